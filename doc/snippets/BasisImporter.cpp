@@ -24,6 +24,7 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/PluginManager/Manager.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
@@ -34,6 +35,9 @@
 #include <Corrade/PluginManager/PluginMetadata.h>
 #include <Magnum/GL/Context.h>
 #include <Magnum/GL/Extensions.h>
+#include <Magnum/PixelFormat.h>
+
+#include "MagnumPlugins/BasisImporter/BasisImporter.h"
 #endif
 
 using namespace Magnum;
@@ -138,6 +142,35 @@ if(PluginManager::PluginMetadata* metadata = manager.metadata("BasisImporter"))
 }
 /* [gl-extension-checks] */
 }
+
+{
+PluginManager::Manager<Trade::AbstractImporter> manager;
+Containers::Optional<Trade::ImageData2D> image;
+/* [choose-target-format] */
+Containers::Pointer<Trade::AbstractImporter> importer =
+    manager.instantiate("BasisImporter");
+auto& basisImporter = static_cast<Trade::BasisImporter&>(*importer);
+basisImporter.openFile("mytexture.basis");
+
+GL::Context& context = GL::Context::current();
+using namespace GL::Extensions;
+Containers::Array<CompressedPixelFormat> supported;
+#ifdef MAGNUM_TARGET_WEBGL
+if(context.isExtensionSupported<WEBGL::compressed_texture_astc>())
+#else
+if(context.isExtensionSupported<KHR::texture_compression_astc_ldr>())
+#endif
+    arrayAppend(supported, CompressedPixelFormat::Astc4x4RGBAUnorm);
+// ... other formats supported by the GPU
+
+Trade::BasisImporter::TargetFormat format =
+    basisImporter.chooseTargetFormat(supported);
+if(format == Trade::BasisImporter::TargetFormat::RGBA8)
+    Warning{} << "No compressed format supported, decoding to RGBA8";
+basisImporter.setTargetFormat(format);
+image = importer->image2D(0);
+/* [choose-target-format] */
+}
 #endif
 
 }
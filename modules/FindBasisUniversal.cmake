@@ -220,6 +220,21 @@ foreach(_component ${BasisUniversal_FIND_COMPONENTS})
                 set(BasisUniversalTranscoder_SOURCES
                     ${BasisUniversalTranscoder_DIR}/basisu_transcoder.cpp)
 
+                # Zstandard is needed for decoding supercompressed KTX2 files.
+                # It's bundled with Basis Universal 1.13 and newer, if it's not
+                # there, compile the transcoder without it. For older versions
+                # without KTX2 support the define has no effect.
+                set(_BASISUNIVERSAL_TRANSCODER_DEFINITIONS BASISU_NO_ITERATOR_DEBUG_LEVEL)
+                find_file(BasisUniversalZstd_SOURCE NAMES zstd.c
+                    HINTS "${BASIS_UNIVERSAL_DIR}/zstd"
+                    NO_DEFAULT_PATH NO_CMAKE_FIND_ROOT_PATH)
+                mark_as_advanced(BasisUniversalZstd_SOURCE)
+                if(BasisUniversalZstd_SOURCE)
+                    list(APPEND BasisUniversalTranscoder_SOURCES ${BasisUniversalZstd_SOURCE})
+                else()
+                    list(APPEND _BASISUNIVERSAL_TRANSCODER_DEFINITIONS BASISD_SUPPORT_KTX2_ZSTD=0)
+                endif()
+
                 foreach(_file ${BasisUniversalTranscoder_SOURCES})
                     _basis_setup_source_file(${_file})
                 endforeach()
@@ -236,7 +251,7 @@ foreach(_component ${BasisUniversal_FIND_COMPONENTS})
                 set_property(TARGET BasisUniversal::Transcoder APPEND PROPERTY
                     INTERFACE_INCLUDE_DIRECTORIES ${BasisUniversalTranscoder_INCLUDE_DIR})
                 set_property(TARGET BasisUniversal::Transcoder APPEND PROPERTY
-                    INTERFACE_COMPILE_DEFINITIONS "BASISU_NO_ITERATOR_DEBUG_LEVEL")
+                    INTERFACE_COMPILE_DEFINITIONS "${_BASISUNIVERSAL_TRANSCODER_DEFINITIONS}")
                 set_property(TARGET BasisUniversal::Transcoder APPEND PROPERTY
                     INTERFACE_SOURCES "${BasisUniversalTranscoder_SOURCES}")
             endif()
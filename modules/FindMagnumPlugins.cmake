@@ -32,6 +32,7 @@
 #  PngImageConverter            - PNG image converter
 #  PngImporter                  - PNG importer
 #  PrimitiveImporter            - Primitive importer
+#  SoundBankAudioImporter       - Sound bank audio importer
 #  StanfordImporter             - Stanford PLY importer
 #  StanfordSceneConverter       - Stanford PLY converter
 #  StbImageConverter            - Image converter using stb_image_write
@@ -44,6 +45,10 @@
 # Some plugins expose their internal state through separate libraries. The
 # libraries are:
 #
+#  AsyncImport                  - Importing meshes and images on a pool of
+#   worker threads
+#  ImportCache                  - Caching imported meshes and images in a
+#   memory-mappable binary format
 #  OpenDdl                      - OpenDDL parser, used as a base for the
 #   OpenGexImporter plugin
 #
@@ -106,6 +111,8 @@ foreach(_component ${MagnumPlugins_FIND_COMPONENTS})
         set(_MAGNUMPLUGINS_${_component}_MAGNUM_DEPENDENCIES Trade)
     elseif(_component MATCHES ".+(Font|FontConverter)$")
         set(_MAGNUMPLUGINS_${_component}_MAGNUM_DEPENDENCIES Text)
+    elseif(_component STREQUAL AsyncImport OR _component STREQUAL ImportCache)
+        set(_MAGNUMPLUGINS_${_component}_MAGNUM_DEPENDENCIES Trade)
     endif()
 
     if(_component STREQUAL AssimpImporter)
@@ -115,11 +122,9 @@ foreach(_component ${MagnumPlugins_FIND_COMPONENTS})
     elseif(_component STREQUAL OpenGexImporter)
         list(APPEND _MAGNUMPLUGINS_${_component}_MAGNUM_DEPENDENCIES AnyImageImporter)
     elseif(_component STREQUAL PrimitiveImporter)
-        list(APPEND _MAGNUMPLUGINS_${_component}_MAGNUM_DEPENDENCIES Primitives)
+        list(APPEND _MAGNUMPLUGINS_${_component}_MAGNUM_DEPENDENCIES MeshTools Primitives)
     elseif(_component STREQUAL StanfordImporter)
         list(APPEND _MAGNUMPLUGINS_${_component}_MAGNUM_DEPENDENCIES MeshTools)
-    elseif(_component STREQUAL StanfordSceneConverter)
-        list(APPEND _MAGNUMPLUGINS_${_component}_MAGNUM_DEPENDENCIES MeshTools)
     elseif(_component STREQUAL TinyGltfImporter)
         list(APPEND _MAGNUMPLUGINS_${_component}_MAGNUM_DEPENDENCIES AnyImageImporter)
     endif()
@@ -135,16 +140,16 @@ mark_as_advanced(MAGNUMPLUGINS_INCLUDE_DIR)
 
 # Component distinction (listing them explicitly to avoid mistakes with finding
 # components from other repositories)
-set(_MAGNUMPLUGINS_LIBRARY_COMPONENT_LIST OpenDdl)
+set(_MAGNUMPLUGINS_LIBRARY_COMPONENT_LIST AsyncImport ImportCache OpenDdl)
 set(_MAGNUMPLUGINS_PLUGIN_COMPONENT_LIST
     AssimpImporter BasisImageConverter BasisImporter DdsImporter
     DevIlImageImporter DrFlacAudioImporter DrMp3AudioImporter
     DrWavAudioImporter Faad2AudioImporter FreeTypeFont HarfBuzzFont IcoImporter
     JpegImageConverter JpegImporter MeshOptimizerSceneConverter
     MiniExrImageConverter OpenGexImporter PngImageConverter PngImporter
-    PrimitiveImporter StanfordImporter StanfordSceneConverter StbImageConverter
-    StbImageImporter StbTrueTypeFont StbVorbisAudioImporter StlImporter
-    TinyGltfImporter)
+    PrimitiveImporter SoundBankAudioImporter StanfordImporter
+    StanfordSceneConverter StbImageConverter StbImageImporter StbTrueTypeFont
+    StbVorbisAudioImporter StlImporter TinyGltfImporter)
 
 # Inter-component dependencies
 set(_MAGNUMPLUGINS_HarfBuzzFont_DEPENDENCIES FreeTypeFont)
@@ -293,6 +298,12 @@ foreach(_component ${MagnumPlugins_FIND_COMPONENTS})
             set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
                 INTERFACE_LINK_LIBRARIES Assimp::Assimp)
 
+        # AsyncImport library dependencies
+        elseif(_component STREQUAL AsyncImport)
+            find_package(Threads REQUIRED)
+            set_property(TARGET MagnumPlugins::${_component} APPEND PROPERTY
+                INTERFACE_LINK_LIBRARIES Threads::Threads)
+
         # BasisImageConverter / BasisImporter has only compiled-in
         # dependencies, except in case of vcpkg, then we need to link to a
         # library. Use a similar logic as in FindBasisUniversal, so in case an
@@ -412,6 +423,7 @@ foreach(_component ${MagnumPlugins_FIND_COMPONENTS})
         endif()
 
         # PrimitiveImporter has no dependencies
+        # SoundBankAudioImporter has no dependencies
         # StanfordImporter has no dependencies
         # StanfordSceneConverter has no dependencies
         # StbImageConverter has no dependencies
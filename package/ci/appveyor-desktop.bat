@@ -112,6 +112,7 @@ cmake .. ^
     -DWITH_PNGIMAGECONVERTER=%EXCEPT_IF_VCPKG_IS_BROKEN% ^
     -DWITH_PNGIMPORTER=%EXCEPT_IF_VCPKG_IS_BROKEN% ^
     -DWITH_PRIMITIVEIMPORTER=ON ^
+    -DWITH_SOUNDBANKAUDIOIMPORTER=ON ^
     -DWITH_STANFORDIMPORTER=ON ^
     -DWITH_STANFORDSCENECONVERTER=ON ^
     -DWITH_STBIMAGECONVERTER=ON ^
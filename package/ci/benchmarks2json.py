@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+
+#
+#   This file is part of Magnum.
+#
+#   Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+#               2020 Vladimír Vondruš <mosra@centrum.cz>
+#
+#   Permission is hereby granted, free of charge, to any person obtaining a
+#   copy of this software and associated documentation files (the "Software"),
+#   to deal in the Software without restriction, including without limitation
+#   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+#   and/or sell copies of the Software, and to permit persons to whom the
+#   Software is furnished to do so, subject to the following conditions:
+#
+#   The above copyright notice and this permission notice shall be included
+#   in all copies or substantial portions of the Software.
+#
+#   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+#   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+#   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+#   DEALINGS IN THE SOFTWARE.
+#
+
+# Runs the benchmark executables passed on the command line (for example the
+# ones built by the MagnumPluginsBenchmarks target) and converts their output
+# to JSON, so results can be compared across commits and machines. For
+# benchmarks that mention the input size as "N bytes" in their description,
+# the throughput in bytes per second is calculated as well, similarly for
+# "N glyphs" in the font benchmarks.
+#
+#   ./benchmarks2json.py build/bin/*Benchmark > results.json
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+
+# BENCH [04]   1.23 ± 0.04   ms image(RGB8, 123456 bytes)@10x1 (wall time)
+bench_rx = re.compile(r'^\s*BENCH \[\d+\]\s+(?P<value>[\d.]+) ± (?P<error>[\d.]+)\s+(?P<unit>\S*)\s+(?P<name>[^(\s]+)\((?P<description>.*)\)@(?P<repeats>\d+)x(?P<batch>\d+) \((?P<type>[^)]+)\)\s*$')
+bytes_rx = re.compile(r'(\d+) bytes')
+glyphs_rx = re.compile(r'(\d+) glyphs')
+ansi_rx = re.compile(r'\033\[[0-9;]*m')
+
+# Everything gets converted to seconds, bytes or plain counts
+multipliers = {
+    'ns': ('s', 1e-9), 'µs': ('s', 1e-6), 'ms': ('s', 1e-3), 's': ('s', 1.0),
+    'B': ('B', 1.0), 'kB': ('B', 1024.0), 'MB': ('B', 1024.0**2), 'GB': ('B', 1024.0**3),
+    'C': ('C', 1.0), 'kC': ('C', 1e3), 'MC': ('C', 1e6), 'GC': ('C', 1e9),
+    '': ('', 1.0), 'k': ('', 1e3), 'M': ('', 1e6), 'G': ('', 1e9)
+}
+
+def parse(suite, output):
+    results = []
+    for line in output.splitlines():
+        match = bench_rx.match(ansi_rx.sub('', line))
+        if not match: continue
+
+        unit, multiplier = multipliers.get(match.group('unit'), (match.group('unit'), 1.0))
+        result = {
+            'suite': suite,
+            'name': match.group('name'),
+            'description': match.group('description'),
+            'type': match.group('type'),
+            'value': float(match.group('value'))*multiplier,
+            'error': float(match.group('error'))*multiplier,
+            'unit': unit
+        }
+
+        size = bytes_rx.search(match.group('description'))
+        if size and unit == 's' and result['value']:
+            result['bytesPerSecond'] = int(size.group(1))/result['value']
+        glyphs = glyphs_rx.search(match.group('description'))
+        if glyphs and unit == 's' and result['value']:
+            result['glyphsPerSecond'] = int(glyphs.group(1))/result['value']
+
+        results.append(result)
+    return results
+
+parser = argparse.ArgumentParser(description="Run benchmarks and print the results as JSON")
+parser.add_argument('benchmarks', nargs='+', help="benchmark executables")
+parser.add_argument('--args', default='', help="additional arguments passed to each benchmark")
+args = parser.parse_args()
+
+results = []
+failed = False
+for benchmark in args.benchmarks:
+    process = subprocess.run([benchmark, '--color', 'off'] + args.args.split(),
+        stdout=subprocess.PIPE, universal_newlines=True)
+    if process.returncode != 0:
+        print("{} failed with exit code {}".format(benchmark, process.returncode), file=sys.stderr)
+        failed = True
+    results += parse(os.path.basename(benchmark), process.stdout)
+
+json.dump({'benchmarks': results}, sys.stdout, indent=2, ensure_ascii=False)
+print()
+sys.exit(1 if failed else 0)
@@ -52,6 +52,7 @@ cmake .. \
     -DCMAKE_INSTALL_RPATH=$HOME/deps/lib \
     -DCMAKE_BUILD_TYPE=$CONFIGURATION \
     -DWITH_ASSIMPIMPORTER=ON \
+    -DWITH_ASYNCIMPORT=ON \
     -DWITH_BASISIMAGECONVERTER=ON \
     -DWITH_BASISIMPORTER=ON -DBASIS_UNIVERSAL_DIR=$HOME/basis_universal \
     -DWITH_DDSIMPORTER=ON \
@@ -64,6 +65,7 @@ cmake .. \
     -DWITH_FREETYPEFONT=ON \
     -DWITH_HARFBUZZFONT=ON \
     -DWITH_ICOIMPORTER=ON \
+    -DWITH_IMPORTCACHE=ON \
     -DWITH_JPEGIMAGECONVERTER=ON \
     -DWITH_JPEGIMPORTER=ON \
     -DWITH_MESHOPTIMIZERSCENECONVERTER=ON \
@@ -72,6 +74,7 @@ cmake .. \
     -DWITH_PNGIMAGECONVERTER=ON \
     -DWITH_PNGIMPORTER=ON \
     -DWITH_PRIMITIVEIMPORTER=ON \
+    -DWITH_SOUNDBANKAUDIOIMPORTER=ON \
     -DWITH_STANFORDIMPORTER=ON \
     -DWITH_STANFORDSCENECONVERTER=ON \
     -DWITH_STBIMAGECONVERTER=ON \
@@ -0,0 +1,235 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "ImporterPool.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/DebugStl.h>
+#include <Magnum/Trade/AbstractImporter.h>
+
+namespace Magnum { namespace AsyncImport {
+
+CancellationToken::CancellationToken(): _cancelled{std::make_shared<std::atomic<bool>>(false)} {}
+
+void CancellationToken::cancel() { *_cancelled = true; }
+
+bool CancellationToken::isCancelled() const { return *_cancelled; }
+
+namespace {
+
+struct Job {
+    std::string filename;
+    Containers::Optional<CancellationToken> token;
+    /* Imports from the importer and resolves the future, or resolves it with
+       NullOpt if the importer is null */
+    std::function<void(Trade::AbstractImporter*)> run;
+};
+
+}
+
+struct ImporterPool::State {
+    void work(std::size_t thread);
+    void submit(Job&& job);
+
+    template<class T> std::future<Containers::Optional<T>> enqueue(const std::string& filename, Containers::Optional<CancellationToken>&& token, std::function<Containers::Optional<T>(Trade::AbstractImporter&)>&& import);
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<Job> jobs;
+    bool quit = false;
+
+    /* Accessed only from the thread of the same index, except for
+       construction and destruction */
+    Containers::Array<Containers::Pointer<Trade::AbstractImporter>> importers;
+    Containers::Array<std::thread> threads;
+};
+
+void ImporterPool::State::work(const std::size_t thread) {
+    Trade::AbstractImporter& importer = *importers[thread];
+    /* File currently opened in the importer, empty if none */
+    std::string opened;
+
+    for(;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            condition.wait(lock, [this]{ return quit || !jobs.empty(); });
+            if(quit) break;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        if(job.token && job.token->isCancelled()) {
+            job.run(nullptr);
+            continue;
+        }
+
+        if(opened != job.filename) {
+            importer.close();
+            opened.clear();
+            if(importer.openFile(job.filename)) opened = job.filename;
+        }
+
+        /* Check for cancellation again, as opening might have taken a
+           while */
+        if(opened.empty() || (job.token && job.token->isCancelled())) {
+            job.run(nullptr);
+            continue;
+        }
+
+        job.run(&importer);
+    }
+
+    importer.close();
+}
+
+void ImporterPool::State::submit(Job&& job) {
+    /* No workers, resolve right away */
+    if(threads.empty()) {
+        job.run(nullptr);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        jobs.push_back(std::move(job));
+    }
+    condition.notify_one();
+}
+
+template<class T> std::future<Containers::Optional<T>> ImporterPool::State::enqueue(const std::string& filename, Containers::Optional<CancellationToken>&& token, std::function<Containers::Optional<T>(Trade::AbstractImporter&)>&& import) {
+    /* std::function needs to be copyable, std::promise isn't */
+    std::shared_ptr<std::promise<Containers::Optional<T>>> promise = std::make_shared<std::promise<Containers::Optional<T>>>();
+    std::future<Containers::Optional<T>> future = promise->get_future();
+
+    submit(Job{filename, std::move(token), [promise, import](Trade::AbstractImporter* const importer) {
+        promise->set_value(importer ? import(*importer) : Containers::Optional<T>{});
+    }});
+
+    return future;
+}
+
+ImporterPool::ImporterPool(PluginManager::Manager<Trade::AbstractImporter>& manager, const std::string& plugin, UnsignedInt threadCount, const std::function<void(Trade::AbstractImporter&)>& setup): _state{new State} {
+    if(!threadCount) threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+    /* Instantiate everything first, so a failure doesn't leave any threads
+       behind */
+    _state->importers = Containers::Array<Containers::Pointer<Trade::AbstractImporter>>{threadCount};
+    for(Containers::Pointer<Trade::AbstractImporter>& importer: _state->importers) {
+        if(!(importer = manager.loadAndInstantiate(plugin))) {
+            Error{} << "AsyncImport::ImporterPool: can't instantiate" << plugin;
+            _state->importers = nullptr;
+            return;
+        }
+        if(setup) setup(*importer);
+    }
+
+    _state->threads = Containers::Array<std::thread>{threadCount};
+    for(std::size_t i = 0; i != threadCount; ++i)
+        _state->threads[i] = std::thread{&State::work, _state.get(), i};
+}
+
+ImporterPool::ImporterPool(ImporterPool&&) noexcept = default;
+
+ImporterPool::~ImporterPool() {
+    /* Moved-out instance */
+    if(!_state) return;
+
+    {
+        std::lock_guard<std::mutex> lock{_state->mutex};
+        _state->quit = true;
+    }
+    _state->condition.notify_all();
+    for(std::thread& thread: _state->threads) thread.join();
+
+    /* The workers are gone now, no need to lock anymore */
+    for(Job& job: _state->jobs) job.run(nullptr);
+}
+
+ImporterPool& ImporterPool::operator=(ImporterPool&&) noexcept = default;
+
+UnsignedInt ImporterPool::threadCount() const { return UnsignedInt(_state->threads.size()); }
+
+std::size_t ImporterPool::pendingCount() const {
+    std::lock_guard<std::mutex> lock{_state->mutex};
+    return _state->jobs.size();
+}
+
+void ImporterPool::cancelPending() {
+    std::deque<Job> jobs;
+    {
+        std::lock_guard<std::mutex> lock{_state->mutex};
+        std::swap(jobs, _state->jobs);
+    }
+
+    /* Resolving outside of the lock, whoever waits on the futures can
+       submit new imports right away */
+    for(Job& job: jobs) job.run(nullptr);
+}
+
+std::future<Containers::Optional<Trade::MeshData>> ImporterPool::mesh(const std::string& filename, const UnsignedInt id, const UnsignedInt level, const CancellationToken& token) {
+    return _state->enqueue<Trade::MeshData>(filename, token, [id, level](Trade::AbstractImporter& importer) {
+        return importer.mesh(id, level);
+    });
+}
+
+std::future<Containers::Optional<Trade::MeshData>> ImporterPool::mesh(const std::string& filename, const UnsignedInt id, const UnsignedInt level) {
+    return _state->enqueue<Trade::MeshData>(filename, Containers::NullOpt, [id, level](Trade::AbstractImporter& importer) {
+        return importer.mesh(id, level);
+    });
+}
+
+std::future<Containers::Optional<Trade::ImageData2D>> ImporterPool::image2D(const std::string& filename, const UnsignedInt id, const UnsignedInt level, const CancellationToken& token) {
+    return _state->enqueue<Trade::ImageData2D>(filename, token, [id, level](Trade::AbstractImporter& importer) {
+        return importer.image2D(id, level);
+    });
+}
+
+std::future<Containers::Optional<Trade::ImageData2D>> ImporterPool::image2D(const std::string& filename, const UnsignedInt id, const UnsignedInt level) {
+    return _state->enqueue<Trade::ImageData2D>(filename, Containers::NullOpt, [id, level](Trade::AbstractImporter& importer) {
+        return importer.image2D(id, level);
+    });
+}
+
+std::future<Containers::Optional<Trade::ImageData3D>> ImporterPool::image3D(const std::string& filename, const UnsignedInt id, const UnsignedInt level, const CancellationToken& token) {
+    return _state->enqueue<Trade::ImageData3D>(filename, token, [id, level](Trade::AbstractImporter& importer) {
+        return importer.image3D(id, level);
+    });
+}
+
+std::future<Containers::Optional<Trade::ImageData3D>> ImporterPool::image3D(const std::string& filename, const UnsignedInt id, const UnsignedInt level) {
+    return _state->enqueue<Trade::ImageData3D>(filename, Containers::NullOpt, [id, level](Trade::AbstractImporter& importer) {
+        return importer.image3D(id, level);
+    });
+}
+
+}}
@@ -0,0 +1,265 @@
+#ifndef Magnum_AsyncImport_ImporterPool_h
+#define Magnum_AsyncImport_ImporterPool_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Magnum::AsyncImport::ImporterPool, @ref Magnum::AsyncImport::CancellationToken
+ * @m_since_latest_{plugins}
+ */
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/PluginManager/PluginManager.h>
+#include <Magnum/Trade/ImageData.h>
+#include <Magnum/Trade/MeshData.h>
+
+#include "Magnum/AsyncImport/AsyncImport.h"
+#include "Magnum/AsyncImport/visibility.h"
+
+namespace Magnum { namespace AsyncImport {
+
+/**
+@brief Cancellation token
+@m_since_latest_{plugins}
+
+Passed to the @ref ImporterPool import functions to be able to cancel the
+import later, for example when the asset is no longer needed because the
+camera moved away. Copies of the token share the same state, so cancelling
+one cancels all of them. A single token can be used for any number of
+imports. Cancelling is thread-safe.
+*/
+class MAGNUM_ASYNCIMPORT_EXPORT CancellationToken {
+    public:
+        /** @brief Constructor */
+        explicit CancellationToken();
+
+        /**
+         * @brief Cancel
+         *
+         * Imports that didn't start yet are not done at all, imports that are
+         * in progress get discarded once the file is opened. The import
+         * currently executed by the importer plugin isn't interrupted, its
+         * result is delivered.
+         */
+        void cancel();
+
+        /** @brief Whether the token was cancelled */
+        bool isCancelled() const;
+
+    private:
+        std::shared_ptr<std::atomic<bool>> _cancelled;
+};
+
+/**
+@brief Importer pool
+@m_since_latest_{plugins}
+
+Opens files and imports meshes and images on a pool of worker threads,
+returning a @ref std::future for each import. Useful for loading assets in the
+background, such as when streaming an open world.
+
+@section AsyncImport-ImporterPool-usage Usage
+
+@code{.cpp}
+PluginManager::Manager<Trade::AbstractImporter> manager;
+AsyncImport::ImporterPool pool{manager, "TinyGltfImporter"};
+
+AsyncImport::CancellationToken token;
+std::future<Containers::Optional<Trade::MeshData>> mesh =
+    pool.mesh("tile-17-42.glb", 0, 0, token);
+
+// ... then, if the camera moved away before the tile got loaded
+token.cancel();
+
+// ... or, if the import finished, get the result
+if(mesh.wait_for(std::chrono::seconds{0}) == std::future_status::ready) {
+    Containers::Optional<Trade::MeshData> data = mesh.get();
+    // ...
+}
+@endcode
+
+If the file can't be opened or the import fails, the future is resolved with
+@ref Containers::NullOpt and the plugin prints a message to @ref Error as
+usual. Cancelled imports are resolved with @ref Containers::NullOpt as well,
+but without any message. Imports are started in the order they were
+requested.
+
+@section AsyncImport-ImporterPool-threads Thread safety
+
+Each worker thread gets its own importer instance. The importers are
+instantiated in the constructor and destroyed in the destructor, both on the
+calling thread, as the plugin manager isn't thread-safe. Apart from that the
+instances aren't shared between threads, so it's enough that the importer
+plugin supports having multiple instances alive at the same time, which
+@ref Trade::TinyGltfImporter "TinyGltfImporter",
+@ref Trade::BasisImporter "BasisImporter" and
+@ref Trade::DdsImporter "DdsImporter" do. The importer configuration, file
+callbacks or flags can be set up with the @p setup function passed to the
+constructor, which is called for each instance before any file is opened.
+
+A worker keeps the last file it imported from opened, so consecutive imports
+from the same file --- for example all meshes of a glTF file --- parse it just
+once per worker. The file is closed when the worker needs to open a
+different one, or when the pool is destroyed. Because of that, changes to the
+file on disk may not be picked up by later imports.
+*/
+class MAGNUM_ASYNCIMPORT_EXPORT ImporterPool {
+    public:
+        /**
+         * @brief Constructor
+         * @param manager       Importer plugin manager
+         * @param plugin        Importer plugin name
+         * @param threadCount   Worker thread count. @cpp 0 @ce sets it to
+         *      the value returned by
+         *      @ref std::thread::hardware_concurrency().
+         * @param setup         Function called on each importer instance
+         *      before it's used, can be @cpp nullptr @ce
+         *
+         * Loads the plugin if it's not loaded yet and instantiates one
+         * importer for each thread on the calling thread using
+         * @ref PluginManager::Manager::loadAndInstantiate(). If the plugin
+         * can't be instantiated, a message is printed to
+         * @ref Error, @ref threadCount() is @cpp 0 @ce and all imports are
+         * resolved with @ref Containers::NullOpt immediately.
+         */
+        explicit ImporterPool(PluginManager::Manager<Trade::AbstractImporter>& manager, const std::string& plugin, UnsignedInt threadCount = 0, const std::function<void(Trade::AbstractImporter&)>& setup = nullptr);
+
+        /** @brief Copying is not allowed */
+        ImporterPool(const ImporterPool&) = delete;
+
+        /** @brief Move constructor */
+        ImporterPool(ImporterPool&&) noexcept;
+
+        /**
+         * @brief Destructor
+         *
+         * Waits for imports that are in progress to finish, imports that
+         * didn't start yet get resolved with @ref Containers::NullOpt. Then
+         * destroys the importer instances on the calling thread.
+         */
+        ~ImporterPool();
+
+        /** @brief Copying is not allowed */
+        ImporterPool& operator=(const ImporterPool&) = delete;
+
+        /** @brief Move assignment */
+        ImporterPool& operator=(ImporterPool&&) noexcept;
+
+        /** @brief Worker thread count */
+        UnsignedInt threadCount() const;
+
+        /**
+         * @brief Count of imports that didn't start yet
+         *
+         * Includes cancelled imports that weren't picked up by a worker
+         * yet.
+         */
+        std::size_t pendingCount() const;
+
+        /**
+         * @brief Resolve all imports that didn't start yet
+         *
+         * Resolves all imports that weren't picked up by a worker yet with
+         * @ref Containers::NullOpt, independently of their
+         * @ref CancellationToken. Imports that are in progress are not
+         * affected.
+         */
+        void cancelPending();
+
+        /**
+         * @brief Import a mesh
+         * @param filename  File to import from
+         * @param id        Mesh ID, from range [0, @ref Trade::AbstractImporter::meshCount())
+         * @param level     Mesh level, from range [0, @ref Trade::AbstractImporter::meshLevelCount())
+         * @param token     Cancellation token
+         *
+         * Opens the file if it's not already opened in the worker the import
+         * got assigned to and calls @ref Trade::AbstractImporter::mesh().
+         */
+        std::future<Containers::Optional<Trade::MeshData>> mesh(const std::string& filename, UnsignedInt id, UnsignedInt level, const CancellationToken& token);
+
+        /**
+         * @brief Import a mesh without a cancellation token
+         *
+         * Same as @ref mesh(const std::string&, UnsignedInt, UnsignedInt, const CancellationToken&),
+         * except that the import can be cancelled only by @ref cancelPending().
+         */
+        std::future<Containers::Optional<Trade::MeshData>> mesh(const std::string& filename, UnsignedInt id, UnsignedInt level = 0);
+
+        /**
+         * @brief Import a 2D image
+         * @param filename  File to import from
+         * @param id        Image ID, from range [0, @ref Trade::AbstractImporter::image2DCount())
+         * @param level     Mip level, from range [0, @ref Trade::AbstractImporter::image2DLevelCount())
+         * @param token     Cancellation token
+         *
+         * Opens the file if it's not already opened in the worker the import
+         * got assigned to and calls @ref Trade::AbstractImporter::image2D().
+         */
+        std::future<Containers::Optional<Trade::ImageData2D>> image2D(const std::string& filename, UnsignedInt id, UnsignedInt level, const CancellationToken& token);
+
+        /**
+         * @brief Import a 2D image without a cancellation token
+         *
+         * Same as @ref image2D(const std::string&, UnsignedInt, UnsignedInt, const CancellationToken&),
+         * except that the import can be cancelled only by @ref cancelPending().
+         */
+        std::future<Containers::Optional<Trade::ImageData2D>> image2D(const std::string& filename, UnsignedInt id, UnsignedInt level = 0);
+
+        /**
+         * @brief Import a 3D image
+         * @param filename  File to import from
+         * @param id        Image ID, from range [0, @ref Trade::AbstractImporter::image3DCount())
+         * @param level     Mip level, from range [0, @ref Trade::AbstractImporter::image3DLevelCount())
+         * @param token     Cancellation token
+         *
+         * Opens the file if it's not already opened in the worker the import
+         * got assigned to and calls @ref Trade::AbstractImporter::image3D().
+         */
+        std::future<Containers::Optional<Trade::ImageData3D>> image3D(const std::string& filename, UnsignedInt id, UnsignedInt level, const CancellationToken& token);
+
+        /**
+         * @brief Import a 3D image without a cancellation token
+         *
+         * Same as @ref image3D(const std::string&, UnsignedInt, UnsignedInt, const CancellationToken&),
+         * except that the import can be cancelled only by @ref cancelPending().
+         */
+        std::future<Containers::Optional<Trade::ImageData3D>> image3D(const std::string& filename, UnsignedInt id, UnsignedInt level = 0);
+
+    private:
+        struct State;
+
+        Containers::Pointer<State> _state;
+};
+
+}}
+
+#endif
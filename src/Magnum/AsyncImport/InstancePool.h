@@ -0,0 +1,285 @@
+#ifndef Magnum_AsyncImport_InstancePool_h
+#define Magnum_AsyncImport_InstancePool_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Magnum::AsyncImport::InstancePool
+ * @m_since_latest_{plugins}
+ */
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Magnum/Trade/AbstractImporter.h>
+
+#include "Magnum/AsyncImport/AsyncImport.h"
+
+namespace Magnum { namespace AsyncImport {
+
+namespace Implementation {
+    /* Importers are closed when returned to the pool, other plugin
+       interfaces have no per-use state that could be reset generically */
+    inline void resetInstance(Trade::AbstractImporter& importer) {
+        importer.close();
+    }
+    template<class T> void resetInstance(T&) {}
+}
+
+/**
+@brief Plugin instance pool
+@m_since_latest_{plugins}
+
+Keeps instances of a plugin alive between uses, so a service that processes
+many independent requests doesn't pay the cost of plugin instantiation ---
+which includes copying the plugin configuration and setting up the plugin
+internals, such as the Assimp importer in
+@ref Trade::AssimpImporter "AssimpImporter" --- for each of them. Works with
+any plugin interface, for example @ref Trade::AbstractImporter or
+@ref Trade::AbstractSceneConverter.
+
+@section AsyncImport-InstancePool-usage Usage
+
+@code{.cpp}
+PluginManager::Manager<Trade::AbstractImporter> manager;
+AsyncImport::InstancePool<Trade::AbstractImporter> pool{manager, "PngImporter"};
+
+// on any thread
+{
+    AsyncImport::InstancePool<Trade::AbstractImporter>::Instance importer =
+        pool.acquire();
+    if(importer && importer->openData(data)) {
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+        // ...
+    }
+} // the importer is returned to the pool here
+@endcode
+
+@section AsyncImport-InstancePool-reset State reset
+
+Instances are created on demand in @ref acquire() and returned to the pool
+when the @ref Instance handle is destroyed. At that point, importers are
+closed and the configuration is restored to the state it had after the
+@p setup function passed to the constructor was called, which is far cheaper
+than creating a new instance. Anything else, such as flags or file
+callbacks, is kept as-is, so it should be set only in the @p setup function.
+State the plugins keep between files, such as lookup tables or internal
+parser instances, is reused as well.
+
+@section AsyncImport-InstancePool-threads Thread safety
+
+@ref acquire() and returning the instances is thread-safe. Because the
+plugin manager isn't thread-safe, instances are created under the pool lock
+and the manager must not be used from other threads at the same time. The
+instances themselves are used by one thread at a time, so it's enough if the
+plugin supports having multiple instances alive at the same time. All
+@ref Instance handles have to be destroyed before the pool.
+*/
+template<class T> class InstancePool {
+    public:
+        /**
+         * @brief Pooled instance
+         *
+         * Owns an instance taken from the pool and returns it back on
+         * destruction. Move-only.
+         */
+        class Instance {
+            public:
+                /** @brief Construct an empty handle */
+                /*implicit*/ Instance() noexcept: _pool{} {}
+
+                /** @brief Copying is not allowed */
+                Instance(const Instance&) = delete;
+
+                /** @brief Move constructor */
+                Instance(Instance&& other) noexcept: _pool{other._pool}, _instance{std::move(other._instance)} {
+                    other._pool = nullptr;
+                }
+
+                /**
+                 * @brief Destructor
+                 *
+                 * Resets the instance and returns it to the pool.
+                 */
+                ~Instance() {
+                    if(_instance) _pool->release(std::move(_instance));
+                }
+
+                /** @brief Copying is not allowed */
+                Instance& operator=(const Instance&) = delete;
+
+                /** @brief Move assignment */
+                Instance& operator=(Instance&& other) noexcept {
+                    std::swap(_pool, other._pool);
+                    std::swap(_instance, other._instance);
+                    return *this;
+                }
+
+                /** @brief Whether the handle contains an instance */
+                explicit operator bool() const { return !!_instance; }
+
+                /** @brief Underlying instance */
+                T* get() { return _instance.get(); }
+                const T* get() const { return _instance.get(); } /**< @overload */
+
+                /** @brief Access the underlying instance */
+                T& operator*() { return *_instance; }
+                const T& operator*() const { return *_instance; } /**< @overload */
+
+                /** @brief Access the underlying instance */
+                T* operator->() { return _instance.get(); }
+                const T* operator->() const { return _instance.get(); } /**< @overload */
+
+            private:
+                friend InstancePool;
+
+                explicit Instance(InstancePool& pool, Containers::Pointer<T>&& instance) noexcept: _pool{&pool}, _instance{std::move(instance)} {}
+
+                InstancePool* _pool;
+                Containers::Pointer<T> _instance;
+        };
+
+        /**
+         * @brief Constructor
+         * @param manager   Plugin manager
+         * @param plugin    Plugin name
+         * @param setup     Function called on each instance after it's
+         *      created, can be @cpp nullptr @ce
+         *
+         * No instances are created upfront, use @ref reserve() for that.
+         */
+        explicit InstancePool(PluginManager::Manager<T>& manager, const std::string& plugin, const std::function<void(T&)>& setup = nullptr): _manager(manager), _plugin{plugin}, _setup{setup} {}
+
+        /** @brief Copying is not allowed */
+        InstancePool(const InstancePool&) = delete;
+
+        /**
+         * @brief Moving is not allowed
+         *
+         * The @ref Instance handles reference the pool.
+         */
+        InstancePool(InstancePool&&) = delete;
+
+        /** @brief Copying is not allowed */
+        InstancePool& operator=(const InstancePool&) = delete;
+
+        /** @brief Moving is not allowed */
+        InstancePool& operator=(InstancePool&&) = delete;
+
+        /** @brief Plugin name */
+        std::string plugin() const { return _plugin; }
+
+        /**
+         * @brief Count of instances created so far
+         *
+         * Includes both instances that are in the pool and instances that
+         * are currently acquired.
+         */
+        std::size_t instanceCount() const {
+            std::lock_guard<std::mutex> lock{_mutex};
+            return _instanceCount;
+        }
+
+        /** @brief Count of instances that are in the pool */
+        std::size_t availableCount() const {
+            std::lock_guard<std::mutex> lock{_mutex};
+            return _available.size();
+        }
+
+        /**
+         * @brief Create instances upfront
+         *
+         * Creates new instances until there's at least @p count instances
+         * in the pool. Returns @cpp false @ce if the plugin can't be
+         * instantiated, @cpp true @ce otherwise.
+         */
+        bool reserve(std::size_t count) {
+            std::lock_guard<std::mutex> lock{_mutex};
+            while(_available.size() < count) {
+                Containers::Pointer<T> instance = instantiate();
+                if(!instance) return false;
+                _available.push_back(std::move(instance));
+            }
+            return true;
+        }
+
+        /**
+         * @brief Acquire an instance
+         *
+         * Takes an instance from the pool or creates a new one if the pool is
+         * empty. If the plugin can't be instantiated, the plugin manager
+         * prints a message to @ref Error and an empty handle is returned.
+         */
+        Instance acquire() {
+            std::lock_guard<std::mutex> lock{_mutex};
+            Containers::Pointer<T> instance;
+            if(!_available.empty()) {
+                instance = std::move(_available.back());
+                _available.pop_back();
+            } else instance = instantiate();
+            if(!instance) return {};
+            return Instance{*this, std::move(instance)};
+        }
+
+    private:
+        /* Called with the mutex locked */
+        Containers::Pointer<T> instantiate() {
+            Containers::Pointer<T> instance = _manager.loadAndInstantiate(_plugin);
+            if(!instance) return nullptr;
+            if(_setup) _setup(*instance);
+
+            /* Same setup for all instances, so save the configuration just
+               once */
+            if(!_instanceCount) _configuration = instance->configuration();
+            ++_instanceCount;
+            return instance;
+        }
+
+        void release(Containers::Pointer<T>&& instance) {
+            Implementation::resetInstance(*instance);
+            instance->configuration() = _configuration;
+            std::lock_guard<std::mutex> lock{_mutex};
+            _available.push_back(std::move(instance));
+        }
+
+        PluginManager::Manager<T>& _manager;
+        const std::string _plugin;
+        const std::function<void(T&)> _setup;
+
+        mutable std::mutex _mutex;
+        std::size_t _instanceCount{};
+        /* Read without the lock in release(), but written only before the
+           first instance leaves the pool */
+        Utility::ConfigurationGroup _configuration;
+        std::vector<Containers::Pointer<T>> _available;
+};
+
+}}
+
+#endif
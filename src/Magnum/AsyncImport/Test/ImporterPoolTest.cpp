@@ -0,0 +1,242 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <atomic>
+#include <sstream>
+#include <vector>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/Directory.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Vector3.h>
+#include <Magnum/Trade/AbstractImporter.h>
+
+#include "Magnum/AsyncImport/ImporterPool.h"
+
+#include "configure.h"
+
+namespace Magnum { namespace AsyncImport { namespace Test { namespace {
+
+struct ImporterPoolTest: TestSuite::Tester {
+    explicit ImporterPoolTest();
+
+    void pluginNotFound();
+    void setup();
+
+    void image2D();
+    void image3D();
+    void many();
+    void invalidFile();
+
+    void cancelled();
+    void cancelledCopy();
+    void cancelPending();
+    void destructPending();
+
+    /* Explicitly forbid system-wide plugin dependencies */
+    PluginManager::Manager<Trade::AbstractImporter> _manager{"nonexistent"};
+};
+
+ImporterPoolTest::ImporterPoolTest() {
+    addTests({&ImporterPoolTest::pluginNotFound,
+              &ImporterPoolTest::setup,
+
+              &ImporterPoolTest::image2D,
+              &ImporterPoolTest::image3D,
+              &ImporterPoolTest::many,
+              &ImporterPoolTest::invalidFile,
+
+              &ImporterPoolTest::cancelled,
+              &ImporterPoolTest::cancelledCopy,
+              &ImporterPoolTest::cancelPending,
+              &ImporterPoolTest::destructPending});
+
+    /* Load the plugin directly from the build tree. Otherwise it's either
+       static and already loaded or not built at all, in which case the
+       tests that need it are skipped. */
+    #ifdef DDSIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(DDSIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+#define SKIP_IF_NO_DDSIMPORTER()                                            \
+    if(!(_manager.loadState("DdsImporter") & PluginManager::LoadState::Loaded)) \
+        CORRADE_SKIP("DdsImporter plugin not found, cannot test")
+
+void ImporterPoolTest::pluginNotFound() {
+    std::ostringstream out;
+    Containers::Optional<ImporterPool> pool;
+    {
+        Error redirectError{&out};
+        pool.emplace(_manager, "NonexistentImporter", 2);
+    }
+    CORRADE_COMPARE(pool->threadCount(), 0);
+    CORRADE_VERIFY(out.str().find("AsyncImport::ImporterPool: can't instantiate NonexistentImporter\n") != std::string::npos);
+
+    /* Everything gets resolved right away */
+    std::future<Containers::Optional<Trade::MeshData>> mesh = pool->mesh("file.gltf", 0);
+    CORRADE_COMPARE(int(mesh.wait_for(std::chrono::seconds{0})), int(std::future_status::ready));
+    CORRADE_VERIFY(!mesh.get());
+    CORRADE_COMPARE(pool->pendingCount(), 0);
+}
+
+void ImporterPoolTest::setup() {
+    SKIP_IF_NO_DDSIMPORTER();
+
+    std::size_t called = 0;
+    ImporterPool pool{_manager, "DdsImporter", 3, [&](Trade::AbstractImporter& importer) {
+        CORRADE_VERIFY(!importer.isOpened());
+        ++called;
+    }};
+    CORRADE_COMPARE(pool.threadCount(), 3);
+    CORRADE_COMPARE(called, 3);
+}
+
+void ImporterPoolTest::image2D() {
+    SKIP_IF_NO_DDSIMPORTER();
+
+    ImporterPool pool{_manager, "DdsImporter", 2};
+    Containers::Optional<Trade::ImageData2D> image = pool.image2D(Utility::Directory::join(DDSIMPORTER_TEST_DIR, "rgb_uncompressed.dds")).get();
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), Vector2i(3, 2));
+    CORRADE_COMPARE(image->format(), PixelFormat::RGB8Unorm);
+}
+
+void ImporterPoolTest::image3D() {
+    SKIP_IF_NO_DDSIMPORTER();
+
+    ImporterPool pool{_manager, "DdsImporter", 2};
+    Containers::Optional<Trade::ImageData3D> image = pool.image3D(Utility::Directory::join(DDSIMPORTER_TEST_DIR, "rgb_uncompressed_volume.dds")).get();
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), Vector3i(3, 2, 3));
+    CORRADE_COMPARE(image->format(), PixelFormat::RGB8Unorm);
+}
+
+void ImporterPoolTest::many() {
+    SKIP_IF_NO_DDSIMPORTER();
+
+    /* Alternating between two files, so the workers have to reopen */
+    const std::string files[]{
+        Utility::Directory::join(DDSIMPORTER_TEST_DIR, "rgb_uncompressed.dds"),
+        Utility::Directory::join(DDSIMPORTER_TEST_DIR, "rgb_uncompressed_mips.dds")
+    };
+
+    ImporterPool pool{_manager, "DdsImporter", 4};
+    std::vector<std::future<Containers::Optional<Trade::ImageData2D>>> images;
+    for(std::size_t i = 0; i != 64; ++i)
+        images.push_back(pool.image2D(files[i % 2]));
+
+    for(std::size_t i = 0; i != images.size(); ++i) {
+        CORRADE_ITERATION(i);
+        Containers::Optional<Trade::ImageData2D> image = images[i].get();
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->size(), Vector2i(3, 2));
+    }
+}
+
+void ImporterPoolTest::invalidFile() {
+    SKIP_IF_NO_DDSIMPORTER();
+
+    ImporterPool pool{_manager, "DdsImporter", 1};
+
+    /* The message is printed from the worker thread, which may not see the
+       redirection, so not testing it */
+    CORRADE_VERIFY(!pool.image2D(Utility::Directory::join(DDSIMPORTER_TEST_DIR, "nonexistent.dds")).get());
+
+    /* The worker can continue with other files after a failure */
+    CORRADE_VERIFY(pool.image2D(Utility::Directory::join(DDSIMPORTER_TEST_DIR, "rgb_uncompressed.dds")).get());
+}
+
+void ImporterPoolTest::cancelled() {
+    SKIP_IF_NO_DDSIMPORTER();
+
+    ImporterPool pool{_manager, "DdsImporter", 2};
+    const std::string filename = Utility::Directory::join(DDSIMPORTER_TEST_DIR, "rgb_uncompressed.dds");
+
+    CancellationToken token;
+    CORRADE_VERIFY(!token.isCancelled());
+    token.cancel();
+    CORRADE_VERIFY(token.isCancelled());
+    CORRADE_VERIFY(!pool.image2D(filename, 0, 0, token).get());
+
+    /* Other imports aren't affected */
+    CORRADE_VERIFY(pool.image2D(filename, 0, 0, CancellationToken{}).get());
+}
+
+void ImporterPoolTest::cancelledCopy() {
+    CancellationToken a;
+    CancellationToken b = a;
+    CORRADE_VERIFY(!a.isCancelled());
+    CORRADE_VERIFY(!b.isCancelled());
+
+    /* Copies share the state */
+    b.cancel();
+    CORRADE_VERIFY(a.isCancelled());
+    CORRADE_VERIFY(b.isCancelled());
+}
+
+void ImporterPoolTest::cancelPending() {
+    SKIP_IF_NO_DDSIMPORTER();
+
+    ImporterPool pool{_manager, "DdsImporter", 1};
+    const std::string filename = Utility::Directory::join(DDSIMPORTER_TEST_DIR, "rgb_uncompressed.dds");
+
+    std::vector<std::future<Containers::Optional<Trade::ImageData2D>>> images;
+    for(std::size_t i = 0; i != 256; ++i)
+        images.push_back(pool.image2D(filename));
+    pool.cancelPending();
+    CORRADE_COMPARE(pool.pendingCount(), 0);
+
+    /* Whatever the worker managed to import is valid, the rest is resolved
+       without a result. Either way all of them get ready. */
+    for(std::size_t i = 0; i != images.size(); ++i) {
+        CORRADE_ITERATION(i);
+        Containers::Optional<Trade::ImageData2D> image = images[i].get();
+        if(image) CORRADE_COMPARE(image->size(), Vector2i(3, 2));
+    }
+}
+
+void ImporterPoolTest::destructPending() {
+    SKIP_IF_NO_DDSIMPORTER();
+
+    const std::string filename = Utility::Directory::join(DDSIMPORTER_TEST_DIR, "rgb_uncompressed.dds");
+
+    std::vector<std::future<Containers::Optional<Trade::ImageData2D>>> images;
+    {
+        ImporterPool pool{_manager, "DdsImporter", 2};
+        for(std::size_t i = 0; i != 256; ++i)
+            images.push_back(pool.image2D(filename));
+    }
+
+    for(std::size_t i = 0; i != images.size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(int(images[i].wait_for(std::chrono::seconds{0})), int(std::future_status::ready));
+    }
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::AsyncImport::Test::ImporterPoolTest)
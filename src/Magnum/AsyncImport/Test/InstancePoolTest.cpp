@@ -0,0 +1,232 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <sstream>
+#include <thread>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/Directory.h>
+#include <Magnum/Math/Vector2.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include "Magnum/AsyncImport/InstancePool.h"
+
+#include "configure.h"
+
+namespace Magnum { namespace AsyncImport { namespace Test { namespace {
+
+struct InstancePoolTest: TestSuite::Tester {
+    explicit InstancePoolTest();
+
+    void pluginNotFound();
+    void reuse();
+    void reset();
+    void reserve();
+    void moveInstance();
+    void threaded();
+
+    /* Explicitly forbid system-wide plugin dependencies */
+    PluginManager::Manager<Trade::AbstractImporter> _manager{"nonexistent"};
+};
+
+InstancePoolTest::InstancePoolTest() {
+    addTests({&InstancePoolTest::pluginNotFound,
+              &InstancePoolTest::reuse,
+              &InstancePoolTest::reset,
+              &InstancePoolTest::reserve,
+              &InstancePoolTest::moveInstance,
+              &InstancePoolTest::threaded});
+
+    /* Load the plugin directly from the build tree. Otherwise it's either
+       static and already loaded or not built at all, in which case the
+       tests that need it are skipped. */
+    #ifdef DDSIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(DDSIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+#define SKIP_IF_NO_DDSIMPORTER()                                            \
+    if(!(_manager.loadState("DdsImporter") & PluginManager::LoadState::Loaded)) \
+        CORRADE_SKIP("DdsImporter plugin not found, cannot test")
+
+void InstancePoolTest::pluginNotFound() {
+    InstancePool<Trade::AbstractImporter> pool{_manager, "NonexistentImporter"};
+    CORRADE_COMPARE(pool.plugin(), "NonexistentImporter");
+
+    std::ostringstream out;
+    {
+        Error redirectError{&out};
+        CORRADE_VERIFY(!pool.acquire());
+        CORRADE_VERIFY(!pool.reserve(1));
+    }
+    CORRADE_VERIFY(!out.str().empty());
+    CORRADE_COMPARE(pool.instanceCount(), 0);
+    CORRADE_COMPARE(pool.availableCount(), 0);
+}
+
+void InstancePoolTest::reuse() {
+    SKIP_IF_NO_DDSIMPORTER();
+
+    std::size_t setupCount = 0;
+    InstancePool<Trade::AbstractImporter> pool{_manager, "DdsImporter", [&](Trade::AbstractImporter&) {
+        ++setupCount;
+    }};
+
+    Trade::AbstractImporter* first;
+    {
+        InstancePool<Trade::AbstractImporter>::Instance importer = pool.acquire();
+        CORRADE_VERIFY(importer);
+        first = importer.get();
+        CORRADE_COMPARE(pool.instanceCount(), 1);
+        CORRADE_COMPARE(pool.availableCount(), 0);
+
+        /* Another acquire while the first is taken creates a new one */
+        InstancePool<Trade::AbstractImporter>::Instance another = pool.acquire();
+        CORRADE_VERIFY(another);
+        CORRADE_VERIFY(another.get() != first);
+        CORRADE_COMPARE(pool.instanceCount(), 2);
+    }
+    CORRADE_COMPARE(pool.availableCount(), 2);
+    CORRADE_COMPARE(setupCount, 2);
+
+    /* Released instances get reused without calling setup again */
+    {
+        InstancePool<Trade::AbstractImporter>::Instance a = pool.acquire();
+        InstancePool<Trade::AbstractImporter>::Instance b = pool.acquire();
+        CORRADE_VERIFY(a.get() == first || b.get() == first);
+    }
+    CORRADE_COMPARE(pool.instanceCount(), 2);
+    CORRADE_COMPARE(setupCount, 2);
+}
+
+void InstancePoolTest::reset() {
+    SKIP_IF_NO_DDSIMPORTER();
+
+    InstancePool<Trade::AbstractImporter> pool{_manager, "DdsImporter", [](Trade::AbstractImporter& importer) {
+        importer.configuration().setValue("zeroCopy", true);
+    }};
+
+    {
+        InstancePool<Trade::AbstractImporter>::Instance importer = pool.acquire();
+        CORRADE_VERIFY(importer);
+        CORRADE_VERIFY(importer->configuration().value<bool>("zeroCopy"));
+        importer->configuration().setValue("zeroCopy", false);
+        importer->configuration().setValue("extra", 42);
+        CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DDSIMPORTER_TEST_DIR, "rgb_uncompressed.dds")));
+    }
+
+    /* The file is closed and the configuration is back to what setup did */
+    InstancePool<Trade::AbstractImporter>::Instance importer = pool.acquire();
+    CORRADE_VERIFY(importer);
+    CORRADE_VERIFY(!importer->isOpened());
+    CORRADE_VERIFY(importer->configuration().value<bool>("zeroCopy"));
+    CORRADE_VERIFY(!importer->configuration().hasValue("extra"));
+}
+
+void InstancePoolTest::reserve() {
+    SKIP_IF_NO_DDSIMPORTER();
+
+    InstancePool<Trade::AbstractImporter> pool{_manager, "DdsImporter"};
+    CORRADE_COMPARE(pool.instanceCount(), 0);
+
+    CORRADE_VERIFY(pool.reserve(3));
+    CORRADE_COMPARE(pool.instanceCount(), 3);
+    CORRADE_COMPARE(pool.availableCount(), 3);
+
+    /* Reserving less than available does nothing */
+    CORRADE_VERIFY(pool.reserve(2));
+    CORRADE_COMPARE(pool.instanceCount(), 3);
+
+    InstancePool<Trade::AbstractImporter>::Instance importer = pool.acquire();
+    CORRADE_COMPARE(pool.instanceCount(), 3);
+    CORRADE_COMPARE(pool.availableCount(), 2);
+}
+
+void InstancePoolTest::moveInstance() {
+    SKIP_IF_NO_DDSIMPORTER();
+
+    InstancePool<Trade::AbstractImporter> pool{_manager, "DdsImporter"};
+
+    InstancePool<Trade::AbstractImporter>::Instance a = pool.acquire();
+    Trade::AbstractImporter* instance = a.get();
+    CORRADE_VERIFY(instance);
+
+    InstancePool<Trade::AbstractImporter>::Instance b = std::move(a);
+    CORRADE_VERIFY(!a);
+    CORRADE_VERIFY(b.get() == instance);
+
+    InstancePool<Trade::AbstractImporter>::Instance c;
+    CORRADE_VERIFY(!c);
+    c = std::move(b);
+    CORRADE_VERIFY(!b);
+    CORRADE_VERIFY(c.get() == instance);
+    CORRADE_COMPARE(pool.availableCount(), 0);
+
+    /* Assigning an empty handle to an empty handle doesn't return
+       anything, assigning it to the full one returns the instance */
+    a = InstancePool<Trade::AbstractImporter>::Instance{};
+    CORRADE_COMPARE(pool.availableCount(), 0);
+    c = InstancePool<Trade::AbstractImporter>::Instance{};
+    CORRADE_VERIFY(!c);
+    CORRADE_COMPARE(pool.availableCount(), 1);
+}
+
+void InstancePoolTest::threaded() {
+    SKIP_IF_NO_DDSIMPORTER();
+
+    InstancePool<Trade::AbstractImporter> pool{_manager, "DdsImporter"};
+    /* Creating the instances upfront, as the manager is used by the test on
+       the main thread */
+    CORRADE_VERIFY(pool.reserve(4));
+
+    const std::string filename = Utility::Directory::join(DDSIMPORTER_TEST_DIR, "rgb_uncompressed.dds");
+    std::size_t succeeded[4]{};
+    Containers::Array<std::thread> threads{4};
+    for(std::size_t t = 0; t != threads.size(); ++t) threads[t] = std::thread{[&, t]{
+        for(std::size_t i = 0; i != 16; ++i) {
+            InstancePool<Trade::AbstractImporter>::Instance importer = pool.acquire();
+            if(!importer || !importer->openFile(filename)) continue;
+            Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+            if(image && image->size() == Vector2i{3, 2}) ++succeeded[t];
+        }
+    }};
+    for(std::thread& thread: threads) thread.join();
+
+    for(std::size_t t = 0; t != 4; ++t) {
+        CORRADE_ITERATION(t);
+        CORRADE_COMPARE(succeeded[t], 16);
+    }
+    /* Each thread holds at most one instance at a time */
+    CORRADE_COMPARE(pool.instanceCount(), 4);
+    CORRADE_COMPARE(pool.availableCount(), 4);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::AsyncImport::Test::InstancePoolTest)
@@ -0,0 +1,214 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "Cache.h"
+
+#include <cstring>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Configuration.h>
+#include <Corrade/Utility/Debug.h>
+#include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/Directory.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ImageData.h>
+#include <Magnum/Trade/MeshData.h>
+
+#include "Magnum/ImportCache/Serialize.h"
+#include "MagnumPlugins/Implementation/importerInput.h"
+
+namespace Magnum { namespace ImportCache {
+
+namespace {
+
+/* Put in front of every blob on disk so hash collisions and files from an
+   unrelated source are detected */
+struct CacheKey {
+    char magic[4];
+    UnsignedInt reserved;
+    UnsignedLong sourceHash;
+    UnsignedLong sourceSize;
+    UnsignedLong configurationHash;
+};
+
+/* Keeps the blob following it aligned to 16 bytes */
+static_assert(sizeof(CacheKey) == 32, "improper size of CacheKey");
+
+/* 64-bit FNV-1a, same as used by the OpenGEX importer cache */
+constexpr UnsignedLong HashSeed = 14695981039346656037ull;
+
+UnsignedLong hash(const Containers::ArrayView<const char> data, UnsignedLong value = HashSeed) {
+    for(const char c: data) {
+        value ^= UnsignedByte(c);
+        value *= 1099511628211ull;
+    }
+    return value;
+}
+
+template<class T> UnsignedLong hash(const T& value, const UnsignedLong seed) {
+    return hash({reinterpret_cast<const char*>(&value), sizeof(T)}, seed);
+}
+
+template<class> struct Deserializer;
+template<> struct Deserializer<Trade::MeshData> {
+    static Containers::Optional<Trade::MeshData> deserialize(Containers::ArrayView<const char> blob) { return deserializeMesh(blob); }
+    static Containers::Optional<Trade::MeshData> import(Trade::AbstractImporter& importer, UnsignedInt id, UnsignedInt level) { return importer.mesh(id, level); }
+};
+template<> struct Deserializer<Trade::ImageData2D> {
+    static Containers::Optional<Trade::ImageData2D> deserialize(Containers::ArrayView<const char> blob) { return deserializeImage2D(blob); }
+    static Containers::Optional<Trade::ImageData2D> import(Trade::AbstractImporter& importer, UnsignedInt id, UnsignedInt level) { return importer.image2D(id, level); }
+};
+template<> struct Deserializer<Trade::ImageData3D> {
+    static Containers::Optional<Trade::ImageData3D> deserialize(Containers::ArrayView<const char> blob) { return deserializeImage3D(blob); }
+    static Containers::Optional<Trade::ImageData3D> import(Trade::AbstractImporter& importer, UnsignedInt id, UnsignedInt level) { return importer.image3D(id, level); }
+};
+
+}
+
+struct Cache::State {
+    std::string directory;
+    std::size_t hitCount{}, missCount{};
+
+    /* Hash and size of each source file used so far */
+    std::unordered_map<std::string, std::pair<UnsignedLong, UnsignedLong>> sources;
+
+    /* Blobs referenced by data returned on a cache hit. Moving the inputs
+       doesn't change the data pointers. */
+    std::vector<Trade::Implementation::ImporterInput> blobs;
+
+    /* File opened by the last cache miss, to avoid reopening it */
+    Trade::AbstractImporter* openedImporter{};
+    std::string openedFilename;
+};
+
+Cache::Cache(const std::string& directory): _state{Containers::InPlaceInit} {
+    _state->directory = directory;
+    Utility::Directory::mkpath(directory);
+}
+
+Cache::Cache(Cache&&) noexcept = default;
+
+Cache::~Cache() = default;
+
+Cache& Cache::operator=(Cache&&) noexcept = default;
+
+std::string Cache::directory() const { return _state->directory; }
+
+std::size_t Cache::hitCount() const { return _state->hitCount; }
+
+std::size_t Cache::missCount() const { return _state->missCount; }
+
+Containers::Optional<Trade::MeshData> Cache::mesh(Trade::AbstractImporter& importer, const std::string& filename, const UnsignedInt id, const UnsignedInt level) {
+    return import<Trade::MeshData>(importer, filename, 1, id, level, "ImportCache::Cache::mesh():");
+}
+
+Containers::Optional<Trade::ImageData2D> Cache::image2D(Trade::AbstractImporter& importer, const std::string& filename, const UnsignedInt id, const UnsignedInt level) {
+    return import<Trade::ImageData2D>(importer, filename, 2, id, level, "ImportCache::Cache::image2D():");
+}
+
+Containers::Optional<Trade::ImageData3D> Cache::image3D(Trade::AbstractImporter& importer, const std::string& filename, const UnsignedInt id, const UnsignedInt level) {
+    return import<Trade::ImageData3D>(importer, filename, 3, id, level, "ImportCache::Cache::image3D():");
+}
+
+template<class T> Containers::Optional<T> Cache::import(Trade::AbstractImporter& importer, const std::string& filename, const UnsignedInt kind, const UnsignedInt id, const UnsignedInt level, const char* const messagePrefix) {
+    /* Hash the source file, if not done already */
+    auto found = _state->sources.find(filename);
+    if(found == _state->sources.end()) {
+        Trade::Implementation::ImporterInput source;
+        if(!source.openFile(filename, messagePrefix)) return {};
+        found = _state->sources.emplace(filename, std::make_pair(hash(source.in), UnsignedLong(source.in.size()))).first;
+    }
+
+    /* Everything that affects the output goes into the key. The
+       configuration is hashed in its textual form. */
+    CacheKey key{};
+    std::memcpy(key.magic, "MGCK", 4);
+    key.sourceHash = found->second.first;
+    key.sourceSize = found->second.second;
+    {
+        Utility::Configuration configuration;
+        configuration.addGroup("configuration", new Utility::ConfigurationGroup{importer.configuration()});
+        std::ostringstream out;
+        configuration.save(out);
+        const std::string plugin = importer.plugin();
+        const std::string dump = out.str();
+        key.configurationHash = hash({dump.data(), dump.size()}, hash({plugin.data(), plugin.size() + 1}));
+    }
+    const UnsignedLong fullHash = hash(level, hash(id, hash(kind, hash(key, HashSeed))));
+
+    char name[16 + 5 + 1];
+    for(std::size_t i = 0; i != 16; ++i)
+        name[i] = "0123456789abcdef"[(fullHash >> (60 - i*4)) & 0xf];
+    std::strcpy(name + 16, ".blob");
+    const std::string blobFilename = Utility::Directory::join(_state->directory, name);
+
+    /* Cache hit. Anything that doesn't match gets regenerated silently. */
+    if(Utility::Directory::exists(blobFilename)) {
+        Trade::Implementation::ImporterInput blob;
+        Containers::Optional<T> out;
+        {
+            Error redirectError{nullptr};
+            if(blob.openFile(blobFilename, messagePrefix) &&
+               blob.in.size() >= sizeof(CacheKey) &&
+               std::memcmp(blob.in.data(), &key, sizeof(CacheKey)) == 0)
+                out = Deserializer<T>::deserialize(blob.in.suffix(sizeof(CacheKey)));
+        }
+
+        if(out) {
+            _state->blobs.push_back(std::move(blob));
+            ++_state->hitCount;
+            return out;
+        }
+    }
+
+    /* Cache miss, open the file if not opened by the previous miss already */
+    ++_state->missCount;
+    if(_state->openedImporter != &importer || _state->openedFilename != filename || !importer.isOpened()) {
+        _state->openedImporter = nullptr;
+        if(!importer.openFile(filename)) return {};
+        _state->openedImporter = &importer;
+        _state->openedFilename = filename;
+    }
+
+    Containers::Optional<T> out = Deserializer<T>::import(importer, id, level);
+    if(!out) return {};
+
+    /* Write to a temporary file first so a concurrently running application
+       never sees a partially written blob */
+    const Containers::Array<char> blob = serialize(*out);
+    Containers::Array<char> data{Containers::NoInit, sizeof(CacheKey) + blob.size()};
+    std::memcpy(data.data(), &key, sizeof(CacheKey));
+    Utility::copy(blob, data.suffix(sizeof(CacheKey)));
+    const std::string temporaryFilename = blobFilename + ".tmp";
+    if(!Utility::Directory::write(temporaryFilename, data) ||
+       !Utility::Directory::move(temporaryFilename, blobFilename))
+        Warning{} << messagePrefix << "cannot write cache file" << blobFilename;
+
+    return out;
+}
+
+}}
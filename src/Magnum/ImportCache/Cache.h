@@ -0,0 +1,176 @@
+#ifndef Magnum_ImportCache_Cache_h
+#define Magnum_ImportCache_Cache_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Magnum::ImportCache::Cache
+ * @m_since_latest_{plugins}
+ */
+
+#include <string>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Magnum/Trade/Trade.h>
+
+#include "Magnum/ImportCache/ImportCache.h"
+#include "Magnum/ImportCache/visibility.h"
+
+namespace Magnum { namespace ImportCache {
+
+/**
+@brief Import cache
+@m_since_latest_{plugins}
+
+Stores meshes and images imported by any importer plugin in a directory as
+blobs produced by @ref serialize(). Subsequent imports of the same data
+memory-map the blob and return a view on it directly, without opening the
+file in the importer at all.
+
+@section ImportCache-Cache-usage Usage
+
+@code{.cpp}
+PluginManager::Manager<Trade::AbstractImporter> manager;
+Containers::Pointer<Trade::AbstractImporter> importer =
+    manager.loadAndInstantiate("TinyGltfImporter");
+
+ImportCache::Cache cache{"/var/cache/my-game"};
+Containers::Optional<Trade::MeshData> mesh =
+    cache.mesh(*importer, "level-1.glb", 3);
+@endcode
+
+@section ImportCache-Cache-keys Cache keys
+
+Each blob is keyed by a hash of the source file contents, the importer plugin
+name, the importer configuration and the requested data ID and level, so
+changing the file or any configuration option results in a cache miss.
+Blobs that are corrupted, were produced by a different @ref BlobVersion or
+belong to a hash collision are silently regenerated. The source file is
+hashed the first time it's used with given cache instance and the hash is
+reused afterwards, so changes to the file done during the lifetime of the
+instance are not picked up. Stale blobs are not removed, it's up to the
+application to clean the directory up when needed.
+
+On a cache miss, the file is opened in the importer, unless it's already the
+file that was opened by the previous cache miss with the same importer, and
+the data are imported from it. The file is left opened afterwards. If the
+blob can't be written, a message is printed to @ref Warning and the imported
+data are returned as usual.
+
+@section ImportCache-Cache-lifetime Data lifetime
+
+The data returned on a cache hit reference the memory-mapped blob, which
+means they're valid for as long as the cache instance is alive. The mapping
+is read-only, so the mesh @ref Trade::MeshData::indexDataFlags() and
+@ref Trade::MeshData::vertexDataFlags() are empty and the image data must not
+be modified. Data returned on a cache miss are the data returned by the
+importer, owned and mutable. Importer state is never cached.
+*/
+class MAGNUM_IMPORTCACHE_EXPORT Cache {
+    public:
+        /**
+         * @brief Constructor
+         * @param directory     Cache directory
+         *
+         * The directory is created if it doesn't exist yet.
+         */
+        explicit Cache(const std::string& directory);
+
+        /** @brief Copying is not allowed */
+        Cache(const Cache&) = delete;
+
+        /** @brief Move constructor */
+        Cache(Cache&&) noexcept;
+
+        /**
+         * @brief Destructor
+         *
+         * Unmaps all blobs, which invalidates all data returned on a cache
+         * hit.
+         */
+        ~Cache();
+
+        /** @brief Copying is not allowed */
+        Cache& operator=(const Cache&) = delete;
+
+        /** @brief Move assignment */
+        Cache& operator=(Cache&&) noexcept;
+
+        /** @brief Cache directory */
+        std::string directory() const;
+
+        /** @brief Count of imports that were satisfied from the cache */
+        std::size_t hitCount() const;
+
+        /** @brief Count of imports that had to go through the importer */
+        std::size_t missCount() const;
+
+        /**
+         * @brief Import a mesh
+         * @param importer  Importer to use on a cache miss
+         * @param filename  File to import from
+         * @param id        Mesh ID, from range [0, @ref Trade::AbstractImporter::meshCount())
+         * @param level     Mesh level, from range [0, @ref Trade::AbstractImporter::meshLevelCount())
+         *
+         * If the file doesn't exist or the import fails, a message is
+         * printed to @ref Error and @ref Containers::NullOpt is returned.
+         * See @ref ImportCache-Cache-lifetime for how long the returned data
+         * are valid.
+         */
+        Containers::Optional<Trade::MeshData> mesh(Trade::AbstractImporter& importer, const std::string& filename, UnsignedInt id, UnsignedInt level = 0);
+
+        /**
+         * @brief Import a 2D image
+         * @param importer  Importer to use on a cache miss
+         * @param filename  File to import from
+         * @param id        Image ID, from range [0, @ref Trade::AbstractImporter::image2DCount())
+         * @param level     Mip level, from range [0, @ref Trade::AbstractImporter::image2DLevelCount())
+         *
+         * Same as @ref mesh(), but for 2D images.
+         */
+        Containers::Optional<Trade::ImageData2D> image2D(Trade::AbstractImporter& importer, const std::string& filename, UnsignedInt id, UnsignedInt level = 0);
+
+        /**
+         * @brief Import a 3D image
+         * @param importer  Importer to use on a cache miss
+         * @param filename  File to import from
+         * @param id        Image ID, from range [0, @ref Trade::AbstractImporter::image3DCount())
+         * @param level     Mip level, from range [0, @ref Trade::AbstractImporter::image3DLevelCount())
+         *
+         * Same as @ref mesh(), but for 3D images.
+         */
+        Containers::Optional<Trade::ImageData3D> image3D(Trade::AbstractImporter& importer, const std::string& filename, UnsignedInt id, UnsignedInt level = 0);
+
+    private:
+        struct State;
+
+        template<class T> Containers::Optional<T> import(Trade::AbstractImporter& importer, const std::string& filename, UnsignedInt kind, UnsignedInt id, UnsignedInt level, const char* messagePrefix);
+
+        Containers::Pointer<State> _state;
+};
+
+}}
+
+#endif
@@ -0,0 +1,445 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "Pack.h"
+
+#include <cstring>
+#include <vector>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Utility/Debug.h>
+#include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/Directory.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Trade/AbstractSceneConverter.h>
+#include <Magnum/Trade/ImageData.h>
+#include <Magnum/Trade/MeshData.h>
+#include <Magnum/Trade/MeshObjectData3D.h>
+#include <Magnum/Trade/SceneData.h>
+
+#include "Magnum/ImportCache/Serialize.h"
+#include "MagnumPlugins/Implementation/importerInput.h"
+
+namespace Magnum { namespace ImportCache {
+
+namespace {
+
+/* Written in the native endianness, reads as 0x3412 with the other one */
+constexpr UnsignedShort EndiannessMarker = 0x1234;
+
+struct PackHeader {
+    char magic[4];
+    UnsignedShort version;
+    UnsignedShort endianness;
+    UnsignedInt meshCount;
+    UnsignedInt imageCount;
+    /* Sum of level counts of all images */
+    UnsignedInt imageLevelCount;
+    UnsignedInt objectCount;
+    UnsignedInt sceneCount;
+    Int defaultScene;
+    /* Sum of child counts of all objects and scenes */
+    UnsignedInt childCount;
+    UnsignedInt reserved;
+    UnsignedLong size;
+};
+
+/* Followed by, in order:
+
+    PackBlob meshes[meshCount];
+    PackImage images[imageCount];
+    PackBlob imageLevels[imageLevelCount];
+    PackObject objects[objectCount];
+    PackScene scenes[sceneCount];
+    UnsignedInt children[childCount];
+
+   and then by the mesh and image blobs, each aligned to 16 bytes. */
+
+struct PackBlob {
+    /* From the pack start */
+    UnsignedLong offset;
+    UnsignedLong size;
+};
+
+struct PackImage {
+    /* Into the imageLevels array */
+    UnsignedInt firstLevel;
+    UnsignedInt levelCount;
+};
+
+struct PackObject {
+    Float transformation[16];
+    /* Either ObjectInstanceType3D::Mesh or Empty */
+    UnsignedInt instanceType;
+    Int instance;
+    /* Into the children array */
+    UnsignedInt firstChild;
+    UnsignedInt childCount;
+};
+
+struct PackScene {
+    /* Into the children array */
+    UnsignedInt firstChild;
+    UnsignedInt childCount;
+};
+
+static_assert(sizeof(PackHeader) == 48, "improper size of PackHeader");
+static_assert(sizeof(PackBlob) == 16, "improper size of PackBlob");
+static_assert(sizeof(PackImage) == 8, "improper size of PackImage");
+static_assert(sizeof(PackObject) == 80, "improper size of PackObject");
+static_assert(sizeof(PackScene) == 8, "improper size of PackScene");
+
+constexpr std::size_t DataAlignment = 16;
+
+std::size_t alignData(const std::size_t offset) {
+    return (offset + DataAlignment - 1)/DataAlignment*DataAlignment;
+}
+
+}
+
+bool writePack(Trade::AbstractImporter& importer, const std::string& filename, Trade::AbstractSceneConverter* const meshConverter) {
+    CORRADE_ASSERT(importer.isOpened(),
+        "ImportCache::writePack(): the importer has no file opened", {});
+
+    std::vector<Containers::Array<char>> blobs;
+
+    /* Meshes, processed by the converter if there's any */
+    const UnsignedInt meshCount = importer.meshCount();
+    for(UnsignedInt i = 0; i != meshCount; ++i) {
+        Containers::Optional<Trade::MeshData> mesh = importer.mesh(i);
+        if(!mesh) {
+            Error{} << "ImportCache::writePack(): can't import mesh" << i;
+            return false;
+        }
+
+        if(meshConverter) {
+            if(meshConverter->features() & Trade::SceneConverterFeature::ConvertMesh)
+                mesh = meshConverter->convert(*mesh);
+            else if(!meshConverter->convertInPlace(*mesh))
+                mesh = Containers::NullOpt;
+            if(!mesh) {
+                Error{} << "ImportCache::writePack(): can't convert mesh" << i;
+                return false;
+            }
+        }
+
+        blobs.push_back(serialize(*mesh));
+    }
+
+    /* All levels of all images */
+    const UnsignedInt imageCount = importer.image2DCount();
+    std::vector<PackImage> images;
+    images.reserve(imageCount);
+    for(UnsignedInt i = 0; i != imageCount; ++i) {
+        PackImage packImage{};
+        packImage.firstLevel = blobs.size() - meshCount;
+        packImage.levelCount = importer.image2DLevelCount(i);
+        for(UnsignedInt level = 0; level != packImage.levelCount; ++level) {
+            Containers::Optional<Trade::ImageData2D> image = importer.image2D(i, level);
+            if(!image) {
+                Error{} << "ImportCache::writePack(): can't import level" << level << "of image" << i;
+                return false;
+            }
+            blobs.push_back(serialize(*image));
+        }
+        images.push_back(packImage);
+    }
+    const std::size_t imageLevelCount = blobs.size() - meshCount;
+
+    /* Objects, the children lists are concatenated into a single array
+       together with the scene children */
+    const UnsignedInt objectCount = importer.object3DCount();
+    std::vector<PackObject> objects;
+    std::vector<UnsignedInt> children;
+    objects.reserve(objectCount);
+    for(UnsignedInt i = 0; i != objectCount; ++i) {
+        Containers::Pointer<Trade::ObjectData3D> object = importer.object3D(i);
+        if(!object) {
+            Error{} << "ImportCache::writePack(): can't import object" << i;
+            return false;
+        }
+
+        PackObject packObject{};
+        const Matrix4 transformation = object->transformation();
+        std::memcpy(packObject.transformation, transformation.data(), sizeof(packObject.transformation));
+        if(object->instanceType() == Trade::ObjectInstanceType3D::Mesh) {
+            packObject.instanceType = UnsignedInt(Trade::ObjectInstanceType3D::Mesh);
+            packObject.instance = object->instance();
+        } else {
+            packObject.instanceType = UnsignedInt(Trade::ObjectInstanceType3D::Empty);
+            packObject.instance = -1;
+        }
+        packObject.firstChild = children.size();
+        packObject.childCount = object->children().size();
+        children.insert(children.end(), object->children().begin(), object->children().end());
+        objects.push_back(packObject);
+    }
+
+    const UnsignedInt sceneCount = importer.sceneCount();
+    std::vector<PackScene> scenes;
+    scenes.reserve(sceneCount);
+    for(UnsignedInt i = 0; i != sceneCount; ++i) {
+        Containers::Optional<Trade::SceneData> scene = importer.scene(i);
+        if(!scene) {
+            Error{} << "ImportCache::writePack(): can't import scene" << i;
+            return false;
+        }
+
+        PackScene packScene{};
+        packScene.firstChild = children.size();
+        packScene.childCount = scene->children3D().size();
+        children.insert(children.end(), scene->children3D().begin(), scene->children3D().end());
+        scenes.push_back(packScene);
+    }
+
+    /* Calculate the layout */
+    const std::size_t meshesOffset = sizeof(PackHeader);
+    const std::size_t imagesOffset = meshesOffset + meshCount*sizeof(PackBlob);
+    const std::size_t imageLevelsOffset = imagesOffset + imageCount*sizeof(PackImage);
+    const std::size_t objectsOffset = imageLevelsOffset + imageLevelCount*sizeof(PackBlob);
+    const std::size_t scenesOffset = objectsOffset + objectCount*sizeof(PackObject);
+    const std::size_t childrenOffset = scenesOffset + sceneCount*sizeof(PackScene);
+    std::vector<PackBlob> blobEntries;
+    blobEntries.reserve(blobs.size());
+    std::size_t offset = childrenOffset + children.size()*sizeof(UnsignedInt);
+    for(const Containers::Array<char>& blob: blobs) {
+        offset = alignData(offset);
+        blobEntries.push_back({offset, blob.size()});
+        offset += blob.size();
+    }
+
+    /* Value-initialized, so all padding is zero */
+    Containers::Array<char> out{Containers::ValueInit, offset};
+    PackHeader header{};
+    std::memcpy(header.magic, "MGPK", 4);
+    header.version = BlobVersion;
+    header.endianness = EndiannessMarker;
+    header.meshCount = meshCount;
+    header.imageCount = imageCount;
+    header.imageLevelCount = imageLevelCount;
+    header.objectCount = objectCount;
+    header.sceneCount = sceneCount;
+    header.defaultScene = importer.defaultScene();
+    header.childCount = children.size();
+    header.size = out.size();
+    std::memcpy(out.data(), &header, sizeof(PackHeader));
+    if(!blobEntries.empty())
+        std::memcpy(out.data() + meshesOffset, blobEntries.data(), meshCount*sizeof(PackBlob));
+    if(!images.empty())
+        std::memcpy(out.data() + imagesOffset, images.data(), imageCount*sizeof(PackImage));
+    if(imageLevelCount)
+        std::memcpy(out.data() + imageLevelsOffset, blobEntries.data() + meshCount, imageLevelCount*sizeof(PackBlob));
+    if(!objects.empty())
+        std::memcpy(out.data() + objectsOffset, objects.data(), objectCount*sizeof(PackObject));
+    if(!scenes.empty())
+        std::memcpy(out.data() + scenesOffset, scenes.data(), sceneCount*sizeof(PackScene));
+    if(!children.empty())
+        std::memcpy(out.data() + childrenOffset, children.data(), children.size()*sizeof(UnsignedInt));
+    for(std::size_t i = 0; i != blobs.size(); ++i)
+        std::memcpy(out.data() + blobEntries[i].offset, blobs[i].data(), blobs[i].size());
+
+    if(!Utility::Directory::write(filename, out)) {
+        Error{} << "ImportCache::writePack(): can't write to" << filename;
+        return false;
+    }
+
+    return true;
+}
+
+struct PackImporter::State {
+    Trade::Implementation::ImporterInput input;
+    PackHeader header;
+    Containers::ArrayView<const PackBlob> meshes;
+    Containers::ArrayView<const PackImage> images;
+    Containers::ArrayView<const PackBlob> imageLevels;
+    Containers::ArrayView<const PackObject> objects;
+    Containers::ArrayView<const PackScene> scenes;
+    Containers::ArrayView<const UnsignedInt> children;
+};
+
+namespace {
+
+/* Returns a view on `count` items of given type at `offset`, advancing the
+   offset, or nullptr if out of bounds. The tables are all four-byte aligned
+   and the pack data are at least that, so the cast is fine. */
+template<class T> bool table(const Containers::ArrayView<const char> data, std::size_t& offset, const std::size_t count, Containers::ArrayView<const T>& out) {
+    const std::size_t size = count*sizeof(T);
+    if(offset > data.size() || count > (data.size() - offset)/sizeof(T))
+        return false;
+    out = {reinterpret_cast<const T*>(data.data() + offset), count};
+    offset += size;
+    return true;
+}
+
+bool checkChildren(const Containers::ArrayView<const UnsignedInt> children, const UnsignedInt first, const UnsignedInt count, const UnsignedInt objectCount) {
+    if(first > children.size() || count > children.size() - first)
+        return false;
+    for(const UnsignedInt child: children.slice(first, first + count))
+        if(child >= objectCount) return false;
+    return true;
+}
+
+}
+
+PackImporter::PackImporter() = default;
+
+PackImporter::~PackImporter() = default;
+
+Trade::ImporterFeatures PackImporter::doFeatures() const { return Trade::ImporterFeature::OpenData; }
+
+bool PackImporter::doIsOpened() const { return !!_state; }
+
+void PackImporter::doClose() { _state = nullptr; }
+
+void PackImporter::doOpenFile(const std::string& filename) {
+    Containers::Pointer<State> state{Containers::InPlaceInit};
+    if(!state->input.openFile(filename, "ImportCache::PackImporter::openFile():"))
+        return;
+
+    /* Moving the input doesn't change the data pointer, so it's fine to
+       open it first and then move the state in */
+    _state = std::move(state);
+    doOpenData({});
+}
+
+void PackImporter::doOpenData(const Containers::ArrayView<const char> data) {
+    /* If called from doOpenFile(), the data are already there */
+    Containers::Pointer<State> state = std::move(_state);
+    if(!state) {
+        state.emplace();
+        state->input.openData(data);
+    }
+
+    const Containers::ArrayView<const char> in = state->input.in;
+    if(in.size() < sizeof(PackHeader)) {
+        Error{} << "ImportCache::PackImporter::openData(): file too short, expected at least" << sizeof(PackHeader) << "bytes but got" << in.size();
+        return;
+    }
+
+    std::memcpy(&state->header, in.data(), sizeof(PackHeader));
+    const PackHeader& header = state->header;
+    if(std::memcmp(header.magic, "MGPK", 4) != 0) {
+        Error{} << "ImportCache::PackImporter::openData(): invalid pack signature";
+        return;
+    }
+    if(header.endianness != EndiannessMarker) {
+        Error{} << "ImportCache::PackImporter::openData(): pack has a different endianness";
+        return;
+    }
+    if(header.version != BlobVersion) {
+        Error{} << "ImportCache::PackImporter::openData(): unsupported pack version" << header.version << Debug::nospace << ", expected" << BlobVersion;
+        return;
+    }
+    if(header.size != in.size()) {
+        Error{} << "ImportCache::PackImporter::openData(): expected a pack of" << header.size << "bytes but got" << in.size();
+        return;
+    }
+
+    std::size_t offset = sizeof(PackHeader);
+    if(!table(in, offset, header.meshCount, state->meshes) ||
+       !table(in, offset, header.imageCount, state->images) ||
+       !table(in, offset, header.imageLevelCount, state->imageLevels) ||
+       !table(in, offset, header.objectCount, state->objects) ||
+       !table(in, offset, header.sceneCount, state->scenes) ||
+       !table(in, offset, header.childCount, state->children)) {
+        Error{} << "ImportCache::PackImporter::openData(): tables out of bounds of a" << in.size() << "byte pack";
+        return;
+    }
+
+    /* Check everything that'd otherwise go out of bounds later. The blobs
+       themselves are checked on import. */
+    for(const Containers::ArrayView<const PackBlob>& blobs: {state->meshes, state->imageLevels})
+        for(const PackBlob& blob: blobs)
+            if(blob.offset > in.size() || blob.size > in.size() - blob.offset) {
+                Error{} << "ImportCache::PackImporter::openData(): data blob out of bounds of a" << in.size() << "byte pack";
+                return;
+            }
+    for(const PackImage& image: state->images)
+        if(image.firstLevel > header.imageLevelCount || image.levelCount > header.imageLevelCount - image.firstLevel || !image.levelCount) {
+            Error{} << "ImportCache::PackImporter::openData(): invalid image level range";
+            return;
+        }
+    for(const PackObject& object: state->objects)
+        if(!checkChildren(state->children, object.firstChild, object.childCount, header.objectCount) ||
+           (object.instanceType != UnsignedInt(Trade::ObjectInstanceType3D::Mesh) && object.instanceType != UnsignedInt(Trade::ObjectInstanceType3D::Empty)) ||
+           (object.instanceType == UnsignedInt(Trade::ObjectInstanceType3D::Mesh) && UnsignedInt(object.instance) >= header.meshCount)) {
+            Error{} << "ImportCache::PackImporter::openData(): invalid object data";
+            return;
+        }
+    for(const PackScene& scene: state->scenes)
+        if(!checkChildren(state->children, scene.firstChild, scene.childCount, header.objectCount)) {
+            Error{} << "ImportCache::PackImporter::openData(): invalid scene data";
+            return;
+        }
+    if(header.defaultScene < -1 || header.defaultScene >= Int(header.sceneCount)) {
+        Error{} << "ImportCache::PackImporter::openData(): invalid default scene" << header.defaultScene;
+        return;
+    }
+
+    _state = std::move(state);
+}
+
+Int PackImporter::doDefaultScene() { return _state->header.defaultScene; }
+
+UnsignedInt PackImporter::doSceneCount() const { return _state->scenes.size(); }
+
+Containers::Optional<Trade::SceneData> PackImporter::doScene(const UnsignedInt id) {
+    const PackScene& scene = _state->scenes[id];
+    const Containers::ArrayView<const UnsignedInt> children = _state->children.slice(scene.firstChild, scene.firstChild + scene.childCount);
+    return Trade::SceneData{{}, std::vector<UnsignedInt>{children.begin(), children.end()}};
+}
+
+UnsignedInt PackImporter::doObject3DCount() const { return _state->objects.size(); }
+
+Containers::Pointer<Trade::ObjectData3D> PackImporter::doObject3D(const UnsignedInt id) {
+    const PackObject& object = _state->objects[id];
+    const Containers::ArrayView<const UnsignedInt> children = _state->children.slice(object.firstChild, object.firstChild + object.childCount);
+    Matrix4 transformation;
+    std::memcpy(transformation.data(), object.transformation, sizeof(object.transformation));
+
+    if(object.instanceType == UnsignedInt(Trade::ObjectInstanceType3D::Mesh))
+        return Containers::pointer(new Trade::MeshObjectData3D{{children.begin(), children.end()}, transformation, UnsignedInt(object.instance), -1});
+    return Containers::pointer(new Trade::ObjectData3D{{children.begin(), children.end()}, transformation});
+}
+
+UnsignedInt PackImporter::doMeshCount() const { return _state->meshes.size(); }
+
+Containers::Optional<Trade::MeshData> PackImporter::doMesh(const UnsignedInt id, UnsignedInt) {
+    const PackBlob& blob = _state->meshes[id];
+    return deserializeMesh(_state->input.in.slice(blob.offset, blob.offset + blob.size));
+}
+
+UnsignedInt PackImporter::doImage2DCount() const { return _state->images.size(); }
+
+UnsignedInt PackImporter::doImage2DLevelCount(const UnsignedInt id) {
+    return _state->images[id].levelCount;
+}
+
+Containers::Optional<Trade::ImageData2D> PackImporter::doImage2D(const UnsignedInt id, const UnsignedInt level) {
+    const PackBlob& blob = _state->imageLevels[_state->images[id].firstLevel + level];
+    return deserializeImage2D(_state->input.in.slice(blob.offset, blob.offset + blob.size));
+}
+
+}}
@@ -0,0 +1,140 @@
+#ifndef Magnum_ImportCache_Pack_h
+#define Magnum_ImportCache_Pack_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Magnum::ImportCache::PackImporter, function @ref Magnum::ImportCache::writePack()
+ * @m_since_latest_{plugins}
+ */
+
+#include <string>
+#include <Corrade/Containers/Pointer.h>
+#include <Magnum/Trade/AbstractImporter.h>
+
+#include "Magnum/ImportCache/ImportCache.h"
+#include "Magnum/ImportCache/visibility.h"
+
+namespace Magnum { namespace ImportCache {
+
+/**
+@brief Write an asset pack
+@param importer         Importer with a file opened
+@param filename         Pack filename
+@param meshConverter    Scene converter to process each mesh with before
+    it's stored, can be @cpp nullptr @ce
+@m_since_latest_{plugins}
+
+Bakes all meshes, all levels of all 2D images, all 3D objects and all scenes
+from @p importer into a single file that can be memory-mapped and used by
+@ref PackImporter without any processing. Meshes and images are stored using
+@ref serialize(), so vertex and index buffers keep the layout they had after
+import or after processing by @p meshConverter, such as
+@ref Trade::MeshOptimizerSceneConverter "MeshOptimizerSceneConverter"; images
+are stored in the format the importer produced them in.
+
+To ship GPU-ready textures, configure the importer before calling this
+function. For example, with @ref Trade::TinyGltfImporter "TinyGltfImporter"
+and Basis Universal images, setting the @cb{.ini} basisFormat @ce
+configuration option to @cb{.ini} Bc7RGBA @ce stores BC7 blocks that can be
+uploaded directly. A pack then contains images for one target format, create
+one pack per target if more are needed.
+
+Only the first level of each mesh is stored. Objects are stored with their
+hierarchy and transformation, mesh objects with their mesh reference, other
+instance types are stored as @ref Trade::ObjectInstanceType3D::Empty.
+Materials, textures, cameras, lights, animations, names and importer state
+are not stored. If @p meshConverter is set, it's expected to support
+@ref Trade::SceneConverterFeature::ConvertMesh or
+@ref Trade::SceneConverterFeature::ConvertMeshInPlace.
+
+If any import or conversion fails or the file can't be written, a message is
+printed to @ref Error and @cpp false @ce is returned.
+*/
+MAGNUM_IMPORTCACHE_EXPORT bool writePack(Trade::AbstractImporter& importer, const std::string& filename, Trade::AbstractSceneConverter* meshConverter = nullptr);
+
+/**
+@brief Asset pack importer
+@m_since_latest_{plugins}
+
+Imports packs produced by @ref writePack(). Not a plugin, instantiate it
+directly. Files are memory-mapped on platforms that support it, data passed
+to @ref openData() are copied.
+
+@code{.cpp}
+ImportCache::PackImporter importer;
+if(!importer.openFile("level-1.bc7.pack"))
+    Fatal{} << "Can't open the pack";
+
+// The mesh and image data point directly into the mapped file
+Containers::Optional<Trade::MeshData> mesh = importer.mesh(0);
+Containers::Optional<Trade::ImageData2D> image = importer.image2D(0);
+@endcode
+
+The imported meshes and images reference the file data directly without any
+copying, which means they're valid only until the file is closed. The mesh
+@ref Trade::MeshData::indexDataFlags() and
+@ref Trade::MeshData::vertexDataFlags() are empty and the image data must
+not be modified. Scenes and objects are imported as they were stored by
+@ref writePack(), with @ref Trade::MeshObjectData3D::material() being
+@cpp -1 @ce. Apart from @ref openFile() and @ref openData(), with file
+callbacks handled by @ref Trade::AbstractImporter, no other features are
+supported.
+*/
+class MAGNUM_IMPORTCACHE_EXPORT PackImporter: public Trade::AbstractImporter {
+    public:
+        /** @brief Constructor */
+        explicit PackImporter();
+
+        ~PackImporter();
+
+    private:
+        MAGNUM_IMPORTCACHE_LOCAL Trade::ImporterFeatures doFeatures() const override;
+        MAGNUM_IMPORTCACHE_LOCAL bool doIsOpened() const override;
+        MAGNUM_IMPORTCACHE_LOCAL void doClose() override;
+        MAGNUM_IMPORTCACHE_LOCAL void doOpenFile(const std::string& filename) override;
+        MAGNUM_IMPORTCACHE_LOCAL void doOpenData(Containers::ArrayView<const char> data) override;
+
+        MAGNUM_IMPORTCACHE_LOCAL Int doDefaultScene() override;
+        MAGNUM_IMPORTCACHE_LOCAL UnsignedInt doSceneCount() const override;
+        MAGNUM_IMPORTCACHE_LOCAL Containers::Optional<Trade::SceneData> doScene(UnsignedInt id) override;
+
+        MAGNUM_IMPORTCACHE_LOCAL UnsignedInt doObject3DCount() const override;
+        MAGNUM_IMPORTCACHE_LOCAL Containers::Pointer<Trade::ObjectData3D> doObject3D(UnsignedInt id) override;
+
+        MAGNUM_IMPORTCACHE_LOCAL UnsignedInt doMeshCount() const override;
+        MAGNUM_IMPORTCACHE_LOCAL Containers::Optional<Trade::MeshData> doMesh(UnsignedInt id, UnsignedInt level) override;
+
+        MAGNUM_IMPORTCACHE_LOCAL UnsignedInt doImage2DCount() const override;
+        MAGNUM_IMPORTCACHE_LOCAL UnsignedInt doImage2DLevelCount(UnsignedInt id) override;
+        MAGNUM_IMPORTCACHE_LOCAL Containers::Optional<Trade::ImageData2D> doImage2D(UnsignedInt id, UnsignedInt level) override;
+
+        struct State;
+        Containers::Pointer<State> _state;
+};
+
+}}
+
+#endif
@@ -0,0 +1,363 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "Serialize.h"
+
+#include <cstring>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Debug.h>
+#include <Magnum/DimensionTraits.h>
+#include <Magnum/Mesh.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/VertexFormat.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Vector3.h>
+#include <Magnum/Trade/ImageData.h>
+#include <Magnum/Trade/MeshData.h>
+
+namespace Magnum { namespace ImportCache {
+
+namespace {
+
+enum class Kind: UnsignedInt {
+    Mesh = 1,
+    Image2D = 2,
+    Image3D = 3
+};
+
+/* Written in the native endianness, reads as 0x3412 with the other one */
+constexpr UnsignedShort EndiannessMarker = 0x1234;
+
+struct BlobHeader {
+    char magic[4];
+    UnsignedShort version;
+    UnsignedShort endianness;
+    Kind kind;
+    UnsignedInt reserved;
+    UnsignedLong size;
+};
+
+struct MeshHeader {
+    UnsignedInt primitive;
+    /* 0 if the mesh isn't indexed */
+    UnsignedInt indexType;
+    UnsignedInt indexCount;
+    UnsignedInt vertexCount;
+    UnsignedInt attributeCount;
+    UnsignedInt reserved;
+    /* Offset of the index view in the index data */
+    UnsignedLong indexOffset;
+    /* Offsets from the blob start */
+    UnsignedLong indexDataOffset;
+    UnsignedLong indexDataSize;
+    UnsignedLong vertexDataOffset;
+    UnsignedLong vertexDataSize;
+};
+
+struct MeshAttributeEntry {
+    UnsignedInt name;
+    UnsignedInt format;
+    /* Offset of the first item in the vertex data */
+    UnsignedLong offset;
+    Int stride;
+    UnsignedShort arraySize;
+    UnsignedShort reserved;
+};
+
+struct ImageHeader {
+    UnsignedInt compressed;
+    UnsignedInt format;
+    UnsignedInt formatExtra;
+    UnsignedInt pixelSize;
+    Int size[3];
+    Int alignment;
+    Int rowLength;
+    Int imageHeight;
+    Int skip[3];
+    Int compressedBlockSize[3];
+    Int compressedBlockDataSize;
+    UnsignedInt reserved;
+    /* Offset from the blob start */
+    UnsignedLong dataOffset;
+    UnsignedLong dataSize;
+};
+
+static_assert(sizeof(BlobHeader) == 24, "improper size of BlobHeader");
+static_assert(sizeof(MeshHeader) == 64, "improper size of MeshHeader");
+static_assert(sizeof(MeshAttributeEntry) == 24, "improper size of MeshAttributeEntry");
+static_assert(sizeof(ImageHeader) == 88, "improper size of ImageHeader");
+
+constexpr std::size_t DataAlignment = 16;
+
+std::size_t alignData(const std::size_t offset) {
+    return (offset + DataAlignment - 1)/DataAlignment*DataAlignment;
+}
+
+/* Value-initialized, so all padding is zero */
+Containers::Array<char> allocateBlob(const Kind kind, const std::size_t size) {
+    Containers::Array<char> out{Containers::ValueInit, size};
+    BlobHeader header{};
+    std::memcpy(header.magic, "MGIC", 4);
+    header.version = BlobVersion;
+    header.endianness = EndiannessMarker;
+    header.kind = kind;
+    header.size = size;
+    std::memcpy(out.data(), &header, sizeof(BlobHeader));
+    return out;
+}
+
+bool checkBlob(const Containers::ArrayView<const char> blob, const Kind kind, const std::size_t headerSize, const char* const messagePrefix) {
+    BlobHeader header;
+    if(blob.size() < sizeof(BlobHeader) + headerSize) {
+        Error{} << messagePrefix << "blob too short, expected at least" << sizeof(BlobHeader) + headerSize << "bytes but got" << blob.size();
+        return false;
+    }
+    std::memcpy(&header, blob.data(), sizeof(BlobHeader));
+    if(std::memcmp(header.magic, "MGIC", 4) != 0) {
+        Error{} << messagePrefix << "invalid blob signature";
+        return false;
+    }
+    if(header.endianness != EndiannessMarker) {
+        Error{} << messagePrefix << "blob has a different endianness";
+        return false;
+    }
+    if(header.version != BlobVersion) {
+        Error{} << messagePrefix << "unsupported blob version" << header.version << Debug::nospace << ", expected" << BlobVersion;
+        return false;
+    }
+    if(header.kind != kind) {
+        Error{} << messagePrefix << "expected a blob of kind" << UnsignedInt(kind) << "but got" << UnsignedInt(header.kind);
+        return false;
+    }
+    if(header.size != blob.size()) {
+        Error{} << messagePrefix << "expected a blob of" << header.size << "bytes but got" << blob.size();
+        return false;
+    }
+    return true;
+}
+
+bool checkRange(const Containers::ArrayView<const char> blob, const UnsignedLong offset, const UnsignedLong size, const char* const what, const char* const messagePrefix) {
+    if(offset > blob.size() || size > blob.size() - offset) {
+        Error{} << messagePrefix << what << "out of bounds of a" << blob.size() << "byte blob";
+        return false;
+    }
+    return true;
+}
+
+/* Referencing the blob directly, without taking an ownership */
+Containers::Array<char> referenceData(const Containers::ArrayView<const char> data) {
+    return Containers::Array<char>{const_cast<char*>(data.data()), data.size(), [](char*, std::size_t) {}};
+}
+
+template<UnsignedInt dimensions> Containers::Array<char> serializeImage(const Trade::ImageData<dimensions>& image, const Kind kind) {
+    const std::size_t dataOffset = alignData(sizeof(BlobHeader) + sizeof(ImageHeader));
+    Containers::Array<char> out = allocateBlob(kind, dataOffset + image.data().size());
+
+    ImageHeader header{};
+    header.compressed = image.isCompressed();
+    const Vector3i size = Vector3i::pad(image.size(), 1);
+    for(std::size_t i = 0; i != 3; ++i) header.size[i] = size[i];
+    const PixelStorage storage = image.isCompressed() ?
+        PixelStorage{image.compressedStorage()} : image.storage();
+    header.alignment = storage.alignment();
+    header.rowLength = storage.rowLength();
+    header.imageHeight = storage.imageHeight();
+    for(std::size_t i = 0; i != 3; ++i) header.skip[i] = storage.skip()[i];
+    if(image.isCompressed()) {
+        header.format = UnsignedInt(image.compressedFormat());
+        const CompressedPixelStorage compressedStorage = image.compressedStorage();
+        for(std::size_t i = 0; i != 3; ++i)
+            header.compressedBlockSize[i] = compressedStorage.compressedBlockSize()[i];
+        header.compressedBlockDataSize = compressedStorage.compressedBlockDataSize();
+    } else {
+        header.format = UnsignedInt(image.format());
+        header.formatExtra = image.formatExtra();
+        header.pixelSize = image.pixelSize();
+    }
+    header.dataOffset = dataOffset;
+    header.dataSize = image.data().size();
+    std::memcpy(out.data() + sizeof(BlobHeader), &header, sizeof(ImageHeader));
+
+    Utility::copy(image.data(), out.suffix(dataOffset));
+    return out;
+}
+
+template<UnsignedInt dimensions> Containers::Optional<Trade::ImageData<dimensions>> deserializeImage(const Containers::ArrayView<const char> blob, const Kind kind, const char* const messagePrefix) {
+    if(!checkBlob(blob, kind, sizeof(ImageHeader), messagePrefix))
+        return {};
+
+    ImageHeader header;
+    std::memcpy(&header, blob.data() + sizeof(BlobHeader), sizeof(ImageHeader));
+    if(!checkRange(blob, header.dataOffset, header.dataSize, "image data", messagePrefix))
+        return {};
+
+    VectorTypeFor<dimensions, Int> size;
+    for(std::size_t i = 0; i != dimensions; ++i) size[i] = header.size[i];
+    const Containers::ArrayView<const char> data = blob.slice(header.dataOffset, header.dataOffset + header.dataSize);
+
+    if(header.compressed) {
+        CompressedPixelStorage storage;
+        storage.setAlignment(header.alignment);
+        storage.setRowLength(header.rowLength);
+        storage.setImageHeight(header.imageHeight);
+        storage.setSkip({header.skip[0], header.skip[1], header.skip[2]});
+        storage.setCompressedBlockSize({header.compressedBlockSize[0], header.compressedBlockSize[1], header.compressedBlockSize[2]});
+        storage.setCompressedBlockDataSize(header.compressedBlockDataSize);
+        return Trade::ImageData<dimensions>{storage, CompressedPixelFormat(header.format), size, referenceData(data)};
+    }
+
+    PixelStorage storage;
+    storage.setAlignment(header.alignment)
+        .setRowLength(header.rowLength)
+        .setImageHeight(header.imageHeight)
+        .setSkip({header.skip[0], header.skip[1], header.skip[2]});
+    if(isPixelFormatImplementationSpecific(PixelFormat(header.format)))
+        return Trade::ImageData<dimensions>{storage, pixelFormatUnwrap<UnsignedInt>(PixelFormat(header.format)), header.formatExtra, header.pixelSize, size, referenceData(data)};
+    return Trade::ImageData<dimensions>{storage, PixelFormat(header.format), size, referenceData(data)};
+}
+
+}
+
+Containers::Array<char> serialize(const Trade::MeshData& mesh) {
+    const std::size_t attributesOffset = sizeof(BlobHeader) + sizeof(MeshHeader);
+    const std::size_t indexDataOffset = alignData(attributesOffset + mesh.attributeCount()*sizeof(MeshAttributeEntry));
+    const std::size_t vertexDataOffset = alignData(indexDataOffset + mesh.indexData().size());
+    Containers::Array<char> out = allocateBlob(Kind::Mesh, vertexDataOffset + mesh.vertexData().size());
+
+    MeshHeader header{};
+    header.primitive = UnsignedInt(mesh.primitive());
+    if(mesh.isIndexed()) {
+        header.indexType = UnsignedInt(mesh.indexType());
+        header.indexCount = mesh.indexCount();
+        header.indexOffset = mesh.indexOffset();
+    }
+    header.vertexCount = mesh.vertexCount();
+    header.attributeCount = mesh.attributeCount();
+    header.indexDataOffset = indexDataOffset;
+    header.indexDataSize = mesh.indexData().size();
+    header.vertexDataOffset = vertexDataOffset;
+    header.vertexDataSize = mesh.vertexData().size();
+    std::memcpy(out.data() + sizeof(BlobHeader), &header, sizeof(MeshHeader));
+
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+        MeshAttributeEntry attribute{};
+        attribute.name = UnsignedInt(mesh.attributeName(i));
+        attribute.format = UnsignedInt(mesh.attributeFormat(i));
+        attribute.offset = mesh.attributeOffset(i);
+        attribute.stride = mesh.attributeStride(i);
+        attribute.arraySize = mesh.attributeArraySize(i);
+        std::memcpy(out.data() + attributesOffset + i*sizeof(MeshAttributeEntry), &attribute, sizeof(MeshAttributeEntry));
+    }
+
+    Utility::copy(mesh.indexData(), out.slice(indexDataOffset, indexDataOffset + mesh.indexData().size()));
+    Utility::copy(mesh.vertexData(), out.suffix(vertexDataOffset));
+    return out;
+}
+
+Containers::Array<char> serialize(const Trade::ImageData2D& image) {
+    return serializeImage(image, Kind::Image2D);
+}
+
+Containers::Array<char> serialize(const Trade::ImageData3D& image) {
+    return serializeImage(image, Kind::Image3D);
+}
+
+Containers::Optional<Trade::MeshData> deserializeMesh(const Containers::ArrayView<const char> blob) {
+    constexpr const char* messagePrefix = "ImportCache::deserializeMesh():";
+    if(!checkBlob(blob, Kind::Mesh, sizeof(MeshHeader), messagePrefix))
+        return {};
+
+    MeshHeader header;
+    std::memcpy(&header, blob.data() + sizeof(BlobHeader), sizeof(MeshHeader));
+    const std::size_t attributesOffset = sizeof(BlobHeader) + sizeof(MeshHeader);
+    if(!checkRange(blob, attributesOffset, UnsignedLong(header.attributeCount)*sizeof(MeshAttributeEntry), "attributes", messagePrefix) ||
+       !checkRange(blob, header.indexDataOffset, header.indexDataSize, "index data", messagePrefix) ||
+       !checkRange(blob, header.vertexDataOffset, header.vertexDataSize, "vertex data", messagePrefix))
+        return {};
+
+    const Containers::ArrayView<const char> indexData = blob.slice(header.indexDataOffset, header.indexDataOffset + header.indexDataSize);
+    const Containers::ArrayView<const char> vertexData = blob.slice(header.vertexDataOffset, header.vertexDataOffset + header.vertexDataSize);
+
+    /* Check everything that MeshData would assert on. A blob with a
+       corrupted layout should fail gracefully instead. */
+    Containers::Array<Trade::MeshAttributeData> attributes{header.attributeCount};
+    for(UnsignedInt i = 0; i != header.attributeCount; ++i) {
+        MeshAttributeEntry attribute;
+        std::memcpy(&attribute, blob.data() + attributesOffset + i*sizeof(MeshAttributeEntry), sizeof(MeshAttributeEntry));
+
+        const Trade::MeshAttribute name = Trade::MeshAttribute(attribute.name);
+        if(attribute.arraySize && !Trade::isMeshAttributeCustom(name)) {
+            Error{} << messagePrefix << "attribute" << i << "is an array but not a custom attribute";
+            return {};
+        }
+
+        const VertexFormat format = VertexFormat(attribute.format);
+        if(!isVertexFormatImplementationSpecific(format) && header.vertexCount) {
+            const std::size_t size = vertexFormatSize(format)*Math::max(UnsignedInt(attribute.arraySize), 1u);
+            const std::ptrdiff_t first = attribute.offset;
+            const std::ptrdiff_t last = first + std::ptrdiff_t(header.vertexCount - 1)*attribute.stride;
+            if(Math::min(first, last) < 0 || std::size_t(Math::max(first, last)) + size > vertexData.size()) {
+                Error{} << messagePrefix << "attribute" << i << "out of bounds of" << vertexData.size() << "bytes of vertex data";
+                return {};
+            }
+        }
+
+        attributes[i] = Trade::MeshAttributeData{name, format,
+            Containers::StridedArrayView1D<const void>{vertexData, vertexData.data() + attribute.offset, header.vertexCount, attribute.stride},
+            attribute.arraySize};
+    }
+
+    if(!header.indexType)
+        return Trade::MeshData{MeshPrimitive(header.primitive),
+            Trade::DataFlags{}, vertexData, std::move(attributes), header.vertexCount};
+
+    if(header.indexType > UnsignedInt(MeshIndexType::UnsignedInt)) {
+        Error{} << messagePrefix << "invalid index type" << header.indexType;
+        return {};
+    }
+
+    const MeshIndexType indexType = MeshIndexType(header.indexType);
+    const std::size_t indexSize = meshIndexTypeSize(indexType);
+    if(header.indexOffset > indexData.size() || std::size_t(header.indexCount)*indexSize > indexData.size() - header.indexOffset) {
+        Error{} << messagePrefix << "indices out of bounds of" << indexData.size() << "bytes of index data";
+        return {};
+    }
+    const Containers::ArrayView<const char> indices = indexData.slice(header.indexOffset, header.indexOffset + header.indexCount*indexSize);
+
+    return Trade::MeshData{MeshPrimitive(header.primitive),
+        Trade::DataFlags{}, indexData, Trade::MeshIndexData{indexType, indices},
+        Trade::DataFlags{}, vertexData, std::move(attributes), header.vertexCount};
+}
+
+Containers::Optional<Trade::ImageData2D> deserializeImage2D(const Containers::ArrayView<const char> blob) {
+    return deserializeImage<2>(blob, Kind::Image2D, "ImportCache::deserializeImage2D():");
+}
+
+Containers::Optional<Trade::ImageData3D> deserializeImage3D(const Containers::ArrayView<const char> blob) {
+    return deserializeImage<3>(blob, Kind::Image3D, "ImportCache::deserializeImage3D():");
+}
+
+}}
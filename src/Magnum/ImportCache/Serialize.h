@@ -0,0 +1,123 @@
+#ifndef Magnum_ImportCache_Serialize_h
+#define Magnum_ImportCache_Serialize_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Function @ref Magnum::ImportCache::serialize(), @ref Magnum::ImportCache::deserializeMesh(), @ref Magnum::ImportCache::deserializeImage2D(), @ref Magnum::ImportCache::deserializeImage3D()
+ * @m_since_latest_{plugins}
+ */
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Magnum/Trade/Trade.h>
+
+#include "Magnum/ImportCache/visibility.h"
+
+namespace Magnum { namespace ImportCache {
+
+/**
+@brief Blob format version
+@m_since_latest_{plugins}
+
+Stored in every blob produced by @ref serialize() and in every pack produced
+by @ref writePack(). Blobs with a different version are rejected by
+@ref deserializeMesh(), @ref deserializeImage2D() and
+@ref deserializeImage3D(), packs by @ref PackImporter. Increased every time
+the layout changes.
+*/
+constexpr UnsignedShort BlobVersion = 1;
+
+/**
+@brief Serialize a mesh
+@m_since_latest_{plugins}
+
+Stores the index and vertex data together with the attribute layout, so the
+mesh can be recreated with @ref deserializeMesh() without any processing.
+The data are stored in the native endianness and aligned to 16 bytes from
+the start of the blob. Custom attribute names are stored as their numeric
+values, importer state is not stored.
+*/
+MAGNUM_IMPORTCACHE_EXPORT Containers::Array<char> serialize(const Trade::MeshData& mesh);
+
+/**
+@brief Serialize a 2D image
+@m_since_latest_{plugins}
+
+Stores the pixel data together with the format, size and pixel storage
+parameters, for both uncompressed and compressed images, so the image can be
+recreated with @ref deserializeImage2D() without any processing. The data
+are stored aligned to 16 bytes from the start of the blob, importer state is
+not stored.
+*/
+MAGNUM_IMPORTCACHE_EXPORT Containers::Array<char> serialize(const Trade::ImageData2D& image);
+
+/**
+@brief Serialize a 3D image
+@m_since_latest_{plugins}
+
+Same as @ref serialize(const Trade::ImageData2D&), recreated with
+@ref deserializeImage3D().
+*/
+MAGNUM_IMPORTCACHE_EXPORT Containers::Array<char> serialize(const Trade::ImageData3D& image);
+
+/**
+@brief Deserialize a mesh
+@m_since_latest_{plugins}
+
+Expects a blob produced by @ref serialize(const Trade::MeshData&) that has
+the same @ref BlobVersion and endianness. The returned mesh references the
+index and vertex data directly, with @ref Trade::MeshData::indexDataFlags()
+and @ref Trade::MeshData::vertexDataFlags() empty, which means the blob has
+to stay in scope for as long as the mesh is used. If the blob is invalid, a
+message is printed to @ref Error and @ref Containers::NullOpt is returned.
+*/
+MAGNUM_IMPORTCACHE_EXPORT Containers::Optional<Trade::MeshData> deserializeMesh(Containers::ArrayView<const char> blob);
+
+/**
+@brief Deserialize a 2D image
+@m_since_latest_{plugins}
+
+Expects a blob produced by @ref serialize(const Trade::ImageData2D&) that
+has the same @ref BlobVersion and endianness. The returned image references
+the pixel data directly, which means the blob has to stay in scope for as
+long as the image is used and the data can't be modified if the blob is
+read-only, such as when it's memory-mapped. If the blob is invalid, a
+message is printed to @ref Error and @ref Containers::NullOpt is returned.
+*/
+MAGNUM_IMPORTCACHE_EXPORT Containers::Optional<Trade::ImageData2D> deserializeImage2D(Containers::ArrayView<const char> blob);
+
+/**
+@brief Deserialize a 3D image
+@m_since_latest_{plugins}
+
+Same as @ref deserializeImage2D(), expects a blob produced by
+@ref serialize(const Trade::ImageData3D&).
+*/
+MAGNUM_IMPORTCACHE_EXPORT Containers::Optional<Trade::ImageData3D> deserializeImage3D(Containers::ArrayView<const char> blob);
+
+}}
+
+#endif
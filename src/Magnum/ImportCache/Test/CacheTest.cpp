@@ -0,0 +1,311 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <sstream>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/Directory.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Vector3.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include "Magnum/ImportCache/Cache.h"
+
+#include "configure.h"
+
+namespace Magnum { namespace ImportCache { namespace Test { namespace {
+
+struct CacheTest: TestSuite::Tester {
+    explicit CacheTest();
+
+    void construct();
+
+    void image2D();
+    void image3D();
+    void sameFile();
+    void configurationChanged();
+    void corrupted();
+
+    void nonexistentFile();
+    void importFailed();
+    void cannotWrite();
+
+    /* Explicitly forbid system-wide plugin dependencies */
+    PluginManager::Manager<Trade::AbstractImporter> _manager{"nonexistent"};
+};
+
+CacheTest::CacheTest() {
+    addTests({&CacheTest::construct,
+
+              &CacheTest::image2D,
+              &CacheTest::image3D,
+              &CacheTest::sameFile,
+              &CacheTest::configurationChanged,
+              &CacheTest::corrupted,
+
+              &CacheTest::nonexistentFile,
+              &CacheTest::importFailed,
+              &CacheTest::cannotWrite});
+
+    /* Load the plugin directly from the build tree. Otherwise it's either
+       static and already loaded or not built at all, in which case the
+       tests that need it are skipped. */
+    #ifdef DDSIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(DDSIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+#define SKIP_IF_NO_DDSIMPORTER()                                            \
+    if(!(_manager.loadState("DdsImporter") & PluginManager::LoadState::Loaded)) \
+        CORRADE_SKIP("DdsImporter plugin not found, cannot test")
+
+/* Each test case gets its own empty directory */
+std::string cacheDirectory(const std::string& name) {
+    const std::string directory = Utility::Directory::join(IMPORTCACHE_WRITE_TEST_DIR, name);
+    for(const std::string& file: Utility::Directory::list(directory, Utility::Directory::Flag::SkipDirectories|Utility::Directory::Flag::SkipDotAndDotDot))
+        Utility::Directory::rm(Utility::Directory::join(directory, file));
+    return directory;
+}
+
+std::size_t blobCount(const std::string& directory) {
+    return Utility::Directory::list(directory, Utility::Directory::Flag::SkipDirectories|Utility::Directory::Flag::SkipDotAndDotDot).size();
+}
+
+void CacheTest::construct() {
+    const std::string directory = Utility::Directory::join(IMPORTCACHE_WRITE_TEST_DIR, "construct/nested");
+    if(Utility::Directory::exists(directory))
+        CORRADE_VERIFY(Utility::Directory::rm(directory));
+
+    /* The directory gets created */
+    Cache cache{directory};
+    CORRADE_COMPARE(cache.directory(), directory);
+    CORRADE_VERIFY(Utility::Directory::exists(directory));
+    CORRADE_COMPARE(cache.hitCount(), 0);
+    CORRADE_COMPARE(cache.missCount(), 0);
+}
+
+void CacheTest::image2D() {
+    SKIP_IF_NO_DDSIMPORTER();
+
+    const std::string directory = cacheDirectory("image2D");
+    const std::string filename = Utility::Directory::join(DDSIMPORTER_TEST_DIR, "rgb_uncompressed.dds");
+
+    Containers::Pointer<Trade::AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    Containers::Array<char> expected;
+    {
+        Cache cache{directory};
+        Containers::Optional<Trade::ImageData2D> image = cache.image2D(*importer, filename, 0);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(cache.hitCount(), 0);
+        CORRADE_COMPARE(cache.missCount(), 1);
+        CORRADE_COMPARE(blobCount(directory), 1);
+
+        expected = Containers::Array<char>{image->data().size()};
+        Utility::copy(image->data(), expected);
+    }
+
+    /* A new instance picks the blob up from the disk, without touching the
+       importer at all */
+    Containers::Pointer<Trade::AbstractImporter> another = _manager.instantiate("DdsImporter");
+    Cache cache{directory};
+    Containers::Optional<Trade::ImageData2D> image = cache.image2D(*another, filename, 0);
+    CORRADE_VERIFY(image);
+    CORRADE_VERIFY(!another->isOpened());
+    CORRADE_COMPARE(cache.hitCount(), 1);
+    CORRADE_COMPARE(cache.missCount(), 0);
+    CORRADE_COMPARE(image->size(), (Vector2i{3, 2}));
+    CORRADE_COMPARE(image->format(), PixelFormat::RGB8Unorm);
+    CORRADE_COMPARE_AS(image->data(), expected,
+        TestSuite::Compare::Container);
+}
+
+void CacheTest::image3D() {
+    SKIP_IF_NO_DDSIMPORTER();
+
+    const std::string directory = cacheDirectory("image3D");
+    const std::string filename = Utility::Directory::join(DDSIMPORTER_TEST_DIR, "rgb_uncompressed_volume.dds");
+
+    Containers::Pointer<Trade::AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    Cache cache{directory};
+    CORRADE_VERIFY(cache.image3D(*importer, filename, 0));
+    /* Another import of the same data is a hit already */
+    Containers::Optional<Trade::ImageData3D> image = cache.image3D(*importer, filename, 0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(cache.hitCount(), 1);
+    CORRADE_COMPARE(cache.missCount(), 1);
+    CORRADE_COMPARE(image->size(), (Vector3i{3, 2, 3}));
+    CORRADE_COMPARE(image->format(), PixelFormat::RGB8Unorm);
+}
+
+void CacheTest::sameFile() {
+    SKIP_IF_NO_DDSIMPORTER();
+
+    const std::string directory = cacheDirectory("sameFile");
+    const std::string filename = Utility::Directory::join(DDSIMPORTER_TEST_DIR, "rgb_uncompressed_mips.dds");
+
+    Containers::Pointer<Trade::AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    Cache cache{directory};
+
+    /* Each level is a separate entry */
+    Containers::Optional<Trade::ImageData2D> level0 = cache.image2D(*importer, filename, 0, 0);
+    Containers::Optional<Trade::ImageData2D> level1 = cache.image2D(*importer, filename, 0, 1);
+    CORRADE_VERIFY(level0);
+    CORRADE_VERIFY(level1);
+    CORRADE_COMPARE(level0->size(), (Vector2i{3, 2}));
+    CORRADE_COMPARE(level1->size(), (Vector2i{1, 1}));
+    CORRADE_COMPARE(cache.missCount(), 2);
+    CORRADE_COMPARE(blobCount(directory), 2);
+
+    Containers::Optional<Trade::ImageData2D> level1Cached = cache.image2D(*importer, filename, 0, 1);
+    CORRADE_VERIFY(level1Cached);
+    CORRADE_COMPARE(level1Cached->size(), (Vector2i{1, 1}));
+    CORRADE_COMPARE(cache.hitCount(), 1);
+}
+
+void CacheTest::configurationChanged() {
+    SKIP_IF_NO_DDSIMPORTER();
+
+    const std::string directory = cacheDirectory("configurationChanged");
+    const std::string filename = Utility::Directory::join(DDSIMPORTER_TEST_DIR, "rgba_dxt1.dds");
+
+    Containers::Pointer<Trade::AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    Cache cache{directory};
+    CORRADE_VERIFY(cache.image2D(*importer, filename, 0));
+    CORRADE_COMPARE(cache.missCount(), 1);
+
+    /* A different configuration is a different entry, even though the
+       output is the same in this case */
+    importer->configuration().setValue("zeroCopy", true);
+    CORRADE_VERIFY(cache.image2D(*importer, filename, 0));
+    CORRADE_COMPARE(cache.hitCount(), 0);
+    CORRADE_COMPARE(cache.missCount(), 2);
+    CORRADE_COMPARE(blobCount(directory), 2);
+
+    /* Going back hits the first entry again */
+    importer->configuration().setValue("zeroCopy", false);
+    Containers::Optional<Trade::ImageData2D> image = cache.image2D(*importer, filename, 0);
+    CORRADE_VERIFY(image);
+    CORRADE_VERIFY(image->isCompressed());
+    CORRADE_COMPARE(image->compressedFormat(), CompressedPixelFormat::Bc1RGBAUnorm);
+    CORRADE_COMPARE(cache.hitCount(), 1);
+}
+
+void CacheTest::corrupted() {
+    SKIP_IF_NO_DDSIMPORTER();
+
+    const std::string directory = cacheDirectory("corrupted");
+    const std::string filename = Utility::Directory::join(DDSIMPORTER_TEST_DIR, "rgb_uncompressed.dds");
+
+    Containers::Pointer<Trade::AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    {
+        Cache cache{directory};
+        CORRADE_VERIFY(cache.image2D(*importer, filename, 0));
+    }
+
+    /* Truncate the blob */
+    const std::vector<std::string> files = Utility::Directory::list(directory, Utility::Directory::Flag::SkipDirectories|Utility::Directory::Flag::SkipDotAndDotDot);
+    CORRADE_COMPARE(files.size(), 1);
+    const std::string blob = Utility::Directory::join(directory, files[0]);
+    CORRADE_VERIFY(Utility::Directory::write(blob, Utility::Directory::read(blob).prefix(40)));
+
+    /* It gets silently regenerated */
+    std::ostringstream out;
+    Cache cache{directory};
+    {
+        Error redirectError{&out};
+        Warning redirectWarning{&out};
+        CORRADE_VERIFY(cache.image2D(*importer, filename, 0));
+    }
+    CORRADE_COMPARE(out.str(), "");
+    CORRADE_COMPARE(cache.hitCount(), 0);
+    CORRADE_COMPARE(cache.missCount(), 1);
+
+    CORRADE_VERIFY(cache.image2D(*importer, filename, 0));
+    CORRADE_COMPARE(cache.hitCount(), 1);
+}
+
+void CacheTest::nonexistentFile() {
+    SKIP_IF_NO_DDSIMPORTER();
+
+    Containers::Pointer<Trade::AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    Cache cache{cacheDirectory("nonexistentFile")};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!cache.image2D(*importer, "nonexistent.dds", 0));
+    CORRADE_COMPARE(out.str(), "ImportCache::Cache::image2D(): cannot open file nonexistent.dds\n");
+    CORRADE_COMPARE(cache.hitCount(), 0);
+    CORRADE_COMPARE(cache.missCount(), 0);
+}
+
+void CacheTest::importFailed() {
+    SKIP_IF_NO_DDSIMPORTER();
+
+    const std::string directory = cacheDirectory("importFailed");
+    Containers::Pointer<Trade::AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    Cache cache{directory};
+
+    std::ostringstream out;
+    {
+        Error redirectError{&out};
+        CORRADE_VERIFY(!cache.image2D(*importer, Utility::Directory::join(DDSIMPORTER_TEST_DIR, "wrong_signature.dds"), 0));
+    }
+    CORRADE_COMPARE(out.str(), "Trade::DdsImporter::openData(): wrong file signature\n");
+    CORRADE_COMPARE(cache.missCount(), 1);
+    CORRADE_COMPARE(blobCount(directory), 0);
+}
+
+void CacheTest::cannotWrite() {
+    SKIP_IF_NO_DDSIMPORTER();
+
+    /* Cache "directory" that's a file */
+    const std::string directory = Utility::Directory::join(DDSIMPORTER_TEST_DIR, "rgba_dxt3.dds");
+
+    Containers::Pointer<Trade::AbstractImporter> importer = _manager.instantiate("DdsImporter");
+
+    std::ostringstream out;
+    Containers::Optional<Trade::ImageData2D> image;
+    {
+        Error redirectError{&out};
+        Warning redirectWarning{&out};
+        Cache cache{directory};
+        image = cache.image2D(*importer, Utility::Directory::join(DDSIMPORTER_TEST_DIR, "rgba_dxt5.dds"), 0);
+    }
+
+    /* The import succeeds anyway */
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->compressedFormat(), CompressedPixelFormat::Bc3RGBAUnorm);
+    CORRADE_VERIFY(out.str().find("ImportCache::Cache::image2D(): cannot write cache file ") != std::string::npos);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::ImportCache::Test::CacheTest)
@@ -0,0 +1,352 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <sstream>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/Directory.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Vector3.h>
+#include <Magnum/Trade/AbstractSceneConverter.h>
+#include <Magnum/Trade/ImageData.h>
+#include <Magnum/Trade/MeshData.h>
+#include <Magnum/Trade/MeshObjectData3D.h>
+#include <Magnum/Trade/SceneData.h>
+
+#include "Magnum/ImportCache/Pack.h"
+
+#include "configure.h"
+
+namespace Magnum { namespace ImportCache { namespace Test { namespace {
+
+struct PackTest: TestSuite::Tester {
+    explicit PackTest();
+
+    void roundTrip();
+    void roundTripData();
+    void meshConverter();
+    void meshConverterFailed();
+    void importFailed();
+    void cannotWrite();
+
+    void invalid();
+};
+
+constexpr struct {
+    const char* name;
+    std::size_t offset;
+    char value;
+    std::size_t size;
+    const char* message;
+} InvalidData[]{
+    {"too short", 0, 0, 47, "file too short, expected at least 48 bytes but got 47"},
+    {"wrong signature", 0, 'X', 0, "invalid pack signature"},
+    {"wrong version", 4, 0x7f, 0, "unsupported pack version"},
+    {"wrong endianness", 6, 0x7f, 0, "pack has a different endianness"},
+    {"wrong size", 40, 0x7f, 0, "expected a pack of"},
+    {"tables out of bounds", 8, 0x7f, 0, "tables out of bounds of a"},
+    /* Highest byte of the first mesh blob size */
+    {"blob out of bounds", 48 + 15, 0x7f, 0, "data blob out of bounds of a"},
+    /* Instance of the first object, which references the second mesh */
+    {"mesh out of bounds", 48 + 16*2 + 8 + 16*2 + 68, 0x7f, 0, "invalid object data"},
+    /* The first child is of the first object, the second of the scene */
+    {"child out of bounds", 48 + 16*2 + 8 + 16*2 + 80*3 + 8 + 4, 0x7f, 0, "invalid scene data"},
+    {"invalid default scene", 28, 0x7f, 0, "invalid default scene 127"}
+};
+
+PackTest::PackTest() {
+    addTests({&PackTest::roundTrip,
+              &PackTest::roundTripData,
+              &PackTest::meshConverter,
+              &PackTest::meshConverterFailed,
+              &PackTest::importFailed,
+              &PackTest::cannotWrite});
+
+    addInstancedTests({&PackTest::invalid},
+        Containers::arraySize(InvalidData));
+}
+
+/* Two meshes, one image with two levels and three objects, the first one
+   being a mesh with the second as a child and the third being a camera.
+   There's one scene containing the first and the third object. */
+struct Importer: Trade::AbstractImporter {
+    Trade::ImporterFeatures doFeatures() const override { return {}; }
+    bool doIsOpened() const override { return true; }
+    void doClose() override {}
+
+    Int doDefaultScene() override { return 0; }
+    UnsignedInt doSceneCount() const override { return 1; }
+    Containers::Optional<Trade::SceneData> doScene(UnsignedInt) override {
+        return Trade::SceneData{{}, {0, 2}};
+    }
+
+    UnsignedInt doObject3DCount() const override { return 3; }
+    Containers::Pointer<Trade::ObjectData3D> doObject3D(UnsignedInt id) override {
+        if(id == 0) return Containers::pointer(new Trade::MeshObjectData3D{{1}, Matrix4::translation({1.0f, 2.0f, 3.0f}), 1, 5});
+        if(id == 1) return Containers::pointer(new Trade::ObjectData3D{{}, Matrix4::scaling(Vector3{2.0f})});
+        return Containers::pointer(new Trade::ObjectData3D{{}, {}, Trade::ObjectInstanceType3D::Camera, 0});
+    }
+
+    UnsignedInt doMeshCount() const override { return 2; }
+    Containers::Optional<Trade::MeshData> doMesh(UnsignedInt id, UnsignedInt) override {
+        if(failMesh) return {};
+
+        Containers::Array<char> vertexData{sizeof(Vector3)*3};
+        auto positions = Containers::arrayCast<Vector3>(vertexData);
+        positions[0] = {0.0f, 0.0f, Float(id)};
+        positions[1] = {1.0f, 0.0f, Float(id)};
+        positions[2] = {0.0f, 1.0f, Float(id)};
+        return Trade::MeshData{id ? MeshPrimitive::Triangles : MeshPrimitive::Points,
+            std::move(vertexData), {
+                Trade::MeshAttributeData{Trade::MeshAttribute::Position, Containers::arrayView(positions)}
+            }};
+    }
+
+    UnsignedInt doImage2DCount() const override { return 1; }
+    UnsignedInt doImage2DLevelCount(UnsignedInt) override { return 2; }
+    Containers::Optional<Trade::ImageData2D> doImage2D(UnsignedInt, UnsignedInt level) override {
+        const Vector2i size = level ? Vector2i{1} : Vector2i{2};
+        Containers::Array<char> data{std::size_t(size.product()*4)};
+        for(std::size_t i = 0; i != data.size(); ++i)
+            data[i] = char(i + level*16);
+        return Trade::ImageData2D{PixelFormat::RGBA8Unorm, size, std::move(data)};
+    }
+
+    bool failMesh = false;
+};
+
+/* Counts the meshes and optionally fails on the second */
+struct MeshConverter: Trade::AbstractSceneConverter {
+    Trade::SceneConverterFeatures doFeatures() const override {
+        return Trade::SceneConverterFeature::ConvertMeshInPlace;
+    }
+
+    bool doConvertInPlace(Trade::MeshData&) override {
+        return ++count == 1 || !fail;
+    }
+
+    bool fail = false;
+    Int count = 0;
+};
+
+/* Each test case gets its own file */
+std::string packFilename(const std::string& name) {
+    const std::string filename = Utility::Directory::join(IMPORTCACHE_WRITE_TEST_DIR, name + ".pack");
+    if(Utility::Directory::exists(filename))
+        Utility::Directory::rm(filename);
+    return filename;
+}
+
+void PackTest::roundTrip() {
+    const std::string filename = packFilename("roundTrip");
+
+    Importer source;
+    CORRADE_VERIFY(writePack(source, filename));
+    CORRADE_VERIFY(Utility::Directory::exists(filename));
+
+    PackImporter importer;
+    CORRADE_VERIFY(importer.openFile(filename));
+    CORRADE_COMPARE(importer.defaultScene(), 0);
+
+    CORRADE_COMPARE(importer.sceneCount(), 1);
+    Containers::Optional<Trade::SceneData> scene = importer.scene(0);
+    CORRADE_VERIFY(scene);
+    CORRADE_COMPARE(scene->children3D(), (std::vector<UnsignedInt>{0, 2}));
+
+    CORRADE_COMPARE(importer.object3DCount(), 3);
+    {
+        Containers::Pointer<Trade::ObjectData3D> object = importer.object3D(0);
+        CORRADE_VERIFY(object);
+        CORRADE_COMPARE(object->instanceType(), Trade::ObjectInstanceType3D::Mesh);
+        CORRADE_COMPARE(object->instance(), 1);
+        /* The material isn't stored */
+        CORRADE_COMPARE(static_cast<Trade::MeshObjectData3D&>(*object).material(), -1);
+        CORRADE_COMPARE(object->children(), std::vector<UnsignedInt>{1});
+        CORRADE_COMPARE(object->transformation(), Matrix4::translation({1.0f, 2.0f, 3.0f}));
+    } {
+        Containers::Pointer<Trade::ObjectData3D> object = importer.object3D(1);
+        CORRADE_VERIFY(object);
+        CORRADE_COMPARE(object->instanceType(), Trade::ObjectInstanceType3D::Empty);
+        CORRADE_COMPARE(object->children(), std::vector<UnsignedInt>{});
+        CORRADE_COMPARE(object->transformation(), Matrix4::scaling(Vector3{2.0f}));
+    } {
+        /* Cameras are not stored, the object becomes empty */
+        Containers::Pointer<Trade::ObjectData3D> object = importer.object3D(2);
+        CORRADE_VERIFY(object);
+        CORRADE_COMPARE(object->instanceType(), Trade::ObjectInstanceType3D::Empty);
+        CORRADE_COMPARE(object->instance(), -1);
+    }
+
+    CORRADE_COMPARE(importer.meshCount(), 2);
+    {
+        Containers::Optional<Trade::MeshData> mesh = importer.mesh(1);
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+        CORRADE_COMPARE(mesh->vertexDataFlags(), Trade::DataFlags{});
+        CORRADE_COMPARE_AS(mesh->attribute<Vector3>(Trade::MeshAttribute::Position),
+            Containers::arrayView<Vector3>({
+                {0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 1.0f}
+            }), TestSuite::Compare::Container);
+    }
+
+    CORRADE_COMPARE(importer.image2DCount(), 1);
+    CORRADE_COMPARE(importer.image2DLevelCount(0), 2);
+    {
+        Containers::Optional<Trade::ImageData2D> image = importer.image2D(0, 1);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->format(), PixelFormat::RGBA8Unorm);
+        CORRADE_COMPARE(image->size(), Vector2i{1});
+        CORRADE_COMPARE_AS(image->data(), Containers::arrayView<char>({
+            16, 17, 18, 19
+        }), TestSuite::Compare::Container);
+    }
+}
+
+void PackTest::roundTripData() {
+    const std::string filename = packFilename("roundTripData");
+
+    Importer source;
+    CORRADE_VERIFY(writePack(source, filename));
+
+    /* The data get copied, so it's fine to release them right after */
+    PackImporter importer;
+    {
+        Containers::Array<char> data = Utility::Directory::read(filename);
+        CORRADE_VERIFY(importer.openData(data));
+    }
+
+    CORRADE_COMPARE(importer.meshCount(), 2);
+    Containers::Optional<Trade::MeshData> mesh = importer.mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Points);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(Trade::MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}
+        }), TestSuite::Compare::Container);
+
+    Containers::Optional<Trade::ImageData2D> image = importer.image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), Vector2i{2});
+    CORRADE_COMPARE(image->data().size(), 16);
+    CORRADE_COMPARE(image->data()[15], 15);
+
+    importer.close();
+    CORRADE_VERIFY(!importer.isOpened());
+}
+
+void PackTest::meshConverter() {
+    const std::string filename = packFilename("meshConverter");
+
+    Importer source;
+    MeshConverter converter;
+    CORRADE_VERIFY(writePack(source, filename, &converter));
+    CORRADE_COMPARE(converter.count, 2);
+
+    PackImporter importer;
+    CORRADE_VERIFY(importer.openFile(filename));
+    CORRADE_COMPARE(importer.meshCount(), 2);
+}
+
+void PackTest::meshConverterFailed() {
+    const std::string filename = packFilename("meshConverterFailed");
+
+    Importer source;
+    MeshConverter converter;
+    converter.fail = true;
+
+    std::ostringstream out;
+    {
+        Error redirectError{&out};
+        CORRADE_VERIFY(!writePack(source, filename, &converter));
+    }
+    CORRADE_COMPARE(converter.count, 2);
+    CORRADE_COMPARE(out.str(), "ImportCache::writePack(): can't convert mesh 1\n");
+    CORRADE_VERIFY(!Utility::Directory::exists(filename));
+}
+
+void PackTest::importFailed() {
+    const std::string filename = packFilename("importFailed");
+
+    Importer source;
+    source.failMesh = true;
+
+    std::ostringstream out;
+    {
+        Error redirectError{&out};
+        CORRADE_VERIFY(!writePack(source, filename));
+    }
+    CORRADE_COMPARE(out.str(), "ImportCache::writePack(): can't import mesh 0\n");
+    CORRADE_VERIFY(!Utility::Directory::exists(filename));
+}
+
+void PackTest::cannotWrite() {
+    /* Pack file that's a directory */
+    const std::string filename = IMPORTCACHE_WRITE_TEST_DIR;
+    Utility::Directory::mkpath(filename);
+
+    Importer source;
+
+    std::ostringstream out;
+    {
+        Error redirectError{&out};
+        CORRADE_VERIFY(!writePack(source, filename));
+    }
+    CORRADE_VERIFY(out.str().find("ImportCache::writePack(): can't write to " + filename + "\n") != std::string::npos);
+}
+
+void PackTest::invalid() {
+    auto&& data = InvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const std::string filename = packFilename("invalid");
+    Importer source;
+    CORRADE_VERIFY(writePack(source, filename));
+
+    Containers::Array<char> pack = Utility::Directory::read(filename);
+    if(data.size) {
+        Containers::Array<char> shorter{data.size};
+        Utility::copy(pack.prefix(data.size), shorter);
+        pack = std::move(shorter);
+    } else pack[data.offset] = data.value;
+
+    PackImporter importer;
+    std::ostringstream out;
+    {
+        Error redirectError{&out};
+        CORRADE_VERIFY(!importer.openData(pack));
+    }
+    CORRADE_VERIFY(!importer.isOpened());
+    CORRADE_VERIFY(out.str().find(data.message) != std::string::npos);
+    CORRADE_COMPARE(out.str().find("ImportCache::PackImporter::openData(): "), 0);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::ImportCache::Test::PackTest)
@@ -0,0 +1,358 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstring>
+#include <sstream>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/DebugStl.h>
+#include <Magnum/Mesh.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/VertexFormat.h>
+#include <Magnum/Math/Vector3.h>
+#include <Magnum/Trade/ImageData.h>
+#include <Magnum/Trade/MeshData.h>
+
+#include "Magnum/ImportCache/Serialize.h"
+
+namespace Magnum { namespace ImportCache { namespace Test { namespace {
+
+struct SerializeTest: TestSuite::Tester {
+    explicit SerializeTest();
+
+    void mesh();
+    void meshNotIndexed();
+    void meshArrayAttribute();
+    void image2D();
+    void image2DImplementationSpecific();
+    void image2DCompressed();
+    void image3D();
+
+    void invalid();
+    void invalidMeshAttribute();
+    void invalidMeshIndices();
+};
+
+struct {
+    const char* name;
+    std::size_t offset;
+    char value;
+    std::size_t size;
+    const char* message;
+} InvalidData[]{
+    {"too short", 0, 0, 30, "blob too short, expected at least 88 bytes but got 30"},
+    {"wrong signature", 1, 'X', 0, "invalid blob signature"},
+    {"wrong endianness", 6, 0x12, 0, "blob has a different endianness"},
+    {"wrong version", 4, 0x7f, 0, "unsupported blob version"},
+    {"wrong kind", 8, 2, 0, "expected a blob of kind 1 but got 2"},
+    {"wrong size", 16, 0x7f, 0, "expected a blob of"},
+    {"attributes out of bounds", 24 + 16, 0x7f, 0, "attributes out of bounds of a"},
+    {"vertex data out of bounds", 24 + 56, 0x7f, 0, "vertex data out of bounds of a"}
+};
+
+SerializeTest::SerializeTest() {
+    addTests({&SerializeTest::mesh,
+              &SerializeTest::meshNotIndexed,
+              &SerializeTest::meshArrayAttribute,
+              &SerializeTest::image2D,
+              &SerializeTest::image2DImplementationSpecific,
+              &SerializeTest::image2DCompressed,
+              &SerializeTest::image3D});
+
+    addInstancedTests({&SerializeTest::invalid},
+        Containers::arraySize(InvalidData));
+
+    addTests({&SerializeTest::invalidMeshAttribute,
+              &SerializeTest::invalidMeshIndices});
+}
+
+struct Vertex {
+    Vector3 position;
+    Vector2 textureCoordinates;
+};
+
+/* Two triangles, the index view doesn't start at the beginning */
+Containers::Array<char> indexedMesh() {
+    Containers::Array<char> indexData{sizeof(UnsignedShort)*7};
+    auto indices = Containers::arrayCast<UnsignedShort>(indexData);
+    indices[0] = 0xdead;
+    indices[1] = 0; indices[2] = 1; indices[3] = 2;
+    indices[4] = 2; indices[5] = 1; indices[6] = 3;
+
+    Containers::Array<char> vertexData{sizeof(Vertex)*4};
+    auto vertices = Containers::arrayCast<Vertex>(vertexData);
+    vertices[0] = {{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}};
+    vertices[1] = {{1.0f, 0.0f, 0.0f}, {1.0f, 0.0f}};
+    vertices[2] = {{0.0f, 1.0f, 0.0f}, {0.0f, 1.0f}};
+    vertices[3] = {{1.0f, 1.0f, 0.0f}, {1.0f, 1.0f}};
+
+    return serialize(Trade::MeshData{MeshPrimitive::Triangles,
+        std::move(indexData), Trade::MeshIndexData{indices.suffix(1)},
+        std::move(vertexData), {
+            Trade::MeshAttributeData{Trade::MeshAttribute::Position,
+                Containers::StridedArrayView1D<const Vector3>{vertices, &vertices[0].position, 4, sizeof(Vertex)}},
+            Trade::MeshAttributeData{Trade::MeshAttribute::TextureCoordinates,
+                Containers::StridedArrayView1D<const Vector2>{vertices, &vertices[0].textureCoordinates, 4, sizeof(Vertex)}}
+        }});
+}
+
+void SerializeTest::mesh() {
+    Containers::Array<char> blob = indexedMesh();
+    /* Every data section is aligned */
+    CORRADE_COMPARE(blob.size() % 16, 0);
+
+    Containers::Optional<Trade::MeshData> mesh = deserializeMesh(blob);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+    CORRADE_COMPARE(mesh->indexDataFlags(), Trade::DataFlags{});
+    CORRADE_COMPARE(mesh->vertexDataFlags(), Trade::DataFlags{});
+
+    /* The data reference the blob directly */
+    CORRADE_VERIFY(mesh->indexData().data() > blob.data());
+    CORRADE_VERIFY(mesh->vertexData().data() + mesh->vertexData().size() <= blob.data() + blob.size());
+    CORRADE_COMPARE((reinterpret_cast<std::uintptr_t>(mesh->vertexData().data()) - reinterpret_cast<std::uintptr_t>(blob.data())) % 16, 0);
+
+    CORRADE_VERIFY(mesh->isIndexed());
+    CORRADE_COMPARE(mesh->indexType(), MeshIndexType::UnsignedShort);
+    CORRADE_COMPARE(mesh->indexOffset(), 2);
+    CORRADE_COMPARE_AS(mesh->indices<UnsignedShort>(),
+        Containers::arrayView<UnsignedShort>({0, 1, 2, 2, 1, 3}),
+        TestSuite::Compare::Container);
+
+    CORRADE_COMPARE(mesh->vertexCount(), 4);
+    CORRADE_COMPARE(mesh->attributeCount(), 2);
+    CORRADE_COMPARE(mesh->attributeName(0), Trade::MeshAttribute::Position);
+    CORRADE_COMPARE(mesh->attributeFormat(0), VertexFormat::Vector3);
+    CORRADE_COMPARE(mesh->attributeOffset(0), 0);
+    CORRADE_COMPARE(mesh->attributeStride(0), sizeof(Vertex));
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(Trade::MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {0.0f, 0.0f, 0.0f},
+            {1.0f, 0.0f, 0.0f},
+            {0.0f, 1.0f, 0.0f},
+            {1.0f, 1.0f, 0.0f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(mesh->attributeName(1), Trade::MeshAttribute::TextureCoordinates);
+    CORRADE_COMPARE(mesh->attributeFormat(1), VertexFormat::Vector2);
+    CORRADE_COMPARE(mesh->attributeOffset(1), sizeof(Vector3));
+    CORRADE_COMPARE(mesh->attributeStride(1), sizeof(Vertex));
+    CORRADE_COMPARE_AS(mesh->attribute<Vector2>(Trade::MeshAttribute::TextureCoordinates),
+        Containers::arrayView<Vector2>({
+            {0.0f, 0.0f},
+            {1.0f, 0.0f},
+            {0.0f, 1.0f},
+            {1.0f, 1.0f}
+        }), TestSuite::Compare::Container);
+}
+
+void SerializeTest::meshNotIndexed() {
+    Containers::Array<char> vertexData{sizeof(Vector2)*3};
+    auto positions = Containers::arrayCast<Vector2>(vertexData);
+    positions[0] = {-1.0f, 0.0f};
+    positions[1] = {0.0f, 1.0f};
+    positions[2] = {1.0f, 0.0f};
+
+    Containers::Array<char> blob = serialize(Trade::MeshData{MeshPrimitive::LineStrip,
+        std::move(vertexData), {
+            Trade::MeshAttributeData{Trade::MeshAttribute::Position, positions}
+        }});
+
+    Containers::Optional<Trade::MeshData> mesh = deserializeMesh(blob);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::LineStrip);
+    CORRADE_VERIFY(!mesh->isIndexed());
+    CORRADE_COMPARE(mesh->vertexCount(), 3);
+    CORRADE_COMPARE(mesh->attributeCount(), 1);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector2>(Trade::MeshAttribute::Position),
+        Containers::arrayView<Vector2>({
+            {-1.0f, 0.0f},
+            {0.0f, 1.0f},
+            {1.0f, 0.0f}
+        }), TestSuite::Compare::Container);
+}
+
+void SerializeTest::meshArrayAttribute() {
+    constexpr Trade::MeshAttribute Weights = Trade::meshAttributeCustom(17);
+
+    Containers::Array<char> vertexData{sizeof(Float)*6};
+    auto weights = Containers::arrayCast<Float>(vertexData);
+    for(std::size_t i = 0; i != weights.size(); ++i) weights[i] = i*0.25f;
+
+    Containers::Array<char> blob = serialize(Trade::MeshData{MeshPrimitive::Points,
+        std::move(vertexData), {
+            Trade::MeshAttributeData{Weights, VertexFormat::Float,
+                Containers::StridedArrayView1D<const void>{weights, weights.data(), 2, sizeof(Float)*3}, 3}
+        }});
+
+    Containers::Optional<Trade::MeshData> mesh = deserializeMesh(blob);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexCount(), 2);
+    CORRADE_COMPARE(mesh->attributeName(0), Weights);
+    CORRADE_COMPARE(mesh->attributeFormat(0), VertexFormat::Float);
+    CORRADE_COMPARE(mesh->attributeArraySize(0), 3);
+    CORRADE_COMPARE_AS(mesh->attribute<Float[]>(0)[1],
+        Containers::arrayView<Float>({0.75f, 1.0f, 1.25f}),
+        TestSuite::Compare::Container);
+}
+
+void SerializeTest::image2D() {
+    Containers::Array<char> data{Containers::ValueInit, 4*3};
+    for(std::size_t i = 0; i != data.size(); ++i) data[i] = i;
+
+    /* RGB8 with a four-byte alignment, so each row has one byte of padding
+       that has to be preserved */
+    Containers::Array<char> blob = serialize(Trade::ImageData2D{
+        PixelStorage{}.setAlignment(4), PixelFormat::RGB8Unorm, {1, 3},
+        std::move(data)});
+    CORRADE_COMPARE(blob.size() % 16, 0);
+
+    Containers::Optional<Trade::ImageData2D> image = deserializeImage2D(blob);
+    CORRADE_VERIFY(image);
+    CORRADE_VERIFY(!image->isCompressed());
+    CORRADE_COMPARE(image->storage().alignment(), 4);
+    CORRADE_COMPARE(image->format(), PixelFormat::RGB8Unorm);
+    CORRADE_COMPARE(image->size(), (Vector2i{1, 3}));
+    CORRADE_VERIFY(image->data().data() > blob.data());
+    CORRADE_COMPARE((reinterpret_cast<std::uintptr_t>(image->data().data()) - reinterpret_cast<std::uintptr_t>(blob.data())) % 16, 0);
+    CORRADE_COMPARE_AS(image->data(),
+        Containers::arrayView<char>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}),
+        TestSuite::Compare::Container);
+}
+
+void SerializeTest::image2DImplementationSpecific() {
+    Containers::Array<char> data{Containers::ValueInit, 2*2*2};
+    data[5] = 0x3f;
+
+    Containers::Array<char> blob = serialize(Trade::ImageData2D{
+        PixelStorage{}.setAlignment(2), 0xabcd, 0x1234, 2, {2, 2},
+        std::move(data)});
+
+    Containers::Optional<Trade::ImageData2D> image = deserializeImage2D(blob);
+    CORRADE_VERIFY(image);
+    CORRADE_VERIFY(!image->isCompressed());
+    CORRADE_COMPARE(image->storage().alignment(), 2);
+    CORRADE_VERIFY(isPixelFormatImplementationSpecific(image->format()));
+    CORRADE_COMPARE(pixelFormatUnwrap<UnsignedInt>(image->format()), 0xabcd);
+    CORRADE_COMPARE(image->formatExtra(), 0x1234);
+    CORRADE_COMPARE(image->pixelSize(), 2);
+    CORRADE_COMPARE(image->size(), (Vector2i{2, 2}));
+    CORRADE_COMPARE(image->data()[5], 0x3f);
+}
+
+void SerializeTest::image2DCompressed() {
+    Containers::Array<char> data{Containers::ValueInit, 16};
+    data[15] = 0x21;
+
+    Containers::Array<char> blob = serialize(Trade::ImageData2D{
+        CompressedPixelStorage{}.setCompressedBlockSize({4, 4, 1})
+            .setCompressedBlockDataSize(16),
+        CompressedPixelFormat::Bc3RGBAUnorm, {4, 4}, std::move(data)});
+
+    Containers::Optional<Trade::ImageData2D> image = deserializeImage2D(blob);
+    CORRADE_VERIFY(image);
+    CORRADE_VERIFY(image->isCompressed());
+    CORRADE_COMPARE(image->compressedStorage().compressedBlockSize(), (Vector3i{4, 4, 1}));
+    CORRADE_COMPARE(image->compressedStorage().compressedBlockDataSize(), 16);
+    CORRADE_COMPARE(image->compressedFormat(), CompressedPixelFormat::Bc3RGBAUnorm);
+    CORRADE_COMPARE(image->size(), (Vector2i{4, 4}));
+    CORRADE_COMPARE(image->data().size(), 16);
+    CORRADE_COMPARE(image->data()[15], 0x21);
+}
+
+void SerializeTest::image3D() {
+    Containers::Array<char> data{Containers::ValueInit, 2*3*4};
+    data[23] = 0x17;
+
+    Containers::Array<char> blob = serialize(Trade::ImageData3D{
+        PixelStorage{}.setAlignment(1), PixelFormat::R8Unorm, {2, 3, 4}, std::move(data)});
+
+    /* A 3D blob can't be deserialized as 2D */
+    {
+        std::ostringstream out;
+        Error redirectError{&out};
+        CORRADE_VERIFY(!deserializeImage2D(blob));
+        CORRADE_COMPARE(out.str(), "ImportCache::deserializeImage2D(): expected a blob of kind 2 but got 3\n");
+    }
+
+    Containers::Optional<Trade::ImageData3D> image = deserializeImage3D(blob);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->format(), PixelFormat::R8Unorm);
+    CORRADE_COMPARE(image->size(), (Vector3i{2, 3, 4}));
+    CORRADE_COMPARE(image->data().size(), 24);
+    CORRADE_COMPARE(image->data()[23], 0x17);
+}
+
+void SerializeTest::invalid() {
+    auto&& data = InvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Array<char> blob = indexedMesh();
+    if(data.size) {
+        Containers::Array<char> shorter{data.size};
+        Utility::copy(blob.prefix(data.size), shorter);
+        blob = std::move(shorter);
+    } else blob[data.offset] = data.value;
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!deserializeMesh(blob));
+    CORRADE_VERIFY(out.str().find(data.message) != std::string::npos);
+    CORRADE_COMPARE(out.str().find("ImportCache::deserializeMesh(): "), 0);
+}
+
+void SerializeTest::invalidMeshAttribute() {
+    Containers::Array<char> blob = indexedMesh();
+
+    /* Stride of the first attribute is at offset 16 of the first attribute
+       entry, make it too large for the vertex data */
+    Int stride;
+    std::memcpy(&stride, blob.data() + 24 + 64 + 16, sizeof(Int));
+    stride *= 2;
+    std::memcpy(blob.data() + 24 + 64 + 16, &stride, sizeof(Int));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!deserializeMesh(blob));
+    CORRADE_COMPARE(out.str(), "ImportCache::deserializeMesh(): attribute 0 out of bounds of 80 bytes of vertex data\n");
+}
+
+void SerializeTest::invalidMeshIndices() {
+    Containers::Array<char> blob = indexedMesh();
+
+    /* Index count is at offset 8 of the mesh header */
+    UnsignedInt count = 7;
+    std::memcpy(blob.data() + 24 + 8, &count, sizeof(UnsignedInt));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!deserializeMesh(blob));
+    CORRADE_COMPARE(out.str(), "ImportCache::deserializeMesh(): indices out of bounds of 14 bytes of index data\n");
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::ImportCache::Test::SerializeTest)
@@ -31,8 +31,10 @@
 
 #include <string>
 #include <vector>
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/Optional.h>
+#include <Magnum/Math/Half.h>
 
 #include "Magnum/OpenDdl/visibility.h"
 #include "Magnum/OpenDdl/OpenDdl.h"
@@ -321,6 +323,123 @@ class MAGNUM_OPENDDL_EXPORT Document {
         /** @todo some sane way to ensure that the initializer lists are valid for whole Document lifetime */
         bool parse(Containers::ArrayView<const char> data, std::initializer_list<CharacterLiteral> structureIdentifiers, std::initializer_list<CharacterLiteral> propertyIdentifiers);
 
+        /**
+         * @brief Thread count used for parsing
+         * @m_since_latest_{plugins}
+         *
+         * @see @ref setThreadCount()
+         */
+        UnsignedInt threadCount() const { return _threadCount; }
+
+        /**
+         * @brief Set thread count used for parsing
+         * @return Reference to self (for method chaining)
+         * @m_since_latest_{plugins}
+         *
+         * If set to a value other than @cpp 1 @ce, @ref parse() first scans
+         * the data for boundaries of top-level structures, splits them into
+         * chunks and parses each chunk on a separate thread. The results are
+         * then merged together in the original order and references are
+         * resolved on the whole document, so the result is the same as with
+         * a single thread. Data that are too small or that can't be split
+         * are parsed on the calling thread. @cpp 0 @ce sets the count to the
+         * value returned by @ref std::thread::hardware_concurrency(). Default
+         * is @cpp 1 @ce. On Linux, the application needs to link to `pthread`
+         * in order to use more than one thread.
+         */
+        Document& setThreadCount(UnsignedInt count) {
+            _threadCount = count;
+            return *this;
+        }
+
+        /**
+         * @brief Whether numeric data lists are parsed lazily
+         * @m_since_latest_{plugins}
+         *
+         * @see @ref setLazy()
+         */
+        bool isLazy() const { return _lazy; }
+
+        /**
+         * @brief Parse numeric data lists lazily
+         * @return Reference to self (for method chaining)
+         * @m_since_latest_{plugins}
+         *
+         * If enabled, @ref parse() makes a copy of the data and data lists of
+         * @ref Type::Bool, integral and floating-point types are only scanned
+         * for their bounds and item count, without converting the literals.
+         * That's enough for @ref validate() and for querying the structure
+         * hierarchy, array sizes, names and properties. The literals are
+         * converted only when @ref Structure::as() or
+         * @ref Structure::asArray() is called on given structure for the first
+         * time, or explicitly using @ref parseDeferred(). An invalid literal
+         * is then reported only at that point. Views on the values returned
+         * earlier stay valid, however, accessing the same structure from
+         * multiple threads at the same time is not safe --- use
+         * @ref parseDeferred() on disjoint structures in that case. Data
+         * lists containing string
+         * or character literals are always parsed immediately. Default is
+         * @cpp false @ce.
+         */
+        Document& setLazy(bool lazy) {
+            _lazy = lazy;
+            return *this;
+        }
+
+        /**
+         * @brief Parse deferred data of given structure and its children
+         * @m_since_latest_{plugins}
+         *
+         * If @ref isLazy() was enabled during @ref parse(), converts literals
+         * of data lists that weren't converted yet, going recursively through
+         * all children of @p structure. If conversion of any literal fails,
+         * detailed info is printed on error output and @cpp false @ce is
+         * returned. Values of a data list that failed to parse are zero.
+         * Does nothing and returns @cpp true @ce if the document isn't lazy.
+         *
+         * Each data list is converted into its own preallocated space, so
+         * it's safe to call this function from multiple threads at the same
+         * time, as long as the structure subtrees don't overlap. All other
+         * @cpp const @ce functions of the document and of its structures and
+         * properties are safe to be called concurrently once the data are
+         * converted.
+         */
+        bool parseDeferred(Structure structure) const;
+
+        /**
+         * @brief Serialize the document into a binary blob
+         * @m_since_latest_{plugins}
+         *
+         * Stores the typed data, structure and property tables and resolved
+         * references in a flat versioned binary format, which can be loaded
+         * back with @ref deserialize() without parsing the text again. If
+         * the document is lazy, all deferred data lists are converted first.
+         * The blob can be used only on platforms with the same byte order and
+         * only with the same identifier lists that were passed to
+         * @ref parse(). If converting the deferred data lists fails, a
+         * message is printed on error output and an empty array is returned.
+         */
+        Containers::Array<char> serialize() const;
+
+        /**
+         * @brief Deserialize a binary blob
+         * @param data                      Data produced by @ref serialize()
+         * @param structureIdentifiers      Structure identifiers
+         * @param propertyIdentifiers       Property identifiers
+         * @return Whether the deserialization succeeded
+         * @m_since_latest_{plugins}
+         *
+         * Expects that the document is empty. The identifier lists are
+         * expected to be the same as the ones used when parsing the
+         * serialized document, which is checked. Data are copied out of the
+         * blob, so it can be freed or unmapped right after. If the blob is
+         * invalid, was created by a different version or on a platform with
+         * a different byte order, detailed info is printed on error output
+         * and the document has undefined contents.
+         */
+        /** @todo some sane way to ensure that the initializer lists are valid for whole Document lifetime */
+        bool deserialize(Containers::ArrayView<const char> data, std::initializer_list<CharacterLiteral> structureIdentifiers, std::initializer_list<CharacterLiteral> propertyIdentifiers);
+
         /** @brief Whether the document is empty */
         bool isEmpty() { return _structures.empty(); }
 
@@ -432,52 +551,70 @@ class MAGNUM_OPENDDL_EXPORT Document {
     private:
         struct PropertyData;
         struct StructureData;
+        struct NameIndex;
+        struct ValidationTables;
 
         MAGNUM_OPENDDL_LOCAL const char* parseProperty(Containers::ArrayView<const char> data, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& references, std::string& buffer, Int position, Implementation::ParseError& error);
         MAGNUM_OPENDDL_LOCAL std::pair<const char*, std::size_t> parseStructure(std::size_t parent, Containers::ArrayView<const char> data, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& references, std::string& buffer, Implementation::ParseError& error);
         MAGNUM_OPENDDL_LOCAL const char* parseStructureList(std::size_t parent, Containers::ArrayView<const char> data, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& references, std::string& buffer, Implementation::ParseError& error);
+        /* Called from inline Structure::as() and Structure::asArray(), so not
+           local */
+        bool parseDeferredData(const StructureData& data) const;
+
+        MAGNUM_OPENDDL_LOCAL void appendParsed(Document& other, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& references, const std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& otherReferences, std::size_t& lastTopLevel);
 
-        MAGNUM_OPENDDL_LOCAL std::size_t dereference(std::size_t originatingStructure, Containers::ArrayView<const char> reference) const;
+        MAGNUM_OPENDDL_LOCAL std::size_t dereference(const NameIndex& index, std::size_t originatingStructure, Containers::ArrayView<const char> reference) const;
 
-        MAGNUM_OPENDDL_LOCAL bool validateLevel(const Containers::Optional<Structure>& first, Containers::ArrayView<const std::pair<Int, std::pair<Int, Int>>> allowedStructures, Containers::ArrayView<const Validation::Structure> structures, std::vector<Int>& counts) const;
-        MAGNUM_OPENDDL_LOCAL bool validateStructure(Structure structure, const Validation::Structure& validation, Containers::ArrayView<const Validation::Structure> structures, std::vector<Int>& counts) const;
+        MAGNUM_OPENDDL_LOCAL bool validateLevel(const Containers::Optional<Structure>& first, Containers::ArrayView<const std::pair<Int, std::pair<Int, Int>>> allowedStructures, std::size_t bounds, ValidationTables& tables) const;
+        MAGNUM_OPENDDL_LOCAL bool validateStructure(Structure structure, const Validation::Structure& validation, std::size_t bounds, ValidationTables& tables) const;
 
         MAGNUM_OPENDDL_LOCAL const char* structureName(Int identifier) const;
         MAGNUM_OPENDDL_LOCAL const char* propertyName(Int identifier) const;
 
-        template<class T> std::vector<T>& data();
-        template<class T> const std::vector<T>& data() const;
+        template<class T> Containers::Array<T>& data();
+        template<class T> const Containers::Array<T>& data() const;
         template<Type> std::size_t dataPosition() const;
 
-        std::vector<bool> _bools;
-        std::vector<Byte> _bytes;
-        std::vector<UnsignedByte> _unsignedBytes;
-        std::vector<Short> _shorts;
-        std::vector<UnsignedShort> _unsignedShorts;
-        std::vector<Int> _ints;
-        std::vector<UnsignedInt> _unsignedInts;
+        /* Growable arrays, which for trivially copyable types grow with
+           realloc() and are contiguous even for bools */
+        Containers::Array<bool> _bools;
+        Containers::Array<Byte> _bytes;
+        Containers::Array<UnsignedByte> _unsignedBytes;
+        Containers::Array<Short> _shorts;
+        Containers::Array<UnsignedShort> _unsignedShorts;
+        Containers::Array<Int> _ints;
+        Containers::Array<UnsignedInt> _unsignedInts;
         #ifndef CORRADE_TARGET_EMSCRIPTEN
-        std::vector<Long> _longs;
-        std::vector<UnsignedLong> _unsignedLongs;
+        Containers::Array<Long> _longs;
+        Containers::Array<UnsignedLong> _unsignedLongs;
         #endif
-        /** @todo Half */
-        std::vector<Float> _floats;
-        std::vector<Double> _doubles;
-        std::vector<std::string> _strings;
-        std::vector<std::size_t> _references;
-        std::vector<Type> _types;
+        Containers::Array<Half> _halves;
+        Containers::Array<Float> _floats;
+        Containers::Array<Double> _doubles;
+        Containers::Array<std::string> _strings;
+        Containers::Array<std::size_t> _references;
+        Containers::Array<Type> _types;
 
         std::vector<PropertyData> _properties;
         std::vector<StructureData> _structures;
 
         Containers::ArrayView<const CharacterLiteral> _structureIdentifiers;
         Containers::ArrayView<const CharacterLiteral> _propertyIdentifiers;
+
+        UnsignedInt _threadCount{1};
+        bool _lazy{false};
+
+        /* Copies of the data passed to lazy parse() and ranges of data lists
+           whose literals weren't converted yet, together with index of the
+           structure they belong to */
+        std::vector<Containers::Array<char>> _lazyData;
+        std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>> _deferred;
 };
 
 #ifndef DOXYGEN_GENERATING_OUTPUT
 #define _c(T, member) \
-    template<> inline std::vector<T>& Document::data() { return member; } \
-    template<> inline const std::vector<T>& Document::data() const { return member; }
+    template<> inline Containers::Array<T>& Document::data() { return member; } \
+    template<> inline const Containers::Array<T>& Document::data() const { return member; }
 _c(bool, _bools)
 _c(UnsignedByte, _unsignedBytes)
 _c(Byte, _bytes)
@@ -489,7 +626,7 @@ _c(Int, _ints)
 _c(UnsignedLong, _unsignedLongs)
 _c(Long, _longs)
 #endif
-/** @todo Half */
+_c(Half, _halves)
 _c(Float, _floats)
 _c(Double, _doubles)
 _c(std::string, _strings)
@@ -511,7 +648,7 @@ _c(Int, Int)
 _c(UnsignedLong, UnsignedLong)
 _c(Long, Long)
 #endif
-/** @todo Half */
+_c(Half, Half)
 _c(Float, Float)
 _c(Double, Double)
 _c(String, std::string)
@@ -540,9 +677,12 @@ struct MAGNUM_OPENDDL_LOCAL Document::StructureData {
     std::size_t name;
 
     struct Primitive {
-        constexpr explicit Primitive(Type type, std::size_t subArraySize, std::size_t begin, std::size_t size) noexcept: type{type}, subArraySize{subArraySize}, begin{begin}, size{size} {}
+        constexpr explicit Primitive(Type type, std::size_t subArraySize, std::size_t begin, std::size_t size) noexcept: type{type}, deferred{false}, subArraySize{subArraySize}, begin{begin}, size{size} {}
 
         Type type;
+        /* Set if the literals weren't converted yet. Fits into padding after
+           the type. */
+        bool deferred;
         std::size_t subArraySize;
 
         std::size_t begin;
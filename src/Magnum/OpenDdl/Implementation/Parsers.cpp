@@ -29,6 +29,7 @@
 #include <limits>
 #include <tuple>
 #include <Corrade/Utility/Debug.h>
+#include <Magnum/Math/Half.h>
 
 #include "Magnum/OpenDdl/Type.h"
 
@@ -140,15 +141,20 @@ const char* whitespace(const Containers::ArrayView<const char> data) {
         /* Comment */
         else if(*i == '/' && i + 1 < data.end() && (i[1] == '*' || i[1] == '/'))
         {
+            /* If the comment is not terminated, it spans till the end of the
+               data. Not updating the position would loop forever. */
+            const char* const begin = i;
+            i = data.end();
+
             /* Single-line comment */
-            if(i[1] == '/') for(const char* j = i + 2; j != data.end(); ++j) {
+            if(begin[1] == '/') for(const char* j = begin + 2; j != data.end(); ++j) {
                 if(*j == '\n') {
                     i = j + 1;
                     break;
                 }
 
             /* Multi-line comment */
-            } else for(const char* j = i + 2; j != data.end(); ++j) {
+            } else for(const char* j = begin + 2; j != data.end(); ++j) {
                 if(*j == '*' && j + 1 != data.end() && *(j + 1) == '/') {
                     i = j + 2;
                     break;
@@ -582,7 +588,7 @@ template<class T> std::pair<const char*, T> floatingPointLiteral(const Container
         ++i;
 
         /* Exponent sign */
-        if(*i == '+' || *i == '-') ++i;
+        if(i != data.end() && (*i == '+' || *i == '-')) ++i;
 
         i = numericCharacters<10, T>(data.suffix(i), error);
     }
@@ -599,6 +605,138 @@ template<class T> std::pair<const char*, T> floatingPointLiteral(const Container
 template std::pair<const char*, Float> floatingPointLiteral<Float>(Containers::ArrayView<const char>, std::string&, ParseError&);
 template std::pair<const char*, Double> floatingPointLiteral<Double>(Containers::ArrayView<const char>, std::string&, ParseError&);
 
+std::pair<const char*, Half> halfLiteral(const Containers::ArrayView<const char> data, std::string& buffer, ParseError& error) {
+    /* Propagate errors */
+    if(!data) return {};
+
+    if(data.empty()) {
+        error = {ParseErrorType::ExpectedLiteral, Type::Half, data};
+        return {};
+    }
+
+    const char* i = data;
+
+    /* Sign */
+    bool negative = false;
+    if(*i == '+') ++i;
+    else if(*i == '-') {
+        negative = true;
+        ++i;
+    }
+
+    /* Binary literal specifies the bits directly, the sign flips the sign
+       bit the same as with floats */
+    if(i + 1 < data.end() && *i == '0' && isBinaryPrefix(i[1])) {
+        UnsignedShort bits{};
+        switch(i[1]) {
+            case 'x':
+            case 'X':
+                std::tie(i, bits) = baseNLiteral<16, UnsignedShort>(data.suffix(i + 2), buffer, error);
+                break;
+            case 'o':
+            case 'O':
+                std::tie(i, bits) = baseNLiteral<8, UnsignedShort>(data.suffix(i + 2), buffer, error);
+                break;
+            case 'b':
+            case 'B':
+                std::tie(i, bits) = baseNLiteral<2, UnsignedShort>(data.suffix(i + 2), buffer, error);
+                break;
+
+            default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+        }
+
+        /* Report errors as happening in a half literal */
+        if(!i) {
+            error.type = Type::Half;
+            return {};
+        }
+
+        return {i, Half{UnsignedShort(negative ? bits ^ 0x8000 : bits)}};
+    }
+
+    /* Decimal literals are parsed as floats and then packed */
+    Float value;
+    if(!(i = decimalFloatingPointLiteral<Float>(data, value)))
+        std::tie(i, value) = floatingPointLiteral<Float>(data, buffer, error);
+    if(!i) {
+        error.type = Type::Half;
+        return {};
+    }
+
+    return {i, Half{value}};
+}
+
+namespace {
+
+/* Powers of ten that are exactly representable in a double */
+constexpr Double ExactPowersOfTen[]{
+    1.0e0, 1.0e1, 1.0e2, 1.0e3, 1.0e4, 1.0e5, 1.0e6, 1.0e7, 1.0e8, 1.0e9,
+    1.0e10, 1.0e11, 1.0e12, 1.0e13, 1.0e14, 1.0e15, 1.0e16, 1.0e17, 1.0e18,
+    1.0e19, 1.0e20, 1.0e21, 1.0e22
+};
+
+}
+
+template<class T> const char* decimalFloatingPointLiteral(const Containers::ArrayView<const char> data, T& out) {
+    if(!data || data.empty()) return nullptr;
+
+    const char* i = data.begin();
+    const char* const end = data.end();
+    const bool negative = *i == '-';
+    if(*i == '-' || *i == '+') ++i;
+
+    /* At least one digit before the dot, anything else (such as .5 or binary
+       literals) goes through the generic path */
+    if(i == end || !isBaseN<10>(*i)) return nullptr;
+
+    /* At most 19 significant digits, so the mantissa doesn't overflow */
+    UnsignedLong mantissa = 0;
+    Int exponent = 0;
+    Int significantDigits = 0;
+    for(; i != end && isBaseN<10>(*i); ++i) {
+        if((mantissa || *i != '0') && ++significantDigits > 19) return nullptr;
+        mantissa = mantissa*10 + (*i - '0');
+    }
+
+    /* Same as in floatingPointLiteral(), the dot is not consumed if it's the
+       last character */
+    if(i + 1 < end && *i == '.') for(++i; i != end && isBaseN<10>(*i); ++i) {
+        if((mantissa || *i != '0') && ++significantDigits > 19) return nullptr;
+        mantissa = mantissa*10 + (*i - '0');
+        --exponent;
+    }
+
+    if(i != end && (*i == 'e' || *i == 'E')) {
+        ++i;
+        const bool negativeExponent = i != end && *i == '-';
+        if(i != end && (*i == '-' || *i == '+')) ++i;
+        if(i == end || !isBaseN<10>(*i)) return nullptr;
+        Int value = 0;
+        for(; i != end && isBaseN<10>(*i); ++i)
+            if(value < 100000) value = value*10 + (*i - '0');
+        exponent += negativeExponent ? -value : value;
+    }
+
+    /* Underscores, suffixes or anything else unusual directly after the
+       literal are handled (or reported) by the generic path */
+    if(i != end && (*i == '_' || *i == '.' || isBaseN<10>(*i) || (*i >= 'a' && *i <= 'z') || (*i >= 'A' && *i <= 'Z')))
+        return nullptr;
+
+    /* A single multiplication or division of exactly representable values
+       gives a correctly rounded double. Rounding that to a float again is
+       also correct, as double has more than twice the float precision. */
+    if(mantissa >= (1ull << 53) || exponent < -22 || exponent > 22)
+        return nullptr;
+    Double value = Double(mantissa);
+    if(exponent < 0) value /= ExactPowersOfTen[-exponent];
+    else value *= ExactPowersOfTen[exponent];
+    out = T(negative ? -value : value);
+    return i;
+}
+
+template const char* decimalFloatingPointLiteral<Float>(Containers::ArrayView<const char>, Float&);
+template const char* decimalFloatingPointLiteral<Double>(Containers::ArrayView<const char>, Double&);
+
 std::pair<const char*, std::string> stringLiteral(const Containers::ArrayView<const char> data, ParseError& error) {
     /* Propagate errors */
     if(!data) return {};
@@ -704,7 +842,9 @@ std::pair<const char*, Type> possiblyTypeLiteral(const Containers::ArrayView<con
     _c(unsigned_int64, UnsignedLong)
     _c(int64, Long)
     #endif
-    /** @todo Half */
+    /* Needs to be before float so it's not matched as a prefix of it */
+    _c(float16, Half)
+    _c(half, Half)
     _c(float, Float)
     _c(double, Double)
     _c(string, String)
@@ -733,6 +873,101 @@ std::pair<const char*, Type> typeLiteral(const Containers::ArrayView<const char>
     return {};
 }
 
+namespace {
+
+/* Skips a string or character literal starting at given quote character,
+   returning pointer after the terminating quote */
+const char* skipQuoted(const Containers::ArrayView<const char> data, ParseError& error) {
+    const char quote = *data;
+    for(const char* i = data + 1; i != data.end(); ++i) {
+        if(*i == '\\') {
+            if(++i == data.end()) break;
+        } else if(*i == quote) return i + 1;
+    }
+
+    error = {ParseErrorType::LiteralOutOfRange, Type::String};
+    return nullptr;
+}
+
+}
+
+const char* skipPropertyValue(const Containers::ArrayView<const char> data, ParseError& error) {
+    /* Propagate errors */
+    if(!data) return {};
+
+    if(data.empty()) {
+        error = {ParseErrorType::ExpectedPropertyValue};
+        return {};
+    }
+
+    /* String literal, possibly with continuations */
+    if(*data == '"') {
+        const char* i = data;
+        for(;;) {
+            i = skipQuoted(data.suffix(i), error);
+            if(!i) return {};
+
+            const char* const j = whitespace(data.suffix(i));
+            if(j == data.end() || *j != '"') return i;
+            i = j;
+        }
+    }
+
+    /* Reference literal */
+    if(*data == '%' || *data == '$')
+        return referenceLiteral(data, error).first;
+
+    /* Numeric, character, boolean, null or type literal. Character literals
+       can be preceded by a sign. */
+    const char* i = data;
+    if(*i == '+' || *i == '-') ++i;
+    if(i != data.end() && *i == '\'') return skipQuoted(data.suffix(i), error);
+    while(i != data.end() && *i > 32 && *i != ',' && *i != ')' && *i != '/') ++i;
+
+    if(i == data) {
+        error = {ParseErrorType::InvalidPropertyValue, data};
+        return {};
+    }
+
+    return i;
+}
+
+const char* skipDataList(const Containers::ArrayView<const char> data, ParseError& error) {
+    /* Propagate errors */
+    if(!data) return {};
+
+    /* Find the brace matching the (already consumed) list start, skipping
+       over subarrays, literals and comments */
+    std::size_t depth = 0;
+    const char* i = data;
+    while(i && i != data.end()) {
+        if(*i == '"' || *i == '\'') {
+            i = skipQuoted(data.suffix(i), error);
+            continue;
+        }
+
+        const char* const j = whitespace(data.suffix(i));
+        if(j != i) {
+            i = j;
+            continue;
+        }
+
+        if(*i == '{') ++depth;
+        else if(*i == '}') {
+            if(!depth) return i;
+            --depth;
+        }
+
+        ++i;
+    }
+
+    /* Propagate errors */
+    if(!i) return {};
+
+    error = {ParseErrorType::ExpectedListEnd, data.end()};
+    return {};
+}
+
 std::pair<const char*, InternalPropertyType> propertyValue(const Containers::ArrayView<const char> data, bool& boolValue, Int& integerValue, Float& floatingPointValue, std::string& stringValue, Containers::ArrayView<const char>& referenceValue, Type& typeValue, std::string& buffer, ParseError& error) {
     /* Propagate errors */
     if(!data) return {};
@@ -91,12 +91,25 @@ std::pair<const char*, bool> boolLiteral(Containers::ArrayView<const char> data,
 std::pair<const char*, char> characterLiteral(Containers::ArrayView<const char> data, ParseError& error);
 template<class T> std::tuple<const char*, T, Int> integralLiteral(Containers::ArrayView<const char> data, std::string& buffer, ParseError& error);
 template<class T> std::pair<const char*, T> floatingPointLiteral(Containers::ArrayView<const char> data, std::string& buffer, ParseError& error);
+/* Fast path for the common case of a plain decimal floating-point literal
+   without underscores. Returns nullptr without setting any error if the
+   literal isn't in this form, floatingPointLiteral() should be used then. */
+template<class T> const char* decimalFloatingPointLiteral(Containers::ArrayView<const char> data, T& out);
+/* Binary literals are taken as the half bits, decimal literals are parsed as
+   a Float and converted */
+std::pair<const char*, Half> halfLiteral(Containers::ArrayView<const char> data, std::string& buffer, ParseError& error);
 std::pair<const char*, std::string> stringLiteral(Containers::ArrayView<const char> data, ParseError& error);
 std::pair<const char*, std::string> nameLiteral(Containers::ArrayView<const char> data, ParseError& error);
 std::pair<const char*, Containers::ArrayView<const char>> referenceLiteral(Containers::ArrayView<const char> data, ParseError& error);
 std::pair<const char*, Type> possiblyTypeLiteral(Containers::ArrayView<const char> data);
 std::pair<const char*, Type> typeLiteral(Containers::ArrayView<const char> data, ParseError& error);
 
+/* Allocation-free counterparts to propertyValue() and the data list parsing
+   used by Scanner. They only find where the literal or list ends, checking
+   just enough to not go past it. */
+const char* skipPropertyValue(Containers::ArrayView<const char> data, ParseError& error);
+const char* skipDataList(Containers::ArrayView<const char> data, ParseError& error);
+
 std::pair<const char*, InternalPropertyType> propertyValue(Containers::ArrayView<const char> data, bool& boolValue, Int& integerValue, Float& floatingPointValue, std::string& stringValue, Containers::ArrayView<const char>& referenceValue, Type& typeValue, std::string& buffer, ParseError& error);
 
 }}}
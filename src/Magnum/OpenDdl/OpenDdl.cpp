@@ -24,12 +24,18 @@
 */
 
 #include <algorithm>
+#include <cstring>
+#include <thread>
 #include <tuple>
+#include <unordered_map>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Corrade/Utility/Debug.h>
 #include <Corrade/Utility/DebugStl.h>
 
 #include "Magnum/OpenDdl/Document.h"
 #include "Magnum/OpenDdl/Property.h"
+#include "Magnum/OpenDdl/Scanner.h"
 #include "Magnum/OpenDdl/Structure.h"
 #include "Magnum/OpenDdl/Validation.h"
 
@@ -52,7 +58,7 @@ Debug& operator<<(Debug& debug, const Type value) {
         _c(UnsignedLong)
         _c(Long)
         #endif
-        /** @todo Half */
+        _c(Half)
         _c(Float)
         _c(Double)
         _c(String)
@@ -117,7 +123,7 @@ namespace Implementation {
 
 Document::Document() {
     /* First string is reserved for empty names */
-    _strings.emplace_back();
+    arrayAppend(_strings, Containers::InPlaceInit);
 }
 
 Document::~Document() = default;
@@ -158,29 +164,208 @@ bool checkReferencePrefix(Containers::Optional<Structure> s, Containers::ArrayVi
     return true;
 }
 
+void printParseError(const char* const prefix, const Containers::ArrayView<const char> data, const Implementation::ParseError& error) {
+    /* Calculate line number */
+    std::size_t line = 1;
+    for(char c: data.prefix(error.position)) if(c == '\n') ++line;
+
+    Error e;
+    e << prefix;
+
+    switch(error.error) {
+        case Implementation::ParseErrorType::InvalidEscapeSequence:
+            e << "invalid escape sequence";
+            break;
+        case Implementation::ParseErrorType::InvalidIdentifier:
+            e << "invalid identifier";
+            break;
+        case Implementation::ParseErrorType::InvalidName:
+            e << "invalid name";
+            break;
+        case Implementation::ParseErrorType::InvalidCharacterLiteral:
+            e << "invalid character literal";
+            break;
+        case Implementation::ParseErrorType::InvalidPropertyValue:
+            e << "invalid property value";
+            break;
+        case Implementation::ParseErrorType::InvalidSubArraySize:
+            e << "invalid subarray size";
+            break;
+        case Implementation::ParseErrorType::LiteralOutOfRange:
+            e << (error.type == Type::String ? "unterminated string literal" : "numeric literal out of range");
+            break;
+        case Implementation::ParseErrorType::ExpectedIdentifier:
+            e << "expected identifier";
+            break;
+        case Implementation::ParseErrorType::ExpectedName:
+            e << "expected name";
+            break;
+        case Implementation::ParseErrorType::ExpectedSeparator:
+            e << "expected , character";
+            break;
+        case Implementation::ParseErrorType::ExpectedListStart:
+            e << "expected { character";
+            break;
+        case Implementation::ParseErrorType::ExpectedListEnd:
+            e << "expected } character";
+            break;
+        case Implementation::ParseErrorType::ExpectedArraySizeEnd:
+            e << "expected ] character";
+            break;
+        case Implementation::ParseErrorType::ExpectedPropertyValue:
+            e << "expected property value";
+            break;
+        case Implementation::ParseErrorType::ExpectedPropertyAssignment:
+            e << "expected = character";
+            break;
+        case Implementation::ParseErrorType::ExpectedPropertyListEnd:
+            e << "expected ) character";
+            break;
+
+        case Implementation::ParseErrorType::InvalidLiteral:
+        case Implementation::ParseErrorType::ExpectedLiteral: {
+            e << (error.error == Implementation::ParseErrorType::InvalidLiteral ? "invalid" : "expected");
+
+            switch(error.type) {
+                #define _c(type, identifier) \
+                    case Type::type: e << #identifier; break;
+                _c(Bool, bool)
+                _c(Byte, int8)
+                _c(UnsignedByte, unsigned_int8)
+                _c(Short, int16)
+                _c(UnsignedShort, unsigned_int16)
+                _c(Int, int32)
+                _c(UnsignedInt, unsigned_int32)
+                #ifndef CORRADE_TARGET_EMSCRIPTEN
+                _c(Long, int64)
+                _c(UnsignedLong, unsigned_int64)
+                #endif
+                _c(Half, half)
+                _c(Float, float)
+                _c(Double, double)
+                _c(String, string)
+                _c(Reference, ref)
+                _c(Type, type)
+                #undef _c
+                case Type::Custom:
+                    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+            }
+
+            e << "literal";
+
+            break;
+        }
+
+        case Implementation::ParseErrorType::NoError:
+            CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    }
+
+    e << "on line" << line;
+}
+
+/* Chunks smaller than this aren't worth the thread creation overhead */
+constexpr std::size_t MinParallelChunkSize = 16384;
+
+/* Splits a top-level structure list into at most count chunks of roughly
+   equal size, each containing only whole structures. Only braces are
+   matched, skipping over comments, string and character literals. If the
+   data contain something unexpected such as an unterminated literal or
+   unbalanced braces, an empty array is returned and the data are parsed
+   serially, which then reports the error. */
+Containers::Array<Containers::ArrayView<const char>> splitStructureList(const Containers::ArrayView<const char> data, const std::size_t count) {
+    Containers::Array<Containers::ArrayView<const char>> chunks;
+    const std::size_t chunkSize = data.size()/count;
+
+    const char* chunkBegin = data;
+    std::size_t depth = 0;
+    for(const char* i = data; i != data.end(); ++i) {
+        /* String or character literal, skip until the terminating quote */
+        if(*i == '"' || *i == '\'') {
+            const char quote = *i;
+            for(++i; i != data.end() && *i != quote; ++i)
+                if(*i == '\\' && ++i == data.end()) break;
+            if(i == data.end()) return {};
+
+        /* Comment */
+        } else if(*i == '/' && i + 1 != data.end() && (i[1] == '/' || i[1] == '*')) {
+            if(i[1] == '/') {
+                for(i += 2; i != data.end() && *i != '\n'; ++i);
+                if(i == data.end()) break;
+            } else {
+                for(i += 2; i + 1 < data.end() && !(*i == '*' && i[1] == '/'); ++i);
+                if(i + 1 >= data.end()) return {};
+                ++i;
+            }
+
+        } else if(*i == '{') ++depth;
+
+        else if(*i == '}') {
+            /* Unbalanced brace, let the parser complain */
+            if(!depth) return {};
+
+            /* End of a top-level structure, cut the chunk if it's large
+               enough and it's not the last */
+            if(!--depth && std::size_t(i + 1 - chunkBegin) >= chunkSize && chunks.size() + 1 < count) {
+                arrayAppend(chunks, Containers::InPlaceInit, chunkBegin, i + 1 - chunkBegin);
+                chunkBegin = Implementation::whitespace(data.suffix(i + 1));
+                i = chunkBegin - 1;
+            }
+        }
+    }
+
+    if(depth) return {};
+
+    /* The rest, if any */
+    if(chunkBegin != data.end())
+        arrayAppend(chunks, Containers::InPlaceInit, chunkBegin, data.end() - chunkBegin);
+
+    return chunks;
+}
+
+}
+
+namespace {
+
+struct ScopedNameHash {
+    std::size_t operator()(const std::pair<std::size_t, std::string>& key) const {
+        return std::hash<std::string>{}(key.second)*31 + key.first;
+    }
+};
+
 }
 
-std::size_t Document::dereference(const std::size_t originatingStructure, const Containers::ArrayView<const char> reference) const {
+/* Built once after parsing so each reference is resolved with a hash lookup
+   instead of searching through all structures */
+struct Document::NameIndex {
+    /* All structures of given name, in the order they appear in the document,
+       so the first one with a matching reference prefix wins */
+    std::unordered_map<std::string, std::vector<std::size_t>> structures;
+
+    /* First structure of given name among children of given parent, for
+       resolving local names in the scope of the originating structure */
+    std::unordered_map<std::pair<std::size_t, std::string>, std::size_t, ScopedNameHash> scoped;
+};
+
+std::size_t Document::dereference(const NameIndex& index, const std::size_t originatingStructure, const Containers::ArrayView<const char> reference) const {
     CORRADE_INTERNAL_ASSERT(!reference.empty());
 
-    const Containers::ArrayView<const char> leafName = reference.suffix(Implementation::findLastOf(reference, "$%"));
+    const Containers::ArrayView<const char> leafNameView = reference.suffix(Implementation::findLastOf(reference, "$%"));
+    const std::string leafName{leafNameView.data(), leafNameView.size()};
 
     /* If the reference is a single local name, try to find in in siblings first */
-    if(leafName.begin() == reference.begin() && reference[0] == '%') {
-        const std::size_t parentIndex = _structures[originatingStructure].parent;
-        std::size_t i = parentIndex == NoParent ? 0 : _structures[parentIndex].custom.firstChild;
-        for(Containers::Optional<Structure> s{Structure{*this, _structures[i]}}; s; i = s->_data.get().next, s = s->findNext())
-            if(Implementation::equals(leafName, {s->name().data(), s->name().size()})) return i;
+    if(leafNameView.begin() == reference.begin() && reference[0] == '%') {
+        const auto found = index.scoped.find({_structures[originatingStructure].parent, leafName});
+        if(found != index.scoped.end()) return found->second;
     }
 
     /* The element which has leaf name is the result if also the rest of the
        reference prefix matches in parent structures */
-    const Containers::ArrayView<const char> referencePrefix = reference.prefix(leafName.begin());
-    for(std::size_t i = 0; i != _structures.size(); ++i) {
-        const Structure s{*this, _structures[i]};
-        if(s.hasName() && Implementation::equals(leafName, {s.name().data(), s.name().size()}) && checkReferencePrefix(s.parent(), referencePrefix))
+    const auto found = index.structures.find(leafName);
+    if(found == index.structures.end()) return NullReference;
+    const Containers::ArrayView<const char> referencePrefix = reference.prefix(leafNameView.begin());
+    for(const std::size_t i: found->second)
+        if(checkReferencePrefix(Structure{*this, _structures[i]}.parent(), referencePrefix))
             return i;
-    }
 
     return NullReference;
 }
@@ -189,128 +374,114 @@ bool Document::parse(Containers::ArrayView<const char> data, const std::initiali
     _structureIdentifiers = {structureIdentifiers.begin(), structureIdentifiers.size()};
     _propertyIdentifiers = {propertyIdentifiers.begin(), propertyIdentifiers.size()};
 
+    /* In lazy mode the deferred data lists get parsed after this function
+       exits, so operate on a copy of the data */
+    if(_lazy) {
+        _lazyData.emplace_back(Containers::NoInit, data.size());
+        std::copy(data.begin(), data.end(), _lazyData.back().begin());
+        data = _lazyData.back();
+    }
+
     Implementation::ParseError error;
     std::string buffer;
 
     const char* i = Implementation::whitespace(data);
     std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>> references;
-    i = parseStructureList(NoParent, data.suffix(i), references, buffer, error);
-
-    if(!i) {
-        /* Calculate line number */
-        std::size_t line = 1;
-        for(char c: data.prefix(error.position)) if(c == '\n') ++line;
-
-        Error e;
-        e << "OpenDdl::Document::parse():";
-
-        switch(error.error) {
-            case Implementation::ParseErrorType::InvalidEscapeSequence:
-                e << "invalid escape sequence";
-                break;
-            case Implementation::ParseErrorType::InvalidIdentifier:
-                e << "invalid identifier";
-                break;
-            case Implementation::ParseErrorType::InvalidName:
-                e << "invalid name";
-                break;
-            case Implementation::ParseErrorType::InvalidCharacterLiteral:
-                e << "invalid character literal";
-                break;
-            case Implementation::ParseErrorType::InvalidPropertyValue:
-                e << "invalid property value";
-                break;
-            case Implementation::ParseErrorType::InvalidSubArraySize:
-                e << "invalid subarray size";
-                break;
-            case Implementation::ParseErrorType::LiteralOutOfRange:
-                e << (error.type == Type::String ? "unterminated string literal" : "numeric literal out of range");
-                break;
-            case Implementation::ParseErrorType::ExpectedIdentifier:
-                e << "expected identifier";
-                break;
-            case Implementation::ParseErrorType::ExpectedName:
-                e << "expected name";
-                break;
-            case Implementation::ParseErrorType::ExpectedSeparator:
-                e << "expected , character";
-                break;
-            case Implementation::ParseErrorType::ExpectedListStart:
-                e << "expected { character";
-                break;
-            case Implementation::ParseErrorType::ExpectedListEnd:
-                e << "expected } character";
-                break;
-            case Implementation::ParseErrorType::ExpectedArraySizeEnd:
-                e << "expected ] character";
-                break;
-            case Implementation::ParseErrorType::ExpectedPropertyValue:
-                e << "expected property value";
-                break;
-            case Implementation::ParseErrorType::ExpectedPropertyAssignment:
-                e << "expected = character";
-                break;
-            case Implementation::ParseErrorType::ExpectedPropertyListEnd:
-                e << "expected ) character";
-                break;
-
-            case Implementation::ParseErrorType::InvalidLiteral:
-            case Implementation::ParseErrorType::ExpectedLiteral: {
-                e << (error.error == Implementation::ParseErrorType::InvalidLiteral ? "invalid" : "expected");
 
-                switch(error.type) {
-                    #define _c(type, identifier) \
-                        case Type::type: e << #identifier; break;
-                    _c(Bool, bool)
-                    _c(Byte, int8)
-                    _c(UnsignedByte, unsigned_int8)
-                    _c(Short, int16)
-                    _c(UnsignedShort, unsigned_int16)
-                    _c(Int, int32)
-                    _c(UnsignedInt, unsigned_int32)
-                    #ifndef CORRADE_TARGET_EMSCRIPTEN
-                    _c(Long, int64)
-                    _c(UnsignedLong, unsigned_int64)
-                    #endif
-                    /** @todo Half */
-                    _c(Float, float)
-                    _c(Double, double)
-                    _c(String, string)
-                    _c(Reference, ref)
-                    _c(Type, type)
-                    #undef _c
-                    case Type::Custom:
-                        CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
-                }
+    /* If parsing on multiple threads, split the top-level structure list into
+       chunks */
+    UnsignedInt threadCount = _threadCount;
+    if(!threadCount) threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    Containers::Array<Containers::ArrayView<const char>> chunks;
+    const Containers::ArrayView<const char> structureList = data.suffix(i);
+    const std::size_t chunkCount = std::min(std::size_t{threadCount}, structureList.size()/MinParallelChunkSize);
+    if(chunkCount > 1) chunks = splitStructureList(structureList, chunkCount);
+
+    if(chunks.size() > 1) {
+        struct Chunk {
+            Containers::Pointer<Document> document;
+            std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>> references;
+            std::string buffer;
+            Implementation::ParseError error;
+            const char* end;
+        };
+
+        /* The first chunk is parsed directly into this document on the
+           calling thread, the others into temporary documents that are
+           merged into this one afterwards */
+        Containers::Array<Chunk> parsed{chunks.size()};
+        for(std::size_t j = 1; j != chunks.size(); ++j) {
+            parsed[j].document = Containers::Pointer<Document>{Containers::InPlaceInit};
+            parsed[j].document->_structureIdentifiers = _structureIdentifiers;
+            parsed[j].document->_propertyIdentifiers = _propertyIdentifiers;
+            parsed[j].document->_lazy = _lazy;
+        }
 
-                e << "literal";
+        const std::size_t listStart = _structures.size();
+        auto parseChunk = [&](const std::size_t id) {
+            Chunk& chunk = parsed[id];
+            Document& document = id ? *chunk.document : *this;
+            chunk.end = document.parseStructureList(NoParent, chunks[id], chunk.references, chunk.buffer, chunk.error);
+        };
+        Containers::Array<std::thread> threads{chunks.size() - 1};
+        for(std::size_t j = 1; j != chunks.size(); ++j)
+            threads[j - 1] = std::thread{parseChunk, j};
+        parseChunk(0);
+        for(std::thread& thread: threads) thread.join();
+
+        /* Report the first error in the document, which is the same one the
+           serial parsing would report */
+        for(const Chunk& chunk: parsed) if(!chunk.end) {
+            printParseError("OpenDdl::Document::parse():", data, chunk.error);
+            return false;
+        }
 
+        /* Find the last top-level structure of the first chunk, which needs
+           to get linked to the first structure of the second chunk */
+        std::size_t lastTopLevel = NoParent;
+        for(std::size_t j = _structures.size(); j != listStart; --j) {
+            if(_structures[j - 1].parent == NoParent) {
+                lastTopLevel = j - 1;
                 break;
             }
-
-            case Implementation::ParseErrorType::NoError:
-                CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
         }
 
-        e << "on line" << line;
+        references = std::move(parsed[0].references);
+        for(std::size_t j = 1; j != parsed.size(); ++j)
+            appendParsed(*parsed[j].document, references, parsed[j].references, lastTopLevel);
 
-        return false;
+    } else {
+        i = parseStructureList(NoParent, structureList, references, buffer, error);
+
+        if(!i) {
+            printParseError("OpenDdl::Document::parse():", data, error);
+            return false;
+        }
     }
 
     /* Everything parsed, dereference references */
+    NameIndex index;
+    if(!references.empty()) for(std::size_t j = 0; j != _structures.size(); ++j) {
+        const StructureData& structure = _structures[j];
+        if(!structure.name) continue;
+
+        const std::string& name = _strings[structure.name];
+        index.structures[name].push_back(j);
+        index.scoped.emplace(std::make_pair(structure.parent, name), j);
+    }
     for(const std::pair<std::size_t, Containers::ArrayView<const char>> reference: references) {
         /* Null reference */
         if(reference.second.empty())
-            _references.push_back(NullReference);
+            arrayAppend(_references, std::size_t(NullReference));
 
         /* Non-null, try to dereference */
         else {
-            std::size_t r = dereference(reference.first, reference.second);
+            std::size_t r = dereference(index, reference.first, reference.second);
             if(r == NullReference) {
                 Error() << "OpenDdl::Document::parse(): reference" << std::string{reference.second, reference.second.size()} << "was not found";
                 return false;
             }
-            _references.push_back(r);
+            arrayAppend(_references, r);
         }
     }
 
@@ -335,21 +506,21 @@ const char* Document::parseProperty(const Containers::ArrayView<const char> data
     switch(type) {
         case Implementation::InternalPropertyType::Bool:
             position = _bools.size();
-            _bools.push_back(boolValue);
+            arrayAppend(_bools, boolValue);
             break;
         case Implementation::InternalPropertyType::Binary:
         case Implementation::InternalPropertyType::Character:
         case Implementation::InternalPropertyType::Integral:
             position = _ints.size();
-            _ints.push_back(integerValue);
+            arrayAppend(_ints, integerValue);
             break;
         case Implementation::InternalPropertyType::Float:
             position = _floats.size();
-            _floats.push_back(floatValue);
+            arrayAppend(_floats, floatValue);
             break;
         case Implementation::InternalPropertyType::String:
             position = _strings.size();
-            _strings.push_back(stringValue);
+            arrayAppend(_strings, Containers::InPlaceInit, std::move(stringValue));
             break;
         case Implementation::InternalPropertyType::Reference:
             position = references.size();
@@ -359,7 +530,7 @@ const char* Document::parseProperty(const Containers::ArrayView<const char> data
             break;
         case Implementation::InternalPropertyType::Type:
             position = _types.size();
-            _types.push_back(typeValue);
+            arrayAppend(_types, typeValue);
             break;
     }
 
@@ -369,22 +540,40 @@ const char* Document::parseProperty(const Containers::ArrayView<const char> data
 
 namespace Implementation {
 
+/* Reserves space for at least count more items, growing the capacity
+   geometrically so repeated reservations for many small lists don't cause a
+   reallocation each time */
+template<class T> void reserveDataListItems(Containers::Array<T>& array, const std::size_t count) {
+    const std::size_t desired = array.size() + count;
+    const std::size_t capacity = Containers::arrayCapacity(array);
+    if(desired > capacity)
+        Containers::arrayReserve(array, std::max(desired, 2*capacity));
+}
+
 template<> struct ExtractDataListItem<Type::Bool> {
+    static void reserve(Document& document, const std::size_t count) {
+        reserveDataListItems(document.data<bool>(), count);
+    }
+
     static const char* extract(const Containers::ArrayView<const char> data, Document& document, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>&, std::string&, Implementation::ParseError& error) {
         const char* i;
         bool value;
         std::tie(i, value) = Implementation::boolLiteral(data, error);
-        document.data<bool>().push_back(value);
+        arrayAppend(document.data<bool>(), value);
         return i;
     }
 };
 
 template<class T> struct ExtractIntegralDataListItem {
+    static void reserve(Document& document, const std::size_t count) {
+        reserveDataListItems(document.data<T>(), count);
+    }
+
     static const char* extract(const Containers::ArrayView<const char> data, Document& document, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>&, std::string& buffer, Implementation::ParseError& error) {
         const char* i;
         T value;
         std::tie(i, value, std::ignore) = Implementation::integralLiteral<T>(data, buffer, error);
-        document.data<T>().push_back(value);
+        arrayAppend(document.data<T>(), value);
         return i;
     }
 };
@@ -403,32 +592,62 @@ _c(Long)
 #undef _c
 
 template<class T> struct ExtractFloatingPointDataListItem {
+    static void reserve(Document& document, const std::size_t count) {
+        reserveDataListItems(document.data<T>(), count);
+    }
+
     static const char* extract(const Containers::ArrayView<const char> data, Document& document, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>&, std::string& buffer, Implementation::ParseError& error) {
-        const char* i;
+        /* Most vertex data are plain decimal literals, parse those directly
+           without going through the buffer */
         T value;
+        if(const char* const i = Implementation::decimalFloatingPointLiteral<T>(data, value)) {
+            arrayAppend(document.data<T>(), value);
+            return i;
+        }
+
+        const char* i;
         std::tie(i, value) = Implementation::floatingPointLiteral<T>(data, buffer, error);
-        document.data<T>().push_back(value);
+        arrayAppend(document.data<T>(), value);
         return i;
     }
 };
 #define _c(T) \
     template<> struct ExtractDataListItem<Type::T>: ExtractFloatingPointDataListItem<T> {};
-/** @todo Half */
 _c(Float)
 _c(Double)
 #undef _c
 
+template<> struct ExtractDataListItem<Type::Half> {
+    static void reserve(Document& document, const std::size_t count) {
+        reserveDataListItems(document.data<Half>(), count);
+    }
+
+    static const char* extract(const Containers::ArrayView<const char> data, Document& document, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>&, std::string& buffer, Implementation::ParseError& error) {
+        const char* i;
+        Half value;
+        std::tie(i, value) = Implementation::halfLiteral(data, buffer, error);
+        arrayAppend(document.data<Half>(), value);
+        return i;
+    }
+};
+
 template<> struct ExtractDataListItem<Type::String> {
+    static void reserve(Document& document, const std::size_t count) {
+        reserveDataListItems(document.data<std::string>(), count);
+    }
+
     static const char* extract(const Containers::ArrayView<const char> data, Document& document, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>&, std::string&, Implementation::ParseError& error) {
         const char* i;
         std::string value;
         std::tie(i, value) = Implementation::stringLiteral(data, error);
-        document.data<std::string>().push_back(std::move(value));
+        arrayAppend(document.data<std::string>(), Containers::InPlaceInit, std::move(value));
         return i;
     }
 };
 
 template<> struct ExtractDataListItem<Type::Reference> {
+    static void reserve(Document&, std::size_t) {}
+
     static const char* extract(const Containers::ArrayView<const char> data, Document& document, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& references, std::string&, Implementation::ParseError& error) {
         const char* i;
         Containers::ArrayView<const char> value;
@@ -441,11 +660,15 @@ template<> struct ExtractDataListItem<Type::Reference> {
 };
 
 template<> struct ExtractDataListItem<Type::Type> {
+    static void reserve(Document& document, const std::size_t count) {
+        reserveDataListItems(document.data<Type>(), count);
+    }
+
     static const char* extract(const Containers::ArrayView<const char> data, Document& document, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>&, std::string&, Implementation::ParseError& error) {
         const char* i;
         Type value;
         std::tie(i, value) = Implementation::typeLiteral(data, error);
-        document.data<Type>().push_back(value);
+        arrayAppend(document.data<Type>(), value);
         return i;
     }
 };
@@ -477,7 +700,25 @@ template<Type type> std::pair<const char*, std::size_t> dataList(const Container
     return {i, j};
 }
 
+/* Upper bound on the item count in a data list, counting separators until
+   the list end. Literals containing commas or braces (strings, character
+   literals) make it imprecise, but it's used just as a hint for reserving the
+   storage. */
+std::size_t estimateDataListSize(const Containers::ArrayView<const char> data) {
+    std::size_t count = 1;
+    Int depth = 0;
+    for(const char c: data) {
+        if(c == ',') ++count;
+        else if(c == '{') ++depth;
+        else if(c == '}' && !depth--) break;
+    }
+    return count;
+}
+
 template<Type type> std::pair<const char*, std::size_t> dataArrayList(const Containers::ArrayView<const char> data, Document& document, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& references, std::string& buffer, const std::size_t subArraySize, Implementation::ParseError& error) {
+    /* Reserve the storage upfront instead of growing it item by item */
+    Implementation::ExtractDataListItem<type>::reserve(document, estimateDataListSize(data));
+
     if(!subArraySize) return dataList<type>(data, document, references, buffer, error);
 
     const char* i = data;
@@ -529,6 +770,67 @@ template<Type type> std::pair<const char*, std::size_t> dataArrayList(const Cont
     return {i, j*subArraySize};
 }
 
+/* Finds the end of a numeric data list and counts its items without
+   converting the literals, following the same grammar as dataArrayList().
+   Returns nullptr if anything unexpected is found, in which case the list is
+   parsed immediately, reporting the error. String and character literals
+   are treated as unexpected as well, as they could contain separators. */
+std::pair<const char*, std::size_t> scanDataList(const Containers::ArrayView<const char> data, const std::size_t subArraySize) {
+    /* Skips a single literal, returning the original pointer if there's
+       none */
+    auto literal = [&data](const char* i) {
+        while(i != data.end() && *i > 32 && *i != ',' && *i != '{' && *i != '}' && *i != '/' && *i != '"' && *i != '\'') ++i;
+        return i;
+    };
+
+    const std::size_t itemsPerGroup = subArraySize ? subArraySize : 1;
+    const char* i = data;
+    std::size_t j = 0;
+    for(;;) {
+        if(i == data.end()) return {};
+
+        /* Empty list */
+        if(*i == '}' && !j) return {i, 0};
+
+        if(subArraySize) {
+            if(*i != '{') return {};
+            i = Implementation::whitespace(data.suffix(i + 1));
+        }
+
+        for(std::size_t k = 0; k != itemsPerGroup; ++k) {
+            if(k) {
+                if(i == data.end() || *i != ',') return {};
+                i = Implementation::whitespace(data.suffix(i + 1));
+            }
+
+            const char* const end = literal(i);
+            if(end == i) return {};
+            i = Implementation::whitespace(data.suffix(end));
+        }
+
+        if(subArraySize) {
+            if(i == data.end() || *i != '}') return {};
+            i = Implementation::whitespace(data.suffix(i + 1));
+        }
+
+        ++j;
+
+        if(i == data.end()) return {};
+        if(*i == '}') return {i, j*itemsPerGroup};
+        if(*i != ',') return {};
+        i = Implementation::whitespace(data.suffix(i + 1));
+    }
+}
+
+/* Adds zero-initialized space for a data list that gets parsed later,
+   returning its position */
+template<class T> std::size_t deferDataList(Containers::Array<T>& array, const std::size_t count) {
+    const std::size_t begin = array.size();
+    Implementation::reserveDataListItems(array, count);
+    arrayResize(array, begin + count);
+    return begin;
+}
+
 Int identifierId(const Containers::ArrayView<const char> data, Containers::ArrayView<const CharacterLiteral> identifiers) {
     Int i = 0;
     for(const Containers::ArrayView<const char> identifier: identifiers) {
@@ -585,7 +887,7 @@ std::pair<const char*, std::size_t> Document::parseStructure(const std::size_t p
             std::string s;
             std::tie(i, s) = Implementation::nameLiteral(data.suffix(i), error);
             name = _strings.size();
-            _strings.push_back(std::move(s));
+            arrayAppend(_strings, Containers::InPlaceInit, std::move(s));
 
             i = Implementation::whitespace(data.suffix(i));
         }
@@ -602,7 +904,44 @@ std::pair<const char*, std::size_t> Document::parseStructure(const std::size_t p
         i = Implementation::whitespace(data.suffix(i + 1));
 
         std::size_t dataBegin = 0, dataSize = 0;
-        switch(type) {
+
+        /* In lazy mode only find bounds of non-empty numeric data lists,
+           the literals get converted on first access */
+        const char* deferredEnd = nullptr;
+        if(_lazy && type != Type::String && type != Type::Reference && type != Type::Type)
+            std::tie(deferredEnd, dataSize) = scanDataList(data.suffix(i), subArraySize);
+        if(deferredEnd && dataSize) {
+            switch(type) {
+                #define _c(type, T) \
+                case Type::type: \
+                    dataBegin = deferDataList(this->data<T>(), dataSize); \
+                    break;
+                _c(Bool, bool)
+                _c(UnsignedByte, UnsignedByte)
+                _c(Byte, Byte)
+                _c(UnsignedShort, UnsignedShort)
+                _c(Short, Short)
+                _c(UnsignedInt, UnsignedInt)
+                _c(Int, Int)
+                #ifndef CORRADE_TARGET_EMSCRIPTEN
+                _c(UnsignedLong, UnsignedLong)
+                _c(Long, Long)
+                #endif
+                _c(Half, Half)
+                _c(Float, Float)
+                _c(Double, Double)
+                #undef _c
+                case Type::String:
+                case Type::Reference:
+                case Type::Type:
+                case Type::Custom:
+                    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+            }
+
+            _deferred.emplace_back(_structures.size(), data.slice(i, deferredEnd));
+            i = deferredEnd;
+
+        } else switch(type) {
             #define _c(type) \
             case Type::type: \
                 dataBegin = dataPosition<Type::type>(); \
@@ -618,7 +957,7 @@ std::pair<const char*, std::size_t> Document::parseStructure(const std::size_t p
             _c(UnsignedLong)
             _c(Long)
             #endif
-            /** @todo Half */
+            _c(Half)
             _c(Float)
             _c(Double)
             _c(String)
@@ -643,6 +982,7 @@ std::pair<const char*, std::size_t> Document::parseStructure(const std::size_t p
         }
 
         _structures.emplace_back(type, name, subArraySize, dataBegin, dataSize, parent, _structures.size() + 1);
+        if(deferredEnd && dataSize) _structures.back().primitive.deferred = true;
         return {i + 1, _structures.size() - 1};
 
     /* Custom structure */
@@ -657,7 +997,7 @@ std::pair<const char*, std::size_t> Document::parseStructure(const std::size_t p
             std::string s;
             std::tie(i, s) = Implementation::nameLiteral(data.suffix(i), error);
             name = _strings.size();
-            _strings.push_back(std::move(s));
+            arrayAppend(_strings, Containers::InPlaceInit, std::move(s));
 
             i = Implementation::whitespace(data.suffix(i));
         }
@@ -769,22 +1109,573 @@ const char* Document::parseStructureList(const std::size_t parent, const Contain
     return i;
 }
 
-bool Document::validate(const Validation::Structures allowedRootStructures, const std::initializer_list<Validation::Structure> structures) const {
-    std::vector<Int> countsBuffer;
-    countsBuffer.reserve(structures.size());
+void Document::appendParsed(Document& other, std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& references, const std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>>& otherReferences, std::size_t& lastTopLevel) {
+    /* The first string is the reserved empty name, which is shared */
+    const std::size_t structureOffset = _structures.size();
+    const std::size_t propertyOffset = _properties.size();
+    const std::size_t stringOffset = _strings.size() - 1;
+    const std::size_t referenceOffset = references.size();
+
+    /* Append typed data, remembering where each type got appended to */
+    std::size_t dataOffsets[std::size_t(Type::Custom)]{};
+    #define _c(type, T) \
+        dataOffsets[std::size_t(Type::type)] = data<T>().size(); \
+        arrayAppend(data<T>(), Containers::arrayView(other.data<T>()));
+    _c(Bool, bool)
+    _c(UnsignedByte, UnsignedByte)
+    _c(Byte, Byte)
+    _c(UnsignedShort, UnsignedShort)
+    _c(Short, Short)
+    _c(UnsignedInt, UnsignedInt)
+    _c(Int, Int)
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    _c(UnsignedLong, UnsignedLong)
+    _c(Long, Long)
+    #endif
+    _c(Half, Half)
+    _c(Float, Float)
+    _c(Double, Double)
+    _c(Type, Type)
+    #undef _c
+    dataOffsets[std::size_t(Type::String)] = stringOffset;
+    dataOffsets[std::size_t(Type::Reference)] = referenceOffset;
+    Implementation::reserveDataListItems(_strings, other._strings.size() - 1);
+    for(std::size_t i = 1; i < other._strings.size(); ++i)
+        arrayAppend(_strings, Containers::InPlaceInit, std::move(other._strings[i]));
+
+    _deferred.reserve(_deferred.size() + other._deferred.size());
+    for(const std::pair<std::size_t, Containers::ArrayView<const char>>& deferred: other._deferred)
+        _deferred.emplace_back(deferred.first + structureOffset, deferred.second);
+
+    /* Unresolved references, pointing to the structures at their new
+       position */
+    for(const std::pair<std::size_t, Containers::ArrayView<const char>>& reference: otherReferences)
+        references.emplace_back(reference.first + structureOffset, reference.second);
+
+    _properties.reserve(_properties.size() + other._properties.size());
+    for(PropertyData property: other._properties) {
+        switch(property.type) {
+            case Implementation::InternalPropertyType::Bool:
+                property.position += dataOffsets[std::size_t(Type::Bool)];
+                break;
+            case Implementation::InternalPropertyType::Binary:
+            case Implementation::InternalPropertyType::Character:
+            case Implementation::InternalPropertyType::Integral:
+                property.position += dataOffsets[std::size_t(Type::Int)];
+                break;
+            case Implementation::InternalPropertyType::Float:
+                property.position += dataOffsets[std::size_t(Type::Float)];
+                break;
+            case Implementation::InternalPropertyType::String:
+                property.position += stringOffset;
+                break;
+            case Implementation::InternalPropertyType::Reference:
+                property.position += referenceOffset;
+                break;
+            case Implementation::InternalPropertyType::Type:
+                property.position += dataOffsets[std::size_t(Type::Type)];
+                break;
+        }
+
+        _properties.push_back(property);
+    }
+
+    /* Structures. Zero child and next index means there's none. */
+    if(other._structures.empty()) return;
+    if(lastTopLevel != NoParent) _structures[lastTopLevel].next = structureOffset;
+    _structures.reserve(structureOffset + other._structures.size());
+    for(StructureData structure: other._structures) {
+        if(structure.name) structure.name += stringOffset;
+        if(structure.next) structure.next += structureOffset;
+        if(structure.parent == NoParent)
+            lastTopLevel = _structures.size();
+        else structure.parent += structureOffset;
+
+        if(structure.primitive.type >= Type::Custom) {
+            structure.custom.propertiesBegin += propertyOffset;
+            if(structure.custom.firstChild)
+                structure.custom.firstChild += structureOffset;
+        } else structure.primitive.begin += dataOffsets[std::size_t(structure.primitive.type)];
+
+        _structures.push_back(structure);
+    }
+}
+
+bool Document::parseDeferred(const Structure structure) const {
+    if(!structure.isCustom())
+        return !structure._data.get().primitive.deferred || parseDeferredData(structure._data.get());
+
+    for(const Structure child: structure.children())
+        if(!parseDeferred(child)) return false;
+
+    return true;
+}
+
+bool Document::parseDeferredData(const StructureData& data) const {
+    /* The document is only logically const. The literals are converted into
+       space reserved during parse(), so views returned for other structures
+       stay valid. The flag is reset even if the parsing fails so the error
+       isn't printed again on each access. */
+    Document& self = const_cast<Document&>(*this);
+    const_cast<StructureData&>(data).primitive.deferred = false;
+
+    const std::size_t index = &data - _structures.data();
+    const auto found = std::lower_bound(_deferred.begin(), _deferred.end(), index, [](const std::pair<std::size_t, Containers::ArrayView<const char>>& a, const std::size_t b) {
+        return a.first < b;
+    });
+    CORRADE_INTERNAL_ASSERT(found != _deferred.end() && found->first == index);
+
+    Document parsed;
+    std::vector<std::pair<std::size_t, Containers::ArrayView<const char>>> references;
+    std::string buffer;
+    Implementation::ParseError error;
+    const char* end = nullptr;
+    std::size_t size = 0;
+    switch(data.primitive.type) {
+        #define _c(type, T) \
+        case Type::type: \
+            std::tie(end, size) = dataArrayList<Type::type>(found->second, parsed, references, buffer, data.primitive.subArraySize, error); \
+            if(end) std::copy(parsed.data<T>().begin(), parsed.data<T>().end(), self.data<T>().begin() + data.primitive.begin); \
+            break;
+        _c(Bool, bool)
+        _c(UnsignedByte, UnsignedByte)
+        _c(Byte, Byte)
+        _c(UnsignedShort, UnsignedShort)
+        _c(Short, Short)
+        _c(UnsignedInt, UnsignedInt)
+        _c(Int, Int)
+        #ifndef CORRADE_TARGET_EMSCRIPTEN
+        _c(UnsignedLong, UnsignedLong)
+        _c(Long, Long)
+        #endif
+        _c(Half, Half)
+        _c(Float, Float)
+        _c(Double, Double)
+        #undef _c
+        case Type::String:
+        case Type::Reference:
+        case Type::Type:
+        case Type::Custom:
+            CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    }
+
+    if(!end) {
+        /* Find the original data to calculate the line number from */
+        for(const Containers::Array<char>& lazyData: _lazyData) {
+            if(found->second.begin() >= lazyData.begin() && found->second.end() <= lazyData.end()) {
+                printParseError("OpenDdl::Document::parseDeferred():", lazyData, error);
+                break;
+            }
+        }
+        return false;
+    }
+
+    CORRADE_INTERNAL_ASSERT(size == data.primitive.size);
+    return true;
+}
+
+namespace {
+
+/* Everything after the header is stored in native byte order with all
+   indices and sizes expanded to 64 bits. Bump the version on any change in
+   the layout. */
+constexpr char SerializedMagic[]{'O', 'D', 'D', 'L', 'B', 'L', 'O', 'B'};
+constexpr UnsignedInt SerializedVersion = 2;
+constexpr UnsignedInt SerializedByteOrder = 0x01020304;
+
+/* FNV-1a of both identifier lists, so a blob doesn't get used with
+   identifiers that would map to different IDs */
+UnsignedLong identifierHash(const Containers::ArrayView<const CharacterLiteral> structureIdentifiers, const Containers::ArrayView<const CharacterLiteral> propertyIdentifiers) {
+    UnsignedLong hash = 14695981039346656037ull;
+    auto add = [&hash](const char c) {
+        hash = (hash ^ UnsignedByte(c))*1099511628211ull;
+    };
+    for(const Containers::ArrayView<const CharacterLiteral> identifiers: {structureIdentifiers, propertyIdentifiers}) {
+        for(const CharacterLiteral& identifier: identifiers) {
+            for(const char c: identifier) add(c);
+            add('\0');
+        }
+        add('\n');
+    }
+    return hash;
+}
+
+/* Null references and parent indices are stored independently of the
+   std::size_t width */
+UnsignedLong serializeIndex(const std::size_t index) {
+    return index == ~std::size_t{} ? ~UnsignedLong{} : UnsignedLong(index);
+}
+
+std::size_t deserializeIndex(const UnsignedLong index) {
+    return index == ~UnsignedLong{} ? ~std::size_t{} : std::size_t(index);
+}
+
+template<class T> void serializeValue(Containers::Array<char>& out, const T& value) {
+    arrayAppend(out, Containers::ArrayView<const char>{reinterpret_cast<const char*>(&value), sizeof(T)});
+}
+
+template<class T> void serializeArray(Containers::Array<char>& out, const Containers::Array<T>& array) {
+    serializeValue(out, UnsignedLong(array.size()));
+    arrayAppend(out, Containers::ArrayView<const char>{reinterpret_cast<const char*>(array.data()), array.size()*sizeof(T)});
+}
+
+template<class T> bool deserializeValue(Containers::ArrayView<const char>& data, T& out) {
+    if(data.size() < sizeof(T)) return false;
+    std::memcpy(&out, data, sizeof(T));
+    data = data.suffix(sizeof(T));
+    return true;
+}
+
+template<class T> bool deserializeArray(Containers::ArrayView<const char>& data, Containers::Array<T>& out) {
+    UnsignedLong size;
+    if(!deserializeValue(data, size) || size > data.size()/sizeof(T))
+        return false;
+    arrayResize(out, Containers::NoInit, std::size_t(size));
+    std::memcpy(out.data(), data, size*sizeof(T));
+    data = data.suffix(size*sizeof(T));
+    return true;
+}
+
+}
+
+Containers::Array<char> Document::serialize() const {
+    /* The blob is always fully parsed */
+    for(const StructureData& structure: _structures)
+        if(structure.primitive.type < Type::Custom && structure.primitive.deferred && !parseDeferredData(structure)) return {};
+
+    Containers::Array<char> out;
+    arrayAppend(out, Containers::arrayView(SerializedMagic));
+    serializeValue(out, SerializedVersion);
+    serializeValue(out, SerializedByteOrder);
+    serializeValue(out, identifierHash(_structureIdentifiers, _propertyIdentifiers));
+
+    /* Typed data. Long arrays are always present to keep the layout the
+       same everywhere, just empty on Emscripten. */
+    serializeArray(out, _bools);
+    serializeArray(out, _unsignedBytes);
+    serializeArray(out, _bytes);
+    serializeArray(out, _unsignedShorts);
+    serializeArray(out, _shorts);
+    serializeArray(out, _unsignedInts);
+    serializeArray(out, _ints);
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    serializeArray(out, _unsignedLongs);
+    serializeArray(out, _longs);
+    #else
+    serializeValue(out, UnsignedLong{});
+    serializeValue(out, UnsignedLong{});
+    #endif
+    serializeArray(out, _halves);
+    serializeArray(out, _floats);
+    serializeArray(out, _doubles);
+    serializeArray(out, _types);
+
+    serializeValue(out, UnsignedLong(_strings.size()));
+    for(const std::string& string: _strings) {
+        serializeValue(out, UnsignedLong(string.size()));
+        arrayAppend(out, Containers::ArrayView<const char>{string.data(), string.size()});
+    }
+
+    serializeValue(out, UnsignedLong(_references.size()));
+    for(const std::size_t reference: _references)
+        serializeValue(out, serializeIndex(reference));
+
+    serializeValue(out, UnsignedLong(_properties.size()));
+    for(const PropertyData& property: _properties) {
+        serializeValue(out, property.identifier);
+        serializeValue(out, UnsignedInt(property.type));
+        serializeValue(out, UnsignedLong(property.position));
+    }
+
+    /* Both primitive and custom structures have three size fields, the type
+       is enough to distinguish between the two */
+    serializeValue(out, UnsignedLong(_structures.size()));
+    for(const StructureData& structure: _structures) {
+        serializeValue(out, UnsignedLong(structure.name));
+        serializeValue(out, UnsignedInt(structure.primitive.type));
+        if(structure.primitive.type >= Type::Custom) {
+            serializeValue(out, UnsignedLong(structure.custom.propertiesBegin));
+            serializeValue(out, UnsignedLong(structure.custom.propertiesSize));
+            serializeValue(out, UnsignedLong(structure.custom.firstChild));
+        } else {
+            serializeValue(out, UnsignedLong(structure.primitive.subArraySize));
+            serializeValue(out, UnsignedLong(structure.primitive.begin));
+            serializeValue(out, UnsignedLong(structure.primitive.size));
+        }
+        serializeValue(out, serializeIndex(structure.parent));
+        serializeValue(out, UnsignedLong(structure.next));
+    }
+
+    return out;
+}
+
+bool Document::deserialize(Containers::ArrayView<const char> data, const std::initializer_list<CharacterLiteral> structureIdentifiers, const std::initializer_list<CharacterLiteral> propertyIdentifiers) {
+    CORRADE_ASSERT(_structures.empty() && _properties.empty() && _strings.size() == 1,
+        "OpenDdl::Document::deserialize(): the document is not empty", false);
+
+    _structureIdentifiers = {structureIdentifiers.begin(), structureIdentifiers.size()};
+    _propertyIdentifiers = {propertyIdentifiers.begin(), propertyIdentifiers.size()};
+
+    char magic[sizeof(SerializedMagic)];
+    UnsignedInt version, byteOrder;
+    UnsignedLong hash;
+    if(!deserializeValue(data, magic) || !std::equal(magic, magic + sizeof(magic), SerializedMagic)) {
+        Error() << "OpenDdl::Document::deserialize(): invalid header";
+        return false;
+    }
+    if(!deserializeValue(data, version) || !deserializeValue(data, byteOrder) || version != SerializedVersion || byteOrder != SerializedByteOrder) {
+        Error() << "OpenDdl::Document::deserialize(): unsupported version or byte order";
+        return false;
+    }
+    if(!deserializeValue(data, hash) || hash != identifierHash(_structureIdentifiers, _propertyIdentifiers)) {
+        Error() << "OpenDdl::Document::deserialize(): identifier lists don't match";
+        return false;
+    }
+
+    /* Typed data */
+    bool ok = deserializeArray(data, _bools) &&
+        deserializeArray(data, _unsignedBytes) &&
+        deserializeArray(data, _bytes) &&
+        deserializeArray(data, _unsignedShorts) &&
+        deserializeArray(data, _shorts) &&
+        deserializeArray(data, _unsignedInts) &&
+        deserializeArray(data, _ints);
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    ok = ok && deserializeArray(data, _unsignedLongs) &&
+        deserializeArray(data, _longs);
+    #else
+    {
+        UnsignedLong unsignedLongCount{}, longCount{};
+        ok = ok && deserializeValue(data, unsignedLongCount) && !unsignedLongCount &&
+            deserializeValue(data, longCount) && !longCount;
+    }
+    #endif
+    ok = ok && deserializeArray(data, _halves) &&
+        deserializeArray(data, _floats) &&
+        deserializeArray(data, _doubles) &&
+        deserializeArray(data, _types);
+
+    /* Strings, the first one is the reserved empty name */
+    UnsignedLong count = 0;
+    ok = ok && deserializeValue(data, count) && count && count <= data.size()/sizeof(UnsignedLong);
+    if(ok) {
+        Implementation::reserveDataListItems(_strings, count - 1);
+        for(UnsignedLong i = 0; ok && i != count; ++i) {
+            UnsignedLong size;
+            ok = deserializeValue(data, size) && size <= data.size() && (i || !size);
+            if(ok && i) {
+                arrayAppend(_strings, Containers::InPlaceInit, data.data(), std::size_t(size));
+                data = data.suffix(size);
+            }
+        }
+    }
+
+    /* Resolved references, either null or pointing to some structure, which
+       is checked below once the structure count is known */
+    ok = ok && deserializeValue(data, count) && count <= data.size()/sizeof(UnsignedLong);
+    if(ok) {
+        Implementation::reserveDataListItems(_references, count);
+        for(UnsignedLong i = 0; i != count; ++i) {
+            UnsignedLong reference;
+            deserializeValue(data, reference);
+            arrayAppend(_references, deserializeIndex(reference));
+        }
+    }
 
+    /* Properties, with positions checked against the typed data */
+    constexpr std::size_t PropertySize = sizeof(Int) + sizeof(UnsignedInt) + sizeof(UnsignedLong);
+    ok = ok && deserializeValue(data, count) && count <= data.size()/PropertySize;
+    if(ok) {
+        _properties.reserve(count);
+        for(UnsignedLong i = 0; ok && i != count; ++i) {
+            Int identifier;
+            UnsignedInt type;
+            UnsignedLong position;
+            deserializeValue(data, identifier);
+            deserializeValue(data, type);
+            deserializeValue(data, position);
+
+            std::size_t size = 0;
+            switch(Implementation::InternalPropertyType(type)) {
+                case Implementation::InternalPropertyType::Bool:
+                    size = _bools.size();
+                    break;
+                case Implementation::InternalPropertyType::Binary:
+                case Implementation::InternalPropertyType::Character:
+                case Implementation::InternalPropertyType::Integral:
+                    size = _ints.size();
+                    break;
+                case Implementation::InternalPropertyType::Float:
+                    size = _floats.size();
+                    break;
+                case Implementation::InternalPropertyType::String:
+                    size = _strings.size();
+                    break;
+                case Implementation::InternalPropertyType::Reference:
+                    size = _references.size();
+                    break;
+                case Implementation::InternalPropertyType::Type:
+                    size = _types.size();
+                    break;
+            }
+
+            ok = position < size;
+            _properties.emplace_back(identifier, Implementation::InternalPropertyType(type), std::size_t(position));
+        }
+    }
+
+    /* Structures, with all indices checked so a corrupted blob can't cause
+       out-of-bounds access later */
+    constexpr std::size_t StructureSize = sizeof(UnsignedInt) + 6*sizeof(UnsignedLong);
+    ok = ok && deserializeValue(data, count) && count <= data.size()/StructureSize;
+    if(ok) {
+        _structures.reserve(count);
+        auto validIndex = [count](const UnsignedLong index) {
+            return index < count;
+        };
+        for(UnsignedLong i = 0; ok && i != count; ++i) {
+            UnsignedLong name, a, b, c, parent, next;
+            UnsignedInt type;
+            deserializeValue(data, name);
+            deserializeValue(data, type);
+            deserializeValue(data, a);
+            deserializeValue(data, b);
+            deserializeValue(data, c);
+            deserializeValue(data, parent);
+            deserializeValue(data, next);
+
+            ok = name < _strings.size() && (parent == ~UnsignedLong{} || validIndex(parent)) && validIndex(next);
+            if(!ok) break;
+
+            /* Custom structure */
+            if(type >= UnsignedInt(Type::Custom)) {
+                ok = b <= _properties.size() && a <= _properties.size() - b && validIndex(c);
+                _structures.emplace_back(Int(type - UnsignedInt(Type::Custom)), std::size_t(name), std::size_t(a), std::size_t(b), std::size_t(c), deserializeIndex(parent), std::size_t(next));
+
+            /* Primitive structure */
+            } else {
+                std::size_t size = 0;
+                switch(Type(type)) {
+                    #define _c(type, T) \
+                    case Type::type: \
+                        size = this->data<T>().size(); \
+                        break;
+                    _c(Bool, bool)
+                    _c(UnsignedByte, UnsignedByte)
+                    _c(Byte, Byte)
+                    _c(UnsignedShort, UnsignedShort)
+                    _c(Short, Short)
+                    _c(UnsignedInt, UnsignedInt)
+                    _c(Int, Int)
+                    #ifndef CORRADE_TARGET_EMSCRIPTEN
+                    _c(UnsignedLong, UnsignedLong)
+                    _c(Long, Long)
+                    #endif
+                    _c(Half, Half)
+                    _c(Float, Float)
+                    _c(Double, Double)
+                    _c(String, std::string)
+                    _c(Type, Type)
+                    #undef _c
+                    case Type::Reference:
+                        size = _references.size();
+                        break;
+                    case Type::Custom:
+                        CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+                }
+
+                ok = c <= size && b <= size - c && (!a || c % a == 0);
+                _structures.emplace_back(Type(type), std::size_t(name), std::size_t(a), std::size_t(b), std::size_t(c), deserializeIndex(parent), std::size_t(next));
+            }
+        }
+    }
+
+    if(ok) for(const std::size_t reference: _references) {
+        if(reference != NullReference && reference >= _structures.size()) {
+            ok = false;
+            break;
+        }
+    }
+
+    if(!ok || !data.empty()) {
+        Error() << "OpenDdl::Document::deserialize(): invalid or truncated data";
+        return false;
+    }
+
+    return true;
+}
+
+/* Lookup tables built from the validation specification once at the start of
+   validate(), so the document is then checked in a single pass without any
+   searching in the specification or allocations */
+struct Document::ValidationTables {
+    std::size_t identifierCount;
+    const Validation::Structure* specification;
+
+    /* Specification of each structure identifier, nullptr if not present */
+    Containers::Array<const Validation::Structure*> structures;
+
+    /* Min and max count of each identifier as a child of each specified
+       structure in the order they're specified, one row per structure,
+       followed by a row for the root level. Min of -1 means the structure is
+       not allowed, max of 0 means there's no upper bound. */
+    Containers::Array<std::pair<Int, Int>> bounds;
+
+    /* Scratch space for counting structures in one level and properties in
+       one structure */
+    Containers::Array<Int> counts;
+};
+
+namespace {
+
+void fillValidationBounds(const Containers::ArrayView<std::pair<Int, Int>> bounds, const Containers::ArrayView<const std::pair<Int, std::pair<Int, Int>>> allowedStructures) {
+    for(std::pair<Int, Int>& bound: bounds) bound.first = -1;
+
+    /* In case the same identifier is listed more than once, the first wins */
+    for(const std::pair<Int, std::pair<Int, Int>> allowedStructure: allowedStructures) {
+        CORRADE_INTERNAL_ASSERT(allowedStructure.second.first >= 0 && (allowedStructure.second.second == 0 || allowedStructure.second.second >= allowedStructure.second.first));
+        CORRADE_INTERNAL_ASSERT(std::size_t(allowedStructure.first) < bounds.size());
+        std::pair<Int, Int>& bound = bounds[allowedStructure.first];
+        if(bound.first == -1) bound = allowedStructure.second;
+    }
+}
+
+}
+
+bool Document::validate(const Validation::Structures allowedRootStructures, const std::initializer_list<Validation::Structure> structures) const {
     /* Check that there are no primitive structures in root */
     for(const Structure s: children()) if(!s.isCustom()) {
         Error() << "OpenDdl::Document::validate(): unexpected primitive structure in root";
         return false;
     }
 
+    /* Build the lookup tables */
+    ValidationTables tables;
+    tables.identifierCount = _structureIdentifiers.size();
+    tables.specification = structures.begin();
+    tables.structures = Containers::Array<const Validation::Structure*>{Containers::ValueInit, tables.identifierCount};
+    tables.bounds = Containers::Array<std::pair<Int, Int>>{Containers::NoInit, (structures.size() + 1)*tables.identifierCount};
+    std::size_t maxPropertyCount = 0;
+    std::size_t row = 0;
+    for(const Validation::Structure& structure: structures) {
+        CORRADE_INTERNAL_ASSERT(std::size_t(structure.identifier()) < tables.identifierCount);
+        if(!tables.structures[structure.identifier()])
+            tables.structures[structure.identifier()] = &structure;
+        fillValidationBounds(tables.bounds.slice(row*tables.identifierCount, (row + 1)*tables.identifierCount), structure.structures());
+        maxPropertyCount = std::max(maxPropertyCount, structure.properties().size());
+        ++row;
+    }
+    fillValidationBounds(tables.bounds.suffix(row*tables.identifierCount), {allowedRootStructures.begin(), allowedRootStructures.size()});
+    tables.counts = Containers::Array<Int>{Containers::NoInit, std::max(tables.identifierCount, maxPropertyCount)};
+
     /* Check custom structures */
-    return validateLevel(findFirstChild(), {allowedRootStructures.begin(), allowedRootStructures.size()}, {structures.begin(), structures.size()}, countsBuffer);
+    return validateLevel(findFirstChild(), {allowedRootStructures.begin(), allowedRootStructures.size()}, row*tables.identifierCount, tables);
 }
 
-bool Document::validateLevel(const Containers::Optional<Structure>& first, const Containers::ArrayView<const std::pair<Int, std::pair<Int, Int>>> allowedStructures, const Containers::ArrayView<const Validation::Structure> structures, std::vector<Int>& counts) const {
-    counts.assign(allowedStructures.size(), 0);
+bool Document::validateLevel(const Containers::Optional<Structure>& first, const Containers::ArrayView<const std::pair<Int, std::pair<Int, Int>>> allowedStructures, const std::size_t bounds, ValidationTables& tables) const {
+    const Containers::ArrayView<const std::pair<Int, Int>> levelBounds = tables.bounds.slice(bounds, bounds + tables.identifierCount);
+    for(const std::pair<Int, std::pair<Int, Int>> allowedStructure: allowedStructures)
+        tables.counts[allowedStructure.first] = 0;
 
     /* Count number of custom structures in this level */
     for(Containers::Optional<Structure> it = first; it; it = it->findNext()) {
@@ -793,32 +1684,26 @@ bool Document::validateLevel(const Containers::Optional<Structure>& first, const
         if(!s.isCustom() || s.identifier() == UnknownIdentifier) continue;
 
         /* Verify that the structure is allowed (ignoring unknown ones) */
-        auto found = std::find_if(allowedStructures.begin(), allowedStructures.end(), [s](const std::pair<Int, std::pair<Int, Int>>& v){ return v.first == s.identifier(); });
-        if(found == allowedStructures.end()) {
+        const std::pair<Int, Int> bound = levelBounds[s.identifier()];
+        if(bound.first == -1) {
             Error() << "OpenDdl::Document::validate(): unexpected structure" << structureName(s.identifier());
             return false;
         }
 
         /* Verify that we don't exceed allowed count */
-        const std::size_t i = found - allowedStructures.begin();
-        if(++counts[i] > found->second.second && found->second.second) {
-            Error() << "OpenDdl::Document::validate(): too many" << structureName(s.identifier()) << "structures, got" << counts[i] << "but expected max" << found->second.second;
+        Int& count = tables.counts[s.identifier()];
+        if(++count > bound.second && bound.second) {
+            Error() << "OpenDdl::Document::validate(): too many" << structureName(s.identifier()) << "structures, got" << count << "but expected max" << bound.second;
             return false;
         }
     }
 
     /* Verify that all required structures are there */
-    {
-        std::size_t i = 0;
-        for(const std::pair<Int, std::pair<Int, Int>> allowedStructure: allowedStructures) {
-            CORRADE_INTERNAL_ASSERT(allowedStructure.second.first >= 0 && (allowedStructure.second.second == 0 || allowedStructure.second.second >= allowedStructure.second.first));
-
-            if(allowedStructure.second.first > counts[i]) {
-                Error() << "OpenDdl::Document::validate(): too little" << structureName(allowedStructure.first) << "structures, got" << counts[i] << "but expected min" << allowedStructure.second.first;
-                return false;
-            }
-
-            ++i;
+    for(const std::pair<Int, std::pair<Int, Int>> allowedStructure: allowedStructures) {
+        const Int count = tables.counts[allowedStructure.first];
+        if(allowedStructure.second.first > count) {
+            Error() << "OpenDdl::Document::validate(): too little" << structureName(allowedStructure.first) << "structures, got" << count << "but expected min" << allowedStructure.second.first;
+            return false;
         }
     }
 
@@ -828,17 +1713,18 @@ bool Document::validateLevel(const Containers::Optional<Structure>& first, const
 
         if(!s.isCustom() || s.identifier() == UnknownIdentifier) continue;
 
-        auto found = std::find_if(structures.begin(), structures.end(), [s](const Validation::Structure& v){ return v.identifier() == s.identifier(); });
-        CORRADE_ASSERT(found != structures.end(), "OpenDdl::Document::validate(): missing specification for structure" << structureName(s.identifier()), false);
-        if(!validateStructure(s, *found, structures, counts))
+        const Validation::Structure* const found = tables.structures[s.identifier()];
+        CORRADE_ASSERT(found, "OpenDdl::Document::validate(): missing specification for structure" << structureName(s.identifier()), false);
+        if(!validateStructure(s, *found, (found - tables.specification)*tables.identifierCount, tables))
             return false;
     }
 
     return true;
 }
 
-bool Document::validateStructure(const Structure structure, const Validation::Structure& validation, const Containers::ArrayView<const Validation::Structure> structures, std::vector<Int>& counts) const {
-    counts.assign(validation.properties().size(), 0);
+bool Document::validateStructure(const Structure structure, const Validation::Structure& validation, const std::size_t bounds, ValidationTables& tables) const {
+    const Containers::ArrayView<Int> counts = tables.counts.prefix(validation.properties().size());
+    for(Int& count: counts) count = 0;
 
     /* Verify that there is no unexpected property (ignoring unknown ones) */
     for(const Property p: structure.properties()) {
@@ -902,7 +1788,7 @@ bool Document::validateStructure(const Structure structure, const Validation::St
     }
 
     /* Check also custom substructures */
-    return validateLevel(structure.findFirstChild(), validation.structures(), structures, counts);
+    return validateLevel(structure.findFirstChild(), validation.structures(), bounds, tables);
 }
 
 const char* Document::structureName(const Int identifier) const {
@@ -1163,6 +2049,181 @@ Containers::Optional<Structure> Property::asReference() const {
         Containers::optional(Structure{_document, _document.get()._structures[reference]});
 }
 
+Scanner::Scanner() = default;
+
+Scanner::~Scanner() = default;
+
+void Scanner::doStructureBegin(Int, Containers::ArrayView<const char>) {}
+
+void Scanner::doProperty(Int, Containers::ArrayView<const char>) {}
+
+void Scanner::doStructureEnd() {}
+
+void Scanner::doPrimitiveStructure(Type, std::size_t, Containers::ArrayView<const char>, Containers::ArrayView<const char>) {}
+
+bool Scanner::scan(const Containers::ArrayView<const char> data, const std::initializer_list<CharacterLiteral> structureIdentifiers, const std::initializer_list<CharacterLiteral> propertyIdentifiers) {
+    _structureIdentifiers = {structureIdentifiers.begin(), structureIdentifiers.size()};
+    _propertyIdentifiers = {propertyIdentifiers.begin(), propertyIdentifiers.size()};
+    _stopped = false;
+
+    Implementation::ParseError error;
+    const char* const i = scanStructureList(data.suffix(Implementation::whitespace(data)), error);
+    if(!i && !_stopped) {
+        printParseError("OpenDdl::Scanner::scan():", data, error);
+        return false;
+    }
+
+    return true;
+}
+
+const char* Scanner::scanStructure(const Containers::ArrayView<const char> data, Implementation::ParseError& error) {
+    /* Identifier */
+    const char* const structureIdentifier = Implementation::identifier(data, error);
+    if(!structureIdentifier) return {};
+
+    /* Decide whether primitive or custom */
+    const char* i;
+    Type type;
+    std::tie(i, type) = Implementation::possiblyTypeLiteral(data.prefix(structureIdentifier));
+    const bool primitive = i;
+
+    i = Implementation::whitespace(data.suffix(structureIdentifier));
+
+    /* Array */
+    std::size_t subArraySize = 0;
+    if(primitive && i != data.end() && *i == '[') {
+        i = Implementation::whitespace(data.suffix(i + 1));
+
+        /* Short enough to not need any allocation in the buffer */
+        std::string buffer;
+        std::tie(i, subArraySize, std::ignore) = Implementation::integralLiteral<std::size_t>(data.suffix(i), buffer, error);
+
+        if(subArraySize == 0) {
+            error = {Implementation::ParseErrorType::InvalidSubArraySize, i};
+            return {};
+        }
+
+        if(!i) return {};
+
+        i = Implementation::whitespace(data.suffix(i));
+
+        if(i == data.end() || *i != ']') {
+            error = {Implementation::ParseErrorType::ExpectedArraySizeEnd, i};
+            return {};
+        }
+
+        i = Implementation::whitespace(data.suffix(i + 1));
+    }
+
+    /* Name */
+    Containers::ArrayView<const char> name;
+    if(i != data.end() && (*i == '%' || *i == '$')) {
+        const char* const nameEnd = Implementation::identifier(data.suffix(i + 1), error);
+        if(!nameEnd) return {};
+
+        name = data.slice(i, nameEnd);
+        i = Implementation::whitespace(data.suffix(nameEnd));
+    }
+
+    /* Primitive structure, report the whole data list at once */
+    if(primitive) {
+        if(i == data.end() || *i != '{') {
+            error = {Implementation::ParseErrorType::ExpectedListStart, i};
+            return {};
+        }
+
+        const char* const dataBegin = Implementation::whitespace(data.suffix(i + 1));
+        const char* const dataListEnd = Implementation::skipDataList(data.suffix(dataBegin), error);
+        if(!dataListEnd) return {};
+
+        const char* dataEnd = dataListEnd;
+        while(dataEnd != dataBegin && UnsignedByte(*(dataEnd - 1)) <= 32) --dataEnd;
+
+        doPrimitiveStructure(type, subArraySize, name, data.slice(dataBegin, dataEnd));
+        return _stopped ? nullptr : dataListEnd + 1;
+    }
+
+    /* Custom structure */
+    doStructureBegin(identifierId(data.prefix(structureIdentifier), _structureIdentifiers), name);
+    if(_stopped) return {};
+
+    /* Property list */
+    if(i != data.end() && *i == '(') {
+        i = Implementation::whitespace(data.suffix(i + 1));
+
+        bool first = true;
+        while(i != data.end() && *i != ')') {
+            if(!first) {
+                if(*i != ',') {
+                    error = {Implementation::ParseErrorType::ExpectedSeparator, i};
+                    return {};
+                }
+
+                i = Implementation::whitespace(data.suffix(i + 1));
+            }
+            first = false;
+
+            const char* const propertyIdentifier = Implementation::identifier(data.suffix(i), error);
+            if(!propertyIdentifier) return {};
+
+            const Int propertyIdentifierId = identifierId(data.slice(i, propertyIdentifier), _propertyIdentifiers);
+
+            i = Implementation::whitespace(data.suffix(propertyIdentifier));
+
+            if(i == data.end() || *i != '=') {
+                error = {Implementation::ParseErrorType::ExpectedPropertyAssignment, i};
+                return {};
+            }
+
+            i = Implementation::whitespace(data.suffix(i + 1));
+
+            const char* const valueEnd = Implementation::skipPropertyValue(data.suffix(i), error);
+            if(!valueEnd) return {};
+
+            doProperty(propertyIdentifierId, data.slice(i, valueEnd));
+            if(_stopped) return {};
+
+            i = Implementation::whitespace(data.suffix(valueEnd));
+        }
+
+        if(i == data.end()) {
+            error = {Implementation::ParseErrorType::ExpectedPropertyListEnd, i};
+            return {};
+        }
+
+        i = Implementation::whitespace(data.suffix(i + 1));
+    }
+
+    /* Structure start */
+    if(i == data.end() || *i != '{') {
+        error = {Implementation::ParseErrorType::ExpectedListStart, i};
+        return {};
+    }
+
+    /* Substructures */
+    i = scanStructureList(data.suffix(Implementation::whitespace(data.suffix(i + 1))), error);
+    if(!i) return {};
+
+    /* Structure end */
+    if(i == data.end() || *i != '}') {
+        error = {Implementation::ParseErrorType::ExpectedListEnd, i};
+        return {};
+    }
+
+    doStructureEnd();
+    return _stopped ? nullptr : i + 1;
+}
+
+const char* Scanner::scanStructureList(const Containers::ArrayView<const char> data, Implementation::ParseError& error) {
+    const char* i = data;
+    while(i && i != data.end() && *i != '}') {
+        i = scanStructure(data.suffix(i), error);
+        i = Implementation::whitespace(data.suffix(i));
+    }
+
+    return i;
+}
+
 namespace Validation {
 
 Structure::Structure(Int identifier, Properties properties, Primitives primitives, std::size_t primitiveCount, std::size_t primitiveArraySize, Structures structures):
@@ -36,6 +36,7 @@ namespace Magnum { namespace OpenDdl {
 struct CharacterLiteral;
 class Document;
 class Property;
+class Scanner;
 class Structure;
 enum class Type: UnsignedInt;
 
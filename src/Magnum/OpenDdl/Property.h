@@ -125,7 +125,7 @@ const T&
 #endif
 Property::as() const {
     CORRADE_ASSERT(Implementation::isPropertyType<T>(_data.get().type),
-        "OpenDdl::Property::as(): not compatible with given type", _document.get().data<T>().front());
+        "OpenDdl::Property::as(): not compatible with given type", _document.get().data<T>()[0]);
     return _document.get().data<T>()[_data.get().position];
 }
 
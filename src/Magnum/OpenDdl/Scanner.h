@@ -0,0 +1,187 @@
+#ifndef Magnum_OpenDdl_Scanner_h
+#define Magnum_OpenDdl_Scanner_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Magnum::OpenDdl::Scanner
+ */
+
+#include <initializer_list>
+#include <Corrade/Containers/ArrayView.h>
+
+#include "Magnum/OpenDdl/Document.h"
+
+namespace Magnum { namespace OpenDdl {
+
+namespace Implementation {
+    struct ParseError;
+}
+
+/**
+@brief Event-driven OpenDDL scanner
+
+Unlike @ref Document, which builds a typed in-memory representation of the
+whole file, the scanner only walks through the document and reports its
+structure to virtual functions you override in a subclass. All names, property
+values and data lists are passed as views into the original data and the
+scanner doesn't allocate, which makes it suitable for quick metadata
+extraction from large files --- such as reading OpenGEX metrics or counting
+objects --- without paying for a full @ref Document::parse().
+
+Structure and property identifiers are translated to integer IDs the same way
+as in @ref Document::parse(), unknown identifiers are reported as
+@ref UnknownIdentifier:
+
+@code{.cpp}
+struct MetricScanner: OpenDdl::Scanner {
+    void doStructureBegin(Int identifier, Containers::ArrayView<const char>) override {
+        inMetric = identifier == OpenGex::Metric;
+    }
+    void doProperty(Int identifier, Containers::ArrayView<const char> value) override {
+        if(inMetric && identifier == OpenGex::key) key = value;
+    }
+    void doPrimitiveStructure(OpenDdl::Type, std::size_t, Containers::ArrayView<const char>, Containers::ArrayView<const char> data) override {
+        if(inMetric) { ... }
+    }
+    void doStructureEnd() override {
+        inMetric = false;
+    }
+
+    bool inMetric = false;
+    Containers::ArrayView<const char> key;
+};
+
+MetricScanner scanner;
+bool scanned = scanner.scan(data, OpenGex::structures, OpenGex::properties);
+@endcode
+
+Property values and data lists are not converted in any way, the views
+contain the literals exactly as they appear in the file, including quotes of
+string literals. Data list views contain everything between the opening and
+closing braces with surrounding whitespace trimmed and can thus still contain
+comments. Because the literals are not converted, only syntax errors in the
+document structure are detected --- an invalid literal inside a data list is
+not reported, while @ref Document::parse() would fail on it. References are
+not resolved either.
+
+Call @ref stop() from any of the callbacks to finish the scanning early.
+*/
+class MAGNUM_OPENDDL_EXPORT Scanner {
+    public:
+        explicit Scanner();
+
+        /** @brief Copying is not allowed */
+        Scanner(const Scanner&) = delete;
+
+        /** @brief Copying is not allowed */
+        Scanner& operator=(const Scanner&) = delete;
+
+        virtual ~Scanner();
+
+        /**
+         * @brief Scan the document
+         * @param data                  Document data
+         * @param structureIdentifiers  Structure identifiers
+         * @param propertyIdentifiers   Property identifiers
+         *
+         * Calls the virtual functions for all structures and properties in
+         * the document in order they appear. Returns @cpp true @ce on
+         * success or if the scanning was stopped with @ref stop(). If the
+         * document has syntax errors, prints detailed diagnostics on
+         * @ref Corrade::Utility::Error output and returns @cpp false @ce ---
+         * note that the callbacks can be already called for structures before
+         * the error.
+         */
+        bool scan(Containers::ArrayView<const char> data, std::initializer_list<CharacterLiteral> structureIdentifiers, std::initializer_list<CharacterLiteral> propertyIdentifiers);
+
+    protected:
+        /**
+         * @brief Stop the scanning
+         *
+         * Meant to be called from the callbacks. No more callbacks are called
+         * after the current one returns and @ref scan() returns
+         * @cpp true @ce.
+         */
+        void stop() { _stopped = true; }
+
+    #ifdef DOXYGEN_GENERATING_OUTPUT
+    protected:
+    #else
+    private:
+    #endif
+        /**
+         * @brief Custom structure begin
+         * @param identifier    Structure identifier or @ref UnknownIdentifier
+         * @param name          Structure name including the @cb{.ini} $ @ce
+         *      or @cb{.ini} % @ce prefix, empty if the structure has no name
+         *
+         * Followed by @ref doProperty() for all structure properties,
+         * callbacks for all substructures and then @ref doStructureEnd().
+         * Default implementation does nothing.
+         */
+        virtual void doStructureBegin(Int identifier, Containers::ArrayView<const char> name);
+
+        /**
+         * @brief Custom structure property
+         * @param identifier    Property identifier or @ref UnknownIdentifier
+         * @param value         Unconverted property value literal
+         *
+         * Default implementation does nothing.
+         */
+        virtual void doProperty(Int identifier, Containers::ArrayView<const char> value);
+
+        /**
+         * @brief Custom structure end
+         *
+         * Default implementation does nothing.
+         */
+        virtual void doStructureEnd();
+
+        /**
+         * @brief Primitive structure
+         * @param type          Structure type
+         * @param subArraySize  Subarray size or @cpp 0 @ce if the data list
+         *      has no subarrays
+         * @param name          Structure name including the @cb{.ini} $ @ce
+         *      or @cb{.ini} % @ce prefix, empty if the structure has no name
+         * @param data          Unconverted data list contents
+         *
+         * Default implementation does nothing.
+         */
+        virtual void doPrimitiveStructure(Type type, std::size_t subArraySize, Containers::ArrayView<const char> name, Containers::ArrayView<const char> data);
+
+    private:
+        MAGNUM_OPENDDL_LOCAL const char* scanStructure(Containers::ArrayView<const char> data, Implementation::ParseError& error);
+        MAGNUM_OPENDDL_LOCAL const char* scanStructureList(Containers::ArrayView<const char> data, Implementation::ParseError& error);
+
+        Containers::ArrayView<const CharacterLiteral> _structureIdentifiers;
+        Containers::ArrayView<const CharacterLiteral> _propertyIdentifiers;
+        bool _stopped{false};
+};
+
+}}
+
+#endif
@@ -395,7 +395,7 @@ namespace Implementation {
     _c(UnsignedLong)
     _c(Long)
     #endif
-    /** @todo Half */
+    _c(Half)
     _c(Float)
     _c(Double)
     #undef _c
@@ -410,15 +410,17 @@ const T&
 #endif
 Structure::as() const {
     CORRADE_ASSERT(arraySize() == 1,
-        "OpenDdl::Structure::as(): not a single value", _document.get().data<T>().front());
+        "OpenDdl::Structure::as(): not a single value", _document.get().data<T>()[0]);
     CORRADE_ASSERT(Implementation::isStructureType<T>(type()),
-        "OpenDdl::Structure::as(): not of given type", _document.get().data<T>().front());
+        "OpenDdl::Structure::as(): not of given type", _document.get().data<T>()[0]);
+    if(_data.get().primitive.deferred) _document.get().parseDeferredData(_data.get());
     return _document.get().data<T>()[_data.get().primitive.begin];
 }
 
 template<class T> Containers::ArrayView<const T> Structure::asArray() const {
     CORRADE_ASSERT(Implementation::isStructureType<T>(type()),
         "OpenDdl::Structure::asArray(): not of given type", nullptr);
+    if(_data.get().primitive.deferred) _document.get().parseDeferredData(_data.get());
     return {_document.get().data<T>().data() + _data.get().primitive.begin, _data.get().primitive.size};
 }
 
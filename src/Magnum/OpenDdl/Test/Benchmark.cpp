@@ -0,0 +1,459 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <sstream>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/FormatStl.h>
+
+#include "Magnum/OpenDdl/Document.h"
+#include "Magnum/OpenDdl/Scanner.h"
+#include "Magnum/OpenDdl/Implementation/Parsers.h"
+
+/* Counting all allocations done through operator new. Growable arrays of
+   trivially copyable types in Document use std::malloc() / std::realloc()
+   directly, so these are not included in the counts. Also, on Windows with
+   shared libraries this affects only allocations in this executable. */
+namespace {
+    std::atomic<std::size_t> allocationCount{};
+}
+
+void* operator new(std::size_t size) {
+    ++allocationCount;
+    if(void* const p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace Magnum { namespace OpenDdl { namespace Test { namespace {
+
+struct Benchmark: TestSuite::Tester {
+    explicit Benchmark();
+
+    void whitespace();
+    void identifier();
+    void integralLiteral();
+    void floatingPointLiteral();
+    void decimalFloatingPointLiteral();
+
+    void parse();
+    void parseAllocations();
+    void scan();
+
+    void fuzz();
+
+    void allocationBenchmarkBegin();
+    std::uint64_t allocationBenchmarkEnd();
+
+    std::string _whitespace, _identifiers, _integralLiterals, _floatingPointLiterals;
+    std::string _documents[3];
+    std::size_t _allocationCount;
+};
+
+/* A subset of OpenGEX, enough for the identifiers to be looked up */
+enum: Int {
+    GeometryNode,
+    GeometryObject,
+    IndexArray,
+    Mesh,
+    Metric,
+    Name,
+    ObjectRef,
+    Transform,
+    VertexArray
+};
+
+enum: Int {
+    attrib,
+    key,
+    primitive,
+    visible
+};
+
+const std::initializer_list<CharacterLiteral> Structures{
+    "GeometryNode",
+    "GeometryObject",
+    "IndexArray",
+    "Mesh",
+    "Metric",
+    "Name",
+    "ObjectRef",
+    "Transform",
+    "VertexArray"
+};
+
+const std::initializer_list<CharacterLiteral> Properties{
+    "attrib",
+    "key",
+    "primitive",
+    "visible"
+};
+
+/* To calculate the throughput in MB/s, divide the data size shown in the test
+   case description by the measured time. The hot function benchmarks go
+   through data of the same size. */
+constexpr std::size_t LiteralDataSize = 1024*1024;
+
+enum: std::size_t {
+    VertexHeavy,
+    StructureHeavy,
+    StringHeavy
+};
+
+constexpr struct {
+    const char* name;
+} DocumentData[] {
+    {"vertex-heavy"},
+    {"structure-heavy"},
+    {"string-heavy"}
+};
+
+/* Small document with most features, mutated in the fuzz test */
+const char FuzzDocument[] = R"(
+Metric (key = "distance") { float { 0.01 } }
+Metric (key = "up") { string { "z" } }
+GeometryNode $node1 (visible = true) {
+    Name { string { "Box \"1\"" } }
+    ObjectRef { ref { $geometry1 } }
+    Transform {
+        float[16] {
+            {1.0, 0.0, 0.0, 0.0,
+             0.0, 1.0, 0.0, 0.0,
+             0.0, 0.0, 1.0, 0.0,
+             0.5, -1.0e2, 0x3f800000, 1.0}
+        }
+    }
+}
+GeometryObject $geometry1 // a comment
+{
+    Mesh (primitive = "triangles") {
+        VertexArray (attrib = "position") {
+            float[3] { {0.0, 0.0, 0.0}, {1, 0, 0}, {0, 1, 0} }
+        }
+        IndexArray { unsigned_int16[3] { {0, 1, 2} } } /* another comment */
+    }
+}
+Unknown %local (value = 'x', size = 0b101) { int8 { -'\n', 0o17 } }
+)";
+
+constexpr std::size_t FuzzRepeatCount = 500;
+
+/* Repeats a pattern until the string is at least given size */
+std::string repeat(const char* const pattern, const std::size_t size) {
+    std::string out;
+    out.reserve(size + std::strlen(pattern));
+    while(out.size() < size) out += pattern;
+    return out;
+}
+
+std::string vertexHeavyDocument() {
+    std::string out = "Metric (key = \"distance\") { float { 0.01 } }\n";
+
+    for(std::size_t i = 0; i != 8; ++i) {
+        constexpr std::size_t VertexCount = 4096;
+
+        Utility::formatInto(out, out.size(),
+            "GeometryNode $node{0} {{ ObjectRef {{ ref {{ $geometry{0} }} }} }}\n"
+            "GeometryObject $geometry{0} {{\n"
+            "    Mesh (primitive = \"triangles\") {{\n", i);
+
+        for(const char* attribute: {"position", "normal"}) {
+            Utility::formatInto(out, out.size(),
+                "        VertexArray (attrib = \"{}\") {{\n"
+                "            float[3] {{\n", attribute);
+            for(std::size_t j = 0; j != VertexCount; ++j)
+                Utility::formatInto(out, out.size(),
+                    "                {{{}, {}, {}}}{}\n",
+                    Float(j)*0.125f, -Float(i + j)/3.0f, Float(j % 117)*1.0e-3f,
+                    j + 1 == VertexCount ? "" : ",");
+            out += "            }\n        }\n";
+        }
+
+        out += "        IndexArray {\n            unsigned_int32[3] {\n";
+        for(std::size_t j = 0; j != VertexCount - 2; ++j)
+            Utility::formatInto(out, out.size(),
+                "                {{{}, {}, {}}}{}\n", j, j + 1, j + 2,
+                j + 3 == VertexCount ? "" : ",");
+        out += "            }\n        }\n    }\n}\n";
+    }
+
+    return out;
+}
+
+std::string structureHeavyDocument() {
+    std::string out;
+
+    /* Nested node hierarchies, each with a name, a transformation and a few
+       properties */
+    for(std::size_t i = 0; i != 4096; ++i) {
+        for(std::size_t j = 0; j != 4; ++j)
+            Utility::formatInto(out, out.size(),
+                "GeometryNode $node{0}_{1} (visible = {2}) {{\n"
+                "Name {{ string {{ \"Node {0}\" }} }}\n"
+                "Transform {{ float[16] {{ {{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, {0}, {1}, 0, 1}} }} }}\n",
+                i, j, j % 2 ? "true" : "false");
+        for(std::size_t j = 0; j != 4; ++j) out += "}\n";
+    }
+
+    return out;
+}
+
+std::string stringHeavyDocument() {
+    std::string out;
+
+    /* Strings with escapes and continuations, in properties and data
+       lists */
+    for(std::size_t i = 0; i != 16384; ++i)
+        Utility::formatInto(out, out.size(),
+            "Metric (key = \"a rather long key with \\\"quotes\\\" #{0}\") {{\n"
+            "    string {{ \"Lorem ipsum dolor sit amet,\\n\" \"consectetur \\u00e9 adipiscing\", \"elit #{0}\\t\" }}\n"
+            "}}\n", i);
+
+    return out;
+}
+
+/* Scanner doing nothing, which shows the cost of the parsing alone */
+struct NoopScanner: Scanner {};
+
+Benchmark::Benchmark() {
+    addBenchmarks({&Benchmark::whitespace,
+                   &Benchmark::identifier,
+                   &Benchmark::integralLiteral,
+                   &Benchmark::floatingPointLiteral,
+                   &Benchmark::decimalFloatingPointLiteral}, 10);
+
+    addInstancedBenchmarks({&Benchmark::parse,
+                            &Benchmark::scan}, 5,
+        Containers::arraySize(DocumentData));
+
+    addCustomInstancedBenchmarks({&Benchmark::parseAllocations}, 1,
+        Containers::arraySize(DocumentData),
+        &Benchmark::allocationBenchmarkBegin,
+        &Benchmark::allocationBenchmarkEnd,
+        BenchmarkUnits::Count);
+
+    addRepeatedTests({&Benchmark::fuzz}, FuzzRepeatCount);
+
+    _whitespace = repeat("  \t\n// a comment\n  /* another\n comment */ ", LiteralDataSize) + "X";
+    _identifiers = repeat("VertexArray unsigned_int32 attrib geometry_1 ", LiteralDataSize);
+    _integralLiterals = repeat("1234567,65535,0,42,", LiteralDataSize);
+    _floatingPointLiterals = repeat("-12.3456,0.5,3.0e-7,100.0,", LiteralDataSize);
+
+    _documents[VertexHeavy] = vertexHeavyDocument();
+    _documents[StructureHeavy] = structureHeavyDocument();
+    _documents[StringHeavy] = stringHeavyDocument();
+}
+
+void Benchmark::whitespace() {
+    setTestCaseDescription(Utility::formatString("{:.1f} MB", _whitespace.size()/1048576.0));
+
+    const Containers::ArrayView<const char> data{_whitespace.data(), _whitespace.size()};
+    const char* i = nullptr;
+    CORRADE_BENCHMARK(1)
+        i = Implementation::whitespace(data);
+
+    CORRADE_VERIFY(i == data.end() - 1);
+}
+
+void Benchmark::identifier() {
+    setTestCaseDescription(Utility::formatString("{:.1f} MB", _identifiers.size()/1048576.0));
+
+    /* The identifiers are separated by a single space */
+    const Containers::ArrayView<const char> data{_identifiers.data(), _identifiers.size()};
+    Implementation::ParseError error;
+    std::size_t count = 0;
+    CORRADE_BENCHMARK(1) {
+        for(const char* i = data; i && i != data.end(); ++count)
+            i = Implementation::identifier(data.suffix(i), error) + 1;
+    }
+
+    CORRADE_COMPARE(error.error, Implementation::ParseErrorType::NoError);
+    CORRADE_VERIFY(count);
+}
+
+void Benchmark::integralLiteral() {
+    setTestCaseDescription(Utility::formatString("{:.1f} MB", _integralLiterals.size()/1048576.0));
+
+    /* The literals are separated by a single comma */
+    const Containers::ArrayView<const char> data{_integralLiterals.data(), _integralLiterals.size()};
+    Implementation::ParseError error;
+    std::string buffer;
+    UnsignedInt sum = 0;
+    CORRADE_BENCHMARK(1) {
+        for(const char* i = data; i && i != data.end(); ++i) {
+            UnsignedInt value;
+            std::tie(i, value, std::ignore) = Implementation::integralLiteral<UnsignedInt>(data.suffix(i), buffer, error);
+            sum += value;
+        }
+    }
+
+    CORRADE_COMPARE(error.error, Implementation::ParseErrorType::NoError);
+    CORRADE_VERIFY(sum);
+}
+
+void Benchmark::floatingPointLiteral() {
+    setTestCaseDescription(Utility::formatString("{:.1f} MB", _floatingPointLiterals.size()/1048576.0));
+
+    /* The literals are separated by a single comma */
+    const Containers::ArrayView<const char> data{_floatingPointLiterals.data(), _floatingPointLiterals.size()};
+    Implementation::ParseError error;
+    std::string buffer;
+    Float sum = 0.0f;
+    CORRADE_BENCHMARK(1) {
+        for(const char* i = data; i && i != data.end(); ++i) {
+            Float value;
+            std::tie(i, value) = Implementation::floatingPointLiteral<Float>(data.suffix(i), buffer, error);
+            sum += value;
+        }
+    }
+
+    CORRADE_COMPARE(error.error, Implementation::ParseErrorType::NoError);
+    CORRADE_VERIFY(sum != 0.0f);
+}
+
+void Benchmark::decimalFloatingPointLiteral() {
+    setTestCaseDescription(Utility::formatString("{:.1f} MB", _floatingPointLiterals.size()/1048576.0));
+
+    /* Same as above, but going only through the fast path */
+    const Containers::ArrayView<const char> data{_floatingPointLiterals.data(), _floatingPointLiterals.size()};
+    Float sum = 0.0f;
+    CORRADE_BENCHMARK(1) {
+        for(const char* i = data; i && i != data.end(); ++i) {
+            Float value;
+            i = Implementation::decimalFloatingPointLiteral<Float>(data.suffix(i), value);
+            sum += value;
+        }
+    }
+
+    CORRADE_VERIFY(sum != 0.0f);
+}
+
+void Benchmark::parse() {
+    auto&& data = DocumentData[testCaseInstanceId()];
+    const std::string& document = _documents[testCaseInstanceId()];
+    setTestCaseDescription(Utility::formatString("{}, {:.1f} MB", data.name, document.size()/1048576.0));
+
+    bool parsed = false;
+    CORRADE_BENCHMARK(1) {
+        Document d;
+        parsed = d.parse({document.data(), document.size()}, Structures, Properties);
+    }
+
+    CORRADE_VERIFY(parsed);
+}
+
+void Benchmark::parseAllocations() {
+    auto&& data = DocumentData[testCaseInstanceId()];
+    const std::string& document = _documents[testCaseInstanceId()];
+    setTestCaseDescription(Utility::formatString("{}, {:.1f} MB", data.name, document.size()/1048576.0));
+
+    bool parsed = false;
+    CORRADE_BENCHMARK(1) {
+        Document d;
+        parsed = d.parse({document.data(), document.size()}, Structures, Properties);
+    }
+
+    CORRADE_VERIFY(parsed);
+}
+
+void Benchmark::scan() {
+    auto&& data = DocumentData[testCaseInstanceId()];
+    const std::string& document = _documents[testCaseInstanceId()];
+    setTestCaseDescription(Utility::formatString("{}, {:.1f} MB", data.name, document.size()/1048576.0));
+
+    NoopScanner scanner;
+    bool scanned = false;
+    CORRADE_BENCHMARK(1)
+        scanned = scanner.scan({document.data(), document.size()}, Structures, Properties);
+
+    CORRADE_VERIFY(scanned);
+}
+
+void Benchmark::fuzz() {
+    /* The first repeat checks the original document is fine */
+    std::string document = FuzzDocument;
+    std::mt19937 rng{UnsignedInt(testCaseRepeatId())};
+    if(testCaseRepeatId()) {
+        /* Replace a few characters with ones that have a meaning in the
+           syntax, occasionally also cut the document */
+        const char characters[] = " \n{}()[],=\"'\\/*$%-.0x";
+        const std::size_t mutationCount = 1 + rng() % 8;
+        for(std::size_t i = 0; i != mutationCount; ++i)
+            document[rng() % document.size()] = characters[rng() % (sizeof(characters) - 1)];
+        if(rng() % 4 == 0) document.resize(rng() % document.size());
+    }
+
+    /* Parse errors are expected, crashes, hangs or sanitizer reports not */
+    std::ostringstream out;
+    Error redirectError{&out};
+    const Containers::ArrayView<const char> data{document.data(), document.size()};
+
+    Document d;
+    const bool parsed = d.parse(data, Structures, Properties);
+
+    Document lazy;
+    lazy.setLazy(true);
+    const bool parsedLazy = lazy.parse(data, Structures, Properties);
+
+    NoopScanner scanner;
+    const bool scanned = scanner.scan(data, Structures, Properties);
+
+    /* Everything the parser accepts, the scanner has to accept as well. The
+       other way doesn't hold, as the scanner doesn't check the literals. */
+    if(parsed) CORRADE_VERIFY(scanned);
+
+    /* Similarly, invalid literals in data lists are not detected by the lazy
+       parsing until they're accessed */
+    if(parsed) CORRADE_VERIFY(parsedLazy);
+    if(!testCaseRepeatId()) {
+        CORRADE_VERIFY(parsed);
+        CORRADE_COMPARE(out.str(), "");
+    }
+}
+
+void Benchmark::allocationBenchmarkBegin() {
+    _allocationCount = allocationCount;
+}
+
+std::uint64_t Benchmark::allocationBenchmarkEnd() {
+    return allocationCount - _allocationCount;
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::OpenDdl::Test::Benchmark)
@@ -23,6 +23,7 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <cstring>
 #include <tuple>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/Utility/DebugStl.h>
@@ -40,6 +41,7 @@ struct ParsersTest: TestSuite::Tester {
     void findLastOf();
     void whitespace();
     void onelineComment();
+    void commentUnterminated();
     void multilineComment();
 
     void escapedCharInvalid();
@@ -68,6 +70,12 @@ struct ParsersTest: TestSuite::Tester {
     void floatLiteralInvalid();
     void floatLiteral();
     void floatLiteralBinary();
+    void floatLiteralDecimal();
+    void floatLiteralDecimalFallback();
+
+    void halfLiteralInvalid();
+    void halfLiteral();
+    void halfLiteralBinary();
 
     void stringLiteralInvalid();
     void stringLiteralEmpty();
@@ -84,6 +92,7 @@ struct ParsersTest: TestSuite::Tester {
 
     void typeLiteralInvalid();
     void typeLiteral();
+    void typeLiteralHalf();
 
     void propertyValueInvalid();
     void propertyValueBool();
@@ -95,6 +104,11 @@ struct ParsersTest: TestSuite::Tester {
     void propertyValueReference();
     void propertyValueReferenceNull();
     void propertyValueType();
+
+    void skipPropertyValueInvalid();
+    void skipPropertyValue();
+    void skipDataListInvalid();
+    void skipDataList();
 };
 
 ParsersTest::ParsersTest() {
@@ -102,6 +116,7 @@ ParsersTest::ParsersTest() {
               &ParsersTest::findLastOf,
               &ParsersTest::whitespace,
               &ParsersTest::onelineComment,
+              &ParsersTest::commentUnterminated,
               &ParsersTest::multilineComment,
 
               &ParsersTest::escapedCharInvalid,
@@ -130,6 +145,12 @@ ParsersTest::ParsersTest() {
               &ParsersTest::floatLiteralInvalid,
               &ParsersTest::floatLiteral,
               &ParsersTest::floatLiteralBinary,
+              &ParsersTest::floatLiteralDecimal,
+              &ParsersTest::floatLiteralDecimalFallback,
+
+              &ParsersTest::halfLiteralInvalid,
+              &ParsersTest::halfLiteral,
+              &ParsersTest::halfLiteralBinary,
 
               &ParsersTest::stringLiteralInvalid,
               &ParsersTest::stringLiteralEmpty,
@@ -146,6 +167,7 @@ ParsersTest::ParsersTest() {
 
               &ParsersTest::typeLiteralInvalid,
               &ParsersTest::typeLiteral,
+              &ParsersTest::typeLiteralHalf,
 
               &ParsersTest::propertyValueInvalid,
               &ParsersTest::propertyValueBool,
@@ -156,7 +178,12 @@ ParsersTest::ParsersTest() {
               &ParsersTest::propertyValueString,
               &ParsersTest::propertyValueReference,
               &ParsersTest::propertyValueReferenceNull,
-              &ParsersTest::propertyValueType});
+              &ParsersTest::propertyValueType,
+
+              &ParsersTest::skipPropertyValueInvalid,
+              &ParsersTest::skipPropertyValue,
+              &ParsersTest::skipDataListInvalid,
+              &ParsersTest::skipDataList});
 }
 
 #define VERIFY_PARSED(e, data, i, parsed) \
@@ -215,6 +242,17 @@ void ParsersTest::onelineComment() {
     VERIFY_PARSED(Implementation::ParseError{}, b, bi, " \b \t // comment /* other comment \n");
 }
 
+void ParsersTest::commentUnterminated() {
+    /* These used to loop forever */
+    CharacterLiteral a{" // comment"};
+    auto ai = Implementation::whitespace(a);
+    VERIFY_PARSED(Implementation::ParseError{}, a, ai, " // comment");
+
+    CharacterLiteral b{" /* comment *"};
+    auto bi = Implementation::whitespace(b);
+    VERIFY_PARSED(Implementation::ParseError{}, b, bi, " /* comment *");
+}
+
 void ParsersTest::multilineComment() {
     CharacterLiteral a{" \b \t /* comment \n bla \n comment */X"};
     auto ai = Implementation::whitespace(a);
@@ -459,6 +497,10 @@ void ParsersTest::floatLiteralInvalid() {
 
     CORRADE_VERIFY(!Implementation::floatingPointLiteral<Float>(CharacterLiteral{"0.e-"}, buffer, error).first);
     CORRADE_COMPARE(error.error, Implementation::ParseErrorType::InvalidLiteral);
+
+    /* Exponent character at the very end, used to read past it */
+    CORRADE_VERIFY(!Implementation::floatingPointLiteral<Float>(CharacterLiteral{"1.0e"}, buffer, error).first);
+    CORRADE_COMPARE(error.error, Implementation::ParseErrorType::InvalidLiteral);
 }
 
 void ParsersTest::floatLiteral() {
@@ -486,6 +528,90 @@ void ParsersTest::floatLiteralBinary() {
     CORRADE_COMPARE(value, -reinterpret_cast<Float&>(v));
 }
 
+void ParsersTest::floatLiteralDecimal() {
+    Implementation::ParseError error;
+    std::string buffer;
+
+    /* The result should be the same as with the generic path */
+    for(const char* string: {"-12.5e-1,", "0.1}", "3.14159265 ", "1000000", "+0.000001e+3", "1.e2,"}) {
+        CORRADE_ITERATION(string);
+        const CharacterLiteral a{string, std::strlen(string)};
+
+        Float value, expected;
+        const char* ai = Implementation::decimalFloatingPointLiteral<Float>(a, value);
+        const char* expectedI;
+        std::tie(expectedI, expected) = Implementation::floatingPointLiteral<Float>(a, buffer, error);
+        CORRADE_VERIFY(ai);
+        CORRADE_COMPARE(ai, expectedI);
+        CORRADE_COMPARE(value, expected);
+
+        Double doubleValue, doubleExpected;
+        ai = Implementation::decimalFloatingPointLiteral<Double>(a, doubleValue);
+        std::tie(expectedI, doubleExpected) = Implementation::floatingPointLiteral<Double>(a, buffer, error);
+        CORRADE_VERIFY(ai);
+        CORRADE_COMPARE(ai, expectedI);
+        CORRADE_COMPARE(doubleValue, doubleExpected);
+    }
+}
+
+void ParsersTest::floatLiteralDecimalFallback() {
+    /* Everything that's not a plain decimal literal is left to the generic
+       path */
+    for(const char* string: {"", "+", ".5", "1_0", "-1_.0_0e+5", "0xbad", "1.5f", "1e", "1.", "12345678901234567890", "1e30", "1e-30"}) {
+        CORRADE_ITERATION(string);
+        Float value;
+        CORRADE_VERIFY(!Implementation::decimalFloatingPointLiteral<Float>(CharacterLiteral{string, std::strlen(string)}, value));
+    }
+}
+
+void ParsersTest::halfLiteralInvalid() {
+    Implementation::ParseError error;
+    std::string buffer;
+
+    CORRADE_VERIFY(!Implementation::halfLiteral(CharacterLiteral{""}, buffer, error).first);
+    CORRADE_COMPARE(error.error, Implementation::ParseErrorType::ExpectedLiteral);
+    CORRADE_COMPARE(error.type, Type::Half);
+
+    CORRADE_VERIFY(!Implementation::halfLiteral(CharacterLiteral{"."}, buffer, error).first);
+    CORRADE_COMPARE(error.error, Implementation::ParseErrorType::InvalidLiteral);
+    CORRADE_COMPARE(error.type, Type::Half);
+
+    /* More bits than a half has */
+    CORRADE_VERIFY(!Implementation::halfLiteral(CharacterLiteral{"0x10000"}, buffer, error).first);
+    CORRADE_COMPARE(error.error, Implementation::ParseErrorType::LiteralOutOfRange);
+    CORRADE_COMPARE(error.type, Type::Half);
+}
+
+void ParsersTest::halfLiteral() {
+    Implementation::ParseError error;
+    std::string buffer;
+
+    /* Both the decimal fast path and the generic one */
+    for(const char* string: {"-12.5e-1X", "-1_.2_5X"}) {
+        CORRADE_ITERATION(string);
+        const CharacterLiteral a{string, std::strlen(string)};
+
+        const char* ai;
+        Half value;
+        std::tie(ai, value) = Implementation::halfLiteral(a, buffer, error);
+        VERIFY_PARSED(error, a, ai, std::string{string, std::strlen(string) - 1});
+        CORRADE_COMPARE(Float(value), -1.25f);
+    }
+}
+
+void ParsersTest::halfLiteralBinary() {
+    CharacterLiteral a{"-0x3c_00X"};
+
+    Implementation::ParseError error;
+    std::string buffer;
+    const char* ai;
+    Half value;
+    std::tie(ai, value) = Implementation::halfLiteral(a, buffer, error);
+    VERIFY_PARSED(error, a, ai, "-0x3c_00");
+    CORRADE_COMPARE(value.data(), 0xbc00);
+    CORRADE_COMPARE(Float(value), -1.0f);
+}
+
 void ParsersTest::stringLiteralInvalid() {
     Implementation::ParseError error;
 
@@ -615,6 +741,22 @@ void ParsersTest::typeLiteralInvalid() {
     CORRADE_COMPARE(error.error, Implementation::ParseErrorType::InvalidLiteral);
 }
 
+void ParsersTest::typeLiteralHalf() {
+    Implementation::ParseError error;
+
+    /* Both spellings, the longer one shouldn't get matched as float */
+    for(const char* string: {"half,", "float16,"}) {
+        CORRADE_ITERATION(string);
+        const CharacterLiteral a{string, std::strlen(string)};
+
+        const char* ai;
+        Type value;
+        std::tie(ai, value) = Implementation::typeLiteral(a, error);
+        VERIFY_PARSED(error, a, ai, std::string{string, std::strlen(string) - 1});
+        CORRADE_COMPARE(value, Type::Half);
+    }
+}
+
 void ParsersTest::typeLiteral() {
     CharacterLiteral a{"unsigned_int16,"};
 
@@ -815,6 +957,57 @@ void ParsersTest::propertyValueType() {
     CORRADE_COMPARE(typeValue, Type::Float);
 }
 
+void ParsersTest::skipPropertyValueInvalid() {
+    Implementation::ParseError error;
+
+    CORRADE_VERIFY(!Implementation::skipPropertyValue(CharacterLiteral{""}, error));
+    CORRADE_COMPARE(error.error, Implementation::ParseErrorType::ExpectedPropertyValue);
+
+    CORRADE_VERIFY(!Implementation::skipPropertyValue(CharacterLiteral{","}, error));
+    CORRADE_COMPARE(error.error, Implementation::ParseErrorType::InvalidPropertyValue);
+
+    CORRADE_VERIFY(!Implementation::skipPropertyValue(CharacterLiteral{"\"abc\\\""}, error));
+    CORRADE_COMPARE(error.error, Implementation::ParseErrorType::LiteralOutOfRange);
+}
+
+void ParsersTest::skipPropertyValue() {
+    Implementation::ParseError error;
+
+    CharacterLiteral a{"\"hello\\\"\" /* x */ \"world\" , "};
+    const char* ai = Implementation::skipPropertyValue(a, error);
+    VERIFY_PARSED(error, a, ai, "\"hello\\\"\" /* x */ \"world\"");
+
+    CharacterLiteral b{"-'\\''), "};
+    const char* bi = Implementation::skipPropertyValue(b, error);
+    VERIFY_PARSED(error, b, bi, "-'\\''");
+
+    CharacterLiteral c{"$a%b)"};
+    const char* ci = Implementation::skipPropertyValue(c, error);
+    VERIFY_PARSED(error, c, ci, "$a%b");
+
+    CharacterLiteral d{"-1.5e3,"};
+    const char* di = Implementation::skipPropertyValue(d, error);
+    VERIFY_PARSED(error, d, di, "-1.5e3");
+}
+
+void ParsersTest::skipDataListInvalid() {
+    Implementation::ParseError error;
+
+    CORRADE_VERIFY(!Implementation::skipDataList(CharacterLiteral{"{1, 2}, {3"}, error));
+    CORRADE_COMPARE(error.error, Implementation::ParseErrorType::ExpectedListEnd);
+
+    CORRADE_VERIFY(!Implementation::skipDataList(CharacterLiteral{"\"}"}, error));
+    CORRADE_COMPARE(error.error, Implementation::ParseErrorType::LiteralOutOfRange);
+}
+
+void ParsersTest::skipDataList() {
+    Implementation::ParseError error;
+
+    CharacterLiteral a{"{1, 2}, {'}', \"}\"} /* } */ } }"};
+    const char* ai = Implementation::skipDataList(a, error);
+    VERIFY_PARSED(error, a, ai, "{1, 2}, {'}', \"}\"} /* } */ ");
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::OpenDdl::Test::ParsersTest)
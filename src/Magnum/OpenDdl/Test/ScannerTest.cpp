@@ -0,0 +1,257 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstring>
+#include <sstream>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/FormatStl.h>
+
+#include "Magnum/OpenDdl/Scanner.h"
+#include "Magnum/OpenDdl/Type.h"
+
+namespace Magnum { namespace OpenDdl { namespace Test { namespace {
+
+struct ScannerTest: TestSuite::Tester {
+    explicit ScannerTest();
+
+    void empty();
+    void primitive();
+    void primitiveSubArray();
+    void primitiveLiteralsWithBraces();
+    void custom();
+    void customProperties();
+    void hierarchy();
+    void stop();
+
+    void invalid();
+};
+
+enum: Int {
+    Camera,
+    Metric,
+    Node
+};
+
+enum: Int {
+    key,
+    value
+};
+
+const std::initializer_list<CharacterLiteral> Structures{
+    "Camera", "Metric", "Node"};
+const std::initializer_list<CharacterLiteral> Properties{
+    "key", "value"};
+
+/* Records all callbacks into a string */
+struct RecordingScanner: Scanner {
+    void doStructureBegin(Int identifier, Containers::ArrayView<const char> name) override {
+        out += Utility::formatString("begin {} {}\n", identifier, std::string{name, name.size()});
+        if(stopAt == ++count) stop();
+    }
+
+    void doProperty(Int identifier, Containers::ArrayView<const char> value) override {
+        out += Utility::formatString("property {} {}\n", identifier, std::string{value, value.size()});
+        if(stopAt == ++count) stop();
+    }
+
+    void doStructureEnd() override {
+        out += "end\n";
+        if(stopAt == ++count) stop();
+    }
+
+    void doPrimitiveStructure(Type type, std::size_t subArraySize, Containers::ArrayView<const char> name, Containers::ArrayView<const char> data) override {
+        out += Utility::formatString("primitive {} {} {} {}\n", UnsignedInt(type), subArraySize, std::string{name, name.size()}, std::string{data, data.size()});
+        if(stopAt == ++count) stop();
+    }
+
+    std::string out;
+    std::size_t count{}, stopAt{};
+};
+
+const struct {
+    const char* name;
+    const char* data;
+    const char* message;
+} InvalidData[]{
+    {"expected list end", "float { 1.0, 2.0",
+        "expected } character on line 1"},
+    {"expected subarray size end", "float[2 { }",
+        "expected ] character on line 1"},
+    {"invalid subarray size", "float[0] { }",
+        "invalid subarray size on line 1"},
+    {"unterminated string in data list", "string { \"hello }",
+        "unterminated string literal on line 1"},
+    {"expected property assignment", "Node (key \"a\") { }",
+        "expected = character on line 1"},
+    {"expected property separator", "Node (key = 1 value = 2) { }",
+        "expected , character on line 1"},
+    {"expected property list end", "Node (key = 1",
+        "expected ) character on line 1"},
+    {"expected structure start", "Node\n$name ( ) }",
+        "expected { character on line 2"},
+    {"expected structure end", "Node { float { }\n",
+        "expected } character on line 2"},
+    {"invalid identifier", "Node { 3 { } }",
+        "invalid identifier on line 1"}
+};
+
+ScannerTest::ScannerTest() {
+    addTests({&ScannerTest::empty,
+              &ScannerTest::primitive,
+              &ScannerTest::primitiveSubArray,
+              &ScannerTest::primitiveLiteralsWithBraces,
+              &ScannerTest::custom,
+              &ScannerTest::customProperties,
+              &ScannerTest::hierarchy,
+              &ScannerTest::stop});
+
+    addInstancedTests({&ScannerTest::invalid},
+        Containers::arraySize(InvalidData));
+}
+
+void ScannerTest::empty() {
+    RecordingScanner scanner;
+    CORRADE_VERIFY(scanner.scan(CharacterLiteral{" // nothing\n"}, Structures, Properties));
+    CORRADE_COMPARE(scanner.out, "");
+}
+
+void ScannerTest::primitive() {
+    RecordingScanner scanner;
+    CORRADE_VERIFY(scanner.scan(CharacterLiteral{
+        "float $pi { 3.14, 2.71 /* e */ }\n"
+        "int32 {}"}, Structures, Properties));
+    CORRADE_COMPARE(scanner.out, Utility::formatString(
+        "primitive {} 0 $pi 3.14, 2.71 /* e */\n"
+        "primitive {} 0  \n", UnsignedInt(Type::Float), UnsignedInt(Type::Int)));
+}
+
+void ScannerTest::primitiveSubArray() {
+    RecordingScanner scanner;
+    CORRADE_VERIFY(scanner.scan(CharacterLiteral{
+        "unsigned_int16[ 3 ] %tri { {0, 1, 2}, {2, 1, 3} }"}, Structures, Properties));
+    CORRADE_COMPARE(scanner.out, Utility::formatString(
+        "primitive {} 3 %tri {{0, 1, 2}}, {{2, 1, 3}}\n", UnsignedInt(Type::UnsignedShort)));
+}
+
+void ScannerTest::primitiveLiteralsWithBraces() {
+    /* Braces inside string literals, character literals or comments
+       shouldn't end the list */
+    RecordingScanner scanner;
+    CORRADE_VERIFY(scanner.scan(CharacterLiteral{
+        "string { \"}\", \"\\\"{\" }\n"
+        "int8 { '}', '\\'' // }\n"
+        "}"}, Structures, Properties));
+    CORRADE_COMPARE(scanner.out, Utility::formatString(
+        "primitive {} 0  \"}}\", \"\\\"{{\"\n"
+        "primitive {} 0  '}}', '\\'' // }}\n", UnsignedInt(Type::String), UnsignedInt(Type::Byte)));
+}
+
+void ScannerTest::custom() {
+    RecordingScanner scanner;
+    CORRADE_VERIFY(scanner.scan(CharacterLiteral{
+        "Camera $cam {}\n"
+        "Light {}"}, Structures, Properties));
+    CORRADE_COMPARE(scanner.out, Utility::formatString(
+        "begin {} $cam\n"
+        "end\n"
+        "begin {} \n"
+        "end\n", Camera, UnknownIdentifier));
+}
+
+void ScannerTest::customProperties() {
+    RecordingScanner scanner;
+    CORRADE_VERIFY(scanner.scan(CharacterLiteral{
+        "Metric (key = \"distance\" \"s\", value = -'a', other = %a%b,\n"
+        "    key = 0x1F, value = float, key = null, key = true) {}"}, Structures, Properties));
+    CORRADE_COMPARE(scanner.out, Utility::formatString(
+        "begin {0} \n"
+        "property {1} \"distance\" \"s\"\n"
+        "property {2} -'a'\n"
+        "property {3} %a%b\n"
+        "property {1} 0x1F\n"
+        "property {2} float\n"
+        "property {1} null\n"
+        "property {1} true\n"
+        "end\n", Metric, key, value, UnknownIdentifier));
+}
+
+void ScannerTest::hierarchy() {
+    RecordingScanner scanner;
+    CORRADE_VERIFY(scanner.scan(CharacterLiteral{
+        "Node $a {\n"
+        "    Node %b (key = 1) { float { 1.0 } }\n"
+        "    Metric {}\n"
+        "}\n"
+        "Node {}"}, Structures, Properties));
+    CORRADE_COMPARE(scanner.out, Utility::formatString(
+        "begin {0} $a\n"
+        "begin {0} %b\n"
+        "property {2} 1\n"
+        "primitive {3} 0  1.0\n"
+        "end\n"
+        "begin {1} \n"
+        "end\n"
+        "end\n"
+        "begin {0} \n"
+        "end\n", Node, Metric, key, UnsignedInt(Type::Float)));
+}
+
+void ScannerTest::stop() {
+    /* Stopping in the middle of the document should succeed even if the rest
+       is invalid */
+    RecordingScanner scanner;
+    scanner.stopAt = 3;
+    CORRADE_VERIFY(scanner.scan(CharacterLiteral{
+        "Metric (key = \"a\") { float { 1.0 } }\n"
+        "Node { !!! }"}, Structures, Properties));
+    CORRADE_COMPARE(scanner.out, Utility::formatString(
+        "begin {} \n"
+        "property {} \"a\"\n"
+        "primitive {} 0  1.0\n", Metric, key, UnsignedInt(Type::Float)));
+
+    /* Scanning again resets the stopped state */
+    scanner.out = {};
+    scanner.stopAt = 0;
+    CORRADE_VERIFY(scanner.scan(CharacterLiteral{"Node {}"}, Structures, Properties));
+    CORRADE_COMPARE(scanner.out, Utility::formatString(
+        "begin {} \n"
+        "end\n", Node));
+}
+
+void ScannerTest::invalid() {
+    auto&& data = InvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    RecordingScanner scanner;
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!scanner.scan({data.data, std::strlen(data.data)}, Structures, Properties));
+    CORRADE_COMPARE(out.str(), Utility::formatString("OpenDdl::Scanner::scan(): {}\n", data.message));
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::OpenDdl::Test::ScannerTest)
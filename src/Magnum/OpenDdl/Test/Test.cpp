@@ -39,7 +39,10 @@ struct Test: TestSuite::Tester {
     explicit Test();
 
     void primitive();
+    void primitiveBool();
+    void primitiveMany();
     void primitiveEmpty();
+    void primitiveHalf();
     void primitiveName();
     void primitiveExpectedListStart();
     void primitiveExpectedListEnd();
@@ -104,12 +107,33 @@ struct Test: TestSuite::Tester {
     void referenceInProperty();
     void referenceNull();
     void referenceChain();
+    void referenceScoped();
     void referenceInvalid();
+
+    void parseThreads();
+    void parseThreadsError();
+
+    void lazy();
+    void lazyInvalid();
+
+    void serialize();
+    void deserializeInvalid();
+};
+
+const struct {
+    const char* name;
+    bool lazy;
+} ParseThreadsData[] {
+    {"", false},
+    {"lazy", true}
 };
 
 Test::Test() {
     addTests({&Test::primitive,
+              &Test::primitiveBool,
+              &Test::primitiveMany,
               &Test::primitiveEmpty,
+              &Test::primitiveHalf,
               &Test::primitiveName,
               &Test::primitiveExpectedListStart,
               &Test::primitiveExpectedListEnd,
@@ -174,7 +198,19 @@ Test::Test() {
               &Test::referenceInProperty,
               &Test::referenceNull,
               &Test::referenceChain,
+              &Test::referenceScoped,
               &Test::referenceInvalid});
+
+    addInstancedTests({&Test::parseThreads},
+        Containers::arraySize(ParseThreadsData));
+
+    addTests({&Test::parseThreadsError,
+
+              &Test::lazy,
+              &Test::lazyInvalid,
+
+              &Test::serialize,
+              &Test::deserializeInvalid});
 }
 
 void Test::primitive() {
@@ -192,6 +228,48 @@ void Test::primitive() {
         TestSuite::Compare::Container);
 }
 
+void Test::primitiveBool() {
+    Document d;
+    CORRADE_VERIFY(d.parse(CharacterLiteral{"bool { true, false, true }"}, {}, {}));
+
+    /* Bools are stored contiguously, so they can be accessed as an array */
+    Structure s = d.firstChild();
+    CORRADE_COMPARE(s.type(), Type::Bool);
+    CORRADE_COMPARE_AS(s.asArray<bool>(),
+        (Containers::Array<bool>{Containers::InPlaceInit, {true, false, true}}),
+        TestSuite::Compare::Container);
+}
+
+void Test::primitiveMany() {
+    /* Many lists of varying size, the storage gets reallocated in the
+       process */
+    std::string data;
+    for(Int i = 0; i != 100; ++i) {
+        data += "float[2] {";
+        for(Int j = 0; j != i; ++j) {
+            if(j) data += ", ";
+            data += "{" + std::to_string(i) + ", " + std::to_string(j) + "}";
+        }
+        data += "}\n";
+    }
+
+    Document d;
+    CORRADE_VERIFY(d.parse({data.data(), data.size()}, {}, {}));
+
+    Int i = 0;
+    for(Structure s: d.children()) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(s.arraySize(), 2*i);
+        Containers::ArrayView<const Float> floats = s.asArray<Float>();
+        for(Int j = 0; j != i; ++j) {
+            CORRADE_COMPARE(floats[2*j], Float(i));
+            CORRADE_COMPARE(floats[2*j + 1], Float(j));
+        }
+        ++i;
+    }
+    CORRADE_COMPARE(i, 100);
+}
+
 void Test::primitiveEmpty() {
     Document d;
     CORRADE_VERIFY(d.parse(CharacterLiteral{"float {}"}, {}, {}));
@@ -205,6 +283,31 @@ void Test::primitiveEmpty() {
     CORRADE_COMPARE(s.arraySize(), 0);
 }
 
+void Test::primitiveHalf() {
+    /* Both the immediate and the deferred conversion */
+    for(const bool lazy: {false, true}) {
+        CORRADE_ITERATION(lazy);
+
+        Document d;
+        d.setLazy(lazy);
+        CORRADE_VERIFY(d.parse(CharacterLiteral{"half[2] { {1.5, -0.25}, {0x3c00, -0x3c00} } float16 { 2.0 }"}, {}, {}));
+
+        Structure s = d.firstChild();
+        CORRADE_COMPARE(s.type(), Type::Half);
+        CORRADE_COMPARE(s.subArraySize(), 2);
+        CORRADE_VERIFY(d.parseDeferred(s));
+        CORRADE_COMPARE_AS(s.asArray<Half>(),
+            (Containers::Array<Half>{Containers::InPlaceInit, {
+                Half{1.5f}, Half{-0.25f}, Half{1.0f}, Half{-1.0f}
+            }}), TestSuite::Compare::Container);
+
+        Structure next = *s.findNext();
+        CORRADE_COMPARE(next.type(), Type::Half);
+        CORRADE_VERIFY(d.parseDeferred(next));
+        CORRADE_COMPARE(next.as<Half>(), Half{2.0f});
+    }
+}
+
 void Test::primitiveName() {
     Document d;
     CORRADE_VERIFY(d.parse(CharacterLiteral{"float %name {}"}, {}, {}));
@@ -1239,6 +1342,38 @@ bool %local4 {}
     CORRADE_COMPARE(local[2]->type(), Type::Int);
 }
 
+void Test::referenceScoped() {
+    /* Many scopes having the same local names, each reference should resolve
+       to the sibling in its own scope */
+    std::string s;
+    for(Int i = 0; i != 100; ++i) {
+        const std::string id = std::to_string(i);
+        s += "Root %r" + id + " {\n"
+             "    int32 %a { " + id + " }\n"
+             "    ref { %a, %r" + id + "%a, %b }\n"
+             "}\n";
+    }
+    s += "int32 %b { -1 }\n";
+
+    Document d;
+    CORRADE_VERIFY(d.parse({s.data(), s.size()}, structureIdentifiers, propertyIdentifiers));
+
+    Int i = 0;
+    for(Structure root: d.childrenOf(RootStructure)) {
+        CORRADE_ITERATION(i);
+
+        Containers::Array<Containers::Optional<Structure>> references = root.firstChildOf(Type::Reference).asReferenceArray();
+        CORRADE_COMPARE(references.size(), 3);
+        CORRADE_VERIFY(references[0]);
+        CORRADE_COMPARE(references[0]->as<Int>(), i);
+        CORRADE_VERIFY(references[0] == references[1]);
+        CORRADE_VERIFY(references[2]);
+        CORRADE_COMPARE(references[2]->as<Int>(), -1);
+        ++i;
+    }
+    CORRADE_COMPARE(i, 100);
+}
+
 void Test::referenceInvalid() {
     Document d;
     std::ostringstream out;
@@ -1271,6 +1406,270 @@ Root %root {
         "OpenDdl::Document::parse(): reference %local1%local2 was not found\n");
 }
 
+/* Large enough to be split into multiple chunks, with references pointing
+   across them and braces in literals and comments that shouldn't be matched */
+std::string threadsData(const Int count) {
+    std::string data;
+    for(Int i = 0; i != count; ++i) {
+        const std::string id = std::to_string(i);
+        data += "Root %r" + id + " (some = " + id + ".5, boolean = true, reference = $h" + std::to_string((i*7)%count) + ") {\n"
+                "    string { \"a}b\", \"c{\" } // }\n"
+                "    float[2] { {" + id + ", 1.5} }\n"
+                "}\n"
+                "Hierarchic $h" + id + " { /* { */ Some { int32 { " + id + " } ref { %r" + std::to_string((i*13)%count) + " } } }\n";
+    }
+    return data;
+}
+
+void Test::parseThreads() {
+    auto&& data = ParseThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    constexpr Int Count = 2000;
+    const std::string s = threadsData(Count);
+
+    Document d;
+    CORRADE_COMPARE(d.threadCount(), 1);
+    d.setThreadCount(4)
+        .setLazy(data.lazy);
+    CORRADE_COMPARE(d.threadCount(), 4);
+    CORRADE_VERIFY(d.parse({s.data(), s.size()}, structureIdentifiers, propertyIdentifiers));
+
+    Int i = 0;
+    for(Structure root: d.childrenOf(RootStructure)) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(root.name(), "%r" + std::to_string(i));
+        CORRADE_VERIFY(!root.parent());
+        CORRADE_COMPARE(root.propertyOf(SomeProperty).as<Float>(), i + 0.5f);
+        CORRADE_VERIFY(root.propertyOf(BooleanProperty).as<bool>());
+        Containers::Optional<Structure> reference = root.propertyOf(ReferenceProperty).asReference();
+        CORRADE_VERIFY(reference);
+        CORRADE_COMPARE(reference->name(), "$h" + std::to_string((i*7)%Count));
+
+        Structure string = root.firstChild();
+        CORRADE_VERIFY(string.parent() == root);
+        CORRADE_COMPARE_AS(string.asArray<std::string>(),
+            (Containers::Array<std::string>{Containers::InPlaceInit, {"a}b", "c{"}}),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(string.findNext()->asArray<Float>(),
+            (Containers::Array<Float>{Containers::InPlaceInit, {Float(i), 1.5f}}),
+            TestSuite::Compare::Container);
+
+        Containers::Optional<Structure> hierarchic = root.findNext();
+        CORRADE_VERIFY(hierarchic);
+        CORRADE_COMPARE(hierarchic->identifier(), HierarchicStructure);
+        CORRADE_COMPARE(hierarchic->name(), "$h" + std::to_string(i));
+        Structure some = hierarchic->firstChild();
+        CORRADE_COMPARE(some.firstChild().as<Int>(), i);
+        Containers::Optional<Structure> someReference = some.firstChild().findNext()->asReference();
+        CORRADE_VERIFY(someReference);
+        CORRADE_COMPARE(someReference->name(), "%r" + std::to_string((i*13)%Count));
+        ++i;
+    }
+    CORRADE_COMPARE(i, Count);
+}
+
+void Test::parseThreadsError() {
+    /* Errors in two different chunks, the first should be reported, same as
+       when parsing serially */
+    const std::string data = threadsData(1000) +
+        "Root { float { 1, 2 3 } }\n" +
+        threadsData(1000) +
+        "Root { int32 { 1, 2 3 } }\n";
+
+    std::ostringstream expected;
+    {
+        Error redirectError{&expected};
+        Document d;
+        CORRADE_VERIFY(!d.parse({data.data(), data.size()}, structureIdentifiers, propertyIdentifiers));
+    }
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    Document d;
+    d.setThreadCount(4);
+    CORRADE_VERIFY(!d.parse({data.data(), data.size()}, structureIdentifiers, propertyIdentifiers));
+    CORRADE_COMPARE(out.str(), expected.str());
+    CORRADE_COMPARE(out.str(), "OpenDdl::Document::parse(): expected , character on line 5001\n");
+}
+
+void Test::lazy() {
+    Document d;
+    CORRADE_VERIFY(!d.isLazy());
+    d.setLazy(true);
+    CORRADE_VERIFY(d.isLazy());
+
+    /* The original data can go away right after parsing */
+    {
+        std::string data = R"oddl(
+float[2] %a { {1.5, 2}, /* comment */ {3, 4} }
+Root { int32 { 5 } bool { true, false } }
+unsigned_int8 { 'a', 2 }
+string { "hello, world" }
+double {}
+        )oddl";
+        CORRADE_VERIFY(d.parse({data.data(), data.size()}, structureIdentifiers, propertyIdentifiers));
+        data.assign(data.size(), 'x');
+    }
+
+    /* Array sizes are known without parsing the literals */
+    Structure a = d.firstChild();
+    CORRADE_COMPARE(a.name(), "%a");
+    CORRADE_COMPARE(a.arraySize(), 4);
+    CORRADE_COMPARE(a.subArraySize(), 2);
+    Structure root = *a.findNext();
+    CORRADE_COMPARE(root.firstChild().arraySize(), 1);
+    CORRADE_COMPARE(root.firstChild().findNext()->arraySize(), 2);
+
+    /* The view stays valid even after other structures get parsed */
+    Containers::ArrayView<const Float> floats = a.asArray<Float>();
+    CORRADE_VERIFY(d.parseDeferred(root));
+    CORRADE_COMPARE(root.firstChild().as<Int>(), 5);
+    CORRADE_COMPARE_AS(root.firstChild().findNext()->asArray<bool>(),
+        (Containers::Array<bool>{Containers::InPlaceInit, {true, false}}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(floats,
+        (Containers::Array<Float>{Containers::InPlaceInit, {1.5f, 2.0f, 3.0f, 4.0f}}),
+        TestSuite::Compare::Container);
+
+    /* Lists with character and string literals are parsed directly */
+    Structure unsignedByte = *root.findNext();
+    CORRADE_COMPARE_AS(unsignedByte.asArray<UnsignedByte>(),
+        (Containers::Array<UnsignedByte>{Containers::InPlaceInit, {'a', 2}}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(unsignedByte.findNext()->as<std::string>(), "hello, world");
+    CORRADE_COMPARE(unsignedByte.findNext()->findNext()->arraySize(), 0);
+}
+
+void Test::lazyInvalid() {
+    Document d;
+    d.setLazy(true);
+
+    /* Structural errors are still reported during parse */
+    {
+        std::ostringstream out;
+        Error redirectError{&out};
+        CORRADE_VERIFY(!d.parse(CharacterLiteral{"float { 1, 2 3 }"}, {}, {}));
+        CORRADE_COMPARE(out.str(), "OpenDdl::Document::parse(): expected , character on line 1\n");
+    }
+
+    Document d2;
+    d2.setLazy(true);
+    CORRADE_VERIFY(d2.parse(CharacterLiteral{"float { 1, 2 }\nint32 { 3, 0xzz }"}, {}, {}));
+    CORRADE_VERIFY(d2.parseDeferred(d2.firstChild()));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    Structure second = *d2.firstChild().findNext();
+    CORRADE_VERIFY(!d2.parseDeferred(second));
+    CORRADE_COMPARE(out.str(), "OpenDdl::Document::parseDeferred(): invalid int32 literal on line 2\n");
+
+    /* The values are zero and the error isn't printed again */
+    out.str({});
+    CORRADE_COMPARE_AS(second.asArray<Int>(),
+        (Containers::Array<Int>{Containers::InPlaceInit, {0, 0}}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(out.str(), "");
+}
+
+void Test::serialize() {
+    Containers::Array<char> blob;
+    {
+        /* Lazy data get parsed during serialization */
+        Document d;
+        d.setLazy(true);
+        /* GCC < 4.9 cannot handle multiline raw string literals inside macros */
+        auto s = CharacterLiteral{R"oddl(
+Root %root (some = 15.5, boolean = true, reference = $b1) {
+    string { "hello", "world" }
+    ref { $b1, null }
+    type { float }
+}
+Hierarchic $b1 (some = "string") {
+    Some { int16[2] { {0, 1}, {2, 3} } double { 0.25 } bool { false } half { -2.5 } }
+}
+        )oddl"};
+        CORRADE_VERIFY(d.parse(s, structureIdentifiers, propertyIdentifiers));
+        blob = d.serialize();
+    }
+    CORRADE_VERIFY(!blob.empty());
+
+    Document d;
+    CORRADE_VERIFY(d.deserialize(blob, structureIdentifiers, propertyIdentifiers));
+
+    Structure root = d.firstChildOf(RootStructure);
+    CORRADE_COMPARE(root.name(), "%root");
+    CORRADE_VERIFY(!root.parent());
+    CORRADE_COMPARE(root.propertyCount(), 3);
+    CORRADE_COMPARE(root.propertyOf(SomeProperty).as<Float>(), 15.5f);
+    CORRADE_VERIFY(root.propertyOf(BooleanProperty).as<bool>());
+
+    Structure string = root.firstChild();
+    CORRADE_VERIFY(string.parent() == root);
+    CORRADE_COMPARE_AS(string.asArray<std::string>(),
+        (Containers::Array<std::string>{Containers::InPlaceInit, {"hello", "world"}}),
+        TestSuite::Compare::Container);
+    Structure ref = *string.findNext();
+    Containers::Array<Containers::Optional<Structure>> references = ref.asReferenceArray();
+    CORRADE_COMPARE(references.size(), 2);
+    CORRADE_VERIFY(!references[1]);
+    CORRADE_COMPARE(ref.findNext()->as<Type>(), Type::Float);
+
+    Structure hierarchic = d.firstChildOf(HierarchicStructure);
+    CORRADE_VERIFY(references[0] == hierarchic);
+    CORRADE_VERIFY(root.propertyOf(ReferenceProperty).asReference() == hierarchic);
+    CORRADE_COMPARE(hierarchic.propertyOf(SomeProperty).as<std::string>(), "string");
+    CORRADE_VERIFY(!hierarchic.findNext());
+
+    Structure some = hierarchic.firstChild();
+    CORRADE_COMPARE(some.identifier(), SomeStructure);
+    CORRADE_COMPARE(some.firstChild().subArraySize(), 2);
+    CORRADE_COMPARE_AS(some.firstChild().asArray<Short>(),
+        (Containers::Array<Short>{Containers::InPlaceInit, {0, 1, 2, 3}}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(some.firstChild().findNext()->as<Double>(), 0.25);
+    CORRADE_VERIFY(!some.firstChild().findNext()->findNext()->as<bool>());
+    CORRADE_COMPARE(some.firstChild().findNext()->findNext()->findNext()->as<Half>(), Half{-2.5f});
+
+    /* Serializing again gives the same result */
+    Containers::Array<char> blob2 = d.serialize();
+    CORRADE_COMPARE_AS(blob2, blob, TestSuite::Compare::Container);
+}
+
+void Test::deserializeInvalid() {
+    Containers::Array<char> blob;
+    {
+        Document d;
+        CORRADE_VERIFY(d.parse(CharacterLiteral{"Root %a { ref { %a } }"}, structureIdentifiers, propertyIdentifiers));
+        blob = d.serialize();
+    }
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    {
+        Document d;
+        CORRADE_VERIFY(!d.deserialize(CharacterLiteral{"Root {}"}, structureIdentifiers, propertyIdentifiers));
+    } {
+        Document d;
+        CORRADE_VERIFY(!d.deserialize(blob, {"Aaa"}, propertyIdentifiers));
+    } {
+        Document d;
+        CORRADE_VERIFY(!d.deserialize(blob.prefix(blob.size() - 1), structureIdentifiers, propertyIdentifiers));
+    } {
+        /* Make the reference point outside of the document. It's after the
+           header, 12 empty typed arrays, two strings and the reference
+           count. */
+        blob[8 + 4 + 4 + 8 + 12*8 + 8 + 8 + 8 + 2 + 8 + 1] = 1;
+        Document d;
+        CORRADE_VERIFY(!d.deserialize(blob, structureIdentifiers, propertyIdentifiers));
+    }
+    CORRADE_COMPARE(out.str(),
+        "OpenDdl::Document::deserialize(): invalid header\n"
+        "OpenDdl::Document::deserialize(): identifier lists don't match\n"
+        "OpenDdl::Document::deserialize(): invalid or truncated data\n"
+        "OpenDdl::Document::deserialize(): invalid or truncated data\n");
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::OpenDdl::Test::Test)
@@ -88,7 +88,11 @@ enum class Type: UnsignedInt {
     Long,
     #endif
 
-    /** @todo Half */
+    /**
+     * Half-float (16 bit). Stored in @ref Magnum::Half "Half" type.
+     * @m_since_latest_{plugins}
+     */
+    Half,
 
     /** Float (32 bit). Stored in @ref Magnum::Float "Float" type. */
     Float,
@@ -28,9 +28,16 @@
 
 #include "AssimpImporter.h"
 
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h>
@@ -38,9 +45,13 @@
 #include <Corrade/Utility/String.h>
 #include <Magnum/FileCallback.h>
 #include <Magnum/Mesh.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Quaternion.h>
 #include <Magnum/Math/Vector.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/PixelStorage.h>
+#include <Magnum/Trade/AnimationData.h>
 #include <Magnum/Trade/ArrayAllocator.h>
 #include <Magnum/Trade/CameraData.h>
 #include <Magnum/Trade/ImageData.h>
@@ -52,6 +63,12 @@
 #include <Magnum/Trade/TextureData.h>
 #include <MagnumPlugins/AnyImageImporter/AnyImageImporter.h>
 
+#ifdef MAGNUM_ASSIMPIMPORTER_WITH_PROFILING
+#define MAGNUM_IMPORTERPROFILING_ENABLED
+#endif
+#include "MagnumPlugins/Implementation/imageSignature.h"
+#include "MagnumPlugins/Implementation/importerProfiling.h"
+
 #include <assimp/postprocess.h>
 #include <assimp/DefaultLogger.hpp>
 #include <assimp/Importer.hpp>
@@ -78,6 +95,10 @@ template<> struct VectorConverter<4, Float, aiColor4D> {
 
 namespace Magnum { namespace Trade {
 
+#if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+#define _ASSIMPIMPORTER_USE_MAP
+#endif
+
 struct AssimpImporter::File {
     Containers::Optional<std::string> filePath;
     const aiScene* scene = nullptr;
@@ -88,8 +109,14 @@ struct AssimpImporter::File {
     std::unordered_map<const aiNode*, UnsignedInt> nodeIndices;
     std::unordered_map<const aiNode*, std::pair<Trade::ObjectInstanceType3D, UnsignedInt>> nodeInstances;
     std::unordered_map<std::string, UnsignedInt> materialIndicesForName;
+    std::unordered_map<std::string, UnsignedInt> animationIndicesForName;
     std::unordered_map<const aiMaterial*, UnsignedInt> textureIndices;
 
+    /* IDs of meshes that have bones, indexed by skin ID, and skin IDs of all
+       meshes, -1 for meshes without bones */
+    std::vector<UnsignedInt> skinMeshes;
+    std::vector<Int> meshSkins;
+
     /* Mapping for multi-mesh nodes:
        (in the following, "node" is an aiNode,
         "object" is Magnum::Trade::ObjectData3D)
@@ -110,9 +137,49 @@ struct AssimpImporter::File {
     std::vector<std::size_t> nodeMap;
 
     UnsignedInt imageImporterId = ~UnsignedInt{};
-    Containers::Optional<AnyImageImporter> imageImporter;
+    Containers::Pointer<AbstractImporter> imageImporter;
 
     Matrix4 rootTransformation;
+
+    /* If threads is larger than 1, contains meshes converted in parallel with
+       a previously requested one. Entries are removed once the mesh is
+       requested. */
+    std::unordered_map<UnsignedInt, MeshData> prefetchedMeshes;
+
+    /* If lazyPostprocess is enabled, contains the per-mesh postprocess steps
+       that get applied on the first mesh() call. Zero afterwards. */
+    UnsignedInt deferredPostprocessFlags = 0;
+
+    /* Objects referencing each mesh, in object order. meshInstanceOffsets
+       has mNumMeshes + 1 items, meshInstanceOffsets[i] points to the first
+       item in meshInstanceObjects for mesh `i` and
+       meshInstanceOffsets[i + 1] - meshInstanceOffsets[i] is the count of
+       objects referencing it. */
+    std::vector<UnsignedInt> meshInstanceOffsets;
+    std::vector<UnsignedInt> meshInstanceObjects;
+
+    /* Absolute transformations of all nodes, populated on the first
+       meshInstanceTransformations() call */
+    std::vector<Matrix4> nodeAbsoluteTransformations;
+
+    /* Returns ID of the mesh given object references or -1 if it doesn't
+       reference any, consistently with what doObject3D() returns */
+    Int meshForObject(const std::size_t id) const {
+        const std::pair<std::size_t, std::size_t>& spec = objectMap[id];
+        const aiNode* node = nodes[spec.first];
+        if(spec.second) return node->mMeshes[spec.second];
+        const auto instance = nodeInstances.find(node);
+        return instance != nodeInstances.end() && instance->second.first == ObjectInstanceType3D::Mesh ? Int(instance->second.second) : -1;
+    }
+
+    /* Returns ID of the first object for a node of given name or -1 if
+       there's no such node or it's the root node that isn't exposed */
+    Int objectForNodeName(const aiString& name) const {
+        const aiNode* node = scene->mRootNode ? scene->mRootNode->FindNode(name) : nullptr;
+        if(!node) return -1;
+        const auto found = nodeIndices.find(node);
+        return found != nodeIndices.end() ? Int(nodeMap[found->second]) : -1;
+    }
 };
 
 namespace {
@@ -121,6 +188,9 @@ void fillDefaultConfiguration(Utility::ConfigurationGroup& conf) {
     /** @todo horrible workaround, fix this properly */
 
     conf.setValue("ImportColladaIgnoreUpDirection", false);
+    conf.setValue("threads", 1);
+    conf.setValue("mapFiles", true);
+    conf.setValue("lazyPostprocess", false);
 
     Utility::ConfigurationGroup& postprocess = *conf.addGroup("postprocess");
     postprocess.setValue("JoinIdenticalVertices", true);
@@ -128,6 +198,14 @@ void fillDefaultConfiguration(Utility::ConfigurationGroup& conf) {
     postprocess.setValue("SortByPType", true);
 }
 
+/* Assimp::DefaultLogger is a global singleton shared by all plugin
+   instances. It's created when the first instance enables verbose output and
+   destroyed only once the last such instance disables it or gets destroyed,
+   so instances used from different threads don't tear it down under each
+   other. */
+std::mutex verboseLoggerMutex;
+UnsignedInt verboseLoggerUsers = 0;
+
 Containers::Pointer<Assimp::Importer> createImporter(Utility::ConfigurationGroup& conf) {
     Containers::Pointer<Assimp::Importer> importer{Containers::InPlaceInit};
 
@@ -154,7 +232,14 @@ AssimpImporter::AssimpImporter(PluginManager::AbstractManager& manager, const st
 AssimpImporter::~AssimpImporter() {
     /* Because we are dealing with a crappy singleton here, we need to make
        sure to clean up everything that might have been set earlier */
-    if(flags() & ImporterFlag::Verbose) Assimp::DefaultLogger::kill();
+    std::lock_guard<std::mutex> lock{verboseLoggerMutex};
+    if(_verboseLogger && !--verboseLoggerUsers)
+        Assimp::DefaultLogger::kill();
+}
+
+void AssimpImporter::setProfilingCallback(void(*callback)(const char*, UnsignedLong, std::size_t, void*), void* userData) {
+    _profilingCallback = callback;
+    _profilingUserData = userData;
 }
 
 ImporterFeatures AssimpImporter::doFeatures() const { return ImporterFeature::OpenData|ImporterFeature::OpenState|ImporterFeature::FileCallback; }
@@ -178,12 +263,13 @@ struct IoStream: Assimp::IOStream {
         _pos += size*maxCount;
         return maxCount;
     }
+    /* Seeking to the end of the file is allowed, same as with fseek() */
     aiReturn Seek(std::size_t offset, aiOrigin origin) override {
-        if(origin == aiOrigin_SET && offset < _data.size())
+        if(origin == aiOrigin_SET && offset <= _data.size())
             _pos = offset;
-        else if(origin == aiOrigin_CUR && _pos + offset < _data.size())
+        else if(origin == aiOrigin_CUR && _pos + offset <= _data.size())
             _pos += offset;
-        else if(origin == aiOrigin_END && _data.size() + std::ptrdiff_t(offset) < _data.size())
+        else if(origin == aiOrigin_END && _data.size() + std::ptrdiff_t(offset) <= _data.size())
             _pos = _data.size() + std::ptrdiff_t(offset);
         else return aiReturn_FAILURE;
         return aiReturn_SUCCESS;
@@ -202,6 +288,10 @@ struct IoStream: Assimp::IOStream {
     /* LCOV_EXCL_STOP */
 
     std::string filename; /* needed for closing properly on the user side */
+    #ifdef _ASSIMPIMPORTER_USE_MAP
+    /* If opened through MapIoSystem, owns the memory _data points to */
+    Containers::Array<const char, Utility::Directory::MapDeleter> mappedData;
+    #endif
     private:
         Containers::ArrayView<const char> _data;
         std::size_t _pos;
@@ -235,6 +325,48 @@ struct IoSystem: Assimp::IOSystem {
     void* _userData;
 };
 
+#ifdef _ASSIMPIMPORTER_USE_MAP
+/* Used when no file callback is set, memory-maps the files instead of
+   reading them through stdio so Assimp can seek around and read them without
+   any extra copies */
+struct MapIoSystem: Assimp::IOSystem {
+    bool Exists(const char* file) const override {
+        return Utility::Directory::exists(file);
+    }
+
+    char getOsSeparator() const override {
+        #ifdef CORRADE_TARGET_WINDOWS
+        return '\\';
+        #else
+        return '/';
+        #endif
+    }
+
+    Assimp::IOStream* Open(const char* file, const char* mode) override {
+        /* We are just a reader */
+        if(std::strchr(mode, 'w') || std::strchr(mode, 'a') || !Utility::Directory::exists(file))
+            return {};
+
+        /* Empty files can't be mapped */
+        const Containers::Optional<std::size_t> size = Utility::Directory::fileSize(file);
+        if(!size) return {};
+        if(!*size) return new IoStream{file, nullptr};
+
+        Containers::Array<const char, Utility::Directory::MapDeleter> data = Utility::Directory::mapRead(file);
+        if(!data) return {};
+        /* Moving the array doesn't change the data pointer, so the view in
+           the stream stays valid */
+        IoStream* stream = new IoStream{file, data};
+        stream->mappedData = std::move(data);
+        return stream;
+    }
+
+    void Close(Assimp::IOStream* file) override {
+        delete file;
+    }
+};
+#endif
+
 }
 
 void AssimpImporter::doSetFlags(const ImporterFlags flags) {
@@ -248,11 +380,18 @@ void AssimpImporter::doSetFlags(const ImporterFlags flags) {
        really restores things back to the default. Ugh, what's the obsession
        with extremely complex loggers everywhere? If a thing works, you don't
        need gigabytes of logs vomitted from every function calls. */
-    if(flags & ImporterFlag::Verbose) {
-        Assimp::DefaultLogger::create("", Assimp::Logger::VERBOSE);
-        Assimp::DefaultLogger::get()->attachStream(new DebugStream,
-            Assimp::Logger::Info|Assimp::Logger::Err|Assimp::Logger::Warn|Assimp::Logger::Debugging);
-    } else Assimp::DefaultLogger::kill();
+    std::lock_guard<std::mutex> lock{verboseLoggerMutex};
+    if((flags & ImporterFlag::Verbose) && !_verboseLogger) {
+        if(!verboseLoggerUsers++) {
+            Assimp::DefaultLogger::create("", Assimp::Logger::VERBOSE);
+            Assimp::DefaultLogger::get()->attachStream(new DebugStream,
+                Assimp::Logger::Info|Assimp::Logger::Err|Assimp::Logger::Warn|Assimp::Logger::Debugging);
+        }
+        _verboseLogger = true;
+    } else if(!(flags & ImporterFlag::Verbose) && _verboseLogger) {
+        if(!--verboseLoggerUsers) Assimp::DefaultLogger::kill();
+        _verboseLogger = false;
+    }
 }
 
 void AssimpImporter::doSetFileCallback(Containers::Optional<Containers::ArrayView<const char>>(*callback)(const std::string&, InputFileCallbackPolicy, void*), void* userData) {
@@ -299,26 +438,126 @@ UnsignedInt flagsFromConfiguration(Utility::ConfigurationGroup& conf) {
     _c(OptimizeGraph)
     _c(FlipUVs)
     _c(FlipWindingOrder)
+    _c(LimitBoneWeights)
     #undef _c
     return flags;
 }
 
+#ifdef _ASSIMPIMPORTER_USE_MAP
+/* If there's no file callback, installs or removes the memory-mapping IO
+   system based on the option. It's tracked the same way as the file callback
+   IO system, so it gets properly replaced or deleted in doSetFileCallback()
+   later. */
+void setupMapIoSystem(Assimp::Importer& importer, Assimp::IOSystem*& ourIoSystem, const bool mapFiles) {
+    const bool mapped = ourIoSystem && importer.GetIOHandler() == ourIoSystem;
+    if(mapFiles && !mapped)
+        importer.SetIOHandler(ourIoSystem = new MapIoSystem);
+    else if(!mapFiles && mapped) {
+        /* Passing nullptr deliberately leaks the previous instance */
+        delete ourIoSystem;
+        importer.SetIOHandler(nullptr);
+        ourIoSystem = nullptr;
+    }
+}
+#endif
+
+/* Postprocess steps in the order Assimp itself executes them, so applying
+   them one by one gives the same result as applying them all at once */
+constexpr std::pair<const char*, aiPostProcessSteps> PostprocessSteps[]{
+    {"ValidateDataStructure", aiProcess_ValidateDataStructure},
+    {"FlipUVs", aiProcess_FlipUVs},
+    {"FlipWindingOrder", aiProcess_FlipWindingOrder},
+    {"RemoveRedundantMaterials", aiProcess_RemoveRedundantMaterials},
+    {"FindInstances", aiProcess_FindInstances},
+    {"OptimizeGraph", aiProcess_OptimizeGraph},
+    {"OptimizeMeshes", aiProcess_OptimizeMeshes},
+    {"FindDegenerates", aiProcess_FindDegenerates},
+    {"GenUVCoords", aiProcess_GenUVCoords},
+    {"TransformUVCoords", aiProcess_TransformUVCoords},
+    {"PreTransformVertices", aiProcess_PreTransformVertices},
+    {"Triangulate", aiProcess_Triangulate},
+    {"SortByPType", aiProcess_SortByPType},
+    {"FindInvalidData", aiProcess_FindInvalidData},
+    {"FixInfacingNormals", aiProcess_FixInfacingNormals},
+    {"SplitLargeMeshes", aiProcess_SplitLargeMeshes},
+    {"GenNormals", aiProcess_GenNormals},
+    {"GenSmoothNormals", aiProcess_GenSmoothNormals},
+    {"JoinIdenticalVertices", aiProcess_JoinIdenticalVertices},
+    {"LimitBoneWeights", aiProcess_LimitBoneWeights},
+    {"ImproveCacheLocality", aiProcess_ImproveCacheLocality}
+};
+
+/* Postprocess steps that only modify contents of particular meshes without
+   affecting the mesh count, node hierarchy or materials. With lazyPostprocess
+   these are deferred to the first mesh() call. */
+constexpr UnsignedInt MeshLocalPostprocessSteps =
+    aiProcess_JoinIdenticalVertices|
+    aiProcess_Triangulate|
+    aiProcess_GenNormals|
+    aiProcess_GenSmoothNormals|
+    aiProcess_ImproveCacheLocality|
+    aiProcess_FixInfacingNormals|
+    aiProcess_FlipWindingOrder|
+    aiProcess_LimitBoneWeights;
+
+/* Applies each of the postprocess steps enabled in flags separately. If
+   verbose, prints how long each step took and how much the scene memory
+   changed. Returns nullptr if any step fails. */
+const aiScene* applyPostprocessStepsProfiled(Assimp::Importer& importer, const UnsignedInt flags, const bool verbose, const char* const messagePrefix) {
+    const aiScene* scene = importer.GetScene();
+    for(const std::pair<const char*, aiPostProcessSteps>& step: PostprocessSteps) {
+        if(!(flags & step.second)) continue;
+
+        aiMemoryInfo memoryBefore, memoryAfter;
+        importer.GetMemoryRequirements(memoryBefore);
+        const auto start = std::chrono::steady_clock::now();
+        if(!(scene = importer.ApplyPostProcessing(step.second))) {
+            Error{} << messagePrefix << "postprocess step" << step.first << "failed:" << importer.GetErrorString();
+            return nullptr;
+        }
+        const auto end = std::chrono::steady_clock::now();
+        importer.GetMemoryRequirements(memoryAfter);
+
+        if(verbose) Debug{} << messagePrefix << "postprocess step" << step.first << "took" << std::chrono::duration<Float, std::milli>(end - start).count() << "ms, scene memory changed by" << Long(memoryAfter.total) - Long(memoryBefore.total) << "bytes";
+    }
+
+    return scene;
+}
+
 }
 
 void AssimpImporter::doOpenData(const Containers::ArrayView<const char> data) {
     if(!_importer) _importer = createImporter(configuration());
 
     if(!_f) {
+        /* Files referenced from the data are opened through the IO system
+           as well */
+        #ifdef _ASSIMPIMPORTER_USE_MAP
+        if(!fileCallback())
+            setupMapIoSystem(*_importer, _ourFileCallback, configuration().value<bool>("mapFiles"));
+        #endif
+
         _f.reset(new File);
         /* File callbacks are set up in doSetFileCallbacks() */
-        if(!(_f->scene = _importer->ReadFileFromMemory(data.data(), data.size(), flagsFromConfiguration(configuration())))) {
+        UnsignedInt postprocessFlags = flagsFromConfiguration(configuration());
+        if(configuration().value<bool>("lazyPostprocess")) {
+            _f->deferredPostprocessFlags = postprocessFlags & MeshLocalPostprocessSteps;
+            postprocessFlags &= ~MeshLocalPostprocessSteps;
+        }
+        MAGNUM_IMPORTER_PROFILE(profile, _profilingCallback, _profilingUserData, "read", data.size());
+        const bool profileSteps = configuration().value<bool>("profilePostprocessSteps");
+        if(!(_f->scene = _importer->ReadFileFromMemory(data.data(), data.size(), profileSteps ? 0 : postprocessFlags))) {
             Error{} << "Trade::AssimpImporter::openData(): loading failed:" << _importer->GetErrorString();
             return;
         }
+        if(profileSteps && !(_f->scene = applyPostprocessStepsProfiled(*_importer, postprocessFlags, flags() & ImporterFlag::Verbose, "Trade::AssimpImporter::openData():")))
+            return;
     }
 
     CORRADE_INTERNAL_ASSERT(_f->scene);
 
+    MAGNUM_IMPORTER_PROFILE(profile, _profilingCallback, _profilingUserData, "scene", 0);
+
     /* Fill hashmaps for index lookup for materials/textures/meshes/nodes */
     _f->materialIndicesForName.reserve(_f->scene->mNumMaterials);
 
@@ -349,6 +588,18 @@ void AssimpImporter::doOpenData(const Containers::ArrayView<const char> data) {
         }
     }
 
+    _f->animationIndicesForName.reserve(_f->scene->mNumAnimations);
+    for(std::size_t i = 0; i != _f->scene->mNumAnimations; ++i)
+        _f->animationIndicesForName.emplace(_f->scene->mAnimations[i]->mName.C_Str(), i);
+
+    /* Each mesh with bones defines a skin */
+    _f->meshSkins.resize(_f->scene->mNumMeshes, -1);
+    for(std::size_t i = 0; i != _f->scene->mNumMeshes; ++i) {
+        if(!_f->scene->mMeshes[i]->HasBones()) continue;
+        _f->meshSkins[i] = _f->skinMeshes.size();
+        _f->skinMeshes.push_back(i);
+    }
+
     /* For some formats (such as COLLADA) Assimp fails to open the scene if
        there are no nodes, so there this is always non-null. For other formats
        (such as glTF) Assimp happily provides a null root node, even thought
@@ -418,6 +669,27 @@ void AssimpImporter::doOpenData(const Containers::ArrayView<const char> data) {
             }
         }
     }
+
+    /* Gather objects referencing each mesh. With the FindInstances
+       postprocess step enabled Assimp replaces duplicate meshes with
+       references to the first of them, so one mesh can be referenced from
+       many objects. Counting first and then filling to avoid an allocation
+       per mesh. */
+    _f->meshInstanceOffsets.assign(_f->scene->mNumMeshes + 1, 0);
+    for(std::size_t i = 0; i != _f->objectMap.size(); ++i) {
+        const Int mesh = _f->meshForObject(i);
+        if(mesh != -1) ++_f->meshInstanceOffsets[mesh + 1];
+    }
+    for(std::size_t i = 0; i != _f->scene->mNumMeshes; ++i)
+        _f->meshInstanceOffsets[i + 1] += _f->meshInstanceOffsets[i];
+    _f->meshInstanceObjects.resize(_f->meshInstanceOffsets.back());
+    {
+        std::vector<UnsignedInt> next{_f->meshInstanceOffsets.begin(), _f->meshInstanceOffsets.end() - 1};
+        for(std::size_t i = 0; i != _f->objectMap.size(); ++i) {
+            const Int mesh = _f->meshForObject(i);
+            if(mesh != -1) _f->meshInstanceObjects[next[mesh]++] = i;
+        }
+    }
 }
 
 void AssimpImporter::doOpenState(const void* state, const std::string& filePath) {
@@ -431,13 +703,29 @@ void AssimpImporter::doOpenState(const void* state, const std::string& filePath)
 void AssimpImporter::doOpenFile(const std::string& filename) {
     if(!_importer) _importer = createImporter(configuration());
 
+    #ifdef _ASSIMPIMPORTER_USE_MAP
+    if(!fileCallback())
+        setupMapIoSystem(*_importer, _ourFileCallback, configuration().value<bool>("mapFiles"));
+    #endif
+
     _f.reset(new File);
     _f->filePath = Utility::Directory::path(filename);
 
     /* File callbacks are set up in doSetFileCallback() */
-    if(!(_f->scene = _importer->ReadFile(filename, flagsFromConfiguration(configuration())))) {
-        Error{} << "Trade::AssimpImporter::openFile(): failed to open" << filename << Debug::nospace << ":" << _importer->GetErrorString();
-        return;
+    UnsignedInt postprocessFlags = flagsFromConfiguration(configuration());
+    if(configuration().value<bool>("lazyPostprocess")) {
+        _f->deferredPostprocessFlags = postprocessFlags & MeshLocalPostprocessSteps;
+        postprocessFlags &= ~MeshLocalPostprocessSteps;
+    }
+    {
+        MAGNUM_IMPORTER_PROFILE(profile, _profilingCallback, _profilingUserData, "read", 0);
+        const bool profileSteps = configuration().value<bool>("profilePostprocessSteps");
+        if(!(_f->scene = _importer->ReadFile(filename, profileSteps ? 0 : postprocessFlags))) {
+            Error{} << "Trade::AssimpImporter::openFile(): failed to open" << filename << Debug::nospace << ":" << _importer->GetErrorString();
+            return;
+        }
+        if(profileSteps && !(_f->scene = applyPostprocessStepsProfiled(*_importer, postprocessFlags, flags() & ImporterFlag::Verbose, "Trade::AssimpImporter::openFile():")))
+            return;
     }
 
     doOpenData({});
@@ -582,9 +870,82 @@ UnsignedInt AssimpImporter::doMeshCount() const {
     return _f->scene->mNumMeshes;
 }
 
-Containers::Optional<MeshData> AssimpImporter::doMesh(const UnsignedInt id, UnsignedInt) {
-    const aiMesh* mesh = _f->scene->mMeshes[id];
+namespace {
+
+Containers::Optional<MeshData> meshZeroCopy(const aiMesh& mesh, const MeshPrimitive primitive, const std::size_t attributeCount, Containers::Array<char>&& indexData, const MeshIndexData& indices) {
+    const UnsignedInt vertexCount = mesh.mNumVertices;
+    Containers::Array<MeshAttributeData> attributeData{attributeCount};
+    std::size_t attributeIndex = 0;
+
+    /* Each attribute is in a separate allocation, so the vertex data view has
+       to span all of them for MeshData to accept the attribute views */
+    const char* begin = reinterpret_cast<const char*>(mesh.mVertices);
+    const char* end = begin + vertexCount*sizeof(aiVector3D);
+    auto addAttribute = [&](const MeshAttributeData& attribute, const void* data, std::size_t size) {
+        begin = Math::min(begin, static_cast<const char*>(data));
+        end = Math::max(end, static_cast<const char*>(data) + size);
+        attributeData[attributeIndex++] = attribute;
+    };
+
+    addAttribute(MeshAttributeData{MeshAttribute::Position,
+        Containers::arrayView(reinterpret_cast<const Vector3*>(mesh.mVertices), vertexCount)},
+        mesh.mVertices, vertexCount*sizeof(aiVector3D));
+    if(mesh.HasNormals()) addAttribute(MeshAttributeData{MeshAttribute::Normal,
+        Containers::arrayView(reinterpret_cast<const Vector3*>(mesh.mNormals), vertexCount)},
+        mesh.mNormals, vertexCount*sizeof(aiVector3D));
+    if(mesh.HasTangentsAndBitangents()) {
+        addAttribute(MeshAttributeData{MeshAttribute::Tangent,
+            Containers::arrayView(reinterpret_cast<const Vector3*>(mesh.mTangents), vertexCount)},
+            mesh.mTangents, vertexCount*sizeof(aiVector3D));
+        addAttribute(MeshAttributeData{MeshAttribute::Bitangent,
+            Containers::arrayView(reinterpret_cast<const Vector3*>(mesh.mBitangents), vertexCount)},
+            mesh.mBitangents, vertexCount*sizeof(aiVector3D));
+    }
+    for(std::size_t layer = 0; layer < mesh.GetNumUVChannels(); ++layer) {
+        /* Warning already printed in doMesh() */
+        if(mesh.mNumUVComponents[layer] != 2) continue;
+
+        /* Taking just the first two components of the 3D coordinate, which
+           means a stride of three floats */
+        addAttribute(MeshAttributeData{MeshAttribute::TextureCoordinates,
+            Containers::arrayCast<const Vector2>(Containers::stridedArrayView(
+                Containers::arrayView(reinterpret_cast<const Vector3*>(mesh.mTextureCoords[layer]), vertexCount)))},
+            mesh.mTextureCoords[layer], vertexCount*sizeof(aiVector3D));
+    }
+    for(std::size_t layer = 0; layer < mesh.GetNumColorChannels(); ++layer)
+        addAttribute(MeshAttributeData{MeshAttribute::Color,
+            Containers::arrayView(reinterpret_cast<const Color4*>(mesh.mColors[layer]), vertexCount)},
+            mesh.mColors[layer], vertexCount*sizeof(aiColor4D));
+
+    /* Check we pre-calculated well */
+    CORRADE_INTERNAL_ASSERT(attributeIndex == attributeCount);
+
+    return MeshData{primitive, std::move(indexData), indices,
+        {}, Containers::ArrayView<const void>{begin, std::size_t(end - begin)},
+        std::move(attributeData), MeshData::ImplicitVertexCount, &mesh};
+}
+
+/* Custom attributes for skinning, named consistently with TinyGltfImporter */
+constexpr MeshAttribute JointIdsAttribute = meshAttributeCustom(0);
+constexpr MeshAttribute WeightsAttribute = meshAttributeCustom(1);
+
+/* Meshes that print no warning or error during conversion, so they can be
+   converted on a different thread ahead of time without losing any
+   diagnostics */
+bool canConvertMeshInParallel(const aiMesh& mesh) {
+    if(mesh.mPrimitiveTypes != aiPrimitiveType_POINT &&
+       mesh.mPrimitiveTypes != aiPrimitiveType_LINE &&
+       mesh.mPrimitiveTypes != aiPrimitiveType_TRIANGLE)
+        return false;
+    if(mesh.mNumBones > 65536) return false;
+    for(std::size_t layer = 0; layer < mesh.GetNumUVChannels(); ++layer)
+        if(mesh.mNumUVComponents[layer] != 2) return false;
+    return true;
+}
 
+/* Doesn't touch any importer state, so it can be called from multiple
+   threads for different meshes */
+Containers::Optional<MeshData> convertMesh(const aiMesh* const mesh, const bool zeroCopy) {
     /* Primitive */
     MeshPrimitive primitive;
     if(mesh->mPrimitiveTypes == aiPrimitiveType_POINT) {
@@ -598,6 +959,19 @@ Containers::Optional<MeshData> AssimpImporter::doMesh(const UnsignedInt id, Unsi
         return Containers::NullOpt;
     }
 
+    /* Import indices. There doesn't seem to be any shortcut to just copy all
+       index data in a single go, so having to iterate over faces. Ugh. */
+    Containers::Array<UnsignedInt> indexData;
+    Containers::arrayReserve<ArrayAllocator>(indexData, mesh->mNumFaces*3);
+    for(std::size_t faceIndex = 0; faceIndex < mesh->mNumFaces; ++faceIndex) {
+        const aiFace& face = mesh->mFaces[faceIndex];
+        CORRADE_ASSERT(face.mNumIndices <= 3, "Trade::AssimpImporter::mesh(): triangulation while loading should have ensured <= 3 vertices per primitive", {});
+
+        Containers::arrayAppend<ArrayAllocator>(indexData, {face.mIndices, face.mNumIndices});
+    }
+
+    MeshIndexData indices{indexData};
+
     /* Gather all attributes. Position is there always, others are optional */
     std::size_t attributeCount = 1;
     std::ptrdiff_t stride = sizeof(Vector3);
@@ -621,9 +995,27 @@ Containers::Optional<MeshData> AssimpImporter::doMesh(const UnsignedInt id, Unsi
     }
     attributeCount += mesh->GetNumColorChannels();
     stride += mesh->GetNumColorChannels()*sizeof(Color4);
+    /* Bone weights and joint IDs, with weights first to keep them aligned */
+    if(mesh->HasBones()) {
+        if(mesh->mNumBones > 65536) {
+            Error{} << "Trade::AssimpImporter::mesh(): expected at most 65536 bones but got" << mesh->mNumBones;
+            return Containers::NullOpt;
+        }
+
+        attributeCount += 2;
+        stride += sizeof(Vector4) + sizeof(Vector4us);
+    }
 
-    /* Allocate vertex data, fill in the attributes */
     const UnsignedInt vertexCount = mesh->mNumVertices;
+
+    /* With zero copy, the attributes reference the Assimp arrays directly.
+       Skinning attributes are calculated, so such meshes are always
+       copied. */
+    if(vertexCount && zeroCopy && !mesh->HasBones())
+        return meshZeroCopy(*mesh, primitive, attributeCount,
+            Containers::arrayAllocatorCast<char, ArrayAllocator>(std::move(indexData)), indices);
+
+    /* Allocate vertex data, fill in the attributes */
     Containers::Array<char> vertexData{Containers::NoInit, std::size_t(stride)*vertexCount};
     Containers::Array<MeshAttributeData> attributeData{attributeCount};
     std::size_t attributeIndex = 0;
@@ -708,22 +1100,54 @@ Containers::Optional<MeshData> AssimpImporter::doMesh(const UnsignedInt id, Unsi
         attributeOffset += sizeof(Color4);
     }
 
-    /* Check we pre-calculated well */
-    CORRADE_INTERNAL_ASSERT(attributeOffset == std::size_t(stride));
-    CORRADE_INTERNAL_ASSERT(attributeIndex == attributeCount);
+    /* Skinning. Assimp stores the influenced vertices per bone, so the
+       weights are distributed to the vertices and for each vertex the four
+       largest are kept. Unused slots have a zero weight, so they get filled
+       first. */
+    if(mesh->HasBones()) {
+        Containers::StridedArrayView1D<Vector4> weights{vertexData,
+            reinterpret_cast<Vector4*>(vertexData + attributeOffset),
+            vertexCount, stride};
+        attributeOffset += sizeof(Vector4);
+        Containers::StridedArrayView1D<Vector4us> jointIds{vertexData,
+            reinterpret_cast<Vector4us*>(vertexData + attributeOffset),
+            vertexCount, stride};
+        attributeOffset += sizeof(Vector4us);
 
-    /* Import indices. There doesn't seem to be any shortcut to just copy all
-       index data in a single go, so having to iterate over faces. Ugh. */
-    Containers::Array<UnsignedInt> indexData;
-    Containers::arrayReserve<ArrayAllocator>(indexData, mesh->mNumFaces*3);
-    for(std::size_t faceIndex = 0; faceIndex < mesh->mNumFaces; ++faceIndex) {
-        const aiFace& face = mesh->mFaces[faceIndex];
-        CORRADE_ASSERT(face.mNumIndices <= 3, "Trade::AssimpImporter::mesh(): triangulation while loading should have ensured <= 3 vertices per primitive", {});
+        for(std::size_t i = 0; i != vertexCount; ++i) {
+            weights[i] = {};
+            jointIds[i] = {};
+        }
 
-        Containers::arrayAppend<ArrayAllocator>(indexData, {face.mIndices, face.mNumIndices});
+        for(UnsignedInt bone = 0; bone != mesh->mNumBones; ++bone) {
+            const aiBone& b = *mesh->mBones[bone];
+            for(const aiVertexWeight& weight: Containers::arrayView(b.mWeights, b.mNumWeights)) {
+                if(weight.mVertexId >= vertexCount) {
+                    Error{} << "Trade::AssimpImporter::mesh(): bone" << bone << "references vertex" << weight.mVertexId << "out of bounds for" << vertexCount << "vertices";
+                    return Containers::NullOpt;
+                }
+
+                Vector4& vertexWeights = weights[weight.mVertexId];
+                std::size_t smallest = 0;
+                for(std::size_t i = 1; i != 4; ++i)
+                    if(vertexWeights[i] < vertexWeights[smallest]) smallest = i;
+                if(weight.mWeight > vertexWeights[smallest]) {
+                    vertexWeights[smallest] = weight.mWeight;
+                    jointIds[weight.mVertexId][smallest] = bone;
+                }
+            }
+        }
+
+        attributeData[attributeIndex++] = MeshAttributeData{
+            WeightsAttribute, weights};
+        attributeData[attributeIndex++] = MeshAttributeData{
+            JointIdsAttribute, jointIds};
     }
 
-    MeshIndexData indices{indexData};
+    /* Check we pre-calculated well */
+    CORRADE_INTERNAL_ASSERT(attributeOffset == std::size_t(stride));
+    CORRADE_INTERNAL_ASSERT(attributeIndex == attributeCount);
+
     return MeshData{primitive,
         Containers::arrayAllocatorCast<char, ArrayAllocator>(std::move(indexData)),
         indices,
@@ -731,6 +1155,193 @@ Containers::Optional<MeshData> AssimpImporter::doMesh(const UnsignedInt id, Unsi
         MeshData::ImplicitVertexCount, mesh};
 }
 
+/* Calls f(t) for t in [0, threadCount), the first on the current thread and
+   the rest on new threads */
+template<class F> void parallelFor(const UnsignedInt threadCount, const F& f) {
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(UnsignedInt t = 1; t < threadCount; ++t)
+        threads[t - 1] = std::thread{f, t};
+    f(0);
+    for(std::thread& thread: threads) thread.join();
+}
+
+/* How many subsequent meshes each thread converts ahead of time. Meshes in
+   large scenes tend to be small, so convert more than one to make up for the
+   thread creation overhead. */
+constexpr UnsignedInt MeshesPerThread = 16;
+
+}
+
+Containers::Optional<MeshData> AssimpImporter::doMesh(const UnsignedInt id, UnsignedInt) {
+    /* Apply the per-mesh postprocess steps deferred by lazyPostprocess. If
+       that fails, Assimp deletes the scene, which effectively closes the
+       file. */
+    if(const UnsignedInt postprocessFlags = _f->deferredPostprocessFlags) {
+        MAGNUM_IMPORTER_PROFILE(profile, _profilingCallback, _profilingUserData, "postprocess", 0);
+        _f->deferredPostprocessFlags = 0;
+        if(configuration().value<bool>("profilePostprocessSteps"))
+            _f->scene = applyPostprocessStepsProfiled(*_importer, postprocessFlags, flags() & ImporterFlag::Verbose, "Trade::AssimpImporter::mesh():");
+        else if(!(_f->scene = _importer->ApplyPostProcessing(postprocessFlags)))
+            Error{} << "Trade::AssimpImporter::mesh(): postprocessing failed:" << _importer->GetErrorString();
+        if(!_f->scene) return Containers::NullOpt;
+    }
+
+    MAGNUM_IMPORTER_PROFILE(profile, _profilingCallback, _profilingUserData, "mesh", 0);
+    Containers::Optional<MeshData> out = meshInternal(id);
+    if(out) MAGNUM_IMPORTER_PROFILE_BYTES(profile, out->vertexData().size() + out->indexData().size());
+    return out;
+}
+
+Containers::Optional<MeshData> AssimpImporter::meshInternal(const UnsignedInt id) {
+    /* The mesh was converted together with another one already */
+    const auto prefetched = _f->prefetchedMeshes.find(id);
+    if(prefetched != _f->prefetchedMeshes.end()) {
+        MeshData mesh = std::move(prefetched->second);
+        _f->prefetchedMeshes.erase(prefetched);
+        return Containers::optional(std::move(mesh));
+    }
+
+    const bool zeroCopy = configuration().value<bool>("zeroCopy");
+    UnsignedInt threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+    if(threadCount == 1)
+        return convertMesh(_f->scene->mMeshes[id], zeroCopy);
+
+    /* Convert the requested mesh together with a batch of the meshes
+       following it in parallel. Meshes that would print a diagnostic are
+       skipped and converted only once requested directly. */
+    Containers::Array<UnsignedInt> ids;
+    arrayAppend(ids, id);
+    for(UnsignedInt i = id + 1; i < _f->scene->mNumMeshes && ids.size() < threadCount*MeshesPerThread; ++i) {
+        if(_f->prefetchedMeshes.find(i) != _f->prefetchedMeshes.end() ||
+           !canConvertMeshInParallel(*_f->scene->mMeshes[i]))
+            continue;
+        arrayAppend(ids, i);
+    }
+
+    /* The requested mesh is converted on the current thread, so any error
+       printed for it goes to the redirected output as usual */
+    Containers::Array<Containers::Optional<MeshData>> meshes{ids.size()};
+    const UnsignedInt usedThreadCount = Math::min(threadCount, UnsignedInt(ids.size()));
+    parallelFor(usedThreadCount, [&](const UnsignedInt t) {
+        for(std::size_t i = t; i < ids.size(); i += usedThreadCount)
+            meshes[i] = convertMesh(_f->scene->mMeshes[ids[i]], zeroCopy);
+    });
+
+    for(std::size_t i = 1; i < ids.size(); ++i)
+        if(meshes[i]) _f->prefetchedMeshes.emplace(ids[i], std::move(*meshes[i]));
+    return std::move(meshes[0]);
+}
+
+MeshAttribute AssimpImporter::doMeshAttributeForName(const std::string& name) {
+    if(name == "JOINTS_0") return JointIdsAttribute;
+    if(name == "WEIGHTS_0") return WeightsAttribute;
+    return {};
+}
+
+std::string AssimpImporter::doMeshAttributeName(const UnsignedShort name) {
+    if(meshAttributeCustom(name) == JointIdsAttribute) return "JOINTS_0";
+    if(meshAttributeCustom(name) == WeightsAttribute) return "WEIGHTS_0";
+    return {};
+}
+
+UnsignedInt AssimpImporter::skin3DCount() {
+    CORRADE_ASSERT(isOpened(), "Trade::AssimpImporter::skin3DCount(): no file opened", {});
+    return _f->skinMeshes.size();
+}
+
+Int AssimpImporter::object3DSkin(const UnsignedInt id) {
+    CORRADE_ASSERT(isOpened(), "Trade::AssimpImporter::object3DSkin(): no file opened", {});
+    CORRADE_ASSERT(id < object3DCount(), "Trade::AssimpImporter::object3DSkin(): index" << id << "out of range for" << object3DCount() << "entries", {});
+
+    const auto& spec = _f->objectMap[id];
+    const aiNode* node = _f->nodes[spec.first];
+    if(!node->mNumMeshes) return -1;
+    return _f->meshSkins[node->mMeshes[spec.second]];
+}
+
+Containers::Optional<Containers::Array<UnsignedInt>> AssimpImporter::skin3DJoints(const UnsignedInt id) {
+    CORRADE_ASSERT(isOpened(), "Trade::AssimpImporter::skin3DJoints(): no file opened", {});
+    CORRADE_ASSERT(id < _f->skinMeshes.size(), "Trade::AssimpImporter::skin3DJoints(): index" << id << "out of range for" << _f->skinMeshes.size() << "entries", {});
+
+    const aiMesh* mesh = _f->scene->mMeshes[_f->skinMeshes[id]];
+    Containers::Array<UnsignedInt> joints{Containers::NoInit, mesh->mNumBones};
+    for(std::size_t i = 0; i != mesh->mNumBones; ++i) {
+        const Int object = _f->objectForNodeName(mesh->mBones[i]->mName);
+        if(object == -1) {
+            Error{} << "Trade::AssimpImporter::skin3DJoints(): joint node" << mesh->mBones[i]->mName.C_Str() << "not found";
+            return Containers::NullOpt;
+        }
+        joints[i] = object;
+    }
+
+    return Containers::optional(std::move(joints));
+}
+
+Containers::Array<Matrix4> AssimpImporter::skin3DInverseBindMatrices(const UnsignedInt id) {
+    CORRADE_ASSERT(isOpened(), "Trade::AssimpImporter::skin3DInverseBindMatrices(): no file opened", {});
+    CORRADE_ASSERT(id < _f->skinMeshes.size(), "Trade::AssimpImporter::skin3DInverseBindMatrices(): index" << id << "out of range for" << _f->skinMeshes.size() << "entries", {});
+
+    /* aiMatrix4x4 is always row-major, transpose */
+    const aiMesh* mesh = _f->scene->mMeshes[_f->skinMeshes[id]];
+    Containers::Array<Matrix4> matrices{Containers::NoInit, mesh->mNumBones};
+    for(std::size_t i = 0; i != mesh->mNumBones; ++i)
+        matrices[i] = Matrix4::from(reinterpret_cast<const float*>(&mesh->mBones[i]->mOffsetMatrix)).transposed();
+
+    return matrices;
+}
+
+UnsignedInt AssimpImporter::meshInstanceCount(const UnsignedInt id) {
+    CORRADE_ASSERT(isOpened(), "Trade::AssimpImporter::meshInstanceCount(): no file opened", {});
+    CORRADE_ASSERT(id < _f->scene->mNumMeshes, "Trade::AssimpImporter::meshInstanceCount(): index" << id << "out of range for" << _f->scene->mNumMeshes << "entries", {});
+
+    return _f->meshInstanceOffsets[id + 1] - _f->meshInstanceOffsets[id];
+}
+
+Containers::Array<UnsignedInt> AssimpImporter::meshInstances(const UnsignedInt id) {
+    CORRADE_ASSERT(isOpened(), "Trade::AssimpImporter::meshInstances(): no file opened", {});
+    CORRADE_ASSERT(id < _f->scene->mNumMeshes, "Trade::AssimpImporter::meshInstances(): index" << id << "out of range for" << _f->scene->mNumMeshes << "entries", {});
+
+    const UnsignedInt begin = _f->meshInstanceOffsets[id];
+    const UnsignedInt end = _f->meshInstanceOffsets[id + 1];
+    Containers::Array<UnsignedInt> objects{Containers::NoInit, end - begin};
+    Utility::copy(Containers::arrayView(_f->meshInstanceObjects.data() + begin, end - begin), objects);
+    return objects;
+}
+
+Containers::Array<Matrix4> AssimpImporter::meshInstanceTransformations(const UnsignedInt id) {
+    CORRADE_ASSERT(isOpened(), "Trade::AssimpImporter::meshInstanceTransformations(): no file opened", {});
+    CORRADE_ASSERT(id < _f->scene->mNumMeshes, "Trade::AssimpImporter::meshInstanceTransformations(): index" << id << "out of range for" << _f->scene->mNumMeshes << "entries", {});
+
+    /* Calculate absolute transformations of all nodes on first use. The
+       nodes are ordered breadth-first so a parent is always processed
+       before its children. Top-level nodes get the root transformation
+       premultiplied, consistently with doObject3D(). */
+    if(_f->nodeAbsoluteTransformations.empty() && !_f->nodes.empty()) {
+        _f->nodeAbsoluteTransformations.resize(_f->nodes.size());
+        for(std::size_t i = 0; i != _f->nodes.size(); ++i) {
+            const aiNode* node = _f->nodes[i];
+            /* aiMatrix4x4 is always row-major, transpose */
+            const Matrix4 transformation = Matrix4::from(reinterpret_cast<const float*>(&node->mTransformation)).transposed();
+            if(node->mParent == _f->scene->mRootNode)
+                _f->nodeAbsoluteTransformations[i] = _f->rootTransformation*transformation;
+            else if(node->mParent)
+                _f->nodeAbsoluteTransformations[i] = _f->nodeAbsoluteTransformations[_f->nodeIndices[node->mParent]]*transformation;
+            else
+                _f->nodeAbsoluteTransformations[i] = transformation;
+        }
+    }
+
+    /* Extra objects of multi-mesh nodes have an identity transformation, so
+       for those it's the same as for the node itself */
+    const UnsignedInt begin = _f->meshInstanceOffsets[id];
+    const UnsignedInt end = _f->meshInstanceOffsets[id + 1];
+    Containers::Array<Matrix4> transformations{Containers::NoInit, end - begin};
+    for(std::size_t i = begin; i != end; ++i)
+        transformations[i - begin] = _f->nodeAbsoluteTransformations[_f->objectMap[_f->meshInstanceObjects[i]].first];
+    return transformations;
+}
+
 UnsignedInt AssimpImporter::doMaterialCount() const { return _f->scene->mNumMaterials; }
 
 Int AssimpImporter::doMaterialForName(const std::string& name) {
@@ -939,13 +1550,13 @@ AbstractImporter* AssimpImporter::setupOrReuseImporterForImage(const UnsignedInt
        that case. Going through everything below again would not change the
        outcome anyway, only spam the output with redundant messages. */
     if(_f->imageImporterId == id)
-        return _f->imageImporter ? &*_f->imageImporter : nullptr;
+        return _f->imageImporter.get();
 
     /* Otherwise reset the importer and remember the new ID. If the import
        fails, the importer will stay unset, but the ID will be updated so the
        next round can again just return nullptr above instead of going through
        the doomed-to-fail process again. */
-    _f->imageImporter = Containers::NullOpt;
+    _f->imageImporter = nullptr;
     _f->imageImporterId = id;
 
     aiString texturePath;
@@ -972,10 +1583,13 @@ AbstractImporter* AssimpImporter::setupOrReuseImporterForImage(const UnsignedInt
             /* Compressed image data */
             auto textureData = Containers::ArrayView<const char>(reinterpret_cast<const char*>(texture->pcData), texture->mWidth);
 
-            AnyImageImporter importer{*manager()};
-            if(!importer.openData(textureData))
+            /* Open directly with the plugin matching the signature if
+               possible, saving going through AnyImageImporter */
+            Containers::Pointer<AbstractImporter> importer = Implementation::imageImporterForData(*manager(), textureData);
+            if(!importer) importer.reset(new AnyImageImporter{*manager()});
+            if(!importer->openData(textureData))
                 return nullptr;
-            return &_f->imageImporter.emplace(std::move(importer));
+            return (_f->imageImporter = std::move(importer)).get();
 
         /* Uncompressed image data */
         } else {
@@ -990,13 +1604,13 @@ AbstractImporter* AssimpImporter::setupOrReuseImporterForImage(const UnsignedInt
             return nullptr;
         }
 
-        AnyImageImporter importer{*manager()};
-        if(fileCallback()) importer.setFileCallback(fileCallback(), fileCallbackUserData());
+        Containers::Pointer<AbstractImporter> importer{new AnyImageImporter{*manager()}};
+        if(fileCallback()) importer->setFileCallback(fileCallback(), fileCallbackUserData());
         /* Assimp doesn't trim spaces from the end of image paths in OBJ
            materials so we have to. See the image-filename-space.mtl test. */
-        if(!importer.openFile(Utility::String::trim(Utility::Directory::join(_f->filePath ? *_f->filePath : "", path))))
+        if(!importer->openFile(Utility::String::trim(Utility::Directory::join(_f->filePath ? *_f->filePath : "", path))))
             return nullptr;
-        return &_f->imageImporter.emplace(std::move(importer));
+        return (_f->imageImporter = std::move(importer)).get();
     }
 }
 
@@ -1020,6 +1634,116 @@ Containers::Optional<ImageData2D> AssimpImporter::doImage2D(const UnsignedInt id
     return importer->image2D(0, level);
 }
 
+UnsignedInt AssimpImporter::doAnimationCount() const {
+    return _f->scene->mNumAnimations;
+}
+
+std::string AssimpImporter::doAnimationName(const UnsignedInt id) {
+    return _f->scene->mAnimations[id]->mName.C_Str();
+}
+
+Int AssimpImporter::doAnimationForName(const std::string& name) {
+    auto found = _f->animationIndicesForName.find(name);
+    return found != _f->animationIndicesForName.end() ? found->second : -1;
+}
+
+namespace {
+
+Animation::Extrapolation extrapolationFor(const aiAnimBehaviour behavior) {
+    return behavior == aiAnimBehaviour_LINEAR ?
+        Animation::Extrapolation::Extrapolated :
+        Animation::Extrapolation::Constant;
+}
+
+Vector3 keyValue(const aiVector3D& value) {
+    return {value.x, value.y, value.z};
+}
+
+Quaternion keyValue(const aiQuaternion& value) {
+    return {{value.x, value.y, value.z}, value.w};
+}
+
+/* Copies times and values of given keys to the packed data at given offset,
+   advances the offset past them and returns a track view on them */
+template<class T, class Key> Animation::TrackView<const Float, const T> keysInto(const Key* const keys, const std::size_t count, const Double ticksPerSecond, const aiNodeAnim& channel, const Containers::ArrayView<char> data, std::size_t& offset) {
+    const Containers::ArrayView<Float> times = Containers::arrayCast<Float>(data.slice(offset, offset + count*sizeof(Float)));
+    offset += count*sizeof(Float);
+    const Containers::ArrayView<T> values = Containers::arrayCast<T>(data.slice(offset, offset + count*sizeof(T)));
+    offset += count*sizeof(T);
+
+    for(std::size_t i = 0; i != count; ++i) {
+        times[i] = Float(keys[i].mTime/ticksPerSecond);
+        values[i] = keyValue(keys[i].mValue);
+    }
+
+    return Animation::TrackView<const Float, const T>{times, values,
+        Animation::Interpolation::Linear,
+        animationInterpolatorFor<T>(Animation::Interpolation::Linear),
+        extrapolationFor(channel.mPreState),
+        extrapolationFor(channel.mPostState)};
+}
+
+}
+
+Containers::Optional<AnimationData> AssimpImporter::doAnimation(const UnsignedInt id) {
+    const aiAnimation* animation = _f->scene->mAnimations[id];
+
+    /* Assimp uses 25 ticks per second if the file doesn't specify it */
+    const Double ticksPerSecond = animation->mTicksPerSecond != 0.0 ?
+        animation->mTicksPerSecond : 25.0;
+
+    /* Resolve the targets and calculate the total size of all tracks so all
+       key data can go into a single allocation */
+    Containers::Array<UnsignedInt> targets{Containers::NoInit, animation->mNumChannels};
+    std::size_t dataSize = 0;
+    std::size_t trackCount = 0;
+    for(std::size_t i = 0; i != animation->mNumChannels; ++i) {
+        const aiNodeAnim& channel = *animation->mChannels[i];
+        const Int object = _f->objectForNodeName(channel.mNodeName);
+        if(object == -1) {
+            Error{} << "Trade::AssimpImporter::animation(): target node" << channel.mNodeName.C_Str() << "not found";
+            return Containers::NullOpt;
+        }
+        targets[i] = object;
+
+        dataSize += channel.mNumPositionKeys*(sizeof(Float) + sizeof(Vector3)) +
+            channel.mNumRotationKeys*(sizeof(Float) + sizeof(Quaternion)) +
+            channel.mNumScalingKeys*(sizeof(Float) + sizeof(Vector3));
+        if(channel.mNumPositionKeys) ++trackCount;
+        if(channel.mNumRotationKeys) ++trackCount;
+        if(channel.mNumScalingKeys) ++trackCount;
+    }
+
+    /* Everything is four-byte aligned, so the tracks can follow each other
+       without any padding */
+    Containers::Array<char> data{Containers::NoInit, dataSize};
+    Containers::Array<AnimationTrackData> tracks{trackCount};
+    std::size_t dataOffset = 0;
+    std::size_t trackId = 0;
+    for(std::size_t i = 0; i != animation->mNumChannels; ++i) {
+        const aiNodeAnim& channel = *animation->mChannels[i];
+
+        if(channel.mNumPositionKeys)
+            tracks[trackId++] = AnimationTrackData{AnimationTrackType::Vector3,
+                AnimationTrackTargetType::Translation3D, targets[i],
+                keysInto<Vector3>(channel.mPositionKeys, channel.mNumPositionKeys, ticksPerSecond, channel, data, dataOffset)};
+        if(channel.mNumRotationKeys)
+            tracks[trackId++] = AnimationTrackData{AnimationTrackType::Quaternion,
+                AnimationTrackTargetType::Rotation3D, targets[i],
+                keysInto<Quaternion>(channel.mRotationKeys, channel.mNumRotationKeys, ticksPerSecond, channel, data, dataOffset)};
+        if(channel.mNumScalingKeys)
+            tracks[trackId++] = AnimationTrackData{AnimationTrackType::Vector3,
+                AnimationTrackTargetType::Scaling3D, targets[i],
+                keysInto<Vector3>(channel.mScalingKeys, channel.mNumScalingKeys, ticksPerSecond, channel, data, dataOffset)};
+    }
+
+    /* Check we pre-calculated well */
+    CORRADE_INTERNAL_ASSERT(dataOffset == dataSize);
+    CORRADE_INTERNAL_ASSERT(trackId == trackCount);
+
+    return AnimationData{std::move(data), std::move(tracks), animation};
+}
+
 const void* AssimpImporter::doImporterState() const {
     return _f->scene;
 }
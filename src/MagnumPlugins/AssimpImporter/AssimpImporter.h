@@ -197,12 +197,27 @@ with @ref InputFileCallbackPolicy::LoadTemporary and
 @ref InputFileCallbackPolicy::Close is emitted right after the file is fully
 read.
 
-Import of animation data is not supported at the moment.
+If no file callback is set, files opened by Assimp, including the ones
+referenced from the main file, are memory-mapped on platforms that support
+it instead of being read through `stdio`. This can be disabled with the
+@cb{.ini} mapFiles @ce
+@ref Trade-AssimpImporter-configuration "configuration option".
 
 The importer recognizes @ref ImporterFlag::Verbose, enabling verbose logging
 in Assimp when the flag is enabled. However please note that since Assimp
 handles logging through a global singleton, it's not possible to have different
-verbosity levels in each instance.
+verbosity levels in each instance --- the verbose output stays enabled for all
+instances until the last instance that enabled it is destroyed or has the
+flag cleared.
+
+The `Assimp::Importer` instance, together with its configuration and the
+file callback setup, is created on the first opened file and then reused for
+all subsequently opened files, only the imported scene is freed on
+@ref close(). When converting many small files, it's thus better to open them
+all with the same plugin instance instead of instantiating the plugin for
+each. Different plugin instances share no state except for the logger
+mentioned above, so it's possible to use one instance per thread in a thread
+pool.
 
 @subsection Trade-AssimpImporter-behavior-materials Material import
 
@@ -274,12 +289,126 @@ verbosity levels in each instance.
 The mesh is always indexed; positions are always present, normals, colors and
 texture coordinates are optional.
 
+By default the vertex attributes are copied into a single interleaved buffer.
+If the @cb{.ini} zeroCopy @ce
+@ref Trade-AssimpImporter-configuration "configuration option" is enabled,
+the attributes instead point directly to the arrays stored in the `aiMesh`,
+without any copy. Texture coordinates are then a @ref VertexFormat::Vector2
+view with a 12-byte stride, taking the first two components of
+Assimp's three-component coordinates. Because each attribute is in a separate
+allocation, @ref MeshData::vertexData() spans the whole memory range between
+them and should be accessed only through @ref MeshData::attribute(). The
+returned @ref MeshData::vertexDataFlags() are empty, meaning the data are
+valid only while the file is opened. Index data are still copied, as Assimp
+stores indices of each face in a separate allocation.
+
+Meshes are converted one by one on the calling thread by default. If the
+@cb{.ini} threads @ce
+@ref Trade-AssimpImporter-configuration "configuration option" is set to a
+value larger than @cpp 1 @ce, importing a mesh converts also a batch of the
+meshes directly following it in parallel. These are then returned from
+subsequent @ref mesh() calls without converting them again, so importing all
+meshes in order keeps all threads busy. Meshes that would print a warning or
+an error during conversion are not converted ahead of time, but only once
+requested directly. In that case the application needs to link to `pthread`
+on Linux due to the same reasons as described in
+@ref Trade-BasisImageConverter-loading "BasisImageConverter docs".
+
+@subsection Trade-AssimpImporter-behavior-instances Mesh instancing
+
+Each @ref MeshObjectData3D references the mesh through the index Assimp
+stores in the `aiNode`. If the file itself references the same mesh from
+multiple nodes, or if the `FindInstances` postprocess step is enabled in the
+@ref Trade-AssimpImporter-configuration "configuration", which replaces
+duplicate meshes with references to the first of them, @ref meshCount()
+reports only the unique meshes and all duplicates become objects pointing
+to the same mesh ID. Each mesh thus needs to be imported and uploaded just
+once, no matter how many times it appears in the scene.
+
+To render such meshes instanced without walking the whole hierarchy, the
+plugin-specific @ref meshInstances() function returns IDs of all objects
+referencing given mesh and @ref meshInstanceTransformations() their absolute
+transformations, calculated once for the whole scene on the first call:
+
+@code{.cpp}
+auto& assimpImporter = static_cast<Trade::AssimpImporter&>(*importer);
+for(UnsignedInt i = 0; i != assimpImporter.meshCount(); ++i) {
+    if(!assimpImporter.meshInstanceCount(i)) continue;
+    Containers::Optional<Trade::MeshData> mesh = assimpImporter.mesh(i);
+    Containers::Array<Matrix4> transformations =
+        assimpImporter.meshInstanceTransformations(i);
+    // ...
+}
+@endcode
+
+Note that the `OptimizeGraph` step collapses the hierarchy and bakes node
+transformations into the meshes, which can produce a separate copy of each
+mesh that was referenced from more than one node. Enable it only if the scene doesn't
+contain instanced geometry.
+
+@subsection Trade-AssimpImporter-behavior-animation Animation and skinning import
+
+-   Each `aiAnimation` is imported as a single @ref AnimationData, with
+    position, rotation and scaling keys of each `aiNodeAnim` channel being
+    separate @ref AnimationTrackTargetType::Translation3D,
+    @ref AnimationTrackTargetType::Rotation3D and
+    @ref AnimationTrackTargetType::Scaling3D tracks. Channels with no keys of
+    given kind produce no track.
+-   Key times and values of all tracks are packed together in a single
+    allocation, each track having its times followed by its values, so even
+    animations with many thousand keys need just one allocation regardless
+    of the channel count.
+-   Key times are converted from ticks to seconds using
+    `aiAnimation::mTicksPerSecond`. If it's zero, 25 ticks per second is
+    assumed, matching what Assimp itself does.
+-   All tracks use @ref Animation::Interpolation::Linear.
+    `aiAnimBehaviour_LINEAR` pre- and post-states are imported as
+    @ref Animation::Extrapolation::Extrapolated, everything else as
+    @ref Animation::Extrapolation::Constant.
+-   The tracks target the first object of given node. Animating the root node
+    is not supported, as it's not exposed as an object. Animations of
+    top-level nodes replace their transformation including the root node
+    transformation described in @ref Trade-AssimpImporter-behavior-scene.
+
+Meshes that have bones get two extra custom attributes, `JOINTS_0` and
+`WEIGHTS_0`, consistently with @link TinyGltfImporter @endlink. Their IDs can
+be queried using @ref meshAttributeForName(). Joint IDs are imported as
+@ref VertexFormat::Vector4us indexing the bones of given mesh, weights as
+@ref VertexFormat::Vector4. If a vertex is influenced by more than four
+bones, the four largest weights are kept and the rest is dropped without
+renormalizing. Enable the `LimitBoneWeights` postprocess step in the
+@ref Trade-AssimpImporter-configuration "configuration" to have Assimp
+renormalize them instead. These attributes are always copied, even with
+@cb{.ini} zeroCopy @ce enabled.
+
+Each mesh with bones additionally defines a skin, exposed through
+@ref skin3DCount() and referenced from objects through @ref object3DSkin().
+The @ref skin3DJoints() function returns object IDs of the bone nodes, in the
+same order as the joint IDs in the mesh attributes, and
+@ref skin3DInverseBindMatrices() returns the bone offset matrices tightly
+packed in a single array. These are plugin-specific APIs, so the importer
+instance needs to be cast to @ref AssimpImporter first:
+
+@code{.cpp}
+auto& assimpImporter = static_cast<Trade::AssimpImporter&>(*importer);
+Int skin = assimpImporter.object3DSkin(id);
+if(skin != -1) {
+    Containers::Optional<Containers::Array<UnsignedInt>> joints =
+        assimpImporter.skin3DJoints(skin);
+    Containers::Optional<Containers::Array<Matrix4>> inverseBindMatrices =
+        assimpImporter.skin3DInverseBindMatrices(skin);
+    // ...
+}
+@endcode
+
 @subsection Trade-AssimpImporter-behavior-textures Texture import
 
 -   Textures with mapping mode/wrapping `aiTextureMapMode_Decal` are loaded
     with @ref SamplerWrapping::ClampToEdge
 -   Assimp does not appear to load any filtering information
--   Raw embedded image data is not supported
+-   Raw embedded image data is not supported. Compressed embedded images
+    are opened directly with the plugin matching their file signature, if
+    known, instead of going through @ref AnyImageImporter.
 
 @subsection Trade-AssimpImporter-behavior-scene Scene import
 
@@ -293,6 +422,30 @@ texture coordinates are optional.
     In that case the single node is imported as a single @ref object3D()
     instead of being ignored.
 
+@section Trade-AssimpImporter-profiling Profiling
+
+If the plugin is built with `WITH_IMPORTER_PROFILING` enabled, it measures
+the duration of individual import stages and reports them to a callback set
+with @ref setProfilingCallback(), together with the amount of data each stage
+processed. The stages are:
+
+-   `read` --- reading and parsing the file in Assimp, including the
+    postprocess steps applied on open, with the input size if the file comes
+    from @ref openData()
+-   `scene` --- indexing materials, textures, meshes and nodes of the parsed
+    scene for name lookup
+-   `postprocess` --- the postprocess steps deferred to the first
+    @ref mesh() call with the @cb{.ini} lazyPostprocess @ce option enabled
+-   `mesh` --- converting a mesh to @ref MeshData in @ref mesh(), with the
+    size of the output vertex and index data. With the @cb{.ini} threads @ce
+    option set to a value other than @cpp 1 @ce this includes the conversion
+    of meshes prefetched along with it.
+
+Without `WITH_IMPORTER_PROFILING` the measurement is compiled out and the
+callback is never called. If it's enabled, the
+@cpp MAGNUM_ASSIMPIMPORTER_WITH_PROFILING @ce macro is defined in the
+`MagnumPlugins/AssimpImporter/configure.h` header.
+
 @section Trade-AssimpImporter-configuration Plugin-specific configuration
 
 Assimp has a versatile set of configuration options and processing operations
@@ -308,6 +461,26 @@ enum. Some of them are enabled by default, some not; options for not yet
 supported features are omitted. These are passed to Assimp when opening a file,
 meaning a change in these will be always applied to the next opened file.
 
+If the @cb{.ini} profilePostprocessSteps @ce option is enabled, the file is
+opened without any postprocessing first and the enabled steps are then
+applied one by one, in the same order Assimp would apply them. With
+@ref ImporterFlag::Verbose set, the time each step took and how much it
+changed the scene memory is printed through @ref Debug. This can be used to
+find out which steps are expensive for particular files.
+
+With the @cb{.ini} lazyPostprocess @ce option enabled, only steps that affect
+the scene structure, such as `SortByPType` or `PreTransformVertices`, are
+applied when opening the file. Steps that only modify contents of particular
+meshes --- `JoinIdenticalVertices`, `Triangulate`, `GenNormals`,
+`GenSmoothNormals`, `ImproveCacheLocality`, `FixInfacingNormals`,
+`FlipWindingOrder` and `LimitBoneWeights` --- are deferred to the first
+@ref mesh() call, so inspecting the hierarchy, materials, cameras or lights
+of a large scene doesn't pay for them. Assimp can apply the steps only to the whole scene, so
+they're still applied to all meshes at once. Because `Triangulate` is then
+executed after `SortByPType`, meshes mixing triangles and polygons get split
+into two triangle meshes. If a deferred step fails, Assimp deletes the scene
+and the file is closed.
+
 @snippet MagnumPlugins/AssimpImporter/AssimpImporter.conf configuration_
 
 @section Trade-AssimpImporter-state Access to internal importer state
@@ -324,6 +497,7 @@ importer state methods:
         in which the first texture of given type in given material is referred to.
     -   @ref MeshData::importerState() returns `aiMesh`
     -   @ref ObjectData3D::importerState() returns `aiNode`
+    -   @ref AnimationData::importerState() returns `aiAnimation`
     -   @ref LightData::importerState() returns `aiLight`
     -   @ref ImageData2D::importerState() may return `aiTexture`, if texture was embedded
         into the loaded file.
@@ -355,6 +529,97 @@ class MAGNUM_ASSIMPIMPORTER_EXPORT AssimpImporter: public AbstractImporter {
 
         ~AssimpImporter();
 
+        /**
+         * @brief Skin count
+         * @m_since_latest_{plugins}
+         *
+         * Count of meshes that have bones. Expects that a file is opened.
+         * See @ref Trade-AssimpImporter-behavior-animation for more
+         * information.
+         */
+        virtual UnsignedInt skin3DCount();
+
+        /**
+         * @brief Skin of given object
+         * @m_since_latest_{plugins}
+         *
+         * Returns ID of the skin of the mesh the object references or
+         * @cpp -1 @ce if the object doesn't reference a mesh with bones.
+         * Expects that a file is opened and @p id is less than
+         * @ref object3DCount().
+         */
+        virtual Int object3DSkin(UnsignedInt id);
+
+        /**
+         * @brief Joints of given skin
+         * @m_since_latest_{plugins}
+         *
+         * Returns object IDs of the bone nodes. Expects that a file is opened
+         * and @p id is less than @ref skin3DCount(). On failure prints a
+         * message to @ref Error and returns @ref Containers::NullOpt. See
+         * @ref Trade-AssimpImporter-behavior-animation for more information.
+         */
+        virtual Containers::Optional<Containers::Array<UnsignedInt>> skin3DJoints(UnsignedInt id);
+
+        /**
+         * @brief Inverse bind matrices of given skin
+         * @m_since_latest_{plugins}
+         *
+         * Returns the offset matrix of each bone in @ref skin3DJoints(),
+         * tightly packed. Expects that a file is opened and @p id is less
+         * than @ref skin3DCount(). See
+         * @ref Trade-AssimpImporter-behavior-animation for more information.
+         */
+        virtual Containers::Array<Matrix4> skin3DInverseBindMatrices(UnsignedInt id);
+
+        /**
+         * @brief Count of objects referencing given mesh
+         * @m_since_latest_{plugins}
+         *
+         * Expects that a file is opened and @p id is less than
+         * @ref meshCount(). See @ref Trade-AssimpImporter-behavior-instances
+         * for more information.
+         */
+        virtual UnsignedInt meshInstanceCount(UnsignedInt id);
+
+        /**
+         * @brief IDs of objects referencing given mesh
+         * @m_since_latest_{plugins}
+         *
+         * Returns IDs of all objects that are a @ref MeshObjectData3D with
+         * @ref MeshObjectData3D::instance() equal to @p id, in increasing
+         * order. Size of the returned array is @ref meshInstanceCount().
+         * Expects that a file is opened and @p id is less than
+         * @ref meshCount().
+         */
+        virtual Containers::Array<UnsignedInt> meshInstances(UnsignedInt id);
+
+        /**
+         * @brief Absolute transformations of objects referencing given mesh
+         * @m_since_latest_{plugins}
+         *
+         * Returns the object transformation combined with transformations of
+         * all its parents for each object in @ref meshInstances(), tightly
+         * packed and ready to be uploaded to an instance buffer. Expects that
+         * a file is opened and @p id is less than @ref meshCount().
+         */
+        virtual Containers::Array<Matrix4> meshInstanceTransformations(UnsignedInt id);
+
+        /**
+         * @brief Set profiling callback
+         * @m_since_latest_{plugins}
+         *
+         * The @p callback is called at the end of each import stage with the
+         * stage name, its duration in nanoseconds, count of bytes it
+         * processed or @cpp 0 @ce if not applicable, and @p userData. The
+         * callback is kept across opened files, pass @cpp nullptr @ce to
+         * reset it. Doesn't need any file to be opened. If the plugin isn't
+         * built with `WITH_IMPORTER_PROFILING`, the callback is never
+         * called. See @ref Trade-AssimpImporter-profiling for more
+         * information.
+         */
+        virtual void setProfilingCallback(void(*callback)(const char* stage, UnsignedLong nanoseconds, std::size_t byteCount, void* userData), void* userData = nullptr);
+
     private:
         struct File;
 
@@ -387,6 +652,9 @@ class MAGNUM_ASSIMPIMPORTER_EXPORT AssimpImporter: public AbstractImporter {
 
         MAGNUM_ASSIMPIMPORTER_LOCAL UnsignedInt doMeshCount() const override;
         MAGNUM_ASSIMPIMPORTER_LOCAL Containers::Optional<MeshData> doMesh(UnsignedInt id, UnsignedInt level) override;
+        MAGNUM_ASSIMPIMPORTER_LOCAL Containers::Optional<MeshData> meshInternal(UnsignedInt id);
+        MAGNUM_ASSIMPIMPORTER_LOCAL MeshAttribute doMeshAttributeForName(const std::string& name) override;
+        MAGNUM_ASSIMPIMPORTER_LOCAL std::string doMeshAttributeName(UnsignedShort name) override;
 
         MAGNUM_ASSIMPIMPORTER_LOCAL UnsignedInt doMaterialCount() const override;
         MAGNUM_ASSIMPIMPORTER_LOCAL Int doMaterialForName(const std::string& name) override;
@@ -402,11 +670,19 @@ class MAGNUM_ASSIMPIMPORTER_EXPORT AssimpImporter: public AbstractImporter {
         MAGNUM_ASSIMPIMPORTER_LOCAL UnsignedInt doImage2DLevelCount(UnsignedInt id) override;
         MAGNUM_ASSIMPIMPORTER_LOCAL Containers::Optional<ImageData2D> doImage2D(UnsignedInt id, UnsignedInt level) override;
 
+        MAGNUM_ASSIMPIMPORTER_LOCAL UnsignedInt doAnimationCount() const override;
+        MAGNUM_ASSIMPIMPORTER_LOCAL std::string doAnimationName(UnsignedInt id) override;
+        MAGNUM_ASSIMPIMPORTER_LOCAL Int doAnimationForName(const std::string& name) override;
+        MAGNUM_ASSIMPIMPORTER_LOCAL Containers::Optional<AnimationData> doAnimation(UnsignedInt id) override;
+
         MAGNUM_ASSIMPIMPORTER_LOCAL const void* doImporterState() const override;
 
         Containers::Pointer<Assimp::Importer> _importer;
-        Assimp::IOSystem* _ourFileCallback;
+        Assimp::IOSystem* _ourFileCallback{};
         Containers::Pointer<File> _f;
+        bool _verboseLogger = false;
+        void(*_profilingCallback)(const char*, UnsignedLong, std::size_t, void*){};
+        void* _profilingUserData{};
 };
 
 }}
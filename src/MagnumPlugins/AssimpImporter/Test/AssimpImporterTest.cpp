@@ -41,9 +41,12 @@
 #include <Magnum/FileCallback.h>
 #include <Magnum/Mesh.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Quaternion.h>
 #include <Magnum/Math/Vector3.h>
 #include <Magnum/MeshTools/Transform.h>
 #include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/AnimationData.h>
 #include <Magnum/Trade/ImageData.h>
 #include <Magnum/Trade/MeshData.h>
 #include <Magnum/Trade/MeshObjectData3D.h>
@@ -60,6 +63,8 @@
 #include <assimp/scene.h>
 #include <assimp/version.h>
 
+#include "MagnumPlugins/AssimpImporter/AssimpImporter.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Trade { namespace Test { namespace {
@@ -70,6 +75,8 @@ struct AssimpImporterTest: TestSuite::Tester {
     explicit AssimpImporterTest();
 
     void openFile();
+    void openFileVerboseMultipleInstances();
+    void openFileMapFiles();
     void openFileFailed();
     void openData();
     void openDataFailed();
@@ -87,9 +94,16 @@ struct AssimpImporterTest: TestSuite::Tester {
     void materialTextureCoordinateSets();
 
     void mesh();
+    void meshZeroCopy();
     void pointMesh();
     void lineMesh();
     void meshMultiplePrimitives();
+    void meshThreads();
+    void meshSkin();
+    void meshInstances();
+    void meshInstancesFindInstances();
+
+    void animation();
 
     void emptyCollada();
     void emptyGltf();
@@ -111,6 +125,8 @@ struct AssimpImporterTest: TestSuite::Tester {
     void openStateTexture();
 
     void configurePostprocessFlipUVs();
+    void configurePostprocessProfile();
+    void configurePostprocessLazy();
 
     void fileCallback();
     void fileCallbackNotFound();
@@ -131,6 +147,14 @@ constexpr struct {
     {"verbose", ImporterFlag::Verbose}
 };
 
+constexpr struct {
+    const char* name;
+    bool mapFiles;
+} MapFilesData[]{
+    {"", false},
+    {"memory-mapped", true}
+};
+
 constexpr struct {
     LightData::Type type;
     Color3 color;
@@ -156,7 +180,11 @@ AssimpImporterTest::AssimpImporterTest() {
     addInstancedTests({&AssimpImporterTest::openFile},
         Containers::arraySize(VerboseData));
 
-    addTests({&AssimpImporterTest::openFileFailed,
+    addInstancedTests({&AssimpImporterTest::openFileMapFiles},
+        Containers::arraySize(MapFilesData));
+
+    addTests({&AssimpImporterTest::openFileVerboseMultipleInstances,
+              &AssimpImporterTest::openFileFailed,
               &AssimpImporterTest::openData,
               &AssimpImporterTest::openDataFailed,
 
@@ -176,9 +204,16 @@ AssimpImporterTest::AssimpImporterTest() {
               &AssimpImporterTest::materialTextureCoordinateSets,
 
               &AssimpImporterTest::mesh,
+              &AssimpImporterTest::meshZeroCopy,
               &AssimpImporterTest::pointMesh,
               &AssimpImporterTest::lineMesh,
               &AssimpImporterTest::meshMultiplePrimitives,
+              &AssimpImporterTest::meshThreads,
+              &AssimpImporterTest::meshSkin,
+              &AssimpImporterTest::meshInstances,
+              &AssimpImporterTest::meshInstancesFindInstances,
+
+              &AssimpImporterTest::animation,
 
               &AssimpImporterTest::emptyCollada,
               &AssimpImporterTest::emptyGltf,
@@ -202,6 +237,8 @@ AssimpImporterTest::AssimpImporterTest() {
               &AssimpImporterTest::openStateTexture,
 
               &AssimpImporterTest::configurePostprocessFlipUVs,
+              &AssimpImporterTest::configurePostprocessProfile,
+              &AssimpImporterTest::configurePostprocessLazy,
 
               &AssimpImporterTest::fileCallback,
               &AssimpImporterTest::fileCallbackNotFound,
@@ -259,6 +296,59 @@ void AssimpImporterTest::openFile() {
     CORRADE_COMPARE(!out.str().empty(), data.flags >= ImporterFlag::Verbose);
 }
 
+void AssimpImporterTest::openFileVerboseMultipleInstances() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
+    importer->setFlags(ImporterFlag::Verbose);
+
+    /* Another instance that enables and disables verbose output, or gets
+       destroyed with it enabled, shouldn't affect the global logger used by
+       the first */
+    {
+        Containers::Pointer<AbstractImporter> another = _manager.instantiate("AssimpImporter");
+        another->setFlags(ImporterFlag::Verbose);
+        another->setFlags({});
+    } {
+        Containers::Pointer<AbstractImporter> another = _manager.instantiate("AssimpImporter");
+        another->setFlags(ImporterFlag::Verbose);
+    }
+
+    std::ostringstream out;
+    {
+        Debug redirectOutput{&out};
+        CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ASSIMPIMPORTER_TEST_DIR, "scene.dae")));
+    }
+    CORRADE_VERIFY(!out.str().empty());
+
+    /* Once the last verbose instance disables it, it's quiet again */
+    importer->setFlags({});
+    out.str({});
+    {
+        Debug redirectOutput{&out};
+        CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ASSIMPIMPORTER_TEST_DIR, "scene.dae")));
+    }
+    CORRADE_COMPARE(out.str(), "");
+}
+
+void AssimpImporterTest::openFileMapFiles() {
+    auto&& data = MapFilesData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
+    importer->configuration().setValue("mapFiles", data.mapFiles);
+
+    /* The OBJ file references a MTL file, which is opened through the same
+       IO system */
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ASSIMPIMPORTER_TEST_DIR, "material-color-texture.obj")));
+    CORRADE_COMPARE(importer->materialCount(), 2);
+    CORRADE_COMPARE(importer->textureCount(), 3);
+
+    /* Switching the option for the next file should work as well */
+    importer->configuration().setValue("mapFiles", !data.mapFiles);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ASSIMPIMPORTER_TEST_DIR, "material-color-texture.obj")));
+    CORRADE_COMPARE(importer->materialCount(), 2);
+    CORRADE_COMPARE(importer->textureCount(), 3);
+}
+
 void AssimpImporterTest::openFileFailed() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
 
@@ -711,6 +801,42 @@ void AssimpImporterTest::mesh() {
     CORRADE_COMPARE(meshObject->instance(), 0);
 }
 
+void AssimpImporterTest::meshZeroCopy() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
+    importer->configuration().setValue("zeroCopy", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ASSIMPIMPORTER_TEST_DIR, "mesh.dae")));
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexDataFlags(), DataFlags{});
+    CORRADE_COMPARE(mesh->indexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+    CORRADE_COMPARE_AS(mesh->indices<UnsignedInt>(),
+        Containers::arrayView<UnsignedInt>({0, 1, 2}),
+        TestSuite::Compare::Container);
+
+    /* The attributes point directly to the Assimp arrays */
+    auto aiMeshState = static_cast<const aiMesh*>(mesh->importerState());
+    CORRADE_VERIFY(aiMeshState);
+    CORRADE_COMPARE(mesh->attributeCount(), 6);
+    CORRADE_COMPARE(mesh->attribute(MeshAttribute::Position).data(), static_cast<const void*>(aiMeshState->mVertices));
+    CORRADE_COMPARE(mesh->attribute(MeshAttribute::Normal).data(), static_cast<const void*>(aiMeshState->mNormals));
+    CORRADE_COMPARE(mesh->attribute(MeshAttribute::Tangent).data(), static_cast<const void*>(aiMeshState->mTangents));
+    CORRADE_COMPARE(mesh->attribute(MeshAttribute::Bitangent).data(), static_cast<const void*>(aiMeshState->mBitangents));
+    CORRADE_COMPARE(mesh->attribute(MeshAttribute::TextureCoordinates).data(), static_cast<const void*>(aiMeshState->mTextureCoords[0]));
+    CORRADE_COMPARE(mesh->attributeStride(MeshAttribute::TextureCoordinates), sizeof(aiVector3D));
+    CORRADE_COMPARE(mesh->attribute(MeshAttribute::Color).data(), static_cast<const void*>(aiMeshState->mColors[0]));
+
+    /* The data are the same as when copying */
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {-1.0f, 1.0f, 1.0f}, {-1.0f, -1.0f, 1.0f}, {1.0f, -1.0f, 1.0f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector2>(MeshAttribute::TextureCoordinates),
+        Containers::arrayView<Vector2>({
+            {0.5f, 1.0f}, {0.75f, 0.5f}, {0.5f, 0.9f}
+        }), TestSuite::Compare::Container);
+}
+
 void AssimpImporterTest::pointMesh() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ASSIMPIMPORTER_TEST_DIR, "points.obj")));
@@ -890,6 +1016,228 @@ void AssimpImporterTest::meshMultiplePrimitives() {
     }
 }
 
+void AssimpImporterTest::meshThreads() {
+    /* Possibly broken in other versions too (4.1 and 5 works, 3.2 doesn't) */
+    if(aiGetVersionMajor()*100 + aiGetVersionMinor() <= 302)
+        CORRADE_SKIP("Assimp 3.2 doesn't recognize primitives used in the test COLLADA file.");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
+    Containers::Pointer<AbstractImporter> threadedImporter = _manager.instantiate("AssimpImporter");
+    threadedImporter->configuration().setValue("threads", 3);
+
+    const std::string filename = Utility::Directory::join(ASSIMPIMPORTER_TEST_DIR, "mesh-multiple-primitives.dae");
+    CORRADE_VERIFY(importer->openFile(filename));
+    CORRADE_VERIFY(threadedImporter->openFile(filename));
+    CORRADE_COMPARE(threadedImporter->meshCount(), 5);
+
+    /* The first call converts all meshes, the rest gets picked up from the
+       prefetched ones. Importing out of order should work too. */
+    for(UnsignedInt id: {1, 0, 2, 3, 4, 3}) {
+        CORRADE_ITERATION(id);
+        Containers::Optional<MeshData> expected = importer->mesh(id);
+        Containers::Optional<MeshData> mesh = threadedImporter->mesh(id);
+        CORRADE_VERIFY(expected);
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->primitive(), expected->primitive());
+        CORRADE_COMPARE_AS(mesh->indices<UnsignedInt>(),
+            expected->indices<UnsignedInt>(),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+            expected->attribute<Vector3>(MeshAttribute::Position),
+            TestSuite::Compare::Container);
+    }
+}
+
+void AssimpImporterTest::meshSkin() {
+    if(!ASSIMP_IS_VERSION_5)
+        CORRADE_SKIP("glTF 2 skins are supported only since Assimp 5.");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ASSIMPIMPORTER_TEST_DIR, "skin-animation.gltf")));
+    auto& assimpImporter = static_cast<AssimpImporter&>(*importer);
+
+    const MeshAttribute jointIds = importer->meshAttributeForName("JOINTS_0");
+    const MeshAttribute weights = importer->meshAttributeForName("WEIGHTS_0");
+    CORRADE_VERIFY(isMeshAttributeCustom(jointIds));
+    CORRADE_VERIFY(isMeshAttributeCustom(weights));
+    CORRADE_COMPARE(importer->meshAttributeName(jointIds), "JOINTS_0");
+    CORRADE_COMPARE(importer->meshAttributeName(weights), "WEIGHTS_0");
+
+    CORRADE_COMPARE(importer->meshCount(), 1);
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_VERIFY(mesh->hasAttribute(jointIds));
+    CORRADE_VERIFY(mesh->hasAttribute(weights));
+    CORRADE_COMPARE(mesh->attributeFormat(jointIds), VertexFormat::Vector4us);
+    CORRADE_COMPARE(mesh->attributeFormat(weights), VertexFormat::Vector4);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector4us>(jointIds),
+        Containers::arrayView<Vector4us>({
+            {0, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 0, 0}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector4>(weights),
+        Containers::arrayView<Vector4>({
+            {1.0f, 0.0f, 0.0f, 0.0f},
+            {0.25f, 0.75f, 0.0f, 0.0f},
+            {1.0f, 0.0f, 0.0f, 0.0f}
+        }), TestSuite::Compare::Container);
+
+    const Int meshObject = importer->object3DForName("Mesh");
+    const Int joint = importer->object3DForName("Joint");
+    const Int childJoint = importer->object3DForName("Child joint");
+    CORRADE_VERIFY(meshObject != -1);
+    CORRADE_VERIFY(joint != -1);
+    CORRADE_VERIFY(childJoint != -1);
+
+    CORRADE_COMPARE(assimpImporter.skin3DCount(), 1);
+    CORRADE_COMPARE(assimpImporter.object3DSkin(meshObject), 0);
+    CORRADE_COMPARE(assimpImporter.object3DSkin(joint), -1);
+
+    Containers::Optional<Containers::Array<UnsignedInt>> joints = assimpImporter.skin3DJoints(0);
+    CORRADE_VERIFY(joints);
+    CORRADE_COMPARE_AS(*joints,
+        Containers::arrayView<UnsignedInt>({UnsignedInt(joint), UnsignedInt(childJoint)}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(assimpImporter.skin3DInverseBindMatrices(0),
+        Containers::arrayView<Matrix4>({
+            Matrix4{},
+            Matrix4::translation({-1.0f, 0.0f, 0.0f})
+        }), TestSuite::Compare::Container);
+}
+
+void AssimpImporterTest::meshInstances() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ASSIMPIMPORTER_TEST_DIR, "mesh-instances.dae")));
+    auto& assimpImporter = static_cast<AssimpImporter&>(*importer);
+
+    /* The Triangle geometry is referenced twice and Assimp shares it on its
+       own, TriangleCopy has the same contents but is a separate mesh */
+    CORRADE_COMPARE(importer->meshCount(), 2);
+    CORRADE_COMPARE(importer->object3DCount(), 3);
+    const Int first = importer->object3DForName("First");
+    const Int second = importer->object3DForName("Second");
+    const Int child = importer->object3DForName("Child");
+    CORRADE_VERIFY(first != -1);
+    CORRADE_VERIFY(second != -1);
+    CORRADE_VERIFY(child != -1);
+
+    CORRADE_COMPARE(assimpImporter.meshInstanceCount(0), 2);
+    CORRADE_COMPARE_AS(assimpImporter.meshInstances(0),
+        Containers::arrayView<UnsignedInt>({UnsignedInt(first), UnsignedInt(child)}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(assimpImporter.meshInstanceTransformations(0),
+        Containers::arrayView<Matrix4>({
+            Matrix4::translation({1.0f, 2.0f, 3.0f}),
+            Matrix4::translation({4.0f, 5.0f, 7.0f})
+        }), TestSuite::Compare::Container);
+
+    CORRADE_COMPARE(assimpImporter.meshInstanceCount(1), 1);
+    CORRADE_COMPARE_AS(assimpImporter.meshInstances(1),
+        Containers::arrayView<UnsignedInt>({UnsignedInt(second)}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(assimpImporter.meshInstanceTransformations(1),
+        Containers::arrayView<Matrix4>({
+            Matrix4::translation({4.0f, 5.0f, 6.0f})
+        }), TestSuite::Compare::Container);
+}
+
+void AssimpImporterTest::meshInstancesFindInstances() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
+    importer->configuration().group("postprocess")->setValue("FindInstances", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ASSIMPIMPORTER_TEST_DIR, "mesh-instances.dae")));
+    auto& assimpImporter = static_cast<AssimpImporter&>(*importer);
+
+    /* The duplicate got replaced with a reference to the first mesh, all
+       objects now reference the same mesh */
+    CORRADE_COMPARE(importer->meshCount(), 1);
+    CORRADE_COMPARE(importer->object3DCount(), 3);
+    const Int first = importer->object3DForName("First");
+    const Int second = importer->object3DForName("Second");
+    const Int child = importer->object3DForName("Child");
+    for(const Int object: {first, second, child}) {
+        CORRADE_ITERATION(object);
+        Containers::Pointer<ObjectData3D> data = importer->object3D(object);
+        CORRADE_VERIFY(data);
+        CORRADE_COMPARE(data->instanceType(), ObjectInstanceType3D::Mesh);
+        CORRADE_COMPARE(data->instance(), 0);
+    }
+
+    CORRADE_COMPARE(assimpImporter.meshInstanceCount(0), 3);
+    CORRADE_COMPARE_AS(assimpImporter.meshInstances(0),
+        Containers::arrayView<UnsignedInt>({UnsignedInt(first), UnsignedInt(second), UnsignedInt(child)}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(assimpImporter.meshInstanceTransformations(0),
+        Containers::arrayView<Matrix4>({
+            Matrix4::translation({1.0f, 2.0f, 3.0f}),
+            Matrix4::translation({4.0f, 5.0f, 6.0f}),
+            Matrix4::translation({4.0f, 5.0f, 7.0f})
+        }), TestSuite::Compare::Container);
+}
+
+void AssimpImporterTest::animation() {
+    if(!ASSIMP_IS_VERSION_5)
+        CORRADE_SKIP("glTF 2 animations are not reliably supported before Assimp 5.");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ASSIMPIMPORTER_TEST_DIR, "skin-animation.gltf")));
+
+    CORRADE_COMPARE(importer->animationCount(), 1);
+    CORRADE_COMPARE(importer->animationName(0), "Bounce");
+    CORRADE_COMPARE(importer->animationForName("Bounce"), 0);
+    CORRADE_COMPARE(importer->animationForName("Nonexistent"), -1);
+
+    const Int joint = importer->object3DForName("Joint");
+    const Int childJoint = importer->object3DForName("Child joint");
+
+    Containers::Optional<AnimationData> animation = importer->animation(0);
+    CORRADE_VERIFY(animation);
+    CORRADE_VERIFY(animation->importerState());
+
+    /* Depending on the version, Assimp may add constant tracks for the
+       remaining properties, so look for the ones we're interested in */
+    Int translation = -1, rotation = -1;
+    for(UnsignedInt i = 0; i != animation->trackCount(); ++i) {
+        CORRADE_ITERATION(i);
+
+        /* All tracks are packed in the single allocation */
+        const Animation::TrackViewStorage<const Float>& track = animation->track(i);
+        const char* keys = static_cast<const char*>(track.keys().data());
+        CORRADE_VERIFY(keys >= animation->data().begin());
+        CORRADE_VERIFY(keys + track.size()*sizeof(Float) <= animation->data().end());
+
+        if(animation->trackTargetType(i) == AnimationTrackTargetType::Translation3D &&
+           animation->trackTarget(i) == UnsignedInt(joint))
+            translation = i;
+        else if(animation->trackTargetType(i) == AnimationTrackTargetType::Rotation3D &&
+           animation->trackTarget(i) == UnsignedInt(childJoint))
+            rotation = i;
+    }
+
+    CORRADE_VERIFY(translation != -1);
+    CORRADE_COMPARE(animation->trackType(translation), AnimationTrackType::Vector3);
+    Animation::TrackView<const Float, const Vector3> translations = animation->track<Vector3>(translation);
+    CORRADE_COMPARE(translations.interpolation(), Animation::Interpolation::Linear);
+    CORRADE_COMPARE_AS(translations.keys(),
+        Containers::stridedArrayView<Float>({0.0f, 1.0f, 2.0f}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(translations.values(),
+        Containers::stridedArrayView<Vector3>({
+            {0.0f, 0.0f, 0.0f}, {1.0f, 2.0f, 3.0f}, {0.0f, 0.0f, 0.0f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(translations.at(0.5f), (Vector3{0.5f, 1.0f, 1.5f}));
+
+    CORRADE_VERIFY(rotation != -1);
+    CORRADE_COMPARE(animation->trackType(rotation), AnimationTrackType::Quaternion);
+    Animation::TrackView<const Float, const Quaternion> rotations = animation->track<Quaternion>(rotation);
+    CORRADE_COMPARE_AS(rotations.keys(),
+        Containers::stridedArrayView<Float>({0.5f, 1.5f}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(rotations.values(),
+        Containers::stridedArrayView<Quaternion>({
+            {},
+            Quaternion::rotation(90.0_degf, Vector3::zAxis())
+        }), TestSuite::Compare::Container);
+}
+
 void AssimpImporterTest::emptyCollada() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
 
@@ -1378,6 +1726,90 @@ void AssimpImporterTest::configurePostprocessFlipUVs() {
         }), TestSuite::Compare::Container);
 }
 
+void AssimpImporterTest::configurePostprocessProfile() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
+    importer->configuration().setValue("profilePostprocessSteps", true);
+    importer->configuration().group("postprocess")->setValue("FlipUVs", true);
+    importer->setFlags(ImporterFlag::Verbose);
+
+    std::ostringstream out;
+    {
+        Debug redirectOutput{&out};
+        CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ASSIMPIMPORTER_TEST_DIR, "mesh.dae")));
+    }
+
+    /* Timing for each enabled step is printed, disabled steps are not run */
+    CORRADE_VERIFY(out.str().find("Trade::AssimpImporter::openFile(): postprocess step JoinIdenticalVertices took") != std::string::npos);
+    CORRADE_VERIFY(out.str().find("Trade::AssimpImporter::openFile(): postprocess step Triangulate took") != std::string::npos);
+    CORRADE_VERIFY(out.str().find("Trade::AssimpImporter::openFile(): postprocess step FlipUVs took") != std::string::npos);
+    CORRADE_VERIFY(out.str().find("postprocess step GenNormals") == std::string::npos);
+
+    /* The result is the same as when applying all steps at once */
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE_AS(mesh->indices<UnsignedInt>(),
+        Containers::arrayView<UnsignedInt>({0, 1, 2}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector2>(MeshAttribute::TextureCoordinates),
+        Containers::arrayView<Vector2>({
+            {0.5f, 0.0f}, {0.75f, 0.5f}, {0.5f, 0.1f}
+        }), TestSuite::Compare::Container);
+}
+
+void AssimpImporterTest::configurePostprocessLazy() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("AssimpImporter");
+    importer->configuration().setValue("lazyPostprocess", true);
+    importer->configuration().setValue("profilePostprocessSteps", true);
+    importer->configuration().group("postprocess")->setValue("FlipUVs", true);
+    importer->setFlags(ImporterFlag::Verbose);
+
+    std::ostringstream out;
+    {
+        Debug redirectOutput{&out};
+        CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ASSIMPIMPORTER_TEST_DIR, "mesh.dae")));
+    }
+
+    /* Only the steps affecting the scene structure are applied on open */
+    CORRADE_VERIFY(out.str().find("Trade::AssimpImporter::openFile(): postprocess step FlipUVs took") != std::string::npos);
+    CORRADE_VERIFY(out.str().find("Trade::AssimpImporter::openFile(): postprocess step SortByPType took") != std::string::npos);
+    CORRADE_VERIFY(out.str().find("postprocess step JoinIdenticalVertices") == std::string::npos);
+    CORRADE_VERIFY(out.str().find("postprocess step Triangulate") == std::string::npos);
+
+    /* Accessing the hierarchy doesn't trigger anything */
+    CORRADE_COMPARE(importer->meshCount(), 1);
+    CORRADE_COMPARE(importer->object3DCount(), 1);
+
+    /* The rest is applied on the first mesh access */
+    out.str({});
+    Containers::Optional<MeshData> mesh;
+    {
+        Debug redirectOutput{&out};
+        mesh = importer->mesh(0);
+    }
+    CORRADE_VERIFY(mesh);
+    CORRADE_VERIFY(out.str().find("Trade::AssimpImporter::mesh(): postprocess step JoinIdenticalVertices took") != std::string::npos);
+    CORRADE_VERIFY(out.str().find("Trade::AssimpImporter::mesh(): postprocess step Triangulate took") != std::string::npos);
+    CORRADE_VERIFY(out.str().find("postprocess step FlipUVs") == std::string::npos);
+
+    /* The result is the same as when applying all steps at once */
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+    CORRADE_COMPARE_AS(mesh->indices<UnsignedInt>(),
+        Containers::arrayView<UnsignedInt>({0, 1, 2}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector2>(MeshAttribute::TextureCoordinates),
+        Containers::arrayView<Vector2>({
+            {0.5f, 0.0f}, {0.75f, 0.5f}, {0.5f, 0.1f}
+        }), TestSuite::Compare::Container);
+
+    /* Subsequent accesses don't apply the steps again */
+    out.str({});
+    {
+        Debug redirectOutput{&out};
+        CORRADE_VERIFY(importer->mesh(0));
+    }
+    CORRADE_COMPARE(out.str(), "");
+}
+
 void AssimpImporterTest::fileCallback() {
     /* This should verify also formats with external data (such as glTF),
        because Assimp is using the same callbacks for all data loading */
@@ -25,3 +25,4 @@
 */
 
 #cmakedefine MAGNUM_ASSIMPIMPORTER_BUILD_STATIC
+#cmakedefine MAGNUM_ASSIMPIMPORTER_WITH_PROFILING
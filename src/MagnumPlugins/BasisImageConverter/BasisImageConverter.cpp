@@ -26,16 +26,20 @@
 
 #include "BasisImageConverter.h"
 
+#include <cstddef>
 #include <cstring>
 #include <algorithm>
 #include <thread>
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/Directory.h>
+#include <Corrade/Utility/Sha1.h>
 #include <Magnum/ImageView.h>
-#include <Magnum/Math/Color.h>
-#include <Magnum/Math/Swizzle.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/PixelFormat.h>
 #include <basisu_enc.h>
 #include <basisu_comp.h>
@@ -43,23 +47,233 @@
 
 namespace Magnum { namespace Trade {
 
-BasisImageConverter::BasisImageConverter() = default;
+namespace {
 
-BasisImageConverter::BasisImageConverter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImageConverter{manager, plugin} {}
-
-ImageConverterFeatures BasisImageConverter::doFeatures() const { return ImageConverterFeature::ConvertData; }
+/* There is only this type of codebook. It's only read from after
+   construction, so it's created on first use and then shared by all
+   instances and conversions instead of unpacking it for each again. */
+const basist::etc1_global_selector_codebook& globalSelectorCodebook() {
+    static const basist::etc1_global_selector_codebook codebook{
+        basist::g_global_selector_cb_size, basist::g_global_selector_cb};
+    return codebook;
+}
 
-Containers::Array<char> BasisImageConverter::doExportToData(const ImageView2D& image) {
-    /* Check input */
+bool checkImage(const ImageView2D& image, const char* const messagePrefix) {
     if(image.format() != PixelFormat::RGB8Unorm &&
        image.format() != PixelFormat::RGBA8Unorm &&
        image.format() != PixelFormat::RG8Unorm &&
        image.format() != PixelFormat::R8Unorm)
     {
-        Error{} << "Trade::BasisImageConverter::exportToData(): unsupported format" << image.format();
+        Error{} << messagePrefix << "unsupported format" << image.format();
+        return false;
+    }
+
+    if(image.size().x() <= 0 || image.size().y() <= 0) {
+        Error() << messagePrefix << "source image is empty";
+        return false;
+    }
+
+    if(!image.data()) {
+        Error() << messagePrefix << "source image data is nullptr";
+        return false;
+    }
+
+    return true;
+}
+
+/* Copy image data into the basis image. There is no way to construct a basis
+   image from existing data as it is based on a std::vector, moreover we need
+   to tightly pack it and flip Y. Pixels in an image row are always
+   contiguous, only the row stride can vary, so this operates on whole rows
+   and plain byte pointers. That makes the RGBA case just a memcpy() and the
+   channel expansion simple enough for the compiler to vectorize. */
+void copyImage(const ImageView2D& image, basisu::image& out) {
+    const std::size_t width = image.size().x();
+    const std::size_t height = image.size().y();
+    out.resize(width, height);
+
+    const Containers::StridedArrayView3D<const char> src = image.pixels();
+    const std::size_t channelCount = image.pixelSize();
+    for(std::size_t y = 0; y != height; ++y) {
+        const auto* srcRow = reinterpret_cast<const UnsignedByte*>(&src[y][0][0]);
+        /* Y-flipped */
+        auto* dstRow = reinterpret_cast<UnsignedByte*>(out.get_ptr() + (height - y - 1)*width);
+
+        /* basis image is always RGBA, fill in alpha if necessary */
+        if(channelCount == 4) {
+            std::memcpy(dstRow, srcRow, width*4);
+
+        } else if(channelCount == 3) {
+            for(std::size_t x = 0; x != width; ++x) {
+                dstRow[x*4 + 0] = srcRow[x*3 + 0];
+                dstRow[x*4 + 1] = srcRow[x*3 + 1];
+                dstRow[x*4 + 2] = srcRow[x*3 + 2];
+                dstRow[x*4 + 3] = 255;
+            }
+
+        } else if(channelCount == 2) {
+            for(std::size_t x = 0; x != width; ++x) {
+                dstRow[x*4 + 0] = srcRow[x*2 + 0];
+                dstRow[x*4 + 1] = srcRow[x*2 + 0];
+                dstRow[x*4 + 2] = srcRow[x*2 + 0];
+                dstRow[x*4 + 3] = srcRow[x*2 + 1];
+            }
+
+        } else if(channelCount == 1) {
+            for(std::size_t x = 0; x != width; ++x) {
+                dstRow[x*4 + 0] = srcRow[x];
+                dstRow[x*4 + 1] = srcRow[x];
+                dstRow[x*4 + 2] = srcRow[x];
+                dstRow[x*4 + 3] = 255;
+            }
+
+        } else CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+    }
+}
+
+/* Feeds the binary representation of a value to the hash. Used with an
+   explicit type to convert the basisu parameter wrappers to the underlying
+   type first. */
+template<class T> void hashValue(Utility::Sha1& sha1, const T& value) {
+    sha1 << Containers::ArrayView<const char>{reinterpret_cast<const char*>(&value), sizeof(T)};
+}
+
+template<> void hashValue<std::string>(Utility::Sha1& sha1, const std::string& value) {
+    /* Size first so consecutive strings can't be shifted into each other */
+    hashValue(sha1, UnsignedLong(value.size()));
+    sha1 << value;
+}
+
+/* Name of the cache file for given input, a SHA-1 of the pixel data and all
+   parameters that affect the output. Unlike the change detection in
+   OpenGexImporter, there's no other way to identify the input, so a
+   cryptographic hash is used to make collisions practically impossible. */
+std::string cacheKey(const basisu::basis_compressor_params& params, const Containers::ArrayView<const ImageView2D> images, const bool levels) {
+    Utility::Sha1 sha1;
+
+    /* Bump this if the way the output is produced changes, to not return
+       stale data from existing caches */
+    sha1 << std::string{"BasisImageConverter 1"};
+    hashValue(sha1, levels);
+    hashValue(sha1, UnsignedLong(images.size()));
+
+    /* Only the actual pixel data, without row padding */
+    for(const ImageView2D& image: images) {
+        hashValue(sha1, image.format());
+        hashValue(sha1, image.size());
+        const Containers::StridedArrayView3D<const char> pixels = image.pixels();
+        const std::size_t rowSize = image.size().x()*image.pixelSize();
+        for(std::size_t y = 0; y != pixels.size()[0]; ++y)
+            sha1 << Containers::ArrayView<const char>{&pixels[y][0][0], rowSize};
+    }
+
+    /* Same order as in convert(), without the threading options that don't
+       affect the output */
+    #define HASH_PARAM(name, type) hashValue<type>(sha1, params.m_##name)
+    HASH_PARAM(quality_level, int);
+    HASH_PARAM(perceptual, bool);
+    HASH_PARAM(debug, bool);
+    HASH_PARAM(debug_images, bool);
+    HASH_PARAM(compute_stats, bool);
+    HASH_PARAM(compression_level, int);
+    HASH_PARAM(max_endpoint_clusters, int);
+    HASH_PARAM(max_selector_clusters, int);
+    HASH_PARAM(y_flip, bool);
+    HASH_PARAM(check_for_alpha, bool);
+    HASH_PARAM(force_alpha, bool);
+    HASH_PARAM(seperate_rg_to_color_alpha, bool);
+    HASH_PARAM(disable_hierarchical_endpoint_codebooks, bool);
+    HASH_PARAM(mip_gen, bool);
+    HASH_PARAM(mip_srgb, bool);
+    HASH_PARAM(mip_scale, float);
+    HASH_PARAM(mip_filter, std::string);
+    HASH_PARAM(mip_renormalize, bool);
+    HASH_PARAM(mip_wrapping, bool);
+    HASH_PARAM(mip_smallest_dimension, int);
+    HASH_PARAM(no_selector_rdo, bool);
+    HASH_PARAM(selector_rdo_thresh, float);
+    HASH_PARAM(no_endpoint_rdo, bool);
+    HASH_PARAM(endpoint_rdo_thresh, float);
+    HASH_PARAM(global_sel_pal, bool);
+    HASH_PARAM(auto_global_sel_pal, bool);
+    HASH_PARAM(no_hybrid_sel_cb, bool);
+    HASH_PARAM(global_pal_bits, int);
+    HASH_PARAM(global_mod_bits, int);
+    HASH_PARAM(hybrid_sel_cb_quality_thresh, float);
+    HASH_PARAM(userdata0, int);
+    HASH_PARAM(userdata1, int);
+    #undef HASH_PARAM
+
+    return sha1.digest().hexString();
+}
+
+/* Checks that a cached file is complete and not corrupted, using the same
+   checksums Basis itself verifies when transcoding */
+bool isValidBasisFile(const Containers::ArrayView<const char> data) {
+    if(data.size() < sizeof(basist::basis_file_header)) return false;
+
+    const auto& header = *reinterpret_cast<const basist::basis_file_header*>(data.data());
+    return UnsignedInt(header.m_sig) == UnsignedInt(basist::basis_file_header::cBASISSigValue) &&
+        UnsignedInt(header.m_header_size) == sizeof(basist::basis_file_header) &&
+        data.size() == sizeof(basist::basis_file_header) + UnsignedInt(header.m_data_size) &&
+        UnsignedShort(header.m_header_crc16) == basist::crc16(&header.m_data_size, sizeof(basist::basis_file_header) - offsetof(basist::basis_file_header, m_data_size), 0) &&
+        UnsignedShort(header.m_data_crc16) == basist::crc16(data.data() + sizeof(basist::basis_file_header), header.m_data_size, 0);
+}
+
+}
+
+struct BasisImageConverter::State {
+    /* Kept across conversions so the worker threads are created just once,
+       recreated only if the thread count changes */
+    Containers::Pointer<basisu::job_pool> jobPool;
+    UnsignedInt jobPoolThreadCount;
+};
+
+BasisImageConverter::BasisImageConverter(): _state{new State} {}
+
+BasisImageConverter::BasisImageConverter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImageConverter{manager, plugin}, _state{new State} {}
+
+BasisImageConverter::~BasisImageConverter() = default;
+
+ImageConverterFeatures BasisImageConverter::doFeatures() const { return ImageConverterFeature::ConvertData; }
+
+Containers::Array<char> BasisImageConverter::doExportToData(const ImageView2D& image) {
+    return convert({&image, 1}, false, "Trade::BasisImageConverter::exportToData():");
+}
+
+Containers::Array<char> BasisImageConverter::exportImagesToData(const Containers::ArrayView<const ImageView2D> images) {
+    if(images.empty()) {
+        Error{} << "Trade::BasisImageConverter::exportImagesToData(): no images given";
+        return {};
+    }
+
+    return convert(images, false, "Trade::BasisImageConverter::exportImagesToData():");
+}
+
+Containers::Array<char> BasisImageConverter::exportLevelsToData(const Containers::ArrayView<const ImageView2D> levels) {
+    if(levels.empty()) {
+        Error{} << "Trade::BasisImageConverter::exportLevelsToData(): no levels given";
         return {};
     }
 
+    /* Basis itself doesn't care, but a broken mip chain would be useless for
+       a GPU texture */
+    for(std::size_t i = 1; i != levels.size(); ++i) {
+        const Vector2i expected = Math::max(levels[0].size() >> Int(i), Vector2i{1});
+        if(levels[i].size() != expected) {
+            Error{} << "Trade::BasisImageConverter::exportLevelsToData(): expected size" << expected << "for level" << i << "but got" << levels[i].size();
+            return {};
+        }
+    }
+
+    return convert(levels, true, "Trade::BasisImageConverter::exportLevelsToData():");
+}
+
+Containers::Array<char> BasisImageConverter::convert(const Containers::ArrayView<const ImageView2D> images, const bool levels, const char* const messagePrefix) {
+    /* Check input */
+    for(const ImageView2D& image: images)
+        if(!checkImage(image, messagePrefix)) return {};
+
     /* To retain sanity, keep this in the same order and grouping as in the
        conf file */
     basisu::basis_compressor_params params;
@@ -85,13 +299,21 @@ Containers::Array<char> BasisImageConverter::doExportToData(const ImageView2D& i
     if(threadCount == 0) threadCount = std::thread::hardware_concurrency();
     const bool multithreading = threadCount > 1;
     params.m_multithreading = multithreading;
-    basisu::job_pool jpool{threadCount};
-    params.m_pJob_pool = &jpool;
+    if(!_state->jobPool || _state->jobPoolThreadCount != threadCount) {
+        /* Destroy the previous pool first to not have both running at the
+           same time */
+        _state->jobPool = nullptr;
+        _state->jobPool.reset(new basisu::job_pool{threadCount});
+        _state->jobPoolThreadCount = threadCount;
+    }
+    params.m_pJob_pool = _state->jobPool.get();
 
     PARAM_CONFIG(disable_hierarchical_endpoint_codebooks, bool);
 
     /* Mipmap generation options */
     PARAM_CONFIG(mip_gen, bool);
+    /* Basis would generate a mip chain for each of the supplied levels */
+    if(levels) params.m_mip_gen = false;
     PARAM_CONFIG(mip_srgb, bool);
     PARAM_CONFIG(mip_scale, float);
     PARAM_CONFIG(mip_filter, std::string);
@@ -119,57 +341,60 @@ Containers::Array<char> BasisImageConverter::doExportToData(const ImageView2D& i
     #undef PARAM_CONFIG
     #undef PARAM_CONFIG_FIX_NAME
 
+    /* Presets override the options they're concerned with. The thresholds
+       match what the basisu tool documents as reasonable ranges. */
+    const std::string preset = configuration().value("preset");
+    if(preset == "fast") {
+        params.m_compression_level = 0;
+        params.m_no_selector_rdo = true;
+        params.m_no_endpoint_rdo = true;
+    } else if(preset == "balanced") {
+        params.m_compression_level = 1;
+        params.m_no_selector_rdo = false;
+        params.m_selector_rdo_thresh = 1.25f;
+        params.m_no_endpoint_rdo = false;
+        params.m_endpoint_rdo_thresh = 1.5f;
+    } else if(preset == "small") {
+        params.m_compression_level = 2;
+        params.m_no_selector_rdo = false;
+        params.m_selector_rdo_thresh = 1.75f;
+        params.m_no_endpoint_rdo = false;
+        params.m_endpoint_rdo_thresh = 2.0f;
+    } else if(preset == "smallest") {
+        params.m_compression_level = 4;
+        params.m_no_selector_rdo = false;
+        params.m_selector_rdo_thresh = 2.5f;
+        params.m_no_endpoint_rdo = false;
+        params.m_endpoint_rdo_thresh = 3.0f;
+    } else if(!preset.empty()) {
+        Error{} << messagePrefix << "unknown preset" << preset;
+        return {};
+    }
+
     /* If these are enabled, the library reads PNGs from a filesystem and then
        writes basis files there also. DO NOT WANT. */
     params.m_read_source_images = false;
     params.m_write_output_basis_files = false;
 
-    basist::etc1_global_selector_codebook sel_codebook(basist::g_global_selector_cb_size, basist::g_global_selector_cb);
-    params.m_pSel_codebook = &sel_codebook;
-
-    if(image.size().x() <= 0 || image.size().y() <= 0) {
-        Error() << "Trade::BasisImageConverter::exportToData(): source image is empty";
-        return {};
-    }
-
-    if(!image.data()) {
-        Error() << "Trade::BasisImageConverter::exportToData(): source image data is nullptr";
-        return {};
+    params.m_pSel_codebook = &globalSelectorCodebook();
+
+    /* If there's a cached file for the same input and parameters, return it
+       directly. A missing, incomplete or corrupted file is not an error, it
+       just gets encoded and written again. */
+    const std::string cacheDirectory = configuration().value("cacheDirectory");
+    std::string cacheFilename;
+    if(!cacheDirectory.empty()) {
+        cacheFilename = Utility::Directory::join(cacheDirectory, cacheKey(params, images, levels) + ".basis");
+        if(Utility::Directory::exists(cacheFilename)) {
+            Containers::Array<char> cached = Utility::Directory::read(cacheFilename);
+            if(isValidBasisFile(cached)) return cached;
+        }
     }
 
-    /* Copy image data into the basis image. There is no way to construct a
-       basis image from existing data as it is based on a std::vector, moreover
-       we need to tightly pack it and flip Y. The `dst` is an Y-flipped view
-       already to make the following loops simpler. */
-    params.m_source_images.emplace_back(image.size().x(), image.size().y());
-    auto dst = Containers::arrayCast<Color4ub>(Containers::StridedArrayView2D<basisu::color_rgba>({params.m_source_images.back().get_ptr(), params.m_source_images.back().get_total_pixels()}, {std::size_t(image.size().y()), std::size_t(image.size().x())})).flipped<0>();
-
-    /* basis image is always RGBA, fill in alpha if necessary */
-    if(image.format() == PixelFormat::RGBA8Unorm) {
-        auto src = image.pixels<Math::Vector4<UnsignedByte>>();
-        for(std::size_t y = 0; y != src.size()[0]; ++y)
-            for(std::size_t x = 0; x != src.size()[1]; ++x)
-                dst[y][x] = src[y][x];
-
-    } else if(image.format() == PixelFormat::RGB8Unorm) {
-        auto src = image.pixels<Math::Vector3<UnsignedByte>>();
-        for(std::size_t y = 0; y != src.size()[0]; ++y)
-            for(std::size_t x = 0; x != src.size()[1]; ++x)
-                dst[y][x] = src[y][x]; /* Alpha implicitly 255 */
-
-    } else if(image.format() == PixelFormat::RG8Unorm) {
-        auto src = image.pixels<Math::Vector2<UnsignedByte>>();
-        for(std::size_t y = 0; y != src.size()[0]; ++y)
-            for(std::size_t x = 0; x != src.size()[1]; ++x)
-                dst[y][x] = Math::gather<'r', 'r', 'r', 'g'>(src[y][x]);
-
-    } else if(image.format() == PixelFormat::R8Unorm) {
-        auto src = image.pixels<Math::Vector<1, UnsignedByte>>();
-        for(std::size_t y = 0; y != src.size()[0]; ++y)
-            for(std::size_t x = 0; x != src.size()[1]; ++x)
-                dst[y][x] = Math::gather<'r', 'r', 'r'>(src[y][x]);
-
-    } else CORRADE_INTERNAL_ASSERT_UNREACHABLE();
+    /* Each image becomes a separate image in the file */
+    params.m_source_images.resize(images.size());
+    for(std::size_t i = 0; i != images.size(); ++i)
+        copyImage(images[i], params.m_source_images[i]);
 
     basisu::basis_compressor basis;
     basis.init(params);
@@ -178,22 +403,22 @@ Containers::Array<char> BasisImageConverter::doExportToData(const ImageView2D& i
     if(errorCode != basisu::basis_compressor::error_code::cECSuccess) switch(errorCode) {
         case basisu::basis_compressor::error_code::cECFailedReadingSourceImages:
             /* Emitted e.g. when source image is 0-size */
-            Error{} << "Trade::BasisImageConverter::exportToData(): source image is invalid";
+            Error{} << messagePrefix << "source image is invalid";
             return {};
         case basisu::basis_compressor::error_code::cECFailedValidating:
             /* process() will have printed additional error information to stderr */
-            Error{} << "Trade::BasisImageConverter::exportToData(): type constraint validation failed";
+            Error{} << messagePrefix << "type constraint validation failed";
             return {};
         case basisu::basis_compressor::error_code::cECFailedFrontEnd:
             /* process() will have printed additional error information to stderr */
-            Error{} << "Trade::BasisImageConverter::exportToData(): frontend processing failed";
+            Error{} << messagePrefix << "frontend processing failed";
             return {};
         case basisu::basis_compressor::error_code::cECFailedBackend:
-            Error{} << "Trade::BasisImageConverter::exportToData(): encoding failed";
+            Error{} << messagePrefix << "encoding failed";
             return {};
         case basisu::basis_compressor::error_code::cECFailedCreateBasisFile:
             /* process() will have printed additional error information to stderr */
-            Error{} << "Trade::BasisImageConverter::exportToData(): assembling basis file data or transcoding failed";
+            Error{} << messagePrefix << "assembling basis file data or transcoding failed";
             return {};
 
         /* LCOV_EXCL_START */
@@ -212,6 +437,28 @@ Containers::Array<char> BasisImageConverter::doExportToData(const ImageView2D& i
     Containers::Array<char> fileData{Containers::DefaultInit, out.size()};
     std::copy(out.begin(), out.end(), fileData.data());
 
+    /* The compressor has no way to take pre-generated levels, but encoding
+       them as separate images puts them into a common codebook exactly like
+       levels generated with mip_gen. They differ only in the image and level
+       index of each slice, so relabel the images as levels of the first
+       image and update the header and checksums accordingly. */
+    if(levels && images.size() > 1) {
+        auto& header = *reinterpret_cast<basist::basis_file_header*>(fileData.data());
+        auto* slices = reinterpret_cast<basist::basis_slice_desc*>(fileData.data() + header.m_slice_desc_file_ofs);
+        for(std::size_t i = 0, iMax = header.m_total_slices; i != iMax; ++i) {
+            slices[i].m_level_index = UnsignedInt(slices[i].m_image_index);
+            slices[i].m_image_index = 0;
+        }
+        header.m_total_images = 1;
+        header.m_data_crc16 = basist::crc16(fileData.data() + sizeof(basist::basis_file_header), header.m_data_size, 0);
+        header.m_header_crc16 = basist::crc16(&header.m_data_size, sizeof(basist::basis_file_header) - offsetof(basist::basis_file_header, m_data_size), 0);
+    }
+
+    /* Save the result for the next time. Failing to do so isn't fatal, the
+       file just gets encoded again. */
+    if(!cacheFilename.empty() && (!Utility::Directory::mkpath(cacheDirectory) || !Utility::Directory::write(cacheFilename, fileData)))
+        Warning{} << messagePrefix << "cannot write cache file" << cacheFilename;
+
     return fileData;
 }
 
@@ -31,6 +31,7 @@
  * @m_since_{plugins,2019,10}
  */
 
+#include <Corrade/Containers/Pointer.h>
 #include <Magnum/Trade/AbstractImageConverter.h>
 
 #include "MagnumPlugins/BasisImageConverter/configure.h"
@@ -110,6 +111,26 @@ target_link_libraries(your-app PRIVATE MagnumPlugins::BasisImageConverter)
 See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
 information.
 
+@section Trade-BasisImageConverter-batch Converting multiple images
+
+Multiple images, such as layers of a texture array or faces of a cube map, can
+be put into a single file using @ref exportImagesToData(). All images are
+encoded with a common codebook in one go, which is faster than encoding each
+of them separately.
+
+If the mip levels were already generated by other means, for example with a
+higher-quality filter or in parallel as a part of an asset pipeline, pass
+them to @ref exportLevelsToData() instead of enabling @cb{.ini} mip_gen @ce.
+The levels are then encoded as-is, saving the time Basis would otherwise
+spend resampling them from the base level.
+
+The global selector codebook is created only once and shared by all
+instances. The worker threads used if the @cb{.ini} threads @ce
+@ref Trade-BasisImageConverter-configuration "configuration option" is set
+to a value other than @cpp 1 @ce are kept alive between conversions as long
+as the thread count doesn't change, so converting a batch of unrelated images
+with the same converter instance pays the thread startup cost only once.
+
 @section Trade-BasisImageConverter-configuration Plugin-specific configuration
 
 Basis compression can be configured to produce better quality or reduce
@@ -120,6 +141,31 @@ tool. The full form of the configuration is shown below:
 
 <b></b>
 
+Instead of tuning the individual options, the @cb{.ini} preset @ce option can
+be set to one of @cb{.ini} fast @ce, @cb{.ini} balanced @ce,
+@cb{.ini} small @ce or @cb{.ini} smallest @ce, trading encoding speed for
+file size. Encoding and transcoding throughput of each preset on your data
+can be measured with the `BasisImageConverterBenchmark` executable, built
+together with the tests. Note that the Basis Universal version this plugin
+is built against supports only the ETC1S mode, the UASTC mode isn't
+available.
+
+@section Trade-BasisImageConverter-cache Caching the encoded output
+
+As encoding a large image can take several seconds, incremental asset
+pipelines can set the @cb{.ini} cacheDirectory @ce
+@ref Trade-BasisImageConverter-configuration "configuration option" to a
+directory where the encoded files get saved. The file name is a SHA-1 hash of
+the pixel data, size and format of all input images together with all
+encoder options that affect the output, so converting an image that didn't
+change with the same options returns the saved file without encoding it
+again, while changing any of them produces a new file. The
+@cb{.ini} threads @ce option isn't a part of the hash as it doesn't affect
+the output. Files that are incomplete or fail the Basis checksum verification
+are encoded and saved again and if the file can't be saved, a warning is
+printed and the encoded data are returned as usual. Old files are never
+removed from the directory, it's up to the application to clean it up.
+
 @section Trade-BasisImageConverter-loading Loading the plugin fails undefined symbol: pthread_create
 
 On Linux it may happen that loading the plugin will fail with
@@ -145,9 +191,49 @@ class MAGNUM_BASISIMAGECONVERTER_EXPORT BasisImageConverter: public AbstractImag
         /** @brief Plugin manager constructor */
         explicit BasisImageConverter(PluginManager::AbstractManager& manager, const std::string& plugin);
 
+        ~BasisImageConverter();
+
+        /**
+         * @brief Convert multiple images to a single file
+         * @m_since_latest_{plugins}
+         *
+         * Like @ref exportToData(const ImageView2D&), but puts all @p images
+         * into a single file, for example layers of a texture array or faces
+         * of a cube map. The images don't need to have the same size or
+         * format and are imported back as separate images by
+         * @ref BasisImporter. See @ref Trade-BasisImageConverter-batch for
+         * more information. If @p images are empty, if any of them has an
+         * unsupported format, is empty or if the encoding fails, prints a
+         * message to @ref Error and returns @cpp nullptr @ce.
+         */
+        virtual Containers::Array<char> exportImagesToData(Containers::ArrayView<const ImageView2D> images);
+
+        /**
+         * @brief Convert a pre-generated mip chain to a file
+         * @m_since_latest_{plugins}
+         *
+         * Like @ref exportToData(const ImageView2D&), but instead of
+         * generating the mip levels with the @cb{.ini} mip_gen @ce
+         * @ref Trade-BasisImageConverter-configuration "configuration option",
+         * @p levels are used as a complete mip chain of a single image, with
+         * the first item being the base level. The @cb{.ini} mip_gen @ce
+         * option is ignored in this case. See
+         * @ref Trade-BasisImageConverter-batch for more information. If
+         * @p levels are empty, if size of each level isn't half of the
+         * previous level, rounded down to at least one pixel, if any of them
+         * has an unsupported format, is empty or if the encoding fails,
+         * prints a message to @ref Error and returns @cpp nullptr @ce.
+         */
+        virtual Containers::Array<char> exportLevelsToData(Containers::ArrayView<const ImageView2D> levels);
+
     private:
+        struct State;
+
         MAGNUM_BASISIMAGECONVERTER_LOCAL ImageConverterFeatures doFeatures() const override;
         MAGNUM_BASISIMAGECONVERTER_LOCAL Containers::Array<char> doExportToData(const ImageView2D& image) override;
+        MAGNUM_BASISIMAGECONVERTER_LOCAL Containers::Array<char> convert(Containers::ArrayView<const ImageView2D> images, bool levels, const char* messagePrefix);
+
+        Containers::Pointer<State> _state;
 };
 
 }}
@@ -0,0 +1,148 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+    Copyright © 2019 Jonathan Hale <squareys@googlemail.com>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+struct BasisImageConverterBenchmark: TestSuite::Tester {
+    explicit BasisImageConverterBenchmark();
+
+    void encode();
+    void transcode();
+
+    /* Explicitly forbid system-wide plugin dependencies */
+    PluginManager::Manager<AbstractImageConverter> _converterManager{"nonexistent"};
+    PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
+
+    Containers::Array<char> _data;
+};
+
+/* To calculate the throughput in MB/s, divide the image size by the measured
+   time */
+constexpr Vector2i ImageSize{512, 512};
+
+constexpr struct {
+    const char* name;
+} EncodeData[] {
+    {"fast"},
+    {"balanced"},
+    {"small"},
+    {"smallest"}
+};
+
+constexpr struct {
+    const char* name;
+} TranscodeData[] {
+    {"Etc1RGB"},
+    {"Etc2RGBA"},
+    {"Bc1RGB"},
+    {"Bc3RGBA"},
+    {"Bc7RGBA"},
+    {"Astc4x4RGBA"},
+    {"RGBA8"}
+};
+
+BasisImageConverterBenchmark::BasisImageConverterBenchmark() {
+    addInstancedBenchmarks({&BasisImageConverterBenchmark::encode}, 3,
+        Containers::arraySize(EncodeData));
+
+    addInstancedBenchmarks({&BasisImageConverterBenchmark::transcode}, 10,
+        Containers::arraySize(TranscodeData));
+
+    /* Load the plugins directly from the build tree. Otherwise they're static
+       and already loaded. */
+    #ifdef BASISIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(BASISIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef BASISIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(BASISIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+
+    /* A smooth gradient with a bit of high-frequency detail so the encoder
+       has something to work with */
+    _data = Containers::Array<char>{Containers::NoInit, std::size_t(ImageSize.product()*4)};
+    for(Int y = 0; y != ImageSize.y(); ++y) for(Int x = 0; x != ImageSize.x(); ++x) {
+        char* pixel = _data.data() + (y*ImageSize.x() + x)*4;
+        pixel[0] = x/2;
+        pixel[1] = y/2;
+        pixel[2] = (x*y) % 255;
+        pixel[3] = (x ^ y) & 0xff;
+    }
+}
+
+void BasisImageConverterBenchmark::encode() {
+    auto&& data = EncodeData[testCaseInstanceId()];
+    setTestCaseDescription(Utility::formatString("{}, {}x{} RGBA8", data.name, ImageSize.x(), ImageSize.y()));
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("BasisImageConverter");
+    converter->configuration().setValue("preset", data.name);
+    converter->configuration().setValue("threads", 0);
+
+    Containers::Array<char> out;
+    CORRADE_BENCHMARK(1)
+        out = converter->exportToData(ImageView2D{PixelFormat::RGBA8Unorm, ImageSize, _data});
+
+    CORRADE_VERIFY(out);
+}
+
+void BasisImageConverterBenchmark::transcode() {
+    auto&& data = TranscodeData[testCaseInstanceId()];
+    setTestCaseDescription(Utility::formatString("{}, {}x{}", data.name, ImageSize.x(), ImageSize.y()));
+
+    if(_manager.loadState("BasisImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("BasisImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("BasisImageConverter");
+    converter->configuration().setValue("threads", 0);
+    const Containers::Array<char> file = converter->exportToData(ImageView2D{PixelFormat::RGBA8Unorm, ImageSize, _data});
+    CORRADE_VERIFY(file);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporter");
+    importer->configuration().setValue("format", data.name);
+    CORRADE_VERIFY(importer->openData(file));
+
+    Containers::Optional<ImageData2D> image;
+    CORRADE_BENCHMARK(1)
+        image = importer->image2D(0);
+
+    CORRADE_VERIFY(image);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::BasisImageConverterBenchmark)
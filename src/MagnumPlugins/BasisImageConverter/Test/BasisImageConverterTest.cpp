@@ -30,10 +30,12 @@
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/FileToString.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Corrade/Utility/Directory.h>
+#include <Corrade/Utility/String.h>
 #include <Magnum/DebugTools/CompareImage.h>
 #include <Magnum/Image.h>
 #include <Magnum/ImageView.h>
@@ -43,6 +45,8 @@
 #include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "MagnumPlugins/BasisImageConverter/BasisImageConverter.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Trade { namespace Test { namespace {
@@ -60,6 +64,19 @@ struct BasisImageConverterTest: TestSuite::Tester {
     void rgb();
     void rgba();
 
+    void multipleImages();
+    void multipleImagesInvalid();
+    void multipleConversionsThreads();
+
+    void levels();
+    void levelsInvalid();
+
+    void preset();
+    void presetUnknown();
+
+    void cache();
+    void cacheCorrupted();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImageConverter> _converterManager{"nonexistent"};
 
@@ -76,6 +93,15 @@ constexpr struct {
     {"all threads", "0"}
 };
 
+constexpr struct {
+    const char* name;
+} PresetData[] {
+    {"fast"},
+    {"balanced"},
+    {"small"},
+    {"smallest"}
+};
+
 BasisImageConverterTest::BasisImageConverterTest() {
     addTests({&BasisImageConverterTest::wrongFormat,
               &BasisImageConverterTest::zeroSize,
@@ -90,6 +116,21 @@ BasisImageConverterTest::BasisImageConverterTest() {
     addInstancedTests({&BasisImageConverterTest::rgba},
         Containers::arraySize(ThreadsData));
 
+    addTests({&BasisImageConverterTest::multipleImages,
+              &BasisImageConverterTest::multipleImagesInvalid,
+              &BasisImageConverterTest::multipleConversionsThreads,
+
+              &BasisImageConverterTest::levels,
+              &BasisImageConverterTest::levelsInvalid});
+
+    addInstancedTests({&BasisImageConverterTest::preset},
+        Containers::arraySize(PresetData));
+
+    addTests({&BasisImageConverterTest::presetUnknown,
+
+              &BasisImageConverterTest::cache,
+              &BasisImageConverterTest::cacheCorrupted});
+
     /* Pull in the AnyImageImporter dependency for image comparison, load
        StbImageImporter from the build tree, if defined. Otherwise it's static
        and already loaded. */
@@ -325,6 +366,291 @@ void BasisImageConverterTest::rgba() {
         (DebugTools::CompareImageToFile{_manager, 78.3f, 8.302f}));
 }
 
+void BasisImageConverterTest::multipleImages() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("BasisImageConverter");
+
+    /* Different sizes and formats */
+    Containers::Array<char> data0{Containers::ValueInit, 16*8*4};
+    Containers::Array<char> data1{Containers::ValueInit, 8*4};
+    Containers::Array<char> data2{Containers::ValueInit, 12*12*3};
+    const ImageView2D images[]{
+        {PixelFormat::RGBA8Unorm, {16, 8}, data0},
+        {PixelFormat::R8Unorm, {8, 4}, data1},
+        {PixelFormat::RGB8Unorm, {12, 12}, data2}
+    };
+
+    const auto compressedData = static_cast<BasisImageConverter&>(*converter).exportImagesToData(images);
+    CORRADE_VERIFY(compressedData);
+
+    if(_manager.loadState("BasisImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("BasisImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer =
+        _manager.instantiate("BasisImporterRGBA8");
+    CORRADE_VERIFY(importer->openData(compressedData));
+    CORRADE_COMPARE(importer->image2DCount(), 3);
+    for(UnsignedInt i = 0; i != 3; ++i) {
+        CORRADE_ITERATION(i);
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(i);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->size(), images[i].size());
+    }
+}
+
+void BasisImageConverterTest::multipleImagesInvalid() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("BasisImageConverter");
+    auto& basisConverter = static_cast<BasisImageConverter&>(*converter);
+
+    Containers::Array<char> data{Containers::ValueInit, 16*8*4};
+    const ImageView2D images[]{
+        {PixelFormat::RGBA8Unorm, {16, 8}, data},
+        {PixelFormat::RG32F, {4, 4}, data}
+    };
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!basisConverter.exportImagesToData(nullptr));
+    CORRADE_VERIFY(!basisConverter.exportImagesToData(images));
+    CORRADE_COMPARE(out.str(),
+        "Trade::BasisImageConverter::exportImagesToData(): no images given\n"
+        "Trade::BasisImageConverter::exportImagesToData(): unsupported format PixelFormat::RG32F\n");
+}
+
+void BasisImageConverterTest::multipleConversionsThreads() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("BasisImageConverter");
+
+    Containers::Array<char> data{Containers::ValueInit, 16*16*4};
+    for(std::size_t i = 0; i != data.size(); ++i) data[i] = i*7;
+    const ImageView2D image{PixelFormat::RGBA8Unorm, {16, 16}, data};
+
+    /* The first conversion creates the job pool, the second reuses it and
+       the third recreates it with a different thread count. None of these
+       should crash or deadlock. */
+    converter->configuration().setValue("threads", 2);
+    const auto first = converter->exportToData(image);
+    CORRADE_VERIFY(first);
+    const auto second = converter->exportToData(image);
+    CORRADE_VERIFY(second);
+    converter->configuration().setValue("threads", 3);
+    const auto third = converter->exportToData(image);
+    CORRADE_VERIFY(third);
+
+    if(_manager.loadState("BasisImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("BasisImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer =
+        _manager.instantiate("BasisImporterRGBA8");
+    for(const Containers::Array<char>* fileData: {&first, &second, &third}) {
+        CORRADE_VERIFY(importer->openData(*fileData));
+        Containers::Optional<Trade::ImageData2D> imported = importer->image2D(0);
+        CORRADE_VERIFY(imported);
+        CORRADE_COMPARE(imported->size(), (Vector2i{16, 16}));
+    }
+}
+
+void BasisImageConverterTest::levels() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("BasisImageConverter");
+    /* Should get ignored */
+    converter->configuration().setValue("mip_gen", true);
+
+    Containers::Array<char> data{Containers::ValueInit, 16*8*4};
+    for(std::size_t i = 0; i != data.size(); ++i) data[i] = i*3;
+    const ImageView2D levels[]{
+        {PixelFormat::RGBA8Unorm, {16, 8}, data},
+        {PixelFormat::RGBA8Unorm, {8, 4}, data},
+        {PixelFormat::RGBA8Unorm, {4, 2}, data},
+        {PixelFormat::RGBA8Unorm, {2, 1}, data},
+        {PixelFormat::RGBA8Unorm, {1, 1}, data}
+    };
+
+    const auto compressedData = static_cast<BasisImageConverter&>(*converter).exportLevelsToData(levels);
+    CORRADE_VERIFY(compressedData);
+
+    if(_manager.loadState("BasisImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("BasisImporter plugin not found, cannot test");
+
+    /* The importer verifies the checksums, so this also tests that the file
+       was patched correctly */
+    Containers::Pointer<AbstractImporter> importer =
+        _manager.instantiate("BasisImporterRGBA8");
+    CORRADE_VERIFY(importer->openData(compressedData));
+    CORRADE_COMPARE(importer->image2DCount(), 1);
+    CORRADE_COMPARE(importer->image2DLevelCount(0), 5);
+    for(UnsignedInt i = 0; i != 5; ++i) {
+        CORRADE_ITERATION(i);
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, i);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->size(), levels[i].size());
+    }
+}
+
+void BasisImageConverterTest::levelsInvalid() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("BasisImageConverter");
+    auto& basisConverter = static_cast<BasisImageConverter&>(*converter);
+
+    Containers::Array<char> data{Containers::ValueInit, 16*8*4};
+    const ImageView2D levels[]{
+        {PixelFormat::RGBA8Unorm, {16, 8}, data},
+        {PixelFormat::RGBA8Unorm, {8, 4}, data},
+        {PixelFormat::RGBA8Unorm, {4, 1}, data}
+    };
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!basisConverter.exportLevelsToData(nullptr));
+    CORRADE_VERIFY(!basisConverter.exportLevelsToData(levels));
+    CORRADE_COMPARE(out.str(),
+        "Trade::BasisImageConverter::exportLevelsToData(): no levels given\n"
+        "Trade::BasisImageConverter::exportLevelsToData(): expected size Vector(4, 2) for level 2 but got Vector(4, 1)\n");
+}
+
+void BasisImageConverterTest::preset() {
+    auto&& data = PresetData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("BasisImageConverter");
+    converter->configuration().setValue("preset", data.name);
+
+    Containers::Array<char> imageData{Containers::ValueInit, 16*16*4};
+    for(std::size_t i = 0; i != imageData.size(); ++i) imageData[i] = i*5;
+    const auto compressedData = converter->exportToData(ImageView2D{PixelFormat::RGBA8Unorm, {16, 16}, imageData});
+    CORRADE_VERIFY(compressedData);
+
+    if(_manager.loadState("BasisImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("BasisImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer =
+        _manager.instantiate("BasisImporterRGBA8");
+    CORRADE_VERIFY(importer->openData(compressedData));
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), (Vector2i{16, 16}));
+}
+
+void BasisImageConverterTest::presetUnknown() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("BasisImageConverter");
+    converter->configuration().setValue("preset", "tiny");
+
+    Containers::Array<char> imageData{Containers::ValueInit, 16*16*4};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->exportToData(ImageView2D{PixelFormat::RGBA8Unorm, {16, 16}, imageData}));
+    CORRADE_COMPARE(out.str(),
+        "Trade::BasisImageConverter::exportToData(): unknown preset tiny\n");
+}
+
+std::vector<std::string> cacheFiles(const std::string& directory) {
+    return Utility::Directory::list(directory, Utility::Directory::Flag::SkipDirectories|Utility::Directory::Flag::SkipDotAndDotDot|Utility::Directory::Flag::SortAscending);
+}
+
+void clearCache(const std::string& directory) {
+    for(const std::string& file: cacheFiles(directory))
+        CORRADE_INTERNAL_ASSERT_OUTPUT(Utility::Directory::rm(Utility::Directory::join(directory, file)));
+}
+
+void BasisImageConverterTest::cache() {
+    const std::string cacheDirectory = Utility::Directory::join(BASISIMAGECONVERTER_WRITE_TEST_DIR, "cache");
+    clearCache(cacheDirectory);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("BasisImageConverter");
+    converter->configuration().setValue("cacheDirectory", cacheDirectory);
+
+    Containers::Array<char> imageData{Containers::ValueInit, 16*16*4};
+    for(std::size_t i = 0; i != imageData.size(); ++i) imageData[i] = i*3;
+    const ImageView2D image{PixelFormat::RGBA8Unorm, {16, 16}, imageData};
+
+    /* The first conversion creates the directory and saves the file */
+    const Containers::Array<char> first = converter->exportToData(image);
+    CORRADE_VERIFY(first);
+    std::vector<std::string> files = cacheFiles(cacheDirectory);
+    CORRADE_COMPARE(files.size(), 1);
+    CORRADE_VERIFY(Utility::String::endsWith(files[0], ".basis"));
+    const std::string firstFile = Utility::Directory::join(cacheDirectory, files[0]);
+    CORRADE_COMPARE_AS(firstFile, (std::string{first, first.size()}),
+        TestSuite::Compare::FileToString);
+
+    /* Replace the saved file with a different valid file to verify the
+       second conversion returns it instead of encoding again */
+    Containers::Array<char> other;
+    {
+        Containers::Pointer<AbstractImageConverter> uncached = _converterManager.instantiate("BasisImageConverter");
+        /* Ends up in the header, so the file is guaranteed to differ */
+        uncached->configuration().setValue("userdata0", 1);
+        other = uncached->exportToData(image);
+        CORRADE_VERIFY(other);
+    }
+    CORRADE_VERIFY(std::string(first, first.size()) != std::string(other, other.size()));
+    CORRADE_VERIFY(Utility::Directory::write(firstFile, other));
+    const Containers::Array<char> second = converter->exportToData(image);
+    CORRADE_COMPARE_AS(Containers::arrayView(second), Containers::arrayView(other),
+        TestSuite::Compare::Container);
+
+    /* Different thread count doesn't affect the output, so it's still
+       cached */
+    converter->configuration().setValue("threads", 2);
+    const Containers::Array<char> third = converter->exportToData(image);
+    CORRADE_COMPARE_AS(Containers::arrayView(third), Containers::arrayView(other),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(cacheFiles(cacheDirectory).size(), 1);
+
+    /* Different options or different pixel data produce a new file */
+    converter->configuration().setValue("userdata0", 2);
+    CORRADE_VERIFY(converter->exportToData(image));
+    CORRADE_COMPARE(cacheFiles(cacheDirectory).size(), 2);
+
+    imageData[17] = 0x7f;
+    CORRADE_VERIFY(converter->exportToData(image));
+    CORRADE_COMPARE(cacheFiles(cacheDirectory).size(), 3);
+
+    /* Same pixel data with different row padding hash the same */
+    Containers::Array<char> paddedData{Containers::ValueInit, 16*20*4};
+    Utility::copy(image.pixels(), Containers::StridedArrayView3D<char>{paddedData, {16, 16, 4}, {20*4, 4, 1}});
+    CORRADE_VERIFY(converter->exportToData(ImageView2D{PixelStorage{}.setRowLength(20), PixelFormat::RGBA8Unorm, {16, 16}, paddedData}));
+    CORRADE_COMPARE(cacheFiles(cacheDirectory).size(), 3);
+}
+
+void BasisImageConverterTest::cacheCorrupted() {
+    const std::string cacheDirectory = Utility::Directory::join(BASISIMAGECONVERTER_WRITE_TEST_DIR, "cache-corrupted");
+    clearCache(cacheDirectory);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("BasisImageConverter");
+    converter->configuration().setValue("cacheDirectory", cacheDirectory);
+
+    Containers::Array<char> imageData{Containers::ValueInit, 16*16*4};
+    for(std::size_t i = 0; i != imageData.size(); ++i) imageData[i] = i*3;
+    const ImageView2D image{PixelFormat::RGBA8Unorm, {16, 16}, imageData};
+
+    const Containers::Array<char> first = converter->exportToData(image);
+    CORRADE_VERIFY(first);
+    std::vector<std::string> files = cacheFiles(cacheDirectory);
+    CORRADE_COMPARE(files.size(), 1);
+    const std::string file = Utility::Directory::join(cacheDirectory, files[0]);
+
+    /* A truncated file gets encoded and saved again */
+    CORRADE_VERIFY(Utility::Directory::write(file, first.prefix(first.size()/2)));
+    {
+        const Containers::Array<char> out = converter->exportToData(image);
+        CORRADE_COMPARE_AS(Containers::arrayView(out), Containers::arrayView(first),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(file, (std::string{first, first.size()}),
+            TestSuite::Compare::FileToString);
+    }
+
+    /* A file with a broken checksum as well */
+    Containers::Array<char> corrupted{Containers::NoInit, first.size()};
+    Utility::copy(first, corrupted);
+    corrupted[corrupted.size() - 1] ^= 0x55;
+    CORRADE_VERIFY(Utility::Directory::write(file, corrupted));
+    {
+        const Containers::Array<char> out = converter->exportToData(image);
+        CORRADE_COMPARE_AS(Containers::arrayView(out), Containers::arrayView(first),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(file, (std::string{first, first.size()}),
+            TestSuite::Compare::FileToString);
+    }
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::BasisImageConverterTest)
@@ -28,3 +28,4 @@
 #cmakedefine BASISIMPORTER_PLUGIN_FILENAME "${BASISIMPORTER_PLUGIN_FILENAME}"
 #cmakedefine STBIMAGEIMPORTER_PLUGIN_FILENAME "${STBIMAGEIMPORTER_PLUGIN_FILENAME}"
 #cmakedefine BASISIMPORTER_TEST_DIR "${BASISIMPORTER_TEST_DIR}"
+#define BASISIMAGECONVERTER_WRITE_TEST_DIR "${BASISIMAGECONVERTER_WRITE_TEST_DIR}"
@@ -26,7 +26,7 @@
 
 #include "MagnumPlugins/BasisImageConverter/configure.h"
 
-#ifdef MAGNUM_BASISIMAGECONVERTER_BUILD_STATIC
+#if defined(MAGNUM_BASISIMAGECONVERTER_BUILD_STATIC) && !defined(MAGNUM_PLUGINS_NO_AUTOMATIC_IMPORT)
 #include <Corrade/PluginManager/AbstractManager.h>
 
 static int magnumBasisImageConverterStaticImporter() {
@@ -26,17 +26,31 @@
 
 #include "BasisImporter.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
 #include <basisu_transcoder.h>
 
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/ScopeGuard.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/ConfigurationValue.h>
 #include <Corrade/Utility/Debug.h>
 #include <Corrade/Utility/String.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Range.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "MagnumPlugins/Implementation/importerInput.h"
+
+#ifdef MAGNUM_BASISIMPORTER_WITH_PROFILING
+#define MAGNUM_IMPORTERPROFILING_ENABLED
+#endif
+#include "MagnumPlugins/Implementation/importerProfiling.h"
+
 namespace Magnum { namespace Trade { namespace {
 
 /* Map BasisImporter::TargetFormat to CompressedPixelFormat. See the
@@ -121,27 +135,64 @@ template<> struct ConfigurationValue<Magnum::Trade::BasisImporter::TargetFormat>
 
 namespace Magnum { namespace Trade {
 
-struct BasisImporter::State {
-    /* There is only this type of codebook */
-    basist::etc1_global_selector_codebook codebook;
+/* KTX2 support is in Basis Universal 1.13 and newer, if not explicitly
+   disabled. Older versions don't define the macro at all. */
+#if defined(BASISD_SUPPORT_KTX2) && BASISD_SUPPORT_KTX2
+#define _BASISIMPORTER_USE_KTX2
+#endif
+
+struct BasisImporter::State: Implementation::ImporterInput {
+    /* Exactly one of these is set if a file is opened, depending on whether
+       it's a *.basis or a *.ktx2 file */
     Containers::Optional<basist::basisu_transcoder> transcoder;
-    Containers::Array<unsigned char> in;
+    #ifdef _BASISIMPORTER_USE_KTX2
+    Containers::Optional<basist::ktx2_transcoder> ktx2Transcoder;
+    #endif
+
+    /* For KTX2 files only the image and level counts, the Y-flip and the
+       alpha flag are filled, which is all the rest of the code needs */
     basist::basisu_file_info fileInfo;
+    #ifdef _BASISIMPORTER_USE_KTX2
+    /* Face count of an opened KTX2 file. Layers and faces are flattened into
+       2D images, the image ID being `layer*ktx2Faces + face`. */
+    UnsignedInt ktx2Faces;
+    #endif
+
+    /* Level transcoded by image2DRegionInto(), reused for subsequent
+       regions of the same level */
+    struct {
+        UnsignedInt id, level;
+        TargetFormat format;
+        UnsignedInt rowLength;
+        Containers::Array<char> data;
+    } region;
 
     bool noTranscodeFormatWarningPrinted = false;
-
-    explicit State(): codebook(basist::g_global_selector_cb_size,
-        basist::g_global_selector_cb) {}
 };
 
-void BasisImporter::initialize() {
-    basist::basisu_transcoder_init();
+namespace {
+
+/* There is only this type of codebook. It's only read from after
+   construction, so it's created on first use and then shared by all
+   instances and threads, instead of unpacking it for each instance again.
+   Function-local statics are initialized thread-safely.
+
+   The global transcoder tables are initialized here as well. Doing that in
+   the plugin initializer would mean paying for it on every plugin manager
+   construction in static builds, even if no Basis file is ever opened. */
+const basist::etc1_global_selector_codebook& globalSelectorCodebook() {
+    static const bool transcoderInitialized = (basist::basisu_transcoder_init(), true);
+    static_cast<void>(transcoderInitialized);
+    static const basist::etc1_global_selector_codebook codebook{
+        basist::g_global_selector_cb_size, basist::g_global_selector_cb};
+    return codebook;
+}
+
 }
 
 BasisImporter::BasisImporter() = default;
 
 BasisImporter::BasisImporter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImporter{manager, plugin} {
-    /* Initializes codebook */
     _state.reset(new State);
 
     /* Set format configuration from plugin alias */
@@ -154,56 +205,173 @@ BasisImporter::BasisImporter(PluginManager::AbstractManager& manager, const std:
 
 BasisImporter::~BasisImporter() = default;
 
+void BasisImporter::setProfilingCallback(void(*callback)(const char*, UnsignedLong, std::size_t, void*), void* userData) {
+    _profilingCallback = callback;
+    _profilingUserData = userData;
+}
+
 ImporterFeatures BasisImporter::doFeatures() const { return ImporterFeature::OpenData; }
 
 bool BasisImporter::doIsOpened() const {
     /* Both the transcoder and then input data have to be present or both
        have to be empty */
+    #ifdef _BASISIMPORTER_USE_KTX2
+    CORRADE_INTERNAL_ASSERT((!_state->transcoder && !_state->ktx2Transcoder) == !_state->in);
+    #else
     CORRADE_INTERNAL_ASSERT(!_state->transcoder == !_state->in);
-    return _state->in;
+    #endif
+    return !!_state->in;
 }
 
 void BasisImporter::doClose() {
     _state->transcoder = Containers::NullOpt;
-    _state->in = nullptr;
+    #ifdef _BASISIMPORTER_USE_KTX2
+    _state->ktx2Transcoder = Containers::NullOpt;
+    #endif
+    _state->close();
+    _state->region.data = nullptr;
+}
+
+/* The KTX2 transcoder keeps a pointer to the data it was initialized with,
+   so the input is saved to the state first and validated from there */
+
+void BasisImporter::doOpenFile(const std::string& filename) {
+    /* Map the file instead of reading it to avoid having the whole file
+       copied in memory */
+    if(!_state->openFile(filename, "Trade::BasisImporter::openFile():")) return;
+    if(!openDataInternal(_state->in, "Trade::BasisImporter::openFile():"))
+        _state->close();
 }
 
 void BasisImporter::doOpenData(const Containers::ArrayView<const char> data) {
-    /* Because here we're copying the data and using the _in to check if file
-       is opened, having them nullptr would mean openData() would fail without
-       any error message. It's not possible to do this check on the importer
-       side, because empty file is valid in some formats (OBJ or glTF). We also
+    {
+        MAGNUM_IMPORTER_PROFILE(profile, _profilingCallback, _profilingUserData, "copy", data.size());
+        _state->openData(data);
+    }
+    if(!openDataInternal(_state->in, "Trade::BasisImporter::openData():"))
+        _state->close();
+}
+
+bool BasisImporter::openMemory(const Containers::ArrayView<const char> data) {
+    close();
+    _state->openMemory(data);
+    if(!openDataInternal(_state->in, "Trade::BasisImporter::openMemory():")) {
+        _state->close();
+        return false;
+    }
+    return true;
+}
+
+bool BasisImporter::openDataInternal(const Containers::ArrayView<const char> data, const char* const messagePrefix) {
+    MAGNUM_IMPORTER_PROFILE(profile, _profilingCallback, _profilingUserData, "open", data.size());
+
+    /* Because here we're using the `in` view to check if file is opened,
+       having it nullptr would mean openData() would fail without any error
+       message. It's not possible to do this check on the importer side,
+       because empty file is valid in some formats (OBJ or glTF). We also
        can't do the full import here because then doImage2D() would need to
-       copy the imported data instead anyway (and the uncompressed size is much
-       larger). This way it'll also work nicely with a future openMemory(). */
+       copy the imported data instead anyway (and the uncompressed size is
+       much larger). */
     if(data.empty()) {
-        Error{} << "Trade::BasisImporter::openData(): the file is empty";
-        return;
+        Error{} << messagePrefix << "the file is empty";
+        return false;
+    }
+
+    /* KTX2 files are recognized by their identifier, everything else is
+       treated as a *.basis file */
+    constexpr char Ktx2Identifier[]{'\xab', 'K', 'T', 'X', ' ', '2', '0', '\xbb', '\r', '\n', '\x1a', '\n'};
+    if(data.size() >= sizeof(Ktx2Identifier) && std::memcmp(data.data(), Ktx2Identifier, sizeof(Ktx2Identifier)) == 0) {
+        #ifdef _BASISIMPORTER_USE_KTX2
+        return openKtx2Internal(data, messagePrefix);
+        #else
+        Error{} << messagePrefix << "KTX2 files are not supported by this Basis Universal version";
+        return false;
+        #endif
     }
 
-    _state->transcoder.emplace(&_state->codebook);
+    _state->transcoder.emplace(&globalSelectorCodebook());
     Containers::ScopeGuard transcoderGuard{&_state->transcoder, [](Containers::Optional<basist::basisu_transcoder>* o) {
         *o = Containers::NullOpt;
     }};
     if(!_state->transcoder->validate_header(data.data(), data.size())) {
-        Error() << "Trade::BasisImporter::openData(): invalid header";
-        return;
+        Error() << messagePrefix << "invalid header";
+        return false;
     }
 
     /* Save the global file info to avoid calling that again each time we check
        for image count and whatnot; start transcoding */
     if(!_state->transcoder->get_file_info(data.data(), data.size(), _state->fileInfo) ||
        !_state->transcoder->start_transcoding(data.data(), data.size())) {
-        Error() << "Trade::BasisImporter::openData(): bad basis file";
-        return;
+        Error() << messagePrefix << "bad basis file";
+        return false;
     }
 
-    /* All good, release the transcoder guard and keep a copy of the data */
+    /* All good, release the transcoder guard */
     transcoderGuard.release();
-    _state->in = Containers::Array<unsigned char>(data.size());
-    std::copy(data.begin(), data.end(), _state->in.begin());
+    return true;
 }
 
+#ifdef _BASISIMPORTER_USE_KTX2
+bool BasisImporter::openKtx2Internal(const Containers::ArrayView<const char> data, const char* const messagePrefix) {
+    _state->ktx2Transcoder.emplace(const_cast<basist::etc1_global_selector_codebook*>(&globalSelectorCodebook()));
+    Containers::ScopeGuard transcoderGuard{&_state->ktx2Transcoder, [](Containers::Optional<basist::ktx2_transcoder>* o) {
+        *o = Containers::NullOpt;
+    }};
+    basist::ktx2_transcoder& transcoder = *_state->ktx2Transcoder;
+
+    /* Validates the header and the level index against the data size, but
+       doesn't touch the level data themselves */
+    if(!transcoder.init(data.data(), data.size())) {
+        Error{} << messagePrefix << "invalid KTX2 header";
+        return false;
+    }
+
+    /* Basis also accepts KTX2 files that contain neither ETC1S nor UASTC
+       data, but then fails only when transcoding */
+    if(!transcoder.is_etc1s() && !transcoder.is_uastc()) {
+        Error{} << messagePrefix << "the KTX2 file doesn't contain Basis Universal data";
+        return false;
+    }
+
+    #if !BASISD_SUPPORT_KTX2_ZSTD
+    if(transcoder.get_header().m_supercompression_scheme == basist::KTX2_SS_ZSTANDARD) {
+        Error{} << messagePrefix << "Zstandard supercompression is not supported by this Basis Universal build";
+        return false;
+    }
+    #endif
+
+    /* Textures with depth are not representable as 2D images */
+    if(transcoder.get_header().m_pixel_depth > 1) {
+        Error{} << messagePrefix << "3D KTX2 textures are not supported";
+        return false;
+    }
+
+    /* Decodes the ETC1S global codebooks, if any */
+    if(!transcoder.start_transcoding()) {
+        Error{} << messagePrefix << "bad KTX2 file";
+        return false;
+    }
+
+    /* Fill the subset of the file info used by the rest of the code. KTX2
+       defaults to Y down, so just an explicit "up" orientation means the
+       data are Y-flipped for OpenGL. */
+    _state->ktx2Faces = transcoder.get_faces();
+    const UnsignedInt imageCount = Math::max(transcoder.get_layers(), 1u)*_state->ktx2Faces;
+    _state->fileInfo = basist::basisu_file_info{};
+    _state->fileInfo.m_total_images = imageCount;
+    _state->fileInfo.m_image_mipmap_levels.resize(imageCount);
+    for(UnsignedInt i = 0; i != imageCount; ++i)
+        _state->fileInfo.m_image_mipmap_levels[i] = transcoder.get_levels();
+    _state->fileInfo.m_has_alpha_slices = transcoder.get_has_alpha();
+    const basist::uint8_vec* const orientation = transcoder.find_key("KTXorientation");
+    _state->fileInfo.m_y_flipped = orientation && orientation->size() >= 2 && (*orientation)[1] == 'u';
+
+    /* All good, release the transcoder guard */
+    transcoderGuard.release();
+    return true;
+}
+#endif
+
 UnsignedInt BasisImporter::doImage2DCount() const {
     return _state->fileInfo.m_total_images;
 }
@@ -212,24 +380,38 @@ UnsignedInt BasisImporter::doImage2DLevelCount(const UnsignedInt id) {
     return _state->fileInfo.m_image_mipmap_levels[id];
 }
 
-Containers::Optional<ImageData2D> BasisImporter::doImage2D(const UnsignedInt id, const UnsignedInt level) {
+Containers::Optional<BasisImporter::TargetFormat> BasisImporter::configuredTargetFormat(const char* const messagePrefix) {
     std::string targetFormatStr = configuration().value<std::string>("format");
-    TargetFormat targetFormat;
     if(targetFormatStr.empty()) {
         if(!_state->noTranscodeFormatWarningPrinted)
-            Warning{} << "Trade::BasisImporter::image2D(): no format to transcode to was specified, falling back to uncompressed RGBA8. To get rid of this warning either load the plugin via one of its BasisImporterEtc1RGB, ... aliases, or explicitly set the format option in plugin configuration.";
-        targetFormat = TargetFormat::RGBA8;
+            Warning{} << messagePrefix << "no format to transcode to was specified, falling back to uncompressed RGBA8. To get rid of this warning either load the plugin via one of its BasisImporterEtc1RGB, ... aliases, or explicitly set the format option in plugin configuration.";
         _state->noTranscodeFormatWarningPrinted = true;
-    } else {
-        targetFormat = configuration().value<TargetFormat>("format");
-        if(UnsignedInt(targetFormat) == ~UnsignedInt{}) {
-            Error() << "Trade::BasisImporter::image2D(): invalid transcoding target format"
-                << targetFormatStr.data() << Debug::nospace << ", expected to be one of EacR, EacRG, Etc1RGB, Etc2RGBA, Bc1RGB, Bc3RGBA, Bc4R, Bc5RG, Bc7RGB, Bc7RGBA, Pvrtc1RGB4bpp, Pvrtc1RGBA4bpp, Astc4x4RGBA, RGBA8";
-            return Containers::NullOpt;
-        }
+        return TargetFormat::RGBA8;
     }
-    const auto format = basist::transcoder_texture_format(Int(targetFormat));
 
+    const TargetFormat targetFormat = configuration().value<TargetFormat>("format");
+    if(UnsignedInt(targetFormat) == ~UnsignedInt{}) {
+        Error() << messagePrefix << "invalid transcoding target format"
+            << targetFormatStr.data() << Debug::nospace << ", expected to be one of EacR, EacRG, Etc1RGB, Etc2RGBA, Bc1RGB, Bc3RGBA, Bc4R, Bc5RG, Bc7RGB, Bc7RGBA, Pvrtc1RGB4bpp, Pvrtc1RGBA4bpp, Astc4x4RGBA, RGBA8";
+        return Containers::NullOpt;
+    }
+
+    return targetFormat;
+}
+
+void BasisImporter::levelLayout(const UnsignedInt id, const UnsignedInt level, const TargetFormat targetFormat, Vector2i& size, UnsignedInt& rowLength, UnsignedInt& rowCount, UnsignedInt& itemSize) const {
+    UnsignedInt origWidth, origHeight, totalBlocks;
+    #ifdef _BASISIMPORTER_USE_KTX2
+    if(_state->ktx2Transcoder) {
+        /* Same as below, everything was already validated on opening */
+        basist::ktx2_image_level_info info;
+        CORRADE_INTERNAL_ASSERT_OUTPUT(_state->ktx2Transcoder->get_image_level_info(info, level, id/_state->ktx2Faces, id%_state->ktx2Faces));
+        origWidth = info.m_orig_width;
+        origHeight = info.m_orig_height;
+        totalBlocks = info.m_total_blocks;
+    } else
+    #endif
+    {
     basist::basisu_image_info info;
     /* Header validation etc. is already done in doOpenData() and id is
        bounds-checked against doImage2DCount() by AbstractImporter, so by
@@ -240,44 +422,306 @@ Containers::Optional<ImageData2D> BasisImporter::doImage2D(const UnsignedInt id,
        not turning this into a graceful error. */
     CORRADE_INTERNAL_ASSERT_OUTPUT(_state->transcoder->get_image_info(_state->in.data(), _state->in.size(), info, id));
 
-    UnsignedInt origWidth, origHeight, totalBlocks;
     /* Same as above, it checks for state we already verified before. If this
        blows up for someone, we can reconsider. */
     CORRADE_INTERNAL_ASSERT_OUTPUT(_state->transcoder->get_image_level_desc(_state->in.data(), _state->in.size(), id, level, origWidth, origHeight, totalBlocks));
+    }
+
+    size = {Int(origWidth), Int(origHeight)};
+
+    /* Uncompressed data are in pixels, compressed in 4x4 blocks */
+    if(targetFormat == BasisImporter::TargetFormat::RGBA8) {
+        rowLength = origWidth;
+        rowCount = origHeight;
+        itemSize = 4;
+    } else {
+        rowLength = (origWidth + 3)/4;
+        rowCount = totalBlocks/rowLength;
+        itemSize = basis_get_bytes_per_block(basist::transcoder_texture_format(Int(targetFormat)));
+    }
+}
+
+bool BasisImporter::transcodeLevelInto(const UnsignedInt id, const UnsignedInt level, const TargetFormat targetFormat, const Containers::ArrayView<char> destination, const UnsignedInt rowPitch, const UnsignedInt rowCount, void* const transcoderState, const char* const messagePrefix) const {
+    MAGNUM_IMPORTER_PROFILE(profile, _profilingCallback, _profilingUserData, "transcode", destination.size());
 
     /* No flags used by transcode_image_level() by default */
     const std::uint32_t flags = 0;
-    if(!_state->fileInfo.m_y_flipped) {
-        /** @todo replace with the flag once the PR is submitted */
-        Warning{} << "Trade::BasisImporter::image2D(): the image was not encoded Y-flipped, imported data will have wrong orientation";
-        //flags |= basist::basisu_transcoder::cDecodeFlagsFlipY;
+
+    /* The output size and row pitch is in pixels for uncompressed data and in
+       blocks for compressed, the output row count is used only for
+       uncompressed data */
+    const bool uncompressed = targetFormat == BasisImporter::TargetFormat::RGBA8;
+    const UnsignedInt itemSize = uncompressed ? 4 : basis_get_bytes_per_block(basist::transcoder_texture_format(Int(targetFormat)));
+    #ifdef _BASISIMPORTER_USE_KTX2
+    if(_state->ktx2Transcoder) {
+        if(!_state->ktx2Transcoder->transcode_image_level(level, id/_state->ktx2Faces, id%_state->ktx2Faces, destination.data(), destination.size()/itemSize, basist::transcoder_texture_format(Int(targetFormat)), flags, rowPitch, uncompressed ? rowCount : 0, -1, -1, static_cast<basist::ktx2_transcoder_state*>(transcoderState))) {
+            Error{} << messagePrefix << "transcoding failed";
+            return false;
+        }
+
+        return true;
     }
+    #endif
 
-    Vector2i size{Int(origWidth), Int(origHeight)};
-    UnsignedInt dataSize, rowStride, outputSizeInBlocksOrPixels, outputRowsInPixels;
-    if(targetFormat == BasisImporter::TargetFormat::RGBA8) {
-        rowStride = size.x();
-        outputRowsInPixels = size.y();
-        outputSizeInBlocksOrPixels = size.product();
-        dataSize = 4*outputSizeInBlocksOrPixels;
-    } else {
-        rowStride = 0; /* left up to Basis to calculate */
-        outputRowsInPixels = 0; /* not used for compressed data */
-        outputSizeInBlocksOrPixels = totalBlocks;
-        dataSize = basis_get_bytes_per_block(format)*totalBlocks;
-    }
-    Containers::Array<char> dest{Containers::DefaultInit, dataSize};
-    if(!_state->transcoder->transcode_image_level(_state->in.data(), _state->in.size(), id, level, dest.data(), outputSizeInBlocksOrPixels, basist::transcoder_texture_format(format), flags, rowStride, nullptr, outputRowsInPixels)) {
-        Error{} << "Trade::BasisImporter::image2D(): transcoding failed";
-        return Containers::NullOpt;
+    if(!_state->transcoder->transcode_image_level(_state->in.data(), _state->in.size(), id, level, destination.data(), destination.size()/itemSize, basist::transcoder_texture_format(Int(targetFormat)), flags, rowPitch, static_cast<basist::basisu_transcoder_state*>(transcoderState), uncompressed ? rowCount : 0)) {
+        Error{} << messagePrefix << "transcoding failed";
+        return false;
     }
 
+    return true;
+}
+
+Containers::Optional<ImageData2D> BasisImporter::transcodeLevel(const UnsignedInt id, const UnsignedInt level, const TargetFormat targetFormat, void* const transcoderState, const char* const messagePrefix) const {
+    Vector2i size;
+    UnsignedInt rowLength, rowCount, itemSize;
+    levelLayout(id, level, targetFormat, size, rowLength, rowCount, itemSize);
+
+    /* The transcoder overwrites the whole output, no need to zero-init it */
+    Containers::Array<char> dest{Containers::NoInit, std::size_t(itemSize)*rowLength*rowCount};
+    if(!transcodeLevelInto(id, level, targetFormat, dest, rowLength, rowCount, transcoderState, messagePrefix))
+        return Containers::NullOpt;
+
     if(targetFormat == BasisImporter::TargetFormat::RGBA8)
         return Trade::ImageData2D{PixelFormat::RGBA8Unorm, size, std::move(dest)};
     else
         return Trade::ImageData2D{compressedPixelFormat(targetFormat), size, std::move(dest)};
 }
 
+Containers::Optional<ImageData2D> BasisImporter::doImage2D(const UnsignedInt id, const UnsignedInt level) {
+    const Containers::Optional<TargetFormat> targetFormat = configuredTargetFormat("Trade::BasisImporter::image2D():");
+    if(!targetFormat) return Containers::NullOpt;
+
+    if(!_state->fileInfo.m_y_flipped) {
+        /** @todo replace with the flag once the PR is submitted */
+        Warning{} << "Trade::BasisImporter::image2D(): the image was not encoded Y-flipped, imported data will have wrong orientation";
+        //flags |= basist::basisu_transcoder::cDecodeFlagsFlipY;
+    }
+
+    return transcodeLevel(id, level, *targetFormat, nullptr, "Trade::BasisImporter::image2D():");
+}
+
+Containers::Array<Containers::Optional<ImageData2D>> BasisImporter::images2D() {
+    CORRADE_ASSERT(isOpened(), "Trade::BasisImporter::images2D(): no file opened", {});
+
+    /* Flatten all levels of all images into a single list of jobs */
+    std::size_t jobCount = 0;
+    for(UnsignedInt id = 0; id != _state->fileInfo.m_total_images; ++id)
+        jobCount += _state->fileInfo.m_image_mipmap_levels[id];
+    Containers::Array<std::pair<UnsignedInt, UnsignedInt>> jobs{Containers::NoInit, jobCount};
+    {
+        std::size_t i = 0;
+        for(UnsignedInt id = 0; id != _state->fileInfo.m_total_images; ++id)
+            for(UnsignedInt level = 0; level != _state->fileInfo.m_image_mipmap_levels[id]; ++level)
+                jobs[i++] = {id, level};
+    }
+
+    Containers::Array<Containers::Optional<ImageData2D>> out{jobs.size()};
+
+    const Containers::Optional<TargetFormat> targetFormat = configuredTargetFormat("Trade::BasisImporter::images2D():");
+    if(!targetFormat) return out;
+
+    if(!_state->fileInfo.m_y_flipped)
+        Warning{} << "Trade::BasisImporter::images2D(): the images were not encoded Y-flipped, imported data will have wrong orientation";
+
+    /* Each thread takes the next level that's not transcoded yet. The
+       transcoder itself is thread-safe as long as each thread has its own
+       transcoder state. */
+    std::atomic<std::size_t> next{0};
+    auto transcodeLevels = [&]() {
+        basist::basisu_transcoder_state basisTranscoderState;
+        void* transcoderState = &basisTranscoderState;
+        #ifdef _BASISIMPORTER_USE_KTX2
+        basist::ktx2_transcoder_state ktx2TranscoderState;
+        if(_state->ktx2Transcoder) transcoderState = &ktx2TranscoderState;
+        #endif
+        std::size_t i;
+        while((i = next++) < jobs.size())
+            out[i] = transcodeLevel(jobs[i].first, jobs[i].second, *targetFormat, transcoderState, "Trade::BasisImporter::images2D():");
+    };
+
+    UnsignedInt threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount) threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    Containers::Array<std::thread> threads{jobs.empty() ? 0 : std::min(std::size_t{threadCount}, jobs.size()) - 1};
+    for(std::thread& thread: threads) thread = std::thread{transcodeLevels};
+    transcodeLevels();
+    for(std::thread& thread: threads) thread.join();
+
+    return out;
+}
+
+std::size_t BasisImporter::image2DDataSize(const UnsignedInt id, const UnsignedInt level, const std::size_t rowPitch) {
+    CORRADE_ASSERT(isOpened(), "Trade::BasisImporter::image2DDataSize(): no file opened", {});
+    CORRADE_ASSERT(id < doImage2DCount() && level < doImage2DLevelCount(id),
+        "Trade::BasisImporter::image2DDataSize(): level" << level << "of image" << id << "out of range", {});
+
+    const Containers::Optional<TargetFormat> targetFormat = configuredTargetFormat("Trade::BasisImporter::image2DDataSize():");
+    if(!targetFormat) return 0;
+
+    Vector2i size;
+    UnsignedInt rowLength, rowCount, itemSize;
+    levelLayout(id, level, *targetFormat, size, rowLength, rowCount, itemSize);
+    return (rowPitch ? rowPitch : std::size_t(itemSize)*rowLength)*rowCount;
+}
+
+bool BasisImporter::image2DInto(const UnsignedInt id, const UnsignedInt level, const Containers::ArrayView<char> destination, const std::size_t rowPitch) {
+    CORRADE_ASSERT(isOpened(), "Trade::BasisImporter::image2DInto(): no file opened", {});
+    CORRADE_ASSERT(id < doImage2DCount() && level < doImage2DLevelCount(id),
+        "Trade::BasisImporter::image2DInto(): level" << level << "of image" << id << "out of range", {});
+
+    const Containers::Optional<TargetFormat> targetFormat = configuredTargetFormat("Trade::BasisImporter::image2DInto():");
+    if(!targetFormat) return false;
+
+    if(!_state->fileInfo.m_y_flipped)
+        Warning{} << "Trade::BasisImporter::image2DInto(): the image was not encoded Y-flipped, imported data will have wrong orientation";
+
+    Vector2i size;
+    UnsignedInt rowLength, rowCount, itemSize;
+    levelLayout(id, level, *targetFormat, size, rowLength, rowCount, itemSize);
+
+    /* Basis expects the pitch in pixels or blocks, not bytes. PVRTC data
+       are swizzled and thus can't have any padding between rows. */
+    const std::size_t tightRowPitch = std::size_t(itemSize)*rowLength;
+    const std::size_t actualRowPitch = rowPitch ? rowPitch : tightRowPitch;
+    if(actualRowPitch < tightRowPitch || actualRowPitch % itemSize) {
+        Error{} << "Trade::BasisImporter::image2DInto(): row pitch" << actualRowPitch << "is not a multiple of" << itemSize << "or is smaller than" << tightRowPitch;
+        return false;
+    }
+    if(actualRowPitch != tightRowPitch && (*targetFormat == TargetFormat::PvrtcRGB4bpp || *targetFormat == TargetFormat::PvrtcRGBA4bpp)) {
+        Error{} << "Trade::BasisImporter::image2DInto(): row padding is not supported for PVRTC formats";
+        return false;
+    }
+    if(destination.size() < actualRowPitch*rowCount) {
+        Error{} << "Trade::BasisImporter::image2DInto(): expected a destination of at least" << actualRowPitch*rowCount << "bytes but got" << destination.size();
+        return false;
+    }
+
+    return transcodeLevelInto(id, level, *targetFormat, destination.prefix(actualRowPitch*rowCount), actualRowPitch/itemSize, rowCount, nullptr, "Trade::BasisImporter::image2DInto():");
+}
+
+bool BasisImporter::image2DRegionInto(const UnsignedInt id, const UnsignedInt level, const Range2Di& region, const Containers::ArrayView<char> destination, const std::size_t rowPitch) {
+    CORRADE_ASSERT(isOpened(), "Trade::BasisImporter::image2DRegionInto(): no file opened", {});
+    CORRADE_ASSERT(id < doImage2DCount() && level < doImage2DLevelCount(id),
+        "Trade::BasisImporter::image2DRegionInto(): level" << level << "of image" << id << "out of range", {});
+
+    const Containers::Optional<TargetFormat> targetFormat = configuredTargetFormat("Trade::BasisImporter::image2DRegionInto():");
+    if(!targetFormat) return false;
+
+    /* PVRTC blocks depend on their neighbors and are swizzled, so a region
+       can't be extracted from them */
+    if(*targetFormat == TargetFormat::PvrtcRGB4bpp || *targetFormat == TargetFormat::PvrtcRGBA4bpp) {
+        Error{} << "Trade::BasisImporter::image2DRegionInto(): PVRTC formats are not supported";
+        return false;
+    }
+
+    Vector2i size;
+    UnsignedInt rowLength, rowCount, itemSize;
+    levelLayout(id, level, *targetFormat, size, rowLength, rowCount, itemSize);
+
+    const Vector2i levelSize{Int(rowLength), Int(rowCount)};
+    if((region.min() < Vector2i{0}).any() || (region.max() > levelSize).any() || (region.min() > region.max()).any()) {
+        Error{} << "Trade::BasisImporter::image2DRegionInto(): region" << region << "out of range for a level of" << levelSize << (*targetFormat == TargetFormat::RGBA8 ? "pixels" : "blocks");
+        return false;
+    }
+
+    const std::size_t tightRowPitch = std::size_t(itemSize)*region.sizeX();
+    const std::size_t actualRowPitch = rowPitch ? rowPitch : tightRowPitch;
+    if(actualRowPitch < tightRowPitch || actualRowPitch % itemSize) {
+        Error{} << "Trade::BasisImporter::image2DRegionInto(): row pitch" << actualRowPitch << "is not a multiple of" << itemSize << "or is smaller than" << tightRowPitch;
+        return false;
+    }
+    if(destination.size() < actualRowPitch*region.sizeY()) {
+        Error{} << "Trade::BasisImporter::image2DRegionInto(): expected a destination of at least" << actualRowPitch*region.sizeY() << "bytes but got" << destination.size();
+        return false;
+    }
+
+    /* Nothing to do for an empty region, don't transcode anything */
+    if(!region.sizeX() || !region.sizeY()) return true;
+
+    /* Transcode the whole level if it's not cached already. The flip
+       warning is printed only when transcoding to avoid spamming the output
+       for each region. */
+    State& state = *_state;
+    if(!state.region.data || state.region.id != id || state.region.level != level || state.region.format != *targetFormat) {
+        if(!state.fileInfo.m_y_flipped)
+            Warning{} << "Trade::BasisImporter::image2DRegionInto(): the image was not encoded Y-flipped, imported data will have wrong orientation";
+
+        state.region.data = Containers::Array<char>{Containers::NoInit, std::size_t(itemSize)*rowLength*rowCount};
+        if(!transcodeLevelInto(id, level, *targetFormat, state.region.data, rowLength, rowCount, nullptr, "Trade::BasisImporter::image2DRegionInto():")) {
+            state.region.data = nullptr;
+            return false;
+        }
+
+        state.region.id = id;
+        state.region.level = level;
+        state.region.format = *targetFormat;
+        state.region.rowLength = rowLength;
+    }
+
+    /* Copy the region out row by row */
+    const std::size_t levelRowPitch = std::size_t(itemSize)*state.region.rowLength;
+    for(Int y = 0; y != region.sizeY(); ++y)
+        std::memcpy(destination.data() + y*actualRowPitch,
+            state.region.data.data() + (region.min().y() + y)*levelRowPitch + region.min().x()*itemSize,
+            tightRowPitch);
+
+    return true;
+}
+
+bool BasisImporter::isKtx2() const {
+    CORRADE_ASSERT(_state->in, "Trade::BasisImporter::isKtx2(): no file opened", {});
+    #ifdef _BASISIMPORTER_USE_KTX2
+    return !!_state->ktx2Transcoder;
+    #else
+    return false;
+    #endif
+}
+
+std::pair<std::size_t, std::size_t> BasisImporter::ktx2LevelDataRange(const UnsignedInt level) const {
+    CORRADE_ASSERT(_state->in, "Trade::BasisImporter::ktx2LevelDataRange(): no file opened", {});
+    #ifdef _BASISIMPORTER_USE_KTX2
+    CORRADE_ASSERT(_state->ktx2Transcoder, "Trade::BasisImporter::ktx2LevelDataRange(): the opened file is not a KTX2 file", {});
+    const auto& levelIndex = _state->ktx2Transcoder->get_level_index();
+    CORRADE_ASSERT(level < levelIndex.size(),
+        "Trade::BasisImporter::ktx2LevelDataRange(): level" << level << "out of range for" << levelIndex.size() << "levels", {});
+    return {std::size_t(levelIndex[level].m_byte_offset),
+            std::size_t(levelIndex[level].m_byte_length)};
+    #else
+    static_cast<void>(level);
+    CORRADE_ASSERT_UNREACHABLE("Trade::BasisImporter::ktx2LevelDataRange(): the opened file is not a KTX2 file", {});
+    #endif
+}
+
+bool BasisImporter::hasAlpha() const {
+    CORRADE_ASSERT(_state->in, "Trade::BasisImporter::hasAlpha(): no file opened", {});
+    return _state->fileInfo.m_has_alpha_slices;
+}
+
+BasisImporter::TargetFormat BasisImporter::chooseTargetFormat(const Containers::ArrayView<const CompressedPixelFormat> supportedFormats) const {
+    /* If nothing is opened, assume there's alpha so nothing gets lost */
+    constexpr TargetFormat Alpha[]{
+        TargetFormat::Astc4x4RGBA,
+        TargetFormat::Bc7RGBA,
+        TargetFormat::Bc3RGBA,
+        TargetFormat::Etc2RGBA,
+        TargetFormat::PvrtcRGBA4bpp
+    };
+    constexpr TargetFormat NoAlpha[]{
+        TargetFormat::Astc4x4RGBA,
+        TargetFormat::Bc7RGB,
+        TargetFormat::Bc1RGB,
+        TargetFormat::Etc1RGB,
+        TargetFormat::PvrtcRGB4bpp
+    };
+    const bool alpha = !_state->in || _state->fileInfo.m_has_alpha_slices;
+    for(const TargetFormat candidate: alpha ? Containers::arrayView(Alpha) : Containers::arrayView(NoAlpha)) {
+        const CompressedPixelFormat format = compressedPixelFormat(candidate);
+        for(const CompressedPixelFormat supported: supportedFormats)
+            if(supported == format) return candidate;
+    }
+
+    return TargetFormat::RGBA8;
+}
+
 void BasisImporter::setTargetFormat(TargetFormat format) {
     configuration().setValue("format", format);
 }
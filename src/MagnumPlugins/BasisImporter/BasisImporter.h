@@ -31,6 +31,7 @@
 * @m_since_{plugins,2019,10}
 */
 
+#include <utility>
 #include <Magnum/Trade/AbstractImporter.h>
 
 #include "MagnumPlugins/BasisImporter/configure.h"
@@ -62,8 +63,9 @@ namespace Magnum { namespace Trade {
 @m_keywords{BasisImporterRGBA8}
 
 Supports [Basis Universal](https://github.com/binomialLLC/basis_universal)
-(`*.basis`) compressed images by parsing and transcoding files into an
-explicitly specified GPU format (see @ref Trade-BasisImporter-target-format).
+(`*.basis`) compressed images and [KTX2](https://github.khronos.org/KTX-Specification/)
+(`*.ktx2`) files with Basis Universal ETC1S or UASTC payloads by parsing and
+transcoding files into an explicitly specified GPU format (see @ref Trade-BasisImporter-target-format).
 You can use @ref BasisImageConverter to transcode images into this format.
 
 This plugin provides `BasisImporterEacR`, `BasisImporterEacRG`,
@@ -118,6 +120,89 @@ target_link_libraries(your-app PRIVATE MagnumPlugins::BasisImporter)
 See @ref building-plugins, @ref cmake-plugins, @ref plugins and
 @ref file-formats for more information.
 
+@section Trade-BasisImporter-behavior Behavior and limitations
+
+Files passed to @ref openFile() are memory-mapped on platforms that support
+it, data passed to @ref openData() are copied. Transcoding only reads from the
+input, so if the data are already in memory for the whole lifetime of the
+importer --- for example as a part of a memory-mapped archive --- they can be
+passed to @ref openMemory(), which references them directly without any copy.
+
+All levels of all images can be transcoded at once using @ref images2D(). If
+the @cb{.ini} threads @ce
+@ref Trade-BasisImporter-configuration "configuration option" is set to a
+value other than @cpp 1 @ce, the levels are transcoded in parallel. In that
+case the application needs to link to `pthread` on Linux due to the same
+reasons as described in @ref Trade-BasisImageConverter-loading "BasisImageConverter docs".
+
+To avoid an extra allocation and copy when uploading the data, a level can be
+also transcoded directly into a caller-provided memory with
+@ref image2DInto(), with an arbitrary row pitch that matches for example
+alignment requirements of a GPU staging buffer. The required memory size is
+returned by @ref image2DDataSize().
+
+For virtual texturing and other cases where only a small part of a large
+image is needed at a time, @ref image2DRegionInto() copies just a
+block-aligned rectangle out of a level. Because the format doesn't allow
+decoding blocks independently, the whole level is transcoded on the first
+request and cached, so further regions of the same level are only a copy.
+
+@subsection Trade-BasisImporter-behavior-ktx2 KTX2 files
+
+Files starting with the KTX2 file identifier are opened as KTX2, everything
+else is treated as a `*.basis` file. Use @ref isKtx2() to check which one was
+opened. KTX2 support requires Basis Universal 1.13 or newer, with older
+versions the KTX2 files fail to open. Array layers and cube map faces are
+exposed as separate 2D images, ID of an image being
+@cpp layer*faceCount + face @ce, with each image having all levels of the
+file. Textures with depth are not supported. Levels that use Zstandard
+supercompression require the transcoder to be built with
+`BASISD_SUPPORT_KTX2_ZSTD` --- the bundled @ref FindBasisUniversal.cmake
+"find module" enables it if the `zstd/zstd.c` file is present in the Basis
+Universal sources. Otherwise such files fail to open with an error. The
+Y-flip warning described below is not printed only if the file contains a
+`KTXorientation` key with the Y axis pointing up.
+
+Unlike `*.basis` files, KTX2 files have a level index at a fixed location
+after the header, and data of each level are stored contiguously. Use
+@ref ktx2LevelDataRange() to get a byte range of a particular level in the
+file. A streaming client can thus fetch just the header, the metadata, the
+level index and levels it's interested in with HTTP range requests, put them
+at their original offsets into a buffer of the full file size and pass that to
+@ref openMemory(). Only the levels that are actually transcoded need to be
+filled in.
+
+@subsection Trade-BasisImporter-behavior-state Transcoder state
+
+The global transcoder tables and the selector codebook are created when the
+first file is opened and then shared read-only by all instances, so merely
+loading the plugin or constructing a plugin manager doesn't pay for them. Per-instance state is thus limited to the
+transcoder of the currently opened file, which makes it cheap to create many
+short-lived importer instances, even from multiple threads at once.
+
+@section Trade-BasisImporter-profiling Profiling
+
+If the plugin is built with `WITH_IMPORTER_PROFILING` enabled, it measures
+the duration of individual import stages and reports them to a callback set
+with @ref setProfilingCallback(), together with the amount of data each stage
+processed. The stages are:
+
+-   `copy` --- copying the data passed to @ref openData(), with the input size
+-   `open` --- validating the header and preparing the transcoder, with the
+    input size
+-   `transcode` --- transcoding a single image level to the target format in
+    @ref image2D(), @ref images2D(), @ref image2DInto() or
+    @ref image2DRegionInto(), with the output size
+
+With @ref images2D() and the @cb{.ini} threads @ce option set to a value other
+than @cpp 1 @ce, the `transcode` stage gets reported from multiple threads at
+the same time.
+
+Without `WITH_IMPORTER_PROFILING` the measurement is compiled out and the
+callback is never called. If it's enabled, the
+@cpp MAGNUM_BASISIMPORTER_WITH_PROFILING @ce macro is defined in the
+`MagnumPlugins/BasisImporter/configure.h` header.
+
 @section Trade-BasisImporter-configuration Plugin-specific configuration
 
 Basis allows configuration of the format of loaded compressed data.
@@ -149,6 +234,15 @@ OpenGL, OpenGL ES and WebGL extensions, in its full ugly glory:
 
 @snippet BasisImporter.cpp gl-extension-checks
 
+Alternatively, once a file is opened, the decision can be left on
+@ref chooseTargetFormat(), which picks the best format out of a list of
+@ref CompressedPixelFormat values supported by the GPU, preferring formats
+without alpha if the file has no alpha channel. Unlike the above, it doesn't
+silently fall back to @ref TargetFormat::RGBA8 --- the caller can check the
+returned value and react accordingly:
+
+@snippet BasisImporter.cpp choose-target-format
+
 <b></b>
 
 @m_class{m-block m-warning}
@@ -269,15 +363,6 @@ class MAGNUM_BASISIMPORTER_EXPORT BasisImporter: public AbstractImporter {
             EacRG = 21,
         };
 
-        /**
-         * @brief Initialize Basis transcoder
-         *
-         * If the class is instantiated directly (not through a plugin
-         * manager), this function has to be called explicitly before using
-         * any instance.
-         */
-        static void initialize();
-
         /** @brief Default constructor */
         explicit BasisImporter();
 
@@ -296,19 +381,195 @@ class MAGNUM_BASISIMPORTER_EXPORT BasisImporter: public AbstractImporter {
         */
         void setTargetFormat(TargetFormat format);
 
+        /**
+         * @brief Whether the opened file has alpha
+         * @m_since_latest_{plugins}
+         *
+         * Returns @cpp true @ce if the file contains alpha slices. Used by
+         * @ref chooseTargetFormat() to pick between formats with and without
+         * alpha. Expects that a file is opened.
+         */
+        virtual bool hasAlpha() const;
+
+        /**
+         * @brief Whether the opened file is a KTX2 file
+         * @m_since_latest_{plugins}
+         *
+         * Returns @cpp true @ce if the file was opened as a KTX2 file,
+         * @cpp false @ce if it's a `*.basis` file. Expects that a file is
+         * opened.
+         * @see @ref Trade-BasisImporter-behavior-ktx2
+         */
+        virtual bool isKtx2() const;
+
+        /**
+         * @brief Byte range of a KTX2 level
+         * @m_since_latest_{plugins}
+         *
+         * Returns offset and size of data of given @p level from the level
+         * index of the file, shared by all layers and faces. For
+         * supercompressed files it's the compressed size. Expects that a KTX2
+         * file is opened and @p level is less than
+         * @ref image2DLevelCount().
+         * @see @ref isKtx2(), @ref Trade-BasisImporter-behavior-ktx2
+         */
+        virtual std::pair<std::size_t, std::size_t> ktx2LevelDataRange(UnsignedInt level) const;
+
+        /**
+         * @brief Choose the best target format out of supported formats
+         * @m_since_latest_{plugins}
+         *
+         * Picks the highest-quality @ref TargetFormat whose corresponding
+         * @ref CompressedPixelFormat is in @p supportedFormats, for example
+         * formats for which the GPU exposes corresponding extensions. If a
+         * file is opened and @ref hasAlpha() is @cpp false @ce, formats
+         * without alpha are preferred, in the following order:
+         * @ref TargetFormat::Astc4x4RGBA, @ref TargetFormat::Bc7RGB,
+         * @ref TargetFormat::Bc1RGB, @ref TargetFormat::Etc1RGB and
+         * @ref TargetFormat::PvrtcRGB4bpp. Otherwise the order is
+         * @ref TargetFormat::Astc4x4RGBA, @ref TargetFormat::Bc7RGBA,
+         * @ref TargetFormat::Bc3RGBA, @ref TargetFormat::Etc2RGBA and
+         * @ref TargetFormat::PvrtcRGBA4bpp. If none of these is supported,
+         * returns @ref TargetFormat::RGBA8 --- compare the result to it if
+         * the uncompressed fallback is not desired. Note that PVRTC formats
+         * are supported only for square power-of-two images. The format is
+         * only returned, pass it to @ref setTargetFormat() to use it.
+         * @see @ref Trade-BasisImporter-target-format
+         */
+        virtual TargetFormat chooseTargetFormat(Containers::ArrayView<const CompressedPixelFormat> supportedFormats) const;
+
+        /**
+         * @brief Open raw data without making a copy
+         * @m_since_latest_{plugins}
+         *
+         * Compared to @ref openData(), the importer references @p data
+         * directly instead of making a copy, which means the memory has to
+         * stay valid and unchanged until the importer is closed or another
+         * file is opened. Useful for transcoding files embedded in
+         * memory-mapped archives in place. Closes previous file, if it was
+         * opened, and tries to open given memory. Returns @cpp true @ce on
+         * success, @cpp false @ce otherwise.
+         */
+        virtual bool openMemory(Containers::ArrayView<const char> data);
+
+        /**
+         * @brief Transcode all levels of all images
+         * @m_since_latest_{plugins}
+         *
+         * Equivalent to calling @ref image2D() for all levels of all images,
+         * but the levels are transcoded on the number of threads given by the
+         * @cb{.ini} threads @ce
+         * @ref Trade-BasisImporter-configuration "configuration option". The
+         * returned array contains all levels of the first image, followed by
+         * all levels of the second image and so on, with level count of each
+         * image given by @ref image2DLevelCount(). Levels that failed to
+         * transcode are @ref Containers::NullOpt. Note that messages printed
+         * from other threads don't go through output redirection set up on
+         * the calling thread. Expects that a file is opened.
+         */
+        virtual Containers::Array<Containers::Optional<ImageData2D>> images2D();
+
+        /**
+         * @brief Size of a transcoded image level
+         * @m_since_latest_{plugins}
+         *
+         * Size in bytes that a destination passed to @ref image2DInto() needs
+         * to have for given @p id, @p level and @p rowPitch. If @p rowPitch
+         * is @cpp 0 @ce, rows are assumed to be tightly packed. A row is a
+         * row of pixels for @ref TargetFormat::RGBA8 and a row of 4x4 blocks
+         * for compressed formats. Expects that a file is opened and @p id and
+         * @p level are in range. If the configured target format is invalid,
+         * prints a message to @ref Error and returns @cpp 0 @ce.
+         */
+        virtual std::size_t image2DDataSize(UnsignedInt id, UnsignedInt level, std::size_t rowPitch = 0);
+
+        /**
+         * @brief Transcode an image level into a caller-provided buffer
+         * @m_since_latest_{plugins}
+         *
+         * Like @ref image2D(), but instead of allocating a new image the data
+         * are transcoded directly to @p destination, for example a mapped GPU
+         * staging buffer, with rows being @p rowPitch bytes apart. If
+         * @p rowPitch is @cpp 0 @ce, the rows are tightly packed. Format of
+         * the data is given by the configured target format, use
+         * @ref image2DDataSize() to query the required destination size.
+         *
+         * Expects that a file is opened and @p id and @p level are in range.
+         * If the row pitch isn't a multiple of pixel or block size, is
+         * smaller than a row or is padded for a PVRTC format, if
+         * @p destination is too small or if the transcoding fails, prints a
+         * message to @ref Error and returns @cpp false @ce.
+         */
+        virtual bool image2DInto(UnsignedInt id, UnsignedInt level, Containers::ArrayView<char> destination, std::size_t rowPitch = 0);
+
+        /**
+         * @brief Transcode a region of an image level into a caller-provided buffer
+         * @m_since_latest_{plugins}
+         *
+         * Like @ref image2DInto(), but copies only given @p region of the
+         * level to @p destination, with rows being @p rowPitch bytes apart.
+         * The region is in pixels for @ref TargetFormat::RGBA8 and in 4x4
+         * blocks for compressed formats. If @p rowPitch is @cpp 0 @ce, the
+         * rows are tightly packed, the destination needs to be at least
+         * row pitch multiplied by region height large.
+         *
+         * Basis data are entropy-coded, so the level is always transcoded
+         * as a whole. The result is kept in the importer and subsequent
+         * calls for the same level and target format only copy the region
+         * out of it, until a different level or format is requested or the
+         * file is closed. Not thread-safe.
+         *
+         * Expects that a file is opened and @p id and @p level are in range.
+         * If the target format is a PVRTC format, which doesn't have
+         * independent blocks, if the region is out of bounds of the level, if
+         * the row pitch isn't a multiple of pixel or block size or is smaller
+         * than a region row, if @p destination is too small or if the
+         * transcoding fails, prints a message to @ref Error and returns
+         * @cpp false @ce.
+         * @see @ref Trade-BasisImporter-behavior
+         */
+        virtual bool image2DRegionInto(UnsignedInt id, UnsignedInt level, const Range2Di& region, Containers::ArrayView<char> destination, std::size_t rowPitch = 0);
+
+        /**
+         * @brief Set profiling callback
+         * @m_since_latest_{plugins}
+         *
+         * The @p callback is called at the end of each import stage with the
+         * stage name, its duration in nanoseconds, count of bytes it
+         * processed or @cpp 0 @ce if not applicable, and @p userData. The
+         * callback is kept across opened files, pass @cpp nullptr @ce to
+         * reset it. Doesn't need any file to be opened. If the plugin isn't
+         * built with `WITH_IMPORTER_PROFILING`, the callback is never
+         * called. See @ref Trade-BasisImporter-profiling for more
+         * information.
+         */
+        virtual void setProfilingCallback(void(*callback)(const char* stage, UnsignedLong nanoseconds, std::size_t byteCount, void* userData), void* userData = nullptr);
+
     private:
         struct State;
 
         MAGNUM_BASISIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_BASISIMPORTER_LOCAL bool doIsOpened() const override;
         MAGNUM_BASISIMPORTER_LOCAL void doClose() override;
+        MAGNUM_BASISIMPORTER_LOCAL void doOpenFile(const std::string& filename) override;
         MAGNUM_BASISIMPORTER_LOCAL void doOpenData(Containers::ArrayView<const char> data) override;
+        MAGNUM_BASISIMPORTER_LOCAL bool openDataInternal(Containers::ArrayView<const char> data, const char* messagePrefix);
+        MAGNUM_BASISIMPORTER_LOCAL bool openKtx2Internal(Containers::ArrayView<const char> data, const char* messagePrefix);
+        MAGNUM_BASISIMPORTER_LOCAL Containers::Optional<TargetFormat> configuredTargetFormat(const char* messagePrefix);
+        /* The state is a basist::basisu_transcoder_state or a
+           basist::ktx2_transcoder_state for KTX2 files, void* to avoid
+           including the Basis headers here */
+        MAGNUM_BASISIMPORTER_LOCAL void levelLayout(UnsignedInt id, UnsignedInt level, TargetFormat targetFormat, Vector2i& size, UnsignedInt& rowLength, UnsignedInt& rowCount, UnsignedInt& itemSize) const;
+        MAGNUM_BASISIMPORTER_LOCAL bool transcodeLevelInto(UnsignedInt id, UnsignedInt level, TargetFormat targetFormat, Containers::ArrayView<char> destination, UnsignedInt rowPitch, UnsignedInt rowCount, void* transcoderState, const char* messagePrefix) const;
+        MAGNUM_BASISIMPORTER_LOCAL Containers::Optional<ImageData2D> transcodeLevel(UnsignedInt id, UnsignedInt level, TargetFormat targetFormat, void* transcoderState, const char* messagePrefix) const;
 
         MAGNUM_BASISIMPORTER_LOCAL UnsignedInt doImage2DCount() const override;
         MAGNUM_BASISIMPORTER_LOCAL UnsignedInt doImage2DLevelCount(UnsignedInt id) override;
         MAGNUM_BASISIMPORTER_LOCAL Containers::Optional<ImageData2D> doImage2D(UnsignedInt id, UnsignedInt level) override;
 
         Containers::Pointer<State> _state;
+        void(*_profilingCallback)(const char*, UnsignedLong, std::size_t, void*){};
+        void* _profilingUserData{};
 };
 
 }}
@@ -25,9 +25,11 @@
 */
 
 #include <sstream>
+#include <thread>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Corrade/Utility/Directory.h>
@@ -35,9 +37,12 @@
 #include <Magnum/PixelFormat.h>
 #include <Magnum/DebugTools/CompareImage.h>
 #include <Magnum/Math/Color.h>
+#include <Magnum/Math/Range.h>
 #include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "MagnumPlugins/BasisImporter/BasisImporter.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Trade { namespace Test { namespace {
@@ -51,6 +56,7 @@ struct BasisImporterTest: TestSuite::Tester {
     void invalidConfiguredFormat();
     void fileTooShort();
     void transcodingFailure();
+    void ktx2Invalid();
 
     void rgbUncompressed();
     void rgbUncompressedNoFlip();
@@ -62,6 +68,15 @@ struct BasisImporterTest: TestSuite::Tester {
 
     void openSameTwice();
     void openDifferent();
+    void openMemory();
+    void openMultipleInstancesThreads();
+    void openMemoryInvalid();
+    void images2DThreads();
+    void image2DInto();
+    void image2DIntoInvalid();
+    void image2DRegionInto();
+    void image2DRegionIntoInvalid();
+    void chooseTargetFormat();
     void importMultipleFormats();
 
     /* Needs to load AnyImageImporter from system-wide location */
@@ -108,6 +123,7 @@ BasisImporterTest::BasisImporterTest() {
               &BasisImporterTest::invalidConfiguredFormat,
               &BasisImporterTest::fileTooShort,
               &BasisImporterTest::transcodingFailure,
+              &BasisImporterTest::ktx2Invalid,
 
               &BasisImporterTest::rgbUncompressed,
               &BasisImporterTest::rgbUncompressedNoFlip,
@@ -120,6 +136,15 @@ BasisImporterTest::BasisImporterTest() {
 
     addTests({&BasisImporterTest::openSameTwice,
               &BasisImporterTest::openDifferent,
+              &BasisImporterTest::openMemory,
+              &BasisImporterTest::openMultipleInstancesThreads,
+              &BasisImporterTest::openMemoryInvalid,
+              &BasisImporterTest::images2DThreads,
+              &BasisImporterTest::image2DInto,
+              &BasisImporterTest::image2DIntoInvalid,
+              &BasisImporterTest::image2DRegionInto,
+              &BasisImporterTest::image2DRegionIntoInvalid,
+              &BasisImporterTest::chooseTargetFormat,
               &BasisImporterTest::importMultipleFormats});
 
     /* Pull in the AnyImageImporter dependency for image comparison, load
@@ -235,6 +260,26 @@ void BasisImporterTest::transcodingFailure() {
     CORRADE_COMPARE(out.str(), "Trade::BasisImporter::image2D(): transcoding failed\n");
 }
 
+void BasisImporterTest::ktx2Invalid() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporter");
+
+    /* A valid KTX2 identifier followed by a truncated header */
+    const char data[]{'\xab', 'K', 'T', 'X', ' ', '2', '0', '\xbb', '\r', '\n', '\x1a', '\n', 0, 0, 0, 0};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->openData(data));
+    /* The message depends on whether the Basis version supports KTX2 */
+    CORRADE_VERIFY(
+        out.str() == "Trade::BasisImporter::openData(): invalid KTX2 header\n" ||
+        out.str() == "Trade::BasisImporter::openData(): KTX2 files are not supported by this Basis Universal version\n");
+
+    /* A *.basis file is not detected as KTX2 */
+    CORRADE_VERIFY(importer->openFile(
+        Utility::Directory::join(BASISIMPORTER_TEST_DIR, "rgb.basis")));
+    CORRADE_VERIFY(!static_cast<BasisImporter&>(*importer).isKtx2());
+}
+
 void BasisImporterTest::rgbUncompressed() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporterRGBA8");
     CORRADE_VERIFY(importer);
@@ -486,6 +531,286 @@ void BasisImporterTest::openDifferent() {
     CORRADE_COMPARE(image->size(), (Vector2i{27, 63}));
 }
 
+void BasisImporterTest::openMemory() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporterEtc2RGBA");
+    Containers::Array<char> data = Utility::Directory::read(Utility::Directory::join(BASISIMPORTER_TEST_DIR, "rgba-2images-mips.basis"));
+    CORRADE_VERIFY(data);
+    CORRADE_VERIFY(static_cast<BasisImporter&>(*importer).openMemory(data));
+    CORRADE_COMPARE(importer->image2DCount(), 2);
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(1);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->compressedFormat(), CompressedPixelFormat::Etc2RGBA8Unorm);
+    CORRADE_COMPARE(image->size(), (Vector2i{27, 63}));
+
+    /* The result should be the same as with the data copied */
+    CORRADE_VERIFY(importer->openData(data));
+    Containers::Optional<Trade::ImageData2D> imageCopied = importer->image2D(1);
+    CORRADE_VERIFY(imageCopied);
+    CORRADE_COMPARE_AS(imageCopied->data(), image->data(),
+        TestSuite::Compare::Container);
+}
+
+void BasisImporterTest::openMultipleInstancesThreads() {
+    Containers::Optional<Trade::ImageData2D> expected;
+    {
+        Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporterEtc2RGBA");
+        CORRADE_VERIFY(importer->openFile(
+            Utility::Directory::join(BASISIMPORTER_TEST_DIR, "rgba-2images-mips.basis")));
+        expected = importer->image2D(1);
+        CORRADE_VERIFY(expected);
+    }
+
+    /* The plugin manager isn't thread-safe, so instantiate upfront. The
+       instances share the selector codebook, opening and transcoding on all
+       of them at the same time should give the same result. */
+    Containers::Pointer<AbstractImporter> importers[4];
+    for(Containers::Pointer<AbstractImporter>& importer: importers)
+        importer = _manager.instantiate("BasisImporterEtc2RGBA");
+
+    Containers::Optional<Trade::ImageData2D> images[Containers::arraySize(importers)];
+    std::thread threads[Containers::arraySize(importers)];
+    for(std::size_t i = 0; i != Containers::arraySize(importers); ++i) {
+        threads[i] = std::thread{[&importers, &images, i]{
+            if(importers[i]->openFile(Utility::Directory::join(BASISIMPORTER_TEST_DIR, "rgba-2images-mips.basis")))
+                images[i] = importers[i]->image2D(1);
+        }};
+    }
+    for(std::thread& thread: threads) thread.join();
+
+    for(std::size_t i = 0; i != Containers::arraySize(importers); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_VERIFY(images[i]);
+        CORRADE_COMPARE_AS(images[i]->data(), expected->data(),
+            TestSuite::Compare::Container);
+    }
+}
+
+void BasisImporterTest::openMemoryInvalid() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporter");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!static_cast<BasisImporter&>(*importer).openMemory(nullptr));
+    CORRADE_VERIFY(!static_cast<BasisImporter&>(*importer).openMemory(Containers::arrayView("NotABasisFile")));
+    CORRADE_VERIFY(!importer->isOpened());
+    CORRADE_COMPARE(out.str(),
+        "Trade::BasisImporter::openMemory(): the file is empty\n"
+        "Trade::BasisImporter::openMemory(): invalid header\n");
+}
+
+void BasisImporterTest::images2DThreads() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporterEtc2RGBA");
+    importer->configuration().setValue("threads", 4);
+    CORRADE_VERIFY(importer->openFile(
+        Utility::Directory::join(BASISIMPORTER_TEST_DIR, "rgba-2images-mips.basis")));
+    CORRADE_COMPARE(importer->image2DCount(), 2);
+
+    Containers::Array<Containers::Optional<Trade::ImageData2D>> images = static_cast<BasisImporter&>(*importer).images2D();
+    CORRADE_COMPARE(images.size(), importer->image2DLevelCount(0) + importer->image2DLevelCount(1));
+
+    /* The result should be the same as when transcoding each level
+       separately */
+    std::size_t i = 0;
+    for(UnsignedInt id: {0, 1}) for(UnsignedInt level = 0; level != importer->image2DLevelCount(id); ++level) {
+        CORRADE_ITERATION(i);
+        Containers::Optional<Trade::ImageData2D> expected = importer->image2D(id, level);
+        CORRADE_VERIFY(expected);
+        CORRADE_VERIFY(images[i]);
+        CORRADE_COMPARE(images[i]->compressedFormat(), expected->compressedFormat());
+        CORRADE_COMPARE(images[i]->size(), expected->size());
+        CORRADE_COMPARE_AS(images[i]->data(), expected->data(),
+            TestSuite::Compare::Container);
+        ++i;
+    }
+}
+
+void BasisImporterTest::image2DInto() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporterRGBA8");
+    CORRADE_VERIFY(importer->openFile(
+        Utility::Directory::join(BASISIMPORTER_TEST_DIR, "rgba.basis")));
+    auto& basisImporter = static_cast<BasisImporter&>(*importer);
+
+    Containers::Optional<Trade::ImageData2D> expected = importer->image2D(0);
+    CORRADE_VERIFY(expected);
+    CORRADE_COMPARE(expected->size(), (Vector2i{63, 27}));
+
+    /* Tightly packed, should be the same as image2D() */
+    CORRADE_COMPARE(basisImporter.image2DDataSize(0, 0), 63*27*4);
+    Containers::Array<char> tight{Containers::NoInit, 63*27*4};
+    CORRADE_VERIFY(basisImporter.image2DInto(0, 0, tight));
+    CORRADE_COMPARE_AS(tight, expected->data(), TestSuite::Compare::Container);
+
+    /* Rows padded to 256 bytes, the padding should stay untouched */
+    CORRADE_COMPARE(basisImporter.image2DDataSize(0, 0, 256), 256*27);
+    Containers::Array<char> padded{Containers::DirectInit, 256*27, '\xcd'};
+    CORRADE_VERIFY(basisImporter.image2DInto(0, 0, padded, 256));
+    for(std::size_t y = 0; y != 27; ++y) {
+        CORRADE_ITERATION(y);
+        CORRADE_COMPARE_AS(padded.slice(y*256, y*256 + 63*4),
+            expected->data().slice(y*63*4, (y + 1)*63*4),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE(padded[y*256 + 63*4], '\xcd');
+    }
+}
+
+void BasisImporterTest::image2DIntoInvalid() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporterRGBA8");
+    CORRADE_VERIFY(importer->openFile(
+        Utility::Directory::join(BASISIMPORTER_TEST_DIR, "rgba.basis")));
+    auto& basisImporter = static_cast<BasisImporter&>(*importer);
+
+    Containers::Array<char> data{63*27*4};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!basisImporter.image2DInto(0, 0, data, 63*4 - 4));
+    CORRADE_VERIFY(!basisImporter.image2DInto(0, 0, data, 63*4 + 1));
+    CORRADE_VERIFY(!basisImporter.image2DInto(0, 0, data.except(1)));
+
+    basisImporter.setTargetFormat(BasisImporter::TargetFormat::PvrtcRGBA4bpp);
+    CORRADE_VERIFY(!basisImporter.image2DInto(0, 0, data, 4096));
+    CORRADE_COMPARE(out.str(),
+        "Trade::BasisImporter::image2DInto(): row pitch 248 is not a multiple of 4 or is smaller than 252\n"
+        "Trade::BasisImporter::image2DInto(): row pitch 253 is not a multiple of 4 or is smaller than 252\n"
+        "Trade::BasisImporter::image2DInto(): expected a destination of at least 6804 bytes but got 6803\n"
+        "Trade::BasisImporter::image2DInto(): row padding is not supported for PVRTC formats\n");
+}
+
+void BasisImporterTest::image2DRegionInto() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporterRGBA8");
+    CORRADE_VERIFY(importer->openFile(
+        Utility::Directory::join(BASISIMPORTER_TEST_DIR, "rgba.basis")));
+    auto& basisImporter = static_cast<BasisImporter&>(*importer);
+
+    Containers::Optional<Trade::ImageData2D> expected = importer->image2D(0);
+    CORRADE_VERIFY(expected);
+    CORRADE_COMPARE(expected->size(), (Vector2i{63, 27}));
+
+    /* Uncompressed region is in pixels, rows padded to 64 bytes */
+    Containers::Array<char> data{Containers::DirectInit, 64*9, '\xcd'};
+    CORRADE_VERIFY(basisImporter.image2DRegionInto(0, 0, Range2Di::fromSize({50, 10}, {13, 9}), data, 64));
+    for(std::size_t y = 0; y != 9; ++y) {
+        CORRADE_ITERATION(y);
+        CORRADE_COMPARE_AS(data.slice(y*64, y*64 + 13*4),
+            expected->data().slice(((10 + y)*63 + 50)*4, ((10 + y)*63 + 63)*4),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE(data[y*64 + 13*4], '\xcd');
+    }
+
+    /* Compressed region is in blocks, a 63x27 image is 16x7 blocks. Second
+       region of the same level is taken from the cached level. */
+    basisImporter.setTargetFormat(BasisImporter::TargetFormat::Etc2RGBA);
+    Containers::Optional<Trade::ImageData2D> expectedCompressed = importer->image2D(0);
+    CORRADE_VERIFY(expectedCompressed);
+    for(const Range2Di region: {Range2Di{{0, 0}, {16, 7}},
+                                Range2Di::fromSize({4, 2}, {3, 5})}) {
+        CORRADE_ITERATION(region);
+        Containers::Array<char> compressed{Containers::NoInit, std::size_t(16*region.sizeX()*region.sizeY())};
+        CORRADE_VERIFY(basisImporter.image2DRegionInto(0, 0, region, compressed));
+        for(Int y = 0; y != region.sizeY(); ++y) {
+            CORRADE_ITERATION(y);
+            const std::size_t begin = ((region.min().y() + y)*16 + region.min().x())*16;
+            CORRADE_COMPARE_AS(compressed.slice(y*16*region.sizeX(), (y + 1)*16*region.sizeX()),
+                expectedCompressed->data().slice(begin, begin + 16*region.sizeX()),
+                TestSuite::Compare::Container);
+        }
+    }
+
+    /* Empty region does nothing */
+    CORRADE_VERIFY(basisImporter.image2DRegionInto(0, 0, Range2Di::fromSize({3, 3}, {0, 2}), nullptr));
+}
+
+void BasisImporterTest::image2DRegionIntoInvalid() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporterRGBA8");
+    CORRADE_VERIFY(importer->openFile(
+        Utility::Directory::join(BASISIMPORTER_TEST_DIR, "rgba.basis")));
+    auto& basisImporter = static_cast<BasisImporter&>(*importer);
+
+    Containers::Array<char> data{63*27*4};
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!basisImporter.image2DRegionInto(0, 0, {{60, 0}, {64, 1}}, data));
+    CORRADE_VERIFY(!basisImporter.image2DRegionInto(0, 0, {{0, 0}, {16, 1}}, data, 60));
+    CORRADE_VERIFY(!basisImporter.image2DRegionInto(0, 0, {{0, 0}, {16, 2}}, data.prefix(127)));
+
+    basisImporter.setTargetFormat(BasisImporter::TargetFormat::PvrtcRGBA4bpp);
+    CORRADE_VERIFY(!basisImporter.image2DRegionInto(0, 0, {{0, 0}, {1, 1}}, data));
+    CORRADE_COMPARE(out.str(),
+        "Trade::BasisImporter::image2DRegionInto(): region Range({60, 0}, {64, 1}) out of range for a level of Vector(63, 27) pixels\n"
+        "Trade::BasisImporter::image2DRegionInto(): row pitch 60 is not a multiple of 4 or is smaller than 64\n"
+        "Trade::BasisImporter::image2DRegionInto(): expected a destination of at least 128 bytes but got 127\n"
+        "Trade::BasisImporter::image2DRegionInto(): PVRTC formats are not supported\n");
+}
+
+void BasisImporterTest::chooseTargetFormat() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporter");
+    auto& basisImporter = static_cast<BasisImporter&>(*importer);
+
+    /* There's no debug output for TargetFormat, comparing the values as
+       integers */
+
+    /* Without a file opened, alpha is assumed */
+    const CompressedPixelFormat desktop[]{
+        CompressedPixelFormat::Bc1RGBUnorm,
+        CompressedPixelFormat::Bc3RGBAUnorm,
+        CompressedPixelFormat::Bc7RGBAUnorm
+    };
+    const CompressedPixelFormat mobile[]{
+        CompressedPixelFormat::Etc2RGB8Unorm,
+        CompressedPixelFormat::Etc2RGBA8Unorm,
+        CompressedPixelFormat::Astc4x4RGBAUnorm
+    };
+    const CompressedPixelFormat fallback[]{
+        CompressedPixelFormat::Etc2RGB8Unorm,
+        CompressedPixelFormat::Etc2RGBA8Unorm
+    };
+    const CompressedPixelFormat unsupported[]{
+        CompressedPixelFormat::Bc4RUnorm,
+        CompressedPixelFormat::Astc8x8RGBAUnorm
+    };
+    CORRADE_COMPARE(UnsignedInt(basisImporter.chooseTargetFormat(desktop)),
+        UnsignedInt(BasisImporter::TargetFormat::Bc7RGBA));
+    CORRADE_COMPARE(UnsignedInt(basisImporter.chooseTargetFormat(mobile)),
+        UnsignedInt(BasisImporter::TargetFormat::Astc4x4RGBA));
+    CORRADE_COMPARE(UnsignedInt(basisImporter.chooseTargetFormat(fallback)),
+        UnsignedInt(BasisImporter::TargetFormat::Etc2RGBA));
+    CORRADE_COMPARE(UnsignedInt(basisImporter.chooseTargetFormat(unsupported)),
+        UnsignedInt(BasisImporter::TargetFormat::RGBA8));
+    CORRADE_COMPARE(UnsignedInt(basisImporter.chooseTargetFormat(nullptr)),
+        UnsignedInt(BasisImporter::TargetFormat::RGBA8));
+
+    /* With alpha in the file it's the same */
+    CORRADE_VERIFY(importer->openFile(
+        Utility::Directory::join(BASISIMPORTER_TEST_DIR, "rgba.basis")));
+    CORRADE_VERIFY(basisImporter.hasAlpha());
+    CORRADE_COMPARE(UnsignedInt(basisImporter.chooseTargetFormat(desktop)),
+        UnsignedInt(BasisImporter::TargetFormat::Bc7RGBA));
+    CORRADE_COMPARE(UnsignedInt(basisImporter.chooseTargetFormat(fallback)),
+        UnsignedInt(BasisImporter::TargetFormat::Etc2RGBA));
+
+    /* Without alpha, formats without alpha are preferred */
+    CORRADE_VERIFY(importer->openFile(
+        Utility::Directory::join(BASISIMPORTER_TEST_DIR, "rgb.basis")));
+    CORRADE_VERIFY(!basisImporter.hasAlpha());
+    CORRADE_COMPARE(UnsignedInt(basisImporter.chooseTargetFormat(desktop)),
+        UnsignedInt(BasisImporter::TargetFormat::Bc7RGB));
+    CORRADE_COMPARE(UnsignedInt(basisImporter.chooseTargetFormat(mobile)),
+        UnsignedInt(BasisImporter::TargetFormat::Astc4x4RGBA));
+    CORRADE_COMPARE(UnsignedInt(basisImporter.chooseTargetFormat(fallback)),
+        UnsignedInt(BasisImporter::TargetFormat::Etc1RGB));
+    CORRADE_COMPARE(UnsignedInt(basisImporter.chooseTargetFormat(unsupported)),
+        UnsignedInt(BasisImporter::TargetFormat::RGBA8));
+
+    /* Picked format can be directly used for transcoding */
+    basisImporter.setTargetFormat(basisImporter.chooseTargetFormat(fallback));
+    Containers::Optional<ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_VERIFY(image->isCompressed());
+    CORRADE_COMPARE(image->compressedFormat(), CompressedPixelFormat::Etc2RGB8Unorm);
+}
+
 void BasisImporterTest::importMultipleFormats() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("BasisImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Directory::join(BASISIMPORTER_TEST_DIR, "rgb.basis")));
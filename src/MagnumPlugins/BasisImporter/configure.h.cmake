@@ -24,3 +24,4 @@
 */
 
 #cmakedefine MAGNUM_BASISIMPORTER_BUILD_STATIC
+#cmakedefine MAGNUM_BASISIMPORTER_WITH_PROFILING
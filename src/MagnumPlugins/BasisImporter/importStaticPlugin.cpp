@@ -26,7 +26,7 @@
 
 #include "MagnumPlugins/BasisImporter/configure.h"
 
-#ifdef MAGNUM_BASISIMPORTER_BUILD_STATIC
+#if defined(MAGNUM_BASISIMPORTER_BUILD_STATIC) && !defined(MAGNUM_PLUGINS_NO_AUTOMATIC_IMPORT)
 #include <Corrade/PluginManager/AbstractManager.h>
 
 static int magnumBasisImporterStaticImporter() {
@@ -27,17 +27,18 @@
 #include "DdsImporter.h"
 
 #include <cstring>
-#include <algorithm>
 #include <vector>
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
 #include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/Directory.h>
+#include <Magnum/FileCallback.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Vector3.h>
-#include <Magnum/Math/Vector4.h>
-#include <Magnum/Math/Swizzle.h>
 #include <Magnum/Trade/ImageData.h>
 
 namespace Magnum { namespace Trade {
@@ -298,22 +299,71 @@ inline std::string fourcc(UnsignedInt enc) {
     return c;
 }
 
-void swizzlePixels(const PixelFormat format, Containers::Array<char>& data, const char* verbosePrefix) {
+/* Converts BGR(A) to RGB(A) while copying the data out of the file, so the
+   pixels are touched just once. Both loops use only plain byte and integer
+   operations with no dependencies between iterations, which lets compilers
+   turn them into vector shuffles. */
+void swizzlePixels(const PixelFormat format, const Containers::ArrayView<const char> in, const Containers::ArrayView<char> out, const char* verbosePrefix) {
+    CORRADE_INTERNAL_ASSERT(in.size() == out.size());
+
     if(format == PixelFormat::RGB8Unorm) {
         if(verbosePrefix) Debug{} << verbosePrefix << "converting from BGR to RGB";
-        auto pixels = reinterpret_cast<Math::Vector3<UnsignedByte>*>(data.data());
-        std::transform(pixels, pixels + data.size()/sizeof(Math::Vector3<UnsignedByte>), pixels,
-            [](Math::Vector3<UnsignedByte> pixel) { return Math::gather<'b', 'g', 'r'>(pixel); });
+        const char* src = in.data();
+        char* dst = out.data();
+        for(std::size_t i = 0, end = in.size()/3*3; i != end; i += 3) {
+            dst[i + 0] = src[i + 2];
+            dst[i + 1] = src[i + 1];
+            dst[i + 2] = src[i + 0];
+        }
 
     } else if(format == PixelFormat::RGBA8Unorm) {
         if(verbosePrefix) Debug{} << verbosePrefix << "converting from BGRA to RGBA";
-        auto pixels = reinterpret_cast<Math::Vector4<UnsignedByte>*>(data.data());
-        std::transform(pixels, pixels + data.size()/sizeof(Math::Vector4<UnsignedByte>), pixels,
-            [](Math::Vector4<UnsignedByte> pixel) { return Math::gather<'b', 'g', 'r', 'a'>(pixel); });
+        /* Swapping the first and third byte of each four-byte word. The
+           memcpy()s get optimized away, they're there only to avoid
+           unaligned and type-punned access. */
+        for(std::size_t i = 0, end = in.size()/4*4; i != end; i += 4) {
+            UnsignedInt pixel;
+            std::memcpy(&pixel, in.data() + i, 4);
+            #ifndef CORRADE_TARGET_BIG_ENDIAN
+            pixel = (pixel & 0xff00ff00u)|((pixel >> 16) & 0x000000ffu)|((pixel & 0x000000ffu) << 16);
+            #else
+            pixel = (pixel & 0x00ff00ffu)|((pixel >> 16) & 0x0000ff00u)|((pixel & 0x0000ff00u) << 16);
+            #endif
+            std::memcpy(out.data() + i, &pixel, 4);
+        }
 
     } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
 }
 
+CompressedPixelFormat dxgiToCompressed(DxgiFormat format) {
+    switch(format) {
+        case DxgiFormat::BC1Typeless:       /* no special handling */
+        case DxgiFormat::BC1UNorm:          return CompressedPixelFormat::Bc1RGBAUnorm;
+        case DxgiFormat::BC1UNormSRGB:      return CompressedPixelFormat::Bc1RGBASrgb;
+        case DxgiFormat::BC2Typeless:       /* no special handling */
+        case DxgiFormat::BC2UNorm:          return CompressedPixelFormat::Bc2RGBAUnorm;
+        case DxgiFormat::BC2UNormSRGB:      return CompressedPixelFormat::Bc2RGBASrgb;
+        case DxgiFormat::BC3Typeless:       /* no special handling */
+        case DxgiFormat::BC3UNorm:          return CompressedPixelFormat::Bc3RGBAUnorm;
+        case DxgiFormat::BC3UNormSRGB:      return CompressedPixelFormat::Bc3RGBASrgb;
+        case DxgiFormat::BC4Typeless:       /* no special handling */
+        case DxgiFormat::BC4UNorm:          return CompressedPixelFormat::Bc4RUnorm;
+        case DxgiFormat::BC4SNorm:          return CompressedPixelFormat::Bc4RSnorm;
+        case DxgiFormat::BC5Typeless:       /* no special handling */
+        case DxgiFormat::BC5UNorm:          return CompressedPixelFormat::Bc5RGUnorm;
+        case DxgiFormat::BC5SNorm:          return CompressedPixelFormat::Bc5RGSnorm;
+        case DxgiFormat::BC6HTypeless:      /* no special handling */
+        case DxgiFormat::BC6HUF16:          return CompressedPixelFormat::Bc6hRGBUfloat;
+        case DxgiFormat::BC6HSF16:          return CompressedPixelFormat::Bc6hRGBSfloat;
+        case DxgiFormat::BC7Typeless:       /* no special handling */
+        case DxgiFormat::BC7UNorm:          return CompressedPixelFormat::Bc7RGBAUnorm;
+        case DxgiFormat::BC7UNormSRGB:      return CompressedPixelFormat::Bc7RGBASrgb;
+
+        default:
+            return CompressedPixelFormat(-1);
+    }
+}
+
 PixelFormat dxgiToGl(DxgiFormat format) {
     switch(format) {
         /* R8 and A8 formats */
@@ -436,10 +486,14 @@ struct DdsHeaderDxt10 {
 
 }
 
+#if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+#define _DDSIMPORTER_USE_MAP
+#endif
+
 struct DdsImporter::File {
     struct ImageDataOffset {
         Vector3i dimensions;
-        Containers::ArrayView<char> data;
+        Containers::ArrayView<const char> data;
     };
 
     /* Returns the new offset of an image in an array for current pixel type
@@ -447,12 +501,30 @@ struct DdsImporter::File {
        (Offset is always at least sizeof(DdsHeader) in healthy cases.) */
     std::size_t addImageDataOffset(const Vector3i& dims, std::size_t offset);
 
-    Containers::Array<char> in;
+    /* Either a copy of the data passed to openData() or a memory-mapped file
+       passed to openFile(). The import only ever looks at the `in` view,
+       which points to one of these or to data coming from a file callback. */
+    Containers::Array<char> data;
+    #ifdef _DDSIMPORTER_USE_MAP
+    Containers::Array<const char, Utility::Directory::MapDeleter> mappedData;
+    #endif
+    Containers::ArrayView<const char> in;
+
+    /* Non-empty if the data come from a file callback, used to signal the
+       callback on close */
+    std::string callbackFilename;
 
     bool compressed;
     bool volume;
+    bool cubemap;
     bool needsSwizzle;
 
+    /* Cube map faces times array layers and mip levels of each, the image
+       data are stored layer by layer, with all levels of a layer following
+       each other */
+    UnsignedInt layerCount;
+    UnsignedInt levelCount;
+
     union {
         PixelFormat uncompressed;
         CompressedPixelFormat compressed;
@@ -463,7 +535,7 @@ struct DdsImporter::File {
 
 std::size_t DdsImporter::File::addImageDataOffset(const Vector3i& dims, const std::size_t offset) {
     const std::size_t size = compressed ?
-        (dims.z()*((dims.x() + 3)/4)*(((dims.y() + 3)/4))*((pixelFormat.compressed == CompressedPixelFormat::Bc1RGBAUnorm) ? 8 : 16)) :
+        (dims.z()*((dims.x() + 3)/4)*(((dims.y() + 3)/4))*compressedBlockDataSize(pixelFormat.compressed)) :
         dims.product()*pixelSize(pixelFormat.uncompressed);
 
     const size_t end = offset + size;
@@ -482,25 +554,81 @@ DdsImporter::DdsImporter(PluginManager::AbstractManager& manager, const std::str
 
 DdsImporter::~DdsImporter() = default;
 
-ImporterFeatures DdsImporter::doFeatures() const { return ImporterFeature::OpenData; }
+ImporterFeatures DdsImporter::doFeatures() const { return ImporterFeature::OpenData|ImporterFeature::FileCallback; }
 
 bool DdsImporter::doIsOpened() const { return !!_f; }
 
-void DdsImporter::doClose() { _f = nullptr; }
+void DdsImporter::doClose() {
+    /* Tell the callback the data aren't needed anymore */
+    if(_f && !_f->callbackFilename.empty())
+        fileCallback()(_f->callbackFilename, InputFileCallbackPolicy::Close, fileCallbackUserData());
+    _f = nullptr;
+}
+
+void DdsImporter::doOpenFile(const std::string& filename) {
+    /* If a file callback is set, ask it for data that stay valid until the
+       file is closed. The importer then only parses the header and the level
+       offsets, the level data are copied out of the view only when requested
+       from image2D() / image3D(). */
+    if(fileCallback()) {
+        const Containers::Optional<Containers::ArrayView<const char>> data = fileCallback()(filename, InputFileCallbackPolicy::LoadPermanent, fileCallbackUserData());
+        if(!data) {
+            Error{} << "Trade::DdsImporter::openFile(): cannot open file" << filename;
+            return;
+        }
+
+        Containers::Pointer<File> f{new File};
+        f->in = *data;
+        f->callbackFilename = filename;
+        openDataInternal(std::move(f));
 
-void DdsImporter::doOpenData(const Containers::ArrayView<const char> data) {
+        /* If the file failed to open, there's nothing that would call the
+           close in doClose(), do it here */
+        if(!_f) fileCallback()(filename, InputFileCallbackPolicy::Close, fileCallbackUserData());
+        return;
+    }
+
+    if(!Utility::Directory::exists(filename)) {
+        Error{} << "Trade::DdsImporter::openFile(): cannot open file" << filename;
+        return;
+    }
+
+    /* Map the file instead of reading it to avoid having the whole file
+       copied in memory. Moving the mapping to the file state in
+       openDataInternal() doesn't change the data pointer, so the views stay
+       valid. */
     Containers::Pointer<File> f{new File};
+    #ifdef _DDSIMPORTER_USE_MAP
+    f->mappedData = Utility::Directory::mapRead(filename);
+    f->in = f->mappedData;
+    #else
+    f->data = Utility::Directory::read(filename);
+    f->in = f->data;
+    #endif
+    openDataInternal(std::move(f));
+}
 
-    /* clear previous data */
-    f->in = Containers::Array<char>(data.size());
-    std::copy(data.begin(), data.end(), f->in.begin());
+void DdsImporter::doOpenData(const Containers::ArrayView<const char> data) {
+    /* The data are guaranteed to be valid only during this call, so keep a
+       copy of them */
+    Containers::Pointer<File> f{new File};
+    f->data = Containers::Array<char>{Containers::NoInit, data.size()};
+    Utility::copy(data, f->data);
+    f->in = f->data;
+    openDataInternal(std::move(f));
+}
 
+void DdsImporter::openDataInternal(Containers::Pointer<File>&& f) {
     constexpr size_t MagicNumberSize = 4;
     /* read magic number to verify this is a dds file. */
-    if(strncmp(f->in.prefix(MagicNumberSize).data(), "DDS ", MagicNumberSize) != 0) {
+    if(f->in.size() < MagicNumberSize || strncmp(f->in.prefix(MagicNumberSize).data(), "DDS ", MagicNumberSize) != 0) {
         Error() << "Trade::DdsImporter::openData(): wrong file signature";
         return;
     }
+    if(f->in.size() < MagicNumberSize + sizeof(DdsHeader)) {
+        Error() << "Trade::DdsImporter::openData(): file too short";
+        return;
+    }
     std::size_t offset = MagicNumberSize;
 
     /* read in DDS header */
@@ -513,7 +641,10 @@ void DdsImporter::doOpenData(const Containers::ArrayView<const char> data) {
     f->volume = ((ddsh.caps2 & DdsCap2::Volume) && (ddsh.depth > 0));
 
     /* check if image is a cubemap */
-    const bool isCubemap = !!(ddsh.caps2 & DdsCap2::Cubemap);
+    f->cubemap = !!(ddsh.caps2 & DdsCap2::Cubemap);
+
+    /* DXT10 array textures, a cube map array has six faces per layer */
+    UnsignedInt arraySize = 1;
 
     /* Compressed */
     if(ddsh.ddspf.flags & DdsPixelFormatFlag::FourCC) {
@@ -537,13 +668,25 @@ void DdsImporter::doOpenData(const Containers::ArrayView<const char> data) {
                     const DdsHeaderDxt10& dxt10 = *reinterpret_cast<const DdsHeaderDxt10*>(f->in.suffix(offset).data());
                     offset += sizeof(DdsHeaderDxt10);
 
+                    if(dxt10.arraySize > 1) arraySize = dxt10.arraySize;
+                    if(UnsignedInt(dxt10.miscFlag) & UnsignedInt(DdsMiscFlag::TextureCube))
+                        f->cubemap = true;
+
+                    f->needsSwizzle = false;
+
+                    /* Block-compressed formats */
+                    f->pixelFormat.compressed = dxgiToCompressed(dxt10.dxgiFormat);
+                    if(f->pixelFormat.compressed != CompressedPixelFormat(-1)) {
+                        f->compressed = true;
+                        break;
+                    }
+
                     f->pixelFormat.uncompressed = dxgiToGl(dxt10.dxgiFormat);
                     if(f->pixelFormat.uncompressed == PixelFormat(-1)) {
                         Error() << "Trade::DdsImporter::openData(): unsupported DXGI format" << UnsignedInt(dxt10.dxgiFormat);
                         return;
                     }
                     f->compressed = false;
-                    f->needsSwizzle = false;
                 }
                 break;
             default:
@@ -610,8 +753,11 @@ void DdsImporter::doOpenData(const Containers::ArrayView<const char> data) {
     /* check how many mipmaps to load */
     const UnsignedInt numMipmaps = ddsh.flags & DdsDescriptionFlag::MipMapCount ? ddsh.mipMapCount : 1;
 
-    /* load all surfaces for the image (6 surfaces for cubemaps) */
-    const UnsignedInt numImages = isCubemap ? 6 : 1;
+    /* load all surfaces for the image (6 surfaces for cubemaps, times the
+       array size) */
+    const UnsignedInt numImages = (f->cubemap ? 6 : 1)*arraySize;
+    f->layerCount = numImages;
+    f->levelCount = numMipmaps;
     for(UnsignedInt n = 0; n < numImages; ++n) {
         Vector3i mipSize{size};
 
@@ -632,6 +778,17 @@ void DdsImporter::doOpenData(const Containers::ArrayView<const char> data) {
     _f = std::move(f);
 }
 
+namespace {
+
+/* Data referencing the file directly, with a no-op deleter. The data are
+   never written to through it, the const_cast is only needed because
+   ImageData takes a mutable array. */
+Containers::Array<char> referenceData(const Containers::ArrayView<const char> data) {
+    return Containers::Array<char>{const_cast<char*>(data.data()), data.size(), [](char*, std::size_t) {}};
+}
+
+}
+
 UnsignedInt DdsImporter::doImage2DCount() const {  return _f->volume ? 0 : 1; }
 
 UnsignedInt DdsImporter::doImage2DLevelCount(UnsignedInt) {  return _f->imageData.size(); }
@@ -639,18 +796,24 @@ UnsignedInt DdsImporter::doImage2DLevelCount(UnsignedInt) {  return _f->imageDat
 Containers::Optional<ImageData2D> DdsImporter::doImage2D(UnsignedInt, const UnsignedInt level) {
     const File::ImageDataOffset& dataOffset = _f->imageData[level];
 
-    /* copy image data */
-    Containers::Array<char> data = Containers::Array<char>(dataOffset.data.size());
-    std::copy(dataOffset.data.begin(), dataOffset.data.end(), data.begin());
+    /* Reference the file directly if requested and the data don't need any
+       processing, copy otherwise */
+    Containers::Array<char> data;
+    if(configuration().value<bool>("zeroCopy") && (_f->compressed || !_f->needsSwizzle))
+        data = referenceData(dataOffset.data);
+    else {
+        data = Containers::Array<char>{Containers::NoInit, dataOffset.data.size()};
+        if(!_f->compressed && _f->needsSwizzle)
+            swizzlePixels(_f->pixelFormat.uncompressed, dataOffset.data, data,
+                flags() & ImporterFlag::Verbose ? "Trade::DdsImporter::image2D():" : nullptr);
+        else Utility::copy(dataOffset.data, data);
+    }
 
     /* Compressed image */
     if(_f->compressed)
         return ImageData2D(_f->pixelFormat.compressed, dataOffset.dimensions.xy(), std::move(data));
 
     /* Uncompressed */
-    if(_f->needsSwizzle) swizzlePixels(_f->pixelFormat.uncompressed, data,
-        flags() & ImporterFlag::Verbose ? "Trade::DdsImporter::image2D():" : nullptr);
-
     /* Adjust pixel storage if row size is not four byte aligned */
     PixelStorage storage;
     if((dataOffset.dimensions.x()*pixelSize(_f->pixelFormat.uncompressed))%4 != 0)
@@ -663,21 +826,82 @@ UnsignedInt DdsImporter::doImage3DCount() const { return _f->volume ? 1 : 0; }
 
 UnsignedInt DdsImporter::doImage3DLevelCount(UnsignedInt) {  return _f->imageData.size(); }
 
+DdsTextureData DdsImporter::texture() {
+    CORRADE_ASSERT(_f, "Trade::DdsImporter::texture(): no file opened", {});
+
+    DdsTextureData out{};
+    if(_f->volume) out.type = DdsTextureType::Texture3D;
+    else if(_f->cubemap)
+        out.type = _f->layerCount > 6 ? DdsTextureType::CubeMapArray : DdsTextureType::CubeMap;
+    else out.type = _f->layerCount > 1 ? DdsTextureType::Texture2DArray : DdsTextureType::Texture2D;
+    out.compressed = _f->compressed;
+    if(_f->compressed) out.compressedFormat = _f->pixelFormat.compressed;
+    else out.format = _f->pixelFormat.uncompressed;
+
+    /* Calculate level offsets, all layers of a level are next to each other.
+       All layers have the same size, so it's enough to look at the first
+       one. */
+    out.levels = Containers::Array<DdsTextureData::Level>{_f->levelCount};
+    std::size_t offset = 0;
+    for(UnsignedInt level = 0; level != _f->levelCount; ++level) {
+        const File::ImageDataOffset& first = _f->imageData[level];
+        out.levels[level].size = _f->volume ? first.dimensions :
+            Vector3i{first.dimensions.xy(), Int(_f->layerCount)};
+        out.levels[level].offset = offset;
+        out.levels[level].dataSize = first.data.size()*_f->layerCount;
+        offset += out.levels[level].dataSize;
+    }
+
+    /* With just one layer or one level, the file layout is the same as the
+       GPU upload order, so the file can be referenced directly if requested
+       and the data don't need any processing */
+    if(configuration().value<bool>("zeroCopy") && (_f->compressed || !_f->needsSwizzle) && (_f->layerCount == 1 || _f->levelCount == 1)) {
+        const char* const begin = _f->imageData.front().data.begin();
+        out.data = referenceData({begin, std::size_t(_f->imageData.back().data.end() - begin)});
+        CORRADE_INTERNAL_ASSERT(out.data.size() == offset);
+        return out;
+    }
+
+    /* Otherwise reorder the layers into a single allocation */
+    out.data = Containers::Array<char>{Containers::NoInit, offset};
+    for(UnsignedInt layer = 0; layer != _f->layerCount; ++layer) {
+        for(UnsignedInt level = 0; level != _f->levelCount; ++level) {
+            const Containers::ArrayView<const char> src = _f->imageData[layer*_f->levelCount + level].data;
+            const Containers::ArrayView<char> dst = out.data.slice(
+                out.levels[level].offset + layer*src.size(),
+                out.levels[level].offset + (layer + 1)*src.size());
+            /* Print the verbose message just once, not for every level */
+            if(!_f->compressed && _f->needsSwizzle)
+                swizzlePixels(_f->pixelFormat.uncompressed, src, dst,
+                    !layer && !level && (flags() & ImporterFlag::Verbose) ? "Trade::DdsImporter::texture():" : nullptr);
+            else Utility::copy(src, dst);
+        }
+    }
+
+    return out;
+}
+
 Containers::Optional<ImageData3D> DdsImporter::doImage3D(UnsignedInt, const UnsignedInt level) {
     const File::ImageDataOffset& dataOffset = _f->imageData[level];
 
-    /* copy image data */
-    Containers::Array<char> data = Containers::Array<char>(dataOffset.data.size());
-    std::copy(dataOffset.data.begin(), dataOffset.data.end(), data.begin());
+    /* Reference the file directly if requested and the data don't need any
+       processing, copy otherwise */
+    Containers::Array<char> data;
+    if(configuration().value<bool>("zeroCopy") && (_f->compressed || !_f->needsSwizzle))
+        data = referenceData(dataOffset.data);
+    else {
+        data = Containers::Array<char>{Containers::NoInit, dataOffset.data.size()};
+        if(!_f->compressed && _f->needsSwizzle)
+            swizzlePixels(_f->pixelFormat.uncompressed, dataOffset.data, data,
+                flags() & ImporterFlag::Verbose ? "Trade::DdsImporter::image3D():" : nullptr);
+        else Utility::copy(dataOffset.data, data);
+    }
 
     /* Compressed image */
     if(_f->compressed)
         return ImageData3D(_f->pixelFormat.compressed, dataOffset.dimensions, std::move(data));
 
     /* Uncompressed */
-    if(_f->needsSwizzle) swizzlePixels(_f->pixelFormat.uncompressed, data,
-        flags() & ImporterFlag::Verbose ? "Trade::DdsImporter::image3D():" : nullptr);
-
     /* Adjust pixel storage if row size is not four byte aligned */
     PixelStorage storage;
     if((dataOffset.dimensions.x()*pixelSize(_f->pixelFormat.uncompressed))%4 != 0)
@@ -27,9 +27,12 @@
 */
 
 /** @file
- * @brief Class @ref Magnum::Trade::DdsImporter
+ * @brief Class @ref Magnum::Trade::DdsImporter, struct @ref Magnum::Trade::DdsTextureData, enum @ref Magnum::Trade::DdsTextureType
  */
 
+#include <Corrade/Containers/Array.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Vector3.h>
 #include <Magnum/Trade/AbstractImporter.h>
 
 #include "MagnumPlugins/DdsImporter/configure.h"
@@ -52,6 +55,75 @@
 
 namespace Magnum { namespace Trade {
 
+/**
+@brief DDS texture type
+@m_since_latest_{plugins}
+
+@see @ref DdsTextureData::type
+*/
+enum class DdsTextureType: UnsignedByte {
+    Texture2D,          /**< 2D texture */
+    Texture2DArray,     /**< 2D array texture */
+    Texture3D,          /**< 3D texture */
+    CubeMap,            /**< Cube map texture */
+    CubeMapArray        /**< Cube map array texture */
+};
+
+/**
+@brief Whole DDS texture in a single contiguous allocation
+@m_since_latest_{plugins}
+
+Returned from @ref DdsImporter::texture(). See
+@ref Trade-DdsImporter-behavior-texture for more information.
+*/
+struct DdsTextureData {
+    /** @brief Mip level */
+    struct Level {
+        /**
+         * @brief Level size
+         *
+         * For array and cube map textures the Z coordinate is the layer
+         * count, with cube map arrays having six layers for each cube map.
+         * For 3D textures it's the depth of given level.
+         */
+        Vector3i size;
+
+        /** @brief Offset of the level data in @ref DdsTextureData::data */
+        std::size_t offset;
+
+        /** @brief Size of the level data */
+        std::size_t dataSize;
+    };
+
+    /** @brief Texture type */
+    DdsTextureType type;
+
+    /** @brief Whether the texture is compressed */
+    bool compressed;
+
+    /**
+     * @brief Pixel format
+     *
+     * Valid only if @ref compressed is @cpp false @ce. Pixel rows are
+     * tightly packed, which means pixel storage alignment has to be set to
+     * @cpp 1 @ce for rows that aren't a multiple of four bytes.
+     */
+    PixelFormat format;
+
+    /**
+     * @brief Compressed pixel format
+     *
+     * Valid only if @ref compressed is @cpp true @ce.
+     */
+    CompressedPixelFormat compressedFormat;
+
+    /** @brief Mip levels, largest first */
+    Containers::Array<Level> levels;
+
+    /** @brief Data of all levels and layers */
+    Containers::Array<char> data;
+};
+
 /**
 @brief DDS image importer plugin
 
@@ -138,11 +210,74 @@ Imports images in the following formats:
         @ref PixelFormat::R32I  and its two-/three-/four-component equivalents
     -   `R32_FLOAT`, `R32G32_FLOAT`, `R32G32B32_FLOAT`, `R32G32B32A32_FLOAT` as
         @ref PixelFormat::R32F and its two-/three-/four-component equivalents
+    -   `BC1_TYPELESS`, `BC1_UNORM`, `BC1_UNORM_SRGB` as
+        @ref CompressedPixelFormat::Bc1RGBAUnorm or
+        @ref CompressedPixelFormat::Bc1RGBASrgb (typeless with no special
+        handling), and similarly for `BC2_*`, `BC3_*` and `BC7_*` as
+        @ref CompressedPixelFormat::Bc2RGBAUnorm,
+        @ref CompressedPixelFormat::Bc3RGBAUnorm,
+        @ref CompressedPixelFormat::Bc7RGBAUnorm and their sRGB variants
+    -   `BC4_TYPELESS`, `BC4_UNORM`, `BC4_SNORM` as
+        @ref CompressedPixelFormat::Bc4RUnorm or
+        @ref CompressedPixelFormat::Bc4RSnorm, and similarly for `BC5_*` as
+        @ref CompressedPixelFormat::Bc5RGUnorm and
+        @ref CompressedPixelFormat::Bc5RGSnorm (typeless with no special
+        handling)
+    -   `BC6H_TYPELESS`, `BC6H_UF16`, `BC6H_SF16` as
+        @ref CompressedPixelFormat::Bc6hRGBUfloat or
+        @ref CompressedPixelFormat::Bc6hRGBSfloat (typeless with no special
+        handling)
 
 The importer recognizes @ref ImporterFlag::Verbose, printing additional info
 when the flag is enabled.
 
-BC6h, BC7 and other compressed formats are currently not imported correctly.
+Other compressed formats, such as BC4 and BC5 through the legacy `ATI1` and
+`ATI2` FourCC codes, are currently not supported.
+
+Files passed to @ref openFile() are memory-mapped on platforms that support
+it, data passed to @ref openData() are copied. The importer supports
+@ref ImporterFeature::FileCallback --- if a callback is set, it's called with
+@ref InputFileCallbackPolicy::LoadPermanent and the returned view is used
+directly, until the importer is closed. In both cases only the header and the
+offset of each level get parsed on opening, with the level data copied out of
+the file only when a particular level is requested through @ref image2D() or
+@ref image3D() --- which means for example the smallest mip levels can be
+loaded first without the rest of the file being touched.
+
+If the @cb{.ini} zeroCopy @ce
+@ref Trade-DdsImporter-configuration "configuration option" is enabled,
+compressed images and uncompressed images that don't need any swizzling
+reference the file data directly instead of being copied, which means they
+can be uploaded to the GPU straight from the file mapping. The data are then
+valid only while the file is opened and must not be modified --- in case of a
+memory-mapped file the memory is read-only.
+
+@subsection Trade-DdsImporter-behavior-texture Importing whole textures
+
+Cube maps and DXT10 array textures are exposed through @ref image2D() with
+each face or layer being a separate sequence of levels, as they're stored in
+the file. To avoid allocating and uploading each of them separately,
+@ref texture() returns the whole 2D, 3D, array or cube map texture including
+all mip levels in a single allocation. The data are ordered level by level,
+with all layers (or cube map faces in the +X, -X, +Y, -Y, +Z, -Z order) of a
+level following each other, which is the order expected by
+@cpp glTexStorage3D() @ce / @cpp glTexSubImage3D() @ce or
+@cpp glCompressedTexSubImage3D() @ce, so each level can be uploaded with a
+single call. Offset and size of each level are stored in
+@ref DdsTextureData::levels.
+
+With the @cb{.ini} zeroCopy @ce option enabled, textures with just one level
+or just one layer, whose layout in the file already matches, reference the
+file data directly under the same conditions as @ref image2D() and
+@ref image3D(). Textures with more than one level and layer are always
+reordered into a fresh allocation.
+
+@section Trade-DdsImporter-configuration Plugin-specific config
+
+It's possible to tune various import options through @ref configuration(). See
+below for all options and their default values:
+
+@snippet MagnumPlugins/DdsImporter/DdsImporter.conf config
 */
 class MAGNUM_DDSIMPORTER_EXPORT DdsImporter: public AbstractImporter {
     public:
@@ -154,11 +289,27 @@ class MAGNUM_DDSIMPORTER_EXPORT DdsImporter: public AbstractImporter {
 
         ~DdsImporter();
 
+        /**
+         * @brief Import the whole texture
+         * @m_since_latest_{plugins}
+         *
+         * Returns all layers and mip levels in a single contiguous
+         * allocation, in the order they're uploaded to the GPU. See
+         * @ref Trade-DdsImporter-behavior-texture for more information.
+         *
+         * Expects that a file is opened.
+         */
+        virtual DdsTextureData texture();
+
     private:
+        struct File;
+
         MAGNUM_DDSIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_DDSIMPORTER_LOCAL bool doIsOpened() const override;
         MAGNUM_DDSIMPORTER_LOCAL void doClose() override;
+        MAGNUM_DDSIMPORTER_LOCAL void doOpenFile(const std::string& filename) override;
         MAGNUM_DDSIMPORTER_LOCAL void doOpenData(Containers::ArrayView<const char> data) override;
+        MAGNUM_DDSIMPORTER_LOCAL void openDataInternal(Containers::Pointer<File>&& f);
 
         MAGNUM_DDSIMPORTER_LOCAL UnsignedInt doImage2DCount() const override;
         MAGNUM_DDSIMPORTER_LOCAL UnsignedInt doImage2DLevelCount(UnsignedInt id) override;
@@ -168,8 +319,6 @@ class MAGNUM_DDSIMPORTER_EXPORT DdsImporter: public AbstractImporter {
         MAGNUM_DDSIMPORTER_LOCAL UnsignedInt doImage3DLevelCount(UnsignedInt id) override;
         MAGNUM_DDSIMPORTER_LOCAL Containers::Optional<ImageData3D> doImage3D(UnsignedInt id, UnsignedInt level) override;
 
-    private:
-        struct File;
         Containers::Pointer<File> _f;
 };
 
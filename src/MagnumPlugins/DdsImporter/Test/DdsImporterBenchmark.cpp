@@ -0,0 +1,212 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+#include <cstring>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/Endianness.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include "MagnumPlugins/Implementation/peakMemory.h"
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+struct DdsImporterBenchmark: TestSuite::Tester {
+    explicit DdsImporterBenchmark();
+
+    void open();
+    void allLevels();
+    void peakMemory();
+
+    void peakMemoryBegin();
+    std::uint64_t peakMemoryEnd();
+
+    /* Explicitly forbid system-wide plugin dependencies */
+    PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
+
+    std::uint64_t _residentSizeBefore{};
+};
+
+/* To calculate the throughput, divide the file size shown in the test case
+   description by the measured time */
+constexpr struct {
+    const char* name;
+    bool compressed;
+    bool bgra;
+    UnsignedInt size;
+    bool zeroCopy;
+} FileData[]{
+    {"DXT1", true, false, 4096, false},
+    {"DXT1, zero copy", true, false, 4096, true},
+    {"RGBA8", false, false, 2048, false},
+    {"RGBA8, zero copy", false, false, 2048, true},
+    {"BGRA8", false, true, 2048, false}
+};
+
+/* A square image with a full mip chain, generated instead of bundling large
+   files. The pixel data are just a repeating pattern, the importer doesn't
+   look at them. */
+Containers::Array<char> file(const bool compressed, const bool bgra, const UnsignedInt size) {
+    const UnsignedInt levelCount = Math::log2(size) + 1;
+    std::size_t dataSize = 0;
+    for(UnsignedInt i = 0, levelSize = size; i != levelCount; ++i, levelSize = Math::max(levelSize >> 1, 1u))
+        dataSize += compressed ?
+            std::size_t((levelSize + 3)/4)*((levelSize + 3)/4)*8 :
+            std::size_t(levelSize)*levelSize*4;
+
+    Containers::Array<char> out{Containers::ValueInit, 128 + dataSize};
+    std::memcpy(out.data(), "DDS ", 4);
+    const auto put = [&](const std::size_t offset, const UnsignedInt value) {
+        const UnsignedInt valueLE = Utility::Endianness::littleEndian(value);
+        std::memcpy(out.data() + 4 + offset, &valueLE, 4);
+    };
+
+    /* Header size, flags (Caps|Height|Width|PixelFormat|MipMapCount),
+       height, width, mip count */
+    put(0, 124);
+    put(4, 0x00000001|0x00000002|0x00000004|0x00001000|0x00020000);
+    put(8, size);
+    put(12, size);
+    put(24, levelCount);
+
+    /* Pixel format size, flags, FourCC / bit count and masks */
+    put(72, 32);
+    if(compressed) {
+        put(76, 0x00000004);
+        std::memcpy(out.data() + 4 + 80, "DXT1", 4);
+    } else {
+        put(76, 0x00000041);
+        put(84, 32);
+        put(88, bgra ? 0x00FF0000 : 0x000000FF);
+        put(92, 0x0000FF00);
+        put(96, bgra ? 0x000000FF : 0x00FF0000);
+        put(100, 0xFF000000);
+    }
+
+    /* Caps (Complex|Texture|MipMap) */
+    put(104, 0x00000008|0x00001000|0x00400000);
+
+    for(std::size_t i = 128; i != out.size(); ++i)
+        out[i] = char(i*37);
+
+    return out;
+}
+
+DdsImporterBenchmark::DdsImporterBenchmark() {
+    addInstancedBenchmarks({&DdsImporterBenchmark::open,
+                            &DdsImporterBenchmark::allLevels}, 10,
+        Containers::arraySize(FileData));
+
+    addCustomInstancedBenchmarks({&DdsImporterBenchmark::peakMemory}, 1,
+        Containers::arraySize(FileData),
+        &DdsImporterBenchmark::peakMemoryBegin,
+        &DdsImporterBenchmark::peakMemoryEnd,
+        BenchmarkUnits::Bytes);
+
+    /* Load the plugin directly from the build tree. Otherwise it's static and
+       already loaded. */
+    #ifdef DDSIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(DDSIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+void DdsImporterBenchmark::open() {
+    auto&& data = FileData[testCaseInstanceId()];
+
+    const Containers::Array<char> in = file(data.compressed, data.bgra, data.size);
+    setTestCaseDescription(Utility::formatString("{}, {} bytes", data.name, in.size()));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    importer->configuration().setValue("zeroCopy", data.zeroCopy);
+
+    bool opened = false;
+    CORRADE_BENCHMARK(1)
+        opened = importer->openData(in);
+
+    CORRADE_VERIFY(opened);
+}
+
+void DdsImporterBenchmark::allLevels() {
+    auto&& data = FileData[testCaseInstanceId()];
+
+    const Containers::Array<char> in = file(data.compressed, data.bgra, data.size);
+    setTestCaseDescription(Utility::formatString("{}, {} bytes", data.name, in.size()));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    importer->configuration().setValue("zeroCopy", data.zeroCopy);
+
+    std::size_t importedSize = 0;
+    CORRADE_BENCHMARK(1) {
+        importer->openData(in);
+        for(UnsignedInt i = 0, iMax = importer->image2DLevelCount(0); i != iMax; ++i) {
+            Containers::Optional<ImageData2D> image = importer->image2D(0, i);
+            if(image) importedSize += image->data().size();
+        }
+    }
+
+    CORRADE_COMPARE(importedSize, in.size() - 128);
+}
+
+void DdsImporterBenchmark::peakMemory() {
+    auto&& data = FileData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifndef __linux__
+    CORRADE_SKIP("Peak memory can be measured only on Linux.");
+    #else
+    /* The input is generated outside of the measured region, so only the
+       memory allocated by the importer and for the output is counted */
+    const Containers::Array<char> in = file(data.compressed, data.bgra, data.size);
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    importer->configuration().setValue("zeroCopy", data.zeroCopy);
+
+    Containers::Optional<ImageData2D> image;
+    CORRADE_BENCHMARK(1) {
+        importer->openData(in);
+        image = importer->image2D(0);
+    }
+
+    CORRADE_VERIFY(image);
+    #endif
+}
+
+void DdsImporterBenchmark::peakMemoryBegin() {
+    _residentSizeBefore = Magnum::Implementation::peakMemoryBegin();
+}
+
+std::uint64_t DdsImporterBenchmark::peakMemoryEnd() {
+    return Magnum::Implementation::peakMemoryEnd(_residentSizeBefore);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::DdsImporterBenchmark)
@@ -28,13 +28,17 @@
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Corrade/Utility/Directory.h>
 #include <Corrade/Utility/Resource.h>
+#include <Magnum/FileCallback.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Trade/ImageData.h>
 #include <Magnum/Trade/AbstractImporter.h>
 
+#include "MagnumPlugins/DdsImporter/DdsImporter.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Trade { namespace Test { namespace {
@@ -50,6 +54,7 @@ struct DdsImporterTest: TestSuite::Tester {
     void rgb();
     void rgbWithMips();
     void rgbVolume();
+    void bgra();
 
     void dxt1();
     void dxt3();
@@ -57,11 +62,26 @@ struct DdsImporterTest: TestSuite::Tester {
 
     void dxt10Formats2D();
     void dxt10Formats3D();
+    void dxt10Compressed();
+    void dxt10CompressedMips();
 
     void dxt10Data();
     void dxt10TooShort();
     void dxt10UnsupportedFormat();
 
+    void openFile();
+    void openFileNonexistent();
+    void fileCallback();
+    void fileCallbackNotFound();
+    void fileCallbackFailed();
+    void zeroCopy();
+    void zeroCopySwizzled();
+
+    void textureCubeMap();
+    void textureArray();
+    void textureVolume();
+    void textureZeroCopy();
+
     void useTwice();
 
     /* Explicitly forbid system-wide plugin dependencies */
@@ -150,6 +170,34 @@ constexpr struct {
     {"3D_R32G32B32_UINT.dds", PixelFormat::RGB32UI}
 };
 
+constexpr struct {
+    const char* filename;
+    CompressedPixelFormat format;
+    std::size_t blockSize;
+} FilesCompressed[]{
+    {"2D_BC1_UNORM.dds", CompressedPixelFormat::Bc1RGBAUnorm, 8},
+    {"2D_BC1_UNORM_SRGB.dds", CompressedPixelFormat::Bc1RGBASrgb, 8},
+    {"2D_BC2_UNORM.dds", CompressedPixelFormat::Bc2RGBAUnorm, 16},
+    {"2D_BC3_UNORM_SRGB.dds", CompressedPixelFormat::Bc3RGBASrgb, 16},
+    {"2D_BC4_UNORM.dds", CompressedPixelFormat::Bc4RUnorm, 8},
+    {"2D_BC4_SNORM.dds", CompressedPixelFormat::Bc4RSnorm, 8},
+    {"2D_BC5_UNORM.dds", CompressedPixelFormat::Bc5RGUnorm, 16},
+    {"2D_BC5_SNORM.dds", CompressedPixelFormat::Bc5RGSnorm, 16},
+    {"2D_BC6H_UF16.dds", CompressedPixelFormat::Bc6hRGBUfloat, 16},
+    {"2D_BC6H_SF16.dds", CompressedPixelFormat::Bc6hRGBSfloat, 16},
+    {"2D_BC7_UNORM.dds", CompressedPixelFormat::Bc7RGBAUnorm, 16},
+    {"2D_BC7_UNORM_SRGB.dds", CompressedPixelFormat::Bc7RGBASrgb, 16}
+};
+
+constexpr struct {
+    const char* filename;
+    CompressedPixelFormat format;
+    std::size_t blockSize;
+} FilesCompressedMips[]{
+    {"2DMips_BC4_UNORM.dds", CompressedPixelFormat::Bc4RUnorm, 8},
+    {"2DMips_BC7_UNORM.dds", CompressedPixelFormat::Bc7RGBAUnorm, 16}
+};
+
 DdsImporterTest::DdsImporterTest() {
     addTests({&DdsImporterTest::wrongSignature,
               &DdsImporterTest::unknownFormat,
@@ -162,6 +210,8 @@ DdsImporterTest::DdsImporterTest() {
         &DdsImporterTest::rgbVolume},
         Containers::arraySize(VerboseData));
 
+    addTests({&DdsImporterTest::bgra});
+
     addTests({&DdsImporterTest::dxt1,
               &DdsImporterTest::dxt3,
               &DdsImporterTest::dxt5});
@@ -170,11 +220,31 @@ DdsImporterTest::DdsImporterTest() {
         Containers::arraySize(Files2D));
     addInstancedTests({&DdsImporterTest::dxt10Formats3D},
         Containers::arraySize(Files3D));
+    addInstancedTests({&DdsImporterTest::dxt10Compressed},
+        Containers::arraySize(FilesCompressed));
+    addInstancedTests({&DdsImporterTest::dxt10CompressedMips},
+        Containers::arraySize(FilesCompressedMips));
 
     addTests({&DdsImporterTest::dxt10Data,
               &DdsImporterTest::dxt10TooShort,
               &DdsImporterTest::dxt10UnsupportedFormat,
 
+              &DdsImporterTest::openFile,
+              &DdsImporterTest::openFileNonexistent,
+              &DdsImporterTest::fileCallback,
+              &DdsImporterTest::fileCallbackNotFound,
+              &DdsImporterTest::fileCallbackFailed,
+              &DdsImporterTest::zeroCopy,
+              &DdsImporterTest::zeroCopySwizzled,
+
+              &DdsImporterTest::textureCubeMap,
+              &DdsImporterTest::textureArray});
+
+    addInstancedTests({&DdsImporterTest::textureVolume},
+        Containers::arraySize(VerboseData));
+
+    addTests({&DdsImporterTest::textureZeroCopy,
+
               &DdsImporterTest::useTwice});
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
@@ -372,6 +442,35 @@ void DdsImporterTest::rgbVolume() {
     CORRADE_COMPARE(out.str(), data.message3D);
 }
 
+void DdsImporterTest::bgra() {
+    Utility::Resource resource{"DdsTestFiles"};
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    importer->setFlags(ImporterFlag::Verbose);
+    CORRADE_VERIFY(importer->openData(resource.getRaw("bgra_uncompressed.dds")));
+
+    const char pixels[] = {'\x10', '\x20', '\x30', '\x40',
+                           '\x50', '\x60', '\x70', '\x80',
+                           '\x90', '\xa0', '\xb0', '\xc0',
+                           '\xd0', '\xe0', '\xf0', '\xff',
+                           '\x01', '\x02', '\x03', '\x04',
+                           '\x05', '\x06', '\x07', '\x08'};
+
+    std::ostringstream out;
+    Containers::Optional<Trade::ImageData2D> image;
+    {
+        Debug redirectOutput{&out};
+        image = importer->image2D(0);
+    }
+    CORRADE_VERIFY(image);
+    CORRADE_VERIFY(!image->isCompressed());
+    CORRADE_COMPARE(image->size(), Vector2i(3, 2));
+    CORRADE_COMPARE(image->format(), PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE_AS(image->data(), Containers::arrayView(pixels),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(out.str(), "Trade::DdsImporter::image2D(): converting from BGRA to RGBA\n");
+}
+
 void DdsImporterTest::dxt1() {
     Utility::Resource resource{"DdsTestFiles"};
 
@@ -457,6 +556,52 @@ void DdsImporterTest::dxt10Formats3D() {
     CORRADE_COMPARE(image->format(), file.format);
 }
 
+void DdsImporterTest::dxt10Compressed() {
+    const auto& file = FilesCompressed[testCaseInstanceId()];
+    setTestCaseDescription(file.filename);
+
+    Utility::Resource resource{"Dxt10TestFiles"};
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    CORRADE_VERIFY(importer->openData(resource.getRaw(file.filename)));
+    CORRADE_COMPARE(importer->image2DLevelCount(0), 1);
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_VERIFY(image->isCompressed());
+    CORRADE_COMPARE(image->size(), Vector2i(3, 2));
+    CORRADE_COMPARE(image->compressedFormat(), file.format);
+    /* A single block */
+    CORRADE_COMPARE(image->data().size(), file.blockSize);
+    CORRADE_COMPARE(image->data()[file.blockSize - 1], char(file.blockSize - 1));
+}
+
+void DdsImporterTest::dxt10CompressedMips() {
+    const auto& file = FilesCompressedMips[testCaseInstanceId()];
+    setTestCaseDescription(file.filename);
+
+    Utility::Resource resource{"Dxt10TestFiles"};
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    CORRADE_VERIFY(importer->openData(resource.getRaw(file.filename)));
+    CORRADE_COMPARE(importer->image2DLevelCount(0), 4);
+
+    /* 8x8 has four blocks, the rest is a single block. The first byte of each
+       level is 0x40 times the level index, so a wrong offset would show. */
+    const Vector2i sizes[]{{8, 8}, {4, 4}, {2, 2}, {1, 1}};
+    const std::size_t blockCounts[]{4, 1, 1, 1};
+    for(UnsignedInt i = 0; i != 4; ++i) {
+        CORRADE_ITERATION(i);
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, i);
+        CORRADE_VERIFY(image);
+        CORRADE_VERIFY(image->isCompressed());
+        CORRADE_COMPARE(image->size(), sizes[i]);
+        CORRADE_COMPARE(image->compressedFormat(), file.format);
+        CORRADE_COMPARE(image->data().size(), blockCounts[i]*file.blockSize);
+        CORRADE_COMPARE(image->data()[0], char(i*0x40));
+    }
+}
+
 void DdsImporterTest::dxt10Data() {
     Utility::Resource resource{"Dxt10TestFiles"};
 
@@ -499,6 +644,271 @@ void DdsImporterTest::dxt10UnsupportedFormat() {
     CORRADE_COMPARE(out.str(), "Trade::DdsImporter::openData(): unsupported DXGI format 100\n");
 }
 
+void DdsImporterTest::openFile() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DDSIMPORTER_TEST_DIR, "rgba_dxt1.dds")));
+
+    const char pixels[] = {'\x76', '\xdd', '\xee', '\xcf', '\x04', '\x51', '\x04', '\x51'};
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_VERIFY(image->isCompressed());
+    CORRADE_COMPARE(image->size(), Vector2i(3, 2));
+    CORRADE_COMPARE(image->compressedFormat(), CompressedPixelFormat::Bc1RGBAUnorm);
+    CORRADE_COMPARE_AS(image->data(), Containers::arrayView(pixels),
+            TestSuite::Compare::Container);
+}
+
+void DdsImporterTest::openFileNonexistent() {
+    std::ostringstream out;
+    Error redirectError{&out};
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    CORRADE_VERIFY(!importer->openFile("nonexistent.dds"));
+    CORRADE_COMPARE(out.str(), "Trade::DdsImporter::openFile(): cannot open file nonexistent.dds\n");
+}
+
+void DdsImporterTest::fileCallback() {
+    Utility::Resource resource{"Dxt10TestFiles"};
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    CORRADE_VERIFY(importer->features() & ImporterFeature::FileCallback);
+
+    std::ostringstream out;
+    Debug redirectOutput{&out};
+
+    importer->setFileCallback([](const std::string& filename, InputFileCallbackPolicy policy, Utility::Resource& resource) {
+        Debug{} << "Loading" << filename << "with" << policy;
+        return Containers::optional(resource.getRaw(filename));
+    }, resource);
+
+    CORRADE_VERIFY(importer->openFile("2DMips_BC7_UNORM.dds"));
+    CORRADE_COMPARE(importer->image2DLevelCount(0), 4);
+
+    /* Requesting just the last level */
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, 3);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), Vector2i(1, 1));
+    CORRADE_COMPARE(image->compressedFormat(), CompressedPixelFormat::Bc7RGBAUnorm);
+    CORRADE_COMPARE(image->data()[0], char(0xc0));
+
+    importer->close();
+    CORRADE_COMPARE(out.str(),
+        "Loading 2DMips_BC7_UNORM.dds with InputFileCallbackPolicy::LoadPermanent\n"
+        "Loading 2DMips_BC7_UNORM.dds with InputFileCallbackPolicy::Close\n");
+}
+
+void DdsImporterTest::fileCallbackNotFound() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    importer->setFileCallback([](const std::string&, InputFileCallbackPolicy, void*) {
+        return Containers::Optional<Containers::ArrayView<const char>>{};
+    });
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->openFile("some-file.dds"));
+    CORRADE_COMPARE(out.str(), "Trade::DdsImporter::openFile(): cannot open file some-file.dds\n");
+}
+
+void DdsImporterTest::fileCallbackFailed() {
+    Utility::Resource resource{"DdsTestFiles"};
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+
+    std::ostringstream out;
+    Debug redirectOutput{&out};
+    Error redirectError{&out};
+
+    importer->setFileCallback([](const std::string& filename, InputFileCallbackPolicy policy, Utility::Resource& resource) {
+        Debug{} << "Loading" << filename << "with" << policy;
+        return Containers::optional(resource.getRaw(filename));
+    }, resource);
+
+    /* The callback should get told to close the file even if the import
+       fails */
+    CORRADE_VERIFY(!importer->openFile("wrong_signature.dds"));
+    CORRADE_COMPARE(out.str(),
+        "Loading wrong_signature.dds with InputFileCallbackPolicy::LoadPermanent\n"
+        "Trade::DdsImporter::openData(): wrong file signature\n"
+        "Loading wrong_signature.dds with InputFileCallbackPolicy::Close\n");
+}
+
+void DdsImporterTest::zeroCopy() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    importer->configuration().setValue("zeroCopy", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DDSIMPORTER_TEST_DIR, "rgba_dxt1.dds")));
+
+    const char pixels[] = {'\x76', '\xdd', '\xee', '\xcf', '\x04', '\x51', '\x04', '\x51'};
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_VERIFY(image->isCompressed());
+    CORRADE_COMPARE(image->size(), Vector2i(3, 2));
+    CORRADE_COMPARE(image->compressedFormat(), CompressedPixelFormat::Bc1RGBAUnorm);
+    CORRADE_COMPARE_AS(image->data(), Containers::arrayView(pixels),
+            TestSuite::Compare::Container);
+
+    /* Importing the second time should give back the same memory */
+    Containers::Optional<Trade::ImageData2D> image2 = importer->image2D(0);
+    CORRADE_VERIFY(image2);
+    CORRADE_COMPARE(static_cast<const void*>(image2->data().data()),
+        static_cast<const void*>(image->data().data()));
+}
+
+void DdsImporterTest::zeroCopySwizzled() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    importer->configuration().setValue("zeroCopy", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DDSIMPORTER_TEST_DIR, "rgb_uncompressed.dds")));
+
+    const char pixels[] = {'\xde', '\xad', '\xb5',
+                           '\xca', '\xfe', '\x77',
+                           '\xde', '\xad', '\xb5',
+                           '\xca', '\xfe', '\x77',
+                           '\xde', '\xad', '\xb5',
+                           '\xca', '\xfe', '\x77'};
+
+    /* The data need to be swizzled, so they get copied even though zero-copy
+       import was requested */
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->format(), PixelFormat::RGB8Unorm);
+    CORRADE_COMPARE_AS(image->data(), Containers::arrayView(pixels),
+        TestSuite::Compare::Container);
+
+    Containers::Optional<Trade::ImageData2D> image2 = importer->image2D(0);
+    CORRADE_VERIFY(image2);
+    CORRADE_VERIFY(image2->data().data() != image->data().data());
+    CORRADE_COMPARE_AS(image2->data(), Containers::arrayView(pixels),
+        TestSuite::Compare::Container);
+}
+
+void DdsImporterTest::textureCubeMap() {
+    Utility::Resource resource{"DdsTestFiles"};
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    CORRADE_VERIFY(importer->openData(resource.getRaw("rgba_cubemap_mips.dds")));
+
+    /* The faces are exposed one after another through image2D() */
+    CORRADE_COMPARE(importer->image2DCount(), 1);
+    CORRADE_COMPARE(importer->image2DLevelCount(0), 6*2);
+
+    DdsTextureData texture = static_cast<DdsImporter&>(*importer).texture();
+    CORRADE_COMPARE(texture.type, DdsTextureType::CubeMap);
+    CORRADE_VERIFY(!texture.compressed);
+    CORRADE_COMPARE(texture.format, PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE(texture.levels.size(), 2);
+    CORRADE_COMPARE(texture.levels[0].size, (Vector3i{2, 2, 6}));
+    CORRADE_COMPARE(texture.levels[0].offset, 0);
+    CORRADE_COMPARE(texture.levels[0].dataSize, 6*2*2*4);
+    CORRADE_COMPARE(texture.levels[1].size, (Vector3i{1, 1, 6}));
+    CORRADE_COMPARE(texture.levels[1].offset, 6*2*2*4);
+    CORRADE_COMPARE(texture.levels[1].dataSize, 6*4);
+    CORRADE_COMPARE(texture.data.size(), 6*2*2*4 + 6*4);
+
+    /* In the file each face has all its levels next to each other, in the
+       output all faces of a level are together. Each pixel is
+       {face*16 + level*8 + pixel, face, level, 0xff}. */
+    std::string expected;
+    for(char face = 0; face != 6; ++face)
+        for(char pixel = 0; pixel != 4; ++pixel)
+            expected += {char(face*16 + pixel), face, '\x00', '\xff'};
+    for(char face = 0; face != 6; ++face)
+        expected += {char(face*16 + 8), face, '\x01', '\xff'};
+    CORRADE_COMPARE_AS(texture.data, Containers::arrayView(expected.data(), expected.size()),
+        TestSuite::Compare::Container);
+}
+
+void DdsImporterTest::textureArray() {
+    Utility::Resource resource{"DdsTestFiles"};
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    CORRADE_VERIFY(importer->openData(resource.getRaw("rgba_array_dxt10.dds")));
+    CORRADE_COMPARE(importer->image2DCount(), 1);
+    CORRADE_COMPARE(importer->image2DLevelCount(0), 3*2);
+
+    DdsTextureData texture = static_cast<DdsImporter&>(*importer).texture();
+    CORRADE_COMPARE(texture.type, DdsTextureType::Texture2DArray);
+    CORRADE_VERIFY(!texture.compressed);
+    CORRADE_COMPARE(texture.format, PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE(texture.levels.size(), 2);
+    CORRADE_COMPARE(texture.levels[0].size, (Vector3i{2, 1, 3}));
+    CORRADE_COMPARE(texture.levels[0].offset, 0);
+    CORRADE_COMPARE(texture.levels[0].dataSize, 3*2*4);
+    CORRADE_COMPARE(texture.levels[1].size, (Vector3i{1, 1, 3}));
+    CORRADE_COMPARE(texture.levels[1].offset, 3*2*4);
+    CORRADE_COMPARE(texture.levels[1].dataSize, 3*4);
+
+    const char pixels[] = {
+        /* level 0, layers 0 to 2 */
+        '\x00', '\x00', '\x00', '\xff', '\x01', '\x00', '\x00', '\xff',
+        '\x10', '\x01', '\x00', '\xff', '\x11', '\x01', '\x00', '\xff',
+        '\x20', '\x02', '\x00', '\xff', '\x21', '\x02', '\x00', '\xff',
+        /* level 1, layers 0 to 2 */
+        '\x08', '\x00', '\x01', '\xff',
+        '\x18', '\x01', '\x01', '\xff',
+        '\x28', '\x02', '\x01', '\xff'};
+    CORRADE_COMPARE_AS(texture.data, Containers::arrayView(pixels),
+        TestSuite::Compare::Container);
+}
+
+void DdsImporterTest::textureVolume() {
+    auto&& data = VerboseData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Utility::Resource resource{"DdsTestFiles"};
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    importer->setFlags(data.flags);
+    importer->configuration().setValue("zeroCopy", true);
+    CORRADE_VERIFY(importer->openData(resource.getRaw("rgb_uncompressed_volume.dds")));
+
+    /* The data need to be swizzled, so they're copied even though zero-copy
+       import was requested */
+    std::ostringstream out;
+    DdsTextureData texture;
+    {
+        Debug redirectOutput{&out};
+        texture = static_cast<DdsImporter&>(*importer).texture();
+    }
+    CORRADE_COMPARE(texture.type, DdsTextureType::Texture3D);
+    CORRADE_COMPARE(texture.format, PixelFormat::RGB8Unorm);
+    CORRADE_COMPARE(texture.levels.size(), 1);
+    CORRADE_COMPARE(texture.levels[0].size, (Vector3i{3, 2, 3}));
+    CORRADE_COMPARE(texture.levels[0].dataSize, 3*2*3*3);
+    CORRADE_VERIFY(!texture.data.deleter());
+
+    Containers::Optional<Trade::ImageData3D> image = importer->image3D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE_AS(texture.data, image->data(),
+        TestSuite::Compare::Container);
+    if(data.flags & ImporterFlag::Verbose)
+        CORRADE_COMPARE(out.str(), "Trade::DdsImporter::texture(): converting from BGR to RGB\n");
+    else CORRADE_COMPARE(out.str(), "");
+}
+
+void DdsImporterTest::textureZeroCopy() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DdsImporter");
+    importer->configuration().setValue("zeroCopy", true);
+
+    /* Single layer, so the file layout matches and the data are referenced
+       directly */
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DDSIMPORTER_TEST_DIR, "Dxt10TestFiles/2DMips_R8G8B8A8_UNORM.dds")));
+    DdsTextureData texture = static_cast<DdsImporter&>(*importer).texture();
+    CORRADE_COMPARE(texture.type, DdsTextureType::Texture2D);
+    CORRADE_COMPARE(texture.levels.size(), importer->image2DLevelCount(0));
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(static_cast<const void*>(texture.data.data()),
+        static_cast<const void*>(image->data().data()));
+
+    /* More layers and levels, has to be reordered */
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DDSIMPORTER_TEST_DIR, "rgba_cubemap_mips.dds")));
+    texture = static_cast<DdsImporter&>(*importer).texture();
+    CORRADE_COMPARE(texture.type, DdsTextureType::CubeMap);
+    CORRADE_VERIFY(!texture.data.deleter());
+    CORRADE_COMPARE(texture.data.size(), 6*2*2*4 + 6*4);
+}
+
 void DdsImporterTest::useTwice() {
     Utility::Resource resource{"DdsTestFiles"};
 
@@ -26,6 +26,7 @@
 
 #include "DevIlImageImporter.h"
 
+#include <mutex>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Debug.h>
@@ -42,84 +43,22 @@
 
 namespace Magnum { namespace Trade {
 
-void DevIlImageImporter::initialize() {
-    /* You are a funny devil, DevIL. No tutorials or docs mention this function
-       (except for a tiny note at http://openil.sourceforge.net/tuts/tut_step/)
-       AND YET when I call ilLoadImage() without this, everything explodes. */
-    ilInit();
-}
+struct DevIlImageImporter::Decoded {
+    Containers::Array<Containers::Optional<ImageData2D>> images;
+};
 
-DevIlImageImporter::DevIlImageImporter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImporter{manager, plugin} {}
-
-DevIlImageImporter::~DevIlImageImporter() { close(); }
-
-ImporterFeatures DevIlImageImporter::doFeatures() const { return ImporterFeature::OpenData; }
+namespace {
 
-bool DevIlImageImporter::doIsOpened() const { return _image; }
-
-void DevIlImageImporter::doClose() {
-    ilDeleteImages(1, &_image);
-    _image = 0;
+/* DevIL has a global bound image and a global error state, so all calls
+   from all importer instances need to be serialized */
+std::mutex& devIlMutex() {
+    static std::mutex mutex;
+    return mutex;
 }
 
-/* So we can use the shorter if(!ilFoo()) */
-static_assert(!IL_FALSE, "IL_FALSE doesn't have a zero value");
-
-void DevIlImageImporter::doOpenData(const Containers::ArrayView<const char> data) {
-    UnsignedInt image;
-    ilGenImages(1, &image);
-    ilBindImage(image);
-
-    /* The documentation doesn't state if the data needs to stay in scope.
-       Let's assume so to avoid a copy on the importer side. */
-    if(!ilLoadL(configuration().value<ILenum>("type", Utility::ConfigurationValueFlag::Hex), data.begin(), data.size())) {
-        /* iluGetString() returns empty string for 0x512, which is even more
-           useless than just returning the error ID */
-        Error() << "Trade::DevIlImageImporter::openData(): cannot open the image:" << reinterpret_cast<void*>(ilGetError());
-        return;
-    }
-
-    /* All good, save the image */
-    _image = image;
-}
-
-void DevIlImageImporter::doOpenFile(const std::string& filename) {
-    UnsignedInt image;
-    ilGenImages(1, &image);
-    ilBindImage(image);
-
-    if(!ilLoad(configuration().value<ILenum>("type", Utility::ConfigurationValueFlag::Hex),
-        #ifdef CORRADE_TARGET_WINDOWS
-        Utility::Unicode::widen(filename).data()
-        #else
-        filename.data()
-        #endif
-    )) {
-        /* iluGetString() returns empty string for 0x512, which is even more
-           useless than just returning the error ID */
-        Error() << "Trade::DevIlImageImporter::openFile(): cannot open the image:" << reinterpret_cast<void*>(ilGetError());
-        return;
-    }
-
-    /* All good, save the image */
-    _image = image;
-}
-
-UnsignedInt DevIlImageImporter::doImage2DCount() const {
-    /* Bind the image. This was done above already, but since it's a global
-       state, this avoids a mismatch in case there's more than one importer
-       active at a time. */
-    ilBindImage(_image);
-    return ilGetInteger(IL_NUM_IMAGES) + 1;
-}
-
-Containers::Optional<ImageData2D> DevIlImageImporter::doImage2D(UnsignedInt id, UnsignedInt) {
-    /* Bind the image. This was done above already, but since it's a global
-       state, this avoids a mismatch in case there's more than one importer
-       active at a time. */
-    ilBindImage(_image);
-    ilActiveImage(id);
-
+/* Converts the currently active image to one of the four supported formats,
+   if needed, and copies it out. Expects the DevIL mutex to be locked. */
+Containers::Optional<ImageData2D> copyActiveImage(const char* const messagePrefix) {
     const Vector2i size{ilGetInteger(IL_IMAGE_WIDTH), ilGetInteger(IL_IMAGE_HEIGHT)};
 
     Int components;
@@ -175,13 +114,13 @@ Containers::Optional<ImageData2D> DevIlImageImporter::doImage2D(UnsignedInt id,
     if(rgbaNeeded && !ilConvertImage(components == 3 ? IL_RGB : IL_RGBA, IL_UNSIGNED_BYTE)) {
         /* iluGetString() returns empty string for 0x512, which is even
            more useless than just returning the error ID */
-        Error() << "Trade::DevIlImageImporter::image2D(): cannot convert image:" << reinterpret_cast<void*>(ilGetError());
+        Error() << messagePrefix << "cannot convert image:" << reinterpret_cast<void*>(ilGetError());
         return Containers::NullOpt;
     }
 
     /* Copy the data into array that is owned by us and not by IL. Make a 2D
        view so we can flip the image to have the origin bottom left. */
-    Containers::Array<char> imageData{std::size_t(size.product()*components)};
+    Containers::Array<char> imageData{Containers::NoInit, std::size_t(size.product()*components)};
     Containers::StridedArrayView2D<const char> src{
         Containers::arrayView(reinterpret_cast<const char*>(ilGetData()), ilGetInteger(IL_IMAGE_SIZE_OF_DATA)),
         {std::size_t(size.y()), std::size_t(size.x()*components)}};
@@ -206,6 +145,138 @@ Containers::Optional<ImageData2D> DevIlImageImporter::doImage2D(UnsignedInt id,
     return Trade::ImageData2D{storage, format, size, std::move(imageData)};
 }
 
+}
+
+void DevIlImageImporter::initialize() {
+    /* You are a funny devil, DevIL. No tutorials or docs mention this function
+       (except for a tiny note at http://openil.sourceforge.net/tuts/tut_step/)
+       AND YET when I call ilLoadImage() without this, everything explodes. */
+    ilInit();
+}
+
+DevIlImageImporter::DevIlImageImporter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImporter{manager, plugin} {}
+
+DevIlImageImporter::~DevIlImageImporter() { close(); }
+
+ImporterFeatures DevIlImageImporter::doFeatures() const { return ImporterFeature::OpenData; }
+
+bool DevIlImageImporter::doIsOpened() const { return _image || _decoded; }
+
+void DevIlImageImporter::doClose() {
+    _decoded = nullptr;
+    if(!_image) return;
+
+    std::lock_guard<std::mutex> lock{devIlMutex()};
+    ilDeleteImages(1, &_image);
+    _image = 0;
+}
+
+/* So we can use the shorter if(!ilFoo()) */
+static_assert(!IL_FALSE, "IL_FALSE doesn't have a zero value");
+
+void DevIlImageImporter::doOpenData(const Containers::ArrayView<const char> data) {
+    std::lock_guard<std::mutex> lock{devIlMutex()};
+
+    UnsignedInt image;
+    ilGenImages(1, &image);
+    ilBindImage(image);
+
+    /* The documentation doesn't state if the data needs to stay in scope.
+       Let's assume so to avoid a copy on the importer side. */
+    if(!ilLoadL(configuration().value<ILenum>("type", Utility::ConfigurationValueFlag::Hex), data.begin(), data.size())) {
+        /* iluGetString() returns empty string for 0x512, which is even more
+           useless than just returning the error ID */
+        Error() << "Trade::DevIlImageImporter::openData(): cannot open the image:" << reinterpret_cast<void*>(ilGetError());
+        ilDeleteImages(1, &image);
+        return;
+    }
+
+    finishOpening(image, "Trade::DevIlImageImporter::openData():");
+}
+
+void DevIlImageImporter::doOpenFile(const std::string& filename) {
+    std::lock_guard<std::mutex> lock{devIlMutex()};
+
+    UnsignedInt image;
+    ilGenImages(1, &image);
+    ilBindImage(image);
+
+    if(!ilLoad(configuration().value<ILenum>("type", Utility::ConfigurationValueFlag::Hex),
+        #ifdef CORRADE_TARGET_WINDOWS
+        Utility::Unicode::widen(filename).data()
+        #else
+        filename.data()
+        #endif
+    )) {
+        /* iluGetString() returns empty string for 0x512, which is even more
+           useless than just returning the error ID */
+        Error() << "Trade::DevIlImageImporter::openFile(): cannot open the image:" << reinterpret_cast<void*>(ilGetError());
+        ilDeleteImages(1, &image);
+        return;
+    }
+
+    finishOpening(image, "Trade::DevIlImageImporter::openFile():");
+}
+
+void DevIlImageImporter::finishOpening(UnsignedInt image, const char* const messagePrefix) {
+    /* Unless requested otherwise, keep the DevIL image and convert it only
+       when asked for */
+    if(!configuration().value<bool>("decodeOnOpen")) {
+        _image = image;
+        return;
+    }
+
+    /* Otherwise convert and copy out all images right away and delete the
+       DevIL image, so image2D() doesn't need to touch DevIL anymore */
+    Containers::Pointer<Decoded> decoded{new Decoded};
+    decoded->images = Containers::Array<Containers::Optional<ImageData2D>>{std::size_t(ilGetInteger(IL_NUM_IMAGES) + 1)};
+    for(std::size_t i = 0; i != decoded->images.size(); ++i) {
+        /* Bind the base image again, as ilActiveImage() is relative to the
+           currently active one */
+        ilBindImage(image);
+        ilActiveImage(i);
+        if(!(decoded->images[i] = copyActiveImage(messagePrefix))) {
+            ilDeleteImages(1, &image);
+            return;
+        }
+    }
+
+    ilDeleteImages(1, &image);
+    _decoded = std::move(decoded);
+}
+
+UnsignedInt DevIlImageImporter::doImage2DCount() const {
+    if(_decoded) return _decoded->images.size();
+
+    std::lock_guard<std::mutex> lock{devIlMutex()};
+
+    /* Bind the image. This was done above already, but since it's a global
+       state, this avoids a mismatch in case there's more than one importer
+       active at a time. */
+    ilBindImage(_image);
+    return ilGetInteger(IL_NUM_IMAGES) + 1;
+}
+
+Containers::Optional<ImageData2D> DevIlImageImporter::doImage2D(UnsignedInt id, UnsignedInt) {
+    /* Images decoded during opening, return a copy */
+    if(_decoded) {
+        const ImageData2D& image = *_decoded->images[id];
+        Containers::Array<char> data{Containers::NoInit, image.data().size()};
+        Utility::copy(image.data(), data);
+        return ImageData2D{image.storage(), image.format(), image.size(), std::move(data)};
+    }
+
+    std::lock_guard<std::mutex> lock{devIlMutex()};
+
+    /* Bind the image. This was done above already, but since it's a global
+       state, this avoids a mismatch in case there's more than one importer
+       active at a time. */
+    ilBindImage(_image);
+    ilActiveImage(id);
+
+    return copyActiveImage("Trade::DevIlImageImporter::image2D():");
+}
+
 }}
 
 CORRADE_PLUGIN_REGISTER(DevIlImageImporter, Magnum::Trade::DevIlImageImporter,
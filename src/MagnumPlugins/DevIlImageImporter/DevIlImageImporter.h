@@ -31,6 +31,7 @@
  */
 
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Magnum/Trade/AbstractImporter.h>
 
 #include "MagnumPlugins/DevIlImageImporter/configure.h"
@@ -174,6 +175,16 @@ to @ref PixelFormat::RGBA8Unorm. Images are imported with default
 @ref PixelStorage parameters except for alignment, which may be changed to `1`
 if the data require it.
 
+DevIL operates on a global state, which means all calls to it from all
+instances of this plugin are serialized with a mutex, making it possible to
+use multiple instances from different threads. By default, the image is kept
+in DevIL until the importer is closed and every @ref image2D() call converts
+and copies it while locking the mutex. If the @cb{.ini} decodeOnOpen @ce
+@ref Trade-DevIlImageImporter-configuration "configuration option" is
+enabled, all images in the file are converted during opening and the DevIL
+image is released right after, so the mutex is held only during opening and
+@ref image2D() on multiple threads doesn't contend on it at all.
+
 @subsection Trade-DevIlImageImporter-behavior-dds Compressed DDS files
 
 DDS files with BCn compression are always decompressed to RGBA on input.
@@ -225,11 +236,15 @@ class MAGNUM_DEVILIMAGEIMPORTER_EXPORT DevIlImageImporter: public AbstractImport
         MAGNUM_DEVILIMAGEIMPORTER_LOCAL void doClose() override;
         MAGNUM_DEVILIMAGEIMPORTER_LOCAL void doOpenFile(const std::string& filename) override;
         MAGNUM_DEVILIMAGEIMPORTER_LOCAL void doOpenData(Containers::ArrayView<const char> data) override;
+        MAGNUM_DEVILIMAGEIMPORTER_LOCAL void finishOpening(UnsignedInt image, const char* messagePrefix);
 
         MAGNUM_DEVILIMAGEIMPORTER_LOCAL UnsignedInt doImage2DCount() const override;
         MAGNUM_DEVILIMAGEIMPORTER_LOCAL Containers::Optional<ImageData2D> doImage2D(UnsignedInt id, UnsignedInt level) override;
 
+        struct Decoded;
+
         UnsignedInt _image = 0;
+        Containers::Pointer<Decoded> _decoded;
 };
 
 }}
@@ -39,6 +39,10 @@
 
 #include "configure.h"
 
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+#include <thread>
+#endif
+
 namespace Magnum { namespace Trade { namespace Test { namespace {
 
 struct DevIlImageImporterTest: TestSuite::Tester {
@@ -65,6 +69,10 @@ struct DevIlImageImporterTest: TestSuite::Tester {
     void openTwice();
     void importTwice();
     void twoImporters();
+    void decodeOnOpen();
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    void multipleThreads();
+    #endif
 
     void utf8Filename();
 
@@ -112,6 +120,10 @@ DevIlImageImporterTest::DevIlImageImporterTest() {
               &DevIlImageImporterTest::openTwice,
               &DevIlImageImporterTest::importTwice,
               &DevIlImageImporterTest::twoImporters,
+              &DevIlImageImporterTest::decodeOnOpen,
+              #ifndef CORRADE_TARGET_EMSCRIPTEN
+              &DevIlImageImporterTest::multipleThreads,
+              #endif
 
               &DevIlImageImporterTest::utf8Filename});
 
@@ -454,6 +466,67 @@ void DevIlImageImporterTest::twoImporters() {
     CORRADE_COMPARE(imageB->pixels<Color4ub>()[0][0], 0x87ceeb_rgb);
 }
 
+void DevIlImageImporterTest::decodeOnOpen() {
+    Containers::Pointer<AbstractImporter> reference = _manager.instantiate("DevIlImageImporter");
+    CORRADE_VERIFY(reference->openFile(Utility::Directory::join(STBIMAGEIMPORTER_TEST_DIR, "dispose_bgnd.gif")));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DevIlImageImporter");
+    importer->configuration().setValue("decodeOnOpen", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(STBIMAGEIMPORTER_TEST_DIR, "dispose_bgnd.gif")));
+    CORRADE_COMPARE(importer->image2DCount(), 5);
+
+    /* The images should be the same as when converting on demand, and the
+       same again on repeated import */
+    for(UnsignedInt i: {0, 1, 2, 3, 4, 1}) {
+        CORRADE_ITERATION(i);
+        Containers::Optional<Trade::ImageData2D> expected = reference->image2D(i);
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(i);
+        CORRADE_VERIFY(expected);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->format(), expected->format());
+        CORRADE_COMPARE(image->size(), expected->size());
+        CORRADE_COMPARE_AS(image->data(), expected->data(),
+            TestSuite::Compare::Container);
+    }
+
+    /* Closing shouldn't crash, leak or anything */
+    importer->close();
+    CORRADE_VERIFY(!importer->isOpened());
+}
+
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+void DevIlImageImporterTest::multipleThreads() {
+    /* Each thread has its own importer instance, the global DevIL state is
+       guarded by the plugin */
+    bool succeeded[4]{};
+    Color3ub pixels[4]{};
+    auto run = [&](std::size_t i) {
+        Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DevIlImageImporter");
+        importer->configuration().setValue("decodeOnOpen", i % 2 == 1);
+        for(std::size_t j = 0; j != 16; ++j) {
+            if(!importer->openFile(Utility::Directory::join(JPEGIMPORTER_TEST_DIR, "rgb.jpg")))
+                return;
+            Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+            if(!image || image->size() != Vector2i{3, 2}) return;
+            pixels[i] = image->pixels<Color3ub>()[0][0];
+        }
+        succeeded[i] = true;
+    };
+
+    std::thread threads[3];
+    for(std::size_t i = 0; i != 3; ++i)
+        threads[i] = std::thread{run, i + 1};
+    run(0);
+    for(std::thread& thread: threads) thread.join();
+
+    for(std::size_t i = 0; i != 4; ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_VERIFY(succeeded[i]);
+        CORRADE_COMPARE(pixels[i], 0xcafe76_rgb);
+    }
+}
+#endif
+
 void DevIlImageImporterTest::utf8Filename() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DevIlImageImporter");
 
@@ -26,17 +26,31 @@
 
 #include "DrFlacImporter.h"
 
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/ScopeGuard.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
-#include <Corrade/Utility/Endianness.h>
 
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Packing.h>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#elif defined(CORRADE_TARGET_ARM) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #define DR_FLAC_IMPLEMENTATION
 #define DR_FLAC_NO_STDIO /* Otherwise it includes windows.h, ugh */
 #include "dr_flac.h"
 
+#include "MagnumPlugins/Implementation/audioConversion.h"
+
 namespace Magnum { namespace Audio {
 
 namespace {
@@ -55,35 +69,430 @@ const BufferFormat flacFormatTable[8][4] = {
 };
 #undef _v
 
-/* Converts 32-bit PCM into lower bit levels by skipping bytes */
-Containers::Array<char> convert32PCM(const Containers::Array<char>& container, const UnsignedInt samples, const UnsignedInt size) {
-    Containers::Array<char> convertData(samples*size);
+/* How many samples get decoded at once in read() */
+constexpr std::size_t StreamChunkSamples = 4096;
+
+/* Size of one output sample. 24-bit samples become floats, 32-bit samples
+   doubles for mono/stereo and floats otherwise. */
+std::size_t outputSampleSize(const UnsignedInt bytesPerSample, const UnsignedInt channelCount) {
+    if(bytesPerSample == 4 && channelCount < 3) return sizeof(Double);
+    if(bytesPerSample >= 3) return sizeof(Float);
+    return bytesPerSample;
+}
+
+/* Converts 32-bit samples returned by dr_flac to the output format, which has
+   outputSampleSize() bytes per sample. The output doesn't need to be aligned.
+   Where the instruction set allows, the bulk is done four or eight samples at
+   a time, producing the exact same values as the scalar Math::unpack() in
+   the tail loops. */
+void convertSamples(const Containers::ArrayView<const Int> in, const UnsignedInt bytesPerSample, const UnsignedInt channelCount, char* const out) {
+    std::size_t i = 0;
+
+    /* 8-bit needs to become unsigned */
+    if(bytesPerSample == 1) {
+        #ifdef __SSE2__
+        const __m128i bias = _mm_set1_epi8(-128);
+        for(; i + 16 <= in.size(); i += 16) {
+            const __m128i* const src = reinterpret_cast<const __m128i*>(in + i);
+            const __m128i a = _mm_packs_epi32(
+                _mm_srai_epi32(_mm_loadu_si128(src + 0), 24),
+                _mm_srai_epi32(_mm_loadu_si128(src + 1), 24));
+            const __m128i b = _mm_packs_epi32(
+                _mm_srai_epi32(_mm_loadu_si128(src + 2), 24),
+                _mm_srai_epi32(_mm_loadu_si128(src + 3), 24));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                _mm_xor_si128(_mm_packs_epi16(a, b), bias));
+        }
+        #elif defined(CORRADE_TARGET_ARM) && defined(__ARM_NEON)
+        for(; i + 8 <= in.size(); i += 8) {
+            const int16x8_t a = vcombine_s16(
+                vshrn_n_s32(vld1q_s32(in + i + 0), 16),
+                vshrn_n_s32(vld1q_s32(in + i + 4), 16));
+            vst1_u8(reinterpret_cast<std::uint8_t*>(out + i),
+                veor_u8(vreinterpret_u8_s8(vshrn_n_s16(a, 8)), vdup_n_u8(0x80)));
+        }
+        #endif
+        for(; i != in.size(); ++i)
+            out[i] = char(UnsignedByte((in[i] >> 24) + 128));
+
+    } else if(bytesPerSample == 2) {
+        #ifdef __SSE2__
+        for(; i + 8 <= in.size(); i += 8) {
+            const __m128i* const src = reinterpret_cast<const __m128i*>(in + i);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i*sizeof(Short)),
+                _mm_packs_epi32(
+                    _mm_srai_epi32(_mm_loadu_si128(src + 0), 16),
+                    _mm_srai_epi32(_mm_loadu_si128(src + 1), 16)));
+        }
+        #elif defined(CORRADE_TARGET_ARM) && defined(__ARM_NEON)
+        for(; i + 8 <= in.size(); i += 8) {
+            vst1q_s16(reinterpret_cast<std::int16_t*>(out + i*sizeof(Short)),
+                vcombine_s16(
+                    vshrn_n_s32(vld1q_s32(in + i + 0), 16),
+                    vshrn_n_s32(vld1q_s32(in + i + 4), 16)));
+        }
+        #endif
+        for(; i != in.size(); ++i) {
+            const Short sample = in[i] >> 16;
+            std::memcpy(out + i*sizeof(Short), &sample, sizeof(Short));
+        }
+
+    /* 32-bit integers need to be normalized to Double (with a 32 bit
+       mantissa), if the channel is mono/stereo. Math::unpack() divides by the
+       max value, so the vectorized variant does as well to give the same
+       result. */
+    } else if(bytesPerSample == 4 && channelCount < 3) {
+        #ifdef __SSE2__
+        const __m128d max = _mm_set1_pd(2147483647.0);
+        const __m128d min = _mm_set1_pd(-1.0);
+        for(; i + 4 <= in.size(); i += 4) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            double* const dst = reinterpret_cast<double*>(out + i*sizeof(Double));
+            _mm_storeu_pd(dst + 0, _mm_max_pd(_mm_div_pd(_mm_cvtepi32_pd(v), max), min));
+            _mm_storeu_pd(dst + 2, _mm_max_pd(_mm_div_pd(_mm_cvtepi32_pd(_mm_srli_si128(v, 8)), max), min));
+        }
+        #elif defined(CORRADE_TARGET_ARM) && defined(__aarch64__)
+        const float64x2_t max = vdupq_n_f64(2147483647.0);
+        const float64x2_t min = vdupq_n_f64(-1.0);
+        for(; i + 4 <= in.size(); i += 4) {
+            const int32x4_t v = vld1q_s32(in + i);
+            double* const dst = reinterpret_cast<double*>(out + i*sizeof(Double));
+            vst1q_f64(dst + 0, vmaxq_f64(vdivq_f64(vcvtq_f64_s64(vmovl_s32(vget_low_s32(v))), max), min));
+            vst1q_f64(dst + 2, vmaxq_f64(vdivq_f64(vcvtq_f64_s64(vmovl_s32(vget_high_s32(v))), max), min));
+        }
+        #endif
+        for(; i != in.size(); ++i) {
+            const Double sample = Math::unpack<Double>(in[i]);
+            std::memcpy(out + i*sizeof(Double), &sample, sizeof(Double));
+        }
+
+    /* 24-bit and 32-bit with more channels need to become float. The 24-bit
+       samples have the lowest byte zero. The max value is 2^31 when
+       converted to a float, so multiplying by the inverse is exact. */
+    } else {
+        #ifdef __SSE2__
+        const __m128 scale = _mm_set1_ps(1.0f/2147483648.0f);
+        const __m128 min = _mm_set1_ps(-1.0f);
+        for(; i + 4 <= in.size(); i += 4) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            _mm_storeu_ps(reinterpret_cast<float*>(out + i*sizeof(Float)),
+                _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(v), scale), min));
+        }
+        #elif defined(CORRADE_TARGET_ARM) && defined(__ARM_NEON)
+        const float32x4_t scale = vdupq_n_f32(1.0f/2147483648.0f);
+        const float32x4_t min = vdupq_n_f32(-1.0f);
+        for(; i + 4 <= in.size(); i += 4) {
+            vst1q_f32(reinterpret_cast<float*>(out + i*sizeof(Float)),
+                vmaxq_f32(vmulq_f32(vcvtq_f32_s32(vld1q_s32(in + i)), scale), min));
+        }
+        #endif
+        for(; i != in.size(); ++i) {
+            const Float sample = Math::unpack<Float>(in[i]);
+            std::memcpy(out + i*sizeof(Float), &sample, sizeof(Float));
+        }
+    }
+}
+
+/* Decodes given count of samples in chunks of scratch.size(), returns count
+   of samples actually decoded */
+std::size_t decodeSamples(drflac* const handle, const UnsignedInt bytesPerSample, const UnsignedInt channelCount, const Containers::ArrayView<Int> scratch, const std::size_t count, char* const out) {
+    const std::size_t sampleSize = outputSampleSize(bytesPerSample, channelCount);
+
+    std::size_t samples = 0;
+    while(samples < count) {
+        const std::size_t toRead = Math::min(count - samples, scratch.size());
+        const std::size_t read = drflac_read_s32(handle, toRead, scratch.data());
+        convertSamples(scratch.prefix(read), bytesPerSample, channelCount, out + samples*sampleSize);
+        samples += read;
+
+        /* End of the stream (or an error) */
+        if(read < toRead) break;
+    }
+
+    return samples;
+}
+
+/* Returns offset of the first frame in a native FLAC stream, or 0 if the
+   data aren't a native FLAC stream or the metadata are truncated */
+std::size_t flacFirstFrameOffset(const Containers::ArrayView<const char> data) {
+    if(data.size() < 4 || std::memcmp(data, "fLaC", 4) != 0) return 0;
+
+    const auto* const bytes = reinterpret_cast<const UnsignedByte*>(data.data());
+    std::size_t offset = 4;
+    for(;;) {
+        if(offset + 4 > data.size()) return 0;
+        const bool last = bytes[offset] & 0x80;
+        offset += 4 + ((std::size_t(bytes[offset + 1]) << 16)|(std::size_t(bytes[offset + 2]) << 8)|bytes[offset + 3]);
+        if(last) break;
+    }
+
+    return offset <= data.size() ? offset : 0;
+}
+
+UnsignedByte crc8(const UnsignedByte* const data, const std::size_t size) {
+    UnsignedByte crc = 0;
+    for(std::size_t i = 0; i != size; ++i) {
+        crc ^= data[i];
+        for(std::size_t j = 0; j != 8; ++j)
+            crc = crc & 0x80 ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+    return crc;
+}
+
+/* Parses a frame header at given offset. Returns the header size and fills
+   in the frame or sample number and the block size if there's a valid
+   header consistent with the stream properties, 0 otherwise. */
+std::size_t parseFrameHeader(const Containers::ArrayView<const UnsignedByte> data, const std::size_t offset, const bool variableBlockSize, const UnsignedInt channelCount, const UnsignedInt bitsPerSample, UnsignedLong& number, UnsignedInt& blockSize) {
+    const UnsignedByte* const header = data + offset;
+    const std::size_t available = data.size() - offset;
+
+    /* Sync code, reserved bit and the blocking strategy */
+    if(available < 6 || header[0] != 0xff || header[1] != (variableBlockSize ? 0xf9 : 0xf8))
+        return 0;
+
+    const UnsignedInt blockSizeCode = header[2] >> 4;
+    const UnsignedInt sampleRateCode = header[2] & 0x0f;
+    const UnsignedInt channelAssignment = header[3] >> 4;
+    const UnsignedInt sampleSizeCode = (header[3] >> 1) & 0x07;
+    if(blockSizeCode == 0 || sampleRateCode == 0x0f || (header[3] & 0x01))
+        return 0;
+
+    /* Independent channels or one of the stereo decorrelation modes */
+    if(channelAssignment < 8 ? channelAssignment + 1 != channelCount :
+       channelAssignment > 10 || channelCount != 2)
+        return 0;
+
+    constexpr UnsignedInt SampleSizes[]{0, 8, 12, 0, 16, 20, 24, 32};
+    if(sampleSizeCode && SampleSizes[sampleSizeCode] != bitsPerSample)
+        return 0;
+
+    /* Frame or sample number, coded similarly to UTF-8 */
+    std::size_t size = 4;
+    UnsignedInt continuationBytes;
+    if(!(header[4] & 0x80)) {
+        number = header[4];
+        continuationBytes = 0;
+    } else if(header[4] == 0xfe) {
+        number = 0;
+        continuationBytes = 6;
+    } else {
+        continuationBytes = 0;
+        UnsignedByte mask = 0x40;
+        while(header[4] & mask) {
+            ++continuationBytes;
+            mask >>= 1;
+        }
+        if(!continuationBytes || continuationBytes > 5) return 0;
+        number = header[4] & (mask - 1);
+    }
+    if(available < size + 1 + continuationBytes + 3) return 0;
+    for(UnsignedInt i = 0; i != continuationBytes; ++i) {
+        if((header[5 + i] & 0xc0) != 0x80) return 0;
+        number = (number << 6)|(header[5 + i] & 0x3f);
+    }
+    size += 1 + continuationBytes;
+
+    /* Block size, possibly stored after the number */
+    if(blockSizeCode == 1) blockSize = 192;
+    else if(blockSizeCode <= 5) blockSize = 576 << (blockSizeCode - 2);
+    else if(blockSizeCode == 6) blockSize = header[size++] + 1;
+    else if(blockSizeCode == 7) {
+        blockSize = ((UnsignedInt(header[size]) << 8)|header[size + 1]) + 1;
+        size += 2;
+    } else blockSize = 256 << (blockSizeCode - 8);
+
+    /* Sample rate, possibly stored after the block size */
+    if(sampleRateCode == 12) size += 1;
+    else if(sampleRateCode == 13 || sampleRateCode == 14) size += 2;
+
+    if(available < size + 1 || crc8(header, size) != header[size])
+        return 0;
+    return size + 1;
+}
+
+/* A range of consecutive frames decoded at once */
+struct FrameRange {
+    std::size_t offset;
+    std::size_t sampleOffset;
+    std::size_t sampleCount;
+};
+
+/* Finds all frames in a native FLAC stream and groups them into at most
+   given count of ranges. The frames don't store their size, so the next
+   frame is found by looking for a valid header with the expected frame or
+   sample number. Returns an empty array if the frames can't be reliably
+   found. */
+Containers::Array<FrameRange> findFrameRanges(const Containers::ArrayView<const char> data, const std::size_t firstFrameOffset, const UnsignedInt channelCount, const UnsignedInt bitsPerSample, const std::size_t sampleCount, const std::size_t maxRangeCount) {
+    const Containers::ArrayView<const UnsignedByte> bytes = Containers::arrayCast<const UnsignedByte>(data);
+    const std::size_t channelSampleCount = sampleCount/channelCount;
+    if(firstFrameOffset + 2 > bytes.size()) return nullptr;
+    const bool variableBlockSize = bytes[firstFrameOffset + 1] == 0xf9;
+
+    /* The first frame follows right after the metadata */
+    struct Frame {
+        std::size_t offset;
+        UnsignedInt blockSize;
+    };
+    Containers::Array<Frame> frames;
+    std::size_t offset = firstFrameOffset;
+    std::size_t decodedSamples = 0;
+    UnsignedLong number;
+    UnsignedInt blockSize;
+    std::size_t headerSize = parseFrameHeader(bytes, offset, variableBlockSize, channelCount, bitsPerSample, number, blockSize);
+    if(!headerSize || number != 0) return nullptr;
+    for(;;) {
+        arrayAppend(frames, Frame{offset, blockSize});
+        decodedSamples += blockSize;
+        if(decodedSamples >= channelSampleCount) break;
+
+        /* Each subframe is at least one byte and there's a CRC-16 at the
+           end */
+        const UnsignedLong expected = variableBlockSize ? decodedSamples : frames.size();
+        std::size_t next = offset + headerSize + channelCount + 2;
+        for(; next + 1 < bytes.size(); ++next) {
+            if(bytes[next] != 0xff || (bytes[next + 1] & 0xfe) != 0xf8) continue;
+            headerSize = parseFrameHeader(bytes, next, variableBlockSize, channelCount, bitsPerSample, number, blockSize);
+            if(headerSize && number == expected) break;
+        }
+        if(next + 1 >= bytes.size()) return nullptr;
+        offset = next;
+    }
+
+    /* The block sizes have to add up to what STREAMINFO says */
+    if(decodedSamples != channelSampleCount) return nullptr;
+
+    /* Distribute the frames evenly among the ranges */
+    const std::size_t rangeCount = Math::min(maxRangeCount, frames.size());
+    Containers::Array<FrameRange> ranges{Containers::NoInit, rangeCount};
+    std::size_t sampleOffset = 0;
+    for(std::size_t i = 0; i != rangeCount; ++i) {
+        const std::size_t begin = i*frames.size()/rangeCount;
+        const std::size_t end = (i + 1)*frames.size()/rangeCount;
+        std::size_t rangeSampleCount = 0;
+        for(std::size_t j = begin; j != end; ++j)
+            rangeSampleCount += frames[j].blockSize*channelCount;
+        ranges[i] = FrameRange{frames[begin].offset, sampleOffset, rangeSampleCount};
+        sampleOffset += rangeSampleCount;
+    }
+
+    return ranges;
+}
 
-    UnsignedInt skip = -1, index = 0;
-    for(char item: container) {
-        ++skip;
+/* Presents the metadata followed by frames starting at given offset as a
+   standalone stream, so dr_flac can start decoding in the middle of the
+   file */
+struct RangeStream {
+    Containers::ArrayView<const char> data;
+    std::size_t metadataSize;
+    std::size_t offset;
+    std::size_t position;
+};
 
-        if(skip > 3) skip = 0;
-        if(skip < 4 - size) continue;
+std::size_t readRangeStream(void* const userData, void* const out, std::size_t size) {
+    RangeStream& stream = *static_cast<RangeStream*>(userData);
+    const std::size_t streamSize = stream.metadataSize + stream.data.size() - stream.offset;
+    size = Math::min(size, streamSize - stream.position);
 
-        convertData[index] = item;
-        ++index;
+    std::size_t copied = 0;
+    if(stream.position < stream.metadataSize) {
+        copied = Math::min(size, stream.metadataSize - stream.position);
+        std::memcpy(out, stream.data + stream.position, copied);
     }
+    if(copied < size)
+        std::memcpy(static_cast<char*>(out) + copied, stream.data + stream.offset + stream.position + copied - stream.metadataSize, size - copied);
+
+    stream.position += size;
+    return size;
+}
 
-    return convertData;
+bool seekRangeStream(void* const userData, const int offset, const drflac_seek_origin origin) {
+    RangeStream& stream = *static_cast<RangeStream*>(userData);
+    const std::size_t streamSize = stream.metadataSize + stream.data.size() - stream.offset;
+    const std::ptrdiff_t position = (origin == drflac_seek_origin_start ? 0 : std::ptrdiff_t(stream.position)) + offset;
+    if(position < 0 || std::size_t(position) > streamSize) return false;
+    stream.position = position;
+    return true;
 }
 
+/* Calls given function with each index in [0, count), distributing them
+   among given count of threads, with the calling thread being one of them */
+template<class Function> void forEachParallel(const std::size_t count, const std::size_t threadCount, const Function& function) {
+    std::atomic<std::size_t> next{0};
+    auto work = [&]() {
+        std::size_t i;
+        while((i = next++) < count) function(i);
+    };
+
+    Containers::Array<std::thread> threads{threadCount ? threadCount - 1 : 0};
+    for(std::thread& thread: threads) thread = std::thread{work};
+    work();
+    for(std::thread& thread: threads) thread.join();
 }
 
-DrFlacImporter::DrFlacImporter() = default;
+/* Decodes the frame ranges in parallel, each with its own decoder. Returns
+   false if any of them failed to decode exactly the expected sample
+   count. */
+bool decodeFrameRanges(const Containers::ArrayView<const char> data, const std::size_t metadataSize, const Containers::ArrayView<const FrameRange> ranges, const std::size_t threadCount, const UnsignedInt bytesPerSample, const UnsignedInt channelCount, char* const out) {
+    const std::size_t sampleSize = outputSampleSize(bytesPerSample, channelCount);
+    std::atomic<bool> failed{false};
+    forEachParallel(ranges.size(), threadCount, [&](const std::size_t i) {
+        if(failed) return;
+
+        RangeStream stream{data, metadataSize, ranges[i].offset, 0};
+        drflac* const handle = drflac_open(readRangeStream, seekRangeStream, &stream);
+        if(!handle) {
+            failed = true;
+            return;
+        }
+
+        Int scratch[StreamChunkSamples];
+        if(decodeSamples(handle, bytesPerSample, channelCount, scratch, ranges[i].sampleCount, out + ranges[i].sampleOffset*sampleSize) != ranges[i].sampleCount)
+            failed = true;
+        drflac_close(handle);
+    });
+
+    return !failed;
+}
+
+}
+
+struct DrFlacImporter::Stream {
+    ~Stream() { drflac_close(handle); }
+
+    /* Copy of the file data, dr_flac reads from it on every read() */
+    Containers::Array<char> data;
+    drflac* handle;
+    UnsignedInt bytesPerSample, channelCount;
+    Containers::Array<Int> samples;
+};
+
+DrFlacImporter::DrFlacImporter() {
+    /** @todo horrible workaround, fix this properly */
+    configuration().setValue("streaming", false);
+    configuration().setValue("frequency", 0);
+    configuration().setValue("channelCount", 0);
+    configuration().setValue("threads", 1);
+}
 
 DrFlacImporter::DrFlacImporter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImporter{manager, plugin} {}
 
+DrFlacImporter::~DrFlacImporter() = default;
+
 ImporterFeatures DrFlacImporter::doFeatures() const { return ImporterFeature::OpenData; }
 
-bool DrFlacImporter::doIsOpened() const { return !!_data; }
+bool DrFlacImporter::doIsOpened() const { return _data || _stream; }
 
 void DrFlacImporter::doOpenData(Containers::ArrayView<const char> data) {
+    /* In streaming mode dr_flac keeps reading from the data after this
+       function exits, so it needs its own copy */
+    const bool streaming = configuration().value<bool>("streaming");
+    Containers::Array<char> dataCopy;
+    if(streaming) {
+        dataCopy = Containers::Array<char>{Containers::NoInit, data.size()};
+        Utility::copy(data, dataCopy);
+        data = dataCopy;
+    }
+
     drflac* const handle = drflac_open_memory(data.data(), data.size());
     if(!handle) {
         Error() << "Audio::DrFlacImporter::openData(): failed to open and decode FLAC data";
@@ -112,85 +521,93 @@ void DrFlacImporter::doOpenData(Containers::ArrayView<const char> data) {
     _format = flacFormatTable[numChannels-1][normalizedBytesPerSample-1];
     CORRADE_INTERNAL_ASSERT(_format != BufferFormat{});
 
-    /* 32-bit integers need to be normalized to Double (with a 32 bit mantissa) */
-    if(normalizedBytesPerSample == 4) {
-        Containers::Array<Int> tempData(samples);
-        drflac_read_s32(handle, samples, reinterpret_cast<Int*>(tempData.begin()));
-
-        /* If the channel is mono/stereo, we can use double samples */
-        if(numChannels < 3) {
-            Containers::Array<Double> doubleData(samples);
-
-            for(std::size_t i = 0; i < samples; ++i) {
-                doubleData[i] = Math::unpack<Double>(tempData[i]);
-            }
-
-            const char* doubleBegin = reinterpret_cast<const char*>(doubleData.begin());
-            const char* doubleEnd = reinterpret_cast<const char*>(doubleData.end());
-
-            _data = Containers::Array<char>(samples*sizeof(Double));
-            std::copy(doubleBegin, doubleEnd, _data->begin());
-
-        /* Otherwise, convert to float */
-        } else {
-            Containers::Array<Float> floatData(samples);
-
-            for(std::size_t i = 0; i < samples; ++i) {
-                floatData[i] = Math::unpack<Float>(tempData[i]);
-            }
-
-            const char* floatBegin = reinterpret_cast<const char*>(floatData.begin());
-            const char* floatEnd = reinterpret_cast<const char*>(floatData.end());
-
-            _data = Containers::Array<char>(samples*sizeof(Float));
-            std::copy(floatBegin, floatEnd, _data->begin());
-        }
-
+    /* Keep the decoder open and decode only in read() */
+    if(streaming) {
+        Implementation::warnAudioConversionStreaming(configuration(), "Audio::DrFlacImporter::openData():", _format, _frequency);
+        _stream.emplace();
+        _stream->data = std::move(dataCopy);
+        _stream->handle = handle;
+        _stream->bytesPerSample = normalizedBytesPerSample;
+        _stream->channelCount = numChannels;
+        /* Whole frames, so read() doesn't need to deal with partial ones */
+        _stream->samples = Containers::Array<Int>{Containers::NoInit, StreamChunkSamples/numChannels*numChannels};
+        drflacClose.release();
         return;
     }
 
-    Containers::Array<char> tempData(samples*sizeof(Int));
-    drflac_read_s32(handle, samples, reinterpret_cast<Int*>(tempData.begin()));
-
-    _data = convert32PCM(tempData, samples, normalizedBytesPerSample);
-
-    /* 8-bit needs to become unsigned */
-    if(normalizedBytesPerSample == 1) {
-        for(char& item: *_data) item = item - 128;
-
-    /* 24-bit needs to become float */
-    } else if(normalizedBytesPerSample == 3) {
-        Containers::Array<Float> floatData(samples);
-
-        for(std::size_t i = 0; i != samples; ++i) {
-            const UnsignedInt s0 = (*_data)[i*3 + 0];
-            const UnsignedInt s1 = (*_data)[i*3 + 1];
-            const UnsignedInt s2 = (*_data)[i*3 + 2];
-
-            const Int intData = Int((s0 << 8) | (s1 << 16) | (s2 << 24));
-            floatData[i] = Math::unpack<Float>(intData);
-        }
+    /* Decode in chunks straight into the output, so there's never a full
+       temporary copy of the 32-bit samples. If multiple threads are
+       requested, split the stream into ranges of frames first and decode
+       each directly into its place in the output. Several ranges per thread
+       so the threads don't wait for the slowest one. If the frames can't be
+       found or decoding any range fails, fall back to decoding the whole
+       stream serially. */
+    Containers::Array<char> out{Containers::NoInit, std::size_t(samples*outputSampleSize(normalizedBytesPerSample, numChannels))};
+    std::size_t threadCount = configuration().value<std::size_t>("threads");
+    if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+    bool decoded = false;
+    if(threadCount > 1 && samples) {
+        const std::size_t metadataSize = flacFirstFrameOffset(data);
+        const Containers::Array<FrameRange> ranges = metadataSize ?
+            findFrameRanges(data, metadataSize, numChannels, bitsPerSample, samples, threadCount*4) : nullptr;
+        if(ranges.size() > 1)
+            decoded = decodeFrameRanges(data, metadataSize, ranges, Math::min(threadCount, ranges.size()), normalizedBytesPerSample, numChannels, out);
+    }
+    if(!decoded) {
+        Int scratch[StreamChunkSamples];
+        decodeSamples(handle, normalizedBytesPerSample, numChannels, scratch, samples, out.data());
+    }
 
-        const char* const floatBegin = reinterpret_cast<const char*>(floatData.begin());
-        const char* const floatEnd = reinterpret_cast<const char*>(floatData.end());
+    if(!Implementation::convertAudio(configuration(), "Audio::DrFlacImporter::openData():", _format, _frequency, out))
+        return;
 
-        _data = Containers::Array<char>(samples*sizeof(Float));
-        std::copy(floatBegin, floatEnd, _data->begin());
-    }
+    _data = std::move(out);
 }
 
-void DrFlacImporter::doClose() { _data = Containers::NullOpt; }
+void DrFlacImporter::doClose() {
+    _data = Containers::NullOpt;
+    _stream = nullptr;
+}
 
 BufferFormat DrFlacImporter::doFormat() const { return _format; }
 
 UnsignedInt DrFlacImporter::doFrequency() const { return _frequency; }
 
 Containers::Array<char> DrFlacImporter::doData() {
+    if(_stream) {
+        Error() << "Audio::DrFlacImporter::data(): the file is opened for streaming, use read() instead";
+        return nullptr;
+    }
+
     Containers::Array<char> copy(_data->size());
     std::copy(_data->begin(), _data->end(), copy.begin());
     return copy;
 }
 
+std::size_t DrFlacImporter::read(const Containers::ArrayView<char> out) {
+    CORRADE_ASSERT(_stream,
+        "Audio::DrFlacImporter::read(): no file opened for streaming", {});
+
+    const std::size_t sampleSize = outputSampleSize(_stream->bytesPerSample, _stream->channelCount);
+    /* Only whole frames */
+    const std::size_t count = out.size()/(sampleSize*_stream->channelCount)*_stream->channelCount;
+    return decodeSamples(_stream->handle, _stream->bytesPerSample, _stream->channelCount, _stream->samples, count, out)*sampleSize;
+}
+
+Containers::Array<char> DrFlacImporter::releaseData() {
+    CORRADE_ASSERT(isOpened(),
+        "Audio::DrFlacImporter::releaseData(): no file opened", {});
+
+    if(_stream) {
+        Error() << "Audio::DrFlacImporter::releaseData(): the file is opened for streaming, use read() instead";
+        return nullptr;
+    }
+
+    Containers::Array<char> out = std::move(*_data);
+    close();
+    return out;
+}
+
 }}
 
 CORRADE_PLUGIN_REGISTER(DrFlacAudioImporter, Magnum::Audio::DrFlacImporter,
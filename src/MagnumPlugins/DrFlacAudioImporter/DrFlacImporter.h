@@ -32,6 +32,7 @@
 
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Magnum/Audio/AbstractImporter.h>
 
 #include "MagnumPlugins/DrFlacAudioImporter/configure.h"
@@ -124,6 +125,52 @@ target_link_libraries(your-app PRIVATE MagnumPlugins::DrFlacAudioImporter)
 
 See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
 information.
+
+@section Audio-DrFlacImporter-streaming Streaming
+
+By default the whole file is decoded in @ref openData() / @ref openFile(). If
+the @cb{.ini} streaming @ce @ref Audio-DrFlacImporter-configuration "configuration option"
+is enabled, only the header is parsed on opening and samples are decoded in
+chunks via @ref read() into a caller-provided buffer, in the same format as
+@ref data() would return. The file data are copied and kept for the whole time
+the file is opened. Calling @ref data() on a file opened for streaming prints
+a message to @ref Error and returns an empty array.
+
+@section Audio-DrFlacImporter-threads Multi-threaded decoding
+
+FLAC frames are independent of each other, so long files can be decoded in
+parallel. If the @cb{.ini} threads @ce
+@ref Audio-DrFlacImporter-configuration "configuration option" is set to a
+value other than @cpp 1 @ce, @ref openData() / @ref openFile() first scans
+the stream for frame headers, splits the frames into a few ranges per thread
+and decodes each range with a separate decoder directly into its place in the
+output. The result is the same as with serial decoding. Frames don't store
+their size, so each next one is found by looking for a header with a valid
+CRC and the expected frame or sample number. If that fails, for example for
+truncated files, Ogg-encapsulated streams or files with just a single
+frame, the whole file is decoded serially as usual. The option is ignored in
+streaming mode. The application needs to link to `pthread` on Linux due to
+the same reasons as described in
+@ref Trade-BasisImageConverter-loading "BasisImageConverter docs".
+
+@section Audio-DrFlacImporter-conversion Frequency and channel count conversion
+
+If the @cb{.ini} frequency @ce or @cb{.ini} channelCount @ce
+@ref Audio-DrFlacImporter-configuration "configuration options" are set, the samples
+are converted right after decoding in @ref openData() / @ref openFile(), so
+@ref data() returns them already in the target format. Resampling uses a
+windowed-sinc polyphase filter, vectorized with SSE2 or NEON where available.
+Channels are mixed through a stereo downmix, with stereo going to the front
+left and right channels of multi-channel outputs. The sample type is kept,
+except for doubles with more than two channels, which become floats. The
+options are ignored with a warning in streaming mode.
+
+@section Audio-DrFlacImporter-configuration Plugin-specific configuration
+
+It's possible to tune various import options through @ref configuration(). See
+below for all options and their default values:
+
+@snippet MagnumPlugins/DrFlacAudioImporter/DrFlacAudioImporter.conf config
 */
 class MAGNUM_DRFLACAUDIOIMPORTER_EXPORT DrFlacImporter: public AbstractImporter {
     public:
@@ -133,7 +180,38 @@ class MAGNUM_DRFLACAUDIOIMPORTER_EXPORT DrFlacImporter: public AbstractImporter
         /** @brief Plugin manager constructor */
         explicit DrFlacImporter(PluginManager::AbstractManager& manager, const std::string& plugin);
 
+        ~DrFlacImporter();
+
+        /**
+         * @brief Decode next chunk of samples
+         * @m_since_latest_{plugins}
+         *
+         * Expects that a file is opened with the @cb{.ini} streaming @ce
+         * @ref Audio-DrFlacImporter-configuration "configuration option"
+         * enabled. Decodes as many whole sample frames as fit into @p out,
+         * in the same format as @ref data() would return, and returns the
+         * count of bytes written. If the returned value is less than the
+         * size of @p out rounded down to whole frames, the end of the stream
+         * was reached. See @ref Audio-DrFlacImporter-streaming for more
+         * information.
+         */
+        virtual std::size_t read(Containers::ArrayView<char> out);
+
+        /**
+         * @brief Release the decoded data
+         * @m_since_latest_{plugins}
+         *
+         * Compared to @ref data(), which returns a copy, moves the decoded
+         * data out and closes the file, so there's never more than one copy
+         * of the samples alive. Expects that a file is opened. If the file is
+         * opened for streaming, prints a message to @ref Error and returns
+         * an empty array.
+         */
+        virtual Containers::Array<char> releaseData();
+
     private:
+        struct Stream;
+
         MAGNUM_DRFLACAUDIOIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_DRFLACAUDIOIMPORTER_LOCAL bool doIsOpened() const override;
         MAGNUM_DRFLACAUDIOIMPORTER_LOCAL void doOpenData(Containers::ArrayView<const char> data) override;
@@ -144,6 +222,7 @@ class MAGNUM_DRFLACAUDIOIMPORTER_EXPORT DrFlacImporter: public AbstractImporter
         MAGNUM_DRFLACAUDIOIMPORTER_LOCAL Containers::Array<char> doData() override;
 
         Containers::Optional<Containers::Array<char>> _data;
+        Containers::Pointer<Stream> _stream;
         BufferFormat _format;
         UnsignedInt _frequency;
 };
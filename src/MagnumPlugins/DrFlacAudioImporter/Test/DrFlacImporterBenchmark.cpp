@@ -0,0 +1,171 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/Directory.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Magnum/Audio/AbstractImporter.h>
+
+#include "MagnumPlugins/DrFlacAudioImporter/DrFlacImporter.h"
+#include "MagnumPlugins/Implementation/audioConversion.h"
+#include "MagnumPlugins/Implementation/peakMemory.h"
+
+#include "configure.h"
+
+namespace Magnum { namespace Audio { namespace Test { namespace {
+
+struct DrFlacImporterBenchmark: TestSuite::Tester {
+    explicit DrFlacImporterBenchmark();
+
+    void decode();
+    void firstSample();
+    void peakMemory();
+
+    void peakMemoryBegin();
+    std::uint64_t peakMemoryEnd();
+
+    /* Explicitly forbid system-wide plugin dependencies */
+    PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
+
+    std::uint64_t _residentSizeBefore{};
+};
+
+/* To calculate the throughput in samples per second, divide the sample frame
+   count shown in the decode() test case description by the measured time */
+constexpr struct {
+    const char* name;
+    const char* filename;
+} ClipData[]{
+    {"16-bit quad", "quad16.flac"},
+    {"16-bit 5.1", "surround51Channel16.flac"},
+    {"24-bit 5.1", "surround51Channel24.flac"}
+};
+
+Containers::Array<char> clip(const char* const filename) {
+    return Utility::Directory::read(Utility::Directory::join(DRFLACAUDIOIMPORTER_TEST_DIR, filename));
+}
+
+std::size_t frameCount(const BufferFormat format, const std::size_t size) {
+    Implementation::AudioSampleType type;
+    UnsignedInt channelCount;
+    CORRADE_INTERNAL_ASSERT_OUTPUT(Implementation::audioFormatProperties(format, type, channelCount));
+    return size/(Implementation::audioSampleSize(type)*channelCount);
+}
+
+DrFlacImporterBenchmark::DrFlacImporterBenchmark() {
+    addInstancedBenchmarks({&DrFlacImporterBenchmark::decode}, 10,
+        Containers::arraySize(ClipData));
+
+    addInstancedBenchmarks({&DrFlacImporterBenchmark::firstSample}, 10,
+        Containers::arraySize(ClipData));
+
+    addCustomInstancedBenchmarks({&DrFlacImporterBenchmark::peakMemory}, 1,
+        Containers::arraySize(ClipData),
+        &DrFlacImporterBenchmark::peakMemoryBegin,
+        &DrFlacImporterBenchmark::peakMemoryEnd,
+        BenchmarkUnits::Bytes);
+
+    /* Load the plugin directly from the build tree. Otherwise it's static and
+       already loaded. */
+    #ifdef DRFLACAUDIOIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(DRFLACAUDIOIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+void DrFlacImporterBenchmark::decode() {
+    auto&& data = ClipData[testCaseInstanceId()];
+
+    const Containers::Array<char> file = clip(data.filename);
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrFlacAudioImporter");
+    CORRADE_VERIFY(importer->openData(file));
+    setTestCaseDescription(Utility::formatString("{}, {} frames at {} Hz",
+        data.name, frameCount(importer->format(), importer->data().size()),
+        importer->frequency()));
+
+    Containers::Array<char> out;
+    CORRADE_BENCHMARK(1) {
+        importer->openData(file);
+        out = static_cast<DrFlacImporter&>(*importer).releaseData();
+    }
+
+    CORRADE_VERIFY(out);
+}
+
+void DrFlacImporterBenchmark::firstSample() {
+    auto&& data = ClipData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const Containers::Array<char> file = clip(data.filename);
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrFlacAudioImporter");
+    importer->configuration().setValue("streaming", true);
+
+    /* Large enough for a single frame of any format */
+    char sample[64];
+    std::size_t size = 0;
+    CORRADE_BENCHMARK(1) {
+        importer->openData(file);
+        size = static_cast<DrFlacImporter&>(*importer).read(sample);
+    }
+
+    CORRADE_VERIFY(size);
+}
+
+void DrFlacImporterBenchmark::peakMemory() {
+    auto&& data = ClipData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifndef __linux__
+    CORRADE_SKIP("Peak memory can be measured only on Linux.");
+    #else
+    /* The input is loaded outside of the measured region, so only the memory
+       allocated by the decoder and for the output is counted */
+    const Containers::Array<char> file = clip(data.filename);
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrFlacAudioImporter");
+
+    Containers::Array<char> out;
+    CORRADE_BENCHMARK(1) {
+        importer->openData(file);
+        out = static_cast<DrFlacImporter&>(*importer).releaseData();
+    }
+
+    CORRADE_VERIFY(out);
+    #endif
+}
+
+void DrFlacImporterBenchmark::peakMemoryBegin() {
+    _residentSizeBefore = Magnum::Implementation::peakMemoryBegin();
+}
+
+std::uint64_t DrFlacImporterBenchmark::peakMemoryEnd() {
+    return Magnum::Implementation::peakMemoryEnd(_residentSizeBefore);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Audio::Test::DrFlacImporterBenchmark)
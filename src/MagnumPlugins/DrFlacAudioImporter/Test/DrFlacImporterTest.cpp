@@ -28,10 +28,13 @@
 #include <Corrade/Containers/Array.h>
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Directory.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Magnum/Audio/AbstractImporter.h>
 
+#include "MagnumPlugins/DrFlacAudioImporter/DrFlacImporter.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Audio { namespace Test { namespace {
@@ -59,10 +62,41 @@ struct DrFlacImporterTest: TestSuite::Tester {
 
     void surround71Channel24();
 
+    void streaming();
+    void streamingData();
+
+    void releaseData();
+
+    void convert();
+
+    void threads();
+    void threadsFallback();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
 };
 
+constexpr struct {
+    const char* name;
+    const char* filename;
+    std::size_t chunkSize;
+} StreamingData[]{
+    {"8-bit", "mono8.flac", 1000},
+    {"16-bit, whole file in one chunk", "stereo16.flac", 256},
+    {"24-bit, chunk not a multiple of frame size", "mono24.flac", 1001},
+    {"24-bit, chunk larger than the internal buffer", "stereo24.flac", 65536},
+    {"24-bit quad, chunk not a multiple of frame size", "quad24.flac", 4099}
+};
+
+constexpr struct {
+    const char* name;
+    UnsignedInt threads;
+} ThreadsData[]{
+    {"single-threaded", 1},
+    {"four threads", 4},
+    {"all threads", 0}
+};
+
 DrFlacImporterTest::DrFlacImporterTest() {
     addTests({&DrFlacImporterTest::empty,
 
@@ -84,6 +118,20 @@ DrFlacImporterTest::DrFlacImporterTest() {
 
               &DrFlacImporterTest::surround71Channel24});
 
+    addInstancedTests({&DrFlacImporterTest::streaming},
+        Containers::arraySize(StreamingData));
+
+    addTests({&DrFlacImporterTest::streamingData,
+
+              &DrFlacImporterTest::releaseData,
+
+              &DrFlacImporterTest::convert});
+
+    addInstancedTests({&DrFlacImporterTest::threads},
+        Containers::arraySize(ThreadsData));
+
+    addTests({&DrFlacImporterTest::threadsFallback});
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef DRFLACAUDIOIMPORTER_PLUGIN_FILENAME
@@ -231,6 +279,115 @@ void DrFlacImporterTest::surround71Channel24() {
     CORRADE_COMPARE(importer->frequency(), 48000);
 }
 
+void DrFlacImporterTest::streaming() {
+    auto&& data = StreamingData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Decode the whole file first to have something to compare to */
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrFlacAudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DRFLACAUDIOIMPORTER_TEST_DIR, data.filename)));
+    Containers::Array<char> expected = importer->data();
+
+    Containers::Pointer<AbstractImporter> streamingImporter = _manager.instantiate("DrFlacAudioImporter");
+    streamingImporter->configuration().setValue("streaming", true);
+    CORRADE_VERIFY(streamingImporter->openFile(Utility::Directory::join(DRFLACAUDIOIMPORTER_TEST_DIR, data.filename)));
+    CORRADE_COMPARE(streamingImporter->format(), importer->format());
+    CORRADE_COMPARE(streamingImporter->frequency(), importer->frequency());
+
+    Containers::Array<char> out{Containers::NoInit, expected.size() + data.chunkSize};
+    std::size_t size = 0;
+    while(size + data.chunkSize <= out.size()) {
+        const std::size_t read = static_cast<DrFlacImporter&>(*streamingImporter).read(out.slice(size, size + data.chunkSize));
+        if(!read) break;
+        size += read;
+    }
+
+    CORRADE_COMPARE_AS(out.prefix(size), expected,
+        TestSuite::Compare::Container);
+}
+
+void DrFlacImporterTest::streamingData() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrFlacAudioImporter");
+    importer->configuration().setValue("streaming", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DRFLACAUDIOIMPORTER_TEST_DIR, "mono8.flac")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(importer->data().empty());
+    CORRADE_COMPARE(out.str(), "Audio::DrFlacImporter::data(): the file is opened for streaming, use read() instead\n");
+}
+
+void DrFlacImporterTest::releaseData() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrFlacAudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DRFLACAUDIOIMPORTER_TEST_DIR, "mono24.flac")));
+
+    Containers::Array<char> expected = importer->data();
+    Containers::Array<char> data = static_cast<DrFlacImporter&>(*importer).releaseData();
+    CORRADE_COMPARE_AS(data, expected,
+        TestSuite::Compare::Container);
+
+    /* The file gets closed after */
+    CORRADE_VERIFY(!importer->isOpened());
+}
+
+void DrFlacImporterTest::convert() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrFlacAudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DRFLACAUDIOIMPORTER_TEST_DIR, "surround51Channel16.flac")));
+    CORRADE_COMPARE(importer->format(), BufferFormat::Surround51Channel16);
+    const UnsignedInt frequency = importer->frequency();
+    const std::size_t frameCount = importer->data().size()/(6*2);
+
+    /* The conversion itself is tested in DrWavAudioImporter, here it's just
+       about the options being propagated */
+    importer->configuration().setValue("frequency", frequency*2);
+    importer->configuration().setValue("channelCount", 2);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DRFLACAUDIOIMPORTER_TEST_DIR, "surround51Channel16.flac")));
+    CORRADE_COMPARE(importer->format(), BufferFormat::Stereo16);
+    CORRADE_COMPARE(importer->frequency(), frequency*2);
+    /* Twice the frames, each having two channels of 16-bit samples */
+    CORRADE_COMPARE(importer->data().size(), frameCount*2*2*2);
+}
+
+void DrFlacImporterTest::threads() {
+    auto&& data = ThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrFlacAudioImporter");
+    importer->configuration().setValue("threads", data.threads);
+
+    /* Ten frames of verbatim samples, the last one shorter, generated by
+       generate-frames.py */
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DRFLACAUDIOIMPORTER_TEST_DIR, "stereo16Frames.flac")));
+    CORRADE_COMPARE(importer->format(), BufferFormat::Stereo16);
+    CORRADE_COMPARE(importer->frequency(), 44100);
+
+    Short expected[616*2];
+    for(std::size_t i = 0; i != 616; ++i) {
+        expected[i*2 + 0] = Short(Int(i*1237 % 65536) - 32768);
+        expected[i*2 + 1] = Short(32767 - Int(i*311 % 65536));
+    }
+    Containers::Array<char> samples = importer->data();
+    CORRADE_COMPARE_AS(Containers::arrayCast<const Short>(samples),
+        Containers::arrayView(expected),
+        TestSuite::Compare::Container);
+}
+
+void DrFlacImporterTest::threadsFallback() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrFlacAudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DRFLACAUDIOIMPORTER_TEST_DIR, "stereo24.flac")));
+    Containers::Array<char> expected = importer->data();
+
+    /* The file is truncated after the first frame, so the frame ranges can't
+       be found and it's decoded serially, giving the same output */
+    importer->configuration().setValue("threads", 4);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DRFLACAUDIOIMPORTER_TEST_DIR, "stereo24.flac")));
+    Containers::Array<char> data = importer->data();
+    CORRADE_COMPARE(data.size(), expected.size());
+    CORRADE_COMPARE_AS(data.prefix(4096*2*4),
+        expected.prefix(4096*2*4),
+        TestSuite::Compare::Container<Containers::ArrayView<const char>>);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Audio::Test::DrFlacImporterTest)
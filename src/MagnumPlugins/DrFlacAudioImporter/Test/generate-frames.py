@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+
+#
+#   This file is part of Magnum.
+#
+#   Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+#               2020 Vladimír Vondruš <mosra@centrum.cz>
+#
+#   Permission is hereby granted, free of charge, to any person obtaining a
+#   copy of this software and associated documentation files (the "Software"),
+#   to deal in the Software without restriction, including without limitation
+#   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+#   and/or sell copies of the Software, and to permit persons to whom the
+#   Software is furnished to do so, subject to the following conditions:
+#
+#   The above copyright notice and this permission notice shall be included
+#   in all copies or substantial portions of the Software.
+#
+#   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+#   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+#   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+#   DEALINGS IN THE SOFTWARE.
+#
+
+# Generates stereo16Frames.flac, a stereo 16-bit file with many small frames
+# of verbatim subframes for testing the multi-threaded decoding. The samples
+# are the same as calculated in DrFlacImporterTest::threads().
+
+import struct
+
+block_size = 64
+sample_count = 616
+
+def left(i): return (i*1237) % 65536 - 32768
+def right(i): return 32767 - (i*311) % 65536
+
+def crc8(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07 if crc & 0x80 else crc << 1) & 0xff
+    return crc
+
+def crc16(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x8005 if crc & 0x8000 else crc << 1) & 0xffff
+    return crc
+
+out = bytearray(b'fLaC')
+
+# Last-metadata-block flag, STREAMINFO type, 34 bytes. Frame sizes and MD5
+# are left unknown.
+out += bytes([0x80, 0, 0, 34])
+out += struct.pack('>HH', block_size, block_size)
+out += bytes(6)
+out += ((44100 << 44) | (1 << 41) | (15 << 36) | sample_count).to_bytes(8, 'big')
+out += bytes(16)
+
+for frame, begin in enumerate(range(0, sample_count, block_size)):
+    count = min(block_size, sample_count - begin)
+
+    # Fixed block size, block size in an extra byte, sample rate from
+    # STREAMINFO, independent stereo, 16 bits per sample, frame number
+    header = bytes([0xff, 0xf8, 0x60, 0x18, frame, count - 1])
+    header += bytes([crc8(header)])
+
+    # A verbatim subframe for each channel
+    body = bytes([0x02]) + b''.join(struct.pack('>h', left(i)) for i in range(begin, begin + count))
+    body += bytes([0x02]) + b''.join(struct.pack('>h', right(i)) for i in range(begin, begin + count))
+
+    data = header + body
+    out += data + struct.pack('>H', crc16(data))
+
+with open('stereo16Frames.flac', 'wb') as f:
+    f.write(out)
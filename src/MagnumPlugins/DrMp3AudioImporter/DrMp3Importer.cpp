@@ -27,15 +27,20 @@
 #include "DrMp3Importer.h"
 
 #include <Corrade/Containers/ScopeGuard.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
 #include <Corrade/Utility/Endianness.h>
 
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Packing.h>
 
 #define DR_MP3_IMPLEMENTATION
 #include "dr_mp3.h"
 
+#include "MagnumPlugins/Implementation/audioConversion.h"
+
 namespace Magnum { namespace Audio {
 
 namespace {
@@ -54,19 +59,84 @@ const BufferFormat mp3FormatTable[8][4] = {
 };
 #undef _v
 
+bool checkChannelCount(const UnsignedInt numChannels) {
+    if(numChannels == 0 || numChannels == 3 || numChannels == 5 || numChannels > 8) {
+        Error() << "Audio::DrMp3Importer::openData(): unsupported channel count"
+                << numChannels;
+        return false;
+    }
+
+    return true;
 }
 
-DrMp3Importer::DrMp3Importer() = default;
+}
+
+struct DrMp3Importer::Stream {
+    ~Stream() { if(initialized) drmp3_uninit(&mp3); }
+
+    /* Copy of the file data, dr_mp3 reads from it on every read() */
+    Containers::Array<char> data;
+    /* Points to itself internally, so it has to be initialized in-place */
+    drmp3 mp3;
+    bool initialized = false;
+    /* Referenced by the decoder if the seekPoints option is set */
+    Containers::Array<drmp3_seek_point> seekPoints;
+    /* Calculated on the first frameCount() call */
+    Containers::Optional<UnsignedLong> frameCount;
+};
+
+DrMp3Importer::DrMp3Importer() {
+    /** @todo horrible workaround, fix this properly */
+    configuration().setValue("streaming", false);
+    configuration().setValue("seekPoints", 0);
+    configuration().setValue("frequency", 0);
+    configuration().setValue("channelCount", 0);
+}
 
 DrMp3Importer::DrMp3Importer(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImporter{manager, plugin} {}
 
+DrMp3Importer::~DrMp3Importer() = default;
+
 ImporterFeatures DrMp3Importer::doFeatures() const { return ImporterFeature::OpenData; }
 
-bool DrMp3Importer::doIsOpened() const { return !!_data; }
+bool DrMp3Importer::doIsOpened() const { return _data || _stream; }
 
 void DrMp3Importer::doOpenData(Containers::ArrayView<const char> data) {
     drmp3_config config;
     config.outputChannels = config.outputSampleRate = 0;
+
+    /* Keep the decoder open and decode only in read(). It reads from the data
+       after this function exits, so it needs its own copy. */
+    if(configuration().value<bool>("streaming")) {
+        Containers::Pointer<Stream> stream{new Stream};
+        stream->data = Containers::Array<char>{Containers::NoInit, data.size()};
+        Utility::copy(data, stream->data);
+        if(!(stream->initialized = drmp3_init_memory(&stream->mp3, stream->data.data(), stream->data.size(), &config))) {
+            Error() << "Audio::DrMp3Importer::openData(): failed to open and decode MP3 data";
+            return;
+        }
+
+        if(!checkChannelCount(stream->mp3.channels)) return;
+
+        /* Build the seek table, if requested. This goes only through frame
+           headers, without decoding the samples themselves. */
+        if(UnsignedInt seekPointCount = configuration().value<UnsignedInt>("seekPoints")) {
+            stream->seekPoints = Containers::Array<drmp3_seek_point>{Containers::NoInit, seekPointCount};
+            if(!drmp3_calculate_seek_points(&stream->mp3, &seekPointCount, stream->seekPoints)) {
+                Error() << "Audio::DrMp3Importer::openData(): can't calculate seek points";
+                return;
+            }
+            drmp3_bind_seek_table(&stream->mp3, seekPointCount, stream->seekPoints);
+        }
+
+        _frequency = stream->mp3.sampleRate;
+        _format = mp3FormatTable[stream->mp3.channels - 1][1];
+        CORRADE_INTERNAL_ASSERT(_format != BufferFormat{});
+        Implementation::warnAudioConversionStreaming(configuration(), "Audio::DrMp3Importer::openData():", _format, _frequency);
+        _stream = std::move(stream);
+        return;
+    }
+
     drmp3_uint64 frameCount;
 
     drmp3_int16* decodedData = drmp3_open_memory_and_read_s16(data.data(), data.size(), &config, &frameCount);
@@ -80,35 +150,104 @@ void DrMp3Importer::doOpenData(Containers::ArrayView<const char> data) {
 
     const std::uint32_t numChannels = config.outputChannels;
 
-    if(numChannels == 0 || numChannels == 3 || numChannels == 5 || numChannels > 8) {
-        Error() << "Audio::DrMp3Importer::openData(): unsupported channel count"
-                << numChannels;
-        return;
-    }
+    if(!checkChannelCount(numChannels)) return;
 
     _frequency = config.outputSampleRate;
     _format = mp3FormatTable[numChannels - 1][1];
     CORRADE_INTERNAL_ASSERT(_format != BufferFormat{});
 
+    /* The frame count is for all channels together */
     const char* const dataBegin = reinterpret_cast<const char*>(decodedData);
-    const char* const dataEnd = reinterpret_cast<const char*>(decodedData + frameCount);
+    const char* const dataEnd = reinterpret_cast<const char*>(decodedData + frameCount*numChannels);
+
+    Containers::Array<char> out{Containers::NoInit, std::size_t(frameCount*numChannels*sizeof(Short))};
+    std::copy(dataBegin, dataEnd, out.begin());
 
-    _data = Containers::Array<char>(frameCount*sizeof(Short));
-    std::copy(dataBegin, dataEnd, _data->begin());
+    if(!Implementation::convertAudio(configuration(), "Audio::DrMp3Importer::openData():", _format, _frequency, out))
+        return;
+
+    _data = std::move(out);
 }
 
-void DrMp3Importer::doClose() { _data = Containers::NullOpt; }
+void DrMp3Importer::doClose() {
+    _data = Containers::NullOpt;
+    _stream = nullptr;
+}
 
 BufferFormat DrMp3Importer::doFormat() const { return _format; }
 
 UnsignedInt DrMp3Importer::doFrequency() const { return _frequency; }
 
 Containers::Array<char> DrMp3Importer::doData() {
+    if(_stream) {
+        Error() << "Audio::DrMp3Importer::data(): the file is opened for streaming, use read() instead";
+        return nullptr;
+    }
+
     Containers::Array<char> copy(_data->size());
     std::copy(_data->begin(), _data->end(), copy.begin());
     return copy;
 }
 
+std::size_t DrMp3Importer::read(const Containers::ArrayView<char> out) {
+    CORRADE_ASSERT(_stream,
+        "Audio::DrMp3Importer::read(): no file opened for streaming", {});
+
+    /* The output is interleaved 16-bit, so dr_mp3 can write there directly.
+       Only whole frames, and the output view might not be aligned. */
+    const std::size_t frameSize = _stream->mp3.channels*sizeof(Short);
+    std::size_t frames = 0;
+    const std::size_t maxFrames = out.size()/frameSize;
+    drmp3_int16 samples[4096];
+    const std::size_t chunkFrames = Containers::arraySize(samples)/_stream->mp3.channels;
+    while(frames < maxFrames) {
+        const std::size_t toRead = Math::min(maxFrames - frames, chunkFrames);
+        const std::size_t read = drmp3_read_pcm_frames_s16(&_stream->mp3, toRead, samples);
+        Utility::copy(Containers::arrayView(reinterpret_cast<const char*>(samples), read*frameSize), out.slice(frames*frameSize, (frames + read)*frameSize));
+        frames += read;
+
+        /* End of the stream (or an error) */
+        if(read < toRead) break;
+    }
+
+    return frames*frameSize;
+}
+
+UnsignedLong DrMp3Importer::frameCount() {
+    CORRADE_ASSERT(_stream,
+        "Audio::DrMp3Importer::frameCount(): no file opened for streaming", {});
+
+    if(!_stream->frameCount)
+        _stream->frameCount = drmp3_get_pcm_frame_count(&_stream->mp3);
+    return *_stream->frameCount;
+}
+
+bool DrMp3Importer::seek(const UnsignedLong frame) {
+    CORRADE_ASSERT(_stream,
+        "Audio::DrMp3Importer::seek(): no file opened for streaming", {});
+
+    if(!drmp3_seek_to_pcm_frame(&_stream->mp3, frame)) {
+        Error() << "Audio::DrMp3Importer::seek(): can't seek to frame" << frame;
+        return false;
+    }
+
+    return true;
+}
+
+Containers::Array<char> DrMp3Importer::releaseData() {
+    CORRADE_ASSERT(isOpened(),
+        "Audio::DrMp3Importer::releaseData(): no file opened", {});
+
+    if(_stream) {
+        Error() << "Audio::DrMp3Importer::releaseData(): the file is opened for streaming, use read() instead";
+        return nullptr;
+    }
+
+    Containers::Array<char> out = std::move(*_data);
+    close();
+    return out;
+}
+
 }}
 
 CORRADE_PLUGIN_REGISTER(DrMp3AudioImporter, Magnum::Audio::DrMp3Importer,
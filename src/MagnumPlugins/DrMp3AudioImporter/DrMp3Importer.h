@@ -33,6 +33,7 @@
 
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Magnum/Audio/AbstractImporter.h>
 
 #include "MagnumPlugins/DrMp3AudioImporter/configure.h"
@@ -116,6 +117,47 @@ target_link_libraries(your-app PRIVATE MagnumPlugins::DrMp3AudioImporter)
 
 See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
 information.
+
+@section Audio-DrMp3Importer-streaming Streaming
+
+By default the whole file is decoded in @ref openData() / @ref openFile(). If
+the @cb{.ini} streaming @ce @ref Audio-DrMp3Importer-configuration "configuration option"
+is enabled, only the header is parsed on opening and samples are decoded in
+chunks via @ref read() into a caller-provided buffer, in the same format as
+@ref data() would return. The file data are copied and kept for the whole time
+the file is opened. Calling @ref data() on a file opened for streaming prints
+a message to @ref Error and returns an empty array.
+
+@subsection Audio-DrMp3Importer-streaming-seeking Seeking
+
+In streaming mode, @ref seek() moves the decoder to given sample frame,
+subsequent @ref read() calls then decode from there. Together with
+@ref frameCount() this can be used for decoding just a particular range of a
+long file. By default, seeking decodes the file from the start, or from the
+current position if seeking forward. If the @cb{.ini} seekPoints @ce
+@ref Audio-DrMp3Importer-configuration "configuration option" is set to a
+non-zero value, a seek table with given count of evenly distributed points is
+built on opening by going only through MP3 frame headers. Seeking then
+decodes just a few MP3 frames before the target position, making random
+access into long files cheap. The seeking is sample-accurate in both cases.
+
+@section Audio-DrMp3Importer-conversion Frequency and channel count conversion
+
+If the @cb{.ini} frequency @ce or @cb{.ini} channelCount @ce
+@ref Audio-DrMp3Importer-configuration "configuration options" are set, the samples
+are converted right after decoding in @ref openData() / @ref openFile(), so
+@ref data() returns them already in the target format. Resampling uses a
+windowed-sinc polyphase filter, vectorized with SSE2 or NEON where available.
+Channels are mixed through a stereo downmix, with stereo going to the front
+left and right channels of multi-channel outputs. The output stays 16-bit. The
+options are ignored with a warning in streaming mode.
+
+@section Audio-DrMp3Importer-configuration Plugin-specific configuration
+
+It's possible to tune various import options through @ref configuration(). See
+below for all options and their default values:
+
+@snippet MagnumPlugins/DrMp3AudioImporter/DrMp3AudioImporter.conf config
 */
 class MAGNUM_DRMP3AUDIOIMPORTER_EXPORT DrMp3Importer: public AbstractImporter {
     public:
@@ -125,7 +167,64 @@ class MAGNUM_DRMP3AUDIOIMPORTER_EXPORT DrMp3Importer: public AbstractImporter {
         /** @brief Plugin manager constructor */
         explicit DrMp3Importer(PluginManager::AbstractManager& manager, const std::string& plugin);
 
+        ~DrMp3Importer();
+
+        /**
+         * @brief Decode next chunk of samples
+         * @m_since_latest_{plugins}
+         *
+         * Expects that a file is opened with the @cb{.ini} streaming @ce
+         * @ref Audio-DrMp3Importer-configuration "configuration option"
+         * enabled. Decodes as many whole sample frames as fit into @p out,
+         * in the same format as @ref data() would return, and returns the
+         * count of bytes written. If the returned value is less than the
+         * size of @p out rounded down to whole frames, the end of the stream
+         * was reached. See @ref Audio-DrMp3Importer-streaming for more
+         * information.
+         */
+        virtual std::size_t read(Containers::ArrayView<char> out);
+
+        /**
+         * @brief Total count of sample frames
+         * @m_since_latest_{plugins}
+         *
+         * Expects that a file is opened with the @cb{.ini} streaming @ce
+         * @ref Audio-DrMp3Importer-configuration "configuration option"
+         * enabled. Calculated by going through all MP3 frame headers on the
+         * first call, without decoding the samples. Returns @cpp 0 @ce on
+         * error.
+         */
+        virtual UnsignedLong frameCount();
+
+        /**
+         * @brief Seek to given sample frame
+         * @m_since_latest_{plugins}
+         *
+         * Expects that a file is opened with the @cb{.ini} streaming @ce
+         * @ref Audio-DrMp3Importer-configuration "configuration option"
+         * enabled. The next @ref read() call decodes from @p frame on. If
+         * seeking fails, for example because @p frame is after the end of
+         * the stream, prints a message to @ref Error and returns
+         * @cpp false @ce. See @ref Audio-DrMp3Importer-streaming-seeking
+         * for more information.
+         */
+        virtual bool seek(UnsignedLong frame);
+
+        /**
+         * @brief Release the decoded data
+         * @m_since_latest_{plugins}
+         *
+         * Compared to @ref data(), which returns a copy, moves the decoded
+         * data out and closes the file, so there's never more than one copy
+         * of the samples alive. Expects that a file is opened. If the file is
+         * opened for streaming, prints a message to @ref Error and returns
+         * an empty array.
+         */
+        virtual Containers::Array<char> releaseData();
+
     private:
+        struct Stream;
+
         MAGNUM_DRMP3AUDIOIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_DRMP3AUDIOIMPORTER_LOCAL bool doIsOpened() const override;
         MAGNUM_DRMP3AUDIOIMPORTER_LOCAL void doOpenData(Containers::ArrayView<const char> data) override;
@@ -138,6 +237,7 @@ class MAGNUM_DRMP3AUDIOIMPORTER_EXPORT DrMp3Importer: public AbstractImporter {
         Containers::Optional<Containers::Array<char>> _data;
         BufferFormat _format;
         UnsignedInt _frequency;
+        Containers::Pointer<Stream> _stream;
 };
 
 }}
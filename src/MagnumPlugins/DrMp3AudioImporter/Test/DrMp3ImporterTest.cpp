@@ -29,10 +29,13 @@
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Directory.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Magnum/Audio/AbstractImporter.h>
 
+#include "MagnumPlugins/DrMp3AudioImporter/DrMp3Importer.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Audio { namespace Test { namespace {
@@ -47,10 +50,37 @@ struct DrMp3ImporterTest: TestSuite::Tester {
     void mono16();
     void stereo16();
 
+    void streaming();
+    void streamingData();
+    void streamingSeek();
+    void streamingSeekInvalid();
+
+    void releaseData();
+
+    void convert();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
 };
 
+constexpr struct {
+    const char* name;
+    const char* filename;
+    std::size_t chunkSize;
+} StreamingData[]{
+    {"mono", "mono16.mp3", 1000},
+    {"stereo, chunk not a multiple of frame size", "stereo16.mp3", 4099},
+    {"stereo, chunk larger than the internal buffer", "stereo16.mp3", 65536}
+};
+
+constexpr struct {
+    const char* name;
+    UnsignedInt seekPoints;
+} StreamingSeekData[]{
+    {"", 0},
+    {"seek table", 16}
+};
+
 DrMp3ImporterTest::DrMp3ImporterTest() {
     addTests({&DrMp3ImporterTest::empty,
 
@@ -59,6 +89,19 @@ DrMp3ImporterTest::DrMp3ImporterTest() {
               &DrMp3ImporterTest::mono16,
               &DrMp3ImporterTest::stereo16});
 
+    addInstancedTests({&DrMp3ImporterTest::streaming},
+        Containers::arraySize(StreamingData));
+
+    addTests({&DrMp3ImporterTest::streamingData});
+
+    addInstancedTests({&DrMp3ImporterTest::streamingSeek,
+                       &DrMp3ImporterTest::streamingSeekInvalid},
+        Containers::arraySize(StreamingSeekData));
+
+    addTests({&DrMp3ImporterTest::releaseData,
+
+              &DrMp3ImporterTest::convert});
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef DRMP3AUDIOIMPORTER_PLUGIN_FILENAME
@@ -117,6 +160,129 @@ void DrMp3ImporterTest::stereo16() {
         TestSuite::Compare::Container<Containers::ArrayView<const char>>);
 }
 
+void DrMp3ImporterTest::streaming() {
+    auto&& data = StreamingData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Decode the whole file first to have something to compare to */
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrMp3AudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DRMP3AUDIOIMPORTER_TEST_DIR, data.filename)));
+    Containers::Array<char> expected = importer->data();
+
+    Containers::Pointer<AbstractImporter> streamingImporter = _manager.instantiate("DrMp3AudioImporter");
+    streamingImporter->configuration().setValue("streaming", true);
+    CORRADE_VERIFY(streamingImporter->openFile(Utility::Directory::join(DRMP3AUDIOIMPORTER_TEST_DIR, data.filename)));
+    CORRADE_COMPARE(streamingImporter->format(), importer->format());
+    CORRADE_COMPARE(streamingImporter->frequency(), importer->frequency());
+
+    Containers::Array<char> out{Containers::NoInit, expected.size() + data.chunkSize};
+    std::size_t size = 0;
+    while(size + data.chunkSize <= out.size()) {
+        const std::size_t read = static_cast<DrMp3Importer&>(*streamingImporter).read(out.slice(size, size + data.chunkSize));
+        if(!read) break;
+        size += read;
+    }
+
+    CORRADE_COMPARE_AS(out.prefix(size), expected,
+        TestSuite::Compare::Container);
+}
+
+void DrMp3ImporterTest::streamingData() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrMp3AudioImporter");
+    importer->configuration().setValue("streaming", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DRMP3AUDIOIMPORTER_TEST_DIR, "mono16.mp3")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(importer->data().empty());
+    CORRADE_COMPARE(out.str(), "Audio::DrMp3Importer::data(): the file is opened for streaming, use read() instead\n");
+}
+
+void DrMp3ImporterTest::streamingSeek() {
+    auto&& data = StreamingSeekData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Decode the whole file first to have something to compare to */
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrMp3AudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DRMP3AUDIOIMPORTER_TEST_DIR, "stereo16.mp3")));
+    Containers::Array<char> expected = importer->data();
+    CORRADE_COMPARE_AS(expected.size(), 9734,
+        TestSuite::Compare::Greater);
+
+    Containers::Pointer<AbstractImporter> streamingImporter = _manager.instantiate("DrMp3AudioImporter");
+    streamingImporter->configuration().setValue("streaming", true);
+    streamingImporter->configuration().setValue("seekPoints", data.seekPoints);
+    CORRADE_VERIFY(streamingImporter->openFile(Utility::Directory::join(DRMP3AUDIOIMPORTER_TEST_DIR, "stereo16.mp3")));
+
+    DrMp3Importer& mp3Importer = static_cast<DrMp3Importer&>(*streamingImporter);
+    CORRADE_COMPARE(mp3Importer.frameCount(), UnsignedLong(expected.size()/4));
+
+    /* Seek forward, the frame size is 4 bytes */
+    char out[400];
+    CORRADE_VERIFY(mp3Importer.seek(1500));
+    CORRADE_COMPARE(mp3Importer.read(out), 400);
+    CORRADE_COMPARE_AS(Containers::arrayView(out), expected.slice(1500*4, 1600*4),
+        TestSuite::Compare::Container);
+
+    /* Seek backward */
+    CORRADE_VERIFY(mp3Importer.seek(433));
+    CORRADE_COMPARE(mp3Importer.read(out), 400);
+    CORRADE_COMPARE_AS(Containers::arrayView(out), expected.slice(433*4, 533*4),
+        TestSuite::Compare::Container);
+
+    /* Seek to the start */
+    CORRADE_VERIFY(mp3Importer.seek(0));
+    CORRADE_COMPARE(mp3Importer.read(out), 400);
+    CORRADE_COMPARE_AS(Containers::arrayView(out), expected.prefix(400),
+        TestSuite::Compare::Container);
+}
+
+void DrMp3ImporterTest::streamingSeekInvalid() {
+    auto&& data = StreamingSeekData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrMp3AudioImporter");
+    importer->configuration().setValue("streaming", true);
+    importer->configuration().setValue("seekPoints", data.seekPoints);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DRMP3AUDIOIMPORTER_TEST_DIR, "stereo16.mp3")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!static_cast<DrMp3Importer&>(*importer).seek(1000000));
+    CORRADE_COMPARE(out.str(), "Audio::DrMp3Importer::seek(): can't seek to frame 1000000\n");
+}
+
+void DrMp3ImporterTest::releaseData() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrMp3AudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DRMP3AUDIOIMPORTER_TEST_DIR, "stereo16.mp3")));
+
+    Containers::Array<char> expected = importer->data();
+    Containers::Array<char> data = static_cast<DrMp3Importer&>(*importer).releaseData();
+    CORRADE_COMPARE_AS(data, expected,
+        TestSuite::Compare::Container);
+
+    /* The file gets closed after */
+    CORRADE_VERIFY(!importer->isOpened());
+}
+
+void DrMp3ImporterTest::convert() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrMp3AudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DRMP3AUDIOIMPORTER_TEST_DIR, "stereo16.mp3")));
+    CORRADE_COMPARE(importer->format(), BufferFormat::Stereo16);
+    const UnsignedInt frequency = importer->frequency();
+    const std::size_t frameCount = importer->data().size()/(2*2);
+
+    /* The conversion itself is tested in DrWavAudioImporter, here it's just
+       about the options being propagated */
+    importer->configuration().setValue("frequency", frequency*2);
+    importer->configuration().setValue("channelCount", 1);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DRMP3AUDIOIMPORTER_TEST_DIR, "stereo16.mp3")));
+    CORRADE_COMPARE(importer->format(), BufferFormat::Mono16);
+    CORRADE_COMPARE(importer->frequency(), frequency*2);
+    /* Twice the frames, each having one channel of 16-bit samples */
+    CORRADE_COMPARE(importer->data().size(), frameCount*2*1*2);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Audio::Test::DrMp3ImporterTest)
@@ -26,7 +26,7 @@
 
 #include "MagnumPlugins/DrMp3AudioImporter/configure.h"
 
-#ifdef MAGNUM_DRMP3AUDIOIMPORTER_BUILD_STATIC
+#if defined(MAGNUM_DRMP3AUDIOIMPORTER_BUILD_STATIC) && !defined(MAGNUM_PLUGINS_NO_AUTOMATIC_IMPORT)
 #include <Corrade/PluginManager/AbstractManager.h>
 
 static int magnumDrMp3AudioImporterStaticImporter() {
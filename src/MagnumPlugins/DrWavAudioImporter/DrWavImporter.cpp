@@ -26,16 +26,27 @@
 
 #include "DrWavImporter.h"
 
+#include <cstring>
 #include <Corrade/Containers/ScopeGuard.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
+#include <Corrade/Utility/Directory.h>
 #include <Corrade/Utility/Endianness.h>
+#include <Magnum/Math/Functions.h>
 
 #define DR_WAV_IMPLEMENTATION
 #include "dr_wav.h"
 
+#include "MagnumPlugins/Implementation/audioConversion.h"
+
 namespace Magnum { namespace Audio {
 
+#if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+#define _DRWAVIMPORTER_USE_MAP
+#endif
+
 namespace {
 
 #define _v(value) BufferFormat::value
@@ -76,53 +87,142 @@ constexpr const BufferFormat MuLawFormatTable[2][1] = {
 };
 #undef _v
 
-/* Converts 32-bit PCM into lower bit levels by skipping bytes */
-Containers::Array<char> convert32Pcm(const Containers::ArrayView<const char> container, const UnsignedInt samples, const UnsignedInt size) {
-    Containers::Array<char> convertData(samples*size);
+/* How the samples are read from dr_wav */
+enum class ReadMode {
+    /* Raw data, the output has the same size as the input */
+    Raw,
+    /* Converted to 32-bit float */
+    Float,
+    /* Converted to 32-bit PCM and then sliced down to 8 or 16 bits */
+    Slice
+};
 
-    UnsignedInt skip = -1, index = 0;
-    for(char item: container) {
-        ++skip;
+/* Reads and converts given count of samples, returns count of samples
+   actually read. The output has sampleSize bytes per sample and doesn't need
+   to be aligned. */
+std::size_t readSamples(drwav* const handle, const ReadMode mode, const UnsignedInt sampleSize, const std::size_t count, char* const out) {
+    /* Be sure size is exact! */
+    if(mode == ReadMode::Raw)
+        return drwav_read_raw(handle, count*sampleSize, out)/sampleSize;
+
+    /* Floats can go directly to the output if it's aligned */
+    if(mode == ReadMode::Float && reinterpret_cast<std::uintptr_t>(out) % alignof(Float) == 0)
+        return drwav_read_f32(handle, count, reinterpret_cast<float*>(out));
+
+    /* Otherwise go through a temporary buffer in chunks */
+    union {
+        Float f[4096];
+        Int i[4096];
+    } samples;
+    std::size_t read = 0;
+    while(read < count) {
+        const std::size_t toRead = Math::min(count - read, std::size_t(Containers::arraySize(samples.i)));
+        std::size_t readNow;
+        if(mode == ReadMode::Float) {
+            readNow = drwav_read_f32(handle, toRead, samples.f);
+            std::memcpy(out + read*sizeof(Float), samples.f, readNow*sizeof(Float));
+        } else {
+            readNow = drwav_read_s32(handle, toRead, samples.i);
+
+            /* 32-bit PCM can be sliced down to 8 or 16 for direct reading,
+               8 bit data needs to be converted to unsigned */
+            if(sampleSize == 1) for(std::size_t i = 0; i != readNow; ++i)
+                out[read + i] = char(UnsignedByte((samples.i[i] >> 24) + 128));
+            else for(std::size_t i = 0; i != readNow; ++i) {
+                const Short sample = samples.i[i] >> 16;
+                std::memcpy(out + (read + i)*sizeof(Short), &sample, sizeof(Short));
+            }
+        }
 
-        if(skip > 3) skip = 0;
-        if(skip < 4 - size) continue;
+        read += readNow;
 
-        convertData[index] = item;
-        ++index;
+        /* End of the stream (or an error) */
+        if(readNow < toRead) break;
     }
 
-    return convertData;
+    return read;
 }
 
-/* Reads generic audio into most compatible format; also adjusts format */
-Containers::Array<char> read32fPcm(drwav* const handle, const UnsignedInt samples, const UnsignedInt numChannels, BufferFormat& format) {
-    format = IeeeFormatTable[numChannels-1][0];
+}
 
-    Containers::Array<char> tempData(samples*sizeof(Float));
-    drwav_read_f32(handle, samples, reinterpret_cast<float*>(tempData.begin()));
+struct DrWavImporter::Stream {
+    ~Stream() { drwav_close(handle); }
 
-    return tempData;
-}
+    /* Copy of the file data, dr_wav reads from it on every read(). Empty if
+       the data are referenced from openMemory() or openFile(). */
+    Containers::Array<char> data;
+    drwav* handle;
+    ReadMode mode;
+    UnsignedInt sampleSize, channelCount;
+};
 
-/* Reads raw data; be sure size is exact! */
-Containers::Array<char> readRaw(drwav* const handle, const UnsignedInt samples, const UnsignedInt size) {
-    Containers::Array<char> tempData(samples*size);
-    drwav_read_raw(handle, samples*size, reinterpret_cast<void*>(tempData.begin()));
+struct DrWavImporter::File {
+    /* Either a memory-mapped file or, on platforms without mapping support,
+       file contents read to memory */
+    #ifdef _DRWAVIMPORTER_USE_MAP
+    Containers::Array<const char, Utility::Directory::MapDeleter> data;
+    #else
+    Containers::Array<char> data;
+    #endif
+};
 
-    return tempData;
+DrWavImporter::DrWavImporter() {
+    /** @todo horrible workaround, fix this properly */
+    configuration().setValue("streaming", false);
+    configuration().setValue("frequency", 0);
+    configuration().setValue("channelCount", 0);
 }
 
+DrWavImporter::DrWavImporter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImporter{manager, plugin} {}
+
+DrWavImporter::~DrWavImporter() = default;
+
+ImporterFeatures DrWavImporter::doFeatures() const { return ImporterFeature::OpenData; }
+
+bool DrWavImporter::doIsOpened() const { return _data || _stream || _referenced; }
+
+bool DrWavImporter::openMemory(const Containers::ArrayView<const char> data) {
+    close();
+    openInternal(data, true);
+    return isOpened();
 }
 
-DrWavImporter::DrWavImporter() = default;
+void DrWavImporter::doOpenFile(const std::string& filename) {
+    if(!Utility::Directory::exists(filename)) {
+        Error() << "Audio::DrWavImporter::openFile(): cannot open file" << filename;
+        return;
+    }
 
-DrWavImporter::DrWavImporter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImporter{manager, plugin} {}
+    /* Map the file instead of reading it to avoid having the whole file
+       copied in memory. The mapping is kept only if the samples or the
+       streaming decoder point to it, moving it doesn't change the data
+       pointer so the views stay valid. */
+    Containers::Pointer<File> file{new File};
+    #ifdef _DRWAVIMPORTER_USE_MAP
+    file->data = Utility::Directory::mapRead(filename);
+    #else
+    file->data = Utility::Directory::read(filename);
+    #endif
+    openInternal(file->data, true);
+    if(_referenced || _stream) _file = std::move(file);
+}
 
-ImporterFeatures DrWavImporter::doFeatures() const { return ImporterFeature::OpenData; }
+void DrWavImporter::doOpenData(Containers::ArrayView<const char> data) {
+    openInternal(data, false);
+}
 
-bool DrWavImporter::doIsOpened() const { return !!_data; }
+void DrWavImporter::openInternal(Containers::ArrayView<const char> data, const bool referenced) {
+    /* In streaming mode dr_wav keeps reading from the data after this
+       function exits, so it needs its own copy, unless the data are
+       guaranteed to stay in scope */
+    const bool streaming = configuration().value<bool>("streaming");
+    Containers::Array<char> dataCopy;
+    if(streaming && !referenced) {
+        dataCopy = Containers::Array<char>{Containers::NoInit, data.size()};
+        Utility::copy(data, dataCopy);
+        data = dataCopy;
+    }
 
-void DrWavImporter::doOpenData(const Containers::ArrayView<const char> data) {
     drwav* const handle = drwav_open_memory(data.data(), data.size());
     if(!handle) {
         Error() << "Audio::DrWavImporter::openData(): failed to open and decode WAV data";
@@ -151,78 +251,157 @@ void DrWavImporter::doOpenData(const Containers::ArrayView<const char> data) {
 
     _frequency = frequency;
 
+    /* If we don't know what the format is, read it out as 32 bit float for
+       compatibility. Overwritten below for formats that can be read directly
+       or sliced. */
+    ReadMode mode = ReadMode::Float;
+    UnsignedInt sampleSize = sizeof(Float);
+    _format = IeeeFormatTable[numChannels-1][0];
+
     /* PCM has a lot of special cases, as we can read many formats directly */
     if(handle->translatedFormatTag == DR_WAVE_FORMAT_PCM) {
-        _format = PcmFormatTable[numChannels-1][normalizedBytesPerSample-1];
-        CORRADE_INTERNAL_ASSERT(_format != BufferFormat{});
-
         /* If the data is exactly 8 or 16 bits, we can read it raw */
-        if(!notExactBitsPerSample && normalizedBytesPerSample < 3) {
-            _data = readRaw(handle, samples, normalizedBytesPerSample);
-            return;
-
-        /* If the data is approximately 24 bits or has many channels, a float is more than enough */
-        } else if(normalizedBytesPerSample == 3 || (normalizedBytesPerSample > 3 && numChannels > 3)) {
-            _data = read32fPcm(handle, samples, numChannels, _format);
-            return;
-
-        /* If the data is close to 8 or 16 bits, we can convert it from 32-bit PCM */
-        } else if(normalizedBytesPerSample == 1 || normalizedBytesPerSample == 2) {
-            Containers::Array<char> tempData(samples*sizeof(Int));
-            drwav_read_s32(handle, samples, reinterpret_cast<Int*>(tempData.begin()));
-
-            /* 32-bit PCM can be sliced down to 8 or 16 for direct reading */
-            _data = convert32Pcm(tempData, samples, normalizedBytesPerSample);
-
-            /* Convert 8 bit data to unsigned */
-            if(normalizedBytesPerSample == 1)
-                for(char& item: *_data) item = item - 128;
-            return;
-        }
+        if(!notExactBitsPerSample && normalizedBytesPerSample < 3)
+            mode = ReadMode::Raw;
+
+        /* If the data is close to 8 or 16 bits, we can convert it from 32-bit
+           PCM. Otherwise it's approximately 24 bits or more and a float is
+           more than enough. */
+        else if(normalizedBytesPerSample == 1 || normalizedBytesPerSample == 2)
+            mode = ReadMode::Slice;
 
         /** @todo Allow loading of 32/64 bit streams to Double format to preserve all information */
 
+        if(mode != ReadMode::Float) {
+            _format = PcmFormatTable[numChannels-1][normalizedBytesPerSample-1];
+            CORRADE_INTERNAL_ASSERT(_format != BufferFormat{});
+            sampleSize = normalizedBytesPerSample;
+        }
+
     /* ALaw of 8/16 bits with 1/2 channels can be loaded directly */
     } else if(handle->translatedFormatTag == DR_WAVE_FORMAT_ALAW) {
         if(numChannels < 3 && !notExactBitsPerSample && (bitsPerSample == 8 || bitsPerSample == 16) ) {
             _format = ALawFormatTable[numChannels-1][normalizedBytesPerSample-1];
-            _data = readRaw(handle, samples, normalizedBytesPerSample);
-            return;
+            mode = ReadMode::Raw;
+            sampleSize = normalizedBytesPerSample;
         }
 
     /* MuLaw of 8/16 bits with 1/2 channels can be loaded directly */
     } else if(handle->translatedFormatTag == DR_WAVE_FORMAT_MULAW) {
         if(numChannels < 3 && !notExactBitsPerSample && (bitsPerSample == 8 || bitsPerSample == 16) ) {
             _format = MuLawFormatTable[numChannels-1][normalizedBytesPerSample-1];
-            _data = readRaw(handle, samples, normalizedBytesPerSample);
-            return;
+            mode = ReadMode::Raw;
+            sampleSize = normalizedBytesPerSample;
         }
 
     /* IEEE float or double can be loaded directly */
     } else if(handle->translatedFormatTag == DR_WAVE_FORMAT_IEEE_FLOAT) {
         if(!notExactBitsPerSample && (bitsPerSample == 32 || bitsPerSample == 64)) {
             _format = IeeeFormatTable[numChannels-1][(normalizedBytesPerSample / 4)-1];
-            _data = readRaw(handle, samples, normalizedBytesPerSample);
-            return;
+            mode = ReadMode::Raw;
+            sampleSize = normalizedBytesPerSample;
         }
     }
 
-    /* If we don't know what the format is, read it out as 32 bit float for compatibility */
-    _data = read32fPcm(handle, samples, numChannels, _format);
+    /* Keep the decoder open and decode only in read() */
+    if(streaming) {
+        Implementation::warnAudioConversionStreaming(configuration(), "Audio::DrWavImporter::openData():", _format, _frequency);
+        _stream.emplace();
+        _stream->data = std::move(dataCopy);
+        _stream->handle = handle;
+        _stream->mode = mode;
+        _stream->sampleSize = sampleSize;
+        _stream->channelCount = numChannels;
+        drwavClose.release();
+        return;
+    }
+
+    /* Samples that don't need any conversion can be referenced directly
+       from the input, if it stays in scope and isn't truncated */
+    const std::size_t size = samples*sampleSize;
+    const bool convert = Implementation::audioConversionNeeded(configuration(), _format, _frequency);
+    if(referenced && !convert && mode == ReadMode::Raw && handle->dataChunkDataPos + size <= data.size()) {
+        _samples = data.slice(handle->dataChunkDataPos, handle->dataChunkDataPos + size);
+        _referenced = true;
+        return;
+    }
+
+    /* Fill whatever couldn't be read from a truncated file with zeros */
+    Containers::Array<char> out{Containers::NoInit, size};
+    const std::size_t read = readSamples(handle, mode, sampleSize, samples, out.data());
+    std::memset(out.data() + read*sampleSize, 0, size - read*sampleSize);
+
+    if(convert && !Implementation::convertAudio(configuration(), "Audio::DrWavImporter::openData():", _format, _frequency, out))
+        return;
+
+    _samples = out;
+    _data = std::move(out);
 }
 
-void DrWavImporter::doClose() { _data = Containers::NullOpt; }
+void DrWavImporter::doClose() {
+    _data = Containers::NullOpt;
+    _samples = nullptr;
+    _referenced = false;
+    _stream = nullptr;
+    _file = nullptr;
+}
 
 BufferFormat DrWavImporter::doFormat() const { return _format; }
 
 UnsignedInt DrWavImporter::doFrequency() const { return _frequency; }
 
 Containers::Array<char> DrWavImporter::doData() {
-    Containers::Array<char> copy(_data->size());
-    std::copy(_data->begin(), _data->end(), copy.begin());
+    if(_stream) {
+        Error() << "Audio::DrWavImporter::data(): the file is opened for streaming, use read() instead";
+        return nullptr;
+    }
+
+    Containers::Array<char> copy{Containers::NoInit, _samples.size()};
+    Utility::copy(_samples, copy);
     return copy;
 }
 
+Containers::ArrayView<const char> DrWavImporter::dataView() {
+    CORRADE_ASSERT(isOpened(),
+        "Audio::DrWavImporter::dataView(): no file opened", {});
+
+    if(_stream) {
+        Error() << "Audio::DrWavImporter::dataView(): the file is opened for streaming, use read() instead";
+        return {};
+    }
+
+    return _samples;
+}
+
+std::size_t DrWavImporter::read(const Containers::ArrayView<char> out) {
+    CORRADE_ASSERT(_stream,
+        "Audio::DrWavImporter::read(): no file opened for streaming", {});
+
+    /* Only whole frames */
+    const std::size_t count = out.size()/(_stream->sampleSize*_stream->channelCount)*_stream->channelCount;
+    return readSamples(_stream->handle, _stream->mode, _stream->sampleSize, count, out)*_stream->sampleSize;
+}
+
+Containers::Array<char> DrWavImporter::releaseData() {
+    CORRADE_ASSERT(isOpened(),
+        "Audio::DrWavImporter::releaseData(): no file opened", {});
+
+    if(_stream) {
+        Error() << "Audio::DrWavImporter::releaseData(): the file is opened for streaming, use read() instead";
+        return nullptr;
+    }
+
+    /* Referenced samples have to be copied as the input goes away */
+    Containers::Array<char> out;
+    if(_data) out = std::move(*_data);
+    else {
+        out = Containers::Array<char>{Containers::NoInit, _samples.size()};
+        Utility::copy(_samples, out);
+    }
+    close();
+    return out;
+}
+
 }}
 
 CORRADE_PLUGIN_REGISTER(DrWavAudioImporter, Magnum::Audio::DrWavImporter,
@@ -32,6 +32,7 @@
 
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Magnum/Audio/AbstractImporter.h>
 
 #include "MagnumPlugins/DrWavAudioImporter/configure.h"
@@ -126,6 +127,52 @@ target_link_libraries(your-app PRIVATE MagnumPlugins::DrWavAudioImporter)
 
 See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
 information.
+
+@section Audio-DrWavImporter-streaming Streaming
+
+By default the whole file is decoded in @ref openData() / @ref openFile(). If
+the @cb{.ini} streaming @ce @ref Audio-DrWavImporter-configuration "configuration option"
+is enabled, only the header is parsed on opening and samples are decoded in
+chunks via @ref read() into a caller-provided buffer, in the same format as
+@ref data() would return. The file data are copied and kept for the whole time
+the file is opened. Calling @ref data() on a file opened for streaming prints
+a message to @ref Error and returns an empty array.
+
+Files passed to @ref openFile() and data passed to @ref openMemory() are not
+copied for streaming, as they're guaranteed to stay in scope for the whole
+time the file is opened.
+
+@section Audio-DrWavImporter-zero-copy Zero-copy access
+
+Samples that are stored in the file in a format already matching the output
+@ref BufferFormat --- 8- and 16-bit integer PCM, 32- and 64-bit IEEE float and
+8-bit A-law and μ-law --- don't need any decoding. Files passed to
+@ref openFile() are memory-mapped on platforms that support it and for data
+passed to @ref openMemory() the importer references the memory directly. In
+both cases @ref dataView() then points directly inside the file data, without
+any copy. Other formats, data passed to @ref openData() and truncated files are
+decoded to an internal buffer during opening and @ref dataView() points to it
+instead.
+
+@section Audio-DrWavImporter-conversion Frequency and channel count conversion
+
+If the @cb{.ini} frequency @ce or @cb{.ini} channelCount @ce
+@ref Audio-DrWavImporter-configuration "configuration options" are set, the samples
+are converted right after decoding in @ref openData() / @ref openFile(), so
+@ref data() returns them already in the target format. Resampling uses a
+windowed-sinc polyphase filter, vectorized with SSE2 or NEON where available.
+Channels are mixed through a stereo downmix, with stereo going to the front
+left and right channels of multi-channel outputs. The sample type is kept,
+except for A-law and μ-law, which get decoded to 16-bit, and doubles with more
+than two channels, which become floats. Converted samples are never referenced
+from the file data. The options are ignored with a warning in streaming mode.
+
+@section Audio-DrWavImporter-configuration Plugin-specific configuration
+
+It's possible to tune various import options through @ref configuration(). See
+below for all options and their default values:
+
+@snippet MagnumPlugins/DrWavAudioImporter/DrWavAudioImporter.conf config
 */
 class MAGNUM_DRWAVAUDIOIMPORTER_EXPORT DrWavImporter: public AbstractImporter {
     public:
@@ -135,10 +182,70 @@ class MAGNUM_DRWAVAUDIOIMPORTER_EXPORT DrWavImporter: public AbstractImporter {
         /** @brief Plugin manager constructor */
         explicit DrWavImporter(PluginManager::AbstractManager& manager, const std::string& plugin);
 
+        ~DrWavImporter();
+
+        /**
+         * @brief Decode next chunk of samples
+         * @m_since_latest_{plugins}
+         *
+         * Expects that a file is opened with the @cb{.ini} streaming @ce
+         * @ref Audio-DrWavImporter-configuration "configuration option"
+         * enabled. Decodes as many whole sample frames as fit into @p out,
+         * in the same format as @ref data() would return, and returns the
+         * count of bytes written. If the returned value is less than the
+         * size of @p out rounded down to whole frames, the end of the stream
+         * was reached. See @ref Audio-DrWavImporter-streaming for more
+         * information.
+         */
+        virtual std::size_t read(Containers::ArrayView<char> out);
+
+        /**
+         * @brief Open a memory-mapped file
+         * @m_since_latest_{plugins}
+         *
+         * Compared to @ref openData(), the data are referenced and not
+         * copied, expecting them to stay in scope for the whole time the
+         * file is opened. See @ref Audio-DrWavImporter-zero-copy for more
+         * information.
+         */
+        virtual bool openMemory(Containers::ArrayView<const char> data);
+
+        /**
+         * @brief View on the sample data
+         * @m_since_latest_{plugins}
+         *
+         * Compared to @ref data(), which returns a copy, returns a view that
+         * points either directly inside the file data or to an internal
+         * buffer with decoded samples. The view is valid until the file is
+         * closed. Expects that a file is opened. If the file is opened for
+         * streaming, prints a message to @ref Error and returns an empty
+         * view. See @ref Audio-DrWavImporter-zero-copy for more information.
+         */
+        virtual Containers::ArrayView<const char> dataView();
+
+        /**
+         * @brief Release the decoded data
+         * @m_since_latest_{plugins}
+         *
+         * Compared to @ref data(), which returns a copy, moves the decoded
+         * data out and closes the file, so there's never more than one copy
+         * of the samples alive. If the samples are referenced directly from
+         * the file data, they're copied instead, as the file data go away
+         * with the close. Expects that a file is opened. If the file is
+         * opened for streaming, prints a message to @ref Error and returns
+         * an empty array.
+         */
+        virtual Containers::Array<char> releaseData();
+
     private:
+        struct Stream;
+        struct File;
+
         MAGNUM_DRWAVAUDIOIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_DRWAVAUDIOIMPORTER_LOCAL bool doIsOpened() const override;
+        MAGNUM_DRWAVAUDIOIMPORTER_LOCAL void doOpenFile(const std::string& filename) override;
         MAGNUM_DRWAVAUDIOIMPORTER_LOCAL void doOpenData(Containers::ArrayView<const char> data) override;
+        MAGNUM_DRWAVAUDIOIMPORTER_LOCAL void openInternal(Containers::ArrayView<const char> data, bool referenced);
         MAGNUM_DRWAVAUDIOIMPORTER_LOCAL void doClose() override;
 
         MAGNUM_DRWAVAUDIOIMPORTER_LOCAL BufferFormat doFormat() const override;
@@ -146,8 +253,13 @@ class MAGNUM_DRWAVAUDIOIMPORTER_EXPORT DrWavImporter: public AbstractImporter {
         MAGNUM_DRWAVAUDIOIMPORTER_LOCAL Containers::Array<char> doData() override;
 
         Containers::Optional<Containers::Array<char>> _data;
+        /* Points either to _data or directly inside the file data */
+        Containers::ArrayView<const char> _samples;
+        bool _referenced{};
         BufferFormat _format;
         UnsignedInt _frequency;
+        Containers::Pointer<Stream> _stream;
+        Containers::Pointer<File> _file;
 };
 
 }}
@@ -0,0 +1,213 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <cstring>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/Endianness.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Magnum/Audio/AbstractImporter.h>
+
+#include "MagnumPlugins/DrWavAudioImporter/DrWavImporter.h"
+#include "MagnumPlugins/Implementation/audioConversion.h"
+#include "MagnumPlugins/Implementation/peakMemory.h"
+
+#include "configure.h"
+
+namespace Magnum { namespace Audio { namespace Test { namespace {
+
+struct DrWavImporterBenchmark: TestSuite::Tester {
+    explicit DrWavImporterBenchmark();
+
+    void decode();
+    void firstSample();
+    void peakMemory();
+
+    void peakMemoryBegin();
+    std::uint64_t peakMemoryEnd();
+
+    /* Explicitly forbid system-wide plugin dependencies */
+    PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
+
+    std::uint64_t _residentSizeBefore{};
+};
+
+/* To calculate the throughput in samples per second, divide the sample frame
+   count shown in the decode() test case description by the measured time */
+constexpr struct {
+    const char* name;
+    UnsignedShort formatTag;
+    UnsignedShort bitsPerSample;
+    UnsignedShort channelCount;
+} ClipData[]{
+    {"8-bit mono", 1, 8, 1},
+    {"16-bit stereo", 1, 16, 2},
+    {"24-bit stereo", 1, 24, 2},
+    {"32-bit float 5.1", 3, 32, 6},
+    {"A-law stereo", 6, 8, 2},
+    {"mu-law stereo", 7, 8, 2}
+};
+
+/* Ten seconds of noise, generated instead of bundling large files */
+Containers::Array<char> clip(const UnsignedShort formatTag, const UnsignedShort bitsPerSample, const UnsignedShort channelCount) {
+    constexpr UnsignedInt Frequency = 48000;
+    const UnsignedInt frameSize = channelCount*bitsPerSample/8;
+    const UnsignedInt dataSize = 10*Frequency*frameSize;
+
+    Containers::Array<char> out{Containers::NoInit, 44 + dataSize};
+    const auto put32 = [&](std::size_t offset, UnsignedInt value) {
+        value = Utility::Endianness::littleEndian(value);
+        std::memcpy(out.data() + offset, &value, 4);
+    };
+    const auto put16 = [&](std::size_t offset, UnsignedShort value) {
+        value = Utility::Endianness::littleEndian(value);
+        std::memcpy(out.data() + offset, &value, 2);
+    };
+    std::memcpy(out.data(), "RIFF", 4);
+    put32(4, out.size() - 8);
+    std::memcpy(out.data() + 8, "WAVEfmt ", 8);
+    put32(16, 16);
+    put16(20, formatTag);
+    put16(22, channelCount);
+    put32(24, Frequency);
+    put32(28, Frequency*frameSize);
+    put16(32, frameSize);
+    put16(34, bitsPerSample);
+    std::memcpy(out.data() + 36, "data", 4);
+    put32(40, dataSize);
+
+    /* A simple LCG, the decoder doesn't care about what the samples are. For
+       floats the top exponent bit is cleared to avoid infinities and NaNs. */
+    UnsignedInt state = 1;
+    for(std::size_t i = 44; i != out.size(); ++i) {
+        state = state*1103515245 + 12345;
+        out[i] = char(state >> 24);
+        if(formatTag == 3 && (i - 44) % 4 == 3) out[i] &= char(0xbf);
+    }
+
+    return out;
+}
+
+std::size_t frameCount(const BufferFormat format, const std::size_t size) {
+    Implementation::AudioSampleType type;
+    UnsignedInt channelCount;
+    CORRADE_INTERNAL_ASSERT_OUTPUT(Implementation::audioFormatProperties(format, type, channelCount));
+    return size/(Implementation::audioSampleSize(type)*channelCount);
+}
+
+DrWavImporterBenchmark::DrWavImporterBenchmark() {
+    addInstancedBenchmarks({&DrWavImporterBenchmark::decode}, 10,
+        Containers::arraySize(ClipData));
+
+    addInstancedBenchmarks({&DrWavImporterBenchmark::firstSample}, 10,
+        Containers::arraySize(ClipData));
+
+    addCustomInstancedBenchmarks({&DrWavImporterBenchmark::peakMemory}, 1,
+        Containers::arraySize(ClipData),
+        &DrWavImporterBenchmark::peakMemoryBegin,
+        &DrWavImporterBenchmark::peakMemoryEnd,
+        BenchmarkUnits::Bytes);
+
+    /* Load the plugin directly from the build tree. Otherwise it's static and
+       already loaded. */
+    #ifdef DRWAVAUDIOIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(DRWAVAUDIOIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+void DrWavImporterBenchmark::decode() {
+    auto&& data = ClipData[testCaseInstanceId()];
+
+    const Containers::Array<char> file = clip(data.formatTag, data.bitsPerSample, data.channelCount);
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrWavAudioImporter");
+    CORRADE_VERIFY(importer->openData(file));
+    setTestCaseDescription(Utility::formatString("{}, {} frames at {} Hz",
+        data.name, frameCount(importer->format(), importer->data().size()),
+        importer->frequency()));
+
+    Containers::Array<char> out;
+    CORRADE_BENCHMARK(1) {
+        importer->openData(file);
+        out = static_cast<DrWavImporter&>(*importer).releaseData();
+    }
+
+    CORRADE_VERIFY(out);
+}
+
+void DrWavImporterBenchmark::firstSample() {
+    auto&& data = ClipData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const Containers::Array<char> file = clip(data.formatTag, data.bitsPerSample, data.channelCount);
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrWavAudioImporter");
+    importer->configuration().setValue("streaming", true);
+
+    /* Large enough for a single frame of any format */
+    char sample[64];
+    std::size_t size = 0;
+    CORRADE_BENCHMARK(1) {
+        importer->openData(file);
+        size = static_cast<DrWavImporter&>(*importer).read(sample);
+    }
+
+    CORRADE_VERIFY(size);
+}
+
+void DrWavImporterBenchmark::peakMemory() {
+    auto&& data = ClipData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifndef __linux__
+    CORRADE_SKIP("Peak memory can be measured only on Linux.");
+    #else
+    /* The input is loaded outside of the measured region, so only the memory
+       allocated by the decoder and for the output is counted */
+    const Containers::Array<char> file = clip(data.formatTag, data.bitsPerSample, data.channelCount);
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrWavAudioImporter");
+
+    Containers::Array<char> out;
+    CORRADE_BENCHMARK(1) {
+        importer->openData(file);
+        out = static_cast<DrWavImporter&>(*importer).releaseData();
+    }
+
+    CORRADE_VERIFY(out);
+    #endif
+}
+
+void DrWavImporterBenchmark::peakMemoryBegin() {
+    _residentSizeBefore = Magnum::Implementation::peakMemoryBegin();
+}
+
+std::uint64_t DrWavImporterBenchmark::peakMemoryEnd() {
+    return Magnum::Implementation::peakMemoryEnd(_residentSizeBefore);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Audio::Test::DrWavImporterBenchmark)
@@ -25,14 +25,22 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <cmath>
+#include <cstring>
 #include <sstream>
 #include <Corrade/Containers/Array.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Directory.h>
+#include <Corrade/Utility/Endianness.h>
+#include <Magnum/Math/Constants.h>
 #include <Magnum/Audio/AbstractImporter.h>
 
+#include "MagnumPlugins/DrWavAudioImporter/DrWavImporter.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Audio { namespace Test { namespace {
@@ -83,10 +91,90 @@ struct DrWavImporterTest: TestSuite::Tester {
     void extensions32f();
     void extensions64f();
 
+    void streaming();
+    void streamingData();
+
+    void releaseData();
+
+    void zeroCopy();
+    void dataViewStreaming();
+
+    void convertChannelCount();
+    void convertFrequency();
+    void convertInvalidChannelCount();
+    void convertStreaming();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
 };
 
+constexpr struct {
+    const char* name;
+    const char* filename;
+    std::size_t chunkSize;
+} StreamingData[]{
+    {"8-bit raw", "mono8.wav", 1000},
+    {"12-bit sliced to 16, chunk not a multiple of frame size", "stereo12.wav", 4099},
+    {"24-bit converted to float, chunk larger than the internal buffer", "stereo24.wav", 65536},
+    {"a-law raw", "mono8ALaw.wav", 1024},
+    {"64-bit float raw", "stereo64f.wav", 100000}
+};
+
+constexpr struct {
+    const char* name;
+    const char* filename;
+    bool referenced;
+} ZeroCopyData[]{
+    {"8-bit", "mono8.wav", true},
+    {"16-bit", "stereo16.wav", true},
+    {"a-law", "mono8ALaw.wav", true},
+    {"μ-law", "stereo8MuLaw.wav", true},
+    {"32-bit float", "mono32f.wav", true},
+    {"64-bit float", "stereo64f.wav", true},
+    {"12-bit, sliced to 16", "stereo12.wav", false},
+    {"24-bit, converted to float", "stereo24.wav", false}
+};
+
+constexpr struct {
+    const char* name;
+    UnsignedInt from, to;
+} ConvertFrequencyData[]{
+    {"downsampling", 48000, 44100},
+    {"upsampling", 22050, 48000},
+    {"large ratio", 44100, 44101}
+};
+
+/* Mono 32-bit float WAV */
+Containers::Array<char> floatWav(const UnsignedInt frequency, const Containers::ArrayView<const Float> samples) {
+    Containers::Array<char> out{Containers::ValueInit, 44 + samples.size()*4};
+    const auto put32 = [&](std::size_t offset, UnsignedInt value) {
+        value = Utility::Endianness::littleEndian(value);
+        std::memcpy(out.data() + offset, &value, 4);
+    };
+    const auto put16 = [&](std::size_t offset, UnsignedShort value) {
+        value = Utility::Endianness::littleEndian(value);
+        std::memcpy(out.data() + offset, &value, 2);
+    };
+    std::memcpy(out.data(), "RIFF", 4);
+    put32(4, out.size() - 8);
+    std::memcpy(out.data() + 8, "WAVEfmt ", 8);
+    put32(16, 16);
+    put16(20, 3); /* IEEE float */
+    put16(22, 1);
+    put32(24, frequency);
+    put32(28, frequency*4);
+    put16(32, 4);
+    put16(34, 32);
+    std::memcpy(out.data() + 36, "data", 4);
+    put32(40, samples.size()*4);
+    for(std::size_t i = 0; i != samples.size(); ++i) {
+        UnsignedInt value;
+        std::memcpy(&value, &samples[i], 4);
+        put32(44 + i*4, value);
+    }
+    return out;
+}
+
 DrWavImporterTest::DrWavImporterTest() {
     addTests({&DrWavImporterTest::empty,
               &DrWavImporterTest::wrongSignature,
@@ -132,6 +220,26 @@ DrWavImporterTest::DrWavImporterTest() {
               &DrWavImporterTest::extensions32f,
               &DrWavImporterTest::extensions64f});
 
+    addInstancedTests({&DrWavImporterTest::streaming},
+        Containers::arraySize(StreamingData));
+
+    addTests({&DrWavImporterTest::streamingData,
+
+              &DrWavImporterTest::releaseData});
+
+    addInstancedTests({&DrWavImporterTest::zeroCopy},
+        Containers::arraySize(ZeroCopyData));
+
+    addTests({&DrWavImporterTest::dataViewStreaming,
+
+              &DrWavImporterTest::convertChannelCount});
+
+    addInstancedTests({&DrWavImporterTest::convertFrequency},
+        Containers::arraySize(ConvertFrequencyData));
+
+    addTests({&DrWavImporterTest::convertInvalidChannelCount,
+              &DrWavImporterTest::convertStreaming});
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef DRWAVAUDIOIMPORTER_PLUGIN_FILENAME
@@ -581,6 +689,173 @@ void DrWavImporterTest::extensions64f() {
         TestSuite::Compare::Container<Containers::ArrayView<const char>>);
 }
 
+void DrWavImporterTest::streaming() {
+    auto&& data = StreamingData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Decode the whole file first to have something to compare to */
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrWavAudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DRWAVAUDIOIMPORTER_TEST_DIR, data.filename)));
+    Containers::Array<char> expected = importer->data();
+
+    Containers::Pointer<AbstractImporter> streamingImporter = _manager.instantiate("DrWavAudioImporter");
+    streamingImporter->configuration().setValue("streaming", true);
+    CORRADE_VERIFY(streamingImporter->openFile(Utility::Directory::join(DRWAVAUDIOIMPORTER_TEST_DIR, data.filename)));
+    CORRADE_COMPARE(streamingImporter->format(), importer->format());
+    CORRADE_COMPARE(streamingImporter->frequency(), importer->frequency());
+
+    Containers::Array<char> out{Containers::NoInit, expected.size() + data.chunkSize};
+    std::size_t size = 0;
+    while(size + data.chunkSize <= out.size()) {
+        const std::size_t read = static_cast<DrWavImporter&>(*streamingImporter).read(out.slice(size, size + data.chunkSize));
+        if(!read) break;
+        size += read;
+    }
+
+    CORRADE_COMPARE_AS(out.prefix(size), expected,
+        TestSuite::Compare::Container);
+}
+
+void DrWavImporterTest::streamingData() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrWavAudioImporter");
+    importer->configuration().setValue("streaming", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DRWAVAUDIOIMPORTER_TEST_DIR, "mono8.wav")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(importer->data().empty());
+    CORRADE_COMPARE(out.str(), "Audio::DrWavImporter::data(): the file is opened for streaming, use read() instead\n");
+}
+
+void DrWavImporterTest::releaseData() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrWavAudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DRWAVAUDIOIMPORTER_TEST_DIR, "stereo12.wav")));
+
+    Containers::Array<char> expected = importer->data();
+    Containers::Array<char> data = static_cast<DrWavImporter&>(*importer).releaseData();
+    CORRADE_COMPARE_AS(data, expected,
+        TestSuite::Compare::Container);
+
+    /* The file gets closed after */
+    CORRADE_VERIFY(!importer->isOpened());
+}
+
+void DrWavImporterTest::zeroCopy() {
+    auto&& data = ZeroCopyData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Array<char> file = Utility::Directory::read(Utility::Directory::join(DRWAVAUDIOIMPORTER_TEST_DIR, data.filename));
+
+    /* Decode the data with a copy first to have something to compare to */
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrWavAudioImporter");
+    CORRADE_VERIFY(importer->openData(file));
+    Containers::Array<char> expected = importer->data();
+
+    Containers::Pointer<AbstractImporter> memoryImporter = _manager.instantiate("DrWavAudioImporter");
+    CORRADE_VERIFY(static_cast<DrWavImporter&>(*memoryImporter).openMemory(file));
+    CORRADE_COMPARE(memoryImporter->format(), importer->format());
+    CORRADE_COMPARE(memoryImporter->frequency(), importer->frequency());
+
+    /* The view should point inside the file data only if no conversion is
+       needed */
+    Containers::ArrayView<const char> view = static_cast<DrWavImporter&>(*memoryImporter).dataView();
+    CORRADE_COMPARE(view.data() >= file.begin() && view.end() <= file.end(), data.referenced);
+    CORRADE_COMPARE_AS(view, expected,
+        TestSuite::Compare::Container<Containers::ArrayView<const char>>);
+    CORRADE_COMPARE_AS(memoryImporter->data(), expected,
+        TestSuite::Compare::Container);
+
+    /* Releasing the data makes a copy in case they're referenced */
+    Containers::Array<char> released = static_cast<DrWavImporter&>(*memoryImporter).releaseData();
+    CORRADE_VERIFY(!(released.begin() >= file.begin() && released.end() <= file.end()));
+    CORRADE_COMPARE_AS(released, expected,
+        TestSuite::Compare::Container);
+    CORRADE_VERIFY(!memoryImporter->isOpened());
+}
+
+void DrWavImporterTest::dataViewStreaming() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrWavAudioImporter");
+    importer->configuration().setValue("streaming", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DRWAVAUDIOIMPORTER_TEST_DIR, "mono8.wav")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(static_cast<DrWavImporter&>(*importer).dataView().empty());
+    CORRADE_COMPARE(out.str(), "Audio::DrWavImporter::dataView(): the file is opened for streaming, use read() instead\n");
+}
+
+void DrWavImporterTest::convertChannelCount() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrWavAudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DRWAVAUDIOIMPORTER_TEST_DIR, "stereo16.wav")));
+    CORRADE_COMPARE(importer->format(), BufferFormat::Stereo16);
+    Containers::Array<char> stereo = importer->data();
+    Containers::ArrayView<const Short> stereoShort = Containers::arrayCast<Short>(stereo);
+
+    importer->configuration().setValue("channelCount", 1);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DRWAVAUDIOIMPORTER_TEST_DIR, "stereo16.wav")));
+    CORRADE_COMPARE(importer->format(), BufferFormat::Mono16);
+    CORRADE_COMPARE(importer->frequency(), 44100);
+
+    /* Each sample is an average of the two channels */
+    Containers::Array<char> mono = importer->data();
+    Containers::ArrayView<const Short> monoShort = Containers::arrayCast<Short>(mono);
+    CORRADE_COMPARE(monoShort.size(), stereoShort.size()/2);
+    for(std::size_t i = 0; i != monoShort.size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(monoShort[i], Short(std::round((stereoShort[i*2] + stereoShort[i*2 + 1])/2.0f)));
+    }
+}
+
+void DrWavImporterTest::convertFrequency() {
+    auto&& data = ConvertFrequencyData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* A second of a 1 kHz sine */
+    Containers::Array<Float> samples{Containers::NoInit, data.from};
+    for(std::size_t i = 0; i != samples.size(); ++i)
+        samples[i] = 0.5f*std::sin(2.0f*Constants::pi()*1000.0f*i/data.from);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrWavAudioImporter");
+    importer->configuration().setValue("frequency", data.to);
+    CORRADE_VERIFY(importer->openData(floatWav(data.from, samples)));
+    CORRADE_COMPARE(importer->format(), BufferFormat::MonoFloat);
+    CORRADE_COMPARE(importer->frequency(), data.to);
+
+    Containers::Array<char> out = importer->data();
+    Containers::ArrayView<const Float> outFloat = Containers::arrayCast<Float>(out);
+    CORRADE_COMPARE(outFloat.size(), data.to);
+
+    /* Check the middle, the edges have the filter ramp up and down */
+    for(std::size_t i = data.to/4; i != data.to*3/4; ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE_WITH(outFloat[i],
+            0.5f*std::sin(2.0f*Constants::pi()*1000.0f*i/data.to),
+            TestSuite::Compare::around(0.001f));
+    }
+}
+
+void DrWavImporterTest::convertInvalidChannelCount() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrWavAudioImporter");
+    importer->configuration().setValue("channelCount", 3);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->openFile(Utility::Directory::join(DRWAVAUDIOIMPORTER_TEST_DIR, "stereo16.wav")));
+    CORRADE_COMPARE(out.str(), "Audio::DrWavImporter::openData(): unsupported target channel count 3\n");
+}
+
+void DrWavImporterTest::convertStreaming() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("DrWavAudioImporter");
+    importer->configuration().setValue("streaming", true);
+    importer->configuration().setValue("channelCount", 1);
+
+    std::ostringstream out;
+    Warning redirectWarning{&out};
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(DRWAVAUDIOIMPORTER_TEST_DIR, "stereo16.wav")));
+    CORRADE_COMPARE(importer->format(), BufferFormat::Stereo16);
+    CORRADE_COMPARE(out.str(), "Audio::DrWavImporter::openData(): frequency and channel count conversion is not supported for streaming, ignoring\n");
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Audio::Test::DrWavImporterTest)
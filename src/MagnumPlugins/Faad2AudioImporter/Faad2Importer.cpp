@@ -25,26 +25,114 @@
 
 #include "Faad2Importer.h"
 
-#include <cstring>
-#include <algorithm>
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ScopeGuard.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
+#include <Magnum/Math/Functions.h>
 
 #include <neaacdec.h>
 
+#include "MagnumPlugins/Implementation/audioConversion.h"
+
 namespace Magnum { namespace Audio {
 
-Faad2Importer::Faad2Importer() = default;
+namespace {
+
+/* Indexed by the 4-bit sampling frequency index in the ADTS header, values
+   13-15 are reserved */
+constexpr UnsignedInt AdtsFrequencies[]{
+    96000, 88200, 64000, 48000, 44100, 32000, 24000, 22050, 16000, 12000,
+    11025, 8000, 7350
+};
+
+/* Walks the ADTS frame headers without decoding anything and returns the
+   total count of raw data blocks, each having 1024 samples per channel at
+   the frequency stored in the header. The frame length is in bits 30-42 and
+   the block count minus one in the lowest two bits of the seventh byte, see
+   https://wiki.multimedia.cx/index.php/ADTS. Returns 0 if the data isn't an
+   ADTS stream (such as ADIF), in which case the sample count can't be known
+   without decoding. */
+std::size_t adtsBlockCount(const Containers::ArrayView<const char> data, UnsignedInt& frequency) {
+    const auto* const d = reinterpret_cast<const unsigned char*>(data.data());
+    std::size_t blockCount = 0;
+    std::size_t pos = 0;
+    while(pos + 7 <= data.size()) {
+        /* 12-bit syncword and the layer being always zero */
+        if(d[pos] != 0xff || (d[pos + 1] & 0xf6) != 0xf0) return 0;
+
+        if(!pos) {
+            const UnsignedInt frequencyIndex = (d[pos + 2] >> 2) & 0x0f;
+            if(frequencyIndex >= Containers::arraySize(AdtsFrequencies))
+                return 0;
+            frequency = AdtsFrequencies[frequencyIndex];
+        }
+
+        const std::size_t frameLength = ((d[pos + 3] & 0x03) << 11)|(d[pos + 4] << 3)|(d[pos + 5] >> 5);
+        if(frameLength < 7) return 0;
+
+        blockCount += (d[pos + 6] & 0x03) + 1;
+        pos += frameLength;
+    }
+
+    return blockCount;
+}
+
+/* Decodes a single frame at given position and advances the position. The
+   decoded samples are owned by the decoder and valid only until the next
+   call. */
+bool decodeFrame(const NeAACDecHandle decoder, const Containers::ArrayView<const char> data, std::size_t& pos, Containers::ArrayView<const char>& samples) {
+    NeAACDecFrameInfo info;
+    void* const sampleBuffer = NeAACDecDecode(decoder, &info, const_cast<unsigned char*>(reinterpret_cast<const unsigned char*>(data.data())) + pos, data.size() - pos);
+    if(info.error) return false;
+
+    samples = {static_cast<const char*>(sampleBuffer), info.samples*sizeof(UnsignedShort)};
+    pos += info.bytesconsumed;
+    return true;
+}
+
+}
+
+struct Faad2Importer::Stream {
+    ~Stream() { NeAACDecClose(decoder); }
+
+    /* Copy of the file data, FAAD2 reads from it on every read() */
+    Containers::Array<char> data;
+    NeAACDecHandle decoder;
+    std::size_t pos;
+    /* Samples from the last decoded frame that didn't fit into the output
+       of the previous read(), pointing to the decoder internal buffer */
+    Containers::ArrayView<const char> pending;
+};
+
+Faad2Importer::Faad2Importer() {
+    /** @todo horrible workaround, fix this properly */
+    configuration().setValue("streaming", false);
+    configuration().setValue("frequency", 0);
+    configuration().setValue("channelCount", 0);
+}
 
 Faad2Importer::Faad2Importer(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImporter{manager, plugin} {}
 
+Faad2Importer::~Faad2Importer() = default;
+
 ImporterFeatures Faad2Importer::doFeatures() const { return ImporterFeature::OpenData; }
 
-bool Faad2Importer::doIsOpened() const { return !_samples.empty(); }
+bool Faad2Importer::doIsOpened() const { return _data || _stream; }
 
 void Faad2Importer::doOpenData(Containers::ArrayView<const char> data) {
+    /* In streaming mode FAAD2 keeps reading from the data after this function
+       exits, so it needs its own copy */
+    const bool streaming = configuration().value<bool>("streaming");
+    Containers::Array<char> dataCopy;
+    if(streaming) {
+        dataCopy = Containers::Array<char>{Containers::NoInit, data.size()};
+        Utility::copy(data, dataCopy);
+        data = dataCopy;
+    }
+
     /* Init the library */
     const NeAACDecHandle decoder = NeAACDecOpen();
     Containers::ScopeGuard exit{decoder, NeAACDecClose};
@@ -65,8 +153,6 @@ void Faad2Importer::doOpenData(Containers::ArrayView<const char> data) {
         return;
     }
 
-    _frequency = samplerate;
-
     if(channels == 2)
         _format = BufferFormat::Stereo16;
     else {
@@ -78,41 +164,123 @@ void Faad2Importer::doOpenData(Containers::ArrayView<const char> data) {
         return;
     }
 
-    /** @todo do it not via a vector -- is there any way to get the sample
-        count beforehand? the faad fronted does it by manually parsing the
-        headers and NO WAY IN HELL i am doing that here. So be it.
-        https://github.com/knik0/faad2/blob/7da4a83b230d069a9d731b1e64f6e6b52802576a/frontend/main.c#L613-L630 */
+    _frequency = samplerate;
+
+    /* Keep the decoder open and decode only in read() */
+    if(streaming) {
+        Implementation::warnAudioConversionStreaming(configuration(), "Audio::Faad2Importer::openData():", _format, _frequency);
+        _stream.emplace();
+        _stream->data = std::move(dataCopy);
+        _stream->decoder = decoder;
+        _stream->pos = result;
+        exit.release();
+        return;
+    }
+
+    /* Size the output from the ADTS headers. With SBR the decoder outputs at
+       twice the frequency stored in the header, so the sample count per block
+       is scaled by the ratio. The decoder delay can make the actual count
+       smaller, which is handled below. Streams that aren't ADTS start with
+       a guess and grow. */
+    UnsignedInt adtsFrequency = 0;
+    const std::size_t blockCount = adtsBlockCount(data.suffix(result), adtsFrequency);
+    const std::size_t frameSize = channels*sizeof(UnsignedShort);
+    Containers::Array<char> out{Containers::NoInit, blockCount ?
+        blockCount*(1024*samplerate/adtsFrequency)*frameSize : 1024*frameSize};
+
     std::size_t pos = result;
-    std::vector<UnsignedShort> samples;
+    std::size_t size = 0;
     while(pos < data.size()) {
-        NeAACDecFrameInfo info;
-        void* sampleBuffer = NeAACDecDecode(decoder, &info, const_cast<unsigned char*>(reinterpret_cast<const unsigned char*>(data.data())) + pos, data.size() - pos);
-        if(info.error) {
+        Containers::ArrayView<const char> samples;
+        if(!decodeFrame(decoder, data, pos, samples)) {
             Error{} << "Audio::Faad2Importer::openData(): decoding error";
             return;
         }
 
-        std::size_t end = samples.size();
-        samples.resize(samples.size() + info.samples);
-        std::copy_n(reinterpret_cast<UnsignedShort*>(sampleBuffer), info.samples, &samples[0] + end);
-        pos += info.bytesconsumed;
+        /* Grow the output only if the pre-scan didn't tell us enough --
+           which shouldn't happen for well-formed ADTS streams */
+        if(size + samples.size() > out.size()) {
+            Containers::Array<char> grown{Containers::NoInit, Math::max(out.size()*2, size + samples.size())};
+            Utility::copy(out.prefix(size), grown.prefix(size));
+            out = std::move(grown);
+        }
+
+        Utility::copy(samples, out.slice(size, size + samples.size()));
+        size += samples.size();
     }
 
-    _samples = std::move(samples);
+    /* Shrink to the actual size, if needed */
+    if(size != out.size()) {
+        Containers::Array<char> shrunk{Containers::NoInit, size};
+        Utility::copy(out.prefix(size), shrunk);
+        out = std::move(shrunk);
+    }
+
+    if(!Implementation::convertAudio(configuration(), "Audio::Faad2Importer::openData():", _format, _frequency, out))
+        return;
+
+    _data = std::move(out);
 }
 
-void Faad2Importer::doClose() { _samples.clear(); }
+void Faad2Importer::doClose() {
+    _data = Containers::NullOpt;
+    _stream = nullptr;
+}
 
 BufferFormat Faad2Importer::doFormat() const { return _format; }
 
 UnsignedInt Faad2Importer::doFrequency() const { return _frequency; }
 
 Containers::Array<char> Faad2Importer::doData() {
-    Containers::Array<char> copy(_samples.size()*2);
-    std::memcpy(copy.begin(), _samples.data(), copy.size());
+    if(_stream) {
+        Error{} << "Audio::Faad2Importer::data(): the file is opened for streaming, use read() instead";
+        return nullptr;
+    }
+
+    Containers::Array<char> copy{Containers::NoInit, _data->size()};
+    Utility::copy(*_data, copy);
     return copy;
 }
 
+std::size_t Faad2Importer::read(const Containers::ArrayView<char> out) {
+    CORRADE_ASSERT(_stream,
+        "Audio::Faad2Importer::read(): no file opened for streaming", {});
+
+    /* Only whole frames, the output is always 16-bit stereo */
+    const std::size_t size = out.size()/(2*sizeof(UnsignedShort))*(2*sizeof(UnsignedShort));
+    std::size_t written = 0;
+    for(;;) {
+        /* Copy what's left from the previously decoded frame first */
+        const std::size_t count = Math::min(size - written, _stream->pending.size());
+        Utility::copy(_stream->pending.prefix(count), out.slice(written, written + count));
+        _stream->pending = _stream->pending.suffix(count);
+        written += count;
+
+        if(written == size || _stream->pos >= _stream->data.size()) break;
+
+        if(!decodeFrame(_stream->decoder, _stream->data, _stream->pos, _stream->pending)) {
+            Error{} << "Audio::Faad2Importer::read(): decoding error";
+            break;
+        }
+    }
+
+    return written;
+}
+
+Containers::Array<char> Faad2Importer::releaseData() {
+    CORRADE_ASSERT(isOpened(),
+        "Audio::Faad2Importer::releaseData(): no file opened", {});
+
+    if(_stream) {
+        Error{} << "Audio::Faad2Importer::releaseData(): the file is opened for streaming, use read() instead";
+        return nullptr;
+    }
+
+    Containers::Array<char> out = std::move(*_data);
+    close();
+    return out;
+}
+
 }}
 
 CORRADE_PLUGIN_REGISTER(Faad2AudioImporter, Magnum::Audio::Faad2Importer,
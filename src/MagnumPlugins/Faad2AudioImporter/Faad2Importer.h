@@ -29,7 +29,9 @@
  * @brief Class @ref Magnum::Audio::Faad2Importer
  */
 
-#include <vector>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Magnum/Audio/AbstractImporter.h>
 
 #include "MagnumPlugins/Faad2AudioImporter/configure.h"
@@ -109,6 +111,45 @@ target_link_libraries(your-app PRIVATE MagnumPlugins::Faad2AudioImporter)
 
 See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
 information.
+
+@section Audio-Faad2Importer-behavior Behavior and limitations
+
+For ADTS streams the frame headers are walked through before decoding to
+calculate the sample count, so the output is allocated just once and
+decoded into in a single pass. As FAAD2 delays the output by a frame, the
+output is shrunk to the actual size at the end. For other streams, such as
+ADIF, the sample count can't be known upfront and the output grows as the
+frames are decoded.
+
+@section Audio-Faad2Importer-streaming Streaming
+
+By default the whole file is decoded in @ref openData() / @ref openFile(). If
+the @cb{.ini} streaming @ce @ref Audio-Faad2Importer-configuration "configuration option"
+is enabled, only the header is parsed on opening and samples are decoded in
+chunks via @ref read() into a caller-provided buffer, in the same format as
+@ref data() would return. The file data are copied and kept for the whole time
+the file is opened. Calling @ref data() on a file opened for streaming prints
+a message to @ref Error and returns an empty array. Decoding errors are then
+reported only from @ref read().
+
+@section Audio-Faad2Importer-conversion Frequency and channel count conversion
+
+If the @cb{.ini} frequency @ce or @cb{.ini} channelCount @ce
+@ref Audio-Faad2Importer-configuration "configuration options" are set, the samples
+are converted right after decoding in @ref openData() / @ref openFile(), so
+@ref data() returns them already in the target format. Resampling uses a
+windowed-sinc polyphase filter, vectorized with SSE2 or NEON where available.
+Channels are mixed through a stereo downmix, with stereo going to the front
+left and right channels of multi-channel outputs. This can be used to get mono
+files, which FAAD2 always decodes as stereo, back to mono. The options are
+ignored with a warning in streaming mode.
+
+@section Audio-Faad2Importer-configuration Plugin-specific configuration
+
+It's possible to tune various import options through @ref configuration(). See
+below for all options and their default values:
+
+@snippet MagnumPlugins/Faad2AudioImporter/Faad2AudioImporter.conf config
 */
 class MAGNUM_FAAD2AUDIOIMPORTER_EXPORT Faad2Importer: public AbstractImporter {
     public:
@@ -118,7 +159,39 @@ class MAGNUM_FAAD2AUDIOIMPORTER_EXPORT Faad2Importer: public AbstractImporter {
         /** @brief Plugin manager constructor */
         explicit Faad2Importer(PluginManager::AbstractManager& manager, const std::string& plugin);
 
+        ~Faad2Importer();
+
+        /**
+         * @brief Decode next chunk of samples
+         * @m_since_latest_{plugins}
+         *
+         * Expects that a file is opened with the @cb{.ini} streaming @ce
+         * @ref Audio-Faad2Importer-configuration "configuration option"
+         * enabled. Decodes as many whole sample frames as fit into @p out,
+         * in the same format as @ref data() would return, and returns the
+         * count of bytes written. If the returned value is less than the
+         * size of @p out rounded down to whole frames, the end of the stream
+         * was reached or a decoding error, which is printed to @ref Error,
+         * happened. See @ref Audio-Faad2Importer-streaming for more
+         * information.
+         */
+        virtual std::size_t read(Containers::ArrayView<char> out);
+
+        /**
+         * @brief Release the decoded data
+         * @m_since_latest_{plugins}
+         *
+         * Compared to @ref data(), which returns a copy, moves the decoded
+         * data out and closes the file, so there's never more than one copy
+         * of the samples alive. Expects that a file is opened. If the file is
+         * opened for streaming, prints a message to @ref Error and returns
+         * an empty array.
+         */
+        virtual Containers::Array<char> releaseData();
+
     private:
+        struct Stream;
+
         MAGNUM_FAAD2AUDIOIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_FAAD2AUDIOIMPORTER_LOCAL bool doIsOpened() const override;
         MAGNUM_FAAD2AUDIOIMPORTER_LOCAL void doOpenData(Containers::ArrayView<const char> data) override;
@@ -128,7 +201,8 @@ class MAGNUM_FAAD2AUDIOIMPORTER_EXPORT Faad2Importer: public AbstractImporter {
         MAGNUM_FAAD2AUDIOIMPORTER_LOCAL UnsignedInt doFrequency() const override;
         MAGNUM_FAAD2AUDIOIMPORTER_LOCAL Containers::Array<char> doData() override;
 
-        std::vector<UnsignedShort> _samples;
+        Containers::Optional<Containers::Array<char>> _data;
+        Containers::Pointer<Stream> _stream;
         BufferFormat _format;
         UnsignedInt _frequency;
 };
@@ -0,0 +1,178 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/Directory.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Magnum/Audio/AbstractImporter.h>
+
+#include "MagnumPlugins/Faad2AudioImporter/Faad2Importer.h"
+#include "MagnumPlugins/Implementation/audioConversion.h"
+#include "MagnumPlugins/Implementation/peakMemory.h"
+
+#include "configure.h"
+
+namespace Magnum { namespace Audio { namespace Test { namespace {
+
+struct Faad2ImporterBenchmark: TestSuite::Tester {
+    explicit Faad2ImporterBenchmark();
+
+    void decode();
+    void firstSample();
+    void peakMemory();
+
+    void peakMemoryBegin();
+    std::uint64_t peakMemoryEnd();
+
+    /* Explicitly forbid system-wide plugin dependencies */
+    PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
+
+    std::uint64_t _residentSizeBefore{};
+};
+
+/* To calculate the throughput in samples per second, divide the sample frame
+   count shown in the decode() test case description by the measured time */
+constexpr struct {
+    const char* name;
+    const char* filename;
+    std::size_t repeat;
+} ClipData[]{
+    {"mono, 1000x repeated", "mono.aac", 1000},
+    {"stereo, 500x repeated", "stereo.aac", 500}
+};
+
+/* The test files are just a few frames long. ADTS frames are self-contained,
+   so the file is repeated to get a clip of a realistic length. */
+Containers::Array<char> clip(const char* const filename, const std::size_t repeat) {
+    const Containers::Array<char> file = Utility::Directory::read(Utility::Directory::join(FAAD2AUDIOIMPORTER_TEST_DIR, filename));
+    Containers::Array<char> out{Containers::NoInit, file.size()*repeat};
+    for(std::size_t i = 0; i != repeat; ++i)
+        Utility::copy(file, out.slice(i*file.size(), (i + 1)*file.size()));
+    return out;
+}
+
+std::size_t frameCount(const BufferFormat format, const std::size_t size) {
+    Implementation::AudioSampleType type;
+    UnsignedInt channelCount;
+    CORRADE_INTERNAL_ASSERT_OUTPUT(Implementation::audioFormatProperties(format, type, channelCount));
+    return size/(Implementation::audioSampleSize(type)*channelCount);
+}
+
+Faad2ImporterBenchmark::Faad2ImporterBenchmark() {
+    addInstancedBenchmarks({&Faad2ImporterBenchmark::decode}, 10,
+        Containers::arraySize(ClipData));
+
+    addInstancedBenchmarks({&Faad2ImporterBenchmark::firstSample}, 10,
+        Containers::arraySize(ClipData));
+
+    addCustomInstancedBenchmarks({&Faad2ImporterBenchmark::peakMemory}, 1,
+        Containers::arraySize(ClipData),
+        &Faad2ImporterBenchmark::peakMemoryBegin,
+        &Faad2ImporterBenchmark::peakMemoryEnd,
+        BenchmarkUnits::Bytes);
+
+    /* Load the plugin directly from the build tree. Otherwise it's static and
+       already loaded. */
+    #ifdef FAAD2AUDIOIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(FAAD2AUDIOIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+void Faad2ImporterBenchmark::decode() {
+    auto&& data = ClipData[testCaseInstanceId()];
+
+    const Containers::Array<char> file = clip(data.filename, data.repeat);
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("Faad2AudioImporter");
+    CORRADE_VERIFY(importer->openData(file));
+    setTestCaseDescription(Utility::formatString("{}, {} frames at {} Hz",
+        data.name, frameCount(importer->format(), importer->data().size()),
+        importer->frequency()));
+
+    Containers::Array<char> out;
+    CORRADE_BENCHMARK(1) {
+        importer->openData(file);
+        out = static_cast<Faad2Importer&>(*importer).releaseData();
+    }
+
+    CORRADE_VERIFY(out);
+}
+
+void Faad2ImporterBenchmark::firstSample() {
+    auto&& data = ClipData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    const Containers::Array<char> file = clip(data.filename, data.repeat);
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("Faad2AudioImporter");
+    importer->configuration().setValue("streaming", true);
+
+    /* Large enough for a single frame of any format */
+    char sample[64];
+    std::size_t size = 0;
+    CORRADE_BENCHMARK(1) {
+        importer->openData(file);
+        size = static_cast<Faad2Importer&>(*importer).read(sample);
+    }
+
+    CORRADE_VERIFY(size);
+}
+
+void Faad2ImporterBenchmark::peakMemory() {
+    auto&& data = ClipData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifndef __linux__
+    CORRADE_SKIP("Peak memory can be measured only on Linux.");
+    #else
+    /* The input is loaded outside of the measured region, so only the memory
+       allocated by the decoder and for the output is counted */
+    const Containers::Array<char> file = clip(data.filename, data.repeat);
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("Faad2AudioImporter");
+
+    Containers::Array<char> out;
+    CORRADE_BENCHMARK(1) {
+        importer->openData(file);
+        out = static_cast<Faad2Importer&>(*importer).releaseData();
+    }
+
+    CORRADE_VERIFY(out);
+    #endif
+}
+
+void Faad2ImporterBenchmark::peakMemoryBegin() {
+    _residentSizeBefore = Magnum::Implementation::peakMemoryBegin();
+}
+
+std::uint64_t Faad2ImporterBenchmark::peakMemoryEnd() {
+    return Magnum::Implementation::peakMemoryEnd(_residentSizeBefore);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Audio::Test::Faad2ImporterBenchmark)
@@ -26,6 +26,8 @@
 #include <sstream>
 #include <Corrade/Containers/Array.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Corrade/Utility/Directory.h>
 #include <Magnum/ImageView.h>
@@ -33,6 +35,8 @@
 #include <Magnum/Audio/AbstractImporter.h>
 #include <Magnum/DebugTools/CompareImage.h>
 
+#include "MagnumPlugins/Faad2AudioImporter/Faad2Importer.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Audio { namespace Test { namespace {
@@ -47,10 +51,28 @@ class Faad2ImporterTest: public TestSuite::Tester {
         void mono();
         void stereo();
 
+        void streaming();
+        void streamingData();
+        void streamingError();
+
+        void releaseData();
+
+        void convert();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
 };
 
+constexpr struct {
+    const char* name;
+    const char* filename;
+    std::size_t chunkSize;
+} StreamingData[]{
+    {"mono, chunk smaller than a frame", "mono.aac", 1000},
+    {"stereo, chunk not a multiple of frame size", "stereo.aac", 4099},
+    {"stereo, chunk larger than the file", "stereo.aac", 65536}
+};
+
 Faad2ImporterTest::Faad2ImporterTest() {
     addTests({&Faad2ImporterTest::empty,
 
@@ -58,6 +80,16 @@ Faad2ImporterTest::Faad2ImporterTest() {
               &Faad2ImporterTest::mono,
               &Faad2ImporterTest::stereo});
 
+    addInstancedTests({&Faad2ImporterTest::streaming},
+        Containers::arraySize(StreamingData));
+
+    addTests({&Faad2ImporterTest::streamingData,
+              &Faad2ImporterTest::streamingError,
+
+              &Faad2ImporterTest::releaseData,
+
+              &Faad2ImporterTest::convert});
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef FAAD2AUDIOIMPORTER_PLUGIN_FILENAME
@@ -141,6 +173,89 @@ void Faad2ImporterTest::stereo() {
         (DebugTools::CompareImage{1.0f, 0.625f}));
 }
 
+void Faad2ImporterTest::streaming() {
+    auto&& data = StreamingData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Decode the whole file first to have something to compare to */
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("Faad2AudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(FAAD2AUDIOIMPORTER_TEST_DIR, data.filename)));
+    Containers::Array<char> expected = importer->data();
+
+    Containers::Pointer<AbstractImporter> streamingImporter = _manager.instantiate("Faad2AudioImporter");
+    streamingImporter->configuration().setValue("streaming", true);
+    CORRADE_VERIFY(streamingImporter->openFile(Utility::Directory::join(FAAD2AUDIOIMPORTER_TEST_DIR, data.filename)));
+    CORRADE_COMPARE(streamingImporter->format(), importer->format());
+    CORRADE_COMPARE(streamingImporter->frequency(), importer->frequency());
+
+    Containers::Array<char> out{Containers::NoInit, expected.size() + data.chunkSize};
+    std::size_t size = 0;
+    while(size + data.chunkSize <= out.size()) {
+        const std::size_t read = static_cast<Faad2Importer&>(*streamingImporter).read(out.slice(size, size + data.chunkSize));
+        if(!read) break;
+        size += read;
+    }
+
+    CORRADE_COMPARE_AS(out.prefix(size), expected,
+        TestSuite::Compare::Container);
+}
+
+void Faad2ImporterTest::streamingData() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("Faad2AudioImporter");
+    importer->configuration().setValue("streaming", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(FAAD2AUDIOIMPORTER_TEST_DIR, "stereo.aac")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(importer->data().empty());
+    CORRADE_COMPARE(out.str(), "Audio::Faad2Importer::data(): the file is opened for streaming, use read() instead\n");
+}
+
+void Faad2ImporterTest::streamingError() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("Faad2AudioImporter");
+    importer->configuration().setValue("streaming", true);
+
+    /* The error is discovered only once the frames get decoded */
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(FAAD2AUDIOIMPORTER_TEST_DIR, "error.aac")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    char data[4096];
+    CORRADE_COMPARE(static_cast<Faad2Importer&>(*importer).read(data), 0);
+    CORRADE_COMPARE(out.str(), "Audio::Faad2Importer::read(): decoding error\n");
+}
+
+void Faad2ImporterTest::releaseData() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("Faad2AudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(FAAD2AUDIOIMPORTER_TEST_DIR, "stereo.aac")));
+
+    Containers::Array<char> expected = importer->data();
+    Containers::Array<char> data = static_cast<Faad2Importer&>(*importer).releaseData();
+    CORRADE_COMPARE_AS(data, expected,
+        TestSuite::Compare::Container);
+
+    /* The file gets closed after */
+    CORRADE_VERIFY(!importer->isOpened());
+}
+
+void Faad2ImporterTest::convert() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("Faad2AudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(FAAD2AUDIOIMPORTER_TEST_DIR, "mono.aac")));
+    CORRADE_COMPARE(importer->format(), BufferFormat::Stereo16);
+    const UnsignedInt frequency = importer->frequency();
+    const std::size_t frameCount = importer->data().size()/(2*2);
+
+    /* The conversion itself is tested in DrWavAudioImporter, here it's just
+       about the options being propagated */
+    importer->configuration().setValue("frequency", frequency*2);
+    importer->configuration().setValue("channelCount", 1);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(FAAD2AUDIOIMPORTER_TEST_DIR, "mono.aac")));
+    CORRADE_COMPARE(importer->format(), BufferFormat::Mono16);
+    CORRADE_COMPARE(importer->frequency(), frequency*2);
+    /* Twice the frames, each having one channel of 16-bit samples */
+    CORRADE_COMPARE(importer->data().size(), frameCount*2*1*2);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Audio::Test::Faad2ImporterTest)
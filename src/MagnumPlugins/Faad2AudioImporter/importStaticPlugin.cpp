@@ -25,7 +25,7 @@
 
 #include "MagnumPlugins/Faad2AudioImporter/configure.h"
 
-#ifdef MAGNUM_FAAD2AUDIOIMPORTER_BUILD_STATIC
+#if defined(MAGNUM_FAAD2AUDIOIMPORTER_BUILD_STATIC) && !defined(MAGNUM_PLUGINS_NO_AUTOMATIC_IMPORT)
 #include <Corrade/PluginManager/AbstractManager.h>
 
 static int magnumFaad2AudioImporterStaticImporter() {
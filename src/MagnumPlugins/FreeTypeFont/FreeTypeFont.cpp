@@ -26,34 +26,223 @@
 #include "FreeTypeFont.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <thread>
+#include <unordered_map>
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include <Corrade/PluginManager/AbstractManager.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Unicode.h>
-#include <Magnum/Image.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/PixelStorage.h>
 #include <Magnum/Text/AbstractGlyphCache.h>
 
+#include "MagnumPlugins/Implementation/glyphBatch.h"
+#include "MagnumPlugins/Implementation/glyphBlit.h"
+#include "MagnumPlugins/Implementation/scratchBuffer.h"
+
 namespace Magnum { namespace Text {
 
 namespace {
 
-class FreeTypeLayouter: public AbstractLayouter {
+class FreeTypeLayouter final: public AbstractLayouter {
     public:
-        explicit FreeTypeLayouter(FT_Face font, const AbstractGlyphCache& cache, const Float fontSize, const Float textSize, std::vector<FT_UInt>&& glyphs);
+        explicit FreeTypeLayouter(const AbstractGlyphCache& cache, const Float fontSize, const Float textSize, std::vector<FT_UInt>&& glyphs, std::vector<Vector2>&& advances);
+
+        /* Non-virtual doRenderGlyph(), used by layoutBatch() */
+        std::tuple<Range2D, Range2D, Vector2> glyph(UnsignedInt i) const;
 
     private:
-        std::tuple<Range2D, Range2D, Vector2> doRenderGlyph(const UnsignedInt i) override;
+        std::tuple<Range2D, Range2D, Vector2> doRenderGlyph(const UnsignedInt i) override {
+            return glyph(i);
+        }
 
-        FT_Face font;
         const AbstractGlyphCache& cache;
         const Float fontSize, textSize;
         const std::vector<FT_UInt> glyphs;
+        const std::vector<Vector2> advances;
 };
 
+/* Takes count items of T from the front of the memory. The callers take the
+   8-byte types first so everything stays aligned. */
+template<class T> Containers::ArrayView<T> take(Containers::ArrayView<char>& memory, const std::size_t count) {
+    const Containers::ArrayView<T> out{reinterpret_cast<T*>(memory.data()), count};
+    memory = memory.suffix(count*sizeof(T));
+    return out;
+}
+
+/* Glyphs are distributed to threads in batches of this size */
+constexpr std::size_t GlyphBatchSize = 16;
+
+/* Pointer to the top row of a bitmap. A negative pitch means the rows go from
+   bottom to top in memory, but the pitch is always the offset to the next row
+   below. */
+const unsigned char* topRow(const FT_Bitmap& bitmap) {
+    return bitmap.pitch < 0 && bitmap.rows ?
+        bitmap.buffer - std::ptrdiff_t(bitmap.pitch)*(bitmap.rows - 1) :
+        bitmap.buffer;
+}
+
+/* One-dimensional squared Euclidean distance transform of n samples, as
+   described in "Distance Transforms of Sampled Functions" by Felzenszwalb and
+   Huttenlocher. The v and z arrays are scratch space for n and n + 1
+   items. */
+void squaredDistance1D(const Float* const f, Float* const d, Int* const v, Float* const z, const Int n) {
+    constexpr Float Infinity = 1.0e20f;
+    Int k = 0;
+    v[0] = 0;
+    z[0] = -Infinity;
+    z[1] = Infinity;
+    for(Int q = 1; q < n; ++q) {
+        Float s = ((f[q] + Float(q*q)) - (f[v[k]] + Float(v[k]*v[k])))/Float(2*q - 2*v[k]);
+        while(s <= z[k]) {
+            --k;
+            s = ((f[q] + Float(q*q)) - (f[v[k]] + Float(v[k]*v[k])))/Float(2*q - 2*v[k]);
+        }
+        ++k;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = Infinity;
+    }
+
+    k = 0;
+    for(Int q = 0; q < n; ++q) {
+        while(z[k + 1] < Float(q)) ++k;
+        d[q] = Float((q - v[k])*(q - v[k])) + f[v[k]];
+    }
 }
 
+/* Appends a signed distance field of a coverage bitmap, padded by radius on
+   each side, with rows going top to bottom like in FreeType. Pixels with
+   coverage of at least a half are treated as inside. The edge maps to 0.5,
+   inside is above and the distance goes linearly to 0 or 1 at radius
+   pixels. */
+void appendDistanceField(const FT_Bitmap& bitmap, const Int radius, std::vector<unsigned char>& out) {
+    constexpr Float Infinity = 1.0e20f;
+    const Vector2i bitmapSize{Int(bitmap.width), Int(bitmap.rows)};
+    const Vector2i size = bitmapSize + Vector2i{2*radius};
+    const unsigned char* const pixels = topRow(bitmap);
+
+    /* Squared distances to the nearest inside and outside pixel */
+    std::vector<Float> toInside(size.product());
+    std::vector<Float> toOutside(size.product());
+    for(Int y = 0; y != size.y(); ++y) for(Int x = 0; x != size.x(); ++x) {
+        const Vector2i in{x - radius, y - radius};
+        const bool inside = (in >= Vector2i{}).all() && (in < bitmapSize).all() &&
+            pixels[std::ptrdiff_t(in.y())*bitmap.pitch + in.x()] >= 128;
+        toInside[y*size.x() + x] = inside ? 0.0f : Infinity;
+        toOutside[y*size.x() + x] = inside ? Infinity : 0.0f;
+    }
+
+    /* Columns first, then rows */
+    const Int maxSize = size.max();
+    std::vector<Float> f(maxSize), d(maxSize), z(maxSize + 1);
+    std::vector<Int> v(maxSize);
+    for(std::vector<Float>* const distances: {&toInside, &toOutside}) {
+        for(Int x = 0; x != size.x(); ++x) {
+            for(Int y = 0; y != size.y(); ++y)
+                f[y] = (*distances)[y*size.x() + x];
+            squaredDistance1D(f.data(), d.data(), v.data(), z.data(), size.y());
+            for(Int y = 0; y != size.y(); ++y)
+                (*distances)[y*size.x() + x] = d[y];
+        }
+        for(Int y = 0; y != size.y(); ++y) {
+            Float* const row = distances->data() + y*size.x();
+            std::copy(row, row + size.x(), f.begin());
+            squaredDistance1D(f.data(), row, v.data(), z.data(), size.x());
+        }
+    }
+
+    /* The edge is half a pixel away from centers of the outermost pixels */
+    out.reserve(out.size() + size.product());
+    for(std::size_t i = 0, max = size.product(); i != max; ++i) {
+        const Float distance = toInside[i] == 0.0f ?
+            std::sqrt(toOutside[i]) - 0.5f : 0.5f - std::sqrt(toInside[i]);
+        out.push_back(UnsignedByte(Math::clamp(0.5f + distance/(2.0f*radius), 0.0f, 1.0f)*255.0f + 0.5f));
+    }
+}
+
+/* Advance of a glyph in pixels, loaded only if not already cached by
+   fillGlyphCache() or a previous call */
+Vector2 glyphAdvance(FT_Face font, std::unordered_map<UnsignedInt, Vector2>& glyphAdvances, const UnsignedInt glyph) {
+    const auto found = glyphAdvances.find(glyph);
+    if(found != glyphAdvances.end()) return found->second;
+
+    CORRADE_INTERNAL_ASSERT_OUTPUT(FT_Load_Glyph(font, glyph, FT_LOAD_DEFAULT) == 0);
+    const Vector2 advance = Vector2(font->glyph->advance.x, font->glyph->advance.y)/64.0f;
+    glyphAdvances.emplace(glyph, advance);
+    return advance;
+}
+
+/* AbstractGlyphCache::reserve() works only on an empty cache, so glyphs added
+   to a non-empty one are packed in rows above everything that's already
+   there. Returns an empty vector if there's not enough space. */
+std::vector<Range2Di> reserveIncremental(const AbstractGlyphCache& cache, const std::vector<Vector2i>& sizes) {
+    const Vector2i textureSize = cache.textureSize();
+    const Vector2i padding = cache.padding();
+
+    Int bottom = 0;
+    for(const auto& glyph: cache)
+        if(!glyph.second.second.size().isZero())
+            bottom = Math::max(bottom, glyph.second.second.top() + padding.y());
+
+    std::vector<Range2Di> out;
+    out.reserve(sizes.size());
+    Vector2i cursor{0, bottom};
+    Int rowHeight = 0;
+    for(const Vector2i& size: sizes) {
+        const Vector2i paddedSize = size + 2*padding;
+        if(cursor.x() + paddedSize.x() > textureSize.x()) {
+            cursor = {0, cursor.y() + rowHeight};
+            rowHeight = 0;
+        }
+        if(cursor.x() + paddedSize.x() > textureSize.x() || cursor.y() + paddedSize.y() > textureSize.y())
+            return {};
+
+        out.push_back(Range2Di::fromSize(cursor + padding, size));
+        cursor.x() += paddedSize.x();
+        rowHeight = Math::max(rowHeight, paddedSize.y());
+    }
+
+    return out;
+}
+
+}
+
+/* The face keeps the data referenced for its whole lifetime */
+struct FreeTypeFont::Face {
+    explicit Face(const Containers::ArrayView<const char> in): data{Containers::NoInit, in.size()}, face{} {
+        std::copy(in.begin(), in.end(), data.begin());
+    }
+
+    ~Face() {
+        if(face) CORRADE_INTERNAL_ASSERT_OUTPUT(FT_Done_Face(face) == 0);
+    }
+
+    Containers::Array<unsigned char> data;
+    FT_Face face;
+};
+
+/* Temporaries of doFillGlyphCache(), kept between calls so filling the cache
+   with glyphs of similar count doesn't allocate again */
+struct FreeTypeFont::Scratch {
+    /* Glyph indices, sized by the character and cached glyph count */
+    Implementation::ScratchBuffer indices;
+    /* Per-glyph data and per-thread faces, sized by the new glyph count */
+    Implementation::ScratchBuffer glyphs;
+    /* Staging for the updated part of the cache image */
+    Implementation::ScratchBuffer pixmap;
+    /* AbstractGlyphCache::reserve() takes a std::vector, reusing the same
+       one keeps its capacity. Same for the per-thread bitmap buffers. */
+    std::vector<Vector2i> charSizes;
+    std::vector<std::vector<unsigned char>> bitmaps;
+};
+
 FT_Library FreeTypeFont::library = nullptr;
 
 void FreeTypeFont::initialize() {
@@ -67,27 +256,58 @@ void FreeTypeFont::finalize() {
     library = nullptr;
 }
 
-FreeTypeFont::FreeTypeFont(): ftFont(nullptr) {}
+FreeTypeFont::FreeTypeFont(): ftFont(nullptr), _ftSize(nullptr), _scratch{new Scratch} {
+    /** @todo horrible workaround, fix this properly */
+    configuration().setValue("threads", 1);
+    configuration().setValue("distanceField", false);
+    configuration().setValue("distanceFieldRadius", 8);
+}
 
-FreeTypeFont::FreeTypeFont(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractFont{manager, plugin}, ftFont(nullptr) {}
+FreeTypeFont::FreeTypeFont(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractFont{manager, plugin}, ftFont(nullptr), _ftSize(nullptr), _scratch{new Scratch} {}
 
 FreeTypeFont::~FreeTypeFont() { close(); }
 
+void FreeTypeFont::setScratchAllocator(void*(*const allocate)(std::size_t, void*), void(*const deallocate)(void*, std::size_t, void*), void* const userData) {
+    CORRADE_ASSERT(!allocate == !deallocate,
+        "Text::FreeTypeFont::setScratchAllocator(): either both or none of the callbacks have to be set", );
+    for(Implementation::ScratchBuffer* buffer: {&_scratch->indices, &_scratch->glyphs, &_scratch->pixmap})
+        buffer->setAllocator(allocate, deallocate, userData);
+}
+
+std::size_t FreeTypeFont::scratchAllocationCount() const {
+    return _scratch->indices.allocationCount() + _scratch->glyphs.allocationCount() + _scratch->pixmap.allocationCount();
+}
+
+std::size_t FreeTypeFont::scratchAllocatedBytes() const {
+    return _scratch->indices.allocatedBytes() + _scratch->glyphs.allocatedBytes() + _scratch->pixmap.allocatedBytes();
+}
+
 FontFeatures FreeTypeFont::doFeatures() const { return FontFeature::OpenData; }
 
 bool FreeTypeFont::doIsOpened() const { return ftFont; }
 
 auto FreeTypeFont::doOpenData(const Containers::ArrayView<const char> data, const Float size) -> Metrics {
-    /* We need to preserve the data for whole FT_Face lifetime */
-    _data = Containers::Array<unsigned char>(data.size());
-    std::copy(data.begin(), data.end(), _data.begin());
-
     CORRADE_ASSERT(library, "Text::FreeTypeFont::openSingleData(): initialize() was not called", {});
-    /** @todo ability to specify different font in TTC collection */
-    if(FT_Error error = FT_New_Memory_Face(library, _data.begin(), _data.size(), 0, &ftFont)) {
-        Error{} << "Text::FreeTypeFont::openData(): failed to open the font:" << error;
-        return {};
+
+    /* If the face is set already, we're being opened from openSize() and
+       the data are the same. Otherwise copy the data, as they need to be
+       preserved for the whole FT_Face lifetime. */
+    if(!_face) {
+        std::shared_ptr<Face> face{new Face{data}};
+        /** @todo ability to specify different font in TTC collection */
+        if(FT_Error error = FT_New_Memory_Face(library, face->data.begin(), face->data.size(), 0, &face->face)) {
+            Error{} << "Text::FreeTypeFont::openData(): failed to open the font:" << error;
+            face->face = nullptr;
+            return {};
+        }
+        _face = std::move(face);
     }
+
+    /* Each instance has its own size, the one created with the face is
+       unused */
+    ftFont = _face->face;
+    CORRADE_INTERNAL_ASSERT_OUTPUT(FT_New_Size(ftFont, &_ftSize) == 0);
+    activateSize();
     CORRADE_INTERNAL_ASSERT_OUTPUT(FT_Set_Char_Size(ftFont, 0, size*64, 0, 0) == 0);
     return {size,
             ftFont->size->metrics.ascender/64.0f,
@@ -96,9 +316,32 @@ auto FreeTypeFont::doOpenData(const Containers::ArrayView<const char> data, cons
 }
 
 void FreeTypeFont::doClose() {
-    CORRADE_INTERNAL_ASSERT_OUTPUT(FT_Done_Face(ftFont) == 0);
-    _data = nullptr;
+    /* The face gets destroyed together with the data once the last instance
+       sharing it is closed */
+    CORRADE_INTERNAL_ASSERT_OUTPUT(FT_Done_Size(_ftSize) == 0);
+    _ftSize = nullptr;
+    _face = nullptr;
     ftFont = nullptr;
+    _glyphAdvances.clear();
+}
+
+void FreeTypeFont::activateSize() {
+    CORRADE_INTERNAL_ASSERT_OUTPUT(FT_Activate_Size(_ftSize) == 0);
+}
+
+Containers::Pointer<FreeTypeFont> FreeTypeFont::instantiateSize(const Float size) {
+    CORRADE_ASSERT(isOpened(),
+        "Text::FreeTypeFont::instantiateSize(): no font opened", {});
+
+    Containers::Pointer<FreeTypeFont> out{new FreeTypeFont};
+    openSize(*out, size);
+    return out;
+}
+
+void FreeTypeFont::openSize(FreeTypeFont& instance, const Float size) {
+    instance.configuration() = configuration();
+    instance._face = _face;
+    CORRADE_INTERNAL_ASSERT_OUTPUT(instance.openData(Containers::ArrayView<const char>{reinterpret_cast<const char*>(_face->data.data()), _face->data.size()}, size));
 }
 
 UnsignedInt FreeTypeFont::doGlyphId(const char32_t character) {
@@ -106,81 +349,225 @@ UnsignedInt FreeTypeFont::doGlyphId(const char32_t character) {
 }
 
 Vector2 FreeTypeFont::doGlyphAdvance(const UnsignedInt glyph) {
-    CORRADE_INTERNAL_ASSERT_OUTPUT(FT_Load_Glyph(ftFont, glyph, FT_LOAD_DEFAULT) == 0);
-    return Vector2(ftFont->glyph->advance.x, ftFont->glyph->advance.y)/64.0f;
+    activateSize();
+    return glyphAdvance(ftFont, _glyphAdvances, glyph);
 }
 
 void FreeTypeFont::doFillGlyphCache(AbstractGlyphCache& cache, const std::u32string& characters) {
-    /** @bug Crash when atlas is too small */
+    /** @bug Crash when atlas is too small and the cache is empty */
 
-    /* Get glyph codes from characters */
-    std::vector<FT_UInt> charIndices;
-    charIndices.resize(characters.size()+1);
+    activateSize();
+
+    /* Get glyph codes from characters. The cached and new index lists can't
+       be larger than the cache and the character list, respectively. */
+    Containers::ArrayView<char> indexMemory = _scratch->indices.get<char>(
+        (2*(characters.size() + 1) + cache.glyphCount())*sizeof(FT_UInt));
+    Containers::ArrayView<FT_UInt> charIndices = take<FT_UInt>(indexMemory, characters.size() + 1);
+    const Containers::ArrayView<FT_UInt> newIndices = take<FT_UInt>(indexMemory, characters.size() + 1);
+    const Containers::ArrayView<FT_UInt> cachedIndices = take<FT_UInt>(indexMemory, cache.glyphCount());
     charIndices[0] = 0;
     std::transform(characters.begin(), characters.end(), charIndices.begin()+1,
         [this](const char32_t c) { return FT_Get_Char_Index(ftFont, c); });
 
     /* Remove duplicates (e.g. uppercase and lowercase mapped to same glyph) */
     std::sort(charIndices.begin(), charIndices.end());
-    charIndices.erase(std::unique(charIndices.begin(), charIndices.end()), charIndices.end());
+    charIndices = charIndices.prefix(std::unique(charIndices.begin(), charIndices.end()));
+
+    /* Skip glyphs that are already in the cache. The invalid glyph is always
+       there, but with an empty rectangle until it's rendered by a fill. */
+    std::size_t cachedCount = 0;
+    for(const auto& glyph: cache)
+        if(glyph.first || !glyph.second.second.size().isZero())
+            cachedIndices[cachedCount++] = glyph.first;
+    const bool incremental = cachedCount;
+    if(incremental) {
+        std::sort(cachedIndices.begin(), cachedIndices.begin() + cachedCount);
+        charIndices = newIndices.prefix(std::set_difference(
+            charIndices.begin(), charIndices.end(),
+            cachedIndices.begin(), cachedIndices.begin() + cachedCount,
+            newIndices.begin()));
+        if(charIndices.empty()) return;
+    }
 
-    /* Sizes of all characters */
-    std::vector<Vector2i> charSizes;
-    charSizes.reserve(charIndices.size());
-    for(FT_UInt c: charIndices) {
-        CORRADE_INTERNAL_ASSERT_OUTPUT(FT_Load_Glyph(ftFont, c, FT_LOAD_DEFAULT) == 0);
-        charSizes.push_back(Vector2i(ftFont->glyph->metrics.width, ftFont->glyph->metrics.height)/64);
+    /* Load and render each glyph just once. The sizes are needed to reserve
+       space in the atlas, so the bitmaps are kept in per-thread buffers until
+       they can be copied there. The advances are remembered for
+       glyphAdvance() and layouting. */
+    /** @todo B&W only if radius != 0 */
+    const std::size_t count = charIndices.size();
+    std::vector<Vector2i>& charSizes = _scratch->charSizes;
+    charSizes.resize(count);
+
+    UnsignedInt threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount) threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    threadCount = UnsignedInt(std::min(std::size_t{threadCount}, (count + GlyphBatchSize - 1)/GlyphBatchSize));
+
+    /* Per-glyph offsets and advances, thread that rendered given glyph and
+       offset in its bitmap buffer, and a face for each thread */
+    Containers::ArrayView<char> glyphMemory = _scratch->glyphs.get<char>(
+        count*(sizeof(std::pair<std::size_t, std::size_t>) + sizeof(Vector2i) + sizeof(Vector2)) + threadCount*sizeof(FT_Face));
+    const Containers::ArrayView<std::pair<std::size_t, std::size_t>> charBitmaps = take<std::pair<std::size_t, std::size_t>>(glyphMemory, count);
+    const Containers::ArrayView<FT_Face> faces = take<FT_Face>(glyphMemory, threadCount);
+    const Containers::ArrayView<Vector2i> charOffsets = take<Vector2i>(glyphMemory, count);
+    const Containers::ArrayView<Vector2> charAdvances = take<Vector2>(glyphMemory, count);
+
+    /* A FT_Face can't be used from multiple threads at once, so each
+       additional thread gets its own face for the same font data. Creating
+       and destroying faces of a shared FT_Library isn't thread-safe, so it's
+       done here on the calling thread. */
+    faces[0] = ftFont;
+    for(std::size_t i = 1; i != faces.size(); ++i) {
+        CORRADE_INTERNAL_ASSERT_OUTPUT(FT_New_Memory_Face(library, _face->data.begin(), _face->data.size(), 0, &faces[i]) == 0);
+        CORRADE_INTERNAL_ASSERT_OUTPUT(FT_Set_Char_Size(faces[i], 0, size()*64, 0, 0) == 0);
     }
 
-    /* Create texture atlas */
-    const std::vector<Range2Di> charPositions = cache.reserve(charSizes);
+    const Int distanceFieldRadius = configuration().value<bool>("distanceField") ?
+        configuration().value<Int>("distanceFieldRadius") : 0;
+
+    /* Each thread takes the next batch of glyphs that aren't rendered yet.
+       Every glyph is written to a disjoint slot of the output vectors, so no
+       locking is needed. */
+    std::vector<std::vector<unsigned char>>& bitmaps = _scratch->bitmaps;
+    if(bitmaps.size() < threadCount) bitmaps.resize(threadCount);
+    for(std::size_t i = 0; i != threadCount; ++i) bitmaps[i].clear();
+    std::atomic<std::size_t> next{0};
+    auto renderGlyphs = [&](const std::size_t thread) {
+        const FT_Face face = faces[thread];
+        std::vector<unsigned char>& threadBitmaps = bitmaps[thread];
+        std::size_t begin;
+        while((begin = next.fetch_add(GlyphBatchSize)) < count) {
+            for(std::size_t i = begin, end = std::min(begin + GlyphBatchSize, count); i != end; ++i) {
+                CORRADE_INTERNAL_ASSERT_OUTPUT(FT_Load_Glyph(face, charIndices[i], FT_LOAD_RENDER) == 0);
+                const FT_GlyphSlot glyph = face->glyph;
+                const FT_Bitmap& bitmap = glyph->bitmap;
+
+                charAdvances[i] = Vector2(glyph->advance.x, glyph->advance.y)/64.0f;
+                charBitmaps[i] = {thread, threadBitmaps.size()};
+
+                /* Empty glyphs such as space stay empty even with a distance
+                   field, there's nothing to get a distance to */
+                if(distanceFieldRadius && bitmap.width && bitmap.rows) {
+                    charSizes[i] = Vector2i(bitmap.width, bitmap.rows) + Vector2i{2*distanceFieldRadius};
+                    charOffsets[i] = Vector2i(glyph->bitmap_left - distanceFieldRadius, glyph->bitmap_top + distanceFieldRadius);
+                    appendDistanceField(bitmap, distanceFieldRadius, threadBitmaps);
+                } else {
+                    charSizes[i] = Vector2i(bitmap.width, bitmap.rows);
+                    charOffsets[i] = Vector2i(glyph->bitmap_left, glyph->bitmap_top);
+                    const unsigned char* const pixels = topRow(bitmap);
+                    for(Int y = 0, ymax = bitmap.rows; y != ymax; ++y) {
+                        const unsigned char* const row = pixels + std::ptrdiff_t(y)*bitmap.pitch;
+                        threadBitmaps.insert(threadBitmaps.end(), row, row + bitmap.width);
+                    }
+                }
+            }
+        }
+    };
+
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(std::size_t i = 0; i != threads.size(); ++i)
+        threads[i] = std::thread{renderGlyphs, i + 1};
+    renderGlyphs(0);
+    for(std::thread& thread: threads) thread.join();
+    for(std::size_t i = 1; i != faces.size(); ++i)
+        CORRADE_INTERNAL_ASSERT_OUTPUT(FT_Done_Face(faces[i]) == 0);
+
+    for(std::size_t i = 0; i != count; ++i)
+        _glyphAdvances[charIndices[i]] = charAdvances[i];
+
+    /* Create texture atlas, or extend it if there's something already */
+    const std::vector<Range2Di> charPositions = incremental ?
+        reserveIncremental(cache, charSizes) : cache.reserve(charSizes);
+    if(charPositions.empty()) {
+        Error{} << "Text::FreeTypeFont::fillGlyphCache(): cannot fit" << charIndices.size() << "new glyphs into the cache";
+        return;
+    }
 
-    /* Render all characters to the atlas and create character map */
-    Containers::Array<char> pixmap{Containers::ValueInit, std::size_t(cache.textureSize().product())};
+    /* The first fill uploads the whole image, subsequent fills only the area
+       covered by the new glyphs, including their padding */
+    Range2Di updated;
+    if(!incremental) updated = {{}, cache.textureSize()};
+    else {
+        for(const Range2Di& position: charPositions) {
+            if(position.size().isZero()) continue;
+            const Range2Di padded = position.padded(cache.padding());
+            updated = updated.size().isZero() ? padded : Math::join(updated, padded);
+        }
+        updated = Math::intersect(updated, Range2Di{{}, cache.textureSize()});
+    }
+
+    /* Copy the rendered bitmaps to texture image and create character map */
+    const Containers::ArrayView<char> pixmap = _scratch->pixmap.get<char>(updated.size().product());
+    std::memset(pixmap.data(), 0, pixmap.size());
     for(std::size_t i = 0; i != charPositions.size(); ++i) {
-        /* Load and render glyph */
-        /** @todo B&W only if radius != 0 */
-        FT_GlyphSlot glyph = ftFont->glyph;
-        CORRADE_INTERNAL_ASSERT_OUTPUT(FT_Load_Glyph(ftFont, charIndices[i], FT_LOAD_DEFAULT) == 0);
-        CORRADE_INTERNAL_ASSERT_OUTPUT(FT_Render_Glyph(glyph, FT_RENDER_MODE_NORMAL) == 0);
-
-        /* Copy rendered bitmap to texture image */
-        const FT_Bitmap& bitmap = glyph->bitmap;
-        CORRADE_INTERNAL_ASSERT(std::abs(Int(bitmap.width)-charPositions[i].sizeX()) <= 2);
-        CORRADE_INTERNAL_ASSERT(std::abs(Int(bitmap.rows)-charPositions[i].sizeY()) <= 2);
-        for(Int yin = 0, yout = charPositions[i].bottom(), ymax = bitmap.rows; yin != ymax; ++yin, ++yout)
-            for(Int xin = 0, xout = charPositions[i].left(), xmax = bitmap.width; xin != xmax; ++xin, ++xout)
-                pixmap[yout*cache.textureSize().x() + xout] = bitmap.buffer[(bitmap.rows-yin-1)*bitmap.width + xin];
+        const Vector2i min = charPositions[i].min() - updated.min();
+        Implementation::blitGlyphFlipped(
+            bitmaps[charBitmaps[i].first].data() + charBitmaps[i].second,
+            charSizes[i].x(), charSizes[i],
+            pixmap.data() + std::ptrdiff_t(min.y())*updated.sizeX() + min.x(),
+            updated.sizeX());
 
         /* Insert glyph parameters into cache */
         cache.insert(charIndices[i],
-            Vector2i(glyph->bitmap_left, glyph->bitmap_top-charPositions[i].sizeY()),
+            Vector2i(charOffsets[i].x(), charOffsets[i].y()-charPositions[i].sizeY()),
             charPositions[i]);
     }
 
-    /* Set cache image */
-    Image2D image(PixelFormat::R8Unorm, cache.textureSize(), std::move(pixmap));
-    cache.setImage({}, image);
+    /* Set the updated part of the cache image. The rows are tightly packed, as
+       the size isn't generally a multiple of four. */
+    if(updated.size().isZero()) return;
+    cache.setImage(updated.min(), ImageView2D{PixelStorage{}.setAlignment(1), PixelFormat::R8Unorm, updated.size(), pixmap});
 }
 
-Containers::Pointer<AbstractLayouter> FreeTypeFont::doLayout(const AbstractGlyphCache& cache, const Float size, const std::string& text) {
+namespace {
+
+Containers::Pointer<FreeTypeLayouter> layoutText(FT_Face font, std::unordered_map<UnsignedInt, Vector2>& glyphAdvances, const AbstractGlyphCache& cache, const Float fontSize, const Float size, const std::string& text) {
     /* Get glyph codes from characters */
     std::vector<UnsignedInt> glyphs;
     glyphs.reserve(text.size());
     for(std::size_t i = 0; i != text.size(); ) {
         UnsignedInt codepoint;
         std::tie(codepoint, i) = Utility::Unicode::nextChar(text, i);
-        glyphs.push_back(FT_Get_Char_Index(ftFont, codepoint));
+        glyphs.push_back(FT_Get_Char_Index(font, codepoint));
     }
 
-    return Containers::pointer(new FreeTypeLayouter(ftFont, cache, this->size(), size, std::move(glyphs)));
+    /* Resolve the advances upfront, so rendering the glyphs later doesn't
+       need to touch the font at all. Glyphs that got into the cache through
+       fillGlyphCache() or were laid out before aren't loaded again. */
+    std::vector<Vector2> advances;
+    advances.reserve(glyphs.size());
+    for(const UnsignedInt glyph: glyphs)
+        advances.push_back(glyphAdvance(font, glyphAdvances, glyph));
+
+    return Containers::pointer(new FreeTypeLayouter(cache, fontSize, size, std::move(glyphs), std::move(advances)));
+}
+
+}
+
+Containers::Pointer<AbstractLayouter> FreeTypeFont::doLayout(const AbstractGlyphCache& cache, const Float size, const std::string& text) {
+    activateSize();
+    return layoutText(ftFont, _glyphAdvances, cache, this->size(), size, text);
+}
+
+std::size_t FreeTypeFont::layoutBatch(const AbstractGlyphCache& cache, const Float size, const Containers::ArrayView<const std::string> texts, const Containers::ArrayView<const Vector2> origins, const Containers::StridedArrayView1D<Vector2>& positions, const Containers::StridedArrayView1D<Vector2>& textureCoordinates) {
+    CORRADE_ASSERT(isOpened(),
+        "Text::FreeTypeFont::layoutBatch(): no font opened", {});
+    CORRADE_ASSERT(texts.size() == origins.size(),
+        "Text::FreeTypeFont::layoutBatch(): expected" << texts.size() << "origins but got" << origins.size(), {});
+
+    activateSize();
+    std::vector<Containers::Pointer<FreeTypeLayouter>> layouters;
+    layouters.reserve(texts.size());
+    for(const std::string& text: texts)
+        layouters.push_back(layoutText(ftFont, _glyphAdvances, cache, this->size(), size, text));
+
+    return Implementation::renderGlyphBatch(layouters, origins, positions, textureCoordinates);
 }
 
 namespace {
 
-FreeTypeLayouter::FreeTypeLayouter(FT_Face font, const AbstractGlyphCache& cache, const Float fontSize, const Float textSize, std::vector<FT_UInt>&& glyphs): AbstractLayouter(glyphs.size()), font(font), cache(cache), fontSize(fontSize), textSize(textSize), glyphs(std::move(glyphs)) {}
+FreeTypeLayouter::FreeTypeLayouter(const AbstractGlyphCache& cache, const Float fontSize, const Float textSize, std::vector<FT_UInt>&& glyphs, std::vector<Vector2>&& advances): AbstractLayouter(glyphs.size()), cache(cache), fontSize(fontSize), textSize(textSize), glyphs(std::move(glyphs)), advances(std::move(advances)) {}
 
-std::tuple<Range2D, Range2D, Vector2> FreeTypeLayouter::doRenderGlyph(const UnsignedInt i) {
+std::tuple<Range2D, Range2D, Vector2> FreeTypeLayouter::glyph(const UnsignedInt i) const {
     /* Position of the texture in the resulting glyph, texture coordinates */
     Vector2i position;
     Range2Di rectangle;
@@ -193,12 +580,8 @@ std::tuple<Range2D, Range2D, Vector2> FreeTypeLayouter::doRenderGlyph(const Unsi
        requested text size */
     const auto quadRectangle = Range2D(Range2Di::fromSize(position, rectangle.size())).scaled(Vector2(textSize/fontSize));
 
-    /* Load glyph */
-    CORRADE_INTERNAL_ASSERT_OUTPUT(FT_Load_Glyph(font, glyphs[i], FT_LOAD_DEFAULT) == 0);
-    const FT_GlyphSlot slot = font->glyph;
-
     /* Glyph advance, denormalized to requested text size */
-    const Vector2 advance = Vector2(slot->advance.x, slot->advance.y)*(textSize/(64.0f*fontSize));
+    const Vector2 advance = advances[i]*(textSize/fontSize);
 
     return std::make_tuple(quadRectangle, textureCoordinates, advance);
 }
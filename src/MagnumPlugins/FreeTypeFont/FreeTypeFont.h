@@ -29,7 +29,11 @@
  * @brief Class @ref Magnum::Text::FreeTypeFont
  */
 
+#include <memory>
+#include <unordered_map>
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/VisibilityMacros.h>
 #include <Magnum/Text/AbstractFont.h>
 
@@ -40,6 +44,8 @@ struct FT_LibraryRec_;
 typedef FT_LibraryRec_* FT_Library;
 struct FT_FaceRec_;
 typedef FT_FaceRec_*  FT_Face;
+struct FT_SizeRec_;
+typedef FT_SizeRec_*  FT_Size;
 
 #ifndef MAGNUM_FREETYPEFONT_BUILD_STATIC
     #ifdef FreeTypeFont_EXPORTS
@@ -113,6 +119,85 @@ target_link_libraries(your-app PRIVATE MagnumPlugins::FreeTypeFont)
 
 See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
 information.
+
+@section Text-FreeTypeFont-glyph-cache Glyph cache filling
+
+Each glyph is loaded and rendered just once in @ref fillGlyphCache(). Its
+advance is remembered, so @ref glyphAdvance() and @ref layout() don't need to
+load it again.
+
+The first fill into an empty cache lays out the glyphs using
+@ref AbstractGlyphCache::reserve() and uploads the whole cache image. Later
+fills into the same cache are incremental. Glyphs that are already in the
+cache are skipped. The new ones are packed in rows above the already occupied
+area. Only the rectangle covering them, including the padding, is uploaded.
+If the new glyphs don't fit, a message is printed to @ref Error and the cache
+is left untouched. Note that caches which process the image on upload, such as
+@ref DistanceFieldGlyphCache, may need the updated rectangle to stay aligned
+to their downscaling ratio.
+
+If the @cb{.ini} threads @ce
+@ref Text-FreeTypeFont-configuration "configuration option" is set to a value
+other than @cpp 1 @ce, the glyphs are rendered on multiple threads, each with
+its own FreeType face created from the same font data. The application then
+needs to link to `pthread` on Linux due to the same reasons as described in
+@ref Trade-BasisImageConverter-loading "BasisImageConverter docs". Copying the
+rendered glyphs to the cache image and uploading it is done on the calling
+thread.
+
+@subsection Text-FreeTypeFont-glyph-cache-distance-field Distance field glyphs
+
+If the @cb{.ini} distanceField @ce
+@ref Text-FreeTypeFont-configuration "configuration option" is enabled,
+@ref fillGlyphCache() puts a signed distance field of each glyph into the
+cache instead of its coverage bitmap, so a single cache can be used for
+rendering text of any size, for example with @ref Shaders::DistanceFieldVector.
+The distance is calculated with an exact Euclidean distance transform of the
+glyph bitmap rendered at the font size, treating pixels with at least half
+coverage as inside. Every glyph is padded by @cb{.ini} distanceFieldRadius @ce
+pixels on each side, its edge is at the value of @cpp 0.5 @ce and the distance
+maps linearly to @cpp 0.0 @ce and @cpp 1.0 @ce at the radius outside and inside
+the glyph. The font should be opened with a large enough size, such as
+@cpp 64.0f @ce, to have smooth edges when scaled up. Compared to
+@ref DistanceFieldGlyphCache, the distance field is calculated on the CPU and
+the cache image is not downscaled.
+
+@subsection Text-FreeTypeFont-glyph-cache-scratch Scratch memory
+
+The glyph lists, per-glyph metrics and the staging image used by
+@ref fillGlyphCache() are kept in the font instance between calls and reused,
+so after the first few fills, repeatedly filling a cache with a similar
+amount of glyphs --- for example when streaming glyphs every frame --- doesn't
+allocate for them anymore. The memory can be supplied by an arena or pool
+allocator set with @ref setScratchAllocator() and
+@ref scratchAllocationCount() together with @ref scratchAllocatedBytes() show
+how much has been allocated so far. The per-thread glyph bitmaps and the
+sizes passed to @ref AbstractGlyphCache::reserve() are kept around as well,
+but still use the standard allocator.
+
+@section Text-FreeTypeFont-sizes Multiple sizes of the same font
+
+A font opened with @ref openFile() or @ref openData() is bound to a single
+size. Instead of opening the same file again for every other size, use
+@ref instantiateSize(), which returns a new font instance in given size that
+shares the font data and the FreeType face with the original one. Only a
+FreeType size object is created for each instance, the font data and the
+face don't get copied or parsed again. The instance has its own configuration
+copied from the original font at the time of the call and its own glyph
+advance cache, and can be used even after the original font is closed or
+destroyed. The shared data are released once the last instance using them is
+closed.
+
+Because the instances share a single FreeType face, they can't be used from
+multiple threads at once. The returned instance isn't managed by the plugin
+manager, so it has to be destroyed before the plugin is unloaded.
+
+@section Text-FreeTypeFont-configuration Plugin-specific configuration
+
+It's possible to tune various options through @ref configuration(). See below
+for all options and their default values:
+
+@snippet MagnumPlugins/FreeTypeFont/FreeTypeFont.conf config
 */
 class MAGNUM_FREETYPEFONT_EXPORT FreeTypeFont: public AbstractFont {
     public:
@@ -130,14 +215,109 @@ class MAGNUM_FREETYPEFONT_EXPORT FreeTypeFont: public AbstractFont {
 
         ~FreeTypeFont();
 
+        /**
+         * @brief Set an allocator for the glyph cache filling scratch memory
+         * @param allocate      Allocation function
+         * @param deallocate    Deallocation function
+         * @param userData      User data passed to both functions
+         * @m_since_latest_{plugins}
+         *
+         * The @p allocate function gets the size in bytes and is expected to
+         * return memory aligned at least as @cpp new[] @ce would. The
+         * @p deallocate function gets the pointer together with the size
+         * passed to @p allocate. Either both or none of the functions have
+         * to be set, passing @cpp nullptr @ce switches back to the default
+         * allocator. Memory allocated through the previous allocator is
+         * released immediately. See
+         * @ref Text-FreeTypeFont-glyph-cache-scratch for more information.
+         *
+         * The function is virtual so it can be called on a dynamically
+         * loaded plugin without linking to it.
+         */
+        virtual void setScratchAllocator(void*(*allocate)(std::size_t size, void* userData), void(*deallocate)(void* data, std::size_t size, void* userData), void* userData = nullptr);
+
+        /**
+         * @brief Count of scratch memory allocations
+         * @m_since_latest_{plugins}
+         *
+         * Total count of allocations done by @ref fillGlyphCache() for its
+         * scratch memory since the font was created. Stays the same once the
+         * scratch memory is large enough for the fills done.
+         */
+        virtual std::size_t scratchAllocationCount() const;
+
+        /**
+         * @brief Total size of scratch memory allocations
+         * @m_since_latest_{plugins}
+         *
+         * Sum of the sizes of all allocations counted by
+         * @ref scratchAllocationCount(), in bytes.
+         */
+        virtual std::size_t scratchAllocatedBytes() const;
+
+        /**
+         * @brief Lay out multiple strings into a single vertex stream
+         * @param cache         Glyph cache
+         * @param size          Font size
+         * @param texts         Texts to lay out
+         * @param origins       Position of the first glyph of each text
+         * @param positions     Where to put vertex positions
+         * @param textureCoordinates Where to put vertex texture coordinates
+         * @return Total glyph count of all texts
+         * @m_since_latest_{plugins}
+         *
+         * Equivalent to calling @ref layout() for each text and then
+         * @ref AbstractLayouter::renderGlyph() for each of its glyphs,
+         * with the cursor starting at the corresponding origin, but without
+         * a virtual call for each glyph. Four vertices are written for each
+         * glyph, in the order top left, bottom left, top right, bottom right,
+         * so each glyph is drawn as a pair of triangles with indices
+         * @cpp 0, 1, 2, 1, 3, 2 @ce offset by four times the glyph index.
+         * The views can point into an interleaved buffer, so everything can
+         * be drawn in a single draw call.
+         *
+         * If @p positions or @p textureCoordinates have less than four times
+         * the returned glyph count elements, nothing is written. Passing
+         * empty views can be used to query the size to allocate. Expects
+         * that a font is opened and that @p origins has the same size as
+         * @p texts.
+         *
+         * The function is virtual so it can be called on a dynamically
+         * loaded plugin without linking to it. @ref HarfBuzzFont overrides
+         * it to use its own shaping.
+         */
+        virtual std::size_t layoutBatch(const AbstractGlyphCache& cache, Float size, Containers::ArrayView<const std::string> texts, Containers::ArrayView<const Vector2> origins, const Containers::StridedArrayView1D<Vector2>& positions, const Containers::StridedArrayView1D<Vector2>& textureCoordinates);
+
+        /**
+         * @brief Instantiate the opened font in a different size
+         * @m_since_latest_{plugins}
+         *
+         * Returns a new font instance, opened in @p size, which shares the
+         * font data and the FreeType face with this one. See
+         * @ref Text-FreeTypeFont-sizes for more information. Expects that a
+         * font is opened.
+         *
+         * The function is virtual so it can be called on a dynamically
+         * loaded plugin without linking to it. @ref HarfBuzzFont overrides
+         * it to return a @ref HarfBuzzFont instance.
+         */
+        virtual Containers::Pointer<FreeTypeFont> instantiateSize(Float size);
+
     #ifdef DOXYGEN_GENERATING_OUTPUT
     private:
     #else
     protected:
     #endif
-        Containers::Array<unsigned char> _data;
         FT_Face ftFont;
 
+        /* Opens `instance` in given size with the face shared with this
+           font, used by instantiateSize() */
+        void openSize(FreeTypeFont& instance, Float size);
+
+        /* Makes the size of this instance active in the shared face. Has to
+           be called before loading glyphs or querying metrics. */
+        void activateSize();
+
         bool doIsOpened() const override;
         Metrics doOpenData(Containers::ArrayView<const char> data, Float size) override;
         void doClose() override;
@@ -145,6 +325,19 @@ class MAGNUM_FREETYPEFONT_EXPORT FreeTypeFont: public AbstractFont {
     private:
         static MAGNUM_FREETYPEFONT_LOCAL FT_Library library;
 
+        /* Font data and the face, shared with all instances created through
+           instantiateSize(). Each instance has its own size in the face. */
+        struct Face;
+        std::shared_ptr<Face> _face;
+        FT_Size _ftSize;
+
+        /* Filled by doFillGlyphCache() and doGlyphAdvance(), used by the
+           layouter to avoid loading each glyph again */
+        std::unordered_map<UnsignedInt, Vector2> _glyphAdvances;
+
+        struct Scratch;
+        Containers::Pointer<Scratch> _scratch;
+
         FontFeatures MAGNUM_FREETYPEFONT_LOCAL doFeatures() const override;
 
         UnsignedInt doGlyphId(char32_t character) override;
@@ -0,0 +1,422 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Arguments.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Unicode.h>
+#include <Magnum/Math/Range.h>
+#include <Magnum/Text/AbstractFont.h>
+#include <Magnum/Text/AbstractGlyphCache.h>
+
+#include "MagnumPlugins/FreeTypeFont/FreeTypeFont.h"
+
+#include "configure.h"
+
+/* Counting all allocations done through operator new, which includes the
+   plugins on Linux. Allocations done by FreeType, HarfBuzz and stb_truetype
+   themselves go through std::malloc() and are not included in the counts.
+   On Windows with shared libraries this affects only allocations in this
+   executable. */
+namespace {
+    std::atomic<std::size_t> allocationCount{};
+}
+
+void* operator new(std::size_t size) {
+    ++allocationCount;
+    if(void* const p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace Magnum { namespace Text { namespace Test { namespace {
+
+/* Compares FreeTypeFont, HarfBuzzFont and StbTrueTypeFont on the same font
+   file and inputs, the plugins that aren't built are skipped. The bundled
+   font has no CJK glyphs, pass a different one with --font-file to run the
+   CJK benchmarks. */
+struct FreeTypeFontBenchmark: TestSuite::Tester {
+    explicit FreeTypeFontBenchmark();
+
+    void fillGlyphCache();
+    void fillGlyphCacheAllocations();
+    void layout();
+    void layoutAllocations();
+    void layoutBatch();
+
+    void allocationBenchmarkBegin();
+    std::uint64_t allocationBenchmarkEnd();
+
+    /* Explicitly forbid system-wide plugin dependencies */
+    PluginManager::Manager<AbstractFont> _manager{"nonexistent"};
+
+    std::string _fontFile;
+    std::size_t _allocationCount;
+};
+
+struct DummyGlyphCache: AbstractGlyphCache {
+    using AbstractGlyphCache::AbstractGlyphCache;
+
+    GlyphCacheFeatures doFeatures() const override { return {}; }
+    void doSetImage(const Vector2i&, const ImageView2D&) override {}
+};
+
+enum class Characters: UnsignedByte {
+    Ascii,
+    LatinExtended,
+    Cjk
+};
+
+/* To calculate the throughput, divide the glyph count shown in the test case
+   description by the measured time */
+constexpr struct {
+    const char* name;
+    const char* plugin;
+    Characters characters;
+    Vector2i textureSize;
+    UnsignedInt threads;
+} FillData[]{
+    {"FreeTypeFont, ASCII", "FreeTypeFont", Characters::Ascii, {512, 512}, 1},
+    {"FreeTypeFont, Latin extended", "FreeTypeFont", Characters::LatinExtended, {2048, 2048}, 1},
+    {"FreeTypeFont, CJK", "FreeTypeFont", Characters::Cjk, {4096, 4096}, 1},
+    {"FreeTypeFont, CJK, all threads", "FreeTypeFont", Characters::Cjk, {4096, 4096}, 0},
+    {"HarfBuzzFont, ASCII", "HarfBuzzFont", Characters::Ascii, {512, 512}, 1},
+    {"HarfBuzzFont, Latin extended", "HarfBuzzFont", Characters::LatinExtended, {2048, 2048}, 1},
+    {"HarfBuzzFont, CJK", "HarfBuzzFont", Characters::Cjk, {4096, 4096}, 1},
+    {"StbTrueTypeFont, ASCII", "StbTrueTypeFont", Characters::Ascii, {512, 512}, 1},
+    {"StbTrueTypeFont, Latin extended", "StbTrueTypeFont", Characters::LatinExtended, {2048, 2048}, 1},
+    {"StbTrueTypeFont, CJK", "StbTrueTypeFont", Characters::Cjk, {4096, 4096}, 1}
+};
+
+/* The measured time is per string */
+constexpr struct {
+    const char* name;
+    const char* plugin;
+    bool paragraphs;
+    Float size;
+    std::size_t shapeCacheSize;
+} LayoutData[]{
+    {"FreeTypeFont, labels, 12 px", "FreeTypeFont", false, 12.0f, 0},
+    {"FreeTypeFont, labels, 48 px", "FreeTypeFont", false, 48.0f, 0},
+    {"FreeTypeFont, paragraphs, 12 px", "FreeTypeFont", true, 12.0f, 0},
+    {"FreeTypeFont, paragraphs, 48 px", "FreeTypeFont", true, 48.0f, 0},
+    {"HarfBuzzFont, labels, 12 px", "HarfBuzzFont", false, 12.0f, 0},
+    {"HarfBuzzFont, labels, 12 px, shape cache", "HarfBuzzFont", false, 12.0f, 64},
+    {"HarfBuzzFont, labels, 48 px", "HarfBuzzFont", false, 48.0f, 0},
+    {"HarfBuzzFont, paragraphs, 12 px", "HarfBuzzFont", true, 12.0f, 0},
+    {"HarfBuzzFont, paragraphs, 48 px", "HarfBuzzFont", true, 48.0f, 0},
+    {"StbTrueTypeFont, labels, 12 px", "StbTrueTypeFont", false, 12.0f, 0},
+    {"StbTrueTypeFont, labels, 48 px", "StbTrueTypeFont", false, 48.0f, 0},
+    {"StbTrueTypeFont, paragraphs, 12 px", "StbTrueTypeFont", true, 12.0f, 0},
+    {"StbTrueTypeFont, paragraphs, 48 px", "StbTrueTypeFont", true, 48.0f, 0}
+};
+
+/* layoutBatch() is available only on FreeTypeFont and its subclasses through
+   a common base */
+constexpr struct {
+    const char* name;
+    const char* plugin;
+    bool paragraphs;
+} LayoutBatchData[]{
+    {"FreeTypeFont, labels", "FreeTypeFont", false},
+    {"FreeTypeFont, paragraphs", "FreeTypeFont", true},
+    {"HarfBuzzFont, labels", "HarfBuzzFont", false},
+    {"HarfBuzzFont, paragraphs", "HarfBuzzFont", true}
+};
+
+const std::vector<std::string> Labels{
+    "OK", "Cancel", "Apply", "Settings", "Open file", "Save as...",
+    "Recent projects", "Help", "About", "Quit", "Undo", "Redo",
+    "Zoom in", "Zoom out", "Full screen", "Show grid"
+};
+
+const std::vector<std::string> Paragraphs{
+    "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+    "tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim "
+    "veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea "
+    "commodo consequat. Duis aute irure dolor in reprehenderit in voluptate "
+    "velit esse cillum dolore eu fugiat nulla pariatur. Excepteur sint "
+    "occaecat cupidatat non proident, sunt in culpa qui officia deserunt "
+    "mollit anim id est laborum.",
+    "Sed ut perspiciatis unde omnis iste natus error sit voluptatem "
+    "accusantium doloremque laudantium, totam rem aperiam, eaque ipsa quae ab "
+    "illo inventore veritatis et quasi architecto beatae vitae dicta sunt "
+    "explicabo. Nemo enim ipsam voluptatem quia voluptas sit aspernatur aut "
+    "odit aut fugit, sed quia consequuntur magni dolores eos qui ratione "
+    "voluptatem sequi nesciunt.",
+    "At vero eos et accusamus et iusto odio dignissimos ducimus qui "
+    "blanditiis praesentium voluptatum deleniti atque corrupti quos dolores "
+    "et quas molestias excepturi sint occaecati cupiditate non provident, "
+    "similique sunt in culpa qui officia deserunt mollitia animi, id est "
+    "laborum et dolorum fuga."
+};
+
+/* UTF-8 string with all characters from given ranges */
+std::string characterRanges(std::initializer_list<std::pair<char32_t, char32_t>> ranges) {
+    std::string out;
+    char buffer[4];
+    for(const std::pair<char32_t, char32_t>& range: ranges)
+        for(char32_t c = range.first; c <= range.second; ++c)
+            out.append(buffer, Utility::Unicode::utf8(c, buffer));
+    return out;
+}
+
+std::string characterSet(const Characters characters) {
+    switch(characters) {
+        /* Printable ASCII */
+        case Characters::Ascii:
+            return characterRanges({{U'\x20', U'\x7e'}});
+        /* ASCII, Latin-1 Supplement, Latin Extended-A and B */
+        case Characters::LatinExtended:
+            return characterRanges({{U'\x20', U'\x7e'}, {U'\xa0', U'ɏ'}});
+        /* The first 2500 CJK Unified Ideographs */
+        case Characters::Cjk:
+            return characterRanges({{U'一', U'一' + 2499}});
+    }
+
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
+
+FreeTypeFontBenchmark::FreeTypeFontBenchmark(): TestSuite::Tester{TesterConfiguration{}.setSkippedArgumentPrefixes({"font"})} {
+    Utility::Arguments args{"font"};
+    args.addOption("file", TTF_FILE).setHelp("file", "font file to benchmark with", "FILE")
+        .parse(arguments().first, arguments().second);
+    _fontFile = args.value("file");
+
+    addInstancedBenchmarks({&FreeTypeFontBenchmark::fillGlyphCache}, 5,
+        Containers::arraySize(FillData));
+
+    addCustomInstancedBenchmarks({&FreeTypeFontBenchmark::fillGlyphCacheAllocations}, 1,
+        Containers::arraySize(FillData),
+        &FreeTypeFontBenchmark::allocationBenchmarkBegin,
+        &FreeTypeFontBenchmark::allocationBenchmarkEnd,
+        BenchmarkUnits::Count);
+
+    addInstancedBenchmarks({&FreeTypeFontBenchmark::layout}, 10,
+        Containers::arraySize(LayoutData));
+
+    addCustomInstancedBenchmarks({&FreeTypeFontBenchmark::layoutAllocations}, 1,
+        Containers::arraySize(LayoutData),
+        &FreeTypeFontBenchmark::allocationBenchmarkBegin,
+        &FreeTypeFontBenchmark::allocationBenchmarkEnd,
+        BenchmarkUnits::Count);
+
+    addInstancedBenchmarks({&FreeTypeFontBenchmark::layoutBatch}, 10,
+        Containers::arraySize(LayoutBatchData));
+
+    /* Load the plugins directly from the build tree. Otherwise they're static
+       and already loaded. */
+    #ifdef FREETYPEFONT_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(FREETYPEFONT_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef HARFBUZZFONT_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(HARFBUZZFONT_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef STBTRUETYPEFONT_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(STBTRUETYPEFONT_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+void FreeTypeFontBenchmark::fillGlyphCache() {
+    auto&& data = FillData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_manager.loadState(data.plugin) == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP(data.plugin << "plugin not found, cannot test");
+
+    Containers::Pointer<AbstractFont> font = _manager.instantiate(data.plugin);
+    font->configuration().setValue("threads", data.threads);
+    CORRADE_VERIFY(font->openFile(_fontFile, 32.0f));
+    if(data.characters == Characters::Cjk && !font->glyphId(U'一'))
+        CORRADE_SKIP("The font has no CJK glyphs, pass a different one with --font-file");
+
+    /* Each iteration fills a new cache, so it's never incremental. The font
+       is kept, so after the first iteration its scratch memory and glyph
+       advances are reused. */
+    const std::string characters = characterSet(data.characters);
+    std::size_t glyphCount = 0;
+    CORRADE_BENCHMARK(1) {
+        DummyGlyphCache cache{data.textureSize};
+        font->fillGlyphCache(cache, characters);
+        glyphCount = cache.glyphCount();
+    }
+
+    setTestCaseDescription(Utility::formatString("{}, {} glyphs", data.name, glyphCount));
+}
+
+void FreeTypeFontBenchmark::fillGlyphCacheAllocations() {
+    auto&& data = FillData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_manager.loadState(data.plugin) == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP(data.plugin << "plugin not found, cannot test");
+
+    Containers::Pointer<AbstractFont> font = _manager.instantiate(data.plugin);
+    font->configuration().setValue("threads", data.threads);
+    CORRADE_VERIFY(font->openFile(_fontFile, 32.0f));
+    if(data.characters == Characters::Cjk && !font->glyphId(U'一'))
+        CORRADE_SKIP("The font has no CJK glyphs, pass a different one with --font-file");
+
+    /* Fill once outside of the measured region, so the count shows the
+       steady state and not the scratch memory being allocated */
+    const std::string characters = characterSet(data.characters);
+    {
+        DummyGlyphCache cache{data.textureSize};
+        font->fillGlyphCache(cache, characters);
+    }
+
+    /* The cache itself is created outside as well, only the fill is
+       counted */
+    DummyGlyphCache cache{data.textureSize};
+    CORRADE_BENCHMARK(1)
+        font->fillGlyphCache(cache, characters);
+
+    CORRADE_VERIFY(cache.glyphCount() > 1);
+}
+
+void FreeTypeFontBenchmark::layout() {
+    auto&& data = LayoutData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_manager.loadState(data.plugin) == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP(data.plugin << "plugin not found, cannot test");
+
+    Containers::Pointer<AbstractFont> font = _manager.instantiate(data.plugin);
+    if(data.shapeCacheSize)
+        font->configuration().setValue("shapeCacheSize", data.shapeCacheSize);
+    CORRADE_VERIFY(font->openFile(_fontFile, data.size));
+
+    /* Filling the cache upfront so the glyph lookups succeed */
+    DummyGlyphCache cache{Vector2i{1024}};
+    font->fillGlyphCache(cache, characterSet(Characters::Ascii));
+
+    /* Each string is laid out and all its glyphs rendered, which is what's
+       needed to fill a vertex buffer */
+    const std::vector<std::string>& texts = data.paragraphs ? Paragraphs : Labels;
+    std::size_t i = 0, glyphCount = 0;
+    CORRADE_BENCHMARK(texts.size()) {
+        Containers::Pointer<AbstractLayouter> layouter = font->layout(cache, data.size, texts[i++ % texts.size()]);
+        Vector2 cursorPosition;
+        Range2D rectangle;
+        for(UnsignedInt j = 0; j != layouter->glyphCount(); ++j)
+            layouter->renderGlyph(j, cursorPosition, rectangle);
+        glyphCount += layouter->glyphCount();
+    }
+
+    CORRADE_VERIFY(glyphCount);
+    setTestCaseDescription(Utility::formatString("{}, {} strings", data.name, texts.size()));
+}
+
+void FreeTypeFontBenchmark::layoutAllocations() {
+    auto&& data = LayoutData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_manager.loadState(data.plugin) == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP(data.plugin << "plugin not found, cannot test");
+
+    Containers::Pointer<AbstractFont> font = _manager.instantiate(data.plugin);
+    if(data.shapeCacheSize)
+        font->configuration().setValue("shapeCacheSize", data.shapeCacheSize);
+    CORRADE_VERIFY(font->openFile(_fontFile, data.size));
+
+    DummyGlyphCache cache{Vector2i{1024}};
+    font->fillGlyphCache(cache, characterSet(Characters::Ascii));
+
+    /* Lay out everything once outside of the measured region, so the count
+       shows the steady state with all caches populated. The reported count
+       is per string. */
+    const std::vector<std::string>& texts = data.paragraphs ? Paragraphs : Labels;
+    for(const std::string& text: texts) font->layout(cache, data.size, text);
+
+    std::size_t i = 0;
+    CORRADE_BENCHMARK(texts.size()) {
+        Containers::Pointer<AbstractLayouter> layouter = font->layout(cache, data.size, texts[i++ % texts.size()]);
+        Vector2 cursorPosition;
+        Range2D rectangle;
+        for(UnsignedInt j = 0; j != layouter->glyphCount(); ++j)
+            layouter->renderGlyph(j, cursorPosition, rectangle);
+    }
+
+    CORRADE_COMPARE(i, texts.size());
+}
+
+void FreeTypeFontBenchmark::layoutBatch() {
+    auto&& data = LayoutBatchData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_manager.loadState(data.plugin) == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP(data.plugin << "plugin not found, cannot test");
+
+    Containers::Pointer<AbstractFont> font = _manager.instantiate(data.plugin);
+    CORRADE_VERIFY(font->openFile(_fontFile, 16.0f));
+
+    DummyGlyphCache cache{Vector2i{1024}};
+    font->fillGlyphCache(cache, characterSet(Characters::Ascii));
+
+    /* All texts are laid out into a single vertex array at once, the
+       allocation is done outside of the measured region */
+    const std::vector<std::string>& texts = data.paragraphs ? Paragraphs : Labels;
+    const std::vector<Vector2> origins(texts.size());
+    FreeTypeFont& batchFont = static_cast<FreeTypeFont&>(*font);
+    const std::size_t glyphCount = batchFont.layoutBatch(cache, 16.0f, texts, origins, {}, {});
+    Containers::Array<Vector2> positions{Containers::NoInit, glyphCount*4};
+    Containers::Array<Vector2> textureCoordinates{Containers::NoInit, glyphCount*4};
+
+    std::size_t count = 0;
+    CORRADE_BENCHMARK(1)
+        count = batchFont.layoutBatch(cache, 16.0f, texts, origins, Containers::stridedArrayView(positions), Containers::stridedArrayView(textureCoordinates));
+
+    CORRADE_COMPARE(count, glyphCount);
+    setTestCaseDescription(Utility::formatString("{}, {} strings, {} glyphs", data.name, texts.size(), glyphCount));
+}
+
+void FreeTypeFontBenchmark::allocationBenchmarkBegin() {
+    _allocationCount = allocationCount;
+}
+
+std::uint64_t FreeTypeFontBenchmark::allocationBenchmarkEnd() {
+    return allocationCount - _allocationCount;
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Text::Test::FreeTypeFontBenchmark)
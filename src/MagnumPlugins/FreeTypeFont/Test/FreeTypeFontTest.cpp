@@ -24,12 +24,18 @@
 */
 
 #include <sstream>
+#include <string>
+#include <vector>
 #include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Magnum/Text/AbstractFont.h>
 #include <Magnum/Text/AbstractGlyphCache.h>
 
+#include "MagnumPlugins/FreeTypeFont/FreeTypeFont.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Text { namespace Test { namespace {
@@ -42,7 +48,18 @@ struct FreeTypeFontTest: TestSuite::Tester {
 
     void properties();
     void layout();
+    void layoutFontClosed();
+    void layoutBatch();
     void fillGlyphCache();
+    void fillGlyphCacheAdvances();
+    void fillGlyphCacheIncremental();
+    void fillGlyphCacheIncrementalNoSpace();
+    void fillGlyphCacheThreads();
+    void fillGlyphCacheDistanceField();
+    void fillGlyphCacheScratchAllocator();
+
+    void instantiateSize();
+    void instantiateSizeOriginalClosed();
 
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractFont> _manager{"nonexistent"};
@@ -55,13 +72,49 @@ struct DummyGlyphCache: AbstractGlyphCache {
     void doSetImage(const Vector2i&, const ImageView2D&) override {}
 };
 
+struct RecordingGlyphCache: AbstractGlyphCache {
+    using AbstractGlyphCache::AbstractGlyphCache;
+
+    GlyphCacheFeatures doFeatures() const override { return {}; }
+    void doSetImage(const Vector2i& offset, const ImageView2D& image) override {
+        updates.push_back(Range2Di::fromSize(offset, image.size()));
+        this->image.assign(image.data().data(), image.data().size());
+    }
+
+    std::vector<Range2Di> updates;
+    std::string image;
+};
+
+constexpr struct {
+    const char* name;
+    UnsignedInt threads;
+} FillGlyphCacheThreadsData[]{
+    {"2 threads", 2},
+    {"4 threads", 4},
+    {"all available threads", 0}
+};
+
 FreeTypeFontTest::FreeTypeFontTest() {
     addTests({&FreeTypeFontTest::empty,
               &FreeTypeFontTest::invalid,
 
               &FreeTypeFontTest::properties,
               &FreeTypeFontTest::layout,
-              &FreeTypeFontTest::fillGlyphCache});
+              &FreeTypeFontTest::layoutFontClosed,
+              &FreeTypeFontTest::layoutBatch,
+              &FreeTypeFontTest::fillGlyphCache,
+              &FreeTypeFontTest::fillGlyphCacheAdvances,
+              &FreeTypeFontTest::fillGlyphCacheIncremental,
+              &FreeTypeFontTest::fillGlyphCacheIncrementalNoSpace});
+
+    addInstancedTests({&FreeTypeFontTest::fillGlyphCacheThreads},
+        Containers::arraySize(FillGlyphCacheThreadsData));
+
+    addTests({&FreeTypeFontTest::fillGlyphCacheDistanceField,
+              &FreeTypeFontTest::fillGlyphCacheScratchAllocator,
+
+              &FreeTypeFontTest::instantiateSize,
+              &FreeTypeFontTest::instantiateSizeOriginalClosed});
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
@@ -142,6 +195,28 @@ void FreeTypeFontTest::layout() {
     CORRADE_COMPARE(cursorPosition, Vector2(0.28125f, 0.0f));
 }
 
+void FreeTypeFontTest::layoutFontClosed() {
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("FreeTypeFont");
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+
+    DummyGlyphCache cache{Vector2i{256}};
+    cache.insert(font->glyphId(U'W'), {25, 34}, {{0, 8}, {16, 128}});
+
+    Containers::Pointer<AbstractLayouter> layouter = font->layout(cache, 0.5f, "Wa");
+    CORRADE_VERIFY(layouter);
+
+    /* The advances are resolved in layout() already, so rendering the glyphs
+       doesn't need the font anymore */
+    font->close();
+
+    Vector2 cursorPosition;
+    Range2D rectangle;
+    layouter->renderGlyph(0, cursorPosition = {}, rectangle);
+    CORRADE_COMPARE(cursorPosition, Vector2(0.53125f, 0.0f));
+    layouter->renderGlyph(1, cursorPosition = {}, rectangle);
+    CORRADE_COMPARE(cursorPosition, Vector2(0.25f, 0.0f));
+}
+
 void FreeTypeFontTest::fillGlyphCache() {
     Containers::Pointer<AbstractFont> font = _manager.instantiate("FreeTypeFont");
     CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
@@ -156,6 +231,322 @@ void FreeTypeFontTest::fillGlyphCache() {
     /** @todo properly test contents */
 }
 
+void FreeTypeFontTest::fillGlyphCacheAdvances() {
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("FreeTypeFont");
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+
+    DummyGlyphCache cache{Vector2i{256}};
+    font->fillGlyphCache(cache, "We");
+
+    /* The advances are remembered when filling the cache, should be the same
+       as when loaded directly */
+    CORRADE_COMPARE(font->glyphAdvance(font->glyphId(U'W')), Vector2(17.0f, 0.0f));
+
+    Containers::Pointer<AbstractLayouter> layouter = font->layout(cache, 0.5f, "Wave");
+    CORRADE_VERIFY(layouter);
+    CORRADE_COMPARE(layouter->glyphCount(), 4);
+
+    /* Same as in layout(), 'a' and 'v' aren't in the cache and get loaded */
+    Vector2 cursorPosition;
+    Range2D rectangle;
+    layouter->renderGlyph(0, cursorPosition = {}, rectangle);
+    CORRADE_COMPARE(cursorPosition, Vector2(0.53125f, 0.0f));
+    layouter->renderGlyph(1, cursorPosition = {}, rectangle);
+    CORRADE_COMPARE(cursorPosition, Vector2(0.25f, 0.0f));
+    layouter->renderGlyph(3, cursorPosition = {}, rectangle);
+    CORRADE_COMPARE(cursorPosition, Vector2(0.28125f, 0.0f));
+
+    /* The cache is dropped on close, so a different size doesn't get stale
+       values */
+    font->close();
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 32.0f));
+    CORRADE_COMPARE_AS(font->glyphAdvance(font->glyphId(U'W')).x(), 30.0f,
+        TestSuite::Compare::Greater);
+}
+
+void FreeTypeFontTest::fillGlyphCacheIncremental() {
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("FreeTypeFont");
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+
+    /* The first fill uploads the whole image */
+    RecordingGlyphCache cache{Vector2i{256}};
+    font->fillGlyphCache(cache, "abc");
+    CORRADE_COMPARE(cache.glyphCount(), 4);
+    CORRADE_COMPARE(cache.updates.size(), 1);
+    CORRADE_COMPARE(cache.updates[0], (Range2Di{{}, Vector2i{256}}));
+
+    Int top = 0;
+    for(const auto& glyph: cache)
+        top = Math::max(top, glyph.second.second.top());
+    const Range2Di c = cache[font->glyphId(U'c')].second;
+
+    /* The second only the area with new glyphs, which are above the ones that
+       are already there. The 'c' is already in the cache and isn't touched. */
+    font->fillGlyphCache(cache, "cdef");
+    CORRADE_COMPARE(cache.glyphCount(), 7);
+    CORRADE_COMPARE(cache.updates.size(), 2);
+    CORRADE_COMPARE(cache[font->glyphId(U'c')].second, c);
+    CORRADE_COMPARE_AS(cache.updates[1].bottom(), top,
+        TestSuite::Compare::GreaterOrEqual);
+    CORRADE_COMPARE_AS(cache.updates[1].size().product(), 256*256,
+        TestSuite::Compare::Less);
+    for(const char32_t character: {U'd', U'e', U'f'}) {
+        CORRADE_ITERATION(character);
+        const Range2Di rectangle = cache[font->glyphId(character)].second;
+        CORRADE_COMPARE_AS(rectangle.bottom(), top,
+            TestSuite::Compare::GreaterOrEqual);
+        CORRADE_COMPARE(Math::join(rectangle, cache.updates[1]), cache.updates[1]);
+    }
+
+    /* Filling with glyphs that are all there already doesn't upload
+       anything */
+    font->fillGlyphCache(cache, "fed");
+    CORRADE_COMPARE(cache.glyphCount(), 7);
+    CORRADE_COMPARE(cache.updates.size(), 2);
+}
+
+void FreeTypeFontTest::fillGlyphCacheIncrementalNoSpace() {
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("FreeTypeFont");
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+
+    RecordingGlyphCache cache{Vector2i{32}};
+    font->fillGlyphCache(cache, "a");
+    CORRADE_COMPARE(cache.glyphCount(), 2);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    font->fillGlyphCache(cache, "WWWMMM@@@QQQ");
+    CORRADE_COMPARE(cache.glyphCount(), 2);
+    CORRADE_COMPARE(cache.updates.size(), 1);
+    CORRADE_COMPARE(out.str(), "Text::FreeTypeFont::fillGlyphCache(): cannot fit 4 new glyphs into the cache\n");
+}
+
+void FreeTypeFontTest::fillGlyphCacheThreads() {
+    auto&& data = FillGlyphCacheThreadsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* All printable ASCII characters, enough for several batches */
+    std::string characters;
+    for(char c = ' '; c != '\x7f'; ++c) characters += c;
+
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("FreeTypeFont");
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+    RecordingGlyphCache expected{Vector2i{256}};
+    font->fillGlyphCache(expected, characters);
+
+    Containers::Pointer<AbstractFont> threadedFont = _manager.instantiate("FreeTypeFont");
+    threadedFont->configuration().setValue("threads", data.threads);
+    CORRADE_VERIFY(threadedFont->openFile(TTF_FILE, 16.0f));
+    RecordingGlyphCache cache{Vector2i{256}};
+    threadedFont->fillGlyphCache(cache, characters);
+
+    /* The result should be the same as when rendering on a single thread */
+    CORRADE_COMPARE(cache.glyphCount(), expected.glyphCount());
+    for(const auto& glyph: expected) {
+        CORRADE_ITERATION(glyph.first);
+        CORRADE_COMPARE(cache[glyph.first], glyph.second);
+    }
+    CORRADE_COMPARE(cache.image.size(), expected.image.size());
+    CORRADE_VERIFY(cache.image == expected.image);
+
+    /* The advances are remembered from all threads */
+    CORRADE_COMPARE(threadedFont->glyphAdvance(threadedFont->glyphId(U'W')), Vector2(17.0f, 0.0f));
+}
+
+void FreeTypeFontTest::fillGlyphCacheDistanceField() {
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("FreeTypeFont");
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 32.0f));
+    RecordingGlyphCache expected{Vector2i{256}};
+    font->fillGlyphCache(expected, "l ");
+
+    Containers::Pointer<AbstractFont> distanceFieldFont = _manager.instantiate("FreeTypeFont");
+    distanceFieldFont->configuration().setValue("distanceField", true);
+    distanceFieldFont->configuration().setValue("distanceFieldRadius", 4);
+    CORRADE_VERIFY(distanceFieldFont->openFile(TTF_FILE, 32.0f));
+    RecordingGlyphCache cache{Vector2i{256}};
+    distanceFieldFont->fillGlyphCache(cache, "l ");
+    CORRADE_COMPARE(cache.glyphCount(), 3);
+
+    /* The glyph is padded by the radius on each side */
+    const UnsignedInt l = font->glyphId(U'l');
+    const std::pair<Vector2i, Range2Di> expectedGlyph = expected[l];
+    const std::pair<Vector2i, Range2Di> glyph = cache[l];
+    CORRADE_COMPARE(glyph.first, expectedGlyph.first - Vector2i{4});
+    CORRADE_COMPARE(glyph.second.size(), expectedGlyph.second.size() + Vector2i{8});
+
+    /* Space is empty and stays that way */
+    const UnsignedInt space = font->glyphId(U' ');
+    CORRADE_COMPARE(cache[space].second.size(), Vector2i{});
+
+    /* Corners are further than the radius from the glyph, the center of the
+       stem is inside */
+    const auto pixel = [&](const Vector2i& position) {
+        return Int(UnsignedByte(cache.image[position.y()*256 + position.x()]));
+    };
+    CORRADE_COMPARE(pixel(glyph.second.min()), 0);
+    CORRADE_COMPARE(pixel(glyph.second.max() - Vector2i{1}), 0);
+    CORRADE_COMPARE_AS(pixel(glyph.second.center()), 128,
+        TestSuite::Compare::Greater);
+}
+
+void FreeTypeFontTest::fillGlyphCacheScratchAllocator() {
+    Containers::Pointer<AbstractFont> expectedFont = _manager.instantiate("FreeTypeFont");
+    CORRADE_VERIFY(expectedFont->openFile(TTF_FILE, 16.0f));
+    RecordingGlyphCache expected{Vector2i{256}};
+    expectedFont->fillGlyphCache(expected, "abcdefgh");
+
+    struct Allocations {
+        std::size_t count, bytes, live;
+    } allocations{};
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("FreeTypeFont");
+    FreeTypeFont& freeTypeFont = static_cast<FreeTypeFont&>(*font);
+    freeTypeFont.setScratchAllocator([](std::size_t size, void* userData) -> void* {
+        Allocations& allocations = *static_cast<Allocations*>(userData);
+        ++allocations.count;
+        ++allocations.live;
+        allocations.bytes += size;
+        return new char[size];
+    }, [](void* data, std::size_t, void* userData) {
+        --static_cast<Allocations*>(userData)->live;
+        delete[] static_cast<char*>(data);
+    }, &allocations);
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+
+    RecordingGlyphCache cache{Vector2i{256}};
+    font->fillGlyphCache(cache, "abcdefgh");
+    CORRADE_COMPARE(cache.glyphCount(), expected.glyphCount());
+    CORRADE_COMPARE(cache.image, expected.image);
+    CORRADE_VERIFY(allocations.count);
+    CORRADE_COMPARE(freeTypeFont.scratchAllocationCount(), allocations.count);
+    CORRADE_COMPARE(freeTypeFont.scratchAllocatedBytes(), allocations.bytes);
+
+    /* Filling another cache with the same amount of glyphs reuses the
+       memory */
+    const std::size_t count = allocations.count;
+    RecordingGlyphCache another{Vector2i{256}};
+    font->fillGlyphCache(another, "hgfedcba");
+    CORRADE_COMPARE(another.image, expected.image);
+    CORRADE_COMPARE(allocations.count, count);
+    CORRADE_COMPARE(freeTypeFont.scratchAllocationCount(), count);
+
+    /* Resetting the allocator releases everything allocated through it */
+    freeTypeFont.setScratchAllocator(nullptr, nullptr);
+    CORRADE_COMPARE(allocations.live, 0);
+}
+
+void FreeTypeFontTest::layoutBatch() {
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("FreeTypeFont");
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+
+    DummyGlyphCache cache{Vector2i{256}};
+    cache.insert(font->glyphId(U'W'), {25, 34}, {{0, 8}, {16, 128}});
+    cache.insert(font->glyphId(U'e'), {25, 12}, {{16, 4}, {64, 32}});
+
+    const std::string texts[]{"Wave", "eW"};
+    const Vector2 origins[]{{}, {10.0f, 20.0f}};
+
+    /* Querying the size with empty views writes nothing */
+    FreeTypeFont& batchFont = static_cast<FreeTypeFont&>(*font);
+    CORRADE_COMPARE(batchFont.layoutBatch(cache, 0.5f, texts, origins, {}, {}), 6);
+
+    struct Vertex {
+        Vector2 position;
+        Vector2 textureCoordinates;
+    } vertices[6*4];
+    const Containers::StridedArrayView1D<Vector2> positions{vertices, &vertices[0].position, Containers::arraySize(vertices), sizeof(Vertex)};
+    const Containers::StridedArrayView1D<Vector2> textureCoordinates{vertices, &vertices[0].textureCoordinates, Containers::arraySize(vertices), sizeof(Vertex)};
+    CORRADE_COMPARE(batchFont.layoutBatch(cache, 0.5f, texts, origins, positions, textureCoordinates), 6);
+
+    /* Should be the same as layouting each text separately */
+    std::size_t vertex = 0;
+    for(std::size_t i = 0; i != Containers::arraySize(texts); ++i) {
+        CORRADE_ITERATION(texts[i]);
+        Containers::Pointer<AbstractLayouter> layouter = font->layout(cache, 0.5f, texts[i]);
+        CORRADE_VERIFY(layouter);
+
+        Vector2 cursorPosition = origins[i];
+        Range2D rectangle, quadPosition, quadTextureCoordinates;
+        for(UnsignedInt j = 0; j != layouter->glyphCount(); ++j) {
+            std::tie(quadPosition, quadTextureCoordinates) = layouter->renderGlyph(j, cursorPosition, rectangle);
+            CORRADE_COMPARE(vertices[vertex + 0].position, quadPosition.topLeft());
+            CORRADE_COMPARE(vertices[vertex + 1].position, quadPosition.bottomLeft());
+            CORRADE_COMPARE(vertices[vertex + 2].position, quadPosition.topRight());
+            CORRADE_COMPARE(vertices[vertex + 3].position, quadPosition.bottomRight());
+            CORRADE_COMPARE(vertices[vertex + 0].textureCoordinates, quadTextureCoordinates.topLeft());
+            CORRADE_COMPARE(vertices[vertex + 1].textureCoordinates, quadTextureCoordinates.bottomLeft());
+            CORRADE_COMPARE(vertices[vertex + 2].textureCoordinates, quadTextureCoordinates.topRight());
+            CORRADE_COMPARE(vertices[vertex + 3].textureCoordinates, quadTextureCoordinates.bottomRight());
+            vertex += 4;
+        }
+    }
+    CORRADE_COMPARE(vertex, Containers::arraySize(vertices));
+}
+
+void FreeTypeFontTest::instantiateSize() {
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("FreeTypeFont");
+    font->configuration().setValue("threads", 3);
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+
+    Containers::Pointer<AbstractFont> expected = _manager.instantiate("FreeTypeFont");
+    CORRADE_VERIFY(expected->openFile(TTF_FILE, 32.0f));
+
+    Containers::Pointer<FreeTypeFont> instance = static_cast<FreeTypeFont&>(*font).instantiateSize(32.0f);
+    CORRADE_VERIFY(instance);
+    CORRADE_VERIFY(instance->isOpened());
+    CORRADE_COMPARE(instance->configuration().value<UnsignedInt>("threads"), 3);
+
+    /* Should be the same as opening the file again in the other size */
+    CORRADE_COMPARE(instance->size(), 32.0f);
+    CORRADE_COMPARE(instance->ascent(), expected->ascent());
+    CORRADE_COMPARE(instance->descent(), expected->descent());
+    CORRADE_COMPARE(instance->lineHeight(), expected->lineHeight());
+    CORRADE_COMPARE(instance->glyphId(U'W'), 58);
+    CORRADE_COMPARE(instance->glyphAdvance(58), expected->glyphAdvance(58));
+
+    /* The original font isn't affected by the instance sharing its face */
+    CORRADE_COMPARE(font->size(), 16.0f);
+    CORRADE_COMPARE(font->ascent(), 15.0f);
+    CORRADE_COMPARE(font->glyphAdvance(58), Vector2(17.0f, 0.0f));
+
+    DummyGlyphCache cache{Vector2i{256}};
+    DummyGlyphCache expectedCache{Vector2i{256}};
+    instance->fillGlyphCache(cache, "Wave");
+    expected->fillGlyphCache(expectedCache, "Wave");
+    CORRADE_COMPARE(cache.glyphCount(), 5);
+    CORRADE_COMPARE(cache[58].first, expectedCache[58].first);
+    CORRADE_COMPARE(cache[58].second, expectedCache[58].second);
+}
+
+void FreeTypeFontTest::instantiateSizeOriginalClosed() {
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("FreeTypeFont");
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 32.0f));
+
+    Containers::Pointer<FreeTypeFont> instance = static_cast<FreeTypeFont&>(*font).instantiateSize(16.0f);
+    CORRADE_VERIFY(instance);
+
+    /* The instance keeps the shared data alive */
+    font->close();
+    font = nullptr;
+    CORRADE_VERIFY(instance->isOpened());
+
+    DummyGlyphCache cache{Vector2i{256}};
+    cache.insert(instance->glyphId(U'W'), {25, 34}, {{0, 8}, {16, 128}});
+    Containers::Pointer<AbstractLayouter> layouter = instance->layout(cache, 0.5f, "Wa");
+    CORRADE_VERIFY(layouter);
+
+    /* Same as in layout() */
+    Vector2 cursorPosition;
+    Range2D rectangle;
+    layouter->renderGlyph(0, cursorPosition = {}, rectangle);
+    CORRADE_COMPARE(cursorPosition, Vector2(0.53125f, 0.0f));
+    layouter->renderGlyph(1, cursorPosition = {}, rectangle);
+    CORRADE_COMPARE(cursorPosition, Vector2(0.25f, 0.0f));
+
+    /* Opening the instance again with other data replaces the shared face */
+    CORRADE_VERIFY(instance->openFile(TTF_FILE, 16.0f));
+    CORRADE_COMPARE(instance->glyphAdvance(58), Vector2(17.0f, 0.0f));
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Text::Test::FreeTypeFontTest)
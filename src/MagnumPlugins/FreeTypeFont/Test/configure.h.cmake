@@ -24,4 +24,6 @@
 */
 
 #cmakedefine FREETYPEFONT_PLUGIN_FILENAME "${FREETYPEFONT_PLUGIN_FILENAME}"
+#cmakedefine HARFBUZZFONT_PLUGIN_FILENAME "${HARFBUZZFONT_PLUGIN_FILENAME}"
+#cmakedefine STBTRUETYPEFONT_PLUGIN_FILENAME "${STBTRUETYPEFONT_PLUGIN_FILENAME}"
 #define TTF_FILE "${TTF_FILE}"
@@ -25,7 +25,7 @@
 
 #include "MagnumPlugins/FreeTypeFont/configure.h"
 
-#ifdef MAGNUM_FREETYPEFONT_BUILD_STATIC
+#if defined(MAGNUM_FREETYPEFONT_BUILD_STATIC) && !defined(MAGNUM_PLUGINS_NO_AUTOMATIC_IMPORT)
 #include <Corrade/PluginManager/AbstractManager.h>
 
 static int magnumFreeTypeFontStaticImporter() {
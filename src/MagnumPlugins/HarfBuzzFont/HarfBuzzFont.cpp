@@ -25,35 +25,68 @@
 
 #include "HarfBuzzFont.h"
 
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
 #include <hb-ft.h>
 #include <Corrade/PluginManager/AbstractManager.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Magnum/Text/AbstractGlyphCache.h>
 
+#include "MagnumPlugins/Implementation/glyphBatch.h"
+
 namespace Magnum { namespace Text {
 
 namespace {
 
-class HarfBuzzLayouter: public AbstractLayouter {
+/* Shaped glyph, offset and advance in pixels */
+struct ShapedGlyph {
+    UnsignedInt id;
+    Vector2 offset;
+    Vector2 advance;
+};
+
+}
+
+class HarfBuzzFont::Layouter final: public AbstractLayouter {
     public:
-        explicit HarfBuzzLayouter(const AbstractGlyphCache& cache, Float fontSize, Float textSize, hb_buffer_t* buffer, hb_glyph_info_t* glyphInfo, hb_glyph_position_t* glyphPositions, UnsignedInt glyphCount);
+        explicit Layouter(const AbstractGlyphCache& cache, Float fontSize, Float textSize, std::vector<ShapedGlyph>&& glyphs);
 
-        ~HarfBuzzLayouter();
+        /* Non-virtual doRenderGlyph(), used by layoutBatch() */
+        std::tuple<Range2D, Range2D, Vector2> glyph(UnsignedInt i) const;
 
     private:
-        std::tuple<Range2D, Range2D, Vector2> doRenderGlyph(UnsignedInt i) override;
+        std::tuple<Range2D, Range2D, Vector2> doRenderGlyph(UnsignedInt i) override {
+            return glyph(i);
+        }
 
         const AbstractGlyphCache& cache;
         const Float fontSize, textSize;
-        hb_buffer_t* const buffer;
-        hb_glyph_info_t* const glyphInfo;
-        hb_glyph_position_t* const glyphPositions;
+        const std::vector<ShapedGlyph> glyphs;
 };
 
-}
+/* Least recently used runs are at the back of the list, the map points into
+   the list for lookup by key */
+struct HarfBuzzFont::ShapeCache {
+    struct Run {
+        std::string key;
+        std::vector<ShapedGlyph> glyphs;
+    };
 
-HarfBuzzFont::HarfBuzzFont(): hbFont(nullptr) {}
+    std::list<Run> runs;
+    std::unordered_map<std::string, std::list<Run>::iterator> lookup;
+};
 
-HarfBuzzFont::HarfBuzzFont(PluginManager::AbstractManager& manager, const std::string& plugin): FreeTypeFont{manager, plugin}, hbFont(nullptr) {}
+HarfBuzzFont::HarfBuzzFont(): hbFace(nullptr), hbFont(nullptr), hbBuffer(nullptr), shapeCache{new ShapeCache} {
+    /** @todo horrible workaround, fix this properly */
+    configuration().setValue("direction", "");
+    configuration().setValue("script", "");
+    configuration().setValue("language", "");
+    configuration().setValue("shapeCacheSize", 0);
+}
+
+HarfBuzzFont::HarfBuzzFont(PluginManager::AbstractManager& manager, const std::string& plugin): FreeTypeFont{manager, plugin}, hbFace(nullptr), hbFont(nullptr), hbBuffer(nullptr), shapeCache{new ShapeCache} {}
 
 HarfBuzzFont::~HarfBuzzFont() { close(); }
 
@@ -68,72 +101,197 @@ auto HarfBuzzFont::doOpenData(const Containers::ArrayView<const char> data, cons
     /* Open FreeType font */
     auto ret = FreeTypeFont::doOpenData(data, size);
 
-    /* Create Harfbuzz font */
-    if(FreeTypeFont::doIsOpened()) hbFont = hb_ft_font_create(ftFont, nullptr);
+    /* Create Harfbuzz font and a buffer reused for all layouts. The font
+       takes its scale from the currently active size, which is the one just
+       opened. If we're being opened from instantiateSize(), the face is
+       already set and replaces the one created for the font, so the tables
+       and shape plans are shared among all sizes. */
+    if(FreeTypeFont::doIsOpened()) {
+        hbFont = hb_ft_font_create(ftFont, nullptr);
+        #if HB_VERSION_ATLEAST(1, 4, 3)
+        if(hbFace) hb_font_set_face(hbFont, hbFace);
+        else hbFace = hb_face_reference(hb_font_get_face(hbFont));
+        #endif
+        hbBuffer = hb_buffer_create();
+    }
 
     return ret;
 }
 
 void HarfBuzzFont::doClose() {
+    /* The face is destroyed after the font, before the FreeType face it's
+       referencing gets released */
+    hb_buffer_destroy(hbBuffer);
     hb_font_destroy(hbFont);
+    hb_face_destroy(hbFace);
+    hbBuffer = nullptr;
     hbFont = nullptr;
+    hbFace = nullptr;
+    shapeCache->runs.clear();
+    shapeCache->lookup.clear();
     FreeTypeFont::doClose();
 }
 
+Containers::Pointer<FreeTypeFont> HarfBuzzFont::instantiateSize(const Float size) {
+    CORRADE_ASSERT(isOpened(),
+        "Text::HarfBuzzFont::instantiateSize(): no font opened", {});
+
+    Containers::Pointer<HarfBuzzFont> out{new HarfBuzzFont};
+    #if HB_VERSION_ATLEAST(1, 4, 3)
+    out->hbFace = hb_face_reference(hbFace);
+    #endif
+    openSize(*out, size);
+    return Containers::Pointer<FreeTypeFont>{out.release()};
+}
+
 Containers::Pointer<AbstractLayouter> HarfBuzzFont::doLayout(const AbstractGlyphCache& cache, const Float size, const std::string& text) {
-    /* Prepare HarfBuzz buffer */
-    hb_buffer_t* const buffer = hb_buffer_create();
-    hb_buffer_set_direction(buffer, HB_DIRECTION_LTR);
-    hb_buffer_set_script(buffer, HB_SCRIPT_LATIN);
-    hb_buffer_set_language(buffer, hb_language_from_string("en", 2));
+    return layoutText(cache, size, text);
+}
 
-    /* Layout the text */
-    hb_buffer_add_utf8(buffer, text.data(), text.size(), 0, -1);
-    hb_shape(hbFont, buffer, nullptr, 0);
+std::size_t HarfBuzzFont::layoutBatch(const AbstractGlyphCache& cache, const Float size, const Containers::ArrayView<const std::string> texts, const Containers::ArrayView<const Vector2> origins, const Containers::StridedArrayView1D<Vector2>& positions, const Containers::StridedArrayView1D<Vector2>& textureCoordinates) {
+    CORRADE_ASSERT(isOpened(),
+        "Text::HarfBuzzFont::layoutBatch(): no font opened", {});
+    CORRADE_ASSERT(texts.size() == origins.size(),
+        "Text::HarfBuzzFont::layoutBatch(): expected" << texts.size() << "origins but got" << origins.size(), {});
 
-    UnsignedInt glyphCount;
-    hb_glyph_info_t* const glyphInfo = hb_buffer_get_glyph_infos(buffer, &glyphCount);
-    hb_glyph_position_t* const glyphPositions = hb_buffer_get_glyph_positions(buffer, &glyphCount);
+    std::vector<Containers::Pointer<Layouter>> layouters;
+    layouters.reserve(texts.size());
+    for(const std::string& text: texts)
+        layouters.push_back(layoutText(cache, size, text));
 
-    return Containers::pointer(new HarfBuzzLayouter(cache, this->size(), size, buffer, glyphInfo, glyphPositions, glyphCount));
+    return Implementation::renderGlyphBatch(layouters, origins, positions, textureCoordinates);
 }
 
-namespace {
+void HarfBuzzFont::shapeBuffer() {
+    /* Set segment properties that are explicitly specified, guess the rest
+       from the text */
+    const std::string direction = configuration().value("direction");
+    const std::string script = configuration().value("script");
+    const std::string language = configuration().value("language");
+    if(!direction.empty())
+        hb_buffer_set_direction(hbBuffer, hb_direction_from_string(direction.data(), direction.size()));
+    if(!script.empty())
+        hb_buffer_set_script(hbBuffer, hb_script_from_string(script.data(), script.size()));
+    if(!language.empty())
+        hb_buffer_set_language(hbBuffer, hb_language_from_string(language.data(), language.size()));
+    hb_buffer_guess_segment_properties(hbBuffer);
+
+    /* Layout the text. The glyph metrics are queried from the FreeType
+       face, which can be shared with other sizes. */
+    activateSize();
+    hb_shape(hbFont, hbBuffer, nullptr, 0);
+}
 
-HarfBuzzLayouter::HarfBuzzLayouter(const AbstractGlyphCache& cache, const Float fontSize, const Float textSize, hb_buffer_t* const buffer, hb_glyph_info_t* const glyphInfo, hb_glyph_position_t* const glyphPositions, const UnsignedInt glyphCount): AbstractLayouter(glyphCount), cache(cache), fontSize(fontSize), textSize(textSize), buffer(buffer), glyphInfo(glyphInfo), glyphPositions(glyphPositions) {}
+std::size_t HarfBuzzFont::shape(const Float size, const Containers::ArrayView<const char32_t> text, const Containers::StridedArrayView1D<UnsignedInt>& glyphIds, const Containers::StridedArrayView1D<Vector2>& offsets, const Containers::StridedArrayView1D<Vector2>& advances) {
+    CORRADE_ASSERT(isOpened(),
+        "Text::HarfBuzzFont::shape(): no font opened", {});
+
+    /* The codepoints are passed as-is, with no decoding involved */
+    static_assert(sizeof(char32_t) == sizeof(std::uint32_t), "");
+    hb_buffer_reset(hbBuffer);
+    hb_buffer_add_utf32(hbBuffer, reinterpret_cast<const std::uint32_t*>(text.data()), text.size(), 0, -1);
+    shapeBuffer();
+
+    UnsignedInt glyphCount;
+    const hb_glyph_info_t* const glyphInfo = hb_buffer_get_glyph_infos(hbBuffer, &glyphCount);
+    const hb_glyph_position_t* const glyphPositions = hb_buffer_get_glyph_positions(hbBuffer, &glyphCount);
+    if(glyphIds.size() < glyphCount || offsets.size() < glyphCount || advances.size() < glyphCount)
+        return glyphCount;
+
+    /* Positions are in 26.6 fixed point of the font size, scale them to the
+       requested size right away */
+    const Float scale = size/(this->size()*64.0f);
+    for(UnsignedInt i = 0; i != glyphCount; ++i) {
+        glyphIds[i] = glyphInfo[i].codepoint;
+        offsets[i] = Vector2(glyphPositions[i].x_offset, glyphPositions[i].y_offset)*scale;
+        advances[i] = Vector2(glyphPositions[i].x_advance, glyphPositions[i].y_advance)*scale;
+    }
+
+    return glyphCount;
+}
 
-HarfBuzzLayouter::~HarfBuzzLayouter() {
-    /* Destroy HarfBuzz buffer */
-    hb_buffer_destroy(buffer);
+Containers::Pointer<HarfBuzzFont::Layouter> HarfBuzzFont::layoutText(const AbstractGlyphCache& cache, const Float size, const std::string& text) {
+    const std::string direction = configuration().value("direction");
+    const std::string script = configuration().value("script");
+    const std::string language = configuration().value("language");
+
+    /* If the run cache is enabled and the text was shaped with the same
+       segment properties recently, reuse it. The requested size only scales
+       the result, so it's not a part of the key. */
+    const std::size_t shapeCacheSize = configuration().value<std::size_t>("shapeCacheSize");
+    std::string key;
+    if(shapeCacheSize) {
+        key.reserve(direction.size() + script.size() + language.size() + text.size() + 3);
+        key += direction;
+        key += '\0';
+        key += script;
+        key += '\0';
+        key += language;
+        key += '\0';
+        key += text;
+
+        const auto found = shapeCache->lookup.find(key);
+        if(found != shapeCache->lookup.end()) {
+            shapeCache->runs.splice(shapeCache->runs.begin(), shapeCache->runs, found->second);
+            std::vector<ShapedGlyph> glyphs = found->second->glyphs;
+            return Containers::pointer(new Layouter(cache, this->size(), size, std::move(glyphs)));
+        }
+    }
+
+    /* Prepare HarfBuzz buffer. Reset keeps the allocated memory, so after a
+       few layouts it doesn't need to allocate anymore. */
+    hb_buffer_reset(hbBuffer);
+    hb_buffer_add_utf8(hbBuffer, text.data(), text.size(), 0, -1);
+    shapeBuffer();
+
+    /* Copy the glyphs out, as the buffer gets reused by the next layout */
+    UnsignedInt glyphCount;
+    const hb_glyph_info_t* const glyphInfo = hb_buffer_get_glyph_infos(hbBuffer, &glyphCount);
+    const hb_glyph_position_t* const glyphPositions = hb_buffer_get_glyph_positions(hbBuffer, &glyphCount);
+    std::vector<ShapedGlyph> glyphs;
+    glyphs.reserve(glyphCount);
+    for(UnsignedInt i = 0; i != glyphCount; ++i) glyphs.push_back({
+        glyphInfo[i].codepoint,
+        Vector2(glyphPositions[i].x_offset, glyphPositions[i].y_offset)/64.0f,
+        Vector2(glyphPositions[i].x_advance, glyphPositions[i].y_advance)/64.0f});
+
+    /* Remember the run, evicting the least recently used ones if the cache
+       is full. The size is checked every time as the option can change
+       between calls. */
+    if(shapeCacheSize) {
+        while(shapeCache->runs.size() >= shapeCacheSize) {
+            shapeCache->lookup.erase(shapeCache->runs.back().key);
+            shapeCache->runs.pop_back();
+        }
+        shapeCache->runs.push_front({std::move(key), glyphs});
+        shapeCache->lookup.emplace(shapeCache->runs.front().key, shapeCache->runs.begin());
+    }
+
+    return Containers::pointer(new Layouter(cache, this->size(), size, std::move(glyphs)));
 }
 
-std::tuple<Range2D, Range2D, Vector2> HarfBuzzLayouter::doRenderGlyph(const UnsignedInt i) {
+HarfBuzzFont::Layouter::Layouter(const AbstractGlyphCache& cache, const Float fontSize, const Float textSize, std::vector<ShapedGlyph>&& glyphs): AbstractLayouter(glyphs.size()), cache(cache), fontSize(fontSize), textSize(textSize), glyphs(std::move(glyphs)) {}
+
+std::tuple<Range2D, Range2D, Vector2> HarfBuzzFont::Layouter::glyph(const UnsignedInt i) const {
     /* Position of the texture in the resulting glyph, texture coordinates */
     Vector2i position;
     Range2Di rectangle;
-    std::tie(position, rectangle) = cache[glyphInfo[i].codepoint];
+    std::tie(position, rectangle) = cache[glyphs[i].id];
 
     /* Normalized texture coordinates */
     const auto textureCoordinates = Range2D(rectangle).scaled(1.0f/Vector2(cache.textureSize()));
 
-    /* Glyph offset in normalized coordinates */
-    const Vector2 offset = Vector2(glyphPositions[i].x_offset,
-                                   glyphPositions[i].y_offset)/64.0f;
-
     /* Quad rectangle, computed from glyph offset and texture rectangle,
        denormalized to requested text size */
     const auto quadRectangle = Range2D(Range2Di::fromSize(position, rectangle.size()))
-        .translated(offset).scaled(Vector2(textSize/fontSize));
+        .translated(glyphs[i].offset).scaled(Vector2(textSize/fontSize));
 
     /* Glyph advance, denormalized to requested text size */
-    const Vector2 advance = Vector2(glyphPositions[i].x_advance,
-                                    glyphPositions[i].y_advance)*(textSize/(64.0f*fontSize));
+    const Vector2 advance = glyphs[i].advance*(textSize/fontSize);
 
     return std::make_tuple(quadRectangle, textureCoordinates, advance);
 }
 
-}
-
 }}
 
 CORRADE_PLUGIN_REGISTER(HarfBuzzFont, Magnum::Text::HarfBuzzFont,
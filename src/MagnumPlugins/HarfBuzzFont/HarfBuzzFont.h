@@ -50,6 +50,8 @@
 #endif
 
 #ifndef DOXYGEN_GENERATING_OUTPUT
+struct hb_buffer_t;
+struct hb_face_t;
 struct hb_font_t;
 #endif
 
@@ -111,6 +113,62 @@ target_link_libraries(your-app PRIVATE MagnumPlugins::HarfBuzzFont)
 
 See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
 information.
+
+@section Text-HarfBuzzFont-layout Text layouting
+
+The text is shaped with the direction, script and language given by the
+@cb{.ini} direction @ce, @cb{.ini} script @ce and @cb{.ini} language @ce
+@ref Text-HarfBuzzFont-configuration "configuration options". By default
+they're empty and guessed from the text using
+@m_class{m-doc-external} [hb_buffer_guess_segment_properties()](https://harfbuzz.github.io/harfbuzz-hb-buffer.html#hb-buffer-guess-segment-properties),
+so for example an Arabic string is shaped right-to-left. The options are
+applied on every @ref layout() call, so they can be changed between calls for
+strings in different languages.
+
+A single HarfBuzz buffer is kept for the whole lifetime of the opened font and
+reused across @ref layout() calls. The shaped glyphs are copied out of it,
+which means the returned layouter stays valid even after another call to
+@ref layout() or after closing the font.
+
+When the same strings are laid out repeatedly, such as labels redrawn every
+frame, set the @cb{.ini} shapeCacheSize @ce
+@ref Text-HarfBuzzFont-configuration "configuration option" to a non-zero
+value. Up to this many shaped runs are remembered, keyed by the text and the
+direction, script and language options, and the least recently used ones are
+discarded first. The size passed to @ref layout() only scales the result, so
+laying out the same string at a different size reuses the run as well. The
+cache is cleared when the font is closed.
+
+@subsection Text-HarfBuzzFont-layout-shape Shaping pre-decoded text
+
+For large amounts of text, the @ref layout() path can be skipped entirely with
+@ref shape(). It takes UTF-32 codepoints directly, so there's no UTF-8
+decoding, and writes glyph IDs, offsets and advances of the whole run into
+caller-provided views, instead of allocating a layouter and returning each
+glyph through a virtual call. The glyph IDs can be then looked up in a glyph
+cache by the application in whatever way suits it best. The same
+@cb{.ini} direction @ce, @cb{.ini} script @ce and @cb{.ini} language @ce
+options are used as in @ref layout(), the @cb{.ini} shapeCacheSize @ce
+option affects only @ref layout() and @ref layoutBatch().
+
+@section Text-HarfBuzzFont-sizes Multiple sizes of the same font
+
+Same as with @ref FreeTypeFont, @ref instantiateSize() returns a new instance
+of the opened font in a different size, sharing the font data and the
+FreeType face. With HarfBuzz 1.4.3 and newer, the instances share also the
+HarfBuzz face, which means the font tables are loaded and the shape plans
+created just once for all sizes. See @ref Text-FreeTypeFont-sizes for more
+information.
+
+@section Text-HarfBuzzFont-configuration Plugin-specific configuration
+
+It's possible to tune various options through @ref configuration(). See below
+for all options and their default values:
+
+@snippet MagnumPlugins/HarfBuzzFont/HarfBuzzFont.conf config
+
+Glyph cache filling is done by @ref FreeTypeFont, see
+@ref Text-FreeTypeFont-glyph-cache for details.
 */
 class MAGNUM_HARFBUZZFONT_EXPORT HarfBuzzFont: public FreeTypeFont {
     public:
@@ -138,14 +196,68 @@ class MAGNUM_HARFBUZZFONT_EXPORT HarfBuzzFont: public FreeTypeFont {
 
         ~HarfBuzzFont();
 
+        /**
+         * @brief Lay out multiple strings into a single vertex stream
+         * @m_since_latest_{plugins}
+         *
+         * Same as @ref FreeTypeFont::layoutBatch(), but with the texts shaped
+         * using HarfBuzz the same way as in @ref layout(). See
+         * @ref Text-HarfBuzzFont-layout for details.
+         */
+        std::size_t layoutBatch(const AbstractGlyphCache& cache, Float size, Containers::ArrayView<const std::string> texts, Containers::ArrayView<const Vector2> origins, const Containers::StridedArrayView1D<Vector2>& positions, const Containers::StridedArrayView1D<Vector2>& textureCoordinates) override;
+
+        /**
+         * @brief Shape a run of UTF-32 text
+         * @param size          Font size
+         * @param text          Codepoints to shape
+         * @param glyphIds      Where to put glyph IDs
+         * @param offsets       Where to put glyph offsets
+         * @param advances      Where to put glyph advances
+         * @return Glyph count of the shaped run
+         * @m_since_latest_{plugins}
+         *
+         * Shapes @p text with HarfBuzz the same way as @ref layout() does
+         * and writes the resulting glyphs in visual order. The offsets and
+         * advances are scaled to @p size. See
+         * @ref Text-HarfBuzzFont-layout-shape for details.
+         *
+         * If @p glyphIds, @p offsets or @p advances have less than the
+         * returned count elements, nothing is written. Passing empty views
+         * can be used to query the size to allocate. Expects that a font is
+         * opened.
+         *
+         * The function is virtual so it can be called on a dynamically
+         * loaded plugin without linking to it.
+         */
+        virtual std::size_t shape(Float size, Containers::ArrayView<const char32_t> text, const Containers::StridedArrayView1D<UnsignedInt>& glyphIds, const Containers::StridedArrayView1D<Vector2>& offsets, const Containers::StridedArrayView1D<Vector2>& advances);
+
+        /**
+         * @brief Instantiate the opened font in a different size
+         * @m_since_latest_{plugins}
+         *
+         * Same as @ref FreeTypeFont::instantiateSize(), but the returned
+         * instance is a @ref HarfBuzzFont sharing also the HarfBuzz face with
+         * this one. See @ref Text-HarfBuzzFont-sizes for details.
+         */
+        Containers::Pointer<FreeTypeFont> instantiateSize(Float size) override;
+
     private:
+        class Layouter;
+
         MAGNUM_HARFBUZZFONT_LOCAL FontFeatures doFeatures() const override;
         MAGNUM_HARFBUZZFONT_LOCAL bool doIsOpened() const override;
         MAGNUM_HARFBUZZFONT_LOCAL Metrics doOpenData(Containers::ArrayView<const char> data, Float size) override;
         MAGNUM_HARFBUZZFONT_LOCAL void doClose() override;
         MAGNUM_HARFBUZZFONT_LOCAL Containers::Pointer<AbstractLayouter> doLayout(const AbstractGlyphCache& cache, Float size, const std::string& text) override;
+        MAGNUM_HARFBUZZFONT_LOCAL Containers::Pointer<Layouter> layoutText(const AbstractGlyphCache& cache, Float size, const std::string& text);
+        MAGNUM_HARFBUZZFONT_LOCAL void shapeBuffer();
 
+        hb_face_t* hbFace;
         hb_font_t* hbFont;
+        hb_buffer_t* hbBuffer;
+
+        struct ShapeCache;
+        Containers::Pointer<ShapeCache> shapeCache;
 };
 
 }}
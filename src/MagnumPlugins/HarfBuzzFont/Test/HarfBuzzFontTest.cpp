@@ -25,10 +25,13 @@
 
 #include <Corrade/PluginManager/Manager.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Magnum/Text/AbstractFont.h>
 #include <Magnum/Text/AbstractGlyphCache.h>
 #include <hb.h>
 
+#include "MagnumPlugins/HarfBuzzFont/HarfBuzzFont.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Text { namespace Test { namespace {
@@ -37,13 +40,32 @@ struct HarfBuzzFontTest: TestSuite::Tester {
     explicit HarfBuzzFontTest();
 
     void layout();
+    void layoutDirection();
+    void layoutMultiple();
+    void layoutShapeCache();
+    void layoutBatch();
+    void shape();
+    void instantiateSize();
 
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractFont> _manager{"nonexistent"};
 };
 
+struct DummyGlyphCache: AbstractGlyphCache {
+    using AbstractGlyphCache::AbstractGlyphCache;
+
+    GlyphCacheFeatures doFeatures() const override { return {}; }
+    void doSetImage(const Vector2i&, const ImageView2D&) override {}
+};
+
 HarfBuzzFontTest::HarfBuzzFontTest() {
-    addTests({&HarfBuzzFontTest::layout});
+    addTests({&HarfBuzzFontTest::layout,
+              &HarfBuzzFontTest::layoutDirection,
+              &HarfBuzzFontTest::layoutMultiple,
+              &HarfBuzzFontTest::layoutShapeCache,
+              &HarfBuzzFontTest::layoutBatch,
+              &HarfBuzzFontTest::shape,
+              &HarfBuzzFontTest::instantiateSize});
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
@@ -58,12 +80,7 @@ void HarfBuzzFontTest::layout() {
     CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
 
     /* Fill the cache with some fake glyphs */
-    struct: AbstractGlyphCache {
-        using AbstractGlyphCache::AbstractGlyphCache;
-
-        GlyphCacheFeatures doFeatures() const override { return {}; }
-        void doSetImage(const Vector2i&, const ImageView2D&) override {}
-    } cache{Vector2i{256}};
+    DummyGlyphCache cache{Vector2i{256}};
     cache.insert(font->glyphId(U'W'), {25, 34}, {{0, 8}, {16, 128}});
     cache.insert(font->glyphId(U'e'), {25, 12}, {{16, 4}, {64, 32}});
 
@@ -106,6 +123,227 @@ void HarfBuzzFontTest::layout() {
     CORRADE_COMPARE(cursorPosition, Vector2(0.260742f, 0.0f));
 }
 
+void HarfBuzzFontTest::layoutDirection() {
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("HarfBuzzFont");
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+
+    DummyGlyphCache cache{Vector2i{256}};
+    cache.insert(font->glyphId(U'W'), {25, 34}, {{0, 8}, {16, 128}});
+    cache.insert(font->glyphId(U'e'), {25, 12}, {{16, 4}, {64, 32}});
+
+    /* The glyphs are in visual order, so in reverse for right-to-left */
+    font->configuration().setValue("direction", "rtl");
+    Containers::Pointer<AbstractLayouter> layouter = font->layout(cache, 0.5f, "Wave");
+    CORRADE_VERIFY(layouter);
+    CORRADE_COMPARE(layouter->glyphCount(), 4);
+
+    Vector2 cursorPosition;
+    Range2D rectangle, position, textureCoordinates;
+
+    /* 'e' */
+    std::tie(position, textureCoordinates) = layouter->renderGlyph(0, cursorPosition = {}, rectangle);
+    CORRADE_COMPARE(textureCoordinates, Range2D({0.0625f, 0.015625f}, {0.25f, 0.125f}));
+    CORRADE_COMPARE(cursorPosition, Vector2(0.260742f, 0.0f));
+
+    /* 'W' */
+    std::tie(position, textureCoordinates) = layouter->renderGlyph(3, cursorPosition = {}, rectangle);
+    CORRADE_COMPARE(textureCoordinates, Range2D({0, 0.03125f}, {0.0625f, 0.5f}));
+    CORRADE_COMPARE(cursorPosition, Vector2(0.51123f, 0.0f));
+
+    /* Resetting back to guessing the direction from the text, which is
+       left-to-right again */
+    font->configuration().setValue("direction", "");
+    layouter = font->layout(cache, 0.5f, "Wave");
+    CORRADE_VERIFY(layouter);
+    std::tie(position, textureCoordinates) = layouter->renderGlyph(0, cursorPosition = {}, rectangle);
+    CORRADE_COMPARE(textureCoordinates, Range2D({0, 0.03125f}, {0.0625f, 0.5f}));
+}
+
+void HarfBuzzFontTest::layoutMultiple() {
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("HarfBuzzFont");
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+
+    DummyGlyphCache cache{Vector2i{256}};
+    cache.insert(font->glyphId(U'W'), {25, 34}, {{0, 8}, {16, 128}});
+    cache.insert(font->glyphId(U'e'), {25, 12}, {{16, 4}, {64, 32}});
+
+    /* The HarfBuzz buffer is reused for both, the first layouter shouldn't be
+       affected by the second layout or by closing the font */
+    Containers::Pointer<AbstractLayouter> first = font->layout(cache, 0.5f, "We");
+    Containers::Pointer<AbstractLayouter> second = font->layout(cache, 0.5f, "eWave");
+    font->close();
+    CORRADE_VERIFY(first);
+    CORRADE_VERIFY(second);
+    CORRADE_COMPARE(first->glyphCount(), 2);
+    CORRADE_COMPARE(second->glyphCount(), 5);
+
+    Vector2 cursorPosition;
+    Range2D rectangle, position, textureCoordinates;
+    std::tie(position, textureCoordinates) = first->renderGlyph(0, cursorPosition = {}, rectangle);
+    CORRADE_COMPARE(textureCoordinates, Range2D({0, 0.03125f}, {0.0625f, 0.5f}));
+    std::tie(position, textureCoordinates) = second->renderGlyph(0, cursorPosition = {}, rectangle);
+    CORRADE_COMPARE(textureCoordinates, Range2D({0.0625f, 0.015625f}, {0.25f, 0.125f}));
+}
+
+void HarfBuzzFontTest::layoutShapeCache() {
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("HarfBuzzFont");
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+    font->configuration().setValue("shapeCacheSize", 2);
+
+    DummyGlyphCache cache{Vector2i{256}};
+    cache.insert(font->glyphId(U'W'), {25, 34}, {{0, 8}, {16, 128}});
+    cache.insert(font->glyphId(U'e'), {25, 12}, {{16, 4}, {64, 32}});
+
+    Vector2 cursorPosition;
+    Range2D rectangle, position, textureCoordinates;
+
+    /* Shaped and remembered */
+    Containers::Pointer<AbstractLayouter> layouter = font->layout(cache, 0.5f, "We");
+    CORRADE_VERIFY(layouter);
+    CORRADE_COMPARE(layouter->glyphCount(), 2);
+
+    /* Reused, but at a different size */
+    layouter = font->layout(cache, 1.0f, "We");
+    CORRADE_VERIFY(layouter);
+    CORRADE_COMPARE(layouter->glyphCount(), 2);
+    std::tie(position, textureCoordinates) = layouter->renderGlyph(0, cursorPosition = {}, rectangle);
+    CORRADE_COMPARE(position, Range2D({1.5625f, 2.125f}, {2.5625f, 9.625f}));
+    CORRADE_COMPARE(textureCoordinates, Range2D({0, 0.03125f}, {0.0625f, 0.5f}));
+
+    /* Different direction is a different key, so it's not the left-to-right
+       run that's returned */
+    font->configuration().setValue("direction", "rtl");
+    layouter = font->layout(cache, 0.5f, "We");
+    CORRADE_VERIFY(layouter);
+    std::tie(position, textureCoordinates) = layouter->renderGlyph(0, cursorPosition = {}, rectangle);
+    CORRADE_COMPARE(textureCoordinates, Range2D({0.0625f, 0.015625f}, {0.25f, 0.125f}));
+
+    /* A third run evicts the least recently used one, which is the
+       left-to-right "We". It gets shaped again, with the same result. */
+    font->configuration().setValue("direction", "");
+    layouter = font->layout(cache, 0.5f, "Wave");
+    CORRADE_VERIFY(layouter);
+    CORRADE_COMPARE(layouter->glyphCount(), 4);
+    layouter = font->layout(cache, 0.5f, "We");
+    CORRADE_VERIFY(layouter);
+    CORRADE_COMPARE(layouter->glyphCount(), 2);
+    std::tie(position, textureCoordinates) = layouter->renderGlyph(0, cursorPosition = {}, rectangle);
+    CORRADE_COMPARE(textureCoordinates, Range2D({0, 0.03125f}, {0.0625f, 0.5f}));
+}
+
+void HarfBuzzFontTest::layoutBatch() {
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("HarfBuzzFont");
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+
+    DummyGlyphCache cache{Vector2i{256}};
+    cache.insert(font->glyphId(U'W'), {25, 34}, {{0, 8}, {16, 128}});
+    cache.insert(font->glyphId(U'e'), {25, 12}, {{16, 4}, {64, 32}});
+
+    const std::string texts[]{"Wave", "eW"};
+    const Vector2 origins[]{{}, {10.0f, 20.0f}};
+
+    /* Querying the size with empty views writes nothing */
+    HarfBuzzFont& batchFont = static_cast<HarfBuzzFont&>(*font);
+    CORRADE_COMPARE(batchFont.layoutBatch(cache, 0.5f, texts, origins, {}, {}), 6);
+
+    struct Vertex {
+        Vector2 position;
+        Vector2 textureCoordinates;
+    } vertices[6*4];
+    const Containers::StridedArrayView1D<Vector2> positions{vertices, &vertices[0].position, Containers::arraySize(vertices), sizeof(Vertex)};
+    const Containers::StridedArrayView1D<Vector2> textureCoordinates{vertices, &vertices[0].textureCoordinates, Containers::arraySize(vertices), sizeof(Vertex)};
+    CORRADE_COMPARE(batchFont.layoutBatch(cache, 0.5f, texts, origins, positions, textureCoordinates), 6);
+
+    /* Should be the same as layouting each text separately */
+    std::size_t vertex = 0;
+    for(std::size_t i = 0; i != Containers::arraySize(texts); ++i) {
+        CORRADE_ITERATION(texts[i]);
+        Containers::Pointer<AbstractLayouter> layouter = font->layout(cache, 0.5f, texts[i]);
+        CORRADE_VERIFY(layouter);
+
+        Vector2 cursorPosition = origins[i];
+        Range2D rectangle, quadPosition, quadTextureCoordinates;
+        for(UnsignedInt j = 0; j != layouter->glyphCount(); ++j) {
+            std::tie(quadPosition, quadTextureCoordinates) = layouter->renderGlyph(j, cursorPosition, rectangle);
+            CORRADE_COMPARE(vertices[vertex + 0].position, quadPosition.topLeft());
+            CORRADE_COMPARE(vertices[vertex + 1].position, quadPosition.bottomLeft());
+            CORRADE_COMPARE(vertices[vertex + 2].position, quadPosition.topRight());
+            CORRADE_COMPARE(vertices[vertex + 3].position, quadPosition.bottomRight());
+            CORRADE_COMPARE(vertices[vertex + 0].textureCoordinates, quadTextureCoordinates.topLeft());
+            CORRADE_COMPARE(vertices[vertex + 1].textureCoordinates, quadTextureCoordinates.bottomLeft());
+            CORRADE_COMPARE(vertices[vertex + 2].textureCoordinates, quadTextureCoordinates.topRight());
+            CORRADE_COMPARE(vertices[vertex + 3].textureCoordinates, quadTextureCoordinates.bottomRight());
+            vertex += 4;
+        }
+    }
+    CORRADE_COMPARE(vertex, Containers::arraySize(vertices));
+}
+
+void HarfBuzzFontTest::shape() {
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("HarfBuzzFont");
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+
+    const char32_t text[]{U'W', U'a', U'v', U'e'};
+
+    /* Querying the size with empty views writes nothing */
+    HarfBuzzFont& shapeFont = static_cast<HarfBuzzFont&>(*font);
+    CORRADE_COMPARE(shapeFont.shape(0.5f, text, {}, {}, {}), 4);
+
+    UnsignedInt glyphIds[4];
+    Vector2 offsets[4];
+    Vector2 advances[4];
+    CORRADE_COMPARE(shapeFont.shape(0.5f, text, glyphIds, offsets, advances), 4);
+
+    /* Should give the same glyphs and advances as layout() */
+    CORRADE_COMPARE(glyphIds[0], font->glyphId(U'W'));
+    CORRADE_COMPARE(glyphIds[1], font->glyphId(U'a'));
+    CORRADE_COMPARE(glyphIds[2], font->glyphId(U'v'));
+    CORRADE_COMPARE(glyphIds[3], font->glyphId(U'e'));
+    CORRADE_COMPARE(offsets[0], Vector2{});
+    CORRADE_COMPARE(advances[0], Vector2(0.51123f, 0.0f));
+    CORRADE_COMPARE(advances[1], Vector2(0.258301f, 0.0f));
+    CORRADE_COMPARE(advances[3], Vector2(0.260742f, 0.0f));
+
+    /* Right-to-left gives the glyphs in reverse */
+    font->configuration().setValue("direction", "rtl");
+    CORRADE_COMPARE(shapeFont.shape(0.5f, text, glyphIds, offsets, advances), 4);
+    CORRADE_COMPARE(glyphIds[0], font->glyphId(U'e'));
+    CORRADE_COMPARE(glyphIds[3], font->glyphId(U'W'));
+    CORRADE_COMPARE(advances[3], Vector2(0.51123f, 0.0f));
+}
+
+void HarfBuzzFontTest::instantiateSize() {
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("HarfBuzzFont");
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 32.0f));
+
+    Containers::Pointer<FreeTypeFont> instance = static_cast<HarfBuzzFont&>(*font).instantiateSize(16.0f);
+    CORRADE_VERIFY(instance);
+    CORRADE_COMPARE(instance->size(), 16.0f);
+
+    /* Lay out something with the original size first to verify the shared
+       face is switched to the right size */
+    DummyGlyphCache cache{Vector2i{256}};
+    cache.insert(font->glyphId(U'W'), {25, 34}, {{0, 8}, {16, 128}});
+    cache.insert(font->glyphId(U'e'), {25, 12}, {{16, 4}, {64, 32}});
+    CORRADE_VERIFY(font->layout(cache, 0.5f, "Wave"));
+
+    /* The instance should be a HarfBuzzFont as well, giving the same advances
+       as in layout() and not the ones from FreeTypeFont, even after the
+       original font is closed */
+    font->close();
+    Containers::Pointer<AbstractLayouter> layouter = instance->layout(cache, 0.5f, "Wave");
+    CORRADE_VERIFY(layouter);
+    CORRADE_COMPARE(layouter->glyphCount(), 4);
+
+    Vector2 cursorPosition;
+    Range2D rectangle, position, textureCoordinates;
+    std::tie(position, textureCoordinates) = layouter->renderGlyph(0, cursorPosition = {}, rectangle);
+    CORRADE_COMPARE(position, Range2D({0.78125f, 1.0625f}, {1.28125f, 4.8125f}));
+    CORRADE_COMPARE(cursorPosition, Vector2(0.51123f, 0.0f));
+    std::tie(position, textureCoordinates) = layouter->renderGlyph(3, cursorPosition = {}, rectangle);
+    CORRADE_COMPARE(cursorPosition, Vector2(0.260742f, 0.0f));
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Text::Test::HarfBuzzFontTest)
@@ -25,7 +25,7 @@
 
 #include "MagnumPlugins/HarfBuzzFont/configure.h"
 
-#ifdef MAGNUM_HARFBUZZFONT_BUILD_STATIC
+#if defined(MAGNUM_HARFBUZZFONT_BUILD_STATIC) && !defined(MAGNUM_PLUGINS_NO_AUTOMATIC_IMPORT)
 #include <Corrade/PluginManager/AbstractManager.h>
 
 static int magnumHarfBuzzFontStaticImporter() {
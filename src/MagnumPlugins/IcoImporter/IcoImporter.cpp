@@ -26,12 +26,20 @@
 
 #include "IcoImporter.h"
 
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
-#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
 #include <Corrade/Utility/Endianness.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "MagnumPlugins/Implementation/importerInput.h"
+
 namespace Magnum { namespace Trade {
 
 namespace {
@@ -62,13 +70,17 @@ struct IconDirEntry {
 
 }
 
-struct IcoImporter::State {
-    Containers::Pointer<Trade::AbstractImporter> pngImporter;
-    Containers::Array<char> data;
+struct IcoImporter::State: Implementation::ImporterInput {
+    /* PNG importers, the first is used by image2D(), all of them by
+       image2DLevels(), one for each thread. Instantiated on demand. */
+    Containers::Array<Containers::Pointer<Trade::AbstractImporter>> pngImporters;
     Containers::Array<Containers::ArrayView<const char>> levels;
 };
 
-IcoImporter::IcoImporter() = default;
+IcoImporter::IcoImporter() {
+    /** @todo horrible workaround, fix this properly */
+    configuration().setValue("threads", 1);
+}
 
 IcoImporter::IcoImporter(PluginManager::AbstractManager& manager, const std::string& plugin) : AbstractImporter{manager, plugin} {}
 
@@ -86,28 +98,52 @@ namespace {
     };
 }
 
+void IcoImporter::doOpenFile(const std::string& filename) {
+    /* Map the file instead of reading it to avoid having the whole file
+       copied in memory. Moving the state in openInternal() doesn't change the
+       data pointer, so the views stay valid. */
+    Containers::Pointer<State> state{Containers::InPlaceInit};
+    if(!state->openFile(filename, "Trade::IcoImporter::openFile():")) return;
+    openInternal(std::move(state), "Trade::IcoImporter::openFile():");
+}
+
 void IcoImporter::doOpenData(const Containers::ArrayView<const char> data) {
+    Containers::Pointer<State> state{Containers::InPlaceInit};
+    state->openData(data);
+    openInternal(std::move(state), "Trade::IcoImporter::openData():");
+}
+
+bool IcoImporter::openMemory(const Containers::ArrayView<const char> data) {
+    close();
+    Containers::Pointer<State> state{Containers::InPlaceInit};
+    state->openMemory(data);
+    openInternal(std::move(state), "Trade::IcoImporter::openMemory():");
+    return isOpened();
+}
+
+void IcoImporter::openInternal(Containers::Pointer<State>&& state, const char* const messagePrefix) {
+    const Containers::ArrayView<const char> data = state->in;
     if(data.size() < sizeof(IconDir)) {
-        Error{} << "Trade::IcoImporter::openData(): file header too short, expected at least" << sizeof(IconDir) << "bytes but got" << data.size();
+        Error{} << messagePrefix << "file header too short, expected at least" << sizeof(IconDir) << "bytes but got" << data.size();
         return;
     }
 
-    IconDir header = *reinterpret_cast<const IconDir*>(data.begin());
+    IconDir header;
+    std::memcpy(&header, data.begin(), sizeof(IconDir));
     Utility::Endianness::littleEndianInPlace(header.imageType, header.imageCount);
 
-    Containers::Pointer<State> state{Containers::InPlaceInit};
-    state->data = Containers::Array<char>{Containers::NoInit, data.size()};
     state->levels = Containers::Array<Containers::ArrayView<const char>>{header.imageCount};
-    Utility::copy(data, state->data);
 
     for(UnsignedInt i = 0; i != header.imageCount; ++i) {
         std::size_t iconDirEntryOffset = sizeof(IconDir) + sizeof(IconDirEntry)*i;
-        if(state->data.size() < iconDirEntryOffset + sizeof(IconDirEntry)) {
-            Error{} << "Trade::IcoImporter::openData(): image header too short, expected at least" << iconDirEntryOffset + sizeof(IconDirEntry) << "bytes but got" << state->data.size();
+        if(state->in.size() < iconDirEntryOffset + sizeof(IconDirEntry)) {
+            Error{} << messagePrefix << "image header too short, expected at least" << iconDirEntryOffset + sizeof(IconDirEntry) << "bytes but got" << state->in.size();
             return;
         }
 
-        IconDirEntry iconDirEntry = *reinterpret_cast<const IconDirEntry*>(state->data.begin() + iconDirEntryOffset);
+        /* The memory passed to openMemory() doesn't need to be aligned */
+        IconDirEntry iconDirEntry;
+        std::memcpy(&iconDirEntry, state->in.begin() + iconDirEntryOffset, sizeof(IconDirEntry));
         /* The other fields need endian swapping as well, but we don't use them
            so it's not necessary */
         Utility::Endianness::littleEndianInPlace(
@@ -115,12 +151,12 @@ void IcoImporter::doOpenData(const Containers::ArrayView<const char> data) {
             iconDirEntry.imageDataOffset
         );
 
-        if(state->data.size() < iconDirEntry.imageDataOffset + iconDirEntry.imageDataSize) {
-            Error{} << "Trade::IcoImporter::openData(): image too short, expected at least" << iconDirEntry.imageDataOffset + iconDirEntry.imageDataSize << "bytes but got" << state->data.size();
+        if(state->in.size() < iconDirEntry.imageDataOffset + iconDirEntry.imageDataSize) {
+            Error{} << messagePrefix << "image too short, expected at least" << iconDirEntry.imageDataOffset + iconDirEntry.imageDataSize << "bytes but got" << state->in.size();
             return;
         }
 
-        state->levels[i] = state->data.slice(iconDirEntry.imageDataOffset, iconDirEntry.imageDataOffset + iconDirEntry.imageDataSize);
+        state->levels[i] = state->in.slice(iconDirEntry.imageDataOffset, iconDirEntry.imageDataOffset + iconDirEntry.imageDataSize);
     }
 
     /* All good, save the state */
@@ -131,26 +167,91 @@ UnsignedInt IcoImporter::doImage2DCount() const { return 1; }
 
 UnsignedInt IcoImporter::doImage2DLevelCount(UnsignedInt) { return _state->levels.size(); }
 
+namespace {
+
+bool isPng(const Containers::ArrayView<const char> data) {
+    return data.size() >= sizeof(PngHeader) && std::memcmp(data.data(), PngHeader, sizeof(PngHeader)) == 0;
+}
+
+}
+
+bool IcoImporter::ensurePngImporters(const std::size_t count, const char* const messagePrefix) {
+    while(_state->pngImporters.size() < count) {
+        Containers::Pointer<AbstractImporter> importer = manager()->loadAndInstantiate("PngImporter");
+        if(!importer) {
+            Error{} << messagePrefix << "PngImporter is not available";
+            return false;
+        }
+        arrayAppend(_state->pngImporters, Containers::InPlaceInit, std::move(importer));
+    }
+
+    return true;
+}
+
 Containers::Optional<ImageData2D> IcoImporter::doImage2D(UnsignedInt, UnsignedInt level) {
-    if(_state->levels[level].size() < sizeof(PngHeader) || std::memcmp(_state->levels[level].data(), PngHeader, sizeof(PngHeader)) != 0) {
+    if(!isPng(_state->levels[level])) {
         Error{} << "Trade::IcoImporter::image2D(): only files with embedded PNGs are supported";
         return Containers::NullOpt;
     }
 
     /* just delegate actual image importing */
-    if(!_state->pngImporter && !(_state->pngImporter = manager()->loadAndInstantiate("PngImporter"))) {
-        Error{} << "Trade::IcoImporter::image2D(): PngImporter is not available";
+    if(!ensurePngImporters(1, "Trade::IcoImporter::image2D():"))
         return Containers::NullOpt;
-    }
 
     /* Note: this is uncovered by the tests because neither StbImageImporter
        nor PngImporter / DevIlImageImporter do any checks apart that could be
        triggered here. In the best case openData() checks PNG header, but that
        we do above already, so it can't be hit again here. */
-    if(!_state->pngImporter->openData(_state->levels[level]))
+    AbstractImporter& pngImporter = *_state->pngImporters[0];
+    if(!pngImporter.openData(_state->levels[level]))
         return Containers::NullOpt;
 
-    return _state->pngImporter->image2D(0);
+    return pngImporter.image2D(0);
+}
+
+Containers::Array<Containers::Optional<ImageData2D>> IcoImporter::image2DLevels() {
+    CORRADE_ASSERT(isOpened(),
+        "Trade::IcoImporter::image2DLevels(): no file opened", {});
+
+    Containers::Array<Containers::Optional<ImageData2D>> out{_state->levels.size()};
+
+    /* Check the format upfront so the messages are printed from the calling
+       thread */
+    Containers::Array<UnsignedInt> pngLevels;
+    for(UnsignedInt i = 0; i != _state->levels.size(); ++i) {
+        if(isPng(_state->levels[i])) arrayAppend(pngLevels, i);
+        else Error{} << "Trade::IcoImporter::image2DLevels(): only files with embedded PNGs are supported, skipping level" << i;
+    }
+    if(pngLevels.empty()) return out;
+
+    std::size_t threadCount = configuration().value<std::size_t>("threads");
+    if(!threadCount) threadCount = Math::max(1u, std::thread::hardware_concurrency());
+    threadCount = Math::min(threadCount, pngLevels.size());
+
+    /* Instantiate the importers here as the plugin manager isn't meant to be
+       used from multiple threads. They're kept for subsequent calls. */
+    if(!ensurePngImporters(threadCount, "Trade::IcoImporter::image2DLevels():"))
+        return out;
+
+    std::atomic<std::size_t> next{0};
+    auto worker = [&](AbstractImporter& importer) {
+        for(std::size_t i; (i = next++) < pngLevels.size(); ) {
+            const UnsignedInt level = pngLevels[i];
+            if(importer.openData(_state->levels[level]))
+                out[level] = importer.image2D(0);
+        }
+    };
+
+    if(threadCount == 1) worker(*_state->pngImporters[0]);
+    else {
+        Containers::Array<std::thread> threads{threadCount - 1};
+        for(std::size_t i = 0; i != threads.size(); ++i)
+            threads[i] = std::thread{worker, std::ref(*_state->pngImporters[i + 1])};
+        worker(*_state->pngImporters[0]);
+        for(std::thread& thread: threads) thread.join();
+    }
+
+    return out;
 }
 
 }}
@@ -31,6 +31,8 @@
  * @m_since_latest
  */
 
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pointer.h>
 #include <Magnum/Trade/AbstractImporter.h>
 
@@ -102,6 +104,27 @@ Currently, only embedded PNGs are supported --- for them it will delegate
 loading to any plugin that provides `PngImporter`; for images that are BMPs,
 @ref image2D() will fail. You can use @ref DevIlImageImporter in that case
 instead, but please @ref Trade-DevIlImageImporter-behavior-ico "be aware of its limitations".
+
+Files passed to @ref openFile() are memory-mapped on platforms that support
+it, data passed to @ref openData() are copied. Use @ref openMemory() to
+reference them directly if they're in memory for the whole lifetime of the importer.
+
+All levels can be imported at once using @ref image2DLevels(). With the
+@cb{.ini} threads @ce
+@ref Trade-IcoImporter-configuration "configuration option" set to something
+else than @cpp 1 @ce, the embedded PNGs are decoded on multiple threads, each
+thread using its own `PngImporter` instance. The instances are created on the
+calling thread and reused for subsequent calls until the file is closed. If
+you use the threads, check the
+@ref Trade-BasisImageConverter-loading "BasisImageConverter docs" for notes
+about pthread linking.
+
+@section Trade-IcoImporter-configuration Plugin-specific config
+
+It's possible to tune various import options through @ref configuration(). See
+below for all options and their default values:
+
+@snippet MagnumPlugins/IcoImporter/IcoImporter.conf config
 */
 class MAGNUM_ICOIMPORTER_EXPORT IcoImporter: public AbstractImporter {
     public:
@@ -113,17 +136,48 @@ class MAGNUM_ICOIMPORTER_EXPORT IcoImporter: public AbstractImporter {
 
         ~IcoImporter();
 
+        /**
+         * @brief Open raw data without making a copy
+         * @m_since_latest_{plugins}
+         *
+         * Compared to @ref openData(), the importer references @p data
+         * directly instead of making a copy, which means the memory has to
+         * stay valid and unchanged until the importer is closed or another
+         * file is opened. Closes previous file, if it was opened, and tries
+         * to open given memory. Returns @cpp true @ce on success,
+         * @cpp false @ce otherwise.
+         */
+        virtual bool openMemory(Containers::ArrayView<const char> data);
+
+        /**
+         * @brief Import all image levels
+         * @m_since_latest_{plugins}
+         *
+         * Returns one item for each level in @ref image2DLevelCount(),
+         * equivalent to calling @ref image2D() for each of them, except that
+         * the levels can be decoded on multiple threads. Levels that are not
+         * embedded PNGs or fail to decode print a message to @ref Error and
+         * are @ref Containers::NullOpt, other levels are unaffected. Expects
+         * that a file is opened. See @ref Trade-IcoImporter-behavior for more
+         * information.
+         */
+        virtual Containers::Array<Containers::Optional<ImageData2D>> image2DLevels();
+
     private:
+        struct State;
+
         MAGNUM_ICOIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_ICOIMPORTER_LOCAL bool doIsOpened() const override;
         MAGNUM_ICOIMPORTER_LOCAL void doClose() override;
+        MAGNUM_ICOIMPORTER_LOCAL void doOpenFile(const std::string& filename) override;
         MAGNUM_ICOIMPORTER_LOCAL void doOpenData(Containers::ArrayView<const char> data) override;
+        MAGNUM_ICOIMPORTER_LOCAL void openInternal(Containers::Pointer<State>&& state, const char* messagePrefix);
 
         MAGNUM_ICOIMPORTER_LOCAL UnsignedInt doImage2DCount() const override;
         MAGNUM_ICOIMPORTER_LOCAL UnsignedInt doImage2DLevelCount(UnsignedInt id) override;
         MAGNUM_ICOIMPORTER_LOCAL Containers::Optional<ImageData2D> doImage2D(UnsignedInt id, UnsignedInt level) override;
+        MAGNUM_ICOIMPORTER_LOCAL bool ensurePngImporters(std::size_t count, const char* messagePrefix);
 
-        struct State;
         Containers::Pointer<State> _state;
 };
 
@@ -30,6 +30,7 @@
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Directory.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Corrade/Utility/FormatStl.h>
@@ -38,6 +39,8 @@
 #include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "MagnumPlugins/IcoImporter/IcoImporter.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Trade { namespace Test { namespace {
@@ -52,6 +55,10 @@ struct IcoImporterTest: TestSuite::Tester {
     void bmp();
     void png();
 
+    void openMemory();
+    void levels();
+    void levelsBmp();
+
     void openTwice();
     void importTwice();
 
@@ -72,6 +79,15 @@ const struct {
         "image too short, expected at least 974 bytes but got 973"}
 };
 
+constexpr struct {
+    const char* name;
+    UnsignedInt threads;
+} LevelsData[]{
+    {"", 1},
+    {"three threads", 3},
+    {"all cores", 0}
+};
+
 IcoImporterTest::IcoImporterTest() {
     addInstancedTests({&IcoImporterTest::tooShort},
         Containers::arraySize(TooShortData));
@@ -81,6 +97,12 @@ IcoImporterTest::IcoImporterTest() {
 
               &IcoImporterTest::bmp,
               &IcoImporterTest::png,
+              &IcoImporterTest::openMemory});
+
+    addInstancedTests({&IcoImporterTest::levels},
+        Containers::arraySize(LevelsData));
+
+    addTests({&IcoImporterTest::levelsBmp,
 
               &IcoImporterTest::openTwice,
               &IcoImporterTest::importTwice});
@@ -205,6 +227,77 @@ void IcoImporterTest::png() {
     }
 }
 
+void IcoImporterTest::openMemory() {
+    if(_manager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test");
+
+    /* Same as png() except that it uses openMemory() and imports just one
+       level */
+    Containers::Array<char> data = Utility::Directory::read(Utility::Directory::join(ICOIMPORTER_TEST_DIR, "pngs.ico"));
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("IcoImporter");
+    CORRADE_VERIFY(static_cast<IcoImporter&>(*importer).openMemory(data));
+    CORRADE_COMPARE(importer->image2DLevelCount(0), 3);
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0, 2);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), (Vector2i{32, 64}));
+    CORRADE_COMPARE(image->pixels<Color3ub>()[0][0], 0xff0000_rgb);
+}
+
+void IcoImporterTest::levels() {
+    auto&& data = LevelsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_manager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("IcoImporter");
+    importer->configuration().setValue("threads", data.threads);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ICOIMPORTER_TEST_DIR, "pngs.ico")));
+
+    /* Calling twice to verify the importers get reused properly */
+    for(std::size_t i = 0; i != 2; ++i) {
+        CORRADE_ITERATION(i);
+        Containers::Array<Containers::Optional<Trade::ImageData2D>> levels = static_cast<IcoImporter&>(*importer).image2DLevels();
+        CORRADE_COMPARE(levels.size(), 3);
+
+        /* Same as in png() */
+        CORRADE_VERIFY(levels[0]);
+        CORRADE_COMPARE(levels[0]->size(), (Vector2i{16, 8}));
+        CORRADE_COMPARE(levels[0]->pixels<Color3ub>()[0][0], 0x00ff00_rgb);
+        CORRADE_VERIFY(levels[1]);
+        CORRADE_COMPARE(levels[1]->size(), Vector2i{256});
+        CORRADE_COMPARE(levels[1]->pixels<Color3ub>()[0][0], 0x0000ff_rgb);
+        CORRADE_VERIFY(levels[2]);
+        CORRADE_COMPARE(levels[2]->size(), (Vector2i{32, 64}));
+        CORRADE_COMPARE(levels[2]->pixels<Color3ub>()[0][0], 0xff0000_rgb);
+    }
+}
+
+void IcoImporterTest::levelsBmp() {
+    if(_manager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("IcoImporter");
+    importer->configuration().setValue("threads", 2);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(ICOIMPORTER_TEST_DIR, "bmp+png.ico")));
+
+    std::ostringstream out;
+    Containers::Array<Containers::Optional<Trade::ImageData2D>> levels;
+    {
+        Error redirectError{&out};
+        levels = static_cast<IcoImporter&>(*importer).image2DLevels();
+    }
+    CORRADE_COMPARE(out.str(), "Trade::IcoImporter::image2DLevels(): only files with embedded PNGs are supported, skipping level 0\n");
+
+    /* The PNG is still imported */
+    CORRADE_COMPARE(levels.size(), 2);
+    CORRADE_VERIFY(!levels[0]);
+    CORRADE_VERIFY(levels[1]);
+    CORRADE_COMPARE(levels[1]->size(), Vector2i{256});
+    CORRADE_COMPARE(levels[1]->pixels<Color3ub>()[0][0], 0x0000ff_rgb);
+}
+
 void IcoImporterTest::openTwice() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("IcoImporter");
 
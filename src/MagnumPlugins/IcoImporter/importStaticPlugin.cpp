@@ -26,7 +26,7 @@
 
 #include "MagnumPlugins/IcoImporter/configure.h"
 
-#ifdef MAGNUM_ICOIMPORTER_BUILD_STATIC
+#if defined(MAGNUM_ICOIMPORTER_BUILD_STATIC) && !defined(MAGNUM_PLUGINS_NO_AUTOMATIC_IMPORT)
 #include <Corrade/PluginManager/AbstractManager.h>
 
 static int magnumIcoImporterStaticImporter() {
@@ -0,0 +1,466 @@
+#ifndef Magnum_Audio_Implementation_audioConversion_h
+#define Magnum_Audio_Implementation_audioConversion_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/* Frequency and channel count conversion of decoded samples, shared by all
+   audio importer plugins and controlled by their frequency and channelCount
+   configuration options. Header-only as there's no common library the
+   plugins could link to. */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/Debug.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Audio/BufferFormat.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#elif defined(CORRADE_TARGET_ARM) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace Magnum { namespace Audio { namespace Implementation {
+
+enum class AudioSampleType {
+    UnsignedByte, Short, Float, Double, ALaw, MuLaw
+};
+
+inline bool audioFormatProperties(const BufferFormat format, AudioSampleType& type, UnsignedInt& channelCount) {
+    switch(format) {
+        #define _c(format, type_, channelCount_)                            \
+            case BufferFormat::format:                                      \
+                type = AudioSampleType::type_;                              \
+                channelCount = channelCount_;                               \
+                return true;
+        _c(Mono8, UnsignedByte, 1)
+        _c(Mono16, Short, 1)
+        _c(Stereo8, UnsignedByte, 2)
+        _c(Stereo16, Short, 2)
+        _c(MonoALaw, ALaw, 1)
+        _c(StereoALaw, ALaw, 2)
+        _c(MonoMuLaw, MuLaw, 1)
+        _c(StereoMuLaw, MuLaw, 2)
+        _c(MonoFloat, Float, 1)
+        _c(StereoFloat, Float, 2)
+        _c(MonoDouble, Double, 1)
+        _c(StereoDouble, Double, 2)
+        _c(Quad8, UnsignedByte, 4)
+        _c(Quad16, Short, 4)
+        _c(Quad32, Float, 4)
+        _c(Surround51Channel8, UnsignedByte, 6)
+        _c(Surround51Channel16, Short, 6)
+        _c(Surround51Channel32, Float, 6)
+        _c(Surround61Channel8, UnsignedByte, 7)
+        _c(Surround61Channel16, Short, 7)
+        _c(Surround61Channel32, Float, 7)
+        _c(Surround71Channel8, UnsignedByte, 8)
+        _c(Surround71Channel16, Short, 8)
+        _c(Surround71Channel32, Float, 8)
+        #undef _c
+    }
+
+    return false;
+}
+
+/* Size of a single sample of given type, in bytes */
+inline std::size_t audioSampleSize(const AudioSampleType type) {
+    switch(type) {
+        case AudioSampleType::UnsignedByte:
+        case AudioSampleType::ALaw:
+        case AudioSampleType::MuLaw:
+            return 1;
+        case AudioSampleType::Short:
+            return 2;
+        case AudioSampleType::Float:
+            return 4;
+        case AudioSampleType::Double:
+            return 8;
+    }
+
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
+
+/* Picks the closest format with given channel count. A-law and μ-law are
+   decoded to 16-bit, doubles are used only for mono and stereo as there are
+   no double formats with more channels. Expects that the channel count is
+   one of 1, 2, 4, 6, 7 or 8. */
+inline BufferFormat audioFormatFor(AudioSampleType& type, const UnsignedInt channelCount) {
+    if(type == AudioSampleType::ALaw || type == AudioSampleType::MuLaw)
+        type = AudioSampleType::Short;
+    if(type == AudioSampleType::Double && channelCount > 2)
+        type = AudioSampleType::Float;
+
+    #define _v(value) BufferFormat::value
+    /* Indexed by the type and channel count */
+    constexpr BufferFormat Formats[][8]{
+        {_v(Mono8), _v(Stereo8), {}, _v(Quad8), {}, _v(Surround51Channel8), _v(Surround61Channel8), _v(Surround71Channel8)},
+        {_v(Mono16), _v(Stereo16), {}, _v(Quad16), {}, _v(Surround51Channel16), _v(Surround61Channel16), _v(Surround71Channel16)},
+        {_v(MonoFloat), _v(StereoFloat), {}, _v(Quad32), {}, _v(Surround51Channel32), _v(Surround61Channel32), _v(Surround71Channel32)},
+        {_v(MonoDouble), _v(StereoDouble), {}, {}, {}, {}, {}, {}}
+    };
+    #undef _v
+    return Formats[UnsignedInt(type)][channelCount - 1];
+}
+
+/* G.711 decoding, same as the reference implementation from Sun */
+inline Short decodeALaw(UnsignedByte value) {
+    value ^= 0x55;
+    Int out = (value & 0x0f) << 4;
+    const Int segment = (value & 0x70) >> 4;
+    if(segment == 0) out += 8;
+    else if(segment == 1) out += 0x108;
+    else out = (out + 0x108) << (segment - 1);
+    return Short((value & 0x80) ? out : -out);
+}
+
+inline Short decodeMuLaw(UnsignedByte value) {
+    value = ~value;
+    const Int out = (((value & 0x0f) << 3) + 0x84) << ((value & 0x70) >> 4);
+    return Short((value & 0x80) ? 0x84 - out : out - 0x84);
+}
+
+/* Deinterleaves the samples to one plane of floats per channel */
+inline void audioSamplesToPlanar(const Containers::ArrayView<const char> in, const AudioSampleType type, const UnsignedInt channelCount, const std::size_t frameCount, Float* const out) {
+    for(std::size_t i = 0, count = frameCount*channelCount; i != count; ++i) {
+        Float value;
+        switch(type) {
+            case AudioSampleType::UnsignedByte:
+                value = (Int(UnsignedByte(in[i])) - 128)/128.0f;
+                break;
+            case AudioSampleType::Short: {
+                Short sample;
+                std::memcpy(&sample, in.data() + i*sizeof(Short), sizeof(Short));
+                value = sample/32768.0f;
+            } break;
+            case AudioSampleType::Float:
+                std::memcpy(&value, in.data() + i*sizeof(Float), sizeof(Float));
+                break;
+            case AudioSampleType::Double: {
+                Double sample;
+                std::memcpy(&sample, in.data() + i*sizeof(Double), sizeof(Double));
+                value = Float(sample);
+            } break;
+            case AudioSampleType::ALaw:
+                value = decodeALaw(in[i])/32768.0f;
+                break;
+            case AudioSampleType::MuLaw:
+                value = decodeMuLaw(in[i])/32768.0f;
+                break;
+            default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+        }
+
+        out[(i % channelCount)*frameCount + i/channelCount] = value;
+    }
+}
+
+/* Interleaves the planes back, converting to given type with clamping. The
+   type is never A-law or μ-law. */
+inline void audioSamplesFromPlanar(const Float* const in, const AudioSampleType type, const UnsignedInt channelCount, const std::size_t frameCount, const Containers::ArrayView<char> out) {
+    for(std::size_t i = 0, count = frameCount*channelCount; i != count; ++i) {
+        const Float value = in[(i % channelCount)*frameCount + i/channelCount];
+        switch(type) {
+            case AudioSampleType::UnsignedByte:
+                out[i] = char(UnsignedByte(Math::clamp(std::round(value*128.0f) + 128.0f, 0.0f, 255.0f)));
+                break;
+            case AudioSampleType::Short: {
+                const Short sample = Short(Math::clamp(std::round(value*32768.0f), -32768.0f, 32767.0f));
+                std::memcpy(out.data() + i*sizeof(Short), &sample, sizeof(Short));
+            } break;
+            case AudioSampleType::Float:
+                std::memcpy(out.data() + i*sizeof(Float), &value, sizeof(Float));
+                break;
+            case AudioSampleType::Double: {
+                const Double sample = value;
+                std::memcpy(out.data() + i*sizeof(Double), &sample, sizeof(Double));
+            } break;
+            default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+        }
+    }
+}
+
+/* Weights of each input channel in a stereo downmix, in the channel order
+   of the OpenAL formats. Center and surround channels are attenuated by
+   -3 dB, LFE is dropped. */
+inline void audioStereoDownmixWeights(const UnsignedInt channelCount, Float(*const weights)[2]) {
+    constexpr Float H = 0.7071068f;
+    constexpr Float Quad[][2]{{1.0f, 0.0f}, {0.0f, 1.0f}, {H, 0.0f}, {0.0f, H}};
+    constexpr Float Surround51[][2]{{1.0f, 0.0f}, {0.0f, 1.0f}, {H, H}, {0.0f, 0.0f}, {H, 0.0f}, {0.0f, H}};
+    constexpr Float Surround61[][2]{{1.0f, 0.0f}, {0.0f, 1.0f}, {H, H}, {0.0f, 0.0f}, {0.5f, 0.5f}, {H, 0.0f}, {0.0f, H}};
+    constexpr Float Surround71[][2]{{1.0f, 0.0f}, {0.0f, 1.0f}, {H, H}, {0.0f, 0.0f}, {H, 0.0f}, {0.0f, H}, {H, 0.0f}, {0.0f, H}};
+
+    const Float(*source)[2];
+    if(channelCount == 1) {
+        weights[0][0] = weights[0][1] = 1.0f;
+        return;
+    } else if(channelCount == 2) {
+        weights[0][0] = weights[1][1] = 1.0f;
+        weights[0][1] = weights[1][0] = 0.0f;
+        return;
+    } else if(channelCount == 4) source = Quad;
+    else if(channelCount == 6) source = Surround51;
+    else if(channelCount == 7) source = Surround61;
+    else if(channelCount == 8) source = Surround71;
+    else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+
+    for(UnsignedInt i = 0; i != channelCount; ++i) {
+        weights[i][0] = source[i][0];
+        weights[i][1] = source[i][1];
+    }
+}
+
+/* Mixes the planes to a different channel count by going through a stereo
+   downmix. A stereo source goes to front left and right of multi-channel
+   outputs, other channels stay silent. */
+inline void audioMixChannels(const Float* const in, const UnsignedInt inChannelCount, Float* const out, const UnsignedInt outChannelCount, const std::size_t frameCount) {
+    Float weights[8][2];
+    audioStereoDownmixWeights(inChannelCount, weights);
+
+    /* Matrix from the input channels to the output */
+    Float matrix[8][8]{};
+    for(UnsignedInt i = 0; i != inChannelCount; ++i) {
+        if(outChannelCount == 1)
+            matrix[0][i] = 0.5f*(weights[i][0] + weights[i][1]);
+        else {
+            matrix[0][i] = weights[i][0];
+            matrix[1][i] = weights[i][1];
+        }
+    }
+
+    for(UnsignedInt o = 0; o != outChannelCount; ++o) {
+        Float* const outPlane = out + o*frameCount;
+        std::fill_n(outPlane, frameCount, 0.0f);
+        for(UnsignedInt i = 0; i != inChannelCount; ++i) {
+            const Float weight = matrix[o][i];
+            if(weight == 0.0f) continue;
+            const Float* const inPlane = in + i*frameCount;
+            for(std::size_t j = 0; j != frameCount; ++j)
+                outPlane[j] += weight*inPlane[j];
+        }
+    }
+}
+
+/* Dot product of two float arrays, with the count being a multiple of 4 */
+inline Float audioDot(const Float* const a, const Float* const b, const std::size_t count) {
+    #ifdef __SSE2__
+    __m128 sum = _mm_setzero_ps();
+    for(std::size_t i = 0; i != count; i += 4)
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    __m128 shuffled = _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(2, 3, 0, 1));
+    sum = _mm_add_ps(sum, shuffled);
+    shuffled = _mm_movehl_ps(shuffled, sum);
+    return _mm_cvtss_f32(_mm_add_ss(sum, shuffled));
+    #elif defined(CORRADE_TARGET_ARM) && defined(__ARM_NEON)
+    float32x4_t sum = vdupq_n_f32(0.0f);
+    for(std::size_t i = 0; i != count; i += 4)
+        sum = vmlaq_f32(sum, vld1q_f32(a + i), vld1q_f32(b + i));
+    const float32x2_t half = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+    return vget_lane_f32(vpadd_f32(half, half), 0);
+    #else
+    Float sum[4]{};
+    for(std::size_t i = 0; i != count; i += 4) for(std::size_t j = 0; j != 4; ++j)
+        sum[j] += a[i + j]*b[i + j];
+    return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+    #endif
+}
+
+/* Polyphase windowed-sinc resampler. The ratio is reduced to up/down,
+   with one filter phase for each of the up positions between two input
+   samples. If there's too many phases, they're quantized to MaxPhaseCount,
+   which is well below audible jitter. */
+struct AudioResampler {
+    enum: UnsignedLong { MaxPhaseCount = 1024 };
+
+    explicit AudioResampler(const UnsignedInt from, const UnsignedInt to) {
+        UnsignedLong a = from, b = to;
+        while(b) { const UnsignedLong t = a % b; a = b; b = t; }
+        up = to/a;
+        down = from/a;
+        phaseCount = Math::min(up, UnsignedLong(MaxPhaseCount));
+
+        /* When downsampling, the cutoff has to go below the output Nyquist
+           frequency and the filter gets proportionally longer to keep the
+           same transition width. Tap count is a multiple of 4 for the dot
+           product. */
+        const Double ratio = Math::min(1.0, Double(up)/Double(down));
+        const Double cutoff = 0.95*ratio;
+        halfTapCount = Math::min(UnsignedInt(std::ceil(16.0/ratio/2.0))*2, 128u);
+        tapCount = halfTapCount*2;
+
+        coefficients = Containers::Array<Float>{Containers::NoInit, std::size_t(phaseCount*tapCount)};
+        const Double pi = 3.14159265358979323846;
+        for(UnsignedLong p = 0; p != phaseCount; ++p) {
+            Float* const phase = coefficients.data() + p*tapCount;
+            Double sum = 0.0;
+            for(UnsignedInt k = 0; k != tapCount; ++k) {
+                /* Distance of the input sample from the output position */
+                const Double x = Double(k) - Double(halfTapCount - 1) - Double(p)/Double(phaseCount);
+                const Double t = cutoff*x;
+                const Double sinc = t == 0.0 ? 1.0 : std::sin(pi*t)/(pi*t);
+                /* Blackman window over the whole filter length */
+                const Double w = x/Double(halfTapCount);
+                const Double window = std::abs(w) >= 1.0 ? 0.0 :
+                    0.42 + 0.5*std::cos(pi*w) + 0.08*std::cos(2.0*pi*w);
+                const Double value = sinc*window;
+                phase[k] = Float(value);
+                sum += value;
+            }
+
+            /* Normalize each phase to unit gain so there's no ripple on
+               constant signals */
+            for(UnsignedInt k = 0; k != tapCount; ++k)
+                phase[k] = Float(phase[k]/sum);
+        }
+    }
+
+    std::size_t outputFrameCount(const std::size_t inputFrameCount) const {
+        return inputFrameCount*up/down;
+    }
+
+    /* The input is expected to have halfTapCount zeros before and after the
+       inputFrameCount samples */
+    void operator()(const Float* const paddedIn, const std::size_t inputFrameCount, Float* const out) const {
+        for(std::size_t i = 0, count = outputFrameCount(inputFrameCount); i != count; ++i) {
+            const UnsignedLong position = UnsignedLong(i)*down;
+            const std::size_t base = position/up;
+            const std::size_t phase = (position % up)*phaseCount/up;
+            /* Input sample base - halfTapCount + 1 + k is at index base + 1 +
+               k in the padded input */
+            out[i] = audioDot(paddedIn + base + 1, coefficients.data() + phase*tapCount, tapCount);
+        }
+    }
+
+    UnsignedLong up, down, phaseCount;
+    UnsignedInt halfTapCount, tapCount;
+    Containers::Array<Float> coefficients;
+};
+
+/* Returns true if the frequency and channelCount options ask for any
+   conversion of samples in given format */
+inline bool audioConversionNeeded(const Utility::ConfigurationGroup& configuration, const BufferFormat format, const UnsignedInt frequency) {
+    AudioSampleType type;
+    UnsignedInt channelCount;
+    if(!audioFormatProperties(format, type, channelCount)) return false;
+
+    const UnsignedInt targetFrequency = configuration.value<UnsignedInt>("frequency");
+    const UnsignedInt targetChannelCount = configuration.value<UnsignedInt>("channelCount");
+    return (targetFrequency && targetFrequency != frequency) ||
+           (targetChannelCount && targetChannelCount != channelCount);
+}
+
+/* The conversion needs the whole file, so for streaming it's only possible
+   to warn that the options are ignored */
+inline void warnAudioConversionStreaming(const Utility::ConfigurationGroup& configuration, const char* const messagePrefix, const BufferFormat format, const UnsignedInt frequency) {
+    if(audioConversionNeeded(configuration, format, frequency))
+        Warning{} << messagePrefix << "frequency and channel count conversion is not supported for streaming, ignoring";
+}
+
+/* Converts the samples based on the frequency and channelCount options,
+   updating the format and frequency. Returns false and prints a message if
+   the options are invalid, does nothing if no conversion is needed. */
+inline bool convertAudio(const Utility::ConfigurationGroup& configuration, const char* const messagePrefix, BufferFormat& format, UnsignedInt& frequency, Containers::Array<char>& data) {
+    if(!audioConversionNeeded(configuration, format, frequency)) return true;
+
+    AudioSampleType type;
+    UnsignedInt channelCount;
+    CORRADE_INTERNAL_ASSERT_OUTPUT(audioFormatProperties(format, type, channelCount));
+
+    UnsignedInt targetFrequency = configuration.value<UnsignedInt>("frequency");
+    UnsignedInt targetChannelCount = configuration.value<UnsignedInt>("channelCount");
+    if(!targetFrequency) targetFrequency = frequency;
+    if(!targetChannelCount) targetChannelCount = channelCount;
+    if(targetChannelCount > 8 || targetChannelCount == 3 || targetChannelCount == 5) {
+        Error{} << messagePrefix << "unsupported target channel count" << targetChannelCount;
+        return false;
+    }
+
+    const std::size_t sampleSize = audioSampleSize(type);
+    const std::size_t frameCount = data.size()/(sampleSize*channelCount);
+
+    /* Mixing is done when there's the least channels -- before resampling
+       when going down, after when going up */
+    const bool resample = targetFrequency != frequency;
+    Containers::Optional<AudioResampler> resampler;
+    std::size_t padding = 0;
+    if(resample) {
+        resampler.emplace(frequency, targetFrequency);
+        padding = resampler->halfTapCount;
+    }
+    const UnsignedInt resampledChannelCount = Math::min(channelCount, targetChannelCount);
+
+    /* Planes of the input, padded for the resampler if needed */
+    const std::size_t paddedFrameCount = frameCount + 2*padding;
+    Containers::Array<Float> planar{Containers::ValueInit, std::size_t(Math::max(channelCount, targetChannelCount))*paddedFrameCount};
+    {
+        Containers::Array<Float> input{Containers::NoInit, channelCount*frameCount};
+        audioSamplesToPlanar(data, type, channelCount, frameCount, input);
+        if(targetChannelCount < channelCount) {
+            Containers::Array<Float> mixed{Containers::NoInit, targetChannelCount*frameCount};
+            audioMixChannels(input, channelCount, mixed, targetChannelCount, frameCount);
+            input = std::move(mixed);
+        }
+        for(UnsignedInt c = 0; c != resampledChannelCount; ++c)
+            std::memcpy(planar.data() + c*paddedFrameCount + padding, input.data() + c*frameCount, frameCount*sizeof(Float));
+    }
+
+    /* Resample each plane */
+    std::size_t outFrameCount = frameCount;
+    Containers::Array<Float> resampled;
+    if(resample) {
+        outFrameCount = resampler->outputFrameCount(frameCount);
+        resampled = Containers::Array<Float>{Containers::NoInit, resampledChannelCount*outFrameCount};
+        for(UnsignedInt c = 0; c != resampledChannelCount; ++c)
+            (*resampler)(planar.data() + c*paddedFrameCount, frameCount, resampled.data() + c*outFrameCount);
+    } else {
+        resampled = Containers::Array<Float>{Containers::NoInit, resampledChannelCount*outFrameCount};
+        for(UnsignedInt c = 0; c != resampledChannelCount; ++c)
+            std::memcpy(resampled.data() + c*outFrameCount, planar.data() + c*paddedFrameCount, outFrameCount*sizeof(Float));
+    }
+
+    if(targetChannelCount > channelCount) {
+        Containers::Array<Float> mixed{Containers::NoInit, targetChannelCount*outFrameCount};
+        audioMixChannels(resampled, channelCount, mixed, targetChannelCount, outFrameCount);
+        resampled = std::move(mixed);
+    }
+
+    /* Convert to the output format */
+    const BufferFormat outFormat = audioFormatFor(type, targetChannelCount);
+    Containers::Array<char> out{Containers::NoInit, outFrameCount*targetChannelCount*audioSampleSize(type)};
+    audioSamplesFromPlanar(resampled, type, targetChannelCount, outFrameCount, out);
+
+    data = std::move(out);
+    format = outFormat;
+    frequency = targetFrequency;
+    return true;
+}
+
+}}}
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef Magnum_Text_Implementation_glyphBatch_h
+#define Magnum_Text_Implementation_glyphBatch_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/* Writing glyphs of many laid out strings into a single vertex stream, shared
+   by the font plugins. Header-only as there's no common library the plugins
+   could link to. */
+
+#include <tuple>
+#include <vector>
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Range.h>
+
+namespace Magnum { namespace Text { namespace Implementation {
+
+/* Writes four vertices for each glyph of each layouter, in the same order as
+   Text::Renderer does, with the layouter glyphs positioned relative to the
+   corresponding origin. Layouter::glyph() is a non-virtual equivalent of
+   AbstractLayouter::renderGlyph(), so there's no virtual call per glyph.
+   Returns the total glyph count. If the views are smaller than four times
+   that, nothing is written. */
+template<class Layouter> std::size_t renderGlyphBatch(const std::vector<Containers::Pointer<Layouter>>& layouters, const Containers::ArrayView<const Vector2> origins, const Containers::StridedArrayView1D<Vector2>& positions, const Containers::StridedArrayView1D<Vector2>& textureCoordinates) {
+    std::size_t glyphCount = 0;
+    for(const Containers::Pointer<Layouter>& layouter: layouters)
+        glyphCount += layouter->glyphCount();
+    if(positions.size() < glyphCount*4 || textureCoordinates.size() < glyphCount*4)
+        return glyphCount;
+
+    std::size_t vertex = 0;
+    for(std::size_t i = 0; i != layouters.size(); ++i) {
+        Vector2 cursorPosition = origins[i];
+        for(UnsignedInt j = 0, jMax = layouters[i]->glyphCount(); j != jMax; ++j) {
+            Range2D quadPosition, quadTextureCoordinates;
+            Vector2 advance;
+            std::tie(quadPosition, quadTextureCoordinates, advance) = layouters[i]->glyph(j);
+            quadPosition = quadPosition.translated(cursorPosition);
+            cursorPosition += advance;
+
+            positions[vertex + 0] = quadPosition.topLeft();
+            positions[vertex + 1] = quadPosition.bottomLeft();
+            positions[vertex + 2] = quadPosition.topRight();
+            positions[vertex + 3] = quadPosition.bottomRight();
+            textureCoordinates[vertex + 0] = quadTextureCoordinates.topLeft();
+            textureCoordinates[vertex + 1] = quadTextureCoordinates.bottomLeft();
+            textureCoordinates[vertex + 2] = quadTextureCoordinates.topRight();
+            textureCoordinates[vertex + 3] = quadTextureCoordinates.bottomRight();
+            vertex += 4;
+        }
+    }
+
+    return glyphCount;
+}
+
+}}}
+
+#endif
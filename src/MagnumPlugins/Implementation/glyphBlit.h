@@ -0,0 +1,53 @@
+#ifndef Magnum_Text_Implementation_glyphBlit_h
+#define Magnum_Text_Implementation_glyphBlit_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/* Copying rendered glyph bitmaps into a glyph cache image, shared by the
+   FreeTypeFont and StbTrueTypeFont plugins. Header-only as there's no common
+   library the plugins could link to. */
+
+#include <cstddef>
+#include <cstring>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Vector2.h>
+
+namespace Magnum { namespace Text { namespace Implementation {
+
+/* Copies a glyph bitmap of given size, with rows going from top to bottom,
+   into an image with rows going from bottom to top. The pitches are offsets
+   to the next row in the source and in the destination and can be negative,
+   source points to the top row and destination to the bottom one. Each row is
+   a single memcpy(), which is vectorized by the standard library. */
+inline void blitGlyphFlipped(const unsigned char* const source, const std::ptrdiff_t sourcePitch, const Vector2i& size, char* const destination, const std::ptrdiff_t destinationPitch) {
+    if(!size.x()) return;
+    for(Int y = 0; y != size.y(); ++y)
+        std::memcpy(destination + (size.y() - y - 1)*destinationPitch,
+            source + y*sourcePitch, size.x());
+}
+
+}}}
+
+#endif
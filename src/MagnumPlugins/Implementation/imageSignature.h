@@ -0,0 +1,91 @@
+#ifndef Magnum_Trade_Implementation_imageSignature_h
+#define Magnum_Trade_Implementation_imageSignature_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/* Magic-byte signatures of image file formats, used by scene importers to
+   open embedded images with a concrete plugin right away instead of going
+   through AnyImageImporter. Looking at the first few bytes is enough for all
+   of them. Header-only as there's no common library the plugins could link
+   to. */
+
+#include <cstring>
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Magnum/Trade/AbstractImporter.h>
+
+namespace Magnum { namespace Trade { namespace Implementation {
+
+struct ImageSignature {
+    /* Plugin name or an alias, resolved by the plugin manager */
+    const char* plugin;
+    const char* signature;
+    std::size_t size;
+};
+
+constexpr ImageSignature ImageSignatures[]{
+    {"PngImporter", "\x89PNG\x0d\x0a\x1a\x0a", 8},
+    {"JpegImporter", "\xff\xd8\xff", 3},
+    {"DdsImporter", "DDS ", 4},
+    {"KtxImporter", "\xabKTX 11\xbb\x0d\x0a\x1a\x0a", 12},
+    {"KtxImporter", "\xabKTX 20\xbb\x0d\x0a\x1a\x0a", 12},
+    {"BasisImporter", "sB", 2},
+    {"GifImporter", "GIF87a", 6},
+    {"GifImporter", "GIF89a", 6},
+    /* Contains zeros, thus the explicit size everywhere */
+    {"IcoImporter", "\x00\x00\x01\x00", 4},
+    {"OpenExrImporter", "\x76\x2f\x31\x01", 4},
+    {"PsdImporter", "8BPS", 4},
+    {"HdrImporter", "#?RADIANCE", 10},
+    {"HdrImporter", "#?RGBE", 6},
+    {"TiffImporter", "II\x2a\x00", 4},
+    {"TiffImporter", "MM\x00\x2a", 4},
+    {"BmpImporter", "BM", 2}
+};
+
+/* Returns the plugin name for given file data or nullptr if the signature
+   isn't known */
+inline const char* imageImporterForData(const Containers::ArrayView<const char> data) {
+    for(const ImageSignature& signature: ImageSignatures)
+        if(data.size() >= signature.size && std::memcmp(data.data(), signature.signature, signature.size) == 0)
+            return signature.plugin;
+    return nullptr;
+}
+
+/* Instantiates the plugin matching the signature of given data. Returns
+   nullptr if the signature isn't known or if there's no plugin for it, in
+   which case it's up to the caller to fall back to AnyImageImporter, which
+   then also reports the error. */
+inline Containers::Pointer<AbstractImporter> imageImporterForData(PluginManager::Manager<AbstractImporter>& manager, const Containers::ArrayView<const char> data) {
+    const char* const plugin = imageImporterForData(data);
+    if(!plugin || manager.loadState(plugin) == PluginManager::LoadState::NotFound)
+        return nullptr;
+    return manager.loadAndInstantiate(plugin);
+}
+
+}}}
+
+#endif
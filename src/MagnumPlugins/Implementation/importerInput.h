@@ -0,0 +1,99 @@
+#ifndef Magnum_Trade_Implementation_importerInput_h
+#define Magnum_Trade_Implementation_importerInput_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/* Input data of an opened file, shared by importer plugins that decode
+   lazily and thus need to keep the input around until the file is closed.
+   Header-only as there's no common library the plugins could link to. */
+
+#include <string>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Debug.h>
+#include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/Directory.h>
+
+#if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+#define MAGNUM_IMPORTERINPUT_USE_MAP
+#endif
+
+namespace Magnum { namespace Trade { namespace Implementation {
+
+/* Either a copy of the data passed to openData(), a memory-mapped file
+   passed to openFile() or nothing if the data were passed to openMemory().
+   The decoding only ever looks at the `in` view, which points to one of
+   these or to the memory passed to openMemory(). Moving the struct doesn't
+   change the data pointer, so the view stays valid. */
+struct ImporterInput {
+    /* Memory-maps the file on platforms that support it and reads it
+       otherwise. If the file doesn't exist, prints a message prefixed with
+       `messagePrefix` and returns false. */
+    bool openFile(const std::string& filename, const char* messagePrefix) {
+        if(!Utility::Directory::exists(filename)) {
+            Utility::Error{} << messagePrefix << "cannot open file" << filename;
+            return false;
+        }
+
+        #ifdef MAGNUM_IMPORTERINPUT_USE_MAP
+        mappedData = Utility::Directory::mapRead(filename);
+        in = mappedData;
+        #else
+        data = Utility::Directory::read(filename);
+        in = data;
+        #endif
+        return true;
+    }
+
+    /* The data passed to openData() are guaranteed to be valid only during
+       the call, so keep a copy of them */
+    void openData(const Containers::ArrayView<const char> data_) {
+        data = Containers::Array<char>{Containers::NoInit, data_.size()};
+        Utility::copy(data_, data);
+        in = data;
+    }
+
+    void openMemory(const Containers::ArrayView<const char> data_) {
+        in = data_;
+    }
+
+    void close() {
+        in = nullptr;
+        data = nullptr;
+        #ifdef MAGNUM_IMPORTERINPUT_USE_MAP
+        mappedData = nullptr;
+        #endif
+    }
+
+    Containers::Array<char> data;
+    #ifdef MAGNUM_IMPORTERINPUT_USE_MAP
+    Containers::Array<const char, Utility::Directory::MapDeleter> mappedData;
+    #endif
+    Containers::ArrayView<const char> in;
+};
+
+}}}
+
+#endif
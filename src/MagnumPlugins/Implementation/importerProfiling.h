@@ -0,0 +1,90 @@
+#ifndef Magnum_Trade_Implementation_importerProfiling_h
+#define Magnum_Trade_Implementation_importerProfiling_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/* Per-stage timing reported by importer plugins to a callback set through
+   their setProfilingCallback(). Header-only as there's no common library the
+   plugins could link to. The plugin defines MAGNUM_IMPORTERPROFILING_ENABLED
+   before including this file if it's built with WITH_IMPORTER_PROFILING,
+   otherwise the macros expand to nothing and none of the arguments get
+   evaluated. */
+
+#include <cstddef>
+#include <Magnum/Types.h>
+
+#ifdef MAGNUM_IMPORTERPROFILING_ENABLED
+#include <chrono>
+#endif
+
+namespace Magnum { namespace Trade { namespace Implementation {
+
+typedef void(*ImporterProfilingCallback)(const char*, UnsignedLong, std::size_t, void*);
+
+#ifdef MAGNUM_IMPORTERPROFILING_ENABLED
+/* Measures the time from construction to destruction and passes it to the
+   callback, if there's any. The stage name is expected to be a string
+   literal. */
+class ImporterProfilingScope {
+    public:
+        explicit ImporterProfilingScope(ImporterProfilingCallback callback, void* userData, const char* stage, std::size_t byteCount): _callback{callback}, _userData{userData}, _stage{stage}, _byteCount{byteCount} {
+            if(_callback) _start = std::chrono::steady_clock::now();
+        }
+
+        ImporterProfilingScope(const ImporterProfilingScope&) = delete;
+        ImporterProfilingScope& operator=(const ImporterProfilingScope&) = delete;
+
+        ~ImporterProfilingScope() {
+            if(!_callback) return;
+            const std::chrono::steady_clock::duration duration = std::chrono::steady_clock::now() - _start;
+            _callback(_stage, std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(), _byteCount, _userData);
+        }
+
+        /* For stages where the amount of processed data is known only at
+           the end */
+        void setByteCount(std::size_t byteCount) { _byteCount = byteCount; }
+
+    private:
+        ImporterProfilingCallback _callback;
+        void* _userData;
+        const char* _stage;
+        std::size_t _byteCount;
+        std::chrono::steady_clock::time_point _start;
+};
+
+#define MAGNUM_IMPORTER_PROFILE(name, callback, userData, stage, byteCount) \
+    Magnum::Trade::Implementation::ImporterProfilingScope name{callback, userData, stage, byteCount}
+#define MAGNUM_IMPORTER_PROFILE_BYTES(name, byteCount) \
+    name.setByteCount(byteCount)
+#else
+#define MAGNUM_IMPORTER_PROFILE(name, callback, userData, stage, byteCount) \
+    do {} while(false)
+#define MAGNUM_IMPORTER_PROFILE_BYTES(name, byteCount) \
+    do {} while(false)
+#endif
+
+}}}
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef Magnum_Implementation_peakMemory_h
+#define Magnum_Implementation_peakMemory_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/* Peak memory measurement for the custom peakMemory() benchmarks of all
+   plugins, reporting the peak resident set size growth over the measured
+   region. Header-only as there's no common library the benchmarks could link
+   to. Works only on Linux, elsewhere it always reports zero. */
+
+#include <cstdint>
+#ifdef __linux__
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#endif
+
+namespace Magnum { namespace Implementation {
+
+#ifdef __linux__
+/* Value of given /proc/self/status field in bytes, the file lists them in kB */
+inline std::uint64_t processStatus(const char* const field) {
+    std::ifstream in{"/proc/self/status"};
+    const std::size_t fieldSize = std::strlen(field);
+    std::string line;
+    while(std::getline(in, line))
+        if(line.compare(0, fieldSize, field) == 0)
+            return std::strtoull(line.data() + fieldSize, nullptr, 10)*1024;
+    return 0;
+}
+#endif
+
+/* Resets the peak resident set size to the current one and returns the
+   current one. Supported since Linux 4.0, on older kernels the process-wide
+   peak gets reported. */
+inline std::uint64_t peakMemoryBegin() {
+    #ifdef __linux__
+    std::ofstream clearRefs{"/proc/self/clear_refs"};
+    clearRefs << "5";
+    clearRefs.close();
+    return processStatus("VmRSS:");
+    #else
+    return 0;
+    #endif
+}
+
+/* Peak resident set size growth since peakMemoryBegin() returned
+   `residentSizeBefore` */
+inline std::uint64_t peakMemoryEnd(const std::uint64_t residentSizeBefore) {
+    #ifdef __linux__
+    const std::uint64_t peak = processStatus("VmHWM:");
+    return peak > residentSizeBefore ? peak - residentSizeBefore : 0;
+    #else
+    static_cast<void>(residentSizeBefore);
+    return 0;
+    #endif
+}
+
+}}
+
+#endif
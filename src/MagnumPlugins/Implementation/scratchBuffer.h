@@ -0,0 +1,103 @@
+#ifndef Magnum_Implementation_scratchBuffer_h
+#define Magnum_Implementation_scratchBuffer_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/* Reusable scratch memory for temporaries that plugins need on every call,
+   such as glyph lists or pixel staging. The largest allocation is kept
+   around, so repeated operations of similar size don't allocate at all. The
+   memory comes either from new[] or from a user-supplied allocator and the
+   allocations are counted so it's possible to verify the steady state is
+   allocation-free. Header-only as there's no common library the plugins
+   could link to. */
+
+#include <cstddef>
+#include <Corrade/Containers/ArrayView.h>
+
+namespace Magnum { namespace Implementation {
+
+typedef void*(*ScratchAllocateCallback)(std::size_t, void*);
+typedef void(*ScratchDeallocateCallback)(void*, std::size_t, void*);
+
+class ScratchBuffer {
+    public:
+        explicit ScratchBuffer() = default;
+
+        ScratchBuffer(const ScratchBuffer&) = delete;
+        ScratchBuffer& operator=(const ScratchBuffer&) = delete;
+
+        ~ScratchBuffer() { release(); }
+
+        /* The allocator is expected to return memory suitably aligned for
+           any fundamental type, same as new[]. Passing null callbacks
+           switches back to new[]. Releases the current memory, as it was
+           allocated by the previous allocator. */
+        void setAllocator(ScratchAllocateCallback allocate, ScratchDeallocateCallback deallocate, void* userData) {
+            release();
+            _allocate = allocate;
+            _deallocate = deallocate;
+            _userData = userData;
+        }
+
+        /* View on count items of a trivial type T, valid until the next call.
+           Existing contents are not preserved when the buffer needs to
+           grow. */
+        template<class T> Containers::ArrayView<T> get(std::size_t count) {
+            const std::size_t size = count*sizeof(T);
+            if(size > _size) {
+                release();
+                _data = _allocate ? static_cast<char*>(_allocate(size, _userData)) : new char[size];
+                _size = size;
+                ++_allocationCount;
+                _allocatedBytes += size;
+            }
+            return {reinterpret_cast<T*>(_data), count};
+        }
+
+        std::size_t capacity() const { return _size; }
+        std::size_t allocationCount() const { return _allocationCount; }
+        std::size_t allocatedBytes() const { return _allocatedBytes; }
+
+        void release() {
+            if(!_data) return;
+            if(_deallocate) _deallocate(_data, _size, _userData);
+            else delete[] _data;
+            _data = nullptr;
+            _size = 0;
+        }
+
+    private:
+        ScratchAllocateCallback _allocate{};
+        ScratchDeallocateCallback _deallocate{};
+        void* _userData{};
+        char* _data{};
+        std::size_t _size{};
+        std::size_t _allocationCount{};
+        std::size_t _allocatedBytes{};
+};
+
+}}
+
+#endif
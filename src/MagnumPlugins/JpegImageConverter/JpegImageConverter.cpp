@@ -27,9 +27,12 @@
 
 #include <csetjmp>
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/DebugStl.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Functions.h>
 
 #ifdef CORRADE_TARGET_WINDOWS
 /* On Windows we need to circumvent conflicting definition of INT32 in
@@ -56,6 +59,9 @@ namespace Magnum { namespace Trade {
 JpegImageConverter::JpegImageConverter() {
     /** @todo horrible workaround, fix this properly */
     configuration().setValue("jpegQuality", 0.8f);
+    configuration().setValue("subsampling", "4:2:0");
+    configuration().setValue("dctMethod", "islow");
+    configuration().setValue("yFlip", true);
 }
 
 JpegImageConverter::JpegImageConverter(PluginManager::AbstractManager& manager, std::string plugin): AbstractImageConverter(manager, std::move(plugin)) {}
@@ -91,16 +97,44 @@ Containers::Array<char> JpegImageConverter::doExportToData(const ImageView2D& im
             return nullptr;
     }
 
+    /* Horizontal and vertical sampling factor of the luminance channel. The
+       chroma channels are always 1x1. */
+    const std::string subsampling = configuration().value("subsampling");
+    Vector2i lumaSampling;
+    if(subsampling == "4:4:4")
+        lumaSampling = {1, 1};
+    else if(subsampling == "4:2:2")
+        lumaSampling = {2, 1};
+    else if(subsampling == "4:2:0")
+        lumaSampling = {2, 2};
+    else {
+        Error{} << "Trade::JpegImageConverter::exportToData(): unsupported subsampling" << subsampling;
+        return nullptr;
+    }
+
+    const std::string dctMethodName = configuration().value("dctMethod");
+    J_DCT_METHOD dctMethod;
+    if(dctMethodName == "islow")
+        dctMethod = JDCT_ISLOW;
+    else if(dctMethodName == "ifast")
+        dctMethod = JDCT_IFAST;
+    else if(dctMethodName == "float")
+        dctMethod = JDCT_FLOAT;
+    else {
+        Error{} << "Trade::JpegImageConverter::exportToData(): unsupported DCT method" << dctMethodName;
+        return nullptr;
+    }
+
     /* Initialize structures. Needs to be before the setjmp crap in order to
        avoid leaks on error. */
     jpeg_compress_struct info;
     struct DestinationManager {
         jpeg_destination_mgr jpegDestinationManager;
-        std::string output;
+        Containers::Array<char> output;
+        std::size_t size;
     } destinationManager;
 
     Containers::Array<JSAMPROW> rows;
-    Containers::Array<char> data;
 
     /* Fugly error handling stuff */
     /** @todo Get rid of this crap */
@@ -124,21 +158,29 @@ Containers::Array<char> JpegImageConverter::doExportToData(const ImageView2D& im
     /* Create the compression structure */
     jpeg_create_compress(&info);
     info.dest = reinterpret_cast<jpeg_destination_mgr*>(&destinationManager);
+    /* Start with an eighth of the input size, which is enough for most
+       images at usual quality settings, to avoid most of the reallocations.
+       Can't be zero, otherwise it crashes. */
+    destinationManager.output = Containers::Array<char>{Containers::NoInit, Math::max(std::size_t(image.pixelSize())*image.size().product()/8, std::size_t{4096})};
+    destinationManager.size = 0;
     info.dest->init_destination = [](j_compress_ptr info) {
         auto& destinationManager = *reinterpret_cast<DestinationManager*>(info->dest);
-        destinationManager.output.resize(1); /* It crashes if the buffer has zero free space */
-        info->dest->next_output_byte = reinterpret_cast<JSAMPLE*>(&destinationManager.output[0]);
+        info->dest->next_output_byte = reinterpret_cast<JSAMPLE*>(destinationManager.output.data());
         info->dest->free_in_buffer = destinationManager.output.size()/sizeof(JSAMPLE);
     };
     info.dest->term_destination = [](j_compress_ptr info) {
         auto& destinationManager = *reinterpret_cast<DestinationManager*>(info->dest);
-        destinationManager.output.resize(destinationManager.output.size() - info->dest->free_in_buffer);
+        destinationManager.size = destinationManager.output.size() - info->dest->free_in_buffer;
     };
     info.dest->empty_output_buffer = [](j_compress_ptr info) -> boolean {
         auto& destinationManager = *reinterpret_cast<DestinationManager*>(info->dest);
+        /* Double capacity each time it is exceeded. The whole buffer is
+           always full when this gets called. */
         const std::size_t oldSize = destinationManager.output.size();
-        destinationManager.output.resize(oldSize*2); /* Double capacity each time it is exceeded */
-        info->dest->next_output_byte = reinterpret_cast<JSAMPLE*>(&destinationManager.output[0] + oldSize);
+        Containers::Array<char> output{Containers::NoInit, oldSize*2};
+        Utility::copy(destinationManager.output, output.prefix(oldSize));
+        destinationManager.output = std::move(output);
+        info->dest->next_output_byte = reinterpret_cast<JSAMPLE*>(destinationManager.output.data() + oldSize);
         info->dest->free_in_buffer = (destinationManager.output.size() - oldSize)/sizeof(JSAMPLE);
         return boolean(true);
     };
@@ -151,6 +193,16 @@ Containers::Array<char> JpegImageConverter::doExportToData(const ImageView2D& im
 
     jpeg_set_defaults(&info);
     jpeg_set_quality(&info, Int(configuration().value<Float>("jpegQuality")*100.0f), boolean(true));
+    info.dct_method = dctMethod;
+    info.optimize_coding = boolean(configuration().value<bool>("optimizeHuffman"));
+    if(colorSpace != JCS_GRAYSCALE) {
+        info.comp_info[0].h_samp_factor = lumaSampling.x();
+        info.comp_info[0].v_samp_factor = lumaSampling.y();
+        for(std::size_t i: {1, 2})
+            info.comp_info[i].h_samp_factor = info.comp_info[i].v_samp_factor = 1;
+    }
+    if(configuration().value<bool>("progressive"))
+        jpeg_simple_progression(&info);
     jpeg_start_compress(&info, boolean(true));
 
     /* Get data properties and calculate the initial slice based on subimage
@@ -158,20 +210,25 @@ Containers::Array<char> JpegImageConverter::doExportToData(const ImageView2D& im
     const std::pair<Math::Vector2<std::size_t>, Math::Vector2<std::size_t>> dataProperties = image.dataProperties();
     Containers::ArrayView<const char> inputData = image.data().suffix(dataProperties.first.sum());
 
-    while(info.next_scanline < info.image_height) {
-        /* libJPEG HAVE YOU EVER HEARD ABOUT CONST ARGUMENTS?! IT'S NOT 1978
-           ANYMORE */
-        JSAMPROW row = reinterpret_cast<JSAMPROW>(const_cast<char*>(inputData.suffix((image.size().y() - info.next_scanline - 1)*dataProperties.second.x()).data()));
-        jpeg_write_scanlines(&info, &row, 1);
-    }
+    /* Point libJPEG directly to the rows of the input in reverse order (or
+       in the original order if the flip is disabled) instead of repacking
+       the image. libJPEG HAVE YOU EVER HEARD ABOUT CONST ARGUMENTS?! IT'S NOT
+       1978 ANYMORE */
+    const bool yFlip = configuration().value<bool>("yFlip");
+    rows = Containers::Array<JSAMPROW>{Containers::NoInit, std::size_t(image.size().y())};
+    for(std::size_t i = 0; i != rows.size(); ++i)
+        rows[i] = reinterpret_cast<JSAMPROW>(const_cast<char*>(inputData.suffix((yFlip ? rows.size() - i - 1 : i)*dataProperties.second.x()).data()));
+
+    while(info.next_scanline < info.image_height)
+        jpeg_write_scanlines(&info, rows + info.next_scanline, info.image_height - info.next_scanline);
 
     jpeg_finish_compress(&info);
     jpeg_destroy_compress(&info);
 
-    /* Copy the string into the output array (I would kill for having std::string::release()) */
-    Containers::Array<char> fileData{destinationManager.output.size()};
-    std::copy(destinationManager.output.begin(), destinationManager.output.end(), fileData.data());
-    return fileData;
+    /* Return the output array without copying, as the default deleter
+       doesn't care about the size and deletes the whole allocation */
+    const std::size_t size = destinationManager.size;
+    return Containers::Array<char>{destinationManager.output.release(), size};
 }
 
 }}
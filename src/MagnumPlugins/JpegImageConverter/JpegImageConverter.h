@@ -119,6 +119,24 @@ implementations:
 -   [MozJPEG](https://github.com/mozilla/mozjpeg), optimized for quality/size
     ratio, though generally much slower than libjpeg-turbo
 
+@section Trade-JpegImageConverter-behavior Behavior and limitations
+
+RGB images are by default encoded with 4:2:0 chroma subsampling, the accurate
+integer DCT and default Huffman tables, which is what libJPEG does by default
+as well. For fastest encoding, for example for real-time previews, set the
+@cb{.ini} dctMethod @ce
+@ref Trade-JpegImageConverter-configuration "configuration option" to
+@cb{.ini} ifast @ce. For smallest files, enable @cb{.ini} optimizeHuffman @ce
+and @cb{.ini} progressive @ce, which both need extra passes over the data.
+Subsampling set to @cb{.ini} 4:4:4 @ce avoids color bleeding on sharp edges
+at the cost of larger files.
+
+Rows are passed to libJPEG bottom to top, matching the Y-up image origin used
+in Magnum. For top-down input, such as images imported by @ref JpegImporter
+with its @cb{.ini} yFlip @ce option disabled, set @cb{.ini} yFlip @ce to
+@cpp false @ce here as well. In both cases the rows are referenced directly,
+without any copy.
+
 @section Trade-JpegImageConverter-configuration Plugin-specific config
 
 It's possible to tune various output options through @ref configuration(). See
@@ -47,6 +47,30 @@
 
 namespace Magnum { namespace Trade { namespace Test { namespace {
 
+constexpr struct {
+    const char* name;
+    const char* subsampling;
+    char expected;
+} SubsamplingData[]{
+    {"4:4:4", "4:4:4", '\x11'},
+    {"4:2:2", "4:2:2", '\x21'},
+    {"4:2:0", "4:2:0", '\x22'}
+};
+
+constexpr struct {
+    const char* name;
+    const char* subsampling;
+    const char* dctMethod;
+    bool optimizeHuffman;
+    bool progressive;
+} OptionsData[]{
+    {"fast DCT", "4:2:0", "ifast", false, false},
+    {"float DCT", "4:2:0", "float", false, false},
+    {"optimized Huffman", "4:2:0", "islow", true, false},
+    {"4:4:4, optimized Huffman, progressive", "4:4:4", "islow", true, true},
+    {"4:2:2, fast DCT, progressive", "4:2:2", "ifast", false, true}
+};
+
 struct JpegImageConverterTest: TestSuite::Tester {
     explicit JpegImageConverterTest();
 
@@ -60,6 +84,13 @@ struct JpegImageConverterTest: TestSuite::Tester {
 
     void grayscale80Percent();
     void grayscale100Percent();
+    void grayscaleNoYFlip();
+
+    void subsampling();
+    void progressive();
+    void options();
+    void unsupportedSubsampling();
+    void unsupportedDctMethod();
 
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImageConverter> _converterManager{"nonexistent"};
@@ -76,7 +107,19 @@ JpegImageConverterTest::JpegImageConverterTest() {
               &JpegImageConverterTest::rgba80Percent,
 
               &JpegImageConverterTest::grayscale80Percent,
-              &JpegImageConverterTest::grayscale100Percent});
+              &JpegImageConverterTest::grayscale100Percent,
+              &JpegImageConverterTest::grayscaleNoYFlip});
+
+    addInstancedTests({&JpegImageConverterTest::subsampling},
+        Containers::arraySize(SubsamplingData));
+
+    addTests({&JpegImageConverterTest::progressive});
+
+    addInstancedTests({&JpegImageConverterTest::options},
+        Containers::arraySize(OptionsData));
+
+    addTests({&JpegImageConverterTest::unsupportedSubsampling,
+              &JpegImageConverterTest::unsupportedDctMethod});
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
@@ -377,6 +420,130 @@ void JpegImageConverterTest::grayscale100Percent() {
         (DebugTools::CompareImage{1.0f, 0.085f}));
 }
 
+void JpegImageConverterTest::grayscaleNoYFlip() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("JpegImageConverter");
+    converter->configuration().setValue("jpegQuality", 1.0f);
+    converter->configuration().setValue("yFlip", false);
+
+    const auto data = converter->exportToData(OriginalGrayscale);
+    CORRADE_VERIFY(data);
+
+    if(_importerManager.loadState("JpegImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("JpegImporter plugin not found, cannot test");
+
+    /* Not flipping on import either should give back the original. The 8x8
+       blocks are padded on the other side now, so the artifacts aren't the
+       same as in the flipped case, but still within the same threshold. */
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("JpegImporter");
+    importer->configuration().setValue("yFlip", false);
+    CORRADE_VERIFY(importer->openData(data));
+    Containers::Optional<Trade::ImageData2D> converted = importer->image2D(0);
+    CORRADE_VERIFY(converted);
+    CORRADE_COMPARE_WITH(*converted, OriginalGrayscale,
+        (DebugTools::CompareImage{1.0f, 0.085f}));
+}
+
+/* Returns the position of a marker following the 0xff byte, or 0 if not
+   found */
+std::size_t findMarker(Containers::ArrayView<const char> data, char marker) {
+    for(std::size_t i = 1; i < data.size(); ++i)
+        if(data[i - 1] == '\xff' && data[i] == marker) return i;
+    return 0;
+}
+
+void JpegImageConverterTest::subsampling() {
+    auto&& data = SubsamplingData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("JpegImageConverter");
+    converter->configuration().setValue("subsampling", data.subsampling);
+
+    const auto out = converter->exportToData(OriginalRgb);
+    CORRADE_VERIFY(out);
+
+    /* The baseline SOF0 marker is followed by a 2-byte length, precision,
+       2-byte height and width, component count and then the ID and sampling
+       factors for each component */
+    const std::size_t sof = findMarker(out, '\xc0');
+    CORRADE_VERIFY(sof);
+    CORRADE_VERIFY(sof + 15 < out.size());
+    CORRADE_COMPARE(out[sof + 8], 3);
+    CORRADE_COMPARE(out[sof + 10], data.expected);
+    CORRADE_COMPARE(out[sof + 13], '\x11');
+}
+
+void JpegImageConverterTest::progressive() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("JpegImageConverter");
+
+    /* Baseline by default */
+    {
+        const auto out = converter->exportToData(OriginalRgb);
+        CORRADE_VERIFY(out);
+        CORRADE_VERIFY(findMarker(out, '\xc0'));
+        CORRADE_VERIFY(!findMarker(out, '\xc2'));
+    }
+
+    /* With a progressive SOF2 marker if enabled */
+    converter->configuration().setValue("progressive", true);
+    {
+        const auto out = converter->exportToData(OriginalRgb);
+        CORRADE_VERIFY(out);
+        CORRADE_VERIFY(!findMarker(out, '\xc0'));
+        CORRADE_VERIFY(findMarker(out, '\xc2'));
+    }
+}
+
+void JpegImageConverterTest::options() {
+    auto&& data = OptionsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("JpegImageConverter");
+    converter->configuration().setValue("jpegQuality", 1.0f);
+    converter->configuration().setValue("subsampling", data.subsampling);
+    converter->configuration().setValue("dctMethod", data.dctMethod);
+    converter->configuration().setValue("optimizeHuffman", data.optimizeHuffman);
+    converter->configuration().setValue("progressive", data.progressive);
+
+    const auto out = converter->exportToData(OriginalRgb);
+    CORRADE_VERIFY(out);
+
+    if(_importerManager.loadState("JpegImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("JpegImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("JpegImporter");
+    CORRADE_VERIFY(importer->openData(out));
+    Containers::Optional<Trade::ImageData2D> converted = importer->image2D(0);
+    CORRADE_VERIFY(converted);
+    CORRADE_COMPARE(converted->size(), Vector2i(6, 4));
+    CORRADE_COMPARE(converted->format(), PixelFormat::RGB8Unorm);
+
+    /* The options affect mostly speed and size, not the quality, so expect
+       only a small difference. Thresholds are larger than in the
+       rgb100Percent() test to account for the less accurate DCT. */
+    CORRADE_COMPARE_WITH(*converted, OriginalRgb,
+        (DebugTools::CompareImage{8.0f, 3.0f}));
+}
+
+void JpegImageConverterTest::unsupportedSubsampling() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("JpegImageConverter");
+    converter->configuration().setValue("subsampling", "4:1:1");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->exportToData(OriginalRgb));
+    CORRADE_COMPARE(out.str(), "Trade::JpegImageConverter::exportToData(): unsupported subsampling 4:1:1\n");
+}
+
+void JpegImageConverterTest::unsupportedDctMethod() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("JpegImageConverter");
+    converter->configuration().setValue("dctMethod", "fastest");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->exportToData(OriginalRgb));
+    CORRADE_COMPARE(out.str(), "Trade::JpegImageConverter::exportToData(): unsupported DCT method fastest\n");
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::JpegImageConverterTest)
@@ -25,12 +25,21 @@
 
 #include "JpegImporter.h"
 
+#include <cstring>
 #include <csetjmp>
+#include <thread>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
+#include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/ConfigurationValue.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "MagnumPlugins/Implementation/importerInput.h"
+
 #ifdef CORRADE_TARGET_WINDOWS
 /* On Windows we need to circumvent conflicting definition of INT32 in
    <windows.h> (included from OpenGL headers). Problem with libjpeg-tubo only,
@@ -53,113 +62,526 @@
 
 namespace Magnum { namespace Trade {
 
-JpegImporter::JpegImporter() = default;
+struct JpegImporter::State: Implementation::ImporterInput {};
 
-JpegImporter::JpegImporter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImporter{manager, plugin} {}
+namespace {
 
-JpegImporter::~JpegImporter() = default;
+/* Rows aligned to four bytes, matching the layout returned by image2D() */
+std::size_t defaultRowPitch(const JpegImporterImageInfo& info) {
+    return ((info.size.x()*pixelSize(info.format) + 3)/4)*4;
+}
 
-ImporterFeatures JpegImporter::doFeatures() const { return ImporterFeature::OpenData; }
+/* Fugly error handling stuff */
+/** @todo Get rid of this crap */
+struct ErrorManager {
+    jpeg_error_mgr jpegErrorManager;
+    std::jmp_buf setjmpBuffer;
+    char message[JMSG_LENGTH_MAX]{};
+};
+
+void errorExit(j_common_ptr info) {
+    auto& errorManager = *reinterpret_cast<ErrorManager*>(info->err);
+    info->err->format_message(info, errorManager.message);
+    std::longjmp(errorManager.setjmpBuffer, 1);
+}
 
-bool JpegImporter::doIsOpened() const { return _in; }
+/* Expands a decoded row to four channels in-place, going from the back to not
+   overwrite what's not processed yet */
+void expandRow(unsigned char* const row, const std::size_t width, const UnsignedInt expandFrom) {
+    for(std::size_t x = width; x != 0; --x) {
+        const unsigned char* const src = row + (x - 1)*expandFrom;
+        unsigned char* const dst = row + (x - 1)*4;
+        const unsigned char r = src[0];
+        const unsigned char g = expandFrom == 3 ? src[1] : r;
+        const unsigned char b = expandFrom == 3 ? src[2] : r;
+        dst[0] = r;
+        dst[1] = g;
+        dst[2] = b;
+        dst[3] = 0xff;
+    }
+}
 
-void JpegImporter::doClose() { _in = nullptr; }
+/* Header and entropy-coded data of a sequential JPEG with a single scan,
+   split at restart markers */
+struct RestartIntervals {
+    /* Everything from the start of the file until the end of the SOS
+       segment */
+    Containers::ArrayView<const char> header;
+    /* Offset of the big-endian image height in the SOF segment */
+    std::size_t heightOffset;
+    /* Entropy-coded data of each interval, without the markers */
+    Containers::Array<Containers::ArrayView<const char>> intervals;
+};
+
+/* Returns false if the file isn't a single-scan Huffman-coded sequential
+   JPEG or if the restart markers aren't in order. Such files are left for the
+   sequential decoder, which also takes care of reporting errors. */
+bool findRestartIntervals(const Containers::ArrayView<const char> in, RestartIntervals& out) {
+    const auto* const data = reinterpret_cast<const unsigned char*>(in.data());
+    const std::size_t size = in.size();
+    if(size < 4 || data[0] != 0xff || data[1] != 0xd8) return false;
+
+    /* Walk the marker segments until the start of scan */
+    std::size_t i = 2;
+    bool foundFrame = false;
+    for(;;) {
+        if(i + 4 > size || data[i] != 0xff) return false;
+        const unsigned char marker = data[i + 1];
+
+        /* Fill bytes before a marker */
+        if(marker == 0xff) {
+            ++i;
+            continue;
+        }
+
+        const std::size_t length = data[i + 2] << 8 | data[i + 3];
+        if(length < 2 || i + 2 + length > size) return false;
+
+        /* Baseline and extended sequential Huffman-coded frame. Everything
+           else in the SOF range except DHT, JPG and DAC is progressive,
+           lossless or arithmetic-coded. */
+        if(marker == 0xc0 || marker == 0xc1) {
+            if(length < 8) return false;
+            foundFrame = true;
+            out.heightOffset = i + 5;
+        } else if(marker >= 0xc2 && marker <= 0xcf && marker != 0xc4 && marker != 0xc8 && marker != 0xcc)
+            return false;
+
+        i += 2 + length;
+        if(marker == 0xda) break;
+    }
+    if(!foundFrame) return false;
+    out.header = in.prefix(i);
+
+    /* Split the entropy-coded data at RST markers. A 0xff byte inside the
+       data is followed by a zero byte, consecutive 0xff bytes are fill. EOI
+       ends the scan, any other marker (a next scan, DNL) isn't supported. */
+    std::size_t begin = i;
+    UnsignedInt expected = 0;
+    while(i < size) {
+        const void* const found = std::memchr(data + i, 0xff, size - i);
+        if(!found) return false;
+        i = static_cast<const unsigned char*>(found) - data;
+        if(i + 1 >= size) return false;
+
+        const unsigned char marker = data[i + 1];
+        if(marker == 0x00) {
+            i += 2;
+            continue;
+        }
+        if(marker == 0xff) {
+            ++i;
+            continue;
+        }
+
+        if(marker >= 0xd0 && marker <= 0xd7) {
+            if(marker != 0xd0 + expected) return false;
+            expected = (expected + 1) & 7;
+            arrayAppend(out.intervals, in.slice(begin, i));
+            i += 2;
+            begin = i;
+            continue;
+        }
+
+        if(marker != 0xd9) return false;
+        arrayAppend(out.intervals, in.slice(begin, i));
+        return true;
+    }
 
-void JpegImporter::doOpenData(const Containers::ArrayView<const char> data) {
-    /* Because here we're copying the data and using the _in to check if file
-       is opened, having them nullptr would mean openData() would fail without
-       any error message. It's not possible to do this check on the importer
-       side, because empty file is valid in some formats (OBJ or glTF). We also
-       can't do the full import here because then doImage2D() would need to
-       copy the imported data instead anyway (and the uncompressed size is much
-       larger). This way it'll also work nicely with a future openMemory(). */
-    if(data.empty()) {
-        Error{} << "Trade::JpegImporter::openData(): the file is empty";
-        return;
+    return false;
+}
+
+/* A standalone JPEG containing a band of whole MCU rows */
+struct RestartBand {
+    Containers::Array<char> data;
+    /* First output row and output row count, counting from the top */
+    std::size_t firstRow;
+    std::size_t rowCount;
+    char message[JMSG_LENGTH_MAX];
+    bool failed;
+};
+
+/* Decodes a band into its part of the output with the same parameters as
+   `reference`, Y-flipped if `yFlip` is set */
+bool decodeBand(RestartBand& band, const jpeg_decompress_struct& reference, const UnsignedInt expandFrom, const JpegImporterImageInfo& info, const Containers::ArrayView<char> out, const std::size_t rowPitch, const bool yFlip) {
+    jpeg_decompress_struct file;
+    ErrorManager errorManager;
+    file.err = jpeg_std_error(&errorManager.jpegErrorManager);
+    errorManager.jpegErrorManager.error_exit = errorExit;
+    if(setjmp(errorManager.setjmpBuffer)) {
+        std::memcpy(band.message, errorManager.message, JMSG_LENGTH_MAX);
+        jpeg_destroy_decompress(&file);
+        return false;
+    }
+
+    jpeg_create_decompress(&file);
+    jpeg_mem_src(&file, reinterpret_cast<unsigned char*>(band.data.data()), band.data.size());
+    jpeg_read_header(&file, boolean(true));
+    file.scale_num = reference.scale_num;
+    file.scale_denom = reference.scale_denom;
+    file.out_color_space = reference.out_color_space;
+    /* Interpolating the subsampled channels would need rows from the
+       neighboring bands, upsample by replication instead so the bands match
+       at their edges */
+    file.do_fancy_upsampling = boolean(false);
+    jpeg_start_decompress(&file);
+    CORRADE_INTERNAL_ASSERT(file.output_width == JDIMENSION(info.size.x()) && file.output_height == band.rowCount);
+
+    while(file.output_scanline < file.output_height) {
+        const std::size_t y = band.firstRow + file.output_scanline;
+        unsigned char* const row = reinterpret_cast<unsigned char*>(out.data() + (yFlip ? info.size.y() - y - 1 : y)*rowPitch);
+        JSAMPROW rowPointer = row;
+        jpeg_read_scanlines(&file, &rowPointer, 1);
+        if(expandFrom) expandRow(row, info.size.x(), expandFrom);
     }
 
-    _in = Containers::Array<unsigned char>(data.size());
-    std::copy(data.begin(), data.end(), _in.begin());
+    jpeg_finish_decompress(&file);
+    jpeg_destroy_decompress(&file);
+    return true;
 }
 
-UnsignedInt JpegImporter::doImage2DCount() const { return 1; }
+/* Sequential JPEGs with a single interleaved scan and restart markers can be
+   split at the markers into bands of whole MCU rows, as the DC prediction is
+   reset at each of them. Each band is made into a standalone JPEG with the
+   original header and a patched height and decoded on its own thread. Returns
+   false if the file isn't suitable for that, in which case it should be
+   decoded sequentially. Decoding errors are printed with `messagePrefix` and
+   reported through `failed`. */
+bool decodeRestartIntervals(const Containers::ArrayView<const char> in, const jpeg_decompress_struct& file, UnsignedInt threadCount, const UnsignedInt expandFrom, const JpegImporterImageInfo& info, const Containers::ArrayView<char> out, const std::size_t rowPitch, const bool yFlip, const char* const messagePrefix, bool& failed) {
+    if(threadCount == 1 || !file.restart_interval || file.progressive_mode || file.arith_code || file.comps_in_scan != file.num_components)
+        return false;
+
+    RestartIntervals intervals;
+    if(!findRestartIntervals(in, intervals)) return false;
+
+    /* A non-interleaved scan of a grayscale image has MCUs of a single
+       block, otherwise they span the maximal sampling factors. If the marker
+       count doesn't match the MCU count, the file is corrupted and it's left
+       for the sequential decoder to deal with it. */
+    const std::size_t mcuWidth = file.comps_in_scan == 1 ? DCTSIZE : file.max_h_samp_factor*DCTSIZE;
+    const std::size_t mcuHeight = file.comps_in_scan == 1 ? DCTSIZE : file.max_v_samp_factor*DCTSIZE;
+    const std::size_t mcusPerRow = (file.image_width + mcuWidth - 1)/mcuWidth;
+    const std::size_t mcuRows = (file.image_height + mcuHeight - 1)/mcuHeight;
+    const std::size_t restartInterval = file.restart_interval;
+    if(intervals.intervals.size() != (mcusPerRow*mcuRows + restartInterval - 1)/restartInterval)
+        return false;
+
+    /* Bands can start only at MCU rows that start an interval as well, which
+       is every restartInterval/gcd(restartInterval, mcusPerRow) rows */
+    std::size_t gcd = restartInterval, b = mcusPerRow;
+    while(b) {
+        const std::size_t t = gcd % b;
+        gcd = b;
+        b = t;
+    }
+    const std::size_t rowStep = restartInterval/gcd;
+    const std::size_t stepCount = (mcuRows + rowStep - 1)/rowStep;
+    if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+    const std::size_t bandCount = Math::min(std::size_t{threadCount}, stepCount);
+    if(bandCount < 2) return false;
+
+    /* Assemble the bands. Each is a copy of the header with the image height
+       patched, followed by its intervals with the markers renumbered from
+       zero and EOI. The output size is a multiple of the MCU size except for
+       the last band, since the scale is at most the MCU size. */
+    Containers::Array<RestartBand> bands{Containers::ValueInit, bandCount};
+    for(std::size_t i = 0; i != bandCount; ++i) {
+        RestartBand& band = bands[i];
+        const std::size_t firstMcuRow = stepCount*i/bandCount*rowStep;
+        const std::size_t endMcuRow = Math::min(stepCount*(i + 1)/bandCount*rowStep, mcuRows);
+        const std::size_t firstInterval = firstMcuRow*mcusPerRow/restartInterval;
+        const std::size_t endInterval = i + 1 == bandCount ? intervals.intervals.size() : endMcuRow*mcusPerRow/restartInterval;
+        const std::size_t height = Math::min(endMcuRow*mcuHeight, std::size_t(file.image_height)) - firstMcuRow*mcuHeight;
+        band.firstRow = firstMcuRow*mcuHeight/file.scale_denom;
+        band.rowCount = (height + file.scale_denom - 1)/file.scale_denom;
+
+        std::size_t size = intervals.header.size();
+        for(std::size_t j = firstInterval; j != endInterval; ++j)
+            size += intervals.intervals[j].size() + 2;
+        band.data = Containers::Array<char>{Containers::NoInit, size};
+
+        char* dst = band.data;
+        std::memcpy(dst, intervals.header.data(), intervals.header.size());
+        dst[intervals.heightOffset] = char(height >> 8);
+        dst[intervals.heightOffset + 1] = char(height & 0xff);
+        dst += intervals.header.size();
+        for(std::size_t j = firstInterval; j != endInterval; ++j) {
+            if(j != firstInterval) {
+                *dst++ = '\xff';
+                *dst++ = char(0xd0 + ((j - firstInterval - 1) & 7));
+            }
+            std::memcpy(dst, intervals.intervals[j].data(), intervals.intervals[j].size());
+            dst += intervals.intervals[j].size();
+        }
+        *dst++ = '\xff';
+        *dst++ = '\xd9';
+        CORRADE_INTERNAL_ASSERT(dst == band.data.end());
+    }
 
-Containers::Optional<ImageData2D> JpegImporter::doImage2D(UnsignedInt, UnsignedInt) {
+    /* Each band is decoded into a disjoint part of the output and has its own
+       libJPEG state. Messages from the other threads wouldn't go through
+       output redirection set up on the calling thread, so they're printed
+       after. */
+    Containers::Array<std::thread> threads{bandCount - 1};
+    for(std::size_t i = 0; i != threads.size(); ++i) threads[i] = std::thread{[&, i]() {
+        bands[i + 1].failed = !decodeBand(bands[i + 1], file, expandFrom, info, out, rowPitch, yFlip);
+    }};
+    bands[0].failed = !decodeBand(bands[0], file, expandFrom, info, out, rowPitch, yFlip);
+    for(std::thread& thread: threads) thread.join();
+
+    for(const RestartBand& band: bands) if(band.failed) {
+        Error() << messagePrefix << "error:" << band.message;
+        failed = true;
+        break;
+    }
+
+    return true;
+}
+
+/* Decodes the image into memory returned by `destination`, which gets called
+   after the header is parsed. If it sets `out` to nullptr, only the header is
+   parsed. If it returns false, the decoding is aborted. If `threadCount` is
+   not 1, files with restart markers are decoded on multiple threads. If
+   `yFlip` is set, the rows are written bottom-up. */
+template<class F> bool decode(const Containers::ArrayView<const char> in, const UnsignedInt scale, const Vector2i& minimumSize, const bool rgba, const UnsignedInt threadCount, const bool yFlip, const char* const messagePrefix, F&& destination) {
     /* Initialize structures */
     jpeg_decompress_struct file;
-    Containers::Array<char> data;
-
-    /* Fugly error handling stuff */
-    /** @todo Get rid of this crap */
-    struct ErrorManager {
-        jpeg_error_mgr jpegErrorManager;
-        std::jmp_buf setjmpBuffer;
-        char message[JMSG_LENGTH_MAX]{};
-    } errorManager;
+    ErrorManager errorManager;
     file.err = jpeg_std_error(&errorManager.jpegErrorManager);
-    errorManager.jpegErrorManager.error_exit = [](j_common_ptr info) {
-        auto& errorManager = *reinterpret_cast<ErrorManager*>(info->err);
-        info->err->format_message(info, errorManager.message);
-        std::longjmp(errorManager.setjmpBuffer, 1);
-    };
+    errorManager.jpegErrorManager.error_exit = errorExit;
     if(setjmp(errorManager.setjmpBuffer)) {
-        Error() << "Trade::JpegImporter::image2D(): error:" << errorManager.message;
+        Error() << messagePrefix << "error:" << errorManager.message;
         jpeg_destroy_decompress(&file);
-        return Containers::NullOpt;
+        return false;
     }
 
-    /* Open file */
+    /* Open file. Older libJPEG versions take a non-const pointer. */
     jpeg_create_decompress(&file);
-    jpeg_mem_src(&file, _in.begin(), _in.size());
+    jpeg_mem_src(&file, const_cast<unsigned char*>(reinterpret_cast<const unsigned char*>(in.data())), in.size());
 
     /* Read file header, start decompression. On macOS (Travis, with Xcode 7.3)
        the compilation fails because "no known conversion from 'bool' to
        'boolean' for 2nd argument" (boolean is an enum instead of a typedef to
        int there) so doing the conversion implicitly. */
     jpeg_read_header(&file, boolean(true));
-    jpeg_start_decompress(&file);
 
-    /* Image size and type */
-    const Vector2i size(file.output_width, file.output_height);
+    /* Downscale in the DCT domain. If minimum size is set, pick the largest
+       factor that still satisfies it, libJPEG rounds the size up. */
+    file.scale_num = 1;
+    if(!minimumSize.isZero()) {
+        file.scale_denom = 1;
+        for(JDIMENSION denom: {8, 4, 2}) {
+            if(Int((file.image_width + denom - 1)/denom) >= minimumSize.x() &&
+               Int((file.image_height + denom - 1)/denom) >= minimumSize.y()) {
+                file.scale_denom = denom;
+                break;
+            }
+        }
+    } else file.scale_denom = scale;
+
+    /* With libjpeg-turbo the four-channel output is done directly by the
+       color converter, otherwise the rows get expanded after decoding */
+    #ifdef JCS_EXTENSIONS
+    if(rgba && (file.out_color_space == JCS_RGB || file.out_color_space == JCS_GRAYSCALE))
+        file.out_color_space = JCS_EXT_RGBA;
+    #endif
+
+    /* Calculate output size and components without starting the
+       decompression, so the destination can fail without any decoding work
+       done */
+    jpeg_calc_output_dimensions(&file);
+
     static_assert(BITS_IN_JSAMPLE == 8, "Only 8-bit JPEG is supported");
 
     /* Image format */
-    PixelFormat format;
+    JpegImporterImageInfo info;
+    info.size = {Int(file.output_width), Int(file.output_height)};
+    UnsignedInt expandFrom = 0;
     switch(file.out_color_space) {
         case JCS_GRAYSCALE:
             CORRADE_INTERNAL_ASSERT(file.out_color_components == 1);
-            format = PixelFormat::R8Unorm;
+            info.format = rgba ? PixelFormat::RGBA8Unorm : PixelFormat::R8Unorm;
+            if(rgba) expandFrom = 1;
             break;
         case JCS_RGB:
             CORRADE_INTERNAL_ASSERT(file.out_color_components == 3);
-            format = PixelFormat::RGB8Unorm;
+            info.format = rgba ? PixelFormat::RGBA8Unorm : PixelFormat::RGB8Unorm;
+            if(rgba) expandFrom = 3;
             break;
-
-        /** @todo RGBA (only in libjpeg-turbo and probably ignored) */
+        #ifdef JCS_EXTENSIONS
+        case JCS_EXT_RGBA:
+            CORRADE_INTERNAL_ASSERT(file.out_color_components == 4);
+            info.format = PixelFormat::RGBA8Unorm;
+            break;
+        #endif
 
         default:
-            Error() << "Trade::JpegImporter::image2D(): unsupported color space" << file.out_color_space;
-            return Containers::NullOpt;
+            Error() << messagePrefix << "unsupported color space" << file.out_color_space;
+            jpeg_destroy_decompress(&file);
+            return false;
+    }
+
+    Containers::ArrayView<char> out;
+    std::size_t rowPitch{};
+    if(!destination(info, out, rowPitch)) {
+        jpeg_destroy_decompress(&file);
+        return false;
+    }
+    if(!out) {
+        jpeg_destroy_decompress(&file);
+        return true;
     }
 
-    /* Initialize data array, align rows to four bytes */
-    const std::size_t stride = ((size.x()*file.out_color_components*BITS_IN_JSAMPLE/8 + 3)/4)*4;
-    data = Containers::Array<char>{stride*std::size_t(size.y())};
+    bool failed = false;
+    if(decodeRestartIntervals(in, file, threadCount, expandFrom, info, out, rowPitch, yFlip, messagePrefix, failed)) {
+        jpeg_destroy_decompress(&file);
+        return !failed;
+    }
+
+    jpeg_start_decompress(&file);
 
-    /* Read image row by row */
+    /* Read image row by row, bottom up unless the Y-flip is disabled */
     while(file.output_scanline < file.output_height) {
-        JSAMPROW row = reinterpret_cast<JSAMPROW>(data.data() + (size.y() - file.output_scanline - 1)*stride);
-        jpeg_read_scanlines(&file, &row, 1);
+        const std::size_t y = file.output_scanline;
+        unsigned char* const row = reinterpret_cast<unsigned char*>(out.data() + (yFlip ? info.size.y() - y - 1 : y)*rowPitch);
+        JSAMPROW rowPointer = row;
+        jpeg_read_scanlines(&file, &rowPointer, 1);
+        if(expandFrom) expandRow(row, info.size.x(), expandFrom);
     }
 
     /* Cleanup */
     jpeg_finish_decompress(&file);
     jpeg_destroy_decompress(&file);
+    return true;
+}
+
+}
+
+JpegImporter::JpegImporter(): _state{new State} {
+    /** @todo horrible workaround, fix this properly */
+    configuration().setValue("yFlip", true);
+}
+
+JpegImporter::JpegImporter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImporter{manager, plugin}, _state{new State} {}
+
+JpegImporter::~JpegImporter() = default;
+
+ImporterFeatures JpegImporter::doFeatures() const { return ImporterFeature::OpenData; }
+
+bool JpegImporter::doIsOpened() const { return !!_state->in; }
+
+void JpegImporter::doClose() { _state->close(); }
+
+bool JpegImporter::checkData(const Containers::ArrayView<const char> data, const char* const messagePrefix) {
+    /* Because here we're using the `in` view to check if file is opened,
+       having it nullptr would mean openData() would fail without any error
+       message. It's not possible to do this check on the importer side,
+       because empty file is valid in some formats (OBJ or glTF). We also
+       can't do the full import here because then doImage2D() would need to
+       copy the imported data instead anyway (and the uncompressed size is
+       much larger). */
+    if(data.empty()) {
+        Error{} << messagePrefix << "the file is empty";
+        return false;
+    }
+
+    return true;
+}
+
+void JpegImporter::doOpenFile(const std::string& filename) {
+    /* Map the file instead of reading it to avoid having the whole file
+       copied in memory */
+    if(!_state->openFile(filename, "Trade::JpegImporter::openFile():")) return;
+    if(!checkData(_state->in, "Trade::JpegImporter::openFile():"))
+        _state->close();
+}
+
+void JpegImporter::doOpenData(const Containers::ArrayView<const char> data) {
+    if(!checkData(data, "Trade::JpegImporter::openData():")) return;
+    _state->openData(data);
+}
+
+bool JpegImporter::openMemory(const Containers::ArrayView<const char> data) {
+    close();
+    if(!checkData(data, "Trade::JpegImporter::openMemory():")) return false;
+    _state->openMemory(data);
+    return true;
+}
+
+UnsignedInt JpegImporter::doImage2DCount() const { return 1; }
+
+bool JpegImporter::checkScale(const char* const messagePrefix) {
+    const UnsignedInt scale = configuration().value<UnsignedInt>("scale");
+    if(scale != 1 && scale != 2 && scale != 4 && scale != 8) {
+        Error{} << messagePrefix << "expected scale to be 1, 2, 4 or 8 but got" << scale;
+        return false;
+    }
+
+    return true;
+}
+
+Containers::Optional<ImageData2D> JpegImporter::doImage2D(UnsignedInt, UnsignedInt) {
+    if(!checkScale("Trade::JpegImporter::image2D():"))
+        return Containers::NullOpt;
+
+    Containers::Array<char> data;
+    PixelFormat format{};
+    Vector2i size;
+    if(!decode(_state->in, configuration().value<UnsignedInt>("scale"), configuration().value<Vector2i>("minimumSize"), configuration().value<bool>("rgba"), configuration().value<UnsignedInt>("threads"), configuration().value<bool>("yFlip"), "Trade::JpegImporter::image2D():", [&](const JpegImporterImageInfo& info, Containers::ArrayView<char>& out, std::size_t& rowPitch) {
+        format = info.format;
+        size = info.size;
+        rowPitch = defaultRowPitch(info);
+        data = Containers::Array<char>{Containers::NoInit, rowPitch*std::size_t(info.size.y())};
+        out = data;
+        return true;
+    })) return Containers::NullOpt;
 
     /* Always using the default 4-byte alignment */
     return Trade::ImageData2D{format, size, std::move(data)};
 }
 
+Containers::Optional<JpegImporterImageInfo> JpegImporter::image2DInfo() {
+    CORRADE_ASSERT(isOpened(), "Trade::JpegImporter::image2DInfo(): no file opened", {});
+
+    if(!checkScale("Trade::JpegImporter::image2DInfo():"))
+        return Containers::NullOpt;
+
+    Containers::Optional<JpegImporterImageInfo> out;
+    if(!decode(_state->in, configuration().value<UnsignedInt>("scale"), configuration().value<Vector2i>("minimumSize"), configuration().value<bool>("rgba"), 1, true, "Trade::JpegImporter::image2DInfo():", [&](const JpegImporterImageInfo& info, Containers::ArrayView<char>&, std::size_t&) {
+        out = info;
+        return true;
+    })) return Containers::NullOpt;
+
+    return out;
+}
+
+bool JpegImporter::image2DInto(const Containers::ArrayView<char> destination, const std::size_t rowPitch) {
+    CORRADE_ASSERT(isOpened(), "Trade::JpegImporter::image2DInto(): no file opened", {});
+
+    if(!checkScale("Trade::JpegImporter::image2DInto():"))
+        return false;
+
+    return decode(_state->in, configuration().value<UnsignedInt>("scale"), configuration().value<Vector2i>("minimumSize"), configuration().value<bool>("rgba"), configuration().value<UnsignedInt>("threads"), configuration().value<bool>("yFlip"), "Trade::JpegImporter::image2DInto():", [&](const JpegImporterImageInfo& info, Containers::ArrayView<char>& out, std::size_t& actualRowPitch) {
+        /* The decoder writes whole scanlines in the libJPEG output format
+           before expanding them, which is never wider than the final format,
+           so the tight row size is enough */
+        const std::size_t tightRowPitch = info.size.x()*pixelSize(info.format);
+        actualRowPitch = rowPitch ? rowPitch : defaultRowPitch(info);
+        if(actualRowPitch < tightRowPitch) {
+            Error{} << "Trade::JpegImporter::image2DInto(): row pitch" << actualRowPitch << "is smaller than" << tightRowPitch;
+            return false;
+        }
+        const std::size_t size = actualRowPitch*info.size.y();
+        if(destination.size() < size) {
+            Error{} << "Trade::JpegImporter::image2DInto(): expected a destination of at least" << size << "bytes but got" << destination.size();
+            return false;
+        }
+
+        out = destination.prefix(size);
+        return true;
+    });
+}
+
 }}
 
 CORRADE_PLUGIN_REGISTER(JpegImporter, Magnum::Trade::JpegImporter,
@@ -26,10 +26,14 @@
 */
 
 /** @file
- * @brief Class @ref Magnum::Trade::JpegImporter
+ * @brief Class @ref Magnum::Trade::JpegImporter, struct @ref Magnum::Trade::JpegImporterImageInfo
  */
 
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Vector2.h>
 #include <Magnum/Trade/AbstractImporter.h>
 
 #include "MagnumPlugins/JpegImporter/configure.h"
@@ -52,6 +56,20 @@
 
 namespace Magnum { namespace Trade {
 
+/**
+@brief JPEG image properties
+@m_since_latest_{plugins}
+
+Returned from @ref JpegImporter::image2DInfo().
+*/
+struct JpegImporterImageInfo {
+    /** @brief Image size */
+    Vector2i size;
+
+    /** @brief Pixel format the image gets decoded to */
+    PixelFormat format;
+};
+
 /**
 @brief JPEG importer plugin
 
@@ -108,6 +126,57 @@ See @ref building-plugins, @ref cmake-plugins, @ref plugins and
 While some systems (such as macOS) still ship only with the vanilla libJPEG,
 you can get a much better decoding performance by using
 [libjpeg-turbo](https://libjpeg-turbo.org/).
+
+@section Trade-JpegImporter-behavior Behavior and limitations
+
+If the @cb{.ini} scale @ce
+@ref Trade-JpegImporter-configuration "configuration option" is set to
+@cpp 2 @ce, @cpp 4 @ce or @cpp 8 @ce, the image is decoded downscaled by given
+factor directly in the DCT domain, which is several times faster than decoding
+the image at full size and downscaling it afterwards. The resulting size is
+rounded up. Alternatively, the @cb{.ini} minimumSize @ce option picks the
+largest factor for which the image is still at least given size in both
+dimensions, which is useful for generating thumbnails of known size.
+
+If the @cb{.ini} rgba @ce option is enabled, both RGB and grayscale images are
+imported as @ref PixelFormat::RGBA8Unorm with alpha set to @cpp 255 @ce, which
+is useful for uploading to GPUs that don't support three-channel formats. With
+libjpeg-turbo the conversion is done directly by its color converter, with
+other implementations the rows are expanded right after decoding.
+
+Scanlines are written bottom-up so the image origin is at the bottom left,
+matching the Magnum convention. Disabling the @cb{.ini} yFlip @ce option
+writes them top to bottom in the file order instead, which is what for
+example Vulkan expects. Either way there's no extra pass over the data.
+
+Files passed to @ref openFile() are memory-mapped on platforms that support
+it, data passed to @ref openData() are copied. Use @ref openMemory() to
+reference memory owned by the application instead. The @ref image2DInto() function
+decodes the image directly into a caller-provided buffer with an arbitrary row
+pitch, for example a mapped GPU staging buffer.
+
+@subsection Trade-JpegImporter-behavior-restart-intervals Multithreaded decoding
+
+If the @cb{.ini} threads @ce
+@ref Trade-JpegImporter-configuration "configuration option" is set to a value
+other than @cpp 1 @ce, sequential files with restart markers and a single
+interleaved scan are split at the markers into bands of whole MCU rows, which
+are then decoded in parallel directly into the output by @ref image2D() and
+@ref image2DInto(). Because the bands are decoded independently, channels with
+chroma subsampling are upsampled by pixel replication instead of the default
+interpolation in this case, so such images can differ slightly from a
+single-threaded decode. Files without restart markers, progressive and
+arithmetic-coded files are always decoded on the calling thread. When using
+multiple threads, the application needs to link to `pthread` on Linux due to
+the same reasons as described in
+@ref Trade-BasisImageConverter-loading "BasisImageConverter docs".
+
+@section Trade-JpegImporter-configuration Plugin-specific config
+
+It's possible to tune various import options through @ref configuration(). See
+below for all options and their default values:
+
+@snippet MagnumPlugins/JpegImporter/JpegImporter.conf config
 */
 class MAGNUM_JPEGIMPORTER_EXPORT JpegImporter: public AbstractImporter {
     public:
@@ -119,16 +188,72 @@ class MAGNUM_JPEGIMPORTER_EXPORT JpegImporter: public AbstractImporter {
 
         ~JpegImporter();
 
+        /**
+         * @brief Open raw data without making a copy
+         * @m_since_latest_{plugins}
+         *
+         * Compared to @ref openData(), the importer references @p data
+         * directly instead of making a copy, which means the memory has to
+         * stay valid and unchanged until the importer is closed or another
+         * file is opened. Closes previous file, if it was opened, and tries
+         * to open given memory. Returns @cpp true @ce on success,
+         * @cpp false @ce otherwise.
+         */
+        virtual bool openMemory(Containers::ArrayView<const char> data);
+
+        /**
+         * @brief Image size and format
+         * @m_since_latest_{plugins}
+         *
+         * Parses just the file header, without decoding the image data, and
+         * takes the @cb{.ini} scale @ce, @cb{.ini} minimumSize @ce and
+         * @cb{.ini} rgba @ce
+         * @ref Trade-JpegImporter-configuration "configuration options" into
+         * account. Useful for allocating memory passed to @ref image2DInto().
+         * Expects that a file is opened. If the header can't be parsed,
+         * prints a message to @ref Error and returns
+         * @ref Containers::NullOpt.
+         */
+        virtual Containers::Optional<JpegImporterImageInfo> image2DInfo();
+
+        /**
+         * @brief Decode the image into a caller-provided buffer
+         * @m_since_latest_{plugins}
+         *
+         * Like @ref image2D(), but instead of allocating a new image the
+         * scanlines are decoded directly to @p destination, with rows being
+         * @p rowPitch bytes apart. Same as with @ref image2D(), the first row
+         * in memory is the bottom row of the image, unless the
+         * @cb{.ini} yFlip @ce
+         * @ref Trade-JpegImporter-configuration "configuration option" is
+         * disabled. If @p rowPitch is
+         * @cpp 0 @ce, the rows are aligned to four bytes, matching the layout
+         * returned by @ref image2D(). The destination needs to be at least
+         * row pitch multiplied by image height large, use @ref image2DInfo()
+         * to query the size and format upfront. Padding bytes between rows
+         * are left untouched.
+         *
+         * Expects that a file is opened. If the row pitch is smaller than a
+         * row, if @p destination is too small or if the decoding fails,
+         * prints a message to @ref Error and returns @cpp false @ce.
+         */
+        virtual bool image2DInto(Containers::ArrayView<char> destination, std::size_t rowPitch = 0);
+
     private:
+        struct State;
+
         MAGNUM_JPEGIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_JPEGIMPORTER_LOCAL bool doIsOpened() const override;
         MAGNUM_JPEGIMPORTER_LOCAL void doClose() override;
+        MAGNUM_JPEGIMPORTER_LOCAL bool checkData(Containers::ArrayView<const char> data, const char* messagePrefix);
+        MAGNUM_JPEGIMPORTER_LOCAL void doOpenFile(const std::string& filename) override;
         MAGNUM_JPEGIMPORTER_LOCAL void doOpenData(Containers::ArrayView<const char> data) override;
+        MAGNUM_JPEGIMPORTER_LOCAL bool checkScale(const char* messagePrefix);
 
         MAGNUM_JPEGIMPORTER_LOCAL UnsignedInt doImage2DCount() const override;
         MAGNUM_JPEGIMPORTER_LOCAL Containers::Optional<ImageData2D> doImage2D(UnsignedInt id, UnsignedInt level) override;
 
-        Containers::Array<unsigned char> _in;
+        Containers::Pointer<State> _state;
 };
 
 }}
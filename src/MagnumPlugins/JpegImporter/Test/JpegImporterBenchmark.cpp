@@ -0,0 +1,161 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include "MagnumPlugins/Implementation/peakMemory.h"
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+struct JpegImporterBenchmark: TestSuite::Tester {
+    explicit JpegImporterBenchmark();
+
+    void image();
+    void peakMemory();
+
+    void peakMemoryBegin();
+    std::uint64_t peakMemoryEnd();
+
+    /* Explicitly forbid system-wide plugin dependencies */
+    PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
+    PluginManager::Manager<AbstractImageConverter> _converterManager{"nonexistent"};
+
+    std::uint64_t _residentSizeBefore{};
+};
+
+/* To calculate the throughput, divide the file size shown in the test case
+   description by the measured time */
+constexpr struct {
+    const char* name;
+    PixelFormat format;
+    Vector2i size;
+} FileData[]{
+    {"RGB8", PixelFormat::RGB8Unorm, {2048, 2048}},
+    {"R8", PixelFormat::R8Unorm, {2048, 2048}},
+};
+
+/* A smooth gradient with a bit of high-frequency detail so the encoder and
+   decoder have something to work with, generated instead of bundling large
+   files. JPEG supports only RGB and grayscale. */
+Containers::Array<char> imageData(const PixelFormat format, const Vector2i& size) {
+    const UnsignedInt channelCount = pixelSize(format);
+    Containers::Array<char> out{Containers::NoInit, std::size_t(size.product()*channelCount)};
+    for(Int y = 0; y != size.y(); ++y) for(Int x = 0; x != size.x(); ++x) {
+        char* pixel = out.data() + (y*size.x() + x)*channelCount;
+        const char channels[]{char(x/2), char(y/2), char((x*y) % 255), char((x ^ y) & 0xff)};
+        for(UnsignedInt i = 0; i != channelCount; ++i)
+            pixel[i] = channels[i];
+    }
+    return out;
+}
+
+JpegImporterBenchmark::JpegImporterBenchmark() {
+    addInstancedBenchmarks({&JpegImporterBenchmark::image}, 10,
+        Containers::arraySize(FileData));
+
+    addCustomInstancedBenchmarks({&JpegImporterBenchmark::peakMemory}, 1,
+        Containers::arraySize(FileData),
+        &JpegImporterBenchmark::peakMemoryBegin,
+        &JpegImporterBenchmark::peakMemoryEnd,
+        BenchmarkUnits::Bytes);
+
+    /* Load the plugins directly from the build tree. Otherwise they're static
+       and already loaded. */
+    #ifdef JPEGIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(JPEGIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    #ifdef JPEGIMAGECONVERTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_converterManager.load(JPEGIMAGECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+void JpegImporterBenchmark::image() {
+    auto&& data = FileData[testCaseInstanceId()];
+
+    if(_converterManager.loadState("JpegImageConverter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("JpegImageConverter plugin not found, cannot test");
+
+    const Containers::Array<char> in = _converterManager.instantiate("JpegImageConverter")->exportToData(ImageView2D{data.format, data.size, imageData(data.format, data.size)});
+    CORRADE_VERIFY(in);
+    setTestCaseDescription(Utility::formatString("{}, {} bytes", data.name, in.size()));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+
+    Containers::Optional<ImageData2D> image;
+    CORRADE_BENCHMARK(1) {
+        importer->openData(in);
+        image = importer->image2D(0);
+    }
+
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), data.size);
+}
+
+void JpegImporterBenchmark::peakMemory() {
+    auto&& data = FileData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifndef __linux__
+    CORRADE_SKIP("Peak memory can be measured only on Linux.");
+    #else
+    if(_converterManager.loadState("JpegImageConverter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("JpegImageConverter plugin not found, cannot test");
+
+    /* The input is generated outside of the measured region, so only the
+       memory allocated by the importer and for the output is counted */
+    const Containers::Array<char> in = _converterManager.instantiate("JpegImageConverter")->exportToData(ImageView2D{data.format, data.size, imageData(data.format, data.size)});
+    CORRADE_VERIFY(in);
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+
+    Containers::Optional<ImageData2D> image;
+    CORRADE_BENCHMARK(1) {
+        importer->openData(in);
+        image = importer->image2D(0);
+    }
+
+    CORRADE_VERIFY(image);
+    #endif
+}
+
+void JpegImporterBenchmark::peakMemoryBegin() {
+    _residentSizeBefore = Magnum::Implementation::peakMemoryBegin();
+}
+
+std::uint64_t JpegImporterBenchmark::peakMemoryEnd() {
+    return Magnum::Implementation::peakMemoryEnd(_residentSizeBefore);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::JpegImporterBenchmark)
@@ -23,20 +23,59 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <cstring>
 #include <sstream>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Corrade/Utility/Directory.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/ConfigurationValue.h>
 #include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "MagnumPlugins/JpegImporter/JpegImporter.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Trade { namespace Test { namespace {
 
+constexpr struct {
+    const char* name;
+    UnsignedInt scale;
+    Vector2i minimumSize;
+    Vector2i expectedSize;
+} ScaleData[]{
+    {"scale 2", 2, {}, {2, 1}},
+    {"scale 8", 8, {}, {1, 1}},
+    {"minimum size 1x1", 1, {1, 1}, {1, 1}},
+    {"minimum size 2x1, overriding scale", 8, {2, 1}, {2, 1}},
+    {"minimum size larger than the image", 4, {4, 4}, {3, 2}}
+};
+
+constexpr struct {
+    const char* name;
+    UnsignedInt threads;
+    UnsignedInt scale;
+    bool rgba;
+} RestartIntervalsData[]{
+    {"two threads", 2, 1, false},
+    {"all cores", 0, 1, false},
+    {"more threads than MCU rows", 16, 1, false},
+    {"two threads, scale 4", 2, 4, false},
+    {"two threads, RGBA", 2, 1, true}
+};
+
+constexpr struct {
+    const char* name;
+    UnsignedInt threads;
+} NoYFlipData[]{
+    {"", 1},
+    {"restart intervals, two threads", 2}
+};
+
 struct JpegImporterTest: TestSuite::Tester {
     explicit JpegImporterTest();
 
@@ -46,6 +85,22 @@ struct JpegImporterTest: TestSuite::Tester {
     void gray();
     void rgb();
 
+    void scale();
+    void scaleInvalid();
+
+    void rgbaGray();
+    void rgbaRgb();
+
+    void restartIntervals();
+    void restartIntervalsImage2DInto();
+
+    void noYFlip();
+
+    void openMemory();
+    void image2DInfo();
+    void image2DInto();
+    void image2DIntoInvalid();
+
     void openTwice();
     void importTwice();
 
@@ -58,7 +113,28 @@ JpegImporterTest::JpegImporterTest() {
               &JpegImporterTest::invalid,
 
               &JpegImporterTest::gray,
-              &JpegImporterTest::rgb,
+              &JpegImporterTest::rgb});
+
+    addInstancedTests({&JpegImporterTest::scale},
+        Containers::arraySize(ScaleData));
+
+    addTests({&JpegImporterTest::scaleInvalid,
+
+              &JpegImporterTest::rgbaGray,
+              &JpegImporterTest::rgbaRgb});
+
+    addInstancedTests({&JpegImporterTest::restartIntervals},
+        Containers::arraySize(RestartIntervalsData));
+
+    addTests({&JpegImporterTest::restartIntervalsImage2DInto});
+
+    addInstancedTests({&JpegImporterTest::noYFlip},
+        Containers::arraySize(NoYFlipData));
+
+    addTests({&JpegImporterTest::openMemory,
+              &JpegImporterTest::image2DInfo,
+              &JpegImporterTest::image2DInto,
+              &JpegImporterTest::image2DIntoInvalid,
 
               &JpegImporterTest::openTwice,
               &JpegImporterTest::importTwice});
@@ -146,6 +222,255 @@ void JpegImporterTest::rgb() {
         TestSuite::Compare::Container<Containers::ArrayView<const char>>);
 }
 
+void JpegImporterTest::scale() {
+    auto&& data = ScaleData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+    importer->configuration().setValue("scale", data.scale);
+    importer->configuration().setValue("minimumSize", data.minimumSize);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(JPEGIMPORTER_TEST_DIR, "rgb.jpg")));
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), data.expectedSize);
+    CORRADE_COMPARE(image->format(), PixelFormat::RGB8Unorm);
+}
+
+void JpegImporterTest::scaleInvalid() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+    importer->configuration().setValue("scale", 3);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(JPEGIMPORTER_TEST_DIR, "rgb.jpg")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->image2D(0));
+    CORRADE_COMPARE(out.str(), "Trade::JpegImporter::image2D(): expected scale to be 1, 2, 4 or 8 but got 3\n");
+}
+
+void JpegImporterTest::rgbaGray() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+    importer->configuration().setValue("rgba", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(JPEGIMPORTER_TEST_DIR, "gray.jpg")));
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), Vector2i(3, 2));
+    CORRADE_COMPARE(image->format(), PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE_AS(image->data(), (Containers::Array<char>{Containers::InPlaceInit, {
+        '\xff', '\xff', '\xff', '\xff',
+        '\x88', '\x88', '\x88', '\xff',
+        '\x00', '\x00', '\x00', '\xff',
+
+        '\x88', '\x88', '\x88', '\xff',
+        '\x00', '\x00', '\x00', '\xff',
+        '\xff', '\xff', '\xff', '\xff'}}),
+        TestSuite::Compare::Container<Containers::ArrayView<const char>>);
+}
+
+void JpegImporterTest::rgbaRgb() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+    importer->configuration().setValue("rgba", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(JPEGIMPORTER_TEST_DIR, "rgb.jpg")));
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), Vector2i(3, 2));
+    CORRADE_COMPARE(image->format(), PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE_AS(image->data(), (Containers::Array<char>{Containers::InPlaceInit, {
+        '\xca', '\xfe', '\x76', '\xff',
+        '\xdf', '\xad', '\xb6', '\xff',
+        '\xca', '\xfe', '\x76', '\xff',
+
+        '\xe0', '\xad', '\xb6', '\xff',
+        '\xc9', '\xff', '\x76', '\xff',
+        '\xdf', '\xad', '\xb6', '\xff'}}),
+        TestSuite::Compare::Container<Containers::ArrayView<const char>>);
+}
+
+void JpegImporterTest::restartIntervals() {
+    auto&& data = RestartIntervalsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* The file has no chroma subsampling, so the output doesn't depend on
+       upsampling and has to be the same as when decoded sequentially */
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+    importer->configuration().setValue("scale", data.scale);
+    importer->configuration().setValue("rgba", data.rgba);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(JPEGIMPORTER_TEST_DIR, "rgb-restart.jpg")));
+
+    Containers::Optional<Trade::ImageData2D> expected = importer->image2D(0);
+    CORRADE_VERIFY(expected);
+    CORRADE_COMPARE(expected->size(), Vector2i{40, 48}/data.scale);
+
+    importer->configuration().setValue("threads", data.threads);
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), expected->size());
+    CORRADE_COMPARE(image->format(), data.rgba ? PixelFormat::RGBA8Unorm : PixelFormat::RGB8Unorm);
+    CORRADE_COMPARE_AS(image->data(), expected->data(),
+        TestSuite::Compare::Container<Containers::ArrayView<const char>>);
+}
+
+void JpegImporterTest::restartIntervalsImage2DInto() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(JPEGIMPORTER_TEST_DIR, "rgb-restart.jpg")));
+
+    Containers::Optional<Trade::ImageData2D> expected = importer->image2D(0);
+    CORRADE_VERIFY(expected);
+
+    /* Each band writes its own rows, the padding should stay untouched */
+    importer->configuration().setValue("threads", 3);
+    Containers::Array<char> data{Containers::NoInit, 128*48};
+    std::memset(data, '\x01', data.size());
+    CORRADE_VERIFY(static_cast<JpegImporter&>(*importer).image2DInto(data, 128));
+    for(std::size_t y = 0; y != 48; ++y) {
+        CORRADE_ITERATION(y);
+        CORRADE_COMPARE_AS(data.slice(y*128, y*128 + 120),
+            expected->data().slice(y*120, y*120 + 120),
+            TestSuite::Compare::Container<Containers::ArrayView<const char>>);
+        for(std::size_t x = 120; x != 128; ++x)
+            CORRADE_COMPARE(data[y*128 + x], '\x01');
+    }
+}
+
+void JpegImporterTest::noYFlip() {
+    auto&& data = NoYFlipData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(JPEGIMPORTER_TEST_DIR, "rgb-restart.jpg")));
+
+    Containers::Optional<Trade::ImageData2D> expected = importer->image2D(0);
+    CORRADE_VERIFY(expected);
+
+    /* The rows should be the same, just in the opposite order */
+    importer->configuration().setValue("yFlip", false);
+    importer->configuration().setValue("threads", data.threads);
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), (Vector2i{40, 48}));
+    for(std::size_t y = 0; y != 48; ++y) {
+        CORRADE_ITERATION(y);
+        CORRADE_COMPARE_AS(image->data().slice(y*120, y*120 + 120),
+            expected->data().slice((47 - y)*120, (47 - y)*120 + 120),
+            TestSuite::Compare::Container<Containers::ArrayView<const char>>);
+    }
+}
+
+void JpegImporterTest::openMemory() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+    Containers::Array<char> data = Utility::Directory::read(Utility::Directory::join(JPEGIMPORTER_TEST_DIR, "gray.jpg"));
+    CORRADE_VERIFY(data);
+    CORRADE_VERIFY(static_cast<JpegImporter&>(*importer).openMemory(data));
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), Vector2i(3, 2));
+    CORRADE_COMPARE(image->format(), PixelFormat::R8Unorm);
+
+    /* The image has four-byte aligned rows, clear the padding to deterministic
+       values */
+    CORRADE_COMPARE(image->data().size(), 8);
+    image->mutableData()[3] = image->mutableData()[7] = 0;
+
+    CORRADE_COMPARE_AS(image->data(), (Containers::Array<char>{Containers::InPlaceInit, {
+        '\xff', '\x88', '\x00', 0,
+        '\x88', '\x00', '\xff', 0}}),
+        TestSuite::Compare::Container<Containers::ArrayView<const char>>);
+
+    /* Opening an empty memory fails */
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!static_cast<JpegImporter&>(*importer).openMemory(nullptr));
+    CORRADE_VERIFY(!importer->isOpened());
+    CORRADE_COMPARE(out.str(), "Trade::JpegImporter::openMemory(): the file is empty\n");
+}
+
+void JpegImporterTest::image2DInfo() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(JPEGIMPORTER_TEST_DIR, "rgb.jpg")));
+
+    {
+        Containers::Optional<JpegImporterImageInfo> info = static_cast<JpegImporter&>(*importer).image2DInfo();
+        CORRADE_VERIFY(info);
+        CORRADE_COMPARE(info->size, Vector2i(3, 2));
+        CORRADE_COMPARE(info->format, PixelFormat::RGB8Unorm);
+
+    /* The scale and RGBA options are taken into account */
+    } {
+        importer->configuration().setValue("scale", 2);
+        importer->configuration().setValue("rgba", true);
+        Containers::Optional<JpegImporterImageInfo> info = static_cast<JpegImporter&>(*importer).image2DInfo();
+        CORRADE_VERIFY(info);
+        CORRADE_COMPARE(info->size, Vector2i(2, 1));
+        CORRADE_COMPARE(info->format, PixelFormat::RGBA8Unorm);
+    }
+
+    /* Invalid file */
+    CORRADE_VERIFY(importer->openData("invalid"));
+
+    #ifdef CORRADE_TARGET_CLANG_CL
+    CORRADE_EXPECT_FAIL("Clang-cl crashes on this test, not sure why.");
+    CORRADE_VERIFY(false);
+    return;
+    #endif
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!static_cast<JpegImporter&>(*importer).image2DInfo());
+    CORRADE_COMPARE(out.str(), "Trade::JpegImporter::image2DInfo(): error: Not a JPEG file: starts with 0x69 0x6e\n");
+}
+
+void JpegImporterTest::image2DInto() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(JPEGIMPORTER_TEST_DIR, "rgb.jpg")));
+
+    /* A 16-byte row pitch, with the padding filled to verify it's not touched */
+    char data[16*2];
+    std::memset(data, '\x01', sizeof(data));
+    CORRADE_VERIFY(static_cast<JpegImporter&>(*importer).image2DInto(data, 16));
+    CORRADE_COMPARE_AS(Containers::arrayView(data), Containers::arrayView<char>({
+        '\xca', '\xfe', '\x76',
+        '\xdf', '\xad', '\xb6',
+        '\xca', '\xfe', '\x76', 1, 1, 1, 1, 1, 1, 1,
+
+        '\xe0', '\xad', '\xb6',
+        '\xc9', '\xff', '\x76',
+        '\xdf', '\xad', '\xb6', 1, 1, 1, 1, 1, 1, 1
+    }), TestSuite::Compare::Container);
+
+    /* Tightly packed RGBA rows */
+    importer->configuration().setValue("rgba", true);
+    char tight[12*2];
+    CORRADE_VERIFY(static_cast<JpegImporter&>(*importer).image2DInto(tight, 12));
+    CORRADE_COMPARE_AS(Containers::arrayView(tight), Containers::arrayView<char>({
+        '\xca', '\xfe', '\x76', '\xff',
+        '\xdf', '\xad', '\xb6', '\xff',
+        '\xca', '\xfe', '\x76', '\xff',
+
+        '\xe0', '\xad', '\xb6', '\xff',
+        '\xc9', '\xff', '\x76', '\xff',
+        '\xdf', '\xad', '\xb6', '\xff'
+    }), TestSuite::Compare::Container);
+}
+
+void JpegImporterTest::image2DIntoInvalid() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(JPEGIMPORTER_TEST_DIR, "rgb.jpg")));
+
+    char data[12*2];
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!static_cast<JpegImporter&>(*importer).image2DInto(data, 8));
+    /* Default pitch is 12, so 23 bytes is not enough */
+    CORRADE_VERIFY(!static_cast<JpegImporter&>(*importer).image2DInto(Containers::arrayView(data).except(1)));
+    CORRADE_COMPARE(out.str(),
+        "Trade::JpegImporter::image2DInto(): row pitch 8 is smaller than 9\n"
+        "Trade::JpegImporter::image2DInto(): expected a destination of at least 24 bytes but got 23\n");
+}
+
 void JpegImporterTest::openTwice() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("JpegImporter");
 
@@ -24,4 +24,5 @@
 */
 
 #cmakedefine JPEGIMPORTER_PLUGIN_FILENAME "${JPEGIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine JPEGIMAGECONVERTER_PLUGIN_FILENAME "${JPEGIMAGECONVERTER_PLUGIN_FILENAME}"
 #define JPEGIMPORTER_TEST_DIR "${CMAKE_CURRENT_SOURCE_DIR}"
@@ -25,16 +25,26 @@
 
 #include "MeshOptimizerSceneConverter.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <thread>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Reference.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/Macros.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Math/PackingBatch.h>
 #include <Magnum/Math/Vector3.h>
 #include <Magnum/MeshTools/Combine.h>
 #include <Magnum/MeshTools/Duplicate.h>
 #include <Magnum/MeshTools/GenerateIndices.h>
 #include <Magnum/MeshTools/Interleave.h>
-#include <Magnum/MeshTools/Reference.h>
 #include <Magnum/Trade/ArrayAllocator.h>
 #include <Magnum/Trade/MeshData.h>
 #include <meshoptimizer.h>
@@ -46,7 +56,7 @@ MeshOptimizerSceneConverter::MeshOptimizerSceneConverter(PluginManager::Abstract
 MeshOptimizerSceneConverter::~MeshOptimizerSceneConverter() = default;
 
 SceneConverterFeatures MeshOptimizerSceneConverter::doFeatures() const {
-    return SceneConverterFeature::ConvertMeshInPlace|SceneConverterFeature::ConvertMesh;
+    return SceneConverterFeature::ConvertMeshInPlace|SceneConverterFeature::ConvertMesh|SceneConverterFeature::ConvertMeshToData;
 }
 
 namespace {
@@ -84,7 +94,30 @@ void analyze(const MeshData& mesh, const Utility::ConfigurationGroup& configurat
     else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
 }
 
-void analyzePost(const char* prefix, const MeshData& mesh, const Utility::ConfigurationGroup& configuration, const Containers::StridedArrayView1D<const Vector3> positions, Containers::Optional<UnsignedInt>& vertexSize, meshopt_VertexCacheStatistics& vertexCacheStatsBefore, meshopt_VertexFetchStatistics& vertexFetchStatsBefore, meshopt_OverdrawStatistics& overdrawStatsBefore) {
+/* Stats are gathered for verbose output and when explicitly requested */
+bool gatherStatistics(const SceneConverterFlags flags, const Utility::ConfigurationGroup& configuration) {
+    return (flags & SceneConverterFlag::Verbose) || configuration.value<bool>("statistics");
+}
+
+MeshOptimizerSceneConverter::Statistics toStatistics(const meshopt_VertexCacheStatistics& vertexCacheStats, const meshopt_VertexFetchStatistics& vertexFetchStats, const meshopt_OverdrawStatistics& overdrawStats, const bool hasVertexFetch, const bool hasOverdraw) {
+    MeshOptimizerSceneConverter::Statistics out{};
+    out.verticesTransformed = vertexCacheStats.vertices_transformed;
+    out.warpsExecuted = vertexCacheStats.warps_executed;
+    out.acmr = vertexCacheStats.acmr;
+    out.atvr = vertexCacheStats.atvr;
+    if(hasVertexFetch) {
+        out.bytesFetched = vertexFetchStats.bytes_fetched;
+        out.overfetch = vertexFetchStats.overfetch;
+    }
+    if(hasOverdraw) {
+        out.pixelsCovered = overdrawStats.pixels_covered;
+        out.pixelsShaded = overdrawStats.pixels_shaded;
+        out.overdraw = overdrawStats.overdraw;
+    }
+    return out;
+}
+
+void analyzePost(const char* prefix, const MeshData& mesh, const SceneConverterFlags flags, const Utility::ConfigurationGroup& configuration, const Containers::StridedArrayView1D<const Vector3> positions, Containers::Optional<UnsignedInt>& vertexSize, meshopt_VertexCacheStatistics& vertexCacheStatsBefore, meshopt_VertexFetchStatistics& vertexFetchStatsBefore, meshopt_OverdrawStatistics& overdrawStatsBefore, Containers::Array<MeshOptimizerSceneConverter::Statistics>& outStatistics) {
     /* If vertex size is zero, it means there was an implementation-specific
        vertex format somewhere. Print a warning about that. */
     CORRADE_INTERNAL_ASSERT(vertexSize);
@@ -101,6 +134,12 @@ void analyzePost(const char* prefix, const MeshData& mesh, const Utility::Config
     meshopt_OverdrawStatistics overdrawStats;
     analyze(mesh, configuration, positions, vertexSize, vertexCacheStats, vertexFetchStats, overdrawStats);
 
+    outStatistics = Containers::Array<MeshOptimizerSceneConverter::Statistics>{Containers::NoInit, 2};
+    outStatistics[0] = toStatistics(vertexCacheStatsBefore, vertexFetchStatsBefore, overdrawStatsBefore, *vertexSize != 0, !!positions);
+    outStatistics[1] = toStatistics(vertexCacheStats, vertexFetchStats, overdrawStats, *vertexSize != 0, !!positions);
+
+    if(!(flags & SceneConverterFlag::Verbose)) return;
+
     Debug{} << prefix << "processing stats:";
     Debug{} << "  vertex cache:\n   "
         << vertexCacheStatsBefore.vertices_transformed << "->"
@@ -136,10 +175,84 @@ void populatePositions(const MeshData& mesh, Containers::Array<Vector3>& positio
     }
 }
 
+/* Moves each vertex i of an interleaved mesh with mutable vertex data to
+   remap[i] */
+void reorderVertices(MeshData& mesh, const Containers::ArrayView<const UnsignedInt> remap) {
+    if(!mesh.attributeCount()) return;
+
+    const Containers::StridedArrayView2D<char> interleaved = MeshTools::interleavedMutableData(mesh);
+    const std::size_t stride = interleaved.stride()[0];
+    const std::size_t vertexSize = interleaved.size()[1];
+    const std::size_t vertexCount = mesh.vertexCount();
+    Containers::Array<char> original{Containers::NoInit, vertexCount*stride};
+    for(std::size_t i = 0; i != vertexCount; ++i)
+        std::memcpy(original + i*stride, interleaved[i].data(), vertexSize);
+    for(std::size_t i = 0; i != vertexCount; ++i)
+        std::memcpy(interleaved[remap[i]].data(), original + i*stride, vertexSize);
+}
+
+template<class T> void remapIndices(const Containers::ArrayView<T> indices, const Containers::ArrayView<const UnsignedInt> remap) {
+    for(T& index: indices) index = T(remap[index]);
+}
+
+/* meshoptimizer can't sort the triangles in-place, so it sorts from a copy */
+template<class T> void spatialSortTriangles(const Containers::ArrayView<T> indices, const Containers::StridedArrayView1D<const Vector3> positions, const UnsignedInt vertexCount) {
+    Containers::Array<T> original{Containers::NoInit, indices.size()};
+    Utility::copy(indices, original);
+    meshopt_spatialSortTriangles(indices.data(), original.data(), indices.size(), static_cast<const Float*>(positions.data()), vertexCount, positions.stride());
+}
+
+/* Point clouds have no connectivity, so the only thing that can be done with
+   them is reordering the vertices */
+bool convertPointsInPlace(const char* prefix, MeshData& mesh, const Utility::ConfigurationGroup& configuration, Containers::Array<Vector3>& positionStorage, Containers::StridedArrayView1D<const Vector3>& positions) {
+    if(configuration.value<bool>("simplify") ||
+       configuration.value<bool>("simplifySloppy") ||
+       configuration.value<UnsignedInt>("lodCount") > 1 ||
+       configuration.value<bool>("buildMeshlets") ||
+       configuration.value<bool>("generateShadowIndices") ||
+       configuration.value<bool>("stripify"))
+    {
+        Error{} << prefix << "simplification, level of detail, meshlet, shadow index and strip generation expects a triangle mesh, got" << mesh.primitive();
+        return false;
+    }
+
+    if(!configuration.value<bool>("spatialSort")) return true;
+
+    if(!mesh.hasAttribute(MeshAttribute::Position)) {
+        Error{} << prefix << "spatialSort requires the mesh to have positions";
+        return false;
+    }
+
+    populatePositions(mesh, positionStorage, positions);
+    Containers::Array<UnsignedInt> remap{Containers::NoInit, mesh.vertexCount()};
+    meshopt_spatialSortRemap(remap.data(), static_cast<const Float*>(positions.data()), mesh.vertexCount(), positions.stride());
+
+    /* This assumes the mesh is interleaved. doConvert() already ensures
+       that, doConvertInPlace() has a runtime check */
+    reorderVertices(mesh, remap);
+    if(mesh.isIndexed()) {
+        if(mesh.indexType() == MeshIndexType::UnsignedInt)
+            remapIndices(mesh.mutableIndices<UnsignedInt>(), remap);
+        else if(mesh.indexType() == MeshIndexType::UnsignedShort)
+            remapIndices(mesh.mutableIndices<UnsignedShort>(), remap);
+        else if(mesh.indexType() == MeshIndexType::UnsignedByte)
+            remapIndices(mesh.mutableIndices<UnsignedByte>(), remap);
+        else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    }
+
+    /* The positions may point to a now outdated copy */
+    populatePositions(mesh, positionStorage, positions);
+    return true;
+}
+
 bool convertInPlaceInternal(const char* prefix, MeshData& mesh, const SceneConverterFlags flags, const Utility::ConfigurationGroup& configuration, Containers::Array<Vector3>& positionStorage, Containers::StridedArrayView1D<const Vector3>& positions, Containers::Optional<UnsignedInt>& vertexSize,  meshopt_VertexCacheStatistics& vertexCacheStatsBefore, meshopt_VertexFetchStatistics& vertexFetchStatsBefore, meshopt_OverdrawStatistics& overdrawStatsBefore) {
+    /* Point clouds, indexed or not, have a separate path */
+    if(mesh.primitive() == MeshPrimitive::Points)
+        return convertPointsInPlace(prefix, mesh, configuration, positionStorage, positions);
+
     /* Only doConvert() can handle triangle strips etc, in-place only triangles */
     if(mesh.primitive() != MeshPrimitive::Triangles) {
-        Error{} << prefix << "expected a triangle mesh, got" << mesh.primitive();
+        Error{} << prefix << "expected a triangle mesh or a point cloud, got" << mesh.primitive();
         return false;
     }
 
@@ -152,10 +265,14 @@ bool convertInPlaceInternal(const char* prefix, MeshData& mesh, const SceneConve
     /* If we need it, get the position attribute, unpack if packed. It's used
        by the verbose stats also but in that case the processing shouldn't fail
        if there are no positions -- so check the hasAttribute() earlier. */
-    if((flags & SceneConverterFlag::Verbose && mesh.hasAttribute(MeshAttribute::Position)) ||
+    if((gatherStatistics(flags, configuration) && mesh.hasAttribute(MeshAttribute::Position)) ||
        configuration.value<bool>("optimizeOverdraw") ||
+       configuration.value<bool>("spatialSort") ||
        configuration.value<bool>("simplify") ||
-       configuration.value<bool>("simplifySloppy"))
+       configuration.value<bool>("simplifySloppy") ||
+       configuration.value<UnsignedInt>("lodCount") > 1 ||
+       configuration.value<bool>("buildMeshlets") ||
+       configuration.value<bool>("generateShadowIndices"))
     {
         if(!mesh.hasAttribute(MeshAttribute::Position)) {
             Error{} << prefix << "optimizeOverdraw and simplify require the mesh to have positions";
@@ -165,13 +282,39 @@ bool convertInPlaceInternal(const char* prefix, MeshData& mesh, const SceneConve
         populatePositions(mesh, positionStorage, positions);
     }
 
-    /* Save "before" stats if verbose output is requested. No messages as those
-       will be printed only at the end if the processing passes. */
-    if(flags & SceneConverterFlag::Verbose) {
+    /* Check meshlet limits early to not do all processing just to fail at the
+       end. These are what meshoptimizer asserts on. */
+    if(configuration.value<bool>("buildMeshlets")) {
+        const UnsignedInt maxVertices = configuration.value<UnsignedInt>("meshletMaxVertices");
+        const UnsignedInt maxTriangles = configuration.value<UnsignedInt>("meshletMaxTriangles");
+        if(maxVertices < 3 || maxVertices > 255 || maxTriangles < 4 || maxTriangles > 512 || maxTriangles % 4) {
+            Error{} << prefix << "expected meshletMaxVertices to be in range [3, 255] and meshletMaxTriangles divisible by four in range [4, 512] but got" << maxVertices << "and" << maxTriangles;
+            return false;
+        }
+    }
+
+    /* Save "before" stats if verbose output or statistics are requested. No
+       messages as those will be printed only at the end if the processing
+       passes. */
+    if(gatherStatistics(flags, configuration)) {
         analyze(mesh, configuration, positions, vertexSize, vertexCacheStatsBefore, vertexFetchStatsBefore, overdrawStatsBefore);
     }
 
-    /* Vertex cache optimization. Goes first. */
+    /* Spatial sort of the triangles. Goes first, so the vertex cache
+       optimization starts from an order that already has some locality.
+       Useful mainly for triangle soups, where the original order is
+       arbitrary. */
+    if(configuration.value<bool>("spatialSort")) {
+        if(mesh.indexType() == MeshIndexType::UnsignedInt)
+            spatialSortTriangles(mesh.mutableIndices<UnsignedInt>(), positions, mesh.vertexCount());
+        else if(mesh.indexType() == MeshIndexType::UnsignedShort)
+            spatialSortTriangles(mesh.mutableIndices<UnsignedShort>(), positions, mesh.vertexCount());
+        else if(mesh.indexType() == MeshIndexType::UnsignedByte)
+            spatialSortTriangles(mesh.mutableIndices<UnsignedByte>(), positions, mesh.vertexCount());
+        else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    }
+
+    /* Vertex cache optimization. Goes after spatial sort. */
     if(configuration.value<bool>("optimizeVertexCache")) {
         if(mesh.indexType() == MeshIndexType::UnsignedInt) {
             Containers::ArrayView<UnsignedInt> indices = mesh.mutableIndices<UnsignedInt>();
@@ -226,78 +369,385 @@ bool convertInPlaceInternal(const char* prefix, MeshData& mesh, const SceneConve
     return true;
 }
 
+/* Puts all levels of detail after each other into the output, converted to
+   the original index type, returns the finest level */
+template<class T> MeshIndexData copyLevelsOfDetail(const Containers::ArrayView<const Containers::Array<UnsignedInt>> levels, const Containers::ArrayView<char> out) {
+    const Containers::ArrayView<T> indices = Containers::arrayCast<T>(out);
+    std::size_t offset = 0;
+    for(const Containers::Array<UnsignedInt>& level: levels) {
+        for(std::size_t i = 0; i != level.size(); ++i)
+            indices[offset + i] = T(level[i]);
+        offset += level.size();
+    }
+    return MeshIndexData{indices.prefix(levels[0].size())};
 }
 
-bool MeshOptimizerSceneConverter::doConvertInPlace(MeshData& mesh) {
-    if((configuration().value<bool>("optimizeVertexCache") ||
-        configuration().value<bool>("optimizeOverdraw") ||
-        configuration().value<bool>("optimizeVertexFetch")) &&
-       !(mesh.indexDataFlags() & DataFlag::Mutable))
-    {
-        Error{} << "Trade::MeshOptimizerSceneConverter::convertInPlace(): optimizeVertexCache, optimizeOverdraw and optimizeVertexFetch require index data to be mutable";
-        return false;
+void buildMeshlets(const MeshData& mesh, const Utility::ConfigurationGroup& configuration, const Containers::StridedArrayView1D<const Vector3> positions, Containers::Array<MeshOptimizerSceneConverter::Meshlet>& meshlets, Containers::Array<UnsignedInt>& meshletVertices, Containers::Array<UnsignedByte>& meshletTriangles) {
+    const std::size_t maxVertices = configuration.value<UnsignedInt>("meshletMaxVertices");
+    const std::size_t maxTriangles = configuration.value<UnsignedInt>("meshletMaxTriangles");
+    const Float coneWeight = configuration.value<Float>("meshletConeWeight");
+
+    /* Again no overloads for other index types */
+    Containers::Array<UnsignedInt> indicesStorage;
+    Containers::ArrayView<const UnsignedInt> indices;
+    if(mesh.indexType() == MeshIndexType::UnsignedInt)
+        indices = mesh.indices<UnsignedInt>();
+    else {
+        indicesStorage = mesh.indicesAsArray();
+        indices = indicesStorage;
     }
 
-    if(configuration().value<bool>("optimizeVertexFetch")) {
-        if(!(mesh.vertexDataFlags() & DataFlag::Mutable)) {
-            Error{} << "Trade::MeshOptimizerSceneConverter::convertInPlace(): optimizeVertexFetch requires vertex data to be mutable";
-            return false;
-        }
+    /* Build into upper-bound sized arrays */
+    const std::size_t maxMeshletCount = meshopt_buildMeshletsBound(indices.size(), maxVertices, maxTriangles);
+    Containers::Array<meshopt_Meshlet> output{Containers::NoInit, maxMeshletCount};
+    Containers::Array<UnsignedInt> vertices{Containers::NoInit, maxMeshletCount*maxVertices};
+    Containers::Array<UnsignedByte> triangles{Containers::NoInit, maxMeshletCount*maxTriangles*3};
+    const std::size_t meshletCount = meshopt_buildMeshlets(output.data(), vertices.data(), triangles.data(), indices.data(), indices.size(), static_cast<const float*>(positions.data()), mesh.vertexCount(), positions.stride(), maxVertices, maxTriangles, coneWeight);
 
-        if(!MeshTools::isInterleaved(mesh)) {
-            Error{} << "Trade::MeshOptimizerSceneConverter::convertInPlace(): optimizeVertexFetch requires the mesh to be interleaved";
-            return false;
+    /* Copy the used prefix out. The triangle range of each meshlet is padded
+       to four bytes. */
+    std::size_t vertexCount = 0;
+    std::size_t triangleSize = 0;
+    if(meshletCount) {
+        const meshopt_Meshlet& last = output[meshletCount - 1];
+        vertexCount = last.vertex_offset + last.vertex_count;
+        triangleSize = last.triangle_offset + ((last.triangle_count*3 + 3) & ~3);
+    }
+    meshletVertices = Containers::Array<UnsignedInt>{Containers::NoInit, vertexCount};
+    Utility::copy(vertices.prefix(vertexCount), meshletVertices);
+    meshletTriangles = Containers::Array<UnsignedByte>{Containers::NoInit, triangleSize};
+    Utility::copy(triangles.prefix(triangleSize), meshletTriangles);
+
+    /* Calculate bounds for each */
+    meshlets = Containers::Array<MeshOptimizerSceneConverter::Meshlet>{Containers::NoInit, meshletCount};
+    for(std::size_t i = 0; i != meshletCount; ++i) {
+        const meshopt_Meshlet& meshlet = output[i];
+        const meshopt_Bounds bounds = meshopt_computeMeshletBounds(meshletVertices + meshlet.vertex_offset, meshletTriangles + meshlet.triangle_offset, meshlet.triangle_count, static_cast<const float*>(positions.data()), mesh.vertexCount(), positions.stride());
+        meshlets[i] = MeshOptimizerSceneConverter::Meshlet{
+            meshlet.vertex_offset, meshlet.triangle_offset,
+            meshlet.vertex_count, meshlet.triangle_count,
+            Vector3::from(bounds.center), bounds.radius,
+            Vector3::from(bounds.cone_apex), Vector3::from(bounds.cone_axis),
+            bounds.cone_cutoff};
+    }
+}
+
+/* Merges duplicate vertices of a non-indexed interleaved mesh, turning it
+   into an indexed one */
+MeshData deduplicateVertices(MeshData&& mesh) {
+    const UnsignedInt vertexCount = mesh.vertexCount();
+    Containers::Array<char> indexData{Containers::NoInit, vertexCount*sizeof(UnsignedInt)};
+    const Containers::ArrayView<UnsignedInt> remap = Containers::arrayCast<UnsignedInt>(indexData);
+
+    /* Without any attributes all vertices are the same */
+    if(!mesh.attributeCount()) {
+        std::fill(remap.begin(), remap.end(), 0);
+        const MeshIndexData indices{remap};
+        return MeshData{MeshPrimitive::Triangles, std::move(indexData), indices,
+            vertexCount ? 1u : 0u};
+    }
+
+    /* Compare each attribute separately so padding between them doesn't
+       matter. If there's an implementation-specific format, compare the whole
+       vertex instead as we don't know the size. */
+    const Containers::StridedArrayView2D<const char> interleaved = MeshTools::interleavedData(mesh);
+    const std::size_t stride = interleaved.stride()[0];
+    Containers::Array<meshopt_Stream> streams{Containers::NoInit, mesh.attributeCount()};
+    std::size_t streamCount = 0;
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+        if(isVertexFormatImplementationSpecific(mesh.attributeFormat(i))) {
+            streams[0] = meshopt_Stream{interleaved.data(), interleaved.size()[1], stride};
+            streamCount = 1;
+            break;
         }
+
+        const Containers::StridedArrayView2D<const char> attribute = mesh.attribute(i);
+        streams[streamCount++] = meshopt_Stream{attribute.data(), attribute.size()[1], stride};
     }
 
+    /* meshoptimizer can't handle strides over 256 bytes, in that case just
+       take the vertices as they are */
+    std::size_t uniqueVertexCount;
+    if(stride > 256) {
+        for(UnsignedInt i = 0; i != vertexCount; ++i) remap[i] = i;
+        uniqueVertexCount = vertexCount;
+    } else uniqueVertexCount = meshopt_generateVertexRemapMulti(remap.data(), nullptr, vertexCount, vertexCount, streams.data(), streamCount);
 
-    if(configuration().value<bool>("simplify") ||
-       configuration().value<bool>("simplifySloppy"))
-    {
-        Error{} << "Trade::MeshOptimizerSceneConverter::convertInPlace(): mesh simplification can't be performed in-place, use convert() instead";
-        return false;
+    /* Copy the unique vertices to a new buffer with the same layout, relative
+       to the first attribute */
+    const std::size_t base = static_cast<const char*>(interleaved.data()) - mesh.vertexData().data();
+    Containers::Array<char> vertexData{Containers::ValueInit, uniqueVertexCount*stride};
+    for(UnsignedInt i = 0; i != vertexCount; ++i)
+        std::memcpy(vertexData + remap[i]*stride, interleaved[i].data(), interleaved.size()[1]);
+    Containers::Array<MeshAttributeData> attributeData{mesh.attributeCount()};
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i)
+        attributeData[i] = MeshAttributeData{mesh.attributeName(i), mesh.attributeFormat(i),
+            Containers::StridedArrayView1D<const void>{vertexData, vertexData + mesh.attributeOffset(i) - base, uniqueVertexCount, std::ptrdiff_t(stride)},
+            mesh.attributeArraySize(i)};
+
+    const MeshIndexData indices{remap};
+    return MeshData{MeshPrimitive::Triangles, std::move(indexData), indices,
+        std::move(vertexData), std::move(attributeData), UnsignedInt(uniqueVertexCount)};
+}
+
+/* Converts an indexed triangle list to a strip, separated either with
+   primitive restart indices or with degenerate triangles */
+template<class T> void copyStripIndices(const Containers::ArrayView<const UnsignedInt> strip, const Containers::ArrayView<char> out) {
+    /* The 32-bit restart index becomes the maximal value of T */
+    const Containers::ArrayView<T> indices = Containers::arrayCast<T>(out);
+    for(std::size_t i = 0; i != strip.size(); ++i)
+        indices[i] = T(strip[i]);
+}
+
+MeshData stripify(MeshData&& mesh, const bool restart) {
+    /* Again no overloads for other index types */
+    Containers::Array<UnsignedInt> inputIndicesStorage;
+    Containers::ArrayView<const UnsignedInt> inputIndices;
+    if(mesh.indexType() == MeshIndexType::UnsignedInt)
+        inputIndices = mesh.indices<UnsignedInt>();
+    else {
+        inputIndicesStorage = mesh.indicesAsArray();
+        inputIndices = inputIndicesStorage;
     }
 
-    meshopt_VertexCacheStatistics vertexCacheStatsBefore;
-    meshopt_VertexFetchStatistics vertexFetchStatsBefore;
-    meshopt_OverdrawStatistics overdrawStatsBefore;
-    Containers::Array<Vector3> positionStorage;
-    Containers::StridedArrayView1D<const Vector3> positions;
-    Containers::Optional<UnsignedInt> vertexSize;
-    if(!convertInPlaceInternal("Trade::MeshOptimizerSceneConverter::convertInPlace():", mesh, flags(), configuration(), positionStorage, positions, vertexSize, vertexCacheStatsBefore, vertexFetchStatsBefore, overdrawStatsBefore))
-        return false;
+    Containers::Array<UnsignedInt> strip{Containers::NoInit, meshopt_stripifyBound(inputIndices.size())};
+    const std::size_t count = meshopt_stripify(strip.data(), inputIndices.data(), inputIndices.size(), mesh.vertexCount(), restart ? ~UnsignedInt{} : 0);
 
-    if(flags() & SceneConverterFlag::Verbose)
-        analyzePost("Trade::MeshOptimizerSceneConverter::convertInPlace():", mesh, configuration(), positions, vertexSize, vertexCacheStatsBefore, vertexFetchStatsBefore, overdrawStatsBefore);
+    /* Keep the original index type, unless the restart index would collide
+       with the last vertex */
+    MeshIndexType type = mesh.indexType();
+    if(restart && type == MeshIndexType::UnsignedByte && mesh.vertexCount() > 0xff)
+        type = MeshIndexType::UnsignedShort;
+    else if(restart && type == MeshIndexType::UnsignedShort && mesh.vertexCount() > 0xffff)
+        type = MeshIndexType::UnsignedInt;
 
-    return true;
+    Containers::Array<char> indexData{Containers::NoInit, count*meshIndexTypeSize(type)};
+    if(type == MeshIndexType::UnsignedInt)
+        copyStripIndices<UnsignedInt>(strip.prefix(count), indexData);
+    else if(type == MeshIndexType::UnsignedShort)
+        copyStripIndices<UnsignedShort>(strip.prefix(count), indexData);
+    else if(type == MeshIndexType::UnsignedByte)
+        copyStripIndices<UnsignedByte>(strip.prefix(count), indexData);
+    else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+
+    const MeshIndexData indices{type, indexData};
+    const UnsignedInt vertexCount = mesh.vertexCount();
+    return MeshData{MeshPrimitive::TriangleStrip,
+        std::move(indexData), indices,
+        mesh.releaseVertexData(), mesh.releaseAttributeData(), vertexCount};
 }
 
-Containers::Optional<MeshData> MeshOptimizerSceneConverter::doConvert(const MeshData& mesh) {
-    /* Make the mesh interleaved and owned first */
-    MeshData out = MeshTools::owned(MeshTools::interleave(mesh));
-    CORRADE_INTERNAL_ASSERT(MeshTools::isInterleaved(out));
+/* Builds a position-only index buffer together with a compact position
+   stream for depth-only rendering. Vertices that differ only in other
+   attributes are merged, so there's less vertices to transform and fetch. */
+void generateShadowMesh(const MeshData& mesh, const Utility::ConfigurationGroup& configuration, const Containers::StridedArrayView1D<const Vector3> positions, Containers::Array<UnsignedInt>& shadowIndices, Containers::Array<Vector3>& shadowPositions) {
+    const UnsignedInt vertexCount = mesh.vertexCount();
+
+    /* The index buffer is only read, no need to make a copy if it's already
+       32-bit */
+    shadowIndices = Containers::Array<UnsignedInt>{Containers::NoInit, mesh.indexCount()};
+    if(mesh.indexType() == MeshIndexType::UnsignedInt) {
+        const Containers::ArrayView<const UnsignedInt> indices = mesh.indices<UnsignedInt>();
+        meshopt_generateShadowIndexBuffer(shadowIndices.data(), indices.data(), indices.size(), positions.data(), vertexCount, sizeof(Vector3), positions.stride());
+    } else {
+        const Containers::Array<UnsignedInt> indices = mesh.indicesAsArray();
+        meshopt_generateShadowIndexBuffer(shadowIndices.data(), indices.data(), indices.size(), positions.data(), vertexCount, sizeof(Vector3), positions.stride());
+    }
+
+    /* The merged vertices change the cache behavior, so optimize again */
+    if(configuration.value<bool>("optimizeVertexCache"))
+        meshopt_optimizeVertexCache(shadowIndices.data(), shadowIndices.data(), shadowIndices.size(), vertexCount);
+
+    /* Keep only the referenced positions, in the order they're first used */
+    Containers::Array<UnsignedInt> remap{Containers::NoInit, vertexCount};
+    const std::size_t shadowVertexCount = meshopt_optimizeVertexFetchRemap(remap.data(), shadowIndices.data(), shadowIndices.size(), vertexCount);
+    meshopt_remapIndexBuffer(shadowIndices.data(), shadowIndices.data(), shadowIndices.size(), remap.data());
+    shadowPositions = Containers::Array<Vector3>{Containers::NoInit, shadowVertexCount};
+    for(std::size_t i = 0; i != vertexCount; ++i)
+        if(remap[i] != ~UnsignedInt{}) shadowPositions[remap[i]] = positions[i];
+}
+
+/* Puts the attributes into a new, more compact layout with quantized
+   positions, normals and texture coordinates */
+Containers::Optional<MeshData> quantize(const char* const prefix, MeshData&& mesh, const Utility::ConfigurationGroup& configuration, Matrix4& positionDequantization) {
+    const bool quantizePositions = configuration.value<bool>("quantizePositions");
+    const bool quantizeNormals = configuration.value<bool>("quantizeNormals");
+    const bool quantizeTextureCoordinates = configuration.value<bool>("quantizeTextureCoordinates");
 
-    /* Convert to an indexed triangle mesh if we have a strip or a fan */
-    if(out.primitive() == MeshPrimitive::TriangleStrip || out.primitive() == MeshPrimitive::TriangleFan) {
-        if(out.isIndexed()) out = MeshTools::duplicate(out);
-        out = MeshTools::generateIndices(std::move(out));
+    /* Decide on the new formats and offsets. Only the first position
+       attribute is quantized, as there's just one dequantization
+       transformation. */
+    const UnsignedInt positionId = mesh.hasAttribute(MeshAttribute::Position) ? mesh.attributeId(MeshAttribute::Position) : ~UnsignedInt{};
+    Containers::Array<VertexFormat> formats{Containers::NoInit, mesh.attributeCount()};
+    Containers::Array<std::size_t> offsets{Containers::NoInit, mesh.attributeCount()};
+    std::size_t stride = 0;
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+        const MeshAttribute name = mesh.attributeName(i);
+        const VertexFormat format = mesh.attributeFormat(i);
+        const UnsignedInt arraySize = mesh.attributeArraySize(i);
+        /* Can't know the size to copy. Currently unreachable as interleave()
+           in convert() doesn't handle those either. */
+        if(isVertexFormatImplementationSpecific(format)) {
+            Error{} << prefix << "can't quantize a mesh with" << format;
+            return Containers::NullOpt;
+        }
+
+        formats[i] = format;
+        if(arraySize) {
+            /* Array attributes are kept as-is */
+        } else if(quantizePositions && i == positionId && format == VertexFormat::Vector3) {
+            formats[i] = VertexFormat::Vector3usNormalized;
+        } else if(quantizeNormals && (name == MeshAttribute::Normal || name == MeshAttribute::Tangent || name == MeshAttribute::Bitangent) && format == VertexFormat::Vector3) {
+            formats[i] = VertexFormat::Vector3bNormalized;
+        } else if(quantizeNormals && name == MeshAttribute::Tangent && format == VertexFormat::Vector4) {
+            formats[i] = VertexFormat::Vector4bNormalized;
+        } else if(quantizeTextureCoordinates && name == MeshAttribute::TextureCoordinates && format == VertexFormat::Vector2) {
+            /* Unorm if in the [0, 1] range, half-floats otherwise */
+            formats[i] = VertexFormat::Vector2usNormalized;
+            for(const Vector2& coordinates: mesh.attribute<Vector2>(i)) {
+                if(coordinates.min() < 0.0f || coordinates.max() > 1.0f) {
+                    formats[i] = VertexFormat::Vector2h;
+                    break;
+                }
+            }
+        }
+
+        /* Align everything to four bytes */
+        offsets[i] = stride;
+        stride += (vertexFormatSize(formats[i])*(arraySize ? arraySize : 1) + 3)/4*4;
     }
 
+    /* Copy or quantize the attributes */
+    const UnsignedInt vertexCount = mesh.vertexCount();
+    Containers::Array<char> vertexData{Containers::ValueInit, vertexCount*stride};
+    Containers::Array<MeshAttributeData> attributeData{mesh.attributeCount()};
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+        const VertexFormat format = mesh.attributeFormat(i);
+        const UnsignedInt arraySize = mesh.attributeArraySize(i);
+        char* const data = vertexData + offsets[i];
+        attributeData[i] = MeshAttributeData{mesh.attributeName(i), formats[i],
+            Containers::StridedArrayView1D<const void>{vertexData, data, vertexCount, std::ptrdiff_t(stride)},
+            UnsignedShort(arraySize)};
+
+        /* Unchanged attribute, copy */
+        if(format == formats[i]) {
+            const Containers::StridedArrayView2D<const char> src = mesh.attribute(i);
+            Utility::copy(src, Containers::StridedArrayView2D<char>{vertexData, data, src.size(), {std::ptrdiff_t(stride), 1}});
+
+        /* Positions, quantized to the bounding box with uniform scaling so the
+           dequantization transformation doesn't skew normals */
+        } else if(formats[i] == VertexFormat::Vector3usNormalized) {
+            const Containers::StridedArrayView1D<const Vector3> src = mesh.attribute<Vector3>(i);
+            const Containers::StridedArrayView1D<Vector3us> dst{vertexData, reinterpret_cast<Vector3us*>(data), vertexCount, std::ptrdiff_t(stride)};
+            Vector3 min, max;
+            if(vertexCount) min = max = src[0];
+            for(const Vector3& position: src) {
+                min = Math::min(min, position);
+                max = Math::max(max, position);
+            }
+            Float scale = (max - min).max();
+            if(scale == 0.0f) scale = 1.0f;
+            for(std::size_t j = 0; j != vertexCount; ++j) {
+                const Vector3 normalized = (src[j] - min)/scale;
+                dst[j] = Vector3us{
+                    UnsignedShort(meshopt_quantizeUnorm(normalized.x(), 16)),
+                    UnsignedShort(meshopt_quantizeUnorm(normalized.y(), 16)),
+                    UnsignedShort(meshopt_quantizeUnorm(normalized.z(), 16))};
+            }
+            positionDequantization = Matrix4::translation(min)*Matrix4::scaling(Vector3{scale});
+
+        /* Normals, tangents and bitangents */
+        } else if(formats[i] == VertexFormat::Vector3bNormalized) {
+            const Containers::StridedArrayView1D<const Vector3> src = mesh.attribute<Vector3>(i);
+            const Containers::StridedArrayView1D<Vector3b> dst{vertexData, reinterpret_cast<Vector3b*>(data), vertexCount, std::ptrdiff_t(stride)};
+            for(std::size_t j = 0; j != vertexCount; ++j) dst[j] = Vector3b{
+                Byte(meshopt_quantizeSnorm(src[j].x(), 8)),
+                Byte(meshopt_quantizeSnorm(src[j].y(), 8)),
+                Byte(meshopt_quantizeSnorm(src[j].z(), 8))};
+        } else if(formats[i] == VertexFormat::Vector4bNormalized) {
+            const Containers::StridedArrayView1D<const Vector4> src = mesh.attribute<Vector4>(i);
+            const Containers::StridedArrayView1D<Vector4b> dst{vertexData, reinterpret_cast<Vector4b*>(data), vertexCount, std::ptrdiff_t(stride)};
+            for(std::size_t j = 0; j != vertexCount; ++j) dst[j] = Vector4b{
+                Byte(meshopt_quantizeSnorm(src[j].x(), 8)),
+                Byte(meshopt_quantizeSnorm(src[j].y(), 8)),
+                Byte(meshopt_quantizeSnorm(src[j].z(), 8)),
+                Byte(meshopt_quantizeSnorm(src[j].w(), 8))};
+
+        /* Texture coordinates */
+        } else if(formats[i] == VertexFormat::Vector2usNormalized) {
+            const Containers::StridedArrayView1D<const Vector2> src = mesh.attribute<Vector2>(i);
+            const Containers::StridedArrayView1D<Vector2us> dst{vertexData, reinterpret_cast<Vector2us*>(data), vertexCount, std::ptrdiff_t(stride)};
+            for(std::size_t j = 0; j != vertexCount; ++j) dst[j] = Vector2us{
+                UnsignedShort(meshopt_quantizeUnorm(src[j].x(), 16)),
+                UnsignedShort(meshopt_quantizeUnorm(src[j].y(), 16))};
+        } else if(formats[i] == VertexFormat::Vector2h) {
+            const Containers::StridedArrayView1D<const Vector2> src = mesh.attribute<Vector2>(i);
+            const Containers::StridedArrayView1D<Vector2us> dst{vertexData, reinterpret_cast<Vector2us*>(data), vertexCount, std::ptrdiff_t(stride)};
+            for(std::size_t j = 0; j != vertexCount; ++j) dst[j] = Vector2us{
+                meshopt_quantizeHalf(src[j].x()),
+                meshopt_quantizeHalf(src[j].y())};
+        } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    }
+
+    /* Point clouds don't need to be indexed */
+    const MeshIndexData indices = mesh.isIndexed() ? MeshIndexData{mesh.indices()} : MeshIndexData{};
+    Containers::Array<char> indexData = mesh.releaseIndexData();
+    return Containers::optional(MeshData{mesh.primitive(),
+        std::move(indexData), indices,
+        std::move(vertexData), std::move(attributeData), vertexCount});
+}
+
+Containers::Optional<MeshData> convertInternal(const char* const prefix, const MeshData& mesh, const SceneConverterFlags flags, const Utility::ConfigurationGroup& configuration, Containers::Array<MeshOptimizerSceneConverter::LevelOfDetail>& outLevelsOfDetail, Containers::Array<MeshOptimizerSceneConverter::Meshlet>& outMeshlets, Containers::Array<UnsignedInt>& outMeshletVertices, Containers::Array<UnsignedByte>& outMeshletTriangles, Matrix4& outPositionDequantization, Containers::Array<MeshOptimizerSceneConverter::Statistics>& outStatistics, Containers::Array<UnsignedInt>& outShadowIndices, Containers::Array<Vector3>& outShadowPositions, bool& outHasShadowMesh) {
+    outLevelsOfDetail = nullptr;
+    outMeshlets = nullptr;
+    outMeshletVertices = nullptr;
+    outMeshletTriangles = nullptr;
+    outPositionDequantization = Matrix4{};
+    outStatistics = nullptr;
+    outShadowIndices = nullptr;
+    outShadowPositions = nullptr;
+    outHasShadowMesh = false;
+
+    if(configuration.value<bool>("stripify") && configuration.value<UnsignedInt>("lodCount") > 1) {
+        Error{} << prefix << "strip conversion can't be combined with level of detail generation";
+        return Containers::NullOpt;
+    }
+
+    /* Make an interleaved owned copy of the mesh, converting it to an indexed
+       triangle mesh if we have a strip or a fan. The input is const so one
+       copy is unavoidable, but each branch makes only that one --- the
+       outputs of duplicate() and interleave() are always interleaved and
+       owned, and the rvalue overloads of generateIndices() and interleave()
+       pass such data through without copying again. */
+    MeshData out{MeshPrimitive::Triangles, 0};
+    if(mesh.primitive() == MeshPrimitive::TriangleStrip || mesh.primitive() == MeshPrimitive::TriangleFan) {
+        if(mesh.isIndexed())
+            out = MeshTools::generateIndices(MeshTools::duplicate(mesh));
+        else
+            out = MeshTools::interleave(MeshTools::generateIndices(mesh));
+    } else out = MeshTools::interleave(mesh);
+    CORRADE_INTERNAL_ASSERT(MeshTools::isInterleaved(out));
+    CORRADE_INTERNAL_ASSERT((out.vertexDataFlags() & DataFlag::Mutable) && (!out.isIndexed() || (out.indexDataFlags() & DataFlag::Mutable)));
+
+    /* Non-indexed triangle soups, such as STL files, get their duplicate
+       vertices merged */
+    if(out.primitive() == MeshPrimitive::Triangles && !out.isIndexed())
+        out = deduplicateVertices(std::move(out));
+
     meshopt_VertexCacheStatistics vertexCacheStatsBefore;
     meshopt_VertexFetchStatistics vertexFetchStatsBefore;
     meshopt_OverdrawStatistics overdrawStatsBefore;
     Containers::Array<Vector3> positionStorage;
     Containers::StridedArrayView1D<const Vector3> positions;
     Containers::Optional<UnsignedInt> vertexSize;
-    if(!convertInPlaceInternal("Trade::MeshOptimizerSceneConverter::convert():", out, flags(), configuration(), positionStorage, positions, vertexSize, vertexCacheStatsBefore, vertexFetchStatsBefore, overdrawStatsBefore))
+    if(!convertInPlaceInternal(prefix, out, flags, configuration, positionStorage, positions, vertexSize, vertexCacheStatsBefore, vertexFetchStatsBefore, overdrawStatsBefore))
         return Containers::NullOpt;
 
-    if(configuration().value<bool>("simplify") ||
-       configuration().value<bool>("simplifySloppy"))
+    if(configuration.value<bool>("simplify") ||
+       configuration.value<bool>("simplifySloppy"))
     {
-        const UnsignedInt targetIndexCount = out.indexCount()*configuration().value<Float>("simplifyTargetIndexCountThreshold");
-        const Float targetError = configuration().value<Float>("simplifyTargetError");
+        const UnsignedInt targetIndexCount = out.indexCount()*configuration.value<Float>("simplifyTargetIndexCountThreshold");
+        const Float targetError = configuration.value<Float>("simplifyTargetError");
 
         /* In this case meshoptimizer doesn't provide overloads, so let's do
            this on our side instead */
@@ -311,10 +761,10 @@ Containers::Optional<MeshData> MeshOptimizerSceneConverter::doConvert(const Mesh
         }
 
         Containers::Array<UnsignedInt> outputIndices;
-        Containers::arrayResize<Trade::ArrayAllocator>(outputIndices, Containers::NoInit, mesh.indexCount());
+        Containers::arrayResize<Trade::ArrayAllocator>(outputIndices, Containers::NoInit, out.indexCount());
 
         UnsignedInt vertexCount;
-        if(configuration().value<bool>("simplifySloppy"))
+        if(configuration.value<bool>("simplifySloppy"))
             vertexCount = meshopt_simplifySloppy(outputIndices.data(), inputIndices, out.indexCount(), static_cast<const float*>(positions.data()), out.vertexCount(), positions.stride(), targetIndexCount);
         else
             vertexCount = meshopt_simplify(outputIndices.data(), inputIndices, out.indexCount(), static_cast<const float*>(positions.data()), out.vertexCount(), positions.stride(), targetIndexCount, targetError);
@@ -333,19 +783,653 @@ Containers::Optional<MeshData> MeshOptimizerSceneConverter::doConvert(const Mesh
 
         /* If we're printing stats after, repopulate the positions to avoid
            using a now-gone array */
-        if(flags() & SceneConverterFlag::Verbose)
+        if(gatherStatistics(flags, configuration))
             populatePositions(out, positionStorage, positions);
     }
 
-    /* Print before & after stats if verbose output is requested */
-    if(flags() & SceneConverterFlag::Verbose)
-        analyzePost("Trade::MeshOptimizerSceneConverter::convert():", out, configuration(), positions, vertexSize, vertexCacheStatsBefore, vertexFetchStatsBefore, overdrawStatsBefore);
+    /* Level of detail chain. Each level is simplified from the previous one,
+       which is faster than always starting from the full mesh and keeps the
+       levels consistent with each other. */
+    const UnsignedInt lodCount = configuration.value<UnsignedInt>("lodCount");
+    if(lodCount > 1) {
+        /* The positions could have been discarded by simplification above */
+        populatePositions(out, positionStorage, positions);
+
+        const Float threshold = configuration.value<Float>("lodIndexCountThreshold");
+        const Float targetError = configuration.value<Float>("lodTargetError");
+        const bool sloppy = configuration.value<bool>("lodSloppy");
+        const bool optimizeVertexCache = configuration.value<bool>("optimizeVertexCache");
+        const UnsignedInt vertexCount = out.vertexCount();
+
+        Containers::Array<Containers::Array<UnsignedInt>> levels{Containers::ValueInit, lodCount};
+        levels[0] = out.indicesAsArray();
+        for(std::size_t i = 1; i != lodCount; ++i) {
+            const Containers::Array<UnsignedInt>& previous = levels[i - 1];
+            const std::size_t targetIndexCount = std::size_t(previous.size()*threshold)/3*3;
+
+            Containers::Array<UnsignedInt> indices{Containers::NoInit, previous.size()};
+            std::size_t indexCount;
+            if(sloppy)
+                indexCount = meshopt_simplifySloppy(indices.data(), previous.data(), previous.size(), static_cast<const float*>(positions.data()), vertexCount, positions.stride(), targetIndexCount);
+            else
+                indexCount = meshopt_simplify(indices.data(), previous.data(), previous.size(), static_cast<const float*>(positions.data()), vertexCount, positions.stride(), targetIndexCount, targetError);
+
+            levels[i] = Containers::Array<UnsignedInt>{Containers::NoInit, indexCount};
+            Utility::copy(indices.prefix(indexCount), levels[i]);
+            if(optimizeVertexCache)
+                meshopt_optimizeVertexCache(levels[i].data(), levels[i].data(), indexCount, vertexCount);
+        }
+
+        /* Sort the vertices so each level uses a prefix of the vertex buffer.
+           The coarsest level goes first, vertices of each finer level that
+           aren't used by the coarser ones get appended in the order they're
+           first referenced, which keeps the fetch locality. Vertices that
+           aren't referenced at all go last. */
+        constexpr UnsignedInt Unused = ~UnsignedInt{};
+        Containers::Array<UnsignedInt> remap{Containers::NoInit, vertexCount};
+        std::fill(remap.begin(), remap.end(), Unused);
+        Containers::Array<MeshOptimizerSceneConverter::LevelOfDetail> levelsOfDetail{Containers::NoInit, lodCount};
+        UnsignedInt nextVertex = 0;
+        for(std::size_t i = lodCount; i != 0; --i) {
+            for(const UnsignedInt index: levels[i - 1])
+                if(remap[index] == Unused) remap[index] = nextVertex++;
+            levelsOfDetail[i - 1].vertexCount = nextVertex;
+        }
+        for(UnsignedInt& index: remap)
+            if(index == Unused) index = nextVertex++;
+        std::size_t indexOffset = 0;
+        for(std::size_t i = 0; i != lodCount; ++i) {
+            for(UnsignedInt& index: levels[i]) index = remap[index];
+            levelsOfDetail[i].indexOffset = indexOffset;
+            levelsOfDetail[i].indexCount = levels[i].size();
+            indexOffset += levels[i].size();
+        }
+
+        /* Reorder the vertex data in place. The mesh is interleaved and owned
+           at this point, so the attributes can stay as they are. */
+        reorderVertices(out, remap);
+
+        /* All levels go into a single index buffer of the original type, the
+           mesh itself references the finest one */
+        const UnsignedInt indexTypeSize = meshIndexTypeSize(out.indexType());
+        Containers::Array<char> indexData{Containers::NoInit, indexOffset*indexTypeSize};
+        MeshIndexData indices;
+        if(out.indexType() == MeshIndexType::UnsignedInt)
+            indices = copyLevelsOfDetail<UnsignedInt>(levels, indexData);
+        else if(out.indexType() == MeshIndexType::UnsignedShort)
+            indices = copyLevelsOfDetail<UnsignedShort>(levels, indexData);
+        else if(out.indexType() == MeshIndexType::UnsignedByte)
+            indices = copyLevelsOfDetail<UnsignedByte>(levels, indexData);
+        else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+
+        out = MeshData{out.primitive(), std::move(indexData), indices,
+            out.releaseVertexData(), out.releaseAttributeData(), vertexCount};
+        outLevelsOfDetail = std::move(levelsOfDetail);
+
+        /* If we're printing stats after, repopulate the positions as the
+           vertices got reordered */
+        if(gatherStatistics(flags, configuration))
+            populatePositions(out, positionStorage, positions);
+    }
+
+    /* Meshlets go last, for the finest level if LODs were generated. The
+       positions could have been copied before the vertices got reordered. */
+    if(configuration.value<bool>("buildMeshlets")) {
+        populatePositions(out, positionStorage, positions);
+        buildMeshlets(out, configuration, positions, outMeshlets, outMeshletVertices, outMeshletTriangles);
+    }
+
+    /* Shadow mesh also for the finest level, before quantization as it needs
+       the float positions */
+    if(configuration.value<bool>("generateShadowIndices")) {
+        populatePositions(out, positionStorage, positions);
+        generateShadowMesh(out, configuration, positions, outShadowIndices, outShadowPositions);
+        outHasShadowMesh = true;
+    }
+
+    /* Quantization changes the vertex layout, so it goes after everything
+       else that needs float positions */
+    if(configuration.value<bool>("quantizePositions") ||
+       configuration.value<bool>("quantizeNormals") ||
+       configuration.value<bool>("quantizeTextureCoordinates"))
+    {
+        Containers::Optional<MeshData> quantized = quantize(prefix, std::move(out), configuration, outPositionDequantization);
+        if(!quantized) {
+            outLevelsOfDetail = nullptr;
+            outMeshlets = nullptr;
+            outMeshletVertices = nullptr;
+            outMeshletTriangles = nullptr;
+            outShadowIndices = nullptr;
+            outShadowPositions = nullptr;
+            outHasShadowMesh = false;
+            return Containers::NullOpt;
+        }
+        out = std::move(*quantized);
+
+        /* If we're printing stats after, the positions and vertex size need to
+           be calculated again for the new layout. There are no
+           implementation-specific formats at this point, quantize() would
+           fail otherwise. */
+        if(gatherStatistics(flags, configuration)) {
+            if(out.hasAttribute(MeshAttribute::Position))
+                populatePositions(out, positionStorage, positions);
+            vertexSize = 0;
+            for(UnsignedInt i = 0; i != out.attributeCount(); ++i) {
+                const UnsignedInt arraySize = out.attributeArraySize(i);
+                *vertexSize += vertexFormatSize(out.attributeFormat(i))*(arraySize ? arraySize : 1);
+            }
+        }
+    }
+
+    /* Print before & after stats if verbose output is requested. The
+       efficiency analyzers have nothing to measure on point clouds. */
+    if(gatherStatistics(flags, configuration) && out.primitive() != MeshPrimitive::Points)
+        analyzePost(prefix, out, flags, configuration, positions, vertexSize, vertexCacheStatsBefore, vertexFetchStatsBefore, overdrawStatsBefore, outStatistics);
+
+    /* Strip conversion goes after the stats, as the efficiency analyzers
+       work with triangle lists only */
+    if(configuration.value<bool>("stripify")) {
+        const UnsignedInt listIndexCount = out.indexCount();
+        const std::size_t listIndexSize = out.indexData().size();
+        out = stripify(std::move(out), configuration.value<bool>("stripifyRestart"));
+
+        if(flags & SceneConverterFlag::Verbose) Debug{}
+            << prefix << "strip conversion:\n   " << listIndexCount << "->"
+            << out.indexCount() << "indices\n   " << listIndexSize << "->"
+            << out.indexData().size() << "bytes";
+    }
 
     /* GCC 4.8 needs an explicit conversion, otherwise it tries to copy the
        thing and fails */
     return Containers::optional(std::move(out));
 }
 
+/* Per-thread scratch memory for meshoptimizer's internal allocations in
+   convertBatch(). Each meshoptimizer function frees everything it allocated
+   before returning, so a bump allocator that rewinds once there are no
+   outstanding allocations is enough. If the memory isn't large enough, the
+   allocation falls back to the heap and the memory gets enlarged the next
+   time it rewinds, so after a few meshes there are no allocations anymore.
+   Threads without any scratch set up behave the same as the default
+   meshoptimizer allocator. */
+struct Scratch {
+    Containers::Array<char> data;
+    std::size_t offset{}, outstanding{}, required{};
+};
+
+CORRADE_THREAD_LOCAL Scratch* currentScratch = nullptr;
+
+void* scratchAllocate(std::size_t size) {
+    Scratch* const scratch = currentScratch;
+    if(!scratch) return ::operator new(size);
+
+    /* Keep all allocations aligned for any type */
+    size = (size + 15) & ~std::size_t{15};
+    ++scratch->outstanding;
+    scratch->required += size;
+    if(scratch->offset + size > scratch->data.size())
+        return ::operator new(size);
+
+    void* const out = scratch->data + scratch->offset;
+    scratch->offset += size;
+    return out;
+}
+
+void scratchDeallocate(void* const pointer) {
+    Scratch* const scratch = currentScratch;
+    if(!scratch) return ::operator delete(pointer);
+
+    const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(pointer);
+    if(address < reinterpret_cast<std::uintptr_t>(scratch->data.begin()) ||
+       address >= reinterpret_cast<std::uintptr_t>(scratch->data.end()))
+        ::operator delete(pointer);
+
+    if(--scratch->outstanding) return;
+    if(scratch->required > scratch->data.size())
+        scratch->data = Containers::Array<char>{Containers::NoInit, scratch->required};
+    scratch->offset = 0;
+    scratch->required = 0;
+}
+
+}
+
+auto MeshOptimizerSceneConverter::levelsOfDetail() const -> Containers::ArrayView<const LevelOfDetail> {
+    return _levelsOfDetail;
+}
+
+auto MeshOptimizerSceneConverter::meshlets() const -> Containers::ArrayView<const Meshlet> {
+    return _meshlets;
+}
+
+Containers::ArrayView<const UnsignedInt> MeshOptimizerSceneConverter::meshletVertices() const {
+    return _meshletVertices;
+}
+
+Containers::ArrayView<const UnsignedByte> MeshOptimizerSceneConverter::meshletTriangles() const {
+    return _meshletTriangles;
+}
+
+Matrix4 MeshOptimizerSceneConverter::positionDequantization() const {
+    return _positionDequantization;
+}
+
+auto MeshOptimizerSceneConverter::statistics() const -> Containers::ArrayView<const Statistics> {
+    return _statistics;
+}
+
+Containers::Optional<MeshData> MeshOptimizerSceneConverter::shadowMesh() const {
+    if(!_hasShadowMesh) return Containers::NullOpt;
+
+    const Containers::ArrayView<const UnsignedInt> indices = _shadowIndices;
+    const Containers::ArrayView<const Vector3> positions = _shadowPositions;
+    return Containers::optional(MeshData{MeshPrimitive::Triangles,
+        {}, indices, MeshIndexData{indices},
+        {}, positions, {MeshAttributeData{MeshAttribute::Position, positions}},
+        UnsignedInt(positions.size())});
+}
+
+bool MeshOptimizerSceneConverter::doConvertInPlace(MeshData& mesh) {
+    _levelsOfDetail = nullptr;
+    _meshlets = nullptr;
+    _meshletVertices = nullptr;
+    _meshletTriangles = nullptr;
+    _positionDequantization = Matrix4{};
+    _statistics = nullptr;
+    _shadowIndices = nullptr;
+    _shadowPositions = nullptr;
+    _hasShadowMesh = false;
+
+    /* Point clouds get only the vertices sorted, and the indices remapped if
+       there are any */
+    if(mesh.primitive() == MeshPrimitive::Points) {
+        if(configuration().value<bool>("spatialSort")) {
+            if(mesh.isIndexed() && !(mesh.indexDataFlags() & DataFlag::Mutable)) {
+                Error{} << "Trade::MeshOptimizerSceneConverter::convertInPlace(): spatialSort requires index data to be mutable";
+                return false;
+            }
+
+            if(!(mesh.vertexDataFlags() & DataFlag::Mutable)) {
+                Error{} << "Trade::MeshOptimizerSceneConverter::convertInPlace(): spatialSort requires vertex data to be mutable";
+                return false;
+            }
+
+            if(!MeshTools::isInterleaved(mesh)) {
+                Error{} << "Trade::MeshOptimizerSceneConverter::convertInPlace(): spatialSort requires the mesh to be interleaved";
+                return false;
+            }
+        }
+
+    } else if((configuration().value<bool>("optimizeVertexCache") ||
+        configuration().value<bool>("optimizeOverdraw") ||
+        configuration().value<bool>("optimizeVertexFetch") ||
+        configuration().value<bool>("spatialSort")) &&
+       !(mesh.indexDataFlags() & DataFlag::Mutable))
+    {
+        Error{} << "Trade::MeshOptimizerSceneConverter::convertInPlace(): optimizeVertexCache, optimizeOverdraw, optimizeVertexFetch and spatialSort require index data to be mutable";
+        return false;
+    }
+
+    if(mesh.primitive() != MeshPrimitive::Points && configuration().value<bool>("optimizeVertexFetch")) {
+        if(!(mesh.vertexDataFlags() & DataFlag::Mutable)) {
+            Error{} << "Trade::MeshOptimizerSceneConverter::convertInPlace(): optimizeVertexFetch requires vertex data to be mutable";
+            return false;
+        }
+
+        if(!MeshTools::isInterleaved(mesh)) {
+            Error{} << "Trade::MeshOptimizerSceneConverter::convertInPlace(): optimizeVertexFetch requires the mesh to be interleaved";
+            return false;
+        }
+    }
+
+
+    if(configuration().value<bool>("simplify") ||
+       configuration().value<bool>("simplifySloppy"))
+    {
+        Error{} << "Trade::MeshOptimizerSceneConverter::convertInPlace(): mesh simplification can't be performed in-place, use convert() instead";
+        return false;
+    }
+
+    if(configuration().value<UnsignedInt>("lodCount") > 1) {
+        Error{} << "Trade::MeshOptimizerSceneConverter::convertInPlace(): level of detail generation can't be performed in-place, use convert() instead";
+        return false;
+    }
+
+    if(configuration().value<bool>("quantizePositions") ||
+       configuration().value<bool>("quantizeNormals") ||
+       configuration().value<bool>("quantizeTextureCoordinates"))
+    {
+        Error{} << "Trade::MeshOptimizerSceneConverter::convertInPlace(): vertex quantization can't be performed in-place, use convert() instead";
+        return false;
+    }
+
+    if(configuration().value<bool>("stripify")) {
+        Error{} << "Trade::MeshOptimizerSceneConverter::convertInPlace(): strip conversion can't be performed in-place, use convert() instead";
+        return false;
+    }
+
+    meshopt_VertexCacheStatistics vertexCacheStatsBefore;
+    meshopt_VertexFetchStatistics vertexFetchStatsBefore;
+    meshopt_OverdrawStatistics overdrawStatsBefore;
+    Containers::Array<Vector3> positionStorage;
+    Containers::StridedArrayView1D<const Vector3> positions;
+    Containers::Optional<UnsignedInt> vertexSize;
+    if(!convertInPlaceInternal("Trade::MeshOptimizerSceneConverter::convertInPlace():", mesh, flags(), configuration(), positionStorage, positions, vertexSize, vertexCacheStatsBefore, vertexFetchStatsBefore, overdrawStatsBefore))
+        return false;
+
+    /* Meshlets go last. The vertex fetch optimization could have reordered
+       the vertices, so repopulate the positions in case they were copied. */
+    if(configuration().value<bool>("buildMeshlets")) {
+        populatePositions(mesh, positionStorage, positions);
+        buildMeshlets(mesh, configuration(), positions, _meshlets, _meshletVertices, _meshletTriangles);
+    }
+
+    if(configuration().value<bool>("generateShadowIndices")) {
+        populatePositions(mesh, positionStorage, positions);
+        generateShadowMesh(mesh, configuration(), positions, _shadowIndices, _shadowPositions);
+        _hasShadowMesh = true;
+    }
+
+    if(gatherStatistics(flags(), configuration()) && mesh.primitive() != MeshPrimitive::Points)
+        analyzePost("Trade::MeshOptimizerSceneConverter::convertInPlace():", mesh, flags(), configuration(), positions, vertexSize, vertexCacheStatsBefore, vertexFetchStatsBefore, overdrawStatsBefore, _statistics);
+
+    return true;
+}
+
+Containers::Optional<MeshData> MeshOptimizerSceneConverter::doConvert(const MeshData& mesh) {
+    return convertInternal("Trade::MeshOptimizerSceneConverter::convert():", mesh, flags(), configuration(), _levelsOfDetail, _meshlets, _meshletVertices, _meshletTriangles, _positionDequantization, _statistics, _shadowIndices, _shadowPositions, _hasShadowMesh);
+}
+
+Containers::Array<char> MeshOptimizerSceneConverter::doConvertToData(const MeshData& mesh) {
+    /* The index codec used for the output is designed for triangle lists */
+    if(configuration().value<bool>("stripify")) {
+        Error{} << "Trade::MeshOptimizerSceneConverter::convertToData(): strip conversion isn't supported for compressed output";
+        return nullptr;
+    }
+    if(mesh.primitive() == MeshPrimitive::Points) {
+        Error{} << "Trade::MeshOptimizerSceneConverter::convertToData(): point clouds aren't supported for compressed output";
+        return nullptr;
+    }
+
+    /* Process the mesh first, the vertex cache and vertex fetch optimizations
+       make the data compress better */
+    Containers::Optional<MeshData> out = convertInternal("Trade::MeshOptimizerSceneConverter::convertToData():", mesh, flags(), configuration(), _levelsOfDetail, _meshlets, _meshletVertices, _meshletTriangles, _positionDequantization, _statistics, _shadowIndices, _shadowPositions, _hasShadowMesh);
+    if(!out) return nullptr;
+
+    /* Decide on the layout of attributes that can be represented in glTF.
+       Each attribute is aligned to four bytes, as both glTF and the vertex
+       codec need that for the stride. */
+    struct Attribute {
+        UnsignedInt id;
+        std::string name;
+        UnsignedInt offset;
+        UnsignedInt componentType;
+        const char* type;
+        bool normalized;
+    };
+    Containers::Array<Attribute> attributes{Containers::ValueInit, out->attributeCount()};
+    std::size_t attributeCount = 0;
+    std::size_t stride = 0;
+    UnsignedInt textureCoordinateCount = 0;
+    UnsignedInt colorCount = 0;
+    bool quantized = false;
+    for(UnsignedInt i = 0; i != out->attributeCount(); ++i) {
+        const MeshAttribute name = out->attributeName(i);
+        const VertexFormat format = out->attributeFormat(i);
+        if(isVertexFormatImplementationSpecific(format)) {
+            Warning{} << "Trade::MeshOptimizerSceneConverter::convertToData(): skipping attribute" << name << "with" << format;
+            continue;
+        }
+
+        UnsignedInt componentType;
+        switch(vertexFormatComponentFormat(format)) {
+            case VertexFormat::Float:
+                componentType = 5126;
+                break;
+            case VertexFormat::UnsignedByte:
+            case VertexFormat::UnsignedByteNormalized:
+                componentType = 5121;
+                break;
+            case VertexFormat::Byte:
+            case VertexFormat::ByteNormalized:
+                componentType = 5120;
+                break;
+            case VertexFormat::UnsignedShort:
+            case VertexFormat::UnsignedShortNormalized:
+                componentType = 5123;
+                break;
+            case VertexFormat::Short:
+            case VertexFormat::ShortNormalized:
+                componentType = 5122;
+                break;
+            case VertexFormat::UnsignedInt:
+                componentType = 5125;
+                break;
+            default:
+                Warning{} << "Trade::MeshOptimizerSceneConverter::convertToData(): skipping attribute" << name << "with unsupported format" << format;
+                continue;
+        }
+
+        const UnsignedInt componentCount = vertexFormatComponentCount(format);
+        if(vertexFormatVectorCount(format) != 1) {
+            Warning{} << "Trade::MeshOptimizerSceneConverter::convertToData(): skipping attribute" << name << "with unsupported format" << format;
+            continue;
+        }
+        if(out->attributeArraySize(i)) {
+            Warning{} << "Trade::MeshOptimizerSceneConverter::convertToData(): skipping array attribute" << name;
+            continue;
+        }
+
+        std::string gltfName;
+        if(name == MeshAttribute::Position) {
+            if(componentCount != 3) {
+                Error{} << "Trade::MeshOptimizerSceneConverter::convertToData(): two-component positions are not supported";
+                return nullptr;
+            }
+            gltfName = "POSITION";
+        } else if(name == MeshAttribute::Normal) {
+            gltfName = "NORMAL";
+        } else if(name == MeshAttribute::Tangent && componentCount == 4) {
+            gltfName = "TANGENT";
+        } else if(name == MeshAttribute::TextureCoordinates) {
+            gltfName = Utility::formatString("TEXCOORD_{}", textureCoordinateCount++);
+        } else if(name == MeshAttribute::Color) {
+            gltfName = Utility::formatString("COLOR_{}", colorCount++);
+        } else if(name == MeshAttribute::ObjectId) {
+            gltfName = configuration().value("objectIdAttribute");
+        } else {
+            Warning{} << "Trade::MeshOptimizerSceneConverter::convertToData(): skipping unsupported attribute" << name;
+            continue;
+        }
+
+        /* Integer positions, normals and tangents and non-normalized or
+           signed texture coordinates need KHR_mesh_quantization */
+        if(((name == MeshAttribute::Position || name == MeshAttribute::Normal || name == MeshAttribute::Tangent) && componentType != 5126) ||
+           (name == MeshAttribute::TextureCoordinates && componentType != 5126 && (!isVertexFormatNormalized(format) || componentType == 5120 || componentType == 5122)))
+            quantized = true;
+
+        constexpr const char* Types[]{"SCALAR", "VEC2", "VEC3", "VEC4"};
+        attributes[attributeCount++] = Attribute{i, std::move(gltfName),
+            UnsignedInt(stride), componentType, Types[componentCount - 1],
+            isVertexFormatNormalized(format)};
+        stride += (vertexFormatSize(format) + 3)/4*4;
+    }
+
+    if(!attributeCount) {
+        Error{} << "Trade::MeshOptimizerSceneConverter::convertToData(): the mesh has no attributes that can be exported";
+        return nullptr;
+    }
+
+    if(stride > 256) {
+        Error{} << "Trade::MeshOptimizerSceneConverter::convertToData(): expected vertex size to be at most 256 bytes but got" << stride;
+        return nullptr;
+    }
+
+    /* Copy the exported attributes into the new layout, zero-filling the
+       padding so it compresses well */
+    const UnsignedInt vertexCount = out->vertexCount();
+    Containers::Array<char> vertices{Containers::ValueInit, vertexCount*stride};
+    for(std::size_t i = 0; i != attributeCount; ++i) {
+        const Attribute& attribute = attributes[i];
+        const Containers::StridedArrayView2D<const char> src = out->attribute(attribute.id);
+        for(std::size_t j = 0; j != vertexCount; ++j)
+            std::memcpy(vertices + j*stride + attribute.offset, src[j].data(), src.size()[1]);
+    }
+
+    /* The index codec works with 16- and 32-bit indices, expand 8-bit ones */
+    const Containers::Array<UnsignedInt> indices = out->indicesAsArray();
+    const bool indices32 = out->indexType() == MeshIndexType::UnsignedInt;
+    const std::size_t indexSize = indices32 ? 4 : 2;
+
+    /* Encode both */
+    Containers::Array<unsigned char> encodedVertices{Containers::NoInit, meshopt_encodeVertexBufferBound(vertexCount, stride)};
+    const std::size_t encodedVertexSize = meshopt_encodeVertexBuffer(encodedVertices.data(), encodedVertices.size(), vertices.data(), vertexCount, stride);
+    Containers::Array<unsigned char> encodedIndices{Containers::NoInit, meshopt_encodeIndexBufferBound(indices.size(), vertexCount)};
+    const std::size_t encodedIndexSize = meshopt_encodeIndexBuffer(encodedIndices.data(), encodedIndices.size(), indices.data(), indices.size());
+
+    /* Both go into the binary chunk after each other, the fallback buffer
+       has the decoded size of both with indices aligned to four bytes */
+    const std::size_t encodedIndexOffset = (encodedVertexSize + 3)/4*4;
+    const std::size_t binSize = (encodedIndexOffset + encodedIndexSize + 3)/4*4;
+    const std::size_t indexOffset = vertices.size();
+    const std::size_t fallbackSize = indexOffset + (indices.size()*indexSize + 3)/4*4;
+
+    /* Accessor for each attribute, positions additionally have the bounds as
+       the spec requires them. Calculating those only for float positions for
+       simplicity. */
+    std::string attributeJson, accessorJson;
+    for(std::size_t i = 0; i != attributeCount; ++i) {
+        const Attribute& attribute = attributes[i];
+        if(i) attributeJson += ", ";
+        attributeJson += Utility::formatString("\"{}\": {}", attribute.name, i);
+
+        std::string bounds;
+        if(out->attributeName(attribute.id) == MeshAttribute::Position && out->attributeFormat(attribute.id) == VertexFormat::Vector3 && vertexCount) {
+            const Containers::StridedArrayView1D<const Vector3> positions = out->attribute<Vector3>(attribute.id);
+            Vector3 min = positions[0], max = positions[0];
+            for(const Vector3& position: positions) {
+                min = Math::min(min, position);
+                max = Math::max(max, position);
+            }
+            bounds = Utility::formatString(", \"min\": [{:.9}, {:.9}, {:.9}], \"max\": [{:.9}, {:.9}, {:.9}]", min.x(), min.y(), min.z(), max.x(), max.y(), max.z());
+        }
+
+        accessorJson += Utility::formatString(
+            "{{\"bufferView\": 0, \"byteOffset\": {}, \"componentType\": {}, {}\"count\": {}, \"type\": \"{}\"{}}}, ",
+            attribute.offset, attribute.componentType,
+            attribute.normalized ? "\"normalized\": true, " : "",
+            vertexCount, attribute.type, bounds);
+    }
+    accessorJson += Utility::formatString(
+        "{{\"bufferView\": 1, \"componentType\": {}, \"count\": {}, \"type\": \"SCALAR\"}}",
+        indices32 ? 5125 : 5123, indices.size());
+
+    /* Quantized positions get dequantized by the node transformation */
+    std::string matrix;
+    if(_positionDequantization != Matrix4{}) {
+        matrix = ", \"matrix\": [";
+        for(std::size_t i = 0; i != 16; ++i) {
+            if(i) matrix += ", ";
+            matrix += Utility::formatString("{:.9}", _positionDequantization.data()[i]);
+        }
+        matrix += "]";
+    }
+
+    const char* const extensions = quantized ?
+        R"(["EXT_meshopt_compression", "KHR_mesh_quantization"])" :
+        R"(["EXT_meshopt_compression"])";
+    std::string json = Utility::formatString(R"({{"asset": {{"version": "2.0", "generator": "Magnum MeshOptimizerSceneConverter"}}, )"
+        R"("extensionsUsed": {}, )"
+        R"("extensionsRequired": {}, )"
+        R"("scene": 0, "scenes": [{{"nodes": [0]}}], "nodes": [{{"mesh": 0{}}}], )"
+        R"("meshes": [{{"primitives": [{{"attributes": {{{}}}, "indices": {}, "mode": 4}}]}}], )"
+        R"("accessors": [{}], )"
+        R"("bufferViews": [)"
+            R"({{"buffer": 1, "byteLength": {}, "byteStride": {}, "target": 34962, "extensions": {{"EXT_meshopt_compression": {{"buffer": 0, "byteLength": {}, "byteStride": {}, "count": {}, "mode": "ATTRIBUTES"}}}}}}, )"
+            R"({{"buffer": 1, "byteOffset": {}, "byteLength": {}, "target": 34963, "extensions": {{"EXT_meshopt_compression": {{"buffer": 0, "byteOffset": {}, "byteLength": {}, "byteStride": {}, "count": {}, "mode": "TRIANGLES"}}}}}}], )"
+        R"("buffers": [{{"byteLength": {}}}, {{"byteLength": {}, "extensions": {{"EXT_meshopt_compression": {{"fallback": true}}}}}}]}})",
+        extensions, extensions, matrix,
+        attributeJson, attributeCount, accessorJson,
+        vertices.size(), stride, encodedVertexSize, stride, vertexCount,
+        indexOffset, indices.size()*indexSize, encodedIndexOffset, encodedIndexSize, indexSize, indices.size(),
+        binSize, fallbackSize);
+    /* The JSON chunk is padded with spaces */
+    json.resize((json.size() + 3)/4*4, ' ');
+
+    /* Assemble the GLB, the binary chunk is padded with zeros */
+    Containers::Array<char> glb{Containers::ValueInit, 28 + json.size() + binSize};
+    const UnsignedInt header[]{
+        0x46546C67, 2, UnsignedInt(glb.size()),
+        UnsignedInt(json.size()), 0x4E4F534A};
+    std::memcpy(glb, header, sizeof(header));
+    std::memcpy(glb + 20, json.data(), json.size());
+    const UnsignedInt binHeader[]{UnsignedInt(binSize), 0x004E4942};
+    std::memcpy(glb + 20 + json.size(), binHeader, sizeof(binHeader));
+    std::memcpy(glb + 28 + json.size(), encodedVertices, encodedVertexSize);
+    std::memcpy(glb + 28 + json.size() + encodedIndexOffset, encodedIndices, encodedIndexSize);
+    return glb;
+}
+
+Containers::Array<Containers::Optional<MeshData>> MeshOptimizerSceneConverter::convertBatch(const Containers::ArrayView<const Containers::Reference<const MeshData>> meshes) {
+    /* The per-mesh state isn't meaningful for more than one mesh */
+    _levelsOfDetail = nullptr;
+    _meshlets = nullptr;
+    _meshletVertices = nullptr;
+    _meshletTriangles = nullptr;
+    _positionDequantization = Matrix4{};
+    _statistics = nullptr;
+    _shadowIndices = nullptr;
+    _shadowPositions = nullptr;
+    _hasShadowMesh = false;
+
+    Containers::Array<Containers::Optional<MeshData>> out{meshes.size()};
+
+    #ifdef CORRADE_BUILD_MULTITHREADED
+    UnsignedInt threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+    #else
+    constexpr UnsignedInt threadCount = 1;
+    #endif
+    const std::size_t workerCount = Math::min(std::size_t(threadCount), Math::max(meshes.size(), std::size_t{1}));
+
+    /* The allocator is global for the whole meshoptimizer library, so it's
+       set only for the duration of the batch. Threads that don't have any
+       scratch set up use the default allocation, so other meshoptimizer use
+       in the meantime isn't affected. */
+    Containers::Array<Scratch> scratch{workerCount};
+    meshopt_setAllocator(scratchAllocate, scratchDeallocate);
+
+    /* Meshes are distributed dynamically as their processing cost can vary a
+       lot */
+    std::atomic<std::size_t> next{0};
+    auto convertMeshes = [&](Scratch& workerScratch) {
+        currentScratch = &workerScratch;
+        Containers::Array<LevelOfDetail> levelsOfDetail;
+        Containers::Array<Meshlet> meshlets;
+        Containers::Array<UnsignedInt> meshletVertices;
+        Containers::Array<UnsignedByte> meshletTriangles;
+        Matrix4 positionDequantization;
+        Containers::Array<Statistics> statistics;
+        Containers::Array<UnsignedInt> shadowIndices;
+        Containers::Array<Vector3> shadowPositions;
+        bool hasShadowMesh;
+        std::size_t i;
+        while((i = next++) < meshes.size())
+            out[i] = convertInternal("Trade::MeshOptimizerSceneConverter::convertBatch():", meshes[i], flags(), configuration(), levelsOfDetail, meshlets, meshletVertices, meshletTriangles, positionDequantization, statistics, shadowIndices, shadowPositions, hasShadowMesh);
+        currentScratch = nullptr;
+    };
+
+    Containers::Array<std::thread> threads{workerCount - 1};
+    for(std::size_t i = 0; i != threads.size(); ++i)
+        threads[i] = std::thread{convertMeshes, std::ref(scratch[i + 1])};
+    convertMeshes(scratch[0]);
+    for(std::thread& thread: threads) thread.join();
+
+    /* Restore the default meshoptimizer allocator */
+    meshopt_setAllocator(static_cast<void*(*)(std::size_t)>(::operator new), static_cast<void(*)(void*)>(::operator delete));
+
+    return out;
+}
+
 }}
 
 CORRADE_PLUGIN_REGISTER(MeshOptimizerSceneConverter, Magnum::Trade::MeshOptimizerSceneConverter,
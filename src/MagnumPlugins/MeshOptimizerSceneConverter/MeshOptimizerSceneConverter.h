@@ -30,6 +30,8 @@
  * @m_since_latest_{plugins}
  */
 
+#include <Corrade/Containers/Array.h>
+#include <Magnum/Math/Matrix4.h>
 #include <Magnum/Trade/AbstractSceneConverter.h>
 
 #include "MagnumPlugins/MeshOptimizerSceneConverter/configure.h"
@@ -122,11 +124,20 @@ plugin-specific options:
 The optimizations can be done either in-place using @ref convertInPlace(MeshData&),
 in which case the input is required to be an indexed triangle mesh with mutable
 index data and, in case of @cb{.ini} optimizeVertexFetch @ce, also mutable
-vertex data. Alternatively, the operation can be performed using
+vertex data. Point clouds are handled separately, see
+@ref Trade-MeshOptimizerSceneConverter-behavior-spatial-sort below. Alternatively, the operation can be performed using
 @ref convert(const MeshData&), which accepts also triangle strips and fans,
 returning always an indexed triangle mesh without requiring the input to be
 mutable.
 
+Non-indexed triangle meshes, such as triangle soups coming from STL files, are
+accepted by @ref convert(const MeshData&) as well. Duplicate vertices in those
+are merged using meshoptimizer's
+[indexing](https://github.com/zeux/meshoptimizer#indexing) before any other
+processing, with the output having @ref MeshIndexType::UnsignedInt indices.
+Vertices are compared attribute by attribute, so padding between attributes
+doesn't prevent them from being merged.
+
 The output has the same index type as input and all attributes are preserved,
 including custom attributes and attributes with implementation-specific vertex
 formats, except for @cb{.ini} optimizeOverdraw @ce, which needs a position
@@ -135,6 +146,34 @@ attribute in a known type.
 When @ref SceneConverterFlag::Verbose is enabled, the plugin prints the output
 from meshoptimizer's [efficiency analyzers](https://github.com/zeux/meshoptimizer#efficiency-analyzers)
 before and after the operation.
+The same values are available in a machine-readable form through
+@ref statistics(), which is populated also if the @cb{.ini} statistics @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration option"
+is enabled, without printing anything.
+
+@subsection Trade-MeshOptimizerSceneConverter-behavior-spatial-sort Spatial sort and point clouds
+
+Enabling the @cb{.ini} spatialSort @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration option"
+reorders the mesh in [Morton order](https://github.com/zeux/meshoptimizer#point-cloud-compression)
+based on its positions, so primitives close to each other in space are close
+to each other in memory as well. For triangle meshes the triangles are
+reordered with @cpp meshopt_spatialSortTriangles() @ce before the vertex cache
+optimization, which is mainly useful for triangle soups where the original
+triangle order is arbitrary.
+
+Meshes with @ref MeshPrimitive::Points, such as point clouds coming from
+@ref StanfordImporter, are accepted by both @ref convert(const MeshData&) and
+@ref convertInPlace(MeshData&), indexed or not. The only operation done on
+those is reordering the vertices with @cpp meshopt_spatialSortRemap() @ce if
+@cb{.ini} spatialSort @ce is enabled and quantization in
+@ref convert(const MeshData&), the vertex cache, overdraw and vertex fetch
+optimizations are ignored and @ref statistics() are empty. If the point cloud
+is indexed, the indices are remapped to point to the same vertices.
+Simplification, levels of detail, meshlets, shadow indices, strip conversion
+and @ref convertToData(const MeshData&) aren't supported for point clouds. In
+case of @ref convertInPlace(MeshData&) the spatial sort requires the mesh to
+be interleaved with mutable vertex data and, if indexed, mutable index data.
 
 @subsection Trade-MeshOptimizerSceneConverter-behavior-simplification Mesh simplification
 
@@ -152,6 +191,154 @@ to new locations. It only requires the mesh to have a position attribute, mesh
 connectivity and face seams are figured out from the index buffer. As with all
 other operations, all original attributes are preserved.
 
+@subsection Trade-MeshOptimizerSceneConverter-behavior-lod Level of detail generation
+
+Setting the @cb{.ini} lodCount @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration option" to
+a value larger than @cpp 1 @ce makes @ref convert(const MeshData&) generate a
+chain of progressively coarser levels of detail. Each level is simplified from
+the previous one to @cb{.ini} lodIndexCountThreshold @ce of its index count,
+setting @cb{.ini} lodSloppy @ce uses the sloppy simplifier instead. As with
+simplification, this can't be done in-place.
+
+All levels share a single vertex buffer and are put after each other into a
+single index buffer, in the original index type, with the finest level first.
+The returned mesh references just the finest level, the index ranges of all
+levels are available through @ref levelsOfDetail() until the next conversion.
+The vertices are sorted so each level references only a prefix of the vertex
+buffer --- the vertices used by the coarsest level are first, followed by
+vertices additionally used by each finer level. A renderer can thus bind the
+vertex and index buffer once and draw any level with a different index range
+and vertex count. Because of the reordering, the vertex fetch optimization is
+only approximate for the finer levels.
+
+@subsection Trade-MeshOptimizerSceneConverter-behavior-meshlets Meshlet generation
+
+If the @cb{.ini} buildMeshlets @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration option" is
+enabled, the index buffer is additionally split into
+[meshlets](https://github.com/zeux/meshoptimizer#mesh-shading) of at most
+@cb{.ini} meshletMaxVertices @ce vertices and @cb{.ini} meshletMaxTriangles @ce
+triangles, suitable for mesh shaders and GPU-driven cluster culling. This is
+done as the last step in both @ref convert(const MeshData&) and
+@ref convertInPlace(MeshData&) and doesn't modify the mesh itself. If levels
+of detail are generated, the meshlets are built for the finest level. The
+result is available through @ref meshlets(), @ref meshletVertices() and
+@ref meshletTriangles() until the next conversion and requires the mesh to
+have positions. Each meshlet has a bounding sphere and a normal cone
+calculated, enabling frustum, occlusion and backface culling of whole
+meshlets.
+
+@subsection Trade-MeshOptimizerSceneConverter-behavior-stripify Triangle strip output
+
+On targets where index bandwidth matters, enabling the @cb{.ini} stripify @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration option"
+makes @ref convert(const MeshData&) output a @ref MeshPrimitive::TriangleStrip
+using meshoptimizer's [triangle strip conversion](https://github.com/zeux/meshoptimizer#triangle-strip-conversion),
+done as the very last step, after the vertex cache optimization. By default the
+strips are separated with a primitive restart index, which is the maximal
+value of the index type and matches what for example
+@m_class{m-doc-external} [GL_PRIMITIVE_RESTART_FIXED_INDEX](https://www.khronos.org/opengl/wiki/Vertex_Rendering#Primitive_Restart)
+or Vulkan use. If the last vertex would collide with the restart index, the
+index type is widened. Disabling @cb{.ini} stripifyRestart @ce separates the
+strips with degenerate triangles instead, for targets without primitive
+restart support. When @ref SceneConverterFlag::Verbose is enabled, the index
+count and size before and after the conversion is printed, the
+@ref statistics() are calculated for the triangle list before the conversion.
+Strip conversion can't be done in-place, can't be combined with level of
+detail generation and isn't supported by @ref convertToData(const MeshData&).
+
+@subsection Trade-MeshOptimizerSceneConverter-behavior-shadow Shadow mesh generation
+
+Depth prepass and shadow rendering need only positions, but vertices of
+regular meshes are often duplicated along texture or normal seams. Enabling
+the @cb{.ini} generateShadowIndices @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration option"
+makes both @ref convert(const MeshData&) and @ref convertInPlace(MeshData&)
+additionally generate a
+[shadow index buffer](https://github.com/zeux/meshoptimizer#shadow-indexing)
+where vertices with the same position are merged, together with a compact
+stream of just the referenced positions. The result is available through
+@ref shadowMesh() until the next conversion and requires the mesh to have
+positions. If @cb{.ini} optimizeVertexCache @ce is enabled, the shadow index
+buffer is optimized for the vertex cache as well. If levels of detail are
+generated, the shadow mesh is made for the finest level, and it's always made
+from the original float positions even if they're quantized afterwards. The
+shadow mesh doesn't modify the mesh itself and isn't stored by
+@ref convertToData(const MeshData&).
+
+@subsection Trade-MeshOptimizerSceneConverter-behavior-encoding Compressed output
+
+The @ref convertToData(const MeshData&) function performs the same operations
+as @ref convert(const MeshData&) and then writes the result as a binary glTF
+file with the vertex and index buffer compressed using meshoptimizer's
+[vertex and index buffer codecs](https://github.com/zeux/meshoptimizer#vertexindex-buffer-compression),
+described by the [EXT_meshopt_compression](https://github.com/KhronosGroup/glTF/tree/master/extensions/2.0/Vendor/EXT_meshopt_compression)
+extension. The codecs are designed for decoding at several gigabytes per
+second, the output can be further compressed with a general-purpose
+compressor. Such files can be imported back with @ref TinyGltfImporter built
+with `TINYGLTFIMPORTER_WITH_MESHOPTIMIZER` enabled.
+
+The file contains a single mesh with positions, normals, four-component
+tangents, texture coordinates, colors and object IDs, attributes of other
+names or with formats not supported by glTF are skipped with a warning. The
+object ID attribute name is controlled with the @cb{.ini} objectIdAttribute @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration option".
+Each attribute is aligned to four bytes, 8-bit indices are widened to 16-bit.
+Generated levels of detail and meshlets are not stored in the file.
+
+@subsection Trade-MeshOptimizerSceneConverter-behavior-quantization Vertex quantization
+
+Enabling the @cb{.ini} quantizePositions @ce, @cb{.ini} quantizeNormals @ce
+and @cb{.ini} quantizeTextureCoordinates @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration options"
+converts the corresponding attributes to compact formats using meshoptimizer's
+[quantization helpers](https://github.com/zeux/meshoptimizer#vertex-quantization),
+reducing vertex fetch bandwidth. The result uses formats that can be directly
+consumed by shaders:
+
+-   @ref VertexFormat::Vector3 positions are converted to
+    @ref VertexFormat::Vector3usNormalized relative to their bounding box,
+    scaled uniformly so normals aren't affected. The transformation mapping
+    them back to the original space is available through
+    @ref positionDequantization() and has to be applied to the mesh, for
+    example by multiplying it with the object transformation. Only the first
+    position attribute is quantized.
+-   @ref VertexFormat::Vector3 normals, tangents and bitangents and
+    @ref VertexFormat::Vector4 tangents are converted to
+    @ref VertexFormat::Vector3bNormalized and
+    @ref VertexFormat::Vector4bNormalized
+-   @ref VertexFormat::Vector2 texture coordinates are converted to
+    @ref VertexFormat::Vector2usNormalized if they're all in the
+    @f$ [0, 1] @f$ range and to @ref VertexFormat::Vector2h otherwise
+
+Other attributes are kept as-is. All attributes are put into a new
+interleaved layout with each attribute aligned to four bytes. Quantization is
+done as the last step in @ref convert(const MeshData&), after levels of detail
+and meshlets are generated, so meshlet bounds are in the original space. It
+can't be done in-place and fails if the mesh contains attributes with
+implementation-specific formats. In @ref convertToData(const MeshData&), the
+dequantization transformation is stored in the node referencing the mesh and
+the file uses the
+[KHR_mesh_quantization](https://github.com/KhronosGroup/glTF/blob/master/extensions/2.0/Khronos/KHR_mesh_quantization/README.md)
+extension, half-float texture coordinates are skipped as glTF has no way to
+represent them.
+
+@subsection Trade-MeshOptimizerSceneConverter-behavior-batch Batch conversion
+
+The @ref convertBatch() function converts many meshes at once, on multiple
+threads based on the @cb{.ini} threads @ce
+@ref Trade-MeshOptimizerSceneConverter-configuration "configuration option".
+If @ref CORRADE_BUILD_MULTITHREADED isn't enabled, everything is converted on
+the calling thread. For the duration of the batch, meshoptimizer's internal
+temporary allocations are redirected to per-thread scratch memory using
+@cpp meshopt_setAllocator() @ce, which is reused across meshes, and the
+default allocator is restored afterwards. As the allocator is global, this
+will override a custom allocator set by the application. If the option is set
+to a value other than @cpp 1 @ce, the application needs to link to `pthread`
+on Linux due to the same reasons as described in
+@ref Trade-BasisImageConverter-loading "BasisImageConverter docs".
+
 @section Trade-MeshOptimizerSceneConverter-configuration Plugin-specific config
 
 It's possible to tune various output options through @ref configuration(). See
@@ -167,11 +354,273 @@ class MAGNUM_MESHOPTIMIZERSCENECONVERTER_EXPORT MeshOptimizerSceneConverter: pub
 
         ~MeshOptimizerSceneConverter();
 
+        /**
+         * @brief Level of detail
+         * @m_since_latest_{plugins}
+         *
+         * @see @ref levelsOfDetail()
+         */
+        struct LevelOfDetail {
+            /** @brief Offset of the first index in the index buffer */
+            UnsignedInt indexOffset;
+
+            /** @brief Index count */
+            UnsignedInt indexCount;
+
+            /**
+             * @brief Vertex count
+             *
+             * The level references only the first @p vertexCount vertices
+             * of the vertex buffer.
+             */
+            UnsignedInt vertexCount;
+        };
+
+        /**
+         * @brief Levels of detail generated by the last conversion
+         * @m_since_latest_{plugins}
+         *
+         * Ordered from the finest to the coarsest, with the first level
+         * being the one the returned mesh references. Empty if the
+         * @cb{.ini} lodCount @ce option wasn't larger than @cpp 1 @ce or if
+         * the last conversion failed. See
+         * @ref Trade-MeshOptimizerSceneConverter-behavior-lod for more
+         * information.
+         *
+         * The function is virtual so it can be called on a dynamically
+         * loaded plugin without linking to it.
+         */
+        virtual Containers::ArrayView<const LevelOfDetail> levelsOfDetail() const;
+
+        /**
+         * @brief Meshlet
+         * @m_since_latest_{plugins}
+         *
+         * @see @ref meshlets()
+         */
+        struct Meshlet {
+            /** @brief Offset of the first vertex in @ref meshletVertices() */
+            UnsignedInt vertexOffset;
+
+            /**
+             * @brief Offset of the first triangle in @ref meshletTriangles()
+             *
+             * In bytes, always a multiple of four.
+             */
+            UnsignedInt triangleOffset;
+
+            /** @brief Vertex count */
+            UnsignedInt vertexCount;
+
+            /** @brief Triangle count */
+            UnsignedInt triangleCount;
+
+            /** @brief Bounding sphere center */
+            Vector3 center;
+
+            /** @brief Bounding sphere radius */
+            Float radius;
+
+            /** @brief Normal cone apex */
+            Vector3 coneApex;
+
+            /** @brief Normal cone axis */
+            Vector3 coneAxis;
+
+            /**
+             * @brief Normal cone cutoff
+             *
+             * The meshlet can be culled if
+             * @cpp Math::dot(Math::normalize(coneApex - cameraPosition), coneAxis) >= coneCutoff @ce.
+             */
+            Float coneCutoff;
+        };
+
+        /**
+         * @brief Meshlets generated by the last conversion
+         * @m_since_latest_{plugins}
+         *
+         * Empty if the @cb{.ini} buildMeshlets @ce option wasn't enabled or if
+         * the last conversion failed. See
+         * @ref Trade-MeshOptimizerSceneConverter-behavior-meshlets for more
+         * information.
+         *
+         * The function is virtual so it can be called on a dynamically
+         * loaded plugin without linking to it.
+         * @see @ref meshletVertices(), @ref meshletTriangles()
+         */
+        virtual Containers::ArrayView<const Meshlet> meshlets() const;
+
+        /**
+         * @brief Meshlet vertices
+         * @m_since_latest_{plugins}
+         *
+         * Indices into the vertex buffer of the mesh returned by the last
+         * conversion. Each meshlet references a range of
+         * @ref Meshlet::vertexCount items starting at
+         * @ref Meshlet::vertexOffset.
+         */
+        virtual Containers::ArrayView<const UnsignedInt> meshletVertices() const;
+
+        /**
+         * @brief Meshlet triangles
+         * @m_since_latest_{plugins}
+         *
+         * Triplets of indices into the meshlet's own range in
+         * @ref meshletVertices(). Each meshlet references
+         * @ref Meshlet::triangleCount triplets starting at byte
+         * @ref Meshlet::triangleOffset, the range of each meshlet is padded
+         * to a multiple of four bytes.
+         */
+        virtual Containers::ArrayView<const UnsignedByte> meshletTriangles() const;
+
+        /**
+         * @brief Position dequantization transformation
+         * @m_since_latest_{plugins}
+         *
+         * Transformation mapping positions quantized by the last conversion
+         * back to the original space. Identity if the
+         * @cb{.ini} quantizePositions @ce option wasn't enabled, if the mesh
+         * had no @ref VertexFormat::Vector3 positions or if the last
+         * conversion failed. See
+         * @ref Trade-MeshOptimizerSceneConverter-behavior-quantization for
+         * more information.
+         *
+         * The function is virtual so it can be called on a dynamically
+         * loaded plugin without linking to it.
+         */
+        virtual Matrix4 positionDequantization() const;
+
+        /**
+         * @brief Mesh efficiency statistics
+         * @m_since_latest_{plugins}
+         *
+         * Output of meshoptimizer's [efficiency analyzers](https://github.com/zeux/meshoptimizer#efficiency-analyzers).
+         * @see @ref statistics()
+         */
+        struct Statistics {
+            /** @brief Number of vertices transformed by the vertex cache */
+            UnsignedInt verticesTransformed;
+
+            /** @brief Number of executed warps */
+            UnsignedInt warpsExecuted;
+
+            /** @brief Average cache miss ratio */
+            Float acmr;
+
+            /** @brief Average transformed vertex ratio */
+            Float atvr;
+
+            /**
+             * @brief Bytes fetched from the vertex buffer
+             *
+             * @cpp 0 @ce if the mesh has attributes with
+             * implementation-specific formats.
+             */
+            UnsignedInt bytesFetched;
+
+            /**
+             * @brief Vertex fetch overfetch ratio
+             *
+             * @cpp 0.0f @ce if the mesh has attributes with
+             * implementation-specific formats.
+             */
+            Float overfetch;
+
+            /**
+             * @brief Number of pixels covered
+             *
+             * @cpp 0 @ce if the mesh has no positions.
+             */
+            UnsignedInt pixelsCovered;
+
+            /**
+             * @brief Number of pixels shaded
+             *
+             * @cpp 0 @ce if the mesh has no positions.
+             */
+            UnsignedInt pixelsShaded;
+
+            /**
+             * @brief Overdraw ratio
+             *
+             * @cpp 0.0f @ce if the mesh has no positions.
+             */
+            Float overdraw;
+        };
+
+        /**
+         * @brief Mesh efficiency statistics of the last conversion
+         * @m_since_latest_{plugins}
+         *
+         * If @ref SceneConverterFlag::Verbose or the @cb{.ini} statistics @ce
+         * @ref Trade-MeshOptimizerSceneConverter-configuration "configuration option"
+         * is enabled, contains two items with the statistics before and after
+         * the processing, in this order. Empty otherwise or if the last
+         * conversion failed.
+         *
+         * The function is virtual so it can be called on a dynamically
+         * loaded plugin without linking to it.
+         */
+        virtual Containers::ArrayView<const Statistics> statistics() const;
+
+        /**
+         * @brief Shadow mesh generated by the last conversion
+         * @m_since_latest_{plugins}
+         *
+         * A triangle mesh with @ref MeshIndexType::UnsignedInt indices and
+         * just @ref VertexFormat::Vector3 positions, referencing data owned
+         * by the plugin that are valid until the next conversion.
+         * @ref Containers::NullOpt if the @cb{.ini} generateShadowIndices @ce
+         * option wasn't enabled or if the last conversion failed. See
+         * @ref Trade-MeshOptimizerSceneConverter-behavior-shadow for more
+         * information.
+         *
+         * The function is virtual so it can be called on a dynamically
+         * loaded plugin without linking to it.
+         */
+        virtual Containers::Optional<MeshData> shadowMesh() const;
+
+        /**
+         * @brief Convert many meshes at once
+         * @m_since_latest_{plugins}
+         *
+         * Performs the same operations as @ref convert(const MeshData&) on
+         * each of @p meshes, on multiple threads based on the
+         * @cb{.ini} threads @ce
+         * @ref Trade-MeshOptimizerSceneConverter-configuration "configuration option",
+         * and returns the results in the same order. Meshes that fail to
+         * convert are @ref Containers::NullOpt in the output, with a message
+         * printed to @ref Error. Note that messages printed from other
+         * threads don't go through output redirection set up on the calling
+         * thread. The @ref levelsOfDetail(), @ref meshlets(),
+         * @ref meshletVertices(), @ref meshletTriangles() and
+         * @ref positionDequantization() are reset and not populated by this
+         * function, process the meshes one by one if you need them. See
+         * @ref Trade-MeshOptimizerSceneConverter-behavior-batch for more
+         * information.
+         *
+         * The function is virtual so it can be called on a dynamically
+         * loaded plugin without linking to it.
+         */
+        virtual Containers::Array<Containers::Optional<MeshData>> convertBatch(Containers::ArrayView<const Containers::Reference<const MeshData>> meshes);
+
     private:
         MAGNUM_MESHOPTIMIZERSCENECONVERTER_LOCAL SceneConverterFeatures doFeatures() const override;
 
         MAGNUM_MESHOPTIMIZERSCENECONVERTER_LOCAL bool doConvertInPlace(MeshData& mesh) override;
         MAGNUM_MESHOPTIMIZERSCENECONVERTER_LOCAL Containers::Optional<MeshData> doConvert(const MeshData& mesh) override;
+        MAGNUM_MESHOPTIMIZERSCENECONVERTER_LOCAL Containers::Array<char> doConvertToData(const MeshData& mesh) override;
+
+        Containers::Array<LevelOfDetail> _levelsOfDetail;
+        Containers::Array<Meshlet> _meshlets;
+        Containers::Array<UnsignedInt> _meshletVertices;
+        Containers::Array<UnsignedByte> _meshletTriangles;
+        Matrix4 _positionDequantization;
+        Containers::Array<Statistics> _statistics;
+        Containers::Array<UnsignedInt> _shadowIndices;
+        Containers::Array<Vector3> _shadowPositions;
+        bool _hasShadowMesh{};
 };
 
 }}
@@ -23,23 +23,39 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <algorithm>
+#include <cstring>
 #include <sstream>
+#include <tuple>
+#include <vector>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Reference.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Corrade/Utility/FormatStl.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Packing.h>
+#include <Magnum/Math/Swizzle.h>
 #include <Magnum/Math/Vector3.h>
 #include <Magnum/MeshTools/CompressIndices.h>
+#include <Magnum/MeshTools/Duplicate.h>
 #include <Magnum/MeshTools/Interleave.h>
+#include <Magnum/MeshTools/Reference.h>
 #include <Magnum/Primitives/Circle.h>
+#include <Magnum/Primitives/Cube.h>
 #include <Magnum/Primitives/Icosphere.h>
 #include <Magnum/Primitives/Square.h>
 #include <Magnum/Primitives/UVSphere.h>
+#include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/AbstractSceneConverter.h>
 #include <Magnum/Trade/MeshData.h>
 
+#include "MagnumPlugins/MeshOptimizerSceneConverter/MeshOptimizerSceneConverter.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Trade { namespace Test { namespace {
@@ -68,11 +84,23 @@ struct MeshOptimizerSceneConverterTest: TestSuite::Tester {
     template<class T> void verbose();
     void verboseCustomAttribute();
     void verboseImplementationSpecificAttribute();
+    void statistics();
+    void statisticsNotEnabled();
 
     /* Those test the copy-making function */
     void copy();
     void copyTriangleStrip2DPositions();
     void copyTriangleFanIndexed();
+    void copyNonIndexed();
+    void copyNonIndexedNoAttributes();
+
+    void spatialSortNoPositions();
+    void spatialSortPointsTriangleOperation();
+    void spatialSortPointsConvertToData();
+    void spatialSortPointsInPlaceNotInterleaved();
+    void spatialSortPoints();
+    template<class T> void spatialSortPointsIndexedInPlace();
+    void spatialSortTriangles();
 
     void simplifyInPlace();
     void simplifyNoPositions();
@@ -81,8 +109,39 @@ struct MeshOptimizerSceneConverterTest: TestSuite::Tester {
 
     void simplifyVerbose();
 
+    void levelsOfDetailInPlace();
+    void levelsOfDetailNoPositions();
+    template<class T> void levelsOfDetail();
+    void levelsOfDetailSloppy();
+
+    void meshletsInvalidLimits();
+    void meshletsNoPositions();
+    template<class T> void meshlets();
+    void meshletsInPlace();
+
+    void stripifyInPlace();
+    void stripifyLevelsOfDetail();
+    void stripifyConvertToData();
+    void stripify();
+    void stripifyRestartWidenIndexType();
+
+    void shadowMesh();
+    void shadowMeshInPlace();
+    void shadowMeshNotEnabled();
+
+    void convertToData();
+    void convertToDataSkipAttributes();
+    void convertToDataImport();
+
+    void quantizeInPlace();
+    void quantize();
+    void quantizeTextureCoordinatesOutOfRange();
+
+    void convertBatch();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractSceneConverter> _manager{"nonexistent"};
+    PluginManager::Manager<AbstractImporter> _importerManager{"nonexistent"};
 };
 
 const struct {
@@ -93,6 +152,25 @@ const struct {
     {"sloppy", "simplifySloppy"}
 };
 
+const struct {
+    const char* name;
+    bool restart;
+} StripifyData[]{
+    {"primitive restart", true},
+    {"degenerate triangles", false}
+};
+
+const struct {
+    const char* name;
+    UnsignedInt threads;
+} ConvertBatchData[]{
+    {"", 1},
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    {"four threads", 4},
+    {"all cores", 0}
+    #endif
+};
+
 MeshOptimizerSceneConverterTest::MeshOptimizerSceneConverterTest() {
     addTests({
         &MeshOptimizerSceneConverterTest::notTriangles,
@@ -123,6 +201,8 @@ MeshOptimizerSceneConverterTest::MeshOptimizerSceneConverterTest() {
         &MeshOptimizerSceneConverterTest::verbose<UnsignedInt>,
         &MeshOptimizerSceneConverterTest::verboseCustomAttribute,
         &MeshOptimizerSceneConverterTest::verboseImplementationSpecificAttribute,
+        &MeshOptimizerSceneConverterTest::statistics,
+        &MeshOptimizerSceneConverterTest::statisticsNotEnabled,
 
         &MeshOptimizerSceneConverterTest::inPlaceOptimizeEmpty<UnsignedByte>,
         &MeshOptimizerSceneConverterTest::inPlaceOptimizeEmpty<UnsignedShort>,
@@ -130,7 +210,18 @@ MeshOptimizerSceneConverterTest::MeshOptimizerSceneConverterTest() {
 
         &MeshOptimizerSceneConverterTest::copy,
         &MeshOptimizerSceneConverterTest::copyTriangleStrip2DPositions,
-        &MeshOptimizerSceneConverterTest::copyTriangleFanIndexed});
+        &MeshOptimizerSceneConverterTest::copyTriangleFanIndexed,
+        &MeshOptimizerSceneConverterTest::copyNonIndexed,
+        &MeshOptimizerSceneConverterTest::copyNonIndexedNoAttributes,
+
+        &MeshOptimizerSceneConverterTest::spatialSortNoPositions,
+        &MeshOptimizerSceneConverterTest::spatialSortPointsTriangleOperation,
+        &MeshOptimizerSceneConverterTest::spatialSortPointsConvertToData,
+        &MeshOptimizerSceneConverterTest::spatialSortPointsInPlaceNotInterleaved,
+        &MeshOptimizerSceneConverterTest::spatialSortPoints,
+        &MeshOptimizerSceneConverterTest::spatialSortPointsIndexedInPlace<UnsignedShort>,
+        &MeshOptimizerSceneConverterTest::spatialSortPointsIndexedInPlace<UnsignedInt>,
+        &MeshOptimizerSceneConverterTest::spatialSortTriangles});
 
     addInstancedTests({
         &MeshOptimizerSceneConverterTest::simplifyInPlace,
@@ -144,13 +235,53 @@ MeshOptimizerSceneConverterTest::MeshOptimizerSceneConverterTest() {
         &MeshOptimizerSceneConverterTest::simplifySloppy<UnsignedByte>,
         &MeshOptimizerSceneConverterTest::simplifySloppy<UnsignedShort>,
         &MeshOptimizerSceneConverterTest::simplifySloppy<UnsignedInt>,
-        &MeshOptimizerSceneConverterTest::simplifyVerbose});
+        &MeshOptimizerSceneConverterTest::simplifyVerbose,
+
+        &MeshOptimizerSceneConverterTest::levelsOfDetailInPlace,
+        &MeshOptimizerSceneConverterTest::levelsOfDetailNoPositions,
+        &MeshOptimizerSceneConverterTest::levelsOfDetail<UnsignedShort>,
+        &MeshOptimizerSceneConverterTest::levelsOfDetail<UnsignedInt>,
+        &MeshOptimizerSceneConverterTest::levelsOfDetailSloppy,
+
+        &MeshOptimizerSceneConverterTest::meshletsInvalidLimits,
+        &MeshOptimizerSceneConverterTest::meshletsNoPositions,
+        &MeshOptimizerSceneConverterTest::meshlets<UnsignedShort>,
+        &MeshOptimizerSceneConverterTest::meshlets<UnsignedInt>,
+        &MeshOptimizerSceneConverterTest::meshletsInPlace,
+
+        &MeshOptimizerSceneConverterTest::stripifyInPlace,
+        &MeshOptimizerSceneConverterTest::stripifyLevelsOfDetail,
+        &MeshOptimizerSceneConverterTest::stripifyConvertToData});
+
+    addInstancedTests({&MeshOptimizerSceneConverterTest::stripify},
+        Containers::arraySize(StripifyData));
+
+    addTests({
+        &MeshOptimizerSceneConverterTest::stripifyRestartWidenIndexType,
+
+        &MeshOptimizerSceneConverterTest::shadowMesh,
+        &MeshOptimizerSceneConverterTest::shadowMeshInPlace,
+        &MeshOptimizerSceneConverterTest::shadowMeshNotEnabled,
+
+        &MeshOptimizerSceneConverterTest::convertToData,
+        &MeshOptimizerSceneConverterTest::convertToDataSkipAttributes,
+        &MeshOptimizerSceneConverterTest::convertToDataImport,
+
+        &MeshOptimizerSceneConverterTest::quantizeInPlace,
+        &MeshOptimizerSceneConverterTest::quantize,
+        &MeshOptimizerSceneConverterTest::quantizeTextureCoordinatesOutOfRange});
+
+    addInstancedTests({&MeshOptimizerSceneConverterTest::convertBatch},
+        Containers::arraySize(ConvertBatchData));
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef MESHOPTIMIZERSCENECONVERTER_PLUGIN_FILENAME
     CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(MESHOPTIMIZERSCENECONVERTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
     #endif
+    #ifdef TINYGLTFIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_importerManager.load(TINYGLTFIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
 }
 
 void MeshOptimizerSceneConverterTest::notTriangles() {
@@ -162,20 +293,19 @@ void MeshOptimizerSceneConverterTest::notTriangles() {
     CORRADE_VERIFY(!converter->convert(mesh));
     CORRADE_VERIFY(!converter->convertInPlace(mesh));
     CORRADE_COMPARE(out.str(),
-        "Trade::MeshOptimizerSceneConverter::convert(): expected a triangle mesh, got MeshPrimitive::Instances\n"
-        "Trade::MeshOptimizerSceneConverter::convertInPlace(): expected a triangle mesh, got MeshPrimitive::Instances\n");
+        "Trade::MeshOptimizerSceneConverter::convert(): expected a triangle mesh or a point cloud, got MeshPrimitive::Instances\n"
+        "Trade::MeshOptimizerSceneConverter::convertInPlace(): expected a triangle mesh or a point cloud, got MeshPrimitive::Instances\n");
 }
 
 void MeshOptimizerSceneConverterTest::notIndexed() {
     Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
 
+    /* convert() handles this, see copyNonIndexed() */
     MeshData mesh{MeshPrimitive::Triangles, 3};
     std::ostringstream out;
     Error redirectError{&out};
-    CORRADE_VERIFY(!converter->convert(mesh));
     CORRADE_VERIFY(!converter->convertInPlace(mesh));
     CORRADE_COMPARE(out.str(),
-        "Trade::MeshOptimizerSceneConverter::convert(): expected an indexed mesh\n"
         "Trade::MeshOptimizerSceneConverter::convertInPlace(): expected an indexed mesh\n");
 }
 
@@ -195,7 +325,7 @@ void MeshOptimizerSceneConverterTest::immutableIndexData() {
     Error redirectError{&out};
     CORRADE_VERIFY(!converter->convertInPlace(mesh));
     CORRADE_COMPARE(out.str(),
-        "Trade::MeshOptimizerSceneConverter::convertInPlace(): optimizeVertexCache, optimizeOverdraw and optimizeVertexFetch require index data to be mutable\n");
+        "Trade::MeshOptimizerSceneConverter::convertInPlace(): optimizeVertexCache, optimizeOverdraw, optimizeVertexFetch and spatialSort require index data to be mutable\n");
 }
 
 void MeshOptimizerSceneConverterTest::inPlaceOptimizeVertexFetchImmutableVertexData() {
@@ -634,6 +764,57 @@ Trade::MeshOptimizerSceneConverter::convertInPlace(): processing stats:
     CORRADE_COMPARE(out.str(), expected);
 }
 
+void MeshOptimizerSceneConverterTest::statistics() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("statistics", true);
+
+    MeshData icosphere = MeshTools::compressIndices(Primitives::icosphereSolid(6));
+
+    /* Nothing should be printed without the verbose flag */
+    std::ostringstream out;
+    {
+        Debug redirectDebug{&out};
+        CORRADE_VERIFY(converter->convertInPlace(icosphere));
+    }
+    CORRADE_COMPARE(out.str(), "");
+
+    /* Same values as in verbose() */
+    Containers::ArrayView<const MeshOptimizerSceneConverter::Statistics> statistics = static_cast<MeshOptimizerSceneConverter&>(*converter).statistics();
+    CORRADE_COMPARE(statistics.size(), 2);
+    CORRADE_COMPARE(statistics[0].verticesTransformed, 165120);
+    CORRADE_COMPARE(statistics[1].verticesTransformed, 58521);
+    CORRADE_COMPARE(statistics[0].warpsExecuted, 1);
+    CORRADE_COMPARE(statistics[1].warpsExecuted, 1);
+    CORRADE_COMPARE(statistics[0].acmr, 2.015625f);
+    CORRADE_COMPARE(statistics[1].acmr, 0.714368f);
+    CORRADE_COMPARE(statistics[0].atvr, 4.03105f);
+    CORRADE_COMPARE(statistics[1].atvr, 1.42867f);
+    CORRADE_COMPARE(statistics[0].bytesFetched, 3891008);
+    CORRADE_COMPARE(statistics[1].bytesFetched, 1582144);
+    CORRADE_COMPARE(statistics[0].overfetch, 3.95794f);
+    CORRADE_COMPARE(statistics[1].overfetch, 1.60936f);
+    CORRADE_COMPARE(statistics[0].pixelsShaded, 308753);
+    CORRADE_COMPARE(statistics[1].pixelsShaded, 308750);
+    CORRADE_COMPARE(statistics[0].pixelsCovered, 308748);
+    CORRADE_COMPARE(statistics[1].pixelsCovered, 308748);
+    CORRADE_COMPARE(statistics[0].overdraw, 1.00002f);
+    CORRADE_COMPARE(statistics[1].overdraw, 1.00001f);
+}
+
+void MeshOptimizerSceneConverterTest::statisticsNotEnabled() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("statistics", true);
+
+    MeshData icosphere = MeshTools::compressIndices(Primitives::icosphereSolid(1));
+    CORRADE_VERIFY(converter->convert(icosphere));
+    CORRADE_COMPARE(static_cast<MeshOptimizerSceneConverter&>(*converter).statistics().size(), 2);
+
+    /* Disabling the option again clears the previous statistics */
+    converter->configuration().setValue("statistics", false);
+    CORRADE_VERIFY(converter->convert(icosphere));
+    CORRADE_VERIFY(static_cast<MeshOptimizerSceneConverter&>(*converter).statistics().empty());
+}
+
 template<class T> void MeshOptimizerSceneConverterTest::inPlaceOptimizeEmpty() {
     setTestCaseTemplateName(Math::TypeTraits<T>::name());
 
@@ -775,6 +956,274 @@ void MeshOptimizerSceneConverterTest::copyTriangleFanIndexed() {
         }), TestSuite::Compare::Container);
 }
 
+void MeshOptimizerSceneConverterTest::copyNonIndexed() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    /* Disable the optimizations so the triangle order is preserved */
+    converter->configuration().setValue("optimizeVertexCache", false);
+    converter->configuration().setValue("optimizeOverdraw", false);
+    converter->configuration().setValue("optimizeVertexFetch", false);
+
+    /* Turn an icosphere into a triangle soup, the duplicates should be merged
+       back */
+    MeshData original = Primitives::icosphereSolid(1);
+    MeshData soup = MeshTools::duplicate(original);
+    CORRADE_VERIFY(!soup.isIndexed());
+    CORRADE_COMPARE(soup.vertexCount(), original.indexCount());
+    Containers::Optional<MeshData> optimized = converter->convert(soup);
+
+    CORRADE_VERIFY(optimized);
+    CORRADE_COMPARE(optimized->primitive(), MeshPrimitive::Triangles);
+    CORRADE_VERIFY(optimized->isIndexed());
+    CORRADE_COMPARE(optimized->indexType(), MeshIndexType::UnsignedInt);
+    CORRADE_COMPARE(optimized->indexCount(), original.indexCount());
+    CORRADE_COMPARE(optimized->vertexCount(), original.vertexCount());
+    CORRADE_COMPARE(optimized->attributeCount(), original.attributeCount());
+    CORRADE_COMPARE(optimized->indexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+    CORRADE_COMPARE(optimized->vertexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+
+    /* Each index should point to a vertex with the same data as in the
+       soup */
+    const Containers::ArrayView<const UnsignedInt> indices = optimized->indices<UnsignedInt>();
+    const Containers::StridedArrayView1D<const Vector3> positions = optimized->attribute<Vector3>(MeshAttribute::Position);
+    const Containers::StridedArrayView1D<const Vector3> normals = optimized->attribute<Vector3>(MeshAttribute::Normal);
+    const Containers::StridedArrayView1D<const Vector3> soupPositions = soup.attribute<Vector3>(MeshAttribute::Position);
+    const Containers::StridedArrayView1D<const Vector3> soupNormals = soup.attribute<Vector3>(MeshAttribute::Normal);
+    for(std::size_t i = 0; i != indices.size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(positions[indices[i]], soupPositions[i]);
+        CORRADE_COMPARE(normals[indices[i]], soupNormals[i]);
+    }
+}
+
+void MeshOptimizerSceneConverterTest::copyNonIndexedNoAttributes() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+
+    /* Overdraw optimization would need positions */
+    converter->configuration().setValue("optimizeOverdraw", false);
+
+    /* All vertices are the same, so they get merged into one */
+    Containers::Optional<MeshData> optimized = converter->convert(MeshData{MeshPrimitive::Triangles, 3});
+    CORRADE_VERIFY(optimized);
+    CORRADE_COMPARE(optimized->indexType(), MeshIndexType::UnsignedInt);
+    CORRADE_COMPARE(optimized->vertexCount(), 1);
+    CORRADE_COMPARE_AS(optimized->indices<UnsignedInt>(),
+        Containers::arrayView<UnsignedInt>({0, 0, 0}),
+        TestSuite::Compare::Container);
+}
+
+void MeshOptimizerSceneConverterTest::spatialSortNoPositions() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("spatialSort", true);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(MeshData{MeshPrimitive::Points, 3}));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::convert(): spatialSort requires the mesh to have positions\n");
+}
+
+void MeshOptimizerSceneConverterTest::spatialSortPointsTriangleOperation() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("buildMeshlets", true);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(MeshData{MeshPrimitive::Points, 3}));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::convert(): simplification, level of detail, meshlet, shadow index and strip generation expects a triangle mesh, got MeshPrimitive::Points\n");
+}
+
+void MeshOptimizerSceneConverterTest::spatialSortPointsConvertToData() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToData(MeshData{MeshPrimitive::Points, 3}));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::convertToData(): point clouds aren't supported for compressed output\n");
+}
+
+void MeshOptimizerSceneConverterTest::spatialSortPointsInPlaceNotInterleaved() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("spatialSort", true);
+
+    Containers::Array<char> vertexData{3*24};
+    MeshData mesh{MeshPrimitive::Points,
+        std::move(vertexData), {
+            MeshAttributeData{MeshAttribute::Position, VertexFormat::Vector3,
+                0, 3, 12},
+            MeshAttributeData{MeshAttribute::Normal, VertexFormat::Vector3,
+                3*12, 3, 12},
+        }, 3};
+
+    CORRADE_VERIFY(converter->convert(mesh)); /* Here it's not a problem */
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertInPlace(mesh));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::convertInPlace(): spatialSort requires the mesh to be interleaved\n");
+}
+
+/* A 16x16x16 grid of points in a scrambled order, with colors derived from
+   the positions so it can be checked the vertices are moved as a whole */
+struct Point {
+    Vector3 position;
+    Vector3 color;
+};
+
+MeshData scrambledPointGrid(Containers::Array<char>&& indexData, const MeshIndexData& indices) {
+    Containers::Array<char> vertexData{Containers::NoInit, 4096*sizeof(Point)};
+    const Containers::ArrayView<Point> points = Containers::arrayCast<Point>(vertexData);
+    for(UnsignedInt i = 0; i != points.size(); ++i) {
+        /* 2503 is coprime with 4096, so this visits each point once */
+        const UnsignedInt j = i*2503 % 4096;
+        const Vector3 position{Float(j%16), Float(j/16%16), Float(j/256)};
+        points[i] = {position, position/16.0f};
+    }
+
+    return MeshData{MeshPrimitive::Points,
+        std::move(indexData), indices,
+        std::move(vertexData), {
+            MeshAttributeData{MeshAttribute::Position,
+                Containers::StridedArrayView1D<const Vector3>{points, &points[0].position, points.size(), sizeof(Point)}},
+            MeshAttributeData{MeshAttribute::Color,
+                Containers::StridedArrayView1D<const Vector3>{points, &points[0].color, points.size(), sizeof(Point)}}
+        }};
+}
+
+Float pathLength(const Containers::StridedArrayView1D<const Vector3>& positions) {
+    Float length = 0.0f;
+    for(std::size_t i = 1; i < positions.size(); ++i)
+        length += (positions[i] - positions[i - 1]).length();
+    return length;
+}
+
+void MeshOptimizerSceneConverterTest::spatialSortPoints() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+
+    MeshData mesh = scrambledPointGrid(nullptr, MeshIndexData{});
+    const Float originalLength = pathLength(mesh.attribute<Vector3>(MeshAttribute::Position));
+
+    /* Without spatial sort enabled it's passed through, and the triangle
+       optimizations that are enabled by default don't apply */
+    {
+        Containers::Optional<MeshData> out = converter->convert(mesh);
+        CORRADE_VERIFY(out);
+        CORRADE_COMPARE(out->primitive(), MeshPrimitive::Points);
+        CORRADE_VERIFY(!out->isIndexed());
+        CORRADE_COMPARE_AS(out->attribute<Vector3>(MeshAttribute::Position),
+            mesh.attribute<Vector3>(MeshAttribute::Position),
+            TestSuite::Compare::Container);
+    }
+
+    converter->configuration().setValue("spatialSort", true);
+    Containers::Optional<MeshData> out = converter->convert(mesh);
+    CORRADE_VERIFY(out);
+    CORRADE_COMPARE(out->primitive(), MeshPrimitive::Points);
+    CORRADE_VERIFY(!out->isIndexed());
+    CORRADE_COMPARE(out->vertexCount(), mesh.vertexCount());
+    CORRADE_COMPARE(out->attributeCount(), 2);
+
+    /* The vertices are kept whole and each is still there exactly once */
+    const Containers::StridedArrayView1D<const Vector3> positions = out->attribute<Vector3>(MeshAttribute::Position);
+    const Containers::StridedArrayView1D<const Vector3> colors = out->attribute<Vector3>(MeshAttribute::Color);
+    Containers::Array<bool> found{Containers::ValueInit, 4096};
+    for(std::size_t i = 0; i != positions.size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(colors[i], positions[i]/16.0f);
+        const std::size_t id = std::size_t(positions[i].x()) + std::size_t(positions[i].y())*16 + std::size_t(positions[i].z())*256;
+        CORRADE_VERIFY(!found[id]);
+        found[id] = true;
+    }
+
+    /* In Morton order most neighbors are next to each other, in the scrambled
+       order they're on average several units apart */
+    CORRADE_COMPARE_AS(pathLength(positions), originalLength/4.0f,
+        TestSuite::Compare::Less);
+}
+
+template<class T> void MeshOptimizerSceneConverterTest::spatialSortPointsIndexedInPlace() {
+    setTestCaseTemplateName(Math::TypeTraits<T>::name());
+
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("spatialSort", true);
+
+    /* Reference every other point, in reverse */
+    Containers::Array<char> indexData{Containers::NoInit, 2048*sizeof(T)};
+    const Containers::ArrayView<T> indices = Containers::arrayCast<T>(indexData);
+    for(std::size_t i = 0; i != indices.size(); ++i)
+        indices[i] = T(4095 - i*2);
+    const MeshIndexData meshIndices{indices};
+    MeshData mesh = scrambledPointGrid(std::move(indexData), meshIndices);
+
+    /* Save what the indices point to before sorting */
+    const Float originalLength = pathLength(mesh.attribute<Vector3>(MeshAttribute::Position));
+    Containers::Array<Vector3> original{Containers::NoInit, indices.size()};
+    for(std::size_t i = 0; i != indices.size(); ++i)
+        original[i] = mesh.attribute<Vector3>(MeshAttribute::Position)[mesh.indices<T>()[i]];
+
+    CORRADE_VERIFY(converter->convertInPlace(mesh));
+    CORRADE_COMPARE(mesh.primitive(), MeshPrimitive::Points);
+    CORRADE_COMPARE(mesh.indexType(), Implementation::meshIndexTypeFor<T>());
+    CORRADE_COMPARE(mesh.indexCount(), 2048);
+
+    /* The vertices moved, but the indices still point to the same data */
+    const Containers::StridedArrayView1D<const Vector3> positions = mesh.attribute<Vector3>(MeshAttribute::Position);
+    const Containers::StridedArrayView1D<const Vector3> colors = mesh.attribute<Vector3>(MeshAttribute::Color);
+    CORRADE_COMPARE_AS(pathLength(positions), originalLength/4.0f,
+        TestSuite::Compare::Less);
+    for(std::size_t i = 0; i != original.size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(positions[mesh.indices<T>()[i]], original[i]);
+        CORRADE_COMPARE(colors[mesh.indices<T>()[i]], original[i]/16.0f);
+    }
+}
+
+void MeshOptimizerSceneConverterTest::spatialSortTriangles() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    /* Disable the other optimizations so just the triangle order changes */
+    converter->configuration().setValue("optimizeVertexCache", false);
+    converter->configuration().setValue("optimizeOverdraw", false);
+    converter->configuration().setValue("optimizeVertexFetch", false);
+
+    /* A triangle soup, which gets deduplicated to the same vertices in both
+       cases */
+    MeshData soup = MeshTools::duplicate(Primitives::icosphereSolid(3));
+    Containers::Optional<MeshData> unsorted = converter->convert(soup);
+    CORRADE_VERIFY(unsorted);
+
+    converter->configuration().setValue("spatialSort", true);
+    Containers::Optional<MeshData> sorted = converter->convert(soup);
+    CORRADE_VERIFY(sorted);
+    CORRADE_COMPARE(sorted->primitive(), MeshPrimitive::Triangles);
+    CORRADE_COMPARE(sorted->indexCount(), unsorted->indexCount());
+    CORRADE_COMPARE(sorted->vertexCount(), unsorted->vertexCount());
+    CORRADE_COMPARE_AS(sorted->attribute<Vector3>(MeshAttribute::Position),
+        unsorted->attribute<Vector3>(MeshAttribute::Position),
+        TestSuite::Compare::Container);
+
+    /* The triangles are reordered, but it's still the same set of them with
+       the same winding */
+    const auto triangles = [](Containers::ArrayView<const UnsignedInt> indices) {
+        std::vector<Vector3ui> out;
+        for(std::size_t i = 0; i != indices.size(); i += 3) {
+            Vector3ui triangle{indices[i], indices[i + 1], indices[i + 2]};
+            /* Rotate so the smallest index is first, keeping the winding */
+            while(triangle[0] != Math::min(triangle)) triangle = Math::gather<'y', 'z', 'x'>(triangle);
+            out.push_back(triangle);
+        }
+        std::sort(out.begin(), out.end(), [](const Vector3ui& a, const Vector3ui& b) {
+            return std::make_tuple(a[0], a[1], a[2]) < std::make_tuple(b[0], b[1], b[2]);
+        });
+        return out;
+    };
+    const Containers::ArrayView<const UnsignedInt> sortedIndices = sorted->indices<UnsignedInt>();
+    const Containers::ArrayView<const UnsignedInt> unsortedIndices = unsorted->indices<UnsignedInt>();
+    CORRADE_VERIFY(!std::equal(sortedIndices.begin(), sortedIndices.end(), unsortedIndices.begin()));
+    CORRADE_VERIFY(triangles(sortedIndices) == triangles(unsortedIndices));
+}
+
 void MeshOptimizerSceneConverterTest::simplifyInPlace() {
     auto&& data = SimplifyErrorData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -987,6 +1436,675 @@ void MeshOptimizerSceneConverterTest::simplifyVerbose() {
     CORRADE_COMPARE(out.str(), expected);
 }
 
+void MeshOptimizerSceneConverterTest::levelsOfDetailInPlace() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("optimizeVertexCache", false);
+    converter->configuration().setValue("optimizeOverdraw", false);
+    converter->configuration().setValue("optimizeVertexFetch", false);
+    converter->configuration().setValue("lodCount", 3);
+
+    const UnsignedByte indexData[3]{};
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indexData, MeshIndexData{indexData},
+        nullptr, {}, 1};
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertInPlace(mesh));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::convertInPlace(): level of detail generation can't be performed in-place, use convert() instead\n");
+}
+
+void MeshOptimizerSceneConverterTest::levelsOfDetailNoPositions() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("optimizeVertexCache", false);
+    converter->configuration().setValue("optimizeOverdraw", false);
+    converter->configuration().setValue("optimizeVertexFetch", false);
+    converter->configuration().setValue("lodCount", 3);
+
+    const UnsignedByte indexData[3]{};
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indexData, MeshIndexData{indexData},
+        nullptr, {}, 1};
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(mesh));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::convert(): optimizeOverdraw and simplify require the mesh to have positions\n");
+}
+
+template<class T> void MeshOptimizerSceneConverterTest::levelsOfDetail() {
+    setTestCaseTemplateName(Math::TypeTraits<T>::name());
+
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("lodCount", 3);
+    /* The default 1.0e-2 is too little for this */
+    converter->configuration().setValue("lodTargetError", 0.25f);
+
+    MeshData sphere = MeshTools::compressIndices(
+        Primitives::icosphereSolid(2),
+        Implementation::meshIndexTypeFor<T>());
+    CORRADE_COMPARE(sphere.indexType(), Implementation::meshIndexTypeFor<T>());
+
+    Containers::Optional<MeshData> out = converter->convert(sphere);
+    CORRADE_VERIFY(out);
+
+    /* The mesh references the finest level in the original index type, all
+       levels share all vertices */
+    CORRADE_COMPARE(out->indexType(), Implementation::meshIndexTypeFor<T>());
+    CORRADE_COMPARE(out->indexCount(), sphere.indexCount());
+    CORRADE_COMPARE(out->vertexCount(), sphere.vertexCount());
+    CORRADE_VERIFY(out->hasAttribute(MeshAttribute::Normal));
+
+    Containers::ArrayView<const MeshOptimizerSceneConverter::LevelOfDetail> levels = static_cast<MeshOptimizerSceneConverter&>(*converter).levelsOfDetail();
+    CORRADE_COMPARE(levels.size(), 3);
+    CORRADE_COMPARE(levels[0].indexOffset, 0);
+    CORRADE_COMPARE(levels[0].indexCount, sphere.indexCount());
+    CORRADE_COMPARE(levels[0].vertexCount, sphere.vertexCount());
+
+    /* The index buffer contains all levels after each other */
+    UnsignedInt indexOffset = 0;
+    for(const MeshOptimizerSceneConverter::LevelOfDetail& level: levels)
+        indexOffset += level.indexCount;
+    CORRADE_COMPARE(out->indexData().size(), indexOffset*sizeof(T));
+
+    const Containers::ArrayView<const T> indices = Containers::arrayCast<const T>(out->indexData());
+    for(std::size_t i = 1; i != levels.size(); ++i) {
+        CORRADE_ITERATION(i);
+
+        /* Each level is coarser than the previous, follows it in the index
+           buffer and uses just a prefix of its vertices */
+        CORRADE_COMPARE(levels[i].indexOffset, levels[i - 1].indexOffset + levels[i - 1].indexCount);
+        CORRADE_COMPARE_AS(levels[i].indexCount, levels[i - 1].indexCount,
+            TestSuite::Compare::Less);
+        CORRADE_COMPARE_AS(levels[i].indexCount, 0u,
+            TestSuite::Compare::Greater);
+        CORRADE_COMPARE(levels[i].indexCount % 3, 0);
+        CORRADE_COMPARE_AS(levels[i].vertexCount, levels[i - 1].vertexCount,
+            TestSuite::Compare::Less);
+
+        UnsignedInt maxIndex = 0;
+        for(const T index: indices.slice(levels[i].indexOffset, levels[i].indexOffset + levels[i].indexCount))
+            maxIndex = Math::max(maxIndex, UnsignedInt(index));
+        CORRADE_COMPARE(maxIndex + 1, levels[i].vertexCount);
+    }
+
+    /* Converting again without LODs clears them */
+    converter->configuration().setValue("lodCount", 1);
+    CORRADE_VERIFY(converter->convert(sphere));
+    CORRADE_VERIFY(static_cast<MeshOptimizerSceneConverter&>(*converter).levelsOfDetail().empty());
+}
+
+void MeshOptimizerSceneConverterTest::levelsOfDetailSloppy() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("lodCount", 4);
+    converter->configuration().setValue("lodSloppy", true);
+
+    Containers::Optional<MeshData> out = converter->convert(Primitives::icosphereSolid(3));
+    CORRADE_VERIFY(out);
+
+    Containers::ArrayView<const MeshOptimizerSceneConverter::LevelOfDetail> levels = static_cast<MeshOptimizerSceneConverter&>(*converter).levelsOfDetail();
+    CORRADE_COMPARE(levels.size(), 4);
+    for(std::size_t i = 1; i != levels.size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE_AS(levels[i].indexCount, levels[i - 1].indexCount,
+            TestSuite::Compare::Less);
+        CORRADE_COMPARE_AS(levels[i].vertexCount, levels[i - 1].vertexCount,
+            TestSuite::Compare::LessOrEqual);
+    }
+}
+
+void MeshOptimizerSceneConverterTest::meshletsInvalidLimits() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("buildMeshlets", true);
+    converter->configuration().setValue("meshletMaxVertices", 256);
+    converter->configuration().setValue("meshletMaxTriangles", 126);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(Primitives::icosphereSolid(0)));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::convert(): expected meshletMaxVertices to be in range [3, 255] and meshletMaxTriangles divisible by four in range [4, 512] but got 256 and 126\n");
+}
+
+void MeshOptimizerSceneConverterTest::meshletsNoPositions() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("optimizeVertexCache", false);
+    converter->configuration().setValue("optimizeOverdraw", false);
+    converter->configuration().setValue("optimizeVertexFetch", false);
+    converter->configuration().setValue("buildMeshlets", true);
+
+    const UnsignedByte indexData[3]{};
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indexData, MeshIndexData{indexData},
+        nullptr, {}, 1};
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(mesh));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::convert(): optimizeOverdraw and simplify require the mesh to have positions\n");
+}
+
+template<class T> void MeshOptimizerSceneConverterTest::meshlets() {
+    setTestCaseTemplateName(Math::TypeTraits<T>::name());
+
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("buildMeshlets", true);
+    converter->configuration().setValue("meshletMaxVertices", 32);
+    converter->configuration().setValue("meshletMaxTriangles", 32);
+    converter->configuration().setValue("meshletConeWeight", 0.5f);
+
+    Containers::Optional<MeshData> out = converter->convert(MeshTools::compressIndices(
+        Primitives::icosphereSolid(2),
+        Implementation::meshIndexTypeFor<T>()));
+    CORRADE_VERIFY(out);
+
+    MeshOptimizerSceneConverter& meshOptimizer = static_cast<MeshOptimizerSceneConverter&>(*converter);
+    Containers::ArrayView<const MeshOptimizerSceneConverter::Meshlet> meshlets = meshOptimizer.meshlets();
+    Containers::ArrayView<const UnsignedInt> vertices = meshOptimizer.meshletVertices();
+    Containers::ArrayView<const UnsignedByte> triangles = meshOptimizer.meshletTriangles();
+    CORRADE_COMPARE_AS(meshlets.size(), std::size_t{1},
+        TestSuite::Compare::Greater);
+
+    /* The meshlets should cover all triangles of the mesh, each referencing
+       just its own vertices, with the triangles in the original winding */
+    const Containers::Array<UnsignedInt> indices = out->indicesAsArray();
+    const Containers::StridedArrayView1D<const Vector3> positions = out->attribute<Vector3>(MeshAttribute::Position);
+    std::size_t triangleCount = 0;
+    Containers::Array<UnsignedInt> triangleUseCount{Containers::ValueInit, indices.size()/3};
+    for(std::size_t i = 0; i != meshlets.size(); ++i) {
+        CORRADE_ITERATION(i);
+        const MeshOptimizerSceneConverter::Meshlet& meshlet = meshlets[i];
+        CORRADE_COMPARE_AS(meshlet.vertexCount, 32u,
+            TestSuite::Compare::LessOrEqual);
+        CORRADE_COMPARE_AS(meshlet.triangleCount, 32u,
+            TestSuite::Compare::LessOrEqual);
+        CORRADE_COMPARE(meshlet.triangleOffset % 4, 0);
+        CORRADE_COMPARE_AS(std::size_t(meshlet.vertexOffset + meshlet.vertexCount), vertices.size(),
+            TestSuite::Compare::LessOrEqual);
+        CORRADE_COMPARE_AS(std::size_t(meshlet.triangleOffset + meshlet.triangleCount*3), triangles.size(),
+            TestSuite::Compare::LessOrEqual);
+
+        for(std::size_t j = 0; j != meshlet.triangleCount; ++j) {
+            UnsignedInt triangle[3];
+            for(std::size_t k = 0; k != 3; ++k) {
+                const UnsignedByte local = triangles[meshlet.triangleOffset + j*3 + k];
+                CORRADE_COMPARE_AS(UnsignedInt(local), meshlet.vertexCount,
+                    TestSuite::Compare::Less);
+                triangle[k] = vertices[meshlet.vertexOffset + local];
+
+                /* All vertices are inside the bounding sphere */
+                CORRADE_COMPARE_AS((positions[triangle[k]] - meshlet.center).length(), meshlet.radius + 1.0e-5f,
+                    TestSuite::Compare::LessOrEqual);
+            }
+
+            /* Find the triangle in the index buffer, with any rotation */
+            for(std::size_t t = 0; t != indices.size()/3; ++t) {
+                for(std::size_t k = 0; k != 3; ++k) {
+                    if(indices[t*3 + k] == triangle[0] &&
+                       indices[t*3 + (k + 1) % 3] == triangle[1] &&
+                       indices[t*3 + (k + 2) % 3] == triangle[2])
+                        ++triangleUseCount[t];
+                }
+            }
+        }
+
+        triangleCount += meshlet.triangleCount;
+    }
+    CORRADE_COMPARE(triangleCount, indices.size()/3);
+    for(std::size_t t = 0; t != triangleUseCount.size(); ++t) {
+        CORRADE_ITERATION(t);
+        CORRADE_COMPARE(triangleUseCount[t], 1);
+    }
+
+    /* Converting again without meshlets clears them */
+    converter->configuration().setValue("buildMeshlets", false);
+    CORRADE_VERIFY(converter->convert(*out));
+    CORRADE_VERIFY(meshOptimizer.meshlets().empty());
+    CORRADE_VERIFY(meshOptimizer.meshletVertices().empty());
+    CORRADE_VERIFY(meshOptimizer.meshletTriangles().empty());
+}
+
+void MeshOptimizerSceneConverterTest::meshletsInPlace() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("buildMeshlets", true);
+
+    MeshData sphere = Primitives::icosphereSolid(2);
+    const UnsignedInt triangleCount = sphere.indexCount()/3;
+    CORRADE_VERIFY(converter->convertInPlace(sphere));
+
+    /* The default limits are large enough for the whole sphere to fit into
+       just a few meshlets */
+    Containers::ArrayView<const MeshOptimizerSceneConverter::Meshlet> meshlets = static_cast<MeshOptimizerSceneConverter&>(*converter).meshlets();
+    CORRADE_COMPARE_AS(meshlets.size(), std::size_t{0},
+        TestSuite::Compare::Greater);
+    UnsignedInt meshletTriangleCount = 0;
+    for(const MeshOptimizerSceneConverter::Meshlet& meshlet: meshlets)
+        meshletTriangleCount += meshlet.triangleCount;
+    CORRADE_COMPARE(meshletTriangleCount, triangleCount);
+}
+
+void MeshOptimizerSceneConverterTest::stripifyInPlace() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("optimizeVertexCache", false);
+    converter->configuration().setValue("optimizeOverdraw", false);
+    converter->configuration().setValue("optimizeVertexFetch", false);
+    converter->configuration().setValue("stripify", true);
+
+    const UnsignedByte indexData[3]{};
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indexData, MeshIndexData{indexData},
+        nullptr, {}, 1};
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertInPlace(mesh));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::convertInPlace(): strip conversion can't be performed in-place, use convert() instead\n");
+}
+
+void MeshOptimizerSceneConverterTest::stripifyLevelsOfDetail() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("stripify", true);
+    converter->configuration().setValue("lodCount", 3);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convert(Primitives::icosphereSolid(1)));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::convert(): strip conversion can't be combined with level of detail generation\n");
+}
+
+void MeshOptimizerSceneConverterTest::stripifyConvertToData() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("stripify", true);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToData(Primitives::icosphereSolid(1)));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::convertToData(): strip conversion isn't supported for compressed output\n");
+}
+
+/* Counts non-degenerate triangles in a strip */
+std::size_t stripTriangleCount(const Containers::ArrayView<const UnsignedInt> strip, const UnsignedInt restart) {
+    std::size_t count = 0;
+    std::size_t start = 0;
+    for(std::size_t i = 0; i != strip.size(); ++i) {
+        if(strip[i] == restart) {
+            start = i + 1;
+            continue;
+        }
+        if(i - start < 2) continue;
+        const UnsignedInt a = strip[i - 2], b = strip[i - 1], c = strip[i];
+        if(a != b && b != c && a != c) ++count;
+    }
+    return count;
+}
+
+void MeshOptimizerSceneConverterTest::stripify() {
+    auto&& data = StripifyData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("stripify", true);
+    converter->configuration().setValue("stripifyRestart", data.restart);
+
+    MeshData icosphere = MeshTools::compressIndices(Primitives::icosphereSolid(3));
+    CORRADE_COMPARE(icosphere.indexType(), MeshIndexType::UnsignedShort);
+    Containers::Optional<MeshData> optimized = converter->convert(icosphere);
+    CORRADE_VERIFY(optimized);
+    CORRADE_COMPARE(optimized->primitive(), MeshPrimitive::TriangleStrip);
+    CORRADE_COMPARE(optimized->indexType(), MeshIndexType::UnsignedShort);
+    CORRADE_COMPARE(optimized->vertexCount(), icosphere.vertexCount());
+    CORRADE_COMPARE(optimized->attributeCount(), icosphere.attributeCount());
+    CORRADE_COMPARE_AS(optimized->indexCount(), icosphere.indexCount(),
+        TestSuite::Compare::Less);
+
+    /* All triangles should be there, the restart index being the maximal
+       value of the index type */
+    const Containers::Array<UnsignedInt> strip = optimized->indicesAsArray();
+    bool hasRestart = false;
+    for(const UnsignedInt index: strip) if(index == 0xffff) hasRestart = true;
+    CORRADE_COMPARE(hasRestart, data.restart);
+    CORRADE_COMPARE(stripTriangleCount(strip, data.restart ? 0xffff : ~UnsignedInt{}), icosphere.indexCount()/3);
+}
+
+void MeshOptimizerSceneConverterTest::stripifyRestartWidenIndexType() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("optimizeOverdraw", false);
+    converter->configuration().setValue("optimizeVertexFetch", false);
+    converter->configuration().setValue("stripify", true);
+
+    /* 256 vertices in 8-bit indices, the last one would collide with the
+       restart index */
+    UnsignedByte indexData[85*3];
+    for(std::size_t i = 0; i != Containers::arraySize(indexData); ++i)
+        indexData[i] = 255 - i;
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indexData, MeshIndexData{indexData},
+        nullptr, {}, 256};
+    Containers::Optional<MeshData> optimized = converter->convert(mesh);
+    CORRADE_VERIFY(optimized);
+    CORRADE_COMPARE(optimized->primitive(), MeshPrimitive::TriangleStrip);
+    CORRADE_COMPARE(optimized->indexType(), MeshIndexType::UnsignedShort);
+    CORRADE_COMPARE(stripTriangleCount(optimized->indicesAsArray(), 0xffff), 85);
+}
+
+void MeshOptimizerSceneConverterTest::shadowMesh() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("generateShadowIndices", true);
+
+    /* A cube has each corner duplicated three times because of the normals */
+    MeshData cube = Primitives::cubeSolid();
+    CORRADE_COMPARE(cube.vertexCount(), 24);
+    Containers::Optional<MeshData> optimized = converter->convert(cube);
+    CORRADE_VERIFY(optimized);
+
+    Containers::Optional<MeshData> shadow = static_cast<MeshOptimizerSceneConverter&>(*converter).shadowMesh();
+    CORRADE_VERIFY(shadow);
+    CORRADE_COMPARE(shadow->primitive(), MeshPrimitive::Triangles);
+    CORRADE_COMPARE(shadow->indexType(), MeshIndexType::UnsignedInt);
+    CORRADE_COMPARE(shadow->indexCount(), optimized->indexCount());
+    CORRADE_COMPARE(shadow->vertexCount(), 8);
+    CORRADE_COMPARE(shadow->attributeCount(), 1);
+    CORRADE_COMPARE(shadow->attributeFormat(MeshAttribute::Position), VertexFormat::Vector3);
+
+    /* Each triangle should have the same positions as in the optimized mesh */
+    const Containers::Array<UnsignedInt> indices = optimized->indicesAsArray();
+    const Containers::StridedArrayView1D<const Vector3> positions = optimized->attribute<Vector3>(MeshAttribute::Position);
+    const Containers::ArrayView<const UnsignedInt> shadowIndices = shadow->indices<UnsignedInt>();
+    const Containers::StridedArrayView1D<const Vector3> shadowPositions = shadow->attribute<Vector3>(MeshAttribute::Position);
+    for(std::size_t i = 0; i != indices.size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(shadowPositions[shadowIndices[i]], positions[indices[i]]);
+    }
+
+    /* The shadow vertices are ordered by first use */
+    CORRADE_COMPARE(shadowIndices[0], 0);
+}
+
+void MeshOptimizerSceneConverterTest::shadowMeshInPlace() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("generateShadowIndices", true);
+
+    MeshData cube = MeshTools::owned(Primitives::cubeSolid());
+    CORRADE_VERIFY(converter->convertInPlace(cube));
+
+    Containers::Optional<MeshData> shadow = static_cast<MeshOptimizerSceneConverter&>(*converter).shadowMesh();
+    CORRADE_VERIFY(shadow);
+    CORRADE_COMPARE(shadow->indexCount(), cube.indexCount());
+    CORRADE_COMPARE(shadow->vertexCount(), 8);
+
+    const Containers::Array<UnsignedInt> indices = cube.indicesAsArray();
+    const Containers::StridedArrayView1D<const Vector3> positions = cube.attribute<Vector3>(MeshAttribute::Position);
+    const Containers::ArrayView<const UnsignedInt> shadowIndices = shadow->indices<UnsignedInt>();
+    const Containers::StridedArrayView1D<const Vector3> shadowPositions = shadow->attribute<Vector3>(MeshAttribute::Position);
+    for(std::size_t i = 0; i != indices.size(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(shadowPositions[shadowIndices[i]], positions[indices[i]]);
+    }
+}
+
+void MeshOptimizerSceneConverterTest::shadowMeshNotEnabled() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("generateShadowIndices", true);
+
+    CORRADE_VERIFY(converter->convert(Primitives::cubeSolid()));
+    CORRADE_VERIFY(static_cast<MeshOptimizerSceneConverter&>(*converter).shadowMesh());
+
+    /* Disabling the option again clears the previous shadow mesh */
+    converter->configuration().setValue("generateShadowIndices", false);
+    CORRADE_VERIFY(converter->convert(Primitives::cubeSolid()));
+    CORRADE_VERIFY(!static_cast<MeshOptimizerSceneConverter&>(*converter).shadowMesh());
+}
+
+void MeshOptimizerSceneConverterTest::convertToData() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    CORRADE_VERIFY(converter->features() & SceneConverterFeature::ConvertMeshToData);
+
+    Containers::Array<char> data = converter->convertToData(Primitives::icosphereSolid(1));
+    CORRADE_VERIFY(data);
+
+    /* A GLB header with the total size, a JSON chunk referencing the
+       extension and a binary chunk */
+    CORRADE_COMPARE_AS(data.size(), std::size_t{28},
+        TestSuite::Compare::Greater);
+    CORRADE_COMPARE(std::string(data, 4), "glTF");
+    UnsignedInt header[5];
+    std::memcpy(header, data, sizeof(header));
+    CORRADE_COMPARE(header[1], 2);
+    CORRADE_COMPARE(header[2], data.size());
+    CORRADE_COMPARE(header[3] % 4, 0);
+    CORRADE_COMPARE(header[4], 0x4E4F534A);
+    const std::string json{data + 20, header[3]};
+    CORRADE_VERIFY(json.find(R"("extensionsRequired": ["EXT_meshopt_compression"])") != std::string::npos);
+    CORRADE_VERIFY(json.find(R"("attributes": {"POSITION": 0, "NORMAL": 1})") != std::string::npos);
+    CORRADE_VERIFY(json.find(R"("mode": "ATTRIBUTES")") != std::string::npos);
+    CORRADE_VERIFY(json.find(R"("mode": "TRIANGLES")") != std::string::npos);
+    UnsignedInt binHeader[2];
+    std::memcpy(binHeader, data + 20 + header[3], sizeof(binHeader));
+    CORRADE_COMPARE(binHeader[0], data.size() - 28 - header[3]);
+    CORRADE_COMPARE(binHeader[1], 0x004E4942);
+}
+
+void MeshOptimizerSceneConverterTest::convertToDataSkipAttributes() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+
+    const struct Vertex {
+        Vector3 position;
+        Double weight;
+        Float custom;
+    } vertexData[3]{};
+    const UnsignedShort indexData[3]{0, 1, 2};
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indexData, MeshIndexData{indexData},
+        {}, vertexData, {
+            MeshAttributeData{MeshAttribute::Position,
+                Containers::StridedArrayView1D<const Vector3>{vertexData, &vertexData[0].position, 3, sizeof(Vertex)}},
+            MeshAttributeData{meshAttributeCustom(1),
+                Containers::StridedArrayView1D<const Double>{vertexData, &vertexData[0].weight, 3, sizeof(Vertex)}},
+            MeshAttributeData{meshAttributeCustom(2),
+                Containers::StridedArrayView1D<const Float>{vertexData, &vertexData[0].custom, 3, sizeof(Vertex)}}
+        }};
+
+    std::ostringstream out;
+    Warning redirectWarning{&out};
+    CORRADE_VERIFY(converter->convertToData(mesh));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::convertToData(): skipping attribute Trade::MeshAttribute::Custom(1) with unsupported format VertexFormat::Double\n"
+        "Trade::MeshOptimizerSceneConverter::convertToData(): skipping unsupported attribute Trade::MeshAttribute::Custom(2)\n");
+}
+
+void MeshOptimizerSceneConverterTest::convertToDataImport() {
+    if(!(_importerManager.loadState("TinyGltfImporter") & PluginManager::LoadState::Loaded))
+        CORRADE_SKIP("TinyGltfImporter plugin not enabled or built without meshoptimizer, cannot test");
+
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+
+    /* The same processing is done for both, so the imported mesh should be
+       the same as convert() output */
+    MeshData sphere = Primitives::uvSphereSolid(4, 6, Primitives::UVSphereFlag::TextureCoordinates);
+    Containers::Optional<MeshData> expected = converter->convert(sphere);
+    CORRADE_VERIFY(expected);
+    Containers::Array<char> data = converter->convertToData(sphere);
+    CORRADE_VERIFY(data);
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("TinyGltfImporter");
+    CORRADE_VERIFY(importer->openData(data));
+    Containers::Optional<MeshData> imported = importer->mesh(0);
+    CORRADE_VERIFY(imported);
+    CORRADE_COMPARE(imported->primitive(), MeshPrimitive::Triangles);
+    CORRADE_COMPARE(imported->indexType(), expected->indexType());
+    CORRADE_COMPARE_AS(imported->indicesAsArray(), expected->indicesAsArray(),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(imported->attribute<Vector3>(MeshAttribute::Position),
+        expected->attribute<Vector3>(MeshAttribute::Position),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(imported->attribute<Vector3>(MeshAttribute::Normal),
+        expected->attribute<Vector3>(MeshAttribute::Normal),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(imported->attribute<Vector2>(MeshAttribute::TextureCoordinates),
+        expected->attribute<Vector2>(MeshAttribute::TextureCoordinates),
+        TestSuite::Compare::Container);
+}
+
+void MeshOptimizerSceneConverterTest::quantizeInPlace() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("optimizeVertexCache", false);
+    converter->configuration().setValue("optimizeOverdraw", false);
+    converter->configuration().setValue("optimizeVertexFetch", false);
+    converter->configuration().setValue("quantizeNormals", true);
+
+    const UnsignedByte indexData[3]{};
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indexData, MeshIndexData{indexData},
+        nullptr, {}, 1};
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertInPlace(mesh));
+    CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::convertInPlace(): vertex quantization can't be performed in-place, use convert() instead\n");
+}
+
+void MeshOptimizerSceneConverterTest::quantize() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("quantizePositions", true);
+    converter->configuration().setValue("quantizeNormals", true);
+    converter->configuration().setValue("quantizeTextureCoordinates", true);
+
+    /* Quantizing a non-quantized output to compare against */
+    MeshData sphere = Primitives::uvSphereSolid(4, 6, Primitives::UVSphereFlag::TextureCoordinates);
+    converter->configuration().setValue("quantizePositions", false);
+    converter->configuration().setValue("quantizeNormals", false);
+    converter->configuration().setValue("quantizeTextureCoordinates", false);
+    Containers::Optional<MeshData> expected = converter->convert(sphere);
+    CORRADE_VERIFY(expected);
+    converter->configuration().setValue("quantizePositions", true);
+    converter->configuration().setValue("quantizeNormals", true);
+    converter->configuration().setValue("quantizeTextureCoordinates", true);
+    Containers::Optional<MeshData> quantized = converter->convert(sphere);
+    CORRADE_VERIFY(quantized);
+
+    /* 8 + 4 + 4 bytes instead of 12 + 12 + 8 */
+    CORRADE_COMPARE(quantized->attributeFormat(MeshAttribute::Position), VertexFormat::Vector3usNormalized);
+    CORRADE_COMPARE(quantized->attributeFormat(MeshAttribute::Normal), VertexFormat::Vector3bNormalized);
+    CORRADE_COMPARE(quantized->attributeFormat(MeshAttribute::TextureCoordinates), VertexFormat::Vector2usNormalized);
+    CORRADE_COMPARE(quantized->attributeStride(MeshAttribute::Position), 16);
+    CORRADE_COMPARE(quantized->vertexCount(), expected->vertexCount());
+    CORRADE_COMPARE_AS(quantized->indicesAsArray(), expected->indicesAsArray(),
+        TestSuite::Compare::Container);
+
+    /* The unit sphere gets scaled to a [0, 1] cube */
+    const Matrix4 dequantization = static_cast<MeshOptimizerSceneConverter&>(*converter).positionDequantization();
+    CORRADE_COMPARE(dequantization, Matrix4::translation(Vector3{-1.0f})*Matrix4::scaling(Vector3{2.0f}));
+
+    const auto expectedPositions = expected->attribute<Vector3>(MeshAttribute::Position);
+    const auto expectedNormals = expected->attribute<Vector3>(MeshAttribute::Normal);
+    const auto expectedTextureCoordinates = expected->attribute<Vector2>(MeshAttribute::TextureCoordinates);
+    const auto positions = quantized->attribute<Vector3us>(MeshAttribute::Position);
+    const auto normals = quantized->attribute<Vector3b>(MeshAttribute::Normal);
+    const auto textureCoordinates = quantized->attribute<Vector2us>(MeshAttribute::TextureCoordinates);
+    for(std::size_t i = 0; i != quantized->vertexCount(); ++i) {
+        CORRADE_ITERATION(i);
+        const Vector3 position = dequantization.transformPoint(Math::unpack<Vector3>(positions[i]));
+        CORRADE_COMPARE_AS((position - expectedPositions[i]).max(), 1.0e-4f,
+            TestSuite::Compare::Less);
+        CORRADE_COMPARE_AS((Math::unpack<Vector3>(normals[i]) - expectedNormals[i]).max(), 1.0e-2f,
+            TestSuite::Compare::Less);
+        CORRADE_COMPARE_AS((Math::unpack<Vector2>(textureCoordinates[i]) - expectedTextureCoordinates[i]).max(), 1.0e-4f,
+            TestSuite::Compare::Less);
+    }
+
+    /* Converting again without quantization resets the transformation */
+    converter->configuration().setValue("quantizePositions", false);
+    CORRADE_VERIFY(converter->convert(sphere));
+    CORRADE_COMPARE(static_cast<MeshOptimizerSceneConverter&>(*converter).positionDequantization(), Matrix4{});
+}
+
+void MeshOptimizerSceneConverterTest::quantizeTextureCoordinatesOutOfRange() {
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("optimizeVertexCache", false);
+    converter->configuration().setValue("optimizeOverdraw", false);
+    converter->configuration().setValue("optimizeVertexFetch", false);
+    converter->configuration().setValue("quantizeTextureCoordinates", true);
+
+    const UnsignedByte indexData[3]{0, 1, 2};
+    const Vector2 vertexData[3]{
+        {0.0f, 0.5f},
+        {2.0f, 0.25f},
+        {-1.0f, 1.0f}
+    };
+    MeshData mesh{MeshPrimitive::Triangles,
+        {}, indexData, MeshIndexData{indexData},
+        {}, vertexData, {
+            MeshAttributeData{MeshAttribute::TextureCoordinates,
+                Containers::arrayView(vertexData)}
+        }};
+    Containers::Optional<MeshData> quantized = converter->convert(mesh);
+    CORRADE_VERIFY(quantized);
+    CORRADE_COMPARE(quantized->attributeFormat(MeshAttribute::TextureCoordinates), VertexFormat::Vector2h);
+    /* Comparing the raw bits to not depend on half-float conversion */
+    CORRADE_COMPARE_AS((Containers::arrayCast<1, const Vector2us>(quantized->attribute(MeshAttribute::TextureCoordinates))),
+        Containers::arrayView<Vector2us>({
+            {0x0000, 0x3800},
+            {0x4000, 0x3400},
+            {0xbc00, 0x3c00}
+        }), TestSuite::Compare::Container);
+}
+
+void MeshOptimizerSceneConverterTest::convertBatch() {
+    auto&& data = ConvertBatchData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractSceneConverter> converter = _manager.instantiate("MeshOptimizerSceneConverter");
+    converter->configuration().setValue("threads", data.threads);
+    /* Simplification allocates a lot internally, so it's a good test for the
+       scratch allocator */
+    converter->configuration().setValue("simplify", true);
+    converter->configuration().setValue("simplifyTargetIndexCountThreshold", 0.5f);
+
+    MeshData icosphere = MeshTools::compressIndices(Primitives::icosphereSolid(3));
+    MeshData square = Primitives::squareSolid();
+    MeshData instances{MeshPrimitive::Instances, 3};
+    MeshData sphere = Primitives::uvSphereSolid(16, 32, Primitives::UVSphereFlag::TextureCoordinates);
+    const Containers::Reference<const MeshData> meshes[]{
+        icosphere, square, instances, sphere, icosphere
+    };
+
+    std::ostringstream out;
+    Containers::Array<Containers::Optional<MeshData>> converted;
+    {
+        Error redirectError{&out};
+        converted = static_cast<MeshOptimizerSceneConverter&>(*converter).convertBatch(meshes);
+    }
+    CORRADE_COMPARE(converted.size(), 5);
+    CORRADE_VERIFY(!converted[2]);
+    /* The message is printed only if the failure happened on this thread */
+    if(data.threads == 1) CORRADE_COMPARE(out.str(),
+        "Trade::MeshOptimizerSceneConverter::convertBatch(): expected a triangle mesh, got MeshPrimitive::Instances\n");
+
+    /* The per-mesh state isn't populated */
+    CORRADE_VERIFY(static_cast<MeshOptimizerSceneConverter&>(*converter).levelsOfDetail().empty());
+
+    /* Each mesh should be the same as if converted separately */
+    for(std::size_t i: {0, 1, 3, 4}) {
+        CORRADE_ITERATION(i);
+        CORRADE_VERIFY(converted[i]);
+
+        Containers::Optional<MeshData> expected = converter->convert(meshes[i]);
+        CORRADE_VERIFY(expected);
+        CORRADE_COMPARE(converted[i]->primitive(), expected->primitive());
+        CORRADE_COMPARE(converted[i]->indexType(), expected->indexType());
+        CORRADE_COMPARE(converted[i]->vertexCount(), expected->vertexCount());
+        CORRADE_COMPARE(converted[i]->attributeCount(), expected->attributeCount());
+        CORRADE_COMPARE_AS(converted[i]->indexData(),
+            expected->indexData(),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(converted[i]->vertexData(),
+            expected->vertexData(),
+            TestSuite::Compare::Container);
+    }
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::MeshOptimizerSceneConverterTest)
@@ -24,3 +24,4 @@
 */
 
 #cmakedefine MESHOPTIMIZERSCENECONVERTER_PLUGIN_FILENAME "${MESHOPTIMIZERSCENECONVERTER_PLUGIN_FILENAME}"
+#cmakedefine TINYGLTFIMPORTER_PLUGIN_FILENAME "${TINYGLTFIMPORTER_PLUGIN_FILENAME}"
@@ -25,7 +25,7 @@
 
 #include "MagnumPlugins/MeshOptimizerSceneConverter/configure.h"
 
-#ifdef MAGNUM_MESHOPTIMIZERSCENECONVERTER_BUILD_STATIC
+#if defined(MAGNUM_MESHOPTIMIZERSCENECONVERTER_BUILD_STATIC) && !defined(MAGNUM_PLUGINS_NO_AUTOMATIC_IMPORT)
 #include <Corrade/PluginManager/AbstractManager.h>
 
 static int magnumMeshOptimizerSceneConverterStaticImporter() {
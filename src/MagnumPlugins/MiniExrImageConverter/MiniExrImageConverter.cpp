@@ -25,10 +25,21 @@
 
 #include "MiniExrImageConverter.h"
 
-#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/DebugStl.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/ConfigurationValue.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Vector2.h>
 
 #ifdef __clang__
 #pragma GCC diagnostic push
@@ -39,14 +50,214 @@
 #pragma GCC diagnostic pop
 #endif
 
+/* Only the zlib compressor is used from stb_image_write, for the ZIP and ZIPS
+   compression. Making everything static so it doesn't conflict with
+   StbImageConverter in static builds. */
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#define STB_IMAGE_WRITE_STATIC
+#define STBI_WRITE_NO_STDIO
+#define STBIW_ASSERT CORRADE_INTERNAL_ASSERT
+#include "stb_image_write.h"
+
 namespace Magnum { namespace Trade {
 
-MiniExrImageConverter::MiniExrImageConverter() = default;
+MiniExrImageConverter::MiniExrImageConverter() {
+    /** @todo horrible workaround, fix this properly */
+    configuration().setValue("compression", "none");
+    configuration().setValue("tileSize", Vector2i{});
+    configuration().setValue("threads", 1);
+    configuration().setValue("yFlip", true);
+}
 
 MiniExrImageConverter::MiniExrImageConverter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImageConverter{manager, plugin} {}
 
 ImageConverterFeatures MiniExrImageConverter::doFeatures() const { return ImageConverterFeature::ConvertData; }
 
+namespace {
+
+/* Values of the compression attribute */
+enum class Compression: UnsignedByte {
+    None = 0,
+    Rle = 1,
+    Zips = 2,
+    Zip = 3
+};
+
+/* EXR is always Little-Endian */
+void appendInt(Containers::Array<char>& out, const UnsignedInt value) {
+    const char bytes[]{char(value & 0xff), char((value >> 8) & 0xff), char((value >> 16) & 0xff), char((value >> 24) & 0xff)};
+    arrayAppend(out, Containers::arrayView(bytes));
+}
+
+void appendAttribute(Containers::Array<char>& out, const char* const name, const char* const type, const Containers::ArrayView<const char> value) {
+    arrayAppend(out, Containers::arrayView(name, std::strlen(name) + 1));
+    arrayAppend(out, Containers::arrayView(type, std::strlen(type) + 1));
+    appendInt(out, value.size());
+    arrayAppend(out, value);
+}
+
+/* Same attributes as miniexr writes, plus the tile description if tiled */
+Containers::Array<char> header(const Vector2i& size, const Compression compression, const Vector2i& tileSize) {
+    Containers::Array<char> out;
+
+    /* Magic, version 2, tiled flag */
+    arrayAppend(out, Containers::arrayView("\x76\x2f\x31\x01", 4));
+    appendInt(out, 2|(tileSize.isZero() ? 0 : 0x200));
+
+    /* Same as miniexr, only B, G, R channels as halfs, alpha is ignored */
+    {
+        Containers::Array<char> channels;
+        for(const char name: {'B', 'G', 'R'}) {
+            const char nameValue[]{name, '\0'};
+            arrayAppend(channels, Containers::arrayView(nameValue));
+            appendInt(channels, 1); /* HALF */
+            appendInt(channels, 0); /* pLinear, reserved */
+            appendInt(channels, 1); /* xSampling */
+            appendInt(channels, 1); /* ySampling */
+        }
+        arrayAppend(channels, '\0');
+        appendAttribute(out, "channels", "chlist", channels);
+    }
+
+    {
+        const char value[]{char(compression)};
+        appendAttribute(out, "compression", "compression", value);
+    }
+
+    {
+        Containers::Array<char> window;
+        appendInt(window, 0);
+        appendInt(window, 0);
+        appendInt(window, size.x() - 1);
+        appendInt(window, size.y() - 1);
+        appendAttribute(out, "dataWindow", "box2i", window);
+        appendAttribute(out, "displayWindow", "box2i", window);
+    }
+
+    /* Increasing Y */
+    appendAttribute(out, "lineOrder", "lineOrder", {"\0", 1});
+    appendAttribute(out, "pixelAspectRatio", "float", {"\0\0\x80\x3f", 4});
+    appendAttribute(out, "screenWindowCenter", "v2f", {"\0\0\0\0\0\0\0\0", 8});
+    appendAttribute(out, "screenWindowWidth", "float", {"\0\0\x80\x3f", 4});
+
+    /* Size of the tile and a single level with rounding down */
+    if(!tileSize.isZero()) {
+        Containers::Array<char> tiles;
+        appendInt(tiles, tileSize.x());
+        appendInt(tiles, tileSize.y());
+        arrayAppend(tiles, '\0');
+        appendAttribute(out, "tiles", "tiledesc", tiles);
+    }
+
+    /* End of header */
+    arrayAppend(out, '\0');
+    return out;
+}
+
+/* Both RLE and ZIP first reorder the bytes so the low and high bytes of the
+   halfs are together and then replace them with differences, which is what
+   this does */
+void predict(const Containers::ArrayView<const char> in, const Containers::ArrayView<char> out) {
+    const std::size_t half = (in.size() + 1)/2;
+    for(std::size_t i = 0; i != in.size(); ++i)
+        out[(i % 2 ? half : 0) + i/2] = in[i];
+    for(std::size_t i = out.size(); i > 1; --i)
+        out[i - 1] = char(UnsignedByte(out[i - 1]) - UnsignedByte(out[i - 2]) + 128);
+}
+
+/* Runs of at least three same bytes are stored as a count and the byte,
+   everything else as a negative count followed by the bytes. Same as
+   rleCompress() in OpenEXR. */
+void compressRle(const Containers::ArrayView<const char> in, Containers::Array<char>& out) {
+    constexpr std::ptrdiff_t MinRunLength = 3;
+    constexpr std::ptrdiff_t MaxRunLength = 127;
+
+    const char* const end = in.end();
+    const char* runStart = in.begin();
+    const char* runEnd = runStart + 1;
+    while(runStart < end) {
+        while(runEnd < end && *runStart == *runEnd && runEnd - runStart - 1 < MaxRunLength)
+            ++runEnd;
+
+        if(runEnd - runStart >= MinRunLength) {
+            arrayAppend(out, char((runEnd - runStart) - 1));
+            arrayAppend(out, *runStart);
+            runStart = runEnd;
+        } else {
+            while(runEnd < end && ((runEnd + 1 >= end || *runEnd != *(runEnd + 1)) || (runEnd + 2 >= end || *(runEnd + 1) != *(runEnd + 2))) && runEnd - runStart < MaxRunLength)
+                ++runEnd;
+            arrayAppend(out, char(runStart - runEnd));
+            arrayAppend(out, Containers::arrayView(runStart, runEnd - runStart));
+            runStart = runEnd;
+        }
+
+        ++runEnd;
+    }
+}
+
+/* Assembles a single scanline block or tile, including the coordinates and
+   data size. The input points to the top row in file order, with the stride
+   negative if the image is flipped. The raw and predicted arrays are scratch
+   memory reused across calls. */
+void writeChunk(const Compression compression, const bool tiled, const Vector2i& coordinates, const Vector2i& min, const Vector2i& max, const char* const input, const std::ptrdiff_t rowStride, const std::size_t pixelSize, Containers::Array<char>& raw, Containers::Array<char>& predicted, Containers::Array<char>& out) {
+    /* Gather the pixels. EXR has Y down, each line has the channels in
+       alphabetical order one after another. */
+    const std::size_t rawSize = std::size_t((max - min).product())*3*2;
+    if(raw.size() < rawSize) {
+        raw = Containers::Array<char>{Containers::NoInit, rawSize};
+        predicted = Containers::Array<char>{Containers::NoInit, rawSize};
+    }
+    char* o = raw.data();
+    for(Int y = min.y(); y != max.y(); ++y) {
+        const char* const row = input + y*rowStride;
+        for(const std::size_t channel: {4, 2, 0}) {
+            for(Int x = min.x(); x != max.x(); ++x) {
+                *o++ = row[x*pixelSize + channel];
+                *o++ = row[x*pixelSize + channel + 1];
+            }
+        }
+    }
+
+    /* Coordinates of the tile and level 0, or the first line of the block */
+    if(tiled) {
+        appendInt(out, coordinates.x());
+        appendInt(out, coordinates.y());
+        appendInt(out, 0);
+        appendInt(out, 0);
+    } else appendInt(out, min.y());
+
+    /* Size placeholder, filled after compression */
+    const std::size_t sizeOffset = out.size();
+    appendInt(out, 0);
+    const std::size_t dataOffset = out.size();
+
+    const Containers::ArrayView<const char> rawView = raw.prefix(rawSize);
+    if(compression == Compression::Rle) {
+        predict(rawView, predicted.prefix(rawSize));
+        compressRle(predicted.prefix(rawSize), out);
+    } else if(compression == Compression::Zip || compression == Compression::Zips) {
+        predict(rawView, predicted.prefix(rawSize));
+        int compressedSize;
+        unsigned char* const compressed = stbi_zlib_compress(reinterpret_cast<unsigned char*>(predicted.data()), int(rawSize), &compressedSize, 8);
+        CORRADE_INTERNAL_ASSERT(compressed);
+        arrayAppend(out, Containers::arrayView(reinterpret_cast<const char*>(compressed), compressedSize));
+        std::free(compressed);
+    }
+
+    /* If the compression didn't help, the data are stored uncompressed, which
+       the readers recognize by the size being the same as uncompressed */
+    if(compression == Compression::None || out.size() - dataOffset >= rawSize) {
+        arrayResize(out, dataOffset);
+        arrayAppend(out, rawView);
+    }
+
+    const UnsignedInt dataSize = out.size() - dataOffset;
+    for(std::size_t i = 0; i != 4; ++i)
+        out[sizeOffset + i] = char((dataSize >> (8*i)) & 0xff);
+}
+
+}
+
 Containers::Array<char> MiniExrImageConverter::doExportToData(const ImageView2D& image) {
     Int components;
     switch(image.format()) {
@@ -57,30 +268,99 @@ Containers::Array<char> MiniExrImageConverter::doExportToData(const ImageView2D&
             return nullptr;
     }
 
+    Compression compression;
+    const std::string compressionName = configuration().value("compression");
+    if(compressionName == "none")
+        compression = Compression::None;
+    else if(compressionName == "rle")
+        compression = Compression::Rle;
+    else if(compressionName == "zips")
+        compression = Compression::Zips;
+    else if(compressionName == "zip")
+        compression = Compression::Zip;
+    else {
+        Error{} << "Trade::MiniExrImageConverter::exportToData(): unsupported compression" << compressionName;
+        return nullptr;
+    }
+
+    const Vector2i tileSize = configuration().value<Vector2i>("tileSize");
+    if(!tileSize.isZero() && tileSize.min() <= 0) {
+        Error{} << "Trade::MiniExrImageConverter::exportToData(): expected tile size to be either zero or positive but got" << tileSize;
+        return nullptr;
+    }
+
     /* Get data properties and calculate the initial slice based on subimage
        offset */
     const std::pair<Math::Vector2<std::size_t>, Math::Vector2<std::size_t>> dataProperties = image.dataProperties();
-    Containers::ArrayView<const char> inputData = image.data().suffix(dataProperties.first.sum());
-
-    /* Do Y-flip and tight packing of image data */
-    const std::size_t rowSize = image.size().x()*image.pixelSize();
-    const std::size_t rowStride = dataProperties.second.x();
-    const std::size_t packedDataSize = rowSize*image.size().y();
-    Containers::Array<char> reversedPackedData{packedDataSize};
-    for(std::int_fast32_t y = 0; y != image.size().y(); ++y)
-        std::copy_n(inputData.suffix((image.size().y() - y - 1)*rowStride).data(), rowSize, reversedPackedData + y*rowSize);
-
-    std::size_t size;
-    unsigned char* const data = miniexr_write(image.size().x(), image.size().y(), components, reversedPackedData, &size);
-    CORRADE_INTERNAL_ASSERT(data);
-
-    /* miniexr uses malloc to allocate and since we can't use custom deleters,
-       copy the result into a new-allocated array instead */
-    Containers::Array<char> fileData{size};
-    std::copy_n(data, size, fileData.begin());
-    std::free(data);
-
-    return fileData;
+    const char* const inputData = image.data().data() + dataProperties.first.sum();
+
+    /* EXR has Y down. The Y-flip is done by going from the last row with a
+       negative stride, so the input doesn't need to be repacked. With the
+       flip disabled the rows are simply taken in order. */
+    const bool yFlip = configuration().value<bool>("yFlip");
+    const std::ptrdiff_t rowStride = yFlip ? -std::ptrdiff_t(dataProperties.second.x()) : std::ptrdiff_t(dataProperties.second.x());
+    const char* const firstRow = yFlip && image.size().y() ?
+        inputData + (image.size().y() - 1)*dataProperties.second.x() : inputData;
+
+    /* Uncompressed scanline images are written with miniexr. Write directly
+       into a new-allocated array, which means no copy is needed afterwards
+       and the default deleter can be used. */
+    if(compression == Compression::None && tileSize.isZero()) {
+        Containers::Array<char> fileData{Containers::NoInit, miniexr_size(image.size().x(), image.size().y())};
+        miniexr_write_to(image.size().x(), image.size().y(), components,
+            firstRow, rowStride, reinterpret_cast<unsigned char*>(fileData.data()));
+        return fileData;
+    }
+
+    /* Otherwise split the image into blocks of scanlines or tiles, each is
+       then compressed independently */
+    const bool tiled = !tileSize.isZero();
+    const Vector2i blockSize = tiled ? tileSize :
+        Vector2i{Math::max(image.size().x(), 1), compression == Compression::Zip ? 16 : 1};
+    const Vector2i blockCount = (image.size() + blockSize - Vector2i{1})/blockSize;
+    const std::size_t chunkCount = blockCount.product();
+
+    std::size_t threadCount = configuration().value<std::size_t>("threads");
+    if(!threadCount) threadCount = Math::max(1u, std::thread::hardware_concurrency());
+    threadCount = Math::max(std::size_t{1}, Math::min(threadCount, chunkCount));
+
+    Containers::Array<Containers::Array<char>> chunks{chunkCount};
+    std::atomic<std::size_t> next{0};
+    auto worker = [&]() {
+        Containers::Array<char> raw, predicted;
+        for(std::size_t i; (i = next++) < chunkCount; ) {
+            const Vector2i coordinates{Int(i % blockCount.x()), Int(i / blockCount.x())};
+            const Vector2i min = coordinates*blockSize;
+            const Vector2i max = Math::min(min + blockSize, image.size());
+            writeChunk(compression, tiled, coordinates, min, max, firstRow, rowStride, image.pixelSize(), raw, predicted, chunks[i]);
+        }
+    };
+
+    if(threadCount == 1) worker();
+    else {
+        Containers::Array<std::thread> threads{threadCount - 1};
+        for(std::thread& thread: threads) thread = std::thread{worker};
+        worker();
+        for(std::thread& thread: threads) thread.join();
+    }
+
+    /* Header, then the chunk offset table and the chunks themselves */
+    Containers::Array<char> head = header(image.size(), compression, tileSize);
+    std::size_t size = head.size() + chunkCount*8;
+    for(const Containers::Array<char>& chunk: chunks) size += chunk.size();
+
+    Containers::Array<char> out{Containers::NoInit, size};
+    Utility::copy(head, out.prefix(head.size()));
+    char* offsetTable = out.data() + head.size();
+    std::size_t offset = head.size() + chunkCount*8;
+    for(const Containers::Array<char>& chunk: chunks) {
+        for(std::size_t i = 0; i != 8; ++i)
+            *offsetTable++ = char((UnsignedLong(offset) >> (8*i)) & 0xff);
+        Utility::copy(chunk, out.slice(offset, offset + chunk.size()));
+        offset += chunk.size();
+    }
+
+    return out;
 }
 
 }}
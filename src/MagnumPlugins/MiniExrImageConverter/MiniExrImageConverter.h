@@ -61,8 +61,8 @@ Supports images with format @ref PixelFormat::RGB16F or
 library.
 
 This plugins provides `OpenExrImageConverter` plugin, but note that this plugin
-generates only uncompressed files and the performance might be worse than when
-using plugin dedicated for given format.
+supports only a subset of the format and the performance might be worse than
+when using plugin dedicated for given format.
 
 @m_class{m-block m-primary}
 
@@ -70,6 +70,17 @@ using plugin dedicated for given format.
     [miniexr](https://github.com/aras-p/miniexr) library by Aras Pranckevičius, released into the @m_class{m-label m-primary} **public domain**
     ([choosealicense.com](https://choosealicense.com/licenses/unlicense/)).
 
+@m_class{m-block m-primary}
+
+@thirdparty This plugin makes use of the
+    [stb_image_write](https://github.com/nothings/stb) library by Sean Barrett,
+    released into the @m_class{m-label m-primary} **public domain**
+    ([license text](https://github.com/nothings/stb/blob/e6afb9cbae4064da8c3e69af3ff5c4629579c1d2/stb_image_write.h#L1550-L1566),
+    [choosealicense.com](https://choosealicense.com/licenses/unlicense/)),
+    or alternatively under @m_class{m-label m-success} **MIT**
+    ([license text](https://github.com/nothings/stb/blob/e6afb9cbae4064da8c3e69af3ff5c4629579c1d2/stb_image_write.h#L1532-L1548),
+    [choosealicense.com](https://choosealicense.com/licenses/mit/)).
+
 @section Trade-MiniExrImageConverter-usage Usage
 
 This plugin depends on the @ref Trade library and is built if
@@ -104,6 +115,39 @@ target_link_libraries(your-app PRIVATE MagnumPlugins::MiniExrImageConverter)
 
 See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
 information.
+
+@section Trade-MiniExrImageConverter-behavior Behavior and limitations
+
+The output has three @cb{.txt} B @ce, @cb{.txt} G @ce and @cb{.txt} R @ce
+half-float channels, alpha of @ref PixelFormat::RGBA16F images is ignored. By
+default an uncompressed scanline image is written. Using the
+@cb{.ini} compression @ce
+@ref Trade-MiniExrImageConverter-configuration "configuration option", it's
+possible to choose RLE or ZIP compression, the latter using the zlib
+compressor from [stb_image_write](https://github.com/nothings/stb). PIZ and
+other lossy compression methods are not supported. Blocks that don't get
+smaller by the compression are stored uncompressed. Setting the
+@cb{.ini} tileSize @ce option writes a single-level tiled image instead of
+scanlines.
+
+The scanline blocks or tiles are compressed independently, and with the
+@cb{.ini} threads @ce option set to something else than @cpp 1 @ce they're
+distributed across multiple threads. The output is the same regardless of the
+thread count. If you use the threads, check the
+@ref Trade-BasisImageConverter-loading "BasisImageConverter docs" for notes
+about pthread linking.
+
+The rows are read bottom to top with a negative stride, so the Y flip doesn't
+involve any copy. Disabling the @cb{.ini} yFlip @ce option makes the rows
+read in order instead, which is useful for exporting images that are already
+top-down.
+
+@section Trade-MiniExrImageConverter-configuration Plugin-specific configuration
+
+It's possible to tune various output options through @ref configuration().
+See below for all options and their default values:
+
+@snippet MagnumPlugins/MiniExrImageConverter/MiniExrImageConverter.conf config
 */
 class MAGNUM_MINIEXRIMAGECONVERTER_EXPORT MiniExrImageConverter: public AbstractImageConverter {
     public:
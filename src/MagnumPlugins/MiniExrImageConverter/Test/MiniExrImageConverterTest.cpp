@@ -25,12 +25,18 @@
 
 #include <sstream>
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/GrowableArray.h>
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Compare/StringToFile.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Corrade/Utility/Directory.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/ConfigurationValue.h>
+#include <Magnum/Math/Vector2.h>
 #include <Magnum/Trade/AbstractImageConverter.h>
 
 #include "configure.h"
@@ -45,6 +51,13 @@ struct MiniExrImageConverterTest: TestSuite::Tester {
     void rgb();
     void rgba();
 
+    void unsupportedCompression();
+    void invalidTileSize();
+    void tiled();
+    void rle();
+    void compressed();
+    void noYFlip();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImageConverter> _manager{"nonexistent"};
 };
@@ -69,11 +82,52 @@ constexpr const char RgbaData[] = {
 
 const ImageView2D Rgba{PixelFormat::RGBA16F, {1, 3}, RgbaData};
 
+constexpr struct {
+    const char* name;
+    const char* compression;
+    char compressionValue;
+    Vector2i tileSize;
+} CompressedData[]{
+    {"RLE", "rle", 1, {}},
+    {"ZIPS", "zips", 2, {}},
+    {"ZIP", "zip", 3, {}},
+    {"RLE, tiled", "rle", 1, {16, 16}},
+    {"ZIP, tiled", "zip", 3, {32, 8}}
+};
+
+constexpr struct {
+    const char* name;
+    const char* compression;
+    Vector2i tileSize;
+} NoYFlipData[]{
+    {"uncompressed", "none", {}},
+    {"ZIP", "zip", {}},
+    {"RLE, tiled", "rle", {16, 16}}
+};
+
+UnsignedInt readInt(const Containers::ArrayView<const char> data, const std::size_t offset) {
+    return UnsignedInt(UnsignedByte(data[offset]))|
+        (UnsignedInt(UnsignedByte(data[offset + 1])) << 8)|
+        (UnsignedInt(UnsignedByte(data[offset + 2])) << 16)|
+        (UnsignedInt(UnsignedByte(data[offset + 3])) << 24);
+}
+
 MiniExrImageConverterTest::MiniExrImageConverterTest() {
     addTests({&MiniExrImageConverterTest::wrongFormat,
 
               &MiniExrImageConverterTest::rgb,
-              &MiniExrImageConverterTest::rgba});
+              &MiniExrImageConverterTest::rgba,
+
+              &MiniExrImageConverterTest::unsupportedCompression,
+              &MiniExrImageConverterTest::invalidTileSize,
+              &MiniExrImageConverterTest::tiled,
+              &MiniExrImageConverterTest::rle});
+
+    addInstancedTests({&MiniExrImageConverterTest::compressed},
+        Containers::arraySize(CompressedData));
+
+    addInstancedTests({&MiniExrImageConverterTest::noYFlip},
+        Containers::arraySize(NoYFlipData));
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
@@ -110,6 +164,183 @@ void MiniExrImageConverterTest::rgba() {
         TestSuite::Compare::StringToFile);
 }
 
+void MiniExrImageConverterTest::unsupportedCompression() {
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("MiniExrImageConverter");
+    converter->configuration().setValue("compression", "piz");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->exportToData(Rgb));
+    CORRADE_COMPARE(out.str(), "Trade::MiniExrImageConverter::exportToData(): unsupported compression piz\n");
+}
+
+void MiniExrImageConverterTest::invalidTileSize() {
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("MiniExrImageConverter");
+    converter->configuration().setValue("tileSize", Vector2i{16, 0});
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->exportToData(Rgb));
+    CORRADE_COMPARE(out.str(), "Trade::MiniExrImageConverter::exportToData(): expected tile size to be either zero or positive but got Vector(16, 0)\n");
+}
+
+void MiniExrImageConverterTest::tiled() {
+    /* 3x3 image with a distinct value in each byte, rows padded to four
+       bytes */
+    char data[3*20]{};
+    for(std::size_t y = 0; y != 3; ++y)
+        for(std::size_t i = 0; i != 18; ++i)
+            data[y*20 + i] = char(y*18 + i + 1);
+
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("MiniExrImageConverter");
+    converter->configuration().setValue("tileSize", Vector2i{2, 2});
+    const Containers::Array<char> out = converter->exportToData(ImageView2D{PixelFormat::RGB16F, {3, 3}, data});
+    CORRADE_VERIFY(out);
+
+    /* Version 2 with the tiled flag */
+    CORRADE_COMPARE(readInt(out, 4), 0x202);
+    const std::string string{out, out.size()};
+    CORRADE_VERIFY(string.find(std::string{"tiles\0tiledesc\0\x09\0\0\0\x02\0\0\0\x02\0\0\0\0", 28}) != std::string::npos);
+
+    /* Four tiles, 2x2, 1x2, 2x1 and 1x1 pixels, each with a 20-byte chunk
+       header */
+    const std::size_t headerSize = out.size() - 4*8 - (4*20 + 24 + 12 + 12 + 6);
+    const std::size_t tileSizes[]{24, 12, 12, 6};
+    const Vector2i tileCoordinates[]{{0, 0}, {1, 0}, {0, 1}, {1, 1}};
+    std::size_t offset = headerSize + 4*8;
+    for(std::size_t i = 0; i != 4; ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(readInt(out, headerSize + i*8), offset);
+        CORRADE_COMPARE(readInt(out, headerSize + i*8 + 4), 0);
+        CORRADE_COMPARE(Int(readInt(out, offset)), tileCoordinates[i].x());
+        CORRADE_COMPARE(Int(readInt(out, offset + 4)), tileCoordinates[i].y());
+        CORRADE_COMPARE(readInt(out, offset + 8), 0);
+        CORRADE_COMPARE(readInt(out, offset + 12), 0);
+        CORRADE_COMPARE(readInt(out, offset + 16), tileSizes[i]);
+        offset += 20 + tileSizes[i];
+    }
+
+    /* The first tile is the top two rows in reverse order, each line having
+       first B for both pixels, then G and R */
+    CORRADE_COMPARE_AS(out.slice(headerSize + 4*8 + 20, headerSize + 4*8 + 44),
+        Containers::arrayView<char>({
+            41, 42, 47, 48, 39, 40, 45, 46, 37, 38, 43, 44,
+            23, 24, 29, 30, 21, 22, 27, 28, 19, 20, 25, 26}),
+        TestSuite::Compare::Container);
+}
+
+void MiniExrImageConverterTest::rle() {
+    /* A single scanline with a run of the same values and a few distinct
+       ones */
+    Containers::Array<char> data{Containers::ValueInit, 32*8};
+    for(std::size_t i = 0; i != 4; ++i) data[i*8*2] = char(i*37 + 5);
+    ImageView2D image{PixelFormat::RGBA16F, {32, 1}, data};
+
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("MiniExrImageConverter");
+    converter->configuration().setValue("compression", "rle");
+    const Containers::Array<char> out = converter->exportToData(image);
+    CORRADE_VERIFY(out);
+
+    /* The one-entry offset table is right before the only chunk, which spans
+       until the end of the file */
+    std::size_t offset = 0;
+    for(std::size_t i = 0; i + 16 <= out.size(); ++i) {
+        if(readInt(out, i) == i + 8 && readInt(out, i + 4) == 0 && i + 8 + 8 + readInt(out, i + 12) == out.size()) {
+            offset = i + 8;
+            break;
+        }
+    }
+    CORRADE_VERIFY(offset);
+    CORRADE_COMPARE(readInt(out, offset), 0);
+    const UnsignedInt size = readInt(out, offset + 4);
+    CORRADE_COMPARE_AS(size, 32*6, TestSuite::Compare::Less);
+
+    /* Decode the RLE */
+    Containers::Array<char> decoded;
+    for(std::size_t i = offset + 8; i < out.size(); ) {
+        const Int count = static_cast<signed char>(out[i++]);
+        if(count < 0) {
+            arrayAppend(decoded, out.slice(i, i - count));
+            i -= count;
+        } else {
+            for(Int j = 0; j != count + 1; ++j)
+                arrayAppend(decoded, out[i]);
+            ++i;
+        }
+    }
+    CORRADE_COMPARE(decoded.size(), 32*6);
+
+    /* Undo the predictor and reordering */
+    for(std::size_t i = 1; i < decoded.size(); ++i)
+        decoded[i] = char(UnsignedByte(decoded[i - 1]) + UnsignedByte(decoded[i]) - 128);
+    Containers::Array<char> raw{Containers::NoInit, decoded.size()};
+    for(std::size_t i = 0; i != decoded.size(); ++i)
+        raw[i] = decoded[(i % 2 ? decoded.size()/2 : 0) + i/2];
+
+    /* Compare to the expected B, G, R planes */
+    Containers::Array<char> expected{Containers::ValueInit, 32*6};
+    for(std::size_t i = 0; i != 4; ++i) expected[2*32*2 + i*4] = char(i*37 + 5);
+    CORRADE_COMPARE_AS(Containers::arrayView(raw), Containers::arrayView(expected),
+        TestSuite::Compare::Container);
+}
+
+void MiniExrImageConverterTest::compressed() {
+    auto&& data = CompressedData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* A smooth gradient that compresses well */
+    Containers::Array<UnsignedShort> pixels{Containers::NoInit, 64*48*3};
+    for(std::size_t y = 0; y != 48; ++y)
+        for(std::size_t x = 0; x != 64; ++x)
+            for(std::size_t c = 0; c != 3; ++c)
+                pixels[(y*64 + x)*3 + c] = UnsignedShort(0x3c00 + x*4 + y*2 + c);
+    ImageView2D image{PixelStorage{}.setAlignment(2), PixelFormat::RGB16F, {64, 48}, pixels};
+
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("MiniExrImageConverter");
+    const Containers::Array<char> uncompressed = converter->exportToData(image);
+    CORRADE_VERIFY(uncompressed);
+
+    converter->configuration().setValue("compression", data.compression);
+    converter->configuration().setValue("tileSize", data.tileSize);
+    const Containers::Array<char> out = converter->exportToData(image);
+    CORRADE_VERIFY(out);
+    CORRADE_COMPARE_AS(out.size(), uncompressed.size(), TestSuite::Compare::Less);
+
+    const std::string string{out, out.size()};
+    CORRADE_VERIFY(string.find(std::string{"compression\0compression\0\x01\0\0\0", 28} + data.compressionValue) != std::string::npos);
+
+    /* Compressing on multiple threads gives the same output */
+    converter->configuration().setValue("threads", 4);
+    const Containers::Array<char> outThreaded = converter->exportToData(image);
+    CORRADE_COMPARE_AS(Containers::arrayView(outThreaded), Containers::arrayView(out),
+        TestSuite::Compare::Container);
+}
+
+void MiniExrImageConverterTest::noYFlip() {
+    auto&& data = NoYFlipData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Rows with distinct values, and a copy with the opposite row order */
+    Containers::Array<UnsignedShort> pixels{Containers::NoInit, 32*24*3};
+    Containers::Array<UnsignedShort> flipped{Containers::NoInit, 32*24*3};
+    for(std::size_t y = 0; y != 24; ++y)
+        for(std::size_t i = 0; i != 32*3; ++i)
+            pixels[y*32*3 + i] = flipped[(23 - y)*32*3 + i] = UnsignedShort(0x3c00 + y*32*3 + i);
+
+    Containers::Pointer<AbstractImageConverter> converter = _manager.instantiate("MiniExrImageConverter");
+    converter->configuration().setValue("compression", data.compression);
+    converter->configuration().setValue("tileSize", data.tileSize);
+    const Containers::Array<char> out = converter->exportToData(ImageView2D{PixelStorage{}.setAlignment(2), PixelFormat::RGB16F, {32, 24}, flipped});
+    CORRADE_VERIFY(out);
+
+    /* Exporting the original without a flip gives the same file */
+    converter->configuration().setValue("yFlip", false);
+    const Containers::Array<char> outNoYFlip = converter->exportToData(ImageView2D{PixelStorage{}.setAlignment(2), PixelFormat::RGB16F, {32, 24}, pixels});
+    CORRADE_VERIFY(outNoYFlip);
+    CORRADE_COMPARE_AS(Containers::arrayView(outNoYFlip), Containers::arrayView(out),
+        TestSuite::Compare::Container);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::MiniExrImageConverterTest)
@@ -27,13 +27,23 @@
 #include "OpenGexImporter.h"
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <limits>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
+#include <cstring>
 #include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Corrade/Utility/Directory.h>
 #include <Magnum/Mesh.h>
+#include <Magnum/VertexFormat.h>
+#include <Magnum/Math/Half.h>
+#include <Magnum/Math/Packing.h>
 #include <Magnum/Math/Quaternion.h>
 #include <Magnum/Trade/CameraData.h>
 #include <Magnum/Trade/ImageData.h>
@@ -49,12 +59,21 @@
 #include "Magnum/OpenDdl/Structure.h"
 #include "MagnumPlugins/AnyImageImporter/AnyImageImporter.h"
 
+#ifdef MAGNUM_OPENGEXIMPORTER_WITH_PROFILING
+#define MAGNUM_IMPORTERPROFILING_ENABLED
+#endif
+#include "MagnumPlugins/Implementation/importerProfiling.h"
+
 #include "openGexSpec.hpp"
 
 namespace Magnum { namespace Trade {
 
 using namespace Magnum::Math::Literals;
 
+#if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+#define _OPENGEXIMPORTER_USE_MAP
+#endif
+
 struct OpenGexImporter::Document {
     /* Clang-CL otherwise complains that Document has no implicit constructor */
     OpenDdl::Document document{};
@@ -82,6 +101,80 @@ struct OpenGexImporter::Document {
 
     UnsignedInt imageImporterId = ~UnsignedInt{};
     Containers::Optional<AnyImageImporter> imageImporter;
+
+    /* Images opened upfront if the prefetchImages option is enabled. The
+       importer and level count are set on the main thread before any worker
+       is started, the rest is guarded by prefetchMutex. */
+    struct PrefetchedImage {
+        Containers::Optional<AnyImageImporter> importer;
+        UnsignedInt levelCount{};
+        bool claimed{}, done{};
+        Containers::Array<Containers::Optional<ImageData2D>> levels;
+    };
+    Containers::Array<PrefetchedImage> prefetchedImages;
+    std::mutex prefetchMutex;
+    std::condition_variable prefetchCondition;
+    std::size_t prefetchNext{};
+    bool prefetchCancelled{};
+    Containers::Array<std::thread> prefetchThreads;
+
+    ~Document() {
+        /* Images that are being decoded right now get finished, the rest is
+           skipped */
+        {
+            std::lock_guard<std::mutex> lock{prefetchMutex};
+            prefetchCancelled = true;
+        }
+        for(std::thread& thread: prefetchThreads) thread.join();
+    }
+
+    static Containers::Array<Containers::Optional<ImageData2D>> decode(PrefetchedImage& image) {
+        Containers::Array<Containers::Optional<ImageData2D>> levels{image.levelCount};
+        for(UnsignedInt level = 0; level != image.levelCount; ++level)
+            levels[level] = image.importer->image2D(0, level);
+        return levels;
+    }
+
+    /* Each worker takes the next image that isn't claimed yet, either by
+       another worker or by image2D() */
+    void prefetch() {
+        std::unique_lock<std::mutex> lock{prefetchMutex};
+        for(;;) {
+            while(prefetchNext != prefetchedImages.size() && (prefetchedImages[prefetchNext].claimed || !prefetchedImages[prefetchNext].importer))
+                ++prefetchNext;
+            if(prefetchCancelled || prefetchNext == prefetchedImages.size())
+                return;
+
+            PrefetchedImage& image = prefetchedImages[prefetchNext];
+            image.claimed = true;
+            lock.unlock();
+            Containers::Array<Containers::Optional<ImageData2D>> levels = decode(image);
+            lock.lock();
+            image.levels = std::move(levels);
+            image.done = true;
+            prefetchCondition.notify_all();
+        }
+    }
+
+    /* Waits for the image to be decoded or decodes it on the calling thread
+       if no worker got to it yet. Returns NullOpt if given level failed to
+       decode or was already taken by a previous call. */
+    Containers::Optional<ImageData2D> takePrefetched(const UnsignedInt id, const UnsignedInt level) {
+        PrefetchedImage& image = prefetchedImages[id];
+        std::unique_lock<std::mutex> lock{prefetchMutex};
+        if(!image.claimed) {
+            image.claimed = true;
+            lock.unlock();
+            Containers::Array<Containers::Optional<ImageData2D>> levels = decode(image);
+            lock.lock();
+            image.levels = std::move(levels);
+            image.done = true;
+        } else prefetchCondition.wait(lock, [&image]() { return image.done; });
+
+        Containers::Optional<ImageData2D> out = std::move(image.levels[level]);
+        image.levels[level] = Containers::NullOpt;
+        return out;
+    }
 };
 
 namespace {
@@ -99,14 +192,38 @@ UnsignedInt structureId(const std::vector<OpenDdl::Structure>& structures, OpenD
 
 }
 
-OpenGexImporter::OpenGexImporter() = default;
+namespace {
+
+void fillDefaultConfiguration(Utility::ConfigurationGroup& conf) {
+    /** @todo horrible workaround, fix this properly */
+    conf.setValue("threads", 1);
+    conf.setValue("lazy", false);
+    conf.setValue("cache", false);
+    conf.setValue("zeroCopy", false);
+    conf.setValue("prefetchImages", false);
+}
+
+}
+
+OpenGexImporter::OpenGexImporter() {
+    /** @todo horrible workaround, fix this properly */
+    fillDefaultConfiguration(configuration());
+}
 
-OpenGexImporter::OpenGexImporter(PluginManager::Manager<AbstractImporter>& manager): AbstractImporter(manager) {}
+OpenGexImporter::OpenGexImporter(PluginManager::Manager<AbstractImporter>& manager): AbstractImporter(manager) {
+    /** @todo horrible workaround, fix this properly */
+    fillDefaultConfiguration(configuration());
+}
 
 OpenGexImporter::OpenGexImporter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImporter(manager, plugin) {}
 
 OpenGexImporter::~OpenGexImporter() = default;
 
+void OpenGexImporter::setProfilingCallback(void(*callback)(const char*, UnsignedLong, std::size_t, void*), void* userData) {
+    _profilingCallback = callback;
+    _profilingUserData = userData;
+}
+
 ImporterFeatures OpenGexImporter::doFeatures() const { return ImporterFeature::OpenData|ImporterFeature::FileCallback; }
 
 bool OpenGexImporter::doIsOpened() const { return !!_d; }
@@ -129,10 +246,25 @@ void OpenGexImporter::doOpenData(const Containers::ArrayView<const char> data) {
     Containers::Pointer<Document> d{Containers::InPlaceInit};
 
     /* Parse the document */
-    if(!d->document.parse(data, OpenGex::structures, OpenGex::properties)) return;
+    d->document.setThreadCount(configuration().value<UnsignedInt>("threads"))
+        .setLazy(configuration().value<bool>("lazy"));
+    {
+        MAGNUM_IMPORTER_PROFILE(profile, _profilingCallback, _profilingUserData, "parse", data.size());
+        if(!d->document.parse(data, OpenGex::structures, OpenGex::properties)) return;
+    }
+
+    openDocument(std::move(d));
 
+    /* When opening a file, this is done only after the file path is known */
+    if(_d && !_openingFile) prefetchImages();
+}
+
+void OpenGexImporter::openDocument(Containers::Pointer<Document>&& d) {
     /* Validate the document */
-    if(!d->document.validate(OpenGex::rootStructures, OpenGex::structureInfo)) return;
+    {
+        MAGNUM_IMPORTER_PROFILE(profile, _profilingCallback, _profilingUserData, "validate", 0);
+        if(!d->document.validate(OpenGex::rootStructures, OpenGex::structureInfo)) return;
+    }
 
     /* Metrics */
     for(const OpenDdl::Structure metric: d->document.childrenOf(OpenGex::Metric)) {
@@ -225,12 +357,144 @@ void OpenGexImporter::doOpenData(const Containers::ArrayView<const char> data) {
     _d = std::move(d);
 }
 
+namespace {
+
+/* Prepended to the serialized document in the cache file to detect that the
+   original file changed */
+struct CacheHeader {
+    UnsignedLong size;
+    UnsignedLong hash;
+};
+
+/* FNV-1a, same as used by OpenDdl::Document::serialize() for identifiers */
+UnsignedLong sourceHash(const Containers::ArrayView<const char> data) {
+    UnsignedLong hash = 14695981039346656037ull;
+    for(const char c: data) {
+        hash ^= UnsignedByte(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+}
+
+void OpenGexImporter::openFileCached(const std::string& filename) {
+    #ifdef _OPENGEXIMPORTER_USE_MAP
+    const Containers::Array<const char, Utility::Directory::MapDeleter> source = Utility::Directory::exists(filename) ? Utility::Directory::mapRead(filename) : nullptr;
+    #else
+    const Containers::Array<char> source = Utility::Directory::exists(filename) ? Utility::Directory::read(filename) : nullptr;
+    #endif
+
+    /* Nonexistent and empty files go through the usual path, which takes
+       care of the error reporting */
+    if(!source) {
+        AbstractImporter::doOpenFile(filename);
+        return;
+    }
+
+    const CacheHeader header{UnsignedLong(source.size()), sourceHash(source)};
+
+    /* If there's an up-to-date cache, load it */
+    const std::string cacheFilename = filename + ".cache";
+    if(Utility::Directory::exists(cacheFilename)) {
+        #ifdef _OPENGEXIMPORTER_USE_MAP
+        const Containers::Array<const char, Utility::Directory::MapDeleter> cache = Utility::Directory::mapRead(cacheFilename);
+        #else
+        const Containers::Array<char> cache = Utility::Directory::read(cacheFilename);
+        #endif
+        CacheHeader cacheHeader;
+        if(cache.size() >= sizeof(CacheHeader)) {
+            std::memcpy(&cacheHeader, cache.data(), sizeof(CacheHeader));
+            if(cacheHeader.size == header.size && cacheHeader.hash == header.hash) {
+                Containers::Pointer<Document> d{Containers::InPlaceInit};
+
+                /* A corrupted cache is not an error, the file gets parsed
+                   and the cache regenerated instead */
+                bool deserialized;
+                {
+                    MAGNUM_IMPORTER_PROFILE(profile, _profilingCallback, _profilingUserData, "deserialize", cache.size());
+                    Error redirectError{nullptr};
+                    deserialized = d->document.deserialize(cache.suffix(sizeof(CacheHeader)), OpenGex::structures, OpenGex::properties);
+                }
+                if(deserialized) {
+                    openDocument(std::move(d));
+                    if(_d) return;
+                }
+            }
+        }
+    }
+
+    /* Otherwise parse the file and save the cache for the next time. The
+       whole document needs to be parsed for serialization, so lazy parsing
+       is disabled here. */
+    const bool lazy = configuration().value<bool>("lazy");
+    configuration().setValue("lazy", false);
+    doOpenData(source);
+    configuration().setValue("lazy", lazy);
+    if(!_d) return;
+
+    MAGNUM_IMPORTER_PROFILE(profile, _profilingCallback, _profilingUserData, "serialize", 0);
+    const Containers::Array<char> serialized = _d->document.serialize();
+    Containers::Array<char> out{Containers::NoInit, sizeof(CacheHeader) + serialized.size()};
+    std::memcpy(out.data(), &header, sizeof(CacheHeader));
+    Utility::copy(serialized, out.suffix(sizeof(CacheHeader)));
+    if(!serialized || !Utility::Directory::write(cacheFilename, out))
+        Warning() << "Trade::OpenGexImporter::openFile(): cannot write cache file" << cacheFilename;
+    MAGNUM_IMPORTER_PROFILE_BYTES(profile, out.size());
+}
+
 void OpenGexImporter::doOpenFile(const std::string& filename) {
-    /* Make doOpenData() do the thing */
-    AbstractImporter::doOpenFile(filename);
+    _openingFile = true;
+
+    /* Load from / save to the cache, if enabled. With a file callback it's
+       not possible to write anything, so the usual path is taken. */
+    if(configuration().value<bool>("cache") && !fileCallback())
+        openFileCached(filename);
+
+    /* Otherwise make doOpenData() do the thing */
+    else AbstractImporter::doOpenFile(filename);
+
+    _openingFile = false;
 
     /* If succeeded, save file path for later */
-    if(_d) _d->filePath = Utility::Directory::path(filename);
+    if(_d) {
+        _d->filePath = Utility::Directory::path(filename);
+        prefetchImages();
+    }
+}
+
+void OpenGexImporter::prefetchImages() {
+    /* Without a path or a callback the images can't be opened at all and
+       image2D() reports that */
+    if(!configuration().value<bool>("prefetchImages") || _d->images.empty() || !manager() || (!_d->filePath && !fileCallback()))
+        return;
+
+    /* Plugin loading and file callbacks aren't meant to be called from
+       multiple threads, so all images are opened here and only the decoding
+       is done on the workers. Images that fail to open are left for
+       image2D(), which then reports the error on the calling thread. */
+    _d->prefetchedImages = Containers::Array<Document::PrefetchedImage>{_d->images.size()};
+    for(std::size_t i = 0; i != _d->images.size(); ++i) {
+        AnyImageImporter importer{*manager()};
+        if(fileCallback()) importer.setFileCallback(fileCallback(), fileCallbackUserData());
+
+        bool opened;
+        {
+            Error redirectError{nullptr};
+            opened = importer.openFile(Utility::Directory::join(_d->filePath ? *_d->filePath : "", _d->images[i]));
+        }
+        if(!opened) continue;
+
+        _d->prefetchedImages[i].levelCount = importer.image2DLevelCount(0);
+        _d->prefetchedImages[i].importer.emplace(std::move(importer));
+    }
+
+    UnsignedInt threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount) threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    Document* const d = _d.get();
+    _d->prefetchThreads = Containers::Array<std::thread>{std::min(std::size_t{threadCount}, _d->images.size())};
+    for(std::thread& thread: _d->prefetchThreads)
+        thread = std::thread{[d]() { d->prefetch(); }};
 }
 
 void OpenGexImporter::doClose() { _d = nullptr; }
@@ -316,6 +580,54 @@ namespace {
         m[3].xyz() *= distanceMultiplier;
         return m;
     }
+
+    /* Negating the smallest representable value would overflow, saturate it
+       instead */
+    template<class T> inline Math::Vector3<T> fixNormalizedVectorZUp(Math::Vector3<T> vec) {
+        return {vec.x(), vec.z(), vec.y() == std::numeric_limits<T>::min() ? std::numeric_limits<T>::max() : T(-vec.y())};
+    }
+
+    /* Integer vertex arrays are treated as normalized. Returns VertexFormat{}
+       for types that can't be represented. */
+    VertexFormat vertexArrayFormat(const OpenDdl::Type type, const std::size_t componentCount) {
+        const bool two = componentCount == 2;
+        switch(type) {
+            case OpenDdl::Type::Float:
+                return two ? VertexFormat::Vector2 : VertexFormat::Vector3;
+            case OpenDdl::Type::Half:
+                return two ? VertexFormat::Vector2h : VertexFormat::Vector3h;
+            case OpenDdl::Type::UnsignedByte:
+                return two ? VertexFormat::Vector2ubNormalized : VertexFormat::Vector3ubNormalized;
+            case OpenDdl::Type::Byte:
+                return two ? VertexFormat::Vector2bNormalized : VertexFormat::Vector3bNormalized;
+            case OpenDdl::Type::UnsignedShort:
+                return two ? VertexFormat::Vector2usNormalized : VertexFormat::Vector3usNormalized;
+            case OpenDdl::Type::Short:
+                return two ? VertexFormat::Vector2sNormalized : VertexFormat::Vector3sNormalized;
+            default: return {};
+        }
+    }
+
+    Containers::ArrayView<const char> vertexArrayBytes(const OpenDdl::Structure data) {
+        switch(data.type()) {
+            #define _c(type) case OpenDdl::Type::type:                      \
+                return Containers::arrayCast<const char>(data.asArray<type>());
+            _c(Float)
+            _c(Half)
+            _c(UnsignedByte)
+            _c(Byte)
+            _c(UnsignedShort)
+            _c(Short)
+            #undef _c
+            default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+        }
+    }
+
+    template<class T> void dequantizeVectors(const Containers::StridedArrayView2D<const char>& src, const Containers::StridedArrayView1D<Vector3>& dst) {
+        const auto vectors = Containers::arrayCast<1, const Math::Vector3<T>>(src);
+        for(std::size_t i = 0; i != vectors.size(); ++i)
+            dst[i] = Math::unpack<Vector3>(vectors[i]);
+    }
 }
 
 Containers::Pointer<ObjectData3D> OpenGexImporter::doObject3D(const UnsignedInt id) {
@@ -554,8 +866,22 @@ UnsignedInt OpenGexImporter::doMeshCount() const {
 }
 
 Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, UnsignedInt) {
+    MAGNUM_IMPORTER_PROFILE(profile, _profilingCallback, _profilingUserData, "mesh", 0);
+    Containers::Optional<MeshData> out = meshInternal(id);
+    if(out) MAGNUM_IMPORTER_PROFILE_BYTES(profile, out->vertexData().size() + out->indexData().size());
+    return out;
+}
+
+Containers::Optional<MeshData> OpenGexImporter::meshInternal(const UnsignedInt id) {
     const OpenDdl::Structure& mesh = _d->meshes[id].firstChildOf(OpenGex::Mesh);
 
+    /* If the document is lazy, convert all vertex and index data now so
+       errors can be propagated */
+    {
+        MAGNUM_IMPORTER_PROFILE(profile, _profilingCallback, _profilingUserData, "deferred", 0);
+        if(!_d->document.parseDeferred(mesh)) return Containers::NullOpt;
+    }
+
     /* Primitive type, triangles by default */
     std::size_t indexArraySubArraySize = 3;
     MeshPrimitive primitive = MeshPrimitive::Triangles;
@@ -580,10 +906,17 @@ Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, Uns
         }
     }
 
-    /* Gather all attributes. Position is optional as well. */
+    /* Gather all attributes. Position is optional as well. Half-float and
+       integer arrays are kept in their compact format, integers are treated
+       as normalized. */
+    const bool zeroCopy = configuration().value<bool>("zeroCopy");
+    bool needsConversion = false;
+    bool sameType = true;
     std::size_t attributeCount = 0;
     std::ptrdiff_t stride = 0;
     UnsignedInt vertexCount = 0;
+    OpenDdl::Type firstType{};
+    std::vector<VertexFormat> formats;
     for(const OpenDdl::Structure vertexArray: mesh.childrenOf(OpenGex::VertexArray)) {
         /* Skip unsupported ones */
         auto&& attrib = vertexArray.propertyOf(OpenGex::attrib).as<std::string>();
@@ -592,13 +925,20 @@ Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, Uns
 
         /* Doubles were supported before (and converted to floats), I could do
            a cast now as well but I don't bother as nobody uses this format
-           anymore anyway */
+           anymore anyway. 32-bit integers have no normalized vertex format. */
         const OpenDdl::Structure vertexArrayData = vertexArray.firstChild();
-        if(vertexArrayData.type() != OpenDdl::Type::Float) {
-            Error() << "Trade::OpenGexImporter::mesh(): unsupported vertex array type" << vertexArrayData.type();
+        const OpenDdl::Type type = vertexArrayData.type();
+        if(type != OpenDdl::Type::Float &&
+           type != OpenDdl::Type::Half &&
+           type != OpenDdl::Type::UnsignedByte &&
+           type != OpenDdl::Type::Byte &&
+           type != OpenDdl::Type::UnsignedShort &&
+           type != OpenDdl::Type::Short) {
+            Error() << "Trade::OpenGexImporter::mesh(): unsupported vertex array type" << type;
             return Containers::NullOpt;
         }
 
+        VertexFormat format = vertexArrayFormat(type, vertexArrayData.subArraySize());
         if(attrib == "position") {
             /* 2D positions could be supported too but I don't bother due to
                the same reason as above */
@@ -607,7 +947,13 @@ Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, Uns
                 return Containers::NullOpt;
             }
 
-            stride += sizeof(Vector3);
+            /* Normalized integer positions can't be scaled, dequantize them
+               to floats if a conversion is needed */
+            if(_d->distanceMultiplier != 1.0f || !_d->yUp) {
+                needsConversion = true;
+                if(isVertexFormatNormalized(format))
+                    format = VertexFormat::Vector3;
+            }
 
         } else if(attrib == "normal") {
             if(vertexArrayData.subArraySize() != 3) {
@@ -615,7 +961,13 @@ Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, Uns
                 return Containers::NullOpt;
             }
 
-            stride += sizeof(Vector3);
+            /* Unsigned formats can't represent negative directions */
+            if(type == OpenDdl::Type::UnsignedByte || type == OpenDdl::Type::UnsignedShort) {
+                Error{} << "Trade::OpenGexImporter::mesh(): unsupported normal type" << type;
+                return Containers::NullOpt;
+            }
+
+            if(!_d->yUp) needsConversion = true;
 
         } else if(attrib == "texcoord") {
             if(vertexArrayData.subArraySize() != 2) {
@@ -623,80 +975,157 @@ Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, Uns
                 return Containers::NullOpt;
             }
 
-            stride += sizeof(Vector2);
-
         } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
 
-        /* If this is the first attribute, save the vertex count; otherwise
-           check that all attributes have the same amount of vertices */
+        /* Pad the interleaved attributes to four bytes */
+        stride += (vertexFormatSize(format) + 3)/4*4;
+        formats.push_back(format);
+
+        /* If this is the first attribute, save the vertex count and type;
+           otherwise check that all attributes have the same amount of
+           vertices */
         const UnsignedInt attributeVertexCount = vertexArrayData.arraySize()/(vertexArrayData.subArraySize() ? vertexArrayData.subArraySize() : 1);
-        if(!attributeCount) vertexCount = attributeVertexCount;
-        else if(vertexCount != attributeVertexCount) {
+        if(!attributeCount) {
+            vertexCount = attributeVertexCount;
+            firstType = type;
+        } else if(vertexCount != attributeVertexCount) {
             Error{} << "Trade::OpenGexImporter::mesh(): mismatched vertex count for attribute" << attrib << Debug::nospace << ", expected" << vertexCount << "but got" << attributeVertexCount;
             return Containers::NullOpt;
-        }
+        } else if(type != firstType) sameType = false;
 
         ++attributeCount;
     }
 
-    /* Allocate vertex data, fill attributes */
-    Containers::Array<char> vertexData{Containers::NoInit, std::size_t(stride)*vertexCount};
+    /* If zero-copy import is requested and the data don't need any
+       conversion, reference the document storage directly. The attributes
+       are then not interleaved. Each type is stored in a different array in
+       the document, so this is possible only if all attributes have the
+       same type. */
+    Containers::Array<char> vertexData;
+    Containers::ArrayView<const char> vertexDataView;
     Containers::Array<MeshAttributeData> attributeData{attributeCount};
-    std::size_t attributeIndex = 0;
-    std::size_t attributeOffset = 0;
-
-    for(const OpenDdl::Structure vertexArray: mesh.childrenOf(OpenGex::VertexArray)) {
-        /* Skip unsupported ones */
-        const OpenDdl::Structure vertexArrayData = vertexArray.firstChild();
-
-        /* Vertex positions */
-        auto&& attrib = vertexArray.propertyOf(OpenGex::attrib).as<std::string>();
-        if(attrib == "position") {
-            Containers::StridedArrayView1D<Vector3> positions{vertexData,
-                reinterpret_cast<Vector3*>(vertexData + attributeOffset),
-                vertexCount, stride};
-            Utility::copy(Containers::arrayCast<const Vector3>(vertexArrayData.asArray<Float>()), positions);
-            for(auto& i: positions) i *= _d->distanceMultiplier;
-            if(!_d->yUp) for(auto& i: positions) i = fixVectorZUp(i);
-
-            attributeData[attributeIndex++] = MeshAttributeData{
-                MeshAttribute::Position, positions};
-            attributeOffset += sizeof(Vector3);
-
-        /* Normals */
-        } else if(attrib == "normal") {
-            Containers::StridedArrayView1D<Vector3> normals{vertexData,
-                reinterpret_cast<Vector3*>(vertexData + attributeOffset),
-                vertexCount, stride};
-            Utility::copy(Containers::arrayCast<const Vector3>(vertexArrayData.asArray<Float>()), normals);
-            if(!_d->yUp) for(auto& i: normals) i = fixVectorZUp(i);
-
-            attributeData[attributeIndex++] = MeshAttributeData{
-                MeshAttribute::Normal, normals};
-            attributeOffset += sizeof(Vector3);
-
-        /* 2D texture coordinates */
-        } else if(attrib == "texcoord") {
-            Containers::StridedArrayView1D<Vector2> textureCoordinates{vertexData,
-                reinterpret_cast<Vector2*>(vertexData + attributeOffset),
-                vertexCount, stride};
-            Utility::copy(Containers::arrayCast<const Vector2>(vertexArrayData.asArray<Float>()), textureCoordinates);
+    if(zeroCopy && attributeCount && !needsConversion && sameType) {
+        std::size_t attributeIndex = 0;
+        const char* begin = nullptr;
+        const char* end = nullptr;
+        for(const OpenDdl::Structure vertexArray: mesh.childrenOf(OpenGex::VertexArray)) {
+            auto&& attrib = vertexArray.propertyOf(OpenGex::attrib).as<std::string>();
+            MeshAttribute name;
+            if(attrib == "position") name = MeshAttribute::Position;
+            else if(attrib == "normal") name = MeshAttribute::Normal;
+            else if(attrib == "texcoord") name = MeshAttribute::TextureCoordinates;
+
+            /* Some other thing that wasn't handled above, ignore */
+            else continue;
+
+            const Containers::ArrayView<const char> data = vertexArrayBytes(vertexArray.firstChild());
+            const VertexFormat format = formats[attributeIndex];
+            attributeData[attributeIndex++] = MeshAttributeData{name, format,
+                Containers::StridedArrayView1D<const void>{data, data.data(),
+                    vertexCount, std::ptrdiff_t(vertexFormatSize(format))}};
+
+            /* All data are in the same contiguous array in the document, so
+               the vertex data are the range spanning all attributes */
+            if(!begin || data.begin() < begin) begin = data.begin();
+            if(!end || data.end() > end) end = data.end();
+        }
 
-            attributeData[attributeIndex++] = MeshAttributeData{
-                MeshAttribute::TextureCoordinates, textureCoordinates};
-            attributeOffset += sizeof(Vector2);
+        CORRADE_INTERNAL_ASSERT(attributeIndex == attributeCount);
+        vertexDataView = {begin, std::size_t(end - begin)};
+
+    /* Otherwise allocate vertex data, fill attributes. Zero-initialized so
+       the attribute padding isn't random memory. */
+    } else {
+        vertexData = Containers::Array<char>{Containers::ValueInit, std::size_t(stride)*vertexCount};
+        std::size_t attributeIndex = 0;
+        std::size_t attributeOffset = 0;
+
+        for(const OpenDdl::Structure vertexArray: mesh.childrenOf(OpenGex::VertexArray)) {
+            auto&& attrib = vertexArray.propertyOf(OpenGex::attrib).as<std::string>();
+            MeshAttribute name;
+            if(attrib == "position") name = MeshAttribute::Position;
+            else if(attrib == "normal") name = MeshAttribute::Normal;
+            else if(attrib == "texcoord") name = MeshAttribute::TextureCoordinates;
+
+            /* Some other thing that wasn't handled above, ignore */
+            else continue;
+
+            const OpenDdl::Structure vertexArrayData = vertexArray.firstChild();
+            const VertexFormat inputFormat = vertexArrayFormat(vertexArrayData.type(), vertexArrayData.subArraySize());
+            const VertexFormat format = formats[attributeIndex];
+            const std::size_t inputSize = vertexFormatSize(inputFormat);
+            const Containers::ArrayView<const char> src = vertexArrayBytes(vertexArrayData);
+            const Containers::StridedArrayView2D<const char> srcView{src,
+                src.data(), {vertexCount, inputSize},
+                {std::ptrdiff_t(inputSize), 1}};
+            char* const dst = vertexData + attributeOffset;
+
+            /* Dequantized positions */
+            if(format != inputFormat) {
+                const Containers::StridedArrayView1D<Vector3> positions{vertexData, reinterpret_cast<Vector3*>(dst), vertexCount, stride};
+                if(inputFormat == VertexFormat::Vector3ubNormalized)
+                    dequantizeVectors<UnsignedByte>(srcView, positions);
+                else if(inputFormat == VertexFormat::Vector3bNormalized)
+                    dequantizeVectors<Byte>(srcView, positions);
+                else if(inputFormat == VertexFormat::Vector3usNormalized)
+                    dequantizeVectors<UnsignedShort>(srcView, positions);
+                else if(inputFormat == VertexFormat::Vector3sNormalized)
+                    dequantizeVectors<Short>(srcView, positions);
+                else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+
+            /* Everything else is copied as-is */
+            } else Utility::copy(srcView, Containers::StridedArrayView2D<char>{
+                vertexData, dst, {vertexCount, inputSize}, {stride, 1}});
+
+            /* Scaled and rotated positions, the integer formats were
+               dequantized above */
+            if(name == MeshAttribute::Position && (_d->distanceMultiplier != 1.0f || !_d->yUp)) {
+                if(format == VertexFormat::Vector3) {
+                    const Containers::StridedArrayView1D<Vector3> positions{vertexData, reinterpret_cast<Vector3*>(dst), vertexCount, stride};
+                    for(auto& i: positions) i *= _d->distanceMultiplier;
+                    if(!_d->yUp) for(auto& i: positions) i = fixVectorZUp(i);
+                } else if(format == VertexFormat::Vector3h) {
+                    for(auto& i: Containers::StridedArrayView1D<Vector3h>{vertexData, reinterpret_cast<Vector3h*>(dst), vertexCount, stride}) {
+                        Vector3 position{i};
+                        position *= _d->distanceMultiplier;
+                        if(!_d->yUp) position = fixVectorZUp(position);
+                        i = Vector3h{position};
+                    }
+                } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+
+            /* Rotated normals, signed integer ones stay in the integer domain
+               as the swizzle and negation don't need any rounding */
+            } else if(name == MeshAttribute::Normal && !_d->yUp) {
+                if(format == VertexFormat::Vector3) {
+                    for(auto& i: Containers::StridedArrayView1D<Vector3>{vertexData, reinterpret_cast<Vector3*>(dst), vertexCount, stride})
+                        i = fixVectorZUp(i);
+                } else if(format == VertexFormat::Vector3h) {
+                    for(auto& i: Containers::StridedArrayView1D<Vector3h>{vertexData, reinterpret_cast<Vector3h*>(dst), vertexCount, stride})
+                        i = Vector3h{fixVectorZUp(Vector3{i})};
+                } else if(format == VertexFormat::Vector3bNormalized) {
+                    for(auto& i: Containers::StridedArrayView1D<Vector3b>{vertexData, reinterpret_cast<Vector3b*>(dst), vertexCount, stride})
+                        i = fixNormalizedVectorZUp(i);
+                } else if(format == VertexFormat::Vector3sNormalized) {
+                    for(auto& i: Containers::StridedArrayView1D<Vector3s>{vertexData, reinterpret_cast<Vector3s*>(dst), vertexCount, stride})
+                        i = fixNormalizedVectorZUp(i);
+                } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+            }
 
-        /* Some other thing that wasn't handled above, ignore */
+            attributeData[attributeIndex++] = MeshAttributeData{name, format,
+                Containers::StridedArrayView1D<const void>{vertexData, dst,
+                    vertexCount, stride}};
+            attributeOffset += (vertexFormatSize(format) + 3)/4*4;
         }
-    }
 
-    /* Check we pre-calculated well */
-    CORRADE_INTERNAL_ASSERT(attributeOffset == std::size_t(stride));
-    CORRADE_INTERNAL_ASSERT(attributeIndex == attributeCount);
+        /* Check we pre-calculated well */
+        CORRADE_INTERNAL_ASSERT(attributeOffset == std::size_t(stride));
+        CORRADE_INTERNAL_ASSERT(attributeIndex == attributeCount);
+    }
 
     /* Mesh indices */
     MeshIndexData indices;
     Containers::Array<char> indexData;
+    Containers::ArrayView<const char> indexDataView;
     if(const Containers::Optional<OpenDdl::Structure> indexArray = mesh.findFirstChildOf(OpenGex::IndexArray)) {
         const OpenDdl::Structure indexArrayData = indexArray->firstChild();
 
@@ -709,6 +1138,11 @@ Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, Uns
             case OpenDdl::Type::UnsignedByte: {
                 Containers::ArrayView<const UnsignedByte> src =
                     indexArrayData.asArray<UnsignedByte>();
+                if(zeroCopy) {
+                    indexDataView = Containers::arrayCast<const char>(src);
+                    indices = MeshIndexData{src};
+                    break;
+                }
                 indexData = Containers::Array<char>{src.size()};
                 auto indexData8 = Containers::arrayCast<UnsignedByte>(indexData);
                 Utility::copy(src, indexData8);
@@ -717,6 +1151,11 @@ Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, Uns
             case OpenDdl::Type::UnsignedShort: {
                 Containers::ArrayView<const UnsignedShort> src =
                     indexArrayData.asArray<UnsignedShort>();
+                if(zeroCopy) {
+                    indexDataView = Containers::arrayCast<const char>(src);
+                    indices = MeshIndexData{src};
+                    break;
+                }
                 indexData = Containers::Array<char>{src.size()*2};
                 auto indexData16 = Containers::arrayCast<UnsignedShort>(indexData);
                 Utility::copy(src, indexData16);
@@ -725,6 +1164,11 @@ Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, Uns
             case OpenDdl::Type::UnsignedInt: {
                 Containers::ArrayView<const UnsignedInt> src =
                     indexArrayData.asArray<UnsignedInt>();
+                if(zeroCopy) {
+                    indexDataView = Containers::arrayCast<const char>(src);
+                    indices = MeshIndexData{src};
+                    break;
+                }
                 indexData = Containers::Array<char>{src.size()*4};
                 auto indexData32 = Containers::arrayCast<UnsignedInt>(indexData);
                 Utility::copy(src, indexData32);
@@ -740,11 +1184,45 @@ Containers::Optional<MeshData> OpenGexImporter::doMesh(const UnsignedInt id, Uns
         }
     }
 
+    /* Index data are never converted, so with zero-copy import they're
+       always referenced from the document */
+    if(zeroCopy) {
+        if(vertexData) return MeshData{primitive,
+            DataFlags{}, indexDataView, indices,
+            std::move(vertexData), std::move(attributeData)};
+        return MeshData{primitive,
+            DataFlags{}, indexDataView, indices,
+            DataFlags{}, vertexDataView, std::move(attributeData)};
+    }
+
     return MeshData{primitive,
         std::move(indexData), indices,
         std::move(vertexData), std::move(attributeData)};
 }
 
+Containers::Array<Containers::Optional<MeshData>> OpenGexImporter::meshes() {
+    CORRADE_ASSERT(_d, "Trade::OpenGexImporter::meshes(): no file opened", {});
+
+    Containers::Array<Containers::Optional<MeshData>> out{_d->meshes.size()};
+
+    /* Each thread takes the next mesh that's not imported yet */
+    std::atomic<std::size_t> next{0};
+    auto importMeshes = [&]() {
+        std::size_t id;
+        while((id = next++) < out.size())
+            out[id] = doMesh(id, 0);
+    };
+
+    UnsignedInt threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount) threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    Containers::Array<std::thread> threads{out.empty() ? 0 : std::min(std::size_t{threadCount}, out.size()) - 1};
+    for(std::thread& thread: threads) thread = std::thread{importMeshes};
+    importMeshes();
+    for(std::thread& thread: threads) thread.join();
+
+    return out;
+}
+
 UnsignedInt OpenGexImporter::doMaterialCount() const { return _d->materials.size(); }
 
 Int OpenGexImporter::doMaterialForName(const std::string& name) {
@@ -859,6 +1337,10 @@ AbstractImporter* OpenGexImporter::setupOrReuseImporterForImage(const UnsignedIn
 UnsignedInt OpenGexImporter::doImage2DLevelCount(const UnsignedInt id) {
     CORRADE_ASSERT(manager(), "Trade::OpenGexImporter::image2DLevelCount(): the plugin must be instantiated with access to plugin manager in order to open image files", {});
 
+    /* Known upfront for prefetched images */
+    if(!_d->prefetchedImages.empty() && _d->prefetchedImages[id].importer)
+        return _d->prefetchedImages[id].levelCount;
+
     AbstractImporter* importer = setupOrReuseImporterForImage(id, "Trade::OpenGexImporter::image2DLevelCount():");
     /* image2DLevelCount() isn't supposed to fail (image2D() is, instead), so
        report 1 on failure and expect image2D() to fail later */
@@ -870,6 +1352,16 @@ UnsignedInt OpenGexImporter::doImage2DLevelCount(const UnsignedInt id) {
 Containers::Optional<ImageData2D> OpenGexImporter::doImage2D(const UnsignedInt id, const UnsignedInt level) {
     CORRADE_ASSERT(manager(), "Trade::OpenGexImporter::image2D(): the plugin must be instantiated with access to plugin manager in order to open image files", {});
 
+    /* If the image is prefetched, take the decoded level. If it failed to
+       decode on the worker or was taken already, decode it again on this
+       thread, which also reports the error here. No worker touches the
+       importer anymore once takePrefetched() returns. */
+    if(!_d->prefetchedImages.empty() && _d->prefetchedImages[id].importer) {
+        if(Containers::Optional<ImageData2D> image = _d->takePrefetched(id, level))
+            return image;
+        return _d->prefetchedImages[id].importer->image2D(0, level);
+    }
+
     AbstractImporter* importer = setupOrReuseImporterForImage(id, "Trade::OpenGexImporter::image2D():");
     if(!importer) return Containers::NullOpt;
 
@@ -110,7 +110,9 @@ top-level file during initial import, meaning there is at most one
 are loaded on-demand inside @ref image2D() calls with
 @ref InputFileCallbackPolicy::LoadTemporary and
 @ref InputFileCallbackPolicy::Close is emitted right after the file is fully
-read.
+read. With the @cb{.ini} prefetchImages @ce option enabled, described in
+@ref Trade-OpenGexImporter-behavior-textures, all image files are loaded
+inside @ref openData() / @ref openFile() instead.
 
 -   Import of animation data is not supported at the moment.
 -   `half` data type results in parsing error.
@@ -124,6 +126,34 @@ read.
     are ignored.
 -   Geometry node visibility, shadow and motion blur properties are ignored.
 
+The whole file is parsed on the calling thread by default. If the
+@cb{.ini} threads @ce
+@ref Trade-OpenGexImporter-configuration "configuration option" is set to a
+value other than @cpp 1 @ce, top-level structures of large files are parsed in
+parallel using @ref OpenDdl::Document::setThreadCount(). In that case the
+application needs to link to `pthread` on Linux due to the same reasons as
+described in @ref Trade-BasisImageConverter-loading "BasisImageConverter docs".
+
+If the @cb{.ini} lazy @ce configuration option is enabled, the document
+structure is validated when opening, but numeric data lists are parsed only
+once they're accessed, using @ref OpenDdl::Document::setLazy(). That makes
+opening large files considerably faster when only the scene hierarchy is
+needed. Invalid vertex or index data then cause @ref mesh() to fail instead
+of @ref openData(), invalid values elsewhere are printed on error output and
+treated as zero.
+
+If the @cb{.ini} cache @ce configuration option is enabled and a file is opened
+using @ref openFile() without a file callback set, the parsed document is
+stored next to the file in a binary form produced by
+@ref OpenDdl::Document::serialize(), with a @cb{.txt} .cache @ce suffix added to
+the filename. Subsequent opens of the same file then load the cache using
+@ref OpenDdl::Document::deserialize() instead of parsing the text again. The
+cache is discarded and regenerated if the size or contents hash of the
+original file changes. Because the whole document needs to be parsed in order
+to be serialized, the @cb{.ini} lazy @ce option has no effect when the cache
+is being written. If the cache can't be written, a warning is printed and the
+file is opened as usual.
+
 @subsection Trade-OpenGexImporter-behavior-camera Camera import
 
 -   Camera type is always @ref CameraType::Perspective3D
@@ -142,11 +172,22 @@ read.
 -   Quads are not supported.
 -   Additional mesh LoDs after the first one are ignored.
 -   `w` coordinate for vertex positions and normals is ignored if present.
--   Positions and normals are always imported as @ref VertexFormat::Vector3,
-    texture coordinates as @ref VertexFormat::Vector2. Positions and normals of
+-   Positions and normals are imported as three-component and texture
+    coordinates as two-component vertex formats. Positions and normals of
     a different component count than 3 and texture coordinates of a different
-    component count than 2 are not supported. Only floats are supported,
-    doubles not.
+    component count than 2 are not supported.
+-   Float and half-float vertex arrays are imported as
+    @ref VertexFormat::Vector3 / @ref VertexFormat::Vector2 and
+    @ref VertexFormat::Vector3h / @ref VertexFormat::Vector2h, 8- and 16-bit
+    integer vertex arrays as the corresponding normalized formats, for example
+    @ref VertexFormat::Vector3bNormalized or
+    @ref VertexFormat::Vector2usNormalized. Unsigned normals, 32- and 64-bit
+    integers and doubles are not supported.
+-   Interleaved attributes are padded to four bytes.
+-   If positions need to be scaled or rotated because of the distance and up
+    metrics, half-float positions are converted in place while normalized
+    integer positions are dequantized to @ref VertexFormat::Vector3. Normals
+    are always rotated in their original format.
 -   Indices are imported as either @ref MeshIndexType::UnsignedByte,
     @ref MeshIndexType::UnsignedShort or @ref MeshIndexType::UnsignedInt.
     64-bit indices are not supported.
@@ -154,6 +195,22 @@ read.
 The imported mesh always has at least one vertex attribute, but positions are
 not required to be present. Indices are optional as well.
 
+If the @cb{.ini} zeroCopy @ce
+@ref Trade-OpenGexImporter-configuration "configuration option" is enabled,
+index data are referenced directly from the parsed document instead of being
+copied. The same is done for vertex data if they don't need any conversion,
+i.e. if the file is Y up and has a unit distance metric, or if it contains
+only texture coordinates, and all attributes have the same type, with the
+attributes being non-interleaved in that case. The corresponding @ref MeshData::indexDataFlags() and
+@ref MeshData::vertexDataFlags() are then empty, meaning the data are valid
+only while the file is opened.
+
+Mesh import only reads the parsed document, so independent meshes can be
+imported by @ref meshes() on multiple threads at once, including conversion of
+data lists deferred with the @cb{.ini} lazy @ce option. Unlike with parsing,
+multiple threads are used there also when the file wasn't big enough to be
+split into chunks.
+
 @subsection Trade-OpenGexImporter-behavior-materials Material import
 
 -   Alpha mode is always @ref MaterialAlphaMode::Opaque and alpha mask always
@@ -176,7 +233,58 @@ not required to be present. Indices are optional as well.
     present in the image list only once. Note that only a simple string
     comparison is used without any path normalization.
 
-@subsection Trade-OpenGexImporter-state Access to internal importer state
+By default, each image file is opened and decoded only once @ref image2D() is
+called for it. If the @cb{.ini} prefetchImages @ce
+@ref Trade-OpenGexImporter-configuration "configuration option" is enabled,
+all images referenced by the file are opened already in @ref openData() /
+@ref openFile() and then decoded in the background on the number of threads
+given by the @cb{.ini} threads @ce option, at least one. An @ref image2D()
+call then either returns the already decoded image, waits for it if it's
+being decoded right now, or decodes it on the calling thread if no worker
+got to it yet. Each decoded level is handed over only once, calling
+@ref image2D() for the same level again decodes it again. Loading the files
+and instantiating the image importer plugins is done on the calling thread,
+so the file callbacks don't need to be thread-safe. Images that fail to open
+or decode are reported by @ref image2D() as usual, decoding errors may
+additionally get printed from the worker threads, bypassing any output
+redirection set up on the calling thread. Closing the file waits for all
+images that are being decoded right now.
+
+@section Trade-OpenGexImporter-profiling Profiling
+
+If the plugin is built with `WITH_IMPORTER_PROFILING` enabled, it measures
+the duration of individual import stages and reports them to a callback set
+with @ref setProfilingCallback(), together with the amount of data each stage
+processed. The stages are:
+
+-   `parse` --- parsing the OpenDDL document, with the input size
+-   `validate` --- validating the document against the OpenGEX specification
+-   `deserialize` --- loading the parsed document from a cache file if the
+    @cb{.ini} cache @ce option is enabled, with the cache file size
+-   `serialize` --- saving the parsed document to a cache file, with the
+    cache file size
+-   `deferred` --- parsing vertex and index data of a mesh in @ref mesh() if
+    the @cb{.ini} lazy @ce option is enabled
+-   `mesh` --- the whole @ref mesh() call, with the size of the output vertex
+    and index data
+
+With @ref meshes() and the @cb{.ini} threads @ce option set to a value other
+than @cpp 1 @ce, the `deferred` and `mesh` stages get reported from multiple
+threads at the same time.
+
+Without `WITH_IMPORTER_PROFILING` the measurement is compiled out and the
+callback is never called. If it's enabled, the
+@cpp MAGNUM_OPENGEXIMPORTER_WITH_PROFILING @ce macro is defined in the
+`MagnumPlugins/OpenGexImporter/configure.h` header.
+
+@section Trade-OpenGexImporter-configuration Plugin-specific config
+
+It's possible to tune various import options through @ref configuration(). See
+below for all options and their default values.
+
+@snippet MagnumPlugins/OpenGexImporter/OpenGexImporter.conf config
+
+@section Trade-OpenGexImporter-state Access to internal importer state
 
 Generic importer for OpenDDL files is implemented in the @ref OpenDdl::Document
 class available as part of this plugin and access to it is provided through
@@ -230,6 +338,38 @@ class MAGNUM_OPENGEXIMPORTER_EXPORT OpenGexImporter: public AbstractImporter {
             return static_cast<const OpenDdl::Document*>(AbstractImporter::importerState());
         }
 
+        /**
+         * @brief Import all meshes
+         * @m_since_latest_{plugins}
+         *
+         * Equivalent to calling @ref mesh() for all IDs from @cpp 0 @ce to
+         * @ref meshCount(), but the meshes are imported on the number of
+         * threads given by the @cb{.ini} threads @ce
+         * @ref Trade-OpenGexImporter-configuration "configuration option".
+         * Meshes that failed to import are @ref Containers::NullOpt in the
+         * returned array. Note that messages printed from other threads don't
+         * go through output redirection set up on the calling thread. See
+         * @ref Trade-OpenGexImporter-behavior-meshes for more information.
+         *
+         * Expects that a file is opened.
+         */
+        virtual Containers::Array<Containers::Optional<MeshData>> meshes();
+
+        /**
+         * @brief Set profiling callback
+         * @m_since_latest_{plugins}
+         *
+         * The @p callback is called at the end of each import stage with the
+         * stage name, its duration in nanoseconds, count of bytes it
+         * processed or @cpp 0 @ce if not applicable, and @p userData. The
+         * callback is kept across opened files, pass @cpp nullptr @ce to
+         * reset it. Doesn't need any file to be opened. If the plugin isn't
+         * built with `WITH_IMPORTER_PROFILING`, the callback is never
+         * called. See @ref Trade-OpenGexImporter-profiling for more
+         * information.
+         */
+        virtual void setProfilingCallback(void(*callback)(const char* stage, UnsignedLong nanoseconds, std::size_t byteCount, void* userData), void* userData = nullptr);
+
     private:
         struct Document;
 
@@ -238,6 +378,9 @@ class MAGNUM_OPENGEXIMPORTER_EXPORT OpenGexImporter: public AbstractImporter {
         MAGNUM_OPENGEXIMPORTER_LOCAL bool doIsOpened() const override;
         MAGNUM_OPENGEXIMPORTER_LOCAL void doOpenData(Containers::ArrayView<const char> data) override;
         MAGNUM_OPENGEXIMPORTER_LOCAL void doOpenFile(const std::string& filename) override;
+        MAGNUM_OPENGEXIMPORTER_LOCAL void openFileCached(const std::string& filename);
+        MAGNUM_OPENGEXIMPORTER_LOCAL void openDocument(Containers::Pointer<Document>&& d);
+        MAGNUM_OPENGEXIMPORTER_LOCAL void prefetchImages();
         MAGNUM_OPENGEXIMPORTER_LOCAL void doClose() override;
 
         MAGNUM_OPENGEXIMPORTER_LOCAL Int doDefaultScene() override;
@@ -257,6 +400,7 @@ class MAGNUM_OPENGEXIMPORTER_EXPORT OpenGexImporter: public AbstractImporter {
 
         MAGNUM_OPENGEXIMPORTER_LOCAL UnsignedInt doMeshCount() const override;
         MAGNUM_OPENGEXIMPORTER_LOCAL Containers::Optional<MeshData> doMesh(UnsignedInt id, UnsignedInt level) override;
+        MAGNUM_OPENGEXIMPORTER_LOCAL Containers::Optional<MeshData> meshInternal(UnsignedInt id);
 
         MAGNUM_OPENGEXIMPORTER_LOCAL UnsignedInt doMaterialCount() const override;
         MAGNUM_OPENGEXIMPORTER_LOCAL Int doMaterialForName(const std::string& name) override;
@@ -275,6 +419,9 @@ class MAGNUM_OPENGEXIMPORTER_EXPORT OpenGexImporter: public AbstractImporter {
         MAGNUM_OPENGEXIMPORTER_LOCAL const void* doImporterState() const override;
 
         Containers::Pointer<Document> _d;
+        void(*_profilingCallback)(const char*, UnsignedLong, std::size_t, void*){};
+        void* _profilingUserData{};
+        bool _openingFile{};
 };
 
 }}
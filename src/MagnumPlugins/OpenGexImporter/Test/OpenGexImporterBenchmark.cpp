@@ -0,0 +1,200 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <string>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/MeshData.h>
+
+#include "MagnumPlugins/Implementation/peakMemory.h"
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+struct OpenGexImporterBenchmark: TestSuite::Tester {
+    explicit OpenGexImporterBenchmark();
+
+    void open();
+    void firstData();
+    void import();
+    void peakMemory();
+
+    void peakMemoryBegin();
+    std::uint64_t peakMemoryEnd();
+
+    PluginManager::Manager<AbstractImporter> _manager;
+
+    std::uint64_t _residentSizeBefore{};
+};
+
+/* To calculate the throughput, divide the file size shown in the test case
+   description by the measured time */
+constexpr struct {
+    const char* name;
+    UnsignedInt meshCount;
+} FileData[]{
+    {"one large mesh", 1},
+    {"1024 small meshes", 1024}
+};
+
+/* A text file with meshes of 262144 vertices in total, each with positions,
+   normals and 32-bit triangle indices, each mesh referenced by a node.
+   Generated instead of bundling large files. */
+std::string file(const UnsignedInt meshCount) {
+    const UnsignedInt vertexCount = 262144/meshCount;
+
+    std::string out = "Metric (key = \"up\") { string { \"z\" } }\n";
+    for(UnsignedInt i = 0; i != meshCount; ++i)
+        out += Utility::formatString("GeometryNode {{ ObjectRef {{ ref {{ $mesh{} }} }} }}\n", i);
+
+    for(UnsignedInt i = 0; i != meshCount; ++i) {
+        out += Utility::formatString("GeometryObject $mesh{} {{\n"
+            "    Mesh (primitive = \"triangles\") {{\n"
+            "        VertexArray (attrib = \"position\") {{ float[3] {{\n", i);
+        for(UnsignedInt j = 0; j != vertexCount; ++j)
+            out += Utility::formatString("{}{{{}.0, {}.5, 0.25}}", j ? ", " : "", j % 2, j/2);
+        out += "}}\n        VertexArray (attrib = \"normal\") { float[3] {\n";
+        for(UnsignedInt j = 0; j != vertexCount; ++j)
+            out += j ? ", {0.0, 0.0, 1.0}" : "{0.0, 0.0, 1.0}";
+        out += "}}\n        IndexArray { unsigned_int32[3] {\n";
+        for(UnsignedInt j = 0; j != vertexCount - 2; ++j)
+            out += Utility::formatString("{}{{{}, {}, {}}}", j ? ", " : "", j, j + 1, j + 2);
+        out += "}}\n    }\n}\n";
+    }
+
+    return out;
+}
+
+OpenGexImporterBenchmark::OpenGexImporterBenchmark() {
+    addInstancedBenchmarks({&OpenGexImporterBenchmark::open,
+                            &OpenGexImporterBenchmark::firstData,
+                            &OpenGexImporterBenchmark::import}, 10,
+        Containers::arraySize(FileData));
+
+    addCustomInstancedBenchmarks({&OpenGexImporterBenchmark::peakMemory}, 1,
+        Containers::arraySize(FileData),
+        &OpenGexImporterBenchmark::peakMemoryBegin,
+        &OpenGexImporterBenchmark::peakMemoryEnd,
+        BenchmarkUnits::Bytes);
+
+    /* Load the plugin directly from the build tree. Otherwise it's static and
+       already loaded. It also pulls in the AnyImageImporter dependency. Reset
+       the plugin dir after so it doesn't load anything else from the
+       filesystem. */
+    #ifdef OPENGEXIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(OPENGEXIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    _manager.setPluginDirectory({});
+    #endif
+}
+
+void OpenGexImporterBenchmark::open() {
+    auto&& data = FileData[testCaseInstanceId()];
+
+    const std::string in = file(data.meshCount);
+    setTestCaseDescription(Utility::formatString("{}, {} bytes", data.name, in.size()));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+
+    bool opened = false;
+    CORRADE_BENCHMARK(1)
+        opened = importer->openData({in.data(), in.size()});
+
+    CORRADE_VERIFY(opened);
+}
+
+void OpenGexImporterBenchmark::firstData() {
+    auto&& data = FileData[testCaseInstanceId()];
+
+    const std::string in = file(data.meshCount);
+    setTestCaseDescription(Utility::formatString("{}, {} bytes", data.name, in.size()));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+
+    Containers::Optional<MeshData> mesh;
+    CORRADE_BENCHMARK(1) {
+        importer->openData({in.data(), in.size()});
+        mesh = importer->mesh(0);
+    }
+
+    CORRADE_VERIFY(mesh);
+}
+
+void OpenGexImporterBenchmark::import() {
+    auto&& data = FileData[testCaseInstanceId()];
+
+    const std::string in = file(data.meshCount);
+    setTestCaseDescription(Utility::formatString("{}, {} bytes", data.name, in.size()));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+
+    UnsignedInt imported = 0;
+    CORRADE_BENCHMARK(1) {
+        importer->openData({in.data(), in.size()});
+        for(UnsignedInt i = 0; i != importer->meshCount(); ++i)
+            if(importer->mesh(i)) ++imported;
+    }
+
+    CORRADE_COMPARE(imported, data.meshCount);
+}
+
+void OpenGexImporterBenchmark::peakMemory() {
+    auto&& data = FileData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifndef __linux__
+    CORRADE_SKIP("Peak memory can be measured only on Linux.");
+    #else
+    /* The input is generated outside of the measured region, so only the
+       memory allocated by the importer and for the output is counted */
+    const std::string in = file(data.meshCount);
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+
+    UnsignedInt imported = 0;
+    CORRADE_BENCHMARK(1) {
+        importer->openData({in.data(), in.size()});
+        for(UnsignedInt i = 0; i != importer->meshCount(); ++i)
+            if(importer->mesh(i)) ++imported;
+    }
+
+    CORRADE_COMPARE(imported, data.meshCount);
+    #endif
+}
+
+void OpenGexImporterBenchmark::peakMemoryBegin() {
+    _residentSizeBefore = Magnum::Implementation::peakMemoryBegin();
+}
+
+std::uint64_t OpenGexImporterBenchmark::peakMemoryEnd() {
+    return Magnum::Implementation::peakMemoryEnd(_residentSizeBefore);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::OpenGexImporterBenchmark)
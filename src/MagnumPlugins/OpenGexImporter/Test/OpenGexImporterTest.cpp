@@ -36,6 +36,8 @@
 #include <Magnum/FileCallback.h>
 #include <Magnum/Mesh.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/VertexFormat.h>
+#include <Magnum/Math/Half.h>
 #include <Magnum/Math/Quaternion.h>
 #include <Magnum/Math/Vector3.h>
 #include <Magnum/Trade/AbstractImporter.h>
@@ -53,6 +55,7 @@
 #include "Magnum/OpenDdl/Property.h"
 #include "Magnum/OpenDdl/Structure.h"
 #include "MagnumPlugins/OpenGexImporter/OpenGex.h"
+#include "MagnumPlugins/OpenGexImporter/OpenGexImporter.h"
 
 #include "configure.h"
 
@@ -89,10 +92,20 @@ struct OpenGexImporterTest: public TestSuite::Tester {
     void mesh();
     void meshIndexed();
     void meshMetrics();
+    void meshLazy();
+    void meshLazyInvalidData();
+    void meshCache();
+    void meshZeroCopy();
+    void meshZeroCopyConversion();
+    void meshHalfNormalized();
+    void meshHalfNormalizedConversion();
+    void meshHalfNormalizedZeroCopy();
+    void meshesThreads();
 
     void meshInvalidPrimitive();
     void meshUnsupportedSize();
     void meshMismatchedSizes();
+    void meshUnsupportedVertexArrayType();
     void meshInvalidIndexArraySubArraySize();
     #ifndef CORRADE_TARGET_EMSCRIPTEN
     void meshUnsupportedIndexType();
@@ -111,6 +124,8 @@ struct OpenGexImporterTest: public TestSuite::Tester {
     void imageUnique();
     void imageMipLevels();
     void imageNoPathNoCallback();
+    void imagePrefetch();
+    void imagePrefetchNotFound();
 
     void extension();
 
@@ -148,10 +163,20 @@ OpenGexImporterTest::OpenGexImporterTest() {
               &OpenGexImporterTest::mesh,
               &OpenGexImporterTest::meshIndexed,
               &OpenGexImporterTest::meshMetrics,
+              &OpenGexImporterTest::meshLazy,
+              &OpenGexImporterTest::meshLazyInvalidData,
+              &OpenGexImporterTest::meshCache,
+              &OpenGexImporterTest::meshZeroCopy,
+              &OpenGexImporterTest::meshZeroCopyConversion,
+              &OpenGexImporterTest::meshHalfNormalized,
+              &OpenGexImporterTest::meshHalfNormalizedConversion,
+              &OpenGexImporterTest::meshHalfNormalizedZeroCopy,
+              &OpenGexImporterTest::meshesThreads,
 
               &OpenGexImporterTest::meshInvalidPrimitive,
               &OpenGexImporterTest::meshUnsupportedSize,
               &OpenGexImporterTest::meshMismatchedSizes,
+              &OpenGexImporterTest::meshUnsupportedVertexArrayType,
               &OpenGexImporterTest::meshInvalidIndexArraySubArraySize,
               #ifndef CORRADE_TARGET_EMSCRIPTEN
               &OpenGexImporterTest::meshUnsupportedIndexType,
@@ -170,6 +195,8 @@ OpenGexImporterTest::OpenGexImporterTest() {
               &OpenGexImporterTest::imageUnique,
               &OpenGexImporterTest::imageMipLevels,
               &OpenGexImporterTest::imageNoPathNoCallback,
+              &OpenGexImporterTest::imagePrefetch,
+              &OpenGexImporterTest::imagePrefetchNotFound,
 
               &OpenGexImporterTest::extension,
 
@@ -779,6 +806,356 @@ void OpenGexImporterTest::meshMetrics() {
         }), TestSuite::Compare::Container);
 }
 
+void OpenGexImporterTest::meshLazy() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    importer->configuration().setValue("lazy", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "mesh.ogex")));
+
+    /* The result should be the same as with eager parsing */
+    Containers::Optional<MeshData> mesh = importer->mesh(1);
+    CORRADE_VERIFY(mesh);
+    CORRADE_VERIFY(mesh->isIndexed());
+    CORRADE_COMPARE_AS(mesh->indices<UnsignedShort>(),
+        Containers::arrayView<UnsignedShort>({
+            2, 0, 1, 1, 2, 3
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {0.0f, 1.0f, 3.0f}, {-1.0f, 2.0f, 2.0f}, {3.0f, 3.0f, 1.0f}, {5.0f, 7.0f, 0.5f}
+        }), TestSuite::Compare::Container);
+
+    /* Importing again works too */
+    mesh = importer->mesh(1);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->attribute<Vector3>(MeshAttribute::Position)[3], (Vector3{5.0f, 7.0f, 0.5f}));
+}
+
+void OpenGexImporterTest::meshLazyInvalidData() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    importer->configuration().setValue("lazy", true);
+
+    /* GCC < 4.9 cannot handle multiline raw string literals inside macros */
+    auto s = OpenDdl::CharacterLiteral{R"oddl(
+GeometryObject {
+    Mesh (primitive = "triangles") {
+        VertexArray (attrib = "position") { float[3] {
+            {0.0, 1.0, 3.0}, {-1.0, 2.0.0, 2.0}, {3.0, 3.0, 1.0}
+        }}
+    }
+}
+    )oddl"};
+
+    /* The invalid literal is found only during mesh import */
+    CORRADE_VERIFY(importer->openData(s));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->mesh(0));
+    CORRADE_COMPARE(out.str(), "OpenDdl::Document::parseDeferred(): expected , character on line 5\n");
+}
+
+void OpenGexImporterTest::meshCache() {
+    const std::string filename = Utility::Directory::join(OPENGEXIMPORTER_WRITE_TEST_DIR, "mesh.ogex");
+    const std::string cacheFilename = filename + ".cache";
+    CORRADE_VERIFY(Utility::Directory::mkpath(OPENGEXIMPORTER_WRITE_TEST_DIR));
+    CORRADE_VERIFY(Utility::Directory::copy(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "mesh.ogex"), filename));
+    if(Utility::Directory::exists(cacheFilename))
+        CORRADE_VERIFY(Utility::Directory::rm(cacheFilename));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    importer->configuration().setValue("cache", true);
+
+    /* First open writes the cache, second loads it, third regenerates it
+       after the file changed */
+    for(std::size_t i: {0, 1, 2}) {
+        CORRADE_ITERATION(i);
+
+        if(i == 2) CORRADE_VERIFY(Utility::Directory::appendString(filename, "\n"));
+
+        CORRADE_VERIFY(importer->openFile(filename));
+        CORRADE_VERIFY(Utility::Directory::exists(cacheFilename));
+        CORRADE_COMPARE(importer->meshCount(), 3);
+
+        Containers::Optional<MeshData> mesh = importer->mesh(1);
+        CORRADE_VERIFY(mesh);
+        CORRADE_VERIFY(mesh->isIndexed());
+        CORRADE_COMPARE_AS(mesh->indices<UnsignedShort>(),
+            Containers::arrayView<UnsignedShort>({
+                2, 0, 1, 1, 2, 3
+            }), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+            Containers::arrayView<Vector3>({
+                {0.0f, 1.0f, 3.0f}, {-1.0f, 2.0f, 2.0f}, {3.0f, 3.0f, 1.0f}, {5.0f, 7.0f, 0.5f}
+            }), TestSuite::Compare::Container);
+    }
+
+    /* A corrupted cache gets regenerated as well */
+    Containers::Array<char> cache = Utility::Directory::read(cacheFilename);
+    CORRADE_VERIFY(cache.size() > 32);
+    cache[24] = 'X';
+    CORRADE_VERIFY(Utility::Directory::write(cacheFilename, cache));
+    CORRADE_VERIFY(importer->openFile(filename));
+    CORRADE_COMPARE(importer->meshCount(), 3);
+    CORRADE_COMPARE_AS(Utility::Directory::read(cacheFilename).suffix(16).prefix(8),
+        Containers::arrayView("ODDLBLOB").prefix(8),
+        TestSuite::Compare::Container);
+}
+
+void OpenGexImporterTest::meshZeroCopy() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    importer->configuration().setValue("zeroCopy", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "mesh.ogex")));
+
+    /* Y up and no distance metric, so nothing needs to be copied */
+    Containers::Optional<MeshData> mesh = importer->mesh(1);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->indexDataFlags(), DataFlags{});
+    CORRADE_COMPARE(mesh->vertexDataFlags(), DataFlags{});
+    CORRADE_COMPARE_AS(mesh->indices<UnsignedShort>(),
+        Containers::arrayView<UnsignedShort>({
+            2, 0, 1, 1, 2, 3
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {0.0f, 1.0f, 3.0f}, {-1.0f, 2.0f, 2.0f}, {3.0f, 3.0f, 1.0f}, {5.0f, 7.0f, 0.5f}
+        }), TestSuite::Compare::Container);
+
+    /* The data point to the document */
+    const OpenDdl::Document& document = *static_cast<const OpenDdl::Document*>(importer->importerState());
+    const OpenDdl::Structure meshStructure = document.firstChildOf(OpenGex::GeometryObject).findNextOf(OpenGex::GeometryObject)->firstChildOf(OpenGex::Mesh);
+    CORRADE_COMPARE(static_cast<const void*>(mesh->indexData().data()),
+        meshStructure.firstChildOf(OpenGex::IndexArray).firstChild().asArray<UnsignedShort>().data());
+    CORRADE_COMPARE(mesh->attribute(MeshAttribute::Position).data(),
+        meshStructure.firstChildOf(OpenGex::VertexArray).firstChild().asArray<Float>().data());
+
+    /* Non-interleaved attributes spanning more arrays */
+    mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexDataFlags(), DataFlags{});
+    CORRADE_COMPARE(mesh->attributeCount(), 4);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Normal),
+        Containers::arrayView<Vector3>({
+            {0.0f, 1.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector2>(MeshAttribute::TextureCoordinates, 1),
+        Containers::arrayView<Vector2>({
+            {0.5f, 1.0f}, {1.0f, 0.5f}, {0.5f, 0.5f}
+        }), TestSuite::Compare::Container);
+}
+
+void OpenGexImporterTest::meshZeroCopyConversion() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    importer->configuration().setValue("zeroCopy", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "mesh-metrics.ogex")));
+
+    /* Vertex data need to be converted so they're copied, indices not */
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->indexDataFlags(), DataFlags{});
+    CORRADE_COMPARE(mesh->vertexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+    CORRADE_COMPARE_AS(mesh->indices<UnsignedByte>(),
+        Containers::arrayView<UnsignedByte>({
+            2
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {100.0f, -200.0f, -50.0f}
+        }), TestSuite::Compare::Container);
+}
+
+void OpenGexImporterTest::meshHalfNormalized() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+
+    /* GCC < 4.9 cannot handle multiline raw string literals inside macros */
+    auto s = OpenDdl::CharacterLiteral{R"oddl(
+Metric (key = "up") { string { "y" } }
+GeometryObject {
+    Mesh (primitive = "points") {
+        VertexArray (attrib = "position") { half[3] {
+            {1.5, -0.25, 2.0}, {0x3c00, 0.0, -1.0}
+        }}
+        VertexArray (attrib = "normal") { int8[3] {
+            {0, 127, 0}, {-127, 0, 0}
+        }}
+        VertexArray (attrib = "texcoord") { unsigned_int8[2] {
+            {0, 255}, {128, 64}
+        }}
+        VertexArray (attrib = "texcoord") { unsigned_int16[2] {
+            {0, 65535}, {32768, 0}
+        }}
+    }
+}
+    )oddl"};
+    CORRADE_VERIFY(importer->openData(s));
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->attributeCount(), 4);
+
+    /* The formats are kept, attributes padded to four bytes */
+    CORRADE_COMPARE(mesh->attributeStride(0), 8 + 4 + 4 + 4);
+    CORRADE_COMPARE(mesh->attributeOffset(0), 0);
+    CORRADE_COMPARE(mesh->attributeOffset(1), 8);
+    CORRADE_COMPARE(mesh->attributeOffset(2), 12);
+    CORRADE_COMPARE(mesh->attributeOffset(3), 16);
+
+    CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Position), VertexFormat::Vector3h);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3h>(MeshAttribute::Position),
+        Containers::arrayView<Vector3h>({
+            {1.5_h, -0.25_h, 2.0_h}, {1.0_h, 0.0_h, -1.0_h}
+        }), TestSuite::Compare::Container);
+
+    CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Normal), VertexFormat::Vector3bNormalized);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3b>(MeshAttribute::Normal),
+        Containers::arrayView<Vector3b>({
+            {0, 127, 0}, {-127, 0, 0}
+        }), TestSuite::Compare::Container);
+
+    CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::TextureCoordinates, 0), VertexFormat::Vector2ubNormalized);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector2ub>(MeshAttribute::TextureCoordinates, 0),
+        Containers::arrayView<Vector2ub>({
+            {0, 255}, {128, 64}
+        }), TestSuite::Compare::Container);
+
+    CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::TextureCoordinates, 1), VertexFormat::Vector2usNormalized);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector2us>(MeshAttribute::TextureCoordinates, 1),
+        Containers::arrayView<Vector2us>({
+            {0, 65535}, {32768, 0}
+        }), TestSuite::Compare::Container);
+}
+
+void OpenGexImporterTest::meshHalfNormalizedConversion() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+
+    /* GCC < 4.9 cannot handle multiline raw string literals inside macros */
+    auto s = OpenDdl::CharacterLiteral{R"oddl(
+Metric (key = "up") { string { "z" } }
+Metric (key = "distance") { float { 2.0 } }
+GeometryObject {
+    Mesh (primitive = "points") {
+        VertexArray (attrib = "position") { half[3] {
+            {1.0, 0.5, -2.0}, {0.0, -0.25, 4.0}
+        }}
+        VertexArray (attrib = "normal") { int8[3] {
+            {0, -128, 127}, {127, 0, 0}
+        }}
+    }
+}
+GeometryObject {
+    Mesh (primitive = "points") {
+        VertexArray (attrib = "position") { int16[3] {
+            {32767, 0, -32767}
+        }}
+        VertexArray (attrib = "normal") { half[3] {
+            {0.0, 1.0, 0.0}
+        }}
+    }
+}
+    )oddl"};
+    CORRADE_VERIFY(importer->openData(s));
+
+    /* Half positions get scaled and rotated in their own format, signed
+       normalized normals are rotated in the integer domain with the
+       negation saturated */
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Position), VertexFormat::Vector3h);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3h>(MeshAttribute::Position),
+        Containers::arrayView<Vector3h>({
+            {2.0_h, -4.0_h, -1.0_h}, {0.0_h, 8.0_h, 0.5_h}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Normal), VertexFormat::Vector3bNormalized);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3b>(MeshAttribute::Normal),
+        Containers::arrayView<Vector3b>({
+            {0, 127, 127}, {127, 0, 0}
+        }), TestSuite::Compare::Container);
+
+    /* Normalized positions can't be scaled so they're dequantized to floats */
+    mesh = importer->mesh(1);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Position), VertexFormat::Vector3);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {2.0f, -2.0f, 0.0f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::Normal), VertexFormat::Vector3h);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3h>(MeshAttribute::Normal),
+        Containers::arrayView<Vector3h>({
+            {0.0_h, 0.0_h, -1.0_h}
+        }), TestSuite::Compare::Container);
+}
+
+void OpenGexImporterTest::meshHalfNormalizedZeroCopy() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    importer->configuration().setValue("zeroCopy", true);
+
+    /* GCC < 4.9 cannot handle multiline raw string literals inside macros */
+    auto s = OpenDdl::CharacterLiteral{R"oddl(
+Metric (key = "up") { string { "y" } }
+GeometryObject {
+    Mesh (primitive = "points") {
+        VertexArray (attrib = "position") { half[3] { {1.0, 0.5, -2.0} } }
+        VertexArray (attrib = "texcoord") { half[2] { {0.25, 0.75} } }
+    }
+}
+GeometryObject {
+    Mesh (primitive = "points") {
+        VertexArray (attrib = "position") { half[3] { {1.0, 0.5, -2.0} } }
+        VertexArray (attrib = "texcoord") { unsigned_int8[2] { {0, 255} } }
+    }
+}
+    )oddl"};
+    CORRADE_VERIFY(importer->openData(s));
+
+    /* All attributes have the same type, so the document data are
+       referenced directly */
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexDataFlags(), DataFlags{});
+    CORRADE_COMPARE(mesh->attributeFormat(MeshAttribute::TextureCoordinates), VertexFormat::Vector2h);
+    CORRADE_COMPARE(mesh->attribute<Vector2h>(MeshAttribute::TextureCoordinates)[0], (Vector2h{0.25_h, 0.75_h}));
+
+    const OpenDdl::Document& document = *static_cast<const OpenDdl::Document*>(importer->importerState());
+    const OpenDdl::Structure meshStructure = document.firstChildOf(OpenGex::GeometryObject).firstChildOf(OpenGex::Mesh);
+    CORRADE_COMPARE(mesh->attribute(MeshAttribute::Position).data(),
+        meshStructure.firstChildOf(OpenGex::VertexArray).firstChild().asArray<Half>().data());
+
+    /* Each type is in a different document array, so these get copied */
+    mesh = importer->mesh(1);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+    CORRADE_COMPARE(mesh->attribute<Vector3h>(MeshAttribute::Position)[0], (Vector3h{1.0_h, 0.5_h, -2.0_h}));
+    CORRADE_COMPARE(mesh->attribute<Vector2ub>(MeshAttribute::TextureCoordinates)[0], (Vector2ub{0, 255}));
+}
+
+void OpenGexImporterTest::meshesThreads() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    importer->configuration().setValue("threads", 4);
+    importer->configuration().setValue("lazy", true);
+
+    /* Each mesh has different vertex count and data */
+    std::string data = "Metric (key = \"up\") { string { \"y\" } }\n";
+    for(Int i = 0; i != 50; ++i) {
+        data += "GeometryObject { Mesh { VertexArray (attrib = \"position\") { float[3] {";
+        for(Int j = 0; j <= i; ++j)
+            data += (j ? ", {" : "{") + std::to_string(i) + ", " + std::to_string(j) + ", 0.5}";
+        data += "}}}}\n";
+    }
+    /* One broken mesh */
+    data += "GeometryObject { Mesh { VertexArray (attrib = \"position\") { float[3] { {0, 0, 0x} } } } }\n";
+    CORRADE_VERIFY(importer->openData({data.data(), data.size()}));
+
+    Containers::Array<Containers::Optional<MeshData>> meshes = static_cast<OpenGexImporter&>(*importer).meshes();
+    CORRADE_COMPARE(meshes.size(), 51);
+    for(Int i = 0; i != 50; ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_VERIFY(meshes[i]);
+        CORRADE_COMPARE(meshes[i]->vertexCount(), i + 1);
+        CORRADE_COMPARE(meshes[i]->attribute<Vector3>(MeshAttribute::Position)[i], (Vector3{Float(i), Float(i), 0.5f}));
+    }
+    CORRADE_VERIFY(!meshes[50]);
+}
+
 void OpenGexImporterTest::meshInvalidPrimitive() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "mesh-invalid.ogex")));
@@ -817,6 +1194,29 @@ void OpenGexImporterTest::meshMismatchedSizes() {
     CORRADE_COMPARE(out.str(), "Trade::OpenGexImporter::mesh(): mismatched vertex count for attribute normal, expected 2 but got 1\n");
 }
 
+void OpenGexImporterTest::meshUnsupportedVertexArrayType() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+
+    /* GCC < 4.9 cannot handle multiline raw string literals inside macros */
+    auto s = OpenDdl::CharacterLiteral{R"oddl(
+GeometryObject {
+    Mesh { VertexArray (attrib = "position") { int32[3] { {1, 2, 3} } } }
+}
+GeometryObject {
+    Mesh { VertexArray (attrib = "normal") { unsigned_int8[3] { {1, 2, 3} } } }
+}
+    )oddl"};
+    CORRADE_VERIFY(importer->openData(s));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->mesh(0));
+    CORRADE_VERIFY(!importer->mesh(1));
+    CORRADE_COMPARE(out.str(),
+        "Trade::OpenGexImporter::mesh(): unsupported vertex array type OpenDdl::Type::Int\n"
+        "Trade::OpenGexImporter::mesh(): unsupported normal type OpenDdl::Type::UnsignedByte\n");
+}
+
 void OpenGexImporterTest::meshInvalidIndexArraySubArraySize() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "mesh-invalid.ogex")));
@@ -1080,6 +1480,79 @@ void OpenGexImporterTest::imageNoPathNoCallback() {
     CORRADE_COMPARE(out.str(), "Trade::OpenGexImporter::image2D(): images can be imported only when opening files from the filesystem or if a file callback is present\n");
 }
 
+void OpenGexImporterTest::imagePrefetch() {
+    if(_manager.loadState("TgaImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("TgaImporter plugin not found, cannot test");
+    if(_manager.loadState("DdsImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("DdsImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    importer->configuration().setValue("prefetchImages", true);
+    importer->configuration().setValue("threads", 2);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "texture-mips.ogex")));
+    CORRADE_COMPARE(importer->image2DCount(), 2);
+    CORRADE_COMPARE(importer->image2DLevelCount(0), 2);
+    CORRADE_COMPARE(importer->image2DLevelCount(1), 1);
+
+    /* Going in the reverse order than the workers, so at least some images
+       are likely to be decoded on the calling thread */
+    Containers::Optional<ImageData2D> image1 = importer->image2D(1);
+    Containers::Optional<ImageData2D> image01 = importer->image2D(0, 1);
+    Containers::Optional<ImageData2D> image00 = importer->image2D(0);
+
+    CORRADE_VERIFY(image1);
+    CORRADE_COMPARE(image1->size(), (Vector2i{2, 3}));
+    CORRADE_COMPARE(image1->format(), PixelFormat::RGB8Unorm);
+    CORRADE_COMPARE_AS(image1->data(), Containers::arrayView<char>({
+        3, 2, 1, 4, 3, 2,
+        5, 4, 3, 6, 5, 4,
+        7, 6, 5, 8, 7, 6
+    }), TestSuite::Compare::Container);
+
+    CORRADE_VERIFY(image01);
+    CORRADE_COMPARE(image01->size(), Vector2i{1});
+    CORRADE_COMPARE_AS(image01->data(), Containers::arrayView<char>({
+        '\xd4', '\xd5', '\x96'
+    }), TestSuite::Compare::Container);
+
+    CORRADE_VERIFY(image00);
+    CORRADE_COMPARE(image00->size(), (Vector2i{3, 2}));
+
+    /* Importing the same image again decodes it again */
+    Containers::Optional<ImageData2D> image1Again = importer->image2D(1);
+    CORRADE_VERIFY(image1Again);
+    CORRADE_COMPARE_AS(image1Again->data(), image1->data(), TestSuite::Compare::Container);
+
+    /* Closing while nothing is being decoded */
+    importer->close();
+    CORRADE_VERIFY(!importer->isOpened());
+
+    /* Closing right after opening waits for the workers */
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "texture-mips.ogex")));
+    importer->close();
+    CORRADE_VERIFY(!importer->isOpened());
+}
+
+void OpenGexImporterTest::imagePrefetchNotFound() {
+    if(_manager.loadState("TgaImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("TgaImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
+    importer->configuration().setValue("prefetchImages", true);
+
+    /* Failures to open an image are not reported when opening the file */
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "texture-invalid.ogex")));
+    CORRADE_COMPARE(importer->image2DCount(), 2);
+    CORRADE_COMPARE(out.str(), "");
+
+    /* But only in image2D(), and just once, same as without prefetching */
+    CORRADE_VERIFY(!importer->image2D(1));
+    CORRADE_VERIFY(!importer->image2D(1));
+    CORRADE_COMPARE(out.str(), "Trade::AbstractImporter::openFile(): cannot open file /nonexistent.tga\n");
+}
+
 void OpenGexImporterTest::extension() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("OpenGexImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Directory::join(OPENGEXIMPORTER_TEST_DIR, "extension.ogex")));
@@ -27,3 +27,4 @@
 #cmakedefine DDSIMPORTER_PLUGIN_FILENAME "${DDSIMPORTER_PLUGIN_FILENAME}"
 #cmakedefine STBIMAGEIMPORTER_PLUGIN_FILENAME "${STBIMAGEIMPORTER_PLUGIN_FILENAME}"
 #define OPENGEXIMPORTER_TEST_DIR "${OPENGEXIMPORTER_TEST_DIR}"
+#define OPENGEXIMPORTER_WRITE_TEST_DIR "${OPENGEXIMPORTER_WRITE_TEST_DIR}"
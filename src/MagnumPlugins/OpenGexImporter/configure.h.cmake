@@ -24,3 +24,4 @@
 */
 
 #cmakedefine MAGNUM_OPENGEXIMPORTER_BUILD_STATIC
+#cmakedefine MAGNUM_OPENGEXIMPORTER_WITH_PROFILING
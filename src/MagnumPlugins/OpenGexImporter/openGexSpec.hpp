@@ -359,9 +359,13 @@ const std::initializer_list<Validation::Structure> structureInfo{
                                    {Extension, {}}}},
     {VertexArray,       Properties{{attrib, PropertyType::String, RequiredProperty},
                                    {morph, PropertyType::UnsignedInt, OptionalProperty}},
-                        Primitives{/** @todo half */
+                        Primitives{Type::Half,
                                    Type::Float,
-                                   Type::Double}, 1, 0,
+                                   Type::Double,
+                                   Type::UnsignedByte,
+                                   Type::Byte,
+                                   Type::UnsignedShort,
+                                   Type::Short}, 1, 0,
                         Structures{{Extension, {}}}}};
 
 }}}
@@ -25,6 +25,7 @@
 
 #include "PngImageConverter.h"
 
+#include <cstdlib>
 #include <cstring>
 #include <algorithm>
 #include <png.h>
@@ -38,13 +39,211 @@
     New versions don't have that anymore: https://github.com/glennrp/libpng/commit/6c2e919c7eb736d230581a4c925fa67bd901fcf8
 */
 #include <csetjmp>
+#include <atomic>
+#include <thread>
+#include <zlib.h>
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/DebugStl.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Functions.h>
 
 namespace Magnum { namespace Trade {
 
-PngImageConverter::PngImageConverter() = default;
+namespace {
+
+/* Filter types as written to the start of each row */
+enum: unsigned char {
+    FilterNone = 0,
+    FilterSub = 1,
+    FilterUp = 2,
+    FilterAverage = 3,
+    FilterPaeth = 4
+};
+
+inline unsigned char paeth(const Int a, const Int b, const Int c) {
+    const Int p = a + b - c;
+    const Int pa = std::abs(p - a);
+    const Int pb = std::abs(p - b);
+    const Int pc = std::abs(p - c);
+    if(pa <= pb && pa <= pc) return a;
+    if(pb <= pc) return b;
+    return c;
+}
+
+/* Filters one row. `previous` is nullptr for the first row of the image,
+   `out` has space for the filter type byte and the row. */
+void filterRow(const unsigned char type, const unsigned char* const row, const unsigned char* const previous, const std::size_t size, const std::size_t bpp, unsigned char* const out) {
+    out[0] = type;
+    unsigned char* const o = out + 1;
+    switch(type) {
+        case FilterNone:
+            std::memcpy(o, row, size);
+            return;
+        case FilterSub:
+            for(std::size_t i = 0; i != size; ++i)
+                o[i] = row[i] - (i >= bpp ? row[i - bpp] : 0);
+            return;
+        case FilterUp:
+            for(std::size_t i = 0; i != size; ++i)
+                o[i] = row[i] - (previous ? previous[i] : 0);
+            return;
+        case FilterAverage:
+            for(std::size_t i = 0; i != size; ++i)
+                o[i] = row[i] - ((Int(i >= bpp ? row[i - bpp] : 0) + Int(previous ? previous[i] : 0))/2);
+            return;
+        case FilterPaeth:
+            for(std::size_t i = 0; i != size; ++i)
+                o[i] = row[i] - paeth(i >= bpp ? row[i - bpp] : 0,
+                                      previous ? previous[i] : 0,
+                                      i >= bpp && previous ? previous[i - bpp] : 0);
+            return;
+    }
+
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
+
+/* Filters one row either with given filter or, if `type` is -1, with the one
+   that gives the smallest sum of absolute values, which is the heuristic
+   libpng uses. `scratch` is a space for one filtered row. */
+void filterRowAdaptive(const Int type, const unsigned char* const row, const unsigned char* const previous, const std::size_t size, const std::size_t bpp, unsigned char* const out, unsigned char* const scratch) {
+    if(type != -1) {
+        filterRow(type, row, previous, size, bpp, out);
+        return;
+    }
+
+    std::size_t best = ~std::size_t{};
+    for(unsigned char t = FilterNone; t <= FilterPaeth; ++t) {
+        filterRow(t, row, previous, size, bpp, scratch);
+        std::size_t sum = 0;
+        for(std::size_t i = 0; i != size; ++i)
+            sum += std::abs(Int(static_cast<signed char>(scratch[1 + i])));
+        if(sum < best) {
+            best = sum;
+            std::memcpy(out, scratch, size + 1);
+        }
+    }
+}
+
+/* Compresses image rows in independent bands on multiple threads and returns
+   the resulting zlib stream split into one piece per band, which are then
+   written as separate IDAT chunks. Each band is deflated with the last 32 kB
+   of the preceding band as a dictionary and ends with a sync flush, so their
+   concatenation is a valid stream, same as done by pigz. */
+Containers::Array<Containers::Array<unsigned char>> compressParallel(const Containers::ArrayView<const unsigned char> data, const std::size_t stride, const Vector2i& size, const std::size_t rowSize, const std::size_t bpp, const bool swap16, const bool yFlip, const Int filter, const Int level, const Int strategy, const UnsignedInt threadCount) {
+    /* Fixed band size so the output doesn't depend on the thread count */
+    constexpr std::size_t BandSize = 256*1024;
+    constexpr std::size_t WindowSize = 32*1024;
+    const std::size_t rowsPerBand = Math::max(BandSize/(rowSize + 1), std::size_t{1});
+    const std::size_t height = size.y();
+    const std::size_t bandCount = (height + rowsPerBand - 1)/rowsPerBand;
+    /* How many rows before a band need to be filtered to get a full window
+       for the dictionary */
+    const std::size_t dictionaryRows = (WindowSize + rowSize)/(rowSize + 1);
+
+    Containers::Array<Containers::Array<unsigned char>> out{bandCount};
+    Containers::Array<uLong> adlers{Containers::NoInit, bandCount};
+    Containers::Array<std::size_t> inputSizes{Containers::NoInit, bandCount};
+
+    /* PNG rows go top to bottom, image rows bottom to top unless the flip
+       is disabled */
+    auto sourceRow = [&](const std::size_t y, unsigned char* const swapped) -> const unsigned char* {
+        const unsigned char* row = data.data() + (yFlip ? height - y - 1 : y)*stride;
+        if(!swap16) return row;
+        for(std::size_t i = 0; i != rowSize; i += 2) {
+            swapped[i] = row[i + 1];
+            swapped[i + 1] = row[i];
+        }
+        return swapped;
+    };
+
+    std::atomic<std::size_t> next{0};
+    auto compressBands = [&]() {
+        Containers::Array<unsigned char> swapped[2]{
+            Containers::Array<unsigned char>{Containers::NoInit, swap16 ? rowSize : 0},
+            Containers::Array<unsigned char>{Containers::NoInit, swap16 ? rowSize : 0}};
+        Containers::Array<unsigned char> scratch{Containers::NoInit, rowSize + 1};
+        std::size_t b;
+        while((b = next++) < bandCount) {
+            const std::size_t begin = b*rowsPerBand;
+            const std::size_t end = Math::min(begin + rowsPerBand, height);
+            const std::size_t filterBegin = begin > dictionaryRows ? begin - dictionaryRows : 0;
+
+            /* Filter the band together with the rows used for the
+               dictionary */
+            Containers::Array<unsigned char> filtered{Containers::NoInit, (end - filterBegin)*(rowSize + 1)};
+            const unsigned char* previous = filterBegin ? sourceRow(filterBegin - 1, swapped[(filterBegin - 1) % 2].data()) : nullptr;
+            for(std::size_t y = filterBegin; y != end; ++y) {
+                const unsigned char* row = sourceRow(y, swapped[y % 2].data());
+                filterRowAdaptive(filter, row, previous, rowSize, bpp, filtered.data() + (y - filterBegin)*(rowSize + 1), scratch.data());
+                previous = row;
+            }
+            const std::size_t dictionarySize = Math::min((begin - filterBegin)*(rowSize + 1), WindowSize);
+            const unsigned char* const input = filtered.data() + (begin - filterBegin)*(rowSize + 1);
+            const std::size_t inputSize = (end - begin)*(rowSize + 1);
+
+            z_stream stream{};
+            CORRADE_INTERNAL_ASSERT_OUTPUT(deflateInit2(&stream, level, Z_DEFLATED, -15, 8, strategy) == Z_OK);
+            if(dictionarySize)
+                deflateSetDictionary(&stream, input - dictionarySize, dictionarySize);
+
+            /* The first band has the zlib header in front, the last has
+               space for the Adler-32 checksum after. A sync flush adds at
+               most a few bytes over the deflateBound(). */
+            const std::size_t prefix = b == 0 ? 2 : 0;
+            const std::size_t suffix = b == bandCount - 1 ? 4 : 0;
+            Containers::Array<unsigned char> compressed{Containers::NoInit, prefix + deflateBound(&stream, inputSize) + 16 + suffix};
+            stream.next_in = const_cast<unsigned char*>(input);
+            stream.avail_in = inputSize;
+            stream.next_out = compressed.data() + prefix;
+            stream.avail_out = compressed.size() - prefix - suffix;
+            const Int result = deflate(&stream, suffix ? Z_FINISH : Z_SYNC_FLUSH);
+            CORRADE_INTERNAL_ASSERT(suffix ? result == Z_STREAM_END : (result == Z_OK && stream.avail_out != 0));
+            CORRADE_INTERNAL_ASSERT(stream.avail_in == 0);
+            const std::size_t compressedSize = prefix + stream.total_out + suffix;
+            deflateEnd(&stream);
+
+            adlers[b] = adler32(adler32(0, nullptr, 0), input, inputSize);
+            inputSizes[b] = inputSize;
+
+            /* Shrink to the actual size */
+            out[b] = Containers::Array<unsigned char>{Containers::NoInit, compressedSize};
+            std::memcpy(out[b].data(), compressed.data(), compressedSize - suffix);
+        }
+    };
+
+    Containers::Array<std::thread> threads{Math::min(std::size_t{threadCount}, bandCount) - 1};
+    for(std::thread& thread: threads) thread = std::thread{compressBands};
+    compressBands();
+    for(std::thread& thread: threads) thread.join();
+
+    /* zlib header, with the level hint matching what zlib itself writes */
+    out[0][0] = 0x78;
+    out[0][1] = level == 0 || level == 1 ? 0x01 :
+                level >= 2 && level <= 5 ? 0x5e :
+                level == 6 || level == -1 ? 0x9c : 0xda;
+
+    /* Adler-32 of the whole uncompressed stream, big-endian */
+    uLong adler = adlers[0];
+    for(std::size_t i = 1; i != bandCount; ++i)
+        adler = adler32_combine(adler, adlers[i], inputSizes[i]);
+    Containers::Array<unsigned char>& last = out[bandCount - 1];
+    last[last.size() - 4] = (adler >> 24) & 0xff;
+    last[last.size() - 3] = (adler >> 16) & 0xff;
+    last[last.size() - 2] = (adler >> 8) & 0xff;
+    last[last.size() - 1] = adler & 0xff;
+
+    return out;
+}
+
+}
+
+PngImageConverter::PngImageConverter() {
+    /** @todo horrible workaround, fix this properly */
+    configuration().setValue("yFlip", true);
+}
 
 PngImageConverter::PngImageConverter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImageConverter{manager, plugin} {}
 
@@ -94,6 +293,64 @@ Containers::Array<char> PngImageConverter::doExportToData(const ImageView2D& ima
             return nullptr;
     }
 
+    /* Compression parameters */
+    const Int level = configuration().value<Int>("compressionLevel");
+    if(level < 0 || level > 9) {
+        Error{} << "Trade::PngImageConverter::exportToData(): compression level" << level << "out of range";
+        return nullptr;
+    }
+
+    /* -1 means adaptive choice for each row */
+    const std::string filterName = configuration().value("filter");
+    Int filter;
+    Int libpngFilters;
+    if(filterName == "none") {
+        filter = FilterNone;
+        libpngFilters = PNG_FILTER_NONE;
+    } else if(filterName == "sub") {
+        filter = FilterSub;
+        libpngFilters = PNG_FILTER_SUB;
+    } else if(filterName == "up") {
+        filter = FilterUp;
+        libpngFilters = PNG_FILTER_UP;
+    } else if(filterName == "average") {
+        filter = FilterAverage;
+        libpngFilters = PNG_FILTER_AVG;
+    } else if(filterName == "paeth") {
+        filter = FilterPaeth;
+        libpngFilters = PNG_FILTER_PAETH;
+    } else if(filterName == "all") {
+        filter = -1;
+        libpngFilters = PNG_ALL_FILTERS;
+    } else {
+        Error{} << "Trade::PngImageConverter::exportToData(): unknown filter" << filterName;
+        return nullptr;
+    }
+
+    /* If not set, use the same choice as libpng does */
+    const std::string strategyName = configuration().value("strategy");
+    Int strategy;
+    if(strategyName.empty())
+        strategy = filter == FilterNone ? Z_DEFAULT_STRATEGY : Z_FILTERED;
+    else if(strategyName == "default")
+        strategy = Z_DEFAULT_STRATEGY;
+    else if(strategyName == "filtered")
+        strategy = Z_FILTERED;
+    else if(strategyName == "huffmanOnly")
+        strategy = Z_HUFFMAN_ONLY;
+    else if(strategyName == "rle")
+        strategy = Z_RLE;
+    else if(strategyName == "fixed")
+        strategy = Z_FIXED;
+    else {
+        Error{} << "Trade::PngImageConverter::exportToData(): unknown strategy" << strategyName;
+        return nullptr;
+    }
+
+    UnsignedInt threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount) threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    const bool yFlip = configuration().value<bool>("yFlip");
+
     png_structp file = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
     CORRADE_INTERNAL_ASSERT(file);
     png_infop info = png_create_info_struct(file);
@@ -125,6 +382,9 @@ Containers::Array<char> PngImageConverter::doExportToData(const ImageView2D& ima
     png_set_IHDR(file, info, image.size().x(), image.size().y(),
         bitDepth, colorType, PNG_INTERLACE_NONE,
         PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE);
+    png_set_compression_level(file, level);
+    png_set_compression_strategy(file, strategy);
+    png_set_filter(file, PNG_FILTER_TYPE_BASE, libpngFilters);
     png_write_info(file, info);
 
     /* Get data properties and calculate the initial slice based on subimage
@@ -133,10 +393,28 @@ Containers::Array<char> PngImageConverter::doExportToData(const ImageView2D& ima
     auto data = Containers::arrayCast<const unsigned char>(image.data())
         .suffix(dataProperties.first.sum());
 
-    /* Write rows in reverse order, properly take stride into account */
-    if(bitDepth == 8) {
+    /* Filter and compress the data ourselves in parallel and write the
+       resulting IDAT chunks directly. As libpng doesn't know about the IDAT
+       chunks written this way, png_write_end() would fail, so IEND is
+       written directly as well. */
+    if(threadCount != 1) {
+        const std::size_t rowSize = image.size().x()*image.pixelSize();
+        /* For 16 bit depth we need to swap to big endian */
+        #ifndef CORRADE_TARGET_BIG_ENDIAN
+        const bool swap16 = bitDepth == 16;
+        #else
+        const bool swap16 = false;
+        #endif
+        const Containers::Array<Containers::Array<unsigned char>> chunks = compressParallel(data, dataProperties.second.x(), image.size(), rowSize, image.pixelSize(), swap16, yFlip, filter, level, strategy, threadCount);
+        for(const Containers::Array<unsigned char>& chunk: chunks)
+            png_write_chunk(file, const_cast<png_bytep>(reinterpret_cast<const unsigned char*>("IDAT")), const_cast<png_bytep>(chunk.data()), chunk.size());
+        png_write_chunk(file, const_cast<png_bytep>(reinterpret_cast<const unsigned char*>("IEND")), nullptr, 0);
+
+    /* Write rows in reverse order (unless the flip is disabled), properly
+       take stride into account */
+    } else if(bitDepth == 8) {
         for(Int y = 0; y != image.size().y(); ++y)
-            png_write_row(file, const_cast<unsigned char*>(data.suffix((image.size().y() - y - 1)*dataProperties.second.x()).data()));
+            png_write_row(file, const_cast<unsigned char*>(data.suffix((yFlip ? image.size().y() - y - 1 : y)*dataProperties.second.x()).data()));
 
     /* For 16 bit depth we need to swap to big endian */
     } else if(bitDepth == 16) {
@@ -144,11 +422,11 @@ Containers::Array<char> PngImageConverter::doExportToData(const ImageView2D& ima
         png_set_swap(file);
         #endif
         for(Int y = 0; y != image.size().y(); ++y) {
-            png_write_row(file, const_cast<unsigned char*>(reinterpret_cast<const unsigned char*>(data.suffix((image.size().y() - y - 1)*dataProperties.second.x()).data())));
+            png_write_row(file, const_cast<unsigned char*>(reinterpret_cast<const unsigned char*>(data.suffix((yFlip ? image.size().y() - y - 1 : y)*dataProperties.second.x()).data())));
         }
     }
 
-    png_write_end(file, nullptr);
+    if(threadCount == 1) png_write_end(file, nullptr);
     png_destroy_write_struct(&file, &info);
 
     /* Copy the string into the output array (I would kill for having std::string::release()) */
@@ -104,6 +104,36 @@ target_link_libraries(your-app PRIVATE MagnumPlugins::PngImageConverter)
 
 See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
 information.
+
+@section Trade-PngImageConverter-behavior Behavior and limitations
+
+The zlib compression level, the row filter and the compression strategy can
+be set through @ref Trade-PngImageConverter-configuration "configuration options".
+By default the filter is picked for each row separately, same as libPNG does.
+
+If the @cb{.ini} threads @ce option is set to a value other than @cpp 1 @ce,
+the rows are filtered and compressed by the plugin itself, split into bands of
+roughly 256 kB of filtered data where each band is compressed on one thread
+and written to a separate `IDAT` chunk. Each band is compressed with the end
+of the preceding band as a dictionary, so the compression ratio is only
+slightly worse than when compressing the whole image at once. The band size
+doesn't depend on the thread count, so the output is the same for any value
+other than @cpp 1 @ce. In that case the application needs to link to
+`pthread` on Linux due to the same reasons as described in
+@ref Trade-BasisImageConverter-loading "BasisImageConverter docs".
+
+The image is expected to have the origin at the bottom left and its rows are
+written in reverse order. Images that are already top-down, such as ones
+imported with the @cb{.ini} yFlip @ce option of @ref PngImporter disabled,
+can be exported as-is by disabling the @cb{.ini} yFlip @ce
+@ref Trade-PngImageConverter-configuration "configuration option" as well.
+
+@section Trade-PngImageConverter-configuration Plugin-specific config
+
+It's possible to tune various output options through @ref configuration().
+See below for all options and their default values:
+
+@snippet MagnumPlugins/PngImageConverter/PngImageConverter.conf config
 */
 class MAGNUM_PNGIMAGECONVERTER_EXPORT PngImageConverter: public AbstractImageConverter {
     public:
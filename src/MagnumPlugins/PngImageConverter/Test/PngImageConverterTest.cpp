@@ -27,6 +27,7 @@
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
@@ -38,6 +39,33 @@
 
 namespace Magnum { namespace Trade { namespace Test { namespace {
 
+constexpr struct {
+    const char* name;
+    Int compressionLevel;
+    const char* filter;
+    const char* strategy;
+    UnsignedInt threads;
+} CompressionOptionsData[]{
+    {"no compression", 0, "none", "", 1},
+    {"best compression", 9, "all", "", 1},
+    {"sub filter, RLE", 6, "sub", "rle", 1},
+    {"up filter, Huffman only", 6, "up", "huffmanOnly", 1},
+    {"average filter, fixed", 1, "average", "fixed", 1},
+    {"Paeth filter, default", 6, "paeth", "default", 1},
+    {"two threads", 6, "all", "", 2},
+    {"two threads, no compression", 0, "none", "", 2},
+    {"two threads, Paeth filter, filtered", 9, "paeth", "filtered", 2},
+    {"all cores, average filter", 6, "average", "", 0}
+};
+
+constexpr struct {
+    const char* name;
+    UnsignedInt threads;
+} NoYFlipData[]{
+    {"", 1},
+    {"two threads", 2}
+};
+
 struct PngImageConverterTest: TestSuite::Tester {
     explicit PngImageConverterTest();
 
@@ -50,6 +78,13 @@ struct PngImageConverterTest: TestSuite::Tester {
     void grayscale();
     void grayscale16();
 
+    void invalidCompressionLevel();
+    void unknownFilter();
+    void unknownStrategy();
+    void compressionOptions();
+    void parallel();
+    void noYFlip();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImageConverter> _converterManager{"nonexistent"};
     PluginManager::Manager<AbstractImporter> _importerManager{"nonexistent"};
@@ -63,7 +98,19 @@ PngImageConverterTest::PngImageConverterTest() {
               &PngImageConverterTest::rgb16,
 
               &PngImageConverterTest::grayscale,
-              &PngImageConverterTest::grayscale16});
+              &PngImageConverterTest::grayscale16,
+
+              &PngImageConverterTest::invalidCompressionLevel,
+              &PngImageConverterTest::unknownFilter,
+              &PngImageConverterTest::unknownStrategy});
+
+    addInstancedTests({&PngImageConverterTest::compressionOptions},
+        Containers::arraySize(CompressionOptionsData));
+
+    addTests({&PngImageConverterTest::parallel});
+
+    addInstancedTests({&PngImageConverterTest::noYFlip},
+        Containers::arraySize(NoYFlipData));
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
@@ -261,6 +308,134 @@ void PngImageConverterTest::grayscale16() {
         TestSuite::Compare::Container);
 }
 
+void PngImageConverterTest::invalidCompressionLevel() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("PngImageConverter");
+    converter->configuration().setValue("compressionLevel", 10);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->exportToData(OriginalRgb));
+    CORRADE_COMPARE(out.str(), "Trade::PngImageConverter::exportToData(): compression level 10 out of range\n");
+}
+
+void PngImageConverterTest::unknownFilter() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("PngImageConverter");
+    converter->configuration().setValue("filter", "median");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->exportToData(OriginalRgb));
+    CORRADE_COMPARE(out.str(), "Trade::PngImageConverter::exportToData(): unknown filter median\n");
+}
+
+void PngImageConverterTest::unknownStrategy() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("PngImageConverter");
+    converter->configuration().setValue("strategy", "lz4");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->exportToData(OriginalRgb));
+    CORRADE_COMPARE(out.str(), "Trade::PngImageConverter::exportToData(): unknown strategy lz4\n");
+}
+
+void PngImageConverterTest::compressionOptions() {
+    auto&& data = CompressionOptionsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("PngImageConverter");
+    converter->configuration().setValue("compressionLevel", data.compressionLevel);
+    converter->configuration().setValue("filter", data.filter);
+    converter->configuration().setValue("strategy", data.strategy);
+    converter->configuration().setValue("threads", data.threads);
+
+    /* Using the 16-bit image to verify the endian swap in the parallel
+       code path as well */
+    const auto exported = converter->exportToData(OriginalRgb16);
+    CORRADE_VERIFY(exported);
+
+    if(_importerManager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("PngImporter");
+    CORRADE_VERIFY(importer->openData(exported));
+    Containers::Optional<Trade::ImageData2D> converted = importer->image2D(0);
+    CORRADE_VERIFY(converted);
+
+    CORRADE_COMPARE(converted->size(), Vector2i(2, 3));
+    CORRADE_COMPARE(converted->format(), PixelFormat::RGB16Unorm);
+    CORRADE_COMPARE_AS(Containers::arrayCast<const UnsignedShort>(converted->data()),
+        Containers::arrayView(ConvertedRgbData16),
+        TestSuite::Compare::Container);
+}
+
+void PngImageConverterTest::parallel() {
+    /* 512x512 RGBA is 1 MB of data, which gets split into four bands. Fill
+       it with a pattern that isn't too trivial to compress and where a
+       wrongly filtered row would be visible. */
+    Containers::Array<char> original{Containers::NoInit, 512*512*4};
+    for(std::size_t i = 0; i != original.size(); ++i)
+        original[i] = char((i*i >> 7) ^ (i >> 11));
+    const ImageView2D image{PixelFormat::RGBA8Unorm, {512, 512}, original};
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("PngImageConverter");
+    converter->configuration().setValue("threads", 2);
+    const auto exported = converter->exportToData(image);
+    CORRADE_VERIFY(exported);
+
+    /* The output should be the same regardless of the thread count */
+    converter->configuration().setValue("threads", 4);
+    const auto exported4 = converter->exportToData(image);
+    CORRADE_VERIFY(exported4);
+    CORRADE_COMPARE_AS(exported4, exported,
+        TestSuite::Compare::Container);
+
+    if(_importerManager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("PngImporter");
+    CORRADE_VERIFY(importer->openData(exported));
+    Containers::Optional<Trade::ImageData2D> converted = importer->image2D(0);
+    CORRADE_VERIFY(converted);
+
+    CORRADE_COMPARE(converted->size(), Vector2i(512, 512));
+    CORRADE_COMPARE(converted->format(), PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE_AS(converted->data(), original,
+        TestSuite::Compare::Container);
+}
+
+void PngImageConverterTest::noYFlip() {
+    auto&& data = NoYFlipData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("PngImageConverter");
+    converter->configuration().setValue("yFlip", false);
+    converter->configuration().setValue("threads", data.threads);
+    const auto exported = converter->exportToData(OriginalRgb);
+    CORRADE_VERIFY(exported);
+
+    if(_importerManager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test");
+
+    /* Imported with the default flip, so the rows are now reversed */
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("PngImporter");
+    CORRADE_VERIFY(importer->openData(exported));
+    Containers::Optional<Trade::ImageData2D> converted = importer->image2D(0);
+    CORRADE_VERIFY(converted);
+    CORRADE_COMPARE(converted->size(), Vector2i(2, 3));
+    CORRADE_COMPARE(converted->format(), PixelFormat::RGB8Unorm);
+
+    CORRADE_COMPARE(converted->mutableData().size(), 24);
+    converted->mutableData()[6] = converted->mutableData()[7] =
+        converted->mutableData()[14] = converted->mutableData()[15] =
+            converted->mutableData()[22] = converted->mutableData()[23] = 0;
+
+    CORRADE_COMPARE_AS(converted->data(), Containers::arrayView<char>({
+        5, 6, 7, 6, 7, 8, 0, 0,
+        3, 4, 5, 4, 5, 6, 0, 0,
+        1, 2, 3, 2, 3, 4, 0, 0
+    }), TestSuite::Compare::Container);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::PngImageConverterTest)
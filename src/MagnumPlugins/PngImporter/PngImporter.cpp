@@ -27,6 +27,8 @@
 
 #include <cstring>
 #include <algorithm>
+#include <atomic>
+#include <thread>
 #include <png.h>
 /*
     The <csetjmp> header has to be included *after* png.h, otherwise older
@@ -40,52 +42,73 @@
 #include <csetjmp>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/ScopeGuard.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
+#include <Corrade/Utility/DebugStl.h>
+#include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Math/Functions.h>
 #include <Magnum/Trade/ImageData.h>
 
-namespace Magnum { namespace Trade {
-
-PngImporter::PngImporter() = default;
+#include "MagnumPlugins/Implementation/importerInput.h"
 
-PngImporter::PngImporter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImporter{manager, plugin} {}
-
-PngImporter::~PngImporter() = default;
-
-ImporterFeatures PngImporter::doFeatures() const { return ImporterFeature::OpenData; }
+namespace Magnum { namespace Trade {
 
-bool PngImporter::doIsOpened() const { return _in; }
+struct PngImporter::State: Implementation::ImporterInput {};
 
-void PngImporter::doClose() { _in = nullptr; }
+namespace {
 
-void PngImporter::doOpenData(const Containers::ArrayView<const char> data) {
-    /* Because here we're copying the data and using the _in to check if file
-       is opened, having them nullptr would mean openData() would fail without
-       any error message. It's not possible to do this check on the importer
-       side, because empty file is valid in some formats (OBJ or glTF). We also
-       can't do the full import here because then doImage2D() would need to
-       copy the imported data instead anyway (and the uncompressed size is much
-       larger). This way it'll also work nicely with a future openMemory(). */
-    if(data.empty()) {
-        Error{} << "Trade::PngImporter::openData(): the file is empty";
-        return;
+/* Expands palette indices of one row to RGB or RGBA pixels using a lookup
+   table with four bytes per entry. Indices with less than 8 bits are packed
+   with the leftmost pixel in the high-order bits. It's a single pass over the
+   row writing directly to the output, compared to the palette and tRNS
+   transforms in libpng that each go over the row again, followed by a copy
+   to the output. */
+template<std::size_t channels> void expandPaletteRow(const UnsignedByte* const in, char* const out, const std::size_t width, const UnsignedInt bits, const UnsignedByte(&palette)[256][4]) {
+    if(bits == 8) {
+        for(std::size_t i = 0; i != width; ++i)
+            std::memcpy(out + i*channels, palette[in[i]], channels);
+    } else {
+        const UnsignedInt indicesPerByte = 8/bits;
+        const UnsignedInt mask = (1 << bits) - 1;
+        for(std::size_t i = 0; i != width; ++i) {
+            const UnsignedInt shift = 8 - bits*(i%indicesPerByte + 1);
+            std::memcpy(out + i*channels, palette[(in[i/indicesPerByte] >> shift) & mask], channels);
+        }
     }
-
-    _in = Containers::Array<unsigned char>(data.size());
-    std::copy(data.begin(), data.end(), _in.begin());
 }
 
-UnsignedInt PngImporter::doImage2DCount() const { return 1; }
-
-Containers::Optional<ImageData2D> PngImporter::doImage2D(UnsignedInt, UnsignedInt) {
+/* Converts big-endian 16-bit values to little-endian in place. The row is
+   still in cache after being decoded into the output, and since there are no
+   dependencies between iterations, compilers turn the loop into vector
+   shuffles, unlike the byte-by-byte swap done in libpng. The memcpy()s get
+   optimized away, they're there only to avoid unaligned and type-punned
+   access. */
+#ifndef CORRADE_TARGET_BIG_ENDIAN
+void swapRow16(char* const data, const std::size_t count) {
+    for(std::size_t i = 0; i != count; ++i) {
+        UnsignedShort value;
+        std::memcpy(&value, data + i*2, 2);
+        value = UnsignedShort(value >> 8)|UnsignedShort(value << 8);
+        std::memcpy(data + i*2, &value, 2);
+    }
+}
+#endif
+
+/* Decodes the PNG in `in`. Once the header is parsed, `destination` is called
+   with the image properties and is expected to fill a view the image gets
+   decoded into and its row pitch. If it leaves the view null, decoding stops
+   right after the header. If it returns false or libpng fails, returns false,
+   with a message prefixed with `messagePrefix` printed. If `yFlip` is set,
+   the rows are written to the destination bottom-up. */
+template<class F> bool decode(const Containers::ArrayView<const char> in, const bool checksums, const bool yFlip, const char* const messagePrefix, F&& destination) {
     CORRADE_ASSERT(std::strcmp(PNG_LIBPNG_VER_STRING, png_libpng_ver) == 0,
-        "Trade::PngImporter::image2D(): libpng version mismatch, got" << png_libpng_ver << "but expected" << PNG_LIBPNG_VER_STRING, Containers::NullOpt);
+        messagePrefix << "libpng version mismatch, got" << png_libpng_ver << "but expected" << PNG_LIBPNG_VER_STRING, false);
 
     /* Verify file signature */
-    if(png_sig_cmp(_in, 0, Math::min(std::size_t(8), _in.size())) != 0) {
-        Error() << "Trade::PngImporter::image2D(): wrong file signature";
-        return Containers::NullOpt;
+    if(png_sig_cmp(reinterpret_cast<png_bytep>(const_cast<char*>(in.data())), 0, Math::min(std::size_t(8), in.size())) != 0) {
+        Error() << messagePrefix << "wrong file signature";
+        return false;
     }
 
     /* Structures for reading the file */
@@ -101,38 +124,56 @@ Containers::Optional<ImageData2D> PngImporter::doImage2D(UnsignedInt, UnsignedIn
     Containers::ScopeGuard pngStateGuard{&pngState, [](PngState* state) {
         png_destroy_read_struct(&state->file, &state->info, nullptr);
     }};
-    Containers::Array<png_bytep> rows;
-    Containers::Array<char> data;
 
     /* Error handling routine. Since we're replacing the png_default_error()
        function, we need to call std::longjmp() ourselves -- otherwise the
-       default error handling with stderr printing kicks in. */
-    if(setjmp(png_jmpbuf(file))) return Containers::NullOpt;
-    png_set_error_fn(file, nullptr, [](const png_structp file, const png_const_charp message) {
-        Error{} << "Trade::PngImporter::image2D(): error:" << message;
+       default error handling with stderr printing kicks in. The message
+       prefix is passed through the error pointer. */
+    if(setjmp(png_jmpbuf(file))) return false;
+    png_set_error_fn(file, const_cast<char*>(messagePrefix), [](const png_structp file, const png_const_charp message) {
+        Error{} << static_cast<const char*>(png_get_error_ptr(file)) << "error:" << message;
         std::longjmp(png_jmpbuf(file), 1);
-    }, [](png_structp, const png_const_charp message) {
-        Warning{} << "Trade::PngImporter::image2D(): warning:" << message;
+    }, [](png_structp file, const png_const_charp message) {
+        Warning{} << static_cast<const char*>(png_get_error_ptr(file)) << "warning:" << message;
     });
 
     /* Input starts right after the header */
-    if(_in.size() < 8) {
-        Error{} << "Trade::PngImporter::image2D(): signature too short";
-        return Containers::NullOpt;
+    if(in.size() < 8) {
+        Error{} << messagePrefix << "signature too short";
+        return false;
     }
-    Containers::ArrayView<unsigned char> input = _in.suffix(8);
+    Containers::ArrayView<const char> input = in.suffix(8);
 
-    /* Set functions for reading */
+    /* Set functions for reading. The input is referenced directly, libpng
+       needs the data copied into its own buffers so this is the only copy
+       of the input that's done. */
     png_set_read_fn(file, &input, [](const png_structp file, const png_bytep data, const png_size_t length) {
-        auto&& input = *reinterpret_cast<Containers::ArrayView<unsigned char>*>(png_get_io_ptr(file));
+        auto&& input = *reinterpret_cast<Containers::ArrayView<const char>*>(png_get_io_ptr(file));
         if(input.size() < length) png_error(file, "file too short");
-        std::copy_n(input.begin(), length, data);
+        std::memcpy(data, input.data(), length);
         input = input.suffix(length);
     });
 
     /* The signature is already read */
     png_set_sig_bytes(file, 8);
 
+    /* The whole input is in memory, so let libpng pass the compressed data to
+       zlib in larger pieces than the default 8 kB to reduce the per-call
+       overhead. It's bounded by IDAT chunk sizes anyway, the upper limit is
+       only to avoid a large temporary allocation for huge single-chunk
+       files. */
+    png_set_compression_buffer_size(file, Math::max(Math::min(input.size(), std::size_t{1024*1024}), std::size_t{1}));
+
+    /* Skip verification of chunk CRCs and zlib Adler-32 checksums if
+       requested. The CRC check is done by libpng itself, Adler-32 by zlib
+       during inflate. Ignoring Adler-32 is available since libpng 1.6.26. */
+    if(!checksums) {
+        png_set_crc_action(file, PNG_CRC_QUIET_USE, PNG_CRC_QUIET_USE);
+        #if defined(PNG_IGNORE_ADLER32) && defined(PNG_SET_OPTION_SUPPORTED)
+        png_set_option(file, PNG_IGNORE_ADLER32, PNG_OPTION_ON);
+        #endif
+    }
+
     /* Read file information */
     png_read_info(file, info);
 
@@ -144,6 +185,13 @@ Containers::Optional<ImageData2D> PngImporter::doImage2D(UnsignedInt, UnsignedIn
     png_uint_32 channels = png_get_channels(file, info);
     png_uint_32 colorType = png_get_color_type(file, info);
 
+    /* Palettes and 16-bit endian swap of non-interlaced images are handled
+       directly in the row loop below instead of through libpng transforms.
+       With interlaced images each row is filled in multiple passes, so those
+       are left to libpng. */
+    const bool interlaced = png_get_interlace_type(file, info) != PNG_INTERLACE_NONE;
+    const png_uint_32 paletteBits = colorType == PNG_COLOR_TYPE_PALETTE && !interlaced ? bits : 0;
+
     /* Check image format, convert if necessary */
     switch(colorType) {
         /* Types that can be used without conversion */
@@ -168,7 +216,7 @@ Containers::Optional<ImageData2D> PngImporter::doImage2D(UnsignedInt, UnsignedIn
 
         /* Palette needs to be converted */
         case PNG_COLOR_TYPE_PALETTE:
-            png_set_palette_to_rgb(file);
+            if(!paletteBits) png_set_palette_to_rgb(file);
             /* png_get_bit_depth(file, info); would return the original value
                here (which can be < 8), expecting the png_set_*() function to
                give back 8-bit channels */
@@ -178,13 +226,13 @@ Containers::Optional<ImageData2D> PngImporter::doImage2D(UnsignedInt, UnsignedIn
             break;
 
         default:
-            Error() << "Trade::PngImporter::image2D(): unsupported color type" << colorType;
-            return Containers::NullOpt;
+            Error() << messagePrefix << "unsupported color type" << colorType;
+            return false;
     }
 
     /* Convert transparency mask to alpha */
     if(png_get_valid(file, info, PNG_INFO_tRNS)) {
-        png_set_tRNS_to_alpha(file);
+        if(!paletteBits) png_set_tRNS_to_alpha(file);
         channels += 1;
         CORRADE_INTERNAL_ASSERT_OUTPUT(channels == 4);
         colorType = PNG_COLOR_TYPE_RGBA;
@@ -194,22 +242,6 @@ Containers::Optional<ImageData2D> PngImporter::doImage2D(UnsignedInt, UnsignedIn
         bits = 8;
     }
 
-    /* Initialize data array, align rows to four bytes */
-    CORRADE_INTERNAL_ASSERT(bits >= 8);
-    const std::size_t stride = ((size.x()*channels*bits/8 + 3)/4)*4;
-    data = Containers::Array<char>{stride*std::size_t(size.y())};
-
-    /* Endianness correction for 16 bit depth */
-    #ifndef CORRADE_TARGET_BIG_ENDIAN
-    if(bits == 16) png_set_swap(file);
-    #endif
-
-    /* Read image row by row */
-    rows = Containers::Array<png_bytep>{std::size_t(size.y())};
-    for(Int i = 0; i != size.y(); ++i)
-        rows[i] = reinterpret_cast<unsigned char*>(data.data()) + (size.y() - i - 1)*stride;
-    png_read_image(file, rows);
-
     /* 8-bit images */
     PixelFormat format;
     if(bits == 8) {
@@ -233,10 +265,289 @@ Containers::Optional<ImageData2D> PngImporter::doImage2D(UnsignedInt, UnsignedIn
        Only 1, 2, 4, 8 or 16 bits per channel, we expand the 1/2/4 to 8 above */
     } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
 
+    /* Ask for the output memory. If none is given, only the image properties
+       were needed. */
+    Containers::ArrayView<char> out;
+    std::size_t rowPitch = 0;
+    if(!destination(PngImporterImageInfo{size, format}, out, rowPitch))
+        return false;
+    if(!out) return true;
+    CORRADE_INTERNAL_ASSERT(out.size() >= rowPitch*std::size_t(size.y()));
+
+    /* Endianness correction for 16 bit depth. Non-interlaced images get
+       swapped in the row loop below. */
+    #ifndef CORRADE_TARGET_BIG_ENDIAN
+    const bool swap16 = bits == 16 && !interlaced;
+    if(bits == 16 && interlaced) png_set_swap(file);
+    #endif
+
+    /* Palette images are decoded into a temporary row with the raw indices
+       and expanded from there. Entries that are not in the file are black
+       and entries without a tRNS value opaque, same as in libpng. */
+    Containers::Array<UnsignedByte> paletteRow;
+    UnsignedByte palette[256][4];
+    if(paletteBits) {
+        png_colorp colors;
+        int colorCount = 0;
+        png_get_PLTE(file, info, &colors, &colorCount);
+        png_bytep alphas = nullptr;
+        int alphaCount = 0;
+        if(channels == 4) png_get_tRNS(file, info, &alphas, &alphaCount, nullptr);
+        for(int i = 0; i != 256; ++i) {
+            palette[i][0] = i < colorCount ? colors[i].red : 0;
+            palette[i][1] = i < colorCount ? colors[i].green : 0;
+            palette[i][2] = i < colorCount ? colors[i].blue : 0;
+            palette[i][3] = i < alphaCount ? alphas[i] : 0xff;
+        }
+
+        paletteRow = Containers::Array<UnsignedByte>{Containers::NoInit, png_get_rowbytes(file, info)};
+    }
+
+    /* Read the image row by row directly into the output, bottom-up unless
+       the Y-flip is disabled. This is what png_read_image() does internally,
+       but without having to allocate an array of row pointers, and so the
+       flip costs nothing either way. Interlaced images need more passes over
+       all rows. */
+    const int passCount = png_set_interlace_handling(file);
+    for(int pass = 0; pass != passCount; ++pass) {
+        for(Int i = 0; i != size.y(); ++i) {
+            char* const row = out.data() + (yFlip ? size.y() - i - 1 : i)*rowPitch;
+            if(paletteBits) {
+                png_read_row(file, paletteRow.data(), nullptr);
+                if(channels == 4)
+                    expandPaletteRow<4>(paletteRow, row, size.x(), paletteBits, palette);
+                else
+                    expandPaletteRow<3>(paletteRow, row, size.x(), paletteBits, palette);
+                continue;
+            }
+
+            png_read_row(file, reinterpret_cast<png_bytep>(row), nullptr);
+            #ifndef CORRADE_TARGET_BIG_ENDIAN
+            if(swap16) swapRow16(row, size.x()*channels);
+            #endif
+        }
+    }
+
+    return true;
+}
+
+/* Row pitch of the images returned from image2D(), rows aligned to four
+   bytes */
+std::size_t defaultRowPitch(const PngImporterImageInfo& info) {
+    return ((info.size.x()*pixelSize(info.format) + 3)/4)*4;
+}
+
+inline UnsignedInt readBigEndian(const char* data) {
+    const auto* d = reinterpret_cast<const unsigned char*>(data);
+    return UnsignedInt(d[0]) << 24 | UnsignedInt(d[1]) << 16 | UnsignedInt(d[2]) << 8 | UnsignedInt(d[3]);
+}
+
+/* Determines image size and format from the IHDR chunk and presence of a tRNS
+   chunk without involving libpng, mirroring the conversions done in
+   decode(). Used to lay out batch output upfront. Returns false if the file
+   is invalid or unsupported, decode() then prints the actual error. */
+bool scanHeader(const Containers::ArrayView<const char> in, PngImporterImageInfo& info) {
+    /* Signature, IHDR length + type, width, height, bit depth, color type */
+    if(in.size() < 8 + 8 + 10 || std::memcmp(in.data() + 12, "IHDR", 4) != 0)
+        return false;
+
+    info.size = {Int(readBigEndian(in.data() + 16)), Int(readBigEndian(in.data() + 20))};
+    const UnsignedInt bits = UnsignedByte(in[24]);
+    const UnsignedInt colorType = UnsignedByte(in[25]);
+
+    /* The tRNS chunk, if present, is before the first IDAT */
+    bool hasTrns = false;
+    for(std::size_t offset = 8; offset + 8 <= in.size(); ) {
+        const char* type = in.data() + offset + 4;
+        if(std::memcmp(type, "IDAT", 4) == 0 || std::memcmp(type, "IEND", 4) == 0) break;
+        if(std::memcmp(type, "tRNS", 4) == 0) {
+            hasTrns = true;
+            break;
+        }
+        /* Length, type, data, CRC */
+        offset += 12 + std::size_t(readBigEndian(in.data() + offset));
+    }
+
+    switch(colorType) {
+        case PNG_COLOR_TYPE_GRAY:
+            if(hasTrns) return false;
+            info.format = bits == 16 ? PixelFormat::R16Unorm : PixelFormat::R8Unorm;
+            return true;
+        case PNG_COLOR_TYPE_RGB:
+            info.format = hasTrns ? PixelFormat::RGBA8Unorm :
+                bits == 16 ? PixelFormat::RGB16Unorm : PixelFormat::RGB8Unorm;
+            return true;
+        case PNG_COLOR_TYPE_PALETTE:
+            info.format = hasTrns ? PixelFormat::RGBA8Unorm : PixelFormat::RGB8Unorm;
+            return true;
+        case PNG_COLOR_TYPE_RGBA:
+            info.format = bits == 16 ? PixelFormat::RGBA16Unorm : PixelFormat::RGBA8Unorm;
+            return true;
+    }
+
+    return false;
+}
+
+}
+
+PngImporter::PngImporter(): _state{new State} {
+    /** @todo horrible workaround, fix this properly */
+    configuration().setValue("yFlip", true);
+}
+
+PngImporter::PngImporter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImporter{manager, plugin}, _state{new State} {}
+
+PngImporter::~PngImporter() = default;
+
+ImporterFeatures PngImporter::doFeatures() const { return ImporterFeature::OpenData; }
+
+bool PngImporter::doIsOpened() const { return !!_state->in; }
+
+void PngImporter::doClose() { _state->close(); }
+
+bool PngImporter::checkData(const Containers::ArrayView<const char> data, const char* const messagePrefix) {
+    /* Because here we're using the `in` view to check if file is opened,
+       having it nullptr would mean openData() would fail without any error
+       message. It's not possible to do this check on the importer side,
+       because empty file is valid in some formats (OBJ or glTF). We also
+       can't do the full import here because then doImage2D() would need to
+       copy the imported data instead anyway (and the uncompressed size is
+       much larger). */
+    if(data.empty()) {
+        Error{} << messagePrefix << "the file is empty";
+        return false;
+    }
+
+    return true;
+}
+
+void PngImporter::doOpenFile(const std::string& filename) {
+    /* Map the file instead of reading it to avoid having the whole file
+       copied in memory */
+    if(!_state->openFile(filename, "Trade::PngImporter::openFile():")) return;
+    if(!checkData(_state->in, "Trade::PngImporter::openFile():"))
+        _state->close();
+}
+
+void PngImporter::doOpenData(const Containers::ArrayView<const char> data) {
+    if(!checkData(data, "Trade::PngImporter::openData():")) return;
+    _state->openData(data);
+}
+
+bool PngImporter::openMemory(const Containers::ArrayView<const char> data) {
+    close();
+    if(!checkData(data, "Trade::PngImporter::openMemory():")) return false;
+    _state->openMemory(data);
+    return true;
+}
+
+UnsignedInt PngImporter::doImage2DCount() const { return 1; }
+
+Containers::Optional<ImageData2D> PngImporter::doImage2D(UnsignedInt, UnsignedInt) {
+    Containers::Array<char> data;
+    PixelFormat format{};
+    Vector2i size;
+    if(!decode(_state->in, configuration().value<bool>("checksums"), configuration().value<bool>("yFlip"), "Trade::PngImporter::image2D():", [&](const PngImporterImageInfo& info, Containers::ArrayView<char>& out, std::size_t& rowPitch) {
+        format = info.format;
+        size = info.size;
+        rowPitch = defaultRowPitch(info);
+        data = Containers::Array<char>{Containers::NoInit, rowPitch*std::size_t(info.size.y())};
+        out = data;
+        return true;
+    })) return Containers::NullOpt;
+
     /* Always using the default 4-byte alignment */
     return Trade::ImageData2D{format, size, std::move(data)};
 }
 
+Containers::Optional<PngImporterImageInfo> PngImporter::image2DInfo() {
+    CORRADE_ASSERT(isOpened(), "Trade::PngImporter::image2DInfo(): no file opened", {});
+
+    Containers::Optional<PngImporterImageInfo> out;
+    if(!decode(_state->in, configuration().value<bool>("checksums"), configuration().value<bool>("yFlip"), "Trade::PngImporter::image2DInfo():", [&](const PngImporterImageInfo& info, Containers::ArrayView<char>&, std::size_t&) {
+        out = info;
+        return true;
+    })) return Containers::NullOpt;
+
+    return out;
+}
+
+PngImporterBatch PngImporter::decodeBatch(const Containers::ArrayView<const Containers::ArrayView<const char>> files) {
+    /* Lay out all images in a single allocation upfront, each with the same
+       four-byte-aligned rows as image2D() returns. Images that can't be
+       decoded get no space. Unlike the decoding, this doesn't need to
+       involve libpng at all. */
+    Containers::Array<PngImporterImageInfo> infos{Containers::NoInit, files.size()};
+    Containers::Array<std::size_t> offsets{Containers::NoInit, files.size() + 1};
+    Containers::Array<bool> valid{Containers::ValueInit, files.size()};
+    offsets[0] = 0;
+    for(std::size_t i = 0; i != files.size(); ++i) {
+        valid[i] = scanHeader(files[i], infos[i]);
+        offsets[i + 1] = offsets[i] + (valid[i] ?
+            defaultRowPitch(infos[i])*std::size_t(infos[i].size.y()) : 0);
+    }
+
+    PngImporterBatch out;
+    out.data = Containers::Array<char>{Containers::NoInit, offsets[files.size()]};
+    out.images = Containers::Array<Containers::Optional<ImageView2D>>{files.size()};
+
+    /* Each thread takes the next image that's not decoded yet. Every image
+       is decoded into a disjoint part of the output and its Optional is set
+       only by the thread that decoded it, so no locking is needed. Each
+       decode() creates its own libpng state, as libpng has no way to reset
+       and reuse it for another file. */
+    const bool checksums = configuration().value<bool>("checksums");
+    const bool yFlip = configuration().value<bool>("yFlip");
+    std::atomic<std::size_t> next{0};
+    auto decodeImages = [&]() {
+        std::size_t i;
+        while((i = next++) < files.size()) {
+            if(!decode(files[i], checksums, yFlip, "Trade::PngImporter::decodeBatch():", [&](const PngImporterImageInfo& info, Containers::ArrayView<char>& destination, std::size_t& rowPitch) {
+                if(!valid[i] || info.size != infos[i].size || info.format != infos[i].format) {
+                    Error{} << "Trade::PngImporter::decodeBatch(): unexpected properties of image" << i;
+                    return false;
+                }
+
+                rowPitch = defaultRowPitch(info);
+                destination = out.data.slice(offsets[i], offsets[i + 1]);
+                return true;
+            })) continue;
+
+            out.images[i].emplace(infos[i].format, infos[i].size, out.data.slice(offsets[i], offsets[i + 1]));
+        }
+    };
+
+    UnsignedInt threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount) threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    Containers::Array<std::thread> threads{files.empty() ? 0 : std::min(std::size_t{threadCount}, files.size()) - 1};
+    for(std::thread& thread: threads) thread = std::thread{decodeImages};
+    decodeImages();
+    for(std::thread& thread: threads) thread.join();
+
+    return out;
+}
+
+bool PngImporter::image2DInto(const Containers::ArrayView<char> destination, const std::size_t rowPitch) {
+    CORRADE_ASSERT(isOpened(), "Trade::PngImporter::image2DInto(): no file opened", {});
+
+    return decode(_state->in, configuration().value<bool>("checksums"), configuration().value<bool>("yFlip"), "Trade::PngImporter::image2DInto():", [&](const PngImporterImageInfo& info, Containers::ArrayView<char>& out, std::size_t& actualRowPitch) {
+        const std::size_t tightRowPitch = info.size.x()*pixelSize(info.format);
+        actualRowPitch = rowPitch ? rowPitch : defaultRowPitch(info);
+        if(actualRowPitch < tightRowPitch) {
+            Error{} << "Trade::PngImporter::image2DInto(): row pitch" << actualRowPitch << "is smaller than" << tightRowPitch;
+            return false;
+        }
+        const std::size_t size = actualRowPitch*info.size.y();
+        if(destination.size() < size) {
+            Error{} << "Trade::PngImporter::image2DInto(): expected a destination of at least" << size << "bytes but got" << destination.size();
+            return false;
+        }
+
+        out = destination.prefix(size);
+        return true;
+    });
+}
+
 }}
 
 CORRADE_PLUGIN_REGISTER(PngImporter, Magnum::Trade::PngImporter,
@@ -26,10 +26,15 @@
 */
 
 /** @file
- * @brief Class @ref Magnum::Trade::PngImporter
+ * @brief Class @ref Magnum::Trade::PngImporter, struct @ref Magnum::Trade::PngImporterImageInfo, @ref Magnum::Trade::PngImporterBatch
  */
 
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Vector2.h>
 #include <Magnum/Trade/AbstractImporter.h>
 
 #include "MagnumPlugins/PngImporter/configure.h"
@@ -52,6 +57,40 @@
 
 namespace Magnum { namespace Trade {
 
+/**
+@brief PNG image properties
+@m_since_latest_{plugins}
+
+Returned from @ref PngImporter::image2DInfo().
+*/
+struct PngImporterImageInfo {
+    /** @brief Image size */
+    Vector2i size;
+
+    /** @brief Pixel format the image gets decoded to */
+    PixelFormat format;
+};
+
+/**
+@brief PNG batch decoding result
+@m_since_latest_{plugins}
+
+Returned from @ref PngImporter::decodeBatch().
+*/
+struct PngImporterBatch {
+    /** @brief Data of all decoded images */
+    Containers::Array<char> data;
+
+    /**
+     * @brief Decoded images
+     *
+     * Views into @ref data, in the same order as the files passed to
+     * @ref PngImporter::decodeBatch(). Images that failed to decode are
+     * @ref Containers::NullOpt.
+     */
+    Containers::Array<Containers::Optional<ImageView2D>> images;
+};
+
 /**
 @brief PNG importer plugin
 
@@ -111,6 +150,49 @@ The images are imported with @ref PixelFormat::RGB8Unorm /
 @ref PixelFormat::R16Unorm. All imported images use default @ref PixelStorage
 parameters.
 
+Files passed to @ref openFile() are memory-mapped on platforms that support
+it, data passed to @ref openData() are copied. If the data are already in
+memory for the whole lifetime of the importer, they can be passed to
+@ref openMemory(), which references them directly without any copy.
+
+The rows are decoded directly to their Y-flipped location so the image origin
+is at the bottom left, as is the convention in Magnum. If the
+@cb{.ini} yFlip @ce
+@ref Trade-PngImporter-configuration "configuration option" is disabled, they
+stay in the top-to-bottom order of the file instead, which some APIs such as
+Vulkan expect. Neither case costs any extra pass over the data, the option
+exists mainly for consistency with @ref StbImageImporter, where the flip is
+a separate pass.
+
+To avoid an extra allocation and copy when uploading the data, the image can be
+also decoded directly into a caller-provided memory with @ref image2DInto(),
+with an arbitrary row pitch that matches for example alignment requirements of
+a GPU staging buffer. Size and format of the image can be queried upfront with
+@ref image2DInfo(), which parses just the file header.
+
+For large images the decoding time is dominated by zlib inflate, which the
+plugin doesn't do itself but leaves on the zlib implementation libPNG is
+linked to. To make it faster, build libPNG against
+[zlib-ng](https://github.com/zlib-ng/zlib-ng) compiled with `ZLIB_COMPAT`
+enabled, which is a drop-in replacement for zlib --- no change in this plugin
+is needed for that. Libraries that don't provide a streaming zlib-compatible
+API, such as [libdeflate](https://github.com/ebiggers/libdeflate), can't be
+used by libPNG. Because the whole file is always in memory, compressed data
+are passed to zlib in pieces of up to 1 MB instead of the default 8 kB.
+Additionally, verification of chunk CRCs and zlib Adler-32 checksums can be
+disabled with the @cb{.ini} checksums @ce
+@ref Trade-PngImporter-configuration "configuration option". Skipping Adler-32
+verification is supported only since libPNG 1.6.26.
+
+Many files at once can be decoded with @ref decodeBatch(), without opening
+them one by one. All images are put into a single allocation, with the size
+of each determined by looking at the file header alone. If the
+@cb{.ini} threads @ce
+@ref Trade-PngImporter-configuration "configuration option" is set to a value
+other than @cpp 1 @ce, the files are decoded in parallel. In that case the
+application needs to link to `pthread` on Linux due to the same reasons as
+described in @ref Trade-BasisImageConverter-loading "BasisImageConverter docs".
+
 @subsection Trade-PngImporter-behavior-cgbi Apple CgBI PNGs
 
 CgBI is a proprietary Apple-specific extension to PNG
@@ -121,6 +203,13 @@ which has the support.
 
 The test for this plugin contains a file that can be used for verifying CgBI
 support.
+
+@section Trade-PngImporter-configuration Plugin-specific config
+
+It's possible to tune various import options through @ref configuration(). See
+below for all options and their default values:
+
+@snippet MagnumPlugins/PngImporter/PngImporter.conf config
 */
 class MAGNUM_PNGIMPORTER_EXPORT PngImporter: public AbstractImporter {
     public:
@@ -132,16 +221,81 @@ class MAGNUM_PNGIMPORTER_EXPORT PngImporter: public AbstractImporter {
 
         ~PngImporter();
 
+        /**
+         * @brief Open raw data without making a copy
+         * @m_since_latest_{plugins}
+         *
+         * Compared to @ref openData(), the importer references @p data
+         * directly instead of making a copy, which means the memory has to
+         * stay valid and unchanged until the importer is closed or another
+         * file is opened. Closes previous file, if it was opened, and tries
+         * to open given memory. Returns @cpp true @ce on success,
+         * @cpp false @ce otherwise.
+         */
+        virtual bool openMemory(Containers::ArrayView<const char> data);
+
+        /**
+         * @brief Image size and format
+         * @m_since_latest_{plugins}
+         *
+         * Parses just the file header, without decoding the image data.
+         * Useful for allocating memory passed to @ref image2DInto(). Expects
+         * that a file is opened. If the header can't be parsed, prints a
+         * message to @ref Error and returns @ref Containers::NullOpt.
+         */
+        virtual Containers::Optional<PngImporterImageInfo> image2DInfo();
+
+        /**
+         * @brief Decode the image into a caller-provided buffer
+         * @m_since_latest_{plugins}
+         *
+         * Like @ref image2D(), but instead of allocating a new image the rows
+         * are decoded directly to @p destination, for example a mapped GPU
+         * staging buffer, with rows being @p rowPitch bytes apart. Same as
+         * with @ref image2D(), the first row in memory is the bottom row of
+         * the image. If @p rowPitch is @cpp 0 @ce, the rows are aligned to
+         * four bytes, matching the layout returned by @ref image2D(). The
+         * destination needs to be at least row pitch multiplied by image
+         * height large, use @ref image2DInfo() to query the size and format
+         * upfront. Padding bytes between rows are left untouched.
+         *
+         * Expects that a file is opened. If the row pitch is smaller than a
+         * row, if @p destination is too small or if the decoding fails,
+         * prints a message to @ref Error and returns @cpp false @ce.
+         */
+        virtual bool image2DInto(Containers::ArrayView<char> destination, std::size_t rowPitch = 0);
+
+        /**
+         * @brief Decode many files at once
+         * @m_since_latest_{plugins}
+         *
+         * Decodes each of @p files the same way as @ref image2D() would if
+         * it was opened, but puts all images into a single allocation and,
+         * based on the @cb{.ini} threads @ce
+         * @ref Trade-PngImporter-configuration "configuration option",
+         * decodes them on multiple threads. Doesn't need any file to be
+         * opened and doesn't affect the currently opened file. Files that
+         * fail to decode are @ref Containers::NullOpt in the output, with a
+         * message printed to @ref Error. Note that messages printed from
+         * other threads don't go through output redirection set up on the
+         * calling thread.
+         */
+        virtual PngImporterBatch decodeBatch(Containers::ArrayView<const Containers::ArrayView<const char>> files);
+
     private:
+        struct State;
+
         MAGNUM_PNGIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_PNGIMPORTER_LOCAL bool doIsOpened() const override;
         MAGNUM_PNGIMPORTER_LOCAL void doClose() override;
+        MAGNUM_PNGIMPORTER_LOCAL bool checkData(Containers::ArrayView<const char> data, const char* messagePrefix);
+        MAGNUM_PNGIMPORTER_LOCAL void doOpenFile(const std::string& filename) override;
         MAGNUM_PNGIMPORTER_LOCAL void doOpenData(Containers::ArrayView<const char> data) override;
 
         MAGNUM_PNGIMPORTER_LOCAL UnsignedInt doImage2DCount() const override;
         MAGNUM_PNGIMPORTER_LOCAL Containers::Optional<ImageData2D> doImage2D(UnsignedInt id, UnsignedInt level) override;
 
-        Containers::Array<unsigned char> _in;
+        Containers::Pointer<State> _state;
 };
 
 }}
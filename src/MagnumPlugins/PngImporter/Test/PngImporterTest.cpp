@@ -23,11 +23,14 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <algorithm>
+#include <cstring>
 #include <sstream>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Directory.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Corrade/Utility/FormatStl.h>
@@ -36,6 +39,8 @@
 #include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "MagnumPlugins/PngImporter/PngImporter.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Trade { namespace Test { namespace {
@@ -49,7 +54,17 @@ struct PngImporterTest: TestSuite::Tester {
     void gray();
     void rgb();
     void rgbPalette1bit();
+    void rgb16();
+    void rgb16NoYFlip();
     void rgba();
+    void rgbaPalette2bitTrns();
+
+    void openMemory();
+    void image2DInfo();
+    void image2DInto();
+    void image2DIntoInvalid();
+    void decodeBatch();
+    void checksumsDisabled();
 
     void openTwice();
     void importTwice();
@@ -89,6 +104,15 @@ constexpr struct {
     {"palette", "rgb-palette.png"},
 };
 
+constexpr struct {
+    const char* name;
+    const char* filename;
+} Rgb16Data[]{
+    /* See README.md for details on how these files were produced */
+    {"", "rgb16.png"},
+    {"interlaced", "rgb16-interlaced.png"}
+};
+
 constexpr struct {
     const char* name;
     const char* filename;
@@ -103,6 +127,15 @@ constexpr struct {
     {"tRNS alpha mask", "rgba-trns.png"},
 };
 
+constexpr struct {
+    const char* name;
+    UnsignedInt threads;
+} DecodeBatchData[]{
+    {"", 1},
+    {"four threads", 4},
+    {"all cores", 0}
+};
+
 PngImporterTest::PngImporterTest() {
     addTests({&PngImporterTest::empty});
 
@@ -117,10 +150,26 @@ PngImporterTest::PngImporterTest() {
 
     addTests({&PngImporterTest::rgbPalette1bit});
 
+    addInstancedTests({&PngImporterTest::rgb16,
+                       &PngImporterTest::rgb16NoYFlip},
+        Containers::arraySize(Rgb16Data));
+
     addInstancedTests({&PngImporterTest::rgba},
         Containers::arraySize(RgbaData));
 
-    addTests({&PngImporterTest::openTwice,
+    addTests({&PngImporterTest::rgbaPalette2bitTrns});
+
+    addInstancedTests({&PngImporterTest::decodeBatch},
+        Containers::arraySize(DecodeBatchData));
+
+    addTests({&PngImporterTest::checksumsDisabled});
+
+    addTests({&PngImporterTest::openMemory,
+              &PngImporterTest::image2DInfo,
+              &PngImporterTest::image2DInto,
+              &PngImporterTest::image2DIntoInvalid,
+
+              &PngImporterTest::openTwice,
               &PngImporterTest::importTwice});
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
@@ -225,6 +274,67 @@ void PngImporterTest::rgbPalette1bit() {
     CORRADE_COMPARE(image->pixels<Color3ub>()[0][0], 0x0000ff_rgb);
 }
 
+void PngImporterTest::rgb16() {
+    auto&& data = Rgb16Data[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PngImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(PNGIMPORTER_TEST_DIR, data.filename)));
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), Vector2i(3, 2));
+    CORRADE_COMPARE(image->format(), PixelFormat::RGB16Unorm);
+
+    /* The image has four-byte aligned rows, clear the padding to deterministic
+       values */
+    CORRADE_COMPARE(image->data().size(), 40);
+    Containers::ArrayView<UnsignedShort> pixels = Containers::arrayCast<UnsignedShort>(image->mutableData());
+    pixels[9] = pixels[19] = 0;
+
+    /* Each channel has a different value in both bytes, so a missing or a
+       double endian swap would be visible */
+    CORRADE_COMPARE_AS(Containers::arrayCast<const UnsignedShort>(image->data()), Containers::arrayView<UnsignedShort>({
+        0xca31, 0xca32, 0xca33,
+        0xca41, 0xca42, 0xca43,
+        0xca51, 0xca52, 0xca53, 0,
+
+        0xca01, 0xca02, 0xca03,
+        0xca11, 0xca12, 0xca13,
+        0xca21, 0xca22, 0xca23, 0
+    }), TestSuite::Compare::Container);
+}
+
+void PngImporterTest::rgb16NoYFlip() {
+    auto&& data = Rgb16Data[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PngImporter");
+    importer->configuration().setValue("yFlip", false);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(PNGIMPORTER_TEST_DIR, data.filename)));
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), Vector2i(3, 2));
+    CORRADE_COMPARE(image->format(), PixelFormat::RGB16Unorm);
+
+    CORRADE_COMPARE(image->data().size(), 40);
+    Containers::ArrayView<UnsignedShort> pixels = Containers::arrayCast<UnsignedShort>(image->mutableData());
+    pixels[9] = pixels[19] = 0;
+
+    /* Same as rgb16() but with the rows swapped, which for the interlaced
+       file verifies all passes go to the same rows */
+    CORRADE_COMPARE_AS(Containers::arrayCast<const UnsignedShort>(image->data()), Containers::arrayView<UnsignedShort>({
+        0xca01, 0xca02, 0xca03,
+        0xca11, 0xca12, 0xca13,
+        0xca21, 0xca22, 0xca23, 0,
+
+        0xca31, 0xca32, 0xca33,
+        0xca41, 0xca42, 0xca43,
+        0xca51, 0xca52, 0xca53, 0
+    }), TestSuite::Compare::Container);
+}
+
 void PngImporterTest::rgba() {
     auto&& data = RgbaData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -253,6 +363,216 @@ void PngImporterTest::rgba() {
     }}), TestSuite::Compare::Container);
 }
 
+void PngImporterTest::openMemory() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PngImporter");
+    Containers::Array<char> data = Utility::Directory::read(Utility::Directory::join(PNGIMPORTER_TEST_DIR, "rgb.png"));
+    CORRADE_VERIFY(data);
+    CORRADE_VERIFY(static_cast<PngImporter&>(*importer).openMemory(data));
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), Vector2i(3, 2));
+    CORRADE_COMPARE(image->format(), PixelFormat::RGB8Unorm);
+
+    /* The result should be the same as with the data copied. Not comparing
+       the padding, which isn't initialized. */
+    CORRADE_VERIFY(importer->openData(data));
+    Containers::Optional<Trade::ImageData2D> imageCopied = importer->image2D(0);
+    CORRADE_VERIFY(imageCopied);
+    CORRADE_COMPARE_AS(imageCopied->pixels<Color3ub>()[0], image->pixels<Color3ub>()[0],
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(imageCopied->pixels<Color3ub>()[1], image->pixels<Color3ub>()[1],
+        TestSuite::Compare::Container);
+
+    /* Opening an empty memory fails */
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!static_cast<PngImporter&>(*importer).openMemory(nullptr));
+    CORRADE_VERIFY(!importer->isOpened());
+    CORRADE_COMPARE(out.str(), "Trade::PngImporter::openMemory(): the file is empty\n");
+}
+
+void PngImporterTest::image2DInfo() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PngImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(PNGIMPORTER_TEST_DIR, "rgb-palette.png")));
+
+    Containers::Optional<PngImporterImageInfo> info = static_cast<PngImporter&>(*importer).image2DInfo();
+    CORRADE_VERIFY(info);
+    CORRADE_COMPARE(info->size, Vector2i(3, 2));
+    /* Palette gets expanded to RGB */
+    CORRADE_COMPARE(info->format, PixelFormat::RGB8Unorm);
+
+    /* Invalid file */
+    CORRADE_VERIFY(importer->openData(Containers::arrayView("invalid").except(1)));
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!static_cast<PngImporter&>(*importer).image2DInfo());
+    CORRADE_COMPARE(out.str(), "Trade::PngImporter::image2DInfo(): wrong file signature\n");
+}
+
+void PngImporterTest::image2DInto() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PngImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(PNGIMPORTER_TEST_DIR, "rgb.png")));
+
+    /* A 16-byte row pitch, with the padding filled to verify it's not touched */
+    char data[16*2];
+    std::memset(data, '\x01', sizeof(data));
+    CORRADE_VERIFY(static_cast<PngImporter&>(*importer).image2DInto(data, 16));
+    CORRADE_COMPARE_AS(Containers::arrayView(data), Containers::arrayView<char>({
+        '\xca', '\xfe', '\x77',
+        '\xde', '\xad', '\xb5',
+        '\xca', '\xfe', '\x77', 1, 1, 1, 1, 1, 1, 1,
+
+        '\xde', '\xad', '\xb5',
+        '\xca', '\xfe', '\x77',
+        '\xde', '\xad', '\xb5', 1, 1, 1, 1, 1, 1, 1
+    }), TestSuite::Compare::Container);
+
+    /* Tightly packed rows */
+    char tight[9*2];
+    CORRADE_VERIFY(static_cast<PngImporter&>(*importer).image2DInto(tight, 9));
+    CORRADE_COMPARE_AS(Containers::arrayView(tight), Containers::arrayView<char>({
+        '\xca', '\xfe', '\x77',
+        '\xde', '\xad', '\xb5',
+        '\xca', '\xfe', '\x77',
+
+        '\xde', '\xad', '\xb5',
+        '\xca', '\xfe', '\x77',
+        '\xde', '\xad', '\xb5'
+    }), TestSuite::Compare::Container);
+}
+
+void PngImporterTest::image2DIntoInvalid() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PngImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(PNGIMPORTER_TEST_DIR, "rgb.png")));
+
+    char data[12*2];
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!static_cast<PngImporter&>(*importer).image2DInto(data, 8));
+    /* Default pitch is 12, so 23 bytes is not enough */
+    CORRADE_VERIFY(!static_cast<PngImporter&>(*importer).image2DInto(Containers::arrayView(data).except(1)));
+    CORRADE_COMPARE(out.str(),
+        "Trade::PngImporter::image2DInto(): row pitch 8 is smaller than 9\n"
+        "Trade::PngImporter::image2DInto(): expected a destination of at least 24 bytes but got 23\n");
+}
+
+void PngImporterTest::rgbaPalette2bitTrns() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PngImporter");
+
+    /* See README.md for details on how this file was produced */
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(PNGIMPORTER_TEST_DIR, "rgba-palette-2bit-trns.png")));
+
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), Vector2i(3, 2));
+    CORRADE_COMPARE(image->format(), PixelFormat::RGBA8Unorm);
+
+    /* The first two palette entries have an alpha, the others are opaque */
+    CORRADE_COMPARE_AS(image->data(), Containers::arrayView(Containers::Array<char>{Containers::InPlaceInit, {
+        '\x44', '\x55', '\x66', '\xff',
+        '\x11', '\x22', '\x33', '\xff',
+        '\xde', '\xad', '\xb5', '\x00',
+        '\xca', '\xfe', '\x77', '\x80',
+        '\xde', '\xad', '\xb5', '\x00',
+        '\x11', '\x22', '\x33', '\xff'
+    }}), TestSuite::Compare::Container);
+}
+
+void PngImporterTest::decodeBatch() {
+    auto&& data = DecodeBatchData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PngImporter");
+    importer->configuration().setValue("threads", data.threads);
+
+    const char* filenames[]{"gray.png", "rgb.png", "rgb-palette.png",
+        "rgba-trns.png", "rgba.png"};
+    Containers::Array<char> files[Containers::arraySize(filenames)];
+    Containers::ArrayView<const char> views[Containers::arraySize(filenames) + 1];
+    for(std::size_t i = 0; i != Containers::arraySize(filenames); ++i) {
+        files[i] = Utility::Directory::read(Utility::Directory::join(PNGIMPORTER_TEST_DIR, filenames[i]));
+        CORRADE_VERIFY(files[i]);
+        views[i] = files[i];
+    }
+    /* The last one is invalid */
+    views[Containers::arraySize(filenames)] = Containers::arrayView("invalid").except(1);
+
+    std::ostringstream out;
+    PngImporterBatch batch;
+    {
+        Error redirectError{&out};
+        batch = static_cast<PngImporter&>(*importer).decodeBatch(views);
+    }
+    CORRADE_COMPARE(batch.images.size(), 6);
+    CORRADE_VERIFY(!batch.images[5]);
+    /* The message is printed only if the failure happened on this thread */
+    if(data.threads == 1)
+        CORRADE_COMPARE(out.str(), "Trade::PngImporter::decodeBatch(): wrong file signature\n");
+
+    /* All images are in a single allocation, with four-byte aligned rows:
+       3x2 R8, 3x2 RGB8 twice and 3x2 RGBA8 twice */
+    CORRADE_COMPARE(batch.data.size(), 8 + 24 + 24 + 24 + 24);
+
+    /* Each image should be the same as if decoded separately */
+    for(std::size_t i = 0; i != Containers::arraySize(filenames); ++i) {
+        CORRADE_ITERATION(filenames[i]);
+        CORRADE_VERIFY(batch.images[i]);
+        CORRADE_VERIFY(batch.images[i]->data().begin() >= batch.data.begin());
+        CORRADE_VERIFY(batch.images[i]->data().end() <= batch.data.end());
+
+        CORRADE_VERIFY(importer->openData(files[i]));
+        Containers::Optional<Trade::ImageData2D> expected = importer->image2D(0);
+        CORRADE_VERIFY(expected);
+        CORRADE_COMPARE(batch.images[i]->size(), expected->size());
+        CORRADE_COMPARE(batch.images[i]->format(), expected->format());
+
+        /* Compare row by row to skip the uninitialized padding */
+        const std::size_t rowSize = expected->size().x()*expected->pixelSize();
+        const std::size_t rowPitch = (rowSize + 3)/4*4;
+        for(std::size_t y = 0; y != std::size_t(expected->size().y()); ++y) {
+            CORRADE_ITERATION(y);
+            CORRADE_COMPARE_AS(
+                batch.images[i]->data().slice(y*rowPitch, y*rowPitch + rowSize),
+                expected->data().slice(y*rowPitch, y*rowPitch + rowSize),
+                TestSuite::Compare::Container);
+        }
+    }
+}
+
+void PngImporterTest::checksumsDisabled() {
+    Containers::Array<char> data = Utility::Directory::read(Utility::Directory::join(PNGIMPORTER_TEST_DIR, "rgb.png"));
+    CORRADE_VERIFY(data);
+
+    /* Corrupt the CRC of the (only) IDAT chunk, which is right after its
+       data */
+    const char* idat = std::search(data.begin(), data.end(), "IDAT", "IDAT" + 4);
+    CORRADE_VERIFY(idat != data.end());
+    const std::size_t length =
+        std::size_t(UnsignedByte(idat[-4])) << 24 |
+        std::size_t(UnsignedByte(idat[-3])) << 16 |
+        std::size_t(UnsignedByte(idat[-2])) << 8 |
+        std::size_t(UnsignedByte(idat[-1]));
+    data[idat - data.begin() + 4 + length] ^= 0xff;
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PngImporter");
+    CORRADE_VERIFY(importer->openData(data));
+    {
+        std::ostringstream out;
+        Error redirectError{&out};
+        CORRADE_VERIFY(!importer->image2D(0));
+        CORRADE_COMPARE(out.str(), "Trade::PngImporter::image2D(): error: IDAT: CRC error\n");
+    }
+
+    /* With checksums disabled it imports fine */
+    importer->configuration().setValue("checksums", false);
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), Vector2i(3, 2));
+    CORRADE_COMPARE(image->pixels<Color3ub>()[0][0], 0xcafe77_rgb);
+}
+
 void PngImporterTest::openTwice() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PngImporter");
 
@@ -24,4 +24,5 @@
 */
 
 #cmakedefine PNGIMPORTER_PLUGIN_FILENAME "${PNGIMPORTER_PLUGIN_FILENAME}"
+#cmakedefine PNGIMAGECONVERTER_PLUGIN_FILENAME "${PNGIMAGECONVERTER_PLUGIN_FILENAME}"
 #define PNGIMPORTER_TEST_DIR "${CMAKE_CURRENT_SOURCE_DIR}"
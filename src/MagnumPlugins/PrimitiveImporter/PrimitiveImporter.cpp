@@ -25,12 +25,20 @@
 
 #include "PrimitiveImporter.h"
 
-#include <cstring>
+#include <algorithm>
 #include <numeric>
+#include <random>
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/StridedArrayView.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/FormatStl.h>
 #include <Magnum/Math/ConfigurationValue.h>
+#include <Magnum/Math/PackingBatch.h>
+#include <Magnum/MeshTools/CompressIndices.h>
+#include <Magnum/MeshTools/Reference.h>
 #include <Magnum/Primitives/Axis.h>
 #include <Magnum/Primitives/Capsule.h>
 #include <Magnum/Primitives/Circle.h>
@@ -52,21 +60,50 @@
 
 namespace Magnum { namespace Trade {
 
-PrimitiveImporter::PrimitiveImporter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImporter{manager, plugin} {}
-
-PrimitiveImporter::~PrimitiveImporter() = default;
-
-ImporterFeatures PrimitiveImporter::doFeatures() const { return ImporterFeature::OpenData; }
-
-bool PrimitiveImporter::doIsOpened() const { return _opened; }
-
-void PrimitiveImporter::doClose() { _opened = false; }
+namespace {
 
-void PrimitiveImporter::doOpenData(Containers::ArrayView<const char>) {
-    _opened = true;
-}
+/* Has to be in the same order as Names */
+enum: UnsignedInt {
+    Axis2D,
+    Axis3D,
+    Capsule2DWireframe,
+    Capsule3DSolid,
+    Capsule3DWireframe,
+    Circle2DSolid,
+    Circle2DWireframe,
+    Circle3DSolid,
+    Circle3DWireframe,
+    ConeSolid,
+    ConeWireframe,
+    Crosshair2D,
+    Crosshair3D,
+    CubeSolid,
+    CubeSolidStrip,
+    CubeWireframe,
+    CylinderSolid,
+    CylinderWireframe,
+    Gradient2D,
+    Gradient2DHorizontal,
+    Gradient2DVertical,
+    Gradient3D,
+    Gradient3DHorizontal,
+    Gradient3DVertical,
+    Grid3DSolid,
+    Grid3DWireframe,
+    IcosphereSolid,
+    IcosphereWireframe,
+    Line2D,
+    Line3D,
+    PlaneSolid,
+    PlaneWireframe,
+    SquareSolid,
+    SquareWireframe,
+    UvSphereSolid,
+    UvSphereWireframe,
+
+    PrimitiveCount
+};
 
-namespace {
 
 constexpr const char* Names[]{
     "axis2D",
@@ -120,6 +157,63 @@ constexpr const char* Names[]{
     "uvSphereWireframe"
 };
 
+static_assert(Containers::arraySize(Names) == PrimitiveCount, "");
+
+/* Configuration group and options each primitive depends on, in the same
+   order as Names. The values are used as a key for the mesh cache. The 2D and
+   3D gradients share the same group. */
+constexpr struct {
+    const char* group;
+    const char* options[6];
+} Parameters[]{
+    {nullptr, {}}, /* axis2D */
+    {nullptr, {}}, /* axis3D */
+    {"capsule2DWireframe", {"hemisphereRings", "cylinderRings", "halfLength"}},
+    {"capsule3DSolid", {
+        "textureCoordinates", "tangents", "hemisphereRings", "cylinderRings",
+        "segments", "halfLength"}},
+    {"capsule3DWireframe", {
+        "hemisphereRings", "cylinderRings", "segments", "halfLength"}},
+    {"circle2DSolid", {"textureCoordinates", "segments"}},
+    {"circle2DWireframe", {"segments"}},
+    {"circle3DSolid", {"textureCoordinates", "tangents", "segments"}},
+    {"circle3DWireframe", {"segments"}},
+    {"coneSolid", {
+        "textureCoordinates", "tangents", "capEnd", "rings", "segments",
+        "halfLength"}},
+    {"coneWireframe", {"segments", "halfLength"}},
+    {nullptr, {}}, /* crosshair2D */
+    {nullptr, {}}, /* crosshair3D */
+    {nullptr, {}}, /* cubeSolid */
+    {nullptr, {}}, /* cubeSolidStrip */
+    {nullptr, {}}, /* cubeWireframe */
+    {"cylinderSolid", {
+        "textureCoordinates", "tangents", "capEnds", "rings", "segments",
+        "halfLength"}},
+    {"cylinderWireframe", {"rings", "segments", "halfLength"}},
+    {"gradient2D", {"a", "colorA", "b", "colorB"}},
+    {"gradient2D", {"colorA", "colorB"}}, /* gradient2DHorizontal */
+    {"gradient2D", {"colorA", "colorB"}}, /* gradient2DVertical */
+    {"gradient3D", {"a", "colorA", "b", "colorB"}},
+    {"gradient3D", {"colorA", "colorB"}}, /* gradient3DHorizontal */
+    {"gradient3D", {"colorA", "colorB"}}, /* gradient3DVertical */
+    {"grid3DSolid", {
+        "textureCoordinates", "tangents", "normals", "subdivisions"}},
+    {"grid3DWireframe", {"subdivisions"}},
+    {"icosphereSolid", {"subdivisions"}},
+    {nullptr, {}}, /* icosphereWireframe */
+    {"line2D", {"a", "b"}},
+    {"line3D", {"a", "b"}},
+    {"planeSolid", {"textureCoordinates", "tangents"}},
+    {nullptr, {}}, /* planeWireframe */
+    {"squareSolid", {"textureCoordinates"}},
+    {nullptr, {}}, /* squareWireframe */
+    {"uvSphereSolid", {"textureCoordinates", "tangents", "rings", "segments"}},
+    {"uvSphereWireframe", {"rings", "segments"}}
+};
+
+static_assert(Containers::arraySize(Parameters) == PrimitiveCount, "");
+
 constexpr const char* Names2D[]{
     "axis2D",
     "capsule2DWireframe",
@@ -162,413 +256,590 @@ constexpr const char* Names3D[]{
     "uvSphereWireframe"
 };
 
+/* All name lists are sorted, so a binary search can be used */
+Int findName(const Containers::ArrayView<const char* const> names, const std::string& name) {
+    const char* const* found = std::lower_bound(names.begin(), names.end(), name,
+        [](const char* a, const std::string& b) { return b.compare(a) > 0; });
+    if(found == names.end() || name != *found) return -1;
+    return found - names.begin();
 }
 
-Int PrimitiveImporter::doDefaultScene() { return 0; }
-
-UnsignedInt PrimitiveImporter::doSceneCount() const { return 1; }
-
-Containers::Optional<SceneData> PrimitiveImporter::doScene(UnsignedInt) {
-    std::vector<UnsignedInt> children2D(Containers::arraySize(Names2D));
-    std::iota(children2D.begin(), children2D.end(), 0);
-    std::vector<UnsignedInt> children3D(Containers::arraySize(Names3D));
-    std::iota(children3D.begin(), children3D.end(), 0);
-
-    return SceneData{std::move(children2D), std::move(children3D)};
-}
+/* Packed format for an attribute, or the original format if it's not
+   something that can be packed without a significant precision loss */
+VertexFormat packedFormat(const MeshData& mesh, const UnsignedInt id) {
+    const MeshAttribute name = mesh.attributeName(id);
+    const VertexFormat format = mesh.attributeFormat(id);
+
+    if(name == MeshAttribute::Normal || name == MeshAttribute::Bitangent) {
+        if(format == VertexFormat::Vector3) return VertexFormat::Vector3sNormalized;
+    } else if(name == MeshAttribute::Tangent) {
+        if(format == VertexFormat::Vector3) return VertexFormat::Vector3sNormalized;
+        if(format == VertexFormat::Vector4) return VertexFormat::Vector4sNormalized;
+    } else if(name == MeshAttribute::TextureCoordinates) {
+        /* Only if all coordinates are in the [0, 1] range, which is the case
+           for all current primitives */
+        if(format == VertexFormat::Vector2) {
+            for(const Vector2& i: mesh.attribute<Vector2>(id))
+                if((i < Vector2{0.0f}).any() || (i > Vector2{1.0f}).any())
+                    return format;
+            return VertexFormat::Vector2usNormalized;
+        }
+    }
 
-UnsignedInt PrimitiveImporter::doObject2DCount() const {
-    return Containers::arraySize(Names2D);
+    return format;
 }
 
-Int PrimitiveImporter::doObject2DForName(const std::string& name) {
-    for(std::size_t i = 0; i != Containers::arraySize(Names2D); ++i)
-        if(name == Names2D[i]) return i;
-    return -1;
-}
+/* Make the mesh smaller as requested by the compactIndices and
+   packAttributes options */
+MeshData compact(MeshData&& mesh, const Utility::ConfigurationGroup& configuration) {
+    /* Use 16-bit indices if they fit. Don't go down to 8-bit, as those are
+       slow or unsupported on many GPUs. */
+    if(configuration.value<bool>("compactIndices") && mesh.isIndexed() && mesh.indexType() == MeshIndexType::UnsignedInt)
+        mesh = MeshTools::compressIndices(mesh, MeshIndexType::UnsignedShort);
+
+    if(!configuration.value<bool>("packAttributes"))
+        return std::move(mesh);
+
+    /* Decide on the formats and an interleaved layout with attributes
+       aligned to four bytes. If nothing can be packed, return as-is. */
+    bool packed = false;
+    Containers::Array<VertexFormat> formats{Containers::NoInit, mesh.attributeCount()};
+    Containers::Array<std::size_t> offsets{Containers::NoInit, mesh.attributeCount()};
+    std::size_t stride = 0;
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+        formats[i] = packedFormat(mesh, i);
+        if(formats[i] != mesh.attributeFormat(i)) packed = true;
+        offsets[i] = stride;
+        stride += (vertexFormatSize(formats[i]) + 3) & ~std::size_t{3};
+    }
+    if(!packed) return std::move(mesh);
+
+    /* Copy the index data, if any */
+    Containers::Array<char> indexData;
+    MeshIndexData indices;
+    if(mesh.isIndexed()) {
+        indexData = Containers::Array<char>{Containers::NoInit, mesh.indexData().size()};
+        Utility::copy(mesh.indexData(), indexData);
+        indices = MeshIndexData{mesh.indexType(), indexData.slice(
+            mesh.indexOffset(),
+            mesh.indexOffset() + mesh.indexCount()*meshIndexTypeSize(mesh.indexType()))};
+    }
 
-std::string PrimitiveImporter::doObject2DName(const UnsignedInt id) {
-    return Names2D[id];
-}
+    /* Zero-initialized so the paddings are deterministic */
+    Containers::Array<char> vertexData{Containers::ValueInit, stride*mesh.vertexCount()};
+    Containers::Array<MeshAttributeData> attributes{mesh.attributeCount()};
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+        const std::size_t size = vertexFormatSize(formats[i]);
+        const Containers::StridedArrayView2D<char> dst{vertexData,
+            vertexData.data() + offsets[i],
+            {mesh.vertexCount(), size},
+            {std::ptrdiff_t(stride), 1}};
+        attributes[i] = MeshAttributeData{mesh.attributeName(i), formats[i],
+            Containers::StridedArrayView1D<const void>{vertexData,
+                vertexData.data() + offsets[i],
+                mesh.vertexCount(), std::ptrdiff_t(stride)}};
+
+        if(formats[i] == mesh.attributeFormat(i))
+            Utility::copy(mesh.attribute(i), dst);
+        else if(vertexFormatComponentFormat(formats[i]) == VertexFormat::ShortNormalized)
+            Math::packInto(Containers::arrayCast<2, const Float>(mesh.attribute(i)),
+                Containers::arrayCast<2, Short>(dst));
+        else if(vertexFormatComponentFormat(formats[i]) == VertexFormat::UnsignedShortNormalized)
+            Math::packInto(Containers::arrayCast<2, const Float>(mesh.attribute(i)),
+                Containers::arrayCast<2, UnsignedShort>(dst));
+        else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    }
 
-Containers::Pointer<ObjectData2D> PrimitiveImporter::doObject2D(const UnsignedInt id) {
-    static_assert(Containers::arraySize(Names2D) <= 12, "can't pack into 3x4 cells");
-    return Containers::pointer(new MeshObjectData2D{{},
-        Matrix3::translation(3.0f*Vector2{-1.5f + Float(id % 4), -1.0f + Float(id / 4)}),
-        UnsignedInt(doMeshForName(Names2D[id])), -1
-    });
+    return MeshData{mesh.primitive(),
+        std::move(indexData), indices,
+        std::move(vertexData), std::move(attributes),
+        mesh.vertexCount()};
 }
 
-UnsignedInt PrimitiveImporter::doObject3DCount() const {
-    return Containers::arraySize(Names3D);
+UnsignedInt instanceCount(const Utility::ConfigurationGroup& configuration) {
+    const Utility::ConfigurationGroup* conf;
+    CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration.group("instancedScene"));
+    return conf->value<UnsignedInt>("count");
 }
 
-Int PrimitiveImporter::doObject3DForName(const std::string& name) {
-    for(std::size_t i = 0; i != Containers::arraySize(Names3D); ++i)
-        if(name == Names3D[i]) return i;
-    return -1;
-}
+/* Objects [0, names.size()) are the primitives placed in the default scene,
+   after that there's instanceCount*names.size() objects for the instanced
+   scene, named "<primitive>.<instance>". Object k of the instanced scene is
+   instance k/names.size() of primitive k%names.size(). */
+Int findObjectName(const Containers::ArrayView<const char* const> names, const std::string& name, const UnsignedInt instanceCount) {
+    const Int id = findName(names, name);
+    if(id != -1) return id;
+
+    const std::size_t dot = name.rfind('.');
+    if(dot == std::string::npos || dot + 1 == name.size()) return -1;
+    const Int primitive = findName(names, name.substr(0, dot));
+    if(primitive == -1) return -1;
+
+    /* Accept only plain decimal numbers without leading zeros, so the lookup
+       is the exact inverse of objectName() */
+    if(name[dot + 1] == '0' && dot + 2 != name.size()) return -1;
+    std::size_t instance = 0;
+    for(std::size_t i = dot + 1; i != name.size(); ++i) {
+        if(name[i] < '0' || name[i] > '9') return -1;
+        instance = instance*10 + (name[i] - '0');
+        if(instance >= instanceCount) return -1;
+    }
 
-std::string PrimitiveImporter::doObject3DName(const UnsignedInt id) {
-    return Names3D[id];
+    return names.size()*(instance + 1) + primitive;
 }
 
-Containers::Pointer<ObjectData3D> PrimitiveImporter::doObject3D(const UnsignedInt id) {
-    static_assert(Containers::arraySize(Names3D) <= 25, "can't pack into 5x5 cells");
-    return Containers::pointer(new MeshObjectData3D{{},
-        Matrix4::translation(3.0f*Vector3{-2.0f + Float(id % 5), -2.0f + Float(id / 5), 0.0f}),
-        UnsignedInt(doMeshForName(Names3D[id])), -1
-    });
+std::string objectName(const Containers::ArrayView<const char* const> names, const UnsignedInt id) {
+    if(id < names.size()) return names[id];
+    const std::size_t k = id - names.size();
+    return Utility::formatString("{}.{}", names[k % names.size()], k/names.size());
 }
 
-UnsignedInt PrimitiveImporter::doMeshCount() const {
-    return Containers::arraySize(Names);
+/* Returns a uniformly distributed value in [0, 1]. Not using
+   std::uniform_real_distribution, as its output is implementation-defined
+   and the layout should be reproducible across platforms. */
+Float random(std::mt19937& engine) {
+    return Float(engine() - engine.min())/Float(engine.max() - engine.min());
 }
 
-Int PrimitiveImporter::doMeshForName(const std::string& name) {
-    for(std::size_t i = 0; i != Containers::arraySize(Names); ++i)
-        if(name == Names[i]) return i;
-    return -1;
+/* Each object gets its own engine seeded from the seed option and the object
+   index, so the transforms don't depend on the order they're queried in */
+std::mt19937 randomEngine(const Utility::ConfigurationGroup& conf, const std::size_t k) {
+    std::seed_seq seed{conf.value<UnsignedInt>("seed"), UnsignedInt(k)};
+    return std::mt19937{seed};
 }
 
-std::string PrimitiveImporter::doMeshName(const UnsignedInt id) {
-    return Names[id];
+/* Side of the smallest square or cube grid that fits the given count */
+std::size_t gridSide(const std::size_t count, const std::size_t dimensions) {
+    std::size_t side = 1;
+    while((dimensions == 2 ? side*side : side*side*side) < count) ++side;
+    return side;
 }
 
-Containers::Optional<MeshData> PrimitiveImporter::doMesh(UnsignedInt id, UnsignedInt) {
-    if(std::strcmp(Names[id], "axis2D") == 0)
-        return Primitives::axis2D();
-
-    if(std::strcmp(Names[id], "axis3D") == 0)
-        return Primitives::axis3D();
-
-    if(std::strcmp(Names[id], "capsule2DWireframe") == 0) {
-        Utility::ConfigurationGroup* conf;
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("capsule2DWireframe"));
-
-        return Primitives::capsule2DWireframe(
-            conf->value<UnsignedInt>("hemisphereRings"),
-            conf->value<UnsignedInt>("cylinderRings"),
-            conf->value<Float>("halfLength"));
-    }
-
-    if(std::strcmp(Names[id], "capsule3DSolid") == 0) {
-        Utility::ConfigurationGroup* conf;
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("capsule3DSolid"));
-
-        Primitives::CapsuleFlags flags;
-        if(conf->value<bool>("textureCoordinates"))
-            flags |= Primitives::CapsuleFlag::TextureCoordinates;
-        if(conf->value<bool>("tangents"))
-            flags |= Primitives::CapsuleFlag::Tangents;
-
-        return Primitives::capsule3DSolid(
-            conf->value<UnsignedInt>("hemisphereRings"),
-            conf->value<UnsignedInt>("cylinderRings"),
-            conf->value<UnsignedInt>("segments"),
-            conf->value<Float>("halfLength"),
-            flags);
-    }
-
-    if(std::strcmp(Names[id], "capsule3DWireframe") == 0) {
-        Utility::ConfigurationGroup* conf;
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("capsule3DWireframe"));
-
-        return Primitives::capsule3DWireframe(
-            conf->value<UnsignedInt>("hemisphereRings"),
-            conf->value<UnsignedInt>("cylinderRings"),
-            conf->value<UnsignedInt>("segments"),
-            conf->value<Float>("halfLength"));
-    }
-
-    if(std::strcmp(Names[id], "circle2DSolid") == 0) {
-        Utility::ConfigurationGroup* conf;
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("circle2DSolid"));
-
-        Primitives::Circle2DFlags flags;
-        if(conf->value<bool>("textureCoordinates"))
-            flags |= Primitives::Circle2DFlag::TextureCoordinates;
-
-        return Primitives::circle2DSolid(
-            conf->value<UnsignedInt>("segments"),
-            flags);
-    }
-
-    if(std::strcmp(Names[id], "circle2DWireframe") == 0) {
-        Utility::ConfigurationGroup* conf;
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("circle2DWireframe"));
+Containers::Optional<Matrix3> instanceTransformation2D(const Utility::ConfigurationGroup& conf, const std::size_t k, const std::size_t total) {
+    const Float spacing = conf.value<Float>("spacing");
+    const std::size_t side = gridSide(total, 2);
+    const Float center = 0.5f*Float(side - 1);
 
-        return Primitives::circle2DWireframe(
-            conf->value<UnsignedInt>("segments"));
-    }
-
-    if(std::strcmp(Names[id], "circle3DSolid") == 0) {
-        Utility::ConfigurationGroup* conf;
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("circle3DSolid"));
-
-        Primitives::Circle3DFlags flags;
-        if(conf->value<bool>("textureCoordinates"))
-            flags |= Primitives::Circle3DFlag::TextureCoordinates;
-        if(conf->value<bool>("tangents"))
-            flags |= Primitives::Circle3DFlag::Tangents;
+    if(conf.value("layout") == "grid")
+        return Matrix3::translation(spacing*(Vector2{Float(k % side), Float(k/side)} - Vector2{center}));
 
-        return Primitives::circle3DSolid(
-            conf->value<UnsignedInt>("segments"),
-            flags);
+    if(conf.value("layout") == "random") {
+        std::mt19937 engine = randomEngine(conf, k);
+        const Vector2 translation{random(engine), random(engine)};
+        const Deg angle{360.0f*random(engine)};
+        return Matrix3::translation(spacing*Float(side)*(translation - Vector2{0.5f}))*
+            Matrix3::rotation(angle);
     }
 
-    if(std::strcmp(Names[id], "circle3DWireframe") == 0) {
-        Utility::ConfigurationGroup* conf;
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("circle3DWireframe"));
-
-        return Primitives::circle3DWireframe(
-            conf->value<UnsignedInt>("segments"));
-    }
-
-    if(std::strcmp(Names[id], "coneSolid") == 0) {
-        Utility::ConfigurationGroup* conf;
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("coneSolid"));
-
-        Primitives::ConeFlags flags;
-        if(conf->value<bool>("textureCoordinates"))
-            flags |= Primitives::ConeFlag::TextureCoordinates;
-        if(conf->value<bool>("tangents"))
-            flags |= Primitives::ConeFlag::Tangents;
-        if(conf->value<bool>("capEnd"))
-            flags |= Primitives::ConeFlag::CapEnd;
-
-        return Primitives::coneSolid(
-            conf->value<UnsignedInt>("rings"),
-            conf->value<UnsignedInt>("segments"),
-            conf->value<Float>("halfLength"),
-            flags);
-    }
-
-    if(std::strcmp(Names[id], "coneWireframe") == 0) {
-        Utility::ConfigurationGroup* conf;
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("coneWireframe"));
+    return {};
+}
 
-        return Primitives::coneWireframe(
-            conf->value<UnsignedInt>("segments"),
-            conf->value<Float>("halfLength"));
+Containers::Optional<Matrix4> instanceTransformation3D(const Utility::ConfigurationGroup& conf, const std::size_t k, const std::size_t total) {
+    const Float spacing = conf.value<Float>("spacing");
+    const std::size_t side = gridSide(total, 3);
+    const Float center = 0.5f*Float(side - 1);
+
+    if(conf.value("layout") == "grid")
+        return Matrix4::translation(spacing*(Vector3{Float(k % side), Float(k/side % side), Float(k/(side*side))} - Vector3{center}));
+
+    if(conf.value("layout") == "random") {
+        std::mt19937 engine = randomEngine(conf, k);
+        const Vector3 translation{random(engine), random(engine), random(engine)};
+        Vector3 axis{random(engine), random(engine), random(engine)};
+        axis = axis*2.0f - Vector3{1.0f};
+        if(axis.dot() < 1.0e-4f) axis = Vector3::yAxis();
+        const Deg angle{360.0f*random(engine)};
+        return Matrix4::translation(spacing*Float(side)*(translation - Vector3{0.5f}))*
+            Matrix4::rotation(angle, axis.normalized());
     }
 
-    if(std::strcmp(Names[id], "crosshair2D") == 0)
-        return Primitives::crosshair2D();
-
-    if(std::strcmp(Names[id], "crosshair3D") == 0)
-        return Primitives::crosshair3D();
-
-    if(std::strcmp(Names[id], "cubeSolid") == 0)
-        return Primitives::cubeSolid();
-
-    if(std::strcmp(Names[id], "cubeSolidStrip") == 0)
-        return Primitives::cubeSolidStrip();
-
-    if(std::strcmp(Names[id], "cubeWireframe") == 0)
-        return Primitives::cubeWireframe();
-
-    if(std::strcmp(Names[id], "cylinderSolid") == 0) {
-        Utility::ConfigurationGroup* conf;
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("cylinderSolid"));
-
-        Primitives::CylinderFlags flags;
-        if(conf->value<bool>("textureCoordinates"))
-            flags |= Primitives::CylinderFlag::TextureCoordinates;
-        if(conf->value<bool>("tangents"))
-            flags |= Primitives::CylinderFlag::Tangents;
-        if(conf->value<bool>("capEnds"))
-            flags |= Primitives::CylinderFlag::CapEnds;
+    return {};
+}
 
-        return Primitives::cylinderSolid(
-            conf->value<UnsignedInt>("rings"),
-            conf->value<UnsignedInt>("segments"),
-            conf->value<Float>("halfLength"),
-            flags);
+/* The configuration group is nullptr for primitives that don't have any
+   options */
+MeshData generateMesh(const UnsignedInt id, const Utility::ConfigurationGroup* const conf) {
+    switch(id) {
+        case Axis2D:
+            return Primitives::axis2D();
+
+        case Axis3D:
+            return Primitives::axis3D();
+
+        case Capsule2DWireframe:
+            return Primitives::capsule2DWireframe(
+                conf->value<UnsignedInt>("hemisphereRings"),
+                conf->value<UnsignedInt>("cylinderRings"),
+                conf->value<Float>("halfLength"));
+
+        case Capsule3DSolid: {
+            Primitives::CapsuleFlags flags;
+            if(conf->value<bool>("textureCoordinates"))
+                flags |= Primitives::CapsuleFlag::TextureCoordinates;
+            if(conf->value<bool>("tangents"))
+                flags |= Primitives::CapsuleFlag::Tangents;
+
+            return Primitives::capsule3DSolid(
+                conf->value<UnsignedInt>("hemisphereRings"),
+                conf->value<UnsignedInt>("cylinderRings"),
+                conf->value<UnsignedInt>("segments"),
+                conf->value<Float>("halfLength"),
+                flags);
+        }
+
+        case Capsule3DWireframe:
+            return Primitives::capsule3DWireframe(
+                conf->value<UnsignedInt>("hemisphereRings"),
+                conf->value<UnsignedInt>("cylinderRings"),
+                conf->value<UnsignedInt>("segments"),
+                conf->value<Float>("halfLength"));
+
+        case Circle2DSolid: {
+            Primitives::Circle2DFlags flags;
+            if(conf->value<bool>("textureCoordinates"))
+                flags |= Primitives::Circle2DFlag::TextureCoordinates;
+
+            return Primitives::circle2DSolid(
+                conf->value<UnsignedInt>("segments"),
+                flags);
+        }
+
+        case Circle2DWireframe:
+            return Primitives::circle2DWireframe(
+                conf->value<UnsignedInt>("segments"));
+
+        case Circle3DSolid: {
+            Primitives::Circle3DFlags flags;
+            if(conf->value<bool>("textureCoordinates"))
+                flags |= Primitives::Circle3DFlag::TextureCoordinates;
+            if(conf->value<bool>("tangents"))
+                flags |= Primitives::Circle3DFlag::Tangents;
+
+            return Primitives::circle3DSolid(
+                conf->value<UnsignedInt>("segments"),
+                flags);
+        }
+
+        case Circle3DWireframe:
+            return Primitives::circle3DWireframe(
+                conf->value<UnsignedInt>("segments"));
+
+        case ConeSolid: {
+            Primitives::ConeFlags flags;
+            if(conf->value<bool>("textureCoordinates"))
+                flags |= Primitives::ConeFlag::TextureCoordinates;
+            if(conf->value<bool>("tangents"))
+                flags |= Primitives::ConeFlag::Tangents;
+            if(conf->value<bool>("capEnd"))
+                flags |= Primitives::ConeFlag::CapEnd;
+
+            return Primitives::coneSolid(
+                conf->value<UnsignedInt>("rings"),
+                conf->value<UnsignedInt>("segments"),
+                conf->value<Float>("halfLength"),
+                flags);
+        }
+
+        case ConeWireframe:
+            return Primitives::coneWireframe(
+                conf->value<UnsignedInt>("segments"),
+                conf->value<Float>("halfLength"));
+
+        case Crosshair2D:
+            return Primitives::crosshair2D();
+
+        case Crosshair3D:
+            return Primitives::crosshair3D();
+
+        case CubeSolid:
+            return Primitives::cubeSolid();
+
+        case CubeSolidStrip:
+            return Primitives::cubeSolidStrip();
+
+        case CubeWireframe:
+            return Primitives::cubeWireframe();
+
+        case CylinderSolid: {
+            Primitives::CylinderFlags flags;
+            if(conf->value<bool>("textureCoordinates"))
+                flags |= Primitives::CylinderFlag::TextureCoordinates;
+            if(conf->value<bool>("tangents"))
+                flags |= Primitives::CylinderFlag::Tangents;
+            if(conf->value<bool>("capEnds"))
+                flags |= Primitives::CylinderFlag::CapEnds;
+
+            return Primitives::cylinderSolid(
+                conf->value<UnsignedInt>("rings"),
+                conf->value<UnsignedInt>("segments"),
+                conf->value<Float>("halfLength"),
+                flags);
+        }
+
+        case CylinderWireframe:
+            return Primitives::cylinderWireframe(
+                conf->value<UnsignedInt>("rings"),
+                conf->value<UnsignedInt>("segments"),
+                conf->value<Float>("halfLength"));
+
+        case Gradient2D:
+            return Primitives::gradient2D(
+                conf->value<Vector2>("a"),
+                conf->value<Color4>("colorA"),
+                conf->value<Vector2>("b"),
+                conf->value<Color4>("colorB"));
+
+        case Gradient2DHorizontal:
+            return Primitives::gradient2DHorizontal(
+                conf->value<Color4>("colorA"),
+                conf->value<Color4>("colorB"));
+
+        case Gradient2DVertical:
+            return Primitives::gradient2DVertical(
+                conf->value<Color4>("colorA"),
+                conf->value<Color4>("colorB"));
+
+        case Gradient3D:
+            return Primitives::gradient3D(
+                conf->value<Vector3>("a"),
+                conf->value<Color4>("colorA"),
+                conf->value<Vector3>("b"),
+                conf->value<Color4>("colorB"));
+
+        case Gradient3DHorizontal:
+            return Primitives::gradient3DHorizontal(
+                conf->value<Color4>("colorA"),
+                conf->value<Color4>("colorB"));
+
+        case Gradient3DVertical:
+            return Primitives::gradient3DVertical(
+                conf->value<Color4>("colorA"),
+                conf->value<Color4>("colorB"));
+
+        case Grid3DSolid: {
+            Primitives::GridFlags flags;
+            if(conf->value<bool>("textureCoordinates"))
+                flags |= Primitives::GridFlag::TextureCoordinates;
+            if(conf->value<bool>("tangents"))
+                flags |= Primitives::GridFlag::Tangents;
+            if(conf->value<bool>("normals"))
+                flags |= Primitives::GridFlag::Normals;
+
+            return Primitives::grid3DSolid(
+                conf->value<Vector2i>("subdivisions"),
+                flags);
+        }
+
+        case Grid3DWireframe:
+            return Primitives::grid3DWireframe(
+                conf->value<Vector2i>("subdivisions"));
+
+        case IcosphereSolid:
+            return Primitives::icosphereSolid(
+                conf->value<UnsignedInt>("subdivisions"));
+
+        case IcosphereWireframe:
+            return Primitives::icosphereWireframe();
+
+        case Line2D:
+            return Primitives::line2D(
+                conf->value<Vector2>("a"),
+                conf->value<Vector2>("b"));
+
+        case Line3D:
+            return Primitives::line3D(
+                conf->value<Vector3>("a"),
+                conf->value<Vector3>("b"));
+
+        case PlaneSolid: {
+            Primitives::PlaneFlags flags;
+            if(conf->value<bool>("textureCoordinates"))
+                flags |= Primitives::PlaneFlag::TextureCoordinates;
+            if(conf->value<bool>("tangents"))
+                flags |= Primitives::PlaneFlag::Tangents;
+
+            return Primitives::planeSolid(flags);
+        }
+
+        case PlaneWireframe:
+            return Primitives::planeWireframe();
+
+        case SquareSolid: {
+            Primitives::SquareFlags flags;
+            if(conf->value<bool>("textureCoordinates"))
+                flags |= Primitives::SquareFlag::TextureCoordinates;
+
+            return Primitives::squareSolid(flags);
+        }
+
+        case SquareWireframe:
+            return Primitives::squareWireframe();
+
+        case UvSphereSolid: {
+            Primitives::UVSphereFlags flags;
+            if(conf->value<bool>("textureCoordinates"))
+                flags |= Primitives::UVSphereFlag::TextureCoordinates;
+            if(conf->value<bool>("tangents"))
+                flags |= Primitives::UVSphereFlag::Tangents;
+
+            return Primitives::uvSphereSolid(
+                conf->value<UnsignedInt>("rings"),
+                conf->value<UnsignedInt>("segments"),
+                flags);
+        }
+
+        case UvSphereWireframe:
+            return Primitives::uvSphereWireframe(
+                conf->value<UnsignedInt>("rings"),
+                conf->value<UnsignedInt>("segments"));
     }
 
-    if(std::strcmp(Names[id], "cylinderWireframe") == 0) {
-        Utility::ConfigurationGroup* conf;
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("cylinderWireframe"));
-
-        return Primitives::cylinderWireframe(
-            conf->value<UnsignedInt>("rings"),
-            conf->value<UnsignedInt>("segments"),
-            conf->value<Float>("halfLength"));
-    }
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
 
-    if(std::strcmp(Names[id], "gradient2D") == 0) {
-        Utility::ConfigurationGroup* conf;
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("gradient2D"));
+}
 
-        return Primitives::gradient2D(
-            conf->value<Vector2>("a"),
-            conf->value<Color4>("colorA"),
-            conf->value<Vector2>("b"),
-            conf->value<Color4>("colorB"));
-    }
+struct PrimitiveImporter::State {
+    /* Meshes generated so far together with the configuration values they
+       were generated with */
+    Containers::Optional<MeshData> meshes[PrimitiveCount];
+    std::string meshKeys[PrimitiveCount];
+};
 
-    if(std::strcmp(Names[id], "gradient2DHorizontal") == 0) {
-        Utility::ConfigurationGroup* conf;
-        /* The same config shared for all 2D gradients */
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("gradient2D"));
+PrimitiveImporter::PrimitiveImporter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImporter{manager, plugin} {}
 
-        return Primitives::gradient2DHorizontal(
-            conf->value<Color4>("colorA"),
-            conf->value<Color4>("colorB"));
-    }
+PrimitiveImporter::~PrimitiveImporter() = default;
 
-    if(std::strcmp(Names[id], "gradient2DVertical") == 0) {
-        Utility::ConfigurationGroup* conf;
-        /* The same config shared for all 2D gradients */
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("gradient2D"));
+ImporterFeatures PrimitiveImporter::doFeatures() const { return ImporterFeature::OpenData; }
 
-        return Primitives::gradient2DVertical(
-            conf->value<Color4>("colorA"),
-            conf->value<Color4>("colorB"));
-    }
+bool PrimitiveImporter::doIsOpened() const { return !!_state; }
 
-    if(std::strcmp(Names[id], "gradient3D") == 0) {
-        Utility::ConfigurationGroup* conf;
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("gradient3D"));
+void PrimitiveImporter::doClose() { _state = nullptr; }
 
-        return Primitives::gradient3D(
-            conf->value<Vector3>("a"),
-            conf->value<Color4>("colorA"),
-            conf->value<Vector3>("b"),
-            conf->value<Color4>("colorB"));
-    }
+void PrimitiveImporter::doOpenData(Containers::ArrayView<const char>) {
+    _state.reset(new State);
+}
 
-    if(std::strcmp(Names[id], "gradient3DHorizontal") == 0) {
-        Utility::ConfigurationGroup* conf;
-        /* The same config shared for all 3D gradients */
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("gradient3D"));
+Int PrimitiveImporter::doDefaultScene() { return 0; }
 
-        return Primitives::gradient3DHorizontal(
-            conf->value<Color4>("colorA"),
-            conf->value<Color4>("colorB"));
-    }
+UnsignedInt PrimitiveImporter::doSceneCount() const {
+    return instanceCount(configuration()) ? 2 : 1;
+}
 
-    if(std::strcmp(Names[id], "gradient3DVertical") == 0) {
-        Utility::ConfigurationGroup* conf;
-        /* The same config shared for all 3D gradients */
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("gradient3D"));
+Containers::Optional<SceneData> PrimitiveImporter::doScene(const UnsignedInt id) {
+    /* The default scene has the first object of each primitive, the
+       instanced scene all others */
+    const std::size_t instances = id == 0 ? 1 : instanceCount(configuration());
+    std::vector<UnsignedInt> children2D(instances*Containers::arraySize(Names2D));
+    std::iota(children2D.begin(), children2D.end(), UnsignedInt(id == 0 ? 0 : Containers::arraySize(Names2D)));
+    std::vector<UnsignedInt> children3D(instances*Containers::arraySize(Names3D));
+    std::iota(children3D.begin(), children3D.end(), UnsignedInt(id == 0 ? 0 : Containers::arraySize(Names3D)));
 
-        return Primitives::gradient3DVertical(
-            conf->value<Color4>("colorA"),
-            conf->value<Color4>("colorB"));
-    }
+    return SceneData{std::move(children2D), std::move(children3D)};
+}
 
-    if(std::strcmp(Names[id], "grid3DSolid") == 0) {
-        Utility::ConfigurationGroup* conf;
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("grid3DSolid"));
-
-        Primitives::GridFlags flags;
-        if(conf->value<bool>("textureCoordinates"))
-            flags |= Primitives::GridFlag::TextureCoordinates;
-        if(conf->value<bool>("tangents"))
-            flags |= Primitives::GridFlag::Tangents;
-        if(conf->value<bool>("normals"))
-            flags |= Primitives::GridFlag::Normals;
-
-        return Primitives::grid3DSolid(
-            conf->value<Vector2i>("subdivisions"),
-            flags);
-    }
+UnsignedInt PrimitiveImporter::doObject2DCount() const {
+    return (1 + instanceCount(configuration()))*Containers::arraySize(Names2D);
+}
 
-    if(std::strcmp(Names[id], "grid3DWireframe") == 0) {
-        Utility::ConfigurationGroup* conf;
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("grid3DWireframe"));
+Int PrimitiveImporter::doObject2DForName(const std::string& name) {
+    return findObjectName(Names2D, name, instanceCount(configuration()));
+}
 
-        return Primitives::grid3DWireframe(
-            conf->value<Vector2i>("subdivisions"));
-    }
+std::string PrimitiveImporter::doObject2DName(const UnsignedInt id) {
+    return objectName(Names2D, id);
+}
 
-    if(std::strcmp(Names[id], "icosphereSolid") == 0) {
-        Utility::ConfigurationGroup* conf;
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("icosphereSolid"));
+Containers::Pointer<ObjectData2D> PrimitiveImporter::doObject2D(const UnsignedInt id) {
+    static_assert(Containers::arraySize(Names2D) <= 12, "can't pack into 3x4 cells");
+    constexpr std::size_t count = Containers::arraySize(Names2D);
+    if(id < count) return Containers::pointer(new MeshObjectData2D{{},
+        Matrix3::translation(3.0f*Vector2{-1.5f + Float(id % 4), -1.0f + Float(id / 4)}),
+        UnsignedInt(doMeshForName(Names2D[id])), -1
+    });
 
-        return Primitives::icosphereSolid(
-            conf->value<UnsignedInt>("subdivisions"));
+    const Utility::ConfigurationGroup& conf = *configuration().group("instancedScene");
+    const std::size_t k = id - count;
+    const Containers::Optional<Matrix3> transformation = instanceTransformation2D(conf, k, instanceCount(configuration())*count);
+    if(!transformation) {
+        Error{} << "Trade::PrimitiveImporter::object2D(): invalid instancedScene layout" << conf.value("layout");
+        return nullptr;
     }
 
-    if(std::strcmp(Names[id], "icosphereWireframe") == 0)
-        return Primitives::icosphereWireframe();
-
-    if(std::strcmp(Names[id], "line2D") == 0) {
-        Utility::ConfigurationGroup* conf;
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("line2D"));
-
-        return Primitives::line2D(
-            conf->value<Vector2>("a"),
-            conf->value<Vector2>("b"));
-    }
+    return Containers::pointer(new MeshObjectData2D{{}, *transformation,
+        UnsignedInt(doMeshForName(Names2D[k % count])), -1});
+}
 
-    if(std::strcmp(Names[id], "line3D") == 0) {
-        Utility::ConfigurationGroup* conf;
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("line3D"));
+UnsignedInt PrimitiveImporter::doObject3DCount() const {
+    return (1 + instanceCount(configuration()))*Containers::arraySize(Names3D);
+}
 
-        return Primitives::line3D(
-            conf->value<Vector3>("a"),
-            conf->value<Vector3>("b"));
-    }
+Int PrimitiveImporter::doObject3DForName(const std::string& name) {
+    return findObjectName(Names3D, name, instanceCount(configuration()));
+}
 
-    if(std::strcmp(Names[id], "planeSolid") == 0) {
-        Utility::ConfigurationGroup* conf;
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("planeSolid"));
+std::string PrimitiveImporter::doObject3DName(const UnsignedInt id) {
+    return objectName(Names3D, id);
+}
 
-        Primitives::PlaneFlags flags;
-        if(conf->value<bool>("textureCoordinates"))
-            flags |= Primitives::PlaneFlag::TextureCoordinates;
-        if(conf->value<bool>("tangents"))
-            flags |= Primitives::PlaneFlag::Tangents;
+Containers::Pointer<ObjectData3D> PrimitiveImporter::doObject3D(const UnsignedInt id) {
+    static_assert(Containers::arraySize(Names3D) <= 25, "can't pack into 5x5 cells");
+    constexpr std::size_t count = Containers::arraySize(Names3D);
+    if(id < count) return Containers::pointer(new MeshObjectData3D{{},
+        Matrix4::translation(3.0f*Vector3{-2.0f + Float(id % 5), -2.0f + Float(id / 5), 0.0f}),
+        UnsignedInt(doMeshForName(Names3D[id])), -1
+    });
 
-        return Primitives::planeSolid(flags);
+    const Utility::ConfigurationGroup& conf = *configuration().group("instancedScene");
+    const std::size_t k = id - count;
+    const Containers::Optional<Matrix4> transformation = instanceTransformation3D(conf, k, instanceCount(configuration())*count);
+    if(!transformation) {
+        Error{} << "Trade::PrimitiveImporter::object3D(): invalid instancedScene layout" << conf.value("layout");
+        return nullptr;
     }
 
-    if(std::strcmp(Names[id], "planeWireframe") == 0)
-        return Primitives::planeWireframe();
-
-    if(std::strcmp(Names[id], "squareSolid") == 0) {
-        Utility::ConfigurationGroup* conf;
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("squareSolid"));
-
-        Primitives::SquareFlags flags;
-        if(conf->value<bool>("textureCoordinates"))
-            flags |= Primitives::SquareFlag::TextureCoordinates;
-
-        return Primitives::squareSolid(flags);
-    }
+    return Containers::pointer(new MeshObjectData3D{{}, *transformation,
+        UnsignedInt(doMeshForName(Names3D[k % count])), -1});
+}
 
-    if(std::strcmp(Names[id], "squareWireframe") == 0)
-        return Primitives::squareWireframe();
+UnsignedInt PrimitiveImporter::doMeshCount() const {
+    return Containers::arraySize(Names);
+}
 
-    if(std::strcmp(Names[id], "uvSphereSolid") == 0) {
-        Utility::ConfigurationGroup* conf;
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("uvSphereSolid"));
+Int PrimitiveImporter::doMeshForName(const std::string& name) {
+    return findName(Names, name);
+}
 
-        Primitives::UVSphereFlags flags;
-        if(conf->value<bool>("textureCoordinates"))
-            flags |= Primitives::UVSphereFlag::TextureCoordinates;
-        if(conf->value<bool>("tangents"))
-            flags |= Primitives::UVSphereFlag::Tangents;
+std::string PrimitiveImporter::doMeshName(const UnsignedInt id) {
+    return Names[id];
+}
 
-        return Primitives::uvSphereSolid(
-            conf->value<UnsignedInt>("rings"),
-            conf->value<UnsignedInt>("segments"),
-            flags);
+Containers::Optional<MeshData> PrimitiveImporter::doMesh(const UnsignedInt id, UnsignedInt) {
+    /* Look up the configuration group, if any, and gather values of all
+       options the primitive depends on into a cache key */
+    const Utility::ConfigurationGroup* conf = nullptr;
+    std::string key = configuration().value("compactIndices") + '\n' +
+        configuration().value("packAttributes") + '\n';
+    if(Parameters[id].group) {
+        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group(Parameters[id].group));
+        for(const char* option: Parameters[id].options) {
+            if(!option) break;
+            key += conf->value(option);
+            key += '\n';
+        }
     }
 
-    if(std::strcmp(Names[id], "uvSphereWireframe") == 0) {
-        Utility::ConfigurationGroup* conf;
-        CORRADE_INTERNAL_ASSERT_OUTPUT(conf = configuration().group("uvSphereWireframe"));
+    if(!configuration().value<bool>("cacheMeshes"))
+        return compact(generateMesh(id, conf), configuration());
 
-        return Primitives::uvSphereWireframe(
-            conf->value<UnsignedInt>("rings"),
-            conf->value<UnsignedInt>("segments"));
+    /* Generate the mesh only if it's not cached yet or if the configuration
+       changed since. Return a copy so the cached instance stays intact. */
+    Containers::Optional<MeshData>& mesh = _state->meshes[id];
+    if(!mesh || _state->meshKeys[id] != key) {
+        mesh = compact(generateMesh(id, conf), configuration());
+        _state->meshKeys[id] = std::move(key);
     }
-
-    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    return MeshTools::owned(*mesh);
 }
 
 }}
@@ -107,6 +107,41 @@ can be accessed through name of the respective function in the @ref Primitives
 namespace (so e.g. loading a `uvSphereSolid` mesh will give you
 @ref Primitives::uvSphereSolid()).
 
+Generated meshes are by default cached for as long as the importer is opened,
+and repeated @ref mesh() calls return a copy of the cached data instead of
+generating the primitive again. The cache entry is regenerated if any
+configuration option the primitive depends on changes. Disable the
+@cb{.ini} cacheMeshes @ce
+@ref Trade-PrimitiveImporter-configuration "configuration option" to always
+generate the meshes from scratch.
+
+By default the meshes are returned exactly as generated by the
+@ref Primitives library, with @ref MeshIndexType::UnsignedInt indices and
+floating-point attributes. Enable the @cb{.ini} compactIndices @ce option to
+get @ref MeshIndexType::UnsignedShort indices where the index range allows,
+and the @cb{.ini} packAttributes @ce option to get normals, tangents and
+bitangents packed to @ref VertexFormat::Vector3sNormalized /
+@ref VertexFormat::Vector4sNormalized and texture coordinates to
+@ref VertexFormat::Vector2usNormalized, with positions and other attributes
+kept as-is.
+
+@subsection Trade-PrimitiveImporter-behavior-instanced Instanced scene
+
+Setting the @cb{.ini} count @ce option in the @cb{.ini} [instancedScene] @ce
+@ref Trade-PrimitiveImporter-configuration "configuration group" to a
+non-zero value adds a second scene containing given number of instances of
+each primitive, for example to use the importer as a reproducible load
+generator for renderer benchmarks. The instances are exposed as additional 2D
+and 3D objects following the ones in the default scene, named
+`<primitive>.<instance>`, so e.g. `uvSphereSolid.3` is the fourth instance of
+the `uvSphereSolid` primitive. With @cb{.ini} layout=grid @ce the instances
+are placed in a square or cube grid with @cb{.ini} spacing @ce between
+them, with @cb{.ini} layout=random @ce they get random positions in the same
+area and random rotations derived from @cb{.ini} seed @ce. The instances
+share the meshes of the default scene, so their complexity can be increased
+with the per-primitive options such as @cb{.ini} subdivisions @ce in the
+@cb{.ini} [icosphereSolid] @ce group.
+
 @section Trade-PrimitiveImporter-configuration Plugin-specific config
 
 By default the primitives are created with the same options that were used to
@@ -153,7 +188,8 @@ class MAGNUM_PRIMITIVEIMPORTER_EXPORT PrimitiveImporter: public AbstractImporter
         MAGNUM_PRIMITIVEIMPORTER_LOCAL std::string doMeshName(UnsignedInt id) override;
         MAGNUM_PRIMITIVEIMPORTER_LOCAL Containers::Optional<MeshData> doMesh(UnsignedInt id, UnsignedInt level) override;
 
-        bool _opened = false;
+        struct State;
+        Containers::Pointer<State> _state;
 };
 
 }}
@@ -23,11 +23,19 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <sstream>
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/ConfigurationValue.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Matrix3.h>
+#include <Magnum/Math/Matrix4.h>
 #include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/MeshData.h>
 #include <Magnum/Trade/MeshObjectData2D.h>
@@ -43,8 +51,15 @@ struct PrimitiveImporterTest: TestSuite::Tester {
 
     void test();
     void mesh();
+    void meshCache();
+    void meshCacheDisabled();
+    void compactIndices();
+    void packAttributes();
 
     void scene();
+    void instancedScene();
+    void instancedSceneRandom();
+    void instancedSceneInvalidLayout();
 
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
@@ -112,7 +127,15 @@ PrimitiveImporterTest::PrimitiveImporterTest() {
     addInstancedTests({&PrimitiveImporterTest::mesh},
         Containers::arraySize(Data));
 
-    addTests({&PrimitiveImporterTest::scene});
+    addTests({&PrimitiveImporterTest::meshCache,
+              &PrimitiveImporterTest::meshCacheDisabled,
+              &PrimitiveImporterTest::compactIndices,
+              &PrimitiveImporterTest::packAttributes,
+
+              &PrimitiveImporterTest::scene,
+              &PrimitiveImporterTest::instancedScene,
+              &PrimitiveImporterTest::instancedSceneRandom,
+              &PrimitiveImporterTest::instancedSceneInvalidLayout});
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
@@ -158,6 +181,122 @@ void PrimitiveImporterTest::mesh() {
     } else CORRADE_VERIFY(!mesh->isIndexed());
 }
 
+void PrimitiveImporterTest::meshCache() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PrimitiveImporter");
+    CORRADE_VERIFY(importer->configuration().value<bool>("cacheMeshes"));
+    CORRADE_VERIFY(importer->openData({}));
+
+    Containers::Optional<Trade::MeshData> mesh = importer->mesh("icosphereSolid");
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexCount(), 42);
+    const Vector3 position = mesh->attribute<Vector3>(MeshAttribute::Position)[0];
+
+    /* The returned mesh is a copy, modifying it shouldn't affect the cached
+       instance */
+    CORRADE_VERIFY(mesh->vertexDataFlags() & DataFlag::Mutable);
+    mesh->mutableAttribute<Vector3>(MeshAttribute::Position)[0] = {};
+
+    Containers::Optional<Trade::MeshData> cached = importer->mesh("icosphereSolid");
+    CORRADE_VERIFY(cached);
+    CORRADE_COMPARE(cached->vertexCount(), 42);
+    CORRADE_COMPARE(cached->attribute<Vector3>(MeshAttribute::Position)[0], position);
+
+    /* Changing an option the primitive depends on regenerates it */
+    importer->configuration().group("icosphereSolid")->setValue("subdivisions", 2);
+    Containers::Optional<Trade::MeshData> regenerated = importer->mesh("icosphereSolid");
+    CORRADE_VERIFY(regenerated);
+    CORRADE_COMPARE(regenerated->vertexCount(), 162);
+
+    /* Gradients share the same group, but each has its own cache entry */
+    importer->configuration().group("gradient2D")->setValue("colorA", Color4{1.0f});
+    Containers::Optional<Trade::MeshData> gradient = importer->mesh("gradient2DHorizontal");
+    Containers::Optional<Trade::MeshData> gradientVertical = importer->mesh("gradient2DVertical");
+    CORRADE_VERIFY(gradient);
+    CORRADE_VERIFY(gradientVertical);
+    for(Trade::MeshData* m: {&*gradient, &*gradientVertical}) {
+        std::size_t colorACount = 0;
+        for(const Color4& color: m->attribute<Color4>(MeshAttribute::Color))
+            if(color == Color4{1.0f}) ++colorACount;
+        CORRADE_COMPARE(colorACount, 2);
+    }
+}
+
+void PrimitiveImporterTest::meshCacheDisabled() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PrimitiveImporter");
+    importer->configuration().setValue("cacheMeshes", false);
+    CORRADE_VERIFY(importer->openData({}));
+
+    Containers::Optional<Trade::MeshData> mesh = importer->mesh("icosphereSolid");
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexCount(), 42);
+
+    importer->configuration().group("icosphereSolid")->setValue("subdivisions", 2);
+    Containers::Optional<Trade::MeshData> regenerated = importer->mesh("icosphereSolid");
+    CORRADE_VERIFY(regenerated);
+    CORRADE_COMPARE(regenerated->vertexCount(), 162);
+}
+
+void PrimitiveImporterTest::compactIndices() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PrimitiveImporter");
+    CORRADE_VERIFY(importer->openData({}));
+
+    Containers::Optional<Trade::MeshData> original = importer->mesh("icosphereSolid");
+    CORRADE_VERIFY(original);
+    CORRADE_COMPARE(original->indexType(), MeshIndexType::UnsignedInt);
+
+    /* The option is part of the cache key, so changing it regenerates the
+       mesh */
+    importer->configuration().setValue("compactIndices", true);
+    Containers::Optional<Trade::MeshData> compact = importer->mesh("icosphereSolid");
+    CORRADE_VERIFY(compact);
+    CORRADE_COMPARE(compact->indexType(), MeshIndexType::UnsignedShort);
+    CORRADE_COMPARE_AS(compact->indicesAsArray(), original->indicesAsArray(),
+        TestSuite::Compare::Container);
+
+    /* Non-indexed meshes are passed through */
+    Containers::Optional<Trade::MeshData> nonIndexed = importer->mesh("line3D");
+    CORRADE_VERIFY(nonIndexed);
+    CORRADE_VERIFY(!nonIndexed->isIndexed());
+}
+
+void PrimitiveImporterTest::packAttributes() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PrimitiveImporter");
+    importer->configuration().group("uvSphereSolid")->setValue("textureCoordinates", true);
+    importer->configuration().group("uvSphereSolid")->setValue("tangents", true);
+    CORRADE_VERIFY(importer->openData({}));
+
+    Containers::Optional<Trade::MeshData> original = importer->mesh("uvSphereSolid");
+    CORRADE_VERIFY(original);
+
+    importer->configuration().setValue("packAttributes", true);
+    Containers::Optional<Trade::MeshData> packed = importer->mesh("uvSphereSolid");
+    CORRADE_VERIFY(packed);
+    CORRADE_COMPARE(packed->vertexCount(), original->vertexCount());
+    CORRADE_COMPARE_AS(packed->indicesAsArray(), original->indicesAsArray(),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(packed->attributeFormat(MeshAttribute::Position), VertexFormat::Vector3);
+    CORRADE_COMPARE(packed->attributeFormat(MeshAttribute::Normal), VertexFormat::Vector3sNormalized);
+    CORRADE_COMPARE(packed->attributeFormat(MeshAttribute::Tangent), VertexFormat::Vector4sNormalized);
+    CORRADE_COMPARE(packed->attributeFormat(MeshAttribute::TextureCoordinates), VertexFormat::Vector2usNormalized);
+    /* 12 + 8 (6 + padding) + 8 + 4 */
+    CORRADE_COMPARE(packed->attributeStride(MeshAttribute::Position), 32);
+
+    /* Positions are copied, the rest (approximately) matches */
+    CORRADE_COMPARE_AS(packed->positions3DAsArray(), original->positions3DAsArray(),
+        TestSuite::Compare::Container);
+    Containers::Array<Vector3> normals = packed->normalsAsArray();
+    Containers::Array<Vector3> originalNormals = original->normalsAsArray();
+    Containers::Array<Vector2> textureCoordinates = packed->textureCoordinates2DAsArray();
+    Containers::Array<Vector2> originalTextureCoordinates = original->textureCoordinates2DAsArray();
+    for(std::size_t i = 0; i != packed->vertexCount(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE_AS(Math::abs(normals[i] - originalNormals[i]).max(), 1.0e-4f,
+            TestSuite::Compare::LessOrEqual);
+        CORRADE_COMPARE_AS(Math::abs(textureCoordinates[i] - originalTextureCoordinates[i]).max(), 1.0e-4f,
+            TestSuite::Compare::LessOrEqual);
+    }
+}
+
 void PrimitiveImporterTest::scene() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PrimitiveImporter");
 
@@ -212,6 +351,112 @@ void PrimitiveImporterTest::scene() {
 
 }
 
+void PrimitiveImporterTest::instancedScene() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PrimitiveImporter");
+    importer->configuration().group("instancedScene")->setValue("count", 3);
+    CORRADE_VERIFY(importer->openData(nullptr));
+
+    const UnsignedInt primitive2DCount = importer->object2DCount()/4;
+    const UnsignedInt primitive3DCount = importer->object3DCount()/4;
+    CORRADE_COMPARE(primitive2DCount + primitive3DCount, Containers::arraySize(Data));
+
+    /* The default scene stays the same, the instanced one has the rest */
+    CORRADE_COMPARE(importer->defaultScene(), 0);
+    CORRADE_COMPARE(importer->sceneCount(), 2);
+    Containers::Optional<Trade::SceneData> scene = importer->scene(0);
+    CORRADE_VERIFY(scene);
+    CORRADE_COMPARE(scene->children2D().size(), primitive2DCount);
+    CORRADE_COMPARE(scene->children3D().size(), primitive3DCount);
+
+    Containers::Optional<Trade::SceneData> instanced = importer->scene(1);
+    CORRADE_VERIFY(instanced);
+    CORRADE_COMPARE(instanced->children2D().size(), 3*primitive2DCount);
+    CORRADE_COMPARE(instanced->children3D().size(), 3*primitive3DCount);
+    CORRADE_COMPARE(instanced->children2D().front(), primitive2DCount);
+    CORRADE_COMPARE(instanced->children3D().back(), 4*primitive3DCount - 1);
+
+    /* Name mapping should work both ways */
+    Int uvSphere = importer->object3DForName("uvSphereSolid.2");
+    CORRADE_COMPARE_AS(uvSphere, primitive3DCount, TestSuite::Compare::GreaterOrEqual);
+    CORRADE_COMPARE(importer->object3DName(uvSphere), "uvSphereSolid.2");
+    CORRADE_COMPARE(importer->object3DForName("uvSphereSolid.3"), -1);
+    CORRADE_COMPARE(importer->object3DForName("uvSphereSolid.02"), -1);
+    CORRADE_COMPARE(importer->object3DForName("uvSphereSolid."), -1);
+    CORRADE_COMPARE(importer->object3DForName("uvSphere.1"), -1);
+    CORRADE_COMPARE(importer->object2DForName("uvSphereSolid.1"), -1);
+
+    /* The instance references the same mesh as the original object */
+    Containers::Pointer<Trade::ObjectData3D> object3D = importer->object3D(uvSphere);
+    CORRADE_VERIFY(object3D);
+    CORRADE_COMPARE(object3D->instanceType(), Trade::ObjectInstanceType3D::Mesh);
+    CORRADE_COMPARE(importer->meshName(object3D->instance()), "uvSphereSolid");
+
+    /* First instance of the first primitive is in the corner of a 5x5x5 grid
+       (3*25 objects), the second one next to it */
+    Containers::Pointer<Trade::ObjectData3D> first = importer->object3D(primitive3DCount);
+    Containers::Pointer<Trade::ObjectData3D> second = importer->object3D(primitive3DCount + 1);
+    CORRADE_VERIFY(first);
+    CORRADE_VERIFY(second);
+    CORRADE_COMPARE(importer->object3DName(primitive3DCount), "axis3D.0");
+    CORRADE_COMPARE(first->transformation().translation(), (Vector3{-6.0f, -6.0f, -6.0f}));
+    CORRADE_COMPARE(second->transformation().translation(), (Vector3{-3.0f, -6.0f, -6.0f}));
+
+    Containers::Pointer<Trade::ObjectData2D> object2D = importer->object2D("squareSolid.1");
+    CORRADE_VERIFY(object2D);
+    CORRADE_COMPARE(object2D->instanceType(), Trade::ObjectInstanceType2D::Mesh);
+    CORRADE_COMPARE(importer->meshName(object2D->instance()), "squareSolid");
+}
+
+void PrimitiveImporterTest::instancedSceneRandom() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PrimitiveImporter");
+    importer->configuration().group("instancedScene")->setValue("count", 10);
+    importer->configuration().group("instancedScene")->setValue("layout", "random");
+    importer->configuration().group("instancedScene")->setValue("seed", 17);
+    CORRADE_VERIFY(importer->openData(nullptr));
+
+    Containers::Pointer<Trade::ObjectData3D> a = importer->object3D("coneSolid.7");
+    Containers::Pointer<Trade::ObjectData2D> a2D = importer->object2D("circle2DSolid.7");
+    CORRADE_VERIFY(a);
+    CORRADE_VERIFY(a2D);
+
+    /* Querying other objects first doesn't affect the result */
+    CORRADE_VERIFY(importer->object3D("coneSolid.6"));
+    Containers::Pointer<Trade::ObjectData3D> b = importer->object3D("coneSolid.7");
+    CORRADE_VERIFY(b);
+    CORRADE_COMPARE(a->transformation(), b->transformation());
+
+    /* The rotation is a proper one */
+    CORRADE_VERIFY(a->transformation().rotation().isOrthogonal());
+
+    /* Different seed gives a different result */
+    importer->configuration().group("instancedScene")->setValue("seed", 18);
+    Containers::Pointer<Trade::ObjectData3D> c = importer->object3D("coneSolid.7");
+    Containers::Pointer<Trade::ObjectData2D> c2D = importer->object2D("circle2DSolid.7");
+    CORRADE_VERIFY(c);
+    CORRADE_VERIFY(c2D);
+    CORRADE_VERIFY(a->transformation() != c->transformation());
+    CORRADE_VERIFY(a2D->transformation() != c2D->transformation());
+}
+
+void PrimitiveImporterTest::instancedSceneInvalidLayout() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("PrimitiveImporter");
+    importer->configuration().group("instancedScene")->setValue("count", 1);
+    importer->configuration().group("instancedScene")->setValue("layout", "spiral");
+    CORRADE_VERIFY(importer->openData(nullptr));
+
+    /* Objects of the default scene are not affected */
+    CORRADE_VERIFY(importer->object2D(0));
+    CORRADE_VERIFY(importer->object3D(0));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->object2D("squareSolid.0"));
+    CORRADE_VERIFY(!importer->object3D("cubeSolid.0"));
+    CORRADE_COMPARE(out.str(),
+        "Trade::PrimitiveImporter::object2D(): invalid instancedScene layout spiral\n"
+        "Trade::PrimitiveImporter::object3D(): invalid instancedScene layout spiral\n");
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::PrimitiveImporterTest)
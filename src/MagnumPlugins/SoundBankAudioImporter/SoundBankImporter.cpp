@@ -0,0 +1,286 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "SoundBankImporter.h"
+
+#include <cstring>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/Debug.h>
+#include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/Endianness.h>
+#include <Magnum/Audio/BufferFormat.h>
+
+#include "MagnumPlugins/Implementation/audioConversion.h"
+#include "MagnumPlugins/Implementation/importerInput.h"
+
+namespace Magnum { namespace Audio {
+
+namespace {
+
+constexpr const char Signature[]{'M', 'S', 'B', 'K'};
+
+struct Header {
+    char signature[4];
+    UnsignedInt version;
+    UnsignedInt clipCount;
+    UnsignedInt reserved;
+};
+
+enum class Encoding: UnsignedInt {
+    Pcm = 0,
+    Vorbis = 1
+};
+
+struct IndexEntry {
+    UnsignedInt encoding;
+    UnsignedInt format;
+    UnsignedInt frequency;
+    UnsignedInt reserved;
+    UnsignedLong offset;
+    UnsignedLong size;
+};
+
+static_assert(sizeof(Header) == 16 && sizeof(IndexEntry) == 32,
+    "unexpected padding in the file structures");
+
+}
+
+struct SoundBankImporter::State: Trade::Implementation::ImporterInput {
+    struct Clip {
+        Encoding encoding;
+        BufferFormat format;
+        UnsignedInt frequency;
+        /* Points inside the file data */
+        Containers::ArrayView<const char> data;
+        /* Decoded samples of Vorbis clips, filled on first access */
+        Containers::Optional<Containers::Array<char>> decoded;
+    };
+
+    Containers::Array<Clip> clips;
+    /* Instantiated on the first Vorbis clip and reused for the others */
+    Containers::Pointer<AbstractImporter> vorbisImporter;
+};
+
+SoundBankImporter::SoundBankImporter() {
+    /** @todo horrible workaround, fix this properly */
+    configuration().setValue("vorbisPlugin", "VorbisAudioImporter");
+}
+
+SoundBankImporter::SoundBankImporter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImporter{manager, plugin} {}
+
+SoundBankImporter::~SoundBankImporter() = default;
+
+ImporterFeatures SoundBankImporter::doFeatures() const { return ImporterFeature::OpenData; }
+
+bool SoundBankImporter::doIsOpened() const { return !!_state; }
+
+void SoundBankImporter::doClose() { _state = nullptr; }
+
+void SoundBankImporter::doOpenFile(const std::string& filename) {
+    /* Map the file instead of reading it, so opening a large bank doesn't
+       need to read anything but the index. Moving the state in
+       openInternal() doesn't change the data pointer, so the views stay
+       valid. */
+    Containers::Pointer<State> state{Containers::InPlaceInit};
+    if(!state->openFile(filename, "Audio::SoundBankImporter::openFile():")) return;
+    openInternal(std::move(state), "Audio::SoundBankImporter::openFile():");
+}
+
+void SoundBankImporter::doOpenData(const Containers::ArrayView<const char> data) {
+    Containers::Pointer<State> state{Containers::InPlaceInit};
+    state->openData(data);
+    openInternal(std::move(state), "Audio::SoundBankImporter::openData():");
+}
+
+bool SoundBankImporter::openMemory(const Containers::ArrayView<const char> data) {
+    close();
+    Containers::Pointer<State> state{Containers::InPlaceInit};
+    state->openMemory(data);
+    openInternal(std::move(state), "Audio::SoundBankImporter::openMemory():");
+    return isOpened();
+}
+
+void SoundBankImporter::openInternal(Containers::Pointer<State>&& state, const char* const messagePrefix) {
+    const Containers::ArrayView<const char> data = state->in;
+    if(data.size() < sizeof(Header)) {
+        Error{} << messagePrefix << "file header too short, expected at least" << sizeof(Header) << "bytes but got" << data.size();
+        return;
+    }
+
+    /* The memory passed to openMemory() doesn't need to be aligned */
+    Header header;
+    std::memcpy(&header, data.data(), sizeof(Header));
+    Utility::Endianness::littleEndianInPlace(header.version, header.clipCount);
+
+    if(std::memcmp(header.signature, Signature, sizeof(Signature)) != 0) {
+        Error{} << messagePrefix << "invalid signature" << std::string{header.signature, sizeof(header.signature)};
+        return;
+    }
+    if(header.version != 1) {
+        Error{} << messagePrefix << "unsupported version" << header.version;
+        return;
+    }
+    if(!header.clipCount) {
+        Error{} << messagePrefix << "the bank has no clips";
+        return;
+    }
+
+    const std::size_t indexEnd = sizeof(Header) + std::size_t(header.clipCount)*sizeof(IndexEntry);
+    if(data.size() < indexEnd) {
+        Error{} << messagePrefix << "clip index too short, expected at least" << indexEnd << "bytes but got" << data.size();
+        return;
+    }
+
+    state->clips = Containers::Array<State::Clip>{header.clipCount};
+    for(std::size_t i = 0; i != header.clipCount; ++i) {
+        IndexEntry entry;
+        std::memcpy(&entry, data.data() + sizeof(Header) + i*sizeof(IndexEntry), sizeof(IndexEntry));
+        Utility::Endianness::littleEndianInPlace(
+            entry.encoding, entry.format, entry.frequency, entry.offset,
+            entry.size);
+
+        const Encoding encoding = Encoding(entry.encoding);
+        if(encoding != Encoding::Pcm && encoding != Encoding::Vorbis) {
+            Error{} << messagePrefix << "unknown encoding" << entry.encoding << "of clip" << i;
+            return;
+        }
+
+        const BufferFormat format = BufferFormat(entry.format);
+        Implementation::AudioSampleType type;
+        UnsignedInt channelCount;
+        if(!Implementation::audioFormatProperties(format, type, channelCount)) {
+            Error{} << messagePrefix << "unsupported format" << format << "of clip" << i;
+            return;
+        }
+
+        /* Written this way to not overflow with garbage offsets */
+        if(entry.offset > data.size() || entry.size > data.size() - entry.offset) {
+            Error{} << messagePrefix << "clip" << i << "needs" << entry.offset + entry.size << "bytes but the file has only" << data.size();
+            return;
+        }
+
+        const std::size_t frameSize = Implementation::audioSampleSize(type)*channelCount;
+        if(encoding == Encoding::Pcm && entry.size % frameSize) {
+            Error{} << messagePrefix << "size" << entry.size << "of clip" << i << "is not a multiple of" << frameSize << "byte frames";
+            return;
+        }
+
+        State::Clip& clip = state->clips[i];
+        clip.encoding = encoding;
+        clip.format = format;
+        clip.frequency = entry.frequency;
+        clip.data = data.slice(entry.offset, entry.offset + entry.size);
+    }
+
+    /* All good, save the state */
+    _state = std::move(state);
+}
+
+BufferFormat SoundBankImporter::doFormat() const { return _state->clips[0].format; }
+
+UnsignedInt SoundBankImporter::doFrequency() const { return _state->clips[0].frequency; }
+
+Containers::Array<char> SoundBankImporter::doData() {
+    const Containers::Optional<Containers::ArrayView<const char>> data = clipDataInternal(0, "Audio::SoundBankImporter::data():");
+    if(!data) return nullptr;
+
+    Containers::Array<char> copy{Containers::NoInit, data->size()};
+    Utility::copy(*data, copy);
+    return copy;
+}
+
+UnsignedInt SoundBankImporter::clipCount() const {
+    CORRADE_ASSERT(_state,
+        "Audio::SoundBankImporter::clipCount(): no file opened", {});
+    return _state->clips.size();
+}
+
+BufferFormat SoundBankImporter::clipFormat(const UnsignedInt id) const {
+    CORRADE_ASSERT(_state,
+        "Audio::SoundBankImporter::clipFormat(): no file opened", {});
+    CORRADE_ASSERT(id < _state->clips.size(),
+        "Audio::SoundBankImporter::clipFormat(): index" << id << "out of range for" << _state->clips.size() << "clips", {});
+    return _state->clips[id].format;
+}
+
+UnsignedInt SoundBankImporter::clipFrequency(const UnsignedInt id) const {
+    CORRADE_ASSERT(_state,
+        "Audio::SoundBankImporter::clipFrequency(): no file opened", {});
+    CORRADE_ASSERT(id < _state->clips.size(),
+        "Audio::SoundBankImporter::clipFrequency(): index" << id << "out of range for" << _state->clips.size() << "clips", {});
+    return _state->clips[id].frequency;
+}
+
+Containers::Optional<Containers::ArrayView<const char>> SoundBankImporter::clipData(const UnsignedInt id) {
+    CORRADE_ASSERT(_state,
+        "Audio::SoundBankImporter::clipData(): no file opened", {});
+    CORRADE_ASSERT(id < _state->clips.size(),
+        "Audio::SoundBankImporter::clipData(): index" << id << "out of range for" << _state->clips.size() << "clips", {});
+    return clipDataInternal(id, "Audio::SoundBankImporter::clipData():");
+}
+
+Containers::Optional<Containers::ArrayView<const char>> SoundBankImporter::clipDataInternal(const UnsignedInt id, const char* const messagePrefix) {
+    State::Clip& clip = _state->clips[id];
+
+    /* Raw samples are referenced directly, decoded clips from the cache */
+    if(clip.encoding == Encoding::Pcm)
+        return clip.data;
+    if(clip.decoded)
+        return Containers::ArrayView<const char>{*clip.decoded};
+
+    CORRADE_INTERNAL_ASSERT(clip.encoding == Encoding::Vorbis);
+    if(!_state->vorbisImporter) {
+        const std::string plugin = configuration().value("vorbisPlugin");
+        if(!manager() || !(_state->vorbisImporter = manager()->loadAndInstantiate(plugin))) {
+            Error{} << messagePrefix << plugin << "is not available";
+            return Containers::NullOpt;
+        }
+    }
+
+    AbstractImporter& importer = *_state->vorbisImporter;
+    if(!importer.openData(clip.data)) {
+        Error{} << messagePrefix << "cannot decode clip" << id;
+        return Containers::NullOpt;
+    }
+
+    if(importer.format() != clip.format || importer.frequency() != clip.frequency) {
+        Error{} << messagePrefix << "clip" << id << "decoded to" << importer.format() << "at" << importer.frequency() << "Hz but the index says" << clip.format << "at" << clip.frequency << "Hz";
+        importer.close();
+        return Containers::NullOpt;
+    }
+
+    clip.decoded = importer.data();
+    importer.close();
+    return Containers::ArrayView<const char>{*clip.decoded};
+}
+
+}}
+
+CORRADE_PLUGIN_REGISTER(SoundBankAudioImporter, Magnum::Audio::SoundBankImporter,
+    "cz.mosra.magnum.Audio.AbstractImporter/0.1")
@@ -0,0 +1,240 @@
+#ifndef Magnum_Audio_SoundBankImporter_h
+#define Magnum_Audio_SoundBankImporter_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+/** @file
+ * @brief Class @ref Magnum::Audio::SoundBankImporter
+ * @m_since_latest
+ */
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Magnum/Audio/AbstractImporter.h>
+
+#include "MagnumPlugins/SoundBankAudioImporter/configure.h"
+
+#ifndef DOXYGEN_GENERATING_OUTPUT
+#ifndef MAGNUM_SOUNDBANKAUDIOIMPORTER_BUILD_STATIC
+    #ifdef SoundBankAudioImporter_EXPORTS
+        #define MAGNUM_SOUNDBANKAUDIOIMPORTER_EXPORT CORRADE_VISIBILITY_EXPORT
+    #else
+        #define MAGNUM_SOUNDBANKAUDIOIMPORTER_EXPORT CORRADE_VISIBILITY_IMPORT
+    #endif
+#else
+    #define MAGNUM_SOUNDBANKAUDIOIMPORTER_EXPORT CORRADE_VISIBILITY_STATIC
+#endif
+#define MAGNUM_SOUNDBANKAUDIOIMPORTER_LOCAL CORRADE_VISIBILITY_LOCAL
+#else
+#define MAGNUM_SOUNDBANKAUDIOIMPORTER_EXPORT
+#define MAGNUM_SOUNDBANKAUDIOIMPORTER_LOCAL
+#endif
+
+namespace Magnum { namespace Audio {
+
+/**
+@brief Sound bank importer plugin
+@m_since_latest
+
+Imports sound banks --- many short clips packed into a single file with an
+index at the beginning. Compared to having each clip in a separate file and
+opening it with a separate importer instance, the whole bank is a single
+memory-mapped file and properties of all clips are known right after opening,
+without decoding anything. Clips can be stored either as raw PCM samples or as
+Ogg Vorbis streams.
+
+@section Audio-SoundBankImporter-usage Usage
+
+This plugin depends on the @ref Audio library and is built if
+`WITH_SOUNDBANKAUDIOIMPORTER` is enabled when building Magnum Plugins. To use
+as a dynamic plugin, load @cpp "SoundBankAudioImporter" @ce via
+@ref Corrade::PluginManager::Manager.
+
+Additionally, if you're using Magnum as a CMake subproject, bundle the
+[magnum-plugins repository](https://github.com/mosra/magnum-plugins) and do the
+following:
+
+@code{.cmake}
+set(WITH_SOUNDBANKAUDIOIMPORTER ON CACHE BOOL "" FORCE)
+add_subdirectory(magnum-plugins EXCLUDE_FROM_ALL)
+
+# So the dynamically loaded plugin gets built implicitly
+add_dependencies(your-app MagnumPlugins::SoundBankAudioImporter)
+@endcode
+
+To use as a static plugin or as a dependency of another plugin with CMake, put
+[FindMagnumPlugins.cmake](https://github.com/mosra/magnum-plugins/blob/master/modules/FindMagnumPlugins.cmake)
+into your `modules/` directory, request the `SoundBankAudioImporter` component
+of the `MagnumPlugins` package and link to the
+`MagnumPlugins::SoundBankAudioImporter` target:
+
+@code{.cmake}
+find_package(MagnumPlugins REQUIRED SoundBankAudioImporter)
+
+# ...
+target_link_libraries(your-app PRIVATE MagnumPlugins::SoundBankAudioImporter)
+@endcode
+
+See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
+information.
+
+@section Audio-SoundBankImporter-behavior Behavior and limitations
+
+Files passed to @ref openFile() are memory-mapped on platforms that support
+it, data passed to @ref openData() are copied and @ref openMemory() references
+the memory directly. Opening a bank parses just the index, @ref clipCount(),
+@ref clipFormat() and @ref clipFrequency() then don't need to touch the clip
+data at all. The generic @ref format(), @ref frequency() and @ref data()
+interface exposes the first clip, so a bank with a single clip can be used in
+place of a regular audio file.
+
+Raw PCM clips are never decoded or copied, @ref clipData() returns a view
+directly on the file data. Vorbis clips are decoded on the first call to
+@ref clipData() for given clip and the result is kept until the file is
+closed. Decoding is delegated to the plugin named in the
+@cb{.ini} vorbisPlugin @ce
+@ref Audio-SoundBankImporter-configuration "configuration option", which is by
+default any plugin that provides `VorbisAudioImporter`, such as
+@ref StbVorbisImporter "StbVorbisAudioImporter". A single instance of it is
+created on the first Vorbis clip and reused for all others. The decoded format
+and frequency is expected to match the index.
+
+@section Audio-SoundBankImporter-format File format
+
+The file consists of a header, a clip index and clip data. All values are
+little-endian, offsets are from the beginning of the file. The header is 16
+bytes:
+
+Offset  | Type              | Description
+------- | ----------------- | -----------
+0       | @cpp char[4] @ce  | Signature, @cpp "MSBK" @ce
+4       | @ref UnsignedInt  | Version, currently @cpp 1 @ce
+8       | @ref UnsignedInt  | Count of clips, at least @cpp 1 @ce
+12      | @ref UnsignedInt  | Reserved, @cpp 0 @ce
+
+It's directly followed by a 32-byte index entry for each clip:
+
+Offset  | Type              | Description
+------- | ----------------- | -----------
+0       | @ref UnsignedInt  | Encoding, @cpp 0 @ce for raw PCM, @cpp 1 @ce for Ogg Vorbis
+4       | @ref UnsignedInt  | @ref BufferFormat value, which is the corresponding OpenAL constant
+8       | @ref UnsignedInt  | Frequency in Hz
+12      | @ref UnsignedInt  | Reserved, @cpp 0 @ce
+16      | @ref UnsignedLong | Offset of the clip data
+24      | @ref UnsignedLong | Size of the clip data
+
+Raw PCM clip data are samples in the layout implied by the format, with the
+size being a whole number of sample frames. Ogg Vorbis clip data are a
+complete Ogg file, with the format and frequency the file decodes to. The clip
+data don't need to be in any particular order and can be shared by more
+clips.
+
+@section Audio-SoundBankImporter-configuration Plugin-specific configuration
+
+It's possible to tune various import options through @ref configuration(). See
+below for all options and their default values:
+
+@snippet MagnumPlugins/SoundBankAudioImporter/SoundBankAudioImporter.conf config
+*/
+class MAGNUM_SOUNDBANKAUDIOIMPORTER_EXPORT SoundBankImporter: public AbstractImporter {
+    public:
+        /** @brief Default constructor */
+        explicit SoundBankImporter();
+
+        /** @brief Plugin manager constructor */
+        explicit SoundBankImporter(PluginManager::AbstractManager& manager, const std::string& plugin);
+
+        ~SoundBankImporter();
+
+        /**
+         * @brief Open raw data without making a copy
+         *
+         * Compared to @ref openData(), the importer references @p data
+         * directly instead of making a copy, which means the memory has to
+         * stay valid and unchanged until the importer is closed or another
+         * file is opened. Closes previous file, if it was opened, and tries
+         * to open given memory. Returns @cpp true @ce on success,
+         * @cpp false @ce otherwise.
+         */
+        virtual bool openMemory(Containers::ArrayView<const char> data);
+
+        /**
+         * @brief Clip count
+         *
+         * Expects that a file is opened. Always at least @cpp 1 @ce.
+         */
+        virtual UnsignedInt clipCount() const;
+
+        /**
+         * @brief Clip format
+         *
+         * Expects that a file is opened and @p id is less than
+         * @ref clipCount(). Known from the index, doesn't decode the clip.
+         */
+        virtual BufferFormat clipFormat(UnsignedInt id) const;
+
+        /**
+         * @brief Clip frequency
+         *
+         * Expects that a file is opened and @p id is less than
+         * @ref clipCount(). Known from the index, doesn't decode the clip.
+         */
+        virtual UnsignedInt clipFrequency(UnsignedInt id) const;
+
+        /**
+         * @brief Clip data
+         *
+         * Expects that a file is opened and @p id is less than
+         * @ref clipCount(). For raw PCM clips returns a view directly on the
+         * file data, Vorbis clips are decoded on the first call and the view
+         * points to the decoded samples. In both cases the view is valid
+         * until the file is closed. If the clip fails to decode, prints a
+         * message to @ref Error and returns @ref Containers::NullOpt. See
+         * @ref Audio-SoundBankImporter-behavior for more information.
+         */
+        virtual Containers::Optional<Containers::ArrayView<const char>> clipData(UnsignedInt id);
+
+    private:
+        struct State;
+
+        MAGNUM_SOUNDBANKAUDIOIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
+        MAGNUM_SOUNDBANKAUDIOIMPORTER_LOCAL bool doIsOpened() const override;
+        MAGNUM_SOUNDBANKAUDIOIMPORTER_LOCAL void doOpenFile(const std::string& filename) override;
+        MAGNUM_SOUNDBANKAUDIOIMPORTER_LOCAL void doOpenData(Containers::ArrayView<const char> data) override;
+        MAGNUM_SOUNDBANKAUDIOIMPORTER_LOCAL void openInternal(Containers::Pointer<State>&& state, const char* messagePrefix);
+        MAGNUM_SOUNDBANKAUDIOIMPORTER_LOCAL void doClose() override;
+
+        MAGNUM_SOUNDBANKAUDIOIMPORTER_LOCAL BufferFormat doFormat() const override;
+        MAGNUM_SOUNDBANKAUDIOIMPORTER_LOCAL UnsignedInt doFrequency() const override;
+        MAGNUM_SOUNDBANKAUDIOIMPORTER_LOCAL Containers::Array<char> doData() override;
+
+        MAGNUM_SOUNDBANKAUDIOIMPORTER_LOCAL Containers::Optional<Containers::ArrayView<const char>> clipDataInternal(UnsignedInt id, const char* messagePrefix);
+
+        Containers::Pointer<State> _state;
+};
+
+}}
+
+#endif
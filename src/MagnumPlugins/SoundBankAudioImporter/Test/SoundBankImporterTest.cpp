@@ -0,0 +1,263 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstring>
+#include <sstream>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/Directory.h>
+#include <Corrade/Utility/Endianness.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Magnum/Audio/AbstractImporter.h>
+
+#include "MagnumPlugins/SoundBankAudioImporter/SoundBankImporter.h"
+
+#include "configure.h"
+
+namespace Magnum { namespace Audio { namespace Test { namespace {
+
+struct SoundBankImporterTest: TestSuite::Tester {
+    explicit SoundBankImporterTest();
+
+    void invalid();
+
+    void pcm();
+    void pcmOpenMemory();
+    void firstClip();
+
+    void vorbis();
+    void vorbisPluginNotFound();
+    void vorbisMismatch();
+
+    void openTwice();
+
+    /* Explicitly forbid system-wide plugin dependencies */
+    PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
+};
+
+/* The bank.msbk file has a Mono16 PCM clip, a Stereo8 PCM clip and a Mono16
+   Vorbis clip, 4143 bytes in total, with the data starting at 112 */
+constexpr struct {
+    const char* name;
+    std::size_t prefix;
+    std::size_t patchOffset;
+    UnsignedInt patchValue;
+    const char* message;
+} InvalidData[]{
+    {"header too short", 15, 0, 0,
+        "file header too short, expected at least 16 bytes but got 15"},
+    {"invalid signature", 4143, 0, 0x4b425358,
+        "invalid signature XSBK"},
+    {"unsupported version", 4143, 4, 2,
+        "unsupported version 2"},
+    {"no clips", 4143, 8, 0,
+        "the bank has no clips"},
+    {"index too short", 111, 0, 0x4b42534d,
+        "clip index too short, expected at least 112 bytes but got 111"},
+    {"unknown encoding", 4143, 16 + 32, 2,
+        "unknown encoding 2 of clip 1"},
+    {"unsupported format", 4143, 16 + 32 + 4, 0xdead,
+        "unsupported format Audio::BufferFormat(0xdead) of clip 1"},
+    {"clip out of bounds", 4142, 0, 0x4b42534d,
+        "clip 2 needs 4143 bytes but the file has only 4142"},
+    {"clip offset out of bounds", 4143, 16 + 16, 0xffffff00,
+        "clip 0 needs 4294967044 bytes but the file has only 4143"},
+    {"PCM clip not whole frames", 4143, 16 + 24, 3,
+        "size 3 of clip 0 is not a multiple of 2 byte frames"}
+};
+
+SoundBankImporterTest::SoundBankImporterTest() {
+    addInstancedTests({&SoundBankImporterTest::invalid},
+        Containers::arraySize(InvalidData));
+
+    addTests({&SoundBankImporterTest::pcm,
+              &SoundBankImporterTest::pcmOpenMemory,
+              &SoundBankImporterTest::firstClip,
+
+              &SoundBankImporterTest::vorbis,
+              &SoundBankImporterTest::vorbisPluginNotFound,
+              &SoundBankImporterTest::vorbisMismatch,
+
+              &SoundBankImporterTest::openTwice});
+
+    /* Load the plugin directly from the build tree. Otherwise it's static and
+       already loaded. */
+    #ifdef SOUNDBANKAUDIOIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(SOUNDBANKAUDIOIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+    /* The Vorbis importer is optional */
+    #ifdef STBVORBISAUDIOIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(STBVORBISAUDIOIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+void SoundBankImporterTest::invalid() {
+    auto&& data = InvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Array<char> file = Utility::Directory::read(Utility::Directory::join(SOUNDBANKAUDIOIMPORTER_TEST_DIR, "bank.msbk"));
+    CORRADE_COMPARE(file.size(), 4143);
+    const UnsignedInt value = Utility::Endianness::littleEndian(data.patchValue);
+    std::memcpy(file + data.patchOffset, &value, sizeof(UnsignedInt));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("SoundBankAudioImporter");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->openData(file.prefix(data.prefix)));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Audio::SoundBankImporter::openData(): {}\n", data.message));
+}
+
+void SoundBankImporterTest::pcm() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("SoundBankAudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(SOUNDBANKAUDIOIMPORTER_TEST_DIR, "bank.msbk")));
+
+    auto& bank = static_cast<SoundBankImporter&>(*importer);
+    CORRADE_COMPARE(bank.clipCount(), 3);
+    CORRADE_COMPARE(bank.clipFormat(0), BufferFormat::Mono16);
+    CORRADE_COMPARE(bank.clipFrequency(0), 44000);
+    CORRADE_COMPARE(bank.clipFormat(1), BufferFormat::Stereo8);
+    CORRADE_COMPARE(bank.clipFrequency(1), 96000);
+    /* Known without decoding */
+    CORRADE_COMPARE(bank.clipFormat(2), BufferFormat::Mono16);
+    CORRADE_COMPARE(bank.clipFrequency(2), 96000);
+
+    /* Same as in the DrWavImporter test for the original files */
+    Containers::Optional<Containers::ArrayView<const char>> clip0 = bank.clipData(0);
+    CORRADE_VERIFY(clip0);
+    CORRADE_COMPARE_AS(*clip0,
+        Containers::arrayView<char>({'\x1d', '\x10', '\x71', '\xc5'}),
+        TestSuite::Compare::Container);
+
+    Containers::Optional<Containers::ArrayView<const char>> clip1 = bank.clipData(1);
+    CORRADE_VERIFY(clip1);
+    CORRADE_COMPARE_AS(*clip1,
+        Containers::arrayView<char>({'\xde', '\xfe', '\xca', '\x7e'}),
+        TestSuite::Compare::Container);
+}
+
+void SoundBankImporterTest::pcmOpenMemory() {
+    Containers::Array<char> file = Utility::Directory::read(Utility::Directory::join(SOUNDBANKAUDIOIMPORTER_TEST_DIR, "bank.msbk"));
+    CORRADE_VERIFY(file);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("SoundBankAudioImporter");
+    auto& bank = static_cast<SoundBankImporter&>(*importer);
+    CORRADE_VERIFY(bank.openMemory(file));
+
+    /* The PCM samples point directly into the memory */
+    Containers::Optional<Containers::ArrayView<const char>> clip1 = bank.clipData(1);
+    CORRADE_VERIFY(clip1);
+    CORRADE_COMPARE(static_cast<const void*>(clip1->data()), static_cast<const void*>(file + 116));
+    CORRADE_COMPARE(clip1->size(), 4);
+}
+
+void SoundBankImporterTest::firstClip() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("SoundBankAudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(SOUNDBANKAUDIOIMPORTER_TEST_DIR, "bank.msbk")));
+
+    /* The generic interface exposes the first clip */
+    CORRADE_COMPARE(importer->format(), BufferFormat::Mono16);
+    CORRADE_COMPARE(importer->frequency(), 44000);
+    CORRADE_COMPARE_AS(importer->data(),
+        (Containers::Array<char>{Containers::InPlaceInit, {
+            '\x1d', '\x10', '\x71', '\xc5'}}),
+        TestSuite::Compare::Container);
+}
+
+void SoundBankImporterTest::vorbis() {
+    if(_manager.loadState("StbVorbisAudioImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("StbVorbisAudioImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("SoundBankAudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(SOUNDBANKAUDIOIMPORTER_TEST_DIR, "bank.msbk")));
+
+    /* Same as in the StbVorbisImporter test for the original file */
+    auto& bank = static_cast<SoundBankImporter&>(*importer);
+    Containers::Optional<Containers::ArrayView<const char>> clip = bank.clipData(2);
+    CORRADE_VERIFY(clip);
+    CORRADE_COMPARE_AS(*clip,
+        Containers::arrayView<char>({'\xcd', '\x0a', '\x2b', '\x0a'}),
+        TestSuite::Compare::Container);
+
+    /* Second access returns the already decoded data */
+    Containers::Optional<Containers::ArrayView<const char>> clipAgain = bank.clipData(2);
+    CORRADE_VERIFY(clipAgain);
+    CORRADE_COMPARE(static_cast<const void*>(clipAgain->data()), static_cast<const void*>(clip->data()));
+    CORRADE_COMPARE(clipAgain->size(), clip->size());
+}
+
+void SoundBankImporterTest::vorbisPluginNotFound() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("SoundBankAudioImporter");
+    importer->configuration().setValue("vorbisPlugin", "NonexistentVorbisAudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(SOUNDBANKAUDIOIMPORTER_TEST_DIR, "bank.msbk")));
+
+    std::ostringstream out;
+    {
+        Error redirectError{&out};
+        CORRADE_VERIFY(!static_cast<SoundBankImporter&>(*importer).clipData(2));
+    }
+    CORRADE_COMPARE(out.str(),
+        "PluginManager::Manager::load(): plugin NonexistentVorbisAudioImporter is not static and was not found in nonexistent\n"
+        "Audio::SoundBankImporter::clipData(): NonexistentVorbisAudioImporter is not available\n");
+
+    /* PCM clips are still accessible */
+    CORRADE_VERIFY(static_cast<SoundBankImporter&>(*importer).clipData(0));
+}
+
+void SoundBankImporterTest::vorbisMismatch() {
+    if(_manager.loadState("StbVorbisAudioImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("StbVorbisAudioImporter plugin not found, cannot test");
+
+    /* Change the frequency of the Vorbis clip in the index */
+    Containers::Array<char> file = Utility::Directory::read(Utility::Directory::join(SOUNDBANKAUDIOIMPORTER_TEST_DIR, "bank.msbk"));
+    CORRADE_VERIFY(file);
+    const UnsignedInt frequency = Utility::Endianness::littleEndian(48000u);
+    std::memcpy(file + 16 + 2*32 + 8, &frequency, sizeof(UnsignedInt));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("SoundBankAudioImporter");
+    CORRADE_VERIFY(importer->openData(file));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!static_cast<SoundBankImporter&>(*importer).clipData(2));
+    CORRADE_COMPARE(out.str(), "Audio::SoundBankImporter::clipData(): clip 2 decoded to Audio::BufferFormat::Mono16 at 96000 Hz but the index says Audio::BufferFormat::Mono16 at 48000 Hz\n");
+}
+
+void SoundBankImporterTest::openTwice() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("SoundBankAudioImporter");
+
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(SOUNDBANKAUDIOIMPORTER_TEST_DIR, "bank.msbk")));
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(SOUNDBANKAUDIOIMPORTER_TEST_DIR, "bank.msbk")));
+
+    /* Shouldn't crash, leak or anything */
+    CORRADE_COMPARE(static_cast<SoundBankImporter&>(*importer).clipCount(), 3);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Audio::Test::SoundBankImporterTest)
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+
+#
+#   This file is part of Magnum.
+#
+#   Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+#               2020 Vladimír Vondruš <mosra@centrum.cz>
+#
+#   Permission is hereby granted, free of charge, to any person obtaining a
+#   copy of this software and associated documentation files (the "Software"),
+#   to deal in the Software without restriction, including without limitation
+#   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+#   and/or sell copies of the Software, and to permit persons to whom the
+#   Software is furnished to do so, subject to the following conditions:
+#
+#   The above copyright notice and this permission notice shall be included
+#   in all copies or substantial portions of the Software.
+#
+#   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+#   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+#   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+#   DEALINGS IN THE SOFTWARE.
+#
+
+# Packs WAV and Ogg Vorbis files into a sound bank for
+# SoundBankAudioImporter. Only 8- and 16-bit mono and stereo PCM WAVs are
+# supported, their samples are stored raw; Ogg files are stored as-is, with
+# the format and frequency taken from the Vorbis identification header.
+# Usage:
+#
+#   ./soundbank.py file.wav file.ogg ... bank.msbk
+
+import struct
+import sys
+
+filesIn = sys.argv[1:-1]
+fileOut = sys.argv[-1]
+
+# OpenAL constants, equivalent to Audio::BufferFormat values
+formats = {
+    (1, 8): 0x1100, # Mono8
+    (1, 16): 0x1101, # Mono16
+    (2, 8): 0x1102, # Stereo8
+    (2, 16): 0x1103 # Stereo16
+}
+
+def wav(data):
+    assert data[0:4] == b'RIFF' and data[8:12] == b'WAVE', "not a WAV file"
+    offset = 12
+    channels, frequency, bits, samples = None, None, None, None
+    while offset + 8 <= len(data):
+        id, size = struct.unpack_from('<4sI', data, offset)
+        if id == b'fmt ':
+            tag, channels, frequency, _, _, bits = struct.unpack_from('<HHIIHH', data, offset + 8)
+            assert tag == 1, "only integer PCM WAVs are supported"
+        elif id == b'data':
+            samples = data[offset + 8:offset + 8 + size]
+        offset += 8 + size + (size & 1)
+    assert (channels, bits) in formats, "unsupported channel count or bit depth"
+    return 0, formats[(channels, bits)], frequency, samples
+
+def ogg(data):
+    assert data[0:4] == b'OggS', "not an Ogg file"
+    # The identification header is in the first page, right after the
+    # segment table
+    header = 27 + data[26]
+    assert data[header:header + 7] == b'\x01vorbis', "not an Ogg Vorbis file"
+    channels, frequency = struct.unpack_from('<BI', data, header + 11)
+    # Decoded to 16-bit samples
+    assert (channels, 16) in formats, "unsupported channel count"
+    return 1, formats[(channels, 16)], frequency, data
+
+clips = []
+for file in filesIn:
+    with open(file, 'rb') as f: data = f.read()
+    clips += [ogg(data) if file.endswith('.ogg') else wav(data)]
+
+out = struct.pack('<4sIII', b'MSBK', 1, len(clips), 0)
+offset = 16 + 32*len(clips)
+payload = b''
+for encoding, format, frequency, data in clips:
+    out += struct.pack('<IIIIQQ', encoding, format, frequency, 0, offset + len(payload), len(data))
+    payload += data
+
+with open(fileOut, 'wb') as f:
+    f.write(out + payload)
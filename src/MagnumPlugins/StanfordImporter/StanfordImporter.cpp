@@ -25,7 +25,15 @@
 
 #include "StanfordImporter.h"
 
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
@@ -37,20 +45,74 @@
 #include <Corrade/Utility/String.h>
 #include <Magnum/Mesh.h>
 #include <Magnum/Math/Color.h>
-#include <Magnum/MeshTools/Combine.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Trade/ArrayAllocator.h>
 #include <Magnum/Trade/MeshData.h>
 
+#ifdef MAGNUM_STANFORDIMPORTER_WITH_PROFILING
+#define MAGNUM_IMPORTERPROFILING_ENABLED
+#endif
+#include "MagnumPlugins/Implementation/importerProfiling.h"
+
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#elif defined(CORRADE_TARGET_ARM) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace Magnum { namespace Trade {
 
+#if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+#define _STANFORDIMPORTER_USE_MAP
+#endif
+
 struct StanfordImporter::State {
+    /* Either a copy of the data passed to openData() or a memory-mapped file
+       passed to openFile(). The parsing only ever looks at the `in` view,
+       which points to one of these. */
     Containers::Array<char> data;
+    #ifdef _STANFORDIMPORTER_USE_MAP
+    Containers::Array<const char, Utility::Directory::MapDeleter> mappedData;
+    #endif
+    /* For ASCII files the body is converted to a native-endian binary
+       representation during open, the original data are not kept */
+    Containers::Array<char> convertedData;
+    Containers::ArrayView<const char> in;
     std::size_t headerSize;
     Containers::Array<MeshAttributeData> attributeData;
     Containers::Array<MeshAttributeData> faceAttributeData;
     UnsignedInt vertexStride{}, vertexCount{}, faceIndicesOffset{}, faceSkip{}, faceCount{};
     MeshIndexType faceSizeType{}, faceIndexType{};
     bool fileFormatNeedsEndianSwapping;
+    bool ascii{};
+    /* Set if there's no face element in the file */
+    bool pointCloud{};
+    /* If endian swap is needed, contains source byte index for every
+       destination byte of a vertex and of a (triangulated) face with the
+       indices excluded */
+    Containers::Array<UnsignedInt> vertexSwapPattern;
+    Containers::Array<UnsignedInt> faceSwapPattern;
+
+    /* Returned from importerState(). If headerOnly is set, the body wasn't
+       read at all. */
+    StanfordImporterHeader header;
+    bool headerOnly{};
+
+    /* Used by the chunked import. The buffer is reused for all chunks, face
+       chunk offsets are calculated on first access for given chunk size. */
+    Containers::Array<char> chunkData;
+    Containers::Array<std::size_t> faceChunkOffsets;
+    UnsignedInt faceChunkOffsetsChunkSize{};
+
+    /* Used by Morton-ordered point clouds. Imported attributes reordered
+       along the curve, with per-chunk bounds. Calculated on first access,
+       recalculated if the attribute filter or chunk size changes. */
+    bool sorted{};
+    std::string sortedAttributes;
+    UnsignedInt sortedChunkSize{};
+    Containers::Array<char> sortedVertexData;
+    Containers::Array<MeshAttributeData> sortedAttributeData;
+    Containers::Array<Range3D> sortedBounds;
 
     std::unordered_map<std::string, MeshAttribute> attributeNameMap;
     Containers::Array<std::string> attributeNames;
@@ -61,12 +123,20 @@ StanfordImporter::StanfordImporter() {
     configuration().setValue("perFaceToPerVertex", true);
     configuration().setValue("triangleFastPath", true);
     configuration().setValue("objectIdAttribute", "object_id");
+    configuration().setValue("zeroCopy", false);
+    configuration().setValue("threads", 1);
+    configuration().setValue("mortonOrder", false);
 }
 
 StanfordImporter::StanfordImporter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImporter{manager, plugin} {}
 
 StanfordImporter::~StanfordImporter() = default;
 
+void StanfordImporter::setProfilingCallback(void(*callback)(const char*, UnsignedLong, std::size_t, void*), void* userData) {
+    _profilingCallback = callback;
+    _profilingUserData = userData;
+}
+
 ImporterFeatures StanfordImporter::doFeatures() const { return ImporterFeature::OpenData; }
 
 bool StanfordImporter::doIsOpened() const { return !!_state; }
@@ -79,13 +149,51 @@ void StanfordImporter::doOpenFile(const std::string& filename) {
         return;
     }
 
-    openDataInternal(Utility::Directory::read(filename));
+    /* Map the file instead of reading it to avoid having the whole file
+       copied in memory. The mapping is moved to the state only if the parsing
+       succeeded, moving it doesn't change the data pointer so the view saved
+       in the state stays valid. */
+    /* ASCII files are converted during the open, so the original data don't
+       need to be kept in that case */
+    /* If only the header is requested, read the file until the end of the
+       header is found and don't keep anything */
+    if(configuration().value<bool>("headerOnly")) {
+        std::ifstream file{filename, std::ios::binary};
+        std::string header;
+        char buffer[4096];
+        while(file) {
+            file.read(buffer, sizeof(buffer));
+            const std::size_t searchFrom = header.size() < 10 ? 0 : header.size() - 10;
+            header.append(buffer, file.gcount());
+            if(header.find("end_header", searchFrom) != std::string::npos)
+                break;
+        }
+        openDataInternal({header.data(), header.size()});
+        return;
+    }
+
+    #ifdef _STANFORDIMPORTER_USE_MAP
+    Containers::Array<const char, Utility::Directory::MapDeleter> data = Utility::Directory::mapRead(filename);
+    openDataInternal(data);
+    if(_state && !_state->ascii) _state->mappedData = std::move(data);
+    #else
+    Containers::Array<char> data = Utility::Directory::read(filename);
+    openDataInternal(data);
+    if(_state && !_state->ascii) _state->data = std::move(data);
+    #endif
 }
 
 void StanfordImporter::doOpenData(Containers::ArrayView<const char> data) {
-    Containers::Array<char> copy{Containers::NoInit, data.size()};
-    Utility::copy(data, copy);
-    openDataInternal(std::move(copy));
+    /* The data are guaranteed to be valid only during this call, so parse them
+       directly and make a copy only if needed -- for ASCII files the
+       converted binary data are kept instead */
+    openDataInternal(data);
+    if(_state && !_state->ascii && !_state->headerOnly) {
+        MAGNUM_IMPORTER_PROFILE(profile, _profilingCallback, _profilingUserData, "copy", data.size());
+        _state->data = Containers::Array<char>{Containers::NoInit, data.size()};
+        Utility::copy(data, _state->data);
+        _state->in = _state->data;
+    }
 }
 
 namespace {
@@ -166,6 +274,344 @@ std::string extractLine(Containers::ArrayView<const char>& in) {
     return {out.begin(), out.end()};
 }
 
+VertexFormat indexTypeFormat(const MeshIndexType type) {
+    switch(type) {
+        /* LCOV_EXCL_START */
+        #define _c(type) case MeshIndexType::type: return VertexFormat::type;
+        _c(UnsignedByte)
+        _c(UnsignedShort)
+        _c(UnsignedInt)
+        #undef _c
+        /* LCOV_EXCL_STOP */
+
+        default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    }
+}
+
+inline bool isAsciiWhitespace(const char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/* Powers of ten that are exactly representable in a double */
+constexpr Double ExactPowersOfTen[]{
+    1.0e0, 1.0e1, 1.0e2, 1.0e3, 1.0e4, 1.0e5, 1.0e6, 1.0e7, 1.0e8, 1.0e9,
+    1.0e10, 1.0e11, 1.0e12, 1.0e13, 1.0e14, 1.0e15, 1.0e16, 1.0e17, 1.0e18,
+    1.0e19, 1.0e20, 1.0e21, 1.0e22
+};
+
+/* Parses a single whitespace-delimited number from an ASCII PLY body into
+   the binary representation of given format. Integers and the common case of
+   floating-point literals with at most 19 significant digits and a small
+   exponent are parsed directly without any allocation or locale lookup, the
+   rest (long mantissas, huge exponents, inf/nan) goes through std::strtod().
+   Returns false if there's no more data or the value is not a valid number. */
+bool parseAsciiValue(const char*& pos, const char* const end, const VertexFormat format, char* const out) {
+    while(pos != end && isAsciiWhitespace(*pos)) ++pos;
+    const char* const begin = pos;
+    while(pos != end && !isAsciiWhitespace(*pos)) ++pos;
+    if(pos == begin) return false;
+
+    if(format == VertexFormat::Float || format == VertexFormat::Double) {
+        const char* i = begin;
+        const bool negative = *i == '-';
+        if(*i == '-' || *i == '+') ++i;
+
+        UnsignedLong mantissa = 0;
+        Int exponent = 0;
+        Int significantDigits = 0;
+        bool anyDigits = false;
+        for(; i != pos && *i >= '0' && *i <= '9'; ++i) {
+            mantissa = mantissa*10 + (*i - '0');
+            if(mantissa) ++significantDigits;
+            anyDigits = true;
+        }
+        if(i != pos && *i == '.') for(++i; i != pos && *i >= '0' && *i <= '9'; ++i) {
+            mantissa = mantissa*10 + (*i - '0');
+            if(mantissa) ++significantDigits;
+            --exponent;
+            anyDigits = true;
+        }
+        if(anyDigits && i != pos && (*i == 'e' || *i == 'E')) {
+            ++i;
+            const bool negativeExponent = i != pos && *i == '-';
+            if(i != pos && (*i == '-' || *i == '+')) ++i;
+            Int value = 0;
+            bool anyExponentDigits = false;
+            for(; i != pos && *i >= '0' && *i <= '9'; ++i) {
+                if(value < 100000) value = value*10 + (*i - '0');
+                anyExponentDigits = true;
+            }
+            if(!anyExponentDigits) return false;
+            exponent += negativeExponent ? -value : value;
+        }
+
+        Double value;
+        /* Fast path -- the whole token consumed, mantissa exactly
+           representable and the power of ten as well, so a single
+           multiplication or division gives a correctly rounded result */
+        if(anyDigits && i == pos && significantDigits <= 19 && mantissa < (1ull << 53) && exponent >= -22 && exponent <= 22) {
+            value = Double(mantissa);
+            if(exponent < 0) value /= ExactPowersOfTen[-exponent];
+            else value *= ExactPowersOfTen[exponent];
+            if(negative) value = -value;
+
+        /* Slow path. The input isn't null-terminated, so copy the token to a
+           local buffer first */
+        } else {
+            char buffer[128];
+            const std::size_t size = pos - begin;
+            if(size >= sizeof(buffer)) return false;
+            std::memcpy(buffer, begin, size);
+            buffer[size] = '\0';
+            char* parsedEnd;
+            value = std::strtod(buffer, &parsedEnd);
+            if(parsedEnd != buffer + size) return false;
+        }
+
+        if(format == VertexFormat::Float) {
+            const Float floatValue = Float(value);
+            std::memcpy(out, &floatValue, sizeof(Float));
+        } else std::memcpy(out, &value, sizeof(Double));
+        return true;
+    }
+
+    /* Integers. Like with the binary format, values out of range of the type
+       are silently wrapped around. */
+    const char* i = begin;
+    const bool negative = *i == '-';
+    if(*i == '-' || *i == '+') ++i;
+    if(i == pos) return false;
+    UnsignedLong value = 0;
+    for(; i != pos; ++i) {
+        if(*i < '0' || *i > '9') return false;
+        value = value*10 + (*i - '0');
+    }
+    if(negative) value = ~value + 1;
+
+    switch(format) {
+        case VertexFormat::UnsignedByte:
+        case VertexFormat::Byte: {
+            const UnsignedByte v = value;
+            std::memcpy(out, &v, sizeof(v));
+        } break;
+        case VertexFormat::UnsignedShort:
+        case VertexFormat::Short: {
+            const UnsignedShort v = value;
+            std::memcpy(out, &v, sizeof(v));
+        } break;
+        case VertexFormat::UnsignedInt:
+        case VertexFormat::Int: {
+            const UnsignedInt v = value;
+            std::memcpy(out, &v, sizeof(v));
+        } break;
+        default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+    }
+
+    return true;
+}
+
+/* Name under which a builtin attribute is matched in the attributes option */
+const char* builtinAttributeName(const MeshAttribute name) {
+    switch(name) {
+        #define _c(name) case MeshAttribute::name: return #name;
+        _c(Position)
+        _c(Normal)
+        _c(TextureCoordinates)
+        _c(Color)
+        _c(ObjectId)
+        #undef _c
+        default: return "";
+    }
+}
+
+/* Appends a byte swap pattern for a sequence of properties to given array */
+void appendSwapPattern(Containers::Array<UnsignedInt>& pattern, const Containers::ArrayView<const VertexFormat> formats) {
+    for(const VertexFormat format: formats) {
+        const UnsignedInt offset = pattern.size();
+        const UnsignedInt size = vertexFormatSize(format);
+        for(UnsignedInt i = 0; i != size; ++i)
+            arrayAppend(pattern, offset + size - i - 1);
+    }
+}
+
+/* Copies a block of equally-sized items from src to dst, with each
+   destination byte taken from a source item byte given by the pattern. Used
+   for endian swapping and optionally for picking a subset of the source item
+   at the same time. If the source and destination item sizes are the same
+   and at most 16 bytes, it's done with a single byte shuffle per item where
+   the instruction set allows. */
+void swapCopy(const Containers::ArrayView<const char> src, const std::size_t srcItemSize, const Containers::ArrayView<char> dst, const Containers::ArrayView<const UnsignedInt> pattern) {
+    const std::size_t itemSize = pattern.size();
+    if(!itemSize) return;
+    const std::size_t count = dst.size()/itemSize;
+    CORRADE_INTERNAL_ASSERT(src.size() == count*srcItemSize);
+    std::size_t i = 0;
+
+    #if defined(__SSSE3__) || (defined(CORRADE_TARGET_ARM) && defined(__aarch64__))
+    /* Each iteration reads and writes 16 bytes, which for items smaller than
+       that overlaps the next item. That's fine as the next item gets written
+       again in the next iteration, but it means the last few items need to be
+       done in the scalar loop below to not go out of bounds. */
+    if(itemSize == srcItemSize && itemSize <= 16 && count*itemSize >= 16) {
+        alignas(16) UnsignedByte mask[16];
+        for(std::size_t j = 0; j != 16; ++j)
+            mask[j] = j < itemSize ? UnsignedByte(pattern[j]) : UnsignedByte(j);
+        const std::size_t end = (count*itemSize - 16)/itemSize + 1;
+        #ifdef __SSSE3__
+        const __m128i shuffle = _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+        for(; i != end; ++i) {
+            const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i*itemSize));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i*itemSize), _mm_shuffle_epi8(in, shuffle));
+        }
+        #else
+        const uint8x16_t shuffle = vld1q_u8(mask);
+        for(; i != end; ++i) {
+            const uint8x16_t in = vld1q_u8(reinterpret_cast<const std::uint8_t*>(src + i*itemSize));
+            vst1q_u8(reinterpret_cast<std::uint8_t*>(dst + i*itemSize), vqtbl1q_u8(in, shuffle));
+        }
+        #endif
+    }
+    #endif
+
+    for(; i != count; ++i) {
+        const char* const srcItem = src + i*srcItemSize;
+        char* const dstItem = dst + i*itemSize;
+        for(std::size_t j = 0; j != itemSize; ++j)
+            dstItem[j] = srcItem[pattern[j]];
+    }
+}
+
+/* Swaps bytes of each 2- or 4-byte item of a contiguous array in place */
+template<std::size_t size> void swapIndicesInPlace(const Containers::ArrayView<char> data) {
+    typedef typename std::conditional<size == 2, UnsignedShort, UnsignedInt>::type T;
+    std::size_t i = 0;
+
+    #ifdef __SSSE3__
+    const __m128i shuffle = size == 2 ?
+        _mm_set_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1) :
+        _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    for(; i + 16 <= data.size(); i += 16) {
+        __m128i* const ptr = reinterpret_cast<__m128i*>(data + i);
+        _mm_storeu_si128(ptr, _mm_shuffle_epi8(_mm_loadu_si128(ptr), shuffle));
+    }
+    #elif defined(CORRADE_TARGET_ARM) && defined(__ARM_NEON)
+    for(; i + 16 <= data.size(); i += 16) {
+        std::uint8_t* const ptr = reinterpret_cast<std::uint8_t*>(data + i);
+        const uint8x16_t in = vld1q_u8(ptr);
+        vst1q_u8(ptr, size == 2 ? vrev16q_u8(in) : vrev32q_u8(in));
+    }
+    #endif
+
+    Utility::Endianness::swapInPlace(Containers::arrayCast<T>(data.suffix(i)));
+}
+
+/* Faces are processed in chunks of this size if the triangle fast path can't
+   be taken */
+constexpr std::size_t FaceChunkSize = 65536;
+
+struct FaceChunk {
+    /* Offset of the first face in the input */
+    std::size_t inputOffset;
+    /* Offset of the first output triangle */
+    UnsignedInt triangleOffset;
+};
+
+/* Calls f(t) for t in [0, threadCount), the first on the current thread and
+   the rest on new threads */
+template<class F> void parallelFor(const UnsignedInt threadCount, const F& f) {
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(UnsignedInt t = 1; t < threadCount; ++t)
+        threads[t - 1] = std::thread{f, t};
+    f(0);
+    for(std::thread& thread: threads) thread.join();
+}
+
+/* Reading index data of a runtime type */
+UnsignedInt indexAt(const char* const data, const UnsignedInt typeSize, const std::size_t i) {
+    if(typeSize == 1) return reinterpret_cast<const UnsignedByte*>(data)[i];
+    if(typeSize == 2) {
+        UnsignedShort out;
+        std::memcpy(&out, data + i*2, 2);
+        return out;
+    }
+    CORRADE_INTERNAL_ASSERT(typeSize == 4);
+    UnsignedInt out;
+    std::memcpy(&out, data + i*4, 4);
+    return out;
+}
+
+/* FNV-1a hash and comparison of fixed-size items, for use in a hash map
+   keyed by pointers to the items */
+struct ItemHash {
+    std::size_t size;
+    std::size_t operator()(const char* const data) const {
+        UnsignedInt hash = 2166136261u;
+        for(std::size_t i = 0; i != size; ++i)
+            hash = (hash ^ UnsignedByte(data[i]))*16777619u;
+        return hash;
+    }
+};
+struct ItemEqual {
+    std::size_t size;
+    bool operator()(const char* const a, const char* const b) const {
+        return std::memcmp(a, b, size) == 0;
+    }
+};
+typedef std::unordered_map<const char*, UnsignedInt, ItemHash, ItemEqual> ItemMap;
+
+/* Assigns each of the items an ID, with the same IDs for equal items and the
+   IDs ordered by first occurrence of the item. The items are split into
+   consecutive ranges, deduplicated locally on each thread and then merged
+   serially, going through the ranges in order. Since only the locally unique
+   items are merged, the output is the same as if done on a single thread.
+   Returns pointer to the first occurrence of each unique item. */
+Containers::Array<const char*> removeDuplicates(const Containers::ArrayView<const char> data, const std::size_t itemSize, UnsignedInt threadCount, const Containers::ArrayView<UnsignedInt> ids) {
+    const std::size_t count = ids.size();
+    CORRADE_INTERNAL_ASSERT(data.size() == count*itemSize);
+
+    /* Don't bother with threads for tiny ranges */
+    threadCount = UnsignedInt(Math::max(Math::min(std::size_t(threadCount), (count + FaceChunkSize - 1)/FaceChunkSize), std::size_t{1}));
+    const std::size_t rangeSize = (count + threadCount - 1)/threadCount;
+
+    Containers::Array<Containers::Array<const char*>> localUnique{threadCount};
+    parallelFor(threadCount, [&](const UnsignedInt t) {
+        const std::size_t begin = Math::min(t*rangeSize, count);
+        const std::size_t end = Math::min(begin + rangeSize, count);
+        ItemMap map{end - begin, ItemHash{itemSize}, ItemEqual{itemSize}};
+        for(std::size_t i = begin; i != end; ++i) {
+            const char* const item = data + i*itemSize;
+            const auto inserted = map.emplace(item, UnsignedInt(localUnique[t].size()));
+            if(inserted.second) arrayAppend(localUnique[t], item);
+            ids[i] = inserted.first->second;
+        }
+    });
+
+    /* Merge the locally unique items and remember how to remap the local
+       IDs to global */
+    Containers::Array<const char*> unique;
+    Containers::Array<Containers::Array<UnsignedInt>> remap{threadCount};
+    ItemMap map{localUnique[0].size(), ItemHash{itemSize}, ItemEqual{itemSize}};
+    for(UnsignedInt t = 0; t != threadCount; ++t) {
+        remap[t] = Containers::Array<UnsignedInt>{Containers::NoInit, localUnique[t].size()};
+        for(std::size_t i = 0; i != localUnique[t].size(); ++i) {
+            const auto inserted = map.emplace(localUnique[t][i], UnsignedInt(unique.size()));
+            if(inserted.second) arrayAppend(unique, localUnique[t][i]);
+            remap[t][i] = inserted.first->second;
+        }
+    }
+
+    /* The first range is already in the global order */
+    parallelFor(threadCount, [&](const UnsignedInt t) {
+        if(!t) return;
+        const std::size_t begin = Math::min(t*rangeSize, count);
+        const std::size_t end = Math::min(begin + rangeSize, count);
+        for(std::size_t i = begin; i != end; ++i)
+            ids[i] = remap[t][ids[i]];
+    });
+
+    return unique;
+}
+
 template<std::size_t size> bool checkVectorAttributeValidity(const Math::Vector<size, VertexFormat>& formats, const Math::Vector<size, UnsignedInt>& offsets, const char* name) {
     /* Check that we have the same type for all position coordinates */
     if(formats != Math::Vector<size, VertexFormat>{formats[0]}) {
@@ -187,14 +633,18 @@ template<std::size_t size> bool checkVectorAttributeValidity(const Math::Vector<
 
 }
 
-void StanfordImporter::openDataInternal(Containers::Array<char>&& data) {
+void StanfordImporter::openDataInternal(const Containers::ArrayView<const char> data) {
+    MAGNUM_IMPORTER_PROFILE(profile, _profilingCallback, _profilingUserData, "parse", data.size());
+
     /* Because here we're copying the data and using the _in to check if file
        is opened, having them nullptr would mean openData() would fail without
        any error message. It's not possible to do this check on the importer
        side, because empty file is valid in some formats (OBJ or glTF). We also
        can't do the full import here because then doImage2D() would need to
        copy the imported data instead anyway (and the uncompressed size is much
-       larger). This way it'll also work nicely with a future openMemory(). */
+       larger). This way it'll also work nicely with a future openMemory(). The
+       caller is responsible for moving the data ownership to the state after
+       this function succeeds, unless the file is ASCII. */
     if(data.empty()) {
         Error{} << "Trade::StanfordImporter::openData(): the file is empty";
         return;
@@ -241,6 +691,11 @@ void StanfordImporter::openDataInternal(Containers::Array<char>&& data) {
                 } else if(tokens[1] == "binary_big_endian") {
                     fileFormatNeedsEndianSwapping = !Utility::Endianness::isBigEndian();
                     break;
+                } else if(tokens[1] == "ascii") {
+                    /* Converted to native endianness during open */
+                    fileFormatNeedsEndianSwapping = false;
+                    state->ascii = true;
+                    break;
                 }
             }
 
@@ -270,6 +725,13 @@ void StanfordImporter::openDataInternal(Containers::Array<char>&& data) {
     bool perFaceNormals = false;
     bool perFaceColors = false;
     bool perFaceObjectIds = false;
+    /* Order of all vertex and face properties, needed only for ASCII
+       parsing */
+    Containers::Array<VertexFormat> vertexPropertyFormats;
+    Containers::Array<VertexFormat> facePropertyFormatsBeforeIndices;
+    Containers::Array<VertexFormat> facePropertyFormatsAfterIndices;
+    bool faceIndicesFound = false;
+    bool faceElementFound = false;
     {
         std::size_t vertexComponentOffset{};
         PropertyType propertyType{};
@@ -292,6 +754,7 @@ void StanfordImporter::openDataInternal(Containers::Array<char>&& data) {
                 } else if(tokens.size() == 3 &&tokens[1] == "face") {
                     state->faceCount = std::stoi(tokens[2]);
                     propertyType = PropertyType::Face;
+                    faceElementFound = true;
 
                 /* Something else */
                 } else {
@@ -374,6 +837,7 @@ void StanfordImporter::openDataInternal(Containers::Array<char>&& data) {
 
                     /* Add size of current component to total offset */
                     vertexComponentOffset += vertexFormatSize(componentFormat);
+                    arrayAppend(vertexPropertyFormats, componentFormat);
 
                 /* Face element properties */
                 } else if(propertyType == PropertyType::Face) {
@@ -381,6 +845,7 @@ void StanfordImporter::openDataInternal(Containers::Array<char>&& data) {
                     if(tokens.size() == 5 && tokens[1] == "list" && tokens[4] == "vertex_indices") {
                         state->faceIndicesOffset = state->faceSkip;
                         state->faceSkip = 0;
+                        faceIndicesFound = true;
 
                         /* Face size type */
                         if((state->faceSizeType = parseIndexType(tokens[2])) == MeshIndexType{}) {
@@ -455,6 +920,9 @@ void StanfordImporter::openDataInternal(Containers::Array<char>&& data) {
                         }
 
                         state->faceSkip += vertexFormatSize(componentFormat);
+                        arrayAppend(faceIndicesFound ?
+                            facePropertyFormatsAfterIndices :
+                            facePropertyFormatsBeforeIndices, componentFormat);
 
                     /* Fail on unknown lines */
                     } else {
@@ -487,7 +955,10 @@ void StanfordImporter::openDataInternal(Containers::Array<char>&& data) {
         Error{} << "Trade::StanfordImporter::openData(): incomplete vertex specification";
         return;
     }
-    if(state->faceSizeType == MeshIndexType{} || state->faceIndexType == MeshIndexType{}) {
+    /* Without any face element it's a point cloud, otherwise the face list
+       has to be fully specified */
+    state->pointCloud = !faceElementFound;
+    if(!state->pointCloud && (state->faceSizeType == MeshIndexType{} || state->faceIndexType == MeshIndexType{})) {
         Error{} << "Trade::StanfordImporter::openData(): incomplete face specification";
         return;
     }
@@ -641,39 +1112,554 @@ void StanfordImporter::openDataInternal(Containers::Array<char>&& data) {
             objectIdOffset, 0u, std::ptrdiff_t(state->faceIndicesOffset + state->faceSkip));
     }
 
+    /* Fill the header information. The views stay valid as nothing gets
+       added to the attribute lists after this point. */
+    state->header.vertexCount = state->vertexCount;
+    state->header.faceCount = state->faceCount;
+    state->header.vertexStride = state->vertexStride;
+    state->header.faceSizeType = state->faceSizeType;
+    state->header.faceIndexType = state->faceIndexType;
+    state->header.ascii = state->ascii;
+    state->header.bigEndian = !state->ascii && (state->fileFormatNeedsEndianSwapping != Utility::Endianness::isBigEndian());
+    state->header.pointCloud = state->pointCloud;
+    state->header.vertexAttributes = state->attributeData;
+    state->header.faceAttributes = state->faceAttributeData;
+
+    /* If only the header is requested, don't look at the body at all */
+    if(configuration().value<bool>("headerOnly")) {
+        state->headerOnly = true;
+        state->in = {};
+        state->headerSize = 0;
+        _state = std::move(state);
+        return;
+    }
+
+    /* Convert an ASCII body to the same binary layout a binary file would
+       have, so doMesh() can treat both the same */
+    if(state->ascii) {
+        const char* pos = in.begin();
+        const char* const end = in.end();
+        state->convertedData = Containers::Array<char>{Containers::NoInit,
+            state->vertexStride*state->vertexCount};
+        char* out = state->convertedData;
+        for(std::size_t i = 0; i != state->vertexCount; ++i) {
+            for(const VertexFormat format: vertexPropertyFormats) {
+                if(!parseAsciiValue(pos, end, format, out)) {
+                    Error{} << "Trade::StanfordImporter::openData(): invalid or incomplete ASCII vertex data";
+                    return;
+                }
+                out += vertexFormatSize(format);
+            }
+        }
+
+        /* Point clouds have nothing else to parse */
+        if(state->pointCloud) {
+            state->in = state->convertedData;
+            state->headerSize = 0;
+            _state = std::move(state);
+            return;
+        }
+
+        /* Reserve for an all-triangle mesh, the face data are validated in
+           doMesh() as with binary files */
+        const UnsignedInt faceSizeTypeSize = meshIndexTypeSize(state->faceSizeType);
+        const UnsignedInt faceIndexTypeSize = meshIndexTypeSize(state->faceIndexType);
+        const VertexFormat faceSizeFormat = indexTypeFormat(state->faceSizeType);
+        const VertexFormat faceIndexFormat = indexTypeFormat(state->faceIndexType);
+        Containers::arrayReserve<ArrayAllocator>(state->convertedData,
+            state->convertedData.size() + state->faceCount*(state->faceIndicesOffset + faceSizeTypeSize + 3*faceIndexTypeSize + state->faceSkip));
+        auto appendValue = [&](const VertexFormat format, const std::size_t size) {
+            const std::size_t offset = state->convertedData.size();
+            Containers::arrayResize<ArrayAllocator>(state->convertedData, Containers::NoInit, offset + size);
+            return parseAsciiValue(pos, end, format, state->convertedData + offset);
+        };
+        for(std::size_t i = 0; i != state->faceCount; ++i) {
+            bool valid = true;
+            for(const VertexFormat format: facePropertyFormatsBeforeIndices)
+                valid = valid && appendValue(format, vertexFormatSize(format));
+
+            const std::size_t faceSizeOffset = state->convertedData.size();
+            valid = valid && appendValue(faceSizeFormat, faceSizeTypeSize);
+            const UnsignedInt faceSize = valid ? extractIndexValue<UnsignedInt>(state->convertedData + faceSizeOffset, state->faceSizeType, false) : 0;
+            for(std::size_t j = 0; j != faceSize && valid; ++j)
+                valid = appendValue(faceIndexFormat, faceIndexTypeSize);
+
+            for(const VertexFormat format: facePropertyFormatsAfterIndices)
+                valid = valid && appendValue(format, vertexFormatSize(format));
+
+            if(!valid) {
+                Error{} << "Trade::StanfordImporter::openData(): invalid or incomplete ASCII face data";
+                return;
+            }
+        }
+
+        state->in = state->convertedData;
+        state->headerSize = 0;
+        _state = std::move(state);
+        return;
+    }
+
     if(in.size() < state->vertexStride*state->vertexCount) {
         Error{} << "Trade::StanfordImporter::openData(): incomplete vertex data";
         return;
     }
 
-    /* All good, move the data to the state struct and save it. Remember header
-       size so we can directly access the binary data in doMesh(). */
-    state->data = std::move(data);
-    state->headerSize = state->data.size() - in.size();
+    /* Prepare byte swap patterns for the whole vertex and face blocks, so
+       doMesh() can swap them at once instead of going attribute by
+       attribute */
+    if(state->fileFormatNeedsEndianSwapping) {
+        appendSwapPattern(state->vertexSwapPattern, vertexPropertyFormats);
+        appendSwapPattern(state->faceSwapPattern, facePropertyFormatsBeforeIndices);
+        appendSwapPattern(state->faceSwapPattern, facePropertyFormatsAfterIndices);
+        CORRADE_INTERNAL_ASSERT(state->vertexSwapPattern.size() == state->vertexStride);
+        CORRADE_INTERNAL_ASSERT(state->faceSwapPattern.size() == state->faceIndicesOffset + state->faceSkip);
+    }
+
+    /* All good, save the state. Remember header size so we can directly
+       access the binary data in doMesh(). */
+    state->in = data;
+    state->headerSize = data.size() - in.size();
     _state = std::move(state);
 }
 
-UnsignedInt StanfordImporter::doMeshCount() const { return 1; }
+UnsignedInt StanfordImporter::doMeshCount() const {
+    if(_state->headerOnly) return 0;
+
+    /* In chunked mode there's first all vertex chunks and then all face
+       chunks. Point clouds have no face chunks, as the face count is 0. */
+    if(const UnsignedInt chunkSize = configuration().value<UnsignedInt>("chunkSize"))
+        return (_state->vertexCount + chunkSize - 1)/chunkSize +
+               (_state->faceCount + chunkSize - 1)/chunkSize;
+    return 1;
+}
 
 UnsignedInt StanfordImporter::doMeshLevelCount(UnsignedInt) {
-    return configuration().value<bool>("perFaceToPerVertex") ? 1 : 2;
+    return _state->pointCloud ||
+        configuration().value<bool>("perFaceToPerVertex") ||
+        configuration().value<UnsignedInt>("chunkSize") ? 1 : 2;
+}
+
+void StanfordImporter::importedAttributes(Containers::Array<UnsignedInt>& vertexAttributes, Containers::Array<UnsignedInt>& faceAttributes) {
+    /* If the list is empty, all are imported, otherwise builtin attributes
+       are matched by their enum name and custom attributes by their name in
+       the file. */
+    const std::vector<std::string> attributeFilter = Utility::String::splitWithoutEmptyParts(configuration().value("attributes"));
+    const auto isAttributeImported = [&](const MeshAttribute name) {
+        if(attributeFilter.empty()) return true;
+        const std::string nameString = isMeshAttributeCustom(name) ?
+            doMeshAttributeName(meshAttributeCustom(name)) :
+            builtinAttributeName(name);
+        for(const std::string& i: attributeFilter)
+            if(i == nameString) return true;
+        return false;
+    };
+    for(std::size_t i = 0; i != _state->attributeData.size(); ++i)
+        if(isAttributeImported(_state->attributeData[i].name()))
+            arrayAppend(vertexAttributes, i);
+    for(std::size_t i = 0; i != _state->faceAttributeData.size(); ++i)
+        if(isAttributeImported(_state->faceAttributeData[i].name()))
+            arrayAppend(faceAttributes, i);
 }
 
-Containers::Optional<MeshData> StanfordImporter::doMesh(UnsignedInt, const UnsignedInt level) {
+Containers::ArrayView<const char> StanfordImporter::importVertexData(const UnsignedInt offset, const UnsignedInt count, const Containers::ArrayView<const UnsignedInt> attributes, const bool zeroCopy, Containers::Array<char>& vertexData, Containers::Array<MeshAttributeData>& attributeData) {
+    const Containers::ArrayView<const char> src = _state->in.suffix(_state->headerSize).slice(
+        std::size_t(offset)*_state->vertexStride,
+        (std::size_t(offset) + count)*_state->vertexStride);
+
+    /* If only a subset of attributes is imported, these get packed tightly
+       together instead of copying everything, unless zero-copy is requested */
+    Containers::Array<UnsignedInt> offsets{Containers::NoInit, attributes.size()};
+    std::size_t stride;
+    if(zeroCopy || attributes.size() == _state->attributeData.size()) {
+        stride = _state->vertexStride;
+        for(std::size_t i = 0; i != attributes.size(); ++i)
+            offsets[i] = _state->attributeData[attributes[i]].offset({});
+    } else {
+        stride = 0;
+        for(std::size_t i = 0; i != attributes.size(); ++i) {
+            offsets[i] = stride;
+            stride += vertexFormatSize(_state->attributeData[attributes[i]].format());
+        }
+    }
+
+    /* Reference the data directly from the file if requested, otherwise copy
+       them, reusing the output allocation if it's large enough */
+    Containers::ArrayView<const char> out;
+    if(zeroCopy) out = src;
+    else {
+        if(vertexData.size() < stride*count)
+            vertexData = Containers::Array<char>{Containers::NoInit, stride*count};
+        const Containers::ArrayView<char> dst = vertexData.prefix(stride*count);
+
+        /* All attributes, copy as a whole. If an endian swap is needed, do it
+           as part of the copy. */
+        if(stride == _state->vertexStride) {
+            if(_state->fileFormatNeedsEndianSwapping)
+                swapCopy(src, _state->vertexStride, dst, _state->vertexSwapPattern);
+            else Utility::copy(src, dst);
+
+        /* A subset. If an endian swap is needed, pick the corresponding parts
+           of the swap pattern and do the swap as part of the copy. Otherwise
+           copy each attribute separately. */
+        } else if(_state->fileFormatNeedsEndianSwapping) {
+            Containers::Array<UnsignedInt> pattern{Containers::NoInit, stride};
+            for(std::size_t i = 0; i != attributes.size(); ++i) {
+                const MeshAttributeData& attribute = _state->attributeData[attributes[i]];
+                const std::size_t size = vertexFormatSize(attribute.format());
+                Utility::copy(
+                    Containers::ArrayView<const UnsignedInt>{_state->vertexSwapPattern}.slice(attribute.offset({}), attribute.offset({}) + size),
+                    Containers::arrayView(pattern).slice(offsets[i], offsets[i] + size));
+            }
+            swapCopy(src, _state->vertexStride, dst, pattern);
+        } else for(std::size_t i = 0; i != attributes.size(); ++i) {
+            const MeshAttributeData& attribute = _state->attributeData[attributes[i]];
+            const std::size_t size = vertexFormatSize(attribute.format());
+            Utility::copy(
+                Containers::StridedArrayView2D<const char>{src,
+                    src + attribute.offset({}),
+                    {count, size},
+                    {std::ptrdiff_t(_state->vertexStride), 1}},
+                Containers::StridedArrayView2D<char>{dst,
+                    dst + offsets[i],
+                    {count, size},
+                    {std::ptrdiff_t(stride), 1}});
+        }
+
+        out = dst;
+    }
+
+    /* The attribute data are offset-only, turn them into absolute ones
+       pointing to the output */
+    attributeData = Containers::Array<MeshAttributeData>{attributes.size()};
+    for(std::size_t i = 0; i != attributes.size(); ++i) {
+        const MeshAttributeData& attribute = _state->attributeData[attributes[i]];
+        attributeData[i] = MeshAttributeData{
+            attribute.name(), attribute.format(),
+            Containers::StridedArrayView1D<const void>{out,
+                out + offsets[i], count, std::ptrdiff_t(stride)}};
+    }
+
+    return out;
+}
+
+Containers::Optional<MeshData> StanfordImporter::meshChunk(const UnsignedInt id, const UnsignedInt chunkSize) {
+    Containers::Array<UnsignedInt> vertexAttributes;
+    Containers::Array<UnsignedInt> faceAttributes;
+    importedAttributes(vertexAttributes, faceAttributes);
+
+    /* Vertex chunk, copied into the reused buffer or referencing the file
+       directly */
+    const UnsignedInt vertexChunkCount = (_state->vertexCount + chunkSize - 1)/chunkSize;
+    if(id < vertexChunkCount) {
+        const UnsignedInt offset = id*chunkSize;
+        const UnsignedInt count = Math::min(chunkSize, _state->vertexCount - offset);
+        const bool zeroCopy = !_state->fileFormatNeedsEndianSwapping && configuration().value<bool>("zeroCopy");
+        Containers::Array<MeshAttributeData> attributeData;
+        const Containers::ArrayView<const char> vertexData = importVertexData(offset, count, vertexAttributes, zeroCopy, _state->chunkData, attributeData);
+        return MeshData{MeshPrimitive::Points,
+            DataFlags{}, vertexData, std::move(attributeData), count};
+    }
+
+    const UnsignedInt faceIndexTypeSize = meshIndexTypeSize(_state->faceIndexType);
+    const UnsignedInt faceSizeTypeSize = meshIndexTypeSize(_state->faceSizeType);
+    const Containers::ArrayView<const char> faces = _state->in.suffix(_state->headerSize + std::size_t(_state->vertexStride)*_state->vertexCount);
+
+    /* Find where each face chunk starts, if not done for this chunk size yet.
+       Faces can have varying sizes, so this has to go through all of them,
+       but it's done only once. */
+    if(_state->faceChunkOffsetsChunkSize != chunkSize) {
+        _state->faceChunkOffsetsChunkSize = 0;
+        _state->faceChunkOffsets = Containers::Array<std::size_t>{Containers::NoInit, (_state->faceCount + chunkSize - 1)/chunkSize};
+        Containers::ArrayView<const char> in = faces;
+        for(std::size_t i = 0; i != _state->faceCount; ++i) {
+            if(i % chunkSize == 0)
+                _state->faceChunkOffsets[i/chunkSize] = in.data() - faces.data();
+
+            if(in.size() < _state->faceIndicesOffset + faceSizeTypeSize) {
+                Error() << "Trade::StanfordImporter::mesh(): incomplete index data";
+                return Containers::NullOpt;
+            }
+
+            const UnsignedInt faceSize = extractIndexValue<UnsignedInt>(in + _state->faceIndicesOffset, _state->faceSizeType, _state->fileFormatNeedsEndianSwapping);
+            in = in.suffix(_state->faceIndicesOffset + faceSizeTypeSize);
+            if(faceSize < 3 || faceSize > 4) {
+                Error() << "Trade::StanfordImporter::mesh(): unsupported face size" << faceSize;
+                return Containers::NullOpt;
+            }
+
+            if(in.size() < faceIndexTypeSize*faceSize + _state->faceSkip) {
+                Error() << "Trade::StanfordImporter::mesh(): incomplete face data";
+                return Containers::NullOpt;
+            }
+
+            in = in.suffix(faceIndexTypeSize*faceSize + _state->faceSkip);
+        }
+        _state->faceChunkOffsetsChunkSize = chunkSize;
+    }
+
+    /* Face chunk, triangulated into the reused buffer. Reserve for the worst
+       case of all faces being quads. */
+    const UnsignedInt chunk = id - vertexChunkCount;
+    const std::size_t faceBegin = std::size_t(chunk)*chunkSize;
+    const std::size_t faceEnd = Math::min(faceBegin + chunkSize, std::size_t(_state->faceCount));
+    if(_state->chunkData.size() < (faceEnd - faceBegin)*6*faceIndexTypeSize)
+        _state->chunkData = Containers::Array<char>{Containers::NoInit, (faceEnd - faceBegin)*6*faceIndexTypeSize};
+    const char* src = faces + _state->faceChunkOffsets[chunk];
+    char* indexDst = _state->chunkData;
+    for(std::size_t i = faceBegin; i != faceEnd; ++i) {
+        src += _state->faceIndicesOffset;
+        const UnsignedInt faceSize = extractIndexValue<UnsignedInt>(src, _state->faceSizeType, _state->fileFormatNeedsEndianSwapping);
+        src += faceSizeTypeSize;
+
+        /* Same triangulation as in doMesh() */
+        std::memcpy(indexDst, src, 3*faceIndexTypeSize);
+        indexDst += 3*faceIndexTypeSize;
+        if(faceSize == 4) {
+            std::memcpy(indexDst, src, faceIndexTypeSize);
+            std::memcpy(indexDst + faceIndexTypeSize, src + 2*faceIndexTypeSize, 2*faceIndexTypeSize);
+            indexDst += 3*faceIndexTypeSize;
+        }
+        src += faceIndexTypeSize*faceSize + _state->faceSkip;
+    }
+
+    const Containers::ArrayView<char> indexData = _state->chunkData.prefix(indexDst - _state->chunkData.data());
+    if(_state->fileFormatNeedsEndianSwapping) {
+        if(faceIndexTypeSize == 2)
+            swapIndicesInPlace<2>(indexData);
+        else if(faceIndexTypeSize == 4)
+            swapIndicesInPlace<4>(indexData);
+    }
+
+    MeshIndexData indices{_state->faceIndexType, indexData};
+    return MeshData{MeshPrimitive::Triangles,
+        DataFlags{}, indexData, indices, _state->vertexCount};
+}
+
+namespace {
+
+/* Spreads the lower 21 bits of the value so there are two zero bits between
+   each */
+UnsignedLong spreadMortonBits(UnsignedLong a) {
+    a &= 0x1fffff;
+    a = (a | a << 32) & 0x001f00000000ffffull;
+    a = (a | a << 16) & 0x001f0000ff0000ffull;
+    a = (a | a <<  8) & 0x100f00f00f00f00full;
+    a = (a | a <<  4) & 0x10c30c30c30c30c3ull;
+    a = (a | a <<  2) & 0x1249249249249249ull;
+    return a;
+}
+
+Range3D positionBounds(const Containers::ArrayView<const Vector3> positions) {
+    if(positions.empty()) return {};
+    Range3D bounds{positions[0], positions[0]};
+    for(const Vector3& i: positions) {
+        bounds.min() = Math::min(bounds.min(), i);
+        bounds.max() = Math::max(bounds.max(), i);
+    }
+    return bounds;
+}
+
+}
+
+Containers::Array<Vector3> StanfordImporter::importPositions(const UnsignedInt offset, const UnsignedInt count) {
+    /* Positions are always present, import just them (endian-swapped if
+       needed) and let MeshData do the conversion to floats */
+    UnsignedInt positionAttribute = 0;
+    while(_state->attributeData[positionAttribute].name() != MeshAttribute::Position)
+        ++positionAttribute;
+    Containers::Array<char> vertexData;
+    Containers::Array<MeshAttributeData> attributeData;
+    const Containers::ArrayView<const char> vertexDataView = importVertexData(offset, count, Containers::arrayView(&positionAttribute, 1), false, vertexData, attributeData);
+    return MeshData{MeshPrimitive::Points, DataFlags{}, vertexDataView,
+        std::move(attributeData), count}.positions3DAsArray();
+}
+
+void StanfordImporter::sortPointCloud(const UnsignedInt chunkSize) {
+    const UnsignedInt count = _state->vertexCount;
+    const Containers::Array<Vector3> positions = importPositions(0, count);
+    const Range3D bounds = positionBounds(positions);
+
+    /* Quantize the positions relative to the bounds. If the cloud is flat in
+       some direction, all points have zero in given coordinate. */
+    const Vector3 size = bounds.size();
+    const Vector3 scale{
+        size.x() > 0.0f ? 2097151.0f/size.x() : 0.0f,
+        size.y() > 0.0f ? 2097151.0f/size.y() : 0.0f,
+        size.z() > 0.0f ? 2097151.0f/size.z() : 0.0f};
+    struct Point {
+        UnsignedLong code;
+        UnsignedInt index;
+    };
+    Containers::Array<Point> points{Containers::NoInit, count};
+    for(UnsignedInt i = 0; i != count; ++i) {
+        const Vector3 quantized = Math::clamp((positions[i] - bounds.min())*scale, 0.0f, 2097151.0f);
+        points[i].code =
+            spreadMortonBits(UnsignedLong(quantized.x())) |
+            spreadMortonBits(UnsignedLong(quantized.y())) << 1 |
+            spreadMortonBits(UnsignedLong(quantized.z())) << 2;
+        points[i].index = i;
+    }
+
+    /* Points with the same code are kept in the file order so the output is
+       deterministic */
+    std::sort(points.begin(), points.end(), [](const Point& a, const Point& b) {
+        return a.code < b.code || (a.code == b.code && a.index < b.index);
+    });
+
+    /* Import all requested attributes and copy whole vertices in the sorted
+       order */
+    Containers::Array<UnsignedInt> vertexAttributes;
+    Containers::Array<UnsignedInt> faceAttributes;
+    importedAttributes(vertexAttributes, faceAttributes);
+    Containers::Array<char> vertexData;
+    Containers::Array<MeshAttributeData> attributeData;
+    const Containers::ArrayView<const char> vertexDataView = importVertexData(0, count, vertexAttributes, false, vertexData, attributeData);
+    const std::size_t stride = count ? vertexDataView.size()/count : 0;
+    _state->sortedVertexData = Containers::Array<char>{Containers::NoInit, vertexDataView.size()};
+    for(UnsignedInt i = 0; i != count; ++i)
+        std::memcpy(_state->sortedVertexData + i*stride, vertexDataView + points[i].index*stride, stride);
+
+    /* Remember the attribute layout as offset-only, the chunks are then
+       created with a vertex count and a data view of their own */
+    _state->sortedAttributeData = Containers::Array<MeshAttributeData>{attributeData.size()};
+    for(std::size_t i = 0; i != attributeData.size(); ++i)
+        _state->sortedAttributeData[i] = MeshAttributeData{
+            attributeData[i].name(), attributeData[i].format(),
+            std::size_t(static_cast<const char*>(attributeData[i].data().data()) - vertexDataView.data()),
+            count, std::ptrdiff_t(stride)};
+
+    /* Bounds of each chunk, or of the whole cloud if not chunked */
+    const UnsignedInt chunkCount = chunkSize ? (count + chunkSize - 1)/chunkSize : 1;
+    _state->sortedBounds = Containers::Array<Range3D>{Containers::NoInit, chunkCount};
+    if(!chunkSize) _state->sortedBounds[0] = bounds;
+    else for(UnsignedInt chunk = 0; chunk != chunkCount; ++chunk) {
+        const UnsignedInt begin = chunk*chunkSize;
+        const UnsignedInt end = Math::min(begin + chunkSize, count);
+        Range3D chunkBounds{positions[points[begin].index], positions[points[begin].index]};
+        for(UnsignedInt i = begin + 1; i != end; ++i) {
+            chunkBounds.min() = Math::min(chunkBounds.min(), positions[points[i].index]);
+            chunkBounds.max() = Math::max(chunkBounds.max(), positions[points[i].index]);
+        }
+        _state->sortedBounds[chunk] = chunkBounds;
+    }
+
+    _state->sorted = true;
+    _state->sortedAttributes = configuration().value("attributes");
+    _state->sortedChunkSize = chunkSize;
+}
+
+Containers::Optional<MeshData> StanfordImporter::pointCloudMesh(const UnsignedInt id, const UnsignedInt chunkSize) {
+    const UnsignedInt offset = chunkSize ? id*chunkSize : 0;
+    const UnsignedInt count = chunkSize ? Math::min(chunkSize, _state->vertexCount - offset) : _state->vertexCount;
+
+    /* Morton-ordered points are cut out of the sorted data */
+    if(configuration().value<bool>("mortonOrder")) {
+        if(!_state->sorted || _state->sortedChunkSize != chunkSize || _state->sortedAttributes != configuration().value("attributes")) {
+            MAGNUM_IMPORTER_PROFILE(profileVertices, _profilingCallback, _profilingUserData, "vertices", 0);
+            sortPointCloud(chunkSize);
+            MAGNUM_IMPORTER_PROFILE_BYTES(profileVertices, _state->sortedVertexData.size());
+        }
+
+        const std::size_t stride = _state->vertexCount ? _state->sortedVertexData.size()/_state->vertexCount : 0;
+        const Containers::ArrayView<const char> vertexData = _state->sortedVertexData.slice(offset*stride, (std::size_t(offset) + count)*stride);
+        Containers::Array<MeshAttributeData> attributeData{_state->sortedAttributeData.size()};
+        for(std::size_t i = 0; i != attributeData.size(); ++i) {
+            const MeshAttributeData& attribute = _state->sortedAttributeData[i];
+            attributeData[i] = MeshAttributeData{
+                attribute.name(), attribute.format(),
+                Containers::StridedArrayView1D<const void>{vertexData,
+                    vertexData + attribute.offset({}), count, std::ptrdiff_t(stride)}};
+        }
+        return MeshData{MeshPrimitive::Points,
+            DataFlags{}, vertexData, std::move(attributeData), count};
+    }
+
+    /* Otherwise the points are taken in the file order. Chunks go through
+       the usual path. */
+    if(chunkSize) return meshChunk(id, chunkSize);
+
+    Containers::Array<UnsignedInt> vertexAttributes;
+    Containers::Array<UnsignedInt> faceAttributes;
+    importedAttributes(vertexAttributes, faceAttributes);
+    const bool zeroCopy = !_state->fileFormatNeedsEndianSwapping && configuration().value<bool>("zeroCopy");
+    Containers::Array<char> vertexData;
+    Containers::Array<MeshAttributeData> attributeData;
+    MAGNUM_IMPORTER_PROFILE(profileVertices, _profilingCallback, _profilingUserData, "vertices", 0);
+    const Containers::ArrayView<const char> vertexDataView = importVertexData(0, count, vertexAttributes, zeroCopy, vertexData, attributeData);
+    MAGNUM_IMPORTER_PROFILE_BYTES(profileVertices, vertexDataView.size());
+    if(zeroCopy) return MeshData{MeshPrimitive::Points,
+        DataFlags{}, vertexDataView, std::move(attributeData), count};
+    return MeshData{MeshPrimitive::Points,
+        std::move(vertexData), std::move(attributeData), count};
+}
+
+Containers::Optional<Range3D> StanfordImporter::meshBounds(const UnsignedInt id) {
+    CORRADE_ASSERT(_state, "Trade::StanfordImporter::meshBounds(): no file opened", {});
+    CORRADE_ASSERT(id < doMeshCount(), "Trade::StanfordImporter::meshBounds(): index" << id << "out of range for" << doMeshCount() << "entries", {});
+
+    /* Morton-ordered point clouds have the bounds calculated together with
+       the sorted data */
+    const UnsignedInt chunkSize = configuration().value<UnsignedInt>("chunkSize");
+    if(_state->pointCloud && configuration().value<bool>("mortonOrder")) {
+        if(!_state->sorted || _state->sortedChunkSize != chunkSize || _state->sortedAttributes != configuration().value("attributes"))
+            sortPointCloud(chunkSize);
+        return _state->sortedBounds[id];
+    }
+
+    /* Face chunks have no vertices of their own */
+    UnsignedInt offset = 0;
+    UnsignedInt count = _state->vertexCount;
+    if(chunkSize) {
+        if(id >= (_state->vertexCount + chunkSize - 1)/chunkSize)
+            return Containers::NullOpt;
+        offset = id*chunkSize;
+        count = Math::min(chunkSize, _state->vertexCount - offset);
+    }
+
+    return positionBounds(importPositions(offset, count));
+}
+
+Containers::Optional<MeshData> StanfordImporter::doMesh(const UnsignedInt id, const UnsignedInt level) {
+    MAGNUM_IMPORTER_PROFILE(profile, _profilingCallback, _profilingUserData, "mesh", 0);
+    Containers::Optional<MeshData> out = meshInternal(id, level);
+    if(out) MAGNUM_IMPORTER_PROFILE_BYTES(profile, out->vertexData().size() + out->indexData().size());
+    return out;
+}
+
+Containers::Optional<MeshData> StanfordImporter::meshInternal(const UnsignedInt id, const UnsignedInt level) {
+    /* Point clouds and chunked import are handled separately */
+    if(_state->pointCloud)
+        return pointCloudMesh(id, configuration().value<UnsignedInt>("chunkSize"));
+    if(const UnsignedInt chunkSize = configuration().value<UnsignedInt>("chunkSize"))
+        return meshChunk(id, chunkSize);
+
     /* We either have per-face in the second level or we convert them to
        per-vertex, never both */
     CORRADE_INTERNAL_ASSERT(!(level == 1 && configuration().value<bool>("perFaceToPerVertex")));
+
+    Containers::Array<UnsignedInt> vertexAttributes;
+    Containers::Array<UnsignedInt> faceAttributes;
+    importedAttributes(vertexAttributes, faceAttributes);
+
+    /* If all per-face attributes got filtered out, there's nothing to
+       convert to per-vertex */
     const bool parsePerFaceAttributes = level == 1 ||
-        configuration().value<bool>("perFaceToPerVertex");
+        (configuration().value<bool>("perFaceToPerVertex") && !faceAttributes.empty());
 
-    Containers::ArrayView<const char> in = _state->data.suffix(_state->headerSize);
+    Containers::ArrayView<const char> in = _state->in.suffix(_state->headerSize);
 
-    /* Copy all vertex data */
+    /* Copy all vertex data. If zero-copy import is requested and no endian
+       swap is needed, the vertex data are referenced directly from the file
+       instead. */
     Containers::Array<char> vertexData;
+    Containers::ArrayView<const char> vertexDataView;
+    Containers::Array<MeshAttributeData> vertexAttributeData;
+    const bool zeroCopy = level == 0 && !_state->fileFormatNeedsEndianSwapping && configuration().value<bool>("zeroCopy");
     if(level == 0) {
-        vertexData = Containers::Array<char>{Containers::NoInit,
-        _state->vertexStride*_state->vertexCount};
-        Utility::copy(in.prefix(vertexData.size()), vertexData);
+        MAGNUM_IMPORTER_PROFILE(profileVertices, _profilingCallback, _profilingUserData, "vertices", 0);
+        vertexDataView = importVertexData(0, _state->vertexCount,
+            vertexAttributes, zeroCopy, vertexData, vertexAttributeData);
+        MAGNUM_IMPORTER_PROFILE_BYTES(profileVertices, vertexDataView.size());
     }
     in = in.suffix(_state->vertexStride*_state->vertexCount);
 
@@ -683,6 +1669,8 @@ Containers::Optional<MeshData> StanfordImporter::doMesh(UnsignedInt, const Unsig
     const UnsignedInt faceIndexTypeSize = meshIndexTypeSize(_state->faceIndexType);
     const UnsignedInt faceSizeTypeSize = meshIndexTypeSize(_state->faceSizeType);
     UnsignedInt triangleFaceCount = _state->faceCount;
+    UnsignedInt configuredThreadCount = configuration().value<UnsignedInt>("threads");
+    if(!configuredThreadCount) configuredThreadCount = Math::max(std::thread::hardware_concurrency(), 1u);
 
     /* Fast path -- if all faces are triangles, we can just copy all indices
        and per-face data directly without parsing anything */
@@ -717,139 +1705,135 @@ Containers::Optional<MeshData> StanfordImporter::doMesh(UnsignedInt, const Unsig
                 dst.suffix({0, _state->faceIndicesOffset}));
         }
 
-    /* Otherwise reserve optimistically amount for all-triangle faces, and let
-       the array grow */
-    /** @todo the size could be estimated *exactly* via the above equation
-       (assuming no stray data at EOF) */
+    /* Otherwise do it in two passes. First verify the face sizes and
+       calculate exact output size, remembering where each chunk of
+       FaceChunkSize faces starts in the input and output. Then, having no
+       further errors to handle, fill the exactly-sized outputs, optionally
+       distributing the chunks across multiple threads. */
     } else {
-        if(parsePerFaceAttributes) Containers::arrayReserve<ArrayAllocator>(faceData,
-            _state->faceCount*(_state->faceIndicesOffset + _state->faceSkip));
-        Containers::arrayReserve<ArrayAllocator>(indexData,
-            _state->faceCount*3*faceIndexTypeSize);
+        Containers::Array<FaceChunk> chunks;
+        Containers::arrayReserve(chunks, (_state->faceCount + FaceChunkSize - 1)/FaceChunkSize);
+        triangleFaceCount = 0;
+        const char* const begin = in.data();
         for(std::size_t i = 0; i != _state->faceCount; ++i) {
+            if(i % FaceChunkSize == 0)
+                arrayAppend(chunks, FaceChunk{
+                    std::size_t(in.data() - begin), triangleFaceCount});
+
             if(in.size() < _state->faceIndicesOffset + faceSizeTypeSize) {
                 Error() << "Trade::StanfordImporter::mesh(): incomplete index data";
                 return Containers::NullOpt;
             }
 
-            /* Copy all face attributes that are before the index */
-            const Containers::ArrayView<const char> faceDataBeforeIndices = in.prefix(_state->faceIndicesOffset);
-            in = in.suffix(_state->faceIndicesOffset);
-
             /* Get face size */
-            const Containers::ArrayView<const char> faceSizeData = in.prefix(faceSizeTypeSize);
-            in = in.suffix(faceSizeTypeSize);
-            const UnsignedInt faceSize = extractIndexValue<UnsignedInt>(faceSizeData, _state->faceSizeType, _state->fileFormatNeedsEndianSwapping);
+            const UnsignedInt faceSize = extractIndexValue<UnsignedInt>(in + _state->faceIndicesOffset, _state->faceSizeType, _state->fileFormatNeedsEndianSwapping);
+            in = in.suffix(_state->faceIndicesOffset + faceSizeTypeSize);
             if(faceSize < 3 || faceSize > 4) {
                 Error() << "Trade::StanfordImporter::mesh(): unsupported face size" << faceSize;
                 return Containers::NullOpt;
             }
 
-            /* Parse face indices */
             if(in.size() < faceIndexTypeSize*faceSize + _state->faceSkip) {
                 Error() << "Trade::StanfordImporter::mesh(): incomplete face data";
                 return Containers::NullOpt;
             }
 
-            const Containers::ArrayView<const char> faceIndexData = in.prefix(faceIndexTypeSize*faceSize);
-            in = in.suffix(faceIndexTypeSize*faceSize);
-            const Containers::ArrayView<const char> faceDataAfterIndices = in.prefix(_state->faceSkip);
-            in = in.suffix(_state->faceSkip);
-
-            /* Append either the triangle or the first triangle of the quad */
-            Containers::arrayAppend<ArrayAllocator>(indexData,
-                faceIndexData.prefix(3*faceIndexTypeSize));
-            if(parsePerFaceAttributes) {
-                Containers::arrayAppend<ArrayAllocator>(faceData, faceDataBeforeIndices);
-                Containers::arrayAppend<ArrayAllocator>(faceData, faceDataAfterIndices);
-            }
-            /* For a quad add the 0, 2 and 3 indices forming another triangle */
-            if(faceSize == 4) {
-                /* 0 0---3
-                   |\ \  |
-                   | \ \ |
-                   |  \ \|
-                   1---2 2 */
-                Containers::arrayAppend<ArrayAllocator>(indexData,
-                    faceIndexData.slice(0*faceIndexTypeSize, 1*faceIndexTypeSize));
-                Containers::arrayAppend<ArrayAllocator>(indexData,
-                    faceIndexData.slice(2*faceIndexTypeSize, 3*faceIndexTypeSize));
-                Containers::arrayAppend<ArrayAllocator>(indexData,
-                    faceIndexData.slice(3*faceIndexTypeSize, 4*faceIndexTypeSize));
-                if(parsePerFaceAttributes) {
-                    Containers::arrayAppend<ArrayAllocator>(faceData, faceDataBeforeIndices);
-                    Containers::arrayAppend<ArrayAllocator>(faceData, faceDataAfterIndices);
+            in = in.suffix(faceIndexTypeSize*faceSize + _state->faceSkip);
+            triangleFaceCount += faceSize - 2;
+        }
+
+        const std::size_t faceDataSize = _state->faceIndicesOffset + _state->faceSkip;
+        if(level == 0) indexData = Containers::Array<char>{Containers::NoInit,
+            triangleFaceCount*3*faceIndexTypeSize};
+        if(parsePerFaceAttributes) faceData = Containers::Array<char>{Containers::NoInit,
+            triangleFaceCount*faceDataSize};
+
+        auto fill = [&](const std::size_t chunk) {
+            const std::size_t faceBegin = chunk*FaceChunkSize;
+            const std::size_t faceEnd = Math::min(faceBegin + FaceChunkSize, std::size_t(_state->faceCount));
+            const char* src = begin + chunks[chunk].inputOffset;
+            char* indexDst = level == 0 ? indexData + chunks[chunk].triangleOffset*3*faceIndexTypeSize : nullptr;
+            char* faceDst = parsePerFaceAttributes ? faceData + chunks[chunk].triangleOffset*faceDataSize : nullptr;
+            for(std::size_t i = faceBegin; i != faceEnd; ++i) {
+                const char* const faceDataBeforeIndices = src;
+                src += _state->faceIndicesOffset;
+                const UnsignedInt faceSize = extractIndexValue<UnsignedInt>(src, _state->faceSizeType, _state->fileFormatNeedsEndianSwapping);
+                src += faceSizeTypeSize;
+                const char* const faceIndexData = src;
+                src += faceIndexTypeSize*faceSize;
+                const char* const faceDataAfterIndices = src;
+                src += _state->faceSkip;
+
+                /* Either the triangle or the first triangle of the quad. For
+                   a quad add also the 0, 2 and 3 indices forming another
+                   triangle:
+
+                    0 0---3
+                    |\ \  |
+                    | \ \ |
+                    |  \ \|
+                    1---2 2 */
+                if(level == 0) {
+                    std::memcpy(indexDst, faceIndexData, 3*faceIndexTypeSize);
+                    indexDst += 3*faceIndexTypeSize;
+                    if(faceSize == 4) {
+                        std::memcpy(indexDst, faceIndexData, faceIndexTypeSize);
+                        std::memcpy(indexDst + faceIndexTypeSize, faceIndexData + 2*faceIndexTypeSize, 2*faceIndexTypeSize);
+                        indexDst += 3*faceIndexTypeSize;
+                    }
+                }
+                if(parsePerFaceAttributes) for(UnsignedInt j = 2; j != faceSize; ++j) {
+                    std::memcpy(faceDst, faceDataBeforeIndices, _state->faceIndicesOffset);
+                    std::memcpy(faceDst + _state->faceIndicesOffset, faceDataAfterIndices, _state->faceSkip);
+                    faceDst += faceDataSize;
                 }
-                ++triangleFaceCount;
             }
-        }
+        };
+
+        /* Chunk i is processed by thread i % threadCount, the current thread
+           is the first one */
+        const UnsignedInt threadCount = Math::max(Math::min(configuredThreadCount, UnsignedInt(chunks.size())), 1u);
+        parallelFor(threadCount, [&fill, &chunks, threadCount](const UnsignedInt t) {
+            for(std::size_t chunk = t; chunk < chunks.size(); chunk += threadCount)
+                fill(chunk);
+        });
     }
 
     /* We need to copy the attribute data (also because they use a forbidden
        deleter), so use that opportunity to also turn them from offset-only to
        absolute, and for per-face ones fill the count for each (which wasn't
-       known until now) */
-    Containers::Array<MeshAttributeData> vertexAttributeData;
+       known until now). Vertex attributes were made absolute already
+       above. */
     Containers::Array<MeshAttributeData> faceAttributeData;
-    if(level == 0) {
-        vertexAttributeData = Containers::Array<MeshAttributeData>{_state->attributeData.size()};
-        for(std::size_t i = 0; i != vertexAttributeData.size(); ++i) {
-            vertexAttributeData[i] = MeshAttributeData{
-                _state->attributeData[i].name(),
-                _state->attributeData[i].format(),
-                _state->attributeData[i].data(vertexData)};
-        }
-    }
-
     if(parsePerFaceAttributes) {
-        faceAttributeData = Containers::Array<MeshAttributeData>{_state->faceAttributeData.size()};
+        faceAttributeData = Containers::Array<MeshAttributeData>{faceAttributes.size()};
         for(std::size_t i = 0; i != faceAttributeData.size(); ++i) {
+            const MeshAttributeData& attribute = _state->faceAttributeData[faceAttributes[i]];
             faceAttributeData[i] = MeshAttributeData{
-                _state->faceAttributeData[i].name(),
-                _state->faceAttributeData[i].format(),
+                attribute.name(), attribute.format(),
                 Containers::StridedArrayView1D<const void>{
                     faceData,
-                    _state->faceAttributeData[i].data(faceData).data(),
+                    attribute.data(faceData).data(),
                     triangleFaceCount,
-                    _state->faceAttributeData[i].stride()}};
+                    attribute.stride()}};
         }
     }
 
-    /* Endian-swap the data, if needed */
+    /* Endian-swap the face and index data, if needed. Vertex data were
+       swapped already during the copy. The face data are swapped through a
+       temporary copy as the swap can't be done in place efficiently. */
     if(_state->fileFormatNeedsEndianSwapping) {
-        for(const auto& attributeData: {
-            Containers::arrayView(vertexAttributeData),
-            Containers::arrayView(faceAttributeData)}) {
-            for(const MeshAttributeData& attribute: attributeData) {
-                const UnsignedInt formatSize =
-                    vertexFormatSize(vertexFormatComponentFormat(attribute.format()));
-                if(formatSize == 1) continue;
-                const UnsignedInt componentCount =
-                    vertexFormatComponentCount(attribute.format());
-                const Containers::StridedArrayView1D<const void> data =
-                    attribute.data(attributeData.data() == vertexAttributeData.data() ? vertexData : faceData);
-                /** @todo some arrayConstCast? ugh */
-                const Containers::StridedArrayView1D<void> mutableData{
-                    {const_cast<void*>(data.data()), ~std::size_t{}},
-                    const_cast<void*>(data.data()), data.size(), data.stride()};
-                if(formatSize == 2) {
-                    for(Containers::StridedArrayView1D<UnsignedShort> component: Containers::arrayCast<2, UnsignedShort>(mutableData, componentCount).transposed<0, 1>())
-                        Utility::Endianness::swapInPlace(component);
-                } else if(formatSize == 4) {
-                    for(Containers::StridedArrayView1D<UnsignedInt> component: Containers::arrayCast<2, UnsignedInt>(mutableData, componentCount).transposed<0, 1>())
-                        Utility::Endianness::swapInPlace(component);
-                } else if(formatSize == 8) {
-                    for(Containers::StridedArrayView1D<UnsignedLong> component: Containers::arrayCast<2, UnsignedLong>(mutableData, componentCount).transposed<0, 1>())
-                        Utility::Endianness::swapInPlace(component);
-                } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
-            }
+        if(parsePerFaceAttributes && !faceData.empty()) {
+            Containers::Array<char> swappedFaceData{Containers::NoInit, faceData.size()};
+            swapCopy(faceData, _state->faceSwapPattern.size(), swappedFaceData, _state->faceSwapPattern);
+            Utility::copy(Containers::ArrayView<const char>{swappedFaceData}, Containers::arrayView(faceData));
         }
 
         if(level == 0) {
             if(faceIndexTypeSize == 2)
-                Utility::Endianness::swapInPlace(Containers::arrayCast<UnsignedShort>(indexData));
+                swapIndicesInPlace<2>(indexData);
             else if(faceIndexTypeSize == 4)
-                Utility::Endianness::swapInPlace(Containers::arrayCast<UnsignedInt>(indexData));
+                swapIndicesInPlace<4>(indexData);
             else CORRADE_INTERNAL_ASSERT(faceIndexTypeSize == 1);
         }
     }
@@ -860,18 +1844,103 @@ Containers::Optional<MeshData> StanfordImporter::doMesh(UnsignedInt, const Unsig
         if(flags() & ImporterFlag::Verbose)
             Debug{} << "Trade::StanfordImporter::mesh(): converting" << faceAttributeData.size() << "per-face attributes to per-vertex";
 
-        /** @todo in this case it'll assert if indices are out of bounds, check
-            for it at runtime somehow */
-        MeshIndexData indices{_state->faceIndexType, indexData};
-        MeshData perVertex{MeshPrimitive::Triangles,
-            std::move(indexData), indices,
-            std::move(vertexData), std::move(vertexAttributeData)};
-        MeshData perFace{MeshPrimitive::Faces,
-            std::move(faceData), std::move(faceAttributeData), triangleFaceCount};
-        return MeshTools::combineFaceAttributes(perVertex, perFace);
+        /* Pack the imported face attributes tightly together and find
+           unique faces among them */
+        std::size_t faceStride = 0;
+        for(const MeshAttributeData& attribute: faceAttributeData)
+            faceStride += vertexFormatSize(attribute.format());
+        Containers::Array<char> packedFaceData{Containers::NoInit, triangleFaceCount*faceStride};
+        {
+            std::size_t offset = 0;
+            for(const MeshAttributeData& attribute: faceAttributeData) {
+                const std::size_t size = vertexFormatSize(attribute.format());
+                const Containers::StridedArrayView1D<const void> src = attribute.data();
+                Utility::copy(
+                    Containers::StridedArrayView2D<const char>{faceData,
+                        static_cast<const char*>(src.data()),
+                        {triangleFaceCount, size},
+                        {src.stride(), 1}},
+                    Containers::StridedArrayView2D<char>{packedFaceData,
+                        packedFaceData + offset,
+                        {triangleFaceCount, size},
+                        {std::ptrdiff_t(faceStride), 1}});
+                offset += size;
+            }
+        }
+        Containers::Array<UnsignedInt> faceIds{Containers::NoInit, triangleFaceCount};
+        removeDuplicates(packedFaceData, faceStride, configuredThreadCount, faceIds);
+
+        /* Combine each vertex index with an ID of the face it belongs to and
+           find unique combinations among these. Those become the new
+           vertices, and their IDs the new indices. */
+        const std::size_t indexCount = std::size_t(triangleFaceCount)*3;
+        Containers::Array<Vector2ui> combined{Containers::NoInit, indexCount};
+        for(std::size_t i = 0; i != indexCount; ++i) {
+            const UnsignedInt index = indexAt(indexData, faceIndexTypeSize, i);
+            if(index >= _state->vertexCount) {
+                Error{} << "Trade::StanfordImporter::mesh(): index" << index << "out of bounds for" << _state->vertexCount << "vertices";
+                return Containers::NullOpt;
+            }
+            combined[i] = {index, faceIds[i/3]};
+        }
+        Containers::Array<char> combinedIndexData{Containers::NoInit, indexCount*sizeof(UnsignedInt)};
+        const Containers::ArrayView<UnsignedInt> combinedIndices = Containers::arrayCast<UnsignedInt>(combinedIndexData);
+        const Containers::Array<const char*> unique = removeDuplicates(
+            Containers::arrayCast<const char>(combined), sizeof(Vector2ui),
+            configuredThreadCount, combinedIndices);
+
+        /* Assemble the new vertices, each being the original vertex followed
+           by the packed face attributes. The original vertex layout is
+           kept. */
+        const std::size_t vertexStride = vertexAttributeData.empty() ? 0 :
+            vertexAttributeData[0].stride();
+        const std::size_t stride = vertexStride + faceStride;
+        Containers::Array<char> combinedVertexData{Containers::NoInit, unique.size()*stride};
+        const UnsignedInt threadCount = Math::max(Math::min(configuredThreadCount, UnsignedInt((unique.size() + FaceChunkSize - 1)/FaceChunkSize)), 1u);
+        const std::size_t rangeSize = (unique.size() + threadCount - 1)/threadCount;
+        parallelFor(threadCount, [&](const UnsignedInt t) {
+            const std::size_t begin = Math::min(t*rangeSize, unique.size());
+            const std::size_t end = Math::min(begin + rangeSize, unique.size());
+            for(std::size_t i = begin; i != end; ++i) {
+                const std::size_t index = reinterpret_cast<const Vector2ui*>(unique[i]) - combined.data();
+                char* const dst = combinedVertexData + i*stride;
+                std::memcpy(dst, vertexDataView + std::size_t(combined[index].x())*vertexStride, vertexStride);
+                std::memcpy(dst + vertexStride, packedFaceData + (index/3)*faceStride, faceStride);
+            }
+        });
+
+        Containers::Array<MeshAttributeData> combinedAttributeData{vertexAttributeData.size() + faceAttributeData.size()};
+        for(std::size_t i = 0; i != vertexAttributeData.size(); ++i) {
+            const MeshAttributeData& attribute = vertexAttributeData[i];
+            combinedAttributeData[i] = MeshAttributeData{
+                attribute.name(), attribute.format(),
+                Containers::StridedArrayView1D<const void>{combinedVertexData,
+                    combinedVertexData + (static_cast<const char*>(attribute.data().data()) - vertexDataView.data()),
+                    unique.size(), std::ptrdiff_t(stride)}};
+        }
+        std::size_t offset = vertexStride;
+        for(std::size_t i = 0; i != faceAttributeData.size(); ++i) {
+            const MeshAttributeData& attribute = faceAttributeData[i];
+            combinedAttributeData[vertexAttributeData.size() + i] = MeshAttributeData{
+                attribute.name(), attribute.format(),
+                Containers::StridedArrayView1D<const void>{combinedVertexData,
+                    combinedVertexData + offset,
+                    unique.size(), std::ptrdiff_t(stride)}};
+            offset += vertexFormatSize(attribute.format());
+        }
+
+        MeshIndexData indices{combinedIndices};
+        return MeshData{MeshPrimitive::Triangles,
+            std::move(combinedIndexData), indices,
+            std::move(combinedVertexData), std::move(combinedAttributeData)};
     }
 
-    if(level == 0) {
+    if(zeroCopy) {
+        MeshIndexData indices{_state->faceIndexType, indexData};
+        return MeshData{MeshPrimitive::Triangles,
+            std::move(indexData), indices,
+            DataFlags{}, vertexDataView, std::move(vertexAttributeData)};
+    } else if(level == 0) {
         MeshIndexData indices{_state->faceIndexType, indexData};
         return MeshData{MeshPrimitive::Triangles,
             std::move(indexData), indices,
@@ -891,6 +1960,10 @@ MeshAttribute StanfordImporter::doMeshAttributeForName(const std::string& name)
     return _state ? _state->attributeNameMap[name] : MeshAttribute{};
 }
 
+const void* StanfordImporter::doImporterState() const {
+    return &_state->header;
+}
+
 }}
 
 CORRADE_PLUGIN_REGISTER(StanfordImporter, Magnum::Trade::StanfordImporter,
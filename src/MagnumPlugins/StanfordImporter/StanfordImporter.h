@@ -29,8 +29,11 @@
  * @brief Class @ref Magnum::Trade::StanfordImporter
  */
 
+#include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/Pointer.h>
+#include <Magnum/Math/Range.h>
 #include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/MeshData.h>
 
 #include "MagnumPlugins/StanfordImporter/configure.h"
 
@@ -52,10 +55,66 @@
 
 namespace Magnum { namespace Trade {
 
+/**
+@brief Stanford PLY header information
+
+Returned from @ref StanfordImporter::importerState(). See
+@ref Trade-StanfordImporter-behavior-header-only for more information.
+*/
+struct StanfordImporterHeader {
+    /** @brief Vertex count */
+    UnsignedInt vertexCount;
+
+    /** @brief Face count, before triangulation */
+    UnsignedInt faceCount;
+
+    /** @brief Size of a single vertex in the file */
+    UnsignedInt vertexStride;
+
+    /** @brief Type of the face size in the face index list */
+    MeshIndexType faceSizeType;
+
+    /** @brief Type of the indices in the face index list */
+    MeshIndexType faceIndexType;
+
+    /** @brief Whether the file is ASCII */
+    bool ascii;
+
+    /** @brief Whether the file is Big-Endian. Always @cpp false @ce for ASCII files. */
+    bool bigEndian;
+
+    /**
+     * @brief Whether the file is a point cloud
+     * @m_since_latest_{plugins}
+     *
+     * Set if the file has no face element at all. See
+     * @ref Trade-StanfordImporter-behavior-point-clouds for more
+     * information.
+     */
+    bool pointCloud;
+
+    /**
+     * @brief Vertex attributes
+     *
+     * Offset-only, with offsets relative to the beginning of a vertex and
+     * the stride being @ref vertexStride.
+     */
+    Containers::ArrayView<const MeshAttributeData> vertexAttributes;
+
+    /**
+     * @brief Face attributes
+     *
+     * Offset-only, with offsets relative to the beginning of a face with the
+     * index list excluded.
+     */
+    Containers::ArrayView<const MeshAttributeData> faceAttributes;
+};
+
 /**
 @brief Stanford PLY importer plugin
 
-Supports Little- and Big-Endian binary formats with triangle and quad meshes.
+Supports Little- and Big-Endian binary formats as well as the ASCII format with
+triangle and quad meshes.
 Imports vertex positions, normals, 2D texture coordinates, vertex colors,
 custom attributes and per-face data as well.
 
@@ -100,8 +159,13 @@ In order to optimize for fast import, the importer supports a restricted subset
 of PLY features, which however shouldn't affect any real-world models.
 
 -   Both Little- and Big-Endian binary files are supported, with bytes swapped
-    to match platform endianness. ASCII files are not supported due to the
-    storage size overhead and inherent inefficiency of float literal parsing.
+    to match platform endianness. ASCII files are supported as well, with the
+    body converted to a binary representation matching platform endianness
+    already during @ref openData() / @ref openFile(). Because of the storage
+    size overhead and inherent inefficiency of float literal parsing, binary
+    files are still recommended for large data. The conversion handles the
+    common case of literals with at most 19 significant digits directly,
+    falling back to @ref std::strtod() only for the rest.
 -   Position coordinates (`x`/`y`/`z`) are expected to have the same type, be
     tightly packed in a XYZ order and be either 32-bit floats or (signed) bytes
     or shorts. Resulting position type is then
@@ -145,12 +209,104 @@ of PLY features, which however shouldn't affect any real-world models.
     for indices as well, but interpreted as unsigned (because negative values
     wouldn't make sense anyway).
 
-The mesh is always indexed; positions are always present, other attributes are
-optional.
+The mesh is always indexed, except for
+@ref Trade-StanfordImporter-behavior-point-clouds "point clouds"; positions
+are always present, other attributes are optional.
 
 The importer recognizes @ref ImporterFlag::Verbose, printing additional info
 when the flag is enabled.
 
+@subsection Trade-StanfordImporter-behavior-faces Face parsing
+
+If all faces in the file are triangles, the indices and per-face data are
+copied directly in a single strided pass, unless the
+@cb{.ini} triangleFastPath @ce
+@ref Trade-StanfordImporter-configuration "configuration option" is disabled.
+Otherwise the faces are first validated and counted to calculate exact output
+size and then copied into the outputs in a second pass. The second pass can be
+distributed across multiple threads using the @cb{.ini} threads @ce option.
+In that case the application needs to link to `pthread` on Linux due to the
+same reasons as described in @ref Trade-BasisImageConverter-loading "BasisImageConverter docs".
+
+@subsection Trade-StanfordImporter-behavior-zero-copy Memory-mapped files and zero-copy import
+
+On Unix and non-RT Windows, files opened through @ref openFile() are
+memory-mapped instead of being read into memory, files passed to
+@ref openData() are copied. Additionally, if the @cb{.ini} zeroCopy @ce
+@ref Trade-StanfordImporter-configuration "configuration option" is enabled
+and the file doesn't need an endian swap, the vertex data of the level
+@cpp 0 @ce mesh are not copied but reference the file data directly. In that
+case @ref MeshData::vertexDataFlags() are empty and the returned instance is
+valid only until the file is closed. Index data as well as per-face data are
+always copied, as they need to be extracted from the face list.
+
+@subsection Trade-StanfordImporter-behavior-attribute-filter Importing a subset of attributes
+
+By default all vertex and face attributes are imported. If only some are
+needed, list them in the @cb{.ini} attributes @ce
+@ref Trade-StanfordImporter-configuration "configuration option". Builtin
+attributes are matched by their @ref MeshAttribute enum name, custom ones by
+the name in the file. The chosen vertex attributes are then packed tightly
+together, which saves memory and copying bandwidth for files with many
+properties per vertex. If zero-copy import is enabled, the vertex data are
+referenced from the file as a whole and only the attribute list is
+restricted.
+
+@subsection Trade-StanfordImporter-behavior-header-only Header-only import
+
+Calling @ref importerState() returns a pointer to a @ref StanfordImporterHeader
+structure with vertex and face counts and the list of recognized attributes
+along with their types. If only this information is needed, enable the
+@cb{.ini} headerOnly @ce
+@ref Trade-StanfordImporter-configuration "configuration option" before
+opening the file. The importer then reads just the file header, never
+touching the body, and @ref meshCount() returns @cpp 0 @ce. The body
+isn't validated in that case.
+
+@subsection Trade-StanfordImporter-behavior-chunked Chunked import
+
+For out-of-core processing of large files it's possible to import the file in
+fixed-size chunks instead of one large mesh by setting the
+@cb{.ini} chunkSize @ce
+@ref Trade-StanfordImporter-configuration "configuration option" to a
+non-zero value. @ref meshCount() then returns the count of vertex chunks
+followed by the count of face chunks. The first are
+@ref MeshPrimitive::Points meshes with at most @cb{.ini} chunkSize @ce
+consecutive vertices each, the second are @ref MeshPrimitive::Triangles meshes
+with just triangulated indices of at most @cb{.ini} chunkSize @ce consecutive
+faces, pointing to vertices of the whole file. All chunks reuse the same
+internal allocation and thus have empty @ref MeshData::vertexDataFlags() /
+@ref MeshData::indexDataFlags() and are valid only until the next
+@ref mesh() call. Together with the @cb{.ini} zeroCopy @ce option and a
+memory-mapped file the vertex chunks don't copy anything. Per-face
+attributes are not imported in this mode and so @ref meshLevelCount() is
+always @cpp 1 @ce.
+
+@subsection Trade-StanfordImporter-behavior-point-clouds Point clouds
+
+Files that have just an @cb{.ini} element vertex @ce and no
+@cb{.ini} element face @ce at all, which is common for output of 3D
+scanners, are treated as point clouds. The face handling is skipped
+completely in that case and the file is imported as a single non-indexed
+@ref MeshPrimitive::Points mesh, @ref meshLevelCount() being always
+@cpp 1 @ce. In chunked import there are only the vertex chunks.
+
+If the @cb{.ini} mortonOrder @ce
+@ref Trade-StanfordImporter-configuration "configuration option" is enabled,
+the points are additionally reordered along a Z-order curve, with positions
+quantized to 21 bits per axis relative to bounds of the whole cloud. Points
+close to each other in space then end up close to each other in memory as
+well, and together with @cb{.ini} chunkSize @ce each chunk covers a compact
+region of space. The sorted data are calculated on first access and kept
+until the file is closed or the @cb{.ini} attributes or @cb{.ini} chunkSize
+options change, the returned meshes reference them and thus have empty
+@ref MeshData::vertexDataFlags(). The @cb{.ini} zeroCopy @ce option has no
+effect in this case, as the data have to be reordered.
+
+Bounds of positions in any mesh or vertex chunk can be queried using
+@ref meshBounds(). For Morton-ordered point clouds the bounds are calculated
+together with the reordering, otherwise on every call.
+
 @subsection Trade-StanfordImporter-behavior-per-face Per-face attributes
 
 By default, if the mesh contains per-face attributes apart from indices, these
@@ -158,7 +314,10 @@ get converted to per-vertex during import. This is what the users usually want,
 however for large meshes this may have a performance impact due to calculating
 only unique per-vertex/per-face data combinations. If this conversion takes
 place, the resulting index type is always @ref MeshIndexType::UnsignedInt,
-independent of what the file has.
+independent of what the file has. The conversion can be distributed across multiple
+threads using the @cb{.ini} threads @ce
+@ref Trade-StanfordImporter-configuration "configuration option", producing
+the same output as a single-threaded conversion.
 
 Alternatively, if the @cb{.ini} perFaceToPerVertex @ce
 @ref Trade-StanfordImporter-configuration "configuration option" is disabled,
@@ -181,6 +340,26 @@ using @ref meshAttributeName() and @ref meshAttributeForName(). Attributes with
 unknown types cause the import to fail, as the format relies on knowing the
 type size.
 
+@section Trade-StanfordImporter-profiling Profiling
+
+If the plugin is built with `WITH_IMPORTER_PROFILING` enabled, it measures
+the duration of individual import stages and reports them to a callback set
+with @ref setProfilingCallback(), together with the amount of data each stage
+processed. The stages are:
+
+-   `parse` --- parsing the header and converting ASCII files to binary in
+    @ref openData() / @ref openFile(), with the input size
+-   `copy` --- copying the data passed to @ref openData(), with the input size
+-   `vertices` --- copying or swizzling vertex data in @ref mesh(), with the
+    output vertex data size
+-   `mesh` --- the whole @ref mesh() call including the above and parsing of
+    faces, with the size of the output vertex and index data
+
+Without `WITH_IMPORTER_PROFILING` the measurement is compiled out and the
+callback is never called. If it's enabled, the
+@cpp MAGNUM_STANFORDIMPORTER_WITH_PROFILING @ce macro is defined in the
+`MagnumPlugins/StanfordImporter/configure.h` header.
+
 @section Trade-StanfordImporter-configuration Plugin-specific config
 
 It's possible to tune various import options through @ref configuration(). See
@@ -199,24 +378,68 @@ class MAGNUM_STANFORDIMPORTER_EXPORT StanfordImporter: public AbstractImporter {
 
         ~StanfordImporter();
 
+        /**
+         * @brief Set profiling callback
+         * @m_since_latest_{plugins}
+         *
+         * The @p callback is called at the end of each import stage with the
+         * stage name, its duration in nanoseconds, count of bytes it
+         * processed or @cpp 0 @ce if not applicable, and @p userData. The
+         * callback is kept across opened files, pass @cpp nullptr @ce to
+         * reset it. Doesn't need any file to be opened. If the plugin isn't
+         * built with `WITH_IMPORTER_PROFILING`, the callback is never
+         * called. See @ref Trade-StanfordImporter-profiling for more
+         * information.
+         */
+        virtual void setProfilingCallback(void(*callback)(const char* stage, UnsignedLong nanoseconds, std::size_t byteCount, void* userData), void* userData = nullptr);
+
+        /**
+         * @brief Bounds of positions in a mesh
+         * @m_since_latest_{plugins}
+         *
+         * Returns a range containing positions of all vertices in mesh
+         * @p id. To be used mainly with vertex chunks of
+         * @ref Trade-StanfordImporter-behavior-point-clouds "point clouds",
+         * for regular meshes it covers all vertices in the file. Positions
+         * are taken from the file independently of the @cb{.ini} attributes
+         * @ref Trade-StanfordImporter-configuration "configuration option".
+         * Returns @ref Containers::NullOpt for face chunks in
+         * @ref Trade-StanfordImporter-behavior-chunked "chunked import",
+         * which contain only indices. Expects that a file is opened and
+         * @p id is less than @ref meshCount().
+         */
+        virtual Containers::Optional<Range3D> meshBounds(UnsignedInt id);
+
     private:
         MAGNUM_STANFORDIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
 
         MAGNUM_STANFORDIMPORTER_LOCAL bool doIsOpened() const override;
         MAGNUM_STANFORDIMPORTER_LOCAL void doOpenFile(const std::string& filename) override;
         MAGNUM_STANFORDIMPORTER_LOCAL void doOpenData(Containers::ArrayView<const char> data) override;
-        MAGNUM_STANFORDIMPORTER_LOCAL void openDataInternal(Containers::Array<char>&& data);
+        MAGNUM_STANFORDIMPORTER_LOCAL void openDataInternal(Containers::ArrayView<const char> data);
         MAGNUM_STANFORDIMPORTER_LOCAL void doClose() override;
 
 
         MAGNUM_STANFORDIMPORTER_LOCAL UnsignedInt doMeshCount() const override;
         MAGNUM_STANFORDIMPORTER_LOCAL UnsignedInt doMeshLevelCount(UnsignedInt id) override;
         MAGNUM_STANFORDIMPORTER_LOCAL Containers::Optional<MeshData> doMesh(UnsignedInt id, UnsignedInt level) override;
+        MAGNUM_STANFORDIMPORTER_LOCAL Containers::Optional<MeshData> meshInternal(UnsignedInt id, UnsignedInt level);
         MAGNUM_STANFORDIMPORTER_LOCAL MeshAttribute doMeshAttributeForName(const std::string& name) override;
         MAGNUM_STANFORDIMPORTER_LOCAL std::string doMeshAttributeName(UnsignedShort name) override;
 
+        MAGNUM_STANFORDIMPORTER_LOCAL const void* doImporterState() const override;
+
+        MAGNUM_STANFORDIMPORTER_LOCAL void importedAttributes(Containers::Array<UnsignedInt>& vertexAttributes, Containers::Array<UnsignedInt>& faceAttributes);
+        MAGNUM_STANFORDIMPORTER_LOCAL Containers::Optional<MeshData> meshChunk(UnsignedInt id, UnsignedInt chunkSize);
+        MAGNUM_STANFORDIMPORTER_LOCAL Containers::Optional<MeshData> pointCloudMesh(UnsignedInt id, UnsignedInt chunkSize);
+        MAGNUM_STANFORDIMPORTER_LOCAL void sortPointCloud(UnsignedInt chunkSize);
+        MAGNUM_STANFORDIMPORTER_LOCAL Containers::Array<Vector3> importPositions(UnsignedInt offset, UnsignedInt count);
+        MAGNUM_STANFORDIMPORTER_LOCAL Containers::ArrayView<const char> importVertexData(UnsignedInt offset, UnsignedInt count, Containers::ArrayView<const UnsignedInt> attributes, bool zeroCopy, Containers::Array<char>& vertexData, Containers::Array<MeshAttributeData>& attributeData);
+
         struct State;
         Containers::Pointer<State> _state;
+        void(*_profilingCallback)(const char*, UnsignedLong, std::size_t, void*){};
+        void* _profilingUserData{};
 };
 
 }}
@@ -0,0 +1,234 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstring>
+#include <string>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/Endianness.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Magnum/Math/Vector3.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/MeshData.h>
+
+#include "MagnumPlugins/Implementation/peakMemory.h"
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+struct StanfordImporterBenchmark: TestSuite::Tester {
+    explicit StanfordImporterBenchmark();
+
+    void open();
+    void firstData();
+    void peakMemory();
+
+    void peakMemoryBegin();
+    std::uint64_t peakMemoryEnd();
+
+    /* Explicitly forbid system-wide plugin dependencies */
+    PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
+
+    std::uint64_t _residentSizeBefore{};
+};
+
+/* To calculate the throughput, divide the file size shown in the test case
+   description by the measured time */
+constexpr struct {
+    const char* name;
+    bool normals, colors, headerOnly;
+} FileData[]{
+    {"positions", false, false, false},
+    {"positions, normals, colors", true, true, false},
+    {"positions, header only", false, false, true}
+};
+
+/* A 512x512 quad grid, so about 263k vertices and 524k triangles, generated
+   instead of bundling large files */
+Containers::Array<char> file(const bool normals, const bool colors) {
+    constexpr UnsignedInt GridSize = 512;
+    constexpr UnsignedInt VertexCount = (GridSize + 1)*(GridSize + 1);
+    constexpr UnsignedInt FaceCount = GridSize*GridSize*2;
+
+    std::string header = Utility::formatString(
+        "ply\n"
+        "format binary_{}_endian 1.0\n"
+        "element vertex {}\n"
+        "property float x\n"
+        "property float y\n"
+        "property float z\n",
+        Utility::Endianness::isBigEndian() ? "big" : "little", VertexCount);
+    if(normals) header +=
+        "property float nx\n"
+        "property float ny\n"
+        "property float nz\n";
+    if(colors) header +=
+        "property uchar red\n"
+        "property uchar green\n"
+        "property uchar blue\n";
+    header += Utility::formatString(
+        "element face {}\n"
+        "property list uchar uint vertex_indices\n"
+        "end_header\n", FaceCount);
+
+    const std::size_t vertexSize = 12 + (normals ? 12 : 0) + (colors ? 3 : 0);
+    constexpr std::size_t FaceSize = 1 + 3*4;
+    Containers::Array<char> out{Containers::NoInit, header.size() + VertexCount*vertexSize + FaceCount*FaceSize};
+    std::memcpy(out.data(), header.data(), header.size());
+
+    char* vertex = out.data() + header.size();
+    for(UnsignedInt y = 0; y <= GridSize; ++y) {
+        for(UnsignedInt x = 0; x <= GridSize; ++x) {
+            const Vector3 position{Float(x), Float(y), Float((x*y) % 7)};
+            std::memcpy(vertex, position.data(), 12);
+            vertex += 12;
+            if(normals) {
+                const Vector3 normal = Vector3::zAxis();
+                std::memcpy(vertex, normal.data(), 12);
+                vertex += 12;
+            }
+            if(colors) {
+                *vertex++ = char(x);
+                *vertex++ = char(y);
+                *vertex++ = char(x + y);
+            }
+        }
+    }
+
+    char* face = vertex;
+    for(UnsignedInt y = 0; y != GridSize; ++y) {
+        for(UnsignedInt x = 0; x != GridSize; ++x) {
+            const UnsignedInt a = y*(GridSize + 1) + x;
+            const UnsignedInt b = a + 1;
+            const UnsignedInt c = a + GridSize + 1;
+            const UnsignedInt d = c + 1;
+            const UnsignedInt triangles[]{a, b, d, a, d, c};
+            for(std::size_t i = 0; i != 2; ++i) {
+                *face++ = 3;
+                std::memcpy(face, triangles + i*3, 12);
+                face += 12;
+            }
+        }
+    }
+
+    CORRADE_INTERNAL_ASSERT(face == out.end());
+    return out;
+}
+
+StanfordImporterBenchmark::StanfordImporterBenchmark() {
+    addInstancedBenchmarks({&StanfordImporterBenchmark::open}, 10,
+        Containers::arraySize(FileData));
+
+    addInstancedBenchmarks({&StanfordImporterBenchmark::firstData}, 10,
+        Containers::arraySize(FileData));
+
+    addCustomInstancedBenchmarks({&StanfordImporterBenchmark::peakMemory}, 1,
+        Containers::arraySize(FileData),
+        &StanfordImporterBenchmark::peakMemoryBegin,
+        &StanfordImporterBenchmark::peakMemoryEnd,
+        BenchmarkUnits::Bytes);
+
+    /* Load the plugin directly from the build tree. Otherwise it's static and
+       already loaded. */
+    #ifdef STANFORDIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(STANFORDIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+void StanfordImporterBenchmark::open() {
+    auto&& data = FileData[testCaseInstanceId()];
+
+    const Containers::Array<char> in = file(data.normals, data.colors);
+    setTestCaseDescription(Utility::formatString("{}, {} bytes", data.name, in.size()));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
+    importer->configuration().setValue("headerOnly", data.headerOnly);
+
+    bool opened = false;
+    CORRADE_BENCHMARK(1)
+        opened = importer->openData(in);
+
+    CORRADE_VERIFY(opened);
+}
+
+void StanfordImporterBenchmark::firstData() {
+    auto&& data = FileData[testCaseInstanceId()];
+
+    const Containers::Array<char> in = file(data.normals, data.colors);
+    setTestCaseDescription(Utility::formatString("{}, {} bytes", data.name, in.size()));
+    if(data.headerOnly)
+        CORRADE_SKIP("No mesh data to import with headerOnly enabled.");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
+
+    Containers::Optional<MeshData> mesh;
+    CORRADE_BENCHMARK(1) {
+        importer->openData(in);
+        mesh = importer->mesh(0);
+    }
+
+    CORRADE_VERIFY(mesh);
+}
+
+void StanfordImporterBenchmark::peakMemory() {
+    auto&& data = FileData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifndef __linux__
+    CORRADE_SKIP("Peak memory can be measured only on Linux.");
+    #else
+    if(data.headerOnly)
+        CORRADE_SKIP("No mesh data to import with headerOnly enabled.");
+
+    /* The input is generated outside of the measured region, so only the
+       memory allocated by the importer and for the output is counted */
+    const Containers::Array<char> in = file(data.normals, data.colors);
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
+
+    Containers::Optional<MeshData> mesh;
+    CORRADE_BENCHMARK(1) {
+        importer->openData(in);
+        mesh = importer->mesh(0);
+    }
+
+    CORRADE_VERIFY(mesh);
+    #endif
+}
+
+void StanfordImporterBenchmark::peakMemoryBegin() {
+    _residentSizeBefore = Magnum::Implementation::peakMemoryBegin();
+}
+
+std::uint64_t StanfordImporterBenchmark::peakMemoryEnd() {
+    return Magnum::Implementation::peakMemoryEnd(_residentSizeBefore);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::StanfordImporterBenchmark)
@@ -32,6 +32,7 @@
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Corrade/Utility/Directory.h>
+#include <Corrade/Utility/Endianness.h>
 #include <Corrade/Utility/FormatStl.h>
 #include <Corrade/Utility/String.h>
 #include <Magnum/Math/Color.h>
@@ -39,6 +40,8 @@
 #include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/MeshData.h>
 
+#include "MagnumPlugins/StanfordImporter/StanfordImporter.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Trade { namespace Test { namespace {
@@ -58,12 +61,23 @@ struct StanfordImporterTest: TestSuite::Tester {
 
     void customAttributes();
     void customAttributesPerFaceToPerVertex();
+    void customAttributesFilter();
     void customAttributesDuplicate();
     void customAttributesNoFileOpened();
 
     void triangleFastPath();
     void triangleFastPathPerFaceToPerVertex();
 
+    void zeroCopy();
+    void chunked();
+    void headerOnly();
+
+    void pointCloud();
+    void pointCloudChunked();
+    void pointCloudMortonOrder();
+
+    void profiling();
+
     void openTwice();
     void importTwice();
 
@@ -79,7 +93,7 @@ constexpr struct {
     {"invalid-signature", "invalid file signature bla", true},
 
     {"format-invalid", "invalid format line format binary_big_endian 1.0 extradata", true},
-    {"format-unsupported", "unsupported file format ascii 1.0", true},
+    {"format-unsupported", "unsupported file format ascii 2.0", true},
     {"format-missing", "missing format line", true},
     {"format-too-late", "expected format line, got element face 1", true},
 
@@ -117,7 +131,11 @@ constexpr struct {
 
     {"objectid-unsupported-type", "unsupported object ID type VertexFormat::Float", true},
 
-    {"unsupported-face-size", "unsupported face size 5", false}
+    {"ascii-invalid-vertex-data", "invalid or incomplete ASCII vertex data", true},
+    {"ascii-incomplete-face-data", "invalid or incomplete ASCII face data", true},
+
+    {"unsupported-face-size", "unsupported face size 5", false},
+    {"per-face-index-out-of-bounds", "index 5 out of bounds for 5 vertices", false}
 };
 
 constexpr struct {
@@ -187,6 +205,12 @@ constexpr struct {
         VertexFormat::Vector3s, VertexFormat::Vector3ubNormalized,
         VertexFormat{}, VertexFormat::Vector2usNormalized,
         VertexFormat{}, nullptr, 3, 0},
+    /* ASCII, same data as the LE/BE file with all attributes */
+    {"ascii",
+        MeshIndexType::UnsignedInt,
+        VertexFormat::Vector3, VertexFormat::Vector3,
+        VertexFormat::Vector3, VertexFormat::Vector2,
+        VertexFormat::UnsignedInt, nullptr, 5, 0},
     /* CR/LF instead of LF */
     {"crlf", MeshIndexType::UnsignedByte,
         VertexFormat::Vector3us, VertexFormat{},
@@ -222,7 +246,11 @@ constexpr struct {
     {"per-face normals, object ids, verbose", "per-face-normals-objectid.ply", 2,
         MeshIndexType::UnsignedByte,
         VertexFormat{}, VertexFormat::Vector3, VertexFormat::UnsignedShort,
-        ImporterFlag::Verbose, "Trade::StanfordImporter::mesh(): converting 2 per-face attributes to per-vertex\n"}
+        ImporterFlag::Verbose, "Trade::StanfordImporter::mesh(): converting 2 per-face attributes to per-vertex\n"},
+    {"per-face normals, object ids, ASCII", "ascii-per-face.ply", 2,
+        MeshIndexType::UnsignedByte,
+        VertexFormat{}, VertexFormat::Vector3, VertexFormat::UnsignedShort,
+        {}, ""}
 };
 
 constexpr struct {
@@ -240,14 +268,67 @@ constexpr struct {
     {"custom-components-be"}
 };
 
+constexpr struct {
+    const char* name;
+    const char* filename;
+    bool perFaceToPerVertex;
+    DataFlags vertexDataFlags;
+} ZeroCopyData[]{
+    {"", "positions-colors-normals-texcoords-float-objectid-uint-indices-int.ply", false, {}},
+    {"per-face to per-vertex", "positions-colors-normals-texcoords-float-objectid-uint-indices-int.ply", true, {}},
+    {"endian swap needed", "positions-colors-normals-texcoords-float-objectid-uint-indices-int-be.ply", false, DataFlag::Owned|DataFlag::Mutable}
+};
+
 constexpr struct {
     const char* name;
     bool enabled;
+    UnsignedInt threads;
 } FastTrianglePathData[]{
-    {"", true},
-    {"disabled", false}
+    {"", true, 1},
+    {"disabled", false, 1},
+    {"disabled, multithreaded", false, 4},
+    {"disabled, all threads", false, 0}
+};
+
+constexpr struct {
+    const char* name;
+    bool headerOnly;
+    bool openData;
+} HeaderOnlyData[]{
+    {"disabled", false, false},
+    {"", true, false},
+    {"from data", true, true}
+};
+
+constexpr struct {
+    const char* name;
+    const char* filename;
+} PointCloudData[]{
+    {"", "point-cloud.ply"},
+    {"ASCII", "point-cloud-ascii.ply"}
+};
+
+/* Points of the point-cloud.ply file and their order along the Z curve */
+const Vector3 PointCloudPositions[]{
+    {1.0f, 1.0f, 1.0f},
+    {0.0f, 0.0f, 0.0f},
+    {1.0f, 0.0f, 0.0f},
+    {0.0f, 1.0f, 0.0f},
+    {0.0f, 0.0f, 1.0f},
+    {0.5f, 0.5f, 0.5f}
+};
+
+const Color3ub PointCloudColors[]{
+    {0, 255, 0},
+    {51, 204, 0},
+    {102, 153, 0},
+    {153, 102, 0},
+    {204, 51, 0},
+    {255, 0, 0}
 };
 
+constexpr UnsignedInt PointCloudMortonOrder[]{1, 5, 2, 3, 4, 0};
+
 StanfordImporterTest::StanfordImporterTest() {
     addInstancedTests({&StanfordImporterTest::invalid},
         Containers::arraySize(InvalidData));
@@ -269,7 +350,8 @@ StanfordImporterTest::StanfordImporterTest() {
         Containers::arraySize(EmptyData));
 
     addInstancedTests({&StanfordImporterTest::customAttributes,
-                       &StanfordImporterTest::customAttributesPerFaceToPerVertex},
+                       &StanfordImporterTest::customAttributesPerFaceToPerVertex,
+                       &StanfordImporterTest::customAttributesFilter},
         Containers::arraySize(CustomAttributeData));
 
     addTests({&StanfordImporterTest::customAttributesDuplicate,
@@ -279,7 +361,24 @@ StanfordImporterTest::StanfordImporterTest() {
                        &StanfordImporterTest::triangleFastPathPerFaceToPerVertex},
         Containers::arraySize(FastTrianglePathData));
 
-    addTests({&StanfordImporterTest::openTwice,
+    addInstancedTests({&StanfordImporterTest::zeroCopy},
+        Containers::arraySize(ZeroCopyData));
+
+    addInstancedTests({&StanfordImporterTest::chunked},
+        Containers::arraySize(CustomAttributeData));
+
+    addInstancedTests({&StanfordImporterTest::headerOnly},
+        Containers::arraySize(HeaderOnlyData));
+
+    addInstancedTests({&StanfordImporterTest::pointCloud},
+        Containers::arraySize(PointCloudData));
+
+    addTests({&StanfordImporterTest::pointCloudChunked,
+              &StanfordImporterTest::pointCloudMortonOrder});
+
+    addTests({&StanfordImporterTest::profiling,
+
+              &StanfordImporterTest::openTwice,
               &StanfordImporterTest::importTwice});
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
@@ -843,6 +942,55 @@ void StanfordImporterTest::customAttributesPerFaceToPerVertex() {
         }), TestSuite::Compare::Container);
 }
 
+void StanfordImporterTest::customAttributesFilter() {
+    auto&& data = CustomAttributeData[testCaseInstanceId()];
+    setTestCaseDescription(Utility::String::replaceAll(data.filename, "-", " "));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
+
+    importer->configuration().setValue("perFaceToPerVertex", false);
+    /* Unknown names are ignored */
+    importer->configuration().setValue("attributes", "weight Position mask Normal");
+
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(STANFORDIMPORTER_TEST_DIR, Utility::formatString("{}.ply", data.filename))));
+
+    const MeshAttribute weightAttribute = importer->meshAttributeForName("weight");
+    const MeshAttribute maskAttribute = importer->meshAttributeForName("mask");
+
+    auto mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->attributeCount(), 2);
+    CORRADE_COMPARE_AS(mesh->indicesAsArray(),
+        Containers::arrayView(Indices),
+        TestSuite::Compare::Container);
+
+    /* The attributes are packed together in the original order, without the
+       skipped index */
+    CORRADE_COMPARE(mesh->vertexData().size(), 5*(6 + 8));
+    CORRADE_COMPARE(mesh->attributeName(0), MeshAttribute::Position);
+    CORRADE_COMPARE(mesh->attributeOffset(0), 0);
+    CORRADE_COMPARE(mesh->attributeStride(0), 14);
+    CORRADE_COMPARE_AS(mesh->positions3DAsArray(),
+        Containers::arrayView(Positions),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(mesh->attributeName(1), weightAttribute);
+    CORRADE_COMPARE(mesh->attributeOffset(1), 6);
+    CORRADE_COMPARE(mesh->attributeStride(1), 14);
+    CORRADE_COMPARE_AS(mesh->attribute<Double>(weightAttribute),
+        Containers::arrayView<Double>({
+            1.23456, 12.3456, 123.456, 1234.56, 12345.6
+        }), TestSuite::Compare::Container);
+
+    auto faceMesh = importer->mesh(0, 1);
+    CORRADE_VERIFY(faceMesh);
+    CORRADE_COMPARE(faceMesh->attributeCount(), 1);
+    CORRADE_COMPARE(faceMesh->attributeName(0), maskAttribute);
+    CORRADE_COMPARE_AS(faceMesh->attribute<UnsignedShort>(maskAttribute),
+        Containers::arrayView<UnsignedShort>({
+            0xf0f0, 0xf0f0, 0xf1f1
+        }), TestSuite::Compare::Container);
+}
+
 void StanfordImporterTest::customAttributesDuplicate() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
 
@@ -917,6 +1065,7 @@ void StanfordImporterTest::triangleFastPath() {
 
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
     importer->configuration().setValue("triangleFastPath", data.enabled);
+    importer->configuration().setValue("threads", data.threads);
     importer->configuration().setValue("perFaceToPerVertex", false);
 
     CORRADE_VERIFY(importer->openFile(Utility::Directory::join(STANFORDIMPORTER_TEST_DIR, "triangle-fast-path-be.ply")));
@@ -965,6 +1114,7 @@ void StanfordImporterTest::triangleFastPathPerFaceToPerVertex() {
 
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
     importer->configuration().setValue("triangleFastPath", data.enabled);
+    importer->configuration().setValue("threads", data.threads);
 
     /* Done by default */
     //importer->configuration().setValue("perFaceToPerVertex", true);
@@ -1005,6 +1155,278 @@ void StanfordImporterTest::triangleFastPathPerFaceToPerVertex() {
         }), TestSuite::Compare::Container);
 }
 
+void StanfordImporterTest::zeroCopy() {
+    auto&& data = ZeroCopyData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(Utility::Endianness::isBigEndian())
+        CORRADE_SKIP("The test files assume a Little-Endian platform.");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
+    importer->configuration().setValue("zeroCopy", true);
+    importer->configuration().setValue("perFaceToPerVertex", data.perFaceToPerVertex);
+
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(STANFORDIMPORTER_TEST_DIR, data.filename)));
+
+    auto mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    /* There are no per-face attributes, so the per-face to per-vertex
+       conversion has nothing to do and the data stay referenced */
+    CORRADE_COMPARE(mesh->vertexDataFlags(), data.vertexDataFlags);
+    CORRADE_COMPARE(mesh->indexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+    CORRADE_COMPARE_AS(mesh->indicesAsArray(),
+        Containers::arrayView(Indices),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->positions3DAsArray(),
+        Containers::arrayView(Positions),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->objectIdsAsArray(),
+        Containers::arrayView(ObjectIds),
+        TestSuite::Compare::Container);
+}
+
+void StanfordImporterTest::chunked() {
+    auto&& data = CustomAttributeData[testCaseInstanceId()];
+    setTestCaseDescription(Utility::String::replaceAll(data.filename, "-", " "));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
+    importer->configuration().setValue("chunkSize", 2);
+
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(STANFORDIMPORTER_TEST_DIR, Utility::formatString("{}.ply", data.filename))));
+
+    /* Three vertex chunks, one face chunk with one quad and one triangle */
+    CORRADE_COMPARE(importer->meshCount(), 4);
+    CORRADE_COMPARE(importer->meshLevelCount(0), 1);
+
+    const MeshAttribute weightAttribute = importer->meshAttributeForName("weight");
+    for(UnsignedInt i = 0; i != 3; ++i) {
+        CORRADE_ITERATION(i);
+        const std::size_t count = i == 2 ? 1 : 2;
+
+        auto mesh = importer->mesh(i);
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Points);
+        CORRADE_VERIFY(!mesh->isIndexed());
+        CORRADE_COMPARE(mesh->vertexDataFlags(), DataFlags{});
+        CORRADE_COMPARE(mesh->vertexCount(), count);
+        CORRADE_COMPARE(mesh->attributeCount(), 3);
+        CORRADE_COMPARE_AS(mesh->positions3DAsArray(),
+            Containers::arrayView(Positions).slice(i*2, i*2 + count),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(mesh->attribute<Double>(weightAttribute),
+            Containers::arrayView<Double>({
+                1.23456, 12.3456, 123.456, 1234.56, 12345.6
+            }).slice(i*2, i*2 + count), TestSuite::Compare::Container);
+    }
+
+    auto mesh = importer->mesh(3);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+    CORRADE_COMPARE(mesh->indexDataFlags(), DataFlags{});
+    CORRADE_COMPARE(mesh->attributeCount(), 0);
+    CORRADE_COMPARE(mesh->vertexCount(), 5);
+    CORRADE_COMPARE(mesh->indexType(), MeshIndexType::UnsignedByte);
+    CORRADE_COMPARE_AS(mesh->indicesAsArray(),
+        Containers::arrayView(Indices),
+        TestSuite::Compare::Container);
+}
+
+void StanfordImporterTest::headerOnly() {
+    auto&& data = HeaderOnlyData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
+    importer->configuration().setValue("headerOnly", data.headerOnly);
+
+    const std::string filename = Utility::Directory::join(STANFORDIMPORTER_TEST_DIR, "custom-components.ply");
+    if(data.openData)
+        CORRADE_VERIFY(importer->openData(Utility::Directory::read(filename)));
+    else
+        CORRADE_VERIFY(importer->openFile(filename));
+    CORRADE_COMPARE(importer->meshCount(), data.headerOnly ? 0 : 1);
+
+    auto header = static_cast<const StanfordImporterHeader*>(importer->importerState());
+    CORRADE_VERIFY(header);
+    CORRADE_COMPARE(header->vertexCount, 5);
+    CORRADE_COMPARE(header->faceCount, 2);
+    CORRADE_COMPARE(header->vertexStride, 15);
+    CORRADE_COMPARE(header->faceSizeType, MeshIndexType::UnsignedInt);
+    CORRADE_COMPARE(header->faceIndexType, MeshIndexType::UnsignedByte);
+    CORRADE_VERIFY(!header->ascii);
+    CORRADE_VERIFY(!header->bigEndian);
+    CORRADE_VERIFY(!header->pointCloud);
+
+    /* Custom attributes are added first, builtin after */
+    CORRADE_COMPARE(header->vertexAttributes.size(), 3);
+    CORRADE_COMPARE(header->vertexAttributes[0].name(), importer->meshAttributeForName("index"));
+    CORRADE_COMPARE(header->vertexAttributes[0].format(), VertexFormat::UnsignedByte);
+    CORRADE_COMPARE(header->vertexAttributes[0].offset({}), 0);
+    CORRADE_COMPARE(header->vertexAttributes[1].name(), importer->meshAttributeForName("weight"));
+    CORRADE_COMPARE(header->vertexAttributes[1].format(), VertexFormat::Double);
+    CORRADE_COMPARE(header->vertexAttributes[1].offset({}), 7);
+    CORRADE_COMPARE(header->vertexAttributes[2].name(), MeshAttribute::Position);
+    CORRADE_COMPARE(header->vertexAttributes[2].format(), VertexFormat::Vector3us);
+    CORRADE_COMPARE(header->vertexAttributes[2].offset({}), 1);
+
+    CORRADE_COMPARE(header->faceAttributes.size(), 2);
+    CORRADE_COMPARE(header->faceAttributes[0].name(), importer->meshAttributeForName("mask"));
+    CORRADE_COMPARE(header->faceAttributes[0].format(), VertexFormat::UnsignedShort);
+    CORRADE_COMPARE(header->faceAttributes[1].name(), importer->meshAttributeForName("id"));
+    CORRADE_COMPARE(header->faceAttributes[1].format(), VertexFormat::Int);
+}
+
+void StanfordImporterTest::pointCloud() {
+    auto&& data = PointCloudData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(STANFORDIMPORTER_TEST_DIR, data.filename)));
+    CORRADE_COMPARE(importer->meshCount(), 1);
+    CORRADE_COMPARE(importer->meshLevelCount(0), 1);
+
+    auto header = static_cast<const StanfordImporterHeader*>(importer->importerState());
+    CORRADE_VERIFY(header);
+    CORRADE_VERIFY(header->pointCloud);
+    CORRADE_COMPARE(header->vertexCount, 6);
+    CORRADE_COMPARE(header->faceCount, 0);
+    CORRADE_VERIFY(header->faceAttributes.empty());
+
+    auto mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Points);
+    CORRADE_VERIFY(!mesh->isIndexed());
+    CORRADE_COMPARE(mesh->vertexCount(), 6);
+    CORRADE_COMPARE(mesh->attributeCount(), 2);
+    CORRADE_COMPARE_AS(mesh->positions3DAsArray(),
+        Containers::arrayView(PointCloudPositions),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Color3ub>(MeshAttribute::Color),
+        Containers::arrayView(PointCloudColors),
+        TestSuite::Compare::Container);
+
+    Containers::Optional<Range3D> bounds = static_cast<StanfordImporter&>(*importer).meshBounds(0);
+    CORRADE_VERIFY(bounds);
+    CORRADE_COMPARE(*bounds, (Range3D{{0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}}));
+}
+
+void StanfordImporterTest::pointCloudChunked() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
+    importer->configuration().setValue("chunkSize", 2);
+
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(STANFORDIMPORTER_TEST_DIR, "point-cloud.ply")));
+
+    /* Just vertex chunks, no face chunks */
+    CORRADE_COMPARE(importer->meshCount(), 3);
+    CORRADE_COMPARE(importer->meshLevelCount(0), 1);
+
+    const Range3D expectedBounds[]{
+        {{0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}},
+        {{0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 0.0f}},
+        {{0.0f, 0.0f, 0.5f}, {0.5f, 0.5f, 1.0f}}
+    };
+    for(UnsignedInt i = 0; i != 3; ++i) {
+        CORRADE_ITERATION(i);
+
+        auto mesh = importer->mesh(i);
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Points);
+        CORRADE_COMPARE(mesh->vertexCount(), 2);
+        CORRADE_COMPARE_AS(mesh->positions3DAsArray(),
+            Containers::arrayView(PointCloudPositions).slice(i*2, i*2 + 2),
+            TestSuite::Compare::Container);
+
+        Containers::Optional<Range3D> bounds = static_cast<StanfordImporter&>(*importer).meshBounds(i);
+        CORRADE_VERIFY(bounds);
+        CORRADE_COMPARE(*bounds, expectedBounds[i]);
+    }
+}
+
+void StanfordImporterTest::pointCloudMortonOrder() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
+    importer->configuration().setValue("mortonOrder", true);
+
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(STANFORDIMPORTER_TEST_DIR, "point-cloud.ply")));
+
+    Vector3 expectedPositions[6];
+    Color3ub expectedColors[6];
+    for(std::size_t i = 0; i != 6; ++i) {
+        expectedPositions[i] = PointCloudPositions[PointCloudMortonOrder[i]];
+        expectedColors[i] = PointCloudColors[PointCloudMortonOrder[i]];
+    }
+
+    /* Whole cloud, referencing the sorted data kept in the importer */
+    {
+        auto mesh = importer->mesh(0);
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Points);
+        CORRADE_COMPARE(mesh->vertexDataFlags(), DataFlags{});
+        CORRADE_COMPARE_AS(mesh->positions3DAsArray(),
+            Containers::arrayView(expectedPositions),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(mesh->attribute<Color3ub>(MeshAttribute::Color),
+            Containers::arrayView(expectedColors),
+            TestSuite::Compare::Container);
+    }
+
+    /* Chunks, each covering a compact region */
+    importer->configuration().setValue("chunkSize", 2);
+    CORRADE_COMPARE(importer->meshCount(), 3);
+    const Range3D expectedBounds[]{
+        {{0.0f, 0.0f, 0.0f}, {0.5f, 0.5f, 0.5f}},
+        {{0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 0.0f}},
+        {{0.0f, 0.0f, 1.0f}, {1.0f, 1.0f, 1.0f}}
+    };
+    for(UnsignedInt i = 0; i != 3; ++i) {
+        CORRADE_ITERATION(i);
+
+        auto mesh = importer->mesh(i);
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->vertexCount(), 2);
+        CORRADE_COMPARE_AS(mesh->positions3DAsArray(),
+            Containers::arrayView(expectedPositions).slice(i*2, i*2 + 2),
+            TestSuite::Compare::Container);
+
+        Containers::Optional<Range3D> bounds = static_cast<StanfordImporter&>(*importer).meshBounds(i);
+        CORRADE_VERIFY(bounds);
+        CORRADE_COMPARE(*bounds, expectedBounds[i]);
+    }
+
+    /* Changing the attribute filter redoes the sort, the bounds are still
+       available as they don't depend on imported attributes */
+    importer->configuration().setValue("attributes", "Color");
+    {
+        auto mesh = importer->mesh(2);
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->attributeCount(), 1);
+        CORRADE_COMPARE_AS(mesh->attribute<Color3ub>(MeshAttribute::Color),
+            Containers::arrayView(expectedColors).slice(4, 6),
+            TestSuite::Compare::Container);
+
+        Containers::Optional<Range3D> bounds = static_cast<StanfordImporter&>(*importer).meshBounds(2);
+        CORRADE_VERIFY(bounds);
+        CORRADE_COMPARE(*bounds, expectedBounds[2]);
+    }
+}
+
+void StanfordImporterTest::profiling() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
+
+    std::string stages;
+    static_cast<StanfordImporter&>(*importer).setProfilingCallback([](const char* stage, UnsignedLong, std::size_t, void* userData) {
+        *static_cast<std::string*>(userData) += stage;
+        *static_cast<std::string*>(userData) += ' ';
+    }, &stages);
+
+    CORRADE_VERIFY(importer->openData(Utility::Directory::read(Utility::Directory::join(STANFORDIMPORTER_TEST_DIR, "positions-float-indices-uint.ply"))));
+    CORRADE_VERIFY(importer->mesh(0));
+
+    #ifdef MAGNUM_STANFORDIMPORTER_WITH_PROFILING
+    CORRADE_COMPARE(stages, "parse copy vertices mesh ");
+    #else
+    CORRADE_COMPARE(stages, "");
+    #endif
+}
+
 void StanfordImporterTest::openTwice() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StanfordImporter");
 
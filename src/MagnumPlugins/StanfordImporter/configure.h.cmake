@@ -24,3 +24,4 @@
 */
 
 #cmakedefine MAGNUM_STANFORDIMPORTER_BUILD_STATIC
+#cmakedefine MAGNUM_STANFORDIMPORTER_WITH_PROFILING
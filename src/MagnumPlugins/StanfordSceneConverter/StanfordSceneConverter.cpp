@@ -25,85 +25,86 @@
 
 #include "StanfordSceneConverter.h"
 
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <thread>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/Endianness.h>
 #include <Corrade/Utility/EndiannessBatch.h>
 #include <Corrade/Utility/FormatStl.h>
-#include <Magnum/MeshTools/Duplicate.h>
-#include <Magnum/MeshTools/GenerateIndices.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Trade/MeshData.h>
 
 namespace Magnum { namespace Trade {
 
-StanfordSceneConverter::StanfordSceneConverter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractSceneConverter{manager, plugin} {}
-
-StanfordSceneConverter::~StanfordSceneConverter() = default;
+namespace {
 
-SceneConverterFeatures StanfordSceneConverter::doFeatures() const { return SceneConverterFeature::ConvertMeshToData; }
-
-Containers::Array<char> StanfordSceneConverter::doConvertToData(const MeshData& mesh) {
-    /* Convert to an indexed triangle mesh if it's a strip/fan */
-    MeshData triangles{MeshPrimitive::Triangles, 0};
-    if(mesh.primitive() == MeshPrimitive::TriangleStrip || mesh.primitive() == MeshPrimitive::TriangleFan) {
-        if(mesh.isIndexed())
-            triangles = MeshTools::generateIndices(MeshTools::duplicate(mesh));
-        else triangles = MeshTools::generateIndices(std::move(mesh));
-
-    /* If it's triangles already, make a non-owning reference to the original */
-    } else if(mesh.primitive() == MeshPrimitive::Triangles) {
-        Containers::ArrayView<const char> indexData;
-        MeshIndexData indices;
-        if(mesh.isIndexed()) {
-            indexData = mesh.indexData();
-            indices = MeshIndexData{mesh.indices()};
-        }
-        triangles = MeshData{mesh.primitive(),
-            {}, indexData, indices,
-            {}, mesh.vertexData(), meshAttributeDataNonOwningArray(mesh.attributeData()),
-            mesh.vertexCount()
-        };
-
-    /* Otherwise we're sorry */
-    } else {
-        Error{} << "Trade::StanfordSceneConverter::convertToData(): expected a triangle mesh, got" << mesh.primitive();
-        return nullptr;
+/* Everything needed to write the header and any subrange of the vertex and
+   face blocks independently of each other */
+struct Layout {
+    std::string header;
+    bool endianSwapNeeded;
+    /* Attributes that can't be written because the type is not supported by
+       PLY or the name is unknown have the offset kept at ~std::size_t{} */
+    Containers::Array<std::size_t> offsets;
+    std::size_t vertexSize;
+    /* If the input vertex data are tightly interleaved in exactly the order
+       and formats written to the file and no endian swap is needed, points
+       to the first vertex so the vertex block can be copied directly.
+       Otherwise nullptr. */
+    const char* vertexDataInFileLayout;
+    /* For a non-indexed mesh we'll use 32-bit indices for simplicity, face
+       size is always 3 so a 1-byte type is enough */
+    std::size_t indexTypeSize;
+    std::size_t faceCount;
+
+    std::size_t faceSize() const { return 1 + 3*indexTypeSize; }
+};
+
+bool computeLayout(const char* prefix, const MeshData& mesh, const Utility::ConfigurationGroup& configuration, Layout& out) {
+    /* Triangle strips and fans are turned into triangle faces on the fly when
+       writing, everything else is unsupported */
+    if(mesh.primitive() != MeshPrimitive::Triangles &&
+       mesh.primitive() != MeshPrimitive::TriangleStrip &&
+       mesh.primitive() != MeshPrimitive::TriangleFan) {
+        Error{} << prefix << "expected a triangle mesh, got" << mesh.primitive();
+        return false;
     }
 
     /* Decide on endian swapping, write file signature */
-    bool endianSwapNeeded;
-    std::string header = "ply\n";
+    out.header = "ply\n";
     {
         bool isBigEndian;
-        if(configuration().value("endianness") == "native") {
+        if(configuration.value("endianness") == "native") {
             isBigEndian = Utility::Endianness::isBigEndian();
-            endianSwapNeeded = false;
-        } else if(configuration().value("endianness") == "little") {
+            out.endianSwapNeeded = false;
+        } else if(configuration.value("endianness") == "little") {
             isBigEndian = false;
-            endianSwapNeeded = Utility::Endianness::isBigEndian();
-        } else if(configuration().value("endianness") == "big") {
+            out.endianSwapNeeded = Utility::Endianness::isBigEndian();
+        } else if(configuration.value("endianness") == "big") {
             isBigEndian = true;
-            endianSwapNeeded = !Utility::Endianness::isBigEndian();
+            out.endianSwapNeeded = !Utility::Endianness::isBigEndian();
         } else {
-            Error{} << "Trade::StanfordSceneConverter::convertToData(): invalid option endianness=" << Debug::nospace << configuration().value("endianness");
-            return nullptr;
+            Error{} << prefix << "invalid option endianness=" << Debug::nospace << configuration.value("endianness");
+            return false;
         }
-        header += isBigEndian ?
+        out.header += isBigEndian ?
             "format binary_big_endian 1.0\n" :
             "format binary_little_endian 1.0\n";
     }
 
-    /* Write attribute header and calculate offsets for copying later.
-       Attributes that can't be written because the type is not supported by
-       PLY or the name is unknown will have offset kept at ~std::size_t{}. */
-    Containers::Array<std::size_t> offsets{Containers::DirectInit, triangles.attributeCount(), ~std::size_t{}};
-    std::size_t vertexSize = 0;
-    header += Utility::formatString("element vertex {}\n", triangles.vertexCount());
-    for(UnsignedInt i = 0; i != triangles.attributeCount(); ++i) {
-        const MeshAttribute name = triangles.attributeName(i);
-        const VertexFormat format = triangles.attributeFormat(i);
+    /* Write attribute header and calculate offsets for copying later */
+    out.offsets = Containers::Array<std::size_t>{Containers::DirectInit, mesh.attributeCount(), ~std::size_t{}};
+    out.vertexSize = 0;
+    out.header += Utility::formatString("element vertex {}\n", mesh.vertexCount());
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+        const MeshAttribute name = mesh.attributeName(i);
+        const VertexFormat format = mesh.attributeFormat(i);
         if(isVertexFormatImplementationSpecific(format)) {
-            Warning{} << "Trade::StanfordSceneConverter::convertToData(): skipping attribute" << name << "with" << format;
+            Warning{} << prefix << "skipping attribute" << name << "with" << format;
             continue;
         }
 
@@ -140,38 +141,38 @@ Containers::Array<char> StanfordSceneConverter::doConvertToData(const MeshData&
                 formatString = "int";
                 break;
             default:
-                Warning{} << "Trade::StanfordSceneConverter::convertToData(): skipping attribute" << name << "with unsupported format" << format;
+                Warning{} << prefix << "skipping attribute" << name << "with unsupported format" << format;
                 continue;
         }
 
         /* Positions */
         if(name == MeshAttribute::Position) {
             if(vertexFormatComponentCount(format) != 3) {
-                Error{} << "Trade::StanfordSceneConverter::convertToData(): two-component positions are not supported";
-                return nullptr;
+                Error{} << prefix << "two-component positions are not supported";
+                return false;
             }
 
-            header += Utility::formatString(
+            out.header += Utility::formatString(
                 "property {0} x\n"
                 "property {0} y\n"
                 "property {0} z\n", formatString);
 
         /* Normals */
         } else if(name == MeshAttribute::Normal) {
-            header += Utility::formatString(
+            out.header += Utility::formatString(
                 "property {0} nx\n"
                 "property {0} ny\n"
                 "property {0} nz\n", formatString);
 
         /* Texture coordinates */
         } else if(name == MeshAttribute::TextureCoordinates) {
-            header += Utility::formatString(
+            out.header += Utility::formatString(
                 "property {0} u\n"
                 "property {0} v\n", formatString);
 
         /* Colors */
         } else if(name == MeshAttribute::Color) {
-            header += Utility::formatString(
+            out.header += Utility::formatString(
                 vertexFormatComponentCount(format) == 3 ?
                     "property {0} red\n"
                     "property {0} green\n"
@@ -183,115 +184,218 @@ Containers::Array<char> StanfordSceneConverter::doConvertToData(const MeshData&
 
         /* Object ID */
         } else if(name == MeshAttribute::ObjectId) {
-            header += Utility::formatString("property {} {}\n", formatString,
-                configuration().value("objectIdAttribute"));
+            out.header += Utility::formatString("property {} {}\n", formatString,
+                configuration.value("objectIdAttribute"));
 
         /* Something else, skip */
         /** @todo add setMeshAttributeName() and enable this for custom attribs */
         } else {
-            Warning{} << "Trade::StanfordSceneConverter::convertToData(): skipping unsupported attribute" << name;
+            Warning{} << prefix << "skipping unsupported attribute" << name;
             continue;
         }
 
-        offsets[i] = vertexSize;
-        vertexSize += vertexFormatSize(format);
+        out.offsets[i] = out.vertexSize;
+        out.vertexSize += vertexFormatSize(format);
+    }
+
+    /* Check if the vertex data can be copied as-is. All written attributes
+       have to have the stride equal to the output vertex size and be at the
+       same relative offsets as in the output -- since the sizes then add up
+       to the stride, there's nothing skipped in between either. */
+    out.vertexDataInFileLayout = nullptr;
+    if(!out.endianSwapNeeded && out.vertexSize && mesh.vertexCount()) {
+        const char* begin = nullptr;
+        bool inFileLayout = true;
+        for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+            if(out.offsets[i] == ~std::size_t{}) continue;
+
+            const char* attributeBegin = static_cast<const char*>(mesh.attribute(i).data()) - out.offsets[i];
+            if(std::size_t(mesh.attributeStride(i)) != out.vertexSize ||
+               (begin && attributeBegin != begin)) {
+                inFileLayout = false;
+                break;
+            }
+            begin = attributeBegin;
+        }
+        if(inFileLayout) out.vertexDataInFileLayout = begin;
     }
 
     /* Index type */
     const char* indexTypeString = nullptr;
-    if(!triangles.isIndexed())
+    if(!mesh.isIndexed()) {
         indexTypeString = "uint";
-    else switch(triangles.indexType()) {
-        case MeshIndexType::UnsignedInt:
-            indexTypeString = "uint";
-            break;
-        case MeshIndexType::UnsignedShort:
-            indexTypeString = "ushort";
-            break;
-        case MeshIndexType::UnsignedByte:
-            indexTypeString = "uchar";
-            break;
+        out.indexTypeSize = 4;
+    } else {
+        switch(mesh.indexType()) {
+            case MeshIndexType::UnsignedInt:
+                indexTypeString = "uint";
+                break;
+            case MeshIndexType::UnsignedShort:
+                indexTypeString = "ushort";
+                break;
+            case MeshIndexType::UnsignedByte:
+                indexTypeString = "uchar";
+                break;
+        }
+        out.indexTypeSize = meshIndexTypeSize(mesh.indexType());
     }
     CORRADE_INTERNAL_ASSERT(indexTypeString);
 
+    /* Face count. A strip or a fan has one triangle for each index (or
+       vertex) after the first two. */
+    const std::size_t count = mesh.isIndexed() ? mesh.indexCount() : mesh.vertexCount();
+    if(mesh.primitive() == MeshPrimitive::Triangles)
+        out.faceCount = count/3;
+    else
+        out.faceCount = count < 3 ? 0 : count - 2;
+
     /* Wrap up the header -- for face attributes we have just the index list */
     /** @todo once multi-mesh conversion is supported, this could accept a
         MeshAttribute::Face with per-face attribs */
-    header += Utility::formatString(
+    out.header += Utility::formatString(
         "element face {}\n"
         "property list uchar {} vertex_indices\n"
         "end_header\n",
-        triangles.isIndexed() ? triangles.indexCount()/3 : triangles.vertexCount()/3,
-        indexTypeString);
+        out.faceCount, indexTypeString);
 
-    /* Vertex and index data size. For a non-indexed mesh we'll use 32-bit
-       indices for simplicity, face size is always 3 so a 1-byte type is
-       enough. */
-    const std::size_t vertexDataSize = vertexSize*triangles.vertexCount();
-    std::size_t indexTypeSize;
-    std::size_t indexDataSize;
-    if(!triangles.isIndexed()) {
-        indexTypeSize = 4;
-        indexDataSize = (1 + 3*4)*triangles.vertexCount()/3;
-    } else {
-        indexTypeSize = meshIndexTypeSize(triangles.indexType());
-        indexDataSize = (1 + 3*indexTypeSize)*triangles.indexCount()/3;
+    return true;
+}
+
+/* Writes vertices [begin, end) to out, which is expected to be exactly
+   (end - begin)*layout.vertexSize bytes */
+void writeVertices(const MeshData& mesh, const Layout& layout, const std::size_t begin, const std::size_t end, const Containers::ArrayView<char> out) {
+    CORRADE_INTERNAL_ASSERT(out.size() == (end - begin)*layout.vertexSize);
+
+    /* If the data are already in the file layout, it's just a single copy */
+    if(layout.vertexDataInFileLayout) {
+        Utility::copy(Containers::arrayView(layout.vertexDataInFileLayout + begin*layout.vertexSize, out.size()), out);
+        return;
     }
 
-    /* Allocate the data, copy header */
-    Containers::Array<char> out{Containers::NoInit, header.size() + vertexDataSize + indexDataSize};
-    /* Needs an explicit ArrayView constructor, otherwise MSVC 2015, 17 and 19
-       creates ArrayView<const void> here (wtf!) */
-    Utility::copy(Containers::ArrayView<const char>{header.data(), header.size()}, out.prefix(header.size()));
-
-    /* Copy the vertices */
-    Containers::ArrayView<char> vertexData = out.slice(header.size(), header.size() + vertexDataSize);
-    for(UnsignedInt i = 0; i != triangles.attributeCount(); ++i) {
-        if(offsets[i] == ~std::size_t{}) continue;
-
-        const Containers::StridedArrayView2D<const char> src = triangles.attribute(i);
-        const Containers::StridedArrayView2D<char> dst{vertexData,
-            vertexData.begin() + offsets[i],
-            src.size(), {std::ptrdiff_t(vertexSize), 1}};
-        Utility::copy(src, dst);
-
-        /* Endian swap, if needed */
-        if(endianSwapNeeded) {
-            const VertexFormat format = triangles.attributeFormat(i);
-            const UnsignedInt componentSize = vertexFormatSize(vertexFormatComponentFormat(format));
-            if(componentSize == 1) continue;
-
-            /* Can't reuse the dst array as it has no information about the
-               component layout. Build a sparse view from scratch instead. */
-            const Containers::StridedArrayView2D<char> components{vertexData,
-                vertexData.begin() + offsets[i],
-                {vertexFormatComponentCount(format),
-                 triangles.vertexCount()},
-                {std::ptrdiff_t(componentSize),
-                 std::ptrdiff_t(vertexSize)}};
-            for(Containers::StridedArrayView1D<char> component: components) {
-                if(componentSize == 8)
-                    Utility::Endianness::swapInPlace(Containers::arrayCast<UnsignedLong>(component));
-                else if(componentSize == 4)
-                    Utility::Endianness::swapInPlace(Containers::arrayCast<UnsignedInt>(component));
-                else if(componentSize == 2)
-                    Utility::Endianness::swapInPlace(Containers::arrayCast<UnsignedShort>(component));
-                else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
-            }
+    /* Without an endian swap, copy the attributes one by one into the
+       interleaved output */
+    if(!layout.endianSwapNeeded) {
+        for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+            if(layout.offsets[i] == ~std::size_t{}) continue;
+
+            const Containers::StridedArrayView2D<const char> src = mesh.attribute(i).slice(begin, end);
+            const Containers::StridedArrayView2D<char> dst{out,
+                out.begin() + layout.offsets[i],
+                src.size(), {std::ptrdiff_t(layout.vertexSize), 1}};
+            Utility::copy(src, dst);
+        }
+
+        return;
+    }
+
+    /* With an endian swap, repack and swap in a single pass that goes vertex
+       by vertex, so each output vertex is written just once instead of being
+       copied first and then revisited for every component of every
+       attribute. The per-attribute properties are gathered upfront to not
+       have to query them in the inner loop. */
+    struct Field {
+        const char* data;
+        std::ptrdiff_t stride;
+        std::size_t offset;
+        std::size_t componentSize;
+        std::size_t size;
+    };
+    Containers::Array<Field> fields{Containers::NoInit, mesh.attributeCount()};
+    std::size_t fieldCount = 0;
+    for(UnsignedInt i = 0; i != mesh.attributeCount(); ++i) {
+        if(layout.offsets[i] == ~std::size_t{}) continue;
+
+        const Containers::StridedArrayView2D<const char> src = mesh.attribute(i);
+        const VertexFormat format = mesh.attributeFormat(i);
+        fields[fieldCount++] = Field{
+            static_cast<const char*>(src.data()), src.stride()[0],
+            layout.offsets[i],
+            vertexFormatSize(vertexFormatComponentFormat(format)),
+            vertexFormatSize(format)};
+    }
+
+    char* dst = out.data();
+    for(std::size_t v = begin; v != end; ++v, dst += layout.vertexSize) {
+        for(std::size_t f = 0; f != fieldCount; ++f) {
+            const Field& field = fields[f];
+            const char* src = field.data + std::ptrdiff_t(v)*field.stride;
+            char* fieldDst = dst + field.offset;
+            for(std::size_t c = 0; c < field.size; c += field.componentSize)
+                for(std::size_t b = 0; b != field.componentSize; ++b)
+                    fieldDst[c + b] = src[c + field.componentSize - b - 1];
+        }
+    }
+}
+
+/* Writes strip or fan faces [begin, end), generating the triangle indices
+   on the fly instead of going through MeshTools::duplicate() and
+   MeshTools::generateIndices(). Triangle winding is the same as with
+   MeshTools::generateTriangleStripIndices() and
+   MeshTools::generateTriangleFanIndices(). For a non-indexed mesh T is
+   UnsignedInt and the corner positions are the vertex IDs directly. */
+template<class T> void writeStripFanFaces(const MeshData& mesh, const Layout& layout, const std::size_t begin, const std::size_t end, const Containers::ArrayView<char> out) {
+    Containers::StridedArrayView1D<const T> indices;
+    if(mesh.isIndexed()) indices = mesh.indices<T>();
+
+    const bool strip = mesh.primitive() == MeshPrimitive::TriangleStrip;
+    char* dst = out.data();
+    for(std::size_t i = begin; i != end; ++i, dst += layout.faceSize()) {
+        std::size_t corners[3];
+        if(!strip) {
+            corners[0] = 0;
+            corners[1] = i + 1;
+            corners[2] = i + 2;
+        /* Every odd triangle of a strip has the first two corners swapped to
+           preserve the winding */
+        } else if(i & 1) {
+            corners[0] = i + 1;
+            corners[1] = i;
+            corners[2] = i + 2;
+        } else {
+            corners[0] = i;
+            corners[1] = i + 1;
+            corners[2] = i + 2;
+        }
+
+        *dst = 3;
+        for(std::size_t j = 0; j != 3; ++j) {
+            T index = mesh.isIndexed() ? indices[corners[j]] : T(corners[j]);
+            if(layout.endianSwapNeeded)
+                index = Utility::Endianness::swap(index);
+            std::memcpy(dst + 1 + j*sizeof(T), &index, sizeof(T));
         }
     }
+}
+
+/* Writes faces [begin, end) to out, which is expected to be exactly
+   (end - begin)*layout.faceSize() bytes */
+void writeFaces(const MeshData& mesh, const Layout& layout, const std::size_t begin, const std::size_t end, const Containers::ArrayView<char> out) {
+    const std::size_t count = end - begin;
+    const std::size_t indexTypeSize = layout.indexTypeSize;
+    CORRADE_INTERNAL_ASSERT(out.size() == count*layout.faceSize());
+
+    /* Strips and fans are handled separately */
+    if(mesh.primitive() != MeshPrimitive::Triangles) {
+        if(indexTypeSize == 4)
+            writeStripFanFaces<UnsignedInt>(mesh, layout, begin, end, out);
+        else if(indexTypeSize == 2)
+            writeStripFanFaces<UnsignedShort>(mesh, layout, begin, end, out);
+        else if(indexTypeSize == 1)
+            writeStripFanFaces<UnsignedByte>(mesh, layout, begin, end, out);
+        else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+        return;
+    }
 
-    /* Copy the indices. For a non-indexed mesh make a trivial index array. */
-    Containers::ArrayView<char> indexData = out.suffix(header.size() + vertexDataSize);
+    /* For a non-indexed mesh make a trivial index array */
     Containers::StridedArrayView3D<char> indices;
-    if(!triangles.isIndexed()) {
-        const Containers::StridedArrayView2D<UnsignedInt> indices32{indexData,
-            reinterpret_cast<UnsignedInt*>(indexData.begin() + 1),
-            {triangles.vertexCount()/3, 3}, {1 + 3*4, 4}};
-        for(std::size_t i = 0; i != indices32.size()[0]; ++i) {
+    if(!mesh.isIndexed()) {
+        const Containers::StridedArrayView2D<UnsignedInt> indices32{out,
+            reinterpret_cast<UnsignedInt*>(out.begin() + 1),
+            {count, 3}, {1 + 3*4, 4}};
+        for(std::size_t i = 0; i != count; ++i) {
             Containers::StridedArrayView1D<UnsignedInt> face = indices32[i];
             for(std::size_t j = 0; j != 3; ++j)
-                face[j] = i*3 + j;
+                face[j] = (begin + i)*3 + j;
         }
 
         indices = Containers::arrayCast<3, char>(indices32);
@@ -299,18 +403,18 @@ Containers::Array<char> StanfordSceneConverter::doConvertToData(const MeshData&
     /* For an indexed mesh simply copy the data */
     } else {
         const Containers::StridedArrayView3D<const char> src{
-            triangles.indices().asContiguous(),
-            {triangles.indexCount()/3, 3, indexTypeSize},
+            mesh.indices().asContiguous().slice(begin*3*indexTypeSize, end*3*indexTypeSize),
+            {count, 3, indexTypeSize},
             {std::ptrdiff_t(3*indexTypeSize), std::ptrdiff_t(indexTypeSize), 1}};
-        indices = Containers::StridedArrayView3D<char>{indexData,
-            indexData.begin() + 1,
-            {triangles.indexCount()/3, 3, indexTypeSize},
+        indices = Containers::StridedArrayView3D<char>{out,
+            out.begin() + 1,
+            {count, 3, indexTypeSize},
             {std::ptrdiff_t(1 + 3*indexTypeSize), std::ptrdiff_t(indexTypeSize), 1}};
         Utility::copy(src, indices);
     }
 
     /* Endian-swap the indices, if needed */
-    if(endianSwapNeeded) {
+    if(layout.endianSwapNeeded) {
         if(indexTypeSize == 4) {
             for(Containers::StridedArrayView1D<UnsignedInt> i: Containers::arrayCast<2, UnsignedInt>(indices).transposed<0, 1>())
                 Utility::Endianness::swapInPlace(i);
@@ -323,25 +427,160 @@ Containers::Array<char> StanfordSceneConverter::doConvertToData(const MeshData&
     /* Fill in face sizes. That's just 3 repeated many times over */
     {
         constexpr UnsignedByte three[]{3};
-        Containers::StridedArrayView1D<const UnsignedByte> src = three;
-        Containers::StridedArrayView1D<UnsignedByte> dst;
-        if(!triangles.isIndexed()) {
-            src = src.broadcasted<0>(triangles.vertexCount()/3);
-            dst = Containers::StridedArrayView1D<UnsignedByte>{indexData,
-                reinterpret_cast<UnsignedByte*>(indexData.begin()),
-                triangles.vertexCount()/3, 1 + 3*4};
-        } else {
-            src = src.broadcasted<0>(triangles.indexCount()/3);
-            dst = Containers::StridedArrayView1D<UnsignedByte>{indexData,
-                reinterpret_cast<UnsignedByte*>(indexData.begin()),
-                triangles.indexCount()/3, std::ptrdiff_t(1 + 3*indexTypeSize)};
-        }
-        Utility::copy(src, dst);
+        Utility::copy(Containers::StridedArrayView1D<const UnsignedByte>{three}.broadcasted<0>(count),
+            Containers::StridedArrayView1D<UnsignedByte>{out,
+                reinterpret_cast<UnsignedByte*>(out.begin()),
+                count, std::ptrdiff_t(layout.faceSize())});
     }
+}
+
+/* Vertex and face data split into chunks of at most a given byte size, but
+   always at least one element. Chunks [0, vertexChunkCount) contain vertices,
+   the rest faces. */
+struct Chunks {
+    std::size_t vertexCount;
+    std::size_t vertexSize;
+    std::size_t verticesPerChunk;
+    std::size_t vertexChunkCount;
+    std::size_t faceCount;
+    std::size_t faceSize;
+    std::size_t facesPerChunk;
+    std::size_t count;
+
+    /* Offset of given chunk relative to the end of the header. Passing count
+       gives the total vertex and face data size. */
+    std::size_t offset(const std::size_t i) const {
+        if(i < vertexChunkCount) return i*verticesPerChunk*vertexSize;
+        return vertexCount*vertexSize + Math::min((i - vertexChunkCount)*facesPerChunk, faceCount)*faceSize;
+    }
+
+    /* Upper bound on the size of any chunk */
+    std::size_t maxSize() const {
+        return Math::max(Math::min(verticesPerChunk, vertexCount)*vertexSize,
+                         Math::min(facesPerChunk, faceCount)*faceSize);
+    }
+};
+
+Chunks splitIntoChunks(const MeshData& mesh, const Layout& layout, std::size_t chunkSize) {
+    chunkSize = Math::max(chunkSize, std::size_t{1});
+
+    Chunks out;
+    out.vertexCount = mesh.vertexCount();
+    out.vertexSize = layout.vertexSize;
+    /* If there are no attributes to write, the vertex block is empty */
+    out.verticesPerChunk = layout.vertexSize ?
+        Math::max(chunkSize/layout.vertexSize, std::size_t{1}) : 0;
+    out.vertexChunkCount = out.verticesPerChunk ?
+        (out.vertexCount + out.verticesPerChunk - 1)/out.verticesPerChunk : 0;
+    out.faceCount = layout.faceCount;
+    out.faceSize = layout.faceSize();
+    out.facesPerChunk = Math::max(chunkSize/out.faceSize, std::size_t{1});
+    out.count = out.vertexChunkCount + (out.faceCount + out.facesPerChunk - 1)/out.facesPerChunk;
+    return out;
+}
+
+UnsignedInt configuredThreadCount(const Utility::ConfigurationGroup& configuration) {
+    const UnsignedInt threadCount = configuration.value<UnsignedInt>("threads");
+    return threadCount ? threadCount : Math::max(std::thread::hardware_concurrency(), 1u);
+}
+
+/* Writes chunks [begin, end) into out, which is expected to span exactly
+   chunks.offset(begin) to chunks.offset(end). The chunks are independent of
+   each other so they're distributed among the threads dynamically, with the
+   calling thread doing its share of the work as well. */
+void writeChunks(const MeshData& mesh, const Layout& layout, const Chunks& chunks, const std::size_t begin, const std::size_t end, const Containers::ArrayView<char> out, const UnsignedInt threadCount) {
+    const std::size_t base = chunks.offset(begin);
+    CORRADE_INTERNAL_ASSERT(out.size() == chunks.offset(end) - base);
+
+    std::atomic<std::size_t> next{begin};
+    auto writeNext = [&]() {
+        std::size_t i;
+        while((i = next++) < end) {
+            const Containers::ArrayView<char> data = out.slice(chunks.offset(i) - base, chunks.offset(i + 1) - base);
+            if(i < chunks.vertexChunkCount) {
+                const std::size_t first = i*chunks.verticesPerChunk;
+                writeVertices(mesh, layout, first, Math::min(first + chunks.verticesPerChunk, chunks.vertexCount), data);
+            } else {
+                const std::size_t first = (i - chunks.vertexChunkCount)*chunks.facesPerChunk;
+                writeFaces(mesh, layout, first, Math::min(first + chunks.facesPerChunk, chunks.faceCount), data);
+            }
+        }
+    };
+
+    Containers::Array<std::thread> threads{Math::min(std::size_t(threadCount), Math::max(end - begin, std::size_t{1})) - 1};
+    for(std::thread& thread: threads) thread = std::thread{writeNext};
+    writeNext();
+    for(std::thread& thread: threads) thread.join();
+}
+
+}
+
+StanfordSceneConverter::StanfordSceneConverter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractSceneConverter{manager, plugin} {}
+
+StanfordSceneConverter::~StanfordSceneConverter() = default;
+
+SceneConverterFeatures StanfordSceneConverter::doFeatures() const {
+    return SceneConverterFeature::ConvertMeshToData|SceneConverterFeature::ConvertMeshToFile;
+}
+
+Containers::Array<char> StanfordSceneConverter::doConvertToData(const MeshData& mesh) {
+    Layout layout;
+    if(!computeLayout("Trade::StanfordSceneConverter::convertToData():", mesh, configuration(), layout))
+        return nullptr;
+
+    const Chunks chunks = splitIntoChunks(mesh, layout, configuration().value<std::size_t>("chunkSize"));
+
+    /* Allocate the data, copy header. The size is known upfront so the
+       chunks can be written in any order into their final locations. */
+    Containers::Array<char> out{Containers::NoInit, layout.header.size() + chunks.offset(chunks.count)};
+    /* Needs an explicit ArrayView constructor, otherwise MSVC 2015, 17 and 19
+       creates ArrayView<const void> here (wtf!) */
+    Utility::copy(Containers::ArrayView<const char>{layout.header.data(), layout.header.size()}, out.prefix(layout.header.size()));
+
+    /* Copy the vertices and indices */
+    writeChunks(mesh, layout, chunks, 0, chunks.count, out.suffix(layout.header.size()), configuredThreadCount(configuration()));
 
     return out;
 }
 
+bool StanfordSceneConverter::doConvertToFile(const std::string& filename, const MeshData& mesh) {
+    Layout layout;
+    if(!computeLayout("Trade::StanfordSceneConverter::convertToFile():", mesh, configuration(), layout))
+        return false;
+
+    std::ofstream file{filename, std::ios::binary};
+    if(!file) {
+        Error{} << "Trade::StanfordSceneConverter::convertToFile(): cannot open file" << filename;
+        return false;
+    }
+
+    file.write(layout.header.data(), layout.header.size());
+
+    /* Vertices and faces are written in chunks of at most chunkSize bytes
+       (but always at least one element). Each batch of as many chunks as
+       there are threads is serialized in parallel into the same reused
+       scratch buffer and then written out, so the memory use doesn't depend
+       on the mesh size. */
+    const Chunks chunks = splitIntoChunks(mesh, layout, configuration().value<std::size_t>("chunkSize"));
+    const UnsignedInt threadCount = configuredThreadCount(configuration());
+    const std::size_t batchSize = Math::min(std::size_t(threadCount), Math::max(chunks.count, std::size_t{1}));
+    Containers::Array<char> scratch{Containers::NoInit, batchSize*chunks.maxSize()};
+
+    for(std::size_t begin = 0; begin < chunks.count && file; begin += batchSize) {
+        const std::size_t end = Math::min(begin + batchSize, chunks.count);
+        const Containers::ArrayView<char> data = scratch.prefix(chunks.offset(end) - chunks.offset(begin));
+        writeChunks(mesh, layout, chunks, begin, end, data, threadCount);
+        file.write(data.data(), data.size());
+    }
+
+    if(!file.flush()) {
+        Error{} << "Trade::StanfordSceneConverter::convertToFile(): cannot write to file" << filename;
+        return false;
+    }
+
+    return true;
+}
+
 }}
 
 CORRADE_PLUGIN_REGISTER(StanfordSceneConverter, Magnum::Trade::StanfordSceneConverter,
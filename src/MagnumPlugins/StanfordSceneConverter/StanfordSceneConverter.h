@@ -125,16 +125,43 @@ Supported component formats --- attributes of other formats and implementation-s
 Index type of the input mesh is preserved, written as `uchar` / `ushort` /
 `uint`. Face size is always @cpp 3 @ce, written as `uchar`. if the mesh is not
 indexed, a trivial index buffer of type @ref MeshIndexType::UnsignedInt is
-generated. The faces are always triangles, @ref MeshPrimitive::TriangleStrip
-and @ref MeshPrimitive::TriangleFan meshes are converted to indexed
-@ref MeshPrimitive::Triangles first; points, lines and other primitives are
-not supported.
+generated. The faces are always triangles. For
+@ref MeshPrimitive::TriangleStrip and @ref MeshPrimitive::TriangleFan meshes
+the triangle faces are generated on the fly while writing the output, with
+vertex data and index type of the input preserved and no intermediate meshes
+created; points, lines and other primitives are not supported.
 
 The data are by default exported in machine endian, use the
 @cb{.ini} endianness @ce
 @ref Trade-StanfordImporter-configuration "configuration option" to perform an
 endian swap on the output data.
 
+If the input vertex data are tightly interleaved with all attributes in a
+supported format and no endian swap is requested, the vertex block is copied
+to the output as a whole. When an endian swap is needed, the attributes are
+repacked and swapped together in a single pass over the vertex data.
+
+@subsection Trade-StanfordSceneConverter-behavior-streaming Streaming file output
+
+While @ref convertToData() assembles the whole file in memory,
+@ref convertToFile() writes the header first and then serializes the vertex
+and face data in chunks straight to the file, reusing a single scratch buffer.
+Memory use thus stays bounded regardless of the mesh size, which is useful
+when exporting large scans. The chunk size is controlled with the
+@cb{.ini} chunkSize @ce
+@ref Trade-StanfordSceneConverter-configuration "configuration option", the
+output is the same in both cases.
+
+@subsection Trade-StanfordSceneConverter-behavior-multithreading Multithreaded serialization
+
+Since the output size is known upfront, vertex and face chunks can be
+serialized independently into their final locations. Setting the
+@cb{.ini} threads @ce
+@ref Trade-StanfordSceneConverter-configuration "configuration option" to a
+value other than @cpp 1 @ce distributes the chunks among multiple threads in
+both @ref convertToData() and @ref convertToFile(). In the latter, up to one
+chunk per thread is kept in memory at a time.
+
 @section Trade-StanfordSceneConverter-configuration Plugin-specific config
 
 It's possible to tune various import options through @ref configuration(). See
@@ -153,6 +180,7 @@ class MAGNUM_STANFORDSCENECONVERTER_EXPORT StanfordSceneConverter: public Abstra
     private:
         MAGNUM_STANFORDSCENECONVERTER_LOCAL SceneConverterFeatures doFeatures() const override;
         MAGNUM_STANFORDSCENECONVERTER_LOCAL Containers::Array<char> doConvertToData(const MeshData& mesh) override;
+        MAGNUM_STANFORDSCENECONVERTER_LOCAL bool doConvertToFile(const std::string& filename, const MeshData& mesh) override;
 };
 
 }}
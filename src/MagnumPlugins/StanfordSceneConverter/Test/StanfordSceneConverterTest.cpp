@@ -27,6 +27,7 @@
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/TestSuite/Compare/File.h>
 #include <Corrade/TestSuite/Compare/StringToFile.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h>
@@ -48,10 +49,15 @@ struct StanfordSceneConverterTest: TestSuite::Tester {
     template<class T> void indexed();
 
     void threeComponentColors();
+    void attributesInDifferentMemoryOrder();
     void triangleFan();
     void indexedTriangleStrip();
+    void triangleStripBigEndian();
     void empty();
 
+    void chunked();
+    void convertToFileCannotOpen();
+
     void lines();
     void twoComponentPositions();
     void invalidEndianness();
@@ -105,6 +111,23 @@ struct {
         "skipping attribute Trade::MeshAttribute::Position with unsupported format VertexFormat::Vector3h"}
 };
 
+struct {
+    const char* name;
+    Containers::Optional<std::size_t> chunkSize;
+    UnsignedInt threads;
+} ChunkedData[] {
+    {"default chunk size", {}, 1},
+    /* Smaller than a single vertex or face, meaning one element per chunk */
+    {"one element per chunk", 1, 1},
+    /* Five of the 27-byte vertices of the non-indexed mesh per chunk, with
+       the last chunk being partial */
+    {"partial last chunk", 135, 1},
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    {"one element per chunk, four threads", 1, 4},
+    {"partial last chunk, all cores", 135, 0}
+    #endif
+};
+
 StanfordSceneConverterTest::StanfordSceneConverterTest() {
     addInstancedTests({&StanfordSceneConverterTest::nonIndexedAllAttributes},
         Containers::arraySize(NonIndexedAllAttributesData));
@@ -116,9 +139,16 @@ StanfordSceneConverterTest::StanfordSceneConverterTest() {
         Containers::arraySize(IndexedData));
 
     addTests({&StanfordSceneConverterTest::threeComponentColors,
+              &StanfordSceneConverterTest::attributesInDifferentMemoryOrder,
               &StanfordSceneConverterTest::triangleFan,
               &StanfordSceneConverterTest::indexedTriangleStrip,
-              &StanfordSceneConverterTest::empty,
+              &StanfordSceneConverterTest::triangleStripBigEndian,
+              &StanfordSceneConverterTest::empty});
+
+    addInstancedTests({&StanfordSceneConverterTest::chunked},
+        Containers::arraySize(ChunkedData));
+
+    addTests({&StanfordSceneConverterTest::convertToFileCannotOpen,
 
               &StanfordSceneConverterTest::lines,
               &StanfordSceneConverterTest::twoComponentPositions,
@@ -388,6 +418,37 @@ void StanfordSceneConverterTest::threeComponentColors() {
         TestSuite::Compare::Container);
 }
 
+void StanfordSceneConverterTest::attributesInDifferentMemoryOrder() {
+    /* Same data as in threeComponentColors(), but with the color first in
+       memory. The vertex is still tightly packed, but the attributes are not
+       in the file order so it can't be copied as a whole. */
+    const struct Vertex {
+        Color3us color;
+        Vector3s position;
+    } vertices[] {
+        {{257, 15, 1566}, {15, 3233, -6}},
+        {{687, 5, 0}, {687, -357, 10}},
+        {{0, 2, 0}, {1, 2, 3}}
+    };
+    MeshData mesh{MeshPrimitive::Triangles, {}, vertices, {
+        MeshAttributeData{MeshAttribute::Position,
+            VertexFormat::Vector3s,
+            offsetof(Vertex, position), 3, sizeof(Vertex)},
+        MeshAttributeData{MeshAttribute::Color,
+            VertexFormat::Vector3usNormalized,
+            offsetof(Vertex, color), 3, sizeof(Vertex)}
+    }};
+
+    Containers::Pointer<AbstractSceneConverter> converter = _converterMnager.instantiate("StanfordSceneConverter");
+    converter->configuration().setValue("endianness", "little");
+
+    Containers::Array<char> out = converter->convertToData(mesh);
+    CORRADE_VERIFY(out);
+    CORRADE_COMPARE_AS((std::string{out.data(), out.size()}),
+        Utility::Directory::join(STANFORDSCENECONVERTER_TEST_DIR, "three-component-color-le.ply"),
+        TestSuite::Compare::StringToFile);
+}
+
 void StanfordSceneConverterTest::triangleFan() {
     const Vector3 positions[] {
         { 0.0f,  0.0f, 0.0f},
@@ -468,10 +529,12 @@ void StanfordSceneConverterTest::indexedTriangleStrip() {
     Containers::Optional<MeshData> importedMesh = importer->mesh(0);
     CORRADE_VERIFY(importedMesh);
 
+    /* The index type and vertex data are preserved, only the faces are
+       generated from the strip */
     CORRADE_VERIFY(importedMesh->isIndexed());
-    CORRADE_COMPARE(importedMesh->indexType(), MeshIndexType::UnsignedInt);
-    CORRADE_COMPARE_AS(importedMesh->indices<UnsignedInt>(),
-        Containers::arrayView<UnsignedInt>({0, 1, 2, 2, 1, 3}),
+    CORRADE_COMPARE(importedMesh->indexType(), MeshIndexType::UnsignedShort);
+    CORRADE_COMPARE_AS(importedMesh->indices<UnsignedShort>(),
+        Containers::arrayView<UnsignedShort>({1, 2, 0, 0, 2, 3}),
         TestSuite::Compare::Container);
 
     CORRADE_COMPARE(importedMesh->attributeCount(), 1);
@@ -480,12 +543,54 @@ void StanfordSceneConverterTest::indexedTriangleStrip() {
     CORRADE_COMPARE(importedMesh->attributeOffset(MeshAttribute::Position), 0);
     CORRADE_COMPARE(importedMesh->attributeStride(MeshAttribute::Position), 12);
     CORRADE_COMPARE_AS(importedMesh->attribute<Vector3>(MeshAttribute::Position),
-        Containers::arrayView<Vector3>({
-            {-1.0f, -1.0f, 0.0f},
-            { 1.0f, -1.0f, 0.0f},
-            { 0.0f,  0.0f, 0.0f},
-            { 1.0f,  1.0f, 0.0f}
-        }), TestSuite::Compare::Container);
+        Containers::arrayView(positions),
+        TestSuite::Compare::Container);
+}
+
+void StanfordSceneConverterTest::triangleStripBigEndian() {
+    const Vector3 positions[] {
+        {-1.0f, -1.0f, 0.0f},
+        { 1.0f, -1.0f, 0.0f},
+        {-1.0f,  1.0f, 0.0f},
+        { 1.0f,  1.0f, 0.0f},
+        {-1.0f,  2.0f, 0.0f}
+    };
+    MeshData mesh{MeshPrimitive::TriangleStrip,
+        {}, positions, {
+            MeshAttributeData{MeshAttribute::Position,
+            Containers::arrayView(positions)}
+    }};
+
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterMnager.instantiate("StanfordSceneConverter");
+    converter->configuration().setValue("endianness", "big");
+
+    Containers::Array<char> out = converter->convertToData(mesh);
+    CORRADE_VERIFY(out);
+    CORRADE_VERIFY(std::string{out.data(), out.size()}.find(
+        "element vertex 5\n"
+        "property float x\n"
+        "property float y\n"
+        "property float z\n"
+        "element face 3\n"
+        "property list uchar uint vertex_indices\n") != std::string::npos);
+
+    if(_importerManager.loadState("StanfordImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("StanfordImporter plugin not found, cannot test a rountrip");
+
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("StanfordImporter");
+    CORRADE_VERIFY(importer->openData(out));
+
+    Containers::Optional<MeshData> importedMesh = importer->mesh(0);
+    CORRADE_VERIFY(importedMesh);
+
+    CORRADE_VERIFY(importedMesh->isIndexed());
+    CORRADE_COMPARE(importedMesh->indexType(), MeshIndexType::UnsignedInt);
+    CORRADE_COMPARE_AS(importedMesh->indices<UnsignedInt>(),
+        Containers::arrayView<UnsignedInt>({0, 1, 2, 2, 1, 3, 2, 3, 4}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(importedMesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView(positions),
+        TestSuite::Compare::Container);
 }
 
 void StanfordSceneConverterTest::empty() {
@@ -499,6 +604,116 @@ void StanfordSceneConverterTest::empty() {
         TestSuite::Compare::StringToFile);
 }
 
+void StanfordSceneConverterTest::chunked() {
+    auto&& data = ChunkedData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    using namespace Math::Literals;
+
+    /* Same as in nonIndexedAllAttributes() */
+    const Vertex vertices[] {
+        {{15, 33}, {1.5f, 0.4f, 9.2f}, 0xdeadbeef_rgba, 163247, {15, -100, 0}},
+        {{2762, 90}, {0.3f, -1.1f, 0.1f}, 0xbadcafe_rgba, 13543154, {12, 52, -44}},
+        {{}, {}, {}, 0, {}},
+        {{}, {}, {}, 0, {}},
+        {{}, {}, {}, 0, {}},
+        {{15, 34}, {0.4f, 2.2f, 0.1f}, 0x33005577_rgba, 10, {14, 42, 34}},
+        {{}, {}, {}, 0, {}},
+        {{18, 98}, {1.0f, 2.0f, 3.0f}, 0x77777777_rgba, 168, {0, 78, 24}},
+        {{}, {}, {}, 0, {}},
+        {{}, {}, {}, 0, {}},
+        {{}, {}, {}, 0, {}},
+        {{}, {}, {}, 0, {}}
+    };
+    MeshData nonIndexed{MeshPrimitive::Triangles, {}, vertices, {
+        MeshAttributeData{MeshAttribute::TextureCoordinates,
+            VertexFormat::Vector2usNormalized,
+            offsetof(Vertex, textureCoordinates), 12, sizeof(Vertex)},
+        MeshAttributeData{MeshAttribute::Position,
+            VertexFormat::Vector3,
+            offsetof(Vertex, position), 12, sizeof(Vertex)},
+        MeshAttributeData{MeshAttribute::Color,
+            VertexFormat::Vector4ubNormalized,
+            offsetof(Vertex, color), 12, sizeof(Vertex)},
+        MeshAttributeData{MeshAttribute::ObjectId,
+            VertexFormat::UnsignedInt,
+            offsetof(Vertex, objectId), 12, sizeof(Vertex)},
+        MeshAttributeData{MeshAttribute::Normal,
+            VertexFormat::Vector3bNormalized,
+            offsetof(Vertex, normal), 12, sizeof(Vertex)}
+    }};
+
+    /* Same as in indexed() */
+    const Vector3 positions[] {
+        {-1.0f, -1.0f, 0.0f},
+        { 1.0f, -1.0f, 0.0f},
+        { 1.0f,  1.0f, 0.0f},
+        {-1.0f,  1.0f, 0.0f}
+    };
+    const UnsignedShort indices[] { 0, 1, 2, 0, 2, 3 };
+    MeshData indexed{MeshPrimitive::Triangles,
+        {}, indices, MeshIndexData{indices},
+        {}, positions, {
+            MeshAttributeData{MeshAttribute::Position,
+            Containers::arrayView(positions)}
+    }};
+
+    Containers::Pointer<AbstractSceneConverter> converter = _converterMnager.instantiate("StanfordSceneConverter");
+    CORRADE_VERIFY(converter->features() & SceneConverterFeature::ConvertMeshToFile);
+    if(data.chunkSize)
+        converter->configuration().setValue("chunkSize", *data.chunkSize);
+    converter->configuration().setValue("threads", data.threads);
+
+    CORRADE_VERIFY(Utility::Directory::mkpath(STANFORDSCENECONVERTER_WRITE_TEST_DIR));
+
+    {
+        const std::string filename = Utility::Directory::join(STANFORDSCENECONVERTER_WRITE_TEST_DIR, "nonindexed-all-attributes-le.ply");
+        if(Utility::Directory::exists(filename))
+            CORRADE_VERIFY(Utility::Directory::rm(filename));
+
+        converter->configuration().setValue("endianness", "little");
+        CORRADE_VERIFY(converter->convertToFile(filename, nonIndexed));
+        CORRADE_COMPARE_AS(filename,
+            Utility::Directory::join(STANFORDSCENECONVERTER_TEST_DIR, "nonindexed-all-attributes-le.ply"),
+            TestSuite::Compare::File);
+
+        /* The in-memory output is split into the same chunks */
+        Containers::Array<char> out = converter->convertToData(nonIndexed);
+        CORRADE_VERIFY(out);
+        CORRADE_COMPARE_AS((std::string{out.data(), out.size()}),
+            Utility::Directory::join(STANFORDSCENECONVERTER_TEST_DIR, "nonindexed-all-attributes-le.ply"),
+            TestSuite::Compare::StringToFile);
+    } {
+        const std::string filename = Utility::Directory::join(STANFORDSCENECONVERTER_WRITE_TEST_DIR, "indexed-ushort-be.ply");
+        if(Utility::Directory::exists(filename))
+            CORRADE_VERIFY(Utility::Directory::rm(filename));
+
+        converter->configuration().setValue("endianness", "big");
+        CORRADE_VERIFY(converter->convertToFile(filename, indexed));
+        CORRADE_COMPARE_AS(filename,
+            Utility::Directory::join(STANFORDSCENECONVERTER_TEST_DIR, "indexed-ushort-be.ply"),
+            TestSuite::Compare::File);
+
+        Containers::Array<char> out = converter->convertToData(indexed);
+        CORRADE_VERIFY(out);
+        CORRADE_COMPARE_AS((std::string{out.data(), out.size()}),
+            Utility::Directory::join(STANFORDSCENECONVERTER_TEST_DIR, "indexed-ushort-be.ply"),
+            TestSuite::Compare::StringToFile);
+    }
+}
+
+void StanfordSceneConverterTest::convertToFileCannotOpen() {
+    Containers::Pointer<AbstractSceneConverter> converter =  _converterMnager.instantiate("StanfordSceneConverter");
+
+    const std::string filename = Utility::Directory::join(STANFORDSCENECONVERTER_WRITE_TEST_DIR, "nonexistent/file.ply");
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!converter->convertToFile(filename, MeshData{MeshPrimitive::Triangles, 0}));
+    CORRADE_COMPARE(out.str(), Utility::formatString(
+        "Trade::StanfordSceneConverter::convertToFile(): cannot open file {}\n", filename));
+}
+
 void StanfordSceneConverterTest::lines() {
     Containers::Pointer<AbstractSceneConverter> converter =  _converterMnager.instantiate("StanfordSceneConverter");
 
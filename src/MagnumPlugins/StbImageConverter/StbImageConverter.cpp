@@ -25,12 +25,15 @@
 
 #include "StbImageConverter.h"
 
-#include <algorithm>
+#include <atomic>
+#include <thread>
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Functions.h>
 
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #define STBI_ASSERT CORRADE_INTERNAL_ASSERT
@@ -45,6 +48,8 @@ StbImageConverter::StbImageConverter(Format format): _format{format} {
 
     /** @todo horrible workaround, fix this properly */
     configuration().setValue("jpegQuality", 0.8f);
+    configuration().setValue("yFlip", true);
+    configuration().setValue("threads", 1);
 }
 
 StbImageConverter::StbImageConverter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImageConverter{manager, plugin} {
@@ -64,49 +69,83 @@ StbImageConverter::StbImageConverter(PluginManager::AbstractManager& manager, co
 
 ImageConverterFeatures StbImageConverter::doFeatures() const { return ImageConverterFeature::ConvertData; }
 
-Containers::Array<char> StbImageConverter::doExportToData(const ImageView2D& image) {
-    if(!Int(_format)) {
-        Error() << "Trade::StbImageConverter::exportToData(): cannot determine output format (plugin loaded as" << plugin() << Error::nospace << ")";
-        return nullptr;
+namespace {
+
+/* Output sink for the stb_image_write callbacks. The data are appended to a
+   preallocated array that's grown by doubling the capacity, and the array can
+   be reused for more images, in which case the output just continues after
+   the previous one. */
+struct Output {
+    Containers::Array<char> data;
+    std::size_t size;
+};
+
+void write(void* const context, void* const data, const int size) {
+    Output& output = *static_cast<Output*>(context);
+    if(output.size + size > output.data.size()) {
+        Containers::Array<char> newData{Containers::NoInit, Math::max(output.size + size, 2*output.data.size())};
+        Utility::copy(output.data.prefix(output.size), newData.prefix(output.size));
+        output.data = std::move(newData);
     }
+    Utility::copy(Containers::arrayView(static_cast<const char*>(data), size),
+        output.data.slice(output.size, output.size + size));
+    output.size += size;
+}
 
-    Int components;
-    if(_format == Format::Bmp || _format == Format::Jpeg || _format == Format::Png || _format == Format::Tga) {
-        switch(image.format()) {
-            case PixelFormat::R8Unorm:      components = 1; break;
+/* Returns the component count for stb_image_write or 0 if the format is not
+   supported. Prints the messages here and not in encode() so it's possible
+   to do the check upfront on the calling thread in exportBatchToData(). */
+Int componentCount(const StbImageConverter::Format format, const PixelFormat pixelFormat, const char* const messagePrefix) {
+    if(format == StbImageConverter::Format::Bmp || format == StbImageConverter::Format::Jpeg || format == StbImageConverter::Format::Png || format == StbImageConverter::Format::Tga) {
+        switch(pixelFormat) {
+            case PixelFormat::R8Unorm:      return 1;
             case PixelFormat::RG8Unorm:
-                if(_format == Format::Bmp || _format == Format::Jpeg)
-                    Warning{} << "Trade::StbImageConverter::exportToData(): ignoring green channel for BMP/JPEG output";
-                components = 2;
-                break;
-            case PixelFormat::RGB8Unorm:    components = 3; break;
+                if(format == StbImageConverter::Format::Bmp || format == StbImageConverter::Format::Jpeg)
+                    Warning{} << messagePrefix << "ignoring green channel for BMP/JPEG output";
+                return 2;
+            case PixelFormat::RGB8Unorm:    return 3;
             case PixelFormat::RGBA8Unorm:
-                if(_format == Format::Bmp || _format == Format::Jpeg)
-                    Warning{} << "Trade::StbImageConverter::exportToData(): ignoring alpha channel for BMP/JPEG output";
-                components = 4;
-                break;
+                if(format == StbImageConverter::Format::Bmp || format == StbImageConverter::Format::Jpeg)
+                    Warning{} << messagePrefix << "ignoring alpha channel for BMP/JPEG output";
+                return 4;
             default:
-                Error() << "Trade::StbImageConverter::exportToData():" << image.format() << "is not supported for BMP/JPEG/PNG/TGA output";
-                return nullptr;
+                Error() << messagePrefix << pixelFormat << "is not supported for BMP/JPEG/PNG/TGA output";
+                return 0;
         }
-    } else if(_format == Format::Hdr) {
-        switch(image.format()) {
-            case PixelFormat::R32F:         components = 1; break;
+    } else if(format == StbImageConverter::Format::Hdr) {
+        switch(pixelFormat) {
+            case PixelFormat::R32F:         return 1;
             case PixelFormat::RG32F:
-                Warning{} << "Trade::StbImageConverter::exportToData(): ignoring green channel for HDR output";
-                components = 2;
-                break;
-            case PixelFormat::RGB32F:       components = 3; break;
+                Warning{} << messagePrefix << "ignoring green channel for HDR output";
+                return 2;
+            case PixelFormat::RGB32F:       return 3;
             case PixelFormat::RGBA32F:
-                Warning{} << "Trade::StbImageConverter::exportToData(): ignoring alpha channel for HDR output";
-                components = 4;
-                break;
+                Warning{} << messagePrefix << "ignoring alpha channel for HDR output";
+                return 4;
             default:
-                Error() << "Trade::StbImageConverter::exportToData():" << image.format() << "is not supported for HDR output";
-                return nullptr;
+                Error() << messagePrefix << pixelFormat << "is not supported for HDR output";
+                return 0;
         }
     } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
+
+const char* formatName(const StbImageConverter::Format format) {
+    switch(format) {
+        case StbImageConverter::Format::Bmp: return "BMP";
+        case StbImageConverter::Format::Jpeg: return "JPEG";
+        case StbImageConverter::Format::Hdr: return "HDR";
+        case StbImageConverter::Format::Png: return "PNG";
+        case StbImageConverter::Format::Tga: return "TGA";
+    }
 
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
+
+/* Appends the encoded image to the output. The scratch array is used for the
+   flipped or repacked image data and is reused across calls, growing as
+   needed. Doesn't print anything, so it's safe to be called from multiple
+   threads at once with a different output and scratch memory. */
+bool encode(const StbImageConverter::Format format, const ImageView2D& image, const Int components, const Int jpegQuality, const bool yFlip, Containers::Array<unsigned char>& scratch, Output& output) {
     /* Get data properties and calculate the initial slice based on subimage
        offset */
     const std::pair<Math::Vector2<std::size_t>, Math::Vector2<std::size_t>> dataProperties = image.dataProperties();
@@ -115,51 +154,154 @@ Containers::Array<char> StbImageConverter::doExportToData(const ImageView2D& ima
 
     /* Reverse rows in image data. There is stbi_flip_vertically_on_write() but
        can't use that because the input image might be sparse (having padded
-       rows, for example). The copy makes the data tightly packed. */
-    Containers::Array<unsigned char> reversedData{image.pixelSize()*image.size().product()};
-    std::size_t outputStride = image.pixelSize()*image.size().x();
-    for(Int y = 0; y != image.size().y(); ++y) {
-        auto row = inputData.suffix(y*dataProperties.second.x()).prefix(outputStride);
-        std::copy(row.begin(), row.end(), reversedData.suffix((image.size().y() - y - 1)*outputStride).begin());
+       rows, for example). The copy makes the data tightly packed. If the
+       image is already top-down and tightly packed, it's passed to stb
+       directly without any copy. */
+    const std::size_t outputStride = image.pixelSize()*image.size().x();
+    const std::size_t outputSize = image.pixelSize()*image.size().product();
+    const unsigned char* data;
+    if(!yFlip && dataProperties.second.x() == outputStride) {
+        data = inputData;
+    } else {
+        if(scratch.size() < outputSize)
+            scratch = Containers::Array<unsigned char>{Containers::NoInit, outputSize};
+        for(Int y = 0; y != image.size().y(); ++y) {
+            const std::size_t outputY = yFlip ? image.size().y() - y - 1 : y;
+            Utility::copy(inputData.slice(y*dataProperties.second.x(), y*dataProperties.second.x() + outputStride),
+                scratch.slice(outputY*outputStride, (outputY + 1)*outputStride));
+        }
+        data = scratch;
     }
 
-    std::string data;
-    const auto writeFunc = [](void* context, void* data, int size) {
-        static_cast<std::string*>(context)->append(static_cast<char*>(data), size);
-    };
+    if(format == StbImageConverter::Format::Bmp)
+        return stbi_write_bmp_to_func(write, &output, image.size().x(), image.size().y(), components, data);
+    if(format == StbImageConverter::Format::Jpeg)
+        return stbi_write_jpg_to_func(write, &output, image.size().x(), image.size().y(), components, data, jpegQuality);
+    if(format == StbImageConverter::Format::Hdr)
+        return stbi_write_hdr_to_func(write, &output, image.size().x(), image.size().y(), components, reinterpret_cast<const float*>(data));
+    if(format == StbImageConverter::Format::Png)
+        return stbi_write_png_to_func(write, &output, image.size().x(), image.size().y(), components, data, 0);
+    if(format == StbImageConverter::Format::Tga)
+        return stbi_write_tga_to_func(write, &output, image.size().x(), image.size().y(), components, data);
+    CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
 
-    if(_format == Format::Bmp) {
-        if(!stbi_write_bmp_to_func(writeFunc, &data, image.size().x(), image.size().y(), components, reversedData)) {
-            Error() << "Trade::StbImageConverter::exportToData(): error while writing the BMP file";
-            return nullptr;
-        }
-    } else if(_format == Format::Jpeg) {
-        if(!stbi_write_jpg_to_func(writeFunc, &data, image.size().x(), image.size().y(), components, reversedData, Int(configuration().value<Float>("jpegQuality")*100.0f))) {
-            Error() << "Trade::StbImageConverter::exportToData(): error while writing the JPEG file";
-            return nullptr;
-        }
-    } else if(_format == Format::Hdr) {
-        if(!stbi_write_hdr_to_func(writeFunc, &data, image.size().x(), image.size().y(), components, reinterpret_cast<float*>(reversedData.begin()))) {
-            Error() << "Trade::StbImageConverter::exportToData(): error while writing the HDR file";
-            return nullptr;
-        }
-    } else if(_format == Format::Png) {
-        if(!stbi_write_png_to_func(writeFunc, &data, image.size().x(), image.size().y(), components, reversedData, 0)) {
-            Error() << "Trade::StbImageConverter::exportToData(): error while writing the PNG file";
-            return nullptr;
+/* Initial output capacity for an image, the compressed formats are usually
+   a fraction of the input size */
+std::size_t initialCapacity(const ImageView2D& image) {
+    return Math::max(std::size_t{4096}, image.pixelSize()*std::size_t(Math::max(image.size().product(), 0))/4);
+}
+
+}
+
+Containers::Array<char> StbImageConverter::doExportToData(const ImageView2D& image) {
+    if(!Int(_format)) {
+        Error() << "Trade::StbImageConverter::exportToData(): cannot determine output format (plugin loaded as" << plugin() << Error::nospace << ")";
+        return nullptr;
+    }
+
+    const Int components = componentCount(_format, image.format(), "Trade::StbImageConverter::exportToData():");
+    if(!components) return nullptr;
+
+    Containers::Array<unsigned char> scratch;
+    Output output{Containers::Array<char>{Containers::NoInit, initialCapacity(image)}, 0};
+    if(!encode(_format, image, components, Int(configuration().value<Float>("jpegQuality")*100.0f), configuration().value<bool>("yFlip"), scratch, output)) {
+        Error() << "Trade::StbImageConverter::exportToData(): error while writing the" << formatName(_format) << "file";
+        return nullptr;
+    }
+
+    /* Take over the output memory directly. It's allocated with new[], so the
+       default deleter works for it, only the size gets trimmed. */
+    return Containers::Array<char>{output.data.release(), output.size};
+}
+
+Containers::Array<char> StbImageConverter::exportBatchToData(const Containers::ArrayView<const ImageView2D> images, const Containers::ArrayView<Containers::ArrayView<const char>> outputs) {
+    CORRADE_ASSERT(outputs.size() == images.size(),
+        "Trade::StbImageConverter::exportBatchToData(): expected" << images.size() << "outputs but got" << outputs.size(), {});
+
+    for(Containers::ArrayView<const char>& output: outputs) output = nullptr;
+
+    if(!Int(_format)) {
+        Error() << "Trade::StbImageConverter::exportBatchToData(): cannot determine output format (plugin loaded as" << plugin() << Error::nospace << ")";
+        return {};
+    }
+
+    /* Check the formats upfront so all messages are printed on the calling
+       thread. Images with an unsupported format are skipped below. */
+    Containers::Array<Int> components{Containers::NoInit, images.size()};
+    std::size_t capacity = 0;
+    for(std::size_t i = 0; i != images.size(); ++i) {
+        components[i] = componentCount(_format, images[i].format(), "Trade::StbImageConverter::exportBatchToData():");
+        capacity += initialCapacity(images[i]);
+    }
+
+    std::size_t threadCount = configuration().value<std::size_t>("threads");
+    if(!threadCount) threadCount = Math::max(1u, std::thread::hardware_concurrency());
+    threadCount = Math::max(std::size_t{1}, Math::min(threadCount, images.size()));
+
+    /* Each thread has its own output arena and scratch memory, reused for all
+       images it encodes. The arena is preallocated to an estimate of the
+       thread's share of the total output size, so it usually doesn't need to
+       be grown at all. Afterwards the arenas are concatenated into a single
+       allocation. */
+    struct Location {
+        std::size_t thread;
+        std::size_t offset;
+        std::size_t size;
+    };
+    Containers::Array<Location> locations{Containers::ValueInit, images.size()};
+    Containers::Array<Output> arenas{threadCount};
+    const Int jpegQuality = Int(configuration().value<Float>("jpegQuality")*100.0f);
+    const bool yFlip = configuration().value<bool>("yFlip");
+    std::atomic<std::size_t> next{0};
+    auto worker = [&](const std::size_t thread) {
+        Output& arena = arenas[thread];
+        arena.data = Containers::Array<char>{Containers::NoInit, capacity/threadCount};
+        arena.size = 0;
+        Containers::Array<unsigned char> scratch;
+        for(std::size_t i; (i = next++) < images.size(); ) {
+            if(!components[i]) continue;
+            const std::size_t offset = arena.size;
+            if(encode(_format, images[i], components[i], jpegQuality, yFlip, scratch, arena))
+                locations[i] = {thread, offset, arena.size - offset};
+            /* Discard partial output on failure */
+            else arena.size = offset;
         }
-    } else if(_format == Format::Tga) {
-        if(!stbi_write_tga_to_func(writeFunc, &data, image.size().x(), image.size().y(), components, reversedData)) {
-            Error() << "Trade::StbImageConverter::exportToData(): error while writing the TGA file";
-            return nullptr;
+    };
+
+    if(threadCount == 1) worker(0);
+    else {
+        Containers::Array<std::thread> threads{threadCount - 1};
+        for(std::size_t i = 0; i != threads.size(); ++i)
+            threads[i] = std::thread{worker, i + 1};
+        worker(0);
+        for(std::thread& thread: threads) thread.join();
+    }
+
+    Containers::Array<std::size_t> arenaOffsets{Containers::NoInit, threadCount};
+    std::size_t size = 0;
+    for(std::size_t i = 0; i != threadCount; ++i) {
+        arenaOffsets[i] = size;
+        size += arenas[i].size;
+    }
+
+    Containers::Array<char> out{Containers::NoInit, size};
+    for(std::size_t i = 0; i != threadCount; ++i)
+        Utility::copy(arenas[i].data.prefix(arenas[i].size),
+            out.slice(arenaOffsets[i], arenaOffsets[i] + arenas[i].size));
+
+    for(std::size_t i = 0; i != images.size(); ++i) {
+        if(!components[i]) continue;
+        if(!locations[i].size) {
+            Error() << "Trade::StbImageConverter::exportBatchToData(): error while writing the" << formatName(_format) << "file for image" << i;
+            continue;
         }
-    } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
 
-    /* Copy the data into array (I would *love* to have a detach() function on
-       std::string) */
-    Containers::Array<char> fileData{data.size()};
-    std::copy(data.begin(), data.end(), fileData.begin());
-    return fileData;
+        const std::size_t offset = arenaOffsets[locations[i].thread] + locations[i].offset;
+        outputs[i] = out.slice(offset, offset + locations[i].size);
+    }
+
+    return out;
 }
 
 }}
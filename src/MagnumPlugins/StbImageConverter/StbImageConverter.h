@@ -29,6 +29,7 @@
  * @brief Class @ref Magnum::Trade::StbImageConverter
  */
 
+#include <Corrade/Containers/Array.h>
 #include <Magnum/Trade/AbstractImageConverter.h>
 
 #include "MagnumPlugins/StbImageConverter/configure.h"
@@ -116,6 +117,16 @@ using plugins dedicated for given format.
     ([license text](https://github.com/nothings/stb/blob/e6afb9cbae4064da8c3e69af3ff5c4629579c1d2/stb_image_write.h#L1532-L1548),
     [choosealicense.com](https://choosealicense.com/licenses/mit/)).
 
+@section Trade-StbImageConverter-behavior Behavior and limitations
+
+The image is flipped vertically on export as a copy into a scratch buffer, as
+stb_image_write itself can't handle padded rows. If the input images are
+already top-down --- for example coming from @ref StbImageImporter with its
+@cb{.ini} yFlip @ce option disabled --- set the @cb{.ini} yFlip @ce
+@ref Trade-StbImageConverter-configuration "configuration option" to
+@cpp false @ce. Tightly packed images are then passed to the encoder directly,
+padded ones are repacked without reversing the row order.
+
 @section Trade-StbImageConverter-usage Usage
 
 This plugin depends on the @ref Trade library and is built if
@@ -154,6 +165,21 @@ target_link_libraries(your-app PRIVATE MagnumPlugins::StbImageConverter)
 See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
 information.
 
+@section Trade-StbImageConverter-batch Batch export
+
+For exporting many images at once, such as tiles or mip levels, there's
+@ref exportBatchToData(). All images are encoded into a single allocation with
+a view for each image. Encoding happens in parallel when the
+@cb{.ini} threads @ce
+@ref Trade-StbImageConverter-configuration "configuration option" is set to
+something else than @cpp 1 @ce. Each thread writes into its own arena,
+preallocated to an estimate of the output size and reused for all images it
+encodes, so there are no allocations per image. All images are exported in
+the same format, to export into different formats use a separate plugin
+instance for each format. If you use the threads, check the
+@ref Trade-BasisImageConverter-loading "BasisImageConverter docs" for notes
+about pthread linking.
+
 @section Trade-StbImageConverter-configuration Plugin-specific configuration
 
 For some formats, it's possible to tune various output options through
@@ -193,6 +219,22 @@ class MAGNUM_STBIMAGECONVERTER_EXPORT StbImageConverter: public AbstractImageCon
          */
         explicit StbImageConverter(PluginManager::AbstractManager& manager, const std::string& plugin);
 
+        /**
+         * @brief Export multiple images to raw data
+         * @param[in]  images   Images to export
+         * @param[out] outputs  Where to put views on the exported data for
+         *      each image. Expected to have the same size as @p images.
+         * @m_since_latest_{plugins}
+         *
+         * Exports all @p images to a single allocation and fills @p outputs
+         * with views on the data for each image. Images in an unsupported
+         * format or failing to be encoded get an error printed and an empty
+         * view in @p outputs, other images are unaffected. The returned array
+         * has to be kept alive for as long as the views are used. See
+         * @ref Trade-StbImageConverter-batch for more information.
+         */
+        virtual Containers::Array<char> exportBatchToData(Containers::ArrayView<const ImageView2D> images, Containers::ArrayView<Containers::ArrayView<const char>> outputs);
+
     private:
         MAGNUM_STBIMAGECONVERTER_LOCAL ImageConverterFeatures doFeatures() const override;
         MAGNUM_STBIMAGECONVERTER_LOCAL Containers::Array<char> doExportToData(const ImageView2D& image) override;
@@ -24,6 +24,7 @@
 */
 
 #include <sstream>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
@@ -36,10 +37,31 @@
 #include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "MagnumPlugins/StbImageConverter/StbImageConverter.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Trade { namespace Test { namespace {
 
+constexpr struct {
+    const char* name;
+    const char* plugin;
+    UnsignedInt threads;
+} ExportBatchData[]{
+    {"PNG", "StbPngImageConverter", 1},
+    {"TGA", "StbTgaImageConverter", 1},
+    {"PNG, four threads", "StbPngImageConverter", 4},
+    {"JPEG, all cores", "StbJpegImageConverter", 0}
+};
+
+constexpr struct {
+    const char* name;
+    bool padded;
+} NoYFlipData[]{
+    {"tightly packed", false},
+    {"padded", true}
+};
+
 struct StbImageConverterTest: TestSuite::Tester {
     explicit StbImageConverterTest();
 
@@ -68,10 +90,14 @@ struct StbImageConverterTest: TestSuite::Tester {
     void pngRgb();
     void pngGrayscale();
     void pngNegativeSize();
+    void pngNoYFlip();
 
     void tgaRgba();
     void tgaNegativeSize();
 
+    void exportBatch();
+    void exportBatchInvalid();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImageConverter> _converterManager{"nonexistent"};
     PluginManager::Manager<AbstractImporter> _importerManager{"nonexistent"};
@@ -99,11 +125,19 @@ StbImageConverterTest::StbImageConverterTest() {
 
               &StbImageConverterTest::pngRgb,
               &StbImageConverterTest::pngGrayscale,
-              &StbImageConverterTest::pngNegativeSize,
+              &StbImageConverterTest::pngNegativeSize});
 
-              &StbImageConverterTest::tgaRgba,
+    addInstancedTests({&StbImageConverterTest::pngNoYFlip},
+        Containers::arraySize(NoYFlipData));
+
+    addTests({&StbImageConverterTest::tgaRgba,
               &StbImageConverterTest::tgaNegativeSize});
 
+    addInstancedTests({&StbImageConverterTest::exportBatch},
+        Containers::arraySize(ExportBatchData));
+
+    addTests({&StbImageConverterTest::exportBatchInvalid});
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef STBIMAGECONVERTER_PLUGIN_FILENAME
@@ -649,6 +683,33 @@ void StbImageConverterTest::pngNegativeSize() {
     CORRADE_COMPARE(out.str(), "Trade::StbImageConverter::exportToData(): error while writing the PNG file\n");
 }
 
+void StbImageConverterTest::pngNoYFlip() {
+    auto&& data = NoYFlipData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("StbPngImageConverter");
+    converter->configuration().setValue("yFlip", false);
+    const auto out = converter->exportToData(data.padded ? OriginalRgb :
+        ImageView2D{PixelFormat::RGB8Unorm, {2, 3}, ConvertedRgbData});
+    CORRADE_VERIFY(out);
+
+    if(_importerManager.loadState("StbImageImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("StbImageImporter plugin not found, cannot test");
+
+    /* Importing without a flip as well should give back the original
+       data */
+    Containers::Pointer<AbstractImporter> importer = _importerManager.instantiate("StbImageImporter");
+    importer->configuration().setValue("yFlip", false);
+    CORRADE_VERIFY(importer->openData(out));
+    Containers::Optional<Trade::ImageData2D> converted = importer->image2D(0);
+    CORRADE_VERIFY(converted);
+    CORRADE_COMPARE(converted->size(), Vector2i(2, 3));
+    CORRADE_COMPARE(converted->format(), PixelFormat::RGB8Unorm);
+    CORRADE_COMPARE_AS(converted->data(),
+        Containers::arrayView(ConvertedRgbData),
+        TestSuite::Compare::Container);
+}
+
 constexpr const char OriginalRgbaData[] = {
     0, 0, 0, 0, 0, 0, 0, 0, /* Skip */
 
@@ -693,6 +754,79 @@ void StbImageConverterTest::tgaNegativeSize() {
     CORRADE_COMPARE(out.str(), "Trade::StbImageConverter::exportToData(): error while writing the TGA file\n");
 }
 
+void StbImageConverterTest::exportBatch() {
+    auto&& data = ExportBatchData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Generate a bunch of images of varying sizes and contents */
+    Containers::Array<char> pixels{Containers::NoInit, 16*32*32*4};
+    for(std::size_t i = 0; i != pixels.size(); ++i)
+        pixels[i] = char(i*7 + i/128);
+    Containers::Array<ImageView2D> images;
+    for(std::size_t i = 0; i != 16; ++i)
+        arrayAppend(images, ImageView2D{PixelFormat::RGBA8Unorm,
+            {Int(i + 1), 32}, pixels.slice(i*32*32*4, (i + 1)*32*32*4)});
+
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate(data.plugin);
+    converter->configuration().setValue("threads", data.threads);
+    Containers::Array<Containers::ArrayView<const char>> outputs{images.size()};
+
+    /* Silence the warnings about alpha being ignored for JPEG */
+    Containers::Array<char> out;
+    {
+        Warning silenceWarning{nullptr};
+        out = static_cast<StbImageConverter&>(*converter).exportBatchToData(images, outputs);
+    }
+    CORRADE_VERIFY(out);
+
+    /* The outputs should be the same as when exporting one by one */
+    for(std::size_t i = 0; i != images.size(); ++i) {
+        CORRADE_ITERATION(i);
+        Containers::Array<char> expected;
+        {
+            Warning silenceWarning{nullptr};
+            expected = converter->exportToData(images[i]);
+        }
+        CORRADE_VERIFY(expected);
+        CORRADE_VERIFY(outputs[i].begin() >= out.begin() && outputs[i].end() <= out.end());
+        CORRADE_COMPARE_AS(outputs[i], Containers::arrayView(expected),
+            TestSuite::Compare::Container);
+    }
+}
+
+void StbImageConverterTest::exportBatchInvalid() {
+    Containers::Pointer<AbstractImageConverter> converter = _converterManager.instantiate("StbTgaImageConverter");
+
+    const ImageView2D images[]{
+        OriginalRgb,
+        ImageView2D{PixelFormat::RGBA32F, {}, nullptr},
+        ImageView2D{PixelFormat::RGB8Unorm, {-1, 0}, nullptr},
+        OriginalRgba
+    };
+    Containers::ArrayView<const char> outputs[4];
+
+    std::ostringstream out;
+    Containers::Array<char> data;
+    {
+        Error redirectError{&out};
+        data = static_cast<StbImageConverter&>(*converter).exportBatchToData(images, outputs);
+    }
+    CORRADE_COMPARE(out.str(),
+        "Trade::StbImageConverter::exportBatchToData(): PixelFormat::RGBA32F is not supported for BMP/JPEG/PNG/TGA output\n"
+        "Trade::StbImageConverter::exportBatchToData(): error while writing the TGA file for image 2\n");
+
+    /* The remaining images are exported fine */
+    CORRADE_VERIFY(data);
+    CORRADE_VERIFY(!outputs[0].empty());
+    CORRADE_VERIFY(outputs[1].empty());
+    CORRADE_VERIFY(outputs[2].empty());
+    CORRADE_VERIFY(!outputs[3].empty());
+    CORRADE_COMPARE(outputs[0].size() + outputs[3].size(), data.size());
+    CORRADE_COMPARE_AS(outputs[3],
+        Containers::arrayView(converter->exportToData(OriginalRgba)),
+        TestSuite::Compare::Container);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::StbImageConverterTest)
@@ -25,13 +25,23 @@
 
 #include "StbImageImporter.h"
 
+#include <cstring>
+#include <atomic>
+#include <new>
+#include <thread>
+#include <utility>
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Utility/Algorithms.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "MagnumPlugins/Implementation/importerInput.h"
+
 #define STBI_NO_STDIO
 #define STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_STATIC
@@ -44,108 +54,175 @@
 #define STBI_THREAD_LOCAL CORRADE_THREAD_LOCAL
 #endif
 
-/* Not defining malloc/free, because there's no equivalent for realloc in C++ */
+/* Allocate with new[] so the decoded images can be adopted by an Array with
+   the default deleter without a copy. A custom deleter calling
+   stbi_image_free() can't be used, as that would be a dangling function
+   pointer call if the plugin gets unloaded sooner than the array is deleted.
+   C++ has no equivalent of realloc(), so it's emulated, and the bundled
+   stb_image.h is patched to always use STBI_REALLOC_SIZED, same as newer
+   upstream versions. */
+namespace {
+
+void* stbMalloc(const std::size_t size) {
+    return new(std::nothrow) char[size];
+}
+
+void* stbRealloc(void* const data, const std::size_t oldSize, const std::size_t newSize) {
+    char* const out = new(std::nothrow) char[newSize];
+    /* Same as with realloc(), the original is kept on failure */
+    if(!out) return nullptr;
+    if(data) std::memcpy(out, data, Magnum::Math::min(oldSize, newSize));
+    delete[] static_cast<char*>(data);
+    return out;
+}
+
+void stbFree(void* const data) {
+    delete[] static_cast<char*>(data);
+}
+
+}
+
+#define STBI_MALLOC(size) stbMalloc(size)
+#define STBI_REALLOC_SIZED(data, oldSize, newSize) stbRealloc(data, oldSize, newSize)
+#define STBI_FREE(data) stbFree(data)
 #include "stb_image.h"
 
 namespace Magnum { namespace Trade {
 
-struct StbImageImporter::State {
-    Containers::Array<char> data;
+namespace {
 
-    /* Gif size, frame stride and delays */
-    Vector3i gifSize;
-    std::size_t gifFrameStride;
-    Containers::Array<int> gifDelays;
-};
+/* State of sequential GIF decoding. Each frame is composited on top of the
+   previous ones, so the frames can only be decoded in order. */
+struct GifDecoder {
+    explicit GifDecoder(const Containers::ArrayView<const char> data) {
+        std::memset(&gif, 0, sizeof(gif));
+        stbi__start_mem(&context, reinterpret_cast<const stbi_uc*>(data.data()), data.size());
+    }
 
-StbImageImporter::StbImageImporter() = default;
+    ~GifDecoder() {
+        STBI_FREE(gif.out);
+        STBI_FREE(gif.background);
+        STBI_FREE(gif.history);
+    }
 
-StbImageImporter::StbImageImporter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImporter{manager, plugin} {}
+    stbi__context context;
+    stbi__gif gif;
+    /* Index of the frame that gets decoded next */
+    UnsignedInt next = 0;
+    /* Unflipped output of the previous frame and the one before it, the
+       latter needed for the "restore to previous" disposal */
+    Containers::Array<char> previous[2];
+};
 
-StbImageImporter::~StbImageImporter() = default;
+struct CachedGifFrame {
+    UnsignedInt id;
+    std::size_t lastUsed;
+    Containers::Array<char> data;
+};
 
-ImporterFeatures StbImageImporter::doFeatures() const { return ImporterFeature::OpenData; }
+}
 
-bool StbImageImporter::doIsOpened() const { return !!_in; }
+struct StbImageImporter::State: Implementation::ImporterInput {
+    /* Gif size and delays, parsed during opening */
+    Vector3i gifSize;
+    Containers::Array<int> gifDelays;
 
-void StbImageImporter::doClose() {
-    _in = nullptr;
-}
+    /* Lazily created during import and restarted when going back to already
+       decoded frames that aren't cached */
+    Containers::Pointer<GifDecoder> gifDecoder;
+    Containers::Array<CachedGifFrame> gifCache;
+    std::size_t gifCacheCounter = 0;
 
-void StbImageImporter::doOpenData(const Containers::ArrayView<const char> data) {
-    /* Because here we're copying the data and using the _in to check if file
-       is opened, having them nullptr would mean openData() would fail without
-       any error message. It's not possible to do this check on the importer
-       side, because empty file is valid in some formats (OBJ or glTF). We also
-       can't do the full import here because then doImage2D() would need to
-       copy the imported data instead anyway (and the uncompressed size is much
-       larger). This way it'll also work nicely with a future openMemory(). */
-    if(data.empty()) {
-        Error{} << "Trade::StbImageImporter::openData(): the file is empty";
-        return;
-    }
+    /* Saved on opening so cached GIF frames don't end up with a different
+       orientation than the newly decoded ones */
+    bool yFlip;
+};
+
+namespace {
 
+/* The settings are thread-local, so they need to be set on the same thread
+   that does the decoding, right before it happens -- not just when opening
+   the file, as the file can be opened on a different thread than the image
+   is imported on. With CORRADE_BUILD_MULTITHREADED disabled they're global,
+   but as they're private to this file and always set right before decoding,
+   that's not a problem either. */
+void setupStb(const bool yFlip) {
     /* NOTE: the StbImageImporterTest::multithreaded() test depends on these
-       two being located here. If that changes, the test needs to be adapted to
-       check those elsewhere. */
-    stbi_set_flip_vertically_on_load_thread(true);
+       two being located here. If that changes, the test needs to be adapted
+       to check those elsewhere. */
+    stbi_set_flip_vertically_on_load_thread(yFlip);
     /* The docs say this is enabled by default, but it's *not*. Ugh. */
     /** @todo do BGR -> RGB processing here instead, this may get obsolete:
         https://github.com/nothings/stb/pull/950 */
     stbi_convert_iphone_png_to_rgb_thread(true);
+}
 
-    /* Try to open as a gif. If that succeeds, great. If that fails, the actual
-       opening (and error handling) is done in doImage2D(). */
-    {
-        int* delays;
-        Vector3i size;
-        int components;
-        stbi_uc* gifData = stbi_load_gif_from_memory(reinterpret_cast<const stbi_uc*>(data.begin()), data.size(), &delays, &size.x(), &size.y(), &size.z(), &components, 0);
-        if(gifData) {
-            _in.emplace();
-
-            /* Acquire ownership of the data */
-            _in->gifDelays = Containers::Array<int>{delays, std::size_t(size.z()),
-                [](int* data, std::size_t) { stbi_image_free(data); }};
-            _in->data = Containers::Array<char>{reinterpret_cast<char*>(gifData),
-                std::size_t(size.product()*components),
-                [](char* data, std::size_t) { stbi_image_free(data); }};
-
-            /* Save size, decide on frame stride. stb_image says that for GIF
-               the result is always four-channel, so take a shortcut and report
-               the images as PixelFormat::RGBA8Unorm always -- that also means
-               we don't need to handle alignment explicitly. */
-            _in->gifSize = size;
-            CORRADE_INTERNAL_ASSERT(components == 4);
-            CORRADE_INTERNAL_ASSERT((size.x()*components)%4 == 0);
-            _in->gifFrameStride = size.xy().product()*components;
-            return;
+/* Goes through the GIF block structure without decompressing anything to get
+   the image size, frame count and delays. Returns false if the file is not a
+   GIF or if it's truncated, in which case it's decoded as a single image
+   instead, same as stbi_load_gif_from_memory() failing would. */
+bool parseGif(const Containers::ArrayView<const char> in, Vector3i& size, Containers::Array<int>& delays) {
+    const unsigned char* const data = reinterpret_cast<const unsigned char*>(in.data());
+    const std::size_t end = in.size();
+    auto get16le = [&](std::size_t i) { return Int(data[i]) | (Int(data[i + 1]) << 8); };
+
+    /* Header and logical screen descriptor */
+    if(end < 13 || std::memcmp(data, "GIF8", 4) != 0 || (data[4] != '7' && data[4] != '9') || data[5] != 'a')
+        return false;
+    size.x() = get16le(6);
+    size.y() = get16le(8);
+    std::size_t i = 13;
+    if(data[10] & 0x80) i += 3*(2 << (data[10] & 7));
+
+    /* Skips data sub-blocks, returns false if going out of bounds */
+    auto skipSubBlocks = [&]() {
+        for(;;) {
+            if(i >= end) return false;
+            const std::size_t length = data[i++];
+            if(!length) return true;
+            i += length;
         }
+    };
+
+    /* Same as stb_image, the delay is kept from the previous frame if the
+       frame doesn't have its own graphic control extension */
+    Int delay = 0;
+    size.z() = 0;
+    for(;;) {
+        if(i >= end) return false;
+        const unsigned char tag = data[i++];
+
+        /* Image descriptor, followed by an optional local color table, LZW
+           minimum code size and the image data */
+        if(tag == 0x2c) {
+            if(i + 9 > end) return false;
+            const unsigned char flags = data[i + 8];
+            i += 9;
+            if(flags & 0x80) i += 3*(2 << (flags & 7));
+            i += 1;
+            if(!skipSubBlocks()) return false;
+            arrayAppend(delays, delay);
+            ++size.z();
+
+        /* Extension. Graphic control extension has the delay in hundredths of
+           a second. */
+        } else if(tag == 0x21) {
+            if(i + 2 > end) return false;
+            if(data[i] == 0xf9 && data[i + 1] == 4 && i + 6 <= end)
+                delay = 10*get16le(i + 3);
+            i += 1;
+            if(!skipSubBlocks()) return false;
+
+        /* Trailer */
+        } else if(tag == 0x3b) {
+            return size.z() != 0;
+
+        } else return false;
     }
-
-    _in.emplace();
-    _in->data = Containers::Array<char>{data.size()};
-    Utility::copy(data, _in->data);
 }
 
-const void* StbImageImporter::doImporterState() const {
-    return _in->gifDelays.data();
-}
-
-UnsignedInt StbImageImporter::doImage2DCount() const {
-    return _in->gifSize.isZero() ? 1 : _in->gifSize.z();
-}
-
-Containers::Optional<ImageData2D> StbImageImporter::doImage2D(const UnsignedInt id, UnsignedInt) {
-    /* This is a GIF that was loaded already during data opening. Return Nth
-       image */
-    if(!_in->gifSize.isZero()) {
-        Containers::Array<char> imageData{_in->gifFrameStride};
-        Utility::copy(Containers::arrayCast<char>(
-            _in->data.slice(id*_in->gifFrameStride, (id + 1)*_in->gifFrameStride)),
-            imageData);
-        return Trade::ImageData2D{PixelFormat::RGBA8Unorm, _in->gifSize.xy(), std::move(imageData)};
-    }
+Containers::Optional<ImageData2D> decode(const Containers::ArrayView<const char> in, const bool yFlip, const char* const messagePrefix) {
+    setupStb(yFlip);
 
     Vector2i size;
     Int components;
@@ -153,8 +230,8 @@ Containers::Optional<ImageData2D> StbImageImporter::doImage2D(const UnsignedInt
     stbi_uc* data;
     std::size_t channelSize;
     PixelFormat format;
-    if(stbi_is_hdr_from_memory(reinterpret_cast<const stbi_uc*>(_in->data.data()), _in->data.size())) {
-        data = reinterpret_cast<stbi_uc*>(stbi_loadf_from_memory(reinterpret_cast<const stbi_uc*>(_in->data.data()), _in->data.size(), &size.x(), &size.y(), &components, 0));
+    if(stbi_is_hdr_from_memory(reinterpret_cast<const stbi_uc*>(in.data()), in.size())) {
+        data = reinterpret_cast<stbi_uc*>(stbi_loadf_from_memory(reinterpret_cast<const stbi_uc*>(in.data()), in.size(), &size.x(), &size.y(), &components, 0));
         channelSize = 4;
         if(data) switch(components) {
             case 1: format = PixelFormat::R32F;         break;
@@ -164,7 +241,7 @@ Containers::Optional<ImageData2D> StbImageImporter::doImage2D(const UnsignedInt
             default: CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
         }
     } else {
-        data = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(_in->data.data()), _in->data.size(), &size.x(), &size.y(), &components, 0);
+        data = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(in.data()), in.size(), &size.x(), &size.y(), &components, 0);
         channelSize = 1;
         if(data) switch(components) {
             case 1: format = PixelFormat::R8Unorm;      break;
@@ -176,16 +253,13 @@ Containers::Optional<ImageData2D> StbImageImporter::doImage2D(const UnsignedInt
     }
 
     if(!data) {
-        Error() << "Trade::StbImageImporter::image2D(): cannot open the image:" << stbi_failure_reason();
+        Error() << messagePrefix << "cannot open the image:" << stbi_failure_reason();
         return Containers::NullOpt;
     }
 
-    /* Copy the data into array with default deleter and free the original (we
-       can't use custom deleter to avoid dangling function pointer call when
-       the plugin is unloaded sooner than the array is deleted) */
-    Containers::Array<char> imageData{std::size_t(size.product()*components*channelSize)};
-    Utility::copy(Containers::arrayView(reinterpret_cast<char*>(data), imageData.size()), imageData);
-    stbi_image_free(data);
+    /* The data are allocated with new[], so they can be taken over with the
+       default deleter directly */
+    Containers::Array<char> imageData{reinterpret_cast<char*>(data), std::size_t(size.product()*components*channelSize)};
 
     /* Adjust pixel storage if row size is not four byte aligned */
     PixelStorage storage;
@@ -195,6 +269,192 @@ Containers::Optional<ImageData2D> StbImageImporter::doImage2D(const UnsignedInt
     return Trade::ImageData2D{storage, format, size, std::move(imageData)};
 }
 
+}
+
+StbImageImporter::StbImageImporter() {
+    /** @todo horrible workaround, fix this properly */
+    configuration().setValue("yFlip", true);
+}
+
+StbImageImporter::StbImageImporter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImporter{manager, plugin} {}
+
+StbImageImporter::~StbImageImporter() = default;
+
+ImporterFeatures StbImageImporter::doFeatures() const { return ImporterFeature::OpenData; }
+
+bool StbImageImporter::doIsOpened() const { return !!_in; }
+
+void StbImageImporter::doClose() {
+    _in = nullptr;
+}
+
+void StbImageImporter::doOpenFile(const std::string& filename) {
+    /* Map the file instead of reading it to avoid having the whole file
+       copied in memory. Moving the state in openInternal() doesn't change the
+       data pointer, so the view stays valid. */
+    Containers::Pointer<State> state{Containers::InPlaceInit};
+    if(!state->openFile(filename, "Trade::StbImageImporter::openFile():")) return;
+    openInternal(std::move(state), "Trade::StbImageImporter::openFile():");
+}
+
+void StbImageImporter::doOpenData(const Containers::ArrayView<const char> data) {
+    Containers::Pointer<State> state{Containers::InPlaceInit};
+    state->openData(data);
+    openInternal(std::move(state), "Trade::StbImageImporter::openData():");
+}
+
+void StbImageImporter::openInternal(Containers::Pointer<State>&& state, const char* const messagePrefix) {
+    /* Because here we're using the _in to check if file is opened, having
+       them nullptr would mean openData() would fail without any error
+       message. It's not possible to do this check on the importer side,
+       because empty file is valid in some formats (OBJ or glTF). We also
+       can't do the full import here because then doImage2D() would need to
+       copy the imported data instead anyway (and the uncompressed size is
+       much larger). */
+    if(state->in.empty()) {
+        Error{} << messagePrefix << "the file is empty";
+        return;
+    }
+
+    state->yFlip = configuration().value<bool>("yFlip");
+    setupStb(state->yFlip);
+
+    /* If this is a GIF, only go through its structure to get the frame count
+       and delays, the frames are decoded on demand in doImage2D(). If it's
+       not a GIF or the structure is broken, the actual opening (and error
+       handling) is done in doImage2D(). */
+    Vector3i gifSize;
+    Containers::Array<int> gifDelays;
+    if(parseGif(state->in, gifSize, gifDelays) && !gifSize.xy().isZero()) {
+        state->gifSize = gifSize;
+        state->gifDelays = std::move(gifDelays);
+        state->gifCache = Containers::Array<CachedGifFrame>{configuration().value<UnsignedInt>("gifCachedFrames")};
+        for(CachedGifFrame& frame: state->gifCache) frame.id = ~UnsignedInt{};
+    }
+
+    _in = std::move(state);
+}
+
+const void* StbImageImporter::doImporterState() const {
+    return _in->gifDelays.data();
+}
+
+UnsignedInt StbImageImporter::doImage2DCount() const {
+    return _in->gifSize.isZero() ? 1 : _in->gifSize.z();
+}
+
+Containers::Optional<ImageData2D> StbImageImporter::doImage2D(const UnsignedInt id, UnsignedInt) {
+    if(!_in->gifSize.isZero()) return doGifImage2D(id);
+
+    return decode(_in->in, _in->yFlip, "Trade::StbImageImporter::image2D():");
+}
+
+Containers::Optional<ImageData2D> StbImageImporter::doGifImage2D(const UnsignedInt id) {
+    /* stb_image says that for GIF the result is always four-channel, so take
+       a shortcut and report the images as PixelFormat::RGBA8Unorm always --
+       that also means we don't need to handle alignment explicitly */
+    State& state = *_in;
+    const Vector2i size = state.gifSize.xy();
+    const std::size_t rowSize = size.x()*4;
+    const std::size_t frameSize = rowSize*size.y();
+
+    /* If the frame is cached, return a copy of it */
+    for(CachedGifFrame& frame: state.gifCache) {
+        if(frame.id != id) continue;
+        frame.lastUsed = ++state.gifCacheCounter;
+        Containers::Array<char> imageData{Containers::NoInit, frameSize};
+        Utility::copy(frame.data, imageData);
+        return Trade::ImageData2D{PixelFormat::RGBA8Unorm, size, std::move(imageData)};
+    }
+
+    /* Restart the decoding if going back */
+    if(!state.gifDecoder || state.gifDecoder->next > id)
+        state.gifDecoder.emplace(state.in);
+
+    /* Decode all frames until the requested one */
+    GifDecoder& decoder = *state.gifDecoder;
+    while(decoder.next <= id) {
+        int components;
+        stbi_uc* const twoBack = decoder.next >= 2 ?
+            reinterpret_cast<stbi_uc*>(decoder.previous[1].data()) : nullptr;
+        stbi_uc* const frame = stbi__gif_load_next(&decoder.context, &decoder.gif, &components, 4, twoBack);
+        if(!frame || frame == reinterpret_cast<stbi_uc*>(&decoder.context)) {
+            Error{} << "Trade::StbImageImporter::image2D(): cannot open the image:" << (frame ? "unexpected end of file" : stbi_failure_reason());
+            state.gifDecoder = nullptr;
+            return Containers::NullOpt;
+        }
+        CORRADE_INTERNAL_ASSERT(decoder.gif.w == size.x() && decoder.gif.h == size.y());
+
+        /* The previous output is the one before the previous now, the one
+           before the previous isn't needed anymore and its memory can be
+           reused */
+        std::swap(decoder.previous[0], decoder.previous[1]);
+        if(!decoder.previous[0])
+            decoder.previous[0] = Containers::Array<char>{Containers::NoInit, frameSize};
+        Utility::copy(Containers::arrayView(reinterpret_cast<const char*>(frame), frameSize), decoder.previous[0]);
+        ++decoder.next;
+    }
+
+    /* Flip the output while copying, as stbi_set_flip_vertically_on_load()
+       applies only to the high-level APIs */
+    Containers::Array<char> imageData{Containers::NoInit, frameSize};
+    if(state.yFlip) {
+        for(std::size_t y = 0; y != std::size_t(size.y()); ++y)
+            Utility::copy(decoder.previous[0].slice((size.y() - y - 1)*rowSize, (size.y() - y)*rowSize), imageData.slice(y*rowSize, (y + 1)*rowSize));
+    } else Utility::copy(decoder.previous[0], imageData);
+
+    /* Put it into the cache, replacing the least recently used frame */
+    if(!state.gifCache.empty()) {
+        CachedGifFrame* leastRecentlyUsed = &state.gifCache[0];
+        for(CachedGifFrame& frame: state.gifCache)
+            if(frame.lastUsed < leastRecentlyUsed->lastUsed)
+                leastRecentlyUsed = &frame;
+        leastRecentlyUsed->id = id;
+        leastRecentlyUsed->lastUsed = ++state.gifCacheCounter;
+        if(!leastRecentlyUsed->data)
+            leastRecentlyUsed->data = Containers::Array<char>{Containers::NoInit, frameSize};
+        Utility::copy(imageData, leastRecentlyUsed->data);
+    }
+
+    return Trade::ImageData2D{PixelFormat::RGBA8Unorm, size, std::move(imageData)};
+}
+
+Containers::Array<Containers::Optional<ImageData2D>> StbImageImporter::decodeBatch(const Containers::ArrayView<const Containers::ArrayView<const char>> files) {
+    Containers::Array<Containers::Optional<ImageData2D>> out{files.size()};
+
+    /* Without thread-local stb_image state the error reporting would race,
+       so decode everything on the calling thread in that case */
+    #ifdef CORRADE_BUILD_MULTITHREADED
+    UnsignedInt threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+    #else
+    constexpr UnsignedInt threadCount = 1;
+    #endif
+
+    /* Each image is decoded and taken over without any copy, so there's no
+       need to allocate anything upfront, unlike in PngImporter. Files are
+       distributed dynamically as their decoding cost can vary a lot. */
+    const bool yFlip = configuration().value<bool>("yFlip");
+    std::atomic<std::size_t> next{0};
+    auto decodeFiles = [&]() {
+        std::size_t i;
+        while((i = next++) < files.size()) {
+            if(files[i].empty()) {
+                Error{} << "Trade::StbImageImporter::decodeBatch(): image" << i << "is empty";
+                continue;
+            }
+            out[i] = decode(files[i], yFlip, "Trade::StbImageImporter::decodeBatch():");
+        }
+    };
+
+    Containers::Array<std::thread> threads{Math::min(std::size_t(threadCount), Math::max(files.size(), std::size_t{1})) - 1};
+    for(std::thread& thread: threads) thread = std::thread{decodeFiles};
+    decodeFiles();
+    for(std::thread& thread: threads) thread.join();
+
+    return out;
+}
+
 }}
 
 CORRADE_PLUGIN_REGISTER(StbImageImporter, Magnum::Trade::StbImageImporter,
@@ -29,6 +29,8 @@
  * @brief Class @ref Magnum::Trade::StbImageImporter
  */
 
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Pointer.h>
 #include <Magnum/Trade/AbstractImporter.h>
 
@@ -137,8 +139,32 @@ images are imported with @ref PixelFormat::RGB32F, @ref PixelFormat::RGBA32F,
 default @ref PixelStorage parameters except for alignment, which may be changed
 to @cpp 1 @ce if the data require it.
 
+The image is Y-flipped on import to have the origin at the bottom left, as is
+the convention in Magnum. stb_image does that in a separate pass over the
+decoded data, so if the image is consumed by an API that expects the rows
+top to bottom, such as Vulkan, disable the @cb{.ini} yFlip @ce
+@ref Trade-StbImageImporter-configuration "configuration option" to skip it.
+The option is read when opening a file, except for @ref decodeBatch() where
+it's read on each call.
+
+Files passed to @ref openFile() are memory-mapped on platforms that support
+it, data passed to @ref openData() are copied.
+
 The importer is thread-safe if Corrade and Magnum is compiled with
-@ref CORRADE_BUILD_MULTITHREADED enabled.
+@ref CORRADE_BUILD_MULTITHREADED enabled. In that case all stb_image state is
+thread-local in the bundled stb_image build and is set up on the decoding
+thread right before each decode, so any number of importer instances can be
+used in parallel.
+
+@subsection Trade-StbImageImporter-behavior-batch Batch decoding
+
+The @ref decodeBatch() function decodes many files at once, on multiple
+threads based on the @cb{.ini} threads @ce
+@ref Trade-StbImageImporter-configuration "configuration option". If
+@ref CORRADE_BUILD_MULTITHREADED isn't enabled, everything is decoded on the
+calling thread. If the option is set to a value other than @cpp 1 @ce, the
+application needs to link to `pthread` on Linux due to the same reasons as
+described in @ref Trade-BasisImageConverter-loading "BasisImageConverter docs".
 
 @subsection Trade-StbImageImporter-behavior-bmp BMP support
 
@@ -155,6 +181,16 @@ frame. Example usage:
 
 @snippet StbImageImporter.cpp gif-delays
 
+The frame count and delays are extracted already when opening the file, but
+the frames themselves are decoded only when requested through @ref image2D(),
+so the memory use doesn't depend on the frame count. As each frame is
+composited on top of the previous ones, the frames are decoded in order ---
+accessing them sequentially is the fastest, going back to an earlier frame
+means decoding the file again from the start unless the frame is among the
+last few requested ones, which are cached. The cache size can be set with the
+@cb{.ini} gifCachedFrames @ce
+@ref Trade-StbImageImporter-configuration "configuration option".
+
 Note that the support for GIF transitions is currently incomplete, see
 [nothings/stb#683](https://github.com/nothings/stb/pull/683) for details.
 
@@ -170,6 +206,13 @@ CgBI is a proprietary Apple-specific extension to PNG
 ([details here](http://iphonedevwiki.net/index.php/CgBI_file_format)). The
 importer detects those files and converts BGRA channels back to RGBA.
 
+@section Trade-StbImageImporter-configuration Plugin-specific config
+
+It's possible to tune various import options through @ref configuration(). See
+below for all options and their default values:
+
+@snippet MagnumPlugins/StbImageImporter/StbImageImporter.conf config
+
 @todo Enable ARM NEON when I'm able to test that
 */
 class MAGNUM_STBIMAGEIMPORTER_EXPORT StbImageImporter: public AbstractImporter {
@@ -182,18 +225,39 @@ class MAGNUM_STBIMAGEIMPORTER_EXPORT StbImageImporter: public AbstractImporter {
 
         ~StbImageImporter();
 
+        /**
+         * @brief Decode many files at once
+         * @m_since_latest_{plugins}
+         *
+         * Decodes each of @p files the same way as @ref image2D() would if
+         * it was opened, on multiple threads based on the
+         * @cb{.ini} threads @ce
+         * @ref Trade-StbImageImporter-configuration "configuration option".
+         * For animated GIFs only the first frame is decoded. Doesn't need any
+         * file to be opened and doesn't affect the currently opened file.
+         * Files that fail to decode are @ref Containers::NullOpt in the
+         * output, with a message printed to @ref Error. Note that messages
+         * printed from other threads don't go through output redirection set
+         * up on the calling thread.
+         */
+        virtual Containers::Array<Containers::Optional<ImageData2D>> decodeBatch(Containers::ArrayView<const Containers::ArrayView<const char>> files);
+
     private:
+        struct State;
+
         MAGNUM_STBIMAGEIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_STBIMAGEIMPORTER_LOCAL bool doIsOpened() const override;
         MAGNUM_STBIMAGEIMPORTER_LOCAL void doClose() override;
+        MAGNUM_STBIMAGEIMPORTER_LOCAL void doOpenFile(const std::string& filename) override;
         MAGNUM_STBIMAGEIMPORTER_LOCAL void doOpenData(Containers::ArrayView<const char> data) override;
+        MAGNUM_STBIMAGEIMPORTER_LOCAL void openInternal(Containers::Pointer<State>&& state, const char* messagePrefix);
 
         MAGNUM_STBIMAGEIMPORTER_LOCAL UnsignedInt doImage2DCount() const override;
         MAGNUM_STBIMAGEIMPORTER_LOCAL Containers::Optional<ImageData2D> doImage2D(UnsignedInt id, UnsignedInt level) override;
+        MAGNUM_STBIMAGEIMPORTER_LOCAL Containers::Optional<ImageData2D> doGifImage2D(UnsignedInt id);
 
         MAGNUM_STBIMAGEIMPORTER_LOCAL const void* doImporterState() const override;
 
-        struct State;
         Containers::Pointer<State> _in;
 };
 
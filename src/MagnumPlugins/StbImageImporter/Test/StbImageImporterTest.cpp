@@ -28,6 +28,7 @@
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h>
 #include <Corrade/Utility/Directory.h>
 #include <Magnum/PixelFormat.h>
@@ -35,6 +36,8 @@
 #include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/ImageData.h>
 
+#include "MagnumPlugins/StbImageImporter/StbImageImporter.h"
+
 #include "configure.h"
 
 #ifndef CORRADE_TARGET_EMSCRIPTEN
@@ -43,6 +46,17 @@
 
 namespace Magnum { namespace Trade { namespace Test { namespace {
 
+constexpr struct {
+    const char* name;
+    UnsignedInt threads;
+} DecodeBatchData[]{
+    {"", 1},
+    #ifndef CORRADE_TARGET_EMSCRIPTEN
+    {"four threads", 4},
+    {"all cores", 0}
+    #endif
+};
+
 struct StbImageImporterTest: TestSuite::Tester {
     explicit StbImageImporterTest();
 
@@ -51,21 +65,28 @@ struct StbImageImporterTest: TestSuite::Tester {
 
     void grayPng();
     void grayJpeg();
+    void grayPngNoYFlip();
 
     void rgbPng();
     void rgbJpeg();
     void rgbHdr();
     void rgbHdrInvalid();
+    void defaultDeleter();
 
     void rgbaPng();
 
     void animatedGif();
+    void animatedGifOutOfOrder();
+    void animatedGifNoYFlip();
 
     void openTwice();
     void importTwice();
 
+    void decodeBatch();
+
     #ifndef CORRADE_TARGET_EMSCRIPTEN
     void multithreaded();
+    void importOnDifferentThread();
     #endif
 
     /* Explicitly forbid system-wide plugin dependencies */
@@ -86,21 +107,30 @@ StbImageImporterTest::StbImageImporterTest() {
 
               &StbImageImporterTest::grayPng,
               &StbImageImporterTest::grayJpeg,
+              &StbImageImporterTest::grayPngNoYFlip,
 
               &StbImageImporterTest::rgbPng,
               &StbImageImporterTest::rgbJpeg,
               &StbImageImporterTest::rgbHdr,
-              &StbImageImporterTest::rgbHdrInvalid});
+              &StbImageImporterTest::rgbHdrInvalid,
+              &StbImageImporterTest::defaultDeleter});
 
     addInstancedTests({&StbImageImporterTest::rgbaPng}, Containers::arraySize(RgbaPngTestData));
 
     addTests({&StbImageImporterTest::animatedGif,
+              &StbImageImporterTest::animatedGifOutOfOrder,
+              &StbImageImporterTest::animatedGifNoYFlip,
 
               &StbImageImporterTest::openTwice,
               &StbImageImporterTest::importTwice});
 
+    addInstancedTests({&StbImageImporterTest::decodeBatch},
+        Containers::arraySize(DecodeBatchData));
+
     #ifndef CORRADE_TARGET_EMSCRIPTEN
     addRepeatedTests({&StbImageImporterTest::multithreaded}, 100);
+
+    addTests({&StbImageImporterTest::importOnDifferentThread});
     #endif
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
@@ -147,6 +177,22 @@ void StbImageImporterTest::grayPng() {
     }), TestSuite::Compare::Container);
 }
 
+void StbImageImporterTest::grayPngNoYFlip() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StbImageImporter");
+    importer->configuration().setValue("yFlip", false);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(PNGIMPORTER_TEST_DIR, "gray.png")));
+
+    /* Same as grayPng(), but with the rows in the file order */
+    Containers::Optional<Trade::ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), Vector2i(3, 2));
+    CORRADE_COMPARE(image->format(), PixelFormat::R8Unorm);
+    CORRADE_COMPARE_AS(image->data(), Containers::arrayView<char>({
+        '\x88', '\x00', '\xff',
+        '\xff', '\x88', '\x00'
+    }), TestSuite::Compare::Container);
+}
+
 void StbImageImporterTest::grayJpeg() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StbImageImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Directory::join(JPEGIMPORTER_TEST_DIR, "gray.jpg")));
@@ -230,6 +276,24 @@ void StbImageImporterTest::rgbHdrInvalid() {
     CORRADE_COMPARE(out.str(), "Trade::StbImageImporter::image2D(): cannot open the image: unsupported format\n");
 }
 
+void StbImageImporterTest::defaultDeleter() {
+    Containers::Optional<Trade::ImageData2D> image;
+    {
+        Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StbImageImporter");
+        CORRADE_VERIFY(importer->openFile(Utility::Directory::join(STBIMAGEIMPORTER_TEST_DIR, "rgb.hdr")));
+        image = importer->image2D(0);
+        CORRADE_VERIFY(image);
+    }
+
+    /* The stb_image output is taken over directly instead of copied, but
+       with the default deleter so the data don't depend on the plugin code
+       anymore after the importer is destroyed */
+    Containers::Array<char> data = image->release();
+    CORRADE_VERIFY(!data.deleter());
+    CORRADE_COMPARE(data.size(), 2*3*3*4);
+    CORRADE_COMPARE(Containers::arrayCast<const Float>(data)[17], 6.0f);
+}
+
 void StbImageImporterTest::rgbaPng() {
     auto&& data = RgbaPngTestData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -291,6 +355,53 @@ void StbImageImporterTest::animatedGif() {
     }
 }
 
+void StbImageImporterTest::animatedGifNoYFlip() {
+    using namespace Math::Literals;
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StbImageImporter");
+    importer->configuration().setValue("yFlip", false);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(STBIMAGEIMPORTER_TEST_DIR, "dispose_bgnd.gif")));
+
+    /* Same pixels as in animatedGif(), but counted from the top. The second
+       import of the first frame comes from the cache. */
+    Containers::Optional<Trade::ImageData2D> image0 = importer->image2D(0);
+    Containers::Optional<Trade::ImageData2D> image1 = importer->image2D(1);
+    Containers::Optional<Trade::ImageData2D> image0Cached = importer->image2D(0);
+    CORRADE_VERIFY(image0);
+    CORRADE_VERIFY(image1);
+    CORRADE_VERIFY(image0Cached);
+    CORRADE_COMPARE(image0->pixels<Color4ub>()[100 - 88 - 1][30], 0x87ceeb_rgb);
+    CORRADE_COMPARE(image1->pixels<Color4ub>()[100 - 88 - 1][30], 0x0000ff_rgb);
+    CORRADE_COMPARE(image0Cached->pixels<Color4ub>()[100 - 88 - 1][30], 0x87ceeb_rgb);
+}
+
+void StbImageImporterTest::animatedGifOutOfOrder() {
+    /* Reference frames, decoded sequentially */
+    Containers::Pointer<AbstractImporter> reference = _manager.instantiate("StbImageImporter");
+    CORRADE_VERIFY(reference->openFile(Utility::Directory::join(STBIMAGEIMPORTER_TEST_DIR, "dispose_bgnd.gif")));
+    CORRADE_COMPARE(reference->image2DCount(), 5);
+    Containers::Optional<Trade::ImageData2D> expected[5];
+    for(UnsignedInt i = 0; i != 5; ++i) {
+        expected[i] = reference->image2D(i);
+        CORRADE_VERIFY(expected[i]);
+    }
+
+    /* With the cache disabled, going back has to decode the file from the
+       start again */
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StbImageImporter");
+    importer->configuration().setValue("gifCachedFrames", 0);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(STBIMAGEIMPORTER_TEST_DIR, "dispose_bgnd.gif")));
+    CORRADE_COMPARE(importer->image2DCount(), 5);
+    for(UnsignedInt i: {3, 1, 1, 4, 0}) {
+        CORRADE_ITERATION(i);
+        Containers::Optional<Trade::ImageData2D> image = importer->image2D(i);
+        CORRADE_VERIFY(image);
+        CORRADE_COMPARE(image->size(), expected[i]->size());
+        CORRADE_COMPARE_AS(image->data(), expected[i]->data(),
+            TestSuite::Compare::Container);
+    }
+}
+
 void StbImageImporterTest::openTwice() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StbImageImporter");
 
@@ -347,6 +458,96 @@ void StbImageImporterTest::multithreaded() {
 }
 #endif
 
+#ifndef CORRADE_TARGET_EMSCRIPTEN
+void StbImageImporterTest::importOnDifferentThread() {
+    #ifndef CORRADE_BUILD_MULTITHREADED
+    CORRADE_SKIP("CORRADE_BUILD_MULTITHREADED is not enabled.");
+    #endif
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StbImageImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(PNGIMPORTER_TEST_DIR, "gray.png")));
+
+    /* The thread-local stb_image settings have to be set up on the thread
+       that imports the image, not just on the one that opened it, otherwise
+       the image wouldn't be flipped */
+    Containers::Optional<Trade::ImageData2D> image;
+    std::thread thread{[&]() { image = importer->image2D(0); }};
+    thread.join();
+
+    CORRADE_VERIFY(image);
+    CORRADE_COMPARE(image->size(), Vector2i(3, 2));
+    CORRADE_COMPARE(image->format(), PixelFormat::R8Unorm);
+    CORRADE_COMPARE_AS(image->data(), Containers::arrayView<char>({
+        '\xff', '\x88', '\x00',
+        '\x88', '\x00', '\xff'
+    }), TestSuite::Compare::Container);
+}
+#endif
+
+void StbImageImporterTest::decodeBatch() {
+    auto&& data = DecodeBatchData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StbImageImporter");
+    importer->configuration().setValue("threads", data.threads);
+
+    const std::string filenames[]{
+        Utility::Directory::join(PNGIMPORTER_TEST_DIR, "gray.png"),
+        Utility::Directory::join(PNGIMPORTER_TEST_DIR, "rgba.png"),
+        Utility::Directory::join(JPEGIMPORTER_TEST_DIR, "rgb.jpg"),
+        Utility::Directory::join(STBIMAGEIMPORTER_TEST_DIR, "rgb.hdr"),
+        Utility::Directory::join(STBIMAGEIMPORTER_TEST_DIR, "dispose_bgnd.gif")
+    };
+    Containers::Array<char> files[Containers::arraySize(filenames)];
+    Containers::ArrayView<const char> views[Containers::arraySize(filenames) + 2];
+    for(std::size_t i = 0; i != Containers::arraySize(filenames); ++i) {
+        files[i] = Utility::Directory::read(filenames[i]);
+        CORRADE_VERIFY(files[i]);
+        views[i] = files[i];
+    }
+    /* The last two are invalid */
+    views[Containers::arraySize(filenames)] = Containers::arrayView("invalid").except(1);
+    views[Containers::arraySize(filenames) + 1] = {};
+
+    std::ostringstream out;
+    Containers::Array<Containers::Optional<Trade::ImageData2D>> images;
+    {
+        Error redirectError{&out};
+        images = static_cast<StbImageImporter&>(*importer).decodeBatch(views);
+    }
+    CORRADE_COMPARE(images.size(), 7);
+    CORRADE_VERIFY(!images[5]);
+    CORRADE_VERIFY(!images[6]);
+    /* The messages are printed only if the failure happened on this thread */
+    if(data.threads == 1) CORRADE_COMPARE(out.str(),
+        "Trade::StbImageImporter::decodeBatch(): cannot open the image: unknown image type\n"
+        "Trade::StbImageImporter::decodeBatch(): image 6 is empty\n");
+
+    /* Only the first frame of the GIF is decoded */
+    CORRADE_VERIFY(images[4]);
+    CORRADE_COMPARE(images[4]->size(), Vector2i(100, 100));
+    CORRADE_COMPARE(images[4]->format(), PixelFormat::RGBA8Unorm);
+    {
+        using namespace Math::Literals;
+        CORRADE_COMPARE(images[4]->pixels<Color4ub>()[88][30], 0x87ceeb_rgb);
+    }
+
+    /* Each image should be the same as if decoded separately */
+    for(std::size_t i = 0; i != 4; ++i) {
+        CORRADE_ITERATION(filenames[i]);
+        CORRADE_VERIFY(images[i]);
+
+        CORRADE_VERIFY(importer->openData(files[i]));
+        Containers::Optional<Trade::ImageData2D> expected = importer->image2D(0);
+        CORRADE_VERIFY(expected);
+        CORRADE_COMPARE(images[i]->size(), expected->size());
+        CORRADE_COMPARE(images[i]->format(), expected->format());
+        CORRADE_COMPARE(images[i]->storage().alignment(), expected->storage().alignment());
+        CORRADE_COMPARE_AS(images[i]->data(), expected->data(),
+            TestSuite::Compare::Container);
+    }
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Trade::Test::StbImageImporterTest)
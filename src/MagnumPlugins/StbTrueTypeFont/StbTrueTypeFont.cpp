@@ -27,12 +27,17 @@
 
 #include <algorithm>
 #include <Corrade/PluginManager/AbstractManager.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Unicode.h>
 #include <Magnum/Image.h>
 #include <Magnum/ImageView.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Text/AbstractGlyphCache.h>
 
+#include "MagnumPlugins/Implementation/glyphBatch.h"
+#include "MagnumPlugins/Implementation/glyphBlit.h"
+
 #define STB_TRUETYPE_IMPLEMENTATION
 #define STBTT_STATIC
 #ifdef _MSC_VER
@@ -58,20 +63,31 @@ struct StbTrueTypeFont::Font {
     Float scale;
 };
 
-class StbTrueTypeFont::Layouter: public AbstractLayouter {
+class StbTrueTypeFont::Layouter final: public AbstractLayouter {
     public:
-        explicit Layouter(Font& _font, const AbstractGlyphCache& cache, const Float fontSize, const Float textSize, std::vector<Int>&& glyphs);
+        explicit Layouter(Font& _font, const AbstractGlyphCache& cache, const Float fontSize, const Float textSize, Int oversampling, std::vector<Int>&& glyphs);
+
+        /* Non-virtual doRenderGlyph(), used by layoutBatch() */
+        std::tuple<Range2D, Range2D, Vector2> glyph(UnsignedInt i) const;
 
     private:
-        std::tuple<Range2D, Range2D, Vector2> doRenderGlyph(const UnsignedInt i) override;
+        std::tuple<Range2D, Range2D, Vector2> doRenderGlyph(const UnsignedInt i) override {
+            return glyph(i);
+        }
 
         Font& _font;
         const AbstractGlyphCache& _cache;
         const Float _fontSize, _textSize;
+        const Int _oversampling;
         const std::vector<Int> _glyphs;
 };
 
-StbTrueTypeFont::StbTrueTypeFont() = default;
+StbTrueTypeFont::StbTrueTypeFont() {
+    /** @todo horrible workaround, fix this properly */
+    configuration().setValue("oversampling", 1);
+    configuration().setValue("distanceField", false);
+    configuration().setValue("distanceFieldRadius", 8);
+}
 
 StbTrueTypeFont::StbTrueTypeFont(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractFont{manager, plugin} {}
 
@@ -146,42 +162,70 @@ void StbTrueTypeFont::doFillGlyphCache(AbstractGlyphCache& cache, const std::u32
     Containers::ArrayView<const int> glyphIndicesUnique{glyphIndices.begin(),
         std::size_t(std::unique(glyphIndices.begin(), glyphIndices.end()) - glyphIndices.begin())};
 
-    /* Properties of all glyphs to reserve the cache */
+    /* Glyphs are rendered this many times larger and the layouter scales them
+       back down */
+    const Int oversampling = Math::max(configuration().value<Int>("oversampling"), 1);
+    const Float scale = _font->scale*oversampling;
+    const bool distanceField = configuration().value<bool>("distanceField");
+    const Int radius = configuration().value<Int>("distanceFieldRadius");
+
+    /* Properties of all glyphs to reserve the cache. The bounding boxes are
+       with Y down. Prefiltering the oversampled glyph smears it over
+       oversampling - 1 more pixels to the right and down. Distance fields
+       have to be calculated already here as that's the only way to know
+       their size. */
     std::vector<Vector2i> glyphSizes;
+    std::vector<Range2Di> glyphBoxes;
+    Containers::Array<unsigned char*> distanceFields{Containers::ValueInit, distanceField ? glyphIndicesUnique.size() : 0};
     glyphSizes.reserve(glyphIndicesUnique.size());
-    for(Int c: glyphIndicesUnique) {
+    glyphBoxes.reserve(glyphIndicesUnique.size());
+    for(std::size_t i = 0; i != glyphIndicesUnique.size(); ++i) {
         Range2Di box;
-        stbtt_GetGlyphBitmapBox(&_font->info, c, _font->scale, _font->scale, &box.min().x(), &box.min().y(), &box.max().x(), &box.max().y());
+        if(distanceField) {
+            /* The edge is at 128, the radius maps to the full range */
+            Vector2i size;
+            distanceFields[i] = stbtt_GetGlyphSDF(&_font->info, scale, glyphIndicesUnique[i], radius, 128, 127.0f/radius, &size.x(), &size.y(), &box.min().x(), &box.min().y());
+            box = Range2Di::fromSize(box.min(), size);
+        } else {
+            stbtt_GetGlyphBitmapBox(&_font->info, glyphIndicesUnique[i], scale, scale, &box.min().x(), &box.min().y(), &box.max().x(), &box.max().y());
+            if(!box.size().isZero()) box.max() += Vector2i{oversampling - 1};
+        }
         glyphSizes.push_back(box.size());
+        glyphBoxes.push_back(box);
     }
 
     /* Create texture atlas */
     /** @todo use Containers::Array for this */
     const std::vector<Range2Di> glyphPositions = cache.reserve(glyphSizes);
 
-    /* Pixmap for a single glyph. We need to flip Y, so it can't be rendered
-       directly into the texture. What a pity. */
-    Range2Di maxBox;
-    stbtt_GetFontBoundingBox(&_font->info, &maxBox.min().x(), &maxBox.min().y(), &maxBox.max().x(), &maxBox.max().y());
-    Containers::Array<UnsignedByte> glyphPixmap{Containers::NoInit,
-        std::size_t(maxBox.size().product())};
-
     /* Render all characters to the atlas and create character map */
     Containers::Array<char> pixmap{Containers::ValueInit, std::size_t(cache.textureSize().product())};
+    const Int pitch = cache.textureSize().x();
     for(std::size_t i = 0; i != glyphPositions.size(); ++i) {
-        /* Render glyph */
-        Range2Di box;
-        stbtt_GetGlyphBitmapBox(&_font->info, glyphIndices[i], _font->scale, _font->scale, &box.min().x(), &box.min().y(), &box.max().x(), &box.max().y());
-        stbtt_MakeGlyphBitmap(&_font->info, glyphPixmap, maxBox.sizeX(), maxBox.sizeY(), maxBox.sizeX(), _font->scale, _font->scale, glyphIndices[i]);
-
-        /* Copy rendered bitmap to texture image */
-        for(Int yin = 0, yout = glyphPositions[i].bottom(), ymax = glyphSizes[i].y(); yin != ymax; ++yin, ++yout)
-            for(Int xin = 0, xout = glyphPositions[i].left(), xmax = glyphSizes[i].x(); xin != xmax; ++xin, ++xout)
-                pixmap[yout*cache.textureSize().x() + xout] = glyphPixmap[(glyphSizes[i].y() - yin - 1)*maxBox.sizeX() + xin];
+        /* stb_truetype outputs rows from top to bottom while the image has
+           them from bottom to top. The distance field gets copied with a
+           flip, the glyph bitmap is rendered directly into the atlas by
+           giving it a pointer to the top row of the glyph rectangle and a
+           negative stride. */
+        if(distanceField) {
+            if(glyphSizes[i].product())
+                Implementation::blitGlyphFlipped(distanceFields[i], glyphSizes[i].x(),
+                    glyphSizes[i],
+                    pixmap.data() + std::ptrdiff_t(glyphPositions[i].bottom())*pitch + glyphPositions[i].left(),
+                    pitch);
+            stbtt_FreeSDF(distanceFields[i], nullptr);
+        } else if(glyphSizes[i].product()) {
+            float subpixelX, subpixelY;
+            stbtt_MakeGlyphBitmapSubpixelPrefilter(&_font->info,
+                reinterpret_cast<unsigned char*>(pixmap.data()) + std::ptrdiff_t(glyphPositions[i].top() - 1)*pitch + glyphPositions[i].left(),
+                glyphSizes[i].x(), glyphSizes[i].y(), -pitch,
+                scale, scale, 0.0f, 0.0f, oversampling, oversampling,
+                &subpixelX, &subpixelY, glyphIndicesUnique[i]);
+        }
 
         /* Insert glyph parameters into cache */
-        cache.insert(glyphIndices[i],
-            Vector2i(box.min().x(), -box.max().y()),
+        cache.insert(glyphIndicesUnique[i],
+            Vector2i(glyphBoxes[i].min().x(), -glyphBoxes[i].max().y()),
                      glyphPositions[i]);
     }
 
@@ -191,6 +235,24 @@ void StbTrueTypeFont::doFillGlyphCache(AbstractGlyphCache& cache, const std::u32
 }
 
 Containers::Pointer<AbstractLayouter> StbTrueTypeFont::doLayout(const AbstractGlyphCache& cache, const Float size, const std::string& text) {
+    return layoutText(cache, size, text);
+}
+
+std::size_t StbTrueTypeFont::layoutBatch(const AbstractGlyphCache& cache, const Float size, const Containers::ArrayView<const std::string> texts, const Containers::ArrayView<const Vector2> origins, const Containers::StridedArrayView1D<Vector2>& positions, const Containers::StridedArrayView1D<Vector2>& textureCoordinates) {
+    CORRADE_ASSERT(isOpened(),
+        "Text::StbTrueTypeFont::layoutBatch(): no font opened", {});
+    CORRADE_ASSERT(texts.size() == origins.size(),
+        "Text::StbTrueTypeFont::layoutBatch(): expected" << texts.size() << "origins but got" << origins.size(), {});
+
+    std::vector<Containers::Pointer<Layouter>> layouters;
+    layouters.reserve(texts.size());
+    for(const std::string& text: texts)
+        layouters.push_back(layoutText(cache, size, text));
+
+    return Implementation::renderGlyphBatch(layouters, origins, positions, textureCoordinates);
+}
+
+Containers::Pointer<StbTrueTypeFont::Layouter> StbTrueTypeFont::layoutText(const AbstractGlyphCache& cache, const Float size, const std::string& text) {
     /* Get glyph codes from characters */
     std::vector<Int> glyphs;
     glyphs.reserve(text.size());
@@ -200,12 +262,12 @@ Containers::Pointer<AbstractLayouter> StbTrueTypeFont::doLayout(const AbstractGl
         glyphs.push_back(stbtt_FindGlyphIndex(&_font->info, codepoint));
     }
 
-    return Containers::pointer(new Layouter{*_font, cache, this->size(), size, std::move(glyphs)});
+    return Containers::pointer(new Layouter{*_font, cache, this->size(), size, Math::max(configuration().value<Int>("oversampling"), 1), std::move(glyphs)});
 }
 
-StbTrueTypeFont::Layouter::Layouter(Font& font, const AbstractGlyphCache& cache, const Float fontSize, const Float textSize, std::vector<Int>&& glyphs): AbstractLayouter(glyphs.size()), _font(font), _cache(cache), _fontSize{fontSize}, _textSize{textSize}, _glyphs{std::move(glyphs)} {}
+StbTrueTypeFont::Layouter::Layouter(Font& font, const AbstractGlyphCache& cache, const Float fontSize, const Float textSize, const Int oversampling, std::vector<Int>&& glyphs): AbstractLayouter(glyphs.size()), _font(font), _cache(cache), _fontSize{fontSize}, _textSize{textSize}, _oversampling{oversampling}, _glyphs{std::move(glyphs)} {}
 
-std::tuple<Range2D, Range2D, Vector2> StbTrueTypeFont::Layouter::doRenderGlyph(const UnsignedInt i) {
+std::tuple<Range2D, Range2D, Vector2> StbTrueTypeFont::Layouter::glyph(const UnsignedInt i) const {
     /* Position of the texture in the resulting glyph, texture coordinates */
     Vector2i position;
     Range2Di rectangle;
@@ -215,8 +277,8 @@ std::tuple<Range2D, Range2D, Vector2> StbTrueTypeFont::Layouter::doRenderGlyph(c
     const auto textureCoordinates = Range2D(rectangle).scaled(1.0f/Vector2(_cache.textureSize()));
 
     /* Quad rectangle, computed from texture rectangle, denormalized to
-       requested text size */
-    const auto quadRectangle = Range2D(Range2Di::fromSize(position, rectangle.size())).scaled(Vector2(_textSize/_fontSize));
+       requested text size. Oversampled glyphs are scaled back down. */
+    const auto quadRectangle = Range2D(Range2Di::fromSize(position, rectangle.size())).scaled(Vector2(_textSize/(_fontSize*_oversampling)));
 
     /* Glyph advance, denormalized to requested text size */
     Vector2i advance;
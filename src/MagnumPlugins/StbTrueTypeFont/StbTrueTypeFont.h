@@ -30,6 +30,7 @@
  */
 
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/StridedArrayView.h>
 #include <Corrade/Utility/VisibilityMacros.h>
 #include <Magnum/Text/AbstractFont.h>
 
@@ -116,6 +117,31 @@ target_link_libraries(your-app PRIVATE MagnumPlugins::StbTrueTypeFont)
 
 See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
 information.
+
+@section Text-StbTrueTypeFont-glyph-cache Glyph cache filling
+
+With the @cb{.ini} oversampling @ce
+@ref Text-StbTrueTypeFont-configuration "configuration option" set to a value
+larger than @cpp 1 @ce, glyphs are rendered into the cache that many times
+larger and prefiltered using @cpp stbtt_MakeGlyphBitmapSubpixelPrefilter() @ce.
+The layouter scales them back to the font size, so the option has to have the
+same value when filling the cache and when calling @ref layout().
+
+If the @cb{.ini} distanceField @ce option is enabled, a signed distance field
+is rendered into the cache instead, using @cpp stbtt_GetGlyphSDF() @ce, with
+the same meaning of the values as in @ref FreeTypeFont. See
+@ref Text-FreeTypeFont-glyph-cache-distance-field for more information. The
+field is calculated on the CPU, which makes it usable also on platforms where
+neither FreeType nor @ref DistanceFieldGlyphCache is available. It's also
+affected by the @cb{.ini} oversampling @ce option, which can be used to get
+a higher-quality field.
+
+@section Text-StbTrueTypeFont-configuration Plugin-specific configuration
+
+It's possible to tune various options through @ref configuration(). See below
+for all options and their default values:
+
+@snippet MagnumPlugins/StbTrueTypeFont/StbTrueTypeFont.conf config
 */
 class MAGNUM_STBTRUETYPEFONT_EXPORT StbTrueTypeFont: public AbstractFont {
     public:
@@ -127,6 +153,16 @@ class MAGNUM_STBTRUETYPEFONT_EXPORT StbTrueTypeFont: public AbstractFont {
 
         ~StbTrueTypeFont();
 
+        /**
+         * @brief Lay out multiple strings into a single vertex stream
+         * @m_since_latest_{plugins}
+         *
+         * Same as @ref FreeTypeFont::layoutBatch(), see its documentation for
+         * details. The function is virtual so it can be called on a
+         * dynamically loaded plugin without linking to it.
+         */
+        virtual std::size_t layoutBatch(const AbstractGlyphCache& cache, Float size, Containers::ArrayView<const std::string> texts, Containers::ArrayView<const Vector2> origins, const Containers::StridedArrayView1D<Vector2>& positions, const Containers::StridedArrayView1D<Vector2>& textureCoordinates);
+
     private:
         struct Font;
         class Layouter;
@@ -139,6 +175,7 @@ class MAGNUM_STBTRUETYPEFONT_EXPORT StbTrueTypeFont: public AbstractFont {
         MAGNUM_STBTRUETYPEFONT_LOCAL Vector2 doGlyphAdvance(UnsignedInt glyph) override;
         MAGNUM_STBTRUETYPEFONT_LOCAL void doFillGlyphCache(AbstractGlyphCache& cache, const std::u32string& characters) override;
         MAGNUM_STBTRUETYPEFONT_LOCAL Containers::Pointer<AbstractLayouter> doLayout(const AbstractGlyphCache& cache, Float size, const std::string& text) override;
+        MAGNUM_STBTRUETYPEFONT_LOCAL Containers::Pointer<Layouter> layoutText(const AbstractGlyphCache& cache, Float size, const std::string& text);
 
         Containers::Pointer<Font> _font;
 };
@@ -25,11 +25,16 @@
 
 #include <sstream>
 #include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Text/AbstractFont.h>
 #include <Magnum/Text/AbstractGlyphCache.h>
 
+#include "MagnumPlugins/StbTrueTypeFont/StbTrueTypeFont.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Text { namespace Test { namespace {
@@ -42,7 +47,10 @@ struct StbTrueTypeFontTest: TestSuite::Tester {
 
     void properties();
     void layout();
+    void layoutBatch();
     void fillGlyphCache();
+    void fillGlyphCacheOversampling();
+    void fillGlyphCacheDistanceField();
 
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractFont> _manager{"nonexistent"};
@@ -54,7 +62,10 @@ StbTrueTypeFontTest::StbTrueTypeFontTest() {
 
               &StbTrueTypeFontTest::properties,
               &StbTrueTypeFontTest::layout,
-              &StbTrueTypeFontTest::fillGlyphCache});
+              &StbTrueTypeFontTest::layoutBatch,
+              &StbTrueTypeFontTest::fillGlyphCache,
+              &StbTrueTypeFontTest::fillGlyphCacheOversampling,
+              &StbTrueTypeFontTest::fillGlyphCacheDistanceField});
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
@@ -191,6 +202,118 @@ void StbTrueTypeFontTest::fillGlyphCache() {
     /** @todo properly test contents */
 }
 
+void StbTrueTypeFontTest::fillGlyphCacheOversampling() {
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("StbTrueTypeFont");
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+    DummyGlyphCache cache{Vector2i{256}};
+    font->fillGlyphCache(cache, "W");
+
+    Containers::Pointer<AbstractFont> oversampledFont = _manager.instantiate("StbTrueTypeFont");
+    oversampledFont->configuration().setValue("oversampling", 3);
+    CORRADE_VERIFY(oversampledFont->openFile(TTF_FILE, 16.0f));
+    DummyGlyphCache oversampledCache{Vector2i{256}};
+    oversampledFont->fillGlyphCache(oversampledCache, "W");
+
+    /* The glyph is three times larger in the cache, plus two pixels the
+       prefilter smears it over. Rounding of the bounding box can add one
+       more. */
+    const Vector2i size = cache[font->glyphId(U'W')].second.size();
+    const Vector2i oversampledSize = oversampledCache[font->glyphId(U'W')].second.size();
+    CORRADE_COMPARE_AS(oversampledSize.x(), size.x()*3 - 3,
+        TestSuite::Compare::Greater);
+    CORRADE_COMPARE_AS(oversampledSize.x(), size.x()*3 + 3,
+        TestSuite::Compare::Less);
+    CORRADE_COMPARE_AS(oversampledSize.y(), size.y()*3 - 3,
+        TestSuite::Compare::Greater);
+    CORRADE_COMPARE_AS(oversampledSize.y(), size.y()*3 + 3,
+        TestSuite::Compare::Less);
+
+    /* But the layouter scales it back to roughly the same size */
+    Containers::Pointer<AbstractLayouter> layouter = font->layout(cache, 16.0f, "W");
+    Containers::Pointer<AbstractLayouter> oversampledLayouter = oversampledFont->layout(oversampledCache, 16.0f, "W");
+    CORRADE_VERIFY(layouter);
+    CORRADE_VERIFY(oversampledLayouter);
+    Vector2 cursorPosition;
+    Range2D rectangle, position, oversampledPosition;
+    position = layouter->renderGlyph(0, cursorPosition = {}, rectangle).first;
+    oversampledPosition = oversampledLayouter->renderGlyph(0, cursorPosition = {}, rectangle).first;
+    CORRADE_COMPARE_AS(Math::abs(oversampledPosition.sizeX() - position.sizeX()), 1.0f,
+        TestSuite::Compare::Less);
+    CORRADE_COMPARE_AS(Math::abs(oversampledPosition.sizeY() - position.sizeY()), 1.0f,
+        TestSuite::Compare::Less);
+}
+
+void StbTrueTypeFontTest::fillGlyphCacheDistanceField() {
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("StbTrueTypeFont");
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+    DummyGlyphCache cache{Vector2i{256}};
+    font->fillGlyphCache(cache, "l ");
+
+    Containers::Pointer<AbstractFont> distanceFieldFont = _manager.instantiate("StbTrueTypeFont");
+    distanceFieldFont->configuration().setValue("distanceField", true);
+    distanceFieldFont->configuration().setValue("distanceFieldRadius", 4);
+    CORRADE_VERIFY(distanceFieldFont->openFile(TTF_FILE, 16.0f));
+    DummyGlyphCache distanceFieldCache{Vector2i{256}};
+    distanceFieldFont->fillGlyphCache(distanceFieldCache, "l ");
+
+    /* The glyph is padded by the radius on each side */
+    const std::pair<Vector2i, Range2Di> glyph = cache[font->glyphId(U'l')];
+    const std::pair<Vector2i, Range2Di> distanceFieldGlyph = distanceFieldCache[font->glyphId(U'l')];
+    CORRADE_COMPARE(distanceFieldGlyph.first, glyph.first - Vector2i{4});
+    CORRADE_COMPARE(distanceFieldGlyph.second.size(), glyph.second.size() + Vector2i{8});
+
+    /* Empty glyphs stay empty */
+    CORRADE_COMPARE(distanceFieldCache[font->glyphId(U' ')].second.size(), Vector2i{});
+}
+
+void StbTrueTypeFontTest::layoutBatch() {
+    Containers::Pointer<AbstractFont> font = _manager.instantiate("StbTrueTypeFont");
+    CORRADE_VERIFY(font->openFile(TTF_FILE, 16.0f));
+
+    DummyGlyphCache cache{Vector2i{256}};
+    cache.insert(font->glyphId(U'W'), {25, 34}, {{0, 8}, {16, 128}});
+    cache.insert(font->glyphId(U'e'), {25, 12}, {{16, 4}, {64, 32}});
+
+    const std::string texts[]{"Wave", "eW"};
+    const Vector2 origins[]{{}, {10.0f, 20.0f}};
+
+    /* Querying the size with empty views writes nothing */
+    StbTrueTypeFont& batchFont = static_cast<StbTrueTypeFont&>(*font);
+    CORRADE_COMPARE(batchFont.layoutBatch(cache, 0.5f, texts, origins, {}, {}), 6);
+
+    struct Vertex {
+        Vector2 position;
+        Vector2 textureCoordinates;
+    } vertices[6*4];
+    const Containers::StridedArrayView1D<Vector2> positions{vertices, &vertices[0].position, Containers::arraySize(vertices), sizeof(Vertex)};
+    const Containers::StridedArrayView1D<Vector2> textureCoordinates{vertices, &vertices[0].textureCoordinates, Containers::arraySize(vertices), sizeof(Vertex)};
+    CORRADE_COMPARE(batchFont.layoutBatch(cache, 0.5f, texts, origins, positions, textureCoordinates), 6);
+
+    /* Should be the same as layouting each text separately */
+    std::size_t vertex = 0;
+    for(std::size_t i = 0; i != Containers::arraySize(texts); ++i) {
+        CORRADE_ITERATION(texts[i]);
+        Containers::Pointer<AbstractLayouter> layouter = font->layout(cache, 0.5f, texts[i]);
+        CORRADE_VERIFY(layouter);
+
+        Vector2 cursorPosition = origins[i];
+        Range2D rectangle, quadPosition, quadTextureCoordinates;
+        for(UnsignedInt j = 0; j != layouter->glyphCount(); ++j) {
+            std::tie(quadPosition, quadTextureCoordinates) = layouter->renderGlyph(j, cursorPosition, rectangle);
+            CORRADE_COMPARE(vertices[vertex + 0].position, quadPosition.topLeft());
+            CORRADE_COMPARE(vertices[vertex + 1].position, quadPosition.bottomLeft());
+            CORRADE_COMPARE(vertices[vertex + 2].position, quadPosition.topRight());
+            CORRADE_COMPARE(vertices[vertex + 3].position, quadPosition.bottomRight());
+            CORRADE_COMPARE(vertices[vertex + 0].textureCoordinates, quadTextureCoordinates.topLeft());
+            CORRADE_COMPARE(vertices[vertex + 1].textureCoordinates, quadTextureCoordinates.bottomLeft());
+            CORRADE_COMPARE(vertices[vertex + 2].textureCoordinates, quadTextureCoordinates.topRight());
+            CORRADE_COMPARE(vertices[vertex + 3].textureCoordinates, quadTextureCoordinates.bottomRight());
+            vertex += 4;
+        }
+    }
+    CORRADE_COMPARE(vertex, Containers::arraySize(vertices));
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Text::Test::StbTrueTypeFontTest)
@@ -27,76 +27,300 @@
 
 #include "StbVorbisImporter.h"
 
+#include <atomic>
+#include <thread>
+#include <Corrade/Containers/ScopeGuard.h>
+#include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Debug.h>
 #include <Corrade/Utility/Endianness.h>
+#include <Magnum/Math/Functions.h>
 
 #define STB_VORBIS_NO_STDIO 1
 #include "stb_vorbis.c"
 
+#include "MagnumPlugins/Implementation/audioConversion.h"
+
 namespace Magnum { namespace Audio {
 
-StbVorbisImporter::StbVorbisImporter() = default;
+namespace {
+
+BufferFormat formatFor(const Int numChannels, const char* const messagePrefix) {
+    /** @todo Floating-point formats */
+    if(numChannels == 1)
+        return BufferFormat::Mono16;
+    else if(numChannels == 2)
+        return BufferFormat::Stereo16;
+    else if(numChannels == 4)
+        return BufferFormat::Quad16;
+    else if(numChannels == 6)
+        return BufferFormat::Surround51Channel16;
+    else if(numChannels == 7)
+        return BufferFormat::Surround61Channel16;
+    else if(numChannels == 8)
+        return BufferFormat::Surround71Channel16;
+
+    Error() << messagePrefix << "unsupported channel count"
+            << numChannels << "with" << 16 << "bits per sample";
+    return BufferFormat{};
+}
+
+/* Calls given function with each index in [0, count), distributing them
+   among given count of threads, with the calling thread being one of them.
+   Each index is touched by exactly one thread, so no locking is needed as
+   long as the function writes only to data associated with the index. */
+template<class Function> void forEachParallel(const std::size_t count, const std::size_t threadCount, const Function& function) {
+    std::atomic<std::size_t> next{0};
+    auto work = [&]() {
+        std::size_t i;
+        while((i = next++) < count) function(i);
+    };
+
+    Containers::Array<std::thread> threads{threadCount ? threadCount - 1 : 0};
+    for(std::thread& thread: threads) thread = std::thread{work};
+    work();
+    for(std::thread& thread: threads) thread.join();
+}
+
+}
+
+struct StbVorbisImporter::Stream {
+    ~Stream() { stb_vorbis_close(handle); }
+
+    /* Copy of the file data, stb_vorbis reads from it on every read() */
+    Containers::Array<char> data;
+    stb_vorbis* handle;
+    Int channelCount;
+};
+
+StbVorbisImporter::StbVorbisImporter() {
+    /** @todo horrible workaround, fix this properly */
+    configuration().setValue("streaming", false);
+    configuration().setValue("threads", 1);
+    configuration().setValue("frequency", 0);
+    configuration().setValue("channelCount", 0);
+}
 
 StbVorbisImporter::StbVorbisImporter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImporter{manager, plugin} {}
 
+StbVorbisImporter::~StbVorbisImporter() = default;
+
 ImporterFeatures StbVorbisImporter::doFeatures() const { return ImporterFeature::OpenData; }
 
-bool StbVorbisImporter::doIsOpened() const { return _data; }
+bool StbVorbisImporter::doIsOpened() const { return _data || _stream; }
 
 void StbVorbisImporter::doOpenData(Containers::ArrayView<const char> data) {
-    Int numChannels, frequency;
-    Short* decodedData = nullptr;
-
-    Int samples = stb_vorbis_decode_memory(reinterpret_cast<const UnsignedByte*>(data.data()), data.size(), &numChannels, &frequency, &decodedData);
+    /* In streaming mode stb_vorbis keeps reading from the data after this
+       function exits, so it needs its own copy */
+    const bool streaming = configuration().value<bool>("streaming");
+    Containers::Array<char> dataCopy;
+    if(streaming) {
+        dataCopy = Containers::Array<char>{Containers::NoInit, data.size()};
+        Utility::copy(data, dataCopy);
+        data = dataCopy;
+    }
 
-    if(samples == -1) {
-        Error() << "Audio::StbVorbisImporter::openData(): the file signature is invalid";
-        return;
-    } else if (samples == -2) {
-        /* memory allocation failure */
-        Error() << "Audio::StbVorbisImporter::openData(): out of memory";
+    Int error;
+    stb_vorbis* const handle = stb_vorbis_open_memory(reinterpret_cast<const UnsignedByte*>(data.data()), data.size(), &error, nullptr);
+    if(!handle) {
+        if(error == VORBIS_outofmem)
+            Error() << "Audio::StbVorbisImporter::openData(): out of memory";
+        else
+            Error() << "Audio::StbVorbisImporter::openData(): the file signature is invalid";
         return;
     }
+    Containers::ScopeGuard stbVorbisClose{handle, stb_vorbis_close};
 
-    Containers::Array<char> tempData{reinterpret_cast<char*>(decodedData), size_t(samples*numChannels*2),
-        [](char* data, size_t) { std::free(data); }};
-    _frequency = frequency;
+    const stb_vorbis_info info = stb_vorbis_get_info(handle);
+    const BufferFormat format = formatFor(info.channels, "Audio::StbVorbisImporter::openData():");
+    if(format == BufferFormat{}) return;
 
-    /** @todo Floating-point formats */
-    if(numChannels == 1)
-        _format = BufferFormat::Mono16;
-    else if(numChannels == 2)
-        _format = BufferFormat::Stereo16;
-    else if(numChannels == 4)
-        _format = BufferFormat::Quad16;
-    else if(numChannels == 6)
-        _format = BufferFormat::Surround51Channel16;
-    else if(numChannels == 7)
-        _format = BufferFormat::Surround61Channel16;
-    else if(numChannels == 8)
-        _format = BufferFormat::Surround71Channel16;
-    else {
-        Error() << "Audio::StbVorbisImporter::openData(): unsupported channel count"
-                << numChannels << "with" << 16 << "bits per sample";
+    _frequency = info.sample_rate;
+    _format = format;
+
+    /* Keep the decoder open and decode only in read() */
+    if(streaming) {
+        Implementation::warnAudioConversionStreaming(configuration(), "Audio::StbVorbisImporter::openData():", _format, _frequency);
+        _stream.emplace();
+        _stream->data = std::move(dataCopy);
+        _stream->handle = handle;
+        _stream->channelCount = info.channels;
+        stbVorbisClose.release();
         return;
     }
 
-    _data = std::move(tempData);
+    /* Decode straight into the output, instead of letting
+       stb_vorbis_decode_memory() grow its own allocation and then copying it.
+       If the length can't be determined, fall back to growing the output. */
+    const std::size_t frameSize = info.channels*sizeof(Short);
+    Containers::Array<char> out{Containers::NoInit, stb_vorbis_stream_length_in_samples(handle)*frameSize};
+    std::size_t frames = 0;
+    for(;;) {
+        const std::size_t maxFrames = out.size()/frameSize - frames;
+        if(maxFrames) {
+            const std::size_t read = stb_vorbis_get_samples_short_interleaved(handle, info.channels, reinterpret_cast<Short*>(out.data()) + frames*info.channels, maxFrames*info.channels);
+            frames += read;
+            if(read < maxFrames) break;
+            continue;
+        }
+
+        /* The output is full, but the length might have been underestimated.
+           Decode into a temporary chunk and grow only if there's actually
+           something left. */
+        Short chunk[4096];
+        const std::size_t read = stb_vorbis_get_samples_short_interleaved(handle, info.channels, chunk, Containers::arraySize(chunk)/info.channels*info.channels);
+        if(!read) break;
+
+        Containers::Array<char> grown{Containers::NoInit, Math::max(out.size()*2, (frames + read)*frameSize)};
+        Utility::copy(out, grown.prefix(out.size()));
+        Utility::copy(Containers::arrayView(reinterpret_cast<const char*>(chunk), read*frameSize), grown.slice(out.size(), out.size() + read*frameSize));
+        out = std::move(grown);
+        frames += read;
+    }
+
+    /* Don't keep the unused part if the length estimate was wrong */
+    if(frames*frameSize != out.size()) {
+        Containers::Array<char> shrunk{Containers::NoInit, frames*frameSize};
+        Utility::copy(out.prefix(shrunk.size()), shrunk);
+        out = std::move(shrunk);
+    }
+
+    if(!Implementation::convertAudio(configuration(), "Audio::StbVorbisImporter::openData():", _format, _frequency, out))
+        return;
+
+    _data = std::move(out);
 }
 
-void StbVorbisImporter::doClose() { _data = nullptr; }
+void StbVorbisImporter::doClose() {
+    _data = Containers::NullOpt;
+    _stream = nullptr;
+}
 
 BufferFormat StbVorbisImporter::doFormat() const { return _format; }
 
 UnsignedInt StbVorbisImporter::doFrequency() const { return _frequency; }
 
 Containers::Array<char> StbVorbisImporter::doData() {
-    Containers::Array<char> copy(_data.size());
-    std::copy(_data.begin(), _data.end(), copy.begin());
+    if(_stream) {
+        Error() << "Audio::StbVorbisImporter::data(): the file is opened for streaming, use read() instead";
+        return nullptr;
+    }
+
+    Containers::Array<char> copy(_data->size());
+    std::copy(_data->begin(), _data->end(), copy.begin());
     return copy;
 }
 
+std::size_t StbVorbisImporter::read(const Containers::ArrayView<char> out) {
+    CORRADE_ASSERT(_stream,
+        "Audio::StbVorbisImporter::read(): no file opened for streaming", {});
+
+    /* The output is interleaved 16-bit, so stb_vorbis could write there
+       directly, but the output view might not be aligned. Only whole
+       frames. */
+    const std::size_t frameSize = _stream->channelCount*sizeof(Short);
+    const std::size_t maxFrames = out.size()/frameSize;
+    Short samples[4096];
+    const std::size_t chunkFrames = Containers::arraySize(samples)/_stream->channelCount;
+    std::size_t frames = 0;
+    while(frames < maxFrames) {
+        const std::size_t toRead = Math::min(maxFrames - frames, chunkFrames);
+        const std::size_t read = stb_vorbis_get_samples_short_interleaved(_stream->handle, _stream->channelCount, samples, toRead*_stream->channelCount);
+        Utility::copy(Containers::arrayView(reinterpret_cast<const char*>(samples), read*frameSize), out.slice(frames*frameSize, (frames + read)*frameSize));
+        frames += read;
+
+        /* End of the stream (or an error) */
+        if(read < toRead) break;
+    }
+
+    return frames*frameSize;
+}
+
+Containers::Array<char> StbVorbisImporter::releaseData() {
+    CORRADE_ASSERT(isOpened(),
+        "Audio::StbVorbisImporter::releaseData(): no file opened", {});
+
+    if(_stream) {
+        Error() << "Audio::StbVorbisImporter::releaseData(): the file is opened for streaming, use read() instead";
+        return nullptr;
+    }
+
+    Containers::Array<char> out = std::move(*_data);
+    close();
+    return out;
+}
+
+StbVorbisImporterBatch StbVorbisImporter::decodeBatch(const Containers::ArrayView<const Containers::ArrayView<const char>> files) {
+    std::size_t threadCount = configuration().value<std::size_t>("threads");
+    if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+    threadCount = Math::min(threadCount, files.size());
+
+    /* Get the format and length of each file first. The decoders are closed
+       right after and opened again for decoding -- parsing the headers is
+       cheap compared to the decoding and keeping thousands of decoders
+       alive in the meantime would need a lot of memory. */
+    Containers::Array<StbVorbisImporterSound> sounds{Containers::ValueInit, files.size()};
+    Containers::Array<std::size_t> frameCounts{Containers::ValueInit, files.size()};
+    Containers::Array<Int> channelCounts{Containers::ValueInit, files.size()};
+    forEachParallel(files.size(), threadCount, [&](const std::size_t i) {
+        Int error;
+        stb_vorbis* const handle = stb_vorbis_open_memory(reinterpret_cast<const UnsignedByte*>(files[i].data()), files[i].size(), &error, nullptr);
+        if(!handle) {
+            if(error == VORBIS_outofmem)
+                Error() << "Audio::StbVorbisImporter::decodeBatch(): out of memory";
+            else
+                Error() << "Audio::StbVorbisImporter::decodeBatch(): the file signature is invalid";
+            return;
+        }
+        Containers::ScopeGuard stbVorbisClose{handle, stb_vorbis_close};
+
+        const stb_vorbis_info info = stb_vorbis_get_info(handle);
+        sounds[i].format = formatFor(info.channels, "Audio::StbVorbisImporter::decodeBatch():");
+        sounds[i].frequency = info.sample_rate;
+        frameCounts[i] = stb_vorbis_stream_length_in_samples(handle);
+        channelCounts[i] = info.channels;
+    });
+
+    /* Lay out all files in a single allocation. Files that failed to open
+       get no space. Each offset is a multiple of the frame size, so the
+       samples are suitably aligned for decoding directly to them. */
+    Containers::Array<std::size_t> offsets{Containers::NoInit, files.size() + 1};
+    offsets[0] = 0;
+    for(std::size_t i = 0; i != files.size(); ++i)
+        offsets[i + 1] = offsets[i] + (sounds[i].format != BufferFormat{} ?
+            frameCounts[i]*channelCounts[i]*sizeof(Short) : 0);
+
+    StbVorbisImporterBatch out;
+    out.data = Containers::Array<char>{Containers::NoInit, offsets[files.size()]};
+    out.sounds = Containers::Array<Containers::Optional<StbVorbisImporterSound>>{files.size()};
+
+    forEachParallel(files.size(), threadCount, [&](const std::size_t i) {
+        if(sounds[i].format == BufferFormat{}) return;
+
+        stb_vorbis* const handle = stb_vorbis_open_memory(reinterpret_cast<const UnsignedByte*>(files[i].data()), files[i].size(), nullptr, nullptr);
+        CORRADE_INTERNAL_ASSERT(handle);
+        Containers::ScopeGuard stbVorbisClose{handle, stb_vorbis_close};
+
+        const Int channelCount = channelCounts[i];
+        const Containers::ArrayView<char> samples = out.data.slice(offsets[i], offsets[i + 1]);
+        const std::size_t frames = stb_vorbis_get_samples_short_interleaved(handle, channelCount, reinterpret_cast<Short*>(samples.data()), frameCounts[i]*channelCount);
+
+        /* If there's anything left, the length was underestimated and the
+           samples don't fit */
+        Short frame[8];
+        if(stb_vorbis_get_samples_short_interleaved(handle, channelCount, frame, channelCount)) {
+            Error() << "Audio::StbVorbisImporter::decodeBatch(): unexpected length of file" << i;
+            return;
+        }
+
+        sounds[i].data = samples.prefix(frames*channelCount*sizeof(Short));
+        out.sounds[i] = sounds[i];
+    });
+
+    return out;
+}
+
 }}
 
 CORRADE_PLUGIN_REGISTER(StbVorbisAudioImporter, Magnum::Audio::StbVorbisImporter,
@@ -28,10 +28,12 @@
 */
 
 /** @file
- * @brief Class @ref Magnum::Audio::StbVorbisImporter
+ * @brief Class @ref Magnum::Audio::StbVorbisImporter, struct @ref Magnum::Audio::StbVorbisImporterSound, @ref Magnum::Audio::StbVorbisImporterBatch
  */
 
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Magnum/Audio/AbstractImporter.h>
 
 #include "MagnumPlugins/StbVorbisAudioImporter/configure.h"
@@ -54,6 +56,43 @@
 
 namespace Magnum { namespace Audio {
 
+/**
+@brief Decoded Vorbis sound
+@m_since_latest_{plugins}
+
+Part of @ref StbVorbisImporterBatch.
+*/
+struct StbVorbisImporterSound {
+    /** @brief Format, same as @ref StbVorbisImporter::format() would return */
+    BufferFormat format;
+
+    /** @brief Frequency, same as @ref StbVorbisImporter::frequency() would return */
+    UnsignedInt frequency;
+
+    /** @brief Samples, a view into @ref StbVorbisImporterBatch::data */
+    Containers::ArrayView<char> data;
+};
+
+/**
+@brief Vorbis batch decoding result
+@m_since_latest_{plugins}
+
+Returned from @ref StbVorbisImporter::decodeBatch().
+*/
+struct StbVorbisImporterBatch {
+    /** @brief Data of all decoded sounds */
+    Containers::Array<char> data;
+
+    /**
+     * @brief Decoded sounds
+     *
+     * In the same order as the files passed to
+     * @ref StbVorbisImporter::decodeBatch(). Sounds that failed to decode are
+     * @ref Containers::NullOpt.
+     */
+    Containers::Array<Containers::Optional<StbVorbisImporterSound>> sounds;
+};
+
 /**
 @brief OGG audio importer plugin using stb_vorbis
 
@@ -115,6 +154,46 @@ target_link_libraries(your-app PRIVATE MagnumPlugins::StbVorbisAudioImporter)
 
 See @ref building-plugins, @ref cmake-plugins and @ref plugins for more
 information.
+
+@section Audio-StbVorbisImporter-streaming Streaming
+
+By default the whole file is decoded in @ref openData() / @ref openFile(). If
+the @cb{.ini} streaming @ce @ref Audio-StbVorbisImporter-configuration "configuration option"
+is enabled, only the header is parsed on opening and samples are decoded in
+chunks via @ref read() into a caller-provided buffer, in the same format as
+@ref data() would return. The file data are copied and kept for the whole time
+the file is opened. Calling @ref data() on a file opened for streaming prints
+a message to @ref Error and returns an empty array.
+
+@section Audio-StbVorbisImporter-batch Batch decoding
+
+Many files at once can be decoded with @ref decodeBatch(), without opening
+them one by one. All sounds are decoded directly into a single allocation,
+with the size of each determined from its headers first. If the
+@cb{.ini} threads @ce
+@ref Audio-StbVorbisImporter-configuration "configuration option" is set to a
+value other than @cpp 1 @ce, the files are decoded in parallel. In that case
+the application needs to link to `pthread` on Linux due to the same reasons as
+described in @ref Trade-BasisImageConverter-loading "BasisImageConverter docs".
+
+@section Audio-StbVorbisImporter-conversion Frequency and channel count conversion
+
+If the @cb{.ini} frequency @ce or @cb{.ini} channelCount @ce
+@ref Audio-StbVorbisImporter-configuration "configuration options" are set, the
+samples are converted right after decoding in @ref openData() /
+@ref openFile(), so @ref data() returns them already in the target format.
+Resampling uses a windowed-sinc polyphase filter, vectorized with SSE2 or NEON
+where available. Channels are mixed through a stereo downmix, with stereo going
+to the front left and right channels of multi-channel outputs. The output stays
+16-bit. The options don't affect @ref decodeBatch(). The options are ignored
+with a warning in streaming mode.
+
+@section Audio-StbVorbisImporter-configuration Plugin-specific configuration
+
+It's possible to tune various import options through @ref configuration(). See
+below for all options and their default values:
+
+@snippet MagnumPlugins/StbVorbisAudioImporter/StbVorbisAudioImporter.conf config
 */
 class MAGNUM_STBVORBISAUDIOIMPORTER_EXPORT StbVorbisImporter: public AbstractImporter {
     public:
@@ -124,7 +203,56 @@ class MAGNUM_STBVORBISAUDIOIMPORTER_EXPORT StbVorbisImporter: public AbstractImp
         /** @brief Plugin manager constructor */
         explicit StbVorbisImporter(PluginManager::AbstractManager& manager, const std::string& plugin);
 
+        ~StbVorbisImporter();
+
+        /**
+         * @brief Decode next chunk of samples
+         * @m_since_latest_{plugins}
+         *
+         * Expects that a file is opened with the @cb{.ini} streaming @ce
+         * @ref Audio-StbVorbisImporter-configuration "configuration option"
+         * enabled. Decodes as many whole sample frames as fit into @p out,
+         * in the same format as @ref data() would return, and returns the
+         * count of bytes written. If the returned value is less than the
+         * size of @p out rounded down to whole frames, the end of the stream
+         * was reached. See @ref Audio-StbVorbisImporter-streaming for more
+         * information.
+         */
+        virtual std::size_t read(Containers::ArrayView<char> out);
+
+        /**
+         * @brief Release the decoded data
+         * @m_since_latest_{plugins}
+         *
+         * Compared to @ref data(), which returns a copy, moves the decoded
+         * data out and closes the file, so there's never more than one copy
+         * of the samples alive. Expects that a file is opened. If the file is
+         * opened for streaming, prints a message to @ref Error and returns
+         * an empty array.
+         */
+        virtual Containers::Array<char> releaseData();
+
+        /**
+         * @brief Decode many files at once
+         * @m_since_latest_{plugins}
+         *
+         * Decodes each of @p files the same way as @ref data() would if it
+         * was opened, but puts all sounds into a single allocation and,
+         * based on the @cb{.ini} threads @ce
+         * @ref Audio-StbVorbisImporter-configuration "configuration option",
+         * decodes them on multiple threads. Doesn't need any file to be
+         * opened and doesn't affect the currently opened file. Files that
+         * fail to decode are @ref Containers::NullOpt in the output, with a
+         * message printed to @ref Error. Note that messages printed from
+         * other threads don't go through output redirection set up on the
+         * calling thread. See @ref Audio-StbVorbisImporter-batch for more
+         * information.
+         */
+        virtual StbVorbisImporterBatch decodeBatch(Containers::ArrayView<const Containers::ArrayView<const char>> files);
+
     private:
+        struct Stream;
+
         MAGNUM_STBVORBISAUDIOIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
         MAGNUM_STBVORBISAUDIOIMPORTER_LOCAL bool doIsOpened() const override;
         MAGNUM_STBVORBISAUDIOIMPORTER_LOCAL void doOpenData(Containers::ArrayView<const char> data) override;
@@ -134,9 +262,10 @@ class MAGNUM_STBVORBISAUDIOIMPORTER_EXPORT StbVorbisImporter: public AbstractImp
         MAGNUM_STBVORBISAUDIOIMPORTER_LOCAL UnsignedInt doFrequency() const override;
         MAGNUM_STBVORBISAUDIOIMPORTER_LOCAL Containers::Array<char> doData() override;
 
-        Containers::Array<char> _data;
+        Containers::Optional<Containers::Array<char>> _data;
         BufferFormat _format;
         UnsignedInt _frequency;
+        Containers::Pointer<Stream> _stream;
 };
 
 }}
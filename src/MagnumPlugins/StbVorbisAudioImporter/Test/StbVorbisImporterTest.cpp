@@ -29,9 +29,12 @@
 #include <Corrade/TestSuite/Compare/Container.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/Utility/DebugStl.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/Directory.h>
 #include <Magnum/Audio/AbstractImporter.h>
 
+#include "MagnumPlugins/StbVorbisAudioImporter/StbVorbisImporter.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Audio { namespace Test { namespace {
@@ -49,10 +52,38 @@ class StbVorbisImporterTest: public TestSuite::Tester {
         void mono16();
         void stereo8();
 
+        void streaming();
+        void streamingData();
+
+        void releaseData();
+
+        void decodeBatch();
+
+        void convert();
+
     /* Explicitly forbid system-wide plugin dependencies */
     PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
 };
 
+constexpr struct {
+    const char* name;
+    const char* filename;
+    std::size_t chunkSize;
+} StreamingData[]{
+    {"mono", "mono16.ogg", 1000},
+    {"stereo, chunk not a multiple of frame size", "stereo8.ogg", 4099},
+    {"stereo, chunk larger than the internal buffer", "stereo8.ogg", 65536}
+};
+
+constexpr struct {
+    const char* name;
+    UnsignedInt threads;
+} DecodeBatchData[]{
+    {"", 1},
+    {"four threads", 4},
+    {"all cores", 0}
+};
+
 StbVorbisImporterTest::StbVorbisImporterTest() {
     addTests({&StbVorbisImporterTest::empty,
               &StbVorbisImporterTest::wrongSignature,
@@ -63,6 +94,18 @@ StbVorbisImporterTest::StbVorbisImporterTest() {
               &StbVorbisImporterTest::mono16,
               &StbVorbisImporterTest::stereo8});
 
+    addInstancedTests({&StbVorbisImporterTest::streaming},
+        Containers::arraySize(StreamingData));
+
+    addTests({&StbVorbisImporterTest::streamingData,
+
+              &StbVorbisImporterTest::releaseData});
+
+    addInstancedTests({&StbVorbisImporterTest::decodeBatch},
+        Containers::arraySize(DecodeBatchData));
+
+    addTests({&StbVorbisImporterTest::convert});
+
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. */
     #ifdef STBVORBISAUDIOIMPORTER_PLUGIN_FILENAME
@@ -133,6 +176,126 @@ void StbVorbisImporterTest::stereo8() {
         TestSuite::Compare::Container);
 }
 
+void StbVorbisImporterTest::streaming() {
+    auto&& data = StreamingData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    /* Decode the whole file first to have something to compare to */
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StbVorbisAudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(STBVORBISAUDIOIMPORTER_TEST_DIR, data.filename)));
+    Containers::Array<char> expected = importer->data();
+
+    Containers::Pointer<AbstractImporter> streamingImporter = _manager.instantiate("StbVorbisAudioImporter");
+    streamingImporter->configuration().setValue("streaming", true);
+    CORRADE_VERIFY(streamingImporter->openFile(Utility::Directory::join(STBVORBISAUDIOIMPORTER_TEST_DIR, data.filename)));
+    CORRADE_COMPARE(streamingImporter->format(), importer->format());
+    CORRADE_COMPARE(streamingImporter->frequency(), importer->frequency());
+
+    Containers::Array<char> out{Containers::NoInit, expected.size() + data.chunkSize};
+    std::size_t size = 0;
+    while(size + data.chunkSize <= out.size()) {
+        const std::size_t read = static_cast<StbVorbisImporter&>(*streamingImporter).read(out.slice(size, size + data.chunkSize));
+        if(!read) break;
+        size += read;
+    }
+
+    CORRADE_COMPARE_AS(out.prefix(size), expected,
+        TestSuite::Compare::Container);
+}
+
+void StbVorbisImporterTest::streamingData() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StbVorbisAudioImporter");
+    importer->configuration().setValue("streaming", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(STBVORBISAUDIOIMPORTER_TEST_DIR, "mono16.ogg")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(importer->data().empty());
+    CORRADE_COMPARE(out.str(), "Audio::StbVorbisImporter::data(): the file is opened for streaming, use read() instead\n");
+}
+
+void StbVorbisImporterTest::releaseData() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StbVorbisAudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(STBVORBISAUDIOIMPORTER_TEST_DIR, "stereo8.ogg")));
+
+    Containers::Array<char> expected = importer->data();
+    Containers::Array<char> data = static_cast<StbVorbisImporter&>(*importer).releaseData();
+    CORRADE_COMPARE_AS(data, expected,
+        TestSuite::Compare::Container);
+
+    /* The file gets closed after */
+    CORRADE_VERIFY(!importer->isOpened());
+}
+
+void StbVorbisImporterTest::decodeBatch() {
+    auto&& data = DecodeBatchData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StbVorbisAudioImporter");
+    importer->configuration().setValue("threads", data.threads);
+
+    const char* filenames[]{"mono16.ogg", "stereo8.ogg", "zeroSamples.ogg",
+        "mono16.ogg"};
+    Containers::Array<char> files[Containers::arraySize(filenames)];
+    Containers::ArrayView<const char> views[Containers::arraySize(filenames) + 1];
+    for(std::size_t i = 0; i != Containers::arraySize(filenames); ++i) {
+        files[i] = Utility::Directory::read(Utility::Directory::join(STBVORBISAUDIOIMPORTER_TEST_DIR, filenames[i]));
+        CORRADE_VERIFY(files[i]);
+        views[i] = files[i];
+    }
+    /* The last one is invalid */
+    views[Containers::arraySize(filenames)] = Containers::arrayView("invalid").except(1);
+
+    std::ostringstream out;
+    StbVorbisImporterBatch batch;
+    {
+        Error redirectError{&out};
+        batch = static_cast<StbVorbisImporter&>(*importer).decodeBatch(views);
+    }
+    CORRADE_COMPARE(batch.sounds.size(), 5);
+    CORRADE_VERIFY(!batch.sounds[4]);
+    /* The message is printed only if the failure happened on this thread */
+    if(data.threads == 1)
+        CORRADE_COMPARE(out.str(), "Audio::StbVorbisImporter::decodeBatch(): the file signature is invalid\n");
+
+    /* Each sound should be the same as if decoded separately */
+    std::size_t size = 0;
+    for(std::size_t i = 0; i != Containers::arraySize(filenames); ++i) {
+        CORRADE_ITERATION(filenames[i]);
+        CORRADE_VERIFY(batch.sounds[i]);
+        CORRADE_VERIFY(batch.sounds[i]->data.begin() >= batch.data.begin());
+        CORRADE_VERIFY(batch.sounds[i]->data.end() <= batch.data.end());
+
+        CORRADE_VERIFY(importer->openData(files[i]));
+        CORRADE_COMPARE(batch.sounds[i]->format, importer->format());
+        CORRADE_COMPARE(batch.sounds[i]->frequency, importer->frequency());
+        CORRADE_COMPARE_AS(batch.sounds[i]->data, importer->data(),
+            TestSuite::Compare::Container<Containers::ArrayView<const char>>);
+        size += batch.sounds[i]->data.size();
+    }
+
+    /* All sounds are in a single allocation */
+    CORRADE_COMPARE(batch.data.size(), size);
+}
+
+void StbVorbisImporterTest::convert() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StbVorbisAudioImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(STBVORBISAUDIOIMPORTER_TEST_DIR, "stereo8.ogg")));
+    CORRADE_COMPARE(importer->format(), BufferFormat::Stereo16);
+    const UnsignedInt frequency = importer->frequency();
+    const std::size_t frameCount = importer->data().size()/(2*2);
+
+    /* The conversion itself is tested in DrWavAudioImporter, here it's just
+       about the options being propagated */
+    importer->configuration().setValue("frequency", frequency*2);
+    importer->configuration().setValue("channelCount", 1);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(STBVORBISAUDIOIMPORTER_TEST_DIR, "stereo8.ogg")));
+    CORRADE_COMPARE(importer->format(), BufferFormat::Mono16);
+    CORRADE_COMPARE(importer->frequency(), frequency*2);
+    /* Twice the frames, each having one channel of 16-bit samples */
+    CORRADE_COMPARE(importer->data().size(), frameCount*2*1*2);
+}
+
 }}}}
 
 CORRADE_TEST_MAIN(Magnum::Audio::Test::StbVorbisImporterTest)
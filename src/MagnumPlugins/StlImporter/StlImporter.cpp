@@ -25,7 +25,9 @@
 
 #include "StlImporter.h"
 
+#include <cstdlib>
 #include <cstring>
+#include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
@@ -33,12 +35,40 @@
 #include <Corrade/Utility/Directory.h>
 #include <Corrade/Utility/Endianness.h>
 #include <Corrade/Utility/EndiannessBatch.h>
+#include <Magnum/Math/Constants.h>
 #include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Vector3.h>
 #include <Magnum/Trade/MeshData.h>
 
 namespace Magnum { namespace Trade {
 
+#if defined(CORRADE_TARGET_UNIX) || (defined(CORRADE_TARGET_WINDOWS) && !defined(CORRADE_TARGET_WINDOWS_RT))
+#define _STLIMPORTER_USE_MAP
+#endif
+
+struct StlImporter::State {
+    /* Either a copy of the data passed to openData(), a binary conversion of
+       an ASCII file or a memory-mapped file passed to openFile(). The import
+       only ever looks at the `in` view, which points to one of these. */
+    Containers::Array<char> data;
+    #ifdef _STLIMPORTER_USE_MAP
+    Containers::Array<const char, Utility::Directory::MapDeleter> mappedData;
+    #endif
+    Containers::ArrayView<const char> in;
+    bool ascii{};
+
+    /* Binary files have just one solid spanning all triangles, ASCII files
+       can have more, each imported as a separate mesh */
+    struct Solid {
+        std::string name;
+        std::size_t triangleOffset;
+        std::size_t triangleCount;
+        /* Filled on every mesh import if statistics are enabled */
+        StlImporterStatistics statistics;
+    };
+    Containers::Array<Solid> solids;
+};
+
 StlImporter::StlImporter() = default;
 
 StlImporter::StlImporter(PluginManager::AbstractManager& manager, const std::string& plugin): AbstractImporter{manager, plugin} {}
@@ -47,9 +77,9 @@ StlImporter::~StlImporter() = default;
 
 ImporterFeatures StlImporter::doFeatures() const { return ImporterFeature::OpenData; }
 
-bool StlImporter::doIsOpened() const { return !!_in; }
+bool StlImporter::doIsOpened() const { return !!_state; }
 
-void StlImporter::doClose() { _in = Containers::NullOpt; }
+void StlImporter::doClose() { _state = nullptr; }
 
 void StlImporter::doOpenFile(const std::string& filename) {
     if(!Utility::Directory::exists(filename)) {
@@ -57,22 +87,212 @@ void StlImporter::doOpenFile(const std::string& filename) {
         return;
     }
 
-    openDataInternal(Utility::Directory::read(filename));
+    /* Map the file instead of reading it to avoid having the whole file
+       copied in memory. The mapping is moved to the state only if the
+       parsing succeeded, moving it doesn't change the data pointer so the
+       view saved in the state stays valid. ASCII files are converted during
+       the open, so the original data don't need to be kept in that case. */
+    #ifdef _STLIMPORTER_USE_MAP
+    Containers::Array<const char, Utility::Directory::MapDeleter> data = Utility::Directory::mapRead(filename);
+    openDataInternal(data);
+    if(_state && !_state->ascii) _state->mappedData = std::move(data);
+    #else
+    Containers::Array<char> data = Utility::Directory::read(filename);
+    openDataInternal(data);
+    if(_state && !_state->ascii) _state->data = std::move(data);
+    #endif
 }
 
 void StlImporter::doOpenData(Containers::ArrayView<const char> data) {
-    Containers::Array<char> copy{Containers::NoInit, data.size()};
-    Utility::copy(data, copy);
-    openDataInternal(std::move(copy));
+    /* The data are guaranteed to be valid only during this call, so parse
+       them directly and make a copy only if needed */
+    openDataInternal(data);
+    if(_state && !_state->ascii) {
+        _state->data = Containers::Array<char>{Containers::NoInit, data.size()};
+        Utility::copy(data, _state->data);
+        _state->in = _state->data;
+    }
 }
 
 namespace {
     /* In the input file, the triangle is represented by 12 floats (3D normal
        followed by three 3D vertices) and 2 extra bytes. */
     constexpr std::ptrdiff_t InputTriangleStride = 12*4 + 2;
+
+    inline bool isWhitespace(const char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    /* Returns next whitespace-delimited token, advancing pos past it. Empty
+       if there's no more data. */
+    Containers::ArrayView<const char> nextToken(const char*& pos, const char* const end) {
+        while(pos != end && isWhitespace(*pos)) ++pos;
+        const char* const begin = pos;
+        while(pos != end && !isWhitespace(*pos)) ++pos;
+        return {begin, std::size_t(pos - begin)};
+    }
+
+    inline bool tokenEquals(const Containers::ArrayView<const char> token, const char* const string) {
+        const std::size_t size = std::strlen(string);
+        return token.size() == size && std::memcmp(token.data(), string, size) == 0;
+    }
+
+    /* Powers of ten that are exactly representable in a double */
+    constexpr Double ExactPowersOfTen[]{
+        1.0e0, 1.0e1, 1.0e2, 1.0e3, 1.0e4, 1.0e5, 1.0e6, 1.0e7, 1.0e8, 1.0e9,
+        1.0e10, 1.0e11, 1.0e12, 1.0e13, 1.0e14, 1.0e15, 1.0e16, 1.0e17, 1.0e18,
+        1.0e19, 1.0e20, 1.0e21, 1.0e22
+    };
+
+    /* Parses a float token. The common case of at most 19 significant digits
+       and a small exponent is done directly with a single multiplication or
+       division of exactly representable values, which gives a correctly
+       rounded result without any allocation or locale lookup. The rest goes
+       through std::strtod(). */
+    bool parseFloat(const Containers::ArrayView<const char> token, Float& out) {
+        if(token.empty()) return false;
+
+        const char* i = token.begin();
+        const char* const end = token.end();
+        const bool negative = *i == '-';
+        if(*i == '-' || *i == '+') ++i;
+
+        UnsignedLong mantissa = 0;
+        Int exponent = 0;
+        Int significantDigits = 0;
+        bool anyDigits = false;
+        for(; i != end && *i >= '0' && *i <= '9'; ++i) {
+            mantissa = mantissa*10 + (*i - '0');
+            if(mantissa) ++significantDigits;
+            anyDigits = true;
+        }
+        if(i != end && *i == '.') for(++i; i != end && *i >= '0' && *i <= '9'; ++i) {
+            mantissa = mantissa*10 + (*i - '0');
+            if(mantissa) ++significantDigits;
+            --exponent;
+            anyDigits = true;
+        }
+        if(anyDigits && i != end && (*i == 'e' || *i == 'E')) {
+            ++i;
+            const bool negativeExponent = i != end && *i == '-';
+            if(i != end && (*i == '-' || *i == '+')) ++i;
+            Int value = 0;
+            bool anyExponentDigits = false;
+            for(; i != end && *i >= '0' && *i <= '9'; ++i) {
+                if(value < 100000) value = value*10 + (*i - '0');
+                anyExponentDigits = true;
+            }
+            if(!anyExponentDigits) return false;
+            exponent += negativeExponent ? -value : value;
+        }
+
+        if(anyDigits && i == end && significantDigits <= 19 && mantissa < (1ull << 53) && exponent >= -22 && exponent <= 22) {
+            Double value = Double(mantissa);
+            if(exponent < 0) value /= ExactPowersOfTen[-exponent];
+            else value *= ExactPowersOfTen[exponent];
+            out = Float(negative ? -value : value);
+            return true;
+        }
+
+        /* Slow path. The input isn't null-terminated, so copy the token to a
+           local buffer first. */
+        char buffer[128];
+        if(token.size() >= sizeof(buffer)) return false;
+        std::memcpy(buffer, token.data(), token.size());
+        buffer[token.size()] = '\0';
+        char* parsedEnd;
+        out = Float(std::strtod(buffer, &parsedEnd));
+        return parsedEnd == buffer + token.size();
+    }
+
+    /* Loads a Little-Endian vector from a possibly unaligned location */
+    inline Vector3 loadVector(const void* const data) {
+        Vector3 out;
+        std::memcpy(&out, data, sizeof(Vector3));
+        for(std::size_t i = 0; i != 3; ++i)
+            out[i] = Utility::Endianness::littleEndian(out[i]);
+        return out;
+    }
+
+    /* Bounds, area and volume, accumulated triangle by triangle. The volume
+       is a sum of signed volumes of tetrahedra formed by each triangle and
+       the origin, area and volume are accumulated in doubles to not lose
+       precision on large meshes. */
+    struct StatisticsAccumulator {
+        void add(const Vector3& a, const Vector3& b, const Vector3& c) {
+            min = Math::min(min, Math::min(a, Math::min(b, c)));
+            max = Math::max(max, Math::max(a, Math::max(b, c)));
+            const Vector3 cross = Math::cross(b - a, c - a);
+            area += Double(cross.length());
+            volume += Double(Math::dot(a, Math::cross(b, c)));
+        }
+
+        StlImporterStatistics result() const {
+            StlImporterStatistics out;
+            /* Stays at default (zero) for empty meshes */
+            if((min <= max).all()) out.bounds = {min, max};
+            out.area = Float(area*0.5);
+            out.volume = Float(volume/6.0);
+            return out;
+        }
+
+        Vector3 min{Constants::inf()};
+        Vector3 max{-Constants::inf()};
+        Double area{}, volume{};
+    };
+
+    /* Hash of a vertex consisting of 32-bit floats */
+    inline UnsignedInt hashVertex(const char* const data, const std::size_t size) {
+        UnsignedInt hash = 0x811c9dc5u;
+        for(std::size_t i = 0; i < size; i += 4) {
+            UnsignedInt word;
+            std::memcpy(&word, data + i, 4);
+            hash = (hash ^ word)*0x9e3779b1u;
+            hash ^= hash >> 15;
+        }
+        return hash;
+    }
+
+    /* Removes duplicate vertices in place, returning the unique vertex count
+       and filling the index array. Uses an open-addressing hash table with
+       linear probing that stores just indices of the unique vertices, which
+       are compared bitwise. */
+    std::size_t deduplicateInPlace(const Containers::ArrayView<char> vertexData, const std::size_t stride, const Containers::ArrayView<UnsignedInt> indices) {
+        const std::size_t vertexCount = indices.size();
+        std::size_t tableSize = 16;
+        while(tableSize < 2*vertexCount) tableSize *= 2;
+        Containers::Array<UnsignedInt> table{Containers::NoInit, tableSize};
+        for(UnsignedInt& i: table) i = ~UnsignedInt{};
+
+        std::size_t uniqueCount = 0;
+        for(std::size_t i = 0; i != vertexCount; ++i) {
+            const char* const vertex = vertexData + i*stride;
+            std::size_t slot = hashVertex(vertex, stride) & (tableSize - 1);
+            for(;;) {
+                const UnsignedInt unique = table[slot];
+                /* An empty slot, it's a new vertex. Move it right after the
+                   other unique vertices. */
+                if(unique == ~UnsignedInt{}) {
+                    if(uniqueCount != i)
+                        std::memcpy(vertexData + uniqueCount*stride, vertex, stride);
+                    table[slot] = indices[i] = uniqueCount++;
+                    break;
+                }
+
+                if(std::memcmp(vertexData + unique*stride, vertex, stride) == 0) {
+                    indices[i] = unique;
+                    break;
+                }
+
+                slot = (slot + 1) & (tableSize - 1);
+            }
+        }
+
+        return uniqueCount;
+    }
 }
 
-void StlImporter::openDataInternal(Containers::Array<char>&& data) {
+void StlImporter::openDataInternal(const Containers::ArrayView<const char> data) {
     /* At this point we can't even check if it's an ASCII or binary file, bail
        out */
     if(data.size() < 5) {
@@ -80,8 +300,15 @@ void StlImporter::openDataInternal(Containers::Array<char>&& data) {
         return;
     }
 
-    if(std::memcmp(data, "solid", 5) == 0) {
-        Error{} << "Trade::StlImporter::openData(): ASCII STL files are not supported, sorry";
+    /* ASCII files start with "solid", but some binary files do as well, so
+       treat the file as ASCII only if its size doesn't match the triangle
+       count in the binary header */
+    if(std::memcmp(data, "solid", 5) == 0 && (data.size() < 84 || data.size() != 84 + std::size_t(InputTriangleStride)*Utility::Endianness::littleEndian(*reinterpret_cast<const UnsignedInt*>(data + 80)))) {
+        auto state = Containers::pointer<State>();
+        if(!convertAscii(data, *state)) return;
+        state->ascii = true;
+        state->in = state->data;
+        _state = std::move(state);
         return;
     }
 
@@ -97,25 +324,191 @@ void StlImporter::openDataInternal(Containers::Array<char>&& data) {
         return;
     }
 
-    _in = std::move(data);
+    /* The data view is set by the caller, as it's either copied or the
+       memory-mapped file is kept */
+    _state = Containers::pointer<State>();
+    _state->in = data;
+    arrayAppend(_state->solids, Containers::InPlaceInit, std::string{}, std::size_t{0}, std::size_t{triangleCount});
 }
 
-UnsignedInt StlImporter::doMeshCount() const { return 1; }
+bool StlImporter::convertAscii(const Containers::ArrayView<const char> data, State& state) {
+    /* Convert to the same layout as a binary file would have, so doMesh()
+       can treat both the same. The header is left empty and the triangle
+       count filled at the end. */
+    Containers::Array<char> out;
+    arrayResize(out, Containers::NoInit, 84);
+    std::memset(out, 0, 84);
+
+    const char* pos = data.begin();
+    const char* const end = data.end();
+    UnsignedInt triangleCount = 0;
+
+    /* Skip the rest of the line, used for the endsolid name */
+    const auto skipLine = [&]() {
+        while(pos != end && *pos != '\n') ++pos;
+    };
+
+    /* Solid name, which can contain spaces. Leading and trailing whitespace
+       is stripped. */
+    const auto parseSolid = [&]() {
+        while(pos != end && *pos != '\n' && isWhitespace(*pos)) ++pos;
+        const char* const nameBegin = pos;
+        skipLine();
+        const char* nameEnd = pos;
+        while(nameEnd != nameBegin && isWhitespace(nameEnd[-1])) --nameEnd;
+        arrayAppend(state.solids, Containers::InPlaceInit, std::string{nameBegin, nameEnd}, std::size_t(triangleCount), std::size_t{0});
+    };
+
+    const auto expect = [&](const char* const expected) {
+        const Containers::ArrayView<const char> token = nextToken(pos, end);
+        if(tokenEquals(token, expected)) return true;
+        Error{} << "Trade::StlImporter::openData(): invalid ASCII STL file, expected" << expected << "but got" << std::string{token.begin(), token.end()};
+        return false;
+    };
+
+    const auto parseVector = [&](char* const dst) {
+        for(std::size_t i = 0; i != 3; ++i) {
+            const Containers::ArrayView<const char> token = nextToken(pos, end);
+            Float value;
+            if(!parseFloat(token, value)) {
+                Error{} << "Trade::StlImporter::openData(): invalid ASCII STL file, expected a number but got" << std::string{token.begin(), token.end()};
+                return false;
+            }
+            /* Stored as Little-Endian, same as in binary files */
+            Utility::Endianness::littleEndianInPlace(value);
+            std::memcpy(dst + i*4, &value, 4);
+        }
+        return true;
+    };
+
+    if(!expect("solid")) return false;
+    parseSolid();
+
+    for(;;) {
+        const Containers::ArrayView<const char> token = nextToken(pos, end);
+
+        /* End of a solid, skip its name. If there's another solid after,
+           continue with it. */
+        if(tokenEquals(token, "endsolid")) {
+            skipLine();
+            State::Solid& solid = state.solids[state.solids.size() - 1];
+            solid.triangleCount = triangleCount - solid.triangleOffset;
+
+            const char* const solidBegin = pos;
+            const Containers::ArrayView<const char> next = nextToken(pos, end);
+            if(next.empty()) break;
+            if(!tokenEquals(next, "solid")) {
+                pos = solidBegin;
+                if(!expect("solid")) return false;
+            }
+            parseSolid();
+            continue;
+        }
+
+        if(!tokenEquals(token, "facet")) {
+            Error{} << "Trade::StlImporter::openData(): invalid ASCII STL file, expected facet or endsolid but got" << std::string{token.begin(), token.end()};
+            return false;
+        }
+
+        char* const triangle = arrayAppend(out, Containers::NoInit, InputTriangleStride).begin();
+        if(!expect("normal") || !parseVector(triangle) ||
+           !expect("outer") || !expect("loop"))
+            return false;
+        for(std::size_t i = 0; i != 3; ++i)
+            if(!expect("vertex") || !parseVector(triangle + 12 + i*12))
+                return false;
+        if(!expect("endloop") || !expect("endfacet"))
+            return false;
+
+        /* Attribute byte count, unused */
+        triangle[48] = triangle[49] = 0;
+        ++triangleCount;
+    }
+
+    Utility::Endianness::littleEndianInPlace(triangleCount);
+    std::memcpy(out + 80, &triangleCount, 4);
+
+    /* Convert to a default deleter so the array can be stored */
+    state.data = Containers::Array<char>{Containers::NoInit, out.size()};
+    Utility::copy(out, state.data);
+    return true;
+}
+
+UnsignedInt StlImporter::doMeshCount() const { return _state->solids.size(); }
+
+Int StlImporter::doMeshForName(const std::string& name) {
+    for(std::size_t i = 0; i != _state->solids.size(); ++i)
+        if(_state->solids[i].name == name) return i;
+    return -1;
+}
+
+std::string StlImporter::doMeshName(const UnsignedInt id) {
+    return _state->solids[id].name;
+}
 
 UnsignedInt StlImporter::doMeshLevelCount(UnsignedInt) {
-    return configuration().value<bool>("perFaceToPerVertex") ? 1 : 2;
+    return configuration().value<bool>("perFaceToPerVertex") && !configuration().value<bool>("zeroCopy") ? 1 : 2;
 }
 
-Containers::Optional<MeshData> StlImporter::doMesh(UnsignedInt, UnsignedInt level) {
+Containers::Optional<MeshData> StlImporter::doMesh(const UnsignedInt id, const UnsignedInt level) {
+    State::Solid& solid = _state->solids[id];
+    const bool statistics = configuration().value<bool>("statistics");
+    const std::size_t triangleCount = solid.triangleCount;
+    Containers::ArrayView<const char> in = _state->in.suffix(84).slice(
+        solid.triangleOffset*InputTriangleStride,
+        (solid.triangleOffset + triangleCount)*InputTriangleStride);
+
+    /* With zero copy, the second level references the triangles directly
+       with their original 50-byte stride -- the normal and the three corner
+       positions are separate attributes. Big-Endian systems need a swapped
+       copy, but with the layout kept the same. */
+    /* Positions aren't copied for the second level, so the statistics are
+       the only pass over them. For the first level they're calculated in the
+       same loop that copies the positions, below. */
+    if(level == 1 && statistics) {
+        StatisticsAccumulator accumulator;
+        for(std::size_t i = 0; i != triangleCount; ++i) {
+            const char* const triangle = in.data() + i*InputTriangleStride;
+            accumulator.add(loadVector(triangle + 12), loadVector(triangle + 24), loadVector(triangle + 36));
+        }
+        solid.statistics = accumulator.result();
+    }
+
+    if(level == 1 && configuration().value<bool>("zeroCopy")) {
+        #ifdef CORRADE_TARGET_BIG_ENDIAN
+        Containers::Array<char> vertexData{Containers::NoInit, in.size()};
+        Utility::copy(in, vertexData);
+        for(Containers::StridedArrayView1D<Float> triangle: Containers::StridedArrayView2D<Float>{vertexData, reinterpret_cast<Float*>(vertexData.data()), {triangleCount, 12}, {InputTriangleStride, 4}})
+            Utility::Endianness::littleEndianInPlace(triangle);
+        const Containers::ArrayView<const char> triangles = vertexData;
+        #else
+        const Containers::ArrayView<const char> triangles = in;
+        #endif
+
+        Containers::Array<MeshAttributeData> attributeData{4};
+        attributeData[0] = MeshAttributeData{MeshAttribute::Normal,
+            Containers::StridedArrayView1D<const Vector3>{triangles,
+                reinterpret_cast<const Vector3*>(triangles.data()),
+                triangleCount, InputTriangleStride}};
+        for(std::size_t i = 0; i != 3; ++i)
+            attributeData[i + 1] = MeshAttributeData{MeshAttribute::Position,
+                Containers::StridedArrayView1D<const Vector3>{triangles,
+                    reinterpret_cast<const Vector3*>(triangles.data() + (i + 1)*sizeof(Vector3)),
+                    triangleCount, InputTriangleStride}};
+
+        #ifdef CORRADE_TARGET_BIG_ENDIAN
+        return MeshData{MeshPrimitive::Faces, std::move(vertexData), std::move(attributeData), MeshData::ImplicitVertexCount, statistics ? &solid.statistics : nullptr};
+        #else
+        return MeshData{MeshPrimitive::Faces, DataFlags{}, in, std::move(attributeData), MeshData::ImplicitVertexCount, statistics ? &solid.statistics : nullptr};
+        #endif
+    }
+
     /* We either have per-face in the second level or we convert them to
        per-vertex, never both */
     const bool perFaceToPerVertex = configuration().value<bool>("perFaceToPerVertex");
     CORRADE_INTERNAL_ASSERT(!(level == 1 && perFaceToPerVertex));
 
-    Containers::ArrayView<const char> in = _in->suffix(84);
-
     /* Make 2D views on input normals and positions */
-    const std::size_t triangleCount = in.size()/InputTriangleStride;
     Containers::StridedArrayView2D<const Vector3> inputNormals{in,
         reinterpret_cast<const Vector3*>(in.data() + 0),
         {triangleCount, 1}, {InputTriangleStride, 0}};
@@ -146,17 +539,35 @@ Containers::Optional<MeshData> StlImporter::doMesh(UnsignedInt, UnsignedInt leve
         Containers::StridedArrayView2D<Vector3> outputPositions{vertexData,
             reinterpret_cast<Vector3*>(vertexData.data() + offset),
             {triangleCount, 3}, {outputVertexStride*3, outputVertexStride}};
-        Utility::copy(inputPositions, outputPositions);
         Containers::StridedArrayView1D<Vector3> positions{vertexData,
             reinterpret_cast<Vector3*>(vertexData.data() + offset),
             vertexCount, outputVertexStride};
 
-        /* Endian conversion. This is needed only on Big-Endian systems, but
-           it's enabled always to minimize a risk of accidental breakage when
-           we can't test. */
-        for(Containers::StridedArrayView1D<Float> component:
-            Containers::arrayCast<2, Float>(positions).transposed<0, 1>())
-                Utility::Endianness::littleEndianInPlace(component);
+        /* If statistics are requested, calculate them in the same loop that
+           copies the positions so the data are traversed just once */
+        if(statistics) {
+            StatisticsAccumulator accumulator;
+            for(std::size_t i = 0; i != triangleCount; ++i) {
+                const Vector3 a = loadVector(&inputPositions[i][0]);
+                const Vector3 b = loadVector(&inputPositions[i][1]);
+                const Vector3 c = loadVector(&inputPositions[i][2]);
+                outputPositions[i][0] = a;
+                outputPositions[i][1] = b;
+                outputPositions[i][2] = c;
+                accumulator.add(a, b, c);
+            }
+            solid.statistics = accumulator.result();
+
+        } else {
+            Utility::copy(inputPositions, outputPositions);
+
+            /* Endian conversion. This is needed only on Big-Endian systems,
+               but it's enabled always to minimize a risk of accidental
+               breakage when we can't test. */
+            for(Containers::StridedArrayView1D<Float> component:
+                Containers::arrayCast<2, Float>(positions).transposed<0, 1>())
+                    Utility::Endianness::littleEndianInPlace(component);
+        }
 
         offset += sizeof(Vector3);
         attributeData[attributeIndex++] = MeshAttributeData{MeshAttribute::Position, positions};
@@ -189,8 +600,57 @@ Containers::Optional<MeshData> StlImporter::doMesh(UnsignedInt, UnsignedInt leve
     CORRADE_INTERNAL_ASSERT(offset == std::size_t(outputVertexStride));
     CORRADE_INTERNAL_ASSERT(attributeIndex == attributeCount);
 
+    /* Remove duplicate vertices, if requested, and make the mesh indexed
+       using the smallest index type that fits */
+    if(level == 0 && configuration().value<bool>("deduplicateVertices")) {
+        Containers::Array<UnsignedInt> indices{Containers::NoInit, vertexCount};
+        const std::size_t uniqueCount = deduplicateInPlace(vertexData, outputVertexStride, indices);
+
+        MeshIndexType indexType;
+        std::size_t indexTypeSize;
+        if(uniqueCount <= 0x100) {
+            indexType = MeshIndexType::UnsignedByte;
+            indexTypeSize = 1;
+        } else if(uniqueCount <= 0x10000) {
+            indexType = MeshIndexType::UnsignedShort;
+            indexTypeSize = 2;
+        } else {
+            indexType = MeshIndexType::UnsignedInt;
+            indexTypeSize = 4;
+        }
+
+        Containers::Array<char> indexData{Containers::NoInit, vertexCount*indexTypeSize};
+        if(indexType == MeshIndexType::UnsignedByte) {
+            const Containers::ArrayView<UnsignedByte> out = Containers::arrayCast<UnsignedByte>(indexData);
+            for(std::size_t i = 0; i != vertexCount; ++i) out[i] = indices[i];
+        } else if(indexType == MeshIndexType::UnsignedShort) {
+            const Containers::ArrayView<UnsignedShort> out = Containers::arrayCast<UnsignedShort>(indexData);
+            for(std::size_t i = 0; i != vertexCount; ++i) out[i] = indices[i];
+        } else Utility::copy(Containers::ArrayView<const UnsignedInt>{indices}, Containers::arrayCast<UnsignedInt>(indexData));
+
+        /* Copy the unique vertices to an exactly-sized allocation and point
+           the attributes there */
+        Containers::Array<char> uniqueVertexData{Containers::NoInit, uniqueCount*outputVertexStride};
+        Utility::copy(vertexData.prefix(uniqueVertexData.size()), uniqueVertexData);
+        for(MeshAttributeData& attribute: attributeData) {
+            attribute = MeshAttributeData{attribute.name(), attribute.format(),
+                Containers::StridedArrayView1D<const void>{uniqueVertexData,
+                    uniqueVertexData.data() + (static_cast<const char*>(attribute.data().data()) - vertexData.data()),
+                    uniqueCount, outputVertexStride}};
+        }
+
+        MeshIndexData indexDataView{indexType, indexData};
+        return MeshData{MeshPrimitive::Triangles,
+            std::move(indexData), indexDataView,
+            std::move(uniqueVertexData), std::move(attributeData),
+            MeshData::ImplicitVertexCount,
+            statistics ? &solid.statistics : nullptr};
+    }
+
     return MeshData{level == 0 ? MeshPrimitive::Triangles : MeshPrimitive::Faces,
-        std::move(vertexData), std::move(attributeData)};
+        std::move(vertexData), std::move(attributeData),
+        MeshData::ImplicitVertexCount,
+        statistics ? &solid.statistics : nullptr};
 }
 
 }}
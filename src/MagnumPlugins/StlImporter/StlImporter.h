@@ -31,6 +31,8 @@
 
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Magnum/Math/Range.h>
 #include <Magnum/Trade/AbstractImporter.h>
 
 #include "MagnumPlugins/StlImporter/configure.h"
@@ -53,11 +55,40 @@
 
 namespace Magnum { namespace Trade {
 
+/**
+@brief STL mesh statistics
+@m_since_latest_{plugins}
+
+Pointed to by @ref MeshData::importerState() if the @cb{.ini} statistics @ce
+@ref Trade-StlImporter-configuration "configuration option" of
+@ref StlImporter is enabled. See @ref Trade-StlImporter-statistics for more
+information.
+*/
+struct StlImporterStatistics {
+    /**
+     * @brief Bounding box
+     *
+     * Axis-aligned bounds of all positions. Zero for an empty mesh.
+     */
+    Range3D bounds;
+
+    /** @brief Surface area */
+    Float area;
+
+    /**
+     * @brief Signed volume
+     *
+     * Meaningful only for closed meshes with consistent winding.
+     * Counter-clockwise winding gives a positive volume.
+     */
+    Float volume;
+};
+
 /**
 @brief STL importer plugin
 @m_since_latest_{plugins}
 
-Imports normal and vertex information from binary
+Imports normal and vertex information from binary and ASCII
 [Stereolitography STL](https://en.wikipedia.org/wiki/STL_(file_format)) files.
 
 @section Trade-StlImporter-usage Usage
@@ -97,13 +128,62 @@ See @ref building-plugins, @ref cmake-plugins, @ref plugins and
 
 @section Trade-StlImporter-behavior Behavior and limitations
 
-The file is always imported as a non-indexed triangle mesh with per-face
+The file is by default imported as a non-indexed triangle mesh with per-face
 normals (i.e., same normal for all vertices in the triangle). Both positions
 and normals are imported as @ref VertexFormat::Vector3.
 
-Similarly to @ref StanfordImporter, ASCII files are not supported, only binary.
+If the @cb{.ini} deduplicateVertices @ce
+@ref Trade-StlImporter-configuration "configuration option" is enabled,
+duplicate vertices are removed and the mesh is indexed instead, using the
+smallest @ref MeshIndexType that fits the unique vertex count. The vertices
+are compared bitwise, together with the normals if @cb{.ini} perFaceToPerVertex @ce
+is enabled --- which usually means only vertices of coplanar neighboring
+triangles get merged. Disable it to get just unique positions.
+
+ASCII files are detected by the @cb{.txt} solid @ce keyword at the start, as
+long as the file size doesn't match the triangle count of a binary file ---
+some exporters put @cb{.txt} solid @ce at the start of binary headers as
+well. ASCII files are converted to the binary layout already during opening,
+so there's no difference when importing the mesh itself. Each
+@cb{.txt} solid @ce block in an ASCII file is imported as a separate mesh,
+with its name available through @ref meshName() and @ref meshForName().
+Binary files always contain just a single unnamed mesh. Numbers are parsed
+with a dedicated scanner that doesn't depend on the current locale, falling
+back to @ref std::strtod() only for numbers with more than 19 significant
+digits or very large exponents.
+
+Files passed to @ref openFile() are memory-mapped on platforms that support
+it, data passed to @ref openData() are copied. If the @cb{.ini} zeroCopy @ce
+@ref Trade-StlImporter-configuration "configuration option" is enabled, a
+second mesh level is always present and its attributes point directly to the
+triangle records in the file, without any copy. It's a
+@ref MeshPrimitive::Faces mesh with one vertex per triangle, containing a
+@ref MeshAttribute::Normal and three @ref MeshAttribute::Position attributes,
+one for each triangle corner, all with a 50-byte stride. The returned
+@ref MeshData::vertexDataFlags() are empty, meaning the data are valid only
+while the file is opened. On Big-Endian systems the data need to be swapped,
+so they're copied in that case. The first level is unaffected by this option.
+
 The [non-standard extensions for vertex colors](https://en.wikipedia.org/wiki/STL_(file_format)#Color_in_binary_STL)
 are also not supported due to a lack of generally available files for testing.
+
+@subsection Trade-StlImporter-statistics Mesh statistics
+
+If the @cb{.ini} statistics @ce
+@ref Trade-StlImporter-configuration "configuration option" is enabled,
+@ref MeshData::importerState() of each imported mesh points to a
+@ref StlImporterStatistics structure with the bounding box, surface area and
+volume of the mesh. These are calculated in the same loop that copies the
+positions out of the file, so the data doesn't need to be traversed one more
+time afterwards. The pointer is valid until the importer is closed and the
+contents get updated with each @ref mesh() call.
+
+@section Trade-StlImporter-configuration Plugin-specific config
+
+It's possible to tune various import options through @ref configuration(). See
+below for all options and their default values:
+
+@snippet MagnumPlugins/StlImporter/StlImporter.conf config
 */
 class MAGNUM_STLIMPORTER_EXPORT StlImporter: public AbstractImporter {
     public:
@@ -116,19 +196,24 @@ class MAGNUM_STLIMPORTER_EXPORT StlImporter: public AbstractImporter {
         ~StlImporter();
 
     private:
+        struct State;
+
         MAGNUM_STLIMPORTER_LOCAL ImporterFeatures doFeatures() const override;
 
         MAGNUM_STLIMPORTER_LOCAL bool doIsOpened() const override;
         MAGNUM_STLIMPORTER_LOCAL void doOpenFile(const std::string& filename) override;
         MAGNUM_STLIMPORTER_LOCAL void doOpenData(Containers::ArrayView<const char> data) override;
-        MAGNUM_STLIMPORTER_LOCAL void openDataInternal(Containers::Array<char>&& data);
+        MAGNUM_STLIMPORTER_LOCAL void openDataInternal(Containers::ArrayView<const char> data);
+        MAGNUM_STLIMPORTER_LOCAL bool convertAscii(Containers::ArrayView<const char> data, State& state);
         MAGNUM_STLIMPORTER_LOCAL void doClose() override;
 
         MAGNUM_STLIMPORTER_LOCAL UnsignedInt doMeshCount() const override;
+        MAGNUM_STLIMPORTER_LOCAL Int doMeshForName(const std::string& name) override;
+        MAGNUM_STLIMPORTER_LOCAL std::string doMeshName(UnsignedInt id) override;
         MAGNUM_STLIMPORTER_LOCAL UnsignedInt doMeshLevelCount(UnsignedInt id) override;
         MAGNUM_STLIMPORTER_LOCAL Containers::Optional<MeshData> doMesh(UnsignedInt id, UnsignedInt level) override;
 
-        Containers::Optional<Containers::Array<char>> _in;
+        Containers::Pointer<State> _state;
 };
 
 }}
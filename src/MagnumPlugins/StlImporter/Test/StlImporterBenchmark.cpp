@@ -0,0 +1,200 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstring>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/Endianness.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/MeshData.h>
+
+#include "MagnumPlugins/Implementation/peakMemory.h"
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+struct StlImporterBenchmark: TestSuite::Tester {
+    explicit StlImporterBenchmark();
+
+    void open();
+    void firstData();
+    void peakMemory();
+
+    void peakMemoryBegin();
+    std::uint64_t peakMemoryEnd();
+
+    /* Explicitly forbid system-wide plugin dependencies */
+    PluginManager::Manager<AbstractImporter> _manager{"nonexistent"};
+
+    std::uint64_t _residentSizeBefore{};
+};
+
+/* To calculate the throughput, divide the file size shown in the test case
+   description by the measured time */
+constexpr struct {
+    const char* name;
+    const char* option;
+    bool value;
+    UnsignedInt level;
+} FileData[]{
+    {"per-vertex normals", nullptr, false, 0},
+    {"positions only", "perFaceToPerVertex", false, 0},
+    {"deduplicated", "deduplicateVertices", true, 0},
+    {"zero copy", "zeroCopy", true, 1}
+};
+
+/* One million triangles of a 1000x500 quad grid, about 50 MB, generated
+   instead of bundling large files */
+Containers::Array<char> file() {
+    constexpr UnsignedInt GridWidth = 1000;
+    constexpr UnsignedInt GridHeight = 500;
+    constexpr UnsignedInt TriangleCount = GridWidth*GridHeight*2;
+
+    Containers::Array<char> out{Containers::ValueInit, 84 + TriangleCount*50};
+    const UnsignedInt triangleCount = Utility::Endianness::littleEndian(TriangleCount);
+    std::memcpy(out.data() + 80, &triangleCount, 4);
+
+    char* triangle = out.data() + 84;
+    const auto put = [&](const Float value) {
+        const Float valueLE = Utility::Endianness::littleEndian(value);
+        std::memcpy(triangle, &valueLE, 4);
+        triangle += 4;
+    };
+    for(UnsignedInt y = 0; y != GridHeight; ++y) {
+        for(UnsignedInt x = 0; x != GridWidth; ++x) {
+            const Float corners[][2]{
+                {Float(x), Float(y)},
+                {Float(x + 1), Float(y)},
+                {Float(x + 1), Float(y + 1)},
+                {Float(x), Float(y)},
+                {Float(x + 1), Float(y + 1)},
+                {Float(x), Float(y + 1)}
+            };
+            for(std::size_t i = 0; i != 2; ++i) {
+                put(0.0f); put(0.0f); put(1.0f);
+                for(std::size_t j = 0; j != 3; ++j) {
+                    put(corners[i*3 + j][0]);
+                    put(corners[i*3 + j][1]);
+                    put(0.0f);
+                }
+                /* Attribute byte count, left zero */
+                triangle += 2;
+            }
+        }
+    }
+
+    CORRADE_INTERNAL_ASSERT(triangle == out.end());
+    return out;
+}
+
+StlImporterBenchmark::StlImporterBenchmark() {
+    addBenchmarks({&StlImporterBenchmark::open}, 10);
+
+    addInstancedBenchmarks({&StlImporterBenchmark::firstData}, 10,
+        Containers::arraySize(FileData));
+
+    addCustomInstancedBenchmarks({&StlImporterBenchmark::peakMemory}, 1,
+        Containers::arraySize(FileData),
+        &StlImporterBenchmark::peakMemoryBegin,
+        &StlImporterBenchmark::peakMemoryEnd,
+        BenchmarkUnits::Bytes);
+
+    /* Load the plugin directly from the build tree. Otherwise it's static and
+       already loaded. */
+    #ifdef STLIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(STLIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    #endif
+}
+
+void StlImporterBenchmark::open() {
+    const Containers::Array<char> in = file();
+    setTestCaseDescription(Utility::formatString("{} bytes", in.size()));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
+
+    bool opened = false;
+    CORRADE_BENCHMARK(1)
+        opened = importer->openData(in);
+
+    CORRADE_VERIFY(opened);
+}
+
+void StlImporterBenchmark::firstData() {
+    auto&& data = FileData[testCaseInstanceId()];
+
+    const Containers::Array<char> in = file();
+    setTestCaseDescription(Utility::formatString("{}, {} bytes", data.name, in.size()));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
+    if(data.option) importer->configuration().setValue(data.option, data.value);
+
+    Containers::Optional<MeshData> mesh;
+    CORRADE_BENCHMARK(1) {
+        importer->openData(in);
+        mesh = importer->mesh(0, data.level);
+    }
+
+    CORRADE_VERIFY(mesh);
+}
+
+void StlImporterBenchmark::peakMemory() {
+    auto&& data = FileData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifndef __linux__
+    CORRADE_SKIP("Peak memory can be measured only on Linux.");
+    #else
+    /* The input is generated outside of the measured region, so only the
+       memory allocated by the importer and for the output is counted */
+    const Containers::Array<char> in = file();
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
+    if(data.option) importer->configuration().setValue(data.option, data.value);
+
+    Containers::Optional<MeshData> mesh;
+    CORRADE_BENCHMARK(1) {
+        importer->openData(in);
+        mesh = importer->mesh(0, data.level);
+    }
+
+    CORRADE_VERIFY(mesh);
+    #endif
+}
+
+void StlImporterBenchmark::peakMemoryBegin() {
+    _residentSizeBefore = Magnum::Implementation::peakMemoryBegin();
+}
+
+std::uint64_t StlImporterBenchmark::peakMemoryEnd() {
+    return Magnum::Implementation::peakMemoryEnd(_residentSizeBefore);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::StlImporterBenchmark)
@@ -25,6 +25,7 @@
 
 #include <sstream>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/TestSuite/Compare/Container.h>
@@ -32,10 +33,14 @@
 #include <Corrade/Utility/DebugStl.h>
 #include <Corrade/Utility/Directory.h>
 #include <Corrade/Utility/FormatStl.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Range.h>
 #include <Magnum/Math/Vector3.h>
 #include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/MeshData.h>
 
+#include "MagnumPlugins/StlImporter/StlImporter.h"
+
 #include "configure.h"
 
 namespace Magnum { namespace Trade { namespace Test { namespace {
@@ -46,9 +51,15 @@ struct StlImporterTest: TestSuite::Tester {
     void invalid();
     void fileNotFound();
     void ascii();
+    void asciiMultipleSolids();
+    void asciiBinaryHeaderSolid();
     void almostAsciiButNotActually();
     void emptyBinary();
     void binary();
+    void deduplicateVertices();
+    void zeroCopy();
+    void statistics();
+    void statisticsDisabled();
 
     void openTwice();
     void importTwice();
@@ -95,7 +106,19 @@ const struct {
     {"too short", Containers::arrayView(data).except(2),
         "file size doesn't match triangle count, expected 234 but got 233 for 3 triangles"},
     {"too long", Containers::arrayView(data),
-        "file size doesn't match triangle count, expected 234 but got 235 for 3 triangles"}
+        "file size doesn't match triangle count, expected 234 but got 235 for 3 triangles"},
+    {"ASCII, no solid", Containers::arrayView("solidity\n").except(1),
+        "invalid ASCII STL file, expected solid but got solidity"},
+    {"ASCII, unexpected keyword", Containers::arrayView("solid a\nfacet normal 0 0 1\nouter ring").except(1),
+        "invalid ASCII STL file, expected loop but got ring"},
+    {"ASCII, invalid number", Containers::arrayView("solid\nfacet normal 0 0.0f 1").except(1),
+        "invalid ASCII STL file, expected a number but got 0.0f"},
+    {"ASCII, unterminated facet", Containers::arrayView("solid\nfacet normal 0 0 1\nouter loop\nvertex 1 2 3\n").except(1),
+        "invalid ASCII STL file, expected vertex but got "},
+    {"ASCII, no endsolid", Containers::arrayView("solid\n").except(1),
+        "invalid ASCII STL file, expected facet or endsolid but got "},
+    {"ASCII, garbage after endsolid", Containers::arrayView("solid\nendsolid\nfacet").except(1),
+        "invalid ASCII STL file, expected solid but got facet"}
 };
 
 const struct {
@@ -115,18 +138,73 @@ const struct {
         false, 1, 2, MeshPrimitive::Faces, 2, 1, false, false}
 };
 
+const struct {
+    const char* name;
+    bool perFaceToPerVertex;
+    UnsignedInt vertexCount;
+    UnsignedInt indices[6];
+} DeduplicateData[] {
+    /* The second triangle shares two positions with the first, but has a
+       different normal */
+    {"", true, 6, {0, 1, 2, 3, 4, 5}},
+    {"per-face normals", false, 4, {0, 1, 2, 1, 3, 2}}
+};
+
+const struct {
+    const char* name;
+    bool perFaceToPerVertex;
+    bool openData;
+} ZeroCopyData[] {
+    {"file", true, false},
+    {"data", true, true},
+    {"per-face normals", false, false}
+};
+
+const struct {
+    const char* name;
+    bool perFaceToPerVertex, deduplicateVertices, zeroCopy;
+    UnsignedInt level;
+} StatisticsData[] {
+    {"", true, false, false, 0},
+    {"deduplicated vertices", true, true, false, 0},
+    {"per-face normals, level 1", false, false, false, 1},
+    {"zero copy, level 1", true, false, true, 1}
+};
+
+/* A unit tetrahedron with outward-facing counterclockwise winding */
+constexpr const char TetrahedronData[] =
+    "solid tetrahedron\n"
+    "facet normal 0 0 -1 outer loop vertex 0 0 0 vertex 0 1 0 vertex 1 0 0 endloop endfacet\n"
+    "facet normal 0 -1 0 outer loop vertex 0 0 0 vertex 1 0 0 vertex 0 0 1 endloop endfacet\n"
+    "facet normal -1 0 0 outer loop vertex 0 0 0 vertex 0 0 1 vertex 0 1 0 endloop endfacet\n"
+    "facet normal 0.57735 0.57735 0.57735 outer loop vertex 1 0 0 vertex 0 1 0 vertex 0 0 1 endloop endfacet\n"
+    "endsolid tetrahedron\n";
+
 StlImporterTest::StlImporterTest() {
     addInstancedTests({&StlImporterTest::invalid},
         Containers::arraySize(InvalidData));
 
     addTests({&StlImporterTest::fileNotFound,
               &StlImporterTest::ascii,
+              &StlImporterTest::asciiMultipleSolids,
+              &StlImporterTest::asciiBinaryHeaderSolid,
               &StlImporterTest::almostAsciiButNotActually,
               &StlImporterTest::emptyBinary});
 
     addInstancedTests({&StlImporterTest::binary},
         Containers::arraySize(BinaryData));
 
+    addInstancedTests({&StlImporterTest::deduplicateVertices},
+        Containers::arraySize(DeduplicateData));
+
+    addInstancedTests({&StlImporterTest::zeroCopy},
+        Containers::arraySize(ZeroCopyData));
+
+    addInstancedTests({&StlImporterTest::statistics},
+        Containers::arraySize(StatisticsData));
+
+    addTests({&StlImporterTest::statisticsDisabled});
+
     addTests({&StlImporterTest::openTwice,
               &StlImporterTest::importTwice});
 
@@ -162,10 +240,102 @@ void StlImporterTest::fileNotFound() {
 void StlImporterTest::ascii() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
 
-    std::ostringstream out;
-    Error redirectError{&out};
-    CORRADE_VERIFY(!importer->openFile(Utility::Directory::join(STLIMPORTER_TEST_DIR, "ascii.stl")));
-    CORRADE_COMPARE(out.str(), "Trade::StlImporter::openData(): ASCII STL files are not supported, sorry\n");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(STLIMPORTER_TEST_DIR, "ascii.stl")));
+    CORRADE_COMPARE(importer->meshCount(), 1);
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_VERIFY(!mesh->isIndexed());
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+    CORRADE_COMPARE(mesh->attributeCount(), 2);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {1.0f, 0.0f, 0.0f},
+            {-1.0f, 0.0f, 0.0f},
+            {0.0f, 1.0f, 0.0f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Normal),
+        Containers::arrayView<Vector3>({
+            {0.0f, 0.0f, 1.0f},
+            {0.0f, 0.0f, 1.0f},
+            {0.0f, 0.0f, 1.0f}
+        }), TestSuite::Compare::Container);
+}
+
+void StlImporterTest::asciiMultipleSolids() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
+
+    /* Tabs, CRLF, exponents, signs and a name with spaces */
+    CORRADE_VERIFY(importer->openData(Containers::arrayView(
+        "solid first one\r\n"
+        "facet normal 0 0 -1\r\n"
+        "\touter loop\r\n"
+        "\t\tvertex 1.5e1 +2 -3.25\r\n"
+        "\t\tvertex 0.125 1E-2 .5\r\n"
+        "\t\tvertex 7 8 9.\r\n"
+        "\tendloop\r\n"
+        "endfacet\r\n"
+        "endsolid first one\r\n"
+        "solid second\n"
+        "facet normal 1 0 0 outer loop vertex 1 0 0 vertex 0 1 0 vertex 0 0 1 endloop endfacet\n"
+        "endsolid").except(1)));
+
+    CORRADE_COMPARE(importer->meshCount(), 2);
+    CORRADE_COMPARE(importer->meshName(0), "first one");
+    CORRADE_COMPARE(importer->meshName(1), "second");
+    CORRADE_COMPARE(importer->meshForName("second"), 1);
+    CORRADE_COMPARE(importer->meshForName("third"), -1);
+
+    Containers::Optional<MeshData> first = importer->mesh(0);
+    CORRADE_VERIFY(first);
+    CORRADE_COMPARE_AS(first->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {15.0f, 2.0f, -3.25f},
+            {0.125f, 0.01f, 0.5f},
+            {7.0f, 8.0f, 9.0f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(first->attribute<Vector3>(MeshAttribute::Normal),
+        Containers::arrayView<Vector3>({
+            {0.0f, 0.0f, -1.0f},
+            {0.0f, 0.0f, -1.0f},
+            {0.0f, 0.0f, -1.0f}
+        }), TestSuite::Compare::Container);
+
+    Containers::Optional<MeshData> second = importer->mesh("second");
+    CORRADE_VERIFY(second);
+    CORRADE_COMPARE_AS(second->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {1.0f, 0.0f, 0.0f},
+            {0.0f, 1.0f, 0.0f},
+            {0.0f, 0.0f, 1.0f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(second->attribute<Vector3>(MeshAttribute::Normal),
+        Containers::arrayView<Vector3>({
+            {1.0f, 0.0f, 0.0f},
+            {1.0f, 0.0f, 0.0f},
+            {1.0f, 0.0f, 0.0f}
+        }), TestSuite::Compare::Container);
+}
+
+void StlImporterTest::asciiBinaryHeaderSolid() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
+
+    constexpr const char data[]{
+        /* 80-byte header starting with "solid", but the size matches the
+           triangle count so it should be treated as binary */
+        's', 'o', 'l', 'i', 'd', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+
+        0, 0, 0, 0, /* No triangles */
+    };
+
+    CORRADE_VERIFY(importer->openData(data));
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexCount(), 0);
 }
 
 void StlImporterTest::almostAsciiButNotActually() {
@@ -273,6 +443,144 @@ void StlImporterTest::binary() {
     } else CORRADE_INTERNAL_ASSERT_UNREACHABLE();
 }
 
+void StlImporterTest::deduplicateVertices() {
+    auto&& data = DeduplicateData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
+    importer->configuration().setValue("deduplicateVertices", true);
+    importer->configuration().setValue("perFaceToPerVertex", data.perFaceToPerVertex);
+
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(STLIMPORTER_TEST_DIR, "shared-vertices.stl")));
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Triangles);
+    CORRADE_VERIFY(mesh->isIndexed());
+    CORRADE_COMPARE(mesh->indexType(), MeshIndexType::UnsignedByte);
+    CORRADE_COMPARE_AS(mesh->indicesAsArray(),
+        Containers::arrayView(data.indices),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(mesh->vertexCount(), data.vertexCount);
+    CORRADE_COMPARE(mesh->vertexData().size(), data.vertexCount*(data.perFaceToPerVertex ? 24 : 12));
+
+    if(data.perFaceToPerVertex) {
+        CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+            Containers::arrayView<Vector3>({
+                {0.0f, 0.0f, 0.0f},
+                {1.0f, 0.0f, 0.0f},
+                {0.0f, 1.0f, 0.0f},
+                {1.0f, 0.0f, 0.0f},
+                {1.0f, 1.0f, 0.0f},
+                {0.0f, 1.0f, 0.0f}
+            }), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Normal),
+            Containers::arrayView<Vector3>({
+                {0.0f, 0.0f, 1.0f},
+                {0.0f, 0.0f, 1.0f},
+                {0.0f, 0.0f, 1.0f},
+                {0.0f, 0.0f, -1.0f},
+                {0.0f, 0.0f, -1.0f},
+                {0.0f, 0.0f, -1.0f}
+            }), TestSuite::Compare::Container);
+    } else {
+        CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+            Containers::arrayView<Vector3>({
+                {0.0f, 0.0f, 0.0f},
+                {1.0f, 0.0f, 0.0f},
+                {0.0f, 1.0f, 0.0f},
+                {1.0f, 1.0f, 0.0f}
+            }), TestSuite::Compare::Container);
+    }
+}
+
+void StlImporterTest::zeroCopy() {
+    auto&& data = ZeroCopyData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
+    importer->configuration().setValue("zeroCopy", true);
+    importer->configuration().setValue("perFaceToPerVertex", data.perFaceToPerVertex);
+
+    const std::string filename = Utility::Directory::join(STLIMPORTER_TEST_DIR, "binary.stl");
+    if(data.openData) {
+        Containers::Array<char> file = Utility::Directory::read(filename);
+        CORRADE_VERIFY(importer->openData(file));
+    } else CORRADE_VERIFY(importer->openFile(filename));
+
+    /* The second level is always present */
+    CORRADE_COMPARE(importer->meshLevelCount(0), 2);
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0, 1);
+    CORRADE_VERIFY(mesh);
+    CORRADE_VERIFY(!mesh->isIndexed());
+    CORRADE_COMPARE(mesh->primitive(), MeshPrimitive::Faces);
+    CORRADE_COMPARE(mesh->vertexDataFlags(), DataFlags{});
+    CORRADE_COMPARE(mesh->vertexCount(), 2);
+    CORRADE_COMPARE(mesh->attributeCount(), 4);
+    CORRADE_COMPARE(mesh->attributeCount(MeshAttribute::Position), 3);
+    CORRADE_COMPARE(mesh->attributeStride(MeshAttribute::Normal), 50);
+    CORRADE_COMPARE(mesh->attributeStride(MeshAttribute::Position), 50);
+
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Normal),
+        Containers::arrayView<Vector3>({
+            {0.1f, 0.2f, 0.3f},
+            {0.4f, 0.5f, 0.6f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position, 0),
+        Containers::arrayView<Vector3>({
+            {1.0f, 2.0f, 3.0f},
+            {1.1f, 2.1f, 3.1f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position, 1),
+        Containers::arrayView<Vector3>({
+            {4.0f, 5.0f, 6.0f},
+            {4.1f, 5.1f, 6.1f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position, 2),
+        Containers::arrayView<Vector3>({
+            {7.0f, 8.0f, 9.0f},
+            {7.1f, 8.1f, 9.1f}
+        }), TestSuite::Compare::Container);
+
+    /* The first level is unaffected */
+    Containers::Optional<MeshData> first = importer->mesh(0);
+    CORRADE_VERIFY(first);
+    CORRADE_COMPARE(first->primitive(), MeshPrimitive::Triangles);
+    CORRADE_COMPARE(first->vertexCount(), 6);
+    CORRADE_COMPARE(first->attributeCount(), data.perFaceToPerVertex ? 2 : 1);
+}
+
+void StlImporterTest::statistics() {
+    auto&& data = StatisticsData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
+    importer->configuration().setValue("statistics", true);
+    importer->configuration().setValue("perFaceToPerVertex", data.perFaceToPerVertex);
+    importer->configuration().setValue("deduplicateVertices", data.deduplicateVertices);
+    importer->configuration().setValue("zeroCopy", data.zeroCopy);
+    CORRADE_VERIFY(importer->openData(Containers::arrayView(TetrahedronData).except(1)));
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0, data.level);
+    CORRADE_VERIFY(mesh);
+    CORRADE_VERIFY(mesh->importerState());
+
+    const auto& statistics = *static_cast<const StlImporterStatistics*>(mesh->importerState());
+    CORRADE_COMPARE(statistics.bounds, (Range3D{{}, Vector3{1.0f}}));
+    CORRADE_COMPARE(statistics.area, 1.5f + Math::sqrt(3.0f)*0.5f);
+    CORRADE_COMPARE(statistics.volume, 1.0f/6.0f);
+}
+
+void StlImporterTest::statisticsDisabled() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
+    CORRADE_VERIFY(importer->openData(Containers::arrayView(TetrahedronData).except(1)));
+
+    Containers::Optional<MeshData> mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_VERIFY(!mesh->importerState());
+}
+
 void StlImporterTest::openTwice() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("StlImporter");
 
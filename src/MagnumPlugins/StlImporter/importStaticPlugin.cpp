@@ -25,7 +25,7 @@
 
 #include "MagnumPlugins/StlImporter/configure.h"
 
-#ifdef MAGNUM_STLIMPORTER_BUILD_STATIC
+#if defined(MAGNUM_STLIMPORTER_BUILD_STATIC) && !defined(MAGNUM_PLUGINS_NO_AUTOMATIC_IMPORT)
 #include <Corrade/PluginManager/AbstractManager.h>
 
 static int magnumStlImporterStaticImporter() {
@@ -0,0 +1,156 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <string>
+#include <utility>
+#include <vector>
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/AbstractSceneConverter.h>
+
+#include "configure.h"
+
+#ifdef MAGNUMPLUGINS_TEST_WITH_AUDIO
+#include <Magnum/Audio/AbstractImporter.h>
+#endif
+#ifdef MAGNUMPLUGINS_TEST_WITH_TEXT
+#include <Magnum/Text/AbstractFont.h>
+#endif
+
+namespace Magnum { namespace Test { namespace {
+
+/* All static plugins linked to the executable are registered at static
+   initialization. Constructing a manager then goes through all of them,
+   parses metadata of those matching its interface and calls their
+   initializers, which is what an application pays for at startup. */
+struct StaticPluginStartupBenchmark: TestSuite::Tester {
+    explicit StaticPluginStartupBenchmark();
+
+    void manager();
+    void instantiate();
+
+    std::vector<Containers::Pointer<PluginManager::AbstractManager>> _managers;
+    /* Index into InterfaceData and _managers, plugin name */
+    std::vector<std::pair<std::size_t, std::string>> _plugins;
+};
+
+template<class T> std::size_t constructManager() {
+    /* Explicitly forbid system-wide plugins, only the static ones are
+       interesting */
+    PluginManager::Manager<T> manager{"nonexistent"};
+    return manager.pluginList().size();
+}
+
+template<class T> Containers::Pointer<PluginManager::AbstractManager> createManager() {
+    return Containers::Pointer<PluginManager::AbstractManager>{new PluginManager::Manager<T>{"nonexistent"}};
+}
+
+template<class T> bool instantiatePlugin(PluginManager::AbstractManager& manager, const std::string& plugin) {
+    return !!static_cast<PluginManager::Manager<T>&>(manager).instantiate(plugin);
+}
+
+const struct {
+    const char* name;
+    std::size_t(*constructManager)();
+    Containers::Pointer<PluginManager::AbstractManager>(*createManager)();
+    bool(*instantiate)(PluginManager::AbstractManager&, const std::string&);
+} InterfaceData[]{
+    {"Trade::AbstractImporter",
+        constructManager<Trade::AbstractImporter>,
+        createManager<Trade::AbstractImporter>,
+        instantiatePlugin<Trade::AbstractImporter>},
+    {"Trade::AbstractImageConverter",
+        constructManager<Trade::AbstractImageConverter>,
+        createManager<Trade::AbstractImageConverter>,
+        instantiatePlugin<Trade::AbstractImageConverter>},
+    {"Trade::AbstractSceneConverter",
+        constructManager<Trade::AbstractSceneConverter>,
+        createManager<Trade::AbstractSceneConverter>,
+        instantiatePlugin<Trade::AbstractSceneConverter>},
+    #ifdef MAGNUMPLUGINS_TEST_WITH_AUDIO
+    {"Audio::AbstractImporter",
+        constructManager<Audio::AbstractImporter>,
+        createManager<Audio::AbstractImporter>,
+        instantiatePlugin<Audio::AbstractImporter>},
+    #endif
+    #ifdef MAGNUMPLUGINS_TEST_WITH_TEXT
+    {"Text::AbstractFont",
+        constructManager<Text::AbstractFont>,
+        createManager<Text::AbstractFont>,
+        instantiatePlugin<Text::AbstractFont>},
+    #endif
+};
+
+StaticPluginStartupBenchmark::StaticPluginStartupBenchmark() {
+    /* Gather plugins of all interfaces so instantiation of each can be
+       measured separately. The managers are kept around so the
+       instantiation doesn't include the manager construction. */
+    for(std::size_t i = 0; i != Containers::arraySize(InterfaceData); ++i) {
+        _managers.push_back(InterfaceData[i].createManager());
+        for(const std::string& plugin: _managers.back()->pluginList())
+            _plugins.emplace_back(i, plugin);
+    }
+
+    addInstancedBenchmarks({&StaticPluginStartupBenchmark::manager}, 10,
+        Containers::arraySize(InterfaceData));
+
+    if(!_plugins.empty())
+        addInstancedBenchmarks({&StaticPluginStartupBenchmark::instantiate}, 10,
+            _plugins.size());
+}
+
+void StaticPluginStartupBenchmark::manager() {
+    auto&& data = InterfaceData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    if(_managers[testCaseInstanceId()]->pluginList().empty())
+        CORRADE_SKIP("No static plugins for this interface are linked.");
+
+    std::size_t count = 0;
+    CORRADE_BENCHMARK(10)
+        count += data.constructManager();
+
+    CORRADE_COMPARE(count, 10*_managers[testCaseInstanceId()]->pluginList().size());
+}
+
+void StaticPluginStartupBenchmark::instantiate() {
+    const std::pair<std::size_t, std::string>& plugin = _plugins[testCaseInstanceId()];
+    setTestCaseDescription(plugin.second);
+
+    PluginManager::AbstractManager& manager = *_managers[plugin.first];
+    bool instantiated = true;
+    CORRADE_BENCHMARK(100)
+        instantiated = InterfaceData[plugin.first].instantiate(manager, plugin.second) && instantiated;
+
+    CORRADE_VERIFY(instantiated);
+}
+
+}}}
+
+CORRADE_TEST_MAIN(Magnum::Test::StaticPluginStartupBenchmark)
@@ -0,0 +1,255 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019,
+                2020 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstring>
+#include <string>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Assert.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Corrade/Utility/Endianness.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/MeshData.h>
+
+#include "MagnumPlugins/Implementation/peakMemory.h"
+
+#include "configure.h"
+
+namespace Magnum { namespace Trade { namespace Test { namespace {
+
+struct TinyGltfImporterBenchmark: TestSuite::Tester {
+    explicit TinyGltfImporterBenchmark();
+
+    void open();
+    void firstData();
+    void import();
+    void peakMemory();
+
+    void peakMemoryBegin();
+    std::uint64_t peakMemoryEnd();
+
+    PluginManager::Manager<AbstractImporter> _manager;
+
+    std::uint64_t _residentSizeBefore{};
+};
+
+/* To calculate the throughput, divide the file size shown in the test case
+   description by the measured time */
+constexpr struct {
+    const char* name;
+    UnsignedInt meshCount;
+    const char* option;
+} FileData[]{
+    {"one large mesh", 1, nullptr},
+    {"one large mesh, zero copy", 1, "zeroCopy"},
+    {"one large mesh, narrowed indices", 1, "narrowIndices"},
+    {"4096 small meshes", 4096, nullptr},
+    {"4096 small meshes, lazy buffer loading", 4096, "lazyBufferLoading"}
+};
+
+/* A GLB file with meshes of about a million vertices in total, each with
+   positions, normals and 32-bit triangle indices referencing a single
+   buffer, generated instead of bundling large files */
+Containers::Array<char> file(const UnsignedInt meshCount) {
+    const UnsignedInt vertexCount = 1048576/meshCount;
+    const UnsignedInt indexCount = (vertexCount - 2)*3;
+    const std::size_t vertexDataSize = vertexCount*24;
+    const std::size_t meshDataSize = vertexDataSize + indexCount*4;
+
+    std::string json = "{\"asset\":{\"version\":\"2.0\"},";
+    json += Utility::formatString("\"buffers\":[{{\"byteLength\":{}}}],", meshDataSize*meshCount);
+    std::string bufferViews = "\"bufferViews\":[";
+    std::string accessors = "\"accessors\":[";
+    std::string meshes = "\"meshes\":[";
+    for(UnsignedInt i = 0; i != meshCount; ++i) {
+        const std::string separator = i ? "," : "";
+        bufferViews += Utility::formatString(
+            "{}{{\"buffer\":0,\"byteOffset\":{},\"byteLength\":{},\"byteStride\":24}},"
+            "{{\"buffer\":0,\"byteOffset\":{},\"byteLength\":{}}}",
+            separator, i*meshDataSize, vertexDataSize,
+            i*meshDataSize + vertexDataSize, indexCount*4);
+        accessors += Utility::formatString(
+            "{}{{\"bufferView\":{},\"componentType\":5126,\"count\":{},\"type\":\"VEC3\",\"min\":[0,0,0],\"max\":[1,1,1]}},"
+            "{{\"bufferView\":{},\"byteOffset\":12,\"componentType\":5126,\"count\":{},\"type\":\"VEC3\"}},"
+            "{{\"bufferView\":{},\"componentType\":5125,\"count\":{},\"type\":\"SCALAR\"}}",
+            separator, i*2, vertexCount, i*2, vertexCount, i*2 + 1, indexCount);
+        meshes += Utility::formatString(
+            "{}{{\"primitives\":[{{\"attributes\":{{\"POSITION\":{},\"NORMAL\":{}}},\"indices\":{}}}]}}",
+            separator, i*3, i*3 + 1, i*3 + 2);
+    }
+    json += bufferViews + "]," + accessors + "]," + meshes + "]}";
+    /* The JSON chunk has to be padded with spaces to four bytes */
+    json.append((4 - json.size() % 4) % 4, ' ');
+
+    const std::size_t binSize = meshDataSize*meshCount;
+    Containers::Array<char> out{Containers::NoInit, 12 + 8 + json.size() + 8 + binSize};
+    const auto put32 = [&](const std::size_t offset, const UnsignedInt value) {
+        const UnsignedInt valueLE = Utility::Endianness::littleEndian(value);
+        std::memcpy(out.data() + offset, &valueLE, 4);
+    };
+    std::memcpy(out.data(), "glTF", 4);
+    put32(4, 2);
+    put32(8, out.size());
+    put32(12, json.size());
+    std::memcpy(out.data() + 16, "JSON", 4);
+    std::memcpy(out.data() + 20, json.data(), json.size());
+    const std::size_t binOffset = 20 + json.size();
+    put32(binOffset, binSize);
+    std::memcpy(out.data() + binOffset + 4, "BIN\0", 4);
+
+    /* Vertices on a triangle strip, indexed as a triangle list. The data
+       themselves don't matter much, they just need to be in bounds. */
+    Containers::ArrayView<char> bin = out.suffix(binOffset + 8);
+    for(UnsignedInt i = 0; i != meshCount; ++i) {
+        Containers::ArrayView<char> mesh = bin.slice(i*meshDataSize, (i + 1)*meshDataSize);
+        for(UnsignedInt j = 0; j != vertexCount; ++j) {
+            const Float vertex[]{Float(j % 2), Float(j/2)/vertexCount, 0.0f,
+                                 0.0f, 0.0f, 1.0f};
+            for(std::size_t k = 0; k != 6; ++k) {
+                const Float valueLE = Utility::Endianness::littleEndian(vertex[k]);
+                std::memcpy(mesh.data() + j*24 + k*4, &valueLE, 4);
+            }
+        }
+        for(UnsignedInt j = 0; j != indexCount; ++j) {
+            const UnsignedInt valueLE = Utility::Endianness::littleEndian(j/3 + j%3);
+            std::memcpy(mesh.data() + vertexDataSize + j*4, &valueLE, 4);
+        }
+    }
+
+    return out;
+}
+
+TinyGltfImporterBenchmark::TinyGltfImporterBenchmark() {
+    addInstancedBenchmarks({&TinyGltfImporterBenchmark::open,
+                            &TinyGltfImporterBenchmark::firstData,
+                            &TinyGltfImporterBenchmark::import}, 10,
+        Containers::arraySize(FileData));
+
+    addCustomInstancedBenchmarks({&TinyGltfImporterBenchmark::peakMemory}, 1,
+        Containers::arraySize(FileData),
+        &TinyGltfImporterBenchmark::peakMemoryBegin,
+        &TinyGltfImporterBenchmark::peakMemoryEnd,
+        BenchmarkUnits::Bytes);
+
+    /* Load the plugin directly from the build tree. Otherwise it's static and
+       already loaded. It also pulls in the AnyImageImporter dependency. Reset
+       the plugin dir after so it doesn't load anything else from the
+       filesystem. */
+    #ifdef TINYGLTFIMPORTER_PLUGIN_FILENAME
+    CORRADE_INTERNAL_ASSERT_OUTPUT(_manager.load(TINYGLTFIMPORTER_PLUGIN_FILENAME) & PluginManager::LoadState::Loaded);
+    _manager.setPluginDirectory({});
+    #endif
+}
+
+void TinyGltfImporterBenchmark::open() {
+    auto&& data = FileData[testCaseInstanceId()];
+
+    const Containers::Array<char> in = file(data.meshCount);
+    setTestCaseDescription(Utility::formatString("{}, {} bytes", data.name, in.size()));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    if(data.option) importer->configuration().setValue(data.option, true);
+
+    bool opened = false;
+    CORRADE_BENCHMARK(1)
+        opened = importer->openData(in);
+
+    CORRADE_VERIFY(opened);
+}
+
+void TinyGltfImporterBenchmark::firstData() {
+    auto&& data = FileData[testCaseInstanceId()];
+
+    const Containers::Array<char> in = file(data.meshCount);
+    setTestCaseDescription(Utility::formatString("{}, {} bytes", data.name, in.size()));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    if(data.option) importer->configuration().setValue(data.option, true);
+
+    Containers::Optional<MeshData> mesh;
+    CORRADE_BENCHMARK(1) {
+        importer->openData(in);
+        mesh = importer->mesh(0);
+    }
+
+    CORRADE_VERIFY(mesh);
+}
+
+void TinyGltfImporterBenchmark::import() {
+    auto&& data = FileData[testCaseInstanceId()];
+
+    const Containers::Array<char> in = file(data.meshCount);
+    setTestCaseDescription(Utility::formatString("{}, {} bytes", data.name, in.size()));
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    if(data.option) importer->configuration().setValue(data.option, true);
+
+    UnsignedInt imported = 0;
+    CORRADE_BENCHMARK(1) {
+        importer->openData(in);
+        for(UnsignedInt i = 0; i != importer->meshCount(); ++i)
+            if(importer->mesh(i)) ++imported;
+    }
+
+    CORRADE_COMPARE(imported, data.meshCount);
+}
+
+void TinyGltfImporterBenchmark::peakMemory() {
+    auto&& data = FileData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    #ifndef __linux__
+    CORRADE_SKIP("Peak memory can be measured only on Linux.");
+    #else
+    /* The input is generated outside of the measured region, so only the
+       memory allocated by the importer and for the output is counted */
+    const Containers::Array<char> in = file(data.meshCount);
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    if(data.option) importer->configuration().setValue(data.option, true);
+
+    UnsignedInt imported = 0;
+    CORRADE_BENCHMARK(1) {
+        importer->openData(in);
+        for(UnsignedInt i = 0; i != importer->meshCount(); ++i)
+            if(importer->mesh(i)) ++imported;
+    }
+
+    CORRADE_COMPARE(imported, data.meshCount);
+    #endif
+}
+
+void TinyGltfImporterBenchmark::peakMemoryBegin() {
+    _residentSizeBefore = Magnum::Implementation::peakMemoryBegin();
+}
+
+std::uint64_t TinyGltfImporterBenchmark::peakMemoryEnd() {
+    return Magnum::Implementation::peakMemoryEnd(_residentSizeBefore);
+}
+
+}}}}
+
+CORRADE_TEST_MAIN(Magnum::Trade::Test::TinyGltfImporterBenchmark)
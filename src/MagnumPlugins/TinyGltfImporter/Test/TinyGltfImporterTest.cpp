@@ -42,6 +42,7 @@
 #include <Magnum/Mesh.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Math/CubicHermite.h>
+#include <Magnum/Math/Matrix4.h>
 #include <Magnum/MeshTools/Transform.h>
 #include <Magnum/Trade/AbstractImporter.h>
 #include <Magnum/Trade/AbstractMaterialData.h>
@@ -58,6 +59,12 @@
 #include <Magnum/Sampler.h>
 
 #include "configure.h"
+#include "MagnumPlugins/TinyGltfImporter/TinyGltfImporter.h"
+
+#ifdef MAGNUM_TINYGLTFIMPORTER_WITH_MESHOPTIMIZER
+#include <cstring>
+#include <meshoptimizer.h>
+#endif
 
 namespace Magnum { namespace Trade { namespace Test { namespace {
 
@@ -95,21 +102,49 @@ struct TinyGltfImporterTest: TestSuite::Tester {
 
     void objectTransformationQuaternionNormalizationEnabled();
     void objectTransformationQuaternionNormalizationDisabled();
+    void objectHierarchy();
+    void objectHierarchyScene();
+    void objectHierarchyQuaternionNormalization();
+    void objectInstancing();
+    void objectInstancingInvalid();
+
+    void skin();
+    void skinInvalid();
+    void meshSkinAttributes();
+    void meshSkinAttributesInvalid();
+
+    void meshMorphTargets();
+    void meshMorphTargetsInvalid();
+    void animationMorphTargetWeights();
+    void animationMorphTargetWeightsSpline();
+    void animationMorphTargetWeightsInvalid();
 
     void mesh();
     void meshAttributeless();
     void meshIndexed();
     void meshIndexedAttributeless();
+    void meshNarrowIndices();
+    void meshNarrowIndicesZeroCopy();
+    void meshZeroCopy();
+    void meshLazyBufferLoading();
+    void meshLazyBufferLoadingNoPathNoCallback();
     void meshColors();
     void meshCustomAttributes();
     void meshCustomAttributesNoFileOpened();
     void meshMultiplePrimitives();
+    void meshMultipleBuffers();
+    void meshSparse();
+    void meshSparseInvalid();
+    void meshDracoInvalid();
+    void meshMeshoptCompression();
     void meshPrimitivesTypes();
     /* This is THE ONE AND ONLY OOB check done by tinygltf, so it fails right
        at openData() and thus has to be separate. Everything else is not done
        by it. */
     void meshIndexAccessorOutOfBounds();
     void meshInvalid();
+    void meshTrustedInput();
+    void meshInvalidTrustedInput();
 
     void materialPbrMetallicRoughness();
     void materialPbrSpecularGlossiness();
@@ -127,9 +162,14 @@ struct TinyGltfImporterTest: TestSuite::Tester {
     void imageEmbedded();
     void imageExternal();
     void imageExternalNotFound();
+    void imageThreads();
+    void imagePrefetch();
+    void imagePrefetchNotFound();
+    void imageImporterCache();
     void imageExternalNoPathNoCallback();
 
     void imageBasis();
+    void imageBasisFormat();
     void imageMipLevels();
 
     void fileCallbackBuffer();
@@ -137,6 +177,8 @@ struct TinyGltfImporterTest: TestSuite::Tester {
     void fileCallbackImage();
     void fileCallbackImageNotFound();
 
+    void profiling();
+
     void utf8filenames();
 
     /* Needs to load AnyImageImporter from system-wide location */
@@ -164,6 +206,18 @@ constexpr struct {
     {"binary", ".glb"}
 };
 
+constexpr struct {
+    const char* filename;
+} ObjectHierarchyData[]{
+    {"scene.gltf"},
+    {"scene.glb"},
+    {"object-transformation.gltf"},
+    {"mesh-multiple-primitives.gltf"},
+    {"camera.gltf"},
+    {"light.gltf"},
+    {"skin.gltf"}
+};
+
 constexpr struct {
     const char* name;
     const char* suffix;
@@ -282,6 +336,86 @@ constexpr struct {
     {"accessor index out of bounds", "accessor 17 out of bounds for 17 accessors"}
 };
 
+/* Subset of MeshInvalidData that's still checked with trustedInput, as the
+   checks are needed for memory safety */
+constexpr struct {
+    const char* name;
+    const char* message;
+} MeshInvalidTrustedInputData[]{
+    {"invalid primitive", "unrecognized primitive 666"},
+    {"different vertex count for each accessor", "mismatched vertex count for attribute TEXCOORD_1, expected 3 but got 4"},
+    {"unexpected texcoord type", "unexpected TEXCOORD type 3"},
+    {"unexpected index type", "unexpected index type 2"},
+    {"unsupported index component type", "unexpected index component type 5124"},
+    {"strided index view", "index bufferView is not contiguous"},
+    /* The stride check is skipped, but the overlapping elements still don't
+       fit into the view */
+    {"accessor type size larger than buffer stride", "accessor 10 needs 40 bytes but bufferView 0 has only 36"},
+    {"accessor count larger than buffer size", "accessor 11 needs 33 bytes but bufferView 1 has only 32"},
+    {"buffer view range out of bounds", "bufferView 2 needs 72 bytes but buffer 0 has only 68"},
+    {"buffer index out of bounds", "buffer 1 out of bounds for 1 buffers"},
+    {"buffer view index out of bounds", "bufferView 4 out of bounds for 4 views"},
+    {"normalized float", "floating-point component types can't be normalized"},
+    {"non-normalized byte matrix", "unsupported matrix component type unnormalized 5120"},
+    {"accessor index out of bounds", "accessor 17 out of bounds for 17 accessors"}
+};
+
+constexpr struct {
+    const char* name;
+    const char* message;
+} ObjectInstancingInvalidData[]{
+    {"mismatched instance count", "mismatched instance count for attribute TRANSLATION, expected 1 but got 2"},
+    {"unexpected rotation type", "unexpected ROTATION type 3"}
+};
+
+constexpr struct {
+    const char* name;
+    const char* function;
+    const char* message;
+} SkinInvalidData[]{
+    {"mismatched inverse bind matrix count", "skin3DInverseBindMatrices", "mismatched inverse bind matrix count, expected 2 but got 1"},
+    {"unexpected inverse bind matrix type", "skin3DInverseBindMatrices", "unexpected inverse bind matrix type 4"},
+    {"unsupported inverse bind matrix component type", "skin3DInverseBindMatrices", "unsupported inverse bind matrix component type normalized 5120"},
+    {"inverse bind matrix accessor out of bounds", "skin3DInverseBindMatrices", "accessor 9 out of bounds for 9 accessors"},
+    {"joint out of bounds", "skin3DJoints", "joint node 4 out of bounds for 4 nodes"}
+};
+
+constexpr struct {
+    const char* name;
+    const char* message;
+} MeshSkinAttributesInvalidData[]{
+    {"unexpected joints type", "unexpected JOINTS type 3"},
+    {"unsupported joints component type", "unsupported JOINTS component type normalized 5121"},
+    {"unexpected weights type", "unexpected WEIGHTS type 3"},
+    {"unsupported weights component type", "unsupported WEIGHTS component type unnormalized 5121"}
+};
+
+constexpr struct {
+    const char* message;
+} MeshMorphTargetsInvalidData[]{
+    {"sparse index 5 out of bounds for 3 elements in accessor 11"},
+    {"mismatched vertex count for attribute POSITION, expected 3 but got 2"},
+    {"unexpected POSITION type 2"}
+};
+
+constexpr struct {
+    const char* name;
+    const char* message;
+} AnimationMorphTargetWeightsInvalidData[]{
+    {"invalid value count", "weights track has 5 values, which isn't a multiple of 2 keys"},
+    {"unexpected type", "weights track has unexpected type 2/5126"}
+};
+
+constexpr struct {
+    const char* name;
+    const char* message;
+} MeshSparseInvalidData[]{
+    {"sparse index out of bounds", "sparse index 5 out of bounds for 3 elements in accessor 3"},
+    {"sparse indices view too small", "sparse accessor 4 needs 4 bytes but bufferView 1 has only 2"},
+    {"unsupported sparse index component type", "unsupported sparse index component type 5126 in accessor 5"},
+    {"sparse index buffer", "sparse index accessors are not supported"}
+};
+
 constexpr struct {
     const char* name;
     const char* message;
@@ -465,16 +599,56 @@ TinyGltfImporterTest::TinyGltfImporterTest() {
     addTests({&TinyGltfImporterTest::objectTransformationQuaternionNormalizationEnabled,
               &TinyGltfImporterTest::objectTransformationQuaternionNormalizationDisabled});
 
+    addInstancedTests({&TinyGltfImporterTest::objectHierarchy},
+        Containers::arraySize(ObjectHierarchyData));
+
+    addTests({&TinyGltfImporterTest::objectHierarchyScene,
+              &TinyGltfImporterTest::objectHierarchyQuaternionNormalization,
+              &TinyGltfImporterTest::objectInstancing});
+
+    addInstancedTests({&TinyGltfImporterTest::objectInstancingInvalid},
+        Containers::arraySize(ObjectInstancingInvalidData));
+
+    addTests({&TinyGltfImporterTest::skin});
+
+    addInstancedTests({&TinyGltfImporterTest::skinInvalid},
+        Containers::arraySize(SkinInvalidData));
+
+    addTests({&TinyGltfImporterTest::meshSkinAttributes});
+
+    addInstancedTests({&TinyGltfImporterTest::meshSkinAttributesInvalid},
+        Containers::arraySize(MeshSkinAttributesInvalidData));
+
+    addTests({&TinyGltfImporterTest::meshMorphTargets});
+
+    addInstancedTests({&TinyGltfImporterTest::meshMorphTargetsInvalid},
+        Containers::arraySize(MeshMorphTargetsInvalidData));
+
+    addTests({&TinyGltfImporterTest::animationMorphTargetWeights,
+              &TinyGltfImporterTest::animationMorphTargetWeightsSpline});
+
+    addInstancedTests({&TinyGltfImporterTest::animationMorphTargetWeightsInvalid},
+        Containers::arraySize(AnimationMorphTargetWeightsInvalidData));
+
     addInstancedTests({&TinyGltfImporterTest::mesh},
                       Containers::arraySize(MultiFileData));
 
     addTests({&TinyGltfImporterTest::meshAttributeless,
               &TinyGltfImporterTest::meshIndexed,
               &TinyGltfImporterTest::meshIndexedAttributeless,
+              &TinyGltfImporterTest::meshNarrowIndices,
+              &TinyGltfImporterTest::meshNarrowIndicesZeroCopy,
+              &TinyGltfImporterTest::meshZeroCopy,
+              &TinyGltfImporterTest::meshLazyBufferLoading,
+              &TinyGltfImporterTest::meshLazyBufferLoadingNoPathNoCallback,
               &TinyGltfImporterTest::meshColors,
               &TinyGltfImporterTest::meshCustomAttributes,
               &TinyGltfImporterTest::meshCustomAttributesNoFileOpened,
-              &TinyGltfImporterTest::meshMultiplePrimitives});
+              &TinyGltfImporterTest::meshMultiplePrimitives,
+              &TinyGltfImporterTest::meshMultipleBuffers,
+              &TinyGltfImporterTest::meshSparse,
+              &TinyGltfImporterTest::meshDracoInvalid,
+              &TinyGltfImporterTest::meshMeshoptCompression});
 
     addInstancedTests({&TinyGltfImporterTest::meshPrimitivesTypes},
         Containers::arraySize(MeshPrimitivesTypesData));
@@ -484,6 +658,14 @@ TinyGltfImporterTest::TinyGltfImporterTest() {
     addInstancedTests({&TinyGltfImporterTest::meshInvalid},
         Containers::arraySize(MeshInvalidData));
 
+    addTests({&TinyGltfImporterTest::meshTrustedInput});
+
+    addInstancedTests({&TinyGltfImporterTest::meshInvalidTrustedInput},
+        Containers::arraySize(MeshInvalidTrustedInputData));
+
+    addInstancedTests({&TinyGltfImporterTest::meshSparseInvalid},
+        Containers::arraySize(MeshSparseInvalidData));
+
     addTests({&TinyGltfImporterTest::materialPbrMetallicRoughness,
               &TinyGltfImporterTest::materialPbrSpecularGlossiness,
               &TinyGltfImporterTest::materialProperties,
@@ -515,7 +697,13 @@ TinyGltfImporterTest::TinyGltfImporterTest() {
     addInstancedTests({&TinyGltfImporterTest::imageBasis},
                       Containers::arraySize(ImageBasisData));
 
-    addTests({&TinyGltfImporterTest::imageMipLevels});
+    addTests({&TinyGltfImporterTest::imageBasisFormat});
+
+    addTests({&TinyGltfImporterTest::imageThreads,
+              &TinyGltfImporterTest::imagePrefetch,
+              &TinyGltfImporterTest::imagePrefetchNotFound,
+              &TinyGltfImporterTest::imageImporterCache,
+              &TinyGltfImporterTest::imageMipLevels});
 
     addInstancedTests({&TinyGltfImporterTest::fileCallbackBuffer,
                        &TinyGltfImporterTest::fileCallbackBufferNotFound,
@@ -523,7 +711,9 @@ TinyGltfImporterTest::TinyGltfImporterTest() {
                        &TinyGltfImporterTest::fileCallbackImageNotFound},
                       Containers::arraySize(SingleFileData));
 
-    addTests({&TinyGltfImporterTest::utf8filenames});
+    addTests({&TinyGltfImporterTest::profiling,
+
+              &TinyGltfImporterTest::utf8filenames});
 
     /* Load the plugin directly from the build tree. Otherwise it's static and
        already loaded. It also pulls in the AnyImageImporter dependency. Reset
@@ -1524,6 +1714,469 @@ void TinyGltfImporterTest::objectTransformationQuaternionNormalizationDisabled()
     CORRADE_COMPARE(object->rotation(), Quaternion::rotation(45.0_degf, Vector3::yAxis())*2.0f);
 }
 
+void TinyGltfImporterTest::objectHierarchy() {
+    auto&& data = ObjectHierarchyData[testCaseInstanceId()];
+    setTestCaseDescription(data.filename);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR, data.filename)));
+
+    auto& gltfImporter = static_cast<TinyGltfImporter&>(*importer);
+    const TinyGltfImporter::Object3DHierarchy hierarchy = gltfImporter.object3DHierarchy();
+    const UnsignedInt count = importer->object3DCount();
+    CORRADE_COMPARE(hierarchy.parents.size(), count);
+    CORRADE_COMPARE(hierarchy.flags.size(), count);
+    CORRADE_COMPARE(hierarchy.transformations.size(), count);
+    CORRADE_COMPARE(hierarchy.translations.size(), count);
+    CORRADE_COMPARE(hierarchy.rotations.size(), count);
+    CORRADE_COMPARE(hierarchy.scalings.size(), count);
+    CORRADE_COMPARE(hierarchy.meshes.size(), count);
+    CORRADE_COMPARE(hierarchy.materials.size(), count);
+    CORRADE_COMPARE(hierarchy.cameras.size(), count);
+    CORRADE_COMPARE(hierarchy.lights.size(), count);
+    CORRADE_COMPARE(hierarchy.skins.size(), count);
+
+    /* Everything should match what the per-object API returns */
+    for(UnsignedInt i = 0; i != count; ++i) {
+        CORRADE_ITERATION(i);
+        Containers::Pointer<ObjectData3D> object = importer->object3D(i);
+        CORRADE_VERIFY(object);
+
+        std::size_t childCount = 0;
+        for(const Int parent: hierarchy.parents)
+            if(parent == Int(i)) ++childCount;
+        CORRADE_COMPARE(childCount, object->children().size());
+        for(const UnsignedInt child: object->children())
+            CORRADE_COMPARE(hierarchy.parents[child], Int(i));
+
+        CORRADE_COMPARE(hierarchy.flags[i], object->flags());
+        CORRADE_COMPARE(hierarchy.transformations[i], object->transformation());
+        if(object->flags() & ObjectFlag3D::HasTranslationRotationScaling) {
+            CORRADE_COMPARE(hierarchy.translations[i], object->translation());
+            CORRADE_COMPARE(hierarchy.rotations[i], object->rotation());
+            CORRADE_COMPARE(hierarchy.scalings[i], object->scaling());
+        }
+
+        if(object->instanceType() == ObjectInstanceType3D::Mesh) {
+            CORRADE_COMPARE(hierarchy.meshes[i], object->instance());
+            CORRADE_COMPARE(hierarchy.materials[i], static_cast<MeshObjectData3D&>(*object).material());
+        } else CORRADE_COMPARE(hierarchy.meshes[i], -1);
+        if(object->instanceType() == ObjectInstanceType3D::Camera)
+            CORRADE_COMPARE(hierarchy.cameras[i], object->instance());
+        if(object->instanceType() == ObjectInstanceType3D::Light)
+            CORRADE_COMPARE(hierarchy.lights[i], object->instance());
+        CORRADE_COMPARE(hierarchy.skins[i], gltfImporter.object3DSkin(i));
+    }
+}
+
+void TinyGltfImporterTest::objectHierarchyScene() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "scene.gltf")));
+
+    const TinyGltfImporter::Object3DHierarchy hierarchy = static_cast<TinyGltfImporter&>(*importer).object3DHierarchy();
+    CORRADE_COMPARE_AS(hierarchy.parents,
+        Containers::arrayView<Int>({1, 4, -1, 4, -1}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(hierarchy.meshes,
+        Containers::arrayView<Int>({-1, -1, 0, -1, -1}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(hierarchy.cameras,
+        Containers::arrayView<Int>({0, -1, -1, -1, -1}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(hierarchy.lights,
+        Containers::arrayView<Int>({-1, -1, -1, 0, -1}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(hierarchy.rotations[3], Quaternion::rotation(-90.0_degf, Vector3::xAxis()));
+}
+
+void TinyGltfImporterTest::objectHierarchyQuaternionNormalization() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "object-transformation-patching.gltf")));
+
+    TinyGltfImporter::Object3DHierarchy hierarchy;
+    std::ostringstream out;
+    {
+        Warning warningRedirection{&out};
+        hierarchy = static_cast<TinyGltfImporter&>(*importer).object3DHierarchy();
+    }
+    CORRADE_COMPARE(out.str(), "Trade::TinyGltfImporter::object3DHierarchy(): 1 rotation quaternions were renormalized\n");
+    CORRADE_COMPARE(hierarchy.rotations.size(), 1);
+    CORRADE_COMPARE(hierarchy.rotations[0], Quaternion::rotation(45.0_degf, Vector3::yAxis()));
+
+    /* Disabling the option keeps the original */
+    importer->configuration().setValue("normalizeQuaternions", false);
+    out.str({});
+    {
+        Warning warningRedirection{&out};
+        hierarchy = static_cast<TinyGltfImporter&>(*importer).object3DHierarchy();
+    }
+    CORRADE_COMPARE(out.str(), "");
+    CORRADE_COMPARE(hierarchy.rotations[0], Quaternion::rotation(45.0_degf, Vector3::yAxis())*2.0f);
+}
+
+void TinyGltfImporterTest::objectInstancing() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "object-instancing.gltf")));
+
+    /* The instances are not expanded to separate objects */
+    CORRADE_COMPARE(importer->object3DCount(), 4);
+
+    auto& gltfImporter = static_cast<TinyGltfImporter&>(*importer);
+    CORRADE_COMPARE(gltfImporter.object3DInstanceCount(importer->object3DForName("not instanced")), 0);
+
+    const Int id = importer->object3DForName("instanced");
+    CORRADE_COMPARE(gltfImporter.object3DInstanceCount(id), 2);
+
+    const MeshAttribute translation = importer->meshAttributeForName("TRANSLATION");
+    const MeshAttribute rotation = importer->meshAttributeForName("ROTATION");
+    const MeshAttribute scale = importer->meshAttributeForName("SCALE");
+    CORRADE_VERIFY(isMeshAttributeCustom(translation));
+    CORRADE_VERIFY(isMeshAttributeCustom(rotation));
+    CORRADE_VERIFY(isMeshAttributeCustom(scale));
+
+    Containers::Optional<MeshData> instances = gltfImporter.object3DInstances(id);
+    CORRADE_VERIFY(instances);
+    CORRADE_VERIFY(instances->importerState());
+    CORRADE_COMPARE(instances->primitive(), MeshPrimitive::Instances);
+    CORRADE_VERIFY(!instances->isIndexed());
+    CORRADE_COMPARE(instances->vertexCount(), 2);
+    /* All attributes tightly packed in a single buffer */
+    CORRADE_COMPARE(instances->vertexData().size(), 2*4 + 2*12 + 2*12);
+    CORRADE_COMPARE(instances->attributeCount(), 3);
+
+    CORRADE_COMPARE(instances->attributeFormat(translation), VertexFormat::Vector3);
+    CORRADE_COMPARE_AS(instances->attribute<Vector3>(translation),
+        Containers::arrayView<Vector3>({
+            {1.0f, 2.0f, 3.0f},
+            {4.0f, 5.0f, 6.0f}
+        }), TestSuite::Compare::Container);
+
+    /* Quantized rotation is kept as-is */
+    CORRADE_COMPARE(instances->attributeFormat(rotation), VertexFormat::Vector4bNormalized);
+    CORRADE_COMPARE_AS(instances->attribute<Vector4b>(rotation),
+        Containers::arrayView<Vector4b>({
+            {0, 0, 0, 127},
+            {0, 127, 0, 0}
+        }), TestSuite::Compare::Container);
+
+    /* Sparse accessor without a buffer view */
+    CORRADE_COMPARE(instances->attributeFormat(scale), VertexFormat::Vector3);
+    CORRADE_COMPARE_AS(instances->attribute<Vector3>(scale),
+        Containers::arrayView<Vector3>({
+            {0.0f, 0.0f, 0.0f},
+            {2.0f, 2.0f, 2.0f}
+        }), TestSuite::Compare::Container);
+}
+
+void TinyGltfImporterTest::objectInstancingInvalid() {
+    auto&& data = ObjectInstancingInvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "object-instancing.gltf")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!static_cast<TinyGltfImporter&>(*importer).object3DInstances(importer->object3DForName(data.name)));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::TinyGltfImporter::object3DInstances(): {}\n", data.message));
+}
+
+void TinyGltfImporterTest::skin() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "skin.gltf")));
+
+    auto& gltfImporter = static_cast<TinyGltfImporter&>(*importer);
+    CORRADE_COMPARE(gltfImporter.skin3DCount(), 7);
+    CORRADE_COMPARE(gltfImporter.object3DSkin(importer->object3DForName("not skinned")), -1);
+    CORRADE_COMPARE(gltfImporter.skin3DForName("nonexistent"), -1);
+
+    const Int id = gltfImporter.object3DSkin(importer->object3DForName("skinned"));
+    CORRADE_COMPARE(id, 0);
+    CORRADE_COMPARE(gltfImporter.skin3DForName("skin"), 0);
+    CORRADE_COMPARE(gltfImporter.skin3DName(id), "skin");
+
+    Containers::Optional<Containers::Array<UnsignedInt>> joints = gltfImporter.skin3DJoints(id);
+    CORRADE_VERIFY(joints);
+    CORRADE_COMPARE_AS(*joints, Containers::arrayView<UnsignedInt>({
+        UnsignedInt(importer->object3DForName("joint root")),
+        UnsignedInt(importer->object3DForName("joint child"))
+    }), TestSuite::Compare::Container);
+
+    Containers::Optional<Containers::Array<Matrix4>> inverseBindMatrices = gltfImporter.skin3DInverseBindMatrices(id);
+    CORRADE_VERIFY(inverseBindMatrices);
+    CORRADE_COMPARE_AS(*inverseBindMatrices, Containers::arrayView<Matrix4>({
+        Matrix4{},
+        Matrix4::translation({-1.0f, 0.0f, 0.0f})
+    }), TestSuite::Compare::Container);
+
+    /* Without an accessor the matrices are identities */
+    const Int implicitId = gltfImporter.skin3DForName("implicit inverse bind matrices");
+    CORRADE_COMPARE(implicitId, 1);
+    Containers::Optional<Containers::Array<Matrix4>> implicitInverseBindMatrices = gltfImporter.skin3DInverseBindMatrices(implicitId);
+    CORRADE_VERIFY(implicitInverseBindMatrices);
+    CORRADE_COMPARE_AS(*implicitInverseBindMatrices, Containers::arrayView<Matrix4>({
+        Matrix4{},
+        Matrix4{}
+    }), TestSuite::Compare::Container);
+}
+
+void TinyGltfImporterTest::skinInvalid() {
+    auto&& data = SkinInvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "skin.gltf")));
+
+    auto& gltfImporter = static_cast<TinyGltfImporter&>(*importer);
+    const Int id = gltfImporter.skin3DForName(data.name);
+    CORRADE_VERIFY(id != -1);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    if(std::string{data.function} == "skin3DJoints")
+        CORRADE_VERIFY(!gltfImporter.skin3DJoints(id));
+    else
+        CORRADE_VERIFY(!gltfImporter.skin3DInverseBindMatrices(id));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::TinyGltfImporter::{}(): {}\n", data.function, data.message));
+}
+
+void TinyGltfImporterTest::meshSkinAttributes() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "skin.gltf")));
+
+    /* There are no builtin attributes for these, so they're custom */
+    const MeshAttribute joints = importer->meshAttributeForName("JOINTS_0");
+    const MeshAttribute weights = importer->meshAttributeForName("WEIGHTS_0");
+    CORRADE_VERIFY(isMeshAttributeCustom(joints));
+    CORRADE_VERIFY(isMeshAttributeCustom(weights));
+    CORRADE_COMPARE(importer->meshAttributeName(joints), "JOINTS_0");
+    CORRADE_COMPARE(importer->meshAttributeName(weights), "WEIGHTS_0");
+
+    Containers::Optional<MeshData> mesh = importer->mesh("skinned");
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->attributeCount(), 3);
+
+    /* The data are kept in their compact types */
+    CORRADE_VERIFY(mesh->hasAttribute(joints));
+    CORRADE_COMPARE(mesh->attributeFormat(joints), VertexFormat::Vector4ub);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector4ub>(joints),
+        Containers::arrayView<Vector4ub>({
+            {0, 1, 0, 0},
+            {1, 0, 0, 0}
+        }), TestSuite::Compare::Container);
+
+    CORRADE_VERIFY(mesh->hasAttribute(weights));
+    CORRADE_COMPARE(mesh->attributeFormat(weights), VertexFormat::Vector4ubNormalized);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector4ub>(weights),
+        Containers::arrayView<Vector4ub>({
+            {128, 127, 0, 0},
+            {255, 0, 0, 0}
+        }), TestSuite::Compare::Container);
+}
+
+void TinyGltfImporterTest::meshSkinAttributesInvalid() {
+    auto&& data = MeshSkinAttributesInvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "skin.gltf")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->mesh(data.name));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::TinyGltfImporter::mesh(): {}\n", data.message));
+}
+
+void TinyGltfImporterTest::meshMorphTargets() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "mesh-morph-targets.gltf")));
+
+    auto& gltfImporter = static_cast<TinyGltfImporter&>(*importer);
+    const Int id = importer->meshForName("morphed");
+    CORRADE_COMPARE(gltfImporter.meshMorphTargetCount(id), 3);
+
+    /* The mesh has only two weights for three targets, the rest is zero */
+    CORRADE_COMPARE_AS(gltfImporter.meshMorphTargetWeights(id),
+        Containers::arrayView<Float>({0.5f, 0.25f, 0.0f}),
+        TestSuite::Compare::Container);
+
+    /* The base mesh isn't affected by the targets */
+    Containers::Optional<MeshData> mesh = importer->mesh(id);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->attributeCount(), 1);
+
+    /* Dense target, attributes tightly packed after each other */
+    {
+        Containers::Optional<MeshData> target = gltfImporter.meshMorphTarget(id, 0);
+        CORRADE_VERIFY(target);
+        CORRADE_VERIFY(target->importerState());
+        CORRADE_COMPARE(target->primitive(), MeshPrimitive::Points);
+        CORRADE_VERIFY(!target->isIndexed());
+        CORRADE_COMPARE(target->vertexCount(), 3);
+        CORRADE_COMPARE(target->vertexData().size(), 2*3*12);
+        CORRADE_COMPARE(target->attributeCount(), 2);
+        CORRADE_COMPARE(target->attributeFormat(MeshAttribute::Position), VertexFormat::Vector3);
+        CORRADE_COMPARE_AS(target->attribute<Vector3>(MeshAttribute::Position),
+            Containers::arrayView<Vector3>({
+                {0.1f, 0.0f, 0.0f},
+                {0.2f, 0.0f, 0.0f},
+                {0.3f, 0.0f, 0.0f}
+            }), TestSuite::Compare::Container);
+        CORRADE_COMPARE(target->attributeFormat(MeshAttribute::Normal), VertexFormat::Vector3);
+        CORRADE_COMPARE_AS(target->attribute<Vector3>(MeshAttribute::Normal),
+            Containers::arrayView<Vector3>({
+                {0.0f, 0.0f, 1.0f},
+                {0.0f, 0.0f, 2.0f},
+                {0.0f, 0.0f, 3.0f}
+            }), TestSuite::Compare::Container);
+    }
+
+    /* Sparse target with all attributes sharing the same indices, kept
+       sparse */
+    {
+        Containers::Optional<MeshData> target = gltfImporter.meshMorphTarget(id, 1);
+        CORRADE_VERIFY(target);
+        CORRADE_VERIFY(target->isIndexed());
+        CORRADE_COMPARE(target->indexType(), MeshIndexType::UnsignedByte);
+        CORRADE_COMPARE_AS(target->indices<UnsignedByte>(),
+            Containers::arrayView<UnsignedByte>({0, 2}),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE(target->vertexCount(), 2);
+        CORRADE_COMPARE(target->vertexData().size(), 2*2*12);
+        CORRADE_COMPARE_AS(target->attribute<Vector3>(MeshAttribute::Position),
+            Containers::arrayView<Vector3>({
+                {1.0f, 2.0f, 3.0f},
+                {4.0f, 5.0f, 6.0f}
+            }), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(target->attribute<Vector3>(MeshAttribute::Normal),
+            Containers::arrayView<Vector3>({
+                {-1.0f, 0.0f, 0.0f},
+                {0.0f, -1.0f, 0.0f}
+            }), TestSuite::Compare::Container);
+    }
+
+    /* Sparse target with a buffer view, expanded with sparse values
+       applied */
+    {
+        Containers::Optional<MeshData> target = gltfImporter.meshMorphTarget(id, 2);
+        CORRADE_VERIFY(target);
+        CORRADE_VERIFY(!target->isIndexed());
+        CORRADE_COMPARE(target->vertexCount(), 3);
+        CORRADE_COMPARE_AS(target->attribute<Vector3>(MeshAttribute::Position),
+            Containers::arrayView<Vector3>({
+                {1.0f, 2.0f, 3.0f},
+                {0.2f, 0.0f, 0.0f},
+                {4.0f, 5.0f, 6.0f}
+            }), TestSuite::Compare::Container);
+    }
+}
+
+void TinyGltfImporterTest::meshMorphTargetsInvalid() {
+    auto&& data = MeshMorphTargetsInvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.message);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "mesh-morph-targets.gltf")));
+
+    auto& gltfImporter = static_cast<TinyGltfImporter&>(*importer);
+    const Int id = importer->meshForName("invalid");
+    /* Check we didn't forget to test anything */
+    CORRADE_COMPARE(gltfImporter.meshMorphTargetCount(id), Containers::arraySize(MeshMorphTargetsInvalidData));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!gltfImporter.meshMorphTarget(id, testCaseInstanceId()));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::TinyGltfImporter::meshMorphTarget(): {}\n", data.message));
+}
+
+void TinyGltfImporterTest::animationMorphTargetWeights() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "mesh-morph-targets.gltf")));
+
+    Containers::Optional<AnimationData> animation = importer->animation("linear");
+    CORRADE_VERIFY(animation);
+
+    /* One track for each target, referencing the interleaved values */
+    CORRADE_COMPARE(animation->trackCount(), 3);
+    CORRADE_COMPARE(animation->data().size(), 2*4 + 6*4);
+    constexpr Float expected[][2]{
+        {0.0f, 1.0f},
+        {0.5f, 0.5f},
+        {1.0f, 0.0f}
+    };
+    for(UnsignedInt i = 0; i != 3; ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(animation->trackType(i), AnimationTrackType::Float);
+        CORRADE_COMPARE(animation->trackResultType(i), AnimationTrackType::Float);
+        CORRADE_COMPARE(animation->trackTargetType(i), AnimationTrackTargetType::Custom);
+        CORRADE_COMPARE(animation->trackTarget(i), UnsignedInt(importer->object3DForName("morphed")));
+
+        Animation::TrackView<const Float, const Float> track = animation->track<Float>(i);
+        CORRADE_COMPARE(track.interpolation(), Animation::Interpolation::Linear);
+        CORRADE_COMPARE_AS(track.keys(),
+            Containers::stridedArrayView<Float>({0.0f, 2.0f}),
+            TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(track.values(),
+            Containers::stridedArrayView(expected[i]),
+            TestSuite::Compare::Container);
+    }
+}
+
+void TinyGltfImporterTest::animationMorphTargetWeightsSpline() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "mesh-morph-targets.gltf")));
+
+    Containers::Optional<AnimationData> animation = importer->animation("spline");
+    CORRADE_VERIFY(animation);
+    CORRADE_COMPARE(animation->trackCount(), 3);
+
+    /* The in-tangents, values and out-tangents are reordered to triplets
+       and the tangents scaled by the time difference of 2 */
+    constexpr CubicHermite1D expected[][2]{
+        {{0.1f, 0.0f, 0.8f}, {1.4f, 1.0f, 1.1f}},
+        {{0.2f, 0.5f, 1.0f}, {1.6f, 0.5f, 1.2f}},
+        {{0.3f, 1.0f, 1.2f}, {1.8f, 0.0f, 1.3f}}
+    };
+    for(UnsignedInt i = 0; i != 3; ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(animation->trackType(i), AnimationTrackType::CubicHermite1D);
+        CORRADE_COMPARE(animation->trackResultType(i), AnimationTrackType::Float);
+        CORRADE_COMPARE(animation->trackTargetType(i), AnimationTrackTargetType::Custom);
+
+        Animation::TrackView<const Float, const CubicHermite1D> track = animation->track<CubicHermite1D>(i);
+        CORRADE_COMPARE(track.interpolation(), Animation::Interpolation::Spline);
+        CORRADE_COMPARE_AS(track.values(),
+            Containers::stridedArrayView(expected[i]),
+            TestSuite::Compare::Container);
+    }
+}
+
+void TinyGltfImporterTest::animationMorphTargetWeightsInvalid() {
+    auto&& data = AnimationMorphTargetWeightsInvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "mesh-morph-targets.gltf")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->animation(data.name));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::TinyGltfImporter::animation(): {}\n", data.message));
+}
+
 void TinyGltfImporterTest::mesh() {
     auto&& data = MultiFileData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -1634,6 +2287,104 @@ void TinyGltfImporterTest::meshIndexed() {
         }), TestSuite::Compare::Container);
 }
 
+void TinyGltfImporterTest::meshZeroCopy() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    importer->configuration().setValue("zeroCopy", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "mesh.gltf")));
+
+    /* No texture coordinates, so referenced directly */
+    auto mesh = importer->mesh("Indexed mesh");
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->indexDataFlags(), DataFlags{});
+    CORRADE_COMPARE(mesh->vertexDataFlags(), DataFlags{});
+    CORRADE_COMPARE(mesh->indexType(), MeshIndexType::UnsignedByte);
+    CORRADE_COMPARE_AS(mesh->indices<UnsignedByte>(),
+        Containers::arrayView<UnsignedByte>({0, 1, 2}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(mesh->attributeCount(), 4);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {1.5f, -1.0f, -0.5f},
+            {-0.5f, 2.5f, 0.75f},
+            {-2.0f, 1.0f, 0.3f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<UnsignedInt>(MeshAttribute::ObjectId),
+        Containers::arrayView<UnsignedInt>({
+            215, 71, 133
+        }), TestSuite::Compare::Container);
+
+    /* Texture coordinates need a Y-flip, so the data get copied */
+    auto withTextureCoordinates = importer->mesh(0);
+    CORRADE_VERIFY(withTextureCoordinates);
+    CORRADE_VERIFY(withTextureCoordinates->hasAttribute(MeshAttribute::TextureCoordinates));
+    CORRADE_COMPARE(withTextureCoordinates->vertexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+}
+
+void TinyGltfImporterTest::meshLazyBufferLoading() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    importer->configuration().setValue("lazyBufferLoading", true);
+
+    /* Load from the filesystem, but record which files get loaded */
+    struct {
+        Containers::Array<char> files[2];
+        std::size_t current = 0;
+        std::ostringstream out;
+    } callbackData;
+    importer->setFileCallback([](const std::string& filename, InputFileCallbackPolicy policy, decltype(callbackData)& data) -> Containers::Optional<Containers::ArrayView<const char>> {
+        if(policy == InputFileCallbackPolicy::Close) return {};
+        data.out << Utility::Directory::filename(filename) << " ";
+        Containers::Array<char>& file = data.files[data.current++ % 2];
+        file = Utility::Directory::read(filename);
+        return Containers::ArrayView<const char>{file};
+    }, callbackData);
+
+    /* Not loaded on open */
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "mesh.gltf")));
+    CORRADE_COMPARE(callbackData.out.str(), "mesh.gltf ");
+
+    /* Meshes 0, 1 and 3 reference the buffer, 2 doesn't */
+    auto mesh = importer->mesh(1);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {1.5f, -1.0f, -0.5f},
+            {-0.5f, 2.5f, 0.75f},
+            {-2.0f, 1.0f, 0.3f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE(callbackData.out.str(), "mesh.gltf mesh.bin ");
+
+    /* Stays loaded until all meshes referencing it are imported */
+    CORRADE_VERIFY(importer->mesh(0));
+    CORRADE_VERIFY(importer->mesh(2));
+    CORRADE_VERIFY(importer->mesh(3));
+    CORRADE_COMPARE(callbackData.out.str(), "mesh.gltf mesh.bin ");
+
+    /* Released after that, so importing again loads it again */
+    mesh = importer->mesh(1);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE_AS(mesh->indices<UnsignedByte>(),
+        Containers::arrayView<UnsignedByte>({0, 1, 2}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE(callbackData.out.str(), "mesh.gltf mesh.bin mesh.bin ");
+}
+
+void TinyGltfImporterTest::meshLazyBufferLoadingNoPathNoCallback() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    importer->configuration().setValue("lazyBufferLoading", true);
+
+    /* Opening succeeds, as the buffer isn't needed yet */
+    CORRADE_VERIFY(importer->openData(Utility::Directory::read(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "mesh.gltf"))));
+    CORRADE_VERIFY(importer->mesh(2));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->mesh(1));
+    CORRADE_COMPARE(out.str(), "Trade::TinyGltfImporter::mesh(): error loading buffer 0: external buffers can be imported only when opening files from the filesystem or if a file callback is present\n");
+}
+
 void TinyGltfImporterTest::meshIndexedAttributeless() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
@@ -1651,6 +2402,67 @@ void TinyGltfImporterTest::meshIndexedAttributeless() {
     CORRADE_COMPARE(mesh->attributeCount(), 0);
 }
 
+void TinyGltfImporterTest::meshNarrowIndices() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    importer->configuration().setValue("narrowIndices", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "mesh-narrow-indices.gltf")));
+
+    CORRADE_COMPARE(importer->meshCount(), 4);
+
+    {
+        auto mesh = importer->mesh("unsigned int to unsigned short");
+        CORRADE_VERIFY(mesh);
+        CORRADE_VERIFY(mesh->isIndexed());
+        CORRADE_COMPARE(mesh->indexType(), MeshIndexType::UnsignedShort);
+        CORRADE_COMPARE(mesh->indexCount(), 3);
+        CORRADE_COMPARE_AS(mesh->indices<UnsignedShort>(),
+            Containers::arrayView<UnsignedShort>({0, 256, 65535}),
+            TestSuite::Compare::Container);
+    } {
+        auto mesh = importer->mesh("unsigned int kept");
+        CORRADE_VERIFY(mesh);
+        CORRADE_VERIFY(mesh->isIndexed());
+        CORRADE_COMPARE(mesh->indexType(), MeshIndexType::UnsignedInt);
+        CORRADE_COMPARE_AS(mesh->indices<UnsignedInt>(),
+            Containers::arrayView<UnsignedInt>({0, 65536, 1}),
+            TestSuite::Compare::Container);
+    } {
+        auto mesh = importer->mesh("unsigned int to unsigned byte");
+        CORRADE_VERIFY(mesh);
+        CORRADE_VERIFY(mesh->isIndexed());
+        CORRADE_COMPARE(mesh->indexType(), MeshIndexType::UnsignedByte);
+        CORRADE_COMPARE_AS(mesh->indices<UnsignedByte>(),
+            Containers::arrayView<UnsignedByte>({3, 255, 0}),
+            TestSuite::Compare::Container);
+    } {
+        auto mesh = importer->mesh("unsigned short to unsigned byte");
+        CORRADE_VERIFY(mesh);
+        CORRADE_VERIFY(mesh->isIndexed());
+        CORRADE_COMPARE(mesh->indexType(), MeshIndexType::UnsignedByte);
+        CORRADE_COMPARE_AS(mesh->indices<UnsignedByte>(),
+            Containers::arrayView<UnsignedByte>({0, 255, 3}),
+            TestSuite::Compare::Container);
+    }
+}
+
+void TinyGltfImporterTest::meshNarrowIndicesZeroCopy() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    importer->configuration().setValue("narrowIndices", true);
+    importer->configuration().setValue("zeroCopy", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "mesh-narrow-indices.gltf")));
+
+    /* Referenced indices are kept as-is */
+    auto mesh = importer->mesh("unsigned int to unsigned byte");
+    CORRADE_VERIFY(mesh);
+    CORRADE_VERIFY(mesh->isIndexed());
+    CORRADE_COMPARE(mesh->indexType(), MeshIndexType::UnsignedInt);
+    CORRADE_COMPARE_AS(mesh->indices<UnsignedInt>(),
+        Containers::arrayView<UnsignedInt>({3, 255, 0}),
+        TestSuite::Compare::Container);
+}
+
 void TinyGltfImporterTest::meshColors() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
@@ -1777,6 +2589,177 @@ void TinyGltfImporterTest::meshCustomAttributesNoFileOpened() {
     CORRADE_COMPARE(importer->meshAttributeForName("thing"), MeshAttribute{});
 }
 
+void TinyGltfImporterTest::meshMultipleBuffers() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    /* Attributes in multiple buffers can't be referenced directly */
+    importer->configuration().setValue("zeroCopy", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "mesh-multiple-buffers.gltf")));
+
+    auto mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_COMPARE(mesh->vertexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+    /* Both views copied after each other */
+    CORRADE_COMPARE(mesh->vertexData().size(), 88);
+    CORRADE_COMPARE(mesh->attributeCount(), 3);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView<Vector3>({
+            {1.5f, -1.0f, -0.5f},
+            {-0.5f, 2.5f, 0.75f},
+            {-2.0f, 1.0f, 0.3f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Normal),
+        Containers::arrayView<Vector3>({
+            {0.1f, 0.2f, 0.3f},
+            {0.4f, 0.5f, 0.6f},
+            {0.7f, 0.8f, 0.9f}
+        }), TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<UnsignedInt>(MeshAttribute::ObjectId),
+        Containers::arrayView<UnsignedInt>({
+            215, 71, 133
+        }), TestSuite::Compare::Container);
+}
+
+void TinyGltfImporterTest::meshSparse() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    /* Sparse values are applied on a copy */
+    importer->configuration().setValue("zeroCopy", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "mesh-sparse.gltf")));
+
+    {
+        auto mesh = importer->mesh("sparse positions");
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->vertexDataFlags(), DataFlag::Owned|DataFlag::Mutable);
+        CORRADE_COMPARE(mesh->vertexCount(), 3);
+        CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+            Containers::arrayView<Vector3>({
+                {1.5f, -1.0f, -0.5f},
+                {-0.5f, 2.5f, 0.75f},
+                {7.0f, 8.0f, 9.0f}
+            }), TestSuite::Compare::Container);
+    }
+
+    /* The accessor without a buffer view gets put after the copied range,
+       the original buffer is unaffected by the substitution above */
+    {
+        auto mesh = importer->mesh("sparse without a buffer view");
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->vertexData().size(), 72);
+        CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+            Containers::arrayView<Vector3>({
+                {1.5f, -1.0f, -0.5f},
+                {-0.5f, 2.5f, 0.75f},
+                {-2.0f, 1.0f, 0.3f}
+            }), TestSuite::Compare::Container);
+        CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Normal),
+            Containers::arrayView<Vector3>({
+                {0.0f, 0.0f, 0.0f},
+                {0.0f, 1.0f, 0.0f},
+                {0.0f, 0.0f, 0.0f}
+            }), TestSuite::Compare::Container);
+    }
+}
+
+void TinyGltfImporterTest::meshSparseInvalid() {
+    auto&& data = MeshSparseInvalidData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "mesh-sparse.gltf")));
+
+    /* Check we didn't forget to test anything */
+    CORRADE_COMPARE(importer->meshCount(), Containers::arraySize(MeshSparseInvalidData) + 2);
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->mesh(data.name));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::TinyGltfImporter::mesh(): {}\n", data.message));
+}
+
+void TinyGltfImporterTest::meshDracoInvalid() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "mesh-draco-invalid.gltf")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->mesh(0));
+    #ifdef MAGNUM_TINYGLTFIMPORTER_WITH_DRACO
+    CORRADE_COMPARE(out.str(), "Trade::TinyGltfImporter::mesh(): can't decode KHR_draco_mesh_compression data\n");
+    #else
+    CORRADE_COMPARE(out.str(), "Trade::TinyGltfImporter::mesh(): KHR_draco_mesh_compression is not supported, the plugin was built without Draco\n");
+    #endif
+}
+
+void TinyGltfImporterTest::meshMeshoptCompression() {
+    #ifndef MAGNUM_TINYGLTFIMPORTER_WITH_MESHOPTIMIZER
+    CORRADE_SKIP("The plugin was built without meshoptimizer, cannot test");
+    #else
+    /* Encode the data using meshoptimizer itself instead of relying on a
+       binary file */
+    const Vector3 positions[]{
+        {1.5f, -1.0f, -0.5f},
+        {-0.5f, 2.5f, 0.75f},
+        {-2.0f, 1.0f, 0.3f}
+    };
+    const UnsignedInt indices[]{0, 1, 2, 2, 1, 0};
+    Containers::Array<unsigned char> vertexBuffer{meshopt_encodeVertexBufferBound(3, sizeof(Vector3))};
+    const Containers::ArrayView<const unsigned char> vertexData = vertexBuffer.prefix(meshopt_encodeVertexBuffer(vertexBuffer, vertexBuffer.size(), positions, 3, sizeof(Vector3)));
+    Containers::Array<unsigned char> indexBuffer{meshopt_encodeIndexBufferBound(6, 3)};
+    const Containers::ArrayView<const unsigned char> indexData = indexBuffer.prefix(meshopt_encodeIndexBuffer(indexBuffer, indexBuffer.size(), indices, 6));
+
+    /* Put it into a GLB, with the fallback buffer having no data */
+    const std::size_t indexOffset = (vertexData.size() + 3)/4*4;
+    const std::size_t binSize = (indexOffset + indexData.size() + 3)/4*4;
+    std::string json = Utility::formatString(R"({{
+    "asset": {{"version": "2.0"}},
+    "extensionsUsed": ["EXT_meshopt_compression"],
+    "extensionsRequired": ["EXT_meshopt_compression"],
+    "meshes": [{{"primitives": [{{"attributes": {{"POSITION": 0}}, "indices": 1}}]}}],
+    "accessors": [
+        {{"bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3"}},
+        {{"bufferView": 1, "componentType": 5123, "count": 6, "type": "SCALAR"}}
+    ],
+    "bufferViews": [
+        {{"buffer": 1, "byteLength": 36, "byteStride": 12, "extensions": {{"EXT_meshopt_compression": {{"buffer": 0, "byteLength": {}, "byteStride": 12, "count": 3, "mode": "ATTRIBUTES"}}}}}},
+        {{"buffer": 1, "byteOffset": 36, "byteLength": 12, "extensions": {{"EXT_meshopt_compression": {{"buffer": 0, "byteOffset": {}, "byteLength": {}, "byteStride": 2, "count": 6, "mode": "TRIANGLES"}}}}}}
+    ],
+    "buffers": [
+        {{"byteLength": {}}},
+        {{"byteLength": 48, "extensions": {{"EXT_meshopt_compression": {{"fallback": true}}}}}}
+    ]
+}})", vertexData.size(), indexOffset, indexData.size(), binSize);
+    json.resize((json.size() + 3)/4*4, ' ');
+
+    Containers::Array<char> glb{Containers::ValueInit, 28 + json.size() + binSize};
+    const UnsignedInt header[]{
+        0x46546C67, 2, UnsignedInt(glb.size()),
+        UnsignedInt(json.size()), 0x4E4F534A};
+    std::memcpy(glb, header, sizeof(header));
+    std::memcpy(glb + 20, json.data(), json.size());
+    const UnsignedInt binHeader[]{UnsignedInt(binSize), 0x004E4942};
+    std::memcpy(glb + 20 + json.size(), binHeader, sizeof(binHeader));
+    std::memcpy(glb + 28 + json.size(), vertexData, vertexData.size());
+    std::memcpy(glb + 28 + json.size() + indexOffset, indexData, indexData.size());
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    CORRADE_VERIFY(importer->openData(glb));
+
+    auto mesh = importer->mesh(0);
+    CORRADE_VERIFY(mesh);
+    CORRADE_VERIFY(mesh->isIndexed());
+    CORRADE_COMPARE(mesh->indexType(), MeshIndexType::UnsignedShort);
+    CORRADE_COMPARE_AS(mesh->indices<UnsignedShort>(),
+        Containers::arrayView<UnsignedShort>({0, 1, 2, 2, 1, 0}),
+        TestSuite::Compare::Container);
+    CORRADE_COMPARE_AS(mesh->attribute<Vector3>(MeshAttribute::Position),
+        Containers::arrayView(positions),
+        TestSuite::Compare::Container);
+    #endif
+}
+
 void TinyGltfImporterTest::meshMultiplePrimitives() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
@@ -2180,6 +3163,20 @@ void TinyGltfImporterTest::meshPrimitivesTypes() {
                 215, 71, 133, 5, 196
             }), TestSuite::Compare::Container);
     } else CORRADE_VERIFY(!mesh->hasAttribute(MeshAttribute::ObjectId));
+
+    /* The quantized data are never expanded, so with zero copy the mesh
+       references the same data with the same formats */
+    importer->configuration().setValue("zeroCopy", true);
+    auto zeroCopy = importer->mesh(data.name);
+    CORRADE_VERIFY(zeroCopy);
+    CORRADE_COMPARE(zeroCopy->vertexDataFlags(), DataFlags{});
+    CORRADE_COMPARE(zeroCopy->vertexData().size(), mesh->vertexData().size());
+    CORRADE_COMPARE(zeroCopy->attributeCount(), mesh->attributeCount());
+    for(UnsignedInt i = 0; i != mesh->attributeCount(); ++i) {
+        CORRADE_ITERATION(i);
+        CORRADE_COMPARE(zeroCopy->attributeFormat(i), mesh->attributeFormat(i));
+        CORRADE_COMPARE(zeroCopy->attributeStride(i), mesh->attributeStride(i));
+    }
 }
 
 void TinyGltfImporterTest::meshIndexAccessorOutOfBounds() {
@@ -2209,6 +3206,62 @@ void TinyGltfImporterTest::meshInvalid() {
     CORRADE_COMPARE(out.str(), Utility::formatString("Trade::TinyGltfImporter::mesh(): {}\n", data.message));
 }
 
+void TinyGltfImporterTest::meshTrustedInput() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    importer->configuration().setValue("trustedInput", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "skin.gltf")));
+
+    const MeshAttribute joints = importer->meshAttributeForName("JOINTS_0");
+    const MeshAttribute weights = importer->meshAttributeForName("WEIGHTS_0");
+
+    /* Valid meshes are imported the same */
+    {
+        Containers::Optional<MeshData> mesh = importer->mesh("skinned");
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->attributeCount(), 3);
+        CORRADE_COMPARE(mesh->attributeFormat(joints), VertexFormat::Vector4ub);
+        CORRADE_COMPARE(mesh->attributeFormat(weights), VertexFormat::Vector4ubNormalized);
+        CORRADE_COMPARE_AS(mesh->attribute<Vector4ub>(weights),
+            Containers::arrayView<Vector4ub>({
+                {128, 127, 0, 0},
+                {255, 0, 0, 0}
+            }), TestSuite::Compare::Container);
+
+    /* Types not allowed by the spec that fail in meshSkinAttributesInvalid()
+       are imported as-is */
+    } {
+        Containers::Optional<MeshData> mesh = importer->mesh("unexpected joints type");
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->attributeFormat(joints), VertexFormat::Vector3ub);
+        CORRADE_COMPARE(mesh->vertexCount(), 2);
+    } {
+        Containers::Optional<MeshData> mesh = importer->mesh("unsupported weights component type");
+        CORRADE_VERIFY(mesh);
+        CORRADE_COMPARE(mesh->attributeFormat(weights), VertexFormat::Vector4ub);
+        CORRADE_COMPARE_AS(mesh->attribute<Vector4ub>(weights),
+            Containers::arrayView<Vector4ub>({
+                {128, 127, 0, 0},
+                {255, 0, 0, 0}
+            }), TestSuite::Compare::Container);
+    }
+}
+
+void TinyGltfImporterTest::meshInvalidTrustedInput() {
+    auto&& data = MeshInvalidTrustedInputData[testCaseInstanceId()];
+    setTestCaseDescription(data.name);
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    importer->configuration().setValue("trustedInput", true);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
+        "mesh-invalid.gltf")));
+
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(!importer->mesh(data.name));
+    CORRADE_COMPARE(out.str(), Utility::formatString("Trade::TinyGltfImporter::mesh(): {}\n", data.message));
+}
+
 void TinyGltfImporterTest::materialPbrMetallicRoughness() {
     Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
     CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR,
@@ -2752,6 +3805,134 @@ void TinyGltfImporterTest::imageExternalNoPathNoCallback() {
     CORRADE_COMPARE(out.str(), "Trade::TinyGltfImporter::image2D(): external images can be imported only when opening files from the filesystem or if a file callback is present\n");
 }
 
+void TinyGltfImporterTest::imageThreads() {
+    if(_manager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    importer->configuration().setValue("threads", 2);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR, "image.gltf")));
+    CORRADE_COMPARE(importer->image2DCount(), 2);
+
+    /* Importing the first image decodes the second as well, which should then
+       be returned unchanged */
+    Containers::Optional<ImageData2D> image0 = importer->image2D(0);
+    CORRADE_COMPARE(importer->image2DLevelCount(1), 1);
+    Containers::Optional<ImageData2D> image1 = importer->image2D(1);
+
+    CORRADE_VERIFY(image0);
+    CORRADE_VERIFY(image0->importerState());
+    CORRADE_COMPARE(image0->size(), Vector2i(5, 3));
+    CORRADE_COMPARE(image0->format(), PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE_AS(image0->data(), Containers::arrayView(ExpectedImageData).prefix(60), TestSuite::Compare::Container);
+
+    CORRADE_VERIFY(image1);
+    CORRADE_VERIFY(image1->importerState());
+    CORRADE_VERIFY(image1->importerState() != image0->importerState());
+    CORRADE_COMPARE(image1->size(), Vector2i(5, 3));
+    CORRADE_COMPARE(image1->format(), PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE_AS(image1->data(), Containers::arrayView(ExpectedImageData).prefix(60), TestSuite::Compare::Container);
+
+    /* Importing again goes through the usual path */
+    Containers::Optional<ImageData2D> image1Again = importer->image2D(1);
+    CORRADE_VERIFY(image1Again);
+    CORRADE_COMPARE_AS(image1Again->data(), Containers::arrayView(ExpectedImageData).prefix(60), TestSuite::Compare::Container);
+}
+
+void TinyGltfImporterTest::imagePrefetch() {
+    if(_manager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    importer->configuration().setValue("prefetchImages", true);
+    importer->configuration().setValue("threads", 2);
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR, "image.gltf")));
+    CORRADE_COMPARE(importer->image2DCount(), 2);
+
+    /* Both images are being decoded already, the level count is known
+       without opening anything again */
+    CORRADE_COMPARE(importer->image2DLevelCount(1), 1);
+    Containers::Optional<ImageData2D> image1 = importer->image2D(1);
+    Containers::Optional<ImageData2D> image0 = importer->image2D(0);
+
+    CORRADE_VERIFY(image0);
+    CORRADE_VERIFY(image0->importerState());
+    CORRADE_COMPARE(image0->size(), Vector2i(5, 3));
+    CORRADE_COMPARE(image0->format(), PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE_AS(image0->data(), Containers::arrayView(ExpectedImageData).prefix(60), TestSuite::Compare::Container);
+
+    CORRADE_VERIFY(image1);
+    CORRADE_VERIFY(image1->importerState());
+    CORRADE_VERIFY(image1->importerState() != image0->importerState());
+    CORRADE_COMPARE(image1->size(), Vector2i(5, 3));
+    CORRADE_COMPARE(image1->format(), PixelFormat::RGBA8Unorm);
+    CORRADE_COMPARE_AS(image1->data(), Containers::arrayView(ExpectedImageData).prefix(60), TestSuite::Compare::Container);
+
+    /* Importing again goes through the usual path */
+    Containers::Optional<ImageData2D> image1Again = importer->image2D(1);
+    CORRADE_VERIFY(image1Again);
+    CORRADE_COMPARE_AS(image1Again->data(), Containers::arrayView(ExpectedImageData).prefix(60), TestSuite::Compare::Container);
+
+    /* Closing with nothing left to decode, and reopening with images not
+       taken at all should be fine too */
+    importer->close();
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR, "image.gltf")));
+    importer->close();
+}
+
+void TinyGltfImporterTest::imagePrefetchNotFound() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    importer->configuration().setValue("prefetchImages", true);
+
+    /* Errors from opening the image upfront aren't printed, only once the
+       image is requested */
+    std::ostringstream out;
+    Error redirectError{&out};
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR, "image-notfound.gltf")));
+    CORRADE_COMPARE(importer->image2DCount(), 1);
+    CORRADE_COMPARE(out.str(), "");
+
+    CORRADE_VERIFY(!importer->image2D(0));
+    CORRADE_COMPARE(out.str(), "Trade::AbstractImporter::openFile(): cannot open file /nonexistent.png\n");
+}
+
+void TinyGltfImporterTest::imageImporterCache() {
+    if(_manager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("PngImporter plugin not found, cannot test");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    importer->configuration().setValue("imageImporterCacheSize", 2);
+
+    /* Load from the filesystem, but record which files get loaded */
+    struct {
+        Containers::Array<char> file;
+        std::ostringstream out;
+    } callbackData;
+    importer->setFileCallback([](const std::string& filename, InputFileCallbackPolicy policy, decltype(callbackData)& data) -> Containers::Optional<Containers::ArrayView<const char>> {
+        if(policy == InputFileCallbackPolicy::Close) return {};
+        data.out << Utility::Directory::filename(filename) << " ";
+        data.file = Utility::Directory::read(filename);
+        return Containers::ArrayView<const char>{data.file};
+    }, callbackData);
+
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR, "image.gltf")));
+    CORRADE_COMPARE(importer->image2DCount(), 2);
+    CORRADE_COMPARE(callbackData.out.str(), "image.gltf ");
+
+    /* Both images reference the same file, but each gets its own importer */
+    CORRADE_VERIFY(importer->image2D(0));
+    CORRADE_VERIFY(importer->image2D(1));
+    CORRADE_COMPARE(callbackData.out.str(), "image.gltf texture.png texture.png ");
+
+    /* Accessing them interleaved again reuses the cached importers */
+    CORRADE_COMPARE(importer->image2DLevelCount(0), 1);
+    CORRADE_VERIFY(importer->image2D(0));
+    CORRADE_COMPARE(importer->image2DLevelCount(1), 1);
+    CORRADE_VERIFY(importer->image2D(1));
+    CORRADE_COMPARE(callbackData.out.str(), "image.gltf texture.png texture.png ");
+
+}
+
 void TinyGltfImporterTest::imageBasis() {
     auto&& data = ImageBasisData[testCaseInstanceId()];
     setTestCaseDescription(data.name);
@@ -2783,6 +3964,36 @@ void TinyGltfImporterTest::imageBasis() {
     CORRADE_COMPARE(texture->image(), 1);
 }
 
+void TinyGltfImporterTest::imageBasisFormat() {
+    if(_manager.loadState("BasisImporter") == PluginManager::LoadState::NotFound)
+        CORRADE_SKIP("BasisImporter plugin not found, cannot test");
+
+    /* The plugin-wide format should get overriden by the option */
+    _manager.metadata("BasisImporter")->configuration().setValue("format", "Astc4x4RGBA");
+
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+    importer->configuration().setValue("basisFormat", "Etc2RGBA");
+    CORRADE_VERIFY(importer->openFile(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR, "image-basisu.gltf")));
+
+    /* The standard extension is recognized as well */
+    auto texture = importer->texture(0);
+    CORRADE_VERIFY(texture);
+    CORRADE_COMPARE(texture->image(), 0);
+
+    Containers::Optional<ImageData2D> image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_VERIFY(image->isCompressed());
+    CORRADE_COMPARE(image->size(), Vector2i(5, 3));
+    CORRADE_COMPARE(image->compressedFormat(), CompressedPixelFormat::Etc2RGBA8Unorm);
+
+    /* Changing the format applies also to the already opened importer */
+    importer->configuration().setValue("basisFormat", "Bc1RGB");
+    image = importer->image2D(0);
+    CORRADE_VERIFY(image);
+    CORRADE_VERIFY(image->isCompressed());
+    CORRADE_COMPARE(image->compressedFormat(), CompressedPixelFormat::Bc1RGBUnorm);
+}
+
 void TinyGltfImporterTest::imageMipLevels() {
     if(_manager.loadState("BasisImporter") == PluginManager::LoadState::NotFound)
         CORRADE_SKIP("BasisImporter plugin not found, cannot test");
@@ -2947,6 +4158,31 @@ void TinyGltfImporterTest::fileCallbackImageNotFound() {
     CORRADE_COMPARE(out.str(), "Trade::AbstractImporter::openFile(): cannot open file data.png\n");
 }
 
+void TinyGltfImporterTest::profiling() {
+    Containers::Pointer<AbstractImporter> importer = _manager.instantiate("TinyGltfImporter");
+
+    std::string stages;
+    static_cast<TinyGltfImporter&>(*importer).setProfilingCallback([](const char* stage, UnsignedLong, std::size_t, void* userData) {
+        *static_cast<std::string*>(userData) += stage;
+        *static_cast<std::string*>(userData) += ' ';
+    }, &stages);
+
+    CORRADE_VERIFY(importer->openData(Utility::Directory::read(Utility::Directory::join(TINYGLTFIMPORTER_TEST_DIR, "mesh-embedded.glb"))));
+    CORRADE_VERIFY(importer->mesh(0));
+
+    #ifdef MAGNUM_TINYGLTFIMPORTER_WITH_PROFILING
+    CORRADE_COMPARE(stages, "parse mesh ");
+    #else
+    CORRADE_COMPARE(stages, "");
+    #endif
+
+    /* Resetting the callback stops the reporting */
+    stages = {};
+    static_cast<TinyGltfImporter&>(*importer).setProfilingCallback(nullptr);
+    CORRADE_VERIFY(importer->mesh(0));
+    CORRADE_COMPARE(stages, "");
+}
+
 void TinyGltfImporterTest::utf8filenames() {
     if(_manager.loadState("PngImporter") == PluginManager::LoadState::NotFound)
         CORRADE_SKIP("PngImporter plugin not found, cannot test");
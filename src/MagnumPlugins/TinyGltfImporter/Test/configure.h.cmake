@@ -28,3 +28,5 @@
 #cmakedefine BASISIMPORTER_PLUGIN_FILENAME "${BASISIMPORTER_PLUGIN_FILENAME}"
 #cmakedefine STBIMAGEIMPORTER_PLUGIN_FILENAME "${STBIMAGEIMPORTER_PLUGIN_FILENAME}"
 #define TINYGLTFIMPORTER_TEST_DIR "${TINYGLTFIMPORTER_TEST_DIR}"
+#cmakedefine MAGNUM_TINYGLTFIMPORTER_WITH_DRACO
+#cmakedefine MAGNUM_TINYGLTFIMPORTER_WITH_MESHOPTIMIZER
@@ -28,12 +28,17 @@
 #include "TinyGltfImporter.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <future>
 #include <limits>
+#include <thread>
 #include <unordered_map>
 #include <Corrade/Containers/GrowableArray.h>
 #include <Corrade/Containers/ArrayView.h>
 #include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
 #include <Corrade/Utility/Algorithms.h>
 #include <Corrade/Utility/ConfigurationGroup.h>
 #include <Corrade/Utility/DebugStl.h>
@@ -43,6 +48,7 @@
 #include <Magnum/Mesh.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/Math/CubicHermite.h>
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Matrix4.h>
 #include <Magnum/Math/Quaternion.h>
 #include <Magnum/Trade/AnimationData.h>
@@ -57,12 +63,41 @@
 
 #include "MagnumPlugins/AnyImageImporter/AnyImageImporter.h"
 
+#ifdef MAGNUM_TINYGLTFIMPORTER_WITH_PROFILING
+#define MAGNUM_IMPORTERPROFILING_ENABLED
+#endif
+#include "MagnumPlugins/Implementation/imageSignature.h"
+#include "MagnumPlugins/Implementation/importerProfiling.h"
+
+#ifdef MAGNUM_TINYGLTFIMPORTER_WITH_MESHOPTIMIZER
+#include <meshoptimizer.h>
+#endif
+
 #define TINYGLTF_IMPLEMENTATION
 /* Opt out of tinygltf stb_image dependency */
 #define TINYGLTF_NO_STB_IMAGE
 #define TINYGLTF_NO_STB_IMAGE_WRITE
 /* Opt out of loading external images */
 #define TINYGLTF_NO_EXTERNAL_IMAGE
+/* Decode KHR_draco_mesh_compression primitives on load, if enabled */
+#ifdef MAGNUM_TINYGLTFIMPORTER_WITH_DRACO
+#define TINYGLTF_ENABLE_DRACO
+#endif
+/* Parse using RapidJSON instead of nlohmann::json, if enabled. The default
+   RapidJSON allocator allows only one document to be alive globally, the CRT
+   allocator is needed for multiple importer instances to work. RapidJSON
+   uses SIMD for skipping whitespace only if told to. */
+#ifdef MAGNUM_TINYGLTFIMPORTER_WITH_RAPIDJSON
+#define TINYGLTF_USE_RAPIDJSON
+#define TINYGLTF_USE_RAPIDJSON_CRTALLOCATOR
+#if defined(__SSE4_2__)
+#define RAPIDJSON_SSE42
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RAPIDJSON_SSE2
+#elif defined(__ARM_NEON)
+#define RAPIDJSON_NEON
+#endif
+#endif
 /* Opt out of filesystem access, as we handle it ourselves. However that makes
    it fail to compile as std::ofstream is not define, so we do that here (and
    newer versions don't seem to fix that either). Enabling filesystem access
@@ -85,6 +120,12 @@
 /* Include like this instead of "MagnumExternal/TinyGltf/tiny_gltf.h" so we can
    include it as a system header and suppress warnings */
 #include "tiny_gltf.h"
+/* The JSON patching for lazy buffer loading and EXT_meshopt_compression
+   fallback buffers is done with nlohmann::json, which tinygltf doesn't
+   include in that case */
+#ifdef MAGNUM_TINYGLTFIMPORTER_WITH_RAPIDJSON
+#include "json.hpp"
+#endif
 #ifdef CORRADE_TARGET_WINDOWS
 #undef near
 #undef far
@@ -110,13 +151,112 @@ std::size_t elementSize(const tinygltf::Accessor& accessor) {
     return tinygltf::GetComponentSizeInBytes(accessor.componentType)*tinygltf::GetNumComponentsInType(accessor.type);
 }
 
-const tinygltf::Accessor* checkedAccessor(const tinygltf::Model& model, const char* function, Int id) {
+/* Checks the index and value views of a sparse accessor. The accessor
+   itself is assumed to be in bounds. */
+bool checkedSparseAccessor(const tinygltf::Model& model, const char* function, Int id) {
+    const tinygltf::Accessor& accessor = model.accessors[id];
+    if(accessor.sparse.indices.componentType != TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE &&
+       accessor.sparse.indices.componentType != TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT &&
+       accessor.sparse.indices.componentType != TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT) {
+        Error{} << "Trade::TinyGltfImporter::" << Debug::nospace << function << Debug::nospace << "(): unsupported sparse index component type" << accessor.sparse.indices.componentType << "in accessor" << id;
+        return false;
+    }
+
+    const std::size_t count = accessor.sparse.count;
+    const std::pair<Int, std::size_t> views[]{
+        {accessor.sparse.indices.bufferView, accessor.sparse.indices.byteOffset + count*tinygltf::GetComponentSizeInBytes(accessor.sparse.indices.componentType)},
+        {accessor.sparse.values.bufferView, accessor.sparse.values.byteOffset + count*elementSize(accessor)}
+    };
+    for(const std::pair<Int, std::size_t>& view: views) {
+        if(std::size_t(view.first) >= model.bufferViews.size()) {
+            Error{} << "Trade::TinyGltfImporter::" << Debug::nospace << function << Debug::nospace << "(): sparse bufferView" << view.first << "out of bounds for" << model.bufferViews.size() << "views";
+            return false;
+        }
+        const tinygltf::BufferView& bufferView = model.bufferViews[view.first];
+        if(bufferView.byteLength < view.second) {
+            Error{} << "Trade::TinyGltfImporter::" << Debug::nospace << function << Debug::nospace << "(): sparse accessor" << id << "needs" << view.second << "bytes but bufferView" << view.first << "has only" << bufferView.byteLength;
+            return false;
+        }
+        if(std::size_t(bufferView.buffer) >= model.buffers.size()) {
+            Error{} << "Trade::TinyGltfImporter::" << Debug::nospace << function << Debug::nospace << "(): buffer" << bufferView.buffer << "out of bounds for" << model.buffers.size() << "buffers";
+            return false;
+        }
+        const std::size_t viewSize = bufferView.byteOffset + bufferView.byteLength;
+        if(model.buffers[bufferView.buffer].data.size() < viewSize) {
+            Error{} << "Trade::TinyGltfImporter::" << Debug::nospace << function << Debug::nospace << "(): bufferView" << view.first << "needs" << viewSize << "bytes but buffer" << bufferView.buffer << "has only" << model.buffers[bufferView.buffer].data.size();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Views on indices and values of a sparse accessor. The accessor is assumed
+   to be checked using checkedSparseAccessor(). */
+Containers::ArrayView<const char> sparseIndexData(const tinygltf::Model& model, const tinygltf::Accessor& accessor) {
+    const tinygltf::BufferView& view = model.bufferViews[accessor.sparse.indices.bufferView];
+    return {reinterpret_cast<const char*>(model.buffers[view.buffer].data.data()) + view.byteOffset + accessor.sparse.indices.byteOffset,
+        accessor.sparse.count*tinygltf::GetComponentSizeInBytes(accessor.sparse.indices.componentType)};
+}
+
+Containers::ArrayView<const char> sparseValueData(const tinygltf::Model& model, const tinygltf::Accessor& accessor) {
+    const tinygltf::BufferView& view = model.bufferViews[accessor.sparse.values.bufferView];
+    return {reinterpret_cast<const char*>(model.buffers[view.buffer].data.data()) + view.byteOffset + accessor.sparse.values.byteOffset,
+        accessor.sparse.count*elementSize(accessor)};
+}
+
+UnsignedInt sparseIndex(const tinygltf::Accessor& accessor, const char* const indices, const std::size_t i) {
+    if(accessor.sparse.indices.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE)
+        return reinterpret_cast<const UnsignedByte*>(indices)[i];
+    if(accessor.sparse.indices.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT) {
+        UnsignedShort value;
+        std::memcpy(&value, indices + i*2, 2);
+        return value;
+    }
+    UnsignedInt value;
+    std::memcpy(&value, indices + i*4, 4);
+    return value;
+}
+
+/* Writes values of a sparse accessor to given elements of the output. The
+   accessor is assumed to be checked using checkedAccessor(). */
+bool applySparseAccessor(const tinygltf::Model& model, const char* function, Int id, const Containers::StridedArrayView1D<char>& out) {
+    const tinygltf::Accessor& accessor = model.accessors[id];
+    const char* const indices = sparseIndexData(model, accessor);
+    const char* const values = sparseValueData(model, accessor);
+    const std::size_t size = elementSize(accessor);
+
+    for(std::size_t i = 0; i != std::size_t(accessor.sparse.count); ++i) {
+        const UnsignedInt index = sparseIndex(accessor, indices, i);
+        if(index >= accessor.count) {
+            Error{} << "Trade::TinyGltfImporter::" << Debug::nospace << function << Debug::nospace << "(): sparse index" << index << "out of bounds for" << accessor.count << "elements in accessor" << id;
+            return false;
+        }
+
+        std::memcpy(static_cast<char*>(out.data()) + index*out.stride(), values + i*size, size);
+    }
+
+    return true;
+}
+
+/* With trustedInput, only the checks needed for memory safety are done --
+   that is, everything except the stride check, as an accessor with elements
+   overlapping each other still stays in bounds of the buffer view */
+const tinygltf::Accessor* checkedAccessor(const tinygltf::Model& model, const char* function, Int id, bool trustedInput = false) {
     if(std::size_t(id) >= model.accessors.size()) {
         Error{} << "Trade::TinyGltfImporter::" << Debug::nospace << function << Debug::nospace << "(): accessor" << id << "out of bounds for" << model.accessors.size() << "accessors";
         return nullptr;
     }
 
     const tinygltf::Accessor& accessor = model.accessors[id];
+
+    /* Sparse accessors don't need to have a buffer view, in which case the
+       base values are all zeros */
+    if(accessor.sparse.isSparse && !checkedSparseAccessor(model, function, id))
+        return nullptr;
+    if(accessor.sparse.isSparse && accessor.bufferView == -1)
+        return &accessor;
+
     if(std::size_t(accessor.bufferView) >= model.bufferViews.size()) {
         Error{} << "Trade::TinyGltfImporter::" << Debug::nospace << function << Debug::nospace << "(): bufferView" << accessor.bufferView << "out of bounds for" << model.bufferViews.size() << "views";
         return nullptr;
@@ -124,7 +264,7 @@ const tinygltf::Accessor* checkedAccessor(const tinygltf::Model& model, const ch
 
     const tinygltf::BufferView& bufferView = model.bufferViews[accessor.bufferView];
     const std::size_t size = elementSize(accessor);
-    if(bufferView.byteStride != 0 && bufferView.byteStride < size) {
+    if(!trustedInput && bufferView.byteStride != 0 && bufferView.byteStride < size) {
         Error{} << "Trade::TinyGltfImporter::" << Debug::nospace << function << Debug::nospace << "():" << size << Debug::nospace << "-byte type defined by accessor" << id << "can't fit into bufferView" << accessor.bufferView << "stride of" << bufferView.byteStride;
         return nullptr;
     }
@@ -148,6 +288,363 @@ const tinygltf::Accessor* checkedAccessor(const tinygltf::Model& model, const ch
     return &accessor;
 }
 
+/* Appends IDs of buffers referenced by given accessor, including sparse
+   indices and values, if valid and not already present. Invalid accessors are
+   ignored, they will fail later in checkedAccessor(). */
+void bufferViewBuffer(const tinygltf::Model& model, const Int bufferView, std::vector<UnsignedInt>& out) {
+    if(std::size_t(bufferView) >= model.bufferViews.size()) return;
+    const UnsignedInt buffer = model.bufferViews[bufferView].buffer;
+    if(buffer >= model.buffers.size()) return;
+    if(std::find(out.begin(), out.end(), buffer) == out.end())
+        out.push_back(buffer);
+}
+
+void accessorBuffer(const tinygltf::Model& model, const Int accessor, std::vector<UnsignedInt>& out) {
+    if(std::size_t(accessor) >= model.accessors.size()) return;
+    bufferViewBuffer(model, model.accessors[accessor].bufferView, out);
+    if(model.accessors[accessor].sparse.isSparse) {
+        bufferViewBuffer(model, model.accessors[accessor].sparse.indices.bufferView, out);
+        bufferViewBuffer(model, model.accessors[accessor].sparse.values.bufferView, out);
+    }
+}
+
+std::vector<UnsignedInt> primitiveBuffers(const tinygltf::Model& model, const tinygltf::Primitive& primitive) {
+    std::vector<UnsignedInt> out;
+    for(const std::pair<const std::string, int>& attribute: primitive.attributes)
+        accessorBuffer(model, attribute.second, out);
+    if(primitive.indices != -1)
+        accessorBuffer(model, primitive.indices, out);
+    return out;
+}
+
+void animationBuffers(const tinygltf::Model& model, const tinygltf::Animation& animation, std::vector<UnsignedInt>& out) {
+    for(const tinygltf::AnimationSampler& sampler: animation.samplers) {
+        accessorBuffer(model, sampler.input, out);
+        accessorBuffer(model, sampler.output, out);
+    }
+}
+
+/* An external buffer that's loaded only when needed */
+struct LazyBuffer {
+    std::string uri;
+    std::size_t size;
+    /* Count of meshes and animations that weren't imported yet. Once it
+       drops to zero, the buffer is released. */
+    UnsignedInt remainingUses;
+    bool loaded;
+    /* Referenced by a zero-copy mesh, can't be released */
+    bool pinned;
+};
+
+/* Replaces URIs of external buffers with a one-byte data URI so tinygltf
+   doesn't load them on open, saving the original URI and size instead.
+   Buffers referenced by images, Draco-compressed primitives and
+   EXT_meshopt_compression buffer views are left as-is, as tinygltf or the
+   importer accesses their data directly on open. Returns false if there's
+   nothing to replace. */
+bool replaceExternalBuffers(nlohmann::json& json, std::vector<Containers::Optional<LazyBuffer>>& lazyBuffers) {
+    const auto buffers = json.find("buffers");
+    if(buffers == json.end() || !buffers->is_array()) return false;
+
+    std::vector<bool> usedOnOpen(buffers->size());
+    auto markBuffer = [&](const nlohmann::json& object, const char* name) {
+        const auto buffer = object.find(name);
+        if(buffer != object.end() && buffer->is_number_unsigned() && buffer->get<std::size_t>() < usedOnOpen.size())
+            usedOnOpen[buffer->get<std::size_t>()] = true;
+    };
+    const auto bufferViews = json.find("bufferViews");
+    auto markBufferView = [&](const nlohmann::json& object) {
+        if(bufferViews == json.end() || !bufferViews->is_array() || !object.is_object()) return;
+        const auto bufferView = object.find("bufferView");
+        if(bufferView == object.end() || !bufferView->is_number_unsigned() || bufferView->get<std::size_t>() >= bufferViews->size()) return;
+        const nlohmann::json& view = (*bufferViews)[bufferView->get<std::size_t>()];
+        if(view.is_object()) markBuffer(view, "buffer");
+    };
+    const auto images = json.find("images");
+    if(images != json.end() && images->is_array())
+        for(const nlohmann::json& image: *images) markBufferView(image);
+    const auto meshes = json.find("meshes");
+    if(meshes != json.end() && meshes->is_array()) for(const nlohmann::json& mesh: *meshes) {
+        if(!mesh.is_object()) continue;
+        const auto primitives = mesh.find("primitives");
+        if(primitives == mesh.end() || !primitives->is_array()) continue;
+        for(const nlohmann::json& primitive: *primitives) {
+            if(!primitive.is_object()) continue;
+            const auto extensions = primitive.find("extensions");
+            if(extensions == primitive.end() || !extensions->is_object()) continue;
+            const auto draco = extensions->find("KHR_draco_mesh_compression");
+            if(draco != extensions->end()) markBufferView(*draco);
+        }
+    }
+    if(bufferViews != json.end() && bufferViews->is_array()) for(const nlohmann::json& view: *bufferViews) {
+        if(!view.is_object()) continue;
+        const auto extensions = view.find("extensions");
+        if(extensions == view.end() || !extensions->is_object()) continue;
+        const auto meshopt = extensions->find("EXT_meshopt_compression");
+        if(meshopt != extensions->end() && meshopt->is_object())
+            markBuffer(*meshopt, "buffer");
+    }
+
+    bool replaced = false;
+    lazyBuffers.resize(buffers->size());
+    for(std::size_t i = 0; i != buffers->size(); ++i) {
+        nlohmann::json& buffer = (*buffers)[i];
+        if(usedOnOpen[i] || !buffer.is_object()) continue;
+
+        const auto uri = buffer.find("uri");
+        const auto byteLength = buffer.find("byteLength");
+        if(uri == buffer.end() || !uri->is_string() ||
+           byteLength == buffer.end() || !byteLength->is_number_unsigned() ||
+           !byteLength->get<std::size_t>()) continue;
+
+        /* Data URIs are decoded right away */
+        const std::string& uriString = uri->get_ref<const std::string&>();
+        if(Utility::String::beginsWith(uriString, "data:")) continue;
+
+        lazyBuffers[i] = LazyBuffer{uriString, byteLength->get<std::size_t>(), 0, false, false};
+        *uri = "data:application/octet-stream;base64,AA==";
+        *byteLength = 1;
+        replaced = true;
+    }
+
+    if(!replaced) lazyBuffers.clear();
+    return replaced;
+}
+
+#ifdef MAGNUM_TINYGLTFIMPORTER_WITH_MESHOPTIMIZER
+/* Replaces EXT_meshopt_compression fallback buffers, which don't have any
+   data, with a one-byte data URI, as tinygltf would fail to load them
+   otherwise. Views referencing them are redirected to the decoded data after
+   opening. Returns false if there's nothing to replace. */
+bool replaceMeshoptFallbackBuffers(nlohmann::json& json) {
+    const auto buffers = json.find("buffers");
+    if(buffers == json.end() || !buffers->is_array()) return false;
+
+    bool replaced = false;
+    for(nlohmann::json& buffer: *buffers) {
+        if(!buffer.is_object() || buffer.find("uri") != buffer.end()) continue;
+        const auto extensions = buffer.find("extensions");
+        if(extensions == buffer.end() || !extensions->is_object()) continue;
+        const auto meshopt = extensions->find("EXT_meshopt_compression");
+        if(meshopt == extensions->end() || !meshopt->is_object()) continue;
+        const auto fallback = meshopt->find("fallback");
+        if(fallback == meshopt->end() || !fallback->is_boolean() || !fallback->get<bool>()) continue;
+
+        buffer["uri"] = "data:application/octet-stream;base64,AA==";
+        buffer["byteLength"] = 1;
+        replaced = true;
+    }
+
+    return replaced;
+}
+#endif
+
+/* Parses the JSON of a glTF or GLB file and calls patch() on it. If it
+   returns true, the patched JSON is serialized back, for GLB files together
+   with the original binary chunk. Returns an empty array if nothing was
+   patched (or the file fails to parse, in which case tinygltf will report the
+   error), in which case the original data should be used. */
+template<class F> Containers::Array<char> patchJson(const Containers::ArrayView<const char> data, F patch) {
+    const bool binary = data.size() >= 20 && std::strncmp(data.data(), "glTF", 4) == 0;
+    Containers::ArrayView<const char> jsonData = data;
+    if(binary) {
+        UnsignedInt jsonSize;
+        std::memcpy(&jsonSize, data + 12, 4);
+        if(20 + std::size_t(jsonSize) > data.size()) return {};
+        jsonData = data.slice(20, 20 + jsonSize);
+    }
+
+    nlohmann::json json = nlohmann::json::parse(jsonData.begin(), jsonData.end(), nullptr, false);
+    if(json.is_discarded() || !json.is_object() || !patch(json)) return {};
+
+    const std::string patchedJson = json.dump();
+    if(!binary) {
+        Containers::Array<char> out{Containers::NoInit, patchedJson.size()};
+        Utility::copy(Containers::arrayView(patchedJson.data(), patchedJson.size()), out);
+        return out;
+    }
+
+    /* For binary files put the new JSON chunk, padded with spaces to four
+       bytes, into a copy of the original header and binary chunk */
+    const std::size_t patchedJsonSize = (patchedJson.size() + 3)/4*4;
+    const Containers::ArrayView<const char> rest = data.suffix(20 + jsonData.size());
+    Containers::Array<char> out{Containers::NoInit, 20 + patchedJsonSize + rest.size()};
+    std::memcpy(out, data, 8);
+    const UnsignedInt header[]{UnsignedInt(out.size()), UnsignedInt(patchedJsonSize), 0x4E4F534A};
+    std::memcpy(out + 8, header, 12);
+    std::memcpy(out + 20, patchedJson.data(), patchedJson.size());
+    std::memset(out + 20 + patchedJson.size(), ' ', patchedJsonSize - patchedJson.size());
+    Utility::copy(rest, out.suffix(20 + patchedJsonSize));
+    return out;
+}
+
+#ifdef MAGNUM_TINYGLTFIMPORTER_WITH_MESHOPTIMIZER
+/* Decodes all EXT_meshopt_compression buffer views into newly added buffers
+   and redirects the views to them */
+bool decodeMeshoptBufferViews(tinygltf::Model& model) {
+    for(std::size_t i = 0; i != model.bufferViews.size(); ++i) {
+        tinygltf::BufferView& bufferView = model.bufferViews[i];
+        const auto found = bufferView.extensions.find("EXT_meshopt_compression");
+        if(found == bufferView.extensions.end()) continue;
+        const tinygltf::Value& meshopt = found->second;
+
+        const tinygltf::Value& buffer = meshopt.Get("buffer");
+        const tinygltf::Value& byteOffset = meshopt.Get("byteOffset");
+        const tinygltf::Value& byteLength = meshopt.Get("byteLength");
+        const tinygltf::Value& byteStride = meshopt.Get("byteStride");
+        const tinygltf::Value& count = meshopt.Get("count");
+        const tinygltf::Value& mode = meshopt.Get("mode");
+        const tinygltf::Value& filter = meshopt.Get("filter");
+        if(!buffer.IsInt() || !byteLength.IsInt() || !byteStride.IsInt() || !count.IsInt() || !mode.IsString() ||
+           (byteOffset.Type() != tinygltf::NULL_TYPE && !byteOffset.IsInt()) ||
+           (filter.Type() != tinygltf::NULL_TYPE && !filter.IsString())) {
+            Error{} << "Trade::TinyGltfImporter::openData(): invalid EXT_meshopt_compression properties in bufferView" << i;
+            return false;
+        }
+
+        const std::size_t sourceBuffer = buffer.Get<int>();
+        const std::size_t sourceOffset = byteOffset.IsInt() ? byteOffset.Get<int>() : 0;
+        const std::size_t sourceLength = byteLength.Get<int>();
+        const std::size_t stride = byteStride.Get<int>();
+        const std::size_t elementCount = count.Get<int>();
+        if(sourceBuffer >= model.buffers.size() || model.buffers[sourceBuffer].data.size() < sourceOffset + sourceLength) {
+            Error{} << "Trade::TinyGltfImporter::openData(): EXT_meshopt_compression data of bufferView" << i << "out of bounds";
+            return false;
+        }
+
+        tinygltf::Buffer decoded;
+        decoded.data.resize(elementCount*stride);
+        const unsigned char* const source = model.buffers[sourceBuffer].data.data() + sourceOffset;
+        const std::string& modeString = mode.Get<std::string>();
+        int result;
+        if(modeString == "ATTRIBUTES")
+            result = meshopt_decodeVertexBuffer(decoded.data.data(), elementCount, stride, source, sourceLength);
+        else if(modeString == "TRIANGLES")
+            result = meshopt_decodeIndexBuffer(decoded.data.data(), elementCount, stride, source, sourceLength);
+        else if(modeString == "INDICES")
+            result = meshopt_decodeIndexSequence(decoded.data.data(), elementCount, stride, source, sourceLength);
+        else {
+            Error{} << "Trade::TinyGltfImporter::openData(): unknown EXT_meshopt_compression mode" << modeString;
+            return false;
+        }
+        if(result != 0) {
+            Error{} << "Trade::TinyGltfImporter::openData(): can't decode EXT_meshopt_compression data of bufferView" << i;
+            return false;
+        }
+
+        /* Filters are applied in-place on the decoded data */
+        if(filter.IsString()) {
+            const std::string& filterString = filter.Get<std::string>();
+            if(filterString == "OCTAHEDRAL")
+                meshopt_decodeFilterOct(decoded.data.data(), elementCount, stride);
+            else if(filterString == "QUATERNION")
+                meshopt_decodeFilterQuat(decoded.data.data(), elementCount, stride);
+            else if(filterString == "EXPONENTIAL")
+                meshopt_decodeFilterExp(decoded.data.data(), elementCount, stride);
+            else if(filterString != "NONE") {
+                Error{} << "Trade::TinyGltfImporter::openData(): unknown EXT_meshopt_compression filter" << filterString;
+                return false;
+            }
+        }
+
+        model.buffers.push_back(std::move(decoded));
+        bufferView.buffer = int(model.buffers.size() - 1);
+        bufferView.byteOffset = 0;
+        bufferView.byteLength = elementCount*stride;
+    }
+
+    return true;
+}
+#endif
+
+/* Attribute-to-accessor mapping of EXT_mesh_gpu_instancing, or nullptr if
+   the node isn't instanced */
+const tinygltf::Value* instancingAttributes(const tinygltf::Node& node) {
+    const auto found = node.extensions.find("EXT_mesh_gpu_instancing");
+    if(found == node.extensions.end()) return nullptr;
+    const tinygltf::Value& attributes = found->second.Get("attributes");
+    return attributes.IsObject() && attributes.Size() ? &attributes : nullptr;
+}
+
+/* Converts accessor component type and type to a vertex format, returns
+   VertexFormat{} if the combination isn't valid */
+VertexFormat checkedVertexFormat(const tinygltf::Accessor& accessor, const char* function) {
+    VertexFormat componentFormat;
+    if(accessor.componentType == TINYGLTF_COMPONENT_TYPE_BYTE)
+        componentFormat = VertexFormat::Byte;
+    else if(accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE)
+        componentFormat = VertexFormat::UnsignedByte;
+    else if(accessor.componentType == TINYGLTF_COMPONENT_TYPE_SHORT)
+        componentFormat = VertexFormat::Short;
+    else if(accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT)
+        componentFormat = VertexFormat::UnsignedShort;
+    else if(accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT)
+        componentFormat = VertexFormat::UnsignedInt;
+    else if(accessor.componentType == TINYGLTF_COMPONENT_TYPE_INT)
+        componentFormat = VertexFormat::Int;
+    else if(accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT)
+        componentFormat = VertexFormat::Float;
+    else if(accessor.componentType == TINYGLTF_COMPONENT_TYPE_DOUBLE)
+        componentFormat = VertexFormat::Double;
+    else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+
+    UnsignedInt componentCount;
+    UnsignedInt vectorCount = 0;
+    if(accessor.type == TINYGLTF_TYPE_SCALAR)
+        componentCount = 1;
+    else if(accessor.type == TINYGLTF_TYPE_VEC2)
+        componentCount = 2;
+    else if(accessor.type == TINYGLTF_TYPE_VEC3)
+        componentCount = 3;
+    else if(accessor.type == TINYGLTF_TYPE_VEC4)
+        componentCount = 4;
+    else if(accessor.type == TINYGLTF_TYPE_MAT2) {
+        componentCount = 2;
+        vectorCount = 2;
+    } else if(accessor.type == TINYGLTF_TYPE_MAT3) {
+        componentCount = 3;
+        vectorCount = 3;
+    } else if(accessor.type == TINYGLTF_TYPE_MAT4) {
+        componentCount = 4;
+        vectorCount = 4;
+    } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+
+    /* Floats should not be normalized */
+    if(accessor.normalized && (componentFormat == VertexFormat::Float || componentFormat == VertexFormat::Double)) {
+        Error{} << "Trade::TinyGltfImporter::" << Debug::nospace << function << Debug::nospace << "(): floating-point component types can't be normalized";
+        return {};
+    }
+
+    /* Check that matrix type is legal */
+    if(vectorCount &&
+        componentFormat != VertexFormat::Float &&
+        componentFormat != VertexFormat::Double &&
+        !(componentFormat == VertexFormat::Byte && accessor.normalized) &&
+        !(componentFormat == VertexFormat::Short && accessor.normalized)) {
+        Error{} << "Trade::TinyGltfImporter::" << Debug::nospace << function << Debug::nospace << "(): unsupported matrix component type"
+            << (accessor.normalized ? "normalized" : "unnormalized")
+            << accessor.componentType;
+        return {};
+    }
+
+    return vectorCount ?
+        vertexFormat(componentFormat, vectorCount, componentCount, true) :
+        vertexFormat(componentFormat, componentCount, accessor.normalized);
+}
+
+template<class T> UnsignedInt maxIndex(const Containers::ArrayView<const char> indices) {
+    UnsignedInt max = 0;
+    for(const T index: Containers::arrayCast<const T>(indices))
+        max = Math::max(max, UnsignedInt(index));
+    return max;
+}
+
+template<class T, class U> void narrowIndicesInto(const Containers::ArrayView<const char> src, const Containers::ArrayView<char> dst) {
+    const Containers::ArrayView<const T> in = Containers::arrayCast<const T>(src);
+    const Containers::ArrayView<U> out = Containers::arrayCast<U>(dst);
+    for(std::size_t i = 0; i != in.size(); ++i) out[i] = U(in[i]);
+}
+
 Containers::StridedArrayView2D<const char> bufferView(const tinygltf::Model& model, const tinygltf::Accessor& accessor) {
     /* All this assumes the accessor was retrieved using checkedAccessor() */
     const std::size_t bufferElementSize = elementSize(accessor);
@@ -164,23 +661,61 @@ Containers::StridedArrayView2D<const char> bufferView(const tinygltf::Model& mod
 
 }
 
+namespace {
+
+/* First levels of all images decoded on background threads right after
+   opening, if prefetchImages is enabled */
+struct ImagePrefetch {
+    ~ImagePrefetch() {
+        /* Don't start decoding any more images and wait for the ones being
+           decoded */
+        next = importers.size();
+        for(std::thread& thread: threads) thread.join();
+    }
+
+    /* Opened on the calling thread, null if opening failed. Destroyed on the
+       calling thread as well once the image is taken, as plugin unloading
+       isn't thread-safe either. */
+    Containers::Array<Containers::Pointer<AbstractImporter>> importers;
+    /* Zero if opening failed */
+    Containers::Array<UnsignedInt> levelCounts;
+    /* Set by the workers, NullOpt if decoding failed. The promise is
+       fulfilled once the image is processed, the future is reset once the
+       image is taken. */
+    Containers::Array<Containers::Optional<ImageData2D>> images;
+    Containers::Array<std::promise<void>> decoded;
+    Containers::Array<std::future<void>> futures;
+
+    std::atomic<std::size_t> next{};
+    Containers::Array<std::thread> threads;
+};
+
+}
+
 struct TinyGltfImporter::Document {
     Containers::Optional<std::string> filePath;
 
     tinygltf::Model model;
 
-    Containers::Optional<std::unordered_map<std::string, Int>>
-        animationsForName,
-        camerasForName,
-        lightsForName,
-        scenesForName,
-        nodesForName,
-        meshesForName,
-        materialsForName,
-        imagesForName,
-        texturesForName;
-
-    /* Unlike the ones above, these are filled already during construction as
+    /* Names of all entities for the *ForName() lookups, built on open. Each
+       kind occupies the range [nameOffsets[kind], nameOffsets[kind + 1]),
+       sorted by the name and then by the ID so the first of duplicate names
+       is found. The names point to the model, so no strings are allocated. */
+    enum class NameKind: UnsignedByte {
+        Animation, Camera, Light, Scene, Node, Mesh, Material, Image, Texture,
+        Skin
+    };
+    struct Name {
+        const std::string* name;
+        Int id;
+    };
+    Containers::Array<Name> names;
+    UnsignedInt nameOffsets[Int(NameKind::Skin) + 2]{};
+
+    template<class T> void addNames(NameKind kind, const std::vector<T>& items, const std::vector<std::size_t>* offsets);
+    Int findName(NameKind kind, const std::string& name) const;
+
+    /* Unlike the above, these are filled already during construction as
        we need them in three different places and on-demand construction would
        be too annoying to test. Also, assuming the importer knows all builtin
        names, in most case these would be empty anyway. */
@@ -216,10 +751,48 @@ struct TinyGltfImporter::Document {
 
     bool open = false;
 
-    UnsignedInt imageImporterId = ~UnsignedInt{};
-    Containers::Optional<AnyImageImporter> imageImporter;
+    /* If lazyBufferLoading is enabled, contains lazily loaded external
+       buffers, indexed by buffer ID. Other buffers are NullOpt. The flags
+       track first import of each mesh and animation for counting remaining
+       buffer uses. */
+    std::vector<Containers::Optional<LazyBuffer>> lazyBuffers;
+    std::vector<bool> meshImported, animationImported;
+
+    /* Importers for recently accessed images, the most recently used one is
+       last. If opening an image failed, the importer is null. At most
+       imageImporterCacheSize entries are kept. */
+    std::vector<std::pair<UnsignedInt, Containers::Pointer<AbstractImporter>>> imageImporters;
+
+    /* If threads is larger than 1, contains first levels of images decoded
+       in parallel with a previously requested one, together with their level
+       count. Entries are removed once the image is requested. */
+    std::unordered_map<UnsignedInt, std::pair<UnsignedInt, ImageData2D>> prefetchedImages;
+
+    /* If prefetchImages is enabled, first levels of all images being decoded
+       in the background. Has to be the last member so the threads are joined
+       before anything they access gets destroyed. */
+    Containers::Pointer<ImagePrefetch> imagePrefetch;
 };
 
+template<class T> void TinyGltfImporter::Document::addNames(const NameKind kind, const std::vector<T>& items, const std::vector<std::size_t>* const offsets) {
+    for(std::size_t i = 0; i != items.size(); ++i)
+        arrayAppend(names, Name{&items[i].name, Int(offsets ? (*offsets)[i] : i)});
+    nameOffsets[Int(kind) + 1] = names.size();
+    std::sort(names + nameOffsets[Int(kind)], names.end(), [](const Name& a, const Name& b) {
+        const int compared = a.name->compare(*b.name);
+        return compared < 0 || (compared == 0 && a.id < b.id);
+    });
+}
+
+Int TinyGltfImporter::Document::findName(const NameKind kind, const std::string& name) const {
+    const Name* const begin = names + nameOffsets[Int(kind)];
+    const Name* const end = names + nameOffsets[Int(kind) + 1];
+    const Name* const found = std::lower_bound(begin, end, name, [](const Name& a, const std::string& b) {
+        return *a.name < b;
+    });
+    return found == end || *found->name != name ? -1 : found->id;
+}
+
 namespace {
 
 void fillDefaultConfiguration(Utility::ConfigurationGroup& conf) {
@@ -229,6 +802,31 @@ void fillDefaultConfiguration(Utility::ConfigurationGroup& conf) {
     conf.setValue("mergeAnimationClips", false);
     conf.setValue("textureCoordinateYFlipInMaterial", false);
     conf.setValue("objectIdAttribute", "_OBJECT_ID");
+    conf.setValue("zeroCopy", false);
+    conf.setValue("narrowIndices", false);
+    conf.setValue("lazyBufferLoading", false);
+    conf.setValue("threads", 1);
+    conf.setValue("imageImporterCacheSize", 1);
+    conf.setValue("prefetchImages", false);
+    conf.setValue("basisFormat", "");
+}
+
+/* Basis Universal images are recognized by the MIME type, which is what both
+   embedded and buffer view images have to specify, or by the file extension
+   for external images */
+bool isBasisImage(const tinygltf::Image& image) {
+    return image.mimeType == "image/x-basis" ||
+        Utility::String::endsWith(Utility::String::lowercase(image.uri), ".basis");
+}
+
+/* Calls f(t) for t in [0, threadCount), the first on the current thread and
+   the rest on new threads */
+template<class F> void parallelFor(const UnsignedInt threadCount, const F& f) {
+    Containers::Array<std::thread> threads{threadCount - 1};
+    for(UnsignedInt t = 1; t < threadCount; ++t)
+        threads[t - 1] = std::thread{f, t};
+    f(0);
+    for(std::thread& thread: threads) thread.join();
 }
 
 }
@@ -247,6 +845,11 @@ TinyGltfImporter::TinyGltfImporter(PluginManager::Manager<AbstractImporter>& man
 
 TinyGltfImporter::~TinyGltfImporter() = default;
 
+void TinyGltfImporter::setProfilingCallback(void(*callback)(const char*, UnsignedLong, std::size_t, void*), void* userData) {
+    _profilingCallback = callback;
+    _profilingUserData = userData;
+}
+
 ImporterFeatures TinyGltfImporter::doFeatures() const { return ImporterFeature::OpenData|ImporterFeature::FileCallback; }
 
 bool TinyGltfImporter::doIsOpened() const { return !!_d && _d->open; }
@@ -310,11 +913,43 @@ void TinyGltfImporter::doOpenData(const Containers::ArrayView<const char> data)
 
     loader.SetImageLoader(&loadImageData, nullptr);
 
+    /* With lazy buffer loading, external buffers are replaced with
+       placeholders so tinygltf doesn't load them */
+    const bool lazyBufferLoading = configuration().value<bool>("lazyBufferLoading");
+    #ifdef MAGNUM_TINYGLTFIMPORTER_WITH_MESHOPTIMIZER
+    /* Same with EXT_meshopt_compression fallback buffers, which have no data.
+       Parsing the whole JSON is avoided if the extension isn't mentioned at
+       all. */
+    constexpr const char MeshoptExtension[] = "EXT_meshopt_compression";
+    const bool meshopt = std::search(data.begin(), data.end(), MeshoptExtension, MeshoptExtension + sizeof(MeshoptExtension) - 1) != data.end();
+    #else
+    constexpr bool meshopt = false;
+    #endif
+    Containers::Array<char> patchedData;
+    Containers::ArrayView<const char> loadData = data;
+    if(lazyBufferLoading || meshopt) {
+        MAGNUM_IMPORTER_PROFILE(profile, _profilingCallback, _profilingUserData, "patch", data.size());
+        patchedData = patchJson(data, [&](nlohmann::json& json) {
+            bool patched = false;
+            if(lazyBufferLoading)
+                patched = replaceExternalBuffers(json, _d->lazyBuffers);
+            #ifdef MAGNUM_TINYGLTFIMPORTER_WITH_MESHOPTIMIZER
+            if(meshopt && replaceMeshoptFallbackBuffers(json))
+                patched = true;
+            #endif
+            return patched;
+        });
+        if(patchedData) loadData = patchedData;
+    }
+
     _d->open = true;
-    if(data.size() >= 4 && strncmp(data.data(), "glTF", 4) == 0) {
-        _d->open = loader.LoadBinaryFromMemory(&_d->model, &err, nullptr, reinterpret_cast<const unsigned char*>(data.data()), data.size(), "", tinygltf::SectionCheck::NO_REQUIRE);
-    } else {
-        _d->open = loader.LoadASCIIFromString(&_d->model, &err, nullptr, data.data(), data.size(), "", tinygltf::SectionCheck::NO_REQUIRE);
+    {
+        MAGNUM_IMPORTER_PROFILE(profile, _profilingCallback, _profilingUserData, "parse", loadData.size());
+        if(loadData.size() >= 4 && strncmp(loadData.data(), "glTF", 4) == 0) {
+            _d->open = loader.LoadBinaryFromMemory(&_d->model, &err, nullptr, reinterpret_cast<const unsigned char*>(loadData.data()), loadData.size(), "", tinygltf::SectionCheck::NO_REQUIRE);
+        } else {
+            _d->open = loader.LoadASCIIFromString(&_d->model, &err, nullptr, loadData.data(), loadData.size(), "", tinygltf::SectionCheck::NO_REQUIRE);
+        }
     }
 
     if(!_d->open) {
@@ -324,6 +959,16 @@ void TinyGltfImporter::doOpenData(const Containers::ArrayView<const char> data)
         return;
     }
 
+    #ifdef MAGNUM_TINYGLTFIMPORTER_WITH_MESHOPTIMIZER
+    if(meshopt) {
+        MAGNUM_IMPORTER_PROFILE(profile, _profilingCallback, _profilingUserData, "meshopt", 0);
+        if(!decodeMeshoptBufferViews(_d->model)) {
+            doClose();
+            return;
+        }
+    }
+    #endif
+
     /* Treat meshes with multiple primitives as separate meshes. Each mesh gets
        duplicated as many times as is the size of the primitives array. */
     _d->meshSizeOffsets.emplace_back(0);
@@ -353,6 +998,26 @@ void TinyGltfImporter::doOpenData(const Containers::ArrayView<const char> data)
         _d->nodeSizeOffsets.emplace_back(_d->nodeMap.size());
     }
 
+    /* Count how many meshes and animations use each lazily loaded buffer so
+       it can be released once all of them are imported */
+    if(!_d->lazyBuffers.empty()) {
+        /* Draco and meshopt decoding appends new buffers, these are never
+           lazy */
+        CORRADE_INTERNAL_ASSERT(_d->lazyBuffers.size() <= _d->model.buffers.size());
+        _d->lazyBuffers.resize(_d->model.buffers.size());
+        _d->meshImported.assign(_d->meshMap.size(), false);
+        _d->animationImported.assign(_d->model.animations.size(), false);
+        for(const std::pair<std::size_t, std::size_t>& mesh: _d->meshMap)
+            for(const UnsignedInt buffer: primitiveBuffers(_d->model, _d->model.meshes[mesh.first].primitives[mesh.second]))
+                if(_d->lazyBuffers[buffer]) ++_d->lazyBuffers[buffer]->remainingUses;
+        for(const tinygltf::Animation& animation: _d->model.animations) {
+            std::vector<UnsignedInt> buffers;
+            animationBuffers(_d->model, animation, buffers);
+            for(const UnsignedInt buffer: buffers)
+                if(_d->lazyBuffers[buffer]) ++_d->lazyBuffers[buffer]->remainingUses;
+        }
+    }
+
     /* Go through all meshes, collect custom attributes and decide about
        implicitly enabling textureCoordinateYFlipInMaterial if it isn't already
        requested from the configuration and there are any texture coordinates
@@ -391,10 +1056,57 @@ void TinyGltfImporter::doOpenData(const Containers::ArrayView<const char> data)
                         arrayAppend(_d->meshAttributeNames, attribute.first);
                 }
             }
+
+            /* Morph target attributes without a builtin equivalent are
+               custom as well */
+            for(const std::map<std::string, int>& target: primitive.targets) {
+                for(const std::pair<const std::string, int>& attribute: target) {
+                    if(attribute.first == "POSITION" ||
+                       attribute.first == "NORMAL" ||
+                       attribute.first == "TANGENT") continue;
+                    if(_d->meshAttributesForName.emplace(attribute.first,
+                        meshAttributeCustom(_d->meshAttributeNames.size())).second)
+                        arrayAppend(_d->meshAttributeNames, attribute.first);
+                }
+            }
         }
     }
 
-    /* Name maps are lazy-loaded because these might not be needed every time */
+    /* Instancing attributes are exposed as custom mesh attributes with the
+       same names */
+    for(const tinygltf::Node& node: _d->model.nodes) {
+        const tinygltf::Value* const attributes = instancingAttributes(node);
+        if(!attributes) continue;
+        for(const std::string& name: attributes->Keys()) {
+            if(_d->meshAttributesForName.emplace(name,
+                meshAttributeCustom(_d->meshAttributeNames.size())).second)
+                arrayAppend(_d->meshAttributeNames, name);
+        }
+    }
+
+    /* Build the name index. Meshes and nodes can be duplicated for as many
+       primitives as the mesh has, point to the first item in the duplicate
+       sequence in that case. */
+    arrayReserve(_d->names, _d->model.skins.size() + _d->model.animations.size() +
+        _d->model.cameras.size() + _d->model.lights.size() +
+        _d->model.scenes.size() + _d->model.nodes.size() +
+        _d->model.meshes.size() + _d->model.materials.size() +
+        _d->model.images.size() + _d->model.textures.size());
+    _d->addNames(Document::NameKind::Animation, _d->model.animations, nullptr);
+    _d->addNames(Document::NameKind::Camera, _d->model.cameras, nullptr);
+    _d->addNames(Document::NameKind::Light, _d->model.lights, nullptr);
+    _d->addNames(Document::NameKind::Scene, _d->model.scenes, nullptr);
+    _d->addNames(Document::NameKind::Node, _d->model.nodes, &_d->nodeSizeOffsets);
+    _d->addNames(Document::NameKind::Mesh, _d->model.meshes, &_d->meshSizeOffsets);
+    _d->addNames(Document::NameKind::Material, _d->model.materials, nullptr);
+    _d->addNames(Document::NameKind::Image, _d->model.images, nullptr);
+    _d->addNames(Document::NameKind::Texture, _d->model.textures, nullptr);
+    _d->addNames(Document::NameKind::Skin, _d->model.skins, nullptr);
+
+    /* Start decoding all images in the background, if requested. Image import
+       needs the plugin manager, without it there's nothing to do. */
+    if(configuration().value<bool>("prefetchImages") && manager() && !_d->model.images.empty())
+        startImagePrefetch();
 }
 
 UnsignedInt TinyGltfImporter::doCameraCount() const {
@@ -402,15 +1114,7 @@ UnsignedInt TinyGltfImporter::doCameraCount() const {
 }
 
 Int TinyGltfImporter::doCameraForName(const std::string& name) {
-    if(!_d->camerasForName) {
-        _d->camerasForName.emplace();
-        _d->camerasForName->reserve(_d->model.cameras.size());
-        for(std::size_t i = 0; i != _d->model.cameras.size(); ++i)
-            _d->camerasForName->emplace(_d->model.cameras[i].name, i);
-    }
-
-    const auto found = _d->camerasForName->find(name);
-    return found == _d->camerasForName->end() ? -1 : found->second;
+    return _d->findName(Document::NameKind::Camera, name);
 }
 
 std::string TinyGltfImporter::doCameraName(const UnsignedInt id) {
@@ -429,15 +1133,7 @@ Int TinyGltfImporter::doAnimationForName(const std::string& name) {
     /* If the animations are merged, don't report any names */
     if(configuration().value<bool>("mergeAnimationClips")) return -1;
 
-    if(!_d->animationsForName) {
-        _d->animationsForName.emplace();
-        _d->animationsForName->reserve(_d->model.animations.size());
-        for(std::size_t i = 0; i != _d->model.animations.size(); ++i)
-            _d->animationsForName->emplace(_d->model.animations[i].name, i);
-    }
-
-    const auto found = _d->animationsForName->find(name);
-    return found == _d->animationsForName->end() ? -1 : found->second;
+    return _d->findName(Document::NameKind::Animation, name);
 }
 
 std::string TinyGltfImporter::doAnimationName(UnsignedInt id) {
@@ -466,19 +1162,140 @@ template<class V> void postprocessSplineTrack(const std::size_t timeTrackUsed, c
     }
 }
 
+/* Count of morph targets animated by a weights channel, or zero if the
+   output count doesn't match the key count. Accessors are assumed to be
+   checked already. */
+std::size_t weightsTrackTargetCount(const tinygltf::Model& model, const tinygltf::AnimationSampler& sampler) {
+    const std::size_t keyCount = model.accessors[sampler.input].count*(sampler.interpolation == "CUBICSPLINE" ? 3 : 1);
+    const std::size_t valueCount = model.accessors[sampler.output].count;
+    return keyCount && valueCount && valueCount % keyCount == 0 ? valueCount/keyCount : 0;
+}
+
+/* glTF stores all in-tangents, then all values and then all out-tangents of
+   one keyframe after each other, which is reordered in-place to (in-tangent,
+   value, out-tangent) triplets for each target, and then the tangents
+   postprocessed the same way as postprocessSplineTrack() does */
+void postprocessWeightsSplineTrack(const std::size_t timeTrackUsed, const Containers::ArrayView<const Float> keys, const Containers::ArrayView<Float> values, const std::size_t targetCount) {
+    /* Already processed, don't do that again */
+    if(timeTrackUsed != ~std::size_t{}) return;
+
+    CORRADE_INTERNAL_ASSERT(keys.size()*targetCount*3 == values.size());
+    Containers::Array<Float> keyframe{Containers::NoInit, targetCount*3};
+    for(std::size_t i = 0; i != keys.size(); ++i) {
+        const Containers::ArrayView<Float> src = values.slice(i*targetCount*3, (i + 1)*targetCount*3);
+        Utility::copy(src, keyframe);
+        for(std::size_t j = 0; j != targetCount; ++j)
+            for(std::size_t k = 0; k != 3; ++k)
+                src[j*3 + k] = keyframe[k*targetCount + j];
+    }
+
+    const Containers::ArrayView<CubicHermite1D> splines = Containers::arrayCast<CubicHermite1D>(values);
+    for(std::size_t i = 0; i + 1 < keys.size(); ++i) {
+        const Float timeDifference = keys[i + 1] - keys[i];
+        for(std::size_t j = 0; j != targetCount; ++j) {
+            splines[i*targetCount + j].outTangent() *= timeDifference;
+            splines[(i + 1)*targetCount + j].inTangent() *= timeDifference;
+        }
+    }
+}
+
+}
+
+bool TinyGltfImporter::loadLazyBuffers(const char* const function, const Containers::ArrayView<const UnsignedInt> buffers) {
+    for(const UnsignedInt id: buffers) {
+        Containers::Optional<LazyBuffer>& lazy = _d->lazyBuffers[id];
+        if(!lazy || lazy->loaded) continue;
+
+        MAGNUM_IMPORTER_PROFILE(profile, _profilingCallback, _profilingUserData, "load", lazy->size);
+        std::vector<unsigned char>& out = _d->model.buffers[id].data;
+        const std::string fullPath = Utility::Directory::join(_d->filePath ? *_d->filePath : "", lazy->uri);
+        if(fileCallback()) {
+            Containers::Optional<Containers::ArrayView<const char>> data = fileCallback()(fullPath, InputFileCallbackPolicy::LoadTemporary, fileCallbackUserData());
+            if(!data) {
+                Error{} << "Trade::TinyGltfImporter::" << Debug::nospace << function << Debug::nospace << "(): error loading buffer" << id << Debug::nospace << ": file callback failed";
+                return false;
+            }
+            out.assign(data->begin(), data->end());
+        } else {
+            if(!_d->filePath) {
+                Error{} << "Trade::TinyGltfImporter::" << Debug::nospace << function << Debug::nospace << "(): error loading buffer" << id << Debug::nospace << ": external buffers can be imported only when opening files from the filesystem or if a file callback is present";
+                return false;
+            }
+            if(!Utility::Directory::exists(fullPath)) {
+                Error{} << "Trade::TinyGltfImporter::" << Debug::nospace << function << Debug::nospace << "(): error loading buffer" << id << Debug::nospace << ": file" << fullPath << "not found";
+                return false;
+            }
+            Containers::Array<char> data = Utility::Directory::read(fullPath);
+            out.assign(data.begin(), data.end());
+        }
+
+        if(out.size() != lazy->size) {
+            Error{} << "Trade::TinyGltfImporter::" << Debug::nospace << function << Debug::nospace << "(): buffer" << id << "expected to have" << lazy->size << "bytes but got" << out.size();
+            std::vector<unsigned char>{}.swap(out);
+            return false;
+        }
+
+        lazy->loaded = true;
+    }
+
+    return true;
+}
+
+void TinyGltfImporter::releaseLazyBuffers(const Containers::ArrayView<const UnsignedInt> buffers, const bool firstImport, const bool pin) {
+    for(const UnsignedInt id: buffers) {
+        Containers::Optional<LazyBuffer>& lazy = _d->lazyBuffers[id];
+        if(!lazy) continue;
+
+        if(firstImport) --lazy->remainingUses;
+        if(pin) lazy->pinned = true;
+        if(lazy->remainingUses || lazy->pinned || !lazy->loaded) continue;
+
+        std::vector<unsigned char>{}.swap(_d->model.buffers[id].data);
+        lazy->loaded = false;
+    }
 }
 
-Containers::Optional<AnimationData> TinyGltfImporter::doAnimation(UnsignedInt id) {
+Containers::Optional<AnimationData> TinyGltfImporter::doAnimation(const UnsignedInt id) {
+    if(_d->lazyBuffers.empty()) return animationInternal(id);
+
+    const bool merge = configuration().value<bool>("mergeAnimationClips");
+    const std::size_t animationBegin = merge ? 0 : id;
+    const std::size_t animationEnd = merge ? _d->model.animations.size() : id + 1;
+
+    std::vector<UnsignedInt> buffers;
+    for(std::size_t a = animationBegin; a != animationEnd; ++a)
+        animationBuffers(_d->model, _d->model.animations[a], buffers);
+    if(!loadLazyBuffers("animation", buffers)) return Containers::NullOpt;
+
+    Containers::Optional<AnimationData> out = animationInternal(id);
+
+    /* Buffers shared by more animations are counted for each of them, so
+       decrement the use count for each first-imported animation
+       separately */
+    for(std::size_t a = animationBegin; a != animationEnd; ++a) {
+        std::vector<UnsignedInt> animationBufferIds;
+        animationBuffers(_d->model, _d->model.animations[a], animationBufferIds);
+        releaseLazyBuffers(animationBufferIds, !_d->animationImported[a], false);
+        _d->animationImported[a] = true;
+    }
+
+    return out;
+}
+
+Containers::Optional<AnimationData> TinyGltfImporter::animationInternal(const UnsignedInt id) {
     /* Import either a single animation or all of them together. At the moment,
        Blender doesn't really support cinematic animations (affecting multiple
        objects): https://blender.stackexchange.com/q/5689. And since
        https://github.com/KhronosGroup/glTF-Blender-Exporter/pull/166, these
        are exported as a set of object-specific clips, which may not be wanted,
        so we give the users an option to merge them all together. */
-    const std::size_t animationBegin =
-        configuration().value<bool>("mergeAnimationClips") ? 0 : id;
-    const std::size_t animationEnd =
-        configuration().value<bool>("mergeAnimationClips") ? _d->model.animations.size() : id + 1;
+    const bool mergeAnimationClips = configuration().value<bool>("mergeAnimationClips");
+    const std::size_t animationBegin = mergeAnimationClips ? 0 : id;
+    const std::size_t animationEnd = mergeAnimationClips ? _d->model.animations.size() : id + 1;
+
+    /* Query these just once instead of for every track */
+    const bool optimizeQuaternionShortestPath = configuration().value<bool>("optimizeQuaternionShortestPath");
+    const bool normalizeQuaternions = configuration().value<bool>("normalizeQuaternions");
 
     /* First gather the input and output data ranges. Key is unique accessor ID
        so we don't duplicate shared data, value is range in the input buffer,
@@ -486,7 +1303,9 @@ Containers::Optional<AnimationData> TinyGltfImporter::doAnimation(UnsignedInt id
        given track is a spline interpolation. The key ID is initialized to ~0
        and will be used later to check that a spline track was not used with
        more than one time track, as it needs to be postprocessed for given time
-       track. */
+       track. For linear and constant quaternion tracks the key ID is set to 0
+       once the shortest path and normalization is done, so data shared by
+       multiple channels are processed just once. */
     std::unordered_map<int, std::tuple<Containers::StridedArrayView2D<const char>, std::size_t, std::size_t>> samplerData;
     std::size_t dataSize = 0;
     for(std::size_t a = animationBegin; a != animationEnd; ++a) {
@@ -500,6 +1319,12 @@ Containers::Optional<AnimationData> TinyGltfImporter::doAnimation(UnsignedInt id
             const tinygltf::Accessor* output = checkedAccessor(_d->model, "animation", sampler.output);
             if(!output) return Containers::NullOpt;
 
+            /** @todo apply sparse accessors here too */
+            if(input->sparse.isSparse || output->sparse.isSparse) {
+                Error{} << "Trade::TinyGltfImporter::animation(): sparse accessors are not supported";
+                return Containers::NullOpt;
+            }
+
             /** @todo handle alignment once we do more than just four-byte types */
 
             /* If the input view is not yet present in the output data buffer, add
@@ -538,10 +1363,19 @@ Containers::Optional<AnimationData> TinyGltfImporter::doAnimation(UnsignedInt id
     }
 
     /* Calculate total track count. If merging all animations together, this is
-       the sum of all clip track counts. */
+       the sum of all clip track counts. Morph target weight channels are
+       split into one track per target. If the channel is invalid, it's
+       counted as one track and fails below. */
     std::size_t trackCount = 0;
-    for(std::size_t a = animationBegin; a != animationEnd; ++a)
-        trackCount += _d->model.animations[a].channels.size();
+    for(std::size_t a = animationBegin; a != animationEnd; ++a) {
+        const tinygltf::Animation& animation = _d->model.animations[a];
+        for(const tinygltf::AnimationChannel& channel: animation.channels) {
+            std::size_t weightCount = 0;
+            if(channel.target_path == "weights" && std::size_t(channel.sampler) < animation.samplers.size())
+                weightCount = weightsTrackTargetCount(_d->model, animation.samplers[channel.sampler]);
+            trackCount += weightCount ? weightCount : 1;
+        }
+    }
 
     /* Import all tracks */
     bool hadToRenormalize = false;
@@ -593,6 +1427,7 @@ Containers::Optional<AnimationData> TinyGltfImporter::doAnimation(UnsignedInt id
             AnimationTrackTargetType target;
             AnimationTrackType type, resultType;
             Animation::TrackViewStorage<const Float> track;
+            std::size_t weightCount = 0;
             const auto outputDataFound = samplerData.find(sampler.output);
             CORRADE_INTERNAL_ASSERT(outputDataFound != samplerData.end());
             const auto outputData = data.suffix(std::get<1>(outputDataFound->second))
@@ -655,29 +1490,30 @@ Containers::Optional<AnimationData> TinyGltfImporter::doAnimation(UnsignedInt id
                         animationInterpolatorFor<CubicHermiteQuaternion>(interpolation),
                         Animation::Extrapolation::Constant};
                 } else {
-                    /* Ensure shortest path is always chosen. Not doing this
-                       for spline interpolation, there it would cause war and
-                       famine. */
+                    /* Ensure shortest path is always chosen and normalize the
+                       quaternions if not already, both in a single pass over
+                       the data. Normalization doesn't change sign of the dot
+                       product, so the order doesn't matter. Don't attempt to
+                       normalize every time to avoid tiny differences, only
+                       when the quaternion looks to be off. Not doing any of
+                       this for spline interpolation, there it would cause war
+                       and famine. If the data are shared with another channel
+                       that was processed already, there's nothing to do. */
                     const auto values = Containers::arrayCast<Quaternion>(outputData);
-                    if(configuration().value<bool>("optimizeQuaternionShortestPath")) {
+                    if(timeTrackUsed == ~std::size_t{} && (optimizeQuaternionShortestPath || normalizeQuaternions)) {
                         Float flip = 1.0f;
-                        for(std::size_t i = 0; i != values.size() - 1; ++i) {
-                            if(Math::dot(values[i], values[i + 1]*flip) < 0) flip = -flip;
-                            values[i + 1] *= flip;
-                        }
-                    }
-
-                    /* Normalize the quaternions if not already. Don't attempt
-                       to normalize every time to avoid tiny differences, only
-                       when the quaternion looks to be off. Again, not doing
-                       this for splines as it would cause things to go
-                       haywire. */
-                    if(configuration().value<bool>("normalizeQuaternions")) {
-                        for(auto& i: values) if(!i.isNormalized()) {
-                            i = i.normalized();
-                            hadToRenormalize = true;
+                        for(std::size_t i = 0; i != values.size(); ++i) {
+                            if(normalizeQuaternions && !values[i].isNormalized()) {
+                                values[i] = values[i].normalized();
+                                hadToRenormalize = true;
+                            }
+                            if(optimizeQuaternionShortestPath && i + 1 != values.size()) {
+                                if(Math::dot(values[i], values[i + 1]*flip) < 0) flip = -flip;
+                                values[i + 1] *= flip;
+                            }
                         }
                     }
+                    timeTrackUsed = 0;
 
                     type = AnimationTrackType::Quaternion;
                     track = Animation::TrackView<const Float, const Quaternion>{
@@ -717,6 +1553,28 @@ Containers::Optional<AnimationData> TinyGltfImporter::doAnimation(UnsignedInt id
                         Animation::Extrapolation::Constant};
                 }
 
+            /* Morph target weights, the tracks are created below */
+            } else if(channel.target_path == "weights") {
+                if(output.type != TINYGLTF_TYPE_SCALAR || output.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT) {
+                    Error{} << "Trade::TinyGltfImporter::animation(): weights track has unexpected type" << output.type << Debug::nospace << "/" << Debug::nospace << output.componentType;
+                    return Containers::NullOpt;
+                }
+
+                weightCount = weightsTrackTargetCount(_d->model, sampler);
+                if(!weightCount) {
+                    Error{} << "Trade::TinyGltfImporter::animation(): weights track has" << output.count << "values, which isn't a multiple of" << (interpolation == Animation::Interpolation::Spline ? 3 : 1)*input.count << "keys";
+                    return Containers::NullOpt;
+                }
+
+                target = AnimationTrackTargetType::Custom;
+                resultType = AnimationTrackType::Float;
+                if(interpolation == Animation::Interpolation::Spline) {
+                    /* Postprocess the spline track. This can be done only
+                       once for every track -- the function checks that. */
+                    postprocessWeightsSplineTrack(timeTrackUsed, keys, Containers::arrayCast<Float>(outputData), weightCount);
+                    type = AnimationTrackType::CubicHermite1D;
+                } else type = AnimationTrackType::Float;
+
             } else {
                 Error{} << "Trade::TinyGltfImporter::animation(): unsupported track target" << channel.target_path;
                 return Containers::NullOpt;
@@ -740,13 +1598,43 @@ Containers::Optional<AnimationData> TinyGltfImporter::doAnimation(UnsignedInt id
                 return Containers::NullOpt;
             }
 
-            tracks[trackId++] = AnimationTrackData{type, resultType, target,
-                /* In cases where multi-primitive mesh nodes are split into
-                   multiple objects, the animation should affect the first node
-                   -- the other nodes are direct children of it and so they get
-                   affected too */
-                UnsignedInt(_d->nodeSizeOffsets[channel.target_node]),
-                track};
+            /* In cases where multi-primitive mesh nodes are split into
+               multiple objects, the animation should affect the first node --
+               the other nodes are direct children of it and so they get
+               affected too */
+            const UnsignedInt object = _d->nodeSizeOffsets[channel.target_node];
+
+            /* Weights of each morph target are a separate track, referencing
+               the interleaved values with a stride */
+            if(weightCount) {
+                for(std::size_t j = 0; j != weightCount; ++j) {
+                    if(interpolation == Animation::Interpolation::Spline) {
+                        const auto values = Containers::arrayCast<const CubicHermite1D>(outputData);
+                        track = Animation::TrackView<const Float, const CubicHermite1D>{
+                            keys,
+                            Containers::StridedArrayView1D<const CubicHermite1D>{values,
+                                values + j, keys.size(),
+                                std::ptrdiff_t(weightCount*sizeof(CubicHermite1D))},
+                            interpolation,
+                            animationInterpolatorFor<CubicHermite1D>(interpolation),
+                            Animation::Extrapolation::Constant};
+                    } else {
+                        const auto values = Containers::arrayCast<const Float>(outputData);
+                        track = Animation::TrackView<const Float, const Float>{
+                            keys,
+                            Containers::StridedArrayView1D<const Float>{values,
+                                values + j, keys.size(),
+                                std::ptrdiff_t(weightCount*sizeof(Float))},
+                            interpolation,
+                            animationInterpolatorFor<Float>(interpolation),
+                            Animation::Extrapolation::Constant};
+                    }
+
+                    tracks[trackId++] = AnimationTrackData{type, resultType,
+                        target, object, track};
+                }
+            } else tracks[trackId++] = AnimationTrackData{type, resultType,
+                target, object, track};
         }
     }
 
@@ -754,8 +1642,7 @@ Containers::Optional<AnimationData> TinyGltfImporter::doAnimation(UnsignedInt id
         Warning{} << "Trade::TinyGltfImporter::animation(): quaternions in some rotation tracks were renormalized";
 
     return AnimationData{std::move(data), std::move(tracks),
-        configuration().value<bool>("mergeAnimationClips") ? nullptr :
-        &_d->model.animations[id]};
+        mergeAnimationClips ? nullptr : &_d->model.animations[id]};
 }
 
 Containers::Optional<CameraData> TinyGltfImporter::doCamera(UnsignedInt id) {
@@ -790,15 +1677,7 @@ UnsignedInt TinyGltfImporter::doLightCount() const {
 }
 
 Int TinyGltfImporter::doLightForName(const std::string& name) {
-    if(!_d->lightsForName) {
-        _d->lightsForName.emplace();
-        _d->lightsForName->reserve(_d->model.lights.size());
-        for(std::size_t i = 0; i != _d->model.lights.size(); ++i)
-            _d->lightsForName->emplace(_d->model.lights[i].name, i);
-    }
-
-    const auto found = _d->lightsForName->find(name);
-    return found == _d->lightsForName->end() ? -1 : found->second;
+    return _d->findName(Document::NameKind::Light, name);
 }
 
 std::string TinyGltfImporter::doLightName(const UnsignedInt id) {
@@ -849,15 +1728,7 @@ Int TinyGltfImporter::doDefaultScene() {
 UnsignedInt TinyGltfImporter::doSceneCount() const { return _d->model.scenes.size(); }
 
 Int TinyGltfImporter::doSceneForName(const std::string& name) {
-    if(!_d->scenesForName) {
-        _d->scenesForName.emplace();
-        _d->scenesForName->reserve(_d->model.scenes.size());
-        for(std::size_t i = 0; i != _d->model.scenes.size(); ++i)
-            _d->scenesForName->emplace(_d->model.scenes[i].name, i);
-    }
-
-    const auto found = _d->scenesForName->find(name);
-    return found == _d->scenesForName->end() ? -1 : found->second;
+    return _d->findName(Document::NameKind::Scene, name);
 }
 
 std::string TinyGltfImporter::doSceneName(const UnsignedInt id) {
@@ -882,18 +1753,7 @@ UnsignedInt TinyGltfImporter::doObject3DCount() const {
 }
 
 Int TinyGltfImporter::doObject3DForName(const std::string& name) {
-    if(!_d->nodesForName) {
-        _d->nodesForName.emplace();
-        _d->nodesForName->reserve(_d->model.nodes.size());
-        for(std::size_t i = 0; i != _d->model.nodes.size(); ++i) {
-            /* A mesh node can be duplicated for as many primitives as the mesh
-               has, point to the first node in the duplicate sequence */
-            _d->nodesForName->emplace(_d->model.nodes[i].name, _d->nodeSizeOffsets[i]);
-        }
-    }
-
-    const auto found = _d->nodesForName->find(name);
-    return found == _d->nodesForName->end() ? -1 : found->second;
+    return _d->findName(Document::NameKind::Node, name);
 }
 
 std::string TinyGltfImporter::doObject3DName(UnsignedInt id) {
@@ -997,23 +1857,499 @@ Containers::Pointer<ObjectData3D> TinyGltfImporter::doObject3D(UnsignedInt id) {
         new ObjectData3D{std::move(children), transformation, instanceType, instanceId, &node});
 }
 
-UnsignedInt TinyGltfImporter::doMeshCount() const {
-    return _d->meshMap.size();
+auto TinyGltfImporter::object3DHierarchy() -> Object3DHierarchy {
+    CORRADE_ASSERT(isOpened(), "Trade::TinyGltfImporter::object3DHierarchy(): no file opened", {});
+
+    const std::size_t count = _d->nodeMap.size();
+    Object3DHierarchy out;
+    out.parents = Containers::Array<Int>{Containers::NoInit, count};
+    out.flags = Containers::Array<ObjectFlags3D>{Containers::NoInit, count};
+    out.transformations = Containers::Array<Matrix4>{Containers::NoInit, count};
+    out.translations = Containers::Array<Vector3>{Containers::NoInit, count};
+    out.rotations = Containers::Array<Quaternion>{Containers::NoInit, count};
+    out.scalings = Containers::Array<Vector3>{Containers::NoInit, count};
+    out.meshes = Containers::Array<Int>{Containers::NoInit, count};
+    out.materials = Containers::Array<Int>{Containers::NoInit, count};
+    out.cameras = Containers::Array<Int>{Containers::NoInit, count};
+    out.lights = Containers::Array<Int>{Containers::NoInit, count};
+    out.skins = Containers::Array<Int>{Containers::NoInit, count};
+    std::fill(out.parents.begin(), out.parents.end(), -1);
+
+    /* Same as in doObject3D(), but for all nodes at once and in a single pass
+       without any temporary allocations */
+    const bool normalizeQuaternions = configuration().value<bool>("normalizeQuaternions");
+    std::size_t renormalizedCount = 0;
+    for(std::size_t i = 0; i != _d->model.nodes.size(); ++i) {
+        const tinygltf::Node& node = _d->model.nodes[i];
+        const std::size_t objectId = _d->nodeSizeOffsets[i];
+
+        for(const std::size_t child: node.children)
+            if(child < _d->model.nodes.size())
+                out.parents[_d->nodeSizeOffsets[child]] = objectId;
+
+        Vector3 translation;
+        Quaternion rotation;
+        Vector3 scaling{1.0f};
+        if(node.matrix.size() == 16) {
+            out.flags[objectId] = {};
+            out.transformations[objectId] = Matrix4(Matrix4d::from(node.matrix.data()));
+        } else {
+            out.flags[objectId] = ObjectFlag3D::HasTranslationRotationScaling;
+            if(node.translation.size() == 3)
+                translation = Vector3{Vector3d::from(node.translation.data())};
+            if(node.rotation.size() == 4) {
+                rotation = Quaternion{Vector3{Vector3d::from(node.rotation.data())}, Float(node.rotation[3])};
+                if(!rotation.isNormalized() && normalizeQuaternions) {
+                    rotation = rotation.normalized();
+                    ++renormalizedCount;
+                }
+            }
+            if(node.scale.size() == 3)
+                scaling = Vector3{Vector3d::from(node.scale.data())};
+            out.transformations[objectId] = Matrix4::from(rotation.toMatrix(), translation)*Matrix4::scaling(scaling);
+        }
+        out.translations[objectId] = translation;
+        out.rotations[objectId] = rotation;
+        out.scalings[objectId] = scaling;
+
+        const Int skin = std::size_t(node.skin) < _d->model.skins.size() ? node.skin : -1;
+        out.skins[objectId] = skin;
+        out.cameras[objectId] = node.camera >= 0 ? node.camera : -1;
+        out.lights[objectId] = -1;
+        const auto foundLight = node.extensions.find("KHR_lights_punctual");
+        if(foundLight != node.extensions.end()) {
+            const tinygltf::Value& light = foundLight->second.Get("light");
+            if(light.IsInt()) out.lights[objectId] = light.Get<int>();
+        }
+
+        out.meshes[objectId] = -1;
+        out.materials[objectId] = -1;
+        if(node.mesh < 0) continue;
+
+        /* The extra objects for multi-primitive meshes are children of the
+           first one with an identity transformation */
+        const std::vector<tinygltf::Primitive>& primitives = _d->model.meshes[node.mesh].primitives;
+        for(std::size_t j = 0; j != primitives.size(); ++j) {
+            const std::size_t id = objectId + j;
+            out.meshes[id] = _d->meshSizeOffsets[node.mesh] + j;
+            out.materials[id] = primitives[j].material;
+            if(!j) continue;
+
+            out.parents[id] = objectId;
+            out.flags[id] = ObjectFlag3D::HasTranslationRotationScaling;
+            out.transformations[id] = Matrix4{};
+            out.translations[id] = Vector3{};
+            out.rotations[id] = Quaternion{};
+            out.scalings[id] = Vector3{1.0f};
+            out.cameras[id] = -1;
+            out.lights[id] = -1;
+            out.skins[id] = skin;
+        }
+    }
+
+    if(renormalizedCount)
+        Warning{} << "Trade::TinyGltfImporter::object3DHierarchy():" << renormalizedCount << "rotation quaternions were renormalized";
+
+    return out;
 }
 
-Int TinyGltfImporter::doMeshForName(const std::string& name) {
-    if(!_d->meshesForName) {
-        _d->meshesForName.emplace();
-        _d->meshesForName->reserve(_d->model.meshes.size());
-        for(std::size_t i = 0; i != _d->model.meshes.size(); ++i) {
-            /* The mesh can be duplicated for as many primitives as it has,
-               point to the first mesh in the duplicate sequence */
-            _d->meshesForName->emplace(_d->model.meshes[i].name, _d->meshSizeOffsets[i]);
+UnsignedInt TinyGltfImporter::object3DInstanceCount(const UnsignedInt id) {
+    CORRADE_ASSERT(isOpened(), "Trade::TinyGltfImporter::object3DInstanceCount(): no file opened", {});
+    CORRADE_ASSERT(id < object3DCount(), "Trade::TinyGltfImporter::object3DInstanceCount(): index" << id << "out of range for" << object3DCount() << "entries", {});
+
+    /* All attributes are required to have the same count, so take the first.
+       If the accessor is invalid, report zero here and let
+       object3DInstances() fail with a proper message. */
+    const tinygltf::Value* const attributes = instancingAttributes(_d->model.nodes[_d->nodeMap[id].first]);
+    if(!attributes) return 0;
+    const tinygltf::Value& accessor = attributes->Get(attributes->Keys()[0]);
+    if(!accessor.IsInt() || std::size_t(accessor.Get<int>()) >= _d->model.accessors.size())
+        return 0;
+    return _d->model.accessors[accessor.Get<int>()].count;
+}
+
+Containers::Optional<MeshData> TinyGltfImporter::object3DInstances(const UnsignedInt id) {
+    CORRADE_ASSERT(isOpened(), "Trade::TinyGltfImporter::object3DInstances(): no file opened", {});
+    CORRADE_ASSERT(id < object3DCount(), "Trade::TinyGltfImporter::object3DInstances(): index" << id << "out of range for" << object3DCount() << "entries", {});
+    const tinygltf::Node& node = _d->model.nodes[_d->nodeMap[id].first];
+    const tinygltf::Value* const attributes = instancingAttributes(node);
+    CORRADE_ASSERT(attributes, "Trade::TinyGltfImporter::object3DInstances(): object" << id << "is not instanced", {});
+
+    /* Instance data aren't counted among buffer uses, so the buffers get
+       released right after if nothing else needs them */
+    if(_d->lazyBuffers.empty()) return object3DInstancesInternal(node, *attributes);
+
+    std::vector<UnsignedInt> buffers;
+    for(const std::string& name: attributes->Keys()) {
+        const tinygltf::Value& accessor = attributes->Get(name);
+        if(accessor.IsInt()) accessorBuffer(_d->model, accessor.Get<int>(), buffers);
+    }
+    if(!loadLazyBuffers("object3DInstances", buffers)) return Containers::NullOpt;
+
+    Containers::Optional<MeshData> out = object3DInstancesInternal(node, *attributes);
+    releaseLazyBuffers(buffers, false, false);
+    return out;
+}
+
+Containers::Optional<MeshData> TinyGltfImporter::object3DInstancesInternal(const tinygltf::Node& node, const tinygltf::Value& attributes) {
+    const std::vector<std::string> names = attributes.Keys();
+
+    /* Gather the attributes and calculate the total size, each attribute is
+       tightly packed after the previous. Offset-only, patched once the data
+       are allocated. */
+    UnsignedInt instanceCount = 0;
+    std::size_t size = 0;
+    Containers::Array<MeshAttributeData> attributeData{names.size()};
+    Containers::Array<Int> accessorIds{Containers::NoInit, names.size()};
+    for(std::size_t i = 0; i != names.size(); ++i) {
+        const tinygltf::Value& accessorId = attributes.Get(names[i]);
+        if(!accessorId.IsInt()) {
+            Error{} << "Trade::TinyGltfImporter::object3DInstances(): invalid accessor for attribute" << names[i];
+            return Containers::NullOpt;
+        }
+
+        const tinygltf::Accessor* const accessor = checkedAccessor(_d->model, "object3DInstances", accessorId.Get<int>());
+        if(!accessor) return Containers::NullOpt;
+
+        /* Standard attributes have to be of the type the extension specifies,
+           any component type allowed by checkedVertexFormat() is fine. */
+        if((names[i] == "TRANSLATION" && accessor->type != TINYGLTF_TYPE_VEC3) ||
+           (names[i] == "ROTATION" && accessor->type != TINYGLTF_TYPE_VEC4) ||
+           (names[i] == "SCALE" && accessor->type != TINYGLTF_TYPE_VEC3)) {
+            Error{} << "Trade::TinyGltfImporter::object3DInstances(): unexpected" << names[i] << "type" << accessor->type;
+            return Containers::NullOpt;
+        }
+
+        const VertexFormat format = checkedVertexFormat(*accessor, "object3DInstances");
+        if(format == VertexFormat{}) return Containers::NullOpt;
+
+        if(i == 0) instanceCount = accessor->count;
+        else if(accessor->count != instanceCount) {
+            Error{} << "Trade::TinyGltfImporter::object3DInstances(): mismatched instance count for attribute" << names[i] << Debug::nospace << ", expected" << instanceCount << "but got" << accessor->count;
+            return Containers::NullOpt;
+        }
+
+        accessorIds[i] = accessorId.Get<int>();
+        attributeData[i] = MeshAttributeData{_d->meshAttributesForName.at(names[i]),
+            format, size, instanceCount, std::ptrdiff_t(vertexFormatSize(format))};
+        size += instanceCount*vertexFormatSize(format);
+    }
+
+    /* Copy the data in, apply sparse values if any and convert the
+       attributes to absolute. Accessors without a buffer view are sparse and
+       zero-initialized otherwise. */
+    Containers::Array<char> data{Containers::ValueInit, size};
+    for(std::size_t i = 0; i != attributeData.size(); ++i) {
+        const tinygltf::Accessor& accessor = _d->model.accessors[accessorIds[i]];
+        const std::size_t elementSize = vertexFormatSize(attributeData[i].format());
+        char* const begin = data + attributeData[i].offset(data);
+        if(accessor.bufferView != -1)
+            Utility::copy(bufferView(_d->model, accessor),
+                Containers::StridedArrayView2D<char>{data, begin,
+                    {instanceCount, elementSize},
+                    {std::ptrdiff_t(elementSize), 1}});
+
+        Containers::StridedArrayView1D<char> dst{data, begin, instanceCount,
+            std::ptrdiff_t(elementSize)};
+        if(accessor.sparse.isSparse && !applySparseAccessor(_d->model, "object3DInstances", accessorIds[i], dst))
+            return Containers::NullOpt;
+
+        attributeData[i] = MeshAttributeData{attributeData[i].name(),
+            attributeData[i].format(), dst};
+    }
+
+    return MeshData{MeshPrimitive::Instances, std::move(data),
+        std::move(attributeData), instanceCount, &node};
+}
+
+UnsignedInt TinyGltfImporter::skin3DCount() {
+    CORRADE_ASSERT(isOpened(), "Trade::TinyGltfImporter::skin3DCount(): no file opened", {});
+    return _d->model.skins.size();
+}
+
+Int TinyGltfImporter::skin3DForName(const std::string& name) {
+    CORRADE_ASSERT(isOpened(), "Trade::TinyGltfImporter::skin3DForName(): no file opened", {});
+    return _d->findName(Document::NameKind::Skin, name);
+}
+
+std::string TinyGltfImporter::skin3DName(const UnsignedInt id) {
+    CORRADE_ASSERT(isOpened(), "Trade::TinyGltfImporter::skin3DName(): no file opened", {});
+    CORRADE_ASSERT(id < _d->model.skins.size(), "Trade::TinyGltfImporter::skin3DName(): index" << id << "out of range for" << _d->model.skins.size() << "entries", {});
+    return _d->model.skins[id].name;
+}
+
+Int TinyGltfImporter::object3DSkin(const UnsignedInt id) {
+    CORRADE_ASSERT(isOpened(), "Trade::TinyGltfImporter::object3DSkin(): no file opened", {});
+    CORRADE_ASSERT(id < object3DCount(), "Trade::TinyGltfImporter::object3DSkin(): index" << id << "out of range for" << object3DCount() << "entries", {});
+
+    /* Invalid skin references are reported as no skin */
+    const Int skin = _d->model.nodes[_d->nodeMap[id].first].skin;
+    return std::size_t(skin) < _d->model.skins.size() ? skin : -1;
+}
+
+Containers::Optional<Containers::Array<UnsignedInt>> TinyGltfImporter::skin3DJoints(const UnsignedInt id) {
+    CORRADE_ASSERT(isOpened(), "Trade::TinyGltfImporter::skin3DJoints(): no file opened", {});
+    CORRADE_ASSERT(id < _d->model.skins.size(), "Trade::TinyGltfImporter::skin3DJoints(): index" << id << "out of range for" << _d->model.skins.size() << "entries", {});
+    const tinygltf::Skin& skin = _d->model.skins[id];
+
+    /* Translate the node IDs to object IDs, pointing to the first object of
+       multi-primitive node sequences */
+    Containers::Array<UnsignedInt> joints{Containers::NoInit, skin.joints.size()};
+    for(std::size_t i = 0; i != joints.size(); ++i) {
+        if(std::size_t(skin.joints[i]) >= _d->model.nodes.size()) {
+            Error{} << "Trade::TinyGltfImporter::skin3DJoints(): joint node" << skin.joints[i] << "out of bounds for" << _d->model.nodes.size() << "nodes";
+            return Containers::NullOpt;
+        }
+
+        joints[i] = _d->nodeSizeOffsets[skin.joints[i]];
+    }
+
+    return Containers::optional(std::move(joints));
+}
+
+Containers::Optional<Containers::Array<Matrix4>> TinyGltfImporter::skin3DInverseBindMatrices(const UnsignedInt id) {
+    CORRADE_ASSERT(isOpened(), "Trade::TinyGltfImporter::skin3DInverseBindMatrices(): no file opened", {});
+    CORRADE_ASSERT(id < _d->model.skins.size(), "Trade::TinyGltfImporter::skin3DInverseBindMatrices(): index" << id << "out of range for" << _d->model.skins.size() << "entries", {});
+    const tinygltf::Skin& skin = _d->model.skins[id];
+
+    /* If the accessor isn't present, the matrices are all identities */
+    if(skin.inverseBindMatrices == -1)
+        return Containers::optional(Containers::Array<Matrix4>{Containers::DirectInit, skin.joints.size(), Math::IdentityInit});
+
+    /* Inverse bind matrices aren't counted among buffer uses, so the buffers
+       get released right after if nothing else needs them */
+    if(_d->lazyBuffers.empty()) return skin3DInverseBindMatricesInternal(skin);
+
+    std::vector<UnsignedInt> buffers;
+    accessorBuffer(_d->model, skin.inverseBindMatrices, buffers);
+    if(!loadLazyBuffers("skin3DInverseBindMatrices", buffers)) return Containers::NullOpt;
+
+    Containers::Optional<Containers::Array<Matrix4>> out = skin3DInverseBindMatricesInternal(skin);
+    releaseLazyBuffers(buffers, false, false);
+    return out;
+}
+
+Containers::Optional<Containers::Array<Matrix4>> TinyGltfImporter::skin3DInverseBindMatricesInternal(const tinygltf::Skin& skin) {
+    const tinygltf::Accessor* const accessor = checkedAccessor(_d->model, "skin3DInverseBindMatrices", skin.inverseBindMatrices);
+    if(!accessor) return Containers::NullOpt;
+
+    if(accessor->type != TINYGLTF_TYPE_MAT4) {
+        Error{} << "Trade::TinyGltfImporter::skin3DInverseBindMatrices(): unexpected inverse bind matrix type" << accessor->type;
+        return Containers::NullOpt;
+    }
+
+    if(accessor->componentType != TINYGLTF_COMPONENT_TYPE_FLOAT || accessor->normalized) {
+        Error{} << "Trade::TinyGltfImporter::skin3DInverseBindMatrices(): unsupported inverse bind matrix component type"
+            << (accessor->normalized ? "normalized" : "unnormalized")
+            << accessor->componentType;
+        return Containers::NullOpt;
+    }
+
+    if(accessor->count != skin.joints.size()) {
+        Error{} << "Trade::TinyGltfImporter::skin3DInverseBindMatrices(): mismatched inverse bind matrix count, expected" << skin.joints.size() << "but got" << accessor->count;
+        return Containers::NullOpt;
+    }
+
+    /* Copy the matrices into a tightly packed array in a single pass, then
+       apply sparse values if any. Accessors without a buffer view are sparse
+       and zero-initialized otherwise. */
+    Containers::Array<Matrix4> out{Containers::ValueInit, accessor->count};
+    const Containers::ArrayView<char> data = Containers::arrayCast<char>(out);
+    if(accessor->bufferView != -1)
+        Utility::copy(bufferView(_d->model, *accessor),
+            Containers::StridedArrayView2D<char>{data, {out.size(), sizeof(Matrix4)}});
+
+    Containers::StridedArrayView1D<char> dst{data, data.data(), out.size(),
+        std::ptrdiff_t(sizeof(Matrix4))};
+    if(accessor->sparse.isSparse && !applySparseAccessor(_d->model, "skin3DInverseBindMatrices", skin.inverseBindMatrices, dst))
+        return Containers::NullOpt;
+
+    return Containers::optional(std::move(out));
+}
+
+UnsignedInt TinyGltfImporter::meshMorphTargetCount(const UnsignedInt id) {
+    CORRADE_ASSERT(isOpened(), "Trade::TinyGltfImporter::meshMorphTargetCount(): no file opened", {});
+    CORRADE_ASSERT(id < meshCount(), "Trade::TinyGltfImporter::meshMorphTargetCount(): index" << id << "out of range for" << meshCount() << "entries", {});
+    return _d->model.meshes[_d->meshMap[id].first].primitives[_d->meshMap[id].second].targets.size();
+}
+
+Containers::Array<Float> TinyGltfImporter::meshMorphTargetWeights(const UnsignedInt id) {
+    CORRADE_ASSERT(isOpened(), "Trade::TinyGltfImporter::meshMorphTargetWeights(): no file opened", {});
+    CORRADE_ASSERT(id < meshCount(), "Trade::TinyGltfImporter::meshMorphTargetWeights(): index" << id << "out of range for" << meshCount() << "entries", {});
+    const tinygltf::Mesh& mesh = _d->model.meshes[_d->meshMap[id].first];
+
+    /* The weights are shared by all primitives, if not present the default
+       is zero */
+    Containers::Array<Float> out{Containers::ValueInit, mesh.primitives[_d->meshMap[id].second].targets.size()};
+    for(std::size_t i = 0, max = Math::min(out.size(), mesh.weights.size()); i != max; ++i)
+        out[i] = mesh.weights[i];
+    return out;
+}
+
+Containers::Optional<MeshData> TinyGltfImporter::meshMorphTarget(const UnsignedInt id, const UnsignedInt target) {
+    CORRADE_ASSERT(isOpened(), "Trade::TinyGltfImporter::meshMorphTarget(): no file opened", {});
+    CORRADE_ASSERT(id < meshCount(), "Trade::TinyGltfImporter::meshMorphTarget(): index" << id << "out of range for" << meshCount() << "entries", {});
+    const tinygltf::Primitive& primitive = _d->model.meshes[_d->meshMap[id].first].primitives[_d->meshMap[id].second];
+    CORRADE_ASSERT(target < primitive.targets.size(), "Trade::TinyGltfImporter::meshMorphTarget(): index" << target << "out of range for" << primitive.targets.size() << "morph targets", {});
+
+    /* Morph targets aren't counted among buffer uses, so the buffers get
+       released right after if nothing else needs them */
+    if(_d->lazyBuffers.empty()) return meshMorphTargetInternal(id, target);
+
+    std::vector<UnsignedInt> buffers;
+    for(const std::pair<const std::string, int>& attribute: primitive.targets[target])
+        accessorBuffer(_d->model, attribute.second, buffers);
+    if(!loadLazyBuffers("meshMorphTarget", buffers)) return Containers::NullOpt;
+
+    Containers::Optional<MeshData> out = meshMorphTargetInternal(id, target);
+    releaseLazyBuffers(buffers, false, false);
+    return out;
+}
+
+Containers::Optional<MeshData> TinyGltfImporter::meshMorphTargetInternal(const UnsignedInt id, const UnsignedInt targetId) {
+    const tinygltf::Mesh& mesh = _d->model.meshes[_d->meshMap[id].first];
+    const tinygltf::Primitive& primitive = mesh.primitives[_d->meshMap[id].second];
+    const std::map<std::string, int>& target = primitive.targets[targetId];
+
+    /* Vertex count of the base mesh, if known. If the accessor is invalid,
+       mesh() fails with a proper message. */
+    UnsignedInt vertexCount = 0;
+    if(!primitive.attributes.empty() && std::size_t(primitive.attributes.begin()->second) < _d->model.accessors.size())
+        vertexCount = _d->model.accessors[primitive.attributes.begin()->second].count;
+
+    /* Gather the attributes and calculate the total size of a dense
+       representation, each attribute tightly packed after the previous.
+       Offset-only, patched once the data are allocated. The sparse
+       representation is possible only if all attributes are sparse with
+       implicit zero base values and share the same indices. */
+    bool sparse = true;
+    std::size_t size = 0;
+    std::size_t sparseSize = 0;
+    Containers::Array<MeshAttributeData> attributeData{target.size()};
+    Containers::Array<const tinygltf::Accessor*> accessors{Containers::NoInit, target.size()};
+    Containers::Array<Int> accessorIds{Containers::NoInit, target.size()};
+    std::size_t i = 0;
+    for(const std::pair<const std::string, int>& attribute: target) {
+        const tinygltf::Accessor* const accessor = checkedAccessor(_d->model, "meshMorphTarget", attribute.second);
+        if(!accessor) return Containers::NullOpt;
+
+        MeshAttribute name;
+        if(attribute.first == "POSITION")
+            name = MeshAttribute::Position;
+        else if(attribute.first == "NORMAL")
+            name = MeshAttribute::Normal;
+        else if(attribute.first == "TANGENT")
+            name = MeshAttribute::Tangent;
+        else name = _d->meshAttributesForName.at(attribute.first);
+
+        /* Displacements of the builtin attributes are always three-component,
+           any component type allowed by checkedVertexFormat() is fine */
+        if(!isMeshAttributeCustom(name) && accessor->type != TINYGLTF_TYPE_VEC3) {
+            Error{} << "Trade::TinyGltfImporter::meshMorphTarget(): unexpected" << attribute.first << "type" << accessor->type;
+            return Containers::NullOpt;
+        }
+
+        const VertexFormat format = checkedVertexFormat(*accessor, "meshMorphTarget");
+        if(format == VertexFormat{}) return Containers::NullOpt;
+
+        if(i == 0 && !vertexCount)
+            vertexCount = accessor->count;
+        else if(accessor->count != vertexCount) {
+            Error{} << "Trade::TinyGltfImporter::meshMorphTarget(): mismatched vertex count for attribute" << attribute.first << Debug::nospace << ", expected" << vertexCount << "but got" << accessor->count;
+            return Containers::NullOpt;
+        }
+
+        if(!accessor->sparse.isSparse || accessor->bufferView != -1 ||
+            (i && (accessor->sparse.count != accessors[0]->sparse.count ||
+                   accessor->sparse.indices.componentType != accessors[0]->sparse.indices.componentType ||
+                   std::memcmp(sparseIndexData(_d->model, *accessor), sparseIndexData(_d->model, *accessors[0]), sparseIndexData(_d->model, *accessor).size()) != 0)))
+            sparse = false;
+
+        accessors[i] = accessor;
+        accessorIds[i] = attribute.second;
+        attributeData[i] = MeshAttributeData{name, format, size, vertexCount,
+            std::ptrdiff_t(vertexFormatSize(format))};
+        size += vertexCount*vertexFormatSize(format);
+        sparseSize += (accessor->sparse.isSparse ? accessor->sparse.count : 0)*vertexFormatSize(format);
+        ++i;
+    }
+
+    /* Sparse representation, indices are IDs of the displaced vertices of
+       the base mesh and the attributes contain the displacements for them.
+       Both are copied as-is. */
+    if(sparse && !accessors.empty()) {
+        const tinygltf::Accessor& first = *accessors[0];
+        const UnsignedInt count = first.sparse.count;
+        const Containers::ArrayView<const char> srcIndices = sparseIndexData(_d->model, first);
+        for(std::size_t j = 0; j != count; ++j) {
+            const UnsignedInt index = sparseIndex(first, srcIndices, j);
+            if(index >= vertexCount) {
+                Error{} << "Trade::TinyGltfImporter::meshMorphTarget(): sparse index" << index << "out of bounds for" << vertexCount << "elements in accessor" << accessorIds[0];
+                return Containers::NullOpt;
+            }
+        }
+
+        MeshIndexType indexType;
+        if(first.sparse.indices.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE)
+            indexType = MeshIndexType::UnsignedByte;
+        else if(first.sparse.indices.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT)
+            indexType = MeshIndexType::UnsignedShort;
+        else indexType = MeshIndexType::UnsignedInt;
+        Containers::Array<char> indexData{Containers::NoInit, srcIndices.size()};
+        Utility::copy(srcIndices, indexData);
+
+        Containers::Array<char> vertexData{Containers::NoInit, sparseSize};
+        std::size_t offset = 0;
+        for(std::size_t j = 0; j != attributeData.size(); ++j) {
+            const Containers::ArrayView<const char> src = sparseValueData(_d->model, *accessors[j]);
+            Utility::copy(src, vertexData.slice(offset, offset + src.size()));
+            attributeData[j] = MeshAttributeData{attributeData[j].name(),
+                attributeData[j].format(),
+                Containers::StridedArrayView1D<const void>{vertexData,
+                    vertexData + offset, count,
+                    std::ptrdiff_t(vertexFormatSize(attributeData[j].format()))}};
+            offset += src.size();
         }
+
+        MeshIndexData indices{indexType, indexData};
+        return MeshData{MeshPrimitive::Points,
+            std::move(indexData), indices,
+            std::move(vertexData), std::move(attributeData), count, &mesh};
     }
 
-    const auto found = _d->meshesForName->find(name);
-    return found == _d->meshesForName->end() ? -1 : found->second;
+    /* Dense representation. Copy the data in, apply sparse values if any and
+       convert the attributes to absolute. Accessors without a buffer view are
+       sparse and zero-initialized otherwise. */
+    Containers::Array<char> data{Containers::ValueInit, size};
+    for(std::size_t j = 0; j != attributeData.size(); ++j) {
+        const tinygltf::Accessor& accessor = *accessors[j];
+        const std::size_t elementSize = vertexFormatSize(attributeData[j].format());
+        char* const begin = data + attributeData[j].offset(data);
+        if(accessor.bufferView != -1)
+            Utility::copy(bufferView(_d->model, accessor),
+                Containers::StridedArrayView2D<char>{data, begin,
+                    {vertexCount, elementSize},
+                    {std::ptrdiff_t(elementSize), 1}});
+
+        Containers::StridedArrayView1D<char> dst{data, begin, vertexCount,
+            std::ptrdiff_t(elementSize)};
+        if(accessor.sparse.isSparse && !applySparseAccessor(_d->model, "meshMorphTarget", accessorIds[j], dst))
+            return Containers::NullOpt;
+
+        attributeData[j] = MeshAttributeData{attributeData[j].name(),
+            attributeData[j].format(), dst};
+    }
+
+    return MeshData{MeshPrimitive::Points, std::move(data),
+        std::move(attributeData), vertexCount, &mesh};
+}
+
+UnsignedInt TinyGltfImporter::doMeshCount() const {
+    return _d->meshMap.size();
+}
+
+Int TinyGltfImporter::doMeshForName(const std::string& name) {
+    return _d->findName(Document::NameKind::Mesh, name);
 }
 
 std::string TinyGltfImporter::doMeshName(const UnsignedInt id) {
@@ -1022,8 +2358,32 @@ std::string TinyGltfImporter::doMeshName(const UnsignedInt id) {
 }
 
 Containers::Optional<MeshData> TinyGltfImporter::doMesh(const UnsignedInt id, UnsignedInt) {
+    if(_d->lazyBuffers.empty()) return profiledMeshInternal(id);
+
+    const std::vector<UnsignedInt> buffers = primitiveBuffers(_d->model, _d->model.meshes[_d->meshMap[id].first].primitives[_d->meshMap[id].second]);
+    if(!loadLazyBuffers("mesh", buffers)) return Containers::NullOpt;
+
+    Containers::Optional<MeshData> out = profiledMeshInternal(id);
+
+    /* Meshes that may reference the buffers directly need them to stay */
+    releaseLazyBuffers(buffers, !_d->meshImported[id],
+        configuration().value<bool>("zeroCopy"));
+    _d->meshImported[id] = true;
+
+    return out;
+}
+
+Containers::Optional<MeshData> TinyGltfImporter::profiledMeshInternal(const UnsignedInt id) {
+    MAGNUM_IMPORTER_PROFILE(profile, _profilingCallback, _profilingUserData, "mesh", 0);
+    Containers::Optional<MeshData> out = meshInternal(id);
+    if(out) MAGNUM_IMPORTER_PROFILE_BYTES(profile, out->vertexData().size() + out->indexData().size());
+    return out;
+}
+
+Containers::Optional<MeshData> TinyGltfImporter::meshInternal(const UnsignedInt id) {
     const tinygltf::Mesh& mesh = _d->model.meshes[_d->meshMap[id].first];
     const tinygltf::Primitive& primitive = mesh.primitives[_d->meshMap[id].second];
+    const bool trustedInput = configuration().value<bool>("trustedInput");
 
     MeshPrimitive meshPrimitive{};
     if(primitive.mode == TINYGLTF_MODE_POINTS) {
@@ -1045,29 +2405,60 @@ Containers::Optional<MeshData> TinyGltfImporter::doMesh(const UnsignedInt id, Un
         return Containers::NullOpt;
     }
 
+    /* Draco-compressed primitives are decoded by tinygltf already during
+       opening, which redirects the accessors to newly created buffers. If
+       that didn't happen, the accessors don't reference any buffer view. */
+    if(primitive.extensions.find("KHR_draco_mesh_compression") != primitive.extensions.end()) {
+        #ifndef MAGNUM_TINYGLTFIMPORTER_WITH_DRACO
+        Error{} << "Trade::TinyGltfImporter::mesh(): KHR_draco_mesh_compression is not supported, the plugin was built without Draco";
+        return Containers::NullOpt;
+        #else
+        bool decoded = true;
+        for(const std::pair<const std::string, int>& attribute: primitive.attributes)
+            if(std::size_t(attribute.second) < _d->model.accessors.size() && _d->model.accessors[attribute.second].bufferView == -1)
+                decoded = false;
+        if(std::size_t(primitive.indices) < _d->model.accessors.size() && _d->model.accessors[primitive.indices].bufferView == -1)
+            decoded = false;
+        if(!decoded) {
+            Error{} << "Trade::TinyGltfImporter::mesh(): can't decode KHR_draco_mesh_compression data";
+            return Containers::NullOpt;
+        }
+        #endif
+    }
+
     /* Gather all (whitelisted) attributes and the total buffer range spanning
        them */
     std::size_t bufferId;
+    bool hasBufferRange = false;
+    bool multipleBuffers = false;
     UnsignedInt vertexCount = 0;
     std::size_t attributeId = 0;
     Math::Range1D<std::size_t> bufferRange;
+    /* Sparse accessors without a buffer view get zero-filled space after
+       the copied buffer range */
+    std::size_t sparseOnlySize = 0;
     Containers::Array<MeshAttributeData> attributeData{primitive.attributes.size()};
+    Containers::Array<Int> attributeBufferViews{Containers::NoInit, primitive.attributes.size()};
+    Containers::Array<Int> attributeSparseAccessors{Containers::NoInit, primitive.attributes.size()};
+    const std::string objectIdAttribute = configuration().value("objectIdAttribute");
     for(auto& attribute: primitive.attributes) {
-        auto* acessorPointer = checkedAccessor(_d->model, "mesh", attribute.second);
+        auto* acessorPointer = checkedAccessor(_d->model, "mesh", attribute.second, trustedInput);
         if(!acessorPointer) return Containers::NullOpt;
         const tinygltf::Accessor& accessor = *acessorPointer;
 
-        /* Whitelist supported name and type combinations */
+        /* Whitelist supported name and type combinations. With trusted input
+           only the texture coordinate types are checked, as the Y-flip below
+           relies on them. */
         MeshAttribute name;
         if(attribute.first == "POSITION") {
             name = MeshAttribute::Position;
 
-            if(accessor.type != TINYGLTF_TYPE_VEC3) {
+            if(!trustedInput && accessor.type != TINYGLTF_TYPE_VEC3) {
                 Error{} << "Trade::TinyGltfImporter::mesh(): unexpected POSITION type" << accessor.type;
                 return Containers::NullOpt;
             }
 
-            if(!(accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT && !accessor.normalized) &&
+            if(!trustedInput && !(accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT && !accessor.normalized) &&
                /* Both normalized and unnormalized bytes/shorts are okay */
                accessor.componentType != TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE &&
                accessor.componentType != TINYGLTF_COMPONENT_TYPE_BYTE &&
@@ -1082,12 +2473,12 @@ Containers::Optional<MeshData> TinyGltfImporter::doMesh(const UnsignedInt id, Un
         } else if(attribute.first == "NORMAL") {
             name = MeshAttribute::Normal;
 
-            if(accessor.type != TINYGLTF_TYPE_VEC3) {
+            if(!trustedInput && accessor.type != TINYGLTF_TYPE_VEC3) {
                 Error{} << "Trade::TinyGltfImporter::mesh(): unexpected NORMAL type" << accessor.type;
                 return Containers::NullOpt;
             }
 
-            if(!(accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT && !accessor.normalized) &&
+            if(!trustedInput && !(accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT && !accessor.normalized) &&
                !(accessor.componentType == TINYGLTF_COMPONENT_TYPE_BYTE && accessor.normalized) &&
                !(accessor.componentType == TINYGLTF_COMPONENT_TYPE_SHORT && accessor.normalized)) {
                 Error{} << "Trade::TinyGltfImporter::mesh(): unsupported NORMAL component type"
@@ -1099,12 +2490,12 @@ Containers::Optional<MeshData> TinyGltfImporter::doMesh(const UnsignedInt id, Un
         } else if(attribute.first == "TANGENT") {
             name = MeshAttribute::Tangent;
 
-            if(accessor.type != TINYGLTF_TYPE_VEC4) {
+            if(!trustedInput && accessor.type != TINYGLTF_TYPE_VEC4) {
                 Error{} << "Trade::TinyGltfImporter::mesh(): unexpected TANGENT type" << accessor.type;
                 return Containers::NullOpt;
             }
 
-            if(!(accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT && !accessor.normalized) &&
+            if(!trustedInput && !(accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT && !accessor.normalized) &&
                !(accessor.componentType == TINYGLTF_COMPONENT_TYPE_BYTE && accessor.normalized) &&
                !(accessor.componentType == TINYGLTF_COMPONENT_TYPE_SHORT && accessor.normalized)) {
                 Error{} << "Trade::TinyGltfImporter::mesh(): unsupported TANGENT component type"
@@ -1138,12 +2529,12 @@ Containers::Optional<MeshData> TinyGltfImporter::doMesh(const UnsignedInt id, Un
         } else if(Utility::String::beginsWith(attribute.first, "COLOR")) {
             name = MeshAttribute::Color;
 
-            if(accessor.type != TINYGLTF_TYPE_VEC4 && accessor.type != TINYGLTF_TYPE_VEC3) {
+            if(!trustedInput && accessor.type != TINYGLTF_TYPE_VEC4 && accessor.type != TINYGLTF_TYPE_VEC3) {
                 Error{} << "Trade::TinyGltfImporter::mesh(): unexpected COLOR type" << accessor.type;
                 return Containers::NullOpt;
             }
 
-            if(!(accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT && !accessor.normalized) &&
+            if(!trustedInput && !(accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT && !accessor.normalized) &&
                !(accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE && accessor.normalized) &&
                !(accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT && accessor.normalized)) {
                 Error{} << "Trade::TinyGltfImporter::mesh(): unsupported COLOR component type"
@@ -1152,19 +2543,57 @@ Containers::Optional<MeshData> TinyGltfImporter::doMesh(const UnsignedInt id, Un
                 return Containers::NullOpt;
             }
 
+        /* Skinning attributes end with _0, _1 ... There are no builtin
+           attributes for these, so they stay custom, but only the compact
+           types allowed by the spec are accepted and they're never expanded
+           to floats */
+        } else if(Utility::String::beginsWith(attribute.first, "JOINTS_")) {
+            name = _d->meshAttributesForName.at(attribute.first);
+
+            if(!trustedInput && accessor.type != TINYGLTF_TYPE_VEC4) {
+                Error{} << "Trade::TinyGltfImporter::mesh(): unexpected JOINTS type" << accessor.type;
+                return Containers::NullOpt;
+            }
+
+            if(!trustedInput && ((accessor.componentType != TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE &&
+                                  accessor.componentType != TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT) ||
+                                  accessor.normalized)) {
+                Error{} << "Trade::TinyGltfImporter::mesh(): unsupported JOINTS component type"
+                    << (accessor.normalized ? "normalized" : "unnormalized")
+                    << accessor.componentType;
+                return Containers::NullOpt;
+            }
+
+        } else if(Utility::String::beginsWith(attribute.first, "WEIGHTS_")) {
+            name = _d->meshAttributesForName.at(attribute.first);
+
+            if(!trustedInput && accessor.type != TINYGLTF_TYPE_VEC4) {
+                Error{} << "Trade::TinyGltfImporter::mesh(): unexpected WEIGHTS type" << accessor.type;
+                return Containers::NullOpt;
+            }
+
+            if(!trustedInput && !(accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT && !accessor.normalized) &&
+               !(accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE && accessor.normalized) &&
+               !(accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT && accessor.normalized)) {
+                Error{} << "Trade::TinyGltfImporter::mesh(): unsupported WEIGHTS component type"
+                    << (accessor.normalized ? "normalized" : "unnormalized")
+                    << accessor.componentType;
+                return Containers::NullOpt;
+            }
+
         /* Object ID, name user-configurable */
-        } else if(attribute.first == configuration().value("objectIdAttribute")) {
+        } else if(attribute.first == objectIdAttribute) {
             name = MeshAttribute::ObjectId;
 
-            if(accessor.type != TINYGLTF_TYPE_SCALAR) {
+            if(!trustedInput && accessor.type != TINYGLTF_TYPE_SCALAR) {
                 Error{} << "Trade::TinyGltfImporter::mesh(): unexpected object ID type" << accessor.type;
                 return Containers::NullOpt;
             }
 
-            if((accessor.componentType != TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT &&
-                accessor.componentType != TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT &&
-                accessor.componentType != TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE) ||
-                accessor.normalized) {
+            if(!trustedInput && ((accessor.componentType != TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT &&
+                                  accessor.componentType != TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT &&
+                                  accessor.componentType != TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE) ||
+                                  accessor.normalized)) {
                 Error{} << "Trade::TinyGltfImporter::mesh(): unsupported object ID component type"
                     << (accessor.normalized ? "normalized" : "unnormalized")
                     << accessor.componentType;
@@ -1175,91 +2604,51 @@ Containers::Optional<MeshData> TinyGltfImporter::doMesh(const UnsignedInt id, Un
         } else name = _d->meshAttributesForName.at(attribute.first);
 
         /* Convert to our vertex format */
-        VertexFormat componentFormat;
-        if(accessor.componentType == TINYGLTF_COMPONENT_TYPE_BYTE)
-            componentFormat = VertexFormat::Byte;
-        else if(accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE)
-            componentFormat = VertexFormat::UnsignedByte;
-        else if(accessor.componentType == TINYGLTF_COMPONENT_TYPE_SHORT)
-            componentFormat = VertexFormat::Short;
-        else if(accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT)
-            componentFormat = VertexFormat::UnsignedShort;
-        else if(accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT)
-            componentFormat = VertexFormat::UnsignedInt;
-        else if(accessor.componentType == TINYGLTF_COMPONENT_TYPE_INT)
-            componentFormat = VertexFormat::Int;
-        else if(accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT)
-            componentFormat = VertexFormat::Float;
-        else if(accessor.componentType == TINYGLTF_COMPONENT_TYPE_DOUBLE)
-            componentFormat = VertexFormat::Double;
-        else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
-
-        UnsignedInt componentCount;
-        UnsignedInt vectorCount = 0;
-        if(accessor.type == TINYGLTF_TYPE_SCALAR)
-            componentCount = 1;
-        else if(accessor.type == TINYGLTF_TYPE_VEC2)
-            componentCount = 2;
-        else if(accessor.type == TINYGLTF_TYPE_VEC3)
-            componentCount = 3;
-        else if(accessor.type == TINYGLTF_TYPE_VEC4)
-            componentCount = 4;
-        else if(accessor.type == TINYGLTF_TYPE_MAT2) {
-            componentCount = 2;
-            vectorCount = 2;
-        } else if(accessor.type == TINYGLTF_TYPE_MAT3) {
-            componentCount = 3;
-            vectorCount = 3;
-        } else if(accessor.type == TINYGLTF_TYPE_MAT4) {
-            componentCount = 4;
-            vectorCount = 4;
-        } else CORRADE_INTERNAL_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
-
-        /* Floats should not be normalized */
-        if(accessor.normalized && (componentFormat == VertexFormat::Float || componentFormat == VertexFormat::Double)) {
-            Error{} << "Trade::TinyGltfImporter::mesh(): floating-point component types can't be normalized";
-            return Containers::NullOpt;
-        }
+        const VertexFormat format = checkedVertexFormat(accessor, "mesh");
+        if(format == VertexFormat{}) return Containers::NullOpt;
 
-        /* Check that matrix type is legal */
-        if(vectorCount &&
-            componentFormat != VertexFormat::Float &&
-            componentFormat != VertexFormat::Double &&
-            !(componentFormat == VertexFormat::Byte && accessor.normalized) &&
-            !(componentFormat == VertexFormat::Short && accessor.normalized)) {
-            Error{} << "Trade::TinyGltfImporter::mesh(): unsupported matrix component type"
-                << (accessor.normalized ? "normalized" : "unnormalized")
-                << accessor.componentType;
+        if(attributeId == 0)
+            vertexCount = accessor.count;
+        else if(accessor.count != vertexCount) {
+            Error{} << "Trade::TinyGltfImporter::mesh(): mismatched vertex count for attribute" << attribute.first << Debug::nospace << ", expected" << vertexCount << "but got" << accessor.count;
             return Containers::NullOpt;
         }
 
-        const VertexFormat format = vectorCount ?
-            vertexFormat(componentFormat, vectorCount, componentCount, true) :
-            vertexFormat(componentFormat, componentCount, accessor.normalized);
+        /* Sparse values get applied after the data are copied */
+        attributeSparseAccessors[attributeId] = accessor.sparse.isSparse ? attribute.second : -1;
+
+        /* A sparse accessor without a buffer view, reserve tightly packed
+           space for it after everything else. Offset relative to the end of
+           the buffer range. */
+        if(accessor.bufferView == -1) {
+            attributeBufferViews[attributeId] = -1;
+            attributeData[attributeId++] = MeshAttributeData{name, format,
+                UnsignedInt(sparseOnlySize), vertexCount,
+                std::ptrdiff_t(vertexFormatSize(format))};
+            sparseOnlySize += vertexCount*vertexFormatSize(format);
+            continue;
+        }
 
         /* Remember which buffer the attribute is in and the range, for
            consecutive attribs expand the range */
         const tinygltf::BufferView& bufferView = _d->model.bufferViews[accessor.bufferView];
-        if(attributeId == 0) {
+        if(!hasBufferRange) {
             bufferId = bufferView.buffer;
             bufferRange = Math::Range1D<std::size_t>::fromSize(bufferView.byteOffset, bufferView.byteLength);
-            vertexCount = accessor.count;
+            hasBufferRange = true;
         } else {
-            /* ... and probably never will be */
-            CORRADE_ASSERT(std::size_t(bufferView.buffer) == bufferId,
-                "Trade::TinyGltfImporter::mesh(): meshes spanning multiple buffers are not supported, sorry", {});
+            /* Attributes in multiple buffers, such as the ones created by
+               Draco decoding, are gathered from each view separately below */
+            if(std::size_t(bufferView.buffer) != bufferId)
+                multipleBuffers = true;
 
             bufferRange = Math::join(bufferRange, Math::Range1D<std::size_t>::fromSize(bufferView.byteOffset, bufferView.byteLength));
-
-            if(accessor.count != vertexCount) {
-                Error{} << "Trade::TinyGltfImporter::mesh(): mismatched vertex count for attribute" << attribute.first << Debug::nospace << ", expected" << vertexCount << "but got" << accessor.count;
-                return Containers::NullOpt;
-            }
         }
 
         /* Fill in an attribute. Offset-only, will be patched to be relative to
            the actual output buffer once we know how large it is and where it
            is allocated. */
+        attributeBufferViews[attributeId] = accessor.bufferView;
         attributeData[attributeId++] = MeshAttributeData{name, format,
             UnsignedInt(accessor.byteOffset + bufferView.byteOffset), vertexCount,
             /* Stride could be 0, in which case it's equal to element size */
@@ -1269,25 +2658,94 @@ Containers::Optional<MeshData> TinyGltfImporter::doMesh(const UnsignedInt id, Un
     /* Verify we really filled all attributes */
     CORRADE_INTERNAL_ASSERT(attributeId == attributeData.size());
 
-    /* Allocate & copy vertex data (if any) */
-    Containers::Array<char> vertexData{Containers::NoInit, bufferRange.size()};
-    if(vertexData.size()) Utility::copy(Containers::arrayCast<const char>(
+    /* With zero copy, the vertex and index data reference the buffers
+       directly. That's not possible if texture coordinates need to be Y-flipped
+       in the data, in which case it's a copy as usual. */
+    bool zeroCopy = configuration().value<bool>("zeroCopy");
+    /* Sparse accessors need their values applied on a copy */
+    for(const Int sparse: attributeSparseAccessors) {
+        if(sparse != -1) {
+            zeroCopy = false;
+            break;
+        }
+    }
+    if(zeroCopy && !_d->textureCoordinateYFlipInMaterial) {
+        for(const MeshAttributeData& attribute: attributeData) {
+            if(attribute.name() == MeshAttribute::TextureCoordinates) {
+                zeroCopy = false;
+                break;
+            }
+        }
+    }
+
+    Containers::ArrayView<const char> vertexDataView;
+    if(bufferRange.size() && !multipleBuffers) vertexDataView = Containers::arrayCast<const char>(
         Containers::arrayView(_d->model.buffers[bufferId].data)
-            .slice(bufferRange.min(), bufferRange.max())),
-        vertexData);
+            .slice(bufferRange.min(), bufferRange.max()));
+
+    /* Allocate & copy vertex data (if any). If the attributes span multiple
+       buffers, all referenced views are copied after each other, which means
+       zero copy isn't possible in that case. */
+    Containers::Array<char> vertexData;
+    std::vector<std::pair<Int, std::size_t>> viewOffsets;
+    if(multipleBuffers) {
+        zeroCopy = false;
+        std::size_t size = 0;
+        for(const Int view: attributeBufferViews) {
+            if(view == -1 || std::find_if(viewOffsets.begin(), viewOffsets.end(), [view](const std::pair<Int, std::size_t>& a) { return a.first == view; }) != viewOffsets.end())
+                continue;
+            viewOffsets.emplace_back(view, size);
+            size += _d->model.bufferViews[view].byteLength;
+        }
+        /* Sparse-only attributes are put after all views */
+        vertexData = Containers::Array<char>{Containers::NoInit, size + sparseOnlySize};
+        for(const std::pair<Int, std::size_t>& viewOffset: viewOffsets) {
+            const tinygltf::BufferView& bufferView = _d->model.bufferViews[viewOffset.first];
+            Utility::copy(Containers::arrayCast<const char>(
+                Containers::arrayView(_d->model.buffers[bufferView.buffer].data)
+                    .slice(bufferView.byteOffset, bufferView.byteOffset + bufferView.byteLength)),
+                vertexData.slice(viewOffset.second, viewOffset.second + bufferView.byteLength));
+        }
+    } else if(!zeroCopy) {
+        vertexData = Containers::Array<char>{Containers::NoInit, bufferRange.size() + sparseOnlySize};
+        if(bufferRange.size()) Utility::copy(vertexDataView, vertexData.prefix(bufferRange.size()));
+    }
+    if(sparseOnlySize)
+        std::memset(vertexData + vertexData.size() - sparseOnlySize, 0, sparseOnlySize);
 
     /* Convert the attributes from relative to absolute, copy them to a
        non-growable array and do additional patching */
     for(std::size_t i = 0; i != attributeData.size(); ++i) {
+        /* Pointing directly to the buffer, nothing else to do */
+        if(zeroCopy) {
+            attributeData[i] = MeshAttributeData{attributeData[i].name(),
+                attributeData[i].format(),
+                Containers::StridedArrayView1D<const void>{vertexDataView,
+                    vertexDataView + attributeData[i].offset(vertexDataView) - bufferRange.min(),
+                    vertexCount, attributeData[i].stride()}};
+            continue;
+        }
+
+        /* Offset is what with the range min subtracted, as we copied without
+           the prefix. For multiple buffers it's relative to where the view
+           got copied. */
+        std::size_t offset;
+        if(attributeBufferViews[i] == -1) {
+            offset = vertexData.size() - sparseOnlySize + attributeData[i].offset(vertexData);
+        } else if(multipleBuffers) {
+            const Int view = attributeBufferViews[i];
+            offset = std::find_if(viewOffsets.begin(), viewOffsets.end(), [view](const std::pair<Int, std::size_t>& a) { return a.first == view; })->second + attributeData[i].offset(vertexData) - _d->model.bufferViews[view].byteOffset;
+        } else offset = attributeData[i].offset(vertexData) - bufferRange.min();
         Containers::StridedArrayView1D<char> data{vertexData,
-            /* Offset is what with the range min subtracted, as we copied
-               without the prefix */
-            vertexData + attributeData[i].offset(vertexData) - bufferRange.min(),
-            vertexCount, attributeData[i].stride()};
+            vertexData + offset, vertexCount, attributeData[i].stride()};
 
         attributeData[i] = MeshAttributeData{attributeData[i].name(),
             attributeData[i].format(), data};
 
+        /* Substitute sparse values directly in the copy */
+        if(attributeSparseAccessors[i] != -1 && !applySparseAccessor(_d->model, "mesh", attributeSparseAccessors[i], data))
+            return Containers::NullOpt;
+
         /* Flip Y axis of texture coordinates, unless it's done in the material
            instead */
         if(attributeData[i].name() == MeshAttribute::TextureCoordinates && !_d->textureCoordinateYFlipInMaterial) {
@@ -1320,19 +2778,27 @@ Containers::Optional<MeshData> TinyGltfImporter::doMesh(const UnsignedInt id, Un
     MeshIndexData indices;
     Containers::Array<char> indexData;
     if(primitive.indices != -1) {
-        const tinygltf::Accessor* accessor = checkedAccessor(_d->model, "mesh", primitive.indices);
+        const tinygltf::Accessor* accessor = checkedAccessor(_d->model, "mesh", primitive.indices, trustedInput);
         if(!accessor) return Containers::NullOpt;
 
+        /* Checked even with trusted input, as the index copy below relies on
+           the accessor element being a single index */
         if(accessor->type != TINYGLTF_TYPE_SCALAR) {
             Error() << "Trade::TinyGltfImporter::mesh(): unexpected index type" << accessor->type;
             return Containers::NullOpt;
         }
 
-        if(accessor->normalized) {
+        if(!trustedInput && accessor->normalized) {
             Error() << "Trade::TinyGltfImporter::mesh(): index type can't be normalized";
             return Containers::NullOpt;
         }
 
+        /** @todo apply sparse index accessors as well */
+        if(accessor->sparse.isSparse) {
+            Error{} << "Trade::TinyGltfImporter::mesh(): sparse index accessors are not supported";
+            return Containers::NullOpt;
+        }
+
         MeshIndexType type;
         if(accessor->componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE)
             type = MeshIndexType::UnsignedByte;
@@ -1352,9 +2818,31 @@ Containers::Optional<MeshData> TinyGltfImporter::doMesh(const UnsignedInt id, Un
         }
 
         Containers::ArrayView<const char> srcContiguous = src.asContiguous();
-        indexData = Containers::Array<char>{srcContiguous.size()};
-        Utility::copy(srcContiguous, indexData);
-        indices = MeshIndexData{type, indexData};
+        if(zeroCopy) indices = MeshIndexData{type, srcContiguous};
+        else {
+            /* Pick the smallest type that fits the largest index, if
+               requested */
+            MeshIndexType outputType = type;
+            if(type != MeshIndexType::UnsignedByte && configuration().value<bool>("narrowIndices")) {
+                const UnsignedInt max = type == MeshIndexType::UnsignedInt ?
+                    maxIndex<UnsignedInt>(srcContiguous) :
+                    maxIndex<UnsignedShort>(srcContiguous);
+                if(max <= 0xff) outputType = MeshIndexType::UnsignedByte;
+                else if(max <= 0xffff) outputType = MeshIndexType::UnsignedShort;
+            }
+
+            /* Convert the indices while copying them to the output */
+            indexData = Containers::Array<char>{Containers::NoInit, accessor->count*meshIndexTypeSize(outputType)};
+            if(outputType == type)
+                Utility::copy(srcContiguous, indexData);
+            else if(type == MeshIndexType::UnsignedInt && outputType == MeshIndexType::UnsignedShort)
+                narrowIndicesInto<UnsignedInt, UnsignedShort>(srcContiguous, indexData);
+            else if(type == MeshIndexType::UnsignedInt)
+                narrowIndicesInto<UnsignedInt, UnsignedByte>(srcContiguous, indexData);
+            else
+                narrowIndicesInto<UnsignedShort, UnsignedByte>(srcContiguous, indexData);
+            indices = MeshIndexData{outputType, indexData};
+        }
     }
 
     /* If we have an index-less attribute-less mesh, glTF has no way to supply
@@ -1362,6 +2850,11 @@ Containers::Optional<MeshData> TinyGltfImporter::doMesh(const UnsignedInt id, Un
     if(!indices.data().size() && !attributeData.size())
         return MeshData{meshPrimitive, 0, &mesh};
 
+    if(zeroCopy) return MeshData{meshPrimitive,
+        DataFlags{}, indices.data(), indices,
+        DataFlags{}, vertexDataView, std::move(attributeData),
+        vertexCount, &mesh};
+
     return MeshData{meshPrimitive,
         std::move(indexData), indices,
         std::move(vertexData), std::move(attributeData),
@@ -1382,15 +2875,7 @@ UnsignedInt TinyGltfImporter::doMaterialCount() const {
 }
 
 Int TinyGltfImporter::doMaterialForName(const std::string& name) {
-    if(!_d->materialsForName) {
-        _d->materialsForName.emplace();
-        _d->materialsForName->reserve(_d->model.materials.size());
-        for(std::size_t i = 0; i != _d->model.materials.size(); ++i)
-            _d->materialsForName->emplace(_d->model.materials[i].name, i);
-    }
-
-    const auto found = _d->materialsForName->find(name);
-    return found == _d->materialsForName->end() ? -1 : found->second;
+    return _d->findName(Document::NameKind::Material, name);
 }
 
 std::string TinyGltfImporter::doMaterialName(const UnsignedInt id) {
@@ -1642,15 +3127,7 @@ UnsignedInt TinyGltfImporter::doTextureCount() const {
 }
 
 Int TinyGltfImporter::doTextureForName(const std::string& name) {
-    if(!_d->texturesForName) {
-        _d->texturesForName.emplace();
-        _d->texturesForName->reserve(_d->model.textures.size());
-        for(std::size_t i = 0; i != _d->model.textures.size(); ++i)
-            _d->texturesForName->emplace(_d->model.textures[i].name, i);
-    }
-
-    const auto found = _d->texturesForName->find(name);
-    return found == _d->texturesForName->end() ? -1 : found->second;
+    return _d->findName(Document::NameKind::Texture, name);
 }
 
 std::string TinyGltfImporter::doTextureName(const UnsignedInt id) {
@@ -1679,6 +3156,12 @@ Containers::Optional<TextureData> TinyGltfImporter::doTexture(const UnsignedInt
         tinygltf::Value basis = tex.extensions.at("GOOGLE_texture_basis");
         imageId = basis.Get("source").Get<int>();
 
+    /* Standardized variant of the above. The images are meant to be KTX2
+       containers, but plain Basis files are accepted as well. */
+    } else if(tex.extensions.find("KHR_texture_basisu") != tex.extensions.end()) {
+        tinygltf::Value basis = tex.extensions.at("KHR_texture_basisu");
+        imageId = basis.Get("source").Get<int>();
+
     /* Image source */
     } else if(tex.source != -1) {
         imageId = UnsignedInt(tex.source);
@@ -1778,49 +3261,23 @@ UnsignedInt TinyGltfImporter::doImage2DCount() const {
 }
 
 Int TinyGltfImporter::doImage2DForName(const std::string& name) {
-    if(!_d->imagesForName) {
-        _d->imagesForName.emplace();
-        _d->imagesForName->reserve(_d->model.images.size());
-        for(std::size_t i = 0; i != _d->model.images.size(); ++i)
-            _d->imagesForName->emplace(_d->model.images[i].name, i);
-    }
-
-    const auto found = _d->imagesForName->find(name);
-    return found == _d->imagesForName->end() ? -1 : found->second;
+    return _d->findName(Document::NameKind::Image, name);
 }
 
 std::string TinyGltfImporter::doImage2DName(const UnsignedInt id) {
     return _d->model.images[id].name;
 }
 
-AbstractImporter* TinyGltfImporter::setupOrReuseImporterForImage(const UnsignedInt id, const char* const errorPrefix) {
-    /* Looking for the same ID, so reuse an importer populated before. If the
-       previous attempt failed, the importer is not set, so return nullptr in
-       that case. Going through everything below again would not change the
-       outcome anyway, only spam the output with redundant messages. */
-    if(_d->imageImporterId == id)
-        return _d->imageImporter ? &*_d->imageImporter : nullptr;
-
-    /* Otherwise reset the importer and remember the new ID. If the import
-       fails, the importer will stay unset, but the ID will be updated so the
-       next round can again just return nullptr above instead of going through
-       the doomed-to-fail process again. */
-    _d->imageImporter = Containers::NullOpt;
-    _d->imageImporterId = id;
-
+Containers::Pointer<AbstractImporter> TinyGltfImporter::openImageImporter(const UnsignedInt id, const char* const errorPrefix) {
     /* Because we specified an empty callback for loading image data,
        Image.image, Image.width, Image.height and Image.component will not be
        valid and should not be accessed. */
 
     const tinygltf::Image& image = _d->model.images[id];
 
-    AnyImageImporter importer{*manager()};
-    if(fileCallback()) importer.setFileCallback(fileCallback(), fileCallbackUserData());
-
-    /* Load embedded image */
+    /* Embedded image data */
+    Containers::ArrayView<const char> data;
     if(image.uri.empty()) {
-        Containers::ArrayView<const char> data;
-
         /* The image data are stored in a buffer */
         if(image.bufferView != -1) {
             const tinygltf::BufferView& bufferView = _d->model.bufferViews[image.bufferView];
@@ -1833,11 +3290,33 @@ AbstractImporter* TinyGltfImporter::setupOrReuseImporterForImage(const UnsignedI
         } else {
             data = Containers::arrayCast<const char>(Containers::arrayView(image.image.data(), image.image.size()));
         }
+    }
 
-        Containers::Optional<ImageData2D> imageData;
-        if(!importer.openData(data))
+    /* Basis Universal images are opened directly with BasisImporter so the
+       transcoding target can be controlled with the basisFormat option.
+       Embedded images with a known signature are opened directly with the
+       matching plugin as well, which saves going through AnyImageImporter
+       for each of them. Everything else goes through AnyImageImporter. */
+    Containers::Pointer<AbstractImporter> importer;
+    if(isBasisImage(image)) {
+        if(!(importer = manager()->loadAndInstantiate("BasisImporter"))) {
+            Error{} << errorPrefix << "can't load BasisImporter for a Basis Universal image";
             return nullptr;
-        return &_d->imageImporter.emplace(std::move(importer));
+        }
+        const std::string basisFormat = configuration().value("basisFormat");
+        if(!basisFormat.empty())
+            importer->configuration().setValue("format", basisFormat);
+    } else {
+        if(image.uri.empty())
+            importer = Implementation::imageImporterForData(*manager(), data);
+        if(!importer) importer.reset(new AnyImageImporter{*manager()});
+    }
+    if(fileCallback()) importer->setFileCallback(fileCallback(), fileCallbackUserData());
+
+    /* Load embedded image */
+    if(image.uri.empty()) {
+        if(!importer->openData(data)) return nullptr;
+        return importer;
     }
 
     /* Load external image */
@@ -1846,15 +3325,143 @@ AbstractImporter* TinyGltfImporter::setupOrReuseImporterForImage(const UnsignedI
         return nullptr;
     }
 
-    Containers::Optional<ImageData2D> imageData;
-    if(!importer.openFile(Utility::Directory::join(_d->filePath ? *_d->filePath : "", image.uri)))
+    if(!importer->openFile(Utility::Directory::join(_d->filePath ? *_d->filePath : "", image.uri)))
         return nullptr;
-    return &_d->imageImporter.emplace(std::move(importer));
+    return importer;
+}
+
+AbstractImporter* TinyGltfImporter::setupOrReuseImporterForImage(const UnsignedInt id, const char* const errorPrefix) {
+    /* Looking for an ID that was accessed recently, so reuse an importer
+       populated before and mark it as the most recently used one. If the
+       previous attempt failed, the importer is not set, so return nullptr in
+       that case. Going through everything below again would not change the
+       outcome anyway, only spam the output with redundant messages. */
+    auto& importers = _d->imageImporters;
+    for(auto it = importers.begin(); it != importers.end(); ++it) {
+        if(it->first != id) continue;
+        std::rotate(it, it + 1, importers.end());
+
+        /* The transcoding target could have changed since the importer was
+           opened, BasisImporter picks it up on every import */
+        AbstractImporter* const importer = importers.back().second.get();
+        const std::string basisFormat = configuration().value("basisFormat");
+        if(importer && !basisFormat.empty() && isBasisImage(_d->model.images[id]))
+            importer->configuration().setValue("format", basisFormat);
+        return importer;
+    }
+
+    /* Otherwise open a new importer and remember it together with the ID. If
+       the import fails, the importer will stay unset, but the ID will be
+       remembered so the next round can again just return nullptr above
+       instead of going through the doomed-to-fail process again. */
+    importers.emplace_back(id, openImageImporter(id, errorPrefix));
+
+    /* Evict the least recently used importers if over the limit */
+    const std::size_t cacheSize = Math::max(configuration().value<UnsignedInt>("imageImporterCacheSize"), 1u);
+    if(importers.size() > cacheSize)
+        importers.erase(importers.begin(), importers.end() - cacheSize);
+
+    return importers.back().second.get();
+}
+
+void TinyGltfImporter::prefetchImages(const UnsignedInt id, AbstractImporter& importer, const UnsignedInt threadCount) {
+    /* Open importers for the images following the requested one. This is done
+       on the main thread, as plugin loading in the manager isn't thread-safe.
+       Images that fail to open or are already prefetched are skipped, the
+       error gets reported once the image is requested directly. */
+    Containers::Array<UnsignedInt> ids;
+    Containers::Array<Containers::Pointer<AbstractImporter>> importers{threadCount};
+    arrayAppend(ids, id);
+    for(UnsignedInt i = id + 1; i < _d->model.images.size() && ids.size() < threadCount; ++i) {
+        if(_d->prefetchedImages.find(i) != _d->prefetchedImages.end())
+            continue;
+
+        Error redirectError{nullptr};
+        Containers::Pointer<AbstractImporter> next = openImageImporter(i, "");
+        if(!next) continue;
+        importers[ids.size()] = std::move(next);
+        arrayAppend(ids, i);
+    }
+
+    /* Decode all images in parallel, the requested one on the current thread
+       using the importer that's already set up. Errors for the other images
+       are silenced and reported again when the image is requested. */
+    Containers::Array<Containers::Optional<ImageData2D>> images{ids.size()};
+    parallelFor(UnsignedInt(ids.size()), [&](const UnsignedInt t) {
+        if(t == 0) {
+            images[t] = importer.image2D(0);
+            return;
+        }
+
+        Error redirectError{nullptr};
+        images[t] = importers[t]->image2D(0);
+    });
+
+    /* Remember also the level count so image2DLevelCount() for the prefetched
+       images doesn't need to open the file again */
+    for(std::size_t t = 0; t != ids.size(); ++t) {
+        if(!images[t]) continue;
+        const UnsignedInt levelCount = t == 0 ?
+            importer.image2DLevelCount(0) :
+            importers[t]->image2DLevelCount(0);
+        _d->prefetchedImages.emplace(ids[t], std::make_pair(levelCount, ImageData2D{std::move(*images[t]), &_d->model.images[ids[t]]}));
+    }
+}
+
+void TinyGltfImporter::startImagePrefetch() {
+    const std::size_t count = _d->model.images.size();
+    _d->imagePrefetch.reset(new ImagePrefetch);
+    ImagePrefetch& prefetch = *_d->imagePrefetch;
+    prefetch.importers = Containers::Array<Containers::Pointer<AbstractImporter>>{count};
+    prefetch.levelCounts = Containers::Array<UnsignedInt>{Containers::ValueInit, count};
+    prefetch.images = Containers::Array<Containers::Optional<ImageData2D>>{count};
+    prefetch.decoded = Containers::Array<std::promise<void>>{count};
+    prefetch.futures = Containers::Array<std::future<void>>{count};
+
+    /* Open all importers on the calling thread, as plugin loading in the
+       manager isn't thread-safe. Errors are silenced and reported again once
+       the image is requested directly. */
+    {
+        Error redirectError{nullptr};
+        for(std::size_t i = 0; i != count; ++i) {
+            prefetch.futures[i] = prefetch.decoded[i].get_future();
+            if((prefetch.importers[i] = openImageImporter(i, "")))
+                prefetch.levelCounts[i] = prefetch.importers[i]->image2DLevelCount(0);
+        }
+    }
+
+    /* Decode the first levels on the worker threads, in order. The workers
+       finish once all images are processed, the destructor stops them
+       earlier if the file gets closed meanwhile. */
+    UnsignedInt threadCount = configuration().value<UnsignedInt>("threads");
+    if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+    ImagePrefetch* const state = &prefetch;
+    const tinygltf::Model* const model = &_d->model;
+    prefetch.threads = Containers::Array<std::thread>{Math::min(std::size_t{threadCount}, count)};
+    for(std::thread& thread: prefetch.threads) thread = std::thread{[state, model]() {
+        Error redirectError{nullptr};
+        for(std::size_t i; (i = state->next++) < state->importers.size(); ) {
+            if(state->importers[i]) {
+                Containers::Optional<ImageData2D> image = state->importers[i]->image2D(0);
+                if(image) state->images[i] = ImageData2D{std::move(*image), &model->images[i]};
+            }
+            state->decoded[i].set_value();
+        }
+    }};
 }
 
 UnsignedInt TinyGltfImporter::doImage2DLevelCount(const UnsignedInt id) {
     CORRADE_ASSERT(manager(), "Trade::OpenGexImporter::image2DLevelCount(): the plugin must be instantiated with access to plugin manager in order to open image files", {});
 
+    /* The image was decoded together with another one already */
+    const auto prefetched = _d->prefetchedImages.find(id);
+    if(prefetched != _d->prefetchedImages.end())
+        return prefetched->second.first;
+
+    /* The image was opened for decoding in the background */
+    if(_d->imagePrefetch && _d->imagePrefetch->levelCounts[id])
+        return _d->imagePrefetch->levelCounts[id];
+
     AbstractImporter* importer = setupOrReuseImporterForImage(id, "Trade::TinyGltfImporter::image2DLevelCount():");
     /* image2DLevelCount() isn't supposed to fail (image2D() is, instead), so
        report 1 on failure and expect image2D() to fail later */
@@ -1866,9 +3473,51 @@ UnsignedInt TinyGltfImporter::doImage2DLevelCount(const UnsignedInt id) {
 Containers::Optional<ImageData2D> TinyGltfImporter::doImage2D(const UnsignedInt id, const UnsignedInt level) {
     CORRADE_ASSERT(manager(), "Trade::TinyGltfImporter::image2D(): the plugin must be instantiated with access to plugin manager in order to load images", {});
 
+    /* The image is being decoded in the background, wait for it and hand it
+       over. If the decoding failed, continue below to report the error. */
+    if(level == 0 && _d->imagePrefetch && _d->imagePrefetch->futures[id].valid()) {
+        ImagePrefetch& prefetch = *_d->imagePrefetch;
+        prefetch.futures[id].get();
+        prefetch.importers[id] = nullptr;
+        if(prefetch.images[id]) {
+            ImageData2D imageData = std::move(*prefetch.images[id]);
+            prefetch.images[id] = Containers::NullOpt;
+            return Containers::optional(std::move(imageData));
+        }
+    }
+
+    /* The image was decoded together with another one already, hand it over
+       and forget it */
+    if(level == 0) {
+        const auto prefetched = _d->prefetchedImages.find(id);
+        if(prefetched != _d->prefetchedImages.end()) {
+            ImageData2D imageData = std::move(prefetched->second.second);
+            _d->prefetchedImages.erase(prefetched);
+            return Containers::optional(std::move(imageData));
+        }
+    }
+
     AbstractImporter* importer = setupOrReuseImporterForImage(id, "Trade::TinyGltfImporter::image2D():");
     if(!importer) return Containers::NullOpt;
 
+    /* Decode the first level of a batch of subsequent images in parallel, if
+       requested and all images aren't already decoded in the background. The
+       result for this image is then picked up from the prefetched images
+       below. */
+    if(level == 0 && !_d->imagePrefetch) {
+        UnsignedInt threadCount = configuration().value<UnsignedInt>("threads");
+        if(!threadCount) threadCount = Math::max(std::thread::hardware_concurrency(), 1u);
+        if(threadCount > 1) {
+            prefetchImages(id, *importer, threadCount);
+            const auto prefetched = _d->prefetchedImages.find(id);
+            if(prefetched == _d->prefetchedImages.end())
+                return Containers::NullOpt;
+            ImageData2D imageData = std::move(prefetched->second.second);
+            _d->prefetchedImages.erase(prefetched);
+            return Containers::optional(std::move(imageData));
+        }
+    }
+
     /* Include a pointer to the tinygltf state in the result */
     Containers::Optional<ImageData2D> imageData = importer->image2D(0, level);
     if(!imageData) return Containers::NullOpt;
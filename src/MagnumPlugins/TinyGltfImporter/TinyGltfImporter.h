@@ -30,7 +30,11 @@
  * @brief Class @ref Magnum::Trade::TinyGltfImporter
  */
 
+#include <Corrade/Containers/Array.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Math/Quaternion.h>
 #include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ObjectData3D.h>
 #include <Magnum/Trade/PhongMaterialData.h>
 
 #include "MagnumPlugins/TinyGltfImporter/configure.h"
@@ -38,6 +42,8 @@
 #ifndef DOXYGEN_GENERATING_OUTPUT
 namespace tinygltf {
     class Model;
+    class Node;
+    struct Skin;
     class Value;
 }
 #endif
@@ -119,6 +125,24 @@ target_link_libraries(your-app PRIVATE MagnumPlugins::TinyGltfImporter)
 See @ref building-plugins, @ref cmake-plugins, @ref plugins and
 @ref file-formats for more information.
 
+Decoding of [KHR_draco_mesh_compression](https://github.com/KhronosGroup/glTF/blob/master/extensions/2.0/Khronos/KHR_draco_mesh_compression/README.md)
+meshes is available if `TINYGLTFIMPORTER_WITH_DRACO` is enabled as well, in
+which case the plugin is linked to the [Draco](https://github.com/google/draco)
+library, found through its CMake config. Similarly, decoding of
+[EXT_meshopt_compression](https://github.com/KhronosGroup/glTF/blob/master/extensions/2.0/Vendor/EXT_meshopt_compression/README.md)
+buffer views is available if `TINYGLTFIMPORTER_WITH_MESHOPTIMIZER` is
+enabled, linking the plugin to [meshoptimizer](https://github.com/zeux/meshoptimizer).
+See @ref Trade-TinyGltfImporter-behavior-meshes for more information.
+
+By default, `tiny_gltf` parses the JSON using the bundled
+[nlohmann::json](https://github.com/nlohmann/json) library. If
+`TINYGLTFIMPORTER_WITH_RAPIDJSON` is enabled, the plugin uses the
+significantly faster [RapidJSON](https://rapidjson.org/) library instead,
+found through its CMake config, with SSE2, SSE4.2 or NEON whitespace
+skipping depending on the target architecture. This is useful mainly for files
+with large scene hierarchies or animation metadata, the behavior is otherwise
+the same.
+
 @section Trade-TinyGltfImporter-behavior Behavior and limitations
 
 The plugin supports @ref ImporterFeature::OpenData and
@@ -131,7 +155,8 @@ calls with @ref InputFileCallbackPolicy::LoadTemporary and
 @ref InputFileCallbackPolicy::Close is emitted right after the file is fully
 read.
 
-Import of skeleton, skin and morph data is not supported at the moment.
+Skins and morph targets are available through plugin-specific APIs, see
+@ref Trade-TinyGltfImporter-skinning and @ref Trade-TinyGltfImporter-morph.
 
 @subsection Trade-TinyGltfImporter-behavior-animation Animation import
 
@@ -150,7 +175,11 @@ Import of skeleton, skin and morph data is not supported at the moment.
     the @cb{.ini} normalizeQuaternions @ce option, see
     @ref Trade-TinyGltfImporter-configuration "below". This doesn't affect
     spline-interpolated rotation tracks.
--   Skinning and morph targets are not supported
+-   Morph target weight channels are imported as one
+    @ref AnimationTrackTargetType::Custom track of either
+    @ref AnimationTrackType::Float or @ref AnimationTrackType::CubicHermite1D
+    for each morph target, see @ref Trade-TinyGltfImporter-morph for more
+    information
 -   Animation tracks are always imported with
     @ref Animation::Extrapolation::Constant, because glTF doesn't support
     anything else
@@ -178,6 +207,145 @@ Import of skeleton, skin and morph data is not supported at the moment.
     @cb{.ini} normalizeQuaternions @ce option, see
     @ref Trade-TinyGltfImporter-configuration "below".
 
+@subsection Trade-TinyGltfImporter-hierarchy Flat object hierarchy
+
+Importing a large scene through @ref object3D() means one heap-allocated
+@ref ObjectData3D instance and one virtual call per object. The
+@ref object3DHierarchy() function instead returns properties of all objects
+at once, packed into an @ref Object3DHierarchy structure with one array per
+property, indexed with the same IDs as @ref object3D():
+
+-   parent object ID or @cpp -1 @ce for objects without a parent, which are
+    the top-level objects of a scene or objects not referenced by any scene,
+-   object flags and the transformation both as a matrix and, if the object
+    has @ref ObjectFlag3D::HasTranslationRotationScaling set, as separate
+    translation, rotation and scaling, identity otherwise,
+-   mesh, material, camera, light and skin IDs, @cpp -1 @ce if not present.
+
+The objects are in the glTF node order, which means a parent may come after
+its children. Extra objects added for
+@ref Trade-TinyGltfImporter-behavior-meshes "multi-primitive meshes" have the
+first object of the sequence as a parent and an identity transformation,
+same as in @ref object3D(). Unlike with @ref object3D(), a node that
+references both a mesh and a camera or a light has both IDs filled. Rotation
+quaternions are normalized according to the @cb{.ini} normalizeQuaternions @ce
+@ref Trade-TinyGltfImporter-configuration "option", with a single warning
+printed for all objects. This is a plugin-specific API, so the importer
+instance needs to be cast to @ref TinyGltfImporter first:
+
+@code{.cpp}
+auto& gltfImporter = static_cast<Trade::TinyGltfImporter&>(*importer);
+Trade::TinyGltfImporter::Object3DHierarchy hierarchy =
+    gltfImporter.object3DHierarchy();
+// copy hierarchy.parents, hierarchy.transformations, hierarchy.meshes ...
+@endcode
+
+@subsection Trade-TinyGltfImporter-instancing Instanced objects
+
+Per-instance transformations defined by the
+[EXT_mesh_gpu_instancing](https://github.com/KhronosGroup/glTF/blob/master/extensions/2.0/Vendor/EXT_mesh_gpu_instancing/README.md)
+extension aren't expanded into separate objects. Instead, the object is
+imported once and @ref object3DInstanceCount() returns the count of its
+instances. The instance data are then available through
+@ref object3DInstances() as a @ref MeshPrimitive::Instances mesh, with
+`TRANSLATION`, `ROTATION`, `SCALE` and any custom attributes copied in a
+single pass from the accessors into one buffer, ready to be uploaded to the
+GPU at once. The attributes are custom, their IDs can be queried using
+@ref meshAttributeForName(). All component types allowed for mesh attributes
+are accepted, including the quantized [KHR_mesh_quantization](https://github.com/KhronosGroup/glTF/blob/master/extensions/2.0/Khronos/KHR_mesh_quantization/README.md)
+ones, and sparse accessors are applied as well. For nodes duplicated because
+of multi-primitive meshes, all objects in the sequence report the same
+instances. These are plugin-specific APIs, so the importer instance needs to
+be cast to @ref TinyGltfImporter first. They're virtual in order to be
+callable also when the plugin is loaded dynamically, without linking to it:
+
+@code{.cpp}
+auto& gltfImporter = static_cast<Trade::TinyGltfImporter&>(*importer);
+if(gltfImporter.object3DInstanceCount(id)) {
+    Containers::Optional<Trade::MeshData> instances =
+        gltfImporter.object3DInstances(id);
+    // ...
+}
+@endcode
+
+@subsection Trade-TinyGltfImporter-skinning Skinning
+
+The `JOINTS_n` and `WEIGHTS_n` mesh attributes are whitelisted and imported
+as custom attributes with the same names, their IDs can be queried using
+@ref meshAttributeForName(). Joint indices are imported as either
+@ref VertexFormat::Vector4ub or @ref VertexFormat::Vector4us, weights as
+@ref VertexFormat::Vector4, @ref VertexFormat::Vector4ubNormalized or
+@ref VertexFormat::Vector4usNormalized. The data are kept in their original
+compact types and never expanded to floats, so they can be uploaded to the
+GPU as-is. Other types are rejected with an error, as the spec doesn't allow
+them.
+
+Skins are exposed through @ref skin3DCount(), @ref skin3DForName() and
+@ref skin3DName(), and objects reference them through @ref object3DSkin().
+The @ref skin3DJoints() function returns object IDs of the joints, pointing
+to the first object for nodes duplicated because of multi-primitive meshes.
+The @ref skin3DInverseBindMatrices() function returns the inverse bind
+matrices tightly packed in a single array, in the same order as the joints
+and ready to be passed to a shader without further processing. Sparse
+accessors are applied and if the skin has no inverse bind matrices, identity
+matrices are returned. These are plugin-specific APIs, so the importer
+instance needs to be cast to @ref TinyGltfImporter first, similarly to
+@ref Trade-TinyGltfImporter-instancing "instanced objects":
+
+@code{.cpp}
+auto& gltfImporter = static_cast<Trade::TinyGltfImporter&>(*importer);
+Int skin = gltfImporter.object3DSkin(id);
+if(skin != -1) {
+    Containers::Optional<Containers::Array<UnsignedInt>> joints =
+        gltfImporter.skin3DJoints(skin);
+    Containers::Optional<Containers::Array<Matrix4>> inverseBindMatrices =
+        gltfImporter.skin3DInverseBindMatrices(skin);
+    // ...
+}
+@endcode
+
+@subsection Trade-TinyGltfImporter-morph Morph targets
+
+Morph targets of a mesh are counted by @ref meshMorphTargetCount() and each
+is available through @ref meshMorphTarget() as a @ref MeshPrimitive::Points
+mesh containing just the displacements. `POSITION`, `NORMAL` and `TANGENT`
+displacements are imported as @ref MeshAttribute::Position,
+@ref MeshAttribute::Normal and @ref MeshAttribute::Tangent, other attributes
+as custom attributes with the same name. All component types allowed for mesh
+attributes are accepted and the data are kept in their original types.
+
+If all accessors of a morph target are sparse without a buffer view and share
+the same indices, the sparse representation is kept --- the returned mesh is
+indexed, with the indices being IDs of the displaced vertices in the base mesh
+and its vertex count being the count of displaced vertices. Otherwise the
+displacements are stored for all vertices of the base mesh, each attribute
+tightly packed after the previous, with values of sparse accessors applied.
+Default weights of all morph targets are returned by
+@ref meshMorphTargetWeights(). Multi-primitive meshes have the targets
+defined for each primitive separately, so each mesh in the sequence reports
+its own targets.
+
+Animations of the weights are imported as one
+@ref AnimationTrackTargetType::Custom track for each morph target, with the
+tracks for one channel following each other in the order of the targets. The
+tracks reference the interleaved glTF data with a stride, so no copy is made.
+Cubic spline tracks are reordered in-place to
+@ref AnimationTrackType::CubicHermite1D values. These are plugin-specific
+APIs, so the importer instance needs to be cast to @ref TinyGltfImporter
+first:
+
+@code{.cpp}
+auto& gltfImporter = static_cast<Trade::TinyGltfImporter&>(*importer);
+for(UnsignedInt i = 0; i != gltfImporter.meshMorphTargetCount(id); ++i) {
+    Containers::Optional<Trade::MeshData> target =
+        gltfImporter.meshMorphTarget(id, i);
+    if(target->isIndexed()) {
+        // sparse displacements
+    }
+    // ...
+}
+@endcode
+
 @subsection Trade-TinyGltfImporter-behavior-camera Camera import
 
 -   Cameras in glTF are specified with vertical FoV and vertical:horizontal
@@ -193,7 +361,9 @@ Import of skeleton, skin and morph data is not supported at the moment.
 @subsection Trade-TinyGltfImporter-behavior-meshes Mesh import
 
 -   Indices are imported as either @ref MeshIndexType::UnsignedByte,
-    @ref MeshIndexType::UnsignedShort or @ref MeshIndexType::UnsignedInt
+    @ref MeshIndexType::UnsignedShort or @ref MeshIndexType::UnsignedInt,
+    optionally narrowed to the smallest type using the
+    @cb{.ini} narrowIndices @ce option
 -   Positions are imported as @ref VertexFormat::Vector3,
     @ref VertexFormat::Vector3ub, @ref VertexFormat::Vector3b,
     @ref VertexFormat::Vector3us, @ref VertexFormat::Vector3s,
@@ -258,6 +428,93 @@ Import of skeleton, skin and morph data is not supported at the moment.
     however since glTF has no way of specifying vertex count for those,
     returned @ref Trade::MeshData::vertexCount() is set to @cpp 0 @ce
 
+Primitives compressed with [KHR_draco_mesh_compression](https://github.com/KhronosGroup/glTF/blob/master/extensions/2.0/Khronos/KHR_draco_mesh_compression/README.md)
+are decoded by `tiny_gltf` already when opening the file, if the plugin is
+built with `TINYGLTFIMPORTER_WITH_DRACO`. Each compressed buffer view is
+decoded just once even if referenced by multiple primitives. The decoded
+attributes end up in separate buffers, which are then copied into a single
+vertex buffer on import. Otherwise, or if the decoding fails, importing such
+primitive fails with an error.
+
+Buffer views compressed with [EXT_meshopt_compression](https://github.com/KhronosGroup/glTF/blob/master/extensions/2.0/Vendor/EXT_meshopt_compression/README.md)
+are decoded on opening, if the plugin is built with
+`TINYGLTFIMPORTER_WITH_MESHOPTIMIZER`. This applies to vertex, index and
+animation data alike, including the octahedral, quaternion and exponential
+filters. The decoded views are stored in new buffers, so the data are then
+imported the same way as uncompressed data, including zero-copy import.
+Fallback buffers without any data are accepted, and decoding errors are
+reported directly by @ref openData() / @ref openFile(). Without the
+meshoptimizer library, such files load only if the fallback buffers contain
+uncompressed data.
+
+By default, vertex and index data are copied out of the glTF buffers. If the
+@cb{.ini} zeroCopy @ce
+@ref Trade-TinyGltfImporter-configuration "configuration option" is enabled,
+the returned @ref MeshData reference the buffers directly instead, with both
+@ref MeshData::indexDataFlags() and @ref MeshData::vertexDataFlags() empty,
+and are thus valid only until the file is closed. This saves a copy for every
+imported mesh, which matters especially with large buffers. As the texture
+coordinate Y-flip can't be done without modifying the data, meshes with
+texture coordinates are still copied unless
+@cb{.ini} textureCoordinateYFlipInMaterial @ce is enabled as well. Meshes with
+attributes spanning multiple buffers are always copied.
+
+Many exporters write `UNSIGNED_INT` indices even for meshes that have just a
+handful of vertices. If the @cb{.ini} narrowIndices @ce
+@ref Trade-TinyGltfImporter-configuration "configuration option" is enabled,
+the importer finds the largest index and converts the indices to the
+smallest @ref MeshIndexType that can hold it while copying them to the
+output. Note that @ref MeshIndexType::UnsignedByte indices may not be
+supported on all GPU APIs. Indices that are referenced directly with
+@cb{.ini} zeroCopy @ce are kept as-is.
+
+Every imported mesh is validated --- the accessor, buffer view and buffer
+ranges are checked against each other and the attribute and index types are
+checked against the list above. For files that were already validated when
+they were produced, the @cb{.ini} trustedInput @ce
+@ref Trade-TinyGltfImporter-configuration "configuration option" skips the
+checks that aren't needed for memory safety: the attribute type whitelist
+except for texture coordinates, the index normalization check and the check
+that the buffer view stride fits the accessor element. Range checks, vertex
+count and index type checks and the vertex format conversion are still done,
+so a file violating the specification can't cause out-of-bounds access in the
+importer, but it may produce @ref MeshData with attribute formats the rest of
+Magnum doesn't expect. Validation done by TinyGLTF itself on opening is not
+affected.
+
+Vertex attributes using [sparse accessors](https://github.com/KhronosGroup/glTF/tree/master/specification/2.0#sparse-accessors)
+are supported as well. The sparse values are written directly into the
+copied vertex data, without creating a dense copy of the accessor first,
+which means meshes with sparse attributes are always copied. Sparse
+accessors that don't reference a buffer view get a zero-filled, tightly
+packed range in the vertex data after the other attributes. Sparse index
+buffers and sparse animation data are not supported.
+
+Attributes quantized according to [KHR_mesh_quantization](https://github.com/KhronosGroup/glTF/blob/master/extensions/2.0/Khronos/KHR_mesh_quantization/README.md)
+are imported with the matching packed @ref VertexFormat listed above and are
+never expanded to floats, so together with @cb{.ini} zeroCopy @ce they're
+referenced directly. The dequantization is, as the extension specifies, part
+of the node transformation available through
+@ref ObjectData3D::transformation() for positions, and of the
+`KHR_texture_transform` material transformation available through
+@ref PhongMaterialData::textureMatrix() for texture coordinates. Normals
+and tangents are expected to be dequantized just by the normalization.
+
+If the @cb{.ini} lazyBufferLoading @ce
+@ref Trade-TinyGltfImporter-configuration "configuration option" is enabled,
+external buffers are not loaded when opening the file but only on the first
+@ref mesh() or @ref animation() call that needs them, again either from the
+filesystem or through @ref setFileCallback() with
+@ref InputFileCallbackPolicy::LoadTemporary. Once all meshes and animations
+referencing given buffer are imported, the buffer is released again and
+transparently reloaded if needed later. Buffers referenced by meshes imported
+with @cb{.ini} zeroCopy @ce are kept until the file is closed. Errors such as
+missing buffer files are then reported on import instead of on open. Buffers
+referenced by images, Draco-compressed primitives, data URIs and the GLB
+binary chunk are always loaded
+on open, and until a buffer is loaded, its `tinygltf::Buffer::data` accessible
+through @ref importerState() contains just a one-byte placeholder.
+
 Custom and unrecognized vertex attributes of allowed types are present in the
 imported meshes as well. Their mapping to/from a string can be queried using
 @ref meshAttributeName() and @ref meshAttributeForName(). Attributes with
@@ -316,6 +573,11 @@ following defaults have been chosen for this importer:
     @ref SamplerMipmap::Linear
 -   Wrapping (all axes): @ref SamplerWrapping::Repeat
 </li>
+<li>Embedded images, either in a buffer view or in a data URI, are opened
+directly with the plugin matching their file signature (or an equivalent
+alias), such as @ref PngImporter for PNG or @ref DdsImporter for DDS files,
+instead of going through @ref AnyImageImporter. Images with an unknown
+signature and external images are opened with @ref AnyImageImporter.</li>
 <li>
     The importer supports the non-standard `GOOGLE_texture_basis` extension
     for referencing [Basis Universal](https://github.com/binomialLLC/basis_universal)
@@ -349,8 +611,19 @@ following defaults have been chosen for this importer:
     }
     @endcode
 
-    The MIME type is not standard either and the importer doesn't check its
-    value. However, in case of embedded data URIs, the prefix *has to* be set
+    The MIME type is not standard either. The importer uses it, or the
+    `*.basis` extension of external files, to open the image directly with
+    @ref BasisImporter instead of going through @ref AnyImageImporter. The
+    transcoding target format can be then set with the
+    @cb{.ini} basisFormat @ce
+    @ref Trade-TinyGltfImporter-configuration "configuration option", which
+    overrides the @cb{.ini} format @ce option of @ref BasisImporter for all
+    Basis images imported by this importer instance and can be changed
+    between @ref image2D() calls. Images stored in a buffer view are opened
+    directly from the buffer memory, without copying them out first. The
+    standardized `KHR_texture_basisu` extension is recognized as well, however
+    KTX2 containers it references are not supported by @ref BasisImporter
+    yet, only plain Basis files. In case of embedded data URIs, the prefix *has to* be set
     to `data:application/octet-stream` as TinyGLTF has a whitelist for data URI
     detection and would treat the URI as a filename otherwise:
 
@@ -368,6 +641,64 @@ following defaults have been chosen for this importer:
 </li>
 </ul>
 
+Images are decoded one by one on the calling thread by default. If the
+@cb{.ini} threads @ce
+@ref Trade-TinyGltfImporter-configuration "configuration option" is set to
+a value larger than @cpp 1 @ce, importing the first level of an image decodes
+also first levels of the images directly following it in parallel, each with
+its own importer instance. These are then returned from
+subsequent @ref image2D() calls without decoding them again, so importing all
+images in order keeps all threads busy. Opening the images, which may involve
+loading plugins, is still done on the calling thread. Errors from the images
+decoded ahead are reported only once the image is requested directly. In that
+case the application needs to link to `pthread` on Linux due to the same
+reasons as described in @ref Trade-BasisImageConverter-loading "BasisImageConverter docs".
+
+If the @cb{.ini} prefetchImages @ce
+@ref Trade-TinyGltfImporter-configuration "configuration option" is enabled,
+first levels of all images are decoded in the background right after the file
+is opened, using @cb{.ini} threads @ce worker threads (or one, if set to
+@cpp 1 @ce). The importers for all images are opened upfront on the calling
+thread. @ref image2D() then only waits until given image is decoded and hands
+it over, importing the same image again or its other levels goes through the
+usual path. The images are decoded with the @cb{.ini} basisFormat @ce that was
+set when the file was opened. Closing the file waits for images that are being
+decoded and discards the rest. The `pthread` requirement described above
+applies here as well.
+
+The importer used for an image is kept around after the image is imported,
+so importing further levels of the same image doesn't need to open the file
+again. By default only the importer for the most recently accessed image is
+kept, which is enough for importing images and their levels in order. When
+accessing images interleaved, for example when materials reference the same
+textures in a different order, the @cb{.ini} imageImporterCacheSize @ce
+@ref Trade-TinyGltfImporter-configuration "configuration option" can be
+increased to keep importers for several recently accessed images, with the
+least recently used ones being discarded first.
+
+@section Trade-TinyGltfImporter-profiling Profiling
+
+If the plugin is built with `WITH_IMPORTER_PROFILING` enabled, it measures
+the duration of individual import stages and reports them to a callback set
+with @ref setProfilingCallback(), together with the amount of data each stage
+processed. The stages are:
+
+-   `patch` --- patching the glTF JSON when the @cb{.ini} lazyBufferLoading @ce
+    option is enabled or the file uses `EXT_meshopt_compression`, with the
+    input size
+-   `parse` --- parsing the file in TinyGLTF, including loading of external
+    buffers and Draco decoding, with the input size
+-   `meshopt` --- decoding `EXT_meshopt_compression` buffer views
+-   `load` --- loading a buffer with @cb{.ini} lazyBufferLoading @ce enabled,
+    with the buffer size
+-   `mesh` --- converting a mesh to @ref MeshData in @ref mesh(), with the
+    size of the output vertex and index data
+
+Without `WITH_IMPORTER_PROFILING` the measurement is compiled out and the
+callback is never called. If it's enabled, the
+@cpp MAGNUM_TINYGLTFIMPORTER_WITH_PROFILING @ce macro is defined in the
+`MagnumPlugins/TinyGltfImporter/configure.h` header.
+
 @section Trade-TinyGltfImporter-configuration Plugin-specific config
 
 It's possible to tune various output options through @ref configuration(). See
@@ -408,6 +739,59 @@ this:
 */
 class MAGNUM_TINYGLTFIMPORTER_EXPORT TinyGltfImporter: public AbstractImporter {
     public:
+        /**
+         * @brief Flat object hierarchy
+         * @m_since_latest_{plugins}
+         *
+         * All arrays have @ref object3DCount() items. See
+         * @ref Trade-TinyGltfImporter-hierarchy for more information.
+         */
+        struct Object3DHierarchy {
+            /** @brief Parent object IDs, @cpp -1 @ce for no parent */
+            Containers::Array<Int> parents;
+
+            /**
+             * @brief Object flags
+             *
+             * @ref ObjectFlag3D::HasTranslationRotationScaling is set if the
+             * object is defined with separate translation, rotation and
+             * scaling.
+             */
+            Containers::Array<ObjectFlags3D> flags;
+
+            /**
+             * @brief Object transformations
+             *
+             * Calculated from @ref translations, @ref rotations and
+             * @ref scalings for objects that have them.
+             */
+            Containers::Array<Matrix4> transformations;
+
+            /** @brief Object translations */
+            Containers::Array<Vector3> translations;
+
+            /** @brief Object rotations */
+            Containers::Array<Quaternion> rotations;
+
+            /** @brief Object scaling */
+            Containers::Array<Vector3> scalings;
+
+            /** @brief Mesh IDs, @cpp -1 @ce for no mesh */
+            Containers::Array<Int> meshes;
+
+            /** @brief Material IDs, @cpp -1 @ce for no material */
+            Containers::Array<Int> materials;
+
+            /** @brief Camera IDs, @cpp -1 @ce for no camera */
+            Containers::Array<Int> cameras;
+
+            /** @brief Light IDs, @cpp -1 @ce for no light */
+            Containers::Array<Int> lights;
+
+            /** @brief Skin IDs, @cpp -1 @ce for no skin */
+            Containers::Array<Int> skins;
+        };
+
         /**
          * @brief Default constructor
          *
@@ -439,6 +823,153 @@ class MAGNUM_TINYGLTFIMPORTER_EXPORT TinyGltfImporter: public AbstractImporter {
             return static_cast<const tinygltf::Model*>(AbstractImporter::importerState());
         }
 
+        /**
+         * @brief Flat hierarchy of all objects
+         * @m_since_latest_{plugins}
+         *
+         * Expects that a file is opened. See
+         * @ref Trade-TinyGltfImporter-hierarchy for more information.
+         */
+        virtual Object3DHierarchy object3DHierarchy();
+
+        /**
+         * @brief Instance count of given object
+         * @m_since_latest_{plugins}
+         *
+         * Returns count of instances defined through the
+         * `EXT_mesh_gpu_instancing` extension or @cpp 0 @ce if the object
+         * isn't instanced. Expects that a file is opened and @p id is less
+         * than @ref object3DCount(). See @ref Trade-TinyGltfImporter-instancing
+         * for more information.
+         */
+        virtual UnsignedInt object3DInstanceCount(UnsignedInt id);
+
+        /**
+         * @brief Instance data of given object
+         * @m_since_latest_{plugins}
+         *
+         * Returns a @ref MeshPrimitive::Instances mesh with one vertex per
+         * instance, with each instancing attribute tightly packed after the
+         * previous in a single buffer. Expects that a file is opened, @p id
+         * is less than @ref object3DCount() and the object is instanced. On
+         * failure prints a message to @ref Error and returns
+         * @ref Containers::NullOpt. See @ref Trade-TinyGltfImporter-instancing
+         * for more information.
+         */
+        virtual Containers::Optional<MeshData> object3DInstances(UnsignedInt id);
+
+        /**
+         * @brief Skin count
+         * @m_since_latest_{plugins}
+         *
+         * Expects that a file is opened. See
+         * @ref Trade-TinyGltfImporter-skinning for more information.
+         */
+        virtual UnsignedInt skin3DCount();
+
+        /**
+         * @brief Skin ID for given name
+         * @m_since_latest_{plugins}
+         *
+         * If no skin for given name exists, returns @cpp -1 @ce. Expects that
+         * a file is opened.
+         */
+        virtual Int skin3DForName(const std::string& name);
+
+        /**
+         * @brief Skin name
+         * @m_since_latest_{plugins}
+         *
+         * Expects that a file is opened and @p id is less than
+         * @ref skin3DCount().
+         */
+        virtual std::string skin3DName(UnsignedInt id);
+
+        /**
+         * @brief Skin of given object
+         * @m_since_latest_{plugins}
+         *
+         * Returns ID of the skin the object references or @cpp -1 @ce if
+         * the object isn't skinned. Expects that a file is opened and @p id
+         * is less than @ref object3DCount(). For nodes duplicated because
+         * of multi-primitive meshes, all objects in the sequence report the
+         * same skin.
+         */
+        virtual Int object3DSkin(UnsignedInt id);
+
+        /**
+         * @brief Joints of given skin
+         * @m_since_latest_{plugins}
+         *
+         * Returns object IDs of the skin joints. Expects that a file is
+         * opened and @p id is less than @ref skin3DCount(). On failure
+         * prints a message to @ref Error and returns
+         * @ref Containers::NullOpt. See @ref Trade-TinyGltfImporter-skinning
+         * for more information.
+         */
+        virtual Containers::Optional<Containers::Array<UnsignedInt>> skin3DJoints(UnsignedInt id);
+
+        /**
+         * @brief Inverse bind matrices of given skin
+         * @m_since_latest_{plugins}
+         *
+         * Returns one matrix for each joint in @ref skin3DJoints(), tightly
+         * packed. Expects that a file is opened and @p id is less than
+         * @ref skin3DCount(). On failure prints a message to @ref Error and
+         * returns @ref Containers::NullOpt. See
+         * @ref Trade-TinyGltfImporter-skinning for more information.
+         */
+        virtual Containers::Optional<Containers::Array<Matrix4>> skin3DInverseBindMatrices(UnsignedInt id);
+
+        /**
+         * @brief Morph target count of given mesh
+         * @m_since_latest_{plugins}
+         *
+         * Expects that a file is opened and @p id is less than
+         * @ref meshCount(). See @ref Trade-TinyGltfImporter-morph for more
+         * information.
+         */
+        virtual UnsignedInt meshMorphTargetCount(UnsignedInt id);
+
+        /**
+         * @brief Default morph target weights of given mesh
+         * @m_since_latest_{plugins}
+         *
+         * Returns one weight for each morph target, zero if the mesh doesn't
+         * specify them. Expects that a file is opened and @p id is less than
+         * @ref meshCount().
+         */
+        virtual Containers::Array<Float> meshMorphTargetWeights(UnsignedInt id);
+
+        /**
+         * @brief Morph target of given mesh
+         * @m_since_latest_{plugins}
+         *
+         * Returns a @ref MeshPrimitive::Points mesh with vertex
+         * displacements, indexed if the morph target is stored sparsely.
+         * Expects that a file is opened, @p id is less than
+         * @ref meshCount() and @p target is less than
+         * @ref meshMorphTargetCount(). On failure prints a message to
+         * @ref Error and returns @ref Containers::NullOpt. See
+         * @ref Trade-TinyGltfImporter-morph for more information.
+         */
+        virtual Containers::Optional<MeshData> meshMorphTarget(UnsignedInt id, UnsignedInt target);
+
+        /**
+         * @brief Set profiling callback
+         * @m_since_latest_{plugins}
+         *
+         * The @p callback is called at the end of each import stage with the
+         * stage name, its duration in nanoseconds, count of bytes it
+         * processed or @cpp 0 @ce if not applicable, and @p userData. The
+         * callback is kept across opened files, pass @cpp nullptr @ce to
+         * reset it. Doesn't need any file to be opened. If the plugin isn't
+         * built with `WITH_IMPORTER_PROFILING`, the callback is never
+         * called. See @ref Trade-TinyGltfImporter-profiling for more
+         * information.
+         */
+        virtual void setProfilingCallback(void(*callback)(const char* stage, UnsignedLong nanoseconds, std::size_t byteCount, void* userData), void* userData = nullptr);
+
     private:
         struct Document;
 
@@ -454,6 +985,7 @@ class MAGNUM_TINYGLTFIMPORTER_EXPORT TinyGltfImporter: public AbstractImporter {
         MAGNUM_TINYGLTFIMPORTER_LOCAL std::string doAnimationName(UnsignedInt id) override;
         MAGNUM_TINYGLTFIMPORTER_LOCAL Int doAnimationForName(const std::string& name) override;
         MAGNUM_TINYGLTFIMPORTER_LOCAL Containers::Optional<AnimationData> doAnimation(UnsignedInt id) override;
+        MAGNUM_TINYGLTFIMPORTER_LOCAL Containers::Optional<AnimationData> animationInternal(UnsignedInt id);
 
         MAGNUM_TINYGLTFIMPORTER_LOCAL Containers::Optional<CameraData> doCamera(UnsignedInt id) override;
         MAGNUM_TINYGLTFIMPORTER_LOCAL Int doCameraForName(const std::string& name) override;
@@ -481,9 +1013,17 @@ class MAGNUM_TINYGLTFIMPORTER_EXPORT TinyGltfImporter: public AbstractImporter {
         MAGNUM_TINYGLTFIMPORTER_LOCAL Int doMeshForName(const std::string& name) override;
         MAGNUM_TINYGLTFIMPORTER_LOCAL std::string doMeshName(UnsignedInt id) override;
         MAGNUM_TINYGLTFIMPORTER_LOCAL Containers::Optional<MeshData> doMesh(UnsignedInt id, UnsignedInt level) override;
+        MAGNUM_TINYGLTFIMPORTER_LOCAL Containers::Optional<MeshData> profiledMeshInternal(UnsignedInt id);
+        MAGNUM_TINYGLTFIMPORTER_LOCAL Containers::Optional<MeshData> meshInternal(UnsignedInt id);
+        MAGNUM_TINYGLTFIMPORTER_LOCAL Containers::Optional<MeshData> object3DInstancesInternal(const tinygltf::Node& node, const tinygltf::Value& attributes);
+        MAGNUM_TINYGLTFIMPORTER_LOCAL Containers::Optional<Containers::Array<Matrix4>> skin3DInverseBindMatricesInternal(const tinygltf::Skin& skin);
+        MAGNUM_TINYGLTFIMPORTER_LOCAL Containers::Optional<MeshData> meshMorphTargetInternal(UnsignedInt id, UnsignedInt target);
         MAGNUM_TINYGLTFIMPORTER_LOCAL MeshAttribute doMeshAttributeForName(const std::string& name) override;
         MAGNUM_TINYGLTFIMPORTER_LOCAL std::string doMeshAttributeName(UnsignedShort name) override;
 
+        MAGNUM_TINYGLTFIMPORTER_LOCAL bool loadLazyBuffers(const char* function, Containers::ArrayView<const UnsignedInt> buffers);
+        MAGNUM_TINYGLTFIMPORTER_LOCAL void releaseLazyBuffers(Containers::ArrayView<const UnsignedInt> buffers, bool firstImport, bool pin);
+
         MAGNUM_TINYGLTFIMPORTER_LOCAL bool materialTexture(const char* name, Int texture, Int texCoord, const tinygltf::Value& extensions, UnsignedInt& index, UnsignedInt& coordinateSet, Containers::Optional<Matrix3>& textureMatrix, PhongMaterialData::Flags& flags) const;
 
         MAGNUM_TINYGLTFIMPORTER_LOCAL UnsignedInt doMaterialCount() const override;
@@ -496,7 +1036,10 @@ class MAGNUM_TINYGLTFIMPORTER_EXPORT TinyGltfImporter: public AbstractImporter {
         MAGNUM_TINYGLTFIMPORTER_LOCAL std::string doTextureName(UnsignedInt id) override;
         MAGNUM_TINYGLTFIMPORTER_LOCAL Containers::Optional<TextureData> doTexture(UnsignedInt id) override;
 
+        MAGNUM_TINYGLTFIMPORTER_LOCAL Containers::Pointer<AbstractImporter> openImageImporter(UnsignedInt id, const char* errorPrefix);
         MAGNUM_TINYGLTFIMPORTER_LOCAL AbstractImporter* setupOrReuseImporterForImage(UnsignedInt id, const char* errorPrefix);
+        MAGNUM_TINYGLTFIMPORTER_LOCAL void prefetchImages(UnsignedInt id, AbstractImporter& importer, UnsignedInt threadCount);
+        MAGNUM_TINYGLTFIMPORTER_LOCAL void startImagePrefetch();
 
         MAGNUM_TINYGLTFIMPORTER_LOCAL UnsignedInt doImage2DCount() const override;
         MAGNUM_TINYGLTFIMPORTER_LOCAL UnsignedInt doImage2DLevelCount(UnsignedInt id) override;
@@ -507,6 +1050,8 @@ class MAGNUM_TINYGLTFIMPORTER_EXPORT TinyGltfImporter: public AbstractImporter {
         MAGNUM_TINYGLTFIMPORTER_LOCAL const void* doImporterState() const override;
 
         Containers::Pointer<Document> _d;
+        void(*_profilingCallback)(const char*, UnsignedLong, std::size_t, void*){};
+        void* _profilingUserData{};
 };
 
 }}
@@ -24,3 +24,7 @@
 */
 
 #cmakedefine MAGNUM_TINYGLTFIMPORTER_BUILD_STATIC
+#cmakedefine MAGNUM_TINYGLTFIMPORTER_WITH_DRACO
+#cmakedefine MAGNUM_TINYGLTFIMPORTER_WITH_MESHOPTIMIZER
+#cmakedefine MAGNUM_TINYGLTFIMPORTER_WITH_RAPIDJSON
+#cmakedefine MAGNUM_TINYGLTFIMPORTER_WITH_PROFILING
@@ -15,12 +15,27 @@
 
 
 #include <assert.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdlib.h>
 
 #define ARRAY_SIZE(x) sizeof(x)/sizeof(x[0])
 
 
+// Size of the .EXR file miniexr_write_to() produces for a (width) x (height) image.
+// (Magnum-specific addition.)
+size_t miniexr_size (unsigned width, unsigned height);
+
+// Writes EXR into a caller-provided memory buffer of miniexr_size() bytes.
+// Input:
+//   - (width) x (height) image,
+//   - channels=4: 8 bytes per pixel (R,G,B,A order, 16 bit float per channel; alpha ignored), or
+//   - channels=3: 6 bytes per pixel (R,G,B order, 16 bit float per channel),
+//   - rowStride: offset between the starts of consecutive rows in bytes, can
+//     be negative to read the rows in reverse order.
+// (Magnum-specific addition.)
+void miniexr_write_to (unsigned width, unsigned height, unsigned channels, const void* rgba16f, ptrdiff_t rowStride, unsigned char* buf);
+
 // Writes EXR into a memory buffer.
 // Input:
 //   - (width) x (height) image,
@@ -28,6 +43,30 @@
 //   - channels=3: 6 bytes per pixel (R,G,B order, 16 bit float per channel).
 // Returns memory buffer with .EXR contents and buffer size in outSize. free() the buffer when done with it.
 unsigned char* miniexr_write (unsigned width, unsigned height, unsigned channels, const void* rgba16f, size_t* outSize)
+{
+	const size_t bufSize = miniexr_size (width, height);
+	unsigned char* buf = (unsigned char*)malloc (bufSize);
+	if (!buf)
+		return NULL;
+
+	miniexr_write_to (width, height, channels, rgba16f, width * channels * 2, buf);
+
+	*outSize = bufSize;
+	return buf;
+}
+
+// Header of the file, shared by miniexr_size() and miniexr_write_to()
+#define MINIEXR_HEADER_SIZE 313
+
+size_t miniexr_size (unsigned width, unsigned height)
+{
+	const size_t kScanlineTableSize = 8 * size_t(height);
+	const size_t pixelRowSize = size_t(width) * 3 * 2;
+	const size_t fullRowSize = pixelRowSize + 8;
+	return MINIEXR_HEADER_SIZE + kScanlineTableSize + height * fullRowSize;
+}
+
+void miniexr_write_to (unsigned width, unsigned height, unsigned channels, const void* rgba16f, ptrdiff_t rowStride, unsigned char* buf)
 {
 	const unsigned ww = width-1;
 	const unsigned hh = height-1;
@@ -85,16 +124,12 @@ unsigned char* miniexr_write (unsigned width, unsigned height, unsigned channels
 		0,
 	};
 	const int kHeaderSize = ARRAY_SIZE(kHeader);
+	static_assert(ARRAY_SIZE(kHeader) == MINIEXR_HEADER_SIZE, "header size mismatch");
 
 	const int kScanlineTableSize = 8 * height;
 	const unsigned pixelRowSize = width * 3 * 2;
 	const unsigned fullRowSize = pixelRowSize + 8;
 
-	unsigned bufSize = kHeaderSize + kScanlineTableSize + height * fullRowSize;
-	unsigned char* buf = (unsigned char*)malloc (bufSize);
-	if (!buf)
-		return NULL;
-
 	// copy in header
 	memcpy (buf, kHeader, kHeaderSize);
 
@@ -153,11 +188,8 @@ unsigned char* miniexr_write (unsigned width, unsigned height, unsigned channels
 			chsrc += stride;
 		}
 
-		src += width * stride;
+		src += rowStride;
 	}
 
-	assert (ptr - buf == bufSize);
-
-	*outSize = bufSize;
-	return buf;
+	assert (size_t(ptr - buf) == miniexr_size (width, height));
 }